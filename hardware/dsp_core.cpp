@@ -0,0 +1,557 @@
+/**
+ * DSP Core Implementation
+ *
+ * The built-in real FFT packs the N real samples into a complex sequence of
+ * half the length, transforms it with an iterative radix-2 FFT and splits
+ * the result into the spectrum of the real input. One table of N / 2
+ * twiddles exp(-2πik/N) serves both the half-length butterflies (even
+ * entries) and the split step. The other backends are thin wrappers that
+ * bring their output to the same layout.
+ */
+
+#include "dsp_core.h"
+#include "dsp_lanes.h"
+#include <math.h>
+#include <string.h>
+#include <new>
+
+#ifdef USE_CMSIS_DSP
+    #include <arm_math.h>
+#endif
+#ifdef USE_KISSFFT
+    #include <kiss_fftr.h>
+#endif
+#ifdef DSP_CORE_FFTW
+    #include <fftw3.h>
+#endif
+
+struct DspRealFft {
+    size_t size = 0;
+    DspFftBackend backend = DSP_FFT_BUILTIN;
+    float *twiddle = nullptr;       // Built-in: re, im of exp(-2πik/N), k < N/2
+    uint16_t *bitrev = nullptr;     // Built-in: N/2 entries
+    float *work = nullptr;          // Built-in: packed half-length sequence; CMSIS: input copy
+#ifdef USE_CMSIS_DSP
+    arm_rfft_fast_instance_f32 cmsis;
+#endif
+#ifdef USE_KISSFFT
+    kiss_fftr_cfg kiss = nullptr;
+#endif
+#ifdef DSP_CORE_FFTW
+    fftw_plan plan = nullptr;
+    double *fftw_input = nullptr;
+    fftw_complex *fftw_output = nullptr;
+#endif
+};
+
+#ifdef USE_KISSFFT
+static_assert(sizeof(kiss_fft_cpx) == 2 * sizeof(float), "KissFFT must be built with float scalars");
+#endif
+
+DspFftBackend dsp_fft_default_backend(void) {
+#if defined(USE_CMSIS_DSP)
+    return DSP_FFT_CMSIS;
+#elif defined(USE_KISSFFT)
+    return DSP_FFT_KISSFFT;
+#elif defined(DSP_CORE_FFTW)
+    return DSP_FFT_FFTW;
+#else
+    return DSP_FFT_BUILTIN;
+#endif
+}
+
+bool dsp_fft_backend_available(DspFftBackend backend) {
+    switch (backend) {
+        case DSP_FFT_BUILTIN:
+            return true;
+#ifdef USE_KISSFFT
+        case DSP_FFT_KISSFFT:
+            return true;
+#endif
+#ifdef USE_CMSIS_DSP
+        case DSP_FFT_CMSIS:
+            return true;
+#endif
+#ifdef DSP_CORE_FFTW
+        case DSP_FFT_FFTW:
+            return true;
+#endif
+        default:
+            return false;
+    }
+}
+
+const char* dsp_fft_backend_name(DspFftBackend backend) {
+    switch (backend) {
+        case DSP_FFT_BUILTIN: return "builtin";
+        case DSP_FFT_KISSFFT: return "kissfft";
+        case DSP_FFT_CMSIS: return "cmsis";
+        case DSP_FFT_FFTW: return "fftw";
+    }
+    return "unknown";
+}
+
+static bool rfft_alloc_tables(DspRealFft *fft) {
+    const size_t n = fft->size, half = n / 2;
+    fft->twiddle = new (std::nothrow) float[n];
+    fft->bitrev = new (std::nothrow) uint16_t[half];
+    fft->work = new (std::nothrow) float[n];
+    return fft->twiddle && fft->bitrev && fft->work;
+}
+
+static bool rfft_build_tables(DspRealFft *fft) {
+    const size_t n = fft->size, half = n / 2;
+    if (!rfft_alloc_tables(fft)) {
+        return false;
+    }
+    for (size_t k = 0; k < half; k++) {
+        double angle = -2.0 * M_PI * (double)k / (double)n;
+        fft->twiddle[2 * k] = (float)cos(angle);
+        fft->twiddle[2 * k + 1] = (float)sin(angle);
+    }
+    unsigned bits = 0;
+    while ((size_t(1) << bits) < half) {
+        bits++;
+    }
+    for (size_t i = 0; i < half; i++) {
+        unsigned r = 0;
+        for (unsigned b = 0; b < bits; b++) {
+            r |= (unsigned)((i >> b) & 1u) << (bits - 1 - b);
+        }
+        fft->bitrev[i] = (uint16_t)r;
+    }
+    return true;
+}
+
+DspRealFft* dsp_rfft_create(size_t size, DspFftBackend backend) {
+    if (size < DSP_FFT_MIN_SIZE || size > DSP_FFT_MAX_SIZE || (size & (size - 1)) != 0 ||
+        !dsp_fft_backend_available(backend)) {
+        return NULL;
+    }
+    DspRealFft *fft = new (std::nothrow) DspRealFft();
+    if (fft == NULL) {
+        return NULL;
+    }
+    fft->size = size;
+    fft->backend = backend;
+
+    bool ok = false;
+    switch (backend) {
+        case DSP_FFT_BUILTIN:
+            ok = rfft_build_tables(fft);
+            break;
+#ifdef USE_KISSFFT
+        case DSP_FFT_KISSFFT:
+            fft->kiss = kiss_fftr_alloc((int)size, 0, NULL, NULL);
+            ok = fft->kiss != NULL;
+            break;
+#endif
+#ifdef USE_CMSIS_DSP
+        case DSP_FFT_CMSIS:
+            // arm_rfft_fast_f32 uses its input as scratch, hence the copy
+            fft->work = new (std::nothrow) float[size];
+            ok = fft->work != NULL && arm_rfft_fast_init_f32(&fft->cmsis, (uint16_t)size) == ARM_MATH_SUCCESS;
+            break;
+#endif
+#ifdef DSP_CORE_FFTW
+        case DSP_FFT_FFTW:
+            fft->fftw_input = fftw_alloc_real(size);
+            fft->fftw_output = fftw_alloc_complex(size / 2 + 1);
+            if (fft->fftw_input && fft->fftw_output) {
+                fft->plan = fftw_plan_dft_r2c_1d((int)size, fft->fftw_input, fft->fftw_output, FFTW_ESTIMATE);
+            }
+            ok = fft->plan != NULL;
+            break;
+#endif
+        default:
+            break;
+    }
+    if (!ok) {
+        dsp_rfft_destroy(fft);
+        return NULL;
+    }
+    return fft;
+}
+
+DspRealFft* dsp_rfft_create_from_tables(size_t size, const float *twiddle, const uint16_t *bitrev) {
+    if (twiddle == NULL || bitrev == NULL || size < DSP_FFT_MIN_SIZE || size > DSP_FFT_MAX_SIZE ||
+        (size & (size - 1)) != 0) {
+        return NULL;
+    }
+    // A bit-reversal entry out of range would index past the work buffer
+    const size_t half = size / 2;
+    for (size_t i = 0; i < half; i++) {
+        if (bitrev[i] >= half) {
+            return NULL;
+        }
+    }
+    DspRealFft *fft = new (std::nothrow) DspRealFft();
+    if (fft == NULL) {
+        return NULL;
+    }
+    fft->size = size;
+    fft->backend = DSP_FFT_BUILTIN;
+    if (!rfft_alloc_tables(fft)) {
+        dsp_rfft_destroy(fft);
+        return NULL;
+    }
+    memcpy(fft->twiddle, twiddle, size * sizeof(float));
+    memcpy(fft->bitrev, bitrev, half * sizeof(uint16_t));
+    return fft;
+}
+
+bool dsp_rfft_get_tables(const DspRealFft *fft, float *twiddle, uint16_t *bitrev) {
+    if (fft == NULL || fft->backend != DSP_FFT_BUILTIN || twiddle == NULL || bitrev == NULL) {
+        return false;
+    }
+    memcpy(twiddle, fft->twiddle, fft->size * sizeof(float));
+    memcpy(bitrev, fft->bitrev, fft->size / 2 * sizeof(uint16_t));
+    return true;
+}
+
+void dsp_rfft_destroy(DspRealFft *fft) {
+    if (fft == NULL) {
+        return;
+    }
+    delete[] fft->twiddle;
+    delete[] fft->bitrev;
+    delete[] fft->work;
+#ifdef USE_KISSFFT
+    kiss_fftr_free(fft->kiss);
+#endif
+#ifdef DSP_CORE_FFTW
+    if (fft->plan) {
+        fftw_destroy_plan(fft->plan);
+    }
+    fftw_free(fft->fftw_input);
+    fftw_free(fft->fftw_output);
+#endif
+    delete fft;
+}
+
+size_t dsp_rfft_size(const DspRealFft *fft) {
+    return fft->size;
+}
+
+DspFftBackend dsp_rfft_backend(const DspRealFft *fft) {
+    return fft->backend;
+}
+
+static void rfft_builtin(DspRealFft *fft, const float *input, float *output) {
+    const size_t half = fft->size / 2;
+    const float *twiddle = fft->twiddle;
+    float *z = fft->work;
+
+    // z[n] = x[2n] + i x[2n+1], in bit-reversed order
+    for (size_t n = 0; n < half; n++) {
+        size_t r = fft->bitrev[n];
+        z[2 * r] = input[2 * n];
+        z[2 * r + 1] = input[2 * n + 1];
+    }
+
+    // Half-length radix-2 butterflies; stage twiddle j is table entry
+    // 2 j (M / len) for M = N/2
+    for (size_t len = 2; len <= half; len <<= 1) {
+        size_t span = len >> 1;
+        size_t step = 2 * (half / len);
+        for (size_t base = 0; base < half; base += len) {
+            for (size_t j = 0; j < span; j++) {
+                float wr = twiddle[2 * j * step];
+                float wi = twiddle[2 * j * step + 1];
+                float *a = &z[2 * (base + j)];
+                float *b = &z[2 * (base + j + span)];
+                float tr = b[0] * wr - b[1] * wi;
+                float ti = b[0] * wi + b[1] * wr;
+                b[0] = a[0] - tr;
+                b[1] = a[1] - ti;
+                a[0] += tr;
+                a[1] += ti;
+            }
+        }
+    }
+
+    // Split: X[k] = E[k] + W^k O[k] with E = (Z[k] + conj Z[M-k]) / 2 and
+    // O = (Z[k] - conj Z[M-k]) / 2i. DC and Nyquist are Re Z[0] ± Im Z[0].
+    output[0] = z[0] + z[1];
+    output[1] = 0.0f;
+    output[2 * half] = z[0] - z[1];
+    output[2 * half + 1] = 0.0f;
+    for (size_t k = 1; k < half; k++) {
+        float zr = z[2 * k], zi = z[2 * k + 1];
+        float cr = z[2 * (half - k)], ci = -z[2 * (half - k) + 1];
+        float er = 0.5f * (zr + cr), ei = 0.5f * (zi + ci);
+        float or_ = 0.5f * (zi - ci), oi = -0.5f * (zr - cr);
+        float wr = twiddle[2 * k], wi = twiddle[2 * k + 1];
+        output[2 * k] = er + (or_ * wr - oi * wi);
+        output[2 * k + 1] = ei + (or_ * wi + oi * wr);
+    }
+}
+
+void dsp_rfft_forward(DspRealFft *fft, const float *input, float *output) {
+    switch (fft->backend) {
+#ifdef USE_KISSFFT
+        case DSP_FFT_KISSFFT:
+            kiss_fftr(fft->kiss, input, (kiss_fft_cpx *)output);
+            return;
+#endif
+#ifdef USE_CMSIS_DSP
+        case DSP_FFT_CMSIS: {
+            // Packed output: bin 0 holds DC and Nyquist
+            const size_t n = fft->size;
+            memcpy(fft->work, input, n * sizeof(float));
+            arm_rfft_fast_f32(&fft->cmsis, fft->work, output, 0);
+            output[n] = output[1];
+            output[n + 1] = 0.0f;
+            output[1] = 0.0f;
+            return;
+        }
+#endif
+#ifdef DSP_CORE_FFTW
+        case DSP_FFT_FFTW: {
+            const size_t n = fft->size;
+            for (size_t t = 0; t < n; t++) {
+                fft->fftw_input[t] = input[t];
+            }
+            fftw_execute(fft->plan);
+            for (size_t k = 0; k <= n / 2; k++) {
+                output[2 * k] = (float)fft->fftw_output[k][0];
+                output[2 * k + 1] = (float)fft->fftw_output[k][1];
+            }
+            return;
+        }
+#endif
+        default:
+            rfft_builtin(fft, input, output);
+            return;
+    }
+}
+
+void dsp_window(DspWindow type, bool periodic, float *window, size_t n) {
+    const double period = periodic ? (double)n : (double)(n > 1 ? n - 1 : 1);
+    for (size_t t = 0; t < n; t++) {
+        double phase = 2.0 * M_PI * (double)t / period;
+        double w;
+        switch (type) {
+            case DSP_WINDOW_BLACKMAN:
+                w = 0.42 - 0.5 * cos(phase) + 0.08 * cos(2.0 * phase);
+                break;
+            case DSP_WINDOW_RECTANGULAR:
+                w = 1.0;
+                break;
+            case DSP_WINDOW_HANN:
+            default:
+                w = 0.5 - 0.5 * cos(phase);
+                break;
+        }
+        window[t] = (float)w;
+    }
+}
+
+void dsp_apply_window(const float *input, const float *window, float *output, size_t n) {
+#ifdef USE_CMSIS_DSP
+    arm_mult_f32(input, window, output, (uint32_t)n);
+#else
+    size_t t = 0;
+    for (; t + DSP_LANES <= n; t += DSP_LANES) {
+        lanes_store(&output[t], lanes_mul(lanes_load(&input[t]), lanes_load(&window[t])));
+    }
+    for (; t < n; t++) {
+        output[t] = input[t] * window[t];
+    }
+#endif
+}
+
+void dsp_magnitudes(const float *spectrum, float *magnitude, size_t bins) {
+#ifdef USE_CMSIS_DSP
+    arm_cmplx_mag_f32(spectrum, magnitude, (uint32_t)bins);
+#else
+    // Four bins per lane vector
+    size_t k = 0;
+    for (; k + DSP_LANES <= bins; k += DSP_LANES) {
+        DspLanes lo = lanes_load(&spectrum[2 * k]);
+        DspLanes hi = lanes_load(&spectrum[2 * k + DSP_LANES]);
+        lanes_store(&magnitude[k], lanes_sqrt(lanes_pairwise_add(lanes_mul(lo, lo), lanes_mul(hi, hi))));
+    }
+    for (; k < bins; k++) {
+        magnitude[k] = sqrtf(spectrum[2 * k] * spectrum[2 * k] + spectrum[2 * k + 1] * spectrum[2 * k + 1]);
+    }
+#endif
+}
+
+// s[t] = x[t] + 2cos(ω) s[t-1] - s[t-2] leaves s[n-1] - exp(-iω) s[n-2] =
+// Σ x[t] exp(iω(n-1-t)), which exp(-iω(n-1)) turns back to the bin. In
+// double, as the recurrence's error grows with n near DC and Nyquist.
+void dsp_goertzel(const float *input, size_t n, size_t stride, float hz, float sample_rate, float *bin) {
+    const double w = 2.0 * M_PI * (double)hz / (double)sample_rate;
+    const double cw = cos(w);
+    const double coeff = 2.0 * cw;
+    double s1 = 0.0, s2 = 0.0;
+    for (size_t t = 0; t < n; t++) {
+        const double s0 = (double)input[t * stride] + coeff * s1 - s2;
+        s2 = s1;
+        s1 = s0;
+    }
+    const double a = s1 - cw * s2;
+    const double b = sin(w) * s2;
+    const double phase = n > 0 ? -w * (double)(n - 1) : 0.0;
+    const double cp = cos(phase), sp = sin(phase);
+    bin[0] = (float)(a * cp - b * sp);
+    bin[1] = (float)(a * sp + b * cp);
+}
+
+void dsp_cross_spectra_update(const float *x, const float *y, size_t bins, float alpha, float *sxx, float *syy,
+                              float *sxy) {
+    for (size_t k = 0; k < bins; k++) {
+        const float xr = x[2 * k], xi = x[2 * k + 1];
+        const float yr = y[2 * k], yi = y[2 * k + 1];
+        sxx[k] += alpha * (xr * xr + xi * xi - sxx[k]);
+        syy[k] += alpha * (yr * yr + yi * yi - syy[k]);
+        sxy[2 * k] += alpha * (xr * yr + xi * yi - sxy[2 * k]);
+        sxy[2 * k + 1] += alpha * (xi * yr - xr * yi - sxy[2 * k + 1]);
+    }
+}
+
+// Sums in double, where a few loud bins sit among many quiet ones
+float dsp_coherence(const float *sxx, const float *syy, const float *sxy, size_t first, size_t bins, float *msc) {
+    double weighted = 0.0, total = 0.0;
+    for (size_t k = first; k < bins; k++) {
+        const double power = (double)sxx[k] * (double)syy[k];
+        const double cross = (double)sxy[2 * k] * sxy[2 * k] + (double)sxy[2 * k + 1] * sxy[2 * k + 1];
+        const double c = power > 0.0 ? fmin(cross / power, 1.0) : 0.0;
+        if (msc != NULL) {
+            msc[k] = (float)c;
+        }
+        const double weight = sqrt(power);
+        weighted += c * weight;
+        total += weight;
+    }
+    return total > 0.0 ? (float)(weighted / total) : 0.0f;
+}
+
+// One sweep over whole lane vectors that also keeps the spectrum for the
+// next flux, a scalar tail, and the rolloff walking the bins again up to
+// its threshold
+bool dsp_spectral_features(const float *magnitude, float *prev, size_t bins, float bin_hz,
+                           DspSpectralFeatures *features) {
+    const DspLanes zero = lanes_set(0.0f);
+    const DspLanes one = lanes_set(1.0f);
+    const DspLanes epsilon = lanes_set(1e-20f);         // Keeps the log of empty bins finite
+    const DspLanes lane_step = lanes_set((float)DSP_LANES);
+    const float first_bins[DSP_LANES] = {0.0f, 1.0f, 2.0f, 3.0f};
+    const float first_keep[DSP_LANES] = {0.0f, 1.0f, 1.0f, 1.0f};
+    DspLanes bin = lanes_load(first_bins);
+    DspLanes keep = lanes_load(first_keep);             // Masks DC out of the first vector
+    DspLanes sum = zero, weighted = zero, rise = zero, power = zero, log_power = zero;
+
+    size_t k = 0;
+    for (; k + DSP_LANES <= bins; k += DSP_LANES) {
+        DspLanes m = lanes_load(&magnitude[k]);
+        DspLanes p = lanes_mul(m, m);
+        if (prev != NULL) {
+            DspLanes up = lanes_max(lanes_sub(m, lanes_load(&prev[k])), zero);
+            lanes_store(&prev[k], m);
+            rise = lanes_add(rise, lanes_mul(up, keep));
+        }
+        m = lanes_mul(m, keep);
+        sum = lanes_add(sum, m);
+        weighted = lanes_add(weighted, lanes_mul(bin, m));
+        power = lanes_add(power, lanes_mul(p, keep));
+        log_power = lanes_add(log_power, lanes_mul(lanes_log2(lanes_add(p, epsilon)), keep));
+        bin = lanes_add(bin, lane_step);
+        keep = one;
+    }
+    float lanes[5][DSP_LANES];
+    lanes_store(lanes[0], sum);
+    lanes_store(lanes[1], weighted);
+    lanes_store(lanes[2], rise);
+    lanes_store(lanes[3], power);
+    lanes_store(lanes[4], log_power);
+    float magnitude_sum = 0.0f, weighted_sum = 0.0f, rise_sum = 0.0f, power_sum = 0.0f, log_sum = 0.0f;
+    for (int j = 0; j < DSP_LANES; j++) {
+        magnitude_sum += lanes[0][j];
+        weighted_sum += lanes[1][j];
+        rise_sum += lanes[2][j];
+        power_sum += lanes[3][j];
+        log_sum += lanes[4][j];
+    }
+    for (; k < bins; k++) {
+        const float m = magnitude[k];
+        if (prev != NULL) {
+            if (k > 0 && m > prev[k]) {
+                rise_sum += m - prev[k];
+            }
+            prev[k] = m;
+        }
+        if (k == 0) {
+            continue;
+        }
+        magnitude_sum += m;
+        weighted_sum += (float)k * m;
+        power_sum += m * m;
+        log_sum += fast_log2f(m * m + 1e-20f);
+    }
+
+    const bool has_energy = magnitude_sum > 0.0f;
+    const float count = (float)(bins - 1);
+    features->centroid = has_energy ? weighted_sum / magnitude_sum * bin_hz : 0.0f;
+    features->flux = has_energy ? fminf(rise_sum / magnitude_sum, 1.0f) : 0.0f;
+    features->flatness = power_sum > 0.0f ? fminf(exp2f(log_sum / count - log2f(power_sum / count)), 1.0f) : 0.0f;
+    features->power = power_sum;
+    features->rolloff = 0.0f;
+    if (has_energy) {
+        const float threshold = DSP_ROLLOFF_FRACTION * magnitude_sum;
+        float cumulative = 0.0f;
+        size_t rolloff = 1;
+        for (; rolloff < bins - 1; rolloff++) {
+            cumulative += magnitude[rolloff];
+            if (cumulative >= threshold) {
+                break;
+            }
+        }
+        features->rolloff = rolloff * bin_hz;
+    }
+    return has_energy;
+}
+
+DspBiquad dsp_biquad_section(bool highpass, float hz, float sample_rate, double q) {
+    double w0 = 2.0 * M_PI * hz / sample_rate;
+    double cs = cos(w0);
+    double alpha = sin(w0) / (2.0 * q);
+    double a0 = 1.0 + alpha;
+    double b = highpass ? (1.0 + cs) / 2.0 : (1.0 - cs) / 2.0;
+    DspBiquad section;
+    section.b0 = (float)(b / a0);
+    section.b1 = (float)((highpass ? -2.0 * b : 2.0 * b) / a0);
+    section.b2 = (float)(b / a0);
+    section.a1 = (float)(-2.0 * cs / a0);
+    section.a2 = (float)((1.0 - alpha) / a0);
+    return section;
+}
+
+size_t dsp_butterworth(bool highpass, float hz, float sample_rate, unsigned order, DspBiquad *sections) {
+    if (hz <= 0.0f || hz >= 0.5f * sample_rate || order == 0 || (order & 1) != 0 ||
+        order > DSP_BUTTERWORTH_MAX_ORDER) {
+        return 0;
+    }
+    for (unsigned k = 0; k < order / 2; k++) {
+        double q = 1.0 / (2.0 * cos((2.0 * k + 1.0) * M_PI / (2.0 * order)));
+        sections[k] = dsp_biquad_section(highpass, hz, sample_rate, q);
+    }
+    return order / 2;
+}
+
+void dsp_biquad_cascade(const DspBiquad *sections, size_t count, float *state, float *samples, size_t n) {
+    for (size_t s = 0; s < count; s++) {
+        const DspBiquad c = sections[s];
+        float z1 = state[2 * s], z2 = state[2 * s + 1];
+        for (size_t t = 0; t < n; t++) {
+            const float x = samples[t];
+            const float y = c.b0 * x + z1;
+            z1 = c.b1 * x - c.a1 * y + z2;
+            z2 = c.b2 * x - c.a2 * y;
+            samples[t] = y;
+        }
+        state[2 * s] = z1;
+        state[2 * s + 1] = z2;
+    }
+}
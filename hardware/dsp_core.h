@@ -0,0 +1,231 @@
+/**
+ * DSP Core - portable signal processing shared by the firmware and the host
+ * Built into hybrid_node, the pipeline host and the host extension
+ *
+ * One implementation of the analysis the tiers have in common, so the
+ * firmware, the native pipeline and the Python server report the same
+ * numbers for the same samples:
+ *
+ *   - Real FFT of power-of-two sizes on a selectable backend: the built-in
+ *     radix-2 transform (always there), KissFFT (USE_KISSFFT), CMSIS-DSP
+ *     (USE_CMSIS_DSP) or FFTW (DSP_CORE_FFTW, host builds). Every backend
+ *     returns the same layout, bins 0 to N/2 as interleaved re/im.
+ *   - Analysis windows, periodic for overlapped STFT frames or symmetric
+ *     as numpy.hanning.
+ *   - Butterworth biquad design and a transposed direct form II cascade.
+ *   - Magnitudes and the spectral features of hybrid_node (FR-003):
+ *     centroid, flux, rolloff and flatness.
+ *
+ * Allocation happens only in dsp_rfft_create; everything else works in the
+ * caller's buffers and is safe on the audio path.
+ */
+
+#ifndef DSP_CORE_H
+#define DSP_CORE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define DSP_FFT_MIN_SIZE            4
+#define DSP_FFT_MAX_SIZE            65536       // Bit-reversal table entries are 16 bits
+#define DSP_ROLLOFF_FRACTION        0.85f       // Share of the magnitude below the rolloff
+#define DSP_BUTTERWORTH_MAX_ORDER   8
+
+typedef enum {
+    DSP_FFT_BUILTIN = 0,
+    DSP_FFT_KISSFFT = 1,
+    DSP_FFT_CMSIS = 2,
+    DSP_FFT_FFTW = 3
+} DspFftBackend;
+
+// Same values as HybridWindow
+typedef enum {
+    DSP_WINDOW_HANN = 0,
+    DSP_WINDOW_BLACKMAN = 1,
+    DSP_WINDOW_RECTANGULAR = 2
+} DspWindow;
+
+// Normalized biquad, a0 = 1: y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2]
+typedef struct {
+    float b0, b1, b2, a1, a2;
+} DspBiquad;
+
+// Features of one magnitude spectrum
+typedef struct {
+    float centroid;                 // Hz
+    float flux;                     // [0, 1]
+    float rolloff;                  // Hz
+    float flatness;                 // [0, 1]
+    float power;                    // Σ |X[k]|² without DC
+} DspSpectralFeatures;
+
+typedef struct DspRealFft DspRealFft;
+
+/**
+ * Backend of dsp_rfft_create(size, dsp_fft_default_backend()): CMSIS-DSP,
+ * KissFFT or FFTW when built in, in that order, else the built-in FFT
+ */
+DspFftBackend dsp_fft_default_backend(void);
+
+/** Whether this build carries the backend */
+bool dsp_fft_backend_available(DspFftBackend backend);
+
+/** "builtin", "kissfft", "cmsis" or "fftw" */
+const char* dsp_fft_backend_name(DspFftBackend backend);
+
+/**
+ * Real FFT of size samples, with its tables, plan and scratch
+ *
+ * With FFTW, create and destroy plans under the caller's FFTW planner lock.
+ *
+ * @param size Power of two from DSP_FFT_MIN_SIZE to DSP_FFT_MAX_SIZE
+ *             (CMSIS-DSP: 32 to 4096)
+ * @param backend Any available backend
+ * @return The transform, NULL for an unsupported size or backend or when
+ *         memory runs out
+ */
+DspRealFft* dsp_rfft_create(size_t size, DspFftBackend backend);
+
+/**
+ * Built-in real FFT of size samples on tables saved with
+ * dsp_rfft_get_tables, copied instead of computed
+ *
+ * @param twiddle size floats: re, im of exp(-2πik/size), k < size / 2
+ * @param bitrev size / 2 bit-reversal entries, each below size / 2
+ * @return The transform, NULL for a bad size or table or when memory runs
+ *         out
+ */
+DspRealFft* dsp_rfft_create_from_tables(size_t size, const float *twiddle, const uint16_t *bitrev);
+
+/**
+ * Copy out the tables of a built-in transform, for
+ * dsp_rfft_create_from_tables
+ *
+ * @param twiddle Receives size floats
+ * @param bitrev Receives size / 2 entries
+ * @return true if copied, false for another backend
+ */
+bool dsp_rfft_get_tables(const DspRealFft *fft, float *twiddle, uint16_t *bitrev);
+
+/** Free the transform; NULL is ignored */
+void dsp_rfft_destroy(DspRealFft *fft);
+
+size_t dsp_rfft_size(const DspRealFft *fft);
+DspFftBackend dsp_rfft_backend(const DspRealFft *fft);
+
+/**
+ * Forward transform, unnormalized (as numpy.fft.rfft)
+ *
+ * Not reentrant per transform: the scratch belongs to fft.
+ *
+ * @param input size samples, left untouched
+ * @param output size + 2 floats: re, im of bins 0 to size / 2; the DC and
+ *               Nyquist imaginary parts are 0
+ */
+void dsp_rfft_forward(DspRealFft *fft, const float *input, float *output);
+
+/**
+ * Analysis window
+ *
+ * @param periodic Period n, so frames overlapped by n/2 (Hann) or n/3
+ *                 (Blackman) sum to a constant; otherwise symmetric over
+ *                 n - 1 (numpy.hanning, numpy.blackman)
+ */
+void dsp_window(DspWindow type, bool periodic, float *window, size_t n);
+
+/** output[t] = input[t] * window[t]; output may be input */
+void dsp_apply_window(const float *input, const float *window, float *output, size_t n);
+
+/**
+ * |X[k]| of bins interleaved re/im values (dsp_rfft_forward layout)
+ */
+void dsp_magnitudes(const float *spectrum, float *magnitude, size_t bins);
+
+/**
+ * One bin of the DFT by the Goertzel recurrence: one multiply-add per
+ * sample, no table, for a tone or two where a whole FFT would be waste
+ *
+ * @param stride Distance between samples, the channel count of
+ *               interleaved frames
+ * @param hz Bin frequency; need not put whole cycles in n, at the cost of
+ *           leakage from other frequencies
+ * @param bin Σ x[t] exp(-iωt), re then im
+ */
+void dsp_goertzel(const float *input, size_t n, size_t stride, float hz, float sample_rate, float *bin);
+
+/**
+ * Recursive Welch average of the auto and cross spectra of two channels:
+ * sxx, syy and sxy each move alpha of the way to this frame's |X|², |Y|²
+ * and X conj(Y), one complex multiply-accumulate per bin
+ *
+ * @param x, y Spectra of the same frame of each channel (dsp_rfft_forward
+ *             layout), bins 0 to bins - 1
+ * @param alpha Weight of the frame in (0, 1]; 1 keeps no history
+ * @param sxy Interleaved re/im
+ */
+void dsp_cross_spectra_update(const float *x, const float *y, size_t bins, float alpha, float *sxx, float *syy,
+                              float *sxy);
+
+/**
+ * Magnitude-squared coherence |Sxy|² / (Sxx Syy) of averaged spectra
+ *
+ * @param first, bins Bins first to bins - 1
+ * @param msc Coherence of each of those bins, at msc[k]; NULL for none
+ * @return Mean over the bins weighted by sqrt(Sxx Syy), so bins without
+ *         power count for nothing, in [0, 1]; 0 if no bin has power
+ */
+float dsp_coherence(const float *sxx, const float *syy, const float *sxy, size_t first, size_t bins, float *msc);
+
+/**
+ * Spectral features of bins magnitudes, DC (bin 0) left out of every sum
+ *
+ * The flux is the positive change against prev over the magnitude sum;
+ * prev then receives this spectrum. A silent spectrum has every feature 0.
+ *
+ * @param magnitude Bins 0 to bins - 1 of a dsp_rfft_forward spectrum
+ * @param prev Previous spectrum of the same bins, updated; NULL for no flux
+ * @param bins At least 2
+ * @param bin_hz Sample rate over FFT size
+ * @return Whether the spectrum carries energy
+ */
+bool dsp_spectral_features(const float *magnitude, float *prev, size_t bins, float bin_hz,
+                           DspSpectralFeatures *features);
+
+/**
+ * RBJ biquad of one Butterworth section
+ *
+ * @param highpass High-pass, else low-pass
+ * @param hz Cutoff, below sample_rate / 2
+ * @param q Quality of the section's pole pair
+ */
+DspBiquad dsp_biquad_section(bool highpass, float hz, float sample_rate, double q);
+
+/**
+ * Sections of an order-N Butterworth high-pass or low-pass, pole pair k at
+ * Q = 1 / (2 cos((2k + 1) π / 2N))
+ *
+ * @param order Even, up to DSP_BUTTERWORTH_MAX_ORDER
+ * @param sections Room for order / 2
+ * @return Sections written: order / 2, or 0 for a cutoff of 0 Hz or at or
+ *         above Nyquist, or an odd or oversized order
+ */
+size_t dsp_butterworth(bool highpass, float hz, float sample_rate, unsigned order, DspBiquad *sections);
+
+/**
+ * Run n samples through a cascade in place
+ *
+ * @param state Two floats per section (z1, z2), kept between calls; zero
+ *              them to reset
+ */
+void dsp_biquad_cascade(const DspBiquad *sections, size_t count, float *state, float *samples, size_t n);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DSP_CORE_H
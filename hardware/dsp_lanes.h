@@ -0,0 +1,104 @@
+/**
+ * DSP Lanes - four-float vectors for the DSP core and the hybrid node
+ *
+ * NEON, SSE or plain arrays, picked by the target. Everything is inline,
+ * so each translation unit gets the best form its flags allow.
+ */
+
+#ifndef DSP_LANES_H
+#define DSP_LANES_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#elif defined(__SSE__) || defined(_M_X64)
+    #include <xmmintrin.h>
+#endif
+
+#define DSP_LANES 4
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+typedef float32x4_t DspLanes;
+static inline DspLanes lanes_load(const float *p) { return vld1q_f32(p); }
+static inline void lanes_store(float *p, DspLanes v) { vst1q_f32(p, v); }
+static inline DspLanes lanes_set(float x) { return vdupq_n_f32(x); }
+static inline DspLanes lanes_mul(DspLanes a, DspLanes b) { return vmulq_f32(a, b); }
+static inline DspLanes lanes_add(DspLanes a, DspLanes b) { return vaddq_f32(a, b); }
+static inline DspLanes lanes_sub(DspLanes a, DspLanes b) { return vsubq_f32(a, b); }
+static inline DspLanes lanes_abs(DspLanes a) { return vabsq_f32(a); }
+static inline DspLanes lanes_max(DspLanes a, DspLanes b) { return vmaxq_f32(a, b); }
+static inline DspLanes lanes_above(DspLanes a, DspLanes b) {
+    return vreinterpretq_f32_u32(vandq_u32(vcgtq_f32(a, b), vreinterpretq_u32_f32(vdupq_n_f32(1.0f))));
+}
+#if defined(__aarch64__)
+static inline DspLanes lanes_pairwise_add(DspLanes a, DspLanes b) { return vpaddq_f32(a, b); }
+static inline DspLanes lanes_sqrt(DspLanes a) { return vsqrtq_f32(a); }
+#else
+static inline DspLanes lanes_pairwise_add(DspLanes a, DspLanes b) {
+    return vcombine_f32(vpadd_f32(vget_low_f32(a), vget_high_f32(a)), vpadd_f32(vget_low_f32(b), vget_high_f32(b)));
+}
+static inline DspLanes lanes_sqrt(DspLanes a) {
+    float v[DSP_LANES];
+    vst1q_f32(v, a);
+    for (int i = 0; i < DSP_LANES; i++) v[i] = sqrtf(v[i]);
+    return vld1q_f32(v);
+}
+#endif
+#elif defined(__SSE__) || defined(_M_X64)
+typedef __m128 DspLanes;
+static inline DspLanes lanes_load(const float *p) { return _mm_loadu_ps(p); }
+static inline void lanes_store(float *p, DspLanes v) { _mm_storeu_ps(p, v); }
+static inline DspLanes lanes_set(float x) { return _mm_set1_ps(x); }
+static inline DspLanes lanes_mul(DspLanes a, DspLanes b) { return _mm_mul_ps(a, b); }
+static inline DspLanes lanes_add(DspLanes a, DspLanes b) { return _mm_add_ps(a, b); }
+static inline DspLanes lanes_sub(DspLanes a, DspLanes b) { return _mm_sub_ps(a, b); }
+static inline DspLanes lanes_abs(DspLanes a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+static inline DspLanes lanes_max(DspLanes a, DspLanes b) { return _mm_max_ps(a, b); }
+static inline DspLanes lanes_above(DspLanes a, DspLanes b) { return _mm_and_ps(_mm_cmpgt_ps(a, b), _mm_set1_ps(1.0f)); }
+static inline DspLanes lanes_pairwise_add(DspLanes a, DspLanes b) {
+    return _mm_add_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+}
+static inline DspLanes lanes_sqrt(DspLanes a) { return _mm_sqrt_ps(a); }
+#else
+typedef struct { float v[DSP_LANES]; } DspLanes;
+static inline DspLanes lanes_load(const float *p) { DspLanes r; memcpy(r.v, p, sizeof(r.v)); return r; }
+static inline void lanes_store(float *p, DspLanes a) { memcpy(p, a.v, sizeof(a.v)); }
+static inline DspLanes lanes_set(float x) { DspLanes r; for (int i = 0; i < DSP_LANES; i++) r.v[i] = x; return r; }
+static inline DspLanes lanes_mul(DspLanes a, DspLanes b) { for (int i = 0; i < DSP_LANES; i++) a.v[i] *= b.v[i]; return a; }
+static inline DspLanes lanes_add(DspLanes a, DspLanes b) { for (int i = 0; i < DSP_LANES; i++) a.v[i] += b.v[i]; return a; }
+static inline DspLanes lanes_sub(DspLanes a, DspLanes b) { for (int i = 0; i < DSP_LANES; i++) a.v[i] -= b.v[i]; return a; }
+static inline DspLanes lanes_abs(DspLanes a) { for (int i = 0; i < DSP_LANES; i++) a.v[i] = fabsf(a.v[i]); return a; }
+static inline DspLanes lanes_max(DspLanes a, DspLanes b) { for (int i = 0; i < DSP_LANES; i++) a.v[i] = fmaxf(a.v[i], b.v[i]); return a; }
+static inline DspLanes lanes_above(DspLanes a, DspLanes b) { for (int i = 0; i < DSP_LANES; i++) a.v[i] = a.v[i] > b.v[i] ? 1.0f : 0.0f; return a; }
+static inline DspLanes lanes_pairwise_add(DspLanes a, DspLanes b) {
+    DspLanes r = {{a.v[0] + a.v[1], a.v[2] + a.v[3], b.v[0] + b.v[1], b.v[2] + b.v[3]}};
+    return r;
+}
+static inline DspLanes lanes_sqrt(DspLanes a) { for (int i = 0; i < DSP_LANES; i++) a.v[i] = sqrtf(a.v[i]); return a; }
+#endif
+
+// log2 of a positive normal float to about 0.008: exponent plus
+// log2(1 + f) ~ f + 0.3466 f (1 - f) on the mantissa fraction, exact at
+// powers of two
+static inline float fast_log2f(float x) {
+    uint32_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    const float exponent = (float)((int32_t)(bits >> 23) - 127);
+    bits = (bits & 0x007FFFFFu) | 0x3F800000u;
+    float f;
+    memcpy(&f, &bits, sizeof(f));
+    f -= 1.0f;
+    return exponent + f + 0.3466f * f * (1.0f - f);
+}
+
+static inline DspLanes lanes_log2(DspLanes a) {
+    float v[DSP_LANES];
+    lanes_store(v, a);
+    for (int i = 0; i < DSP_LANES; i++) v[i] = fast_log2f(v[i]);
+    return lanes_load(v);
+}
+
+#endif // DSP_LANES_H
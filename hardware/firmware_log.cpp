@@ -0,0 +1,366 @@
+/**
+ * Firmware Log Implementation
+ *
+ * A bounded multi-producer ring in the style of Vyukov's queue. Each slot
+ * carries a sequence word; a writer claims position pos with a CAS on the
+ * head once the slot's sequence says it is free for pos's lap, fills it
+ * and publishes it with a release store, so a writer preempted between
+ * claim and publish only holds back the drain, never other writers.
+ * Sequences are kept relative to the slot index so that the zero-filled
+ * ring is valid before any initialization:
+ *
+ *   pos & ~MASK       slot free for the writer of pos
+ *   (pos & ~MASK) + 1 record of pos ready for the drain
+ */
+
+#include "firmware_log.h"
+#include <atomic>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef TEENSY
+    #include <Arduino.h>
+#else
+    #include <chrono>
+    #include <condition_variable>
+    #include <mutex>
+    #include <thread>
+    #if defined(__linux__)
+        #include <pthread.h>
+        #include <sched.h>
+    #endif
+#endif
+
+#define LOG_MASK (FIRMWARE_LOG_CAPACITY - 1)
+static_assert((FIRMWARE_LOG_CAPACITY & LOG_MASK) == 0, "FIRMWARE_LOG_CAPACITY must be a power of two");
+
+// Argument classes, as va_arg has to read them
+typedef enum {
+    LOG_ARG_NONE = 0,       // %% or a conversion that is printed as is
+    LOG_ARG_INT,
+    LOG_ARG_LONG,
+    LOG_ARG_LLONG,
+    LOG_ARG_SIZE,
+    LOG_ARG_INTMAX,
+    LOG_ARG_PTRDIFF,
+    LOG_ARG_DOUBLE,
+    LOG_ARG_LDOUBLE,        // Kept as a double
+    LOG_ARG_POINTER
+} LogArgKind;
+
+typedef union {
+    long long i;
+    double d;
+    const void *p;
+} LogArg;
+
+typedef struct {
+    std::atomic<uint32_t> sequence;
+    uint32_t timestamp_us;
+    const char *format;
+    uint8_t argc;
+    LogArg args[FIRMWARE_LOG_MAX_ARGS];
+} LogRecord;
+
+static LogRecord g_ring[FIRMWARE_LOG_CAPACITY];
+static std::atomic<uint32_t> g_head{0};
+static std::atomic<uint32_t> g_dropped{0};
+
+// Drain side, owned by whoever holds g_draining; a flag rather than a
+// mutex, so it builds without a threads library
+static std::atomic_flag g_draining = ATOMIC_FLAG_INIT;
+static uint32_t g_tail = 0;
+static uint32_t g_dropped_reported = 0;
+
+static uint32_t log_clock_us() {
+#ifdef TEENSY
+    return micros();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)ts.tv_sec * 1000000u + (uint32_t)(ts.tv_nsec / 1000);
+#endif
+}
+
+/**
+ * Length of the conversion spec at format (which points at '%') and the
+ * class of its argument; an unsupported or cut-off spec has none
+ */
+static size_t log_conversion(const char *format, LogArgKind *kind) {
+    size_t n = 1;
+    *kind = LOG_ARG_NONE;
+    if (format[n] == '%') {
+        return 2;
+    }
+    while (format[n] != '\0' && strchr("-+ #0", format[n]) != NULL) n++;
+    while (format[n] >= '0' && format[n] <= '9') n++;
+    if (format[n] == '.') {
+        n++;
+        while (format[n] >= '0' && format[n] <= '9') n++;
+    }
+
+    LogArgKind integer = LOG_ARG_INT;
+    bool long_double = false;
+    switch (format[n]) {
+        case 'h':
+            n += format[n + 1] == 'h' ? 2 : 1;
+            break;
+        case 'l':
+            integer = format[n + 1] == 'l' ? LOG_ARG_LLONG : LOG_ARG_LONG;
+            n += format[n + 1] == 'l' ? 2 : 1;
+            break;
+        case 'z': integer = LOG_ARG_SIZE; n++; break;
+        case 'j': integer = LOG_ARG_INTMAX; n++; break;
+        case 't': integer = LOG_ARG_PTRDIFF; n++; break;
+        case 'L': long_double = true; n++; break;
+        default: break;
+    }
+
+    const char c = format[n];
+    if (c == '\0') {
+        return n;
+    }
+    if (strchr("diouxXc", c) != NULL) {
+        *kind = integer;
+    } else if (strchr("eEfFgGaA", c) != NULL) {
+        *kind = long_double ? LOG_ARG_LDOUBLE : LOG_ARG_DOUBLE;
+    } else if (c == 's' || c == 'p') {
+        *kind = LOG_ARG_POINTER;
+    }
+    return n + 1;
+}
+
+bool firmware_log(const char *format, ...) {
+    if (format == NULL) {
+        return false;
+    }
+
+    // Pick up the arguments before claiming a slot, so the slot is held
+    // for a copy only
+    LogArg args[FIRMWARE_LOG_MAX_ARGS];
+    uint8_t argc = 0;
+    va_list ap;
+    va_start(ap, format);
+    for (const char *p = format; *p != '\0' && argc < FIRMWARE_LOG_MAX_ARGS;) {
+        if (*p != '%') {
+            p++;
+            continue;
+        }
+        LogArgKind kind;
+        p += log_conversion(p, &kind);
+        switch (kind) {
+            case LOG_ARG_INT: args[argc++].i = va_arg(ap, int); break;
+            case LOG_ARG_LONG: args[argc++].i = va_arg(ap, long); break;
+            case LOG_ARG_LLONG: args[argc++].i = va_arg(ap, long long); break;
+            case LOG_ARG_SIZE: args[argc++].i = (long long)va_arg(ap, size_t); break;
+            case LOG_ARG_INTMAX: args[argc++].i = (long long)va_arg(ap, intmax_t); break;
+            case LOG_ARG_PTRDIFF: args[argc++].i = (long long)va_arg(ap, ptrdiff_t); break;
+            case LOG_ARG_DOUBLE: args[argc++].d = va_arg(ap, double); break;
+            case LOG_ARG_LDOUBLE: args[argc++].d = (double)va_arg(ap, long double); break;
+            case LOG_ARG_POINTER: args[argc++].p = va_arg(ap, const void *); break;
+            case LOG_ARG_NONE: break;
+        }
+    }
+    va_end(ap);
+    const uint32_t now_us = log_clock_us();
+
+    uint32_t pos = g_head.load(std::memory_order_relaxed);
+    LogRecord *record;
+    for (;;) {
+        record = &g_ring[pos & LOG_MASK];
+        const int32_t lag = (int32_t)(record->sequence.load(std::memory_order_acquire) - (pos & ~LOG_MASK));
+        if (lag == 0) {
+            if (g_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (lag < 0) {
+            // The slot still holds the record of the previous lap
+            g_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = g_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    record->timestamp_us = now_us;
+    record->format = format;
+    record->argc = argc;
+    memcpy(record->args, args, argc * sizeof(LogArg));
+    record->sequence.store((pos & ~LOG_MASK) + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * printf of one record into line, spec by spec
+ */
+static void log_format(const char *format, const LogArg *args, uint8_t argc, char *line, size_t size) {
+    size_t length = 0;
+    uint8_t next = 0;
+    for (const char *p = format; *p != '\0' && length + 1 < size;) {
+        if (*p != '%') {
+            line[length++] = *p++;
+            continue;
+        }
+        LogArgKind kind;
+        const size_t n = log_conversion(p, &kind);
+        char spec[32];
+        if (kind == LOG_ARG_NONE || next == argc || n >= sizeof(spec)) {
+            // %%, or a spec without an argument or too long: copied through
+            if (kind != LOG_ARG_NONE && next < argc) {
+                next++;
+            }
+            if (n == 2 && p[1] == '%') {
+                line[length++] = '%';
+            } else {
+                const size_t copy = n < size - 1 - length ? n : size - 1 - length;
+                memcpy(&line[length], p, copy);
+                length += copy;
+            }
+            p += n;
+            continue;
+        }
+
+        memcpy(spec, p, n);
+        spec[n] = '\0';
+        if (kind == LOG_ARG_LDOUBLE) {
+            // Stored as a double: drop the L
+            memmove(&spec[n - 2], &spec[n - 1], 2);
+        }
+        const LogArg arg = args[next++];
+        int written;
+        switch (kind) {
+            case LOG_ARG_INT: written = snprintf(&line[length], size - length, spec, (int)arg.i); break;
+            case LOG_ARG_LONG: written = snprintf(&line[length], size - length, spec, (long)arg.i); break;
+            case LOG_ARG_LLONG: written = snprintf(&line[length], size - length, spec, arg.i); break;
+            case LOG_ARG_SIZE: written = snprintf(&line[length], size - length, spec, (size_t)arg.i); break;
+            case LOG_ARG_INTMAX: written = snprintf(&line[length], size - length, spec, (intmax_t)arg.i); break;
+            case LOG_ARG_PTRDIFF: written = snprintf(&line[length], size - length, spec, (ptrdiff_t)arg.i); break;
+            case LOG_ARG_DOUBLE:
+            case LOG_ARG_LDOUBLE: written = snprintf(&line[length], size - length, spec, arg.d); break;
+            case LOG_ARG_POINTER:
+            default:
+                if (spec[n - 1] == 's') {
+                    const char *text = arg.p != NULL ? (const char *)arg.p : "(null)";
+                    written = snprintf(&line[length], size - length, spec, text);
+                } else {
+                    written = snprintf(&line[length], size - length, spec, arg.p);
+                }
+                break;
+        }
+        if (written > 0) {
+            length += (size_t)written < size - length ? (size_t)written : size - 1 - length;
+        }
+        p += n;
+    }
+    line[length] = '\0';
+}
+
+static void log_stdout_sink(uint32_t timestamp_us, const char *line, void *context) {
+    (void)timestamp_us;
+    (void)context;
+    fputs(line, stdout);
+}
+
+size_t firmware_log_drain(FirmwareLogSink sink, void *context, size_t max_records) {
+    if (sink == NULL) {
+        sink = log_stdout_sink;
+    }
+    if (g_draining.test_and_set(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    char line[FIRMWARE_LOG_LINE_MAX];
+    size_t drained = 0;
+    while (max_records == 0 || drained < max_records) {
+        LogRecord *record = &g_ring[g_tail & LOG_MASK];
+        const uint32_t lap = g_tail & ~LOG_MASK;
+        if (record->sequence.load(std::memory_order_acquire) != lap + 1) {
+            break;      // Empty, or the next record is still being written
+        }
+        const uint32_t timestamp_us = record->timestamp_us;
+        const char *format = record->format;
+        const uint8_t argc = record->argc;
+        LogArg args[FIRMWARE_LOG_MAX_ARGS];
+        memcpy(args, record->args, argc * sizeof(LogArg));
+        record->sequence.store(lap + FIRMWARE_LOG_CAPACITY, std::memory_order_release);
+        g_tail++;
+
+        log_format(format, args, argc, line, sizeof(line));
+        sink(timestamp_us, line, context);
+        drained++;
+    }
+
+    const uint32_t dropped = g_dropped.load(std::memory_order_relaxed);
+    if (dropped != g_dropped_reported) {
+        snprintf(line, sizeof(line), "[FirmwareLog] %u records dropped, ring full\n",
+                 (unsigned)(dropped - g_dropped_reported));
+        g_dropped_reported = dropped;
+        sink(log_clock_us(), line, context);
+    }
+    g_draining.clear(std::memory_order_release);
+    return drained;
+}
+
+uint32_t firmware_log_dropped(void) {
+    return g_dropped.load(std::memory_order_relaxed);
+}
+
+#ifndef TEENSY
+// Background drainer for hosts
+static std::mutex g_drainer_mutex;
+static std::condition_variable g_drainer_wake;
+static std::thread g_drainer;
+static bool g_drainer_stop = false;
+
+bool firmware_log_start_drainer(FirmwareLogSink sink, void *context, uint32_t interval_ms) {
+    std::lock_guard<std::mutex> lock(g_drainer_mutex);
+    if (g_drainer.joinable()) {
+        return false;
+    }
+    g_drainer_stop = false;
+    g_drainer = std::thread([sink, context, interval_ms] {
+#if defined(__linux__) && defined(SCHED_IDLE)
+        // Below every normal thread, so draining never competes with audio
+        struct sched_param param;
+        memset(&param, 0, sizeof(param));
+        pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+        const auto interval = std::chrono::milliseconds(interval_ms > 0 ? interval_ms : 1);
+        std::unique_lock<std::mutex> wait_lock(g_drainer_mutex);
+        while (!g_drainer_stop) {
+            wait_lock.unlock();
+            firmware_log_drain(sink, context, 0);
+            wait_lock.lock();
+            g_drainer_wake.wait_for(wait_lock, interval, [] { return g_drainer_stop; });
+        }
+        wait_lock.unlock();
+        firmware_log_drain(sink, context, 0);
+    });
+    return true;
+}
+
+void firmware_log_stop_drainer(void) {
+    std::thread drainer;
+    {
+        std::lock_guard<std::mutex> lock(g_drainer_mutex);
+        g_drainer_stop = true;
+        drainer.swap(g_drainer);
+    }
+    g_drainer_wake.notify_all();
+    if (drainer.joinable()) {
+        drainer.join();
+    }
+}
+#else
+bool firmware_log_start_drainer(FirmwareLogSink sink, void *context, uint32_t interval_ms) {
+    (void)sink;
+    (void)context;
+    (void)interval_ms;
+    return false;
+}
+
+void firmware_log_stop_drainer(void) {
+}
+#endif
@@ -0,0 +1,92 @@
+/**
+ * Firmware Log - deferred logging for the hardware modules
+ * Shared by hybrid_node, i2s_bridge and phi_sensor
+ *
+ * firmware_log() is safe in the audio callback and in interrupt handlers:
+ * it stores the format pointer, a timestamp and the raw arguments in a
+ * lock-free ring and returns, with no formatting, locking or I/O. A
+ * low-priority task formats and writes the records with
+ * firmware_log_drain(): loop() on Teensy, or the background drainer of
+ * firmware_log_start_drainer() on hosts. When the ring is full a record
+ * is dropped and counted rather than waited for.
+ *
+ * Only pointers are stored, so the format and every %s argument must
+ * outlive the record: string literals or other static strings. At most
+ * FIRMWARE_LOG_MAX_ARGS conversions per record; the printf conversions
+ * d i u o x X c e E f F g G a A s p are supported with the usual flags,
+ * width, precision (not '*') and length modifiers.
+ */
+
+#ifndef FIRMWARE_LOG_H
+#define FIRMWARE_LOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FIRMWARE_LOG_CAPACITY   256         // Records in the ring (power of two)
+#define FIRMWARE_LOG_MAX_ARGS   6           // Conversions per record
+#define FIRMWARE_LOG_LINE_MAX   256         // Formatted length, longer lines are cut
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FIRMWARE_LOG_PRINTF(fmt, args) __attribute__((format(printf, fmt, args)))
+#else
+#define FIRMWARE_LOG_PRINTF(fmt, args)
+#endif
+
+/**
+ * Receives each formatted record from firmware_log_drain
+ *
+ * @param timestamp_us Time of the firmware_log call (µs, wraps)
+ * @param line Formatted text, including any newline of the format
+ * @param context Pointer given to firmware_log_drain
+ */
+typedef void (*FirmwareLogSink)(uint32_t timestamp_us, const char *line, void *context);
+
+/**
+ * Queue a record; real-time and interrupt safe, lock-free
+ *
+ * @param format printf format, stored by pointer
+ * @return true if queued, false if the ring was full and the record dropped
+ */
+bool firmware_log(const char *format, ...) FIRMWARE_LOG_PRINTF(1, 2);
+
+/**
+ * Format and hand queued records to a sink, oldest first. One drain at a
+ * time: a call while another is in progress returns 0 at once.
+ *
+ * @param sink Receiver of the lines, NULL writes them to stdout
+ * @param context Passed to the sink
+ * @param max_records Most records to drain, 0 for all queued
+ * @return Number of records drained
+ */
+size_t firmware_log_drain(FirmwareLogSink sink, void *context, size_t max_records);
+
+/**
+ * Records dropped because the ring was full, since start-up
+ */
+uint32_t firmware_log_dropped(void);
+
+/**
+ * Drain from a background thread at idle priority every interval_ms
+ * (hosts only; on Teensy call firmware_log_drain from loop())
+ *
+ * @return true if the drainer runs, false if one already did or threads
+ *         are unavailable
+ */
+bool firmware_log_start_drainer(FirmwareLogSink sink, void *context, uint32_t interval_ms);
+
+/**
+ * Stop the background drainer after a last drain
+ */
+void firmware_log_stop_drainer(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FIRMWARE_LOG_H
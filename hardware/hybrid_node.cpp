@@ -8,10 +8,23 @@
  */
 
 #include "hybrid_node.h"
+#include "firmware_log.h"
+#include "dsp_core.h"
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
 #include <time.h>
+#include <errno.h>
+#include <atomic>
+#include <new>
+
+#if defined(__linux__)
+    #include <stdlib.h>
+    #include <pthread.h>
+    #include <sched.h>
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
 
 // Platform-specific includes (conditionally compiled)
 #ifdef TEENSY
@@ -19,427 +32,1296 @@
     #include <Audio.h>
 #elif defined(RASPBERRY_PI)
     #include <wiringPi.h>
+    #include <alsa/asoundlib.h>
+#endif
+
+// CMSIS-DSP filter bank; the FFT backend (CMSIS-DSP, KissFFT or built-in)
+// lives in the DSP core
+#ifdef USE_CMSIS_DSP
+    #include <arm_math.h>
+#endif
+
+// Lane vectors of the analog filter bank, level metrics and output stage
+#include "dsp_lanes.h"
+#if defined(HYBRID_NODE_Q31) && !defined(__ARM_NEON) && !defined(__ARM_NEON__) && (defined(__SSE2__) || defined(_M_X64))
+    #include <emmintrin.h>
+    #define HYBRID_Q31_SSE2 1
+#endif
+
+// Flush-to-zero for the length of a call into the node, with the previous
+// mode and flags put back on the way out. Filter and envelope states decay
+// into subnormals on silence, which cost tens of cycles per operation in
+// microcode on x86 and trap to software on some ARM cores; flushed, a quiet
+// input costs what a loud one does. The underflow flag cleared on entry is
+// read back once per buffer as a cheap record that flushing happened.
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #include <xmmintrin.h>
+#endif
+
+class FpModeGuard {
+public:
+    FpModeGuard() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        saved_ = _mm_getcsr();
+        _mm_setcsr((saved_ & ~0x3fu) | 0x8040u);  // FTZ | DAZ, flags cleared
+#elif defined(__aarch64__)
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(saved_));
+        __asm__ __volatile__("mrs %0, fpsr" : "=r"(saved_status_));
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(saved_ | (1ull << 24)));  // FZ
+        __asm__ __volatile__("msr fpsr, %0" : : "r"(saved_status_ & ~0x9full));
+#elif defined(__arm__) && defined(__ARM_FP)
+        uint32_t fpscr;
+        __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+        saved_ = fpscr;
+        fpscr = (fpscr | (1u << 24)) & ~0x9fu;  // FZ, flags cleared
+        __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr));
+#endif
+    }
+
+    ~FpModeGuard() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        _mm_setcsr((unsigned)saved_);
+#elif defined(__aarch64__)
+        __asm__ __volatile__("msr fpcr, %0" : : "r"(saved_));
+        __asm__ __volatile__("msr fpsr, %0" : : "r"(saved_status_));
+#elif defined(__arm__) && defined(__ARM_FP)
+        const uint32_t fpscr = (uint32_t)saved_;
+        __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr));
+#endif
+    }
+
+    FpModeGuard(const FpModeGuard&) = delete;
+    FpModeGuard& operator=(const FpModeGuard&) = delete;
+
+    // True if a result has underflowed (and was flushed) since the guard
+    // was set or last read
+    bool take_underflow() {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+        const unsigned csr = _mm_getcsr();
+        if ((csr & 0x12u) == 0) return false;  // UE | DE
+        _mm_setcsr(csr & ~0x3fu);
+        return true;
+#elif defined(__aarch64__)
+        uint64_t fpsr;
+        __asm__ __volatile__("mrs %0, fpsr" : "=r"(fpsr));
+        if ((fpsr & 0x88u) == 0) return false;  // IDC | UFC
+        __asm__ __volatile__("msr fpsr, %0" : : "r"(fpsr & ~0x9full));
+        return true;
+#elif defined(__arm__) && defined(__ARM_FP)
+        uint32_t fpscr;
+        __asm__ __volatile__("vmrs %0, fpscr" : "=r"(fpscr));
+        if ((fpscr & 0x88u) == 0) return false;  // IDC | UFC
+        fpscr &= ~0x9fu;
+        __asm__ __volatile__("vmsr fpscr, %0" : : "r"(fpscr));
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+    uint64_t saved_ = 0;
+#if defined(__aarch64__)
+    uint64_t saved_status_ = 0;
+#endif
+};
+
+// Analog filter bank (FR-002): Butterworth high-pass and low-pass cascades
+// of order / 2 biquads each, designed for the cutoffs in filter_design and
+// redesigned when the configuration changes them
+#define ANALOG_FILTER_MAX_ORDER    8
+#define ANALOG_FILTER_MAX_SECTIONS ANALOG_FILTER_MAX_ORDER
+#define ANALOG_FILTER_LANES        DSP_LANES
+static_assert(HYBRID_ADC_CHANNELS <= ANALOG_FILTER_LANES, "one filter lane per ADC channel");
+static_assert(HYBRID_BOOT_FILTER_SECTIONS == ANALOG_FILTER_MAX_SECTIONS, "boot image holds the whole filter bank");
+
+typedef DspBiquad BiquadSection;
+
+typedef struct {
+    float hpf_cutoff;
+    float lpf_cutoff;
+    uint32_t sample_rate;
+    uint8_t order;
+} FilterDesign;
+
+// Features of one analyzed spectrum (FR-003), computed by the DSP core
+typedef DspSpectralFeatures SpectralFeatures;
+
+#define SPECTRAL_ROLLOFF_FRACTION DSP_ROLLOFF_FRACTION
+
+// ICI peak detector (FR-003) on the flux of each analysis
+#define ICI_INTERVALS           16          // Intervals in the running mean and variance
+#define ICI_REFRACTORY_MS       30.0f       // Shortest time between two peaks
+#define ICI_MAX_INTERVAL_MS     2000.0f     // Longer gaps start a new peak sequence
+#define ICI_THRESHOLD_TIME_S    1.0f        // Time constant of the adaptive threshold
+#define ICI_THRESHOLD_K         3.0f        // Mean absolute deviations above the mean flux
+#define ICI_THRESHOLD_MIN       0.1f        // Floor of the threshold
+#define ICI_DEFAULT_MS          100.0f      // Reported until there is an interval
+
+// Coherence (FR-003): magnitude-squared coherence of ADC channels 0 and 1
+// from auto and cross spectra averaged over the STFT frames
+#define COHERENCE_TIME_S        0.5f        // Time constant of the spectra averages
+
+// THD and SNR (FR-002) from each analysis' magnitudes: the fundamental is
+// tracked from one analysis to the next and placed between bins by a
+// parabola, harmonics are the peaks nearest its multiples, and a tone's
+// power is that of the window's main lobe around its peak
+#define DISTORTION_HARMONICS    9           // Highest harmonic in the THD
+#define DISTORTION_TRACK_BINS   2           // Search either side of the tracked fundamental
+#define DISTORTION_MIN_SHARE    0.05f       // Fundamental's share of the power to count as a tone
+#define DISTORTION_GUARD_BINS   16          // Bins either side of the fundamental left out of the noise
+
+// Loopback delay calibration (SC-001): one period of an order-12 maximum
+// length sequence captured over CAL_XCORR_SIZE frames, so delays up to
+// CAL_XCORR_SIZE - CAL_MLS_LENGTH frames are found without wrap-around
+#define CAL_MLS_ORDER           12
+#define CAL_MLS_LENGTH          ((1u << CAL_MLS_ORDER) - 1)
+#define CAL_MLS_TAPS            0xE08u      // Galois LFSR of x^12 + x^11 + x^10 + x^4 + 1
+#define CAL_MLS_LEVEL           0.25f       // Stimulus amplitude (-12 dBFS)
+#define CAL_XCORR_SIZE          8192        // Capture and transform length (power of two)
+#define CAL_XCORR_GUARD         8           // Lags around the peak not counted as sidelobe
+#define CAL_XCORR_FLOOR         0.01        // Reference power floor of the deconvolution, of its mean
+#define CAL_XCORR_TAPER         0.75        // Fraction of Nyquist the roll-off starts at
+#define CAL_LOOPBACK_MIN_RATIO  4.0f        // Peak over sidelobe of a valid measurement
+#define CAL_SINC_HALF_TAPS      16          // Interpolation kernel half-length (lags)
+
+// DAC gain calibration (FR-008): CAL_TONE_FREQ on one DAC audio channel at
+// a time, its amplitude and phase on the ADC channel of the same index by
+// a Goertzel bin over whole cycles once the loop has settled
+#define CAL_TONE_LEVEL          0.5f        // Tone amplitude (-6 dBFS)
+#define CAL_TONE_CYCLES         100         // Cycles measured (100 ms at 1 kHz)
+#define CAL_TONE_SETTLE_MS      20.0f       // Past the loop delay, for filters and codec
+#define CAL_TONE_MIN_RATIO      0.01f       // Returned amplitude of a connected loop (-40 dB)
+
+// Four float lanes for the filter bank and the level metrics (dsp_lanes.h)
+typedef DspLanes FilterLanes;
+
+static_assert(HYBRID_FFT_SIZE >= DSP_FFT_MIN_SIZE && (HYBRID_FFT_SIZE & (HYBRID_FFT_SIZE - 1)) == 0,
+              "HYBRID_FFT_SIZE must be a power of two");
+
+#ifdef HYBRID_NODE_Q31
+// Fixed-point path: the built-in real FFT in Q31, with the input and every
+// butterfly stage scaled by 1/2 so no stage can overflow. Twiddles and the
+// analysis window span ±INT32_MAX, so products never reach 2^62.
+#define Q31_FFT_HALF (HYBRID_FFT_SIZE / 2)
+static_assert(HYBRID_FFT_SIZE >= 4 && (HYBRID_FFT_SIZE & (HYBRID_FFT_SIZE - 1)) == 0,
+              "HYBRID_FFT_SIZE must be a power of two");
+static int32_t g_q31_twiddle[HYBRID_FFT_SIZE];         // re, im of exp(-2πik/N), k < N/2
+static uint16_t g_q31_bitrev[Q31_FFT_HALF];
+#endif
+
+// Deferred DSP hand-off (defer_dsp): hybrid_process pushes filtered blocks,
+// hybrid_dsp_poll pops them. Each counter has one writer; the slot of a
+// block belongs to the producer until head passes it and to the consumer
+// until tail does.
+static_assert((HYBRID_DSP_RING_BLOCKS & (HYBRID_DSP_RING_BLOCKS - 1)) == 0,
+              "HYBRID_DSP_RING_BLOCKS must be a power of two");
+typedef struct {
+    uint32_t frames;
+    uint32_t start_us;
+#ifdef HYBRID_NODE_Q31
+    bool q31;                       // Pushed by hybrid_process_q31
+    union {
+        float samples[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        int32_t samples_q31[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+    };
+#else
+    float samples[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+#endif
+} DspBlock;
+
+// Status snapshots for readers outside the writing contexts, each behind a
+// seqlock: the sequence is odd while the writer copies, and a reader that
+// sees the same even value before and after its copy has a consistent
+// frame. Writers never wait; readers retry, so they must not preempt the
+// writer of the slot they read. The audio context owns the node slot, the
+// context running dsp_analyze_block the analysis slot, and control calls
+// publish both while the node is stopped.
+typedef struct {
+    HybridNodeMode mode;
+    bool is_running;
+    bool is_calibrated;
+    CalibrationData calibration;
+    NodeStatistics stats;
+    HybridRealtimeStatus realtime;
+} NodeSnapshot;
+
+typedef struct {
+    AnalogMetrics analog;
+    DSPMetrics dsp;
+    ControlVoltage control;
+    PhiLinkStatus phi_link;
+    SafetyTelemetry safety;
+    HybridStageTiming stage[HYBRID_STAGE_COUNT];   // Analysis stages only
+} AnalysisSnapshot;
+
+// Running sums behind one HybridStageTiming, written by the context that
+// runs the stage
+typedef struct {
+    uint32_t count;
+    uint32_t min_ns;
+    uint32_t max_ns;
+    uint64_t total_ns;
+} StageAccumulator;
+
+template <typename T>
+struct StatusSlot {
+    std::atomic<uint32_t> sequence{0};
+    T data;
+};
+
+// Latency histogram of hybrid_process (SC-001). Values below
+// LATENCY_SUB_BUCKETS ns get one bucket each, then every power of two is
+// split into LATENCY_SUB_BUCKETS / 2 buckets. The counters are atomics so the
+// main loop can read and reset them while the DMA callback records.
+#define LATENCY_SUB_BUCKET_BITS 5
+#define LATENCY_SUB_BUCKETS     (1u << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_BUCKETS         (LATENCY_SUB_BUCKETS + (32 - LATENCY_SUB_BUCKET_BITS) * (LATENCY_SUB_BUCKETS / 2))
+
+// Real-time mode (enable_realtime)
+#define REALTIME_DEFAULT_PRIORITY   80
+#define REALTIME_STACK_PREFAULT     (256 * 1024)    // Stack bytes touched by hybrid_realtime_enter
+
+// Load governor (enable_load_governor)
+#define LOAD_GOVERNOR_HIGH      80.0f       // Default governor_high_load (%)
+#define LOAD_GOVERNOR_LOW       50.0f       // Default governor_low_load (%)
+#define LOAD_GOVERNOR_ALPHA     0.125f      // Smoothing of cpu_load per buffer
+#define LOAD_GOVERNOR_HOLD      8           // Buffers between two level changes
+
+// Deadline watchdog
+#define DEADLINE_NEAR_MISS      0.8f        // Default deadline_near_miss
+
+// Φ link (enable_phi_link)
+#define PHI_LINK_TIMEOUT_MS     100         // Default phi_link_timeout_ms
+
+// USB audio backend (hybrid_usb_open)
+#define USB_RATE_WINDOW_MS      1024        // Node clock measured over this many ms of SOFs
+#define USB_RATE_TOLERANCE      0.01        // Measurements further off nominal are discarded
+#define USB_QUEUE_SMOOTHING_MS  64          // Averaging of the IN queue fill
+#define USB_FEEDBACK_SETTLE_MS  1000        // Queue error trimmed out over about this long
+#define USB_FEEDBACK_TRIM_PPM   1000.0      // Largest trim of the feedback
+
+// SPI converter backend (hybrid_spi_open)
+#define SPI_ADC_BITS            19          // MCP3208 conversion: start, mode, 3 input bits, sample,
+                                            // null and 12 data bits
+#define SPI_DAC_BITS            16          // MCP4822 write
+#define SPI_CS_GAP_NS           500         // Chip select high between transfers (MCP3208 tCSH)
+#define SPI_MAX_PRESCALE        7           // A transfer's clock divides by up to 2^7
+#define SPI_MAX_CS              3
+
+// LPSPI transmit command word (TCR) of a transfer; the simulated bus
+// decodes the same fields
+#define SPI_TCR_FRAMESZ(bits)   ((uint32_t)(bits) - 1)
+#define SPI_TCR_RXMSK           (1u << 19)  // Nothing received: DAC writes
+#define SPI_TCR_PCS(cs)         ((uint32_t)(cs) << 24)
+#define SPI_TCR_PRESCALE(p)     ((uint32_t)(p) << 27)
+#define SPI_TCR_CS(tcr)         (((tcr) >> 24) & 3u)
+
+// MCP3208 command and MCP4822 write words
+#define MCP3208_COMMAND(input)  ((1u << 18) | (1u << 17) | ((uint32_t)(input) << 14))
+#define MCP3208_INPUT(word)     (((word) >> 14) & 7u)
+#define MCP4822_CHANNEL_B       (1u << 15)
+#define MCP4822_GAIN_1X         (1u << 13)
+#define MCP4822_ACTIVE          (1u << 12)
+#define SPI_CODE_MASK           0xFFFu
+#define SPI_CODE_MID            2048
+
+#ifdef RASPBERRY_PI
+// Sample word of the codec PCMs: Q31 words run the fixed-point path in place
+#ifdef HYBRID_NODE_Q31
+typedef int32_t AlsaSample;
+#define ALSA_FORMAT             SND_PCM_FORMAT_S32_LE
+#define ALSA_DEFAULT_DEVICE     "hw:0"
+#else
+typedef float AlsaSample;
+#define ALSA_FORMAT             SND_PCM_FORMAT_FLOAT_LE
+#define ALSA_DEFAULT_DEVICE     "plughw:0"
+#endif
+#endif
+
+// Everything one node owns. Nodes share only the read-only Q31 FFT tables, so
+// each can run on its own core without touching another's cache lines.
+struct HybridNode {
+    HybridNodeConfig config;
+    HybridNodeStatus status;
+    bool initialized = false;
+    bool running = false;
+
+    // Processing buffers
+    float adc_buffer[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+    float dac_buffer[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+    float fft_input[HYBRID_FFT_SIZE];
+    float fft_output[HYBRID_FFT_SIZE + 2];          // Bins 0 to N/2, re/im
+    float fft_magnitude[HYBRID_FFT_SIZE / 2];
+    float fft_prev_magnitude[HYBRID_FFT_SIZE / 2];  // Spectrum of the previous analysis, for the flux
+
+    // STFT stage: the last HYBRID_FFT_SIZE mono frames in a ring, analyzed
+    // through fft_window each time fft_hop new frames have arrived
+    float fft_history[HYBRID_FFT_SIZE];
+    float fft_window[HYBRID_FFT_SIZE];
+    size_t fft_history_pos = 0;     // Next write, also the oldest frame
+    size_t fft_hop_fill = 0;        // Frames since the last analysis
+    size_t fft_hop = HYBRID_FFT_SIZE / 2;
+
+    // Coherence: channel 1's frames in a ring at the same position as the
+    // STFT's, its spectrum at each analysis, and the auto and cross spectra
+    // of the two channels averaged with weight coherence_alpha per analysis
+    bool coherence_stereo = false;  // enable_coherence with two ADC channels
+    float coherence_history[HYBRID_FFT_SIZE];
+    float coherence_output[HYBRID_FFT_SIZE + 2];
+    float coherence_sxx[HYBRID_FFT_SIZE / 2];
+    float coherence_syy[HYBRID_FFT_SIZE / 2];
+    float coherence_sxy[HYBRID_FFT_SIZE];           // re/im
+    float coherence_alpha = 0.0f;
+
+    // THD and SNR: the fundamental's peak bin at the last analysis, 0 for
+    // none, and the main lobe half-width of the analysis window in bins
+    size_t distortion_bin = 0;
+    size_t distortion_lobe = 2;
+
+    // Analog filter bank
+    BiquadSection filter_sections[ANALOG_FILTER_MAX_SECTIONS];
+    size_t filter_section_count = 0;
+    FilterDesign filter_design;
+    bool filter_designed = false;
+#ifdef USE_CMSIS_DSP
+    // CMSIS filters one channel at a time, so interleaved input goes through
+    // a per-channel scratch buffer
+    float filter_coeffs[5 * ANALOG_FILTER_MAX_SECTIONS];
+    float filter_state[HYBRID_ADC_CHANNELS][4 * ANALOG_FILTER_MAX_SECTIONS];
+    arm_biquad_casd_df1_inst_f32 filter[HYBRID_ADC_CHANNELS];
+    float filter_scratch[HYBRID_BUFFER_SIZE];
+#else
+    // Transposed direct form II state, one lane per channel
+    float filter_z1[ANALOG_FILTER_MAX_SECTIONS][ANALOG_FILTER_LANES];
+    float filter_z2[ANALOG_FILTER_MAX_SECTIONS][ANALOG_FILTER_LANES];
+#endif
+
+    // DSP core real FFT on the build's default backend, allocated by the
+    // first init and kept until the node is destroyed. It carries scratch
+    // space, so nodes cannot share it.
+    DspRealFft *fft = NULL;
+
+    // Cellular engine of HYBRID_MODE_HYBRID (hybrid_set_engine) and its
+    // mono input and output
+    HybridEngineProcess engine_process = NULL;
+    void *engine = NULL;
+    float engine_in[HYBRID_BUFFER_SIZE];
+    float engine_out[HYBRID_BUFFER_SIZE];
+
+    // Buffer observer (hybrid_set_buffer_observer), the stage times of the
+    // audio context's current buffer and frames_dropped after the last one
+    HybridBufferObserver buffer_observer = NULL;
+    void *observer_context = NULL;
+    uint32_t buffer_stage_ns[HYBRID_STAGE_COUNT] = {};
+    uint64_t observer_dropped = 0;
+    // Deadline watchdog (hybrid_set_deadline_callback) and load sheds
+    // requested from outside (hybrid_request_load_shed)
+    HybridBufferObserver deadline_callback = NULL;
+    void *deadline_context = NULL;
+    std::atomic<bool> shed_requested{false};
+
+#ifdef HYBRID_NODE_Q31
+    // Fixed-point path: Q30 filter coefficients {b0, b1, b2, a1, a2} and
+    // direct form I state {x1, x2, y1, y2} per section and channel; the
+    // STFT history and window in Q31. The history shares position and hop
+    // count with the float one, so a node runs one path or the other.
+    int32_t q31_adc_buffer[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+    int32_t q31_filter_coeffs[ANALOG_FILTER_MAX_SECTIONS][5];
+    int32_t q31_filter_state[ANALOG_FILTER_MAX_SECTIONS][HYBRID_ADC_CHANNELS][4];
+    int32_t q31_fft_history[HYBRID_FFT_SIZE];
+    int32_t q31_fft_window[HYBRID_FFT_SIZE];
+    int32_t q31_fft_work[HYBRID_FFT_SIZE];
+    uint32_t q31_fft_magnitude[HYBRID_FFT_SIZE / 2];
+    uint32_t q31_fft_prev_magnitude[HYBRID_FFT_SIZE / 2];
+#endif
+
+    // Deferred DSP hand-off
+    DspBlock dsp_ring[HYBRID_DSP_RING_BLOCKS];
+    std::atomic<uint32_t> dsp_head{0};  // Blocks pushed
+    std::atomic<uint32_t> dsp_tail{0};  // Blocks analyzed or discarded
+
+    // Control voltages the output stage ramps toward, published by whichever
+    // context last changed status.control
+    std::atomic<float> cv_out[2];
+
+    // Control loop (FR-004), control_period frames per update. The analysis
+    // side recomputes the targets once a period has passed; the output stage
+    // latches them at its own period boundaries and moves each CV per frame
+    // by level += (target - level) * cv_glide + step, a straight line when
+    // cv_glide is 0 and a one-pole glide when step is.
+    uint32_t control_period = HYBRID_BUFFER_SIZE;
+    uint32_t control_elapsed = 0;       // Analysis context: frames since the last update
+    float host_phi_depth = 0.0f;        // Last hybrid_set_control_voltage values, in force
+    float host_phi_phase = 0.0f;        // while the Φ link is not
+    uint32_t phi_link_idle = 0;         // Analysis context: frames since a new link frame
+    uint32_t cv_countdown = 0;          // Output stage: frames left in the period
+    float cv_glide = 0.0f;
+    float cv_level[2] = {0.0f, 0.0f};
+    float cv_target[2] = {0.0f, 0.0f};
+    float cv_step[2] = {0.0f, 0.0f};
+#ifdef HYBRID_NODE_Q31
+    int32_t q31_cv_glide = 0;           // The same ramp in Q31 DAC codes
+    int32_t q31_cv_level[2] = {0, 0};
+    int32_t q31_cv_target[2] = {0, 0};
+    int32_t q31_cv_step[2] = {0, 0};
 #endif
 
-// DSP library (use KissFFT or CMSIS-DSP based on platform)
-#ifdef USE_KISSFFT
-    #include <kiss_fft.h>
+    StatusSlot<NodeSnapshot> node_slot;
+    StatusSlot<AnalysisSnapshot> analysis_slot;
+
+    // DSP state
+    uint32_t last_zero_crossing = 0;
+
+    // ICI detector: a flux value one analysis back is a peak when it tops
+    // both neighbours and the adaptive threshold, and the last peak is at
+    // least ici_refractory frames ago. Times are in 1/256 frames since the
+    // analysis reset, placed between the analyses by a parabola through the
+    // three flux values. The last ICI_INTERVALS intervals sit in a ring whose
+    // sums give the mean and variance without a rescan.
+    float ici_flux[2] = {0.0f, 0.0f};   // Flux one and two analyses back
+    float ici_flux_mean = 0.0f;         // Exponential mean of the flux
+    float ici_flux_deviation = 0.0f;    // and of its absolute deviation
+    float ici_threshold = 0.0f;         // Threshold one analysis back
+    float ici_alpha = 0.0f;             // Averaging weight per analysis
+    uint32_t ici_refractory = 0;        // Frames
+    uint32_t ici_max_interval = 0;      // 1/256 frames
+    bool ici_have_peak = false;
+    uint64_t ici_last_peak = 0;         // 1/256 frames
+    uint32_t ici_intervals[ICI_INTERVALS];
+    uint32_t ici_interval_count = 0;
+    uint32_t ici_interval_next = 0;
+    uint64_t ici_sum = 0;
+    uint64_t ici_sum_sq = 0;
+    uint32_t ici_peak_hop = 0;          // Hop of the analysis one back
+
+    // Load governor. The audio context moves load_level after each buffer;
+    // the analysis context picks it up at the start of a block, so a block
+    // is analyzed at one level throughout.
+    std::atomic<uint8_t> load_level{HYBRID_LOAD_FULL};
+    uint32_t governor_hold = 0;         // Buffers before the level may move again
+    uint64_t governor_dropped = 0;      // frames_dropped at the last update
+    uint8_t analysis_level = HYBRID_LOAD_FULL;      // Analysis context from here
+    size_t fft_bins = HYBRID_FFT_SIZE / 2;          // Bins the magnitudes and features cover
+    size_t fft_prev_bins = HYBRID_FFT_SIZE / 2;     // and covered at the previous analysis
+    uint32_t fft_hop_count = 0;         // Hops completed since the analysis reset
+    uint32_t analysis_blocks = 0;       // Blocks analyzed at HYBRID_LOAD_ALTERNATE or above
+
+    // Latency histogram
+    std::atomic<uint32_t> latency_counts[LATENCY_BUCKETS];
+    std::atomic<uint32_t> latency_min_ns{UINT32_MAX};
+    std::atomic<uint32_t> latency_max_ns{0};
+
+    // Per-stage timing. The audio context owns the filter, engine and
+    // output stages, the context running dsp_analyze_block the rest. A statistics
+    // reset while running bumps the generation, and each context clears its
+    // own stages when it next sees the change.
+    StageAccumulator stage_time[HYBRID_STAGE_COUNT] = {
+        {0, UINT32_MAX, 0, 0}, {0, UINT32_MAX, 0, 0}, {0, UINT32_MAX, 0, 0},
+        {0, UINT32_MAX, 0, 0}, {0, UINT32_MAX, 0, 0}, {0, UINT32_MAX, 0, 0},
+        {0, UINT32_MAX, 0, 0}};
+    std::atomic<uint32_t> stage_generation{0};
+    uint32_t stage_seen_audio = 0;      // Generation each context last cleared
+    uint32_t stage_seen_analysis = 0;
+
+#ifdef HYBRID_NODE_SIMULATION
+    // Simulated ADC source and the position of the next frame it delivers
+    HybridSimConfig sim_config = {NULL, 0, false, CAL_TONE_FREQ, 0.5f, false};
+    uint64_t sim_position = 0;
+    float sim_input[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+    float sim_output[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+    // Loopback: DAC audio frames by the ADC position they play at, each
+    // cleared once read back
+    float sim_loop[HYBRID_SIM_LOOPBACK_FRAMES * HYBRID_ADC_CHANNELS];
 #endif
 
-// Global state
-static HybridNodeConfig g_config;
-static HybridNodeStatus g_status;
-static bool g_initialized = false;
-static bool g_running = false;
+    // USB audio backend, buffers allocated by hybrid_usb_open. OUT packets
+    // collect in usb_input, which has a packet of room past one buffer.
+    // usb_output is the IN queue: usb_ring_frames frames of whole buffers,
+    // then a copy of its first usb_packet_max frames so a packet that wraps
+    // is still contiguous. Written by the USB context only.
+    HybridUsbSample *usb_input = NULL;
+    HybridUsbSample *usb_output = NULL;
+    HybridUsbSample *usb_silence = NULL;        // One packet of zeros
+    HybridUsbConfig usb_config = {};
+    size_t usb_packet_max = 0;          // Frames in the longest packet either way
+    size_t usb_ring_frames = 0;
+    size_t usb_target = 0;              // IN queue frames the feedback holds
+    size_t usb_input_frames = 0;        // Collected towards the next buffer
+    uint64_t usb_written = 0;           // Frames processed into the IN queue
+    uint64_t usb_read = 0;              // and handed to IN packets
+    size_t usb_last_packet = 0;         // Frames of the IN packet the stack may still be sending
+    bool usb_primed = false;            // IN packets carry the queue rather than silence
+    uint32_t usb_sofs_per_ms = 1;
+    double usb_nominal = 0.0;           // Frames per SOF at the nominal rate
+    double usb_rate = 0.0;              // and on the node clock, as measured
+    double usb_queue_average = 0.0;
+    double usb_in_phase = 0.0;          // Fraction of a frame owed to the next IN packet
+    uint32_t usb_window_us = 0;         // Node clock at the first SOF of the measurement
+    uint32_t usb_window_sofs = 0;       // SOFs since, 0 before the first
+    uint32_t usb_last_sof_us = 0;       // Node clock at the previous SOF
+    uint64_t usb_buffers = 0;           // Buffers processed, behind the mean latency
+    uint64_t usb_latency_sum_us = 0;
+    HybridUsbStats usb_stats = {};
+    StatusSlot<HybridUsbStats> usb_slot;        // usb_stats as of the last IN packet
+
+    // Sample clock against the USB bus from the last measurement of any
+    // stream, or from the boot image; a new stream's feedback starts there
+    double clock_ppm = 0.0;
+    bool clock_measured = false;
+
+#ifdef HYBRID_NODE_Q31
+    // SPI converter backend, tables allocated by hybrid_spi_open. spi_tx
+    // holds both DMA halves of (command, data) word pairs, spi_slots pairs
+    // a frame; spi_rx both halves of the adc_channels conversions a frame,
+    // turned into Q31 in place once a half is complete.
+    uint32_t *spi_tx = NULL;
+    int32_t *spi_rx = NULL;
+    int32_t *spi_dac = NULL;            // Q31 output of a half, before it is encoded
+    HybridSpiConfig spi_config = {};
+    size_t spi_slots = 0;
+    unsigned spi_next_half = 0;         // Half the DMA completes next
+    bool spi_running = false;
+    HybridSpiStats spi_stats = {};
+    StatusSlot<HybridSpiStats> spi_slot;
+#endif
 
-// Processing buffers
-static float g_adc_buffer[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
-static float g_dac_buffer[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
-static float g_fft_input[HYBRID_FFT_SIZE];
-static float g_fft_output[HYBRID_FFT_SIZE];
+#ifdef RASPBERRY_PI
+    // Codec PCMs of the ALSA backend, NULL until hybrid_alsa_open
+    snd_pcm_t *alsa_capture = NULL;
+    snd_pcm_t *alsa_playback = NULL;
+    snd_pcm_uframes_t alsa_period = 0;  // Frames per period, one buffer
+    snd_pcm_uframes_t alsa_buffer = 0;  // Frames per ring
+    bool alsa_linked = false;           // Streams start and stop together
+    AlsaSample alsa_scratch[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];  // platform_adc_read/dac_write
+#endif
+};
 
-// DSP state
-static float g_prev_spectral_centroid = 0.0f;
-static uint32_t g_last_zero_crossing = 0;
-static float g_ici_buffer[32];  // Ring buffer for ICI calculation
-static uint8_t g_ici_index = 0;
+// Node behind the hybrid_node_* functions
+static HybridNode g_default_node;
 
 // Firmware version
 #define FIRMWARE_VERSION "1.0.0-hybrid-node"
 
 // Forward declarations
-static bool platform_adc_init();
-static bool platform_dac_init();
-static bool platform_adc_read(float *buffer, size_t frames);
-static bool platform_dac_write(const float *buffer, size_t frames);
-static void dsp_process_fft(const float *input, size_t frames);
-static void dsp_calculate_ici(float *ici_out);
-static void dsp_calculate_coherence(float *coherence_out);
-static void safety_check();
-static void apply_analog_filter(float *buffer, size_t frames);
-static void apply_control_voltage();
+static bool platform_adc_init(HybridNode *node);
+static bool platform_dac_init(HybridNode *node);
+static bool platform_adc_read(HybridNode *node, float *buffer, size_t frames);
+static bool platform_dac_write(HybridNode *node, const float *buffer, size_t frames);
+static bool calibrate_loopback(HybridNode *node, float *delay_frames, float *peak_ratio);
+static bool calibrate_tone(HybridNode *node, size_t channel, size_t settle_frames, float *ratio, float *phase,
+                           float *dc);
+static void dsp_process_fft(HybridNode *node, const float *input, size_t frames);
+static void dsp_analysis_init(HybridNode *node);
+static void dsp_analysis_reset(HybridNode *node);
+static void dsp_analyze_spectrum(HybridNode *node);
+static bool dsp_fft_init(HybridNode *node);
+static void dsp_analog_metrics(const float *buffer, size_t frames, size_t channels, AnalogMetrics *metrics);
+static void dsp_metrics_combine(AnalogMetrics *metrics, size_t channels);
+static void dsp_calculate_ici(HybridNode *node, float *ici_out);
+static void dsp_ici_detect(HybridNode *node, float flux);
+static void dsp_calculate_coherence(HybridNode *node, float *coherence_out);
+static void dsp_coherence_update(HybridNode *node);
+static void safety_check(HybridNode *node);
+static void apply_analog_filter(HybridNode *node, float *buffer, size_t frames);
+static void filter_design(HybridNode *node);
+static void filter_load(HybridNode *node, const HybridBootImage *image);
+static void filter_commit(HybridNode *node, const FilterDesign &design, size_t count);
+static uint8_t filter_order_rounded(uint8_t order);
+static void filter_update(HybridNode *node);
+static void filter_reset(HybridNode *node);
+static void apply_control_voltage(HybridNode *node);
+static void phi_link_reset(HybridNode *node);
+static void phi_link_update(HybridNode *node);
+static void publish_control_voltage(HybridNode *node);
+static void control_loop_reset(HybridNode *node);
+static void cv_period_start(HybridNode *node);
+static void write_frames(HybridNode *node, const float *audio, float *output, size_t frames);
+static void publish_node_status(HybridNode *node);
+static void publish_analysis_status(HybridNode *node);
+static void publish_status(HybridNode *node);
+template <typename T> static void status_write(StatusSlot<T> *slot, const T &value);
+template <typename M> static void dsp_distortion(HybridNode *node, const M *magnitude, float power);
+template <typename T> static void status_read(const StatusSlot<T> *slot, T *out);
+static void dsp_analyze_block(HybridNode *node, const float *block, size_t frames, uint32_t start_us);
+static bool dsp_block_metrics(HybridNode *node);
+static void dsp_block_finish(HybridNode *node, bool analyzed, size_t frames, uint32_t start_us, uint32_t ticks);
+static void dsp_spectral_update(HybridNode *node, bool has_energy, const SpectralFeatures *features);
+static void dsp_spectral_features(HybridNode *node);
+static DspBlock* dsp_ring_claim(HybridNode *node);
+static void dsp_ring_commit(HybridNode *node);
+static void process_buffer(HybridNode *node, float *work, float *output, size_t frames, uint32_t start_ns, uint32_t start_us);
+static void run_engine(HybridNode *node, float *work, size_t frames);
+static void process_finish(HybridNode *node, size_t frames, uint32_t start_ns);
+static bool deadline_update(HybridNode *node, uint32_t latency_ns, uint32_t budget_ns);
+static void buffer_record(HybridNode *node, uint32_t latency_ns, uint32_t budget_ns, bool near_miss,
+                          HybridBufferRecord *record);
+static void load_governor_reset(HybridNode *node);
+static void load_governor_update(HybridNode *node, bool near_miss);
+static void dsp_load_level(HybridNode *node);
+static bool dsp_hop_due(HybridNode *node);
+#ifdef HYBRID_NODE_Q31
+static bool q31_fft_init(const int32_t *twiddle = NULL);
+static int32_t q30_coeff(float c);
+static unsigned q31_input_shift(const HybridNode *node);
+static int32_t q31_cv_code(const HybridNode *node, float volts);
+static void dsp_analyze_block_q31(HybridNode *node, const int32_t *block, size_t frames, uint32_t start_us);
+static void dsp_spectral_features_q31(HybridNode *node);
+static void process_buffer_q31(HybridNode *node, int32_t *work, int32_t *output, size_t frames, uint32_t start_ns, uint32_t start_us);
+static void write_frames_q31(HybridNode *node, const int32_t *audio, int32_t *output, size_t frames);
+#endif
+static void write_output(HybridNode *node, const float *audio, float *output, size_t frames);
+static uint32_t latency_clock_ns();
+static uint32_t node_clock_us();
+#ifdef HYBRID_NODE_SIMULATION
+static uint64_t sim_clock_ns();
+static void sim_sleep_until(uint64_t deadline_ns);
+#endif
+#ifdef RASPBERRY_PI
+static int alsa_configure(HybridNode *node, snd_pcm_t *pcm, unsigned channels, snd_pcm_uframes_t period,
+                          unsigned periods, bool playback);
+static bool alsa_restart(HybridNode *node);
+static bool alsa_xrun(HybridNode *node, HybridAlsaReport *run);
+static AlsaSample* alsa_frames(const snd_pcm_channel_area_t *areas, snd_pcm_uframes_t offset, unsigned channels);
+static bool alsa_read(HybridNode *node, float *buffer, size_t frames);
+static bool alsa_write(HybridNode *node, const float *buffer, size_t frames);
+#endif
+static void usb_stream_reset(HybridNode *node);
+static void usb_process(HybridNode *node);
+static void usb_publish(HybridNode *node);
+#ifdef HYBRID_NODE_Q31
+static uint32_t spi_dac_word(HybridNode *node, size_t channel, int32_t sample);
+static void spi_encode(HybridNode *node, unsigned half);
+static bool platform_spi_start(HybridNode *node);
+static void platform_spi_stop(HybridNode *node);
+#endif
+#ifdef HYBRID_NODE_SIMULATION
+static bool sim_spi_half(HybridNode *node);
+#endif
+static void realtime_fail(HybridRealtimeStatus *rt, int err);
+static void realtime_lock_memory(HybridNode *node);
+#if defined(__linux__)
+static uint32_t realtime_isolated_cpus();
+static void realtime_prefault_stack();
+#endif
+static void latency_record(HybridNode *node, uint32_t ns);
+static uint32_t stage_ticks();
+static uint32_t stage_ticks_ns(uint32_t ticks);
+static uint32_t stage_begin(HybridNode *node, bool audio);
+static uint32_t stage_end(HybridNode *node, HybridStage stage, uint32_t start);
+static bool stage_in_audio(int stage);
+static void stage_clear(HybridNode *node, bool audio);
+static void stage_reset(HybridNode *node);
+static void stage_copy(const HybridNode *node, HybridStageTiming *timing, bool audio);
+static uint32_t latency_copy_counts(HybridNode *node, uint32_t *counts);
+static uint32_t latency_percentile(const uint32_t *counts, uint32_t total, uint32_t max_ns, float p);
 
 //==============================================================================
 // PUBLIC API IMPLEMENTATION
 //==============================================================================
 
-bool hybrid_node_init(const HybridNodeConfig *config) {
-    if (config == NULL) {
+HybridNode* hybrid_node_create(void) {
+    // Value-initialized: zeroed, then the member defaults applied
+    return new (std::nothrow) HybridNode();
+}
+
+void hybrid_node_destroy(HybridNode *node) {
+    if (node == NULL || node == &g_default_node) {
+        return;
+    }
+    hybrid_stop(node);
+#ifdef RASPBERRY_PI
+    hybrid_alsa_close(node);
+#endif
+    hybrid_usb_close(node);
+#ifdef HYBRID_NODE_Q31
+    hybrid_spi_close(node);
+#endif
+    dsp_rfft_destroy(node->fft);
+    delete node;
+}
+
+HybridNode* hybrid_node_default(void) {
+    return &g_default_node;
+}
+
+// hybrid_init, with the tables and calibration of a checked boot image
+// when there is one
+static bool init_node(HybridNode *node, const HybridNodeConfig *config, const HybridBootImage *image) {
+    if (node == NULL || config == NULL) {
         return false;
     }
 
     // Copy configuration
-    memcpy(&g_config, config, sizeof(HybridNodeConfig));
+    memcpy(&node->config, config, sizeof(HybridNodeConfig));
 
     // Initialize status structure
-    memset(&g_status, 0, sizeof(HybridNodeStatus));
-    g_status.mode = config->mode;
-    g_status.is_running = false;
-    g_status.is_calibrated = false;
+    memset(&node->status, 0, sizeof(HybridNodeStatus));
+    node->status.mode = config->mode;
+    node->status.is_running = false;
+    node->status.is_calibrated = false;
 
     // Set default calibration values
     for (int i = 0; i < HYBRID_ADC_CHANNELS; i++) {
-        g_status.calibration.adc_gain[i] = 1.0f;
-        g_status.calibration.adc_offset[i] = 0.0f;
+        node->status.calibration.adc_gain[i] = 1.0f;
+        node->status.calibration.adc_offset[i] = 0.0f;
     }
     for (int i = 0; i < HYBRID_DAC_CHANNELS; i++) {
-        g_status.calibration.dac_gain[i] = 1.0f;
-        g_status.calibration.dac_offset[i] = 0.0f;
+        node->status.calibration.dac_gain[i] = 1.0f;
+        node->status.calibration.dac_offset[i] = 0.0f;
+    }
+    if (image != NULL) {
+        memcpy(&node->status.calibration, &image->calibration, sizeof(CalibrationData));
+        node->status.is_calibrated = true;
+        if (image->flags & HYBRID_BOOT_HAS_CLOCK) {
+            node->clock_ppm = image->clock_ppm;
+            node->clock_measured = true;
+        }
     }
 
+    // Filter coefficients, FFT plan, tables and analysis window, off the
+    // audio path; taken as they are from a boot image
+    node->config.filter_order = filter_order_rounded(node->config.filter_order);
+    node->config.engine_dry = node->config.engine_dry > 0.0f ? fminf(node->config.engine_dry, 1.0f) : 0.0f;
+    if (image != NULL) {
+        filter_load(node, image);
+    } else {
+        filter_design(node);
+    }
+    filter_reset(node);
+    dsp_analysis_init(node);
+    if (image != NULL && (image->flags & HYBRID_BOOT_HAS_FFT) && node->fft == NULL &&
+        dsp_fft_default_backend() == DSP_FFT_BUILTIN) {
+        node->fft = dsp_rfft_create_from_tables(HYBRID_FFT_SIZE, image->fft_twiddle, image->fft_bitrev);
+    }
+    if (!dsp_fft_init(node)) {
+        if (node->config.enable_logging) {
+            firmware_log("[HybridNode] FFT initialization failed\n");
+        }
+        return false;
+    }
+#ifdef HYBRID_NODE_Q31
+    q31_fft_init(image != NULL && (image->flags & HYBRID_BOOT_HAS_Q31) ? image->q31_twiddle : NULL);
+#endif
+
     // Initialize platform-specific ADC/DAC
-    if (!platform_adc_init()) {
-        if (g_config.enable_logging) {
-            printf("[HybridNode] ADC initialization failed\n");
+    if (!platform_adc_init(node)) {
+        if (node->config.enable_logging) {
+            firmware_log("[HybridNode] ADC initialization failed\n");
         }
         return false;
     }
 
-    if (!platform_dac_init()) {
-        if (g_config.enable_logging) {
-            printf("[HybridNode] DAC initialization failed\n");
+    if (!platform_dac_init(node)) {
+        if (node->config.enable_logging) {
+            firmware_log("[HybridNode] DAC initialization failed\n");
         }
         return false;
     }
 
     // Initialize safety monitoring (FR-007)
-    g_status.safety.status = HYBRID_SAFETY_OK;
-    g_status.safety.temperature = 25.0f;  // Default temperature
+    node->status.safety.status = HYBRID_SAFETY_OK;
+    node->status.safety.temperature = 25.0f;  // Default temperature
 
 #ifdef TEENSY
+    // Cycle counter behind the stage timings; the Teensy 4 core starts it
+    // already, Teensy 3 does not
+    ARM_DEMCR |= ARM_DEMCR_TRCENA;
+    ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+
     // Setup thermal monitoring GPIO
-    if (g_config.enable_thermal_monitor) {
-        pinMode(g_config.thermal_gpio_pin, INPUT);
+    if (node->config.enable_thermal_monitor) {
+        pinMode(node->config.thermal_gpio_pin, INPUT);
     }
 #elif defined(RASPBERRY_PI)
-    if (g_config.enable_thermal_monitor) {
+    if (node->config.enable_thermal_monitor) {
         wiringPiSetup();
-        pinMode(g_config.thermal_gpio_pin, INPUT);
+        pinMode(node->config.thermal_gpio_pin, INPUT);
     }
 #endif
 
-    g_initialized = true;
+    if (node->config.enable_realtime) {
+        realtime_lock_memory(node);
+    }
+
+    node->initialized = true;
 
-    if (g_config.enable_logging) {
-        printf("[HybridNode] Initialized successfully\n");
-        printf("  Mode: %d\n", g_config.mode);
-        printf("  Sample rate: %d Hz\n", g_config.sample_rate);
-        printf("  Buffer size: %d samples\n", g_config.buffer_size);
-        printf("  ADC channels: %d\n", g_config.adc_channels);
-        printf("  DAC channels: %d\n", g_config.dac_channels);
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Initialized successfully\n");
+        firmware_log("  Mode: %d\n", node->config.mode);
+        firmware_log("  Sample rate: %d Hz\n", node->config.sample_rate);
+        firmware_log("  Buffer size: %d samples\n", node->config.buffer_size);
+        firmware_log("  ADC channels: %d\n", node->config.adc_channels);
+        firmware_log("  DAC channels: %d\n", node->config.dac_channels);
     }
 
+    publish_status(node);
     return true;
 }
 
-bool hybrid_node_start(void) {
-    if (!g_initialized || g_running) {
+bool hybrid_init(HybridNode *node, const HybridNodeConfig *config) {
+    return init_node(node, config, NULL);
+}
+
+bool hybrid_start(HybridNode *node) {
+    if (node == NULL || !node->initialized || node->running) {
         return false;
     }
 
     // Reset statistics
-    g_status.stats.frames_processed = 0;
-    g_status.stats.frames_dropped = 0;
-    g_status.stats.uptime_ms = 0;
-
-    g_running = true;
-    g_status.is_running = true;
-
-    if (g_config.enable_logging) {
-        printf("[HybridNode] Started\n");
+    node->status.stats.frames_processed = 0;
+    node->status.stats.frames_dropped = 0;
+    node->status.stats.deadline_overruns = 0;
+    node->status.stats.denormal_buffers = 0;
+    node->status.stats.uptime_ms = 0;
+    memset(&node->status.stats.deadline, 0, sizeof(node->status.stats.deadline));
+    node->shed_requested.store(false, std::memory_order_relaxed);
+    hybrid_reset_latency(node);
+    stage_reset(node);
+    load_governor_reset(node);
+    dsp_analysis_reset(node);
+    filter_reset(node);
+    node->dsp_head.store(0, std::memory_order_relaxed);
+    node->dsp_tail.store(0, std::memory_order_relaxed);
+    publish_control_voltage(node);
+    control_loop_reset(node);
+    phi_link_reset(node);
+    node->status.is_running = true;
+    publish_status(node);
+
+    node->running = true;
+
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Started\n");
     }
 
     return true;
 }
 
-bool hybrid_node_stop(void) {
-    if (!g_running) {
+bool hybrid_stop(HybridNode *node) {
+    if (node == NULL || !node->running) {
         return false;
     }
 
-    g_running = false;
-    g_status.is_running = false;
+    node->running = false;
+    node->status.is_running = false;
+    publish_status(node);
 
     // Clamp DAC outputs to safe levels
-    memset(g_dac_buffer, 0, sizeof(g_dac_buffer));
-    platform_dac_write(g_dac_buffer, g_config.buffer_size);
+    memset(node->dac_buffer, 0, sizeof(node->dac_buffer));
+    platform_dac_write(node, node->dac_buffer, node->config.buffer_size);
 
-    if (g_config.enable_logging) {
-        printf("[HybridNode] Stopped\n");
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Stopped\n");
     }
 
     return true;
 }
 
-bool hybrid_node_process(const float *input, float *output, size_t frames) {
-    if (!g_running || input == NULL || output == NULL) {
+bool hybrid_process(HybridNode *node, const float *input, float *output, size_t frames) {
+    if (node == NULL || !node->running || input == NULL || output == NULL || frames > HYBRID_BUFFER_SIZE) {
         return false;
     }
 
     // Record start time for latency measurement
-    uint32_t start_us = 0;
-#ifdef TEENSY
-    start_us = micros();
-#endif
+    const uint32_t start_ns = latency_clock_ns();
+    const uint32_t start_us = node_clock_us();
 
     // Copy input to working buffer
-    memcpy(g_adc_buffer, input, frames * g_config.adc_channels * sizeof(float));
+    memcpy(node->adc_buffer, input, frames * node->config.adc_channels * sizeof(float));
 
-    // Apply analog filtering (FR-002)
-    if (g_config.enable_analog_filter) {
-        apply_analog_filter(g_adc_buffer, frames);
+    process_buffer(node, node->adc_buffer, output, frames, start_ns, start_us);
+    return true;
+}
+
+bool hybrid_process_inplace(HybridNode *node, float *adc, float *dac, size_t frames) {
+    if (node == NULL || !node->running || adc == NULL || dac == NULL || frames > HYBRID_BUFFER_SIZE) {
+        return false;
     }
 
-    // Calculate analog metrics (FR-002)
-    float rms = 0.0f;
-    float peak = 0.0f;
-    float dc_sum = 0.0f;
+    process_buffer(node, adc, dac, frames, latency_clock_ns(), node_clock_us());
+    return true;
+}
 
-    for (size_t i = 0; i < frames * g_config.adc_channels; i++) {
-        float sample = g_adc_buffer[i];
-        rms += sample * sample;
-        peak = fmaxf(peak, fabsf(sample));
-        dc_sum += sample;
+#ifdef HYBRID_NODE_Q31
+bool hybrid_process_q31(HybridNode *node, const int32_t *input, int32_t *output, size_t frames) {
+    if (node == NULL || !node->running || input == NULL || output == NULL || frames > HYBRID_BUFFER_SIZE) {
+        return false;
     }
 
-    g_status.analog.rms_level = sqrtf(rms / (frames * g_config.adc_channels));
-    g_status.analog.peak_level = peak;
-    g_status.analog.dc_offset = dc_sum / (frames * g_config.adc_channels);
-    g_status.analog.is_overloaded = (peak > SAFETY_OVERLOAD_THRESH);
+    const uint32_t start_ns = latency_clock_ns();
+    const uint32_t start_us = node_clock_us();
+
+    // Left-justify into Q31 on the way into the working buffer, saturating
+    // words that carry more than sample_bits significant bits
+    const unsigned shift = q31_input_shift(node);
+    const size_t count = frames * node->config.adc_channels;
+    for (size_t i = 0; i < count; i++) {
+        const int32_t x = input[i];
+        int32_t q = (int32_t)((uint32_t)x << shift);
+        if (x > (INT32_MAX >> shift)) {
+            q = INT32_MAX;
+        } else if (x < (INT32_MIN >> shift)) {
+            q = INT32_MIN;
+        }
+        node->q31_adc_buffer[i] = q;
+    }
 
-    // Safety check (FR-007)
-    safety_check();
+    process_buffer_q31(node, node->q31_adc_buffer, output, frames, start_ns, start_us);
+    return true;
+}
+#endif
 
-    // DSP processing (FR-003)
-    if (g_config.enable_dsp && g_status.safety.status == HYBRID_SAFETY_OK) {
-        // Perform FFT analysis
-        dsp_process_fft(g_adc_buffer, frames);
+uint32_t hybrid_dsp_poll(HybridNode *node, uint32_t max_blocks) {
+    if (node == NULL) {
+        return 0;
+    }
 
-        // Calculate ICI
-        if (g_config.enable_ici) {
-            dsp_calculate_ici(&g_status.dsp.ici);
+    FpModeGuard fp;
+    uint32_t tail = node->dsp_tail.load(std::memory_order_relaxed);
+    const uint32_t head = node->dsp_head.load(std::memory_order_acquire);
+    uint32_t analyzed = 0;
+    while (tail != head && (max_blocks == 0 || analyzed < max_blocks)) {
+        const DspBlock *block = &node->dsp_ring[tail & (HYBRID_DSP_RING_BLOCKS - 1)];
+#ifdef HYBRID_NODE_Q31
+        if (block->q31) {
+            dsp_analyze_block_q31(node, block->samples_q31, block->frames, block->start_us);
+        } else {
+            dsp_analyze_block(node, block->samples, block->frames, block->start_us);
         }
+#else
+        dsp_analyze_block(node, block->samples, block->frames, block->start_us);
+#endif
+        // Releases the slot only after the analysis has read it
+        node->dsp_tail.store(++tail, std::memory_order_release);
+        analyzed++;
+    }
+    return analyzed;
+}
 
-        // Calculate coherence
-        if (g_config.enable_coherence) {
-            dsp_calculate_coherence(&g_status.dsp.coherence);
-        }
+uint32_t hybrid_dsp_pending(HybridNode *node) {
+    if (node == NULL) {
+        return 0;
+    }
 
-        // Update timestamp
-        g_status.dsp.timestamp_us = start_us;
+    return node->dsp_head.load(std::memory_order_acquire) - node->dsp_tail.load(std::memory_order_acquire);
+}
+
+bool hybrid_get_latency(HybridNode *node, HybridLatencyStats *stats) {
+    if (node == NULL || stats == NULL) {
+        return false;
     }
 
-    // Apply control voltage modulation (FR-004)
-    if (g_config.enable_modulation) {
-        apply_control_voltage();
+    // Percentiles come from one copy so they agree with each other
+    uint32_t counts[LATENCY_BUCKETS];
+    const uint32_t total = latency_copy_counts(node, counts);
+
+    memset(stats, 0, sizeof(HybridLatencyStats));
+    if (total == 0) {
+        return true;
     }
+    const uint32_t max_ns = node->latency_max_ns.load(std::memory_order_relaxed);
+    const uint32_t min_ns = node->latency_min_ns.load(std::memory_order_relaxed);
+    stats->count = total;
+    stats->max_ns = max_ns;
+    stats->min_ns = min_ns < max_ns ? min_ns : max_ns;
+    stats->p50_ns = latency_percentile(counts, total, max_ns, 0.50f);
+    stats->p90_ns = latency_percentile(counts, total, max_ns, 0.90f);
+    stats->p99_ns = latency_percentile(counts, total, max_ns, 0.99f);
+    stats->p999_ns = latency_percentile(counts, total, max_ns, 0.999f);
+    return true;
+}
 
-    // Copy to output buffer
-    // First 2 channels: audio passthrough
-    // Last 2 channels: control voltages
-    for (size_t i = 0; i < frames; i++) {
-        // Audio passthrough (channels 0-1)
-        output[i * g_config.dac_channels + 0] = g_adc_buffer[i * g_config.adc_channels + 0];
-        if (g_config.adc_channels > 1) {
-            output[i * g_config.dac_channels + 1] = g_adc_buffer[i * g_config.adc_channels + 1];
-        }
+uint32_t hybrid_latency_percentile(HybridNode *node, float p) {
+    if (node == NULL) {
+        return 0;
+    }
 
-        // Control voltages (channels 2-3)
-        if (g_config.dac_channels > 2) {
-            output[i * g_config.dac_channels + 2] = g_status.control.cv1;
-            output[i * g_config.dac_channels + 3] = g_status.control.cv2;
-        }
+    uint32_t counts[LATENCY_BUCKETS];
+    const uint32_t total = latency_copy_counts(node, counts);
+    return latency_percentile(counts, total, node->latency_max_ns.load(std::memory_order_relaxed), p);
+}
+
+bool hybrid_reset_latency(HybridNode *node) {
+    if (node == NULL) {
+        return false;
     }
 
-    // Update statistics
-    g_status.stats.frames_processed++;
+    // Bucket by bucket, so a concurrent record is either kept or cleared whole
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+        node->latency_counts[i].exchange(0, std::memory_order_relaxed);
+    }
+    node->latency_min_ns.exchange(UINT32_MAX, std::memory_order_relaxed);
+    node->latency_max_ns.exchange(0, std::memory_order_relaxed);
+    return true;
+}
 
-    // Calculate total latency (SC-001)
-#ifdef TEENSY
-    uint32_t end_us = micros();
-    uint32_t latency_us = end_us - start_us;
-    g_status.calibration.total_latency_us = latency_us;
+bool hybrid_set_preamp_gain(HybridNode *node, float gain) {
+    if (node == NULL || gain < ANALOG_PREAMP_GAIN_MIN || gain > ANALOG_PREAMP_GAIN_MAX) {
+        return false;
+    }
 
-    // Update CPU load estimate
-    float buffer_duration_us = (frames * 1000000.0f) / g_config.sample_rate;
-    g_status.stats.cpu_load = (latency_us / buffer_duration_us) * 100.0f;
-#endif
+    node->config.preamp_gain = gain;
+
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Preamp gain set to %.2f (%.1f dB)\n", gain, 20.0f * log10f(gain));
+    }
 
     return true;
 }
 
-bool hybrid_node_set_preamp_gain(float gain) {
-    if (gain < ANALOG_PREAMP_GAIN_MIN || gain > ANALOG_PREAMP_GAIN_MAX) {
+bool hybrid_set_filter(HybridNode *node, float hpf_cutoff, float lpf_cutoff, uint8_t order) {
+    if (node == NULL) {
+        return false;
+    }
+
+    if (order == 0) {
+        order = node->config.filter_order;
+    }
+    if (hpf_cutoff < 0.0f || lpf_cutoff <= hpf_cutoff ||
+        order < 2 || order > ANALOG_FILTER_MAX_ORDER || (order & 1) != 0) {
         return false;
     }
 
-    g_config.preamp_gain = gain;
+    // Picked up by apply_analog_filter before the next buffer
+    node->config.hpf_cutoff = hpf_cutoff;
+    node->config.lpf_cutoff = lpf_cutoff;
+    node->config.filter_order = order;
 
-    if (g_config.enable_logging) {
-        printf("[HybridNode] Preamp gain set to %.2f (%.1f dB)\n",
-               gain, 20.0f * log10f(gain));
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Filter set to %.1f Hz - %.1f Hz, order %u\n", hpf_cutoff, lpf_cutoff, order);
     }
 
     return true;
 }
 
-bool hybrid_node_set_control_voltage(const ControlVoltage *cv) {
-    if (cv == NULL) {
+bool hybrid_set_control_voltage(HybridNode *node, const ControlVoltage *cv) {
+    if (node == NULL || cv == NULL) {
         return false;
     }
 
     // Apply voltage clamping (FR-007)
-    if (g_config.enable_voltage_clamp) {
-        g_status.control.cv1 = fminf(fmaxf(cv->cv1, SAFETY_VOLTAGE_MIN), SAFETY_VOLTAGE_MAX);
-        g_status.control.cv2 = fminf(fmaxf(cv->cv2, SAFETY_VOLTAGE_MIN), SAFETY_VOLTAGE_MAX);
+    if (node->config.enable_voltage_clamp) {
+        node->status.control.cv1 = fminf(fmaxf(cv->cv1, SAFETY_VOLTAGE_MIN), SAFETY_VOLTAGE_MAX);
+        node->status.control.cv2 = fminf(fmaxf(cv->cv2, SAFETY_VOLTAGE_MIN), SAFETY_VOLTAGE_MAX);
     } else {
-        g_status.control.cv1 = cv->cv1;
-        g_status.control.cv2 = cv->cv2;
+        node->status.control.cv1 = cv->cv1;
+        node->status.control.cv2 = cv->cv2;
     }
 
-    g_status.control.phi_phase = cv->phi_phase;
-    g_status.control.phi_depth = cv->phi_depth;
+    node->host_phi_phase = cv->phi_phase;
+    node->host_phi_depth = cv->phi_depth;
+    if (!node->status.phi_link.active) {
+        node->status.control.phi_phase = cv->phi_phase;
+        node->status.control.phi_depth = cv->phi_depth;
+    }
+    publish_control_voltage(node);
+    if (!node->running) {
+        publish_status(node);
+    }
 
     return true;
 }
 
-bool hybrid_node_get_status(HybridNodeStatus *status) {
-    if (status == NULL) {
+bool hybrid_get_status(HybridNode *node, HybridNodeStatus *status) {
+    if (node == NULL || status == NULL) {
         return false;
     }
 
-    memcpy(status, &g_status, sizeof(HybridNodeStatus));
+    NodeSnapshot state;
+    AnalysisSnapshot analysis;
+    status_read(&node->node_slot, &state);
+    status_read(&node->analysis_slot, &analysis);
+    status->mode = state.mode;
+    status->is_running = state.is_running;
+    status->is_calibrated = state.is_calibrated;
+    status->analog = analysis.analog;
+    status->dsp = analysis.dsp;
+    status->control = analysis.control;
+    status->phi_link = analysis.phi_link;
+    status->safety = analysis.safety;
+    status->calibration = state.calibration;
+    status->stats = state.stats;
+    status->realtime = state.realtime;
+    for (int s = 0; s < HYBRID_STAGE_COUNT; s++) {
+        if (!stage_in_audio(s)) {
+            status->stats.stage[s] = analysis.stage[s];
+        }
+    }
     return true;
 }
 
-bool hybrid_node_get_dsp_metrics(DSPMetrics *metrics) {
-    if (metrics == NULL) {
+bool hybrid_get_dsp_metrics(HybridNode *node, DSPMetrics *metrics) {
+    if (node == NULL || metrics == NULL) {
         return false;
     }
 
-    memcpy(metrics, &g_status.dsp, sizeof(DSPMetrics));
+    AnalysisSnapshot analysis;
+    status_read(&node->analysis_slot, &analysis);
+    *metrics = analysis.dsp;
     return true;
 }
 
-bool hybrid_node_get_safety(SafetyTelemetry *telemetry) {
-    if (telemetry == NULL) {
+bool hybrid_get_safety(HybridNode *node, SafetyTelemetry *telemetry) {
+    if (node == NULL || telemetry == NULL) {
         return false;
     }
 
-    memcpy(telemetry, &g_status.safety, sizeof(SafetyTelemetry));
+    AnalysisSnapshot analysis;
+    status_read(&node->analysis_slot, &analysis);
+    *telemetry = analysis.safety;
     return true;
 }
 
-bool hybrid_node_calibrate(CalibrationData *calibration) {
-    if (calibration == NULL || g_running) {
+bool hybrid_calibrate(HybridNode *node, CalibrationData *calibration) {
+    if (node == NULL || calibration == NULL || node->running) {
         return false;
     }
 
-    if (g_config.enable_logging) {
-        printf("[HybridNode] Starting calibration...\n");
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Starting calibration...\n");
     }
 
     // ADC calibration: measure DC offset
-    printf("  Calibrating ADC offsets (ensure inputs grounded)...\n");
+    firmware_log("  Calibrating ADC offsets (ensure inputs grounded)...\n");
 
     float adc_samples[HYBRID_ADC_CHANNELS][CAL_SAMPLES];
     for (int sample = 0; sample < CAL_SAMPLES; sample++) {
-        platform_adc_read(g_adc_buffer, g_config.buffer_size);
+        platform_adc_read(node, node->adc_buffer, node->config.buffer_size);
 
-        for (int ch = 0; ch < g_config.adc_channels; ch++) {
+        for (int ch = 0; ch < node->config.adc_channels; ch++) {
             float sum = 0.0f;
-            for (size_t i = 0; i < g_config.buffer_size; i++) {
-                sum += g_adc_buffer[i * g_config.adc_channels + ch];
+            for (size_t i = 0; i < node->config.buffer_size; i++) {
+                sum += node->adc_buffer[i * node->config.adc_channels + ch];
             }
-            adc_samples[ch][sample] = sum / g_config.buffer_size;
+            adc_samples[ch][sample] = sum / node->config.buffer_size;
         }
     }
 
     // Calculate average DC offset
-    for (int ch = 0; ch < g_config.adc_channels; ch++) {
+    for (int ch = 0; ch < node->config.adc_channels; ch++) {
         float sum = 0.0f;
         for (int i = 0; i < CAL_SAMPLES; i++) {
             sum += adc_samples[ch][i];
         }
         calibration->adc_offset[ch] = -(sum / CAL_SAMPLES);
-        printf("    ADC%d offset: %.6f\n", ch, calibration->adc_offset[ch]);
+        firmware_log("    ADC%d offset: %.6f\n", ch, calibration->adc_offset[ch]);
     }
 
-    // DAC calibration: measure output with known input
-    printf("  Calibrating DAC gain...\n");
+    // Latency calibration (SC-001)
+    firmware_log("  Calibrating latency (loopback test)...\n");
+
+    // Generate impulse and time each stage of the loop: DAC write, ADC
+    // read of the response, and one DSP pass over it
+    memset(node->dac_buffer, 0, sizeof(node->dac_buffer));
+    node->dac_buffer[0] = 1.0f;  // Impulse
+
+    const uint32_t dac_start = stage_ticks();
+    platform_dac_write(node, node->dac_buffer, node->config.buffer_size);
+    const uint32_t adc_start = stage_ticks();
+    platform_adc_read(node, node->adc_buffer, node->config.buffer_size);
+    const uint32_t dsp_start = stage_ticks();
+    dsp_process_fft(node, node->adc_buffer, node->config.buffer_size);
+    const uint32_t end = stage_ticks();
+    const uint32_t dac_ns = stage_ticks_ns(adc_start - dac_start);
+    const uint32_t adc_ns = stage_ticks_ns(dsp_start - adc_start);
+    const uint32_t dsp_ns = stage_ticks_ns(end - dsp_start);
+
+    // Rounded to the nearest µs
+    calibration->dac_latency_us = (dac_ns + 500) / 1000;
+    calibration->adc_latency_us = (adc_ns + 500) / 1000;
+    calibration->dsp_latency_us = (dsp_ns + 500) / 1000;
+    calibration->total_latency_us = (dac_ns + adc_ns + dsp_ns + 500) / 1000;
+
+    // Those are call times; the delay around the loop itself comes from
+    // cross-correlating a known sequence with what comes back
+    float delay_frames = 0.0f, peak_ratio = 0.0f;
+    calibrate_loopback(node, &delay_frames, &peak_ratio);
+    calibration->loopback_peak_ratio = peak_ratio;
+    calibration->loopback_delay_frames = 0.0f;
+    if (peak_ratio >= CAL_LOOPBACK_MIN_RATIO) {
+        calibration->loopback_delay_frames = delay_frames;
+        calibration->total_latency_us = (uint32_t)lrintf(delay_frames * 1e6f / node->config.sample_rate);
+        firmware_log("    Loopback delay: %.3f frames (peak ratio %.1f)\n", delay_frames, peak_ratio);
+    } else {
+        firmware_log("    No loopback found (peak ratio %.1f), using call times\n", peak_ratio);
+    }
 
-    for (int ch = 0; ch < g_config.dac_channels; ch++) {
-        calibration->dac_gain[ch] = 1.0f;  // Default gain
+    // DAC calibration: the tone around the loop of each audio channel,
+    // waiting out the delay just found or, without one, the longest the
+    // correlator could have found. CV outputs have no loop to measure.
+    firmware_log("  Calibrating DAC gain (%.0f Hz tone)...\n", CAL_TONE_FREQ);
+    const float loop_frames = calibration->loopback_delay_frames > 0.0f ? calibration->loopback_delay_frames
+                                                                        : (float)(CAL_XCORR_SIZE - CAL_MLS_LENGTH);
+    const size_t settle = (size_t)ceilf(loop_frames + CAL_TONE_SETTLE_MS * 1e-3f * node->config.sample_rate);
+    const size_t audio = node->config.dac_channels < 2 ? node->config.dac_channels : 2;
+    for (int ch = 0; ch < node->config.dac_channels; ch++) {
+        calibration->dac_gain[ch] = 1.0f;
         calibration->dac_offset[ch] = 0.0f;
+        calibration->dac_phase[ch] = 0.0f;
+        float ratio = 0.0f, phase = 0.0f, dc = 0.0f;
+        if ((size_t)ch >= audio || ch >= node->config.adc_channels ||
+            !calibrate_tone(node, ch, settle, &ratio, &phase, &dc)) {
+            continue;
+        }
+        if (ratio < CAL_TONE_MIN_RATIO) {
+            firmware_log("    DAC%d: no tone returned (%.4f), gain left at 1\n", ch, ratio);
+            continue;
+        }
+        // Corrections applied before the DAC: x * gain + offset plays x
+        calibration->dac_gain[ch] = 1.0f / ratio;
+        calibration->dac_offset[ch] = -(dc + calibration->adc_offset[ch]) / ratio;
+        calibration->dac_phase[ch] = phase;
+        firmware_log("    DAC%d gain: %.6f  offset: %.6f  phase: %.4f rad\n", ch, calibration->dac_gain[ch],
+                     calibration->dac_offset[ch], phase);
     }
 
-    // Latency calibration (SC-001)
-    printf("  Calibrating latency (loopback test)...\n");
-
-    // Generate impulse and measure round-trip time
-    memset(g_dac_buffer, 0, sizeof(g_dac_buffer));
-    g_dac_buffer[0] = 1.0f;  // Impulse
-
-#ifdef TEENSY
-    uint32_t start_us = micros();
-#endif
-
-    platform_dac_write(g_dac_buffer, g_config.buffer_size);
-    platform_adc_read(g_adc_buffer, g_config.buffer_size);
-
-#ifdef TEENSY
-    uint32_t end_us = micros();
-    calibration->total_latency_us = end_us - start_us;
-#else
-    calibration->total_latency_us = 2000;  // Estimate: 2ms
-#endif
-
-    // Estimate component latencies
-    calibration->adc_latency_us = calibration->total_latency_us / 3;
-    calibration->dsp_latency_us = calibration->total_latency_us / 3;
-    calibration->dac_latency_us = calibration->total_latency_us / 3;
-
-    printf("    Total latency: %d µs\n", calibration->total_latency_us);
-    printf("    ADC latency: %d µs\n", calibration->adc_latency_us);
-    printf("    DSP latency: %d µs\n", calibration->dsp_latency_us);
-    printf("    DAC latency: %d µs\n", calibration->dac_latency_us);
+    firmware_log("    Total latency: %d µs\n", calibration->total_latency_us);
+    firmware_log("    ADC latency: %d µs\n", calibration->adc_latency_us);
+    firmware_log("    DSP latency: %d µs\n", calibration->dsp_latency_us);
+    firmware_log("    DAC latency: %d µs\n", calibration->dac_latency_us);
 
     // Verify SC-001: latency ≤2000 µs (2 ms)
     bool meets_sc001 = calibration->total_latency_us <= 2000;
-    printf("    SC-001 (latency ≤2ms): %s\n", meets_sc001 ? "PASS" : "FAIL");
+    firmware_log("    SC-001 (latency ≤2ms): %s\n", meets_sc001 ? "PASS" : "FAIL");
 
     // Mark as calibrated
     calibration->calibration_timestamp = (uint32_t)time(NULL);
     calibration->is_calibrated = true;
 
     // Load calibration into runtime state
-    memcpy(&g_status.calibration, calibration, sizeof(CalibrationData));
-    g_status.is_calibrated = true;
+    memcpy(&node->status.calibration, calibration, sizeof(CalibrationData));
+    node->status.is_calibrated = true;
+    node->status.recalibration_due = false;
+    publish_node_status(node);
 
-    if (g_config.enable_logging) {
-        printf("[HybridNode] Calibration complete\n");
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Calibration complete\n");
     }
 
     return true;
 }
 
-bool hybrid_node_load_calibration(const CalibrationData *calibration) {
-    if (calibration == NULL) {
+bool hybrid_load_calibration(HybridNode *node, const CalibrationData *calibration) {
+    if (node == NULL || calibration == NULL) {
         return false;
     }
 
-    memcpy(&g_status.calibration, calibration, sizeof(CalibrationData));
-    g_status.is_calibrated = calibration->is_calibrated;
+    memcpy(&node->status.calibration, calibration, sizeof(CalibrationData));
+    node->status.is_calibrated = calibration->is_calibrated;
+    if (!node->running) {
+        publish_node_status(node);
+    }
 
-    if (g_config.enable_logging) {
-        printf("[HybridNode] Calibration data loaded\n");
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Calibration data loaded\n");
     }
 
     return true;
 }
 
-bool hybrid_node_save_calibration(const char *filename) {
-    if (filename == NULL || !g_status.is_calibrated) {
+bool hybrid_save_calibration(HybridNode *node, const char *filename) {
+    if (node == NULL || filename == NULL || !node->status.is_calibrated) {
         return false;
     }
 
@@ -448,18 +1330,18 @@ bool hybrid_node_save_calibration(const char *filename) {
         return false;
     }
 
-    size_t written = fwrite(&g_status.calibration, sizeof(CalibrationData), 1, fp);
+    size_t written = fwrite(&node->status.calibration, sizeof(CalibrationData), 1, fp);
     fclose(fp);
 
-    if (g_config.enable_logging) {
+    if (node->config.enable_logging) {
         printf("[HybridNode] Calibration saved to %s\n", filename);
     }
 
     return (written == 1);
 }
 
-bool hybrid_node_load_calibration_file(const char *filename) {
-    if (filename == NULL) {
+bool hybrid_load_calibration_file(HybridNode *node, const char *filename) {
+    if (node == NULL || filename == NULL) {
         return false;
     }
 
@@ -473,317 +1355,3845 @@ bool hybrid_node_load_calibration_file(const char *filename) {
     fclose(fp);
 
     if (read == 1) {
-        return hybrid_node_load_calibration(&cal);
+        return hybrid_load_calibration(node, &cal);
     }
 
     return false;
 }
 
-bool hybrid_node_reset_statistics(void) {
-    g_status.stats.frames_processed = 0;
-    g_status.stats.frames_dropped = 0;
-    g_status.stats.uptime_ms = 0;
-    g_status.stats.drift_ppm = 0.0f;
-
-    if (g_config.enable_logging) {
-        printf("[HybridNode] Statistics reset\n");
+// CRC-32 (IEEE 802.3, reflected) of a boot image with its crc field 0
+static uint32_t boot_image_crc(const HybridBootImage *image) {
+    const uint8_t *bytes = (const uint8_t *)image;
+    const size_t crc_at = offsetof(HybridBootImage, crc);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < sizeof(HybridBootImage); i++) {
+        const bool in_field = i >= crc_at && i < crc_at + sizeof(image->crc);
+        crc ^= in_field ? 0u : bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1u) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
     }
-
-    return true;
+    return ~crc;
 }
 
-bool hybrid_node_set_mode(HybridNodeMode mode) {
-    if (g_running) {
-        return false;  // Cannot change mode while running
+HybridBootImageStatus hybrid_node_check_boot_image(const void *image, size_t size, const HybridNodeConfig *config,
+                                                   uint32_t max_age_s, uint32_t now) {
+    const HybridBootImage *boot = (const HybridBootImage *)image;
+    if (boot == NULL || config == NULL || size < offsetof(HybridBootImage, created)) {
+        return HYBRID_BOOT_IMAGE_MISSING;
     }
-
-    g_config.mode = mode;
-    g_status.mode = mode;
-
-    if (g_config.enable_logging) {
-        printf("[HybridNode] Mode set to %d\n", mode);
+    if (boot->magic != HYBRID_BOOT_IMAGE_MAGIC) {
+        return HYBRID_BOOT_IMAGE_CORRUPT;
     }
-
-    return true;
+    if (boot->version != HYBRID_BOOT_IMAGE_VERSION) {
+        return HYBRID_BOOT_IMAGE_OTHER_VERSION;
+    }
+    if (boot->size != sizeof(HybridBootImage) || size < sizeof(HybridBootImage) || boot->crc != boot_image_crc(boot)) {
+        return HYBRID_BOOT_IMAGE_CORRUPT;
+    }
+    if (boot->sample_rate != config->sample_rate || boot->fft_size != HYBRID_FFT_SIZE ||
+        boot->adc_channels != config->adc_channels || boot->dac_channels != config->dac_channels ||
+        boot->hpf_cutoff != config->hpf_cutoff || boot->lpf_cutoff != config->lpf_cutoff ||
+        boot->filter_order != filter_order_rounded(config->filter_order) ||
+        boot->filter_sections > ANALOG_FILTER_MAX_SECTIONS) {
+        return HYBRID_BOOT_IMAGE_CONFIG;
+    }
+    if (!(boot->flags & HYBRID_BOOT_HAS_CALIBRATION)) {
+        return HYBRID_BOOT_IMAGE_UNCALIBRATED;
+    }
+    if (max_age_s > 0 && now > boot->created && now - boot->created > max_age_s) {
+        return HYBRID_BOOT_IMAGE_EXPIRED;
+    }
+    return HYBRID_BOOT_IMAGE_OK;
 }
 
-bool hybrid_node_emergency_shutdown(const char *reason) {
-    if (g_config.enable_logging) {
-        printf("[HybridNode] EMERGENCY SHUTDOWN: %s\n", reason);
+const char* hybrid_boot_image_status_name(HybridBootImageStatus status) {
+    switch (status) {
+        case HYBRID_BOOT_IMAGE_OK: return "ok";
+        case HYBRID_BOOT_IMAGE_MISSING: return "missing";
+        case HYBRID_BOOT_IMAGE_CORRUPT: return "corrupt";
+        case HYBRID_BOOT_IMAGE_OTHER_VERSION: return "other version";
+        case HYBRID_BOOT_IMAGE_CONFIG: return "config";
+        case HYBRID_BOOT_IMAGE_EXPIRED: return "expired";
+        case HYBRID_BOOT_IMAGE_UNCALIBRATED: return "uncalibrated";
     }
+    return "unknown";
+}
 
-    // Stop processing immediately
-    hybrid_node_stop();
+bool hybrid_init_fast(HybridNode *node, const HybridNodeConfig *config, const void *image, size_t size,
+                      uint32_t max_age_s, HybridBootImageStatus *verdict) {
+    if (node == NULL || config == NULL) {
+        return false;
+    }
 
-    // Set safety status
-    g_status.safety.status = HYBRID_SAFETY_FAULT;
+    const HybridBootImageStatus status =
+        hybrid_node_check_boot_image(image, size, config, max_age_s, (uint32_t)time(NULL));
+    if (verdict != NULL) {
+        *verdict = status;
+    }
+    if (!init_node(node, config, status == HYBRID_BOOT_IMAGE_OK ? (const HybridBootImage *)image : NULL)) {
+        return false;
+    }
 
-    // Clamp all outputs to 0V
-    memset(g_dac_buffer, 0, sizeof(g_dac_buffer));
-    platform_dac_write(g_dac_buffer, g_config.buffer_size);
+    // Calibrating plays on the outputs, so it waits for the application
+    // to stop the node
+    node->status.recalibration_due = true;
+    publish_node_status(node);
 
-    g_status.control.cv1 = 0.0f;
-    g_status.control.cv2 = 0.0f;
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Boot image: %s, %s\n", hybrid_boot_image_status_name(status),
+                     status == HYBRID_BOOT_IMAGE_OK ? "calibration reused" : "booted uncalibrated");
+    }
 
     return true;
 }
 
-const char* hybrid_node_get_version(void) {
-    return FIRMWARE_VERSION;
-}
+bool hybrid_init_from_file(HybridNode *node, const HybridNodeConfig *config, const char *filename,
+                           uint32_t max_age_s, HybridBootImageStatus *verdict) {
+    if (node == NULL || config == NULL) {
+        return false;
+    }
 
-//==============================================================================
-// INTERNAL HELPER FUNCTIONS
-//==============================================================================
+    HybridBootImage *image = new (std::nothrow) HybridBootImage;
+    size_t size = 0;
+    FILE *fp = image != NULL && filename != NULL ? fopen(filename, "rb") : NULL;
+    if (fp != NULL) {
+        size = fread(image, 1, sizeof(HybridBootImage), fp);
+        fclose(fp);
+    }
 
-static bool platform_adc_init() {
-#ifdef TEENSY
-    // Teensy I²S ADC initialization would go here
-    return true;
-#elif defined(RASPBERRY_PI)
-    // Raspberry Pi I²S or SPI ADC initialization
-    return true;
-#else
-    // Stub for simulation/testing
-    return true;
-#endif
+    const bool ok = hybrid_init_fast(node, config, size > 0 ? image : NULL, size, max_age_s, verdict);
+    delete image;
+    return ok;
 }
 
-static bool platform_dac_init() {
-#ifdef TEENSY
-    // Teensy I²S DAC initialization would go here
-    return true;
-#elif defined(RASPBERRY_PI)
-    // Raspberry Pi I²S or SPI DAC initialization
-    return true;
-#else
-    // Stub for simulation/testing
-    return true;
-#endif
-}
+bool hybrid_capture_boot_image(HybridNode *node, HybridBootImage *image) {
+    if (node == NULL || image == NULL || !node->initialized || node->running || !node->status.is_calibrated) {
+        return false;
+    }
 
-static bool platform_adc_read(float *buffer, size_t frames) {
-#ifdef TEENSY
-    // Read from Teensy ADC
-    return true;
-#elif defined(RASPBERRY_PI)
-    // Read from Pi ADC
-    return true;
-#else
-    // Stub: generate silence
-    memset(buffer, 0, frames * g_config.adc_channels * sizeof(float));
-    return true;
-#endif
-}
+    // Zeroed first, so the padding the CRC covers is too
+    memset(image, 0, sizeof(HybridBootImage));
+    image->magic = HYBRID_BOOT_IMAGE_MAGIC;
+    image->version = HYBRID_BOOT_IMAGE_VERSION;
+    image->size = sizeof(HybridBootImage);
+    image->created = (uint32_t)time(NULL);
+    image->flags = HYBRID_BOOT_HAS_CALIBRATION;
+
+    // The sections in force belong to filter_design, which the
+    // configuration may have moved from since
+    image->sample_rate = node->config.sample_rate;
+    image->fft_size = HYBRID_FFT_SIZE;
+    image->adc_channels = node->config.adc_channels;
+    image->dac_channels = node->config.dac_channels;
+    image->hpf_cutoff = node->filter_design.hpf_cutoff;
+    image->lpf_cutoff = node->filter_design.lpf_cutoff;
+    image->filter_order = node->filter_design.order;
+    image->filter_sections = (uint8_t)node->filter_section_count;
+    for (size_t s = 0; s < node->filter_section_count; s++) {
+        const BiquadSection &section = node->filter_sections[s];
+        float *c = image->filter[s];
+        c[0] = section.b0;
+        c[1] = section.b1;
+        c[2] = section.b2;
+        c[3] = section.a1;
+        c[4] = section.a2;
+    }
 
-static bool platform_dac_write(const float *buffer, size_t frames) {
-#ifdef TEENSY
-    // Write to Teensy DAC
-    return true;
-#elif defined(RASPBERRY_PI)
-    // Write to Pi DAC
-    return true;
-#else
-    // Stub: discard output
-    return true;
+    memcpy(&image->calibration, &node->status.calibration, sizeof(CalibrationData));
+    if (node->clock_measured) {
+        image->flags |= HYBRID_BOOT_HAS_CLOCK;
+        image->clock_ppm = (float)node->clock_ppm;
+    }
+    if (dsp_rfft_get_tables(node->fft, image->fft_twiddle, image->fft_bitrev)) {
+        image->flags |= HYBRID_BOOT_HAS_FFT;
+    }
+#ifdef HYBRID_NODE_Q31
+    if (q31_fft_init()) {
+        memcpy(image->q31_twiddle, g_q31_twiddle, sizeof(image->q31_twiddle));
+        image->flags |= HYBRID_BOOT_HAS_Q31;
+    }
 #endif
+    image->crc = boot_image_crc(image);
+    return true;
 }
 
-static void dsp_process_fft(const float *input, size_t frames) {
-    // Copy input to FFT buffer (mono mix)
-    for (size_t i = 0; i < frames && i < HYBRID_FFT_SIZE; i++) {
-        g_fft_input[i] = input[i * g_config.adc_channels];
+bool hybrid_save_boot_image(HybridNode *node, const char *filename) {
+    if (node == NULL || filename == NULL) {
+        return false;
     }
 
-    // Zero-pad if needed
-    if (frames < HYBRID_FFT_SIZE) {
-        memset(&g_fft_input[frames], 0, (HYBRID_FFT_SIZE - frames) * sizeof(float));
+    // Written beside the old image and renamed over it, so a reset midway
+    // leaves one image or the other
+    char temp[512];
+    HybridBootImage *image = new (std::nothrow) HybridBootImage;
+    bool ok = image != NULL && (size_t)snprintf(temp, sizeof(temp), "%s.tmp", filename) < sizeof(temp) &&
+              hybrid_capture_boot_image(node, image);
+    if (ok) {
+        FILE *fp = fopen(temp, "wb");
+        ok = fp != NULL && fwrite(image, sizeof(HybridBootImage), 1, fp) == 1;
+        if (fp != NULL) {
+            ok = fclose(fp) == 0 && ok;
+        }
+        ok = ok && rename(temp, filename) == 0;
+        if (!ok) {
+            remove(temp);
+        }
     }
+    delete image;
 
-#ifdef USE_KISSFFT
-    // Perform FFT using KissFFT
-    kiss_fft_cfg cfg = kiss_fft_alloc(HYBRID_FFT_SIZE, 0, NULL, NULL);
-    kiss_fft(cfg, (kiss_fft_cpx*)g_fft_input, (kiss_fft_cpx*)g_fft_output);
-    free(cfg);
-#else
-    // Stub: simple DFT for testing
-    for (size_t k = 0; k < HYBRID_FFT_SIZE / 2; k++) {
-        float real = 0.0f, imag = 0.0f;
-        for (size_t n = 0; n < HYBRID_FFT_SIZE; n++) {
-            float angle = 2.0f * M_PI * k * n / HYBRID_FFT_SIZE;
-            real += g_fft_input[n] * cosf(angle);
-            imag -= g_fft_input[n] * sinf(angle);
-        }
-        g_fft_output[k * 2] = real;
-        g_fft_output[k * 2 + 1] = imag;
+    if (ok && node->config.enable_logging) {
+        firmware_log("[HybridNode] Boot image saved to %s\n", filename);
     }
-#endif
 
-    // Calculate spectral centroid
-    float weighted_sum = 0.0f;
-    float magnitude_sum = 0.0f;
+    return ok;
+}
 
-    for (size_t k = 1; k < HYBRID_FFT_SIZE / 2; k++) {
-        float real = g_fft_output[k * 2];
-        float imag = g_fft_output[k * 2 + 1];
-        float magnitude = sqrtf(real * real + imag * imag);
-        float freq = (k * g_config.sample_rate) / (float)HYBRID_FFT_SIZE;
+bool hybrid_reset_statistics(HybridNode *node) {
+    if (node == NULL) {
+        return false;
+    }
 
-        weighted_sum += freq * magnitude;
-        magnitude_sum += magnitude;
+    node->status.stats.frames_processed = 0;
+    node->status.stats.frames_dropped = 0;
+    node->status.stats.deadline_overruns = 0;
+    node->status.stats.denormal_buffers = 0;
+    node->status.stats.uptime_ms = 0;
+    node->status.stats.drift_ppm = 0.0f;
+    node->status.stats.load_level_changes = 0;
+    memset(node->status.stats.load_level_buffers, 0, sizeof(node->status.stats.load_level_buffers));
+    memset(&node->status.stats.deadline, 0, sizeof(node->status.stats.deadline));
+    hybrid_reset_latency(node);
+    if (node->running) {
+        node->stage_generation.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        stage_reset(node);
+        publish_status(node);
     }
 
-    if (magnitude_sum > 0.0f) {
-        g_status.dsp.spectral_centroid = weighted_sum / magnitude_sum;
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Statistics reset\n");
     }
 
-    // Calculate spectral flux
-    float flux = fabsf(g_status.dsp.spectral_centroid - g_prev_spectral_centroid);
-    g_status.dsp.spectral_flux = flux;
-    g_prev_spectral_centroid = g_status.dsp.spectral_centroid;
+    return true;
+}
+
+bool hybrid_set_mode(HybridNode *node, HybridNodeMode mode) {
+    if (node == NULL || node->running) {
+        return false;  // Cannot change mode while running
+    }
+
+    node->config.mode = mode;
+    node->status.mode = mode;
+    publish_node_status(node);
+
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Mode set to %d\n", mode);
+    }
+
+    return true;
+}
+
+bool hybrid_set_engine(HybridNode *node, HybridEngineProcess process, void *engine) {
+    if (node == NULL || node->running) {
+        return false;  // The audio context reads the engine unlocked
+    }
+
+    node->engine_process = process;
+    node->engine = process != NULL ? engine : NULL;
+    return true;
+}
+
+bool hybrid_set_buffer_observer(HybridNode *node, HybridBufferObserver observer, void *context) {
+    if (node == NULL || node->running) {
+        return false;  // The audio context reads the observer unlocked
+    }
+
+    node->buffer_observer = observer;
+    node->observer_context = observer != NULL ? context : NULL;
+    node->observer_dropped = node->status.stats.frames_dropped;
+    return true;
+}
+
+bool hybrid_set_deadline_callback(HybridNode *node, HybridBufferObserver callback, void *context) {
+    if (node == NULL || node->running) {
+        return false;  // The audio context reads the callback unlocked
+    }
+
+    node->deadline_callback = callback;
+    node->deadline_context = callback != NULL ? context : NULL;
+    return true;
+}
+
+bool hybrid_request_load_shed(HybridNode *node) {
+    if (node == NULL) {
+        return false;
+    }
+
+    node->shed_requested.store(true, std::memory_order_relaxed);
+    return true;
+}
+
+uint8_t hybrid_get_load_level(HybridNode *node) {
+    if (node == NULL) {
+        return HYBRID_LOAD_FULL;
+    }
+
+    return node->load_level.load(std::memory_order_relaxed);
+}
+
+bool hybrid_emergency_shutdown(HybridNode *node, const char *reason) {
+    if (node == NULL) {
+        return false;
+    }
+
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] EMERGENCY SHUTDOWN: %s\n", reason);
+    }
+
+    // Stop processing immediately
+    hybrid_stop(node);
+
+    // Set safety status
+    node->status.safety.status = HYBRID_SAFETY_FAULT;
+
+    // Clamp all outputs to 0V
+    memset(node->dac_buffer, 0, sizeof(node->dac_buffer));
+    platform_dac_write(node, node->dac_buffer, node->config.buffer_size);
+
+    node->status.control.cv1 = 0.0f;
+    node->status.control.cv2 = 0.0f;
+    publish_control_voltage(node);
+    publish_status(node);
+
+    return true;
+}
+
+bool hybrid_realtime_enter(HybridNode *node) {
+    if (node == NULL || !node->initialized) {
+        return false;
+    }
+
+    HybridRealtimeStatus *rt = &node->status.realtime;
+#if defined(__linux__)
+    if (!rt->memory_locked) {
+        // Locking now also brings in every page mapped so far
+        realtime_lock_memory(node);
+    }
+
+    struct sched_param param;
+    memset(&param, 0, sizeof(param));
+    param.sched_priority = node->config.realtime_priority != 0 ? node->config.realtime_priority : REALTIME_DEFAULT_PRIORITY;
+    int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    rt->sched_fifo = err == 0;
+    realtime_fail(rt, err);
+
+    const uint32_t isolated = realtime_isolated_cpus();
+    uint32_t cpus = node->config.realtime_cpus;
+    if (cpus == 0) {
+        cpus = isolated & (0u - isolated);
+    }
+    rt->cpu_pinned = false;
+    rt->cpu_isolated = false;
+    rt->cpu = -1;
+    if (cpus != 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int c = 0; c < 32; c++) {
+            if (cpus & (1u << c)) {
+                CPU_SET(c, &set);
+            }
+        }
+        err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        realtime_fail(rt, err);
+        if (err == 0) {
+            rt->cpu_pinned = true;
+            rt->cpu_isolated = (cpus & ~isolated) == 0;
+            rt->cpu = __builtin_ctz(cpus);
+        }
+    }
+
+    realtime_prefault_stack();
+    rt->prefaulted = true;
+    const bool ok = rt->memory_locked && rt->sched_fifo && (cpus == 0 || rt->cpu_pinned);
+#else
+    realtime_fail(rt, ENOSYS);
+    const bool ok = false;
+#endif
+
+    publish_node_status(node);
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] Real-time mode: FIFO %d, locked %d, CPU %d%s\n", rt->sched_fifo, rt->memory_locked,
+                     rt->cpu, rt->cpu_isolated ? " (isolated)" : "");
+    }
+    return ok;
+}
+
+const char* hybrid_node_get_version(void) {
+    return FIRMWARE_VERSION;
+}
+
+#ifdef HYBRID_NODE_SIMULATION
+bool hybrid_sim_configure(HybridNode *node, const HybridSimConfig *config) {
+    if (node == NULL || (config != NULL && config->samples != NULL && config->frames == 0) ||
+        (config != NULL && config->loopback && config->loopback_frames > HYBRID_SIM_LOOPBACK_FRAMES - HYBRID_BUFFER_SIZE)) {
+        return false;
+    }
+    const HybridSimConfig tone = {NULL, 0, false, CAL_TONE_FREQ, 0.5f, false};
+    node->sim_config = config != NULL ? *config : tone;
+    node->sim_position = 0;
+    memset(node->sim_loop, 0, sizeof(node->sim_loop));
+    return true;
+}
+
+bool hybrid_sim_run(HybridNode *node, uint32_t blocks, HybridSimReport *report) {
+    if (node == NULL || !node->running) {
+        return false;
+    }
+
+    if (node->config.enable_realtime) {
+        hybrid_realtime_enter(node);
+    }
+
+    HybridSimReport run;
+    memset(&run, 0, sizeof(run));
+    const size_t frames = node->config.buffer_size;
+    const uint64_t period_ns = (uint64_t)frames * 1000000000u / node->config.sample_rate;
+    const uint64_t overruns_before = node->status.stats.deadline_overruns;
+    double cpu_load_sum = 0.0;
+
+    // Buffer k is complete at origin + (k + 1) * period and due for output
+    // one period later, when buffer k + 1 completes
+    const uint64_t origin = sim_clock_ns();
+    uint64_t next = 0;
+    while (next < blocks) {
+        if (!node->sim_config.free_run) {
+            uint64_t released = (sim_clock_ns() - origin) / period_ns;
+            if (released > blocks) {
+                released = blocks;
+            }
+            if (released <= next) {
+                sim_sleep_until(origin + (next + 1) * period_ns);
+                continue;
+            }
+            uint64_t backlog = released - next;
+            if (backlog > HYBRID_SIM_RING_BLOCKS) {
+                // The DMA has wrapped over the oldest buffers
+                const uint64_t lost = backlog - HYBRID_SIM_RING_BLOCKS;
+                for (uint64_t k = 0; k < lost; k++) {
+                    platform_adc_read(node, node->sim_input, frames);
+                }
+                node->status.stats.frames_dropped += lost;
+                run.blocks_dropped += lost;
+                next += lost;
+                backlog = HYBRID_SIM_RING_BLOCKS;
+            }
+            node->status.stats.buffer_utilization = 100.0f * backlog / HYBRID_SIM_RING_BLOCKS;
+            if (node->status.stats.buffer_utilization > run.peak_buffer_utilization) {
+                run.peak_buffer_utilization = node->status.stats.buffer_utilization;
+            }
+        }
+
+        if (!sim_spi_half(node)) {
+            platform_adc_read(node, node->sim_input, frames);
+            hybrid_process_inplace(node, node->sim_input, node->sim_output, frames);
+            platform_dac_write(node, node->sim_output, frames);
+        }
+        if (node->config.defer_dsp) {
+            // The DSP task catches up while the next buffer fills
+            hybrid_dsp_poll(node, 0);
+        }
+
+        cpu_load_sum += node->status.stats.cpu_load;
+        if (node->status.stats.cpu_load > run.peak_cpu_load) {
+            run.peak_cpu_load = node->status.stats.cpu_load;
+        }
+        if (node->status.calibration.total_latency_us > run.max_latency_us) {
+            run.max_latency_us = node->status.calibration.total_latency_us;
+        }
+        if (!node->sim_config.free_run && sim_clock_ns() - origin > (next + 2) * period_ns) {
+            run.deadline_misses++;
+        }
+        run.blocks_processed++;
+        next++;
+    }
+
+    run.blocks_released = blocks;
+    run.deadline_overruns = node->status.stats.deadline_overruns - overruns_before;
+    run.mean_cpu_load = run.blocks_processed > 0 ? (float)(cpu_load_sum / run.blocks_processed) : 0.0f;
+    if (report != NULL) {
+        *report = run;
+    }
+    return true;
+}
+#endif
+
+#ifdef RASPBERRY_PI
+bool hybrid_alsa_open(HybridNode *node, const HybridAlsaConfig *config) {
+    if (node == NULL || !node->initialized || node->running) {
+        return false;
+    }
+    hybrid_alsa_close(node);
+
+    const HybridAlsaConfig defaults = {NULL, NULL, 0, 0};
+    if (config == NULL) {
+        config = &defaults;
+    }
+    const char *capture = config->capture_device != NULL ? config->capture_device : ALSA_DEFAULT_DEVICE;
+    const char *playback = config->playback_device != NULL ? config->playback_device : capture;
+    const snd_pcm_uframes_t period = config->period_frames != 0 ? config->period_frames : node->config.buffer_size;
+    const unsigned periods = config->periods != 0 ? config->periods : HYBRID_ALSA_PERIODS;
+    if (period == 0 || period > HYBRID_BUFFER_SIZE || periods < 2) {
+        return false;
+    }
+
+    snd_pcm_t *in = NULL, *out = NULL;
+    int err = snd_pcm_open(&in, capture, SND_PCM_STREAM_CAPTURE, 0);
+    if (err >= 0) {
+        node->alsa_capture = in;
+        err = snd_pcm_open(&out, playback, SND_PCM_STREAM_PLAYBACK, 0);
+    }
+    if (err >= 0) {
+        node->alsa_playback = out;
+        err = alsa_configure(node, in, node->config.adc_channels, period, periods, false);
+    }
+    if (err >= 0) {
+        err = alsa_configure(node, out, node->config.dac_channels, period, periods, true);
+    }
+    if (err < 0) {
+        if (node->config.enable_logging) {
+            firmware_log("[HybridNode] ALSA setup failed: %s\n", snd_strerror(err));
+        }
+        hybrid_alsa_close(node);
+        return false;
+    }
+
+    node->alsa_period = period;
+    node->alsa_buffer = period * periods;
+    node->alsa_linked = snd_pcm_link(in, out) == 0;
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] ALSA streams open: %u periods of %u frames, %.2f ms loop\n", periods,
+                     (unsigned)period, 1000.0 * node->alsa_buffer / node->config.sample_rate);
+    }
+    return true;
+}
+
+bool hybrid_alsa_run(HybridNode *node, uint32_t periods, HybridAlsaReport *report) {
+    if (node == NULL || !node->running || node->alsa_capture == NULL) {
+        return false;
+    }
+
+    if (node->config.enable_realtime) {
+        hybrid_realtime_enter(node);
+    }
+
+    HybridAlsaReport run;
+    memset(&run, 0, sizeof(run));
+    snd_pcm_t *capture = node->alsa_capture;
+    snd_pcm_t *playback = node->alsa_playback;
+    const snd_pcm_uframes_t period = node->alsa_period;
+    const double frame_ns = 1e9 / node->config.sample_rate;
+    uint64_t latency_sum_ns = 0;
+
+    bool ok = alsa_restart(node);
+    while (ok && run.periods_processed < periods) {
+        // Capture paces the loop; both rings run on the codec clock
+        const int ready = snd_pcm_wait(capture, 1000);
+        const snd_pcm_sframes_t avail = snd_pcm_avail_update(capture);
+        const snd_pcm_sframes_t space = snd_pcm_avail_update(playback);
+        if (ready < 0 || avail < 0 || space < 0) {
+            ok = alsa_xrun(node, &run);
+            continue;
+        }
+        if (ready == 0) {
+            if (node->config.enable_logging) {
+                firmware_log("[HybridNode] ALSA capture stalled\n");
+            }
+            ok = false;
+            break;
+        }
+        if ((snd_pcm_uframes_t)avail < period) {
+            continue;
+        }
+        if ((snd_pcm_uframes_t)space < period) {
+            if (snd_pcm_wait(playback, 1000) < 0) {
+                ok = alsa_xrun(node, &run);
+            }
+            continue;
+        }
+
+        // Age of the oldest captured frame, then the period in place
+        snd_pcm_sframes_t delay_in = 0, delay_out = 0;
+        snd_pcm_delay(capture, &delay_in);
+        const uint32_t start_ns = latency_clock_ns();
+        const snd_pcm_channel_area_t *in_areas, *out_areas;
+        snd_pcm_uframes_t in_offset, out_offset, in_frames = period, out_frames = period;
+        if (snd_pcm_mmap_begin(capture, &in_areas, &in_offset, &in_frames) < 0 ||
+            snd_pcm_mmap_begin(playback, &out_areas, &out_offset, &out_frames) < 0) {
+            ok = alsa_xrun(node, &run);
+            continue;
+        }
+        AlsaSample *in = alsa_frames(in_areas, in_offset, node->config.adc_channels);
+        AlsaSample *out = alsa_frames(out_areas, out_offset, node->config.dac_channels);
+        if (in_frames != period || out_frames != period || in == NULL || out == NULL) {
+            // Rings of whole periods keep every period contiguous and
+            // interleaved; anything else is a device we cannot run in place
+            if (node->config.enable_logging) {
+                firmware_log("[HybridNode] ALSA ring layout not supported\n");
+            }
+            ok = false;
+            break;
+        }
+        node->status.stats.buffer_utilization = 100.0f * avail / node->alsa_buffer;
+#ifdef HYBRID_NODE_Q31
+        process_buffer_q31(node, in, out, period, start_ns, node_clock_us());
+#else
+        process_buffer(node, in, out, period, start_ns, node_clock_us());
+#endif
+        if (snd_pcm_mmap_commit(capture, in_offset, period) != (snd_pcm_sframes_t)period ||
+            snd_pcm_mmap_commit(playback, out_offset, period) != (snd_pcm_sframes_t)period) {
+            ok = alsa_xrun(node, &run);
+            continue;
+        }
+
+        // The oldest frame plays once the playback queue ahead of the
+        // period has drained
+        snd_pcm_delay(playback, &delay_out);
+        const uint64_t latency_ns = (uint64_t)((delay_in + delay_out - (snd_pcm_sframes_t)period) * frame_ns) +
+                                    (latency_clock_ns() - start_ns);
+        const uint32_t latency_us = (uint32_t)(latency_ns / 1000u);
+        if (latency_us > run.max_loop_latency_us) {
+            run.max_loop_latency_us = latency_us;
+        }
+        latency_sum_ns += latency_ns;
+        if (node->status.stats.cpu_load > run.peak_cpu_load) {
+            run.peak_cpu_load = node->status.stats.cpu_load;
+        }
+        run.periods_processed++;
+
+        if (node->config.defer_dsp) {
+            // The DSP task catches up while the next period fills
+            hybrid_dsp_poll(node, 0);
+        }
+    }
+
+    // Stopped but prepared, so the output clamp of hybrid_stop still queues
+    snd_pcm_drop(capture);
+    snd_pcm_drop(playback);
+    snd_pcm_prepare(capture);
+    snd_pcm_prepare(playback);
+    run.mean_loop_latency_us = run.periods_processed > 0 ? (uint32_t)(latency_sum_ns / run.periods_processed / 1000u) : 0;
+    run.meets_sc001 = run.periods_processed > 0 && run.max_loop_latency_us <= 2000;
+    if (report != NULL) {
+        *report = run;
+    }
+    return ok;
+}
+
+void hybrid_alsa_close(HybridNode *node) {
+    if (node == NULL) {
+        return;
+    }
+    if (node->alsa_capture != NULL) {
+        snd_pcm_drop(node->alsa_capture);
+        snd_pcm_close(node->alsa_capture);
+        node->alsa_capture = NULL;
+    }
+    if (node->alsa_playback != NULL) {
+        snd_pcm_drop(node->alsa_playback);
+        snd_pcm_close(node->alsa_playback);
+        node->alsa_playback = NULL;
+    }
+    node->alsa_linked = false;
+}
+#endif
+
+bool hybrid_usb_open(HybridNode *node, const HybridUsbConfig *config) {
+    if (node == NULL || !node->initialized || node->running ||
+        node->config.interface_type != HYBRID_INTERFACE_USB) {
+        return false;
+    }
+    const HybridUsbConfig defaults = {HYBRID_USB_INTERVAL_MS, false};
+    HybridUsbConfig usb = config != NULL ? *config : defaults;
+    if (usb.service_interval_ms == 0) {
+        usb.service_interval_ms = HYBRID_USB_INTERVAL_MS;
+    }
+    const size_t interval = usb.service_interval_ms;
+    if (interval > 8 || (interval & (interval - 1)) != 0) {
+        return false;
+    }
+    hybrid_usb_close(node);
+
+    // The feedback moves a packet by well under a frame per millisecond
+    const size_t nominal = (node->config.sample_rate * interval + 999) / 1000;
+    const size_t packet_max = nominal + interval;
+    const size_t buffer = node->config.buffer_size;
+    const size_t adc = node->config.adc_channels;
+    const size_t dac = node->config.dac_channels;
+    // Whole buffers for the target, the buffer being added and the packet
+    // being sent, with a buffer to spare
+    const size_t ring = (3 * buffer + nominal + packet_max + buffer - 1) / buffer * buffer;
+    node->usb_input = new (std::nothrow) HybridUsbSample[(buffer + packet_max) * adc];
+    node->usb_output = new (std::nothrow) HybridUsbSample[(ring + packet_max) * dac]();
+    node->usb_silence = new (std::nothrow) HybridUsbSample[packet_max * dac]();
+    if (node->usb_input == NULL || node->usb_output == NULL || node->usb_silence == NULL) {
+        hybrid_usb_close(node);
+        if (node->config.enable_logging) {
+            firmware_log("[HybridNode] USB buffer allocation failed\n");
+        }
+        return false;
+    }
+
+    node->usb_config = usb;
+    node->usb_packet_max = packet_max;
+    node->usb_ring_frames = ring;
+    node->usb_target = buffer + nominal;
+    node->usb_sofs_per_ms = usb.high_speed ? 8 : 1;
+    node->usb_nominal = node->config.sample_rate / (1000.0 * node->usb_sofs_per_ms);
+    node->usb_rate = node->usb_nominal;
+    if (node->clock_measured && fabs(node->clock_ppm) * 1e-6 < USB_RATE_TOLERANCE) {
+        node->usb_rate *= 1.0 + node->clock_ppm * 1e-6;
+    }
+    usb_stream_reset(node);
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] USB audio: %u ms interval, %u-frame packets, %u-frame IN queue target\n",
+                     (unsigned)interval, (unsigned)nominal, (unsigned)node->usb_target);
+    }
+    return true;
+}
+
+HybridUsbSample* hybrid_usb_out_buffer(HybridNode *node, size_t *max_frames) {
+    if (node == NULL || max_frames == NULL || node->usb_input == NULL) {
+        return NULL;
+    }
+    *max_frames = node->usb_packet_max;
+    return node->usb_input + node->usb_input_frames * node->config.adc_channels;
+}
+
+bool hybrid_usb_out_complete(HybridNode *node, size_t frames) {
+    if (node == NULL || node->usb_input == NULL || frames > node->usb_packet_max) {
+        return false;
+    }
+    node->usb_stats.packets_out++;
+    if (!node->running) {
+        node->usb_input_frames = 0;
+        return false;
+    }
+
+    // Each complete buffer in place; what the packet brought past its end
+    // moves to the front for the next
+    const size_t buffer = node->config.buffer_size;
+    const size_t adc = node->config.adc_channels;
+    node->usb_input_frames += frames;
+    while (node->usb_input_frames >= buffer) {
+        usb_process(node);
+        node->usb_input_frames -= buffer;
+        memmove(node->usb_input, node->usb_input + buffer * adc,
+                node->usb_input_frames * adc * sizeof(HybridUsbSample));
+    }
+    return true;
+}
+
+const HybridUsbSample* hybrid_usb_in_packet(HybridNode *node, size_t *frames) {
+    if (node == NULL || frames == NULL || node->usb_output == NULL) {
+        return NULL;
+    }
+
+    // What the node clock produced over the interval
+    const double due = node->usb_in_phase +
+                       node->usb_rate * node->usb_sofs_per_ms * node->usb_config.service_interval_ms;
+    size_t n = (size_t)due;
+    node->usb_in_phase = due - (double)n;
+    if (n > node->usb_packet_max) {
+        n = node->usb_packet_max;
+    }
+    *frames = n;
+    node->usb_stats.packets_in++;
+
+    const uint64_t queued = node->usb_written - node->usb_read;
+    if (!node->usb_primed && queued >= node->usb_target) {
+        node->usb_primed = true;
+    }
+    const HybridUsbSample *packet = node->usb_silence;
+    if (node->usb_primed && queued >= n) {
+        packet = node->usb_output + (size_t)(node->usb_read % node->usb_ring_frames) * node->config.dac_channels;
+        node->usb_read += n;
+        node->usb_last_packet = n;
+    } else {
+        if (node->usb_primed) {
+            node->usb_stats.underruns++;
+            node->status.stats.frames_dropped++;
+            node->usb_primed = false;
+        }
+        node->usb_last_packet = 0;
+    }
+    usb_publish(node);
+    return packet;
+}
+
+uint32_t hybrid_usb_sof(HybridNode *node, uint32_t node_us) {
+    if (node == NULL || node->usb_output == NULL) {
+        return 0;
+    }
+
+    // Node clock against the bus over a long window, so the microsecond
+    // clock resolves about a ppm
+    const uint32_t window = USB_RATE_WINDOW_MS * node->usb_sofs_per_ms;
+    if (node->usb_window_sofs > 0) {
+        // A SOF the stack missed leaves a gap of whole (micro)frames;
+        // counting them keeps the window's length right
+        const double frames = (double)(uint32_t)(node_us - node->usb_last_sof_us) * 1e-3 * node->usb_sofs_per_ms;
+        if (frames > 1.5) {
+            node->usb_window_sofs += (uint32_t)lround(frames) - 1;
+        }
+    }
+    node->usb_last_sof_us = node_us;
+    if (node->usb_window_sofs == 0) {
+        node->usb_window_us = node_us;
+    } else if (node->usb_window_sofs >= window) {
+        const double rate = (double)(uint32_t)(node_us - node->usb_window_us) * 1e-6 *
+                            node->config.sample_rate / node->usb_window_sofs;
+        if (fabs(rate / node->usb_nominal - 1.0) < USB_RATE_TOLERANCE) {
+            node->usb_rate = rate;
+            node->clock_ppm = (rate / node->usb_nominal - 1.0) * 1e6;
+            node->clock_measured = true;
+        }
+        node->usb_window_us = node_us;
+        node->usb_window_sofs = 0;
+    }
+    node->usb_window_sofs++;
+
+    // Trimmed towards the queue target, which absorbs the rate error
+    // until the first measurement (of this stream, or the last one's)
+    const double queued = (double)(node->usb_written - node->usb_read);
+    node->usb_queue_average += (queued - node->usb_queue_average) / (USB_QUEUE_SMOOTHING_MS * node->usb_sofs_per_ms);
+    const double limit = node->usb_rate * USB_FEEDBACK_TRIM_PPM * 1e-6;
+    double trim = ((double)node->usb_target - node->usb_queue_average) / (USB_FEEDBACK_SETTLE_MS * node->usb_sofs_per_ms);
+    trim = trim > limit ? limit : (trim < -limit ? -limit : trim);
+    const double feedback = node->usb_rate + trim;
+    node->usb_stats.feedback = (float)feedback;
+    node->usb_stats.clock_ppm = (float)((node->usb_rate / node->usb_nominal - 1.0) * 1e6);
+    return (uint32_t)lround(feedback * (node->usb_config.high_speed ? 65536.0 : 16384.0));
+}
+
+bool hybrid_usb_get_stats(HybridNode *node, HybridUsbStats *stats) {
+    if (node == NULL || stats == NULL || node->usb_output == NULL) {
+        return false;
+    }
+    status_read(&node->usb_slot, stats);
+    return true;
+}
+
+void hybrid_usb_close(HybridNode *node) {
+    if (node == NULL) {
+        return;
+    }
+    delete[] node->usb_input;
+    delete[] node->usb_output;
+    delete[] node->usb_silence;
+    node->usb_input = NULL;
+    node->usb_output = NULL;
+    node->usb_silence = NULL;
+}
+
+#ifdef HYBRID_NODE_Q31
+bool hybrid_spi_open(HybridNode *node, const HybridSpiConfig *config) {
+    if (node == NULL || !node->initialized || node->running ||
+        node->config.interface_type != HYBRID_INTERFACE_SPI) {
+        return false;
+    }
+    const HybridSpiConfig defaults = {0, {1, 2}, {0, 1}, 0, 0, false};
+    HybridSpiConfig spi = config != NULL ? *config : defaults;
+    if (spi.clock_hz == 0) {
+        spi.clock_hz = HYBRID_SPI_CLOCK_HZ;
+    }
+    if (spi.adc_clock_hz == 0) {
+        spi.adc_clock_hz = HYBRID_SPI_ADC_CLOCK_HZ;
+    }
+    const size_t adc = node->config.adc_channels;
+    const size_t dac = node->config.dac_channels;
+    bool valid = spi.adc_cs <= SPI_MAX_CS;
+    for (size_t c = 0; c < adc; c++) {
+        valid = valid && spi.adc_inputs[c] < 8;
+    }
+    for (size_t chip = 0; chip < (dac + 1) / 2; chip++) {
+        valid = valid && spi.dac_cs[chip] <= SPI_MAX_CS && spi.dac_cs[chip] != spi.adc_cs;
+    }
+    unsigned prescale = 0;
+    while ((spi.clock_hz >> prescale) > spi.adc_clock_hz && prescale < SPI_MAX_PRESCALE) {
+        prescale++;
+    }
+    if (!valid || (spi.clock_hz >> prescale) > spi.adc_clock_hz) {
+        return false;
+    }
+
+    // A frame's transfers have to fit its sample period
+    const double adc_ns = SPI_ADC_BITS * 1e9 * (1u << prescale) / spi.clock_hz + SPI_CS_GAP_NS;
+    const double dac_ns = SPI_DAC_BITS * 1e9 / spi.clock_hz + SPI_CS_GAP_NS;
+    const double frame_ns = adc * adc_ns + dac * dac_ns;
+    const float bus_load = (float)(frame_ns * node->config.sample_rate * 1e-9);
+    if (bus_load > 1.0f) {
+        if (node->config.enable_logging) {
+            firmware_log("[HybridNode] SPI frame takes %.1f µs, over the %.1f µs sample period\n", frame_ns * 1e-3,
+                         1e6 / node->config.sample_rate);
+        }
+        return false;
+    }
+
+    hybrid_spi_close(node);
+    const size_t frames = node->config.buffer_size;
+    const size_t slots = adc + dac;
+    node->spi_tx = new (std::nothrow) uint32_t[2 * frames * slots * 2];
+    node->spi_rx = new (std::nothrow) int32_t[2 * frames * adc]();
+    node->spi_dac = new (std::nothrow) int32_t[frames * dac]();
+    if (node->spi_tx == NULL || node->spi_rx == NULL || node->spi_dac == NULL) {
+        hybrid_spi_close(node);
+        if (node->config.enable_logging) {
+            firmware_log("[HybridNode] SPI table allocation failed\n");
+        }
+        return false;
+    }
+    node->spi_config = spi;
+    node->spi_slots = slots;
+    node->config.sample_bits = 12;
+
+    // The commands never change; the DAC data words start at rest
+    for (size_t i = 0; i < 2 * frames; i++) {
+        uint32_t *pair = node->spi_tx + i * slots * 2;
+        for (size_t c = 0; c < adc; c++, pair += 2) {
+            pair[0] = SPI_TCR_PCS(spi.adc_cs) | SPI_TCR_FRAMESZ(SPI_ADC_BITS) | SPI_TCR_PRESCALE(prescale);
+            pair[1] = MCP3208_COMMAND(spi.adc_inputs[c]);
+        }
+        for (size_t c = 0; c < dac; c++, pair += 2) {
+            pair[0] = SPI_TCR_PCS(spi.dac_cs[c / 2]) | SPI_TCR_FRAMESZ(SPI_DAC_BITS) | SPI_TCR_RXMSK;
+            pair[1] = spi_dac_word(node, c, 0);
+        }
+    }
+    memset(&node->spi_stats, 0, sizeof(node->spi_stats));
+    node->spi_stats.frame_ns = (uint32_t)frame_ns;
+    node->spi_stats.bus_load = bus_load;
+    status_write(&node->spi_slot, node->spi_stats);
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] SPI converters: %.1f µs a frame, %.0f%% of the bus, ADC at %u kHz\n",
+                     frame_ns * 1e-3, bus_load * 100.0f, (unsigned)((spi.clock_hz >> prescale) / 1000u));
+    }
+    return true;
+}
+
+bool hybrid_spi_start(HybridNode *node) {
+    if (node == NULL || node->spi_tx == NULL || !node->running || node->spi_running) {
+        return false;
+    }
+    node->spi_next_half = 0;
+    if (!platform_spi_start(node)) {
+        return false;
+    }
+    node->spi_running = true;
+    return true;
+}
+
+void hybrid_spi_dma_half(HybridNode *node, unsigned half) {
+    if (node == NULL || node->spi_tx == NULL || half > 1) {
+        return;
+    }
+    if (half != node->spi_next_half) {
+        // The DMA lapped the processing; that half's audio is gone
+        node->spi_stats.missed_halves++;
+        node->status.stats.frames_dropped++;
+    }
+    node->spi_next_half = half ^ 1u;
+
+    const size_t frames = node->config.buffer_size;
+    const size_t count = frames * node->config.adc_channels;
+    if (node->running) {
+        // 12-bit offset binary to Q31 in place, the bits around the code
+        // (null bit, floating MISO) masked off
+        int32_t *work = node->spi_rx + half * count;
+#ifdef TEENSY
+        arm_dcache_delete(work, count * sizeof(int32_t));
+#endif
+        const uint32_t start_ns = latency_clock_ns();
+        for (size_t i = 0; i < count; i++) {
+            const int32_t code = (int32_t)((uint32_t)work[i] & SPI_CODE_MASK) - SPI_CODE_MID;
+            work[i] = (int32_t)((uint32_t)code << 20);
+        }
+        process_buffer_q31(node, work, node->spi_dac, frames, start_ns, node_clock_us());
+    } else {
+        // Stopped: the outputs rest at zero
+        memset(node->spi_dac, 0, frames * node->config.dac_channels * sizeof(int32_t));
+    }
+    spi_encode(node, half);
+    node->spi_stats.blocks++;
+    status_write(&node->spi_slot, node->spi_stats);
+}
+
+bool hybrid_spi_get_stats(HybridNode *node, HybridSpiStats *stats) {
+    if (node == NULL || stats == NULL || node->spi_tx == NULL) {
+        return false;
+    }
+    status_read(&node->spi_slot, stats);
+    return true;
+}
+
+void hybrid_spi_stop(HybridNode *node) {
+    if (node == NULL || !node->spi_running) {
+        return;
+    }
+    platform_spi_stop(node);
+    node->spi_running = false;
+}
+
+void hybrid_spi_close(HybridNode *node) {
+    if (node == NULL) {
+        return;
+    }
+    hybrid_spi_stop(node);
+    delete[] node->spi_tx;
+    delete[] node->spi_rx;
+    delete[] node->spi_dac;
+    node->spi_tx = NULL;
+    node->spi_rx = NULL;
+    node->spi_dac = NULL;
+}
+#endif
+
+//==============================================================================
+// DEFAULT NODE
+//==============================================================================
+
+bool hybrid_node_init(const HybridNodeConfig *config) {
+    return hybrid_init(&g_default_node, config);
+}
+
+bool hybrid_node_start(void) {
+    return hybrid_start(&g_default_node);
+}
+
+bool hybrid_node_stop(void) {
+    return hybrid_stop(&g_default_node);
+}
+
+bool hybrid_node_process(const float *input, float *output, size_t frames) {
+    return hybrid_process(&g_default_node, input, output, frames);
+}
+
+bool hybrid_node_process_inplace(float *adc, float *dac, size_t frames) {
+    return hybrid_process_inplace(&g_default_node, adc, dac, frames);
+}
+
+#ifdef HYBRID_NODE_Q31
+bool hybrid_node_process_q31(const int32_t *input, int32_t *output, size_t frames) {
+    return hybrid_process_q31(&g_default_node, input, output, frames);
+}
+#endif
+
+uint32_t hybrid_node_dsp_poll(uint32_t max_blocks) {
+    return hybrid_dsp_poll(&g_default_node, max_blocks);
+}
+
+uint32_t hybrid_node_dsp_pending(void) {
+    return hybrid_dsp_pending(&g_default_node);
+}
+
+bool hybrid_node_get_latency(HybridLatencyStats *stats) {
+    return hybrid_get_latency(&g_default_node, stats);
+}
+
+uint32_t hybrid_node_latency_percentile(float p) {
+    return hybrid_latency_percentile(&g_default_node, p);
+}
+
+bool hybrid_node_reset_latency(void) {
+    return hybrid_reset_latency(&g_default_node);
+}
+
+bool hybrid_node_set_preamp_gain(float gain) {
+    return hybrid_set_preamp_gain(&g_default_node, gain);
+}
+
+bool hybrid_node_set_filter(float hpf_cutoff, float lpf_cutoff, uint8_t order) {
+    return hybrid_set_filter(&g_default_node, hpf_cutoff, lpf_cutoff, order);
+}
+
+bool hybrid_node_set_control_voltage(const ControlVoltage *cv) {
+    return hybrid_set_control_voltage(&g_default_node, cv);
+}
+
+bool hybrid_node_get_status(HybridNodeStatus *status) {
+    return hybrid_get_status(&g_default_node, status);
+}
+
+bool hybrid_node_get_dsp_metrics(DSPMetrics *metrics) {
+    return hybrid_get_dsp_metrics(&g_default_node, metrics);
+}
+
+bool hybrid_node_get_safety(SafetyTelemetry *telemetry) {
+    return hybrid_get_safety(&g_default_node, telemetry);
+}
+
+bool hybrid_node_calibrate(CalibrationData *calibration) {
+    return hybrid_calibrate(&g_default_node, calibration);
+}
+
+bool hybrid_node_load_calibration(const CalibrationData *calibration) {
+    return hybrid_load_calibration(&g_default_node, calibration);
+}
+
+bool hybrid_node_save_calibration(const char *filename) {
+    return hybrid_save_calibration(&g_default_node, filename);
+}
+
+bool hybrid_node_load_calibration_file(const char *filename) {
+    return hybrid_load_calibration_file(&g_default_node, filename);
+}
+
+bool hybrid_node_init_fast(const HybridNodeConfig *config, const void *image, size_t size, uint32_t max_age_s,
+                           HybridBootImageStatus *verdict) {
+    return hybrid_init_fast(&g_default_node, config, image, size, max_age_s, verdict);
+}
+
+bool hybrid_node_init_from_file(const HybridNodeConfig *config, const char *filename, uint32_t max_age_s,
+                                HybridBootImageStatus *verdict) {
+    return hybrid_init_from_file(&g_default_node, config, filename, max_age_s, verdict);
+}
+
+bool hybrid_node_capture_boot_image(HybridBootImage *image) {
+    return hybrid_capture_boot_image(&g_default_node, image);
+}
+
+bool hybrid_node_save_boot_image(const char *filename) {
+    return hybrid_save_boot_image(&g_default_node, filename);
+}
+
+bool hybrid_node_reset_statistics(void) {
+    return hybrid_reset_statistics(&g_default_node);
+}
+
+bool hybrid_node_set_mode(HybridNodeMode mode) {
+    return hybrid_set_mode(&g_default_node, mode);
+}
+
+bool hybrid_node_set_engine(HybridEngineProcess process, void *engine) {
+    return hybrid_set_engine(&g_default_node, process, engine);
+}
+
+bool hybrid_node_set_buffer_observer(HybridBufferObserver observer, void *context) {
+    return hybrid_set_buffer_observer(&g_default_node, observer, context);
+}
+
+bool hybrid_node_set_deadline_callback(HybridBufferObserver callback, void *context) {
+    return hybrid_set_deadline_callback(&g_default_node, callback, context);
+}
+
+bool hybrid_node_request_load_shed(void) {
+    return hybrid_request_load_shed(&g_default_node);
+}
+
+uint8_t hybrid_node_get_load_level(void) {
+    return hybrid_get_load_level(&g_default_node);
+}
+
+bool hybrid_node_emergency_shutdown(const char *reason) {
+    return hybrid_emergency_shutdown(&g_default_node, reason);
+}
+
+bool hybrid_node_realtime_enter(void) {
+    return hybrid_realtime_enter(&g_default_node);
+}
+
+#ifdef HYBRID_NODE_SIMULATION
+bool hybrid_node_sim_configure(const HybridSimConfig *config) {
+    return hybrid_sim_configure(&g_default_node, config);
+}
+
+bool hybrid_node_sim_run(uint32_t blocks, HybridSimReport *report) {
+    return hybrid_sim_run(&g_default_node, blocks, report);
+}
+#endif
+
+#ifdef RASPBERRY_PI
+bool hybrid_node_alsa_open(const HybridAlsaConfig *config) {
+    return hybrid_alsa_open(&g_default_node, config);
+}
+
+bool hybrid_node_alsa_run(uint32_t periods, HybridAlsaReport *report) {
+    return hybrid_alsa_run(&g_default_node, periods, report);
+}
+
+void hybrid_node_alsa_close(void) {
+    hybrid_alsa_close(&g_default_node);
+}
+#endif
+
+bool hybrid_node_usb_open(const HybridUsbConfig *config) {
+    return hybrid_usb_open(&g_default_node, config);
+}
+
+HybridUsbSample* hybrid_node_usb_out_buffer(size_t *max_frames) {
+    return hybrid_usb_out_buffer(&g_default_node, max_frames);
+}
+
+bool hybrid_node_usb_out_complete(size_t frames) {
+    return hybrid_usb_out_complete(&g_default_node, frames);
+}
+
+const HybridUsbSample* hybrid_node_usb_in_packet(size_t *frames) {
+    return hybrid_usb_in_packet(&g_default_node, frames);
+}
+
+uint32_t hybrid_node_usb_sof(uint32_t node_us) {
+    return hybrid_usb_sof(&g_default_node, node_us);
+}
+
+bool hybrid_node_usb_get_stats(HybridUsbStats *stats) {
+    return hybrid_usb_get_stats(&g_default_node, stats);
+}
+
+void hybrid_node_usb_close(void) {
+    hybrid_usb_close(&g_default_node);
+}
+
+#ifdef HYBRID_NODE_Q31
+bool hybrid_node_spi_open(const HybridSpiConfig *config) {
+    return hybrid_spi_open(&g_default_node, config);
+}
+
+bool hybrid_node_spi_start(void) {
+    return hybrid_spi_start(&g_default_node);
+}
+
+void hybrid_node_spi_dma_half(unsigned half) {
+    hybrid_spi_dma_half(&g_default_node, half);
+}
+
+bool hybrid_node_spi_get_stats(HybridSpiStats *stats) {
+    return hybrid_spi_get_stats(&g_default_node, stats);
+}
+
+void hybrid_node_spi_stop(void) {
+    hybrid_spi_stop(&g_default_node);
+}
+
+void hybrid_node_spi_close(void) {
+    hybrid_spi_close(&g_default_node);
+}
+#endif
+
+//==============================================================================
+// INTERNAL HELPER FUNCTIONS
+//==============================================================================
+
+static bool platform_adc_init(HybridNode *node) {
+#ifdef TEENSY
+    // Teensy I²S ADC initialization would go here
+    return true;
+#elif defined(RASPBERRY_PI)
+    // Raspberry Pi I²S or SPI ADC initialization
+    return true;
+#else
+    // Stub for simulation/testing
+    return true;
+#endif
+}
+
+static bool platform_dac_init(HybridNode *node) {
+#ifdef TEENSY
+    // Teensy I²S DAC initialization would go here
+    return true;
+#elif defined(RASPBERRY_PI)
+    // Raspberry Pi I²S or SPI DAC initialization
+    return true;
+#else
+    // Stub for simulation/testing
+    return true;
+#endif
+}
+
+static bool platform_adc_read(HybridNode *node, float *buffer, size_t frames) {
+#ifdef TEENSY
+    // Read from Teensy ADC
+    return true;
+#elif defined(RASPBERRY_PI)
+    // Copying path for calibration; the real-time loop is hybrid_alsa_run
+    return alsa_read(node, buffer, frames);
+#elif defined(HYBRID_NODE_SIMULATION)
+    // Recorded samples, the synthetic tone or the loop, frame by frame
+    const size_t channels = node->config.adc_channels;
+    for (size_t i = 0; i < frames; i++, node->sim_position++) {
+        float *frame = buffer + i * channels;
+        if (node->sim_config.loopback) {
+            const uint64_t played = node->sim_position - node->sim_config.loopback_frames;
+            if (node->sim_position >= node->sim_config.loopback_frames) {
+                float *slot = &node->sim_loop[(played & (HYBRID_SIM_LOOPBACK_FRAMES - 1)) * HYBRID_ADC_CHANNELS];
+                memcpy(frame, slot, channels * sizeof(float));
+                memset(slot, 0, channels * sizeof(float));
+            } else {
+                memset(frame, 0, channels * sizeof(float));
+            }
+        } else if (node->sim_config.samples != NULL) {
+            uint64_t index = node->sim_position;
+            if (node->sim_config.loop) {
+                index %= node->sim_config.frames;
+            }
+            if (index < node->sim_config.frames) {
+                memcpy(frame, node->sim_config.samples + index * channels, channels * sizeof(float));
+            } else {
+                memset(frame, 0, channels * sizeof(float));
+            }
+        } else {
+            // Phase from the integer position so long runs do not drift
+            const double cycles = fmod((double)node->sim_position * node->sim_config.tone_hz / node->config.sample_rate, 1.0);
+            const float sample = node->sim_config.tone_level * (float)sin(2.0 * M_PI * cycles);
+            for (size_t c = 0; c < channels; c++) {
+                frame[c] = sample;
+            }
+        }
+    }
+    return true;
+#else
+    // Stub: generate silence
+    memset(buffer, 0, frames * node->config.adc_channels * sizeof(float));
+    return true;
+#endif
+}
+
+static bool platform_dac_write(HybridNode *node, const float *buffer, size_t frames) {
+#ifdef TEENSY
+    // Write to Teensy DAC
+    return true;
+#elif defined(RASPBERRY_PI)
+    return alsa_write(node, buffer, frames);
+#elif defined(HYBRID_NODE_SIMULATION)
+    // Into the loop from the ADC position on, as a zero-latency DAC would
+    // play it; discarded without loopback
+    if (node->sim_config.loopback) {
+        const size_t in_ch = node->config.adc_channels;
+        const size_t out_ch = node->config.dac_channels;
+        const size_t audio = in_ch < out_ch ? in_ch : out_ch;
+        for (size_t i = 0; i < frames; i++) {
+            const uint64_t at = (node->sim_position + i) & (HYBRID_SIM_LOOPBACK_FRAMES - 1);
+            memcpy(&node->sim_loop[at * HYBRID_ADC_CHANNELS], &buffer[i * out_ch], audio * sizeof(float));
+        }
+    }
+    return true;
+#else
+    // Stub: discard output
+    return true;
+#endif
+}
+
+// Next chip of the order-12 maximum length sequence, ±1
+static float cal_mls_next(uint32_t *state) {
+    const uint32_t lsb = *state & 1u;
+    *state >>= 1;
+    if (lsb) {
+        *state ^= CAL_MLS_TAPS;
+    }
+    return lsb ? 1.0f : -1.0f;
+}
+
+// In-place radix-2 FFT of n interleaved complex values, n a power of two,
+// unscaled either way. Calibration only, so plain loops with the twiddles
+// by recurrence in double.
+static void cal_fft(float *z, size_t n, bool inverse) {
+    for (size_t i = 1, j = 0; i < n; i++) {
+        size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            const float re = z[2 * i], im = z[2 * i + 1];
+            z[2 * i] = z[2 * j];
+            z[2 * i + 1] = z[2 * j + 1];
+            z[2 * j] = re;
+            z[2 * j + 1] = im;
+        }
+    }
+    for (size_t len = 2; len <= n; len <<= 1) {
+        const double angle = (inverse ? 2.0 : -2.0) * M_PI / (double)len;
+        const double step_r = cos(angle), step_i = sin(angle);
+        for (size_t base = 0; base < n; base += len) {
+            double wr = 1.0, wi = 0.0;
+            for (size_t j = 0; j < len / 2; j++) {
+                float *a = &z[2 * (base + j)];
+                float *b = &z[2 * (base + j + len / 2)];
+                const double tr = b[0] * wr - b[1] * wi;
+                const double ti = b[0] * wi + b[1] * wr;
+                b[0] = (float)(a[0] - tr);
+                b[1] = (float)(a[1] - ti);
+                a[0] = (float)(a[0] + tr);
+                a[1] = (float)(a[1] + ti);
+                const double next = wr * step_r - wi * step_i;
+                wi = wr * step_i + wi * step_r;
+                wr = next;
+            }
+        }
+    }
+}
+
+// Correlation at fractional lag t, windowed-sinc interpolated from the
+// real parts of the n lags in z
+static double cal_interpolate(const float *z, size_t n, double t) {
+    const long first = (long)floor(t) - CAL_SINC_HALF_TAPS + 1;
+    double sum = 0.0;
+    for (long k = first; k < first + 2 * CAL_SINC_HALF_TAPS; k++) {
+        if (k < 0 || k >= (long)n) {
+            continue;
+        }
+        const double x = t - (double)k;
+        const double sinc = fabs(x) < 1e-9 ? 1.0 : sin(M_PI * x) / (M_PI * x);
+        sum += z[2 * k] * sinc * (0.5 + 0.5 * cos(M_PI * x / CAL_SINC_HALF_TAPS));
+    }
+    return sum;
+}
+
+// Delay of a capture behind its reference by FFT cross-correlation. z
+// holds CAL_XCORR_SIZE complex values, capture in the real and reference
+// in the imaginary parts, zero past their ends; it is overwritten with the
+// correlation. Lags up to max_lag are searched; the strongest, of either
+// sign, is placed to a fraction of a frame by a parabola on its neighbours
+// and then refined on the band-limited interpolation. Returns the peak
+// over the highest lag further than CAL_XCORR_GUARD from it.
+static float cal_xcorr_delay(float *z, size_t max_lag, float *delay_frames) {
+    const size_t n = CAL_XCORR_SIZE;
+    double energy = 0.0;        // Of the reference, also its mean |S|^2
+    for (size_t i = 0; i < n; i++) {
+        energy += (double)z[2 * i + 1] * z[2 * i + 1];
+    }
+    const double floor_power = CAL_XCORR_FLOOR * energy;
+    cal_fft(z, n, false);
+
+    // Both spectra from the one transform, X = (Z[k] + Z*[-k]) / 2 and
+    // S = (Z[k] - Z*[-k]) / 2i, then X S* / |S|^2 at k and its conjugate
+    // at -k: dividing out the reference's own spectrum leaves the loop's
+    // impulse response, free of the sequence's aperiodic sidelobes
+    for (size_t k = 0; k <= n / 2; k++) {
+        const size_t j = (n - k) & (n - 1);
+        const double zr = z[2 * k], zi = z[2 * k + 1], cr = z[2 * j], ci = -z[2 * j + 1];
+        const double xr = 0.5 * (zr + cr), xi = 0.5 * (zi + ci);
+        const double sr = 0.5 * (zi - ci), si = -0.5 * (zr - cr);
+        double weight = 1.0 / (sr * sr + si * si + floor_power);
+        if (k > CAL_XCORR_TAPER * (n / 2)) {
+            // Raised-cosine roll-off to Nyquist, inside the band the
+            // interpolation kernel passes
+            const double u = ((double)k / (n / 2) - CAL_XCORR_TAPER) / (1.0 - CAL_XCORR_TAPER);
+            weight *= 0.5 + 0.5 * cos(M_PI * u);
+        }
+        const double rr = (xr * sr + xi * si) * weight, ri = (xi * sr - xr * si) * weight;
+        z[2 * k] = (float)rr;
+        z[2 * k + 1] = (float)ri;
+        z[2 * j] = (float)rr;
+        z[2 * j + 1] = (float)-ri;
+    }
+    cal_fft(z, n, true);
+
+    size_t peak = 0;
+    for (size_t d = 1; d <= max_lag; d++) {
+        if (fabsf(z[2 * d]) > fabsf(z[2 * peak])) {
+            peak = d;
+        }
+    }
+    float sidelobe = 0.0f;
+    for (size_t d = 0; d <= max_lag; d++) {
+        if ((d + CAL_XCORR_GUARD < peak || d > peak + CAL_XCORR_GUARD) && fabsf(z[2 * d]) > sidelobe) {
+            sidelobe = fabsf(z[2 * d]);
+        }
+    }
+
+    const double sign = z[2 * peak] < 0.0f ? -1.0 : 1.0;
+    double t = (double)peak;
+    if (peak > 0 && peak < max_lag) {
+        const double a = sign * z[2 * (peak - 1)], b = sign * z[2 * peak], c = sign * z[2 * (peak + 1)];
+        const double curvature = a - 2.0 * b + c;
+        t += curvature < 0.0 ? 0.5 * (a - c) / curvature : 0.0;
+    }
+    double h = 0.25;
+    for (int pass = 0; pass < 3; pass++, h *= 0.2) {
+        const double a = sign * cal_interpolate(z, n, t - h);
+        const double b = sign * cal_interpolate(z, n, t);
+        const double c = sign * cal_interpolate(z, n, t + h);
+        const double curvature = a - 2.0 * b + c;
+        if (curvature < 0.0) {
+            t += fmax(-h, fmin(h, 0.5 * h * (a - c) / curvature));
+        }
+    }
+    *delay_frames = (float)t;
+    return sidelobe > 0.0f ? fabsf(z[2 * peak]) / sidelobe : 0.0f;
+}
+
+// Plays one MLS period on the DAC audio channels, CV outputs at 0, and
+// records ADC channel 0 for CAL_XCORR_SIZE frames, a buffer at a time;
+// the delay and peak ratio of cal_xcorr_delay, or false if the loop could
+// not run
+static bool calibrate_loopback(HybridNode *node, float *delay_frames, float *peak_ratio) {
+    float *z = new (std::nothrow) float[2 * CAL_XCORR_SIZE];
+    if (z == NULL) {
+        return false;
+    }
+    const size_t in_ch = node->config.adc_channels;
+    const size_t out_ch = node->config.dac_channels;
+    const size_t audio = out_ch < 2 ? out_ch : 2;
+    size_t chunk = node->config.buffer_size;
+    if (chunk == 0 || chunk > HYBRID_BUFFER_SIZE) {
+        chunk = HYBRID_BUFFER_SIZE;
+    }
+
+    uint32_t state = 1u;
+    bool ok = in_ch > 0;
+    for (size_t done = 0; ok && done < CAL_XCORR_SIZE; done += chunk) {
+        const size_t frames = CAL_XCORR_SIZE - done < chunk ? CAL_XCORR_SIZE - done : chunk;
+        memset(node->dac_buffer, 0, frames * out_ch * sizeof(float));
+        for (size_t i = 0; i < frames; i++) {
+            const float chip = done + i < CAL_MLS_LENGTH ? CAL_MLS_LEVEL * cal_mls_next(&state) : 0.0f;
+            for (size_t c = 0; c < audio; c++) {
+                node->dac_buffer[i * out_ch + c] = chip;
+            }
+            z[2 * (done + i) + 1] = chip;
+        }
+        ok = platform_dac_write(node, node->dac_buffer, frames) &&
+             platform_adc_read(node, node->adc_buffer, frames);
+        for (size_t i = 0; ok && i < frames; i++) {
+            z[2 * (done + i)] = node->adc_buffer[i * in_ch];
+        }
+    }
+    if (ok) {
+        *peak_ratio = cal_xcorr_delay(z, CAL_XCORR_SIZE - CAL_MLS_LENGTH, delay_frames);
+    }
+    delete[] z;
+    return ok;
+}
+
+// Plays CAL_TONE_FREQ on DAC channel, every other output at 0, for
+// settle_frames and then CAL_TONE_CYCLES whole cycles, recording ADC
+// channel over those cycles a buffer at a time. The Goertzel bins of the
+// recording and of the tone as played give the loop's gain (ratio) and
+// phase in (-π, π], the loop delay included; dc is the recording's mean.
+// False if the loop could not run.
+static bool calibrate_tone(HybridNode *node, size_t channel, size_t settle_frames, float *ratio, float *phase,
+                           float *dc) {
+    const float rate = (float)node->config.sample_rate;
+    const size_t measured = (size_t)lrintf(CAL_TONE_CYCLES * rate / CAL_TONE_FREQ);
+    float *played = new (std::nothrow) float[2 * measured];
+    if (played == NULL || measured == 0) {
+        delete[] played;
+        return false;
+    }
+    float *captured = played + measured;
+    const size_t in_ch = node->config.adc_channels;
+    const size_t out_ch = node->config.dac_channels;
+    size_t chunk = node->config.buffer_size;
+    if (chunk == 0 || chunk > HYBRID_BUFFER_SIZE) {
+        chunk = HYBRID_BUFFER_SIZE;
+    }
+
+    // Phase from the integer position, as the simulated tone
+    const double step = (double)CAL_TONE_FREQ / (double)rate;
+    const size_t total = settle_frames + measured;
+    bool ok = true;
+    for (size_t done = 0; ok && done < total; done += chunk) {
+        const size_t frames = total - done < chunk ? total - done : chunk;
+        memset(node->dac_buffer, 0, frames * out_ch * sizeof(float));
+        for (size_t i = 0; i < frames; i++) {
+            const float x = CAL_TONE_LEVEL * (float)sin(2.0 * M_PI * fmod((double)(done + i) * step, 1.0));
+            node->dac_buffer[i * out_ch + channel] = x;
+            if (done + i >= settle_frames) {
+                played[done + i - settle_frames] = x;
+            }
+        }
+        ok = platform_dac_write(node, node->dac_buffer, frames) &&
+             platform_adc_read(node, node->adc_buffer, frames);
+        for (size_t i = 0; ok && i < frames; i++) {
+            if (done + i >= settle_frames) {
+                captured[done + i - settle_frames] = node->adc_buffer[i * in_ch + channel];
+            }
+        }
+    }
+
+    if (ok) {
+        // The loop's transfer at the tone: Y / X
+        float x[2], y[2];
+        dsp_goertzel(played, measured, 1, CAL_TONE_FREQ, rate, x);
+        dsp_goertzel(captured, measured, 1, CAL_TONE_FREQ, rate, y);
+        const double x_power = (double)x[0] * x[0] + (double)x[1] * x[1];
+        const double re = ((double)y[0] * x[0] + (double)y[1] * x[1]) / x_power;
+        const double im = ((double)y[1] * x[0] - (double)y[0] * x[1]) / x_power;
+        *ratio = (float)sqrt(re * re + im * im);
+        *phase = (float)atan2(im, re);
+        double sum = 0.0;
+        for (size_t i = 0; i < measured; i++) {
+            sum += captured[i];
+        }
+        *dc = (float)(sum / (double)measured);
+    }
+    delete[] played;
+    return ok;
+}
+
+static void dsp_analysis_init(HybridNode *node) {
+    node->fft_hop = node->config.fft_hop == 0 ? HYBRID_FFT_SIZE / 2 : node->config.fft_hop;
+    if (node->fft_hop > HYBRID_FFT_SIZE) {
+        node->fft_hop = HYBRID_FFT_SIZE;
+    }
+    const float rate = (float)node->config.sample_rate;
+    node->ici_alpha = 1.0f - expf(-(float)node->fft_hop / (ICI_THRESHOLD_TIME_S * rate));
+    node->coherence_alpha = 1.0f - expf(-(float)node->fft_hop / (COHERENCE_TIME_S * rate));
+    node->coherence_stereo = node->config.enable_coherence && node->config.adc_channels >= 2;
+    node->distortion_lobe = node->config.fft_window == HYBRID_WINDOW_BLACKMAN ? 3
+                            : node->config.fft_window == HYBRID_WINDOW_RECTANGULAR ? 1 : 2;
+    node->ici_refractory = (uint32_t)(ICI_REFRACTORY_MS * 1e-3f * rate);
+    node->ici_max_interval = (uint32_t)(ICI_MAX_INTERVAL_MS * 1e-3f * rate * 256.0f);
+
+    // Periodic windows, so overlapping frames at hop N/2 (Hann) or N/3
+    // (Blackman) sum to a constant
+    dsp_window((DspWindow)node->config.fft_window, true, node->fft_window, HYBRID_FFT_SIZE);
+#ifdef HYBRID_NODE_Q31
+    for (size_t n = 0; n < HYBRID_FFT_SIZE; n++) {
+        node->q31_fft_window[n] = (int32_t)lrint((double)node->fft_window[n] * INT32_MAX);
+    }
+#endif
+    dsp_analysis_reset(node);
+}
+
+static void dsp_analysis_reset(HybridNode *node) {
+    memset(node->fft_history, 0, sizeof(node->fft_history));
+    memset(node->fft_prev_magnitude, 0, sizeof(node->fft_prev_magnitude));
+    memset(node->coherence_history, 0, sizeof(node->coherence_history));
+    memset(node->coherence_sxx, 0, sizeof(node->coherence_sxx));
+    memset(node->coherence_syy, 0, sizeof(node->coherence_syy));
+    memset(node->coherence_sxy, 0, sizeof(node->coherence_sxy));
+    node->distortion_bin = 0;
+    node->status.analog.thd = 0.0f;
+    node->status.analog.snr_db = 0.0f;
+#ifdef HYBRID_NODE_Q31
+    memset(node->q31_fft_history, 0, sizeof(node->q31_fft_history));
+    memset(node->q31_fft_prev_magnitude, 0, sizeof(node->q31_fft_prev_magnitude));
+#endif
+    node->fft_history_pos = 0;
+    node->fft_hop_fill = 0;
+    node->status.dsp.analysis_count = 0;
+
+    node->ici_flux[0] = node->ici_flux[1] = 0.0f;
+    node->ici_flux_mean = node->ici_flux_deviation = 0.0f;
+    node->ici_threshold = ICI_THRESHOLD_MIN;
+    node->ici_have_peak = false;
+    node->ici_interval_count = node->ici_interval_next = 0;
+    node->ici_sum = node->ici_sum_sq = 0;
+    node->ici_peak_hop = 0;
+
+    node->analysis_level = HYBRID_LOAD_FULL;
+    node->fft_bins = node->fft_prev_bins = HYBRID_FFT_SIZE / 2;
+    node->fft_hop_count = 0;
+    node->analysis_blocks = 0;
+}
+
+static void dsp_process_fft(HybridNode *node, const float *input, size_t frames) {
+    // Feed the mono channel into the history ring, analyzing at every
+    // completed hop; a block may complete none, one or several
+    const size_t channels = node->config.adc_channels;
+    size_t i = 0;
+    while (i < frames) {
+        size_t n = node->fft_hop - node->fft_hop_fill;
+        if (n > frames - i) {
+            n = frames - i;
+        }
+        for (size_t j = 0; j < n; j++) {
+            node->fft_history[node->fft_history_pos] = input[(i + j) * channels];
+            if (node->coherence_stereo) {
+                node->coherence_history[node->fft_history_pos] = input[(i + j) * channels + 1];
+            }
+            node->fft_history_pos = (node->fft_history_pos + 1) & (HYBRID_FFT_SIZE - 1);
+        }
+        i += n;
+        node->fft_hop_fill += n;
+        if (node->fft_hop_fill == node->fft_hop) {
+            node->fft_hop_fill = 0;
+            if (dsp_hop_due(node)) {
+                dsp_analyze_spectrum(node);
+            }
+        }
+    }
+
+    // Calculate zero-crossing rate
+    uint32_t zero_crossings = 0;
+    for (size_t i = 1; i < frames; i++) {
+        float prev = input[(i-1) * node->config.adc_channels];
+        float curr = input[i * node->config.adc_channels];
+        if ((prev >= 0.0f && curr < 0.0f) || (prev < 0.0f && curr >= 0.0f)) {
+            zero_crossings++;
+        }
+    }
+    node->status.dsp.zero_crossing_rate = (float)zero_crossings / frames;
+}
+
+// Counts a completed hop; true if the load level has it analyzed
+static bool dsp_hop_due(HybridNode *node) {
+    node->fft_hop_count++;
+    if (node->analysis_level >= HYBRID_LOAD_NO_SPECTRAL) {
+        return false;
+    }
+    return node->analysis_level < HYBRID_LOAD_HALF_RATE || (node->fft_hop_count & 1) == 0;
+}
+
+// Takes up the governor's level for the block about to be analyzed, and
+// the bins it leaves to the spectral features: from HYBRID_LOAD_PASSBAND
+// on, whole lane vectors up to lpf_cutoff, at most the lower half
+static void dsp_load_level(HybridNode *node) {
+    const uint8_t level = node->load_level.load(std::memory_order_relaxed);
+    size_t bins = HYBRID_FFT_SIZE / 2;
+    if (level >= HYBRID_LOAD_PASSBAND) {
+        const float bin_hz = node->config.sample_rate / (float)HYBRID_FFT_SIZE;
+        size_t passband = (size_t)ceilf(node->config.lpf_cutoff / bin_hz) + 1;
+        passband = (passband + ANALOG_FILTER_LANES - 1) & ~(size_t)(ANALOG_FILTER_LANES - 1);
+        bins = passband < HYBRID_FFT_SIZE / 4 ? passband : HYBRID_FFT_SIZE / 4;
+    }
+    node->analysis_level = level;
+    node->fft_bins = bins;
+}
+
+// Spectral features of the windowed history, oldest frame first
+static void dsp_analyze_spectrum(HybridNode *node) {
+    const size_t tail = HYBRID_FFT_SIZE - node->fft_history_pos;
+    memcpy(node->fft_input, &node->fft_history[node->fft_history_pos], tail * sizeof(float));
+    memcpy(&node->fft_input[tail], node->fft_history, node->fft_history_pos * sizeof(float));
+    dsp_apply_window(node->fft_input, node->fft_window, node->fft_input, HYBRID_FFT_SIZE);
+    dsp_rfft_forward(node->fft, node->fft_input, node->fft_output);
+    dsp_magnitudes(node->fft_output, node->fft_magnitude, node->fft_bins);
+    dsp_spectral_features(node);
+    if (node->coherence_stereo) {
+        dsp_coherence_update(node);
+    }
+}
+
+// Channel 1's frame through the same window and transform, and both
+// channels' spectra, channel 0's in fft_output, into the averages. Only
+// the fft_bins the analysis covers are updated.
+static void dsp_coherence_update(HybridNode *node) {
+    const size_t tail = HYBRID_FFT_SIZE - node->fft_history_pos;
+    memcpy(node->fft_input, &node->coherence_history[node->fft_history_pos], tail * sizeof(float));
+    memcpy(&node->fft_input[tail], node->coherence_history, node->fft_history_pos * sizeof(float));
+    dsp_apply_window(node->fft_input, node->fft_window, node->fft_input, HYBRID_FFT_SIZE);
+    dsp_rfft_forward(node->fft, node->fft_input, node->coherence_output);
+    dsp_cross_spectra_update(node->fft_output, node->coherence_output, node->fft_bins, node->coherence_alpha,
+                             node->coherence_sxx, node->coherence_syy, node->coherence_sxy);
+}
+
+// The magnitude and feature sweeps run whole lane vectors
+static_assert((HYBRID_FFT_SIZE / 2) % ANALOG_FILTER_LANES == 0,
+              "HYBRID_FFT_SIZE / 2 must be a multiple of the lane count");
+
+// Centroid, flux, rolloff and flatness of the node->fft_bins magnitudes
+// without DC, keeping the spectrum for the next flux
+static void dsp_spectral_features(HybridNode *node) {
+    const size_t bins = node->fft_bins;
+    float *prev = node->fft_prev_magnitude;
+    if (bins > node->fft_prev_bins) {
+        // Bins the previous analysis left out add no flux
+        memcpy(&prev[node->fft_prev_bins], &node->fft_magnitude[node->fft_prev_bins],
+               (bins - node->fft_prev_bins) * sizeof(float));
+    }
+    node->fft_prev_bins = bins;
+    SpectralFeatures features;
+    const bool has_energy = dsp_spectral_features(node->fft_magnitude, prev, bins,
+                                                  node->config.sample_rate / (float)HYBRID_FFT_SIZE, &features);
+    dsp_spectral_update(node, has_energy, &features);
+    dsp_distortion(node, node->fft_magnitude, features.power);
+}
+
+// Power of bins first to last
+template <typename M>
+static float distortion_power(const M *magnitude, size_t first, size_t last) {
+    float power = 0.0f;
+    for (size_t k = first; k <= last; k++) {
+        const float m = (float)magnitude[k];
+        power += m * m;
+    }
+    return power;
+}
+
+// Power of the main lobe around bin c, within bins 1 to bins - 1
+template <typename M>
+static float distortion_lobe_power(const M *magnitude, size_t c, size_t lobe, size_t bins) {
+    return distortion_power(magnitude, c > lobe ? c - lobe : 1, c + lobe < bins ? c + lobe : bins - 1);
+}
+
+// Highest of bins lo to hi
+template <typename M>
+static size_t distortion_peak(const M *magnitude, size_t lo, size_t hi) {
+    size_t peak = lo;
+    for (size_t k = lo + 1; k <= hi; k++) {
+        if (magnitude[k] > magnitude[peak]) {
+            peak = k;
+        }
+    }
+    return peak;
+}
+
+// THD (harmonics 2 to DISTORTION_HARMONICS over the fundamental, %) and
+// SNR (fundamental over what is neither a harmonic nor DC, dB) of the
+// node->fft_bins magnitudes whose power without DC is power. The search
+// stays around the tracked fundamental while it holds DISTORTION_MIN_SHARE
+// of the power and sweeps all bins only to find a new one. The noise floor
+// is the mean power of the bins outside guards around DC, the fundamental
+// and the harmonics, wide enough around the fundamental that its window
+// sidelobes fall below the floor, taken over every bin; it is summed bin by
+// bin in double rather than taken as what the tones leave of power, which
+// float cancellation would swamp at high SNR. That sum is one multiply-add
+// per bin and the rest a few dozen operations. Without a tone, or with its
+// harmonics closer than two lobes, both read 0.
+template <typename M>
+static void dsp_distortion(HybridNode *node, const M *magnitude, float power) {
+    AnalogMetrics *analog = &node->status.analog;
+    const size_t bins = node->fft_bins;
+    const size_t lobe = node->distortion_lobe;
+    const size_t lo = 2 * lobe + 1;             // Fundamentals with room for separate harmonic lobes
+    const size_t hi = bins > lobe + 2 ? bins - lobe - 2 : 0;
+    analog->thd = 0.0f;
+    analog->snr_db = 0.0f;
+    if (power <= 0.0f || hi <= lo) {
+        node->distortion_bin = 0;
+        return;
+    }
+
+    size_t peak = 0;
+    float fundamental = 0.0f;
+    if (node->distortion_bin >= lo && node->distortion_bin <= hi) {
+        const size_t t = node->distortion_bin;
+        peak = distortion_peak(magnitude, t - DISTORTION_TRACK_BINS > lo ? t - DISTORTION_TRACK_BINS : lo,
+                               t + DISTORTION_TRACK_BINS < hi ? t + DISTORTION_TRACK_BINS : hi);
+        fundamental = distortion_lobe_power(magnitude, peak, lobe, bins);
+    }
+    if (fundamental < DISTORTION_MIN_SHARE * power) {
+        peak = distortion_peak(magnitude, lo, hi);
+        fundamental = distortion_lobe_power(magnitude, peak, lobe, bins);
+    }
+    if (fundamental < DISTORTION_MIN_SHARE * power) {
+        node->distortion_bin = 0;
+        return;
+    }
+    node->distortion_bin = peak;
+
+    // Fractional peak from the parabola through it and its neighbours
+    const float a = (float)magnitude[peak - 1], b = (float)magnitude[peak], c = (float)magnitude[peak + 1];
+    const float curvature = a - 2.0f * b + c;
+    const float f0 = (float)peak + (curvature < 0.0f ? 0.5f * (a - c) / curvature : 0.0f);
+
+    // Guards in ascending order, each starting past the last: DC, the
+    // fundamental, then each harmonic below the analyzed bins at the
+    // highest bin within one of its multiple
+    size_t next = 1, floor_bins = 0;
+    double floor_power = 0.0;
+    auto guard = [&](size_t centre, size_t width) {
+        const size_t first = centre > width && centre - width > next ? centre - width : next;
+        const size_t last = centre + width < bins ? centre + width : bins - 1;
+        for (; next < first; next++, floor_bins++) {
+            floor_power += (double)magnitude[next] * (double)magnitude[next];
+        }
+        next = last + 1 > next ? last + 1 : next;
+    };
+    guard(1, lobe + 1);
+    guard(peak, DISTORTION_GUARD_BINS);
+    float harmonics = 0.0f;
+    for (int h = 2; h <= DISTORTION_HARMONICS; h++) {
+        const size_t centre = (size_t)lrintf((float)h * f0);
+        if (centre + 1 + lobe >= bins) {
+            break;
+        }
+        const size_t at = distortion_peak(magnitude, centre - 1, centre + 1);
+        harmonics += distortion_lobe_power(magnitude, at, lobe, bins);
+        guard(at, lobe + 2);
+    }
+    guard(bins, 0);     // The bins past the last guard
+    analog->thd = 100.0f * sqrtf(harmonics / fundamental);
+    if (floor_bins > 0) {
+        const float noise = (float)(floor_power / (double)floor_bins * (double)(bins - 1));
+        analog->snr_db = 10.0f * log10f(fundamental / fmaxf(noise, 1e-12f * fundamental));
+    }
+}
+
+// Features of one analyzed spectrum into the status; a silent spectrum
+// keeps the previous centroid, rolloff and flatness and has no flux
+static void dsp_spectral_update(HybridNode *node, bool has_energy, const SpectralFeatures *features) {
+    if (has_energy) {
+        node->status.dsp.spectral_centroid = features->centroid;
+        node->status.dsp.spectral_rolloff = features->rolloff;
+        node->status.dsp.spectral_flatness = features->flatness;
+    }
+    node->status.dsp.spectral_flux = features->flux;
+    node->status.dsp.analysis_count++;
+    if (node->config.enable_ici) {
+        dsp_ici_detect(node, features->flux);
+    }
+}
+
+static bool dsp_fft_init(HybridNode *node) {
+    if (node->fft == NULL) {
+        node->fft = dsp_rfft_create(HYBRID_FFT_SIZE, dsp_fft_default_backend());
+    }
+    return node->fft != NULL;
+}
+
+// ADC→DSP→DAC of one buffer: filters work in place, analyzes or queues
+// it, and writes output. work is node->adc_buffer or a DMA buffer.
+static void process_buffer(HybridNode *node, float *work, float *output, size_t frames, uint32_t start_ns, uint32_t start_us) {
+    FpModeGuard fp;
+    uint32_t t = stage_begin(node, true);
+
+    // Apply analog filtering (FR-002)
+    if (node->config.enable_analog_filter) {
+        apply_analog_filter(node, work, frames);
+        stage_end(node, HYBRID_STAGE_FILTER, t);
+    }
+
+    // Embedded cellular engine (FR-004)
+    if (node->engine_process != NULL && node->config.mode == HYBRID_MODE_HYBRID) {
+        t = stage_ticks();
+        run_engine(node, work, frames);
+        stage_end(node, HYBRID_STAGE_ENGINE, t);
+    }
+
+    if (node->config.defer_dsp) {
+        // Hand the block to hybrid_node_dsp_poll
+        DspBlock *block = dsp_ring_claim(node);
+        if (block != NULL) {
+            block->frames = (uint32_t)frames;
+            block->start_us = start_us;
+#ifdef HYBRID_NODE_Q31
+            block->q31 = false;
+#endif
+            memcpy(block->samples, work, frames * node->config.adc_channels * sizeof(float));
+            dsp_ring_commit(node);
+        }
+    } else {
+        dsp_analyze_block(node, work, frames, start_us);
+    }
+
+    t = stage_ticks();
+    write_output(node, work, output, frames);
+    stage_end(node, HYBRID_STAGE_OUTPUT, t);
+    if (fp.take_underflow()) {
+        node->status.stats.denormal_buffers++;
+    }
+    process_finish(node, frames, start_ns);
+}
+
+// Runs the first channel of the filtered block through the engine and puts
+// the output, with engine_dry of the input, in its place
+static void run_engine(HybridNode *node, float *work, size_t frames) {
+    const size_t ch = node->config.adc_channels;
+    const float dry = node->config.engine_dry;
+    for (size_t i = 0; i < frames; i++) {
+        node->engine_in[i] = work[i * ch];
+    }
+    node->engine_process(node->engine, node->engine_in, node->engine_out, frames);
+    for (size_t i = 0; i < frames; i++) {
+        work[i * ch] = node->engine_out[i] + dry * node->engine_in[i];
+    }
+}
+
+// Free ring slot for the next deferred block, or NULL, counted as a drop,
+// when the DSP context has fallen HYBRID_DSP_RING_BLOCKS blocks behind
+static DspBlock* dsp_ring_claim(HybridNode *node) {
+    const uint32_t head = node->dsp_head.load(std::memory_order_relaxed);
+    const uint32_t tail = node->dsp_tail.load(std::memory_order_acquire);
+    if (head - tail >= HYBRID_DSP_RING_BLOCKS) {
+        node->status.stats.frames_dropped++;
+        return NULL;
+    }
+    return &node->dsp_ring[head & (HYBRID_DSP_RING_BLOCKS - 1)];
+}
+
+// Publishes the block filled after dsp_ring_claim
+static void dsp_ring_commit(HybridNode *node) {
+    const uint32_t head = node->dsp_head.load(std::memory_order_relaxed);
+    node->dsp_head.store(head + 1, std::memory_order_release);
+}
+
+// Statistics, latency and status snapshot at the end of a buffer
+static void process_finish(HybridNode *node, size_t frames, uint32_t start_ns) {
+    // Update statistics
+    node->status.stats.frames_processed++;
+
+    // Calculate total latency (SC-001)
+    const uint32_t latency_ns = latency_clock_ns() - start_ns;
+    node->status.calibration.total_latency_us = latency_ns / 1000u;
+
+    // Update CPU load estimate; past 100% the next buffer is already due
+    float buffer_duration_us = (frames * 1000000.0f) / node->config.sample_rate;
+    node->status.stats.cpu_load = (latency_ns / 1000.0f / buffer_duration_us) * 100.0f;
+    if (node->status.stats.cpu_load > 100.0f) {
+        node->status.stats.deadline_overruns++;
+    }
+    const uint32_t budget_ns = (uint32_t)(buffer_duration_us * 1000.0f);
+    const bool near_miss = deadline_update(node, latency_ns, budget_ns);
+    if (node->config.enable_load_governor) {
+        load_governor_update(node, near_miss);
+    }
+    latency_record(node, latency_ns);
+    publish_node_status(node);
+
+    const bool deadline_event = node->deadline_callback != NULL && (near_miss || latency_ns > budget_ns);
+    if (node->buffer_observer != NULL || deadline_event) {
+        HybridBufferRecord record;
+        buffer_record(node, latency_ns, budget_ns, near_miss, &record);
+        if (node->buffer_observer != NULL) {
+            node->buffer_observer(node->observer_context, &record);
+        }
+        if (deadline_event) {
+            node->deadline_callback(node->deadline_context, &record);
+        }
+    }
+}
+
+// Deadline health after a buffer; returns true for a near miss
+static bool deadline_update(HybridNode *node, uint32_t latency_ns, uint32_t budget_ns) {
+    HybridDeadlineHealth *health = &node->status.stats.deadline;
+    const float fraction = node->config.deadline_near_miss > 0.0f ? node->config.deadline_near_miss
+                                                                  : DEADLINE_NEAR_MISS;
+    const bool miss = latency_ns > budget_ns;
+    const bool near_miss = !miss && (float)latency_ns > fraction * (float)budget_ns;
+    health->budget_ns = budget_ns;
+    if (latency_ns > health->worst_ns) {
+        health->worst_ns = latency_ns;
+    }
+    health->consecutive_misses = miss ? health->consecutive_misses + 1 : 0;
+    if (health->consecutive_misses > health->max_consecutive_misses) {
+        health->max_consecutive_misses = health->consecutive_misses;
+    }
+    if (miss || near_miss) {
+        int longest = 0;
+        for (int s = 1; s < HYBRID_STAGE_COUNT; s++) {
+            if (node->buffer_stage_ns[s] > node->buffer_stage_ns[longest]) {
+                longest = s;
+            }
+        }
+        if (miss) {
+            health->stage_misses[longest]++;
+        } else {
+            health->near_misses++;
+            health->stage_near_misses[longest]++;
+        }
+    }
+    return near_miss;
+}
+
+// Record of the buffer for the observer and the deadline callback
+static void buffer_record(HybridNode *node, uint32_t latency_ns, uint32_t budget_ns, bool near_miss,
+                          HybridBufferRecord *record) {
+    const NodeStatistics *stats = &node->status.stats;
+    record->buffer = stats->frames_processed;
+    record->latency_ns = latency_ns;
+    record->budget_ns = budget_ns;
+    memcpy(record->stage_ns, node->buffer_stage_ns, sizeof(record->stage_ns));
+    record->frames_dropped = stats->frames_dropped;
+    record->dsp_pending = node->dsp_head.load(std::memory_order_relaxed) - node->dsp_tail.load(std::memory_order_acquire);
+    record->load_level = stats->load_level;
+    record->overrun = latency_ns > budget_ns;
+    record->near_miss = near_miss;
+    record->dropped = stats->frames_dropped > node->observer_dropped;
+    node->observer_dropped = stats->frames_dropped;
+}
+
+// Full analysis and fresh governor counters, before the first buffer
+static void load_governor_reset(HybridNode *node) {
+    NodeStatistics *stats = &node->status.stats;
+    stats->load_level = HYBRID_LOAD_FULL;
+    stats->governed_load = 0.0f;
+    stats->load_level_changes = 0;
+    memset(stats->load_level_buffers, 0, sizeof(stats->load_level_buffers));
+    node->governor_hold = 0;
+    node->governor_dropped = stats->frames_dropped;
+    node->load_level.store(HYBRID_LOAD_FULL, std::memory_order_relaxed);
+}
+
+// Moves the load level by one after a buffer: up while the smoothed load
+// is above governor_high_load, down while it is below governor_low_load,
+// at most once per LOAD_GOVERNOR_HOLD buffers. An overrun or a deferred
+// block dropped for lack of ring space sheds a level at once.
+static void load_governor_update(HybridNode *node, bool near_miss) {
+    NodeStatistics *stats = &node->status.stats;
+    const float high = node->config.governor_high_load > 0.0f ? node->config.governor_high_load : LOAD_GOVERNOR_HIGH;
+    const float low = node->config.governor_low_load > 0.0f ? node->config.governor_low_load : LOAD_GOVERNOR_LOW;
+    const bool shed = node->shed_requested.exchange(false, std::memory_order_relaxed);
+    const bool overrun = stats->cpu_load > 100.0f || stats->frames_dropped > node->governor_dropped || shed ||
+                         (near_miss && node->config.governor_on_near_miss);
+    node->governor_dropped = stats->frames_dropped;
+    stats->governed_load += LOAD_GOVERNOR_ALPHA * (stats->cpu_load - stats->governed_load);
+    if (node->governor_hold > 0) {
+        node->governor_hold--;
+    }
+
+    uint8_t level = stats->load_level;
+    if (level < HYBRID_LOAD_NO_SPECTRAL && (overrun || (node->governor_hold == 0 && stats->governed_load > high))) {
+        level++;
+    } else if (level > HYBRID_LOAD_FULL && !overrun && node->governor_hold == 0 && stats->governed_load < low) {
+        level--;
+    }
+    if (level != stats->load_level) {
+        stats->load_level = level;
+        stats->load_level_changes++;
+        node->governor_hold = LOAD_GOVERNOR_HOLD;
+        node->load_level.store(level, std::memory_order_relaxed);
+        if (node->config.enable_logging) {
+            firmware_log("[HybridNode] Load level %d at %.1f%% CPU\n", level, stats->governed_load);
+        }
+    }
+    stats->load_level_buffers[level]++;
+}
+
+// DAC frames: audio passthrough on channels 0-1, control voltages on 2-3,
+// in runs that end at control period boundaries
+static void write_output(HybridNode *node, const float *audio, float *output, size_t frames) {
+    const size_t in_ch = node->config.adc_channels;
+    const size_t out_ch = node->config.dac_channels;
+    size_t done = 0;
+    while (done < frames) {
+        if (node->cv_countdown == 0) {
+            cv_period_start(node);
+        }
+        size_t n = frames - done < node->cv_countdown ? frames - done : node->cv_countdown;
+        write_frames(node, &audio[done * in_ch], &output[done * out_ch], n);
+        node->cv_countdown -= (uint32_t)n;
+        done += n;
+    }
+}
+
+// Frames within one control period. The stereo-in, four-out layout takes
+// one vector store per frame, the ramp running in the upper half.
+static void write_frames(HybridNode *node, const float *audio, float *output, size_t frames) {
+    const size_t in_ch = node->config.adc_channels;
+    const size_t out_ch = node->config.dac_channels;
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    if (in_ch == 2 && out_ch == 4) {
+        float32x2_t level = vld1_f32(node->cv_level);
+        const float32x2_t target = vld1_f32(node->cv_target);
+        const float32x2_t step = vld1_f32(node->cv_step);
+        const float32x2_t glide = vdup_n_f32(node->cv_glide);
+        for (size_t i = 0; i < frames; i++) {
+            vst1q_f32(&output[i * 4], vcombine_f32(vld1_f32(&audio[i * 2]), level));
+            level = vadd_f32(vmla_f32(level, vsub_f32(target, level), glide), step);
+        }
+        vst1_f32(node->cv_level, level);
+        return;
+    }
+#elif defined(__SSE__) || defined(_M_X64)
+    if (in_ch == 2 && out_ch == 4) {
+        __m128 level = _mm_setr_ps(node->cv_level[0], node->cv_level[1], 0.0f, 0.0f);
+        const __m128 target = _mm_setr_ps(node->cv_target[0], node->cv_target[1], 0.0f, 0.0f);
+        const __m128 step = _mm_setr_ps(node->cv_step[0], node->cv_step[1], 0.0f, 0.0f);
+        const __m128 glide = _mm_set1_ps(node->cv_glide);
+        for (size_t i = 0; i < frames; i++) {
+            __m128 pair = _mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)&audio[i * 2]);
+            _mm_storeu_ps(&output[i * 4], _mm_movelh_ps(pair, level));
+            level = _mm_add_ps(_mm_add_ps(level, _mm_mul_ps(_mm_sub_ps(target, level), glide)), step);
+        }
+        _mm_storel_pi((__m64 *)node->cv_level, level);
+        return;
+    }
+#endif
+
+    float cv1 = node->cv_level[0], cv2 = node->cv_level[1];
+    for (size_t i = 0; i < frames; i++) {
+        // Audio passthrough (channels 0-1)
+        output[i * out_ch + 0] = audio[i * in_ch + 0];
+        if (in_ch > 1) {
+            output[i * out_ch + 1] = audio[i * in_ch + 1];
+        }
+
+        // Control voltages (channels 2-3)
+        if (out_ch > 2) {
+            output[i * out_ch + 2] = cv1;
+            output[i * out_ch + 3] = cv2;
+        }
+        cv1 = cv1 + (node->cv_target[0] - cv1) * node->cv_glide + node->cv_step[0];
+        cv2 = cv2 + (node->cv_target[1] - cv2) * node->cv_glide + node->cv_step[1];
+    }
+    node->cv_level[0] = cv1;
+    node->cv_level[1] = cv2;
+}
+
+// Metrics, safety, spectral analysis and control voltages of one filtered
+// block: inline in hybrid_node_process, or in hybrid_node_dsp_poll with
+// defer_dsp
+static void dsp_analyze_block(HybridNode *node, const float *block, size_t frames, uint32_t start_us) {
+    uint32_t t = stage_begin(node, false);
+    dsp_load_level(node);
+
+    // Calculate analog metrics (FR-002)
+    dsp_analog_metrics(block, frames, node->config.adc_channels, &node->status.analog);
+    const bool analyze = dsp_block_metrics(node);
+    t = stage_end(node, HYBRID_STAGE_METRICS, t);
+
+    // Perform FFT analysis
+    if (analyze) {
+        dsp_process_fft(node, block, frames);
+        t = stage_end(node, HYBRID_STAGE_FFT, t);
+    }
+    dsp_block_finish(node, analyze, frames, start_us, t);
+}
+
+// Overload flag and safety check on the analog metrics of a block; true if
+// the block goes on to DSP processing
+static bool dsp_block_metrics(HybridNode *node) {
+    node->status.analog.is_overloaded = (node->status.analog.peak_level > SAFETY_OVERLOAD_THRESH);
+
+    // Safety check (FR-007)
+    safety_check(node);
+
+    // DSP processing (FR-003)
+    return node->config.enable_dsp && node->status.safety.status == HYBRID_SAFETY_OK;
+}
+
+// Derived metrics, modulation and the analysis snapshot after the spectral
+// stage of a block of frames; ticks is the stage clock at the call
+static void dsp_block_finish(HybridNode *node, bool analyzed, size_t frames, uint32_t start_us, uint32_t ticks) {
+    if (analyzed) {
+        // From HYBRID_LOAD_ALTERNATE on, every other block keeps the last
+        // ICI statistics and coherence
+        const bool shed = node->analysis_level >= HYBRID_LOAD_ALTERNATE && (node->analysis_blocks++ & 1) != 0;
+
+        // Calculate ICI
+        if (node->config.enable_ici && !shed) {
+            dsp_calculate_ici(node, &node->status.dsp.ici);
+        }
+
+        // Calculate coherence
+        if (node->config.enable_coherence && !shed) {
+            dsp_calculate_coherence(node, &node->status.dsp.coherence);
+        }
+
+        // Update timestamp
+        node->status.dsp.timestamp_us = start_us;
+        ticks = stage_end(node, HYBRID_STAGE_ANALYSIS, ticks);
+    }
+
+    // Apply control voltage modulation (FR-004) once a control period has
+    // passed; faster rates than the block rate update once per block
+    if (node->config.enable_modulation) {
+        node->control_elapsed += (uint32_t)frames;
+        if (node->control_elapsed >= node->control_period) {
+            node->control_elapsed %= node->control_period;
+            apply_control_voltage(node);
+            publish_control_voltage(node);
+            stage_end(node, HYBRID_STAGE_CONTROL, ticks);
+        }
+    }
+
+    publish_analysis_status(node);
+}
+
+// Per-channel RMS, peak magnitude, mean and overload count of frames
+// interleaved frames in one pass. When the channel count divides the lane
+// count, each vector takes consecutive samples and lane j always holds
+// channel j % channels; otherwise each vector takes one zero-padded frame.
+static void dsp_analog_metrics(const float *buffer, size_t frames, size_t channels, AnalogMetrics *metrics) {
+    if (channels == 0 || channels > HYBRID_ADC_CHANNELS) {
+        channels = 0;
+    }
+    const size_t count = frames * channels;
+    const FilterLanes threshold = lanes_set(SAFETY_OVERLOAD_THRESH);
+    FilterLanes sum = lanes_set(0.0f), sum_sq = sum, max_abs = sum, overloads = sum;
+    size_t i = 0;
+    if (channels != 0 && ANALOG_FILTER_LANES % channels == 0) {
+        for (; i + ANALOG_FILTER_LANES <= count; i += ANALOG_FILTER_LANES) {
+            FilterLanes x = lanes_load(&buffer[i]);
+            FilterLanes magnitude = lanes_abs(x);
+            sum = lanes_add(sum, x);
+            sum_sq = lanes_add(sum_sq, lanes_mul(x, x));
+            max_abs = lanes_max(max_abs, magnitude);
+            overloads = lanes_add(overloads, lanes_above(magnitude, threshold));
+        }
+    } else if (channels != 0) {
+        float frame[ANALOG_FILTER_LANES] = {0.0f, 0.0f, 0.0f, 0.0f};
+        for (; i < count; i += channels) {
+            memcpy(frame, &buffer[i], channels * sizeof(float));
+            FilterLanes x = lanes_load(frame);
+            FilterLanes magnitude = lanes_abs(x);
+            sum = lanes_add(sum, x);
+            sum_sq = lanes_add(sum_sq, lanes_mul(x, x));
+            max_abs = lanes_max(max_abs, magnitude);
+            overloads = lanes_add(overloads, lanes_above(magnitude, threshold));
+        }
+    }
+
+    // Fold the lanes onto their channels, then the samples left over
+    float lane_sum[ANALOG_FILTER_LANES], lane_sq[ANALOG_FILTER_LANES];
+    float lane_max[ANALOG_FILTER_LANES], lane_over[ANALOG_FILTER_LANES];
+    lanes_store(lane_sum, sum);
+    lanes_store(lane_sq, sum_sq);
+    lanes_store(lane_max, max_abs);
+    lanes_store(lane_over, overloads);
+    float ch_sum[HYBRID_ADC_CHANNELS] = {0.0f}, ch_sq[HYBRID_ADC_CHANNELS] = {0.0f};
+    float ch_max[HYBRID_ADC_CHANNELS] = {0.0f}, ch_over[HYBRID_ADC_CHANNELS] = {0.0f};
+    for (size_t j = 0; channels != 0 && j < ANALOG_FILTER_LANES; j++) {
+        const size_t c = j % channels;
+        ch_sum[c] += lane_sum[j];
+        ch_sq[c] += lane_sq[j];
+        ch_max[c] = fmaxf(ch_max[c], lane_max[j]);
+        ch_over[c] += lane_over[j];
+    }
+    for (; i < count; i++) {
+        const size_t c = i % channels;
+        const float x = buffer[i];
+        ch_sum[c] += x;
+        ch_sq[c] += x * x;
+        ch_max[c] = fmaxf(ch_max[c], fabsf(x));
+        ch_over[c] += fabsf(x) > SAFETY_OVERLOAD_THRESH ? 1.0f : 0.0f;
+    }
+
+    for (size_t c = 0; c < HYBRID_ADC_CHANNELS; c++) {
+        const bool active = c < channels && frames > 0;
+        metrics->channel_rms[c] = active ? sqrtf(ch_sq[c] / frames) : 0.0f;
+        metrics->channel_peak[c] = active ? ch_max[c] : 0.0f;
+        metrics->channel_dc[c] = active ? ch_sum[c] / frames : 0.0f;
+        metrics->channel_overloads[c] = active ? (uint32_t)ch_over[c] : 0;
+    }
+    dsp_metrics_combine(metrics, channels);
+}
+
+// Levels over all channels from the per-channel ones; every channel has
+// the same number of frames
+static void dsp_metrics_combine(AnalogMetrics *metrics, size_t channels) {
+    float mean_sq = 0.0f, peak = 0.0f, dc = 0.0f;
+    for (size_t c = 0; c < channels; c++) {
+        mean_sq += metrics->channel_rms[c] * metrics->channel_rms[c];
+        peak = fmaxf(peak, metrics->channel_peak[c]);
+        dc += metrics->channel_dc[c];
+    }
+    metrics->rms_level = channels > 0 ? sqrtf(mean_sq / channels) : 0.0f;
+    metrics->peak_level = peak;
+    metrics->dc_offset = channels > 0 ? dc / channels : 0.0f;
+}
+
+// Peak test for the flux one analysis back, now that the next value is
+// known; constant work per analysis
+static void dsp_ici_detect(HybridNode *node, float flux) {
+    const float before = node->ici_flux[1], peak = node->ici_flux[0];
+    const uint64_t analysis = node->status.dsp.analysis_count;
+    // Analyses are spacing hops apart, more than one when the load governor
+    // skips hops
+    const uint32_t spacing = node->fft_hop_count - node->ici_peak_hop;
+    if (analysis >= 3 && peak > before && peak >= flux && peak > node->ici_threshold) {
+        // Vertex of the parabola through the three values, within half the
+        // spacing
+        const float curvature = before - 2.0f * peak + flux;
+        const float offset = curvature < 0.0f ? 0.5f * (before - flux) / curvature : 0.0f;
+        const uint64_t time = (uint64_t)node->ici_peak_hop * node->fft_hop * 256 +
+                              (int64_t)lrintf(offset * (float)(spacing * node->fft_hop) * 256.0f);
+        const uint64_t interval = node->ici_have_peak && time > node->ici_last_peak ? time - node->ici_last_peak : 0;
+
+        if (!node->ici_have_peak || interval >= (uint64_t)node->ici_refractory * 256) {
+            if (node->ici_have_peak && interval <= node->ici_max_interval) {
+                if (node->ici_interval_count == ICI_INTERVALS) {
+                    const uint64_t oldest = node->ici_intervals[node->ici_interval_next];
+                    node->ici_sum -= oldest;
+                    node->ici_sum_sq -= oldest * oldest;
+                } else {
+                    node->ici_interval_count++;
+                }
+                node->ici_intervals[node->ici_interval_next] = (uint32_t)interval;
+                node->ici_interval_next = (node->ici_interval_next + 1) % ICI_INTERVALS;
+                node->ici_sum += interval;
+                node->ici_sum_sq += interval * interval;
+            } else if (node->ici_have_peak) {
+                // A gap this long starts over
+                node->ici_interval_count = node->ici_interval_next = 0;
+                node->ici_sum = node->ici_sum_sq = 0;
+            }
+            node->ici_have_peak = true;
+            node->ici_last_peak = time;
+        }
+    }
+
+    // Threshold for the value just in, from the flux before it
+    node->ici_threshold = fmaxf(node->ici_flux_mean + ICI_THRESHOLD_K * node->ici_flux_deviation, ICI_THRESHOLD_MIN);
+    const float alpha = spacing > 1 ? 1.0f - powf(1.0f - node->ici_alpha, (float)spacing) : node->ici_alpha;
+    node->ici_flux_deviation += alpha * (fabsf(flux - node->ici_flux_mean) - node->ici_flux_deviation);
+    node->ici_flux_mean += alpha * (flux - node->ici_flux_mean);
+    node->ici_flux[1] = peak;
+    node->ici_flux[0] = flux;
+    node->ici_peak_hop = node->fft_hop_count;
+}
+
+// Mean and standard deviation of the recent peak intervals from the
+// running sums, ICI_DEFAULT_MS until a first interval
+static void dsp_calculate_ici(HybridNode *node, float *ici_out) {
+    const uint64_t n = node->ici_interval_count;
+    const float ms_per_unit = 1000.0f / (256.0f * (float)node->config.sample_rate);
+    if (n > 0) {
+        const uint64_t spread = n * node->ici_sum_sq - node->ici_sum * node->ici_sum;
+        *ici_out = (float)node->ici_sum / (float)n * ms_per_unit;
+        node->status.dsp.ici_deviation = sqrtf((float)spread) / (float)n * ms_per_unit;
+    } else {
+        *ici_out = ICI_DEFAULT_MS;
+        node->status.dsp.ici_deviation = 0.0f;
+    }
+    node->status.dsp.ici_interval_count = node->ici_interval_count;
+
+    node->status.dsp.ici = *ici_out;
+}
+
+// Power-weighted coherence of the averaged spectra over the analyzed bins
+// without DC; a mono node is coherent with itself
+static void dsp_calculate_coherence(HybridNode *node, float *coherence_out) {
+    *coherence_out = node->coherence_stereo ? dsp_coherence(node->coherence_sxx, node->coherence_syy,
+                                                            node->coherence_sxy, 1, node->fft_bins, NULL)
+                                            : 1.0f;
+
+    node->status.dsp.coherence = *coherence_out;
+}
+
+static void safety_check(HybridNode *node) {
+    // Check for ADC overload (FR-007)
+    if (node->status.analog.is_overloaded) {
+        node->status.safety.overload_count++;
+
+        // Auto-gain reduction
+        if (node->config.preamp_gain > ANALOG_PREAMP_GAIN_MIN) {
+            node->config.preamp_gain *= 0.9f;  // Reduce by 10%
+
+            if (node->config.enable_logging) {
+                firmware_log("[HybridNode] ADC overload detected, reducing gain to %.2f\n",
+                             node->config.preamp_gain);
+            }
+        }
+    }
+
+    // Check thermal status (FR-007)
+#ifdef TEENSY
+    if (node->config.enable_thermal_monitor) {
+        // Read analog temperature sensor (example)
+        int temp_raw = analogRead(node->config.thermal_gpio_pin);
+        node->status.safety.temperature = temp_raw * 0.1f;  // Convert to °C
+
+        if (node->status.safety.temperature > SAFETY_TEMP_CRITICAL) {
+            hybrid_emergency_shutdown(node, "Temperature critical");
+            node->status.safety.status = HYBRID_SAFETY_TEMP_CRITICAL;
+        } else if (node->status.safety.temperature > SAFETY_TEMP_WARNING) {
+            node->status.safety.thermal_warning = true;
+            node->status.safety.status = HYBRID_SAFETY_TEMP_WARNING;
+        }
+    }
+#endif
+
+    // Check voltage clamping
+    if (node->config.enable_voltage_clamp) {
+        if (node->status.control.cv1 >= SAFETY_VOLTAGE_MAX ||
+            node->status.control.cv2 >= SAFETY_VOLTAGE_MAX) {
+            node->status.safety.clamp_count++;
+            node->status.safety.status = HYBRID_SAFETY_VOLTAGE_CLAMP;
+        }
+    }
+}
+
+// Sections for the cutoffs and order in node->config. A high-pass at 0 Hz or a
+// low-pass at or above Nyquist is left out.
+static void filter_design(HybridNode *node) {
+    const FilterDesign design = {node->config.hpf_cutoff, node->config.lpf_cutoff, node->config.sample_rate,
+                                 node->config.filter_order};
+    const unsigned order = design.order;
+
+    // dsp_butterworth leaves out a high-pass at 0 Hz or a low-pass at or
+    // above Nyquist
+    size_t count = dsp_butterworth(true, design.hpf_cutoff, (float)design.sample_rate, order, node->filter_sections);
+    count += dsp_butterworth(false, design.lpf_cutoff, (float)design.sample_rate, order, &node->filter_sections[count]);
+    filter_commit(node, design, count);
+}
+
+// Sections of a boot image checked against node->config
+static void filter_load(HybridNode *node, const HybridBootImage *image) {
+    const FilterDesign design = {node->config.hpf_cutoff, node->config.lpf_cutoff, node->config.sample_rate,
+                                 node->config.filter_order};
+    const size_t count = image->filter_sections;
+    for (size_t s = 0; s < count; s++) {
+        const float *c = image->filter[s];
+        node->filter_sections[s] = {c[0], c[1], c[2], c[3], c[4]};
+    }
+    filter_commit(node, design, count);
+}
+
+// Puts the first count of node->filter_sections, designed for design, in
+// force
+static void filter_commit(HybridNode *node, const FilterDesign &design, size_t count) {
+    const bool resized = count != node->filter_section_count;
+    node->filter_section_count = count;
+
+#ifdef USE_CMSIS_DSP
+    // CMSIS takes {b0, b1, b2, a1, a2} with a1, a2 added to the output
+    for (size_t s = 0; s < count; s++) {
+        float *c = &node->filter_coeffs[5 * s];
+        c[0] = node->filter_sections[s].b0;
+        c[1] = node->filter_sections[s].b1;
+        c[2] = node->filter_sections[s].b2;
+        c[3] = -node->filter_sections[s].a1;
+        c[4] = -node->filter_sections[s].a2;
+    }
+    if (resized || !node->filter_designed) {
+        for (int ch = 0; ch < HYBRID_ADC_CHANNELS; ch++) {
+            arm_biquad_cascade_df1_init_f32(&node->filter[ch], (uint8_t)count, node->filter_coeffs, node->filter_state[ch]);
+        }
+    }
+#else
+    if (resized) {
+        filter_reset(node);
+    }
+#endif
+#ifdef HYBRID_NODE_Q31
+    // |b1| and |a1| reach 2, hence Q30
+    for (size_t s = 0; s < count; s++) {
+        const BiquadSection &section = node->filter_sections[s];
+        int32_t *c = node->q31_filter_coeffs[s];
+        c[0] = q30_coeff(section.b0);
+        c[1] = q30_coeff(section.b1);
+        c[2] = q30_coeff(section.b2);
+        c[3] = q30_coeff(section.a1);
+        c[4] = q30_coeff(section.a2);
+    }
+    if (resized) {
+        memset(node->q31_filter_state, 0, sizeof(node->q31_filter_state));
+    }
+#endif
+    node->filter_design = design;
+    node->filter_designed = true;
+}
+
+static void filter_reset(HybridNode *node) {
+#ifdef USE_CMSIS_DSP
+    memset(node->filter_state, 0, sizeof(node->filter_state));
+#else
+    memset(node->filter_z1, 0, sizeof(node->filter_z1));
+    memset(node->filter_z2, 0, sizeof(node->filter_z2));
+#endif
+#ifdef HYBRID_NODE_Q31
+    memset(node->q31_filter_state, 0, sizeof(node->q31_filter_state));
+#endif
+}
+
+// Order hybrid_init runs the filters at: even, 2 to ANALOG_FILTER_MAX_ORDER
+static uint8_t filter_order_rounded(uint8_t order) {
+    if (order == 0) {
+        order = 2;
+    } else if (order > ANALOG_FILTER_MAX_ORDER) {
+        order = ANALOG_FILTER_MAX_ORDER;
+    }
+    return (uint8_t)(order + (order & 1));
+}
+
+// Redesigns the bank when the configuration has moved its cutoffs
+static void filter_update(HybridNode *node) {
+    if (!node->filter_designed || node->filter_design.hpf_cutoff != node->config.hpf_cutoff ||
+        node->filter_design.lpf_cutoff != node->config.lpf_cutoff || node->filter_design.sample_rate != node->config.sample_rate ||
+        node->filter_design.order != node->config.filter_order) {
+        filter_design(node);
+    }
+}
+
+static void apply_analog_filter(HybridNode *node, float *buffer, size_t frames) {
+    filter_update(node);
+    const size_t sections = node->filter_section_count;
+    const size_t channels = node->config.adc_channels;
+    if (sections == 0 || channels == 0 || channels > HYBRID_ADC_CHANNELS) {
+        return;
+    }
+
+#ifdef USE_CMSIS_DSP
+    // Biquad cascade per channel, through the scratch buffer in chunks
+    for (size_t ch = 0; ch < channels; ch++) {
+        for (size_t start = 0; start < frames; start += HYBRID_BUFFER_SIZE) {
+            size_t n = frames - start < HYBRID_BUFFER_SIZE ? frames - start : HYBRID_BUFFER_SIZE;
+            for (size_t i = 0; i < n; i++) {
+                node->filter_scratch[i] = buffer[(start + i) * channels + ch];
+            }
+            arm_biquad_cascade_df1_f32(&node->filter[ch], node->filter_scratch, node->filter_scratch, (uint32_t)n);
+            for (size_t i = 0; i < n; i++) {
+                buffer[(start + i) * channels + ch] = node->filter_scratch[i];
+            }
+        }
+    }
+#else
+    // All channels of a frame side by side in one lane vector, the cascade
+    // state held in registers for the whole buffer
+    FilterLanes b0[ANALOG_FILTER_MAX_SECTIONS], b1[ANALOG_FILTER_MAX_SECTIONS], b2[ANALOG_FILTER_MAX_SECTIONS];
+    FilterLanes a1[ANALOG_FILTER_MAX_SECTIONS], a2[ANALOG_FILTER_MAX_SECTIONS];
+    FilterLanes z1[ANALOG_FILTER_MAX_SECTIONS], z2[ANALOG_FILTER_MAX_SECTIONS];
+    for (size_t s = 0; s < sections; s++) {
+        b0[s] = lanes_set(node->filter_sections[s].b0);
+        b1[s] = lanes_set(node->filter_sections[s].b1);
+        b2[s] = lanes_set(node->filter_sections[s].b2);
+        a1[s] = lanes_set(node->filter_sections[s].a1);
+        a2[s] = lanes_set(node->filter_sections[s].a2);
+        z1[s] = lanes_load(node->filter_z1[s]);
+        z2[s] = lanes_load(node->filter_z2[s]);
+    }
+
+    float frame[ANALOG_FILTER_LANES] = {0.0f, 0.0f, 0.0f, 0.0f};
+    for (size_t i = 0; i < frames; i++) {
+        float *samples = &buffer[i * channels];
+        memcpy(frame, samples, channels * sizeof(float));
+        FilterLanes x = lanes_load(frame);
+        for (size_t s = 0; s < sections; s++) {
+            // y = b0 x + z1;  z1 = b1 x - a1 y + z2;  z2 = b2 x - a2 y
+            FilterLanes y = lanes_add(lanes_mul(b0[s], x), z1[s]);
+            z1[s] = lanes_add(lanes_sub(lanes_mul(b1[s], x), lanes_mul(a1[s], y)), z2[s]);
+            z2[s] = lanes_sub(lanes_mul(b2[s], x), lanes_mul(a2[s], y));
+            x = y;
+        }
+        lanes_store(frame, x);
+        memcpy(samples, frame, channels * sizeof(float));
+    }
+
+    for (size_t s = 0; s < sections; s++) {
+        lanes_store(node->filter_z1[s], z1[s]);
+        lanes_store(node->filter_z2[s], z2[s]);
+    }
+#endif
+}
+
+#ifdef HYBRID_NODE_Q31
+// Fixed-point path (HYBRID_NODE_Q31). Samples stay left-justified Q31 from
+// the input copy to the output stage; metrics reach the status as floats
+// once per block.
+
+static inline int32_t q31_saturate(int64_t x) {
+    return x > INT32_MAX ? INT32_MAX : x < INT32_MIN ? (int32_t)INT32_MIN : (int32_t)x;
+}
+
+// Product of two Q31 values; b must not be INT32_MIN
+static inline int32_t q31_mul(int32_t a, int32_t b) {
+    return (int32_t)(((int64_t)a * b) >> 31);
+}
+
+static uint32_t q31_isqrt(uint64_t x) {
+    uint64_t root = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > x) {
+        bit >>= 2;
+    }
+    while (bit != 0) {
+        if (x >= root + bit) {
+            x -= root + bit;
+            root = (root >> 1) + bit;
+        } else {
+            root >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)root;
+}
+
+// Shift between right-aligned sample_bits words and Q31
+static unsigned q31_input_shift(const HybridNode *node) {
+    const unsigned bits = node->config.sample_bits;
+    return bits == 0 || bits >= 32 ? 0 : 32 - bits;
+}
+
+static int32_t q30_coeff(float c) {
+    return q31_saturate(llrint(c * 1073741824.0));
+}
+
+static bool q31_build_tables(const int32_t *twiddle) {
+    if (twiddle != NULL) {
+        // A boot image's, checked by its CRC
+        memcpy(g_q31_twiddle, twiddle, sizeof(g_q31_twiddle));
+    } else {
+        for (size_t k = 0; k < Q31_FFT_HALF; k++) {
+            double angle = -2.0 * M_PI * (double)k / HYBRID_FFT_SIZE;
+            g_q31_twiddle[2 * k] = (int32_t)lrint(cos(angle) * INT32_MAX);
+            g_q31_twiddle[2 * k + 1] = (int32_t)lrint(sin(angle) * INT32_MAX);
+        }
+    }
+    unsigned bits = 0;
+    while ((1u << bits) < Q31_FFT_HALF) {
+        bits++;
+    }
+    for (size_t i = 0; i < Q31_FFT_HALF; i++) {
+        unsigned r = 0;
+        for (unsigned b = 0; b < bits; b++) {
+            r |= ((i >> b) & 1u) << (bits - 1 - b);
+        }
+        g_q31_bitrev[i] = (uint16_t)r;
+    }
+    return true;
+}
+
+static bool q31_fft_init(const int32_t *twiddle) {
+    // Once for all nodes, from the first caller's image if it has one: the
+    // tables come out the same. Static initialization is thread-safe.
+    static const bool ready = q31_build_tables(twiddle);
+    return ready;
+}
+
+// Direct form I cascade per channel on the Q30 coefficients. Products are
+// taken down to Q59 before they are summed, so the 64-bit accumulator has
+// headroom for the worst-case sum of all five terms.
+static void apply_analog_filter_q31(HybridNode *node, int32_t *buffer, size_t frames) {
+    filter_update(node);
+    const size_t sections = node->filter_section_count;
+    const size_t channels = node->config.adc_channels;
+    if (sections == 0 || channels == 0 || channels > HYBRID_ADC_CHANNELS) {
+        return;
+    }
+
+    for (size_t ch = 0; ch < channels; ch++) {
+        int32_t x1[ANALOG_FILTER_MAX_SECTIONS], x2[ANALOG_FILTER_MAX_SECTIONS];
+        int32_t y1[ANALOG_FILTER_MAX_SECTIONS], y2[ANALOG_FILTER_MAX_SECTIONS];
+        for (size_t s = 0; s < sections; s++) {
+            const int32_t *state = node->q31_filter_state[s][ch];
+            x1[s] = state[0];
+            x2[s] = state[1];
+            y1[s] = state[2];
+            y2[s] = state[3];
+        }
+
+        for (size_t i = 0; i < frames; i++) {
+            int32_t x = buffer[i * channels + ch];
+            for (size_t s = 0; s < sections; s++) {
+                const int32_t *c = node->q31_filter_coeffs[s];
+                // y = b0 x + b1 x1 + b2 x2 - a1 y1 - a2 y2
+                int64_t acc = (((int64_t)c[0] * x) >> 2) + (((int64_t)c[1] * x1[s]) >> 2) +
+                              (((int64_t)c[2] * x2[s]) >> 2) - (((int64_t)c[3] * y1[s]) >> 2) -
+                              (((int64_t)c[4] * y2[s]) >> 2);
+                int32_t y = q31_saturate((acc + (1ll << 27)) >> 28);
+                x2[s] = x1[s];
+                x1[s] = x;
+                y2[s] = y1[s];
+                y1[s] = y;
+                x = y;
+            }
+            buffer[i * channels + ch] = x;
+        }
+
+        for (size_t s = 0; s < sections; s++) {
+            int32_t *state = node->q31_filter_state[s][ch];
+            state[0] = x1[s];
+            state[1] = x2[s];
+            state[2] = y1[s];
+            state[3] = y2[s];
+        }
+    }
+}
+
+// dsp_analog_metrics on Q31 samples, results as fractions of full scale
+static void dsp_analog_metrics_q31(const int32_t *buffer, size_t frames, size_t channels, AnalogMetrics *metrics) {
+    if (channels > HYBRID_ADC_CHANNELS) {
+        channels = 0;
+    }
+    const uint32_t threshold = (uint32_t)(SAFETY_OVERLOAD_THRESH * 2147483648.0f);
+    uint64_t sum_sq[HYBRID_ADC_CHANNELS] = {0};     // Q31 squares
+    uint32_t max_abs[HYBRID_ADC_CHANNELS] = {0};    // |INT32_MIN| fits
+    int64_t sum[HYBRID_ADC_CHANNELS] = {0};
+    uint32_t overloads[HYBRID_ADC_CHANNELS] = {0};
+    for (size_t i = 0; i < frames; i++) {
+        for (size_t c = 0; c < channels; c++) {
+            const int32_t sample = buffer[i * channels + c];
+            sum_sq[c] += (uint64_t)(((int64_t)sample * sample) >> 31);
+            const uint32_t magnitude = sample < 0 ? 0u - (uint32_t)sample : (uint32_t)sample;
+            if (magnitude > max_abs[c]) {
+                max_abs[c] = magnitude;
+            }
+            overloads[c] += magnitude > threshold;
+            sum[c] += sample;
+        }
+    }
+
+    for (size_t c = 0; c < HYBRID_ADC_CHANNELS; c++) {
+        const bool active = c < channels && frames > 0;
+        metrics->channel_rms[c] = active ? (float)q31_isqrt((sum_sq[c] / frames) << 31) / 2147483648.0f : 0.0f;
+        metrics->channel_peak[c] = (float)max_abs[c] / 2147483648.0f;
+        metrics->channel_dc[c] = active ? (float)(sum[c] / (int64_t)frames) / 2147483648.0f : 0.0f;
+        metrics->channel_overloads[c] = overloads[c];
+    }
+    dsp_metrics_combine(metrics, channels);
+}
+
+// Spectral features of the windowed Q31 history. The transform is the
+// built-in one scaled by 1/N, which leaves the centroid unchanged.
+static void dsp_analyze_spectrum_q31(HybridNode *node) {
+    int32_t *z = node->q31_fft_work;
+    uint32_t *magnitude = node->q31_fft_magnitude;
+    const size_t pos = node->fft_history_pos;
+
+    // Windowed, halved, oldest frame first and packed as
+    // z[n] = x[2n] + i x[2n+1] in bit-reversed order
+    for (size_t n = 0; n < Q31_FFT_HALF; n++) {
+        const size_t r = g_q31_bitrev[n];
+        const size_t even = (pos + 2 * n) & (HYBRID_FFT_SIZE - 1);
+        const size_t odd = (pos + 2 * n + 1) & (HYBRID_FFT_SIZE - 1);
+        z[2 * r] = q31_mul(node->q31_fft_history[even], node->q31_fft_window[2 * n]) >> 1;
+        z[2 * r + 1] = q31_mul(node->q31_fft_history[odd], node->q31_fft_window[2 * n + 1]) >> 1;
+    }
+
+    // Butterflies halve their outputs, so magnitudes never grow
+    for (size_t len = 2; len <= Q31_FFT_HALF; len <<= 1) {
+        const size_t half = len >> 1;
+        const size_t step = 2 * (Q31_FFT_HALF / len);
+        for (size_t base = 0; base < Q31_FFT_HALF; base += len) {
+            for (size_t j = 0; j < half; j++) {
+                const int64_t wr = g_q31_twiddle[2 * j * step];
+                const int64_t wi = g_q31_twiddle[2 * j * step + 1];
+                int32_t *a = &z[2 * (base + j)];
+                int32_t *b = &z[2 * (base + j + half)];
+                const int64_t tr = (b[0] * wr - b[1] * wi) >> 31;
+                const int64_t ti = (b[0] * wi + b[1] * wr) >> 31;
+                const int64_t ar = a[0], ai = a[1];
+                a[0] = (int32_t)((ar + tr) >> 1);
+                a[1] = (int32_t)((ai + ti) >> 1);
+                b[0] = (int32_t)((ar - tr) >> 1);
+                b[1] = (int32_t)((ai - ti) >> 1);
+            }
+        }
+    }
+
+    // Split as in the DSP core's built-in FFT, halved once more
+    const int64_t dc = ((int64_t)z[0] + z[1]) >> 1;
+    magnitude[0] = (uint32_t)(dc < 0 ? -dc : dc);
+    // Coherence takes the bins as floats; it does not see their scale
+    const bool coherence = node->coherence_stereo;
+    if (coherence) {
+        node->fft_output[0] = (float)dc;
+        node->fft_output[1] = 0.0f;
+    }
+    for (size_t k = 1; k < node->fft_bins; k++) {
+        const int64_t zr = z[2 * k], zi = z[2 * k + 1];
+        const int64_t cr = z[2 * (Q31_FFT_HALF - k)], ci = -(int64_t)z[2 * (Q31_FFT_HALF - k) + 1];
+        const int64_t er = (zr + cr) >> 1, ei = (zi + ci) >> 1;
+        const int64_t or_ = (zi - ci) >> 1, oi = (cr - zr) >> 1;
+        const int64_t wr = g_q31_twiddle[2 * k], wi = g_q31_twiddle[2 * k + 1];
+        const int64_t xr = (er + ((or_ * wr - oi * wi) >> 31)) >> 1;
+        const int64_t xi = (ei + ((or_ * wi + oi * wr) >> 31)) >> 1;
+        magnitude[k] = q31_isqrt((uint64_t)(xr * xr) + (uint64_t)(xi * xi));
+        if (coherence) {
+            node->fft_output[2 * k] = (float)xr;
+            node->fft_output[2 * k + 1] = (float)xi;
+        }
+    }
+
+    dsp_spectral_features_q31(node);
+    if (coherence) {
+        dsp_coherence_update(node);
+    }
+}
+
+// log2 of x in Q16, 0 for x = 0: bit position plus the correction of
+// fast_log2f on the Q16 mantissa fraction
+static int32_t q31_log2(uint64_t x) {
+    if (x == 0) {
+        return 0;
+    }
+#if defined(__GNUC__) || defined(__clang__)
+    const unsigned top = 63u - (unsigned)__builtin_clzll(x);
+#else
+    unsigned top = 0;
+    for (uint64_t v = x; v >>= 1;) top++;
+#endif
+    const int64_t m = top >= 16 ? (int64_t)(x >> (top - 16)) : (int64_t)(x << (16 - top));  // [1, 2) in Q16
+    const int64_t f = m - 65536;
+    const int64_t fraction = f + ((22714 * ((f * (65536 - f)) >> 16)) >> 16);
+    return (int32_t)(((int64_t)top << 16) + fraction);
+}
+
+// dsp_spectral_features on the Q31 magnitudes, in integer sums; empty bins
+// count as one LSB in the flatness
+static void dsp_spectral_features_q31(HybridNode *node) {
+    const size_t bins = node->fft_bins;
+    const uint32_t *magnitude = node->q31_fft_magnitude;
+    uint32_t *prev = node->q31_fft_prev_magnitude;
+    if (bins > node->fft_prev_bins) {
+        memcpy(&prev[node->fft_prev_bins], &magnitude[node->fft_prev_bins], (bins - node->fft_prev_bins) * sizeof(uint32_t));
+    }
+    node->fft_prev_bins = bins;
+    uint64_t magnitude_sum = 0, weighted_sum = 0, rise_sum = 0;
+    uint64_t power_sum = 0;     // Squares >> 16, so 511 of them fit
+    int64_t log_sum = 0;        // Q16 log2 of each power
+    for (size_t k = 1; k < bins; k++) {
+        const uint32_t m = magnitude[k];
+        magnitude_sum += m;
+        weighted_sum += (uint64_t)k * m;
+        rise_sum += m > prev[k] ? m - prev[k] : 0;
+        power_sum += ((uint64_t)m * m) >> 16;
+        log_sum += 2 * (int64_t)q31_log2(m);
+        prev[k] = m;
+    }
+    prev[0] = magnitude[0];
+
+    SpectralFeatures features = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    const bool has_energy = magnitude_sum > 0;
+    const uint64_t count = bins - 1;
+    if (has_energy) {
+        // Centroid bin in Q8, then Hz; flux in Q16
+        const uint64_t bin_q8 = (weighted_sum << 8) / magnitude_sum;
+        features.centroid = (float)((bin_q8 * node->config.sample_rate / HYBRID_FFT_SIZE) >> 8);
+        features.flux = (float)((rise_sum << 16) / magnitude_sum) / 65536.0f;
+
+        const uint64_t threshold = (uint64_t)((double)magnitude_sum * SPECTRAL_ROLLOFF_FRACTION);
+        uint64_t cumulative = 0;
+        size_t rolloff = 1;
+        for (; rolloff < bins - 1; rolloff++) {
+            cumulative += magnitude[rolloff];
+            if (cumulative >= threshold) {
+                break;
+            }
+        }
+        features.rolloff = (float)(rolloff * node->config.sample_rate / HYBRID_FFT_SIZE);
+    }
+    if (power_sum > 0) {
+        // log2 of geometric over arithmetic mean, Q16
+        const int64_t mean_log = log_sum / (int64_t)count;
+        const int64_t log_mean = (int64_t)q31_log2(power_sum) + (16 << 16) - q31_log2(count);
+        const int64_t flatness = mean_log - log_mean;
+        features.flatness = flatness >= 0 ? 1.0f : exp2f(flatness / 65536.0f);
+    }
+    features.power = (float)power_sum * 65536.0f;
+    dsp_spectral_update(node, has_energy, &features);
+    dsp_distortion(node, magnitude, features.power);
+}
+
+// dsp_process_fft on Q31 samples
+static void dsp_process_fft_q31(HybridNode *node, const int32_t *input, size_t frames) {
+    const size_t channels = node->config.adc_channels;
+    size_t i = 0;
+    while (i < frames) {
+        size_t n = node->fft_hop - node->fft_hop_fill;
+        if (n > frames - i) {
+            n = frames - i;
+        }
+        for (size_t j = 0; j < n; j++) {
+            node->q31_fft_history[node->fft_history_pos] = input[(i + j) * channels];
+            if (node->coherence_stereo) {
+                node->coherence_history[node->fft_history_pos] = (float)input[(i + j) * channels + 1] / 2147483648.0f;
+            }
+            node->fft_history_pos = (node->fft_history_pos + 1) & (HYBRID_FFT_SIZE - 1);
+        }
+        i += n;
+        node->fft_hop_fill += n;
+        if (node->fft_hop_fill == node->fft_hop) {
+            node->fft_hop_fill = 0;
+            if (dsp_hop_due(node)) {
+                dsp_analyze_spectrum_q31(node);
+            }
+        }
+    }
 
-    // Calculate zero-crossing rate
     uint32_t zero_crossings = 0;
     for (size_t i = 1; i < frames; i++) {
-        float prev = input[(i-1) * g_config.adc_channels];
-        float curr = input[i * g_config.adc_channels];
-        if ((prev >= 0.0f && curr < 0.0f) || (prev < 0.0f && curr >= 0.0f)) {
+        if ((input[(i - 1) * channels] < 0) != (input[i * channels] < 0)) {
             zero_crossings++;
         }
     }
-    g_status.dsp.zero_crossing_rate = (float)zero_crossings / frames;
+    node->status.dsp.zero_crossing_rate = (float)zero_crossings / frames;
+}
+
+// dsp_analyze_block on Q31 samples
+static void dsp_analyze_block_q31(HybridNode *node, const int32_t *block, size_t frames, uint32_t start_us) {
+    uint32_t t = stage_begin(node, false);
+    dsp_load_level(node);
+    dsp_analog_metrics_q31(block, frames, node->config.adc_channels, &node->status.analog);
+    const bool analyze = dsp_block_metrics(node);
+    t = stage_end(node, HYBRID_STAGE_METRICS, t);
+    if (analyze) {
+        dsp_process_fft_q31(node, block, frames);
+        t = stage_end(node, HYBRID_STAGE_FFT, t);
+    }
+    dsp_block_finish(node, analyze, frames, start_us, t);
+}
+
+// DAC code of a control voltage in Q31, full scale at voltage_max
+static int32_t q31_cv_code(const HybridNode *node, float volts) {
+    const float full_scale = node->config.voltage_max > 0.0f ? node->config.voltage_max : SAFETY_VOLTAGE_MAX;
+    const float x = volts / full_scale;
+    if (x >= 1.0f) {
+        return INT32_MAX;
+    }
+    if (x <= -1.0f) {
+        return INT32_MIN;
+    }
+    return (int32_t)(x * 2147483648.0f);
+}
+
+// write_output for Q31 audio: everything leaves right-aligned at
+// sample_bits, the control voltages as DAC codes
+static void write_output_q31(HybridNode *node, const int32_t *audio, int32_t *output, size_t frames) {
+    const size_t in_ch = node->config.adc_channels;
+    const size_t out_ch = node->config.dac_channels;
+    size_t done = 0;
+    while (done < frames) {
+        if (node->cv_countdown == 0) {
+            cv_period_start(node);
+        }
+        size_t n = frames - done < node->cv_countdown ? frames - done : node->cv_countdown;
+        write_frames_q31(node, &audio[done * in_ch], &output[done * out_ch], n);
+        node->cv_countdown -= (uint32_t)n;
+        done += n;
+    }
+}
+
+// Next Q31 ramp value; the distance to the target may exceed 32 bits
+static inline int32_t q31_cv_next(int32_t level, int32_t target, int32_t glide, int32_t step) {
+    return q31_saturate(level + ((((int64_t)target - level) * glide) >> 31) + step);
+}
+
+// write_frames for Q31 audio
+static void write_frames_q31(HybridNode *node, const int32_t *audio, int32_t *output, size_t frames) {
+    const size_t in_ch = node->config.adc_channels;
+    const size_t out_ch = node->config.dac_channels;
+    const unsigned shift = q31_input_shift(node);
+    const int32_t glide = node->q31_cv_glide;
+    int32_t cv1 = node->q31_cv_level[0], cv2 = node->q31_cv_level[1];
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    if (in_ch == 2 && out_ch == 4) {
+        const int32x2_t right = vdup_n_s32(-(int32_t)shift);
+        for (size_t i = 0; i < frames; i++) {
+            const int32_t cv_pair[2] = {cv1 >> shift, cv2 >> shift};
+            vst1q_s32(&output[i * 4], vcombine_s32(vshl_s32(vld1_s32(&audio[i * 2]), right), vld1_s32(cv_pair)));
+            cv1 = q31_cv_next(cv1, node->q31_cv_target[0], glide, node->q31_cv_step[0]);
+            cv2 = q31_cv_next(cv2, node->q31_cv_target[1], glide, node->q31_cv_step[1]);
+        }
+        node->q31_cv_level[0] = cv1;
+        node->q31_cv_level[1] = cv2;
+        return;
+    }
+#elif defined(HYBRID_Q31_SSE2)
+    if (in_ch == 2 && out_ch == 4) {
+        const __m128i right = _mm_cvtsi32_si128((int)shift);
+        for (size_t i = 0; i < frames; i++) {
+            const __m128i cv = _mm_setr_epi32(cv1 >> shift, cv2 >> shift, 0, 0);
+            __m128i pair = _mm_sra_epi32(_mm_loadl_epi64((const __m128i *)&audio[i * 2]), right);
+            _mm_storeu_si128((__m128i *)&output[i * 4], _mm_unpacklo_epi64(pair, cv));
+            cv1 = q31_cv_next(cv1, node->q31_cv_target[0], glide, node->q31_cv_step[0]);
+            cv2 = q31_cv_next(cv2, node->q31_cv_target[1], glide, node->q31_cv_step[1]);
+        }
+        node->q31_cv_level[0] = cv1;
+        node->q31_cv_level[1] = cv2;
+        return;
+    }
+#endif
+
+    for (size_t i = 0; i < frames; i++) {
+        output[i * out_ch + 0] = audio[i * in_ch + 0] >> shift;
+        if (in_ch > 1) {
+            output[i * out_ch + 1] = audio[i * in_ch + 1] >> shift;
+        }
+        if (out_ch > 2) {
+            output[i * out_ch + 2] = cv1 >> shift;
+            output[i * out_ch + 3] = cv2 >> shift;
+        }
+        cv1 = q31_cv_next(cv1, node->q31_cv_target[0], glide, node->q31_cv_step[0]);
+        cv2 = q31_cv_next(cv2, node->q31_cv_target[1], glide, node->q31_cv_step[1]);
+    }
+    node->q31_cv_level[0] = cv1;
+    node->q31_cv_level[1] = cv2;
+}
+
+// process_buffer on Q31 samples
+static void process_buffer_q31(HybridNode *node, int32_t *work, int32_t *output, size_t frames, uint32_t start_ns, uint32_t start_us) {
+    FpModeGuard fp;
+    uint32_t t = stage_begin(node, true);
+    if (node->config.enable_analog_filter) {
+        apply_analog_filter_q31(node, work, frames);
+        stage_end(node, HYBRID_STAGE_FILTER, t);
+    }
+
+    if (node->config.defer_dsp) {
+        DspBlock *block = dsp_ring_claim(node);
+        if (block != NULL) {
+            block->frames = (uint32_t)frames;
+            block->start_us = start_us;
+            block->q31 = true;
+            memcpy(block->samples_q31, work, frames * node->config.adc_channels * sizeof(int32_t));
+            dsp_ring_commit(node);
+        }
+    } else {
+        dsp_analyze_block_q31(node, work, frames, start_us);
+    }
+
+    t = stage_ticks();
+    write_output_q31(node, work, output, frames);
+    stage_end(node, HYBRID_STAGE_OUTPUT, t);
+    if (fp.take_underflow()) {
+        node->status.stats.denormal_buffers++;
+    }
+    process_finish(node, frames, start_ns);
+}
+#endif
+
+static void publish_control_voltage(HybridNode *node) {
+    node->cv_out[0].store(node->status.control.cv1, std::memory_order_relaxed);
+    node->cv_out[1].store(node->status.control.cv2, std::memory_order_relaxed);
+}
+
+template <typename T>
+static void status_write(StatusSlot<T> *slot, const T &value) {
+    const uint32_t seq = slot->sequence.load(std::memory_order_relaxed);
+    slot->sequence.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    memcpy(&slot->data, &value, sizeof(T));
+    slot->sequence.store(seq + 2, std::memory_order_release);
+}
+
+template <typename T>
+static void status_read(const StatusSlot<T> *slot, T *out) {
+    for (;;) {
+        const uint32_t seq = slot->sequence.load(std::memory_order_acquire);
+        if (seq & 1u) {
+            continue;
+        }
+        memcpy(out, &slot->data, sizeof(T));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot->sequence.load(std::memory_order_relaxed) == seq) {
+            return;
+        }
+    }
+}
+
+static void publish_node_status(HybridNode *node) {
+    NodeSnapshot state;
+    state.mode = node->status.mode;
+    state.is_running = node->status.is_running;
+    state.is_calibrated = node->status.is_calibrated;
+    state.calibration = node->status.calibration;
+    state.stats = node->status.stats;
+    stage_copy(node, state.stats.stage, true);
+    state.realtime = node->status.realtime;
+    status_write(&node->node_slot, state);
+}
+
+static void publish_analysis_status(HybridNode *node) {
+    AnalysisSnapshot analysis;
+    analysis.analog = node->status.analog;
+    analysis.dsp = node->status.dsp;
+    analysis.control = node->status.control;
+    analysis.phi_link = node->status.phi_link;
+    analysis.safety = node->status.safety;
+    stage_copy(node, analysis.stage, false);
+    status_write(&node->analysis_slot, analysis);
+}
+
+static void publish_status(HybridNode *node) {
+    publish_node_status(node);
+    publish_analysis_status(node);
+}
+
+// Control period and ramp shape from the configuration, the ramp parked on
+// the published control voltages; while the node is stopped
+static void control_loop_reset(HybridNode *node) {
+    const float rate = node->config.control_loop_rate;
+    float period = rate > 0.0f ? node->config.sample_rate / rate : (float)node->config.buffer_size;
+    if (!(period >= 1.0f)) {
+        period = node->config.buffer_size > 0 ? node->config.buffer_size : HYBRID_BUFFER_SIZE;
+    } else if (period > 2147483648.0f) {
+        period = 2147483648.0f;
+    }
+    node->control_period = (uint32_t)lrintf(period);
+
+    // e^-4 of the distance is left after one period
+    const bool glide = node->config.cv_interpolation == HYBRID_CV_EXPONENTIAL;
+    node->cv_glide = glide ? (float)(1.0 - exp(-4.0 / node->control_period)) : 0.0f;
+    node->control_elapsed = node->control_period;   // First analyzed block updates
+    node->cv_countdown = 0;
+    for (int c = 0; c < 2; c++) {
+        node->cv_level[c] = node->cv_target[c] = node->cv_out[c].load(std::memory_order_relaxed);
+        node->cv_step[c] = 0.0f;
+    }
+#ifdef HYBRID_NODE_Q31
+    node->q31_cv_glide = (int32_t)lrint(node->cv_glide * 2147483648.0);
+    for (int c = 0; c < 2; c++) {
+        node->q31_cv_level[c] = node->q31_cv_target[c] = q31_cv_code(node, node->cv_level[c]);
+        node->q31_cv_step[c] = 0;
+    }
+#endif
+}
+
+// Output stage: next control period, ramping from where the last one ended
+// to the latest published control voltages
+static void cv_period_start(HybridNode *node) {
+    const uint32_t period = node->control_period;
+    const bool linear = node->config.cv_interpolation != HYBRID_CV_EXPONENTIAL;
+    for (int c = 0; c < 2; c++) {
+        if (linear) {
+            node->cv_level[c] = node->cv_target[c];     // Land exactly, no drift
+        }
+        node->cv_target[c] = node->cv_out[c].load(std::memory_order_relaxed);
+        node->cv_step[c] = linear ? (node->cv_target[c] - node->cv_level[c]) / period : 0.0f;
+#ifdef HYBRID_NODE_Q31
+        if (linear) {
+            node->q31_cv_level[c] = node->q31_cv_target[c];
+        }
+        node->q31_cv_target[c] = q31_cv_code(node, node->cv_target[c]);
+        node->q31_cv_step[c] = linear ? (int32_t)(((int64_t)node->q31_cv_target[c] - node->q31_cv_level[c]) / (int64_t)period) : 0;
+#endif
+    }
+    node->cv_countdown = period;
+}
+
+// Link state for a start: inactive until a frame newer than any already
+// published arrives; no reader runs yet
+static void phi_link_reset(HybridNode *node) {
+    PhiLinkFrame frame;
+    memset(&node->status.phi_link, 0, sizeof(node->status.phi_link));
+    if (phi_link_read(&frame)) {
+        node->status.phi_link.sequence = frame.sequence;
+    }
+    node->phi_link_idle = 0;
+}
+
+// Take the latest phi_sensor frame into phi_depth/phi_phase, or go back to
+// the host's values once none has come for phi_link_timeout_ms
+static void phi_link_update(HybridNode *node) {
+    PhiLinkStatus *link = &node->status.phi_link;
+    PhiLinkFrame frame;
+    if (phi_link_read(&frame) && frame.sequence != link->sequence) {
+        link->sequence = frame.sequence;
+        link->frames++;
+        memcpy(link->normalized, frame.normalized, sizeof(link->normalized));
+        node->phi_link_idle = 0;
+        link->active = true;
+    } else if (link->active) {
+        node->phi_link_idle += node->control_period;
+        const uint32_t timeout_ms = node->config.phi_link_timeout_ms > 0 ? node->config.phi_link_timeout_ms
+                                                                         : PHI_LINK_TIMEOUT_MS;
+        if ((uint64_t)node->phi_link_idle * 1000 > (uint64_t)timeout_ms * node->config.sample_rate) {
+            link->active = false;
+            link->stale_count++;
+            node->status.control.phi_depth = node->host_phi_depth;
+            node->status.control.phi_phase = node->host_phi_phase;
+            if (node->config.enable_logging) {
+                firmware_log("[HybridNode] Phi link stale, using host control values\n");
+            }
+        }
+    }
+
+    if (link->active) {
+        node->status.control.phi_depth = fminf(fmaxf(link->normalized[0], 0.0f), 1.0f);
+        node->status.control.phi_phase = fminf(fmaxf(link->normalized[1], 0.0f), 1.0f) * 6.28318531f;
+    }
+}
+
+static void apply_control_voltage(HybridNode *node) {
+    // Φ values straight from the sensor while its link is live (FR-004)
+    if (node->config.enable_phi_link) {
+        phi_link_update(node);
+    }
+
+    // Modulate control voltages based on DSP metrics (FR-004)
+
+    // CV1: VCA depth based on phi_depth and coherence
+    float depth_factor = node->status.control.phi_depth * node->status.dsp.coherence;
+    node->status.control.cv1 = depth_factor * SAFETY_VOLTAGE_MAX * node->config.modulation_depth;
+
+    // CV2: VCA rate based on ICI
+    float rate_factor = 1000.0f / fmaxf(node->status.dsp.ici, 10.0f);  // Inverse of ICI
+    node->status.control.cv2 = fminf(rate_factor, 1.0f) * SAFETY_VOLTAGE_MAX * node->config.modulation_depth;
+
+    // Apply voltage clamping
+    if (node->config.enable_voltage_clamp) {
+        node->status.control.cv1 = fminf(fmaxf(node->status.control.cv1, SAFETY_VOLTAGE_MIN), SAFETY_VOLTAGE_MAX);
+        node->status.control.cv2 = fminf(fmaxf(node->status.control.cv2, SAFETY_VOLTAGE_MIN), SAFETY_VOLTAGE_MAX);
+    }
+
+    // Update output voltage telemetry
+    node->status.safety.voltage_out[2] = node->status.control.cv1;
+    node->status.safety.voltage_out[3] = node->status.control.cv2;
+
+    // Calculate modulation fidelity (SC-002)
+    float target_cv1 = node->status.control.phi_depth * SAFETY_VOLTAGE_MAX;
+    float error = fabsf(node->status.control.cv1 - target_cv1) / SAFETY_VOLTAGE_MAX;
+    node->status.stats.modulation_fidelity = (1.0f - error) * 100.0f;
+}
+
+// Monotonic nanoseconds; only differences are used, so wrapping is harmless
+static uint32_t latency_clock_ns() {
+#ifdef TEENSY
+    return micros() * 1000u;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)ts.tv_sec * 1000000000u + (uint32_t)ts.tv_nsec;
+#else
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint32_t)ts.tv_sec * 1000000000u + (uint32_t)ts.tv_nsec;
+#endif
+}
+
+#ifdef HYBRID_NODE_SIMULATION
+// Simulated ADC clock; 64-bit so long runs do not wrap
+static uint64_t sim_clock_ns() {
+    struct timespec ts;
+#ifdef CLOCK_MONOTONIC
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#else
+    timespec_get(&ts, TIME_UTC);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void sim_sleep_until(uint64_t deadline_ns) {
+#ifdef CLOCK_MONOTONIC
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadline_ns / 1000000000u);
+    ts.tv_nsec = (long)(deadline_ns % 1000000000u);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+#else
+    while (sim_clock_ns() < deadline_ns) {
+    }
+#endif
+}
+#endif
+
+#ifdef RASPBERRY_PI
+// Exact rate, channels, period and period count for interleaved mmap
+// access; playback waits for an explicit start
+static int alsa_configure(HybridNode *node, snd_pcm_t *pcm, unsigned channels, snd_pcm_uframes_t period,
+                          unsigned periods, bool playback) {
+    snd_pcm_hw_params_t *hw;
+    snd_pcm_sw_params_t *sw;
+    snd_pcm_hw_params_alloca(&hw);
+    snd_pcm_sw_params_alloca(&sw);
+    int err;
+    if ((err = snd_pcm_hw_params_any(pcm, hw)) < 0 ||
+        (err = snd_pcm_hw_params_set_access(pcm, hw, SND_PCM_ACCESS_MMAP_INTERLEAVED)) < 0 ||
+        (err = snd_pcm_hw_params_set_format(pcm, hw, ALSA_FORMAT)) < 0 ||
+        (err = snd_pcm_hw_params_set_channels(pcm, hw, channels)) < 0 ||
+        (err = snd_pcm_hw_params_set_rate(pcm, hw, node->config.sample_rate, 0)) < 0 ||
+        (err = snd_pcm_hw_params_set_period_size(pcm, hw, period, 0)) < 0 ||
+        (err = snd_pcm_hw_params_set_periods(pcm, hw, periods, 0)) < 0 ||
+        (err = snd_pcm_hw_params(pcm, hw)) < 0) {
+        return err;
+    }
+    if ((err = snd_pcm_sw_params_current(pcm, sw)) < 0 ||
+        (err = snd_pcm_sw_params_set_avail_min(pcm, sw, period)) < 0 ||
+        (err = snd_pcm_sw_params_set_start_threshold(pcm, sw, playback ? period * periods : 1)) < 0 ||
+        (err = snd_pcm_sw_params(pcm, sw)) < 0) {
+        return err;
+    }
+    return 0;
+}
+
+// Both streams from stopped, the playback ring full of silence so the
+// first period has the whole ring as margin
+static bool alsa_restart(HybridNode *node) {
+    snd_pcm_drop(node->alsa_capture);
+    snd_pcm_drop(node->alsa_playback);
+    if (snd_pcm_prepare(node->alsa_capture) < 0 || snd_pcm_prepare(node->alsa_playback) < 0) {
+        return false;
+    }
+    for (snd_pcm_uframes_t filled = 0; filled < node->alsa_buffer;) {
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset, frames = node->alsa_buffer - filled;
+        if (snd_pcm_avail_update(node->alsa_playback) < 0 ||
+            snd_pcm_mmap_begin(node->alsa_playback, &areas, &offset, &frames) < 0) {
+            return false;
+        }
+        snd_pcm_areas_silence(areas, offset, node->config.dac_channels, frames, ALSA_FORMAT);
+        if (snd_pcm_mmap_commit(node->alsa_playback, offset, frames) < 0) {
+            return false;
+        }
+        filled += frames;
+    }
+    if (!node->alsa_linked && snd_pcm_start(node->alsa_playback) < 0) {
+        return false;
+    }
+    return snd_pcm_start(node->alsa_capture) == 0;
+}
+
+// Overrun or underrun: one buffer counted as dropped, the streams restarted
+static bool alsa_xrun(HybridNode *node, HybridAlsaReport *run) {
+    run->xruns++;
+    node->status.stats.frames_dropped++;
+    if (node->config.enable_logging) {
+        firmware_log("[HybridNode] ALSA xrun, restarting streams\n");
+    }
+    return alsa_restart(node);
+}
+
+// First sample of the frame at offset, or NULL unless the channels are
+// interleaved in one area
+static AlsaSample* alsa_frames(const snd_pcm_channel_area_t *areas, snd_pcm_uframes_t offset, unsigned channels) {
+    const unsigned bits = 8 * sizeof(AlsaSample);
+    for (unsigned c = 0; c < channels; c++) {
+        if (areas[c].addr != areas[0].addr || areas[c].first != c * bits || areas[c].step != channels * bits) {
+            return NULL;
+        }
+    }
+    return (AlsaSample *)areas[0].addr + offset * channels;
+}
+
+#ifdef HYBRID_NODE_Q31
+static float alsa_to_float(AlsaSample x) {
+    return (float)x * (1.0f / 2147483648.0f);
+}
+
+static AlsaSample alsa_from_float(float x) {
+    return (AlsaSample)lrint((double)fminf(fmaxf(x, -1.0f), 1.0f) * 2147483647.0);
+}
+#else
+static float alsa_to_float(AlsaSample x) {
+    return x;
+}
+
+static AlsaSample alsa_from_float(float x) {
+    return x;
+}
+#endif
+
+// Blocking copies through the mmap rings, for calibration and the output
+// clamp on stop; without open streams the ADC reads silence
+static bool alsa_read(HybridNode *node, float *buffer, size_t frames) {
+    const size_t channels = node->config.adc_channels;
+    if (node->alsa_capture == NULL) {
+        memset(buffer, 0, frames * channels * sizeof(float));
+        return true;
+    }
+    snd_pcm_sframes_t got = snd_pcm_mmap_readi(node->alsa_capture, node->alsa_scratch, frames);
+    if (got < 0 && snd_pcm_recover(node->alsa_capture, (int)got, 1) == 0) {
+        got = snd_pcm_mmap_readi(node->alsa_capture, node->alsa_scratch, frames);
+    }
+    if (got != (snd_pcm_sframes_t)frames) {
+        return false;
+    }
+    for (size_t i = 0; i < frames * channels; i++) {
+        buffer[i] = alsa_to_float(node->alsa_scratch[i]);
+    }
+    return true;
+}
+
+static bool alsa_write(HybridNode *node, const float *buffer, size_t frames) {
+    const size_t channels = node->config.dac_channels;
+    if (node->alsa_playback == NULL) {
+        return true;
+    }
+    for (size_t i = 0; i < frames * channels; i++) {
+        node->alsa_scratch[i] = alsa_from_float(buffer[i]);
+    }
+    snd_pcm_sframes_t put = snd_pcm_mmap_writei(node->alsa_playback, node->alsa_scratch, frames);
+    if (put < 0 && snd_pcm_recover(node->alsa_playback, (int)put, 1) == 0) {
+        put = snd_pcm_mmap_writei(node->alsa_playback, node->alsa_scratch, frames);
+    }
+    return put == (snd_pcm_sframes_t)frames;
+}
+#endif
+
+#ifdef HYBRID_NODE_Q31
+// MCP4822 write of one output sample, right-aligned at 12 bits: audio
+// channels offset around mid-scale, control voltages from 0 V at code 0
+static uint32_t spi_dac_word(HybridNode *node, size_t channel, int32_t sample) {
+    int32_t code = channel < node->config.adc_channels ? sample + SPI_CODE_MID : 2 * sample;
+    if (code < 0 || code > (int32_t)SPI_CODE_MASK) {
+        code = code < 0 ? 0 : (int32_t)SPI_CODE_MASK;
+        node->spi_stats.dac_clips++;
+    }
+    return ((channel & 1) ? MCP4822_CHANNEL_B : 0) | (node->spi_config.dac_gain_2x ? 0 : MCP4822_GAIN_1X) |
+           MCP4822_ACTIVE | (uint32_t)code;
+}
+
+// The DAC data words of a half from spi_dac, for its next lap
+static void spi_encode(HybridNode *node, unsigned half) {
+    const size_t frames = node->config.buffer_size;
+    const size_t adc = node->config.adc_channels;
+    const size_t dac = node->config.dac_channels;
+    const size_t slots = node->spi_slots;
+    uint32_t *tx = node->spi_tx + half * frames * slots * 2;
+    for (size_t i = 0; i < frames; i++) {
+        uint32_t *pair = tx + (i * slots + adc) * 2;
+        for (size_t c = 0; c < dac; c++, pair += 2) {
+            pair[1] = spi_dac_word(node, c, node->spi_dac[i * dac + c]);
+        }
+    }
+#ifdef TEENSY
+    arm_dcache_flush(tx, frames * slots * 2 * sizeof(uint32_t));
+#endif
+}
+
+static bool platform_spi_start(HybridNode *node) {
+#ifdef TEENSY
+    // LPSPI4 in master mode 0 at spi_config.clock_hz (CCR SCKDIV), with
+    // SPI_CS_GAP_NS between transfers (CCR DBT) and the PCS pins muxed to
+    // the converters. PIT channel 0 at sample_rate triggers DMA channel 0
+    // (periodic trigger), whose minor loop writes the spi_slots command
+    // and data pairs of one frame to TCR and TDR (destination modulo 8,
+    // the two registers being adjacent), a frame at most 16 words so it
+    // fits the TX FIFO; the major loop runs circularly over both halves
+    // of spi_tx. DMA channel 1 moves RDR into spi_rx on each RX request,
+    // circularly over both halves, interrupting at half and major loop
+    // completion; the handler calls hybrid_spi_dma_half(node, 0) and (1).
+    (void)node;
+    return true;
+#elif defined(HYBRID_NODE_SIMULATION)
+    // hybrid_sim_run moves the halves through sim_spi_half
+    (void)node;
+    return true;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+static void platform_spi_stop(HybridNode *node) {
+    // Teensy: stop PIT channel 0, disable both DMA channels and wait for
+    // the LPSPI to go idle, so no transfer is cut mid-frame
+    (void)node;
+}
+#endif
+
+#ifdef HYBRID_NODE_SIMULATION
+// The next DMA half through simulated converters: the MCP3208 answers each
+// conversion with the code of the simulated input on that input, the
+// half's DAC writes from its previous lap go to the simulated DAC. false
+// when the SPI backend is not running.
+static bool sim_spi_half(HybridNode *node) {
+#ifdef HYBRID_NODE_Q31
+    if (!node->spi_running) {
+        return false;
+    }
+    const size_t frames = node->config.buffer_size;
+    const size_t adc = node->config.adc_channels;
+    const size_t dac = node->config.dac_channels;
+    const size_t slots = node->spi_slots;
+    const unsigned half = node->spi_next_half;
+    const uint32_t *pair = node->spi_tx + half * frames * slots * 2;
+    int32_t *rx = node->spi_rx + half * frames * adc;
+    const float cv_scale = (node->config.voltage_max > 0.0f ? node->config.voltage_max : SAFETY_VOLTAGE_MAX) / 4096.0f;
+
+    platform_adc_read(node, node->sim_input, frames);
+    for (size_t i = 0; i < frames; i++) {
+        for (size_t s = 0; s < slots; s++, pair += 2) {
+            if (pair[0] & SPI_TCR_RXMSK) {
+                size_t chip = 0;
+                while (chip + 1 < (dac + 1) / 2 && node->spi_config.dac_cs[chip] != SPI_TCR_CS(pair[0])) {
+                    chip++;
+                }
+                const size_t c = chip * 2 + ((pair[1] & MCP4822_CHANNEL_B) ? 1 : 0);
+                const int32_t code = (int32_t)(pair[1] & SPI_CODE_MASK);
+                if (c < dac) {
+                    node->sim_output[i * dac + c] = c < adc ? (float)(code - SPI_CODE_MID) / SPI_CODE_MID
+                                                            : (float)code * cv_scale;
+                }
+                continue;
+            }
+            size_t input = 0;
+            while (input + 1 < adc && node->spi_config.adc_inputs[input] != MCP3208_INPUT(pair[1])) {
+                input++;
+            }
+            long code = lrintf(node->sim_input[i * adc + input] * SPI_CODE_MID) + SPI_CODE_MID;
+            code = code < 0 ? 0 : (code > (long)SPI_CODE_MASK ? (long)SPI_CODE_MASK : code);
+            // Above the code the null bit, and a floating MISO before it
+            *rx++ = (int32_t)((0x3Fu << 13) | (uint32_t)code);
+        }
+    }
+    platform_dac_write(node, node->sim_output, frames);
+    hybrid_spi_dma_half(node, half);
+    return true;
+#else
+    (void)node;
+    return false;
+#endif
 }
+#endif
 
-static void dsp_calculate_ici(float *ici_out) {
-    // Simplified ICI calculation based on spectral flux peaks
-    // Store spectral flux in ring buffer
-    g_ici_buffer[g_ici_index] = g_status.dsp.spectral_flux;
-    g_ici_index = (g_ici_index + 1) % 32;
-
-    // Find intervals between peaks
-    float threshold = 0.5f;  // Peak detection threshold
-    uint32_t interval_samples = 0;
-    uint32_t peak_count = 0;
+// Empty stream at the nominal rate, as after hybrid_usb_open
+static void usb_stream_reset(HybridNode *node) {
+    node->usb_input_frames = 0;
+    node->usb_written = 0;
+    node->usb_read = 0;
+    node->usb_last_packet = 0;
+    node->usb_primed = false;
+    node->usb_queue_average = (double)node->usb_target;
+    node->usb_in_phase = 0.0;
+    node->usb_window_sofs = 0;
+    node->usb_buffers = 0;
+    node->usb_latency_sum_us = 0;
+    memset(&node->usb_stats, 0, sizeof(node->usb_stats));
+    node->usb_stats.feedback = (float)node->usb_rate;
+    usb_publish(node);
+}
 
-    for (int i = 0; i < 32; i++) {
-        if (g_ici_buffer[i] > threshold) {
-            peak_count++;
-            interval_samples += g_config.buffer_size;
-        }
+// The first buffer of usb_input into the IN queue, unless the queue has no
+// room for it besides the packet the stack is sending
+static void usb_process(HybridNode *node) {
+    const size_t buffer = node->config.buffer_size;
+    const size_t dac = node->config.dac_channels;
+    const uint64_t queued = node->usb_written - node->usb_read;
+    if (queued + node->usb_last_packet + buffer > node->usb_ring_frames) {
+        node->usb_stats.overruns++;
+        node->status.stats.frames_dropped++;
+        return;
     }
 
-    if (peak_count > 1) {
-        float interval_s = interval_samples / (float)g_config.sample_rate;
-        *ici_out = (interval_s / peak_count) * 1000.0f;  // Convert to ms
-    } else {
-        *ici_out = 100.0f;  // Default 100ms
+    const size_t at = (size_t)(node->usb_written % node->usb_ring_frames);
+    HybridUsbSample *out = node->usb_output + at * dac;
+    const uint32_t start_ns = latency_clock_ns();
+#ifdef HYBRID_NODE_Q31
+    process_buffer_q31(node, node->usb_input, out, buffer, start_ns, node_clock_us());
+#else
+    process_buffer(node, node->usb_input, out, buffer, start_ns, node_clock_us());
+#endif
+    if (at < node->usb_packet_max) {
+        const size_t mirrored = node->usb_packet_max - at < buffer ? node->usb_packet_max - at : buffer;
+        memcpy(node->usb_output + (node->usb_ring_frames + at) * dac, out, mirrored * dac * sizeof(HybridUsbSample));
     }
-
-    g_status.dsp.ici = *ici_out;
+    node->usb_written += buffer;
+
+    // The oldest frame waited for the buffer to fill and waits for the
+    // queue ahead of it to go out
+    const uint64_t latency_us = (buffer + queued) * 1000000u / node->config.sample_rate +
+                                (latency_clock_ns() - start_ns) / 1000u;
+    if (latency_us > node->usb_stats.max_loop_latency_us) {
+        node->usb_stats.max_loop_latency_us = (uint32_t)latency_us;
+    }
+    node->usb_latency_sum_us += latency_us;
+    node->usb_buffers++;
 }
 
-static void dsp_calculate_coherence(float *coherence_out) {
-    // Simplified coherence: based on spectral stability
-    // High coherence = low spectral flux
-    float normalized_flux = fminf(g_status.dsp.spectral_flux / 1000.0f, 1.0f);
-    *coherence_out = 1.0f - normalized_flux;
-
-    g_status.dsp.coherence = *coherence_out;
+static void usb_publish(HybridNode *node) {
+    node->usb_stats.queue_frames = (uint32_t)(node->usb_written - node->usb_read);
+    node->usb_stats.mean_loop_latency_us =
+        node->usb_buffers > 0 ? (uint32_t)(node->usb_latency_sum_us / node->usb_buffers) : 0;
+    status_write(&node->usb_slot, node->usb_stats);
 }
 
-static void safety_check() {
-    // Check for ADC overload (FR-007)
-    if (g_status.analog.is_overloaded) {
-        g_status.safety.overload_count++;
+// Keeps the errno of the first failed real-time step
+static void realtime_fail(HybridRealtimeStatus *rt, int err) {
+    if (err != 0 && rt->error == 0) {
+        rt->error = err;
+    }
+}
 
-        // Auto-gain reduction
-        if (g_config.preamp_gain > ANALOG_PREAMP_GAIN_MIN) {
-            g_config.preamp_gain *= 0.9f;  // Reduce by 10%
+// mlockall, then a write to every page of the node so none first faults in
+// the audio path; from hybrid_init, or before any buffer if already running
+static void realtime_lock_memory(HybridNode *node) {
+    HybridRealtimeStatus *rt = &node->status.realtime;
+#if defined(__linux__)
+    rt->memory_locked = mlockall(MCL_CURRENT | MCL_FUTURE) == 0;
+    realtime_fail(rt, rt->memory_locked ? 0 : errno);
+    if (!node->running) {
+        const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        volatile unsigned char *bytes = (volatile unsigned char *)node;
+        for (size_t i = 0; i < sizeof(HybridNode); i += page) {
+            bytes[i] = bytes[i];
+        }
+    }
+#else
+    realtime_fail(rt, ENOSYS);
+#endif
+}
 
-            if (g_config.enable_logging) {
-                printf("[HybridNode] ADC overload detected, reducing gain to %.2f\n",
-                       g_config.preamp_gain);
+#if defined(__linux__)
+// CPUs 0-31 of the isolcpus= list in sysfs, e.g. "2-3,5"
+static uint32_t realtime_isolated_cpus() {
+    FILE *fp = fopen("/sys/devices/system/cpu/isolated", "r");
+    if (fp == NULL) {
+        return 0;
+    }
+    char line[256];
+    uint32_t mask = 0;
+    if (fgets(line, sizeof(line), fp) != NULL) {
+        char *p = line;
+        while (*p >= '0' && *p <= '9') {
+            const long first = strtol(p, &p, 10);
+            long last = first;
+            if (*p == '-') {
+                last = strtol(p + 1, &p, 10);
+            }
+            for (long c = first; c <= last && c < 32; c++) {
+                mask |= 1u << c;
+            }
+            if (*p == ',') {
+                p++;
             }
         }
     }
+    fclose(fp);
+    return mask;
+}
+
+// Maps the stack the processing loop will grow into
+__attribute__((noinline)) static void realtime_prefault_stack() {
+    volatile unsigned char stack[REALTIME_STACK_PREFAULT];
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < sizeof(stack); i += page) {
+        stack[i] = 0;
+    }
+}
+#endif
 
-    // Check thermal status (FR-007)
+// Monotonic microseconds for DSP timestamps (wraps after ~71 minutes)
+static uint32_t node_clock_us() {
 #ifdef TEENSY
-    if (g_config.enable_thermal_monitor) {
-        // Read analog temperature sensor (example)
-        int temp_raw = analogRead(g_config.thermal_gpio_pin);
-        g_status.safety.temperature = temp_raw * 0.1f;  // Convert to °C
+    return micros();
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+#else
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+#endif
+}
 
-        if (g_status.safety.temperature > SAFETY_TEMP_CRITICAL) {
-            hybrid_node_emergency_shutdown("Temperature critical");
-            g_status.safety.status = HYBRID_SAFETY_TEMP_CRITICAL;
-        } else if (g_status.safety.temperature > SAFETY_TEMP_WARNING) {
-            g_status.safety.thermal_warning = true;
-            g_status.safety.status = HYBRID_SAFETY_TEMP_WARNING;
-        }
+static size_t latency_bucket(uint32_t ns) {
+    if (ns < LATENCY_SUB_BUCKETS) {
+        return ns;
     }
+#if defined(__GNUC__) || defined(__clang__)
+    const unsigned top = 31u - (unsigned)__builtin_clz(ns);
+#else
+    unsigned top = 0;
+    for (uint32_t v = ns; v >>= 1;) top++;
 #endif
+    // Shift that brings ns into [LATENCY_SUB_BUCKETS / 2, LATENCY_SUB_BUCKETS)
+    const unsigned shift = top - (LATENCY_SUB_BUCKET_BITS - 1);
+    return LATENCY_SUB_BUCKETS + (shift - 1) * (LATENCY_SUB_BUCKETS / 2) +
+           ((ns >> shift) - LATENCY_SUB_BUCKETS / 2);
+}
 
-    // Check voltage clamping
-    if (g_config.enable_voltage_clamp) {
-        if (g_status.control.cv1 >= SAFETY_VOLTAGE_MAX ||
-            g_status.control.cv2 >= SAFETY_VOLTAGE_MAX) {
-            g_status.safety.clamp_count++;
-            g_status.safety.status = HYBRID_SAFETY_VOLTAGE_CLAMP;
-        }
+static uint32_t latency_bucket_upper(size_t index) {
+    if (index < LATENCY_SUB_BUCKETS) {
+        return (uint32_t)index;
     }
+    const size_t offset = index - LATENCY_SUB_BUCKETS;
+    const unsigned shift = (unsigned)(offset / (LATENCY_SUB_BUCKETS / 2)) + 1;
+    const uint64_t sub = offset % (LATENCY_SUB_BUCKETS / 2) + LATENCY_SUB_BUCKETS / 2;
+    return (uint32_t)(((sub + 1) << shift) - 1);
 }
 
-static void apply_analog_filter(float *buffer, size_t frames) {
-    // Simple first-order filters (FR-002)
-    // In production, use proper biquad or IIR filters
+// Stage clock: the DWT cycle counter on Teensy, nanoseconds of the raw
+// monotonic clock elsewhere. Differences of it fit 32 bits for any one stage.
+static uint32_t stage_ticks() {
+#ifdef TEENSY
+    return ARM_DWT_CYCCNT;
+#elif defined(CLOCK_MONOTONIC_RAW)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint32_t)ts.tv_sec * 1000000000u + (uint32_t)ts.tv_nsec;
+#else
+    return latency_clock_ns();
+#endif
+}
 
-    static float hpf_state[HYBRID_ADC_CHANNELS] = {0};
-    static float lpf_state[HYBRID_ADC_CHANNELS] = {0};
+static uint32_t stage_ticks_ns(uint32_t ticks) {
+#ifdef TEENSY
+#ifdef __IMXRT1062__
+    const uint32_t hz = F_CPU_ACTUAL;   // Follows set_arm_clock()
+#else
+    const uint32_t hz = F_CPU;
+#endif
+    return (uint32_t)((uint64_t)ticks * 1000000000u / hz);
+#else
+    return ticks;
+#endif
+}
 
-    float hpf_coeff = 1.0f - expf(-2.0f * M_PI * g_config.hpf_cutoff / g_config.sample_rate);
-    float lpf_coeff = 1.0f - expf(-2.0f * M_PI * g_config.lpf_cutoff / g_config.sample_rate);
+// Stage clock at the start of a buffer or block, after clearing the
+// context's stages if the statistics were reset since its last one
+static uint32_t stage_begin(HybridNode *node, bool audio) {
+    uint32_t *seen = audio ? &node->stage_seen_audio : &node->stage_seen_analysis;
+    const uint32_t generation = node->stage_generation.load(std::memory_order_relaxed);
+    if (*seen != generation) {
+        stage_clear(node, audio);
+        *seen = generation;
+    }
+    if (audio) {
+        memset(node->buffer_stage_ns, 0, sizeof(node->buffer_stage_ns));
+    }
+    return stage_ticks();
+}
 
-    for (size_t i = 0; i < frames; i++) {
-        for (int ch = 0; ch < g_config.adc_channels; ch++) {
-            size_t idx = i * g_config.adc_channels + ch;
+// Records a stage that started at start; returns the clock, the start of
+// the next stage
+static uint32_t stage_end(HybridNode *node, HybridStage stage, uint32_t start) {
+    const uint32_t now = stage_ticks();
+    const uint32_t ns = stage_ticks_ns(now - start);
+    StageAccumulator *acc = &node->stage_time[stage];
+    if (stage_in_audio(stage) || !node->config.defer_dsp) {
+        node->buffer_stage_ns[stage] = ns;  // Only the audio context writes it
+    }
+    acc->count++;
+    acc->total_ns += ns;
+    if (ns < acc->min_ns) {
+        acc->min_ns = ns;
+    }
+    if (ns > acc->max_ns) {
+        acc->max_ns = ns;
+    }
+    return now;
+}
 
-            // High-pass filter
-            hpf_state[ch] = hpf_coeff * (hpf_state[ch] + buffer[idx] - buffer[idx]);
-            buffer[idx] = hpf_state[ch];
+static bool stage_in_audio(int stage) {
+    return stage == HYBRID_STAGE_FILTER || stage == HYBRID_STAGE_ENGINE || stage == HYBRID_STAGE_OUTPUT;
+}
 
-            // Low-pass filter
-            lpf_state[ch] += lpf_coeff * (buffer[idx] - lpf_state[ch]);
-            buffer[idx] = lpf_state[ch];
+// Clears the stages one context owns
+static void stage_clear(HybridNode *node, bool audio) {
+    for (int s = 0; s < HYBRID_STAGE_COUNT; s++) {
+        if (stage_in_audio(s) == audio) {
+            node->stage_time[s] = {0, UINT32_MAX, 0, 0};
         }
     }
 }
 
-static void apply_control_voltage() {
-    // Modulate control voltages based on DSP metrics (FR-004)
-
-    // CV1: VCA depth based on phi_depth and coherence
-    float depth_factor = g_status.control.phi_depth * g_status.dsp.coherence;
-    g_status.control.cv1 = depth_factor * SAFETY_VOLTAGE_MAX * g_config.modulation_depth;
+// Clears every stage; while the node is stopped
+static void stage_reset(HybridNode *node) {
+    stage_clear(node, true);
+    stage_clear(node, false);
+    node->stage_seen_audio = node->stage_seen_analysis = node->stage_generation.load(std::memory_order_relaxed);
+}
 
-    // CV2: VCA rate based on ICI
-    float rate_factor = 1000.0f / fmaxf(g_status.dsp.ici, 10.0f);  // Inverse of ICI
-    g_status.control.cv2 = fminf(rate_factor, 1.0f) * SAFETY_VOLTAGE_MAX * g_config.modulation_depth;
+// Timings of the stages one context owns; the others are left alone
+static void stage_copy(const HybridNode *node, HybridStageTiming *timing, bool audio) {
+    for (int s = 0; s < HYBRID_STAGE_COUNT; s++) {
+        if (stage_in_audio(s) != audio) {
+            continue;
+        }
+        const StageAccumulator *acc = &node->stage_time[s];
+        timing[s].count = acc->count;
+        timing[s].min_ns = acc->count > 0 ? acc->min_ns : 0;
+        timing[s].mean_ns = acc->count > 0 ? (uint32_t)(acc->total_ns / acc->count) : 0;
+        timing[s].max_ns = acc->max_ns;
+    }
+}
 
-    // Apply voltage clamping
-    if (g_config.enable_voltage_clamp) {
-        g_status.control.cv1 = fminf(fmaxf(g_status.control.cv1, SAFETY_VOLTAGE_MIN), SAFETY_VOLTAGE_MAX);
-        g_status.control.cv2 = fminf(fmaxf(g_status.control.cv2, SAFETY_VOLTAGE_MIN), SAFETY_VOLTAGE_MAX);
+static void latency_record(HybridNode *node, uint32_t ns) {
+    node->latency_counts[latency_bucket(ns)].fetch_add(1, std::memory_order_relaxed);
+    uint32_t seen = node->latency_max_ns.load(std::memory_order_relaxed);
+    while (ns > seen && !node->latency_max_ns.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+    }
+    seen = node->latency_min_ns.load(std::memory_order_relaxed);
+    while (ns < seen && !node->latency_min_ns.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
     }
+}
 
-    // Update output voltage telemetry
-    g_status.safety.voltage_out[2] = g_status.control.cv1;
-    g_status.safety.voltage_out[3] = g_status.control.cv2;
+static uint32_t latency_copy_counts(HybridNode *node, uint32_t *counts) {
+    uint32_t total = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+        counts[i] = node->latency_counts[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    return total;
+}
 
-    // Calculate modulation fidelity (SC-002)
-    float target_cv1 = g_status.control.phi_depth * SAFETY_VOLTAGE_MAX;
-    float error = fabsf(g_status.control.cv1 - target_cv1) / SAFETY_VOLTAGE_MAX;
-    g_status.stats.modulation_fidelity = (1.0f - error) * 100.0f;
+// Upper bound of the bucket holding the p-quantile, capped at the maximum
+static uint32_t latency_percentile(const uint32_t *counts, uint32_t total, uint32_t max_ns, float p) {
+    if (total == 0) {
+        return 0;
+    }
+    p = fminf(fmaxf(p, 0.0f), 1.0f);
+    uint32_t rank = (uint32_t)ceil((double)p * total);
+    if (rank == 0) {
+        rank = 1;
+    }
+    uint32_t seen = 0;
+    for (size_t i = 0; i < LATENCY_BUCKETS; i++) {
+        seen += counts[i];
+        if (seen >= rank) {
+            const uint32_t upper = latency_bucket_upper(i);
+            return upper < max_ns ? upper : max_ns;
+        }
+    }
+    return max_ns;
 }
 
 //==============================================================================
@@ -791,6 +5201,56 @@ static void apply_control_voltage() {
 //==============================================================================
 
 #ifdef HYBRID_NODE_STANDALONE
+#include <thread>
+
+// Fixed tone through one node, for the multi-node test
+static void selftest_run_node(HybridNode *node, const float *input, size_t blocks) {
+    static thread_local float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+    for (size_t b = 0; b < blocks; b++) {
+        hybrid_process(node, input, out, HYBRID_BUFFER_SIZE);
+    }
+}
+
+static double selftest_seconds(const struct timespec &t0, const struct timespec &t1) {
+    return (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+}
+
+// Writes the log records of the previous step, then the next heading
+static void selftest_step(const char *title) {
+    firmware_log_drain(NULL, NULL, 0);
+    printf("\n%s...\n", title);
+}
+
+// Log records of the ring test: per writer thread, how many arrived and
+// whether they arrived in order
+typedef struct {
+    uint32_t received[4];
+    bool ordered;
+    bool malformed;
+} SelftestLogCount;
+
+static void selftest_count_log(uint32_t timestamp_us, const char *line, void *context) {
+    SelftestLogCount *count = (SelftestLogCount *)context;
+    unsigned writer, index;
+    float value;
+    (void)timestamp_us;
+    if (sscanf(line, "[LogTest] writer %u record %u value %f", &writer, &index, &value) != 3 || writer >= 4 ||
+        value != index * 0.5f) {
+        count->malformed = strncmp(line, "[FirmwareLog]", 13) != 0 || count->malformed;
+        return;
+    }
+    count->ordered = count->ordered && index == count->received[writer];
+    count->received[writer] = index + 1;
+}
+
+static void selftest_log_writer(unsigned writer, unsigned records) {
+    for (unsigned i = 0; i < records; i++) {
+        while (!firmware_log("[LogTest] writer %u record %u value %.1f\n", writer, i, i * 0.5f)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
 int main() {
     printf("=================================================================\n");
     printf("Hybrid Analog-DSP Node Self-Test\n");
@@ -807,10 +5267,13 @@ int main() {
         .hpf_cutoff = ANALOG_HPF_CUTOFF,
         .lpf_cutoff = ANALOG_LPF_CUTOFF,
         .enable_analog_filter = true,
+        .filter_order = 2,
         .fft_size = HYBRID_FFT_SIZE,
         .enable_dsp = true,
         .enable_coherence = true,
         .enable_ici = true,
+        .fft_hop = HYBRID_FFT_SIZE / 2,
+        .fft_window = HYBRID_WINDOW_HANN,
         .enable_modulation = true,
         .modulation_depth = 0.8f,
         .control_loop_rate = 100.0f,
@@ -822,7 +5285,7 @@ int main() {
         .enable_logging = true
     };
 
-    printf("\n1. Testing initialization...\n");
+    selftest_step("1. Testing initialization");
     if (hybrid_node_init(&config)) {
         printf("   ✓ PASS: Initialization successful\n");
     } else {
@@ -830,7 +5293,7 @@ int main() {
         return 1;
     }
 
-    printf("\n2. Testing calibration...\n");
+    selftest_step("2. Testing calibration");
     CalibrationData cal;
     if (hybrid_node_calibrate(&cal)) {
         printf("   ✓ PASS: Calibration successful\n");
@@ -841,16 +5304,1287 @@ int main() {
         printf("   ✗ FAIL: Calibration failed\n");
     }
 
-    printf("\n3. Testing start/stop...\n");
+    selftest_step("3. Testing start/stop");
     if (hybrid_node_start() && hybrid_node_stop()) {
         printf("   ✓ PASS: Start/stop successful\n");
     } else {
         printf("   ✗ FAIL: Start/stop failed\n");
     }
 
-    printf("\n4. Getting firmware version...\n");
+    selftest_step("4. Testing latency histogram");
+    {
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        for (size_t i = 0; i < HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS; i++) {
+            in[i] = 0.5f * sinf(2.0f * 3.14159265f * CAL_TONE_FREQ * (float)(i / HYBRID_ADC_CHANNELS) / HYBRID_SAMPLE_RATE);
+        }
+        hybrid_node_start();
+        for (int b = 0; b < 200; b++) {
+            hybrid_node_process(in, out, HYBRID_BUFFER_SIZE);
+        }
+        hybrid_node_stop();
+
+        HybridLatencyStats latency;
+        hybrid_node_get_latency(&latency);
+        printf("   Buffers: %u  p50: %u ns  p99: %u ns  p99.9: %u ns  max: %u ns\n",
+               latency.count, latency.p50_ns, latency.p99_ns, latency.p999_ns, latency.max_ns);
+        if (latency.count == 200 && latency.p50_ns <= latency.p99_ns && latency.p99_ns <= latency.max_ns) {
+            printf("   ✓ PASS: Latency recorded\n");
+        } else {
+            printf("   ✗ FAIL: Latency histogram inconsistent\n");
+        }
+
+        DSPMetrics dsp;
+        hybrid_node_get_dsp_metrics(&dsp);
+        const uint32_t expected = 200u * HYBRID_BUFFER_SIZE / (HYBRID_FFT_SIZE / 2);
+        if (dsp.analysis_count == expected) {
+            printf("   ✓ PASS: %u spectra analyzed at hop %u\n", dsp.analysis_count, HYBRID_FFT_SIZE / 2);
+        } else {
+            printf("   ✗ FAIL: %u spectra analyzed, expected %u\n", dsp.analysis_count, expected);
+        }
+    }
+
+    selftest_step("5. Testing analog filter bank");
+    {
+        // Steady-state gain of the 120 Hz - 8 kHz band at three tones
+        const float tones[3] = {20.0f, 1000.0f, 20000.0f};
+        float gain[3];
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        for (int t = 0; t < 3; t++) {
+            hybrid_node_start();
+            double in_sq = 0.0, out_sq = 0.0;
+            for (int b = 0; b < 40; b++) {
+                for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+                    float x = 0.5f * sinf(2.0f * (float)M_PI * tones[t] * (float)(b * HYBRID_BUFFER_SIZE + i) /
+                                          HYBRID_SAMPLE_RATE);
+                    for (int ch = 0; ch < HYBRID_ADC_CHANNELS; ch++) {
+                        in[i * HYBRID_ADC_CHANNELS + ch] = x;
+                    }
+                }
+                hybrid_node_process(in, out, HYBRID_BUFFER_SIZE);
+                if (b >= 20) {
+                    for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+                        in_sq += in[i * HYBRID_ADC_CHANNELS] * in[i * HYBRID_ADC_CHANNELS];
+                        out_sq += out[i * HYBRID_DAC_CHANNELS] * out[i * HYBRID_DAC_CHANNELS];
+                    }
+                }
+            }
+            hybrid_node_stop();
+            gain[t] = (float)(10.0 * log10(out_sq / in_sq));
+        }
+        printf("   Gain: %.1f dB at 20 Hz, %.2f dB at 1 kHz, %.1f dB at 20 kHz\n", gain[0], gain[1], gain[2]);
+        if (gain[0] < -20.0f && fabsf(gain[1]) < 0.5f && gain[2] < -12.0f) {
+            printf("   ✓ PASS: Pass band flat, stop bands attenuated\n");
+        } else {
+            printf("   ✗ FAIL: Filter response out of range\n");
+        }
+    }
+
+    selftest_step("6. Testing deferred DSP ring");
+    {
+        // Six buffers with no DSP poll: the ring takes four, two are dropped
+        HybridNodeConfig deferred = config;
+        deferred.defer_dsp = true;
+        deferred.enable_logging = false;
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        memset(in, 0, sizeof(in));
+        hybrid_node_init(&deferred);
+        hybrid_node_start();
+        for (int b = 0; b < HYBRID_DSP_RING_BLOCKS + 2; b++) {
+            hybrid_node_process(in, out, HYBRID_BUFFER_SIZE);
+        }
+        const uint32_t pending = hybrid_node_dsp_pending();
+        const uint32_t analyzed = hybrid_node_dsp_poll(0);
+        HybridNodeStatus status;
+        hybrid_node_get_status(&status);
+        hybrid_node_stop();
+        hybrid_node_init(&config);
+
+        printf("   Queued: %u  analyzed: %u  dropped: %llu  spectra: %u\n", pending, analyzed,
+               (unsigned long long)status.stats.frames_dropped, status.dsp.analysis_count);
+        if (pending == HYBRID_DSP_RING_BLOCKS && analyzed == pending && status.stats.frames_dropped == 2 &&
+            status.dsp.analysis_count == analyzed && hybrid_node_dsp_pending() == 0) {
+            printf("   ✓ PASS: Blocks analyzed in the DSP context, overruns counted\n");
+        } else {
+            printf("   ✗ FAIL: Deferred DSP accounting inconsistent\n");
+        }
+    }
+
+    selftest_step("7. Testing in-place processing");
+    {
+        // Same input through both paths must give the same DAC frames
+        static float staged_in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float dma_in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float staged_out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        static float dma_out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        for (size_t i = 0; i < HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS; i++) {
+            staged_in[i] = 0.5f * sinf(2.0f * (float)M_PI * 440.0f * (i / 2) / config.sample_rate);
+        }
+        memcpy(dma_in, staged_in, sizeof(dma_in));
+
+        // Both runs start their CV ramps from the same level
+        HybridNodeStatus before;
+        hybrid_node_get_status(&before);
+        hybrid_node_start();
+        hybrid_node_process(staged_in, staged_out, HYBRID_BUFFER_SIZE);
+        hybrid_node_stop();
+        hybrid_node_set_control_voltage(&before.control);
+        hybrid_node_start();
+        hybrid_node_process_inplace(dma_in, dma_out, HYBRID_BUFFER_SIZE);
+        hybrid_node_stop();
+
+        float max_diff = 0.0f;
+        for (size_t i = 0; i < HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS; i++) {
+            max_diff = fmaxf(max_diff, fabsf(staged_out[i] - dma_out[i]));
+        }
+        float max_passthrough = 0.0f;
+        for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+            max_passthrough = fmaxf(max_passthrough, fabsf(dma_out[i * HYBRID_DAC_CHANNELS] - dma_in[i * 2]));
+        }
+        printf("   Max difference: %.2e  passthrough error: %.2e\n", max_diff, max_passthrough);
+        if (max_diff == 0.0f && max_passthrough == 0.0f) {
+            printf("   ✓ PASS: In-place output matches the staged path\n");
+        } else {
+            printf("   ✗ FAIL: In-place output differs\n");
+        }
+    }
+
+    selftest_step("8. Testing independent node instances");
+    {
+        // Identical input on every node: results must match a lone node
+        // exactly, whether the nodes run one after another or in parallel
+        const size_t nodes = 4, blocks = 400;
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        for (size_t i = 0; i < HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS; i++) {
+            in[i] = 0.3f * sinf(2.0f * (float)M_PI * 750.0f * (i / 2) / config.sample_rate);
+        }
+        HybridNodeConfig quiet = config;
+        quiet.enable_logging = false;
+
+        HybridNode *node[nodes];
+        bool created = true;
+        for (size_t n = 0; n < nodes; n++) {
+            node[n] = hybrid_node_create();
+            created = created && node[n] != NULL && hybrid_init(node[n], &quiet) && hybrid_start(node[n]);
+        }
+
+        struct timespec t0, t1, t2;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        selftest_run_node(node[0], in, blocks);
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        std::thread workers[nodes - 1];
+        for (size_t n = 1; n < nodes; n++) {
+            workers[n - 1] = std::thread(selftest_run_node, node[n], in, blocks);
+        }
+        for (size_t n = 1; n < nodes; n++) {
+            workers[n - 1].join();
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t2);
+
+        DSPMetrics first;
+        hybrid_get_dsp_metrics(node[0], &first);
+        bool identical = created && first.analysis_count > 0;
+        for (size_t n = 1; n < nodes; n++) {
+            DSPMetrics dsp;
+            HybridNodeStatus status;
+            hybrid_get_dsp_metrics(node[n], &dsp);
+            hybrid_get_status(node[n], &status);
+            identical = identical && memcmp(&dsp, &first, offsetof(DSPMetrics, timestamp_us)) == 0 &&
+                        dsp.analysis_count == first.analysis_count && status.stats.frames_processed == blocks;
+        }
+        for (size_t n = 0; n < nodes; n++) {
+            hybrid_node_destroy(node[n]);
+        }
+
+        const double lone = selftest_seconds(t0, t1), parallel = selftest_seconds(t1, t2);
+        printf("   1 node: %.1f ms  %zu nodes in parallel: %.1f ms (%.2fx throughput)\n", lone * 1e3,
+               nodes - 1, parallel * 1e3, (nodes - 1) * lone / parallel);
+        if (identical) {
+            printf("   ✓ PASS: Nodes keep separate state and agree on the same input\n");
+        } else {
+            printf("   ✗ FAIL: Node instances interfere\n");
+        }
+    }
+
+#ifdef HYBRID_NODE_Q31
+    selftest_step("9. Testing Q31 fixed-point path");
+    {
+        // 24-bit words through the Q31 path against the same tone through
+        // the float path: metrics, audio and control voltages must agree
+        const size_t blocks = 40;
+        const float full_scale = 8388608.0f;
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static int32_t in_q31[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        static int32_t out_q31[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        HybridNodeConfig fixed = config;
+        fixed.enable_logging = false;
+        fixed.sample_bits = 24;
+
+        HybridNode *reference = hybrid_node_create();
+        HybridNode *node = hybrid_node_create();
+        bool ready = reference != NULL && node != NULL && hybrid_init(reference, &fixed) && hybrid_init(node, &fixed) &&
+                     hybrid_start(reference) && hybrid_start(node);
+
+        float audio_error = 0.0f, cv_error = 0.0f;
+        struct timespec t0, t1, t2;
+        double float_s = 0.0, q31_s = 0.0;
+        for (size_t b = 0; ready && b < blocks; b++) {
+            for (size_t i = 0; i < HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS; i++) {
+                size_t t = b * HYBRID_BUFFER_SIZE + i / 2;
+                float x = 0.4f * sinf(2.0f * (float)M_PI * 1000.0f * t / config.sample_rate) +
+                          0.1f * sinf(2.0f * (float)M_PI * 5000.0f * t / config.sample_rate);
+                in_q31[i] = (int32_t)lrintf(x * full_scale);
+                in[i] = in_q31[i] / full_scale;
+            }
+            clock_gettime(CLOCK_MONOTONIC, &t0);
+            hybrid_process(reference, in, out, HYBRID_BUFFER_SIZE);
+            clock_gettime(CLOCK_MONOTONIC, &t1);
+            hybrid_process_q31(node, in_q31, out_q31, HYBRID_BUFFER_SIZE);
+            clock_gettime(CLOCK_MONOTONIC, &t2);
+            float_s += selftest_seconds(t0, t1);
+            q31_s += selftest_seconds(t1, t2);
+            for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+                const float *f = &out[i * HYBRID_DAC_CHANNELS];
+                const int32_t *q = &out_q31[i * HYBRID_DAC_CHANNELS];
+                audio_error = fmaxf(audio_error, fabsf(q[0] / full_scale - f[0]));
+                audio_error = fmaxf(audio_error, fabsf(q[1] / full_scale - f[1]));
+                cv_error = fmaxf(cv_error, fabsf(q[2] / full_scale * fixed.voltage_max - f[2]));
+                cv_error = fmaxf(cv_error, fabsf(q[3] / full_scale * fixed.voltage_max - f[3]));
+            }
+        }
+
+        HybridNodeStatus expected, actual;
+        hybrid_get_status(reference, &expected);
+        hybrid_get_status(node, &actual);
+        const float centroid_error = fabsf(actual.dsp.spectral_centroid - expected.dsp.spectral_centroid) /
+                                     fmaxf(expected.dsp.spectral_centroid, 1.0f);
+        const float rolloff_error = fabsf(actual.dsp.spectral_rolloff - expected.dsp.spectral_rolloff);
+        const float shape_error = fmaxf(fabsf(actual.dsp.spectral_flatness - expected.dsp.spectral_flatness),
+                                        fabsf(actual.dsp.spectral_flux - expected.dsp.spectral_flux));
+        float level_error = fmaxf(fabsf(actual.analog.rms_level - expected.analog.rms_level),
+                                  fabsf(actual.analog.peak_level - expected.analog.peak_level));
+        for (size_t c = 0; c < HYBRID_ADC_CHANNELS; c++) {
+            level_error = fmaxf(level_error, fabsf(actual.analog.channel_rms[c] - expected.analog.channel_rms[c]));
+            level_error = fmaxf(level_error, fabsf(actual.analog.channel_peak[c] - expected.analog.channel_peak[c]));
+            level_error = fmaxf(level_error, fabsf(actual.analog.channel_dc[c] - expected.analog.channel_dc[c]));
+        }
+        printf("   Centroid: %.1f Hz (float %.1f Hz)  RMS: %.4f (float %.4f)\n", actual.dsp.spectral_centroid,
+               expected.dsp.spectral_centroid, actual.analog.rms_level, expected.analog.rms_level);
+        printf("   Rolloff: %.0f Hz (float %.0f Hz)  flatness: %.4f (float %.4f)  flux: %.4f (float %.4f)\n",
+               actual.dsp.spectral_rolloff, expected.dsp.spectral_rolloff, actual.dsp.spectral_flatness,
+               expected.dsp.spectral_flatness, actual.dsp.spectral_flux, expected.dsp.spectral_flux);
+        const float coherence_error = fabsf(actual.dsp.coherence - expected.dsp.coherence);
+        const float thd_error = fabsf(actual.analog.thd - expected.analog.thd) / fmaxf(expected.analog.thd, 1e-3f);
+        printf("   Coherence: %.4f (float %.4f)  THD: %.3f%% (float %.3f%%)  SNR: %.1f dB (float %.1f dB)\n",
+               actual.dsp.coherence, expected.dsp.coherence, actual.analog.thd, expected.analog.thd,
+               actual.analog.snr_db, expected.analog.snr_db);
+        printf("   Audio error: %.2e  CV error: %.2e V  per buffer: %.1f µs Q31, %.1f µs float\n", audio_error,
+               cv_error, q31_s * 1e6 / blocks, float_s * 1e6 / blocks);
+
+        // Words beyond 24 bits saturate instead of wrapping
+        hybrid_stop(node);
+        fixed.enable_analog_filter = false;
+        hybrid_init(node, &fixed);
+        hybrid_start(node);
+        for (size_t i = 0; i < HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS; i++) {
+            in_q31[i] = (i & 2) ? -0x7FFFFFF : 0x7FFFFFF;
+        }
+        hybrid_process_q31(node, in_q31, out_q31, HYBRID_BUFFER_SIZE);
+        const bool saturated = out_q31[0] == 0x7FFFFF && out_q31[HYBRID_DAC_CHANNELS] == -0x800000;
+
+        hybrid_node_destroy(reference);
+        hybrid_node_destroy(node);
+        if (ready && actual.dsp.analysis_count == expected.dsp.analysis_count && centroid_error < 0.01f &&
+            rolloff_error <= config.sample_rate / HYBRID_FFT_SIZE && shape_error < 0.01f && coherence_error < 0.01f &&
+            thd_error < 0.01f && level_error < 1e-4f && audio_error < 1e-4f && cv_error < 1e-3f && saturated) {
+            printf("   ✓ PASS: Fixed-point path matches the float path\n");
+        } else {
+            printf("   ✗ FAIL: Fixed-point path differs%s\n", saturated ? "" : " (no saturation)");
+        }
+    }
+#endif
+
+    selftest_step("10. Testing control loop CV ramps");
+    {
+        // One CV step at a 1 kHz control rate: the per-sample ramp must be
+        // the same whatever the buffer size
+        const size_t total = 4 * HYBRID_BUFFER_SIZE, period = HYBRID_SAMPLE_RATE / 1000;
+        const size_t sizes[2] = {16, HYBRID_BUFFER_SIZE};
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        static float ramp[2][2][4 * HYBRID_BUFFER_SIZE];
+        HybridNodeConfig control = config;
+        control.enable_logging = false;
+        control.enable_modulation = false;
+        control.control_loop_rate = 1000.0f;
+
+        HybridNode *node = hybrid_node_create();
+        bool ready = node != NULL;
+        for (int shape = 0; shape < 2; shape++) {
+            control.cv_interpolation = shape == 0 ? HYBRID_CV_LINEAR : HYBRID_CV_EXPONENTIAL;
+            for (int z = 0; z < 2; z++) {
+                ControlVoltage cv = {0.0f, 0.0f, 0.0f, 0.0f};
+                ready = ready && hybrid_init(node, &control) && hybrid_set_control_voltage(node, &cv) &&
+                        hybrid_start(node);
+                cv.cv1 = 4.0f;
+                hybrid_set_control_voltage(node, &cv);
+                for (size_t done = 0; ready && done < total; done += sizes[z]) {
+                    hybrid_process(node, in, out, sizes[z]);
+                    for (size_t i = 0; i < sizes[z]; i++) {
+                        ramp[shape][z][done + i] = out[i * HYBRID_DAC_CHANNELS + 2];
+                    }
+                }
+                hybrid_stop(node);
+            }
+        }
+        hybrid_node_destroy(node);
+
+        bool ok = ready;
+        for (int shape = 0; shape < 2; shape++) {
+            const float *r = ramp[shape][0];
+            float max_step = 0.0f;
+            for (size_t i = 1; i < total; i++) {
+                max_step = fmaxf(max_step, fabsf(r[i] - r[i - 1]));
+            }
+            printf("   %s: largest step %.3f V, %.3f V after one period\n", shape == 0 ? "Linear" : "Exponential",
+                   max_step, r[period]);
+            ok = ok && memcmp(ramp[shape][0], ramp[shape][1], total * sizeof(float)) == 0 && r[0] == 0.0f &&
+                 fabsf(r[period] - 4.0f) <= 0.08f && r[total - 1] > 3.99f &&
+                 max_step <= (shape == 0 ? 1.001f * 4.0f / period : 0.5f);
+        }
+        if (ok) {
+            printf("   ✓ PASS: CV ramps per sample, independent of the buffer size\n");
+        } else {
+            printf("   ✗ FAIL: CV ramp depends on the buffer size or steps\n");
+        }
+    }
+
+    selftest_step("11. Testing per-channel analog metrics, THD and SNR");
+    {
+        // Unbalanced stereo with DC on the right and a few clipped samples:
+        // every channel must match a double-precision reference, and the
+        // node total must combine them
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        const size_t frames = HYBRID_BUFFER_SIZE - 3;   // Leaves a tail past the last full vector
+        for (size_t i = 0; i < frames; i++) {
+            float phase = 2.0f * (float)M_PI * 440.0f * i / config.sample_rate;
+            in[i * 2] = 0.5f * sinf(phase);
+            in[i * 2 + 1] = 0.1f * sinf(phase) + 0.05f;
+        }
+        in[7 * 2 + 1] = 0.99f;
+        in[frames * 2 - 1] = -0.98f;
+
+        HybridNodeConfig raw = config;
+        raw.enable_logging = false;
+        raw.enable_analog_filter = false;
+        HybridNode *node = hybrid_node_create();
+        bool ok = node != NULL && hybrid_init(node, &raw) && hybrid_start(node) &&
+                  hybrid_process(node, in, out, frames);
+        HybridNodeStatus status;
+        hybrid_get_status(node, &status);
+        hybrid_node_destroy(node);
+
+        float max_error = 0.0f;
+        double total_sq = 0.0;
+        for (size_t c = 0; c < 2; c++) {
+            double sum = 0.0, sum_sq = 0.0, peak = 0.0;
+            uint32_t overloads = 0;
+            for (size_t i = 0; i < frames; i++) {
+                double x = in[i * 2 + c];
+                sum += x;
+                sum_sq += x * x;
+                peak = fmax(peak, fabs(x));
+                overloads += fabs(x) > SAFETY_OVERLOAD_THRESH;
+            }
+            total_sq += sum_sq;
+            max_error = fmaxf(max_error, fabsf(status.analog.channel_rms[c] - (float)sqrt(sum_sq / frames)));
+            max_error = fmaxf(max_error, fabsf(status.analog.channel_dc[c] - (float)(sum / frames)));
+            max_error = fmaxf(max_error, fabsf(status.analog.channel_peak[c] - (float)peak));
+            ok = ok && status.analog.channel_overloads[c] == overloads;
+            printf("   ch%zu: rms %.4f  peak %.4f  dc %+.4f  overloads %u\n", c, status.analog.channel_rms[c],
+                   status.analog.channel_peak[c], status.analog.channel_dc[c], status.analog.channel_overloads[c]);
+        }
+        max_error = fmaxf(max_error, fabsf(status.analog.rms_level - (float)sqrt(total_sq / (2 * frames))));
+        if (ok && max_error < 1e-5f && status.analog.channel_overloads[1] == 2 && status.analog.is_overloaded) {
+            printf("   ✓ PASS: Per-channel metrics match the reference (max error %.1e)\n", max_error);
+        } else {
+            printf("   ✗ FAIL: Per-channel metrics differ (max error %.1e)\n", max_error);
+        }
+
+        // Half a second of a tone with 1% second and 0.5% third harmonic
+        // over white noise 60 dB down, at 1 kHz and then at 3 kHz: THD
+        // √1.25 %, SNR 60 dB, the fundamental found again after the jump
+        node = hybrid_node_create();
+        ok = node != NULL && hybrid_init(node, &raw) && hybrid_start(node);
+        const float noise_level = sqrtf(3.0f * 0.125f * 1e-6f);     // Uniform, variance 1e-6 of the tone's
+        const size_t buffers = (size_t)(0.5f * config.sample_rate) / HYBRID_BUFFER_SIZE;
+        uint32_t seed = 2718u;
+        float thd[2] = {0.0f, 0.0f}, snr[2] = {0.0f, 0.0f};
+        for (int part = 0; part < 2; part++) {
+            const float hz = part == 0 ? 1000.0f : 3000.0f;
+            for (size_t b = 0; ok && b < buffers; b++) {
+                for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+                    const float w = 2.0f * (float)M_PI * hz * (float)(b * HYBRID_BUFFER_SIZE + i) / config.sample_rate;
+                    seed = seed * 1664525u + 1013904223u;
+                    const float x = 0.5f * sinf(w) + 0.005f * sinf(2.0f * w) + 0.0025f * sinf(3.0f * w) +
+                                    noise_level * ((float)(seed >> 8) / 8388608.0f - 1.0f);
+                    for (int ch = 0; ch < HYBRID_ADC_CHANNELS; ch++) {
+                        in[i * HYBRID_ADC_CHANNELS + ch] = x;
+                    }
+                }
+                hybrid_process(node, in, out, HYBRID_BUFFER_SIZE);
+            }
+            hybrid_get_status(node, &status);
+            thd[part] = status.analog.thd;
+            snr[part] = status.analog.snr_db;
+            ok = ok && fabsf(thd[part] - sqrtf(1.25f)) < 0.02f && fabsf(snr[part] - 60.0f) < 1.5f;
+        }
+        hybrid_node_destroy(node);
+        printf("   1 kHz: THD %.3f%%  SNR %.1f dB   3 kHz: THD %.3f%%  SNR %.1f dB   (%.3f%%, 60.0 dB)\n", thd[0],
+               snr[0], thd[1], snr[1], sqrtf(1.25f));
+        if (ok) {
+            printf("   ✓ PASS: THD and SNR from the analysis spectrum\n");
+        } else {
+            printf("   ✗ FAIL: THD or SNR off\n");
+        }
+    }
+
+    selftest_step("12. Testing spectral features and coherence");
+    {
+        // A steady 1 kHz tone, then white noise from the next buffer on:
+        // the tone is tonal and steady, the switch is an onset, the noise
+        // is flat and reaches towards Nyquist
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        const size_t blocks = 4 * HYBRID_FFT_SIZE / HYBRID_BUFFER_SIZE;
+        HybridNodeConfig raw = config;
+        raw.enable_logging = false;
+        raw.enable_analog_filter = false;
+        HybridNode *node = hybrid_node_create();
+        bool ok = node != NULL && hybrid_init(node, &raw) && hybrid_start(node);
+
+        DSPMetrics tone = {}, noise = {};
+        float onset_flux = 0.0f;
+        uint32_t seed = 12345u, analyses = 0;
+        for (size_t b = 0; ok && b < 2 * blocks; b++) {
+            for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+                float x;
+                if (b < blocks) {
+                    x = 0.5f * sinf(2.0f * (float)M_PI * 1000.0f * (float)(b * HYBRID_BUFFER_SIZE + i) /
+                                    config.sample_rate);
+                } else {
+                    seed = seed * 1664525u + 1013904223u;
+                    x = 0.5f * ((float)(seed >> 8) / 8388608.0f - 1.0f);
+                }
+                for (int ch = 0; ch < HYBRID_ADC_CHANNELS; ch++) {
+                    in[i * HYBRID_ADC_CHANNELS + ch] = x;
+                }
+            }
+            hybrid_process(node, in, out, HYBRID_BUFFER_SIZE);
+            HybridNodeStatus status;
+            hybrid_get_status(node, &status);
+            if (status.dsp.analysis_count != analyses) {
+                analyses = status.dsp.analysis_count;
+                if (b < blocks) {
+                    tone = status.dsp;
+                } else {
+                    onset_flux = fmaxf(onset_flux, status.dsp.spectral_flux);
+                    noise = status.dsp;
+                }
+            }
+        }
+        hybrid_node_destroy(node);
+
+        printf("   Tone:  centroid %.0f Hz  rolloff %.0f Hz  flatness %.3f  flux %.3f\n", tone.spectral_centroid,
+               tone.spectral_rolloff, tone.spectral_flatness, tone.spectral_flux);
+        printf("   Noise: centroid %.0f Hz  rolloff %.0f Hz  flatness %.3f  flux %.3f (onset %.3f)\n",
+               noise.spectral_centroid, noise.spectral_rolloff, noise.spectral_flatness, noise.spectral_flux,
+               onset_flux);
+        const float nyquist = config.sample_rate / 2.0f;
+        if (ok && tone.spectral_flux < 0.01f && tone.spectral_flatness < 0.01f &&
+            tone.spectral_rolloff < 2000.0f && onset_flux > 0.3f && noise.spectral_flatness > 0.4f &&
+            noise.spectral_rolloff > 0.75f * nyquist && noise.spectral_rolloff < nyquist) {
+            printf("   ✓ PASS: Flux, rolloff and flatness separate tone, onset and noise\n");
+        } else {
+            printf("   ✗ FAIL: Spectral features out of range\n");
+        }
+
+        // Channel 1 as channel 0 itself, as a delayed copy under independent
+        // noise of the same power (coherence 1/2 in every bin) and as
+        // independent noise: 3 s each, six averaging time constants
+        const float expected[3] = {1.0f, 0.5f, 0.0f};
+        float coherence[3] = {0.0f, 0.0f, 0.0f};
+        ok = true;
+        for (int mix = 0; mix < 3; mix++) {
+            node = hybrid_node_create();
+            ok = ok && node != NULL && hybrid_init(node, &raw) && hybrid_start(node);
+            float previous[3] = {0.0f, 0.0f, 0.0f};
+            const size_t buffers = (size_t)(3.0f * config.sample_rate) / HYBRID_BUFFER_SIZE;
+            for (size_t b = 0; ok && b < buffers; b++) {
+                for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+                    seed = seed * 1664525u + 1013904223u;
+                    const float x = 0.3f * ((float)(seed >> 8) / 8388608.0f - 1.0f);
+                    seed = seed * 1664525u + 1013904223u;
+                    const float n = 0.3f * ((float)(seed >> 8) / 8388608.0f - 1.0f);
+                    in[i * HYBRID_ADC_CHANNELS] = x;
+                    in[i * HYBRID_ADC_CHANNELS + 1] = mix == 0 ? x : mix == 1 ? previous[2] + n : n;
+                    previous[2] = previous[1];
+                    previous[1] = previous[0];
+                    previous[0] = x;
+                }
+                hybrid_process(node, in, out, HYBRID_BUFFER_SIZE);
+            }
+            HybridNodeStatus status;
+            hybrid_get_status(node, &status);
+            coherence[mix] = status.dsp.coherence;
+            hybrid_node_destroy(node);
+            ok = ok && fabsf(coherence[mix] - expected[mix]) < 0.1f;
+        }
+        printf("   Coherence: identical %.3f  delayed under noise %.3f (1/2)  independent %.3f\n", coherence[0],
+               coherence[1], coherence[2]);
+        if (ok) {
+            printf("   ✓ PASS: Averaged cross spectra separate shared, half-shared and independent input\n");
+        } else {
+            printf("   ✗ FAIL: Coherence out of range\n");
+        }
+    }
+
+    selftest_step("13. Testing ICI peak detector");
+    {
+        // Decaying noise bursts every 11025 frames, not a multiple of the
+        // hop, on a faint noise floor: the mean interval must come out to
+        // well within a buffer and the spread stay below one
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        const uint32_t period = 11025;
+        const size_t blocks = 20 * period / HYBRID_BUFFER_SIZE;
+        HybridNodeConfig raw = config;
+        raw.enable_logging = false;
+        raw.enable_analog_filter = false;
+        HybridNode *node = hybrid_node_create();
+        bool ok = node != NULL && hybrid_init(node, &raw) && hybrid_start(node);
+        uint32_t seed = 777u;
+        for (size_t b = 0; ok && b < blocks; b++) {
+            for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+                const uint32_t t = (uint32_t)(b * HYBRID_BUFFER_SIZE + i) % period;
+                seed = seed * 1664525u + 1013904223u;
+                const float white = (float)(seed >> 8) / 8388608.0f - 1.0f;
+                const float x = white * (0.002f + 0.6f * expf(-(float)t / (0.01f * config.sample_rate)));
+                for (int ch = 0; ch < HYBRID_ADC_CHANNELS; ch++) {
+                    in[i * HYBRID_ADC_CHANNELS + ch] = x;
+                }
+            }
+            hybrid_process(node, in, out, HYBRID_BUFFER_SIZE);
+        }
+        HybridNodeStatus status;
+        hybrid_get_status(node, &status);
+        hybrid_node_destroy(node);
+
+        const float expected_ms = 1000.0f * period / config.sample_rate;
+        const float buffer_ms = 1000.0f * HYBRID_BUFFER_SIZE / config.sample_rate;
+        printf("   ICI: %.2f ms (bursts every %.2f ms)  deviation: %.2f ms  over %u intervals\n", status.dsp.ici,
+               expected_ms, status.dsp.ici_deviation, status.dsp.ici_interval_count);
+        if (ok && status.dsp.ici_interval_count == 16 && fabsf(status.dsp.ici - expected_ms) < 0.1f * buffer_ms &&
+            status.dsp.ici_deviation < buffer_ms) {
+            printf("   ✓ PASS: Peak intervals resolved below one buffer\n");
+        } else {
+            printf("   ✗ FAIL: Peak intervals off\n");
+        }
+    }
+
+    selftest_step("14. Testing per-stage timing");
+    {
+        // A tone through every stage, inline and then deferred; the deferred
+        // node is reset while running and must restart at one buffer
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        static const char *names[HYBRID_STAGE_COUNT] = {"filter", "metrics", "fft", "analysis", "control", "output",
+                                                         "engine"};
+        for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+            const float x = 0.3f * sinf(2.0f * (float)M_PI * CAL_TONE_FREQ * i / config.sample_rate);
+            for (int ch = 0; ch < HYBRID_ADC_CHANNELS; ch++) {
+                in[i * HYBRID_ADC_CHANNELS + ch] = x;
+            }
+        }
+        HybridNodeConfig timed = config;
+        timed.enable_logging = false;
+        timed.enable_analog_filter = timed.enable_dsp = timed.enable_modulation = true;
+        timed.enable_ici = timed.enable_coherence = true;
+        HybridNodeStatus status, after_reset;
+        bool ok = true;
+        for (int pass = 0; pass < 2; pass++) {
+            timed.defer_dsp = pass == 1;
+            HybridNode *node = hybrid_node_create();
+            ok = ok && node != NULL && hybrid_init(node, &timed) && hybrid_start(node);
+            for (int b = 0; ok && b < 32; b++) {
+                hybrid_process(node, in, out, HYBRID_BUFFER_SIZE);
+                hybrid_dsp_poll(node, 0);
+            }
+            hybrid_get_status(node, &status);
+            if (pass == 1) {
+                hybrid_reset_statistics(node);
+                hybrid_process(node, in, out, HYBRID_BUFFER_SIZE);
+                hybrid_dsp_poll(node, 0);
+                hybrid_get_status(node, &after_reset);
+                ok = ok && after_reset.stats.stage[HYBRID_STAGE_FILTER].count == 1 &&
+                     after_reset.stats.stage[HYBRID_STAGE_METRICS].count == 1 &&
+                     after_reset.stats.stage[HYBRID_STAGE_OUTPUT].count == 1;
+            }
+            for (int s = 0; s < HYBRID_STAGE_ENGINE; s++) {   // No engine attached
+                const HybridStageTiming *t = &status.stats.stage[s];
+                ok = ok && t->count > 0 && t->min_ns <= t->mean_ns && t->mean_ns <= t->max_ns;
+                if (pass == 0) {
+                    printf("   %-9s %4u buffers  min %7u ns  mean %7u ns  max %7u ns\n", names[s], t->count,
+                           t->min_ns, t->mean_ns, t->max_ns);
+                }
+            }
+            hybrid_node_destroy(node);
+        }
+        if (ok) {
+            printf("   ✓ PASS: Every stage timed in its own context, reset while running\n");
+        } else {
+            printf("   ✗ FAIL: Stage timings missing or inconsistent\n");
+        }
+    }
+
+    selftest_step("15. Testing real-time mode");
+    {
+        // On a thread of its own, so the rest of the test keeps its
+        // scheduling; each step reports, granted or not
+        HybridNodeConfig rt = config;
+        rt.enable_logging = false;
+        rt.enable_realtime = true;
+        rt.realtime_cpus = 1u;
+        HybridNode *node = hybrid_node_create();
+        bool ok = node != NULL && hybrid_init(node, &rt) && hybrid_start(node);
+        bool entered = false;
+        std::thread worker([&] {
+            static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+            static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+            entered = ok && hybrid_realtime_enter(node);
+            for (int b = 0; ok && b < 8; b++) {
+                hybrid_process(node, in, out, HYBRID_BUFFER_SIZE);
+            }
+        });
+        worker.join();
+        HybridNodeStatus status;
+        memset(&status, 0, sizeof(status));
+        if (ok) {
+            hybrid_get_status(node, &status);
+        }
+        hybrid_node_destroy(node);
+#if defined(__linux__)
+        munlockall();
+#endif
+
+        const HybridRealtimeStatus *r = &status.realtime;
+        printf("   mlockall: %s  prefault: %s  SCHED_FIFO: %s  CPU: %d%s  errno: %d\n", r->memory_locked ? "yes" : "no",
+               r->prefaulted ? "yes" : "no", r->sched_fifo ? "yes" : "no", r->cpu, r->cpu_isolated ? " (isolated)" : "",
+               r->error);
+        const bool all = r->memory_locked && r->prefaulted && r->sched_fifo && r->cpu_pinned;
+        if (ok && entered == all && (r->error == 0) == all && status.stats.frames_processed == 8) {
+            printf("   ✓ PASS: Every real-time step reported%s\n", all ? "" : " (some not granted here)");
+        } else {
+            printf("   ✗ FAIL: Real-time status inconsistent\n");
+        }
+    }
+
+    selftest_step("16. Testing load governor");
+    {
+        // Thresholds every buffer is above shed one level per hold period
+        // up to no spectral analysis; thresholds none reaches then restore
+        // them, unless buffers overrun here even without the spectra. Audio
+        // and buffer counts must not notice either way.
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+            const float x = 0.3f * sinf(2.0f * (float)M_PI * CAL_TONE_FREQ * i / config.sample_rate);
+            for (int ch = 0; ch < HYBRID_ADC_CHANNELS; ch++) {
+                in[i * HYBRID_ADC_CHANNELS + ch] = x;
+            }
+        }
+        HybridNodeConfig governed = config;
+        governed.enable_logging = false;
+        governed.enable_analog_filter = false;
+        governed.enable_load_governor = true;
+        governed.governor_high_load = 1e-6f;
+        governed.governor_low_load = 1e-7f;
+        HybridNode *node = hybrid_node_create();
+        bool ok = node != NULL && hybrid_init(node, &governed) && hybrid_start(node);
+        const int blocks = (HYBRID_LOAD_LEVELS + 1) * (LOAD_GOVERNOR_HOLD + 1);
+        char trace[2][blocks + 1];
+        uint32_t analyses[HYBRID_LOAD_LEVELS] = {0}, buffers[HYBRID_LOAD_LEVELS] = {0};
+        uint8_t peak = HYBRID_LOAD_FULL;
+        uint64_t restore_overruns = 0;
+        bool passthrough = true, stepped = true;
+        HybridNodeStatus status;
+        memset(&status, 0, sizeof(status));
+        for (int pass = 0; ok && pass < 2; pass++) {
+            if (pass == 1) {
+                node->config.governor_high_load = 1e9f;
+                node->config.governor_low_load = 1e8f;
+                restore_overruns = status.stats.deadline_overruns;
+            }
+            for (int b = 0; b < blocks; b++) {
+                const uint8_t before = status.stats.load_level;
+                const uint32_t counted = status.dsp.analysis_count;
+                hybrid_process(node, in, out, HYBRID_BUFFER_SIZE);
+                for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+                    passthrough = passthrough && out[i * HYBRID_DAC_CHANNELS] == in[i * HYBRID_ADC_CHANNELS];
+                }
+                hybrid_get_status(node, &status);
+                const uint8_t level = status.stats.load_level;
+                stepped = stepped && (level == before || level == before + 1 || level + 1 == before);
+                // The block ran at the level before this buffer moved it
+                analyses[before] += status.dsp.analysis_count - counted;
+                buffers[before]++;
+                peak = level > peak ? level : peak;
+                trace[pass][b] = (char)('0' + level);
+            }
+            trace[pass][blocks] = '\0';
+        }
+        restore_overruns = status.stats.deadline_overruns - restore_overruns;
+        hybrid_node_destroy(node);
+
+        uint64_t at_levels = 0;
+        for (int l = 0; l < HYBRID_LOAD_LEVELS; l++) {
+            at_levels += status.stats.load_level_buffers[l];
+        }
+        printf("   shed:    %s\n   restore: %s\n", trace[0], trace[1]);
+        printf("   analyses per buffer: full %.2f  half rate %.2f  none %.2f\n",
+               (float)analyses[HYBRID_LOAD_FULL] / buffers[HYBRID_LOAD_FULL],
+               (float)analyses[HYBRID_LOAD_HALF_RATE] / buffers[HYBRID_LOAD_HALF_RATE],
+               (float)analyses[HYBRID_LOAD_NO_SPECTRAL] / buffers[HYBRID_LOAD_NO_SPECTRAL]);
+        const bool restored = restore_overruns > 0 ||
+                              (status.stats.load_level == HYBRID_LOAD_FULL &&
+                               status.stats.load_level_changes == 2 * HYBRID_LOAD_NO_SPECTRAL &&
+                               analyses[HYBRID_LOAD_FULL] == buffers[HYBRID_LOAD_FULL] &&
+                               2 * analyses[HYBRID_LOAD_HALF_RATE] + 1 >= buffers[HYBRID_LOAD_HALF_RATE] &&
+                               2 * analyses[HYBRID_LOAD_HALF_RATE] <= buffers[HYBRID_LOAD_HALF_RATE] + 1);
+        if (ok && stepped && passthrough && restored && peak == HYBRID_LOAD_NO_SPECTRAL &&
+            status.stats.frames_processed == 2 * (uint64_t)blocks && at_levels == status.stats.frames_processed &&
+            analyses[HYBRID_LOAD_NO_SPECTRAL] == 0) {
+            printf("   ✓ PASS: Analysis shed and restored a level at a time, audio untouched%s\n",
+                   restore_overruns > 0 ? " (overruns hold the level here)" : "");
+        } else {
+            printf("   ✗ FAIL: Load governor levels or telemetry off\n");
+        }
+    }
+
+    selftest_step("17. Testing the deadline watchdog");
+    {
+        // A near-miss fraction no buffer stays under: every buffer is a
+        // near miss or an overrun, each charged to one stage and reported;
+        // then a requested shed moves the governor one level
+        static float in[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS];
+        static float out[HYBRID_BUFFER_SIZE * HYBRID_DAC_CHANNELS];
+        for (size_t i = 0; i < HYBRID_BUFFER_SIZE; i++) {
+            const float x = 0.3f * sinf(2.0f * (float)M_PI * CAL_TONE_FREQ * i / config.sample_rate);
+            for (int ch = 0; ch < HYBRID_ADC_CHANNELS; ch++) {
+                in[i * HYBRID_ADC_CHANNELS + ch] = x;
+            }
+        }
+        struct Watch {
+            uint32_t calls;
+            uint32_t near;
+            bool budgeted;
+        } watch = {0, 0, true};
+        HybridBufferObserver on_deadline = [](void *context, const HybridBufferRecord *record) {
+            Watch *w = (Watch *)context;
+            w->calls++;
+            w->near += record->near_miss ? 1 : 0;
+            w->budgeted = w->budgeted && record->budget_ns > 0 && record->near_miss != record->overrun;
+        };
+        HybridNodeConfig watched = config;
+        watched.enable_logging = false;
+        watched.deadline_near_miss = 1e-9f;
+        HybridNode *node = hybrid_node_create();
+        bool ok = node != NULL && hybrid_init(node, &watched) &&
+                  hybrid_set_deadline_callback(node, on_deadline, &watch) && hybrid_start(node) &&
+                  !hybrid_set_deadline_callback(node, NULL, NULL);
+        const int blocks = 32;
+        for (int b = 0; ok && b < blocks; b++) {
+            ok = hybrid_process(node, in, out, HYBRID_BUFFER_SIZE);
+        }
+        HybridNodeStatus status;
+        memset(&status, 0, sizeof(status));
+        hybrid_get_status(node, &status);
+        const HybridDeadlineHealth *health = &status.stats.deadline;
+        uint64_t charged_misses = 0, charged_near = 0;
+        for (int s = 0; s < HYBRID_STAGE_COUNT; s++) {
+            charged_misses += health->stage_misses[s];
+            charged_near += health->stage_near_misses[s];
+        }
+        const bool counted = health->near_misses + status.stats.deadline_overruns == (uint64_t)blocks &&
+                             charged_near == health->near_misses &&
+                             charged_misses == status.stats.deadline_overruns &&
+                             watch.calls == (uint32_t)blocks && watch.near == health->near_misses &&
+                             watch.budgeted && health->worst_ns > 0;
+        printf("   %llu near misses, %llu overruns, worst %.3f ms of %.3f ms\n",
+               (unsigned long long)health->near_misses, (unsigned long long)status.stats.deadline_overruns,
+               health->worst_ns * 1e-6, health->budget_ns * 1e-6);
+        hybrid_node_destroy(node);
+
+        HybridNodeConfig shed = config;
+        shed.enable_logging = false;
+        shed.enable_load_governor = true;
+        shed.governor_high_load = 1e9f;
+        shed.governor_low_load = 1e8f;
+        node = hybrid_node_create();
+        bool shed_ok = node != NULL && hybrid_init(node, &shed) && hybrid_start(node) &&
+                       hybrid_process(node, in, out, HYBRID_BUFFER_SIZE) && hybrid_request_load_shed(node) &&
+                       hybrid_process(node, in, out, HYBRID_BUFFER_SIZE);
+        hybrid_get_status(node, &status);
+        shed_ok = shed_ok && status.stats.load_level == HYBRID_LOAD_HALF_RATE;
+        hybrid_node_destroy(node);
+        if (ok && counted && shed_ok) {
+            printf("   ✓ PASS: Near misses and overruns counted, charged to stages and reported\n");
+        } else {
+            printf("   ✗ FAIL: Deadline watchdog counts, callback or load shed off\n");
+        }
+    }
+
+    selftest_step("18. Testing loopback delay and tone calibration");
+    {
+        // The correlator on a band-limited MLS a fraction of a frame late,
+        // inverted and over faint noise; then, simulated, calibrations with
+        // and without a loop of known length
+        static float z[2 * CAL_XCORR_SIZE];
+        static float chips[CAL_MLS_LENGTH];
+        uint32_t state = 1u;
+        for (size_t i = 0; i < CAL_MLS_LENGTH; i++) {
+            chips[i] = CAL_MLS_LEVEL * cal_mls_next(&state);
+        }
+        const double delay = 1234.37;
+        uint32_t seed = 4242u;
+        for (size_t n = 0; n < CAL_XCORR_SIZE; n++) {
+            double x = 0.0;
+            const long centre = (long)floor((double)n - delay);
+            for (long i = centre - 31; i <= centre + 32; i++) {
+                if (i >= 0 && i < (long)CAL_MLS_LENGTH) {
+                    const double u = (double)n - delay - (double)i;
+                    x += chips[i] * sin(M_PI * u) / (M_PI * u) * (0.5 + 0.5 * cos(M_PI * u / 32.0));
+                }
+            }
+            seed = seed * 1664525u + 1013904223u;
+            const float noise = 0.01f * ((float)(seed >> 8) / 8388608.0f - 1.0f);
+            z[2 * n] = (float)(-0.5 * x) + noise;
+            z[2 * n + 1] = n < CAL_MLS_LENGTH ? chips[n] : 0.0f;
+        }
+        // Goertzel bin of a tone off the bin grid against its amplitude and phase
+        static float tone[4410];
+        for (size_t n = 0; n < 4410; n++) {
+            tone[n] = 0.3f * (float)sin(2.0 * M_PI * 1000.0 * n / 44100.0 + 0.7);
+        }
+        float bin[2];
+        dsp_goertzel(tone, 4410, 1, 1000.0f, 44100.0f, bin);
+        const float bin_level = 2.0f * sqrtf(bin[0] * bin[0] + bin[1] * bin[1]) / 4410.0f;
+        const float bin_phase = atan2f(bin[1], bin[0]) + (float)(M_PI / 2.0);
+        printf("   Goertzel: level %.4f (true 0.3000)  phase %.4f rad (true 0.7000)\n", bin_level, bin_phase);
+        bool ok = fabsf(bin_level - 0.3f) < 1e-3f && fabsf(bin_phase - 0.7f) < 1e-3f;
+
+        float measured = 0.0f;
+        const float ratio = cal_xcorr_delay(z, CAL_XCORR_SIZE - CAL_MLS_LENGTH, &measured);
+        ok = ok && fabs(measured - delay) < 0.005 && ratio >= CAL_LOOPBACK_MIN_RATIO;
+        printf("   Correlator: %.3f frames (true %.2f)  peak ratio %.1f\n", measured, delay, ratio);
+
+#ifdef HYBRID_NODE_SIMULATION
+        const uint32_t loop_frames = 1500;
+        HybridNodeConfig looped = config;
+        looped.enable_logging = false;
+        HybridNode *node = hybrid_node_create();
+        const HybridSimConfig loop = {NULL, 0, false, CAL_TONE_FREQ, 0.5f, false, true, loop_frames};
+        CalibrationData wired, open;
+        memset(&wired, 0, sizeof(wired));
+        memset(&open, 0, sizeof(open));
+        static const float silence[HYBRID_BUFFER_SIZE * HYBRID_ADC_CHANNELS] = {0.0f};
+        const HybridSimConfig unwired = {silence, HYBRID_BUFFER_SIZE, true, CAL_TONE_FREQ, 0.5f, false};
+        ok = ok && node != NULL && hybrid_init(node, &looped) && hybrid_sim_configure(node, &loop) &&
+             hybrid_calibrate(node, &wired) && hybrid_sim_configure(node, &unwired) && hybrid_calibrate(node, &open);
+        hybrid_node_destroy(node);
+        const uint32_t expected_us = (uint32_t)lrint(loop_frames * 1e6 / looped.sample_rate);
+        printf("   Simulated loop of %u frames: %.3f frames, %u µs  peak ratio %.1f (open: %.1f)\n", loop_frames,
+               wired.loopback_delay_frames, wired.total_latency_us, wired.loopback_peak_ratio,
+               open.loopback_peak_ratio);
+        ok = ok && fabsf(wired.loopback_delay_frames - (float)loop_frames) < 0.01f &&
+             wired.total_latency_us == expected_us && open.loopback_peak_ratio < CAL_LOOPBACK_MIN_RATIO &&
+             open.loopback_delay_frames == 0.0f;
+
+        // The tone around the same loop: unity gain, the delay's phase
+        const double turns = loop_frames * CAL_TONE_FREQ / looped.sample_rate;
+        const float expected_phase = (float)(-2.0 * M_PI * (turns - floor(turns + 0.5)));
+        printf("   Tone: DAC0 gain %.4f phase %.4f rad (expected %.4f)  DAC1 gain %.4f  open DAC0 gain %.4f\n",
+               wired.dac_gain[0], wired.dac_phase[0], expected_phase, wired.dac_gain[1], open.dac_gain[0]);
+        ok = ok && fabsf(wired.dac_gain[0] - 1.0f) < 1e-3f && fabsf(wired.dac_gain[1] - 1.0f) < 1e-3f &&
+             fabsf(wired.dac_phase[0] - expected_phase) < 1e-3f && fabsf(wired.dac_offset[0]) < 1e-4f &&
+             open.dac_gain[0] == 1.0f && open.dac_phase[0] == 0.0f;
+#endif
+        if (ok) {
+            printf("   ✓ PASS: Loop delay to a fraction of a frame, tone gain and phase\n");
+        } else {
+            printf("   ✗ FAIL: Loop delay off\n");
+        }
+    }
+
+    selftest_step("19. Testing deferred log ring");
+    {
+        // Four writers against a background drainer: every record arrives
+        // once, in order per writer, and formatted as printf would
+        const unsigned writers = 4, records = 2000;
+        SelftestLogCount count = {{0, 0, 0, 0}, true, false};
+        const uint32_t dropped = firmware_log_dropped();
+        bool ok = firmware_log_start_drainer(selftest_count_log, &count, 1);
+        std::thread threads[writers];
+        for (unsigned w = 0; w < writers; w++) {
+            threads[w] = std::thread(selftest_log_writer, w, records);
+        }
+        for (unsigned w = 0; w < writers; w++) {
+            threads[w].join();
+        }
+        firmware_log_stop_drainer();
+
+        char expected[FIRMWARE_LOG_LINE_MAX];
+        char formatted[FIRMWARE_LOG_LINE_MAX] = "";
+        snprintf(expected, sizeof(expected), "%-6s|%+.3e|%05d|%x|%zu|%%|%c\n", "ring", -1234.5, 42, 0xBEEFu,
+                 (size_t)123456789, 'z');
+        firmware_log("%-6s|%+.3e|%05d|%x|%zu|%%|%c\n", "ring", -1234.5, 42, 0xBEEFu, (size_t)123456789, 'z');
+        firmware_log_drain([](uint32_t, const char *line, void *context) {
+            snprintf((char *)context, FIRMWARE_LOG_LINE_MAX, "%s", line);
+        }, formatted, 0);
+
+        for (unsigned w = 0; w < writers; w++) {
+            ok = ok && count.received[w] == records;
+        }
+        printf("   Received %u + %u + %u + %u records, %u retried on a full ring\n", count.received[0],
+               count.received[1], count.received[2], count.received[3], firmware_log_dropped() - dropped);
+        printf("   Formatted: %s", formatted);
+        if (ok && count.ordered && !count.malformed && strcmp(formatted, expected) == 0) {
+            printf("   ✓ PASS: Records arrive complete and in order, formatted by the drain\n");
+        } else {
+            printf("   ✗ FAIL: Log records lost, reordered or misformatted\n");
+        }
+    }
+
+    selftest_step("20. Testing the DSP core FFT against a reference DFT");
+    {
+        static float x[HYBRID_FFT_SIZE];
+        static float spectrum[HYBRID_FFT_SIZE + 2];
+        DspRealFft *fft = dsp_rfft_create(HYBRID_FFT_SIZE, dsp_fft_default_backend());
+        for (size_t n = 0; n < HYBRID_FFT_SIZE; n++) {
+            x[n] = 0.5f * sinf(2.0f * (float)M_PI * 37.0f * n / HYBRID_FFT_SIZE) +
+                   0.25f * cosf(2.0f * (float)M_PI * 211.0f * n / HYBRID_FFT_SIZE) + 0.1f;
+        }
+        dsp_rfft_forward(fft, x, spectrum);
+
+        double max_error = 0.0, max_magnitude = 0.0;
+        for (size_t k = 0; k <= HYBRID_FFT_SIZE / 2; k++) {
+            double re = 0.0, im = 0.0;
+            for (size_t n = 0; n < HYBRID_FFT_SIZE; n++) {
+                double angle = 2.0 * M_PI * (double)((k * n) % HYBRID_FFT_SIZE) / HYBRID_FFT_SIZE;
+                re += x[n] * cos(angle);
+                im -= x[n] * sin(angle);
+            }
+            max_error = fmax(max_error, hypot(spectrum[2 * k] - re, spectrum[2 * k + 1] - im));
+            max_magnitude = fmax(max_magnitude, hypot(re, im));
+        }
+
+        struct timespec t0, t1;
+        clock_gettime(CLOCK_MONOTONIC, &t0);
+        for (int i = 0; i < 1000; i++) {
+            dsp_rfft_forward(fft, x, spectrum);
+        }
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        dsp_rfft_destroy(fft);
+        double us = ((t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec)) / 1000.0 / 1000.0;
+        printf("   Backend: %s  Max error: %.2e of peak  %d-point FFT: %.1f µs\n",
+               dsp_fft_backend_name(dsp_fft_default_backend()), max_error / max_magnitude, HYBRID_FFT_SIZE, us);
+        if (max_error <= 1e-4 * max_magnitude) {
+            printf("   ✓ PASS: FFT matches the DFT\n");
+        } else {
+            printf("   ✗ FAIL: FFT differs from the DFT\n");
+        }
+    }
+
+    selftest_step("21. Getting firmware version");
     printf("   Version: %s\n", hybrid_node_get_version());
 
+#ifdef HYBRID_NODE_SIMULATION
+    selftest_step("22. Testing real-time simulation");
+    {
+        HybridSimReport report;
+        hybrid_node_sim_configure(NULL);
+        hybrid_node_start();
+        hybrid_node_sim_run(100, &report);
+        HybridNodeStatus status;
+        hybrid_node_get_status(&status);
+        hybrid_node_stop();
+
+        printf("   Buffers: %llu processed, %llu dropped, %llu late, %llu overruns\n",
+               (unsigned long long)report.blocks_processed, (unsigned long long)report.blocks_dropped,
+               (unsigned long long)report.deadline_misses, (unsigned long long)report.deadline_overruns);
+        printf("   CPU load: %.1f%% mean, %.1f%% peak  ring: %.0f%% peak  max latency: %u µs\n",
+               report.mean_cpu_load, report.peak_cpu_load, report.peak_buffer_utilization,
+               report.max_latency_us);
+        if (report.blocks_processed + report.blocks_dropped == report.blocks_released &&
+            status.stats.frames_dropped == report.blocks_dropped && report.mean_cpu_load > 0.0f) {
+            printf("   ✓ PASS: Every released buffer processed or counted as dropped\n");
+        } else {
+            printf("   ✗ FAIL: Simulation accounting inconsistent\n");
+        }
+        if (report.peak_cpu_load > 100.0f) {
+            printf("   ⚠ WARNING: hybrid_node_process overran its %u-frame deadline\n", HYBRID_BUFFER_SIZE);
+        }
+    }
+#endif
+
+#ifdef RASPBERRY_PI
+    selftest_step("23. Testing ALSA loop on the codec");
+    {
+        // Two seconds through the default PCM when a codec takes the
+        // configuration; hosts without one skip
+        HybridNodeConfig live = config;
+        live.enable_logging = false;
+        hybrid_node_init(&live);
+        if (!hybrid_node_alsa_open(NULL)) {
+            printf("   Skipped: no codec PCM takes %u Hz in %u periods of %u frames\n", config.sample_rate,
+                   HYBRID_ALSA_PERIODS, config.buffer_size);
+        } else {
+            HybridAlsaReport report;
+            const uint32_t periods = 2 * config.sample_rate / config.buffer_size;
+            hybrid_node_start();
+            const bool ran = hybrid_node_alsa_run(periods, &report);
+            hybrid_node_stop();
+            hybrid_node_alsa_close();
+
+            printf("   Periods: %llu  xruns: %llu  peak CPU load: %.1f%%\n",
+                   (unsigned long long)report.periods_processed, (unsigned long long)report.xruns,
+                   report.peak_cpu_load);
+            printf("   Loop latency: %u µs mean, %u µs max (SC-001: %s)\n", report.mean_loop_latency_us,
+                   report.max_loop_latency_us, report.meets_sc001 ? "PASS" : "FAIL");
+            if (ran && report.periods_processed == periods) {
+                printf("   ✓ PASS: Codec loop ran every period in place\n");
+            } else {
+                printf("   ✗ FAIL: Codec loop stopped early\n");
+            }
+        }
+        hybrid_node_init(&config);
+    }
+#endif
+
+    selftest_step("24. Testing USB audio loop against a drifting bus clock");
+    {
+        // Full speed, 1 ms packets and 48-frame buffers; the node clock
+        // runs 200 ppm fast against the SOFs, with a few µs of jitter, and
+        // the host sends what the feedback asks for. OUT and IN swap order
+        // within a frame now and then, as the stack's interrupts may.
+        HybridNodeConfig usb = config;
+        usb.interface_type = HYBRID_INTERFACE_USB;
+        usb.buffer_size = 48;
+        usb.enable_logging = false;
+        HybridNode *node = hybrid_node_create();
+        const HybridUsbConfig odd = {3, false};
+        const bool ok = node != NULL && hybrid_init(node, &usb) && !hybrid_usb_open(node, &odd) &&
+                        hybrid_usb_open(node, NULL) && hybrid_start(node);
+        const uint32_t frames_total = 8000, settle = 4000;
+        HybridUsbStats settled = {};
+        double host_phase = 0.0, sine_phase = 0.0;
+        bool packets_ok = ok;
+        for (uint32_t f = 0; ok && f < frames_total; f++) {
+            const uint32_t node_us = (uint32_t)llround(f * 1000.2 + (double)((f * 7919u) % 7) - 3.0);
+            const uint32_t feedback = hybrid_usb_sof(node, node_us);
+            host_phase += feedback / 16384.0;
+            const size_t sent = (size_t)host_phase;
+            host_phase -= (double)sent;
+
+            size_t room = 0, frames = 0;
+            const bool in_first = f % 5 == 3;
+            if (in_first) {
+                packets_ok = hybrid_usb_in_packet(node, &frames) != NULL && packets_ok;
+            }
+            HybridUsbSample *packet = hybrid_usb_out_buffer(node, &room);
+            packets_ok = packet != NULL && sent <= room && packets_ok;
+            for (size_t i = 0; packet != NULL && i < sent && i < room; i++) {
+                const float x = 0.25f * (float)sin(sine_phase);
+                sine_phase += 2.0 * M_PI * 1000.0 / HYBRID_SAMPLE_RATE;
+                for (size_t c = 0; c < usb.adc_channels; c++) {
+#ifdef HYBRID_NODE_Q31
+                    packet[i * usb.adc_channels + c] = (HybridUsbSample)lrintf(x * 2147483647.0f);
+#else
+                    packet[i * usb.adc_channels + c] = x;
+#endif
+                }
+            }
+            packets_ok = hybrid_usb_out_complete(node, sent) && packets_ok;
+            if (!in_first) {
+                packets_ok = hybrid_usb_in_packet(node, &frames) != NULL && packets_ok;
+            }
+            if (f + 1 == settle) {
+                hybrid_usb_get_stats(node, &settled);
+            }
+        }
+        HybridUsbStats stats = {};
+        hybrid_usb_get_stats(node, &stats);
+        hybrid_usb_close(node);
+        hybrid_node_destroy(node);
+
+        printf("   Packets: %llu out, %llu in  xruns: %llu under, %llu over (%llu, %llu after settling)\n",
+               (unsigned long long)stats.packets_out, (unsigned long long)stats.packets_in,
+               (unsigned long long)stats.underruns, (unsigned long long)stats.overruns,
+               (unsigned long long)(stats.underruns - settled.underruns),
+               (unsigned long long)(stats.overruns - settled.overruns));
+        printf("   Clock: %+.1f ppm  feedback: %.4f frames/ms  queue: %u frames\n", stats.clock_ppm, stats.feedback,
+               stats.queue_frames);
+        printf("   Loop latency: %u µs mean, %u µs max\n", stats.mean_loop_latency_us, stats.max_loop_latency_us);
+        if (ok && packets_ok && fabsf(stats.clock_ppm - 200.0f) < 20.0f && stats.underruns == settled.underruns &&
+            stats.overruns == settled.overruns && stats.max_loop_latency_us <= 4000) {
+            printf("   ✓ PASS: Feedback locks the host to the node clock with no xruns, within 4 ms\n");
+        } else {
+            printf("   ✗ FAIL: USB stream did not lock\n");
+        }
+    }
+
+#if defined(HYBRID_NODE_Q31) && defined(HYBRID_NODE_SIMULATION)
+    selftest_step("25. Testing SPI converter bursts");
+    {
+        // 48 kHz does not fit two conversions and four writes in a frame
+        // at 2 MHz, 32 kHz does; the tone then goes through the simulated
+        // MCP3208 and MCP4822 bursts, half by half
+        HybridNodeConfig spi = config;
+        spi.interface_type = HYBRID_INTERFACE_SPI;
+        spi.enable_logging = false;
+        HybridNode *node = hybrid_node_create();
+        const bool rejected = node != NULL && hybrid_init(node, &spi) && !hybrid_spi_open(node, NULL);
+        spi.sample_rate = 32000;
+        const HybridSimConfig tone = {NULL, 0, false, CAL_TONE_FREQ, 0.5f, true};
+        const bool ok = rejected && hybrid_init(node, &spi) && hybrid_spi_open(node, NULL) &&
+                        hybrid_sim_configure(node, &tone) && hybrid_start(node) && hybrid_spi_start(node) &&
+                        hybrid_sim_run(node, 200, NULL);
+        double sum = 0.0;
+        int32_t low = SPI_CODE_MID, high = SPI_CODE_MID;
+        size_t count = 0;
+        if (ok) {
+            const size_t frames = spi.buffer_size;
+            const unsigned half = node->spi_next_half ^ 1u;
+            const int32_t *rx = node->spi_rx + half * frames * spi.adc_channels;
+            const uint32_t *tx = node->spi_tx + half * frames * node->spi_slots * 2;
+            for (size_t i = 0; i < frames; i++) {
+                const double x = rx[i * spi.adc_channels] / 2147483648.0;
+                sum += x * x;
+                const int32_t code = (int32_t)(tx[(i * node->spi_slots + spi.adc_channels) * 2 + 1] & SPI_CODE_MASK);
+                low = code < low ? code : low;
+                high = code > high ? code : high;
+                count++;
+            }
+        }
+        HybridSpiStats stats = {};
+        hybrid_spi_get_stats(node, &stats);
+        hybrid_spi_close(node);
+        hybrid_node_destroy(node);
+
+        const double rms = count > 0 ? sqrt(sum / count) : 0.0;
+        printf("   Frame: %.1f µs (%.0f%% of the bus)  blocks: %llu  missed halves: %llu  DAC clips: %llu\n",
+               stats.frame_ns * 1e-3, stats.bus_load * 100.0f, (unsigned long long)stats.blocks,
+               (unsigned long long)stats.missed_halves, (unsigned long long)stats.dac_clips);
+        printf("   ADC rms: %.3f  DAC codes: %d..%d\n", rms, (int)low, (int)high);
+        if (ok && stats.blocks == 200 && stats.missed_halves == 0 && fabs(rms - 0.3536) < 0.01 &&
+            high - low > 1024 && stats.bus_load < 1.0f) {
+            printf("   ✓ PASS: Bursts carry the tone both ways, 48 kHz refused\n");
+        } else {
+            printf("   ✗ FAIL: SPI bursts\n");
+        }
+    }
+#endif
+
+    selftest_step("26. Testing fast boot from a boot image");
+    {
+        // Calibrated node with a clock measured 200 ppm fast; the image it
+        // leaves must bring up a node with the same tables, calibration and
+        // clock, and be refused once damaged or for another configuration
+        HybridNodeConfig boot = config;
+        boot.enable_logging = false;
+        const char *path = "/tmp/hybrid_node_selftest.boot";
+        HybridNode *cold = hybrid_node_create();
+        HybridNode *fast = hybrid_node_create();
+        HybridBootImage *image = new (std::nothrow) HybridBootImage;
+        CalibrationData cal = {};
+        const uint32_t cold_start = node_clock_us();
+        bool ok = cold != NULL && fast != NULL && image != NULL && hybrid_init(cold, &boot) &&
+                  hybrid_calibrate(cold, &cal);
+        const uint32_t cold_us = node_clock_us() - cold_start;
+        if (ok) {
+            cold->clock_ppm = 200.0;
+            cold->clock_measured = true;
+        }
+        ok = ok && hybrid_save_boot_image(cold, path) && hybrid_capture_boot_image(cold, image);
+
+        HybridBootImageStatus verdict = HYBRID_BOOT_IMAGE_MISSING;
+        const uint32_t fast_start = node_clock_us();
+        ok = ok && hybrid_init_from_file(fast, &boot, path, 3600, &verdict);
+        const uint32_t fast_us = node_clock_us() - fast_start;
+
+        // Same spectrum of a tone through both transforms, same filter
+        bool same = ok && verdict == HYBRID_BOOT_IMAGE_OK && fast->status.is_calibrated &&
+                    fast->status.recalibration_due && !cold->status.recalibration_due &&
+                    memcmp(&fast->status.calibration, &cal, sizeof(cal)) == 0 &&
+                    fast->filter_section_count == cold->filter_section_count &&
+                    memcmp(fast->filter_sections, cold->filter_sections,
+                           cold->filter_section_count * sizeof(BiquadSection)) == 0;
+        if (same) {
+            static float tone[HYBRID_FFT_SIZE], a[HYBRID_FFT_SIZE + 2], b[HYBRID_FFT_SIZE + 2];
+            for (size_t i = 0; i < HYBRID_FFT_SIZE; i++) {
+                tone[i] = sinf(2.0f * 3.14159265f * 37.0f * (float)i / HYBRID_FFT_SIZE);
+            }
+            dsp_rfft_forward(cold->fft, tone, a);
+            dsp_rfft_forward(fast->fft, tone, b);
+            same = memcmp(a, b, sizeof(a)) == 0;
+        }
+        const HybridUsbConfig full_speed = {1, false};
+        HybridNodeConfig usb = boot;
+        usb.interface_type = HYBRID_INTERFACE_USB;
+        usb.buffer_size = 48;
+        HybridNode *seeded = hybrid_node_create();
+        const bool clock = ok && seeded != NULL && hybrid_init_fast(seeded, &usb, image, sizeof(*image), 0, NULL) &&
+                           hybrid_usb_open(seeded, &full_speed) &&
+                           fabs((seeded->usb_rate / seeded->usb_nominal - 1.0) * 1e6 - 200.0) < 0.01;
+
+        // A flipped bit, another sample rate, a short read, an old image
+        HybridBootImageStatus corrupt = HYBRID_BOOT_IMAGE_OK, other = HYBRID_BOOT_IMAGE_OK;
+        HybridBootImageStatus truncated = HYBRID_BOOT_IMAGE_OK, expired = HYBRID_BOOT_IMAGE_OK;
+        if (ok) {
+            HybridNodeConfig rate = boot;
+            rate.sample_rate = 44100;
+            other = hybrid_node_check_boot_image(image, sizeof(*image), &rate, 0, 0);
+            truncated = hybrid_node_check_boot_image(image, sizeof(*image) / 2, &boot, 0, 0);
+            expired = hybrid_node_check_boot_image(image, sizeof(*image), &boot, 60, image->created + 61);
+            image->fft_twiddle[3] += 1e-6f;
+            corrupt = hybrid_node_check_boot_image(image, sizeof(*image), &boot, 0, 0);
+        }
+        remove(path);
+        hybrid_usb_close(seeded);
+        hybrid_node_destroy(seeded);
+        hybrid_node_destroy(fast);
+        hybrid_node_destroy(cold);
+        delete image;
+
+        printf("   Image: %u bytes  cold init + calibration: %u µs  fast init: %u µs\n",
+               (unsigned)sizeof(HybridBootImage), cold_us, fast_us);
+        printf("   Verdicts: saved %s, flipped bit %s, 44.1 kHz %s, half read %s, a minute old %s\n",
+               hybrid_boot_image_status_name(verdict), hybrid_boot_image_status_name(corrupt),
+               hybrid_boot_image_status_name(other), hybrid_boot_image_status_name(truncated),
+               hybrid_boot_image_status_name(expired));
+        if (ok && same && clock && corrupt == HYBRID_BOOT_IMAGE_CORRUPT && other == HYBRID_BOOT_IMAGE_CONFIG &&
+            truncated == HYBRID_BOOT_IMAGE_CORRUPT && expired == HYBRID_BOOT_IMAGE_EXPIRED) {
+            printf("   ✓ PASS: Image restores tables, calibration and clock; damaged or foreign images refused\n");
+        } else {
+            printf("   ✗ FAIL: Fast boot\n");
+        }
+    }
+
+    firmware_log_drain(NULL, NULL, 0);
     printf("\n=================================================================\n");
     printf("Self-Test Complete\n");
     printf("=================================================================\n");
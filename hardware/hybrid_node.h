@@ -5,6 +5,18 @@
  * Platform: Raspberry Pi 4/5, Teensy 4.x, or compatible ARM Cortex-A/M7
  * Dependencies: I²S/SPI ADC/DAC drivers, DSP library (CMSIS-DSP or KissFFT)
  *
+ * DSP backend, chosen at build time:
+ * - USE_CMSIS_DSP: CMSIS-DSP (arm_math.h) for the FFT, magnitudes, analog
+ *   metrics and analog filter; intended for the Teensy 4.x Cortex-M7
+ * - USE_KISSFFT: KissFFT real transform for the FFT only
+ * - neither: built-in radix-2 real FFT
+ *
+ * HYBRID_NODE_Q31 adds hybrid_process_q31(), a fixed-point path for integer
+ * I²S or SPI samples: filters, RMS/peak, FFT and CV output run on Q31 with
+ * saturating arithmetic and no float sample buffers, for Cortex-M parts
+ * whose FPU is single precision only or slow. It uses its own kernels on
+ * every backend.
+ *
  * Integrates:
  * - Analog signal acquisition via ADC (I²S or SPI)
  * - Real-time DSP: FFT, ICI, coherence analysis
@@ -29,8 +41,10 @@
 #ifndef HYBRID_NODE_H
 #define HYBRID_NODE_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include "phi_link.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +56,7 @@ extern "C" {
 #define HYBRID_FFT_SIZE         1024        // FFT analysis window
 #define HYBRID_ADC_CHANNELS     2           // Stereo input
 #define HYBRID_DAC_CHANNELS     4           // 2 audio + 2 control voltage
+#define HYBRID_DSP_RING_BLOCKS  4           // Deferred DSP hand-off depth (power of two)
 
 // Analog filter parameters (FR-002)
 #define ANALOG_HPF_CUTOFF       120.0f      // High-pass cutoff (Hz)
@@ -85,6 +100,32 @@ typedef enum {
     HYBRID_SAFETY_FAULT = 5
 } HybridSafetyStatus;
 
+// Analysis window of the STFT stage (FR-003)
+typedef enum {
+    HYBRID_WINDOW_HANN = 0,
+    HYBRID_WINDOW_BLACKMAN = 1,
+    HYBRID_WINDOW_RECTANGULAR = 2
+} HybridFFTWindow;
+
+// Path of the control voltages between control loop updates (FR-004)
+typedef enum {
+    HYBRID_CV_LINEAR = 0,          // Straight line to the new value over one update period
+    HYBRID_CV_EXPONENTIAL = 1      // One-pole glide, within 2% of the new value after one period
+} HybridCVInterpolation;
+
+/**
+ * Cellular engine run on each buffer in HYBRID_MODE_HYBRID (FR-004)
+ *
+ * Called from the audio context with the filtered first ADC channel; writes
+ * frames samples of engine output, which take that channel's place in the
+ * analysis and at the DAC (see engine_dry). The other channels pass
+ * unchanged, the reference of coherence and ICI. Must not block or
+ * allocate; input and output never overlap. A
+ * callback, so the firmware builds without the engine: the embedded profile
+ * of the D-ASE engine provides one (sase_amp_fixed/embedded_engine.h).
+ */
+typedef void (*HybridEngineProcess)(void *engine, const float *input, float *output, size_t frames);
+
 // Configuration structure
 typedef struct {
     // Interface configuration (FR-001)
@@ -93,23 +134,35 @@ typedef struct {
     uint16_t buffer_size;
     uint8_t adc_channels;
     uint8_t dac_channels;
+    uint8_t sample_bits;            // Significant bits of right-aligned integer samples on the
+                                    // Q31 path, e.g. 24 for I²S words (0: 32, full Q31)
 
     // Analog section (FR-002)
     float preamp_gain;              // Preamp gain (linear)
     float hpf_cutoff;               // High-pass filter cutoff (Hz)
     float lpf_cutoff;               // Low-pass filter cutoff (Hz)
     bool enable_analog_filter;      // Enable analog filtering
+    uint8_t filter_order;           // Butterworth order of each filter: 2, 4, 6 or 8 (0: 2)
 
     // DSP configuration (FR-003)
     uint16_t fft_size;              // FFT analysis window
     bool enable_dsp;                // Enable DSP analysis
     bool enable_coherence;          // Enable coherence calculation
     bool enable_ici;                // Enable ICI calculation
+    uint16_t fft_hop;               // Frames between analyses of the last HYBRID_FFT_SIZE
+                                    // frames (0: HYBRID_FFT_SIZE / 2, at most HYBRID_FFT_SIZE)
+    HybridFFTWindow fft_window;     // Window applied to each analysis frame
 
     // Control loop (FR-004)
     bool enable_modulation;         // Enable analog modulation
     float modulation_depth;         // Modulation depth [0, 1]
-    float control_loop_rate;        // Control update rate (Hz)
+    float control_loop_rate;        // Control updates per second, independent of the buffer
+                                    // size (0: one per buffer)
+    HybridCVInterpolation cv_interpolation; // Per-sample CV ramp between updates
+    bool enable_phi_link;           // Take phi_depth/phi_phase from phi_sensor over phi_link
+                                    // rather than from hybrid_set_control_voltage
+    uint32_t phi_link_timeout_ms;   // Link stale after this long without a frame, control
+                                    // falls back to the host's values (0: 100)
 
     // Safety configuration (FR-007)
     bool enable_voltage_clamp;      // Enable voltage limiting
@@ -119,7 +172,33 @@ typedef struct {
 
     // Operation mode
     HybridNodeMode mode;
-    bool enable_logging;            // Enable diagnostic logging
+    float engine_dry;               // Share of the filtered input mixed back next to the
+                                    // engine output in HYBRID_MODE_HYBRID [0, 1] (0: engine only)
+    bool enable_logging;            // Enable diagnostic logging, deferred through firmware_log
+                                    // and written by firmware_log_drain
+
+    // Run metrics, safety, DSP analysis and CV updates in
+    // hybrid_node_dsp_poll() instead of the DMA callback (FR-001)
+    bool defer_dsp;
+
+    // Real-time mode on Linux hosts (hybrid_node_realtime_enter)
+    bool enable_realtime;
+    uint8_t realtime_priority;      // SCHED_FIFO priority 1-99 (0: 80)
+    uint32_t realtime_cpus;         // Affinity mask of the processing thread (0: the first
+                                    // isolcpus CPU, or unchanged when none is isolated)
+
+    // Load governor: sheds spectral analysis one HybridLoadLevel at a time
+    // while the smoothed cpu_load stays above governor_high_load, and
+    // restores it below governor_low_load. Audio and CV are never shed.
+    bool enable_load_governor;
+    float governor_high_load;       // CPU load that sheds a level (%, 0: 80)
+    float governor_low_load;        // CPU load that restores a level (%, 0: 50)
+
+    // Deadline watchdog: a buffer over deadline_near_miss of its period is a
+    // near miss (HybridDeadlineHealth); with governor_on_near_miss the
+    // governor sheds a level on one as on an overrun
+    float deadline_near_miss;       // Fraction of the buffer period (0: 0.8)
+    bool governor_on_near_miss;
 } HybridNodeConfig;
 
 // Analog signal metrics (FR-002)
@@ -130,17 +209,33 @@ typedef struct {
     float thd;                      // Total harmonic distortion (%)
     float snr_db;                   // Signal-to-noise ratio (dB)
     bool is_overloaded;             // ADC overload flag
+
+    // Per ADC channel over the last buffer; the levels above combine all
+    // channels
+    float channel_rms[HYBRID_ADC_CHANNELS];
+    float channel_peak[HYBRID_ADC_CHANNELS];
+    float channel_dc[HYBRID_ADC_CHANNELS];
+    uint32_t channel_overloads[HYBRID_ADC_CHANNELS];  // Samples above SAFETY_OVERLOAD_THRESH
 } AnalogMetrics;
 
 // DSP analysis results (FR-003)
 typedef struct {
-    float ici;                      // Inter-Criticality Interval (ms)
-    float coherence;                // Phase coherence [0, 1]
+    float ici;                      // Inter-Criticality Interval: mean time between spectral flux
+                                    // peaks over the last 16 intervals (ms), 100 until measured
+    float ici_deviation;            // Standard deviation of those intervals (ms)
+    uint32_t ici_interval_count;    // Intervals in the mean (0 .. 16)
+    float coherence;                // Magnitude-squared coherence of ADC channels 0 and 1 [0, 1]:
+                                    // per bin from auto and cross spectra averaged over 0.5 s of
+                                    // analyses, power-weighted over the analyzed bins; 1 for mono
     float criticality;              // Criticality metric
     float spectral_centroid;        // Spectral centroid (Hz)
-    float spectral_flux;            // Spectral flux
+    float spectral_flux;            // Positive change of the magnitude spectrum since the previous
+                                    // analysis, as a fraction of the current one [0, 1]
+    float spectral_rolloff;         // Frequency below which 85% of the spectral magnitude lies (Hz)
+    float spectral_flatness;        // Geometric over arithmetic mean of the power spectrum [0, 1]
     float zero_crossing_rate;       // Zero-crossing rate
     uint32_t timestamp_us;          // Microsecond timestamp
+    uint32_t analysis_count;        // Spectra analyzed since start (one per analyzed hop)
 } DSPMetrics;
 
 // Control voltage output (FR-004)
@@ -170,40 +265,218 @@ typedef struct {
     // DAC calibration
     float dac_gain[HYBRID_DAC_CHANNELS];      // DAC gain correction
     float dac_offset[HYBRID_DAC_CHANNELS];    // DAC offset correction
+    float dac_phase[HYBRID_DAC_CHANNELS];     // Phase of CAL_TONE_FREQ from the DAC channel to
+                                              // the ADC channel of its index (radians, loop delay
+                                              // included; 0 where there was no loop)
 
     // Latency calibration (SC-001)
     uint32_t adc_latency_us;        // ADC latency (µs)
     uint32_t dsp_latency_us;        // DSP processing latency (µs)
     uint32_t dac_latency_us;        // DAC latency (µs)
-    uint32_t total_latency_us;      // Total loop latency (µs)
+    uint32_t total_latency_us;      // Total loop latency (µs): the loopback delay when one was
+                                    // found, else the sum of the three above
+    float loopback_delay_frames;    // DAC to ADC channel 0 delay by cross-correlation of an MLS
+                                    // (frames, to a fraction of one; 0 when none was found).
+                                    // DelayLineBuffer takes it as its delay in samples.
+    float loopback_peak_ratio;      // Correlation peak over the highest sidelobe, valid from 4
 
     // Calibration metadata
     uint32_t calibration_timestamp; // Unix timestamp of last calibration
     bool is_calibrated;             // Calibration valid flag
 } CalibrationData;
 
+// Boot image (FR-008): what hybrid_node_init_fast takes instead of
+// calibrating and building the filter and FFT tables, for flash or a file.
+// Only valid on the device and build that captured it: fields are in its
+// byte order and layout, which the version and size check.
+#define HYBRID_BOOT_IMAGE_MAGIC     0x544F4248u  // "HBOT"
+#define HYBRID_BOOT_IMAGE_VERSION   1
+#define HYBRID_BOOT_FILTER_SECTIONS 8           // Biquads of an order 8 high- and low-pass
+
+// Contents of a boot image
+#define HYBRID_BOOT_HAS_CALIBRATION 0x01        // calibration is a completed calibration
+#define HYBRID_BOOT_HAS_CLOCK       0x02        // clock_ppm was measured
+#define HYBRID_BOOT_HAS_FFT         0x04        // Built-in FFT tables
+#define HYBRID_BOOT_HAS_Q31         0x08        // Q31 FFT twiddles
+
+typedef struct {
+    uint32_t magic;                 // HYBRID_BOOT_IMAGE_MAGIC
+    uint16_t version;               // HYBRID_BOOT_IMAGE_VERSION
+    uint16_t flags;                 // HYBRID_BOOT_HAS_*
+    uint32_t size;                  // sizeof(HybridBootImage)
+    uint32_t crc;                   // CRC-32 (IEEE) of the image with this field 0
+    uint32_t created;               // Unix timestamp of the capture
+
+    // Configuration the contents belong to
+    uint32_t sample_rate;
+    uint16_t fft_size;              // HYBRID_FFT_SIZE
+    uint8_t adc_channels;
+    uint8_t dac_channels;
+    float hpf_cutoff;
+    float lpf_cutoff;
+    uint8_t filter_order;           // As hybrid_node_init rounds it
+    uint8_t filter_sections;        // Sections of filter in use
+
+    CalibrationData calibration;
+    float filter[HYBRID_BOOT_FILTER_SECTIONS][5];   // b0, b1, b2, a1, a2 of each section
+    float clock_ppm;                // Node sample clock against the USB bus SOFs (ppm)
+    float fft_twiddle[HYBRID_FFT_SIZE];             // re, im of exp(-2πik/N), k < N/2
+    uint16_t fft_bitrev[HYBRID_FFT_SIZE / 2];
+    int32_t q31_twiddle[HYBRID_FFT_SIZE];
+} HybridBootImage;
+
+// Verdict on a boot image; all but HYBRID_BOOT_IMAGE_OK boot cold
+typedef enum {
+    HYBRID_BOOT_IMAGE_OK = 0,
+    HYBRID_BOOT_IMAGE_MISSING = 1,  // No image, or shorter than its header
+    HYBRID_BOOT_IMAGE_CORRUPT = 2,  // Bad magic, size or CRC
+    HYBRID_BOOT_IMAGE_OTHER_VERSION = 3,  // Another format version
+    HYBRID_BOOT_IMAGE_CONFIG = 4,   // Another sample rate, channel count, FFT size or filter
+    HYBRID_BOOT_IMAGE_EXPIRED = 5,  // Older than the age allowed
+    HYBRID_BOOT_IMAGE_UNCALIBRATED = 6  // Captured before any calibration
+} HybridBootImageStatus;
+
+// Stages of processing a buffer, timed separately (SC-001)
+typedef enum {
+    HYBRID_STAGE_FILTER = 0,        // Analog filter bank
+    HYBRID_STAGE_METRICS = 1,       // Analog metrics and safety check
+    HYBRID_STAGE_FFT = 2,           // STFT, spectral features and ICI peak detection
+    HYBRID_STAGE_ANALYSIS = 3,      // ICI statistics and coherence
+    HYBRID_STAGE_CONTROL = 4,       // Control voltage update
+    HYBRID_STAGE_OUTPUT = 5,        // DAC frames: audio copy and CV ramps
+    HYBRID_STAGE_ENGINE = 6,        // Embedded cellular engine (hybrid_set_engine)
+    HYBRID_STAGE_COUNT = 7
+} HybridStage;
+
+// Time one stage took per buffer that ran it, since the last statistics
+// reset. Taken from the DWT cycle counter on Teensy and the raw monotonic
+// clock elsewhere; with defer_dsp the analysis stages are timed in the DSP
+// context.
+typedef struct {
+    uint32_t count;                 // Buffers timed
+    uint32_t min_ns;
+    uint32_t mean_ns;
+    uint32_t max_ns;
+} HybridStageTiming;
+
+// One buffer of the audio context, handed to the buffer observer
+// (hybrid_set_buffer_observer) at its end
+typedef struct {
+    uint64_t buffer;                        // frames_processed counting this buffer
+    uint32_t latency_ns;                    // Start of the buffer to the end of its processing
+    uint32_t budget_ns;                     // Its duration at the sample rate
+    uint32_t stage_ns[HYBRID_STAGE_COUNT];  // Indexed by HybridStage; 0 for stages it did not run, and
+                                            // for the analysis stages with defer_dsp
+    uint64_t frames_dropped;                // Node total
+    uint32_t dsp_pending;                   // Deferred blocks waiting for the DSP context
+    uint8_t load_level;                     // HybridLoadLevel in force
+    bool overrun;                           // latency_ns over budget_ns
+    bool near_miss;                         // Within budget_ns, over deadline_near_miss of it
+    bool dropped;                           // frames_dropped rose since the last record
+} HybridBufferRecord;
+
+/**
+ * Per-buffer observer, e.g. a flight recorder of buffer timings
+ *
+ * Called from the audio context at the end of every buffer, after the
+ * statistics are updated. Must not block or allocate.
+ */
+typedef void (*HybridBufferObserver)(void *context, const HybridBufferRecord *record);
+
+// Deadline health of the audio context since the last statistics reset.
+// The buffer's deadline is its period; misses are deadline_overruns. A miss
+// or near miss is charged to the longest stage of its buffer (with
+// defer_dsp, the longest audio-context stage).
+typedef struct {
+    uint32_t budget_ns;             // Period of the last buffer
+    uint32_t worst_ns;              // Longest buffer
+    uint64_t near_misses;           // Buffers within budget over deadline_near_miss of it
+    uint32_t consecutive_misses;    // Overruns in a row up to the last buffer
+    uint32_t max_consecutive_misses;
+    uint64_t stage_misses[HYBRID_STAGE_COUNT];       // Indexed by HybridStage
+    uint64_t stage_near_misses[HYBRID_STAGE_COUNT];
+} HybridDeadlineHealth;
+
+// Analysis the load governor has shed, each level adding to the one below
+typedef enum {
+    HYBRID_LOAD_FULL = 0,           // Every hop analyzed
+    HYBRID_LOAD_HALF_RATE = 1,      // Every other hop analyzed
+    HYBRID_LOAD_ALTERNATE = 2,      // ICI statistics and coherence on every other block
+    HYBRID_LOAD_PASSBAND = 3,       // Magnitudes and features only below lpf_cutoff, at most
+                                    // the lower half of the spectrum
+    HYBRID_LOAD_NO_SPECTRAL = 4,    // No spectral analysis; metrics, safety and CV only
+    HYBRID_LOAD_LEVELS = 5
+} HybridLoadLevel;
+
 // Node statistics (SC-003)
 typedef struct {
     uint64_t frames_processed;      // Total frames processed
     uint64_t frames_dropped;        // Dropped frames
     float cpu_load;                 // CPU load (%)
     float buffer_utilization;       // DMA buffer utilization (%)
+    uint64_t deadline_overruns;     // Buffers that took longer than their duration
+    uint64_t denormal_buffers;      // Buffers that underflowed into (flushed) subnormals
     uint32_t uptime_ms;             // Uptime (milliseconds)
     float drift_ppm;                // Clock drift (parts per million)
     float modulation_fidelity;      // Modulation fidelity (%) (SC-002)
+    uint8_t load_level;             // HybridLoadLevel in force (enable_load_governor)
+    float governed_load;            // Smoothed cpu_load the governor acts on (%)
+    uint32_t load_level_changes;    // Times the governor moved the level
+    uint64_t load_level_buffers[HYBRID_LOAD_LEVELS];  // Buffers processed at each level
+    HybridStageTiming stage[HYBRID_STAGE_COUNT];  // Indexed by HybridStage
+    HybridDeadlineHealth deadline;
 } NodeStatistics;
 
+// Processing latency distribution of hybrid_node_process (SC-001)
+//
+// Every processed buffer is recorded in a log-bucketed histogram (HDR
+// layout, values known to within ~3%); percentiles report the upper bound of
+// their bucket. Latencies above ~4.29 s saturate.
+typedef struct {
+    uint32_t count;                 // Buffers recorded since the last reset
+    uint32_t min_ns;                // Fastest buffer
+    uint32_t max_ns;                // Slowest buffer (exact)
+    uint32_t p50_ns;
+    uint32_t p90_ns;
+    uint32_t p99_ns;
+    uint32_t p999_ns;
+} HybridLatencyStats;
+
+// Outcome of each step of the real-time mode (enable_realtime)
+typedef struct {
+    bool memory_locked;             // mlockall of current and future pages (hybrid_init)
+    bool prefaulted;                // Node buffers and processing stack touched
+    bool sched_fifo;                // Processing thread at SCHED_FIFO realtime_priority
+    bool cpu_pinned;                // Processing thread bound to the CPUs of cpu
+    bool cpu_isolated;              // and every one of them in isolcpus
+    int32_t cpu;                    // Lowest CPU the thread is bound to, -1 if unpinned
+    int32_t error;                  // errno of the first step that failed, 0 if none
+} HybridRealtimeStatus;
+
+// On-device Φ link from phi_sensor (enable_phi_link, FR-004)
+typedef struct {
+    bool active;                    // Fresh frames are driving phi_depth and phi_phase
+    uint32_t sequence;              // Sequence of the latest frame taken
+    uint32_t frames;                // Frames taken since start
+    uint32_t stale_count;           // Times the link went stale
+    float normalized[PHI_LINK_CHANNELS];    // Latest frame [0, 1]
+} PhiLinkStatus;
+
 // Comprehensive node status (FR-009)
 typedef struct {
     HybridNodeMode mode;
     bool is_running;
     bool is_calibrated;
+    bool recalibration_due;         // Calibration came from a boot image, or there is none
+                                    // since hybrid_node_init_fast; cleared by calibrating
     AnalogMetrics analog;
     DSPMetrics dsp;
     ControlVoltage control;
+    PhiLinkStatus phi_link;
     SafetyTelemetry safety;
     CalibrationData calibration;
     NodeStatistics stats;
+    HybridRealtimeStatus realtime;
 } HybridNodeStatus;
 
 // Function prototypes
@@ -239,11 +512,92 @@ bool hybrid_node_stop(void);
  *
  * @param input ADC input buffer
  * @param output DAC output buffer
- * @param frames Number of frames to process
+ * @param frames Number of frames to process (at most HYBRID_BUFFER_SIZE)
  * @return true if processed successfully, false otherwise
  */
 bool hybrid_node_process(const float *input, float *output, size_t frames);
 
+/**
+ * Process a buffer in place in DMA-owned memory
+ *
+ * Same as hybrid_node_process without the staging copy: the analog filter
+ * runs directly on adc, which must stay owned by the caller until the call
+ * returns (the idle half of a ping-pong pair), and dac receives the output
+ * frames. adc and dac must not overlap.
+ *
+ * @param adc ADC buffer, filtered in place
+ * @param dac DAC output buffer
+ * @param frames Number of frames to process (at most HYBRID_BUFFER_SIZE)
+ * @return true if processed successfully, false otherwise
+ */
+bool hybrid_node_process_inplace(float *adc, float *dac, size_t frames);
+
+#ifdef HYBRID_NODE_Q31
+/**
+ * Process an integer audio buffer on the fixed-point path
+ *
+ * hybrid_node_process for right-aligned integer samples of sample_bits
+ * bits: the analog filter, metrics, FFT and output stage run in Q31, the
+ * audio passthrough leaves in the input format and the control voltages
+ * as codes of the same width, full scale at voltage_max. Metrics in the
+ * status are the same normalized floats as on the float path.
+ *
+ * @param input ADC input buffer
+ * @param output DAC output buffer
+ * @param frames Number of frames to process (at most HYBRID_BUFFER_SIZE)
+ * @return true if processed successfully, false otherwise
+ */
+bool hybrid_node_process_q31(const int32_t *input, int32_t *output, size_t frames);
+#endif
+
+/**
+ * Run deferred DSP analysis (defer_dsp)
+ *
+ * With defer_dsp set, hybrid_node_process only filters, writes the output
+ * with the latest control voltages and hands the block to a wait-free
+ * single-producer/single-consumer ring of HYBRID_DSP_RING_BLOCKS blocks.
+ * Call this from one lower-priority thread or task to analyze the queued
+ * blocks in order. A block that finds the ring full is counted in
+ * stats.frames_dropped and not analyzed; its audio is still output.
+ *
+ * @param max_blocks Most blocks to analyze (0 for all queued)
+ * @return Blocks analyzed
+ */
+uint32_t hybrid_node_dsp_poll(uint32_t max_blocks);
+
+/**
+ * Blocks waiting for hybrid_node_dsp_poll
+ *
+ * @return Queued blocks, 0 if defer_dsp is off
+ */
+uint32_t hybrid_node_dsp_pending(void);
+
+/**
+ * Get processing latency percentiles (SC-001)
+ *
+ * Safe to call while hybrid_node_process runs on another thread or in the
+ * DMA interrupt.
+ *
+ * @param stats Pointer to latency structure to fill
+ * @return true if statistics retrieved, false otherwise
+ */
+bool hybrid_node_get_latency(HybridLatencyStats *stats);
+
+/**
+ * Latency at quantile p of the processed buffers (SC-001)
+ *
+ * @param p Quantile in [0, 1] (0.999 for p99.9)
+ * @return Latency in nanoseconds, 0 before the first buffer
+ */
+uint32_t hybrid_node_latency_percentile(float p);
+
+/**
+ * Clear the latency histogram without stopping processing
+ *
+ * @return true if reset successful, false otherwise
+ */
+bool hybrid_node_reset_latency(void);
+
 /**
  * Set analog preamp gain (FR-002)
  *
@@ -252,9 +606,26 @@ bool hybrid_node_process(const float *input, float *output, size_t frames);
  */
 bool hybrid_node_set_preamp_gain(float gain);
 
+/**
+ * Set the analog filter band (FR-002)
+ *
+ * The filter coefficients are redesigned before the next buffer; filter
+ * state carries over.
+ *
+ * @param hpf_cutoff High-pass cutoff (Hz), 0 to disable the high-pass
+ * @param lpf_cutoff Low-pass cutoff (Hz), at or above Nyquist to disable it
+ * @param order Butterworth order of each filter: 2, 4, 6 or 8 (0 keeps the current one)
+ * @return true if set successfully, false for an invalid band or order
+ */
+bool hybrid_node_set_filter(float hpf_cutoff, float lpf_cutoff, uint8_t order);
+
 /**
  * Set control voltage output (FR-004)
  *
+ * While the node runs, the outputs ramp to the new values over one control
+ * period (control_loop_rate) starting at the next period boundary, in the
+ * shape set by cv_interpolation.
+ *
  * @param cv Control voltage structure
  * @return true if set successfully, false otherwise
  */
@@ -263,6 +634,12 @@ bool hybrid_node_set_control_voltage(const ControlVoltage *cv);
 /**
  * Get current node status (FR-009)
  *
+ * Reads seqlock-published snapshots, so it never blocks the audio callback
+ * and never returns a torn frame: processing statistics are those of the
+ * last buffer, analysis metrics, control voltages and safety those of the
+ * last analyzed block. Call it from a context that cannot preempt the audio
+ * callback or the DSP context (main loop, telemetry task, host thread).
+ *
  * @param status Pointer to status structure to fill
  * @return true if status retrieved, false otherwise
  */
@@ -271,6 +648,8 @@ bool hybrid_node_get_status(HybridNodeStatus *status);
 /**
  * Get DSP metrics (FR-003)
  *
+ * Consistent snapshot of the last analyzed block, see hybrid_node_get_status
+ *
  * @param metrics Pointer to DSP metrics structure to fill
  * @return true if metrics retrieved, false otherwise
  */
@@ -279,6 +658,8 @@ bool hybrid_node_get_dsp_metrics(DSPMetrics *metrics);
 /**
  * Get safety telemetry (FR-007)
  *
+ * Consistent snapshot of the last analyzed block, see hybrid_node_get_status
+ *
  * @param telemetry Pointer to safety telemetry structure to fill
  * @return true if telemetry retrieved, false otherwise
  */
@@ -288,7 +669,13 @@ bool hybrid_node_get_safety(SafetyTelemetry *telemetry);
  * Run calibration routine (FR-008)
  *
  * Performs automatic calibration of ADC, DAC, and latency.
- * Node must be stopped before running calibration.
+ * Node must be stopped before running calibration. For the loop delay a
+ * maximum length sequence plays on the DAC audio channels while ADC
+ * channel 0 records; wire an output back to it first (on Raspberry Pi,
+ * after hybrid_node_alsa_open). Then CAL_TONE_FREQ plays on each DAC audio
+ * channel in turn, measured on the ADC channel of the same index, for its
+ * gain, offset and phase corrections; channels without a loop keep gain 1.
+ * About 0.2 s plus 0.1-0.2 s per audio channel at 48 kHz.
  *
  * @param calibration Pointer to calibration data structure to fill
  * @return true if calibration successful, false otherwise
@@ -320,7 +707,70 @@ bool hybrid_node_save_calibration(const char *filename);
 bool hybrid_node_load_calibration_file(const char *filename);
 
 /**
- * Reset node statistics
+ * Initialize from a boot image (FR-001, FR-008)
+ *
+ * hybrid_node_init that, given a valid image for config, takes its filter
+ * coefficients, FFT tables, calibration and clock estimate instead of
+ * designing, building and measuring them, so the node can start within
+ * milliseconds. An image is valid when its magic, size, version and CRC
+ * check, it was captured after a calibration, with the same sample rate,
+ * channel counts, FFT size and filter, and it is at most max_age_s old.
+ * The age is only checked while the clock reads later than the capture,
+ * so a board without a real-time clock keeps its image.
+ *
+ * Either way recalibration_due is set in the status: the loopback
+ * calibration plays on the outputs, so it cannot run under the audio. Run
+ * hybrid_node_calibrate at the next point the node may stop and capture a
+ * new image.
+ *
+ * @param config Configuration structure
+ * @param image Boot image, NULL for none
+ * @param size Bytes at image
+ * @param max_age_s Oldest image taken in seconds (0: any age)
+ * @param verdict Receives why the image was or was not used, may be NULL
+ * @return true if initialization successful, image or not
+ */
+bool hybrid_node_init_fast(const HybridNodeConfig *config, const void *image, size_t size, uint32_t max_age_s,
+                           HybridBootImageStatus *verdict);
+
+/**
+ * hybrid_node_init_fast with the image of a file
+ *
+ * @param filename Path of a hybrid_node_save_boot_image file; a missing
+ *                 file boots cold
+ */
+bool hybrid_node_init_from_file(const HybridNodeConfig *config, const char *filename, uint32_t max_age_s,
+                                HybridBootImageStatus *verdict);
+
+/**
+ * Check a boot image against a configuration, as hybrid_node_init_fast does
+ *
+ * @param now Unix time to take the age at (0: no age check)
+ */
+HybridBootImageStatus hybrid_node_check_boot_image(const void *image, size_t size, const HybridNodeConfig *config,
+                                                   uint32_t max_age_s, uint32_t now);
+
+/**
+ * Capture the boot image of the initialized, calibrated node, for flash
+ *
+ * @param image Receives the image, CRC included
+ * @return true if captured, false if uninitialized or uncalibrated
+ */
+bool hybrid_node_capture_boot_image(HybridBootImage *image);
+
+/**
+ * Capture the boot image to a file, replaced whole: written to
+ * filename.tmp, then renamed
+ *
+ * @return true if saved, false if uncalibrated or on an I/O error
+ */
+bool hybrid_node_save_boot_image(const char *filename);
+
+/** Name of a verdict, "ok", "missing", "corrupt", ... */
+const char* hybrid_boot_image_status_name(HybridBootImageStatus status);
+
+/**
+ * Reset node statistics (including the latency histogram)
  *
  * @return true if reset successful, false otherwise
  */
@@ -334,16 +784,402 @@ bool hybrid_node_reset_statistics(void);
  */
 bool hybrid_node_set_mode(HybridNodeMode mode);
 
+/**
+ * Attach the cellular engine of HYBRID_MODE_HYBRID (FR-004)
+ *
+ * With an engine attached and the node in HYBRID_MODE_HYBRID, every float
+ * buffer runs through it after the analog filter, so the analysis and the
+ * control loop see the engine output without a round trip to the host. Its
+ * time is HYBRID_STAGE_ENGINE. The Q31 path does not run the engine.
+ *
+ * @param process Engine callback, NULL to detach
+ * @param engine Passed to process; must outlive the attachment
+ * @return true if attached, false while running
+ */
+bool hybrid_node_set_engine(HybridEngineProcess process, void *engine);
+
+/**
+ * Observe every buffer of the audio context (see HybridBufferRecord)
+ *
+ * @param observer Callback, NULL to detach
+ * @param context Passed to observer; must outlive the attachment
+ * @return true if attached, false while running
+ */
+bool hybrid_node_set_buffer_observer(HybridBufferObserver observer, void *context);
+
+/**
+ * Deadline watchdog callback: called from the audio context after every
+ * buffer that overran its period or came within deadline_near_miss of it,
+ * with the buffer's record. Must not block or allocate.
+ *
+ * @param callback Callback, NULL to detach
+ * @param context Passed to callback; must outlive the attachment
+ * @return true if attached, false while running
+ */
+bool hybrid_node_set_deadline_callback(HybridBufferObserver callback, void *context);
+
+/**
+ * Shed one load level at the next buffer, as an overrun would, e.g. when a
+ * stage outside the node misses its deadline. Safe from any context; no
+ * effect without enable_load_governor.
+ */
+bool hybrid_node_request_load_shed(void);
+
+/**
+ * HybridLoadLevel in force, as of the last buffer. Lock-free, for a stage
+ * outside the node that sheds work along with it.
+ */
+uint8_t hybrid_node_get_load_level(void);
+
 /**
  * Emergency shutdown (FR-007)
  *
  * Immediately stops all processing and clamps outputs to safe levels.
  *
- * @param reason Reason for shutdown
+ * @param reason Reason for shutdown; logged by pointer, so a string literal
+ *               or another string that outlives the log drain
  * @return true if shutdown successful, false otherwise
  */
 bool hybrid_node_emergency_shutdown(const char *reason);
 
+#ifdef HYBRID_NODE_SIMULATION
+/**
+ * Host simulation backend
+ *
+ * Built with HYBRID_NODE_SIMULATION, the ADC reads from a recorded buffer or
+ * a synthetic tone and hybrid_node_sim_run() drives hybrid_node_process at
+ * the cadence of the configured sample rate, behind a ring of
+ * HYBRID_SIM_RING_BLOCKS DMA buffers. Buffers the ring overwrites before
+ * they are processed count in frames_dropped, one per buffer like
+ * frames_processed; the ADC position advances regardless, as on hardware. The input sequence depends only on the
+ * configuration; in free-run mode which buffers get processed does too.
+ */
+#define HYBRID_SIM_RING_BLOCKS  4
+#define HYBRID_SIM_LOOPBACK_FRAMES 8192     // Frames the simulated loop holds (power of two)
+
+typedef struct {
+    const float *samples;           // Interleaved adc_channels samples, NULL for the tone
+    size_t frames;                  // Frames in samples
+    bool loop;                      // Restart samples at the end instead of reading silence
+    float tone_hz;                  // Synthetic tone frequency (Hz)
+    float tone_level;               // Synthetic tone amplitude
+    bool free_run;                  // Process buffers back to back, without pacing or drops
+    bool loopback;                  // ADC reads back the DAC audio channels instead, as through
+                                    // a cable from each output to the same input
+    uint32_t loopback_frames;       // Delay of that loop (frames, at most
+                                    // HYBRID_SIM_LOOPBACK_FRAMES - HYBRID_BUFFER_SIZE)
+} HybridSimConfig;
+
+typedef struct {
+    uint64_t blocks_released;       // Buffers the simulated ADC clock delivered
+    uint64_t blocks_processed;
+    uint64_t blocks_dropped;        // Overwritten in the ring before processing
+    uint64_t deadline_misses;       // Finished after the next buffer was due
+    uint64_t deadline_overruns;     // Processing alone took longer than a buffer
+    uint32_t max_latency_us;        // Slowest hybrid_node_process call
+    float mean_cpu_load;            // Processing time over buffer duration (%)
+    float peak_cpu_load;
+    float peak_buffer_utilization;  // Fullest the ring got (%)
+} HybridSimReport;
+
+/**
+ * Select the simulated ADC input; resets the read position
+ *
+ * @param config Simulation configuration (NULL for a 1 kHz tone at 0.5)
+ * @return true if configured, false if samples is set without frames or
+ *         the loopback delay is too long
+ */
+bool hybrid_node_sim_configure(const HybridSimConfig *config);
+
+/**
+ * Run the real-time loop for a number of buffers
+ *
+ * The node must be started. Processing statistics (cpu_load,
+ * buffer_utilization, frames_dropped, deadline_overruns) are updated as on
+ * hardware.
+ *
+ * @param blocks Buffers the ADC clock releases
+ * @param report Pointer to store the run summary (may be NULL)
+ * @return true if the run completed, false if the node is not running
+ */
+bool hybrid_node_sim_run(uint32_t blocks, HybridSimReport *report);
+#endif
+
+#ifdef RASPBERRY_PI
+/**
+ * ALSA backend of the I²S codec (Raspberry Pi)
+ *
+ * hybrid_node_alsa_open() sets up the capture and playback PCMs for mmap
+ * access, one period per buffer, and hybrid_node_alsa_run() drives the
+ * ADC→DSP→DAC loop on them: each captured period is processed in place in
+ * the capture ring and written straight into the playback ring, with no
+ * copies. Playback starts a full ring ahead, so the loop latency is about
+ * periods × period_frames frames plus the processing time; more periods
+ * survive longer stalls at one period of latency each.
+ *
+ * With HYBRID_NODE_Q31 the PCMs run S32_LE, whose left-justified words are
+ * Q31 as they are (sample_bits does not apply); otherwise FLOAT_LE, which
+ * usually takes a plug device. The playback PCM carries dac_channels
+ * channels, the control voltages included. An xrun restarts both streams
+ * and counts one buffer in frames_dropped.
+ */
+#define HYBRID_ALSA_PERIODS     2           // Default periods per ring
+
+typedef struct {
+    const char *capture_device;     // ADC PCM, NULL for "hw:0" (Q31) or "plughw:0" (float)
+    const char *playback_device;    // DAC PCM, NULL for the capture device
+    uint16_t period_frames;         // Frames per period (0: buffer_size), at most HYBRID_BUFFER_SIZE
+    uint8_t periods;                // Periods per ring (0: HYBRID_ALSA_PERIODS), at least 2
+} HybridAlsaConfig;
+
+typedef struct {
+    uint64_t periods_processed;
+    uint64_t xruns;                 // Overruns and underruns, each restarting the streams
+    uint32_t max_loop_latency_us;   // Oldest input frame of a period to its output,
+    uint32_t mean_loop_latency_us;  // from the ring delays and the processing time
+    float peak_cpu_load;
+    bool meets_sc001;               // Every period within 2 ms (SC-001)
+} HybridAlsaReport;
+
+/**
+ * Open and configure the codec PCMs; the node must be initialized and
+ * stopped. Reopening closes the previous streams first.
+ *
+ * @param config Devices and ring shape (NULL for the defaults)
+ * @return true if both streams took the configuration exactly
+ */
+bool hybrid_node_alsa_open(const HybridAlsaConfig *config);
+
+/**
+ * Run the real-time loop for a number of periods
+ *
+ * The node must be started and the PCMs open. Statistics are updated as
+ * for hybrid_node_process, with buffer_utilization the capture ring fill.
+ *
+ * @param periods Periods to process
+ * @param report Pointer to store the run summary (may be NULL)
+ * @return true if the run completed, false if not running or the streams failed
+ */
+bool hybrid_node_alsa_run(uint32_t periods, HybridAlsaReport *report);
+
+/**
+ * Stop and close the codec PCMs
+ */
+void hybrid_node_alsa_close(void);
+#endif
+
+/**
+ * USB Audio Class 2.0 backend, asynchronous mode (HYBRID_INTERFACE_USB)
+ *
+ * The node is a UAC2 device: the host's playback reaches it through an
+ * isochronous OUT endpoint as the ADC input, and the node's DAC frames go
+ * back through an isochronous IN endpoint, control voltages included. The
+ * USB device stack (TinyUSB or the Teensy core on targets, a gadget driver
+ * elsewhere) moves the packets; the node owns their buffers:
+ *
+ * - OUT packets are received straight into the node's input buffer at
+ *   hybrid_node_usb_out_buffer(); hybrid_node_usb_out_complete() processes
+ *   every buffer_size frames in place, into the IN queue.
+ * - Each service interval, hybrid_node_usb_in_packet() hands the stack the
+ *   next IN packet in the queue, sized by the node's own clock.
+ * - At each SOF (each frame, or microframe at high speed),
+ *   hybrid_node_usb_sof() measures the node clock against the bus and
+ *   returns the feedback value for the explicit feedback endpoint: the
+ *   frames per (micro)frame the node consumes, trimmed to hold the IN queue
+ *   at one buffer plus one packet, so the host sends at the node's rate.
+ *
+ * The round trip is the buffer filling plus the queue, about two buffers
+ * and a packet: 3 ms at 48 kHz with 48-frame buffers and a 1 ms
+ * interval, against several periods of I²S DMA and host buffering. Small
+ * buffers are the point; buffer_size equal to the packet frames suits.
+ * An IN packet with too little processed is sent as silence and counted
+ * as an underrun until the queue is primed again; a buffer with no room
+ * in the queue is dropped as an overrun; both count a buffer in
+ * frames_dropped.
+ *
+ * With HYBRID_NODE_Q31 the endpoints carry 32-bit PCM, whose words are
+ * Q31 as they are (sample_bits does not apply); otherwise 32-bit IEEE
+ * float (UAC2 format type I, IEEE_FLOAT). The packet calls are for the
+ * USB stack's context, one at a time; hybrid_node_usb_get_stats is safe
+ * from any.
+ */
+#define HYBRID_USB_INTERVAL_MS  1           // Default service interval (ms)
+
+#ifdef HYBRID_NODE_Q31
+typedef int32_t HybridUsbSample;
+#else
+typedef float HybridUsbSample;
+#endif
+
+typedef struct {
+    uint8_t service_interval_ms;    // Packet interval of both endpoints: 1, 2, 4 or 8 ms
+                                    // (0: HYBRID_USB_INTERVAL_MS)
+    bool high_speed;                // USB 2.0 high speed: SOF per 125 µs microframe and 16.16
+                                    // feedback; full speed: per 1 ms frame and 10.14
+} HybridUsbConfig;
+
+typedef struct {
+    uint64_t packets_out;           // OUT packets received (host to node)
+    uint64_t packets_in;            // IN packets sent (node to host), silence included
+    uint64_t overruns;              // Buffers dropped, no room in the IN queue
+    uint64_t underruns;             // IN packets sent as silence, too little processed
+    float feedback;                 // Last feedback value (frames per frame or microframe)
+    float clock_ppm;                // Node sample clock against the bus SOFs (ppm)
+    uint32_t queue_frames;          // Processed frames waiting for IN packets
+    uint32_t max_loop_latency_us;   // Oldest OUT frame of a buffer to its IN packet,
+    uint32_t mean_loop_latency_us;  // from the queue ahead of it and the processing time
+} HybridUsbStats;
+
+/**
+ * Allocate the packet buffers; the node must be initialized with
+ * HYBRID_INTERFACE_USB and stopped. Reopening starts a new stream.
+ *
+ * @param config Service interval and bus speed (NULL for the defaults)
+ * @return true if open, false on a bad interval, interface or out of memory
+ */
+bool hybrid_node_usb_open(const HybridUsbConfig *config);
+
+/**
+ * Buffer the next OUT packet is received into, interleaved adc_channels
+ * samples per frame
+ *
+ * @param max_frames Pointer to store the room, at least one packet
+ * @return Packet buffer, or NULL if not open
+ */
+HybridUsbSample* hybrid_node_usb_out_buffer(size_t *max_frames);
+
+/**
+ * An OUT packet arrived in the buffer from hybrid_node_usb_out_buffer;
+ * processes each complete buffer while the node runs
+ *
+ * @param frames Frames received, at most max_frames
+ * @return true if taken, false if not open, not running or too long
+ */
+bool hybrid_node_usb_out_complete(size_t frames);
+
+/**
+ * Next IN packet, interleaved dac_channels samples per frame; valid until
+ * the next call
+ *
+ * @param frames Pointer to store the frames in the packet
+ * @return Packet, or NULL if not open
+ */
+const HybridUsbSample* hybrid_node_usb_in_packet(size_t *frames);
+
+/**
+ * Start of a bus frame (microframe at high speed)
+ *
+ * @param node_us Node clock at the SOF (µs, wrapping), e.g. micros()
+ * @return Feedback endpoint value: frames per (micro)frame in 10.14 (full
+ *         speed) or 16.16 (high speed), 0 if not open
+ */
+uint32_t hybrid_node_usb_sof(uint32_t node_us);
+
+/**
+ * @param stats Pointer to store the stream counters
+ * @return true if open
+ */
+bool hybrid_node_usb_get_stats(HybridUsbStats *stats);
+
+/**
+ * Free the packet buffers
+ */
+void hybrid_node_usb_close(void);
+
+#ifdef HYBRID_NODE_Q31
+/**
+ * SPI converter backend (HYBRID_INTERFACE_SPI): an MCP3208 ADC and one
+ * MCP4822 dual DAC per two DAC channels, on one SPI bus, Q31 builds
+ *
+ * A sample timer paces the bus: each tick starts one DMA minor loop that
+ * pushes the frame's transfers into the SPI FIFO, each a command word
+ * (chip select, frame length, clock prescale) and a data word, so the
+ * peripheral drives every chip select itself: adc_channels 19-clock
+ * conversions on the MCP3208, then a 16-bit write to each DAC channel.
+ * A second DMA channel collects the conversions. Both run circularly over
+ * two halves of buffer_size frames; at each half the interrupt calls
+ * hybrid_node_spi_dma_half(), which turns the 12-bit codes into Q31 in
+ * place, runs the Q31 path and writes the DAC codes into the data words
+ * of the half just sent, to go out on the next lap. The loop latency is
+ * two buffers.
+ *
+ * The bus time of a frame has to fit a sample period. The MCP3208 takes
+ * at most 2 MHz at 5 V, its transfers run at the bus clock divided by a
+ * power of two, so with the default 16 MHz two ADC and four DAC channels
+ * fit up to about 38 kHz, one ADC channel up to about 62 kHz;
+ * hybrid_node_spi_open refuses what does not fit. ADC codes are offset
+ * binary around mid-scale (a front end biased to Vref / 2); the audio DAC
+ * channels are too, the control voltage channels run from 0 at code 0 to
+ * voltage_max at full scale. hybrid_node_spi_open sets sample_bits to 12.
+ */
+#define HYBRID_SPI_CLOCK_HZ     16000000    // Default bus clock, divides to the MCP3208's 2 MHz
+#define HYBRID_SPI_ADC_CLOCK_HZ 2000000     // MCP3208 limit at 5 V
+
+typedef struct {
+    uint8_t adc_cs;                             // Chip select (PCS 0-3) of the MCP3208
+    uint8_t dac_cs[HYBRID_DAC_CHANNELS / 2];    // of the MCP4822 of DAC channels 0-1, 2-3
+    uint8_t adc_inputs[HYBRID_ADC_CHANNELS];    // MCP3208 input (0-7) of each ADC channel
+    uint32_t clock_hz;                          // Bus clock of the DACs (0: HYBRID_SPI_CLOCK_HZ)
+    uint32_t adc_clock_hz;                      // Fastest MCP3208 clock (0: HYBRID_SPI_ADC_CLOCK_HZ)
+    bool dac_gain_2x;                           // MCP4822 at 2 × 2.048 V full scale
+} HybridSpiConfig;
+
+typedef struct {
+    uint64_t blocks;                // Halves processed
+    uint64_t missed_halves;         // Halves the DMA completed before the last was processed
+    uint64_t dac_clips;             // DAC codes clamped to the 12-bit range
+    uint32_t frame_ns;              // Bus time of one frame, chip select gaps included
+    float bus_load;                 // frame_ns over the sample period
+} HybridSpiStats;
+
+/**
+ * Build the transfer tables and allocate the DMA halves; the node must be
+ * initialized with HYBRID_INTERFACE_SPI and stopped
+ *
+ * @param config Chip selects, inputs and clocks (NULL: ADC on PCS 0,
+ *        inputs 0 and 1, DACs on PCS 1 and 2, default clocks)
+ * @return true if open, false on a bad chip select or input, a frame that
+ *         does not fit the sample period, or out of memory
+ */
+bool hybrid_node_spi_open(const HybridSpiConfig *config);
+
+/**
+ * Start the sample timer and the DMA; the node must be started
+ */
+bool hybrid_node_spi_start(void);
+
+/**
+ * DMA interrupt: half 0 or 1 of the transfers has completed
+ */
+void hybrid_node_spi_dma_half(unsigned half);
+
+bool hybrid_node_spi_get_stats(HybridSpiStats *stats);
+
+/**
+ * Stop the timer and the DMA
+ */
+void hybrid_node_spi_stop(void);
+
+/**
+ * Stop and free the transfer tables
+ */
+void hybrid_node_spi_close(void);
+#endif
+
+/**
+ * Put the calling thread, the one that runs hybrid_node_process, in
+ * real-time mode: SCHED_FIFO at realtime_priority, bound to realtime_cpus
+ * and its stack prefaulted. Memory is locked and the node prefaulted by
+ * hybrid_node_init already. hybrid_node_alsa_run and hybrid_node_sim_run
+ * call this themselves when enable_realtime is set; the thread keeps the
+ * settings afterwards. Linux only; SCHED_FIFO and mlockall need
+ * CAP_SYS_NICE and CAP_IPC_LOCK or matching rlimits.
+ *
+ * @return true if every step succeeded; the status realtime field says
+ *         which did
+ */
+bool hybrid_node_realtime_enter(void);
+
 /**
  * Get firmware version
  *
@@ -351,6 +1187,101 @@ bool hybrid_node_emergency_shutdown(const char *reason);
  */
 const char* hybrid_node_get_version(void);
 
+//==============================================================================
+// Node instances
+//
+// The hybrid_node_* functions above drive one default node. A process that
+// runs several nodes, typically one per core on its own ADC pair, creates
+// them with hybrid_node_create() and uses the hybrid_* functions below,
+// which take the node first and otherwise behave like their hybrid_node_*
+// counterparts. Nodes share no mutable state, so calls on different nodes
+// never contend; the calls on one node follow the same context rules as
+// the default node. A NULL node fails like the other NULL arguments.
+//==============================================================================
+
+typedef struct HybridNode HybridNode;
+
+/**
+ * Create a node, uninitialized; configure it with hybrid_init()
+ *
+ * @return New node, or NULL if out of memory
+ */
+HybridNode* hybrid_node_create(void);
+
+/**
+ * Stop and free a node from hybrid_node_create(); NULL and the default
+ * node are ignored
+ */
+void hybrid_node_destroy(HybridNode *node);
+
+/**
+ * Node behind the hybrid_node_* functions
+ */
+HybridNode* hybrid_node_default(void);
+
+bool hybrid_init(HybridNode *node, const HybridNodeConfig *config);
+bool hybrid_start(HybridNode *node);
+bool hybrid_stop(HybridNode *node);
+bool hybrid_process(HybridNode *node, const float *input, float *output, size_t frames);
+bool hybrid_process_inplace(HybridNode *node, float *adc, float *dac, size_t frames);
+#ifdef HYBRID_NODE_Q31
+bool hybrid_process_q31(HybridNode *node, const int32_t *input, int32_t *output, size_t frames);
+#endif
+uint32_t hybrid_dsp_poll(HybridNode *node, uint32_t max_blocks);
+uint32_t hybrid_dsp_pending(HybridNode *node);
+bool hybrid_get_latency(HybridNode *node, HybridLatencyStats *stats);
+uint32_t hybrid_latency_percentile(HybridNode *node, float p);
+bool hybrid_reset_latency(HybridNode *node);
+bool hybrid_set_preamp_gain(HybridNode *node, float gain);
+bool hybrid_set_filter(HybridNode *node, float hpf_cutoff, float lpf_cutoff, uint8_t order);
+bool hybrid_set_control_voltage(HybridNode *node, const ControlVoltage *cv);
+bool hybrid_get_status(HybridNode *node, HybridNodeStatus *status);
+bool hybrid_get_dsp_metrics(HybridNode *node, DSPMetrics *metrics);
+bool hybrid_get_safety(HybridNode *node, SafetyTelemetry *telemetry);
+bool hybrid_calibrate(HybridNode *node, CalibrationData *calibration);
+bool hybrid_load_calibration(HybridNode *node, const CalibrationData *calibration);
+bool hybrid_save_calibration(HybridNode *node, const char *filename);
+bool hybrid_load_calibration_file(HybridNode *node, const char *filename);
+bool hybrid_init_fast(HybridNode *node, const HybridNodeConfig *config, const void *image, size_t size,
+                      uint32_t max_age_s, HybridBootImageStatus *verdict);
+bool hybrid_init_from_file(HybridNode *node, const HybridNodeConfig *config, const char *filename,
+                           uint32_t max_age_s, HybridBootImageStatus *verdict);
+bool hybrid_capture_boot_image(HybridNode *node, HybridBootImage *image);
+bool hybrid_save_boot_image(HybridNode *node, const char *filename);
+bool hybrid_reset_statistics(HybridNode *node);
+bool hybrid_set_mode(HybridNode *node, HybridNodeMode mode);
+bool hybrid_set_engine(HybridNode *node, HybridEngineProcess process, void *engine);
+bool hybrid_set_buffer_observer(HybridNode *node, HybridBufferObserver observer, void *context);
+bool hybrid_set_deadline_callback(HybridNode *node, HybridBufferObserver callback, void *context);
+bool hybrid_request_load_shed(HybridNode *node);
+uint8_t hybrid_get_load_level(HybridNode *node);
+bool hybrid_emergency_shutdown(HybridNode *node, const char *reason);
+bool hybrid_realtime_enter(HybridNode *node);
+#ifdef HYBRID_NODE_SIMULATION
+bool hybrid_sim_configure(HybridNode *node, const HybridSimConfig *config);
+bool hybrid_sim_run(HybridNode *node, uint32_t blocks, HybridSimReport *report);
+#endif
+#ifdef RASPBERRY_PI
+bool hybrid_alsa_open(HybridNode *node, const HybridAlsaConfig *config);
+bool hybrid_alsa_run(HybridNode *node, uint32_t periods, HybridAlsaReport *report);
+void hybrid_alsa_close(HybridNode *node);
+#endif
+bool hybrid_usb_open(HybridNode *node, const HybridUsbConfig *config);
+HybridUsbSample* hybrid_usb_out_buffer(HybridNode *node, size_t *max_frames);
+bool hybrid_usb_out_complete(HybridNode *node, size_t frames);
+const HybridUsbSample* hybrid_usb_in_packet(HybridNode *node, size_t *frames);
+uint32_t hybrid_usb_sof(HybridNode *node, uint32_t node_us);
+bool hybrid_usb_get_stats(HybridNode *node, HybridUsbStats *stats);
+void hybrid_usb_close(HybridNode *node);
+#ifdef HYBRID_NODE_Q31
+bool hybrid_spi_open(HybridNode *node, const HybridSpiConfig *config);
+bool hybrid_spi_start(HybridNode *node);
+void hybrid_spi_dma_half(HybridNode *node, unsigned half);
+bool hybrid_spi_get_stats(HybridNode *node, HybridSpiStats *stats);
+void hybrid_spi_stop(HybridNode *node);
+void hybrid_spi_close(HybridNode *node);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -7,11 +7,38 @@
  *
  * Note: This is a reference implementation. Actual hardware-specific
  * code will depend on the target platform's I²S and DMA drivers.
+ *
+ * Building with I2S_BRIDGE_LOOPBACK on a host without I²S hardware turns
+ * the bridge into a software loopback: every transmitted frame is what the
+ * next receive returns, so the encode/decode path can be exercised and
+ * timed off-target.
  */
 
 #include "i2s_bridge.h"
+#include "firmware_log.h"
 #include <string.h>
 #include <stdio.h>
+#include <math.h>
+#include <time.h>
+#include <stdlib.h>
+#include <atomic>
+#include <new>
+#ifndef TEENSY
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#endif
+
+// UDP telemetry forwarding (sendmmsg) on Linux hosts
+#if !defined(TEENSY) && defined(__linux__)
+#define I2S_BRIDGE_FORWARDING
+#include <thread>
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
 
 // Platform-specific includes (conditionally compiled)
 #ifdef TEENSY
@@ -23,442 +50,2788 @@
     #include <wiringPiI2C.h>
 #endif
 
-// Global state
-static I2SBridgeConfig g_config;
-static I2SStatistics g_stats;
-static bool g_initialized = false;
-static bool g_running = false;
+// Wire format pack/unpack kernels
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #if defined(__SSSE3__)
+        #include <tmmintrin.h>
+    #endif
+#endif
 
-// DMA buffers (FR-004)
-static int32_t g_tx_buffer[I2S_BUFFER_SIZE * I2S_CHANNELS];
-static int32_t g_rx_buffer[I2S_BUFFER_SIZE * I2S_CHANNELS];
+// Drift DLL (FR-005): second-order delay-locked loop on the sync pulse
+// times, run in the pulse interrupt. The predicted time of the next pulse
+// is a whole µs count plus a fraction; the loop filter tracks how far the
+// period of the remote clock, seen by the local one, is off nominal. Both
+// stay small so single-precision updates do not round away.
+#define DLL_NOMINAL_PERIOD_US   (1000000.0f / GPIO_SYNC_FREQ_HZ)
+#define DLL_BANDWIDTH_HZ        0.1f        // ~10 s settling
+#define DLL_MAX_ERROR_US        (DLL_NOMINAL_PERIOD_US / 4)  // Beyond it, a pulse was missed
+
+// RX resampler (FR-005): polyphase windowed sinc, coefficients
+// interpolated linearly between phases. The DMA interrupt appends the
+// audio channels of every received half to a ring; the receive functions
+// read it at the local pace, stepping 1 + drift input frames per output
+// frame. A slow servo on the ring fill absorbs what the estimate misses,
+// so the fill stays bounded without dropping or repeating frames.
+#define ASRC_TAPS               16
+#define ASRC_PHASES             64
+#define ASRC_HISTORY            (ASRC_TAPS / 2 - 1)     // Frames left of the read position
+#define ASRC_RING_FRAMES        2048        // Power of two
+#define ASRC_TARGET_FILL        (2 * I2S_BUFFER_SIZE + I2S_BUFFER_SIZE / 4)  // Ahead of the read position
+#define ASRC_MAX_PPM            1000.0      // Correction clamp
+#define ASRC_CUTOFF             0.45f       // Of the sample rate
+static float g_asrc_coeffs[ASRC_PHASES + 1][ASRC_TAPS];  // Shared, read-only once built
+
+// Link health (SC-003): a link is degraded when no DMA half has completed
+// for HEALTH_LATE_HALVES periods or more than HEALTH_DEGRADED_CRC of the
+// packets of the last window failed their CRC, and fails over after
+// HEALTH_WATCHDOG_HALVES periods (about 53 ms) or above HEALTH_FAILED_CRC
+#define HEALTH_HALF_MS          ((float)I2S_BUFFER_SIZE * 1000.0f / I2S_SAMPLE_RATE)
+#define HEALTH_LATE_HALVES      2
+#define HEALTH_WATCHDOG_HALVES  5
+#define HEALTH_WINDOW_MS        100
+#define HEALTH_DEGRADED_CRC     0.01f
+#define HEALTH_FAILED_CRC       0.25f
+
+// Loopback self-test (FR-010)
+#define SELF_TEST_ROUNDS        100
+#define SELF_TEST_TIMEOUT_MS    100
+
+// Serial diagnostic queues (FR-006), in lines (powers of two)
+#define DIAG_TX_LINES           32
+#define DIAG_RX_LINES           8
+#define DIAG_TX_MASK            (DIAG_TX_LINES - 1)
+#define DIAG_RX_MASK            (DIAG_RX_LINES - 1)
+static_assert((DIAG_TX_LINES & DIAG_TX_MASK) == 0 && (DIAG_RX_LINES & DIAG_RX_MASK) == 0,
+              "diagnostic queues must be powers of two");
+
+// One queued diagnostic line. TX lines are claimed and published through
+// sequence as firmware_log's records (any number of senders, one drain);
+// RX lines are a single-producer queue and leave it unused.
+struct I2SDiagLine {
+    std::atomic<uint32_t> sequence{0};
+    uint16_t length = 0;                    // Including the newline of a TX line
+    char text[I2S_DIAGNOSTIC_LINE_MAX];
+};
+
+struct I2SForwarder;
+
+// Everything one link owns. Links share only the resampler coefficients;
+// the links of a group also share its aggregate buffers and the drift
+// estimate of its leader.
+struct I2SBridge {
+    I2SBridgeConfig config = {};
+    I2SStatistics stats = {};
+    bool initialized = false;
+    bool running = false;
+
+    // Receiver sequence tracking (SC-002)
+    uint32_t rx_next_sequence = 0;
+    bool rx_sequence_valid = false;
+
+    // Circular DMA buffers (FR-004): the DMA runs through half 0, then half
+    // 1, and interrupts after each. The CPU fills and reads the half the
+    // DMA just left, in place. The TX masks hold one bit per half; received
+    // halves form a single-producer queue whose entry k is half k & 1, fed
+    // by the interrupt through rx_produced. The rest is touched by the
+    // caller only. The halves are the link's own buffers or its view of a
+    // group's: frame i of a half starts stride samples after frame i - 1.
+    int32_t own_tx[2][I2S_BUFFER_SIZE * I2S_CHANNELS];
+    int32_t own_rx[2][I2S_BUFFER_SIZE * I2S_CHANNELS];
+    int32_t *tx[2] = {own_tx[0], own_tx[1]};
+    int32_t *rx[2] = {own_rx[0], own_rx[1]};
+    size_t stride = I2S_CHANNELS;
+    I2SBridgeGroup *group = NULL;
+    size_t group_index = 0;                 // Link number in the group
+    std::atomic<uint8_t> tx_free{0};        // TX halves the CPU may fill
+    std::atomic<uint8_t> tx_ready{0};       // Committed, not yet sent
+    std::atomic<uint32_t> rx_produced{0};   // RX halves completed by the DMA
+    uint32_t rx_consumed = 0;               // RX halves the caller has read
+    uint8_t tx_next = 0;                    // Half acquire_tx hands out next
+    int tx_acquired = -1;                   // Half the caller is filling
+    int rx_acquired = -1;                   // Half the caller is reading
+    I2SBufferCallback buffer_callback = NULL;
+    void *buffer_context = NULL;
+
+#ifndef TEENSY
+    // Wakes i2s_wait_rx; host completions run in thread context
+    std::mutex rx_mutex;
+    std::condition_variable rx_signal;
+#endif
 
-// GPIO sync state (FR-005)
+    // Drift DLL (FR-005)
+    bool dll_locked = false;
+    uint32_t dll_next_us = 0;
+    float dll_next_frac = 0.0f;
+    float dll_period_offset_us = 0.0f;
+    std::atomic<float> drift_ppm{0.0f};     // Remote clock rate against ours
+
+    // RX resampler (FR-005), the ring allocated by init when enabled
+    float (*asrc_ring)[I2S_AUDIO_CHANNELS] = NULL;   // ASRC_RING_FRAMES frames
+    std::atomic<uint32_t> asrc_write{0};        // Frames appended, by the interrupt
+    std::atomic<uint32_t> asrc_push_ticks{0};   // When the last half was appended
+    std::atomic<uint32_t> asrc_oldest{0};       // Oldest frame the reader still needs
+    uint32_t asrc_read = 0;                     // Read position, whole frames
+    double asrc_frac = 0.0;                     // and fraction
+    double asrc_step = 1.0;
+    bool asrc_primed = false;
+
+    // Arrival tick of each RX half, written by the DMA interrupt
+    uint32_t rx_capture_ticks[2];
+
+    // Loopback self-test round trips; a round holds no frame on the stack
+    float self_test_rtt_ns[SELF_TEST_ROUNDS];
+
+    // UDP forwarding of decoded packets, set while the bridge is stopped
+    I2SForwarder *forwarder = NULL;
+
+    // Serial diagnostics (FR-006): senders queue lines from any context,
+    // i2s_service_diagnostics moves them to and from the port without
+    // waiting. The drain side is owned by whoever holds diag_servicing.
+    I2SDiagLine diag_tx[DIAG_TX_LINES];
+    std::atomic<uint32_t> diag_tx_head{0};  // Lines claimed by senders
+    uint32_t diag_tx_tail = 0;              // Lines written out
+    size_t diag_tx_offset = 0;              // Bytes of the tail line already written
+    I2SDiagLine diag_rx[DIAG_RX_LINES];
+    std::atomic<uint32_t> diag_rx_write{0}; // Lines received, by the service
+    std::atomic<uint32_t> diag_rx_read{0};  // Lines taken by the reader
+    char diag_rx_partial[I2S_DIAGNOSTIC_LINE_MAX];  // Line being received
+    size_t diag_rx_length = 0;
+    std::atomic<uint32_t> diag_dropped{0};
+    std::atomic_flag diag_servicing = ATOMIC_FLAG_INIT;
+
+    // Link health (SC-003), kept by i2s_check_link
+    int standby_port = -1;                  // Pre-initialized spare port, -1 for none
+    uint32_t health_produced = 0;           // rx_produced when last seen moving
+    uint32_t health_last_ms = 0;            // and when
+    uint32_t health_window_ms = 0;          // Start of the CRC error window
+    uint64_t health_received = 0;           // packets_received and packets_corrupt
+    uint64_t health_corrupt = 0;            // at its start
+    bool relocking = false;                 // Failed over, no half back yet
+    uint32_t outage_start_ms = 0;           // Last half before the failure
+
+    // Φ sideband (FR-003). TX: the points staged for the next commit and
+    // the last point sent, quantized as on the wire. RX: the last half's
+    // trajectory at audio rate and the point it ended on.
+    uint16_t phi_tx_phase[I2S_PHI_SIDEBAND_MAX_POINTS];
+    uint16_t phi_tx_depth[I2S_PHI_SIDEBAND_MAX_POINTS];
+    bool phi_tx_staged = false;
+    uint16_t phi_tx_last_phase = 0;
+    uint16_t phi_tx_last_depth = 0;
+    uint32_t phi_tx_sequence = 0;
+    float phi_rx_phase[I2S_BUFFER_SIZE];
+    float phi_rx_depth[I2S_BUFFER_SIZE];
+    uint16_t phi_rx_last_phase = 0;
+    uint16_t phi_rx_last_depth = 0;
+    bool phi_rx_primed = false;             // A block was received since init
+    bool phi_rx_intact = false;             // and the last half held one
+    uint32_t phi_rx_next_sequence = 0;
+};
+
+// Links aggregated into one interleaved buffer (FR-004). Each link's DMA
+// runs through its own channels of the aggregate halves, so no link is
+// copied; link i owns channels i * I2S_CHANNELS onwards.
+struct I2SBridgeGroup {
+    I2SBridge *links[I2S_MAX_LINKS];
+    size_t count;
+    size_t channels;
+    int32_t *buffer;                        // Both TX halves, then both RX halves
+    int32_t *tx[2];
+    int32_t *rx[2];
+};
+
+static I2SBridge g_default_bridge;
+
+// GPIO sync state (FR-005); one sync pin per device, taken over by the
+// last bridge initialized with enable_gpio_sync
+#ifdef TEENSY
+static I2SBridge *g_sync_bridge = NULL;
 static volatile uint32_t g_sync_counter = 0;
 static volatile uint32_t g_last_sync_us = 0;
+static IntervalTimer g_sync_timer;
+#endif
 
 // Firmware version
 #define FIRMWARE_VERSION "1.0.0-i2s-bridge"
 
-/**
- * Encode consciousness metrics into I²S frame (FR-003)
- *
- * Interleaves metrics as 32-bit floats in unused audio channels
- * Channel layout:
- * - Channels 0-3: Audio L/R stereo pairs
- * - Channel 4: phi_phase (encoded as float)
- * - Channel 5: phi_depth (encoded as float)
- * - Channel 6: coherence (encoded as float)
- * - Channel 7: criticality/ici (alternating)
- */
-static void encode_metrics_to_frame(int32_t *frame, const ConsciousnessMetrics *metrics) {
-    // Encode floats as 32-bit integers (reinterpret cast)
-    union {
-        float f;
-        int32_t i;
-    } phi_phase, phi_depth, coherence, extra;
-
-    phi_phase.f = metrics->phi_phase;
-    phi_depth.f = metrics->phi_depth;
-    coherence.f = metrics->coherence;
-
-    // Alternate between criticality and ICI
-    if (metrics->sequence % 2 == 0) {
-        extra.f = metrics->criticality;
-    } else {
-        extra.f = metrics->ici;
-    }
+// Telemetry packet layout (FR-003), in bytes; sent most significant byte
+// first in each 24-bit slot of the telemetry lane
+#define TELEMETRY_SYNC          0xA5
+#define TELEMETRY_VERSION       1
+#define TELEMETRY_CRC_OFFSET    30          // CRC-16 of bytes 0-29
+#define TELEMETRY_BYTES         (I2S_TELEMETRY_WORDS * 3)
+
+// Φ sideband block (FR-003) at the end of the lane: sync, version, log2 of
+// the decimation, reserved, sequence (little-endian), then phase and depth
+// of each point as 16-bit fractions of a turn and of full depth
+// (little-endian), CRC-16 of everything before it
+#define PHI_SIDEBAND_SYNC       0x5B
+#define PHI_SIDEBAND_VERSION    1
+#define PHI_SIDEBAND_HEADER     8
+#define PHI_SIDEBAND_MAX_BYTES  (PHI_SIDEBAND_HEADER + 4 * I2S_PHI_SIDEBAND_MAX_POINTS + 2)
+#define PHI_TURN                65536.0f
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
-    // Interleave into channels 4-7
-    for (int i = 0; i < I2S_BUFFER_SIZE; i++) {
-        frame[i * I2S_CHANNELS + 4] = phi_phase.i;
-        frame[i * I2S_CHANNELS + 5] = phi_depth.i;
-        frame[i * I2S_CHANNELS + 6] = coherence.i;
-        frame[i * I2S_CHANNELS + 7] = extra.i;
+static void put_u32(uint8_t *bytes, uint32_t value) {
+    bytes[0] = (uint8_t)value;
+    bytes[1] = (uint8_t)(value >> 8);
+    bytes[2] = (uint8_t)(value >> 16);
+    bytes[3] = (uint8_t)(value >> 24);
+}
+
+static uint32_t get_u32(const uint8_t *bytes) {
+    return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) |
+           ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+}
+
+static void put_float(uint8_t *bytes, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    put_u32(bytes, bits);
+}
+
+static float get_float(const uint8_t *bytes) {
+    const uint32_t bits = get_u32(bytes);
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// CRC-16/CCITT-FALSE (polynomial 0x1021, initial 0xFFFF)
+static uint16_t telemetry_crc(const uint8_t *bytes, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)(bytes[i] << 8);
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
     }
+    return crc;
 }
 
-/**
- * Decode consciousness metrics from I²S frame (FR-003)
- */
-static void decode_metrics_from_frame(const int32_t *frame, ConsciousnessMetrics *metrics) {
-    // Decode floats from channels 4-7
-    union {
-        float f;
-        int32_t i;
-    } phi_phase, phi_depth, coherence, extra;
-
-    // Take first sample from buffer
-    phi_phase.i = frame[4];
-    phi_depth.i = frame[5];
-    coherence.i = frame[6];
-    extra.i = frame[7];
-
-    metrics->phi_phase = phi_phase.f;
-    metrics->phi_depth = phi_depth.f;
-    metrics->coherence = coherence.f;
-
-    // Decode criticality or ICI based on sequence
-    if (metrics->sequence % 2 == 0) {
-        metrics->criticality = extra.f;
-    } else {
-        metrics->ici = extra.f;
+#ifdef I2S_BRIDGE_FORWARDING
+// Telemetry forwarding: the receiving thread queues each decoded packet's
+// bytes in a single-producer ring; the forwarding thread batches them into
+// datagrams, one mmsghdr per datagram and peer, for sendmmsg
+#define FORWARD_RING_PACKETS    1024        // Power of two
+#define FORWARD_RING_MASK       (FORWARD_RING_PACKETS - 1)
+#define FORWARD_MAX_DATAGRAMS   16          // Per peer and sendmmsg call
+#define FORWARD_HEADER_BYTES    16
+#define FORWARD_DATAGRAM_BYTES  (FORWARD_HEADER_BYTES + I2S_FORWARD_NODE_ID_MAX + \
+                                 I2S_FORWARD_MAX_BATCH * I2S_FORWARD_PACKET_BYTES)
+
+struct I2SForwarder {
+    size_t batch_packets = 1;
+    uint32_t max_delay_ms = 0;
+    int socket_fd = -1;
+    struct sockaddr_in peers[I2S_FORWARD_MAX_PEERS];
+    size_t peer_count = 0;
+    uint8_t header[FORWARD_HEADER_BYTES + I2S_FORWARD_NODE_ID_MAX];  // Before the send time is set
+    size_t header_bytes = 0;
+
+    uint8_t ring[FORWARD_RING_PACKETS][I2S_FORWARD_PACKET_BYTES];
+    std::atomic<uint32_t> ring_write{0};    // Packets queued, by the receiving thread
+    std::atomic<uint32_t> ring_read{0};     // Packets taken, by the forwarding thread
+
+    std::atomic<uint64_t> packets_forwarded{0};
+    std::atomic<uint64_t> datagrams_sent{0};
+    std::atomic<uint64_t> send_calls{0};
+    std::atomic<uint64_t> packets_dropped{0};
+    std::atomic<uint64_t> send_errors{0};
+
+    // Forwarding thread's own
+    uint8_t datagrams[FORWARD_MAX_DATAGRAMS][FORWARD_DATAGRAM_BYTES];
+    struct iovec iov[FORWARD_MAX_DATAGRAMS];
+    struct mmsghdr messages[FORWARD_MAX_DATAGRAMS * I2S_FORWARD_MAX_PEERS];
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stop = false;
+};
+
+// Queue a packet; lock-free, no system call
+static void forward_push(I2SForwarder *forwarder, const uint8_t *packet) {
+    const uint32_t write = forwarder->ring_write.load(std::memory_order_relaxed);
+    if (write - forwarder->ring_read.load(std::memory_order_acquire) >= FORWARD_RING_PACKETS) {
+        forwarder->packets_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
     }
+    memcpy(forwarder->ring[write & FORWARD_RING_MASK], packet, I2S_FORWARD_PACKET_BYTES);
+    forwarder->ring_write.store(write + 1, std::memory_order_release);
 }
+#endif
 
-/**
- * GPIO sync pulse interrupt handler (FR-005)
- *
- * Called at 1 kHz to provide timing reference
- */
-#ifdef TEENSY
-void sync_pulse_isr() {
-    g_sync_counter++;
-    g_last_sync_us = micros();
+// Copy I2S_BUFFER_SIZE frames of I2S_CHANNELS samples between buffers
+// whose frames are dst_stride and src_stride samples apart
+static void copy_frames(int32_t *dst, size_t dst_stride, const int32_t *src, size_t src_stride) {
+    if (dst_stride == I2S_CHANNELS && src_stride == I2S_CHANNELS) {
+        memcpy(dst, src, I2S_BUFFER_SIZE * I2S_CHANNELS * sizeof(int32_t));
+        return;
+    }
+    for (int i = 0; i < I2S_BUFFER_SIZE; i++) {
+        memcpy(dst + i * dst_stride, src + i * src_stride, I2S_CHANNELS * sizeof(int32_t));
+    }
+}
 
-    // Toggle GPIO pin
-    if (g_config.enable_gpio_sync) {
-        digitalToggle(g_config.gpio_sync_pin);
+// Bytes per slot in the DMA buffers
+static size_t wire_slot_bytes(I2SWireFormat format) {
+    switch (format) {
+    case I2S_WIRE_24_PACKED:
+        return 3;
+    case I2S_WIRE_16:
+        return 2;
+    default:
+        return 4;
     }
 }
-#endif
 
 /**
- * Initialize I²S peripheral (platform-specific)
+ * Pack count 24-bit samples in place into the slots of a wire format
+ * (FR-004). Runs first to last: every slot is written at or before the
+ * bytes of the samples still to be read.
  */
-static bool platform_i2s_init() {
-#ifdef TEENSY
-    // Teensy 4.x I²S initialization
-    // Configure I²S1 peripheral for 48kHz, 24-bit, 8-channel
-
-    // Set clock dividers for 48kHz sample rate
-    // MCLK = 24.576 MHz (512 * 48kHz)
-    // BCLK = 12.288 MHz (256 * 48kHz)
-
-    I2S1_TCR2 = I2S_TCR2_SYNC(0) | I2S_TCR2_BCP | I2S_TCR2_MSEL(1) | I2S_TCR2_BCD | I2S_TCR2_DIV(3);
-    I2S1_TCR3 = I2S_TCR3_TCE;
-    I2S1_TCR4 = I2S_TCR4_FRSZ(7) | I2S_TCR4_SYWD(23) | I2S_TCR4_MF | I2S_TCR4_FSE | I2S_TCR4_FSD;
-    I2S1_TCR5 = I2S_TCR5_WNW(23) | I2S_TCR5_W0W(23) | I2S_TCR5_FBT(23);
-
-    // Enable DMA requests
-    I2S1_TCSR = I2S_TCSR_TE | I2S_TCSR_BCE | I2S_TCSR_FRDE;
+static void wire_pack(I2SWireFormat format, int32_t *samples, size_t count) {
+    uint8_t *bytes = (uint8_t *)samples;
+    size_t i = 0;
+
+    switch (format) {
+    case I2S_WIRE_24_IN_32_LEFT: {
+        // Whole vectors end here; computed once so the tail loop is bounded
+        const size_t vec_end = count & ~(size_t)3;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        for (; i < vec_end; i += 4) {
+            vst1q_s32(samples + i, vshlq_n_s32(vld1q_s32(samples + i), 8));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        for (; i < vec_end; i += 4) {
+            const __m128i v = _mm_loadu_si128((const __m128i *)(samples + i));
+            _mm_storeu_si128((__m128i *)(samples + i), _mm_slli_epi32(v, 8));
+        }
+#else
+        (void)vec_end;
+#endif
+        for (; i < count; i++) {
+            samples[i] = (int32_t)((uint32_t)samples[i] << 8);
+        }
+        break;
+    }
 
-    return true;
-#elif defined(RASPBERRY_PI)
-    // Raspberry Pi I²S initialization via device tree
-    // Requires custom device tree overlay
-    return true;
+    case I2S_WIRE_24_PACKED:
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        // Split 16 samples into byte planes, store the low three interleaved
+        for (const size_t vec_end = count & ~(size_t)15; i < vec_end; i += 16) {
+            const uint8x16x4_t planes = vld4q_u8(bytes + i * 4);
+            uint8x16x3_t packed;
+            packed.val[0] = planes.val[0];
+            packed.val[1] = planes.val[1];
+            packed.val[2] = planes.val[2];
+            vst3q_u8(bytes + i * 3, packed);
+        }
+#elif defined(__SSSE3__)
+        {
+            // The 16-byte store runs 4 bytes into the next group's slots
+            const __m128i order = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+            for (const size_t vec_end = count & ~(size_t)3; i < vec_end; i += 4) {
+                const __m128i v = _mm_loadu_si128((const __m128i *)(samples + i));
+                _mm_storeu_si128((__m128i *)(bytes + i * 3), _mm_shuffle_epi8(v, order));
+            }
+        }
+#endif
+        for (; i < count; i++) {
+            const uint32_t v = (uint32_t)samples[i];
+            uint8_t *slot = bytes + i * 3;
+            slot[0] = (uint8_t)v;
+            slot[1] = (uint8_t)(v >> 8);
+            slot[2] = (uint8_t)(v >> 16);
+        }
+        break;
+
+    case I2S_WIRE_16: {
+        const size_t vec_end = count & ~(size_t)7;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        for (; i < vec_end; i += 8) {
+            const int16x4_t lo = vshrn_n_s32(vld1q_s32(samples + i), 8);
+            const int16x4_t hi = vshrn_n_s32(vld1q_s32(samples + i + 4), 8);
+            vst1q_s16((int16_t *)(bytes + i * 2), vcombine_s16(lo, hi));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        for (; i < vec_end; i += 8) {
+            const __m128i lo = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(samples + i)), 8);
+            const __m128i hi = _mm_srai_epi32(_mm_loadu_si128((const __m128i *)(samples + i + 4)), 8);
+            _mm_storeu_si128((__m128i *)(bytes + i * 2), _mm_packs_epi32(lo, hi));
+        }
 #else
-    // Stub for other platforms
-    return false;
+        (void)vec_end;
 #endif
+        for (; i < count; i++) {
+            const int16_t v = (int16_t)(samples[i] >> 8);
+            memcpy(bytes + i * 2, &v, sizeof(v));
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
 }
 
 /**
- * Start DMA transfers (FR-004)
+ * Expand count slots of a wire format in place back to 24-bit samples
+ * (FR-004). Runs last to first: every sample is written at or after the
+ * bytes of the slots still to be read.
  */
-static bool platform_dma_start() {
-#ifdef TEENSY
-    // Configure DMA channels for I²S TX/RX
-    // Use ping-pong buffering for continuous operation
-    return true;
+static void wire_unpack(I2SWireFormat format, int32_t *samples, size_t count) {
+    uint8_t *bytes = (uint8_t *)samples;
+
+    switch (format) {
+    case I2S_WIRE_24_IN_32_LEFT: {
+        // Same place, any order
+        size_t i = 0;
+        const size_t vec_end = count & ~(size_t)3;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        for (; i < vec_end; i += 4) {
+            vst1q_s32(samples + i, vshrq_n_s32(vld1q_s32(samples + i), 8));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        for (; i < vec_end; i += 4) {
+            const __m128i v = _mm_loadu_si128((const __m128i *)(samples + i));
+            _mm_storeu_si128((__m128i *)(samples + i), _mm_srai_epi32(v, 8));
+        }
 #else
-    return false;
+        (void)vec_end;
 #endif
-}
-
-// Public API implementation
-
-bool i2s_bridge_init(const I2SBridgeConfig *config) {
-    if (config == NULL) {
-        return false;
+        for (; i < count; i++) {
+            samples[i] >>= 8;
+        }
+        break;
     }
 
-    // Copy configuration
-    memcpy(&g_config, config, sizeof(I2SBridgeConfig));
-
-    // Initialize statistics
-    memset(&g_stats, 0, sizeof(I2SStatistics));
-    g_stats.link_status = I2S_LINK_DISCONNECTED;
-
-    // Initialize hardware
-    if (!platform_i2s_init()) {
-        return false;
+    case I2S_WIRE_24_PACKED: {
+        size_t i = count;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__SSSE3__)
+        // Slots past the last whole vector first
+        for (const size_t vec_end = count & ~(size_t)15; i > vec_end; i--) {
+            const uint8_t *slot = bytes + (i - 1) * 3;
+            const uint32_t v = (uint32_t)slot[0] | ((uint32_t)slot[1] << 8) | ((uint32_t)slot[2] << 16);
+            samples[i - 1] = (int32_t)(v << 8) >> 8;
+        }
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        // The sign of the top byte plane becomes the fourth
+        for (; i > 0; i -= 16) {
+            const uint8x16x3_t packed = vld3q_u8(bytes + (i - 16) * 3);
+            uint8x16x4_t planes;
+            planes.val[0] = packed.val[0];
+            planes.val[1] = packed.val[1];
+            planes.val[2] = packed.val[2];
+            planes.val[3] = vreinterpretq_u8_s8(vshrq_n_s8(vreinterpretq_s8_u8(packed.val[2]), 7));
+            vst4q_u8(bytes + (i - 16) * 4, planes);
+        }
+#elif defined(__SSSE3__)
+        {
+            // Bytes to the top of each sample, then the sign down; the
+            // 16-byte load runs 4 bytes into slots already expanded
+            const __m128i order = _mm_setr_epi8(-1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11);
+            for (; i > 0; i -= 4) {
+                const __m128i v = _mm_loadu_si128((const __m128i *)(bytes + (i - 4) * 3));
+                _mm_storeu_si128((__m128i *)(samples + i - 4), _mm_srai_epi32(_mm_shuffle_epi8(v, order), 8));
+            }
+        }
+#endif
+        for (; i > 0; i--) {
+            const uint8_t *slot = bytes + (i - 1) * 3;
+            const uint32_t v = (uint32_t)slot[0] | ((uint32_t)slot[1] << 8) | ((uint32_t)slot[2] << 16);
+            samples[i - 1] = (int32_t)(v << 8) >> 8;
+        }
+        break;
     }
 
-#ifdef TEENSY
-    // Setup GPIO sync pulse (FR-005)
-    if (g_config.enable_gpio_sync) {
-        pinMode(g_config.gpio_sync_pin, OUTPUT);
-
-        // Setup timer interrupt at 1 kHz
-        IntervalTimer timer;
-        timer.begin(sync_pulse_isr, 1000); // 1000 µs = 1 kHz
+    case I2S_WIRE_16: {
+        size_t i = count;
+#if defined(__ARM_NEON) || defined(__ARM_NEON__) || defined(__SSE2__) || defined(_M_X64)
+        for (const size_t vec_end = count & ~(size_t)7; i > vec_end; i--) {
+            int16_t v;
+            memcpy(&v, bytes + (i - 1) * 2, sizeof(v));
+            samples[i - 1] = (int32_t)v * 256;
+        }
+#endif
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+        for (; i > 0; i -= 8) {
+            const int16x8_t v = vld1q_s16((const int16_t *)(bytes + (i - 8) * 2));
+            vst1q_s32(samples + i - 8, vshll_n_s16(vget_low_s16(v), 8));
+            vst1q_s32(samples + i - 4, vshll_n_s16(vget_high_s16(v), 8));
+        }
+#elif defined(__SSE2__) || defined(_M_X64)
+        {
+            // Each slot to the top half of a sample, then the sign down
+            const __m128i zero = _mm_setzero_si128();
+            for (; i > 0; i -= 8) {
+                const __m128i v = _mm_loadu_si128((const __m128i *)(bytes + (i - 8) * 2));
+                _mm_storeu_si128((__m128i *)(samples + i - 8), _mm_srai_epi32(_mm_unpacklo_epi16(zero, v), 8));
+                _mm_storeu_si128((__m128i *)(samples + i - 4), _mm_srai_epi32(_mm_unpackhi_epi16(zero, v), 8));
+            }
+        }
+#endif
+        for (; i > 0; i--) {
+            int16_t v;
+            memcpy(&v, bytes + (i - 1) * 2, sizeof(v));
+            samples[i - 1] = (int32_t)v * 256;
+        }
+        break;
     }
 
-    // Initialize serial diagnostics (FR-006)
-    if (g_config.enable_diagnostics) {
-        Serial.begin(115200);
-        while (!Serial && millis() < 3000); // Wait up to 3s for serial
+    default:
+        break;
     }
-#endif
-
-    g_initialized = true;
-    g_stats.link_status = I2S_LINK_SYNCING;
-
-    return true;
 }
 
-bool i2s_bridge_start(void) {
-    if (!g_initialized || g_running) {
-        return false;
+// Copy I2S_BUFFER_SIZE frames of frame_bytes, stride_bytes apart in both
+// buffers
+[[maybe_unused]] static void copy_wire_frames(uint8_t *dst, const uint8_t *src, size_t stride_bytes,
+                                              size_t frame_bytes) {
+    if (stride_bytes == frame_bytes) {
+        memcpy(dst, src, I2S_BUFFER_SIZE * frame_bytes);
+        return;
     }
-
-    // Start DMA transfers
-    if (!platform_dma_start()) {
-        return false;
+    for (int i = 0; i < I2S_BUFFER_SIZE; i++) {
+        memcpy(dst + i * stride_bytes, src + i * stride_bytes, frame_bytes);
     }
-
-    g_running = true;
-    g_stats.link_status = I2S_LINK_STABLE;
-    g_stats.uptime_ms = 0;
-
-    return true;
 }
 
-bool i2s_bridge_stop(void) {
-    if (!g_running) {
-        return false;
-    }
-
-    // Stop DMA transfers
-    // Platform-specific stop code here
-
-    g_running = false;
-    g_stats.link_status = I2S_LINK_DISCONNECTED;
+// Where the wire slots of a link's half start: its channels of the packed
+// aggregate in a group, the half itself otherwise
+[[maybe_unused]] static uint8_t *wire_view(const I2SBridge *bridge, int32_t *half) {
+    const size_t offset = bridge->group_index * I2S_CHANNELS;
+    return (uint8_t *)(half - offset) + offset * wire_slot_bytes(bridge->config.wire_format);
+}
 
-    return true;
+// Lane slots per packet, and of the packet bytes each slot carries
+static size_t telemetry_words(I2SWireFormat format) {
+    return format == I2S_WIRE_16 ? I2S_TELEMETRY_WORDS_16 : I2S_TELEMETRY_WORDS;
 }
 
-bool i2s_bridge_transmit(const int32_t *audio_data, const ConsciousnessMetrics *metrics) {
-    if (!g_running || audio_data == NULL || metrics == NULL) {
-        return false;
+// Lane slots of the Φ sideband block, 0 with it off
+static size_t phi_sideband_slots(I2SWireFormat format, uint16_t decimation) {
+    if (decimation == 0) {
+        return 0;
     }
+    const size_t bytes = PHI_SIDEBAND_HEADER + 4 * (I2S_BUFFER_SIZE / decimation) + 2;
+    const size_t per_slot = format == I2S_WIRE_16 ? 2 : 3;
+    return (bytes + per_slot - 1) / per_slot;
+}
 
-    // Copy audio data to TX buffer
-    memcpy(g_tx_buffer, audio_data, I2S_BUFFER_SIZE * I2S_CHANNELS * sizeof(int32_t));
-
-    // Encode metrics into channels 4-7
-    encode_metrics_to_frame(g_tx_buffer, metrics);
-
-    // Trigger DMA transfer (platform-specific)
-    // ...
-
-    g_stats.frames_transmitted++;
+// Lane slots left for packets, ahead of the sideband
+static size_t telemetry_packet_slots(const I2SBridge *bridge) {
+    return I2S_BUFFER_SIZE - phi_sideband_slots(bridge->config.wire_format, bridge->config.phi_sideband_decimation);
+}
 
-    return true;
+static size_t telemetry_max_packets(const I2SBridge *bridge) {
+    return telemetry_packet_slots(bridge) / telemetry_words(bridge->config.wire_format);
 }
 
-bool i2s_bridge_receive(int32_t *audio_data, ConsciousnessMetrics *metrics) {
-    if (!g_running || audio_data == NULL || metrics == NULL) {
-        return false;
+/**
+ * Encode consciousness metrics into I²S frame (FR-003)
+ *
+ * Channel layout:
+ * - Channels 0-6: Audio
+ * - Channel 7: Telemetry lane, count packets from the first frame, then idle
+ *
+ * Packet bytes: sync, version, sequence, timestamp_us, phi_phase,
+ * phi_depth, coherence, criticality, ici (little-endian), CRC-16, pad.
+ * Every slot is a 24-bit sample holding three bytes, or two in its top
+ * bits on 16-bit links, so the packet survives any wire format.
+ */
+static void encode_metrics_to_frame(int32_t *frame, size_t stride, I2SWireFormat format,
+                                    const ConsciousnessMetrics *metrics, size_t count) {
+    int32_t *lane = frame + I2S_TELEMETRY_CHANNEL;
+    const size_t words = telemetry_words(format);
+    const bool two_bytes = format == I2S_WIRE_16;
+    size_t slot = 0;
+
+    for (size_t p = 0; p < count; p++) {
+        const ConsciousnessMetrics *m = &metrics[p];
+        uint8_t bytes[TELEMETRY_BYTES];
+        bytes[0] = TELEMETRY_SYNC;
+        bytes[1] = TELEMETRY_VERSION;
+        put_u32(&bytes[2], m->sequence);
+        put_u32(&bytes[6], m->timestamp_us);
+        put_float(&bytes[10], m->phi_phase);
+        put_float(&bytes[14], m->phi_depth);
+        put_float(&bytes[18], m->coherence);
+        put_float(&bytes[22], m->criticality);
+        put_float(&bytes[26], m->ici);
+        const uint16_t crc = telemetry_crc(bytes, TELEMETRY_CRC_OFFSET);
+        bytes[TELEMETRY_CRC_OFFSET] = (uint8_t)(crc >> 8);
+        bytes[TELEMETRY_CRC_OFFSET + 1] = (uint8_t)crc;
+        bytes[TELEMETRY_BYTES - 1] = 0;
+
+        for (size_t w = 0; w < words; w++, slot++) {
+            const uint8_t *b = two_bytes ? &bytes[w * 2] : &bytes[w * 3];
+            const uint32_t word = ((uint32_t)b[0] << 16) | ((uint32_t)b[1] << 8) | (two_bytes ? 0 : b[2]);
+            lane[slot * stride] = (int32_t)(word << 8) >> 8;
+        }
     }
 
-    // Check if RX buffer has data (platform-specific)
-    // ...
-
-    // Copy received audio data
-    memcpy(audio_data, g_rx_buffer, I2S_BUFFER_SIZE * I2S_CHANNELS * sizeof(int32_t));
-
-    // Decode metrics from channels 4-7
-    decode_metrics_from_frame(g_rx_buffer, metrics);
-
-    g_stats.frames_received++;
-
-    return true;
+    // Idle slots end the packet run
+    for (; slot < I2S_BUFFER_SIZE; slot++) {
+        lane[slot * stride] = 0;
+    }
 }
 
-bool i2s_bridge_set_gpio_sync(bool enable) {
-    g_config.enable_gpio_sync = enable;
-
-#ifdef TEENSY
-    if (!enable) {
-        digitalWrite(g_config.gpio_sync_pin, LOW);
+/**
+ * Count the packets missing before sequence (SC-002)
+ *
+ * A sequence behind the expected one (a duplicate, or a restarted sender)
+ * resynchronizes without counting a loss.
+ */
+static void track_sequence(I2SBridge *bridge, uint32_t sequence) {
+    const uint32_t gap = sequence - bridge->rx_next_sequence;
+    if (bridge->rx_sequence_valid && gap != 0 && gap < 0x80000000u) {
+        bridge->stats.frames_dropped += gap;
     }
-#endif
-
-    return true;
+    bridge->rx_next_sequence = sequence + 1;
+    bridge->rx_sequence_valid = true;
 }
 
-bool i2s_bridge_get_statistics(I2SStatistics *stats) {
-    if (stats == NULL) {
-        return false;
-    }
+/**
+ * Decode consciousness metrics from I²S frame (FR-003)
+ *
+ * @return Packets decoded, at most max_count
+ */
+static size_t decode_metrics_from_frame(I2SBridge *bridge, const int32_t *frame, ConsciousnessMetrics *metrics,
+                                        size_t max_count) {
+    const int32_t *lane = frame + I2S_TELEMETRY_CHANNEL;
+    const size_t words = telemetry_words(bridge->config.wire_format);
+    const bool two_bytes = bridge->config.wire_format == I2S_WIRE_16;
+    size_t decoded = 0;
+
+    const size_t slots = telemetry_packet_slots(bridge);
+    for (size_t slot = 0; decoded < max_count && slot + words <= slots; slot += words) {
+        uint8_t bytes[TELEMETRY_BYTES];
+        for (size_t w = 0; w < words; w++) {
+            const uint32_t word = (uint32_t)lane[(slot + w) * bridge->stride];
+            uint8_t *b = two_bytes ? &bytes[w * 2] : &bytes[w * 3];
+            b[0] = (uint8_t)(word >> 16);
+            b[1] = (uint8_t)(word >> 8);
+            if (!two_bytes) {
+                b[2] = (uint8_t)word;
+            }
+        }
+        if (bytes[0] != TELEMETRY_SYNC) {
+            break;
+        }
+        const uint16_t crc = (uint16_t)((bytes[TELEMETRY_CRC_OFFSET] << 8) | bytes[TELEMETRY_CRC_OFFSET + 1]);
+        if (bytes[1] != TELEMETRY_VERSION || crc != telemetry_crc(bytes, TELEMETRY_CRC_OFFSET)) {
+            bridge->stats.packets_corrupt++;
+            break;
+        }
 
-    memcpy(stats, &g_stats, sizeof(I2SStatistics));
+#ifdef I2S_BRIDGE_FORWARDING
+        if (bridge->forwarder != NULL) {
+            forward_push(bridge->forwarder, bytes);
+        }
+#endif
 
-    // Calculate metrics loss rate (SC-002)
-    if (g_stats.frames_transmitted > 0) {
-        float loss_rate = (float)g_stats.frames_dropped / g_stats.frames_transmitted;
-        // loss_rate should be < 0.001 (0.1%)
+        ConsciousnessMetrics *m = &metrics[decoded++];
+        m->sequence = get_u32(&bytes[2]);
+        track_sequence(bridge, m->sequence);
+        m->timestamp_us = get_u32(&bytes[6]);
+        m->phi_phase = get_float(&bytes[10]);
+        m->phi_depth = get_float(&bytes[14]);
+        m->coherence = get_float(&bytes[18]);
+        m->criticality = get_float(&bytes[22]);
+        m->ici = get_float(&bytes[26]);
     }
 
-    return true;
+    bridge->stats.packets_received += decoded;
+    return decoded;
 }
 
-bool i2s_bridge_reset_statistics(void) {
-    g_stats.frames_transmitted = 0;
-    g_stats.frames_received = 0;
-    g_stats.frames_dropped = 0;
-    g_stats.uptime_ms = 0;
-
-    return true;
+// Φ as on the sideband: phase in 1/65536 turns, depth in 1/65535
+static uint16_t phi_quantize_phase(float phase) {
+    if (!isfinite(phase)) {
+        return 0;
+    }
+    float turns = fmodf(phase * (1.0f / (2.0f * (float)M_PI)), 1.0f);
+    if (turns < 0.0f) {
+        turns += 1.0f;
+    }
+    return (uint16_t)((uint32_t)lrintf(turns * PHI_TURN) & 0xFFFF);
 }
 
-I2SLinkStatus i2s_bridge_get_link_status(void) {
-    return g_stats.link_status;
+static uint16_t phi_quantize_depth(float depth) {
+    return (uint16_t)lrintf(fminf(fmaxf(depth, 0.0f), 1.0f) * 65535.0f);
 }
 
-bool i2s_bridge_self_test(uint32_t *latency_us, uint32_t *jitter_us) {
-    if (!g_initialized) {
-        return false;
+/**
+ * Encode the staged Φ points into the last slots of the lane (FR-003)
+ *
+ * Unstaged, the half carries newest's Φ throughout, or with no packet the
+ * last point sent, so the receiver holds it.
+ */
+static void encode_phi_sideband(I2SBridge *bridge, int32_t *frame, const ConsciousnessMetrics *newest) {
+    const uint16_t decimation = bridge->config.phi_sideband_decimation;
+    const size_t points = I2S_BUFFER_SIZE / decimation;
+    if (!bridge->phi_tx_staged) {
+        const uint16_t phase = newest != NULL ? phi_quantize_phase(newest->phi_phase) : bridge->phi_tx_last_phase;
+        const uint16_t depth = newest != NULL ? phi_quantize_depth(newest->phi_depth) : bridge->phi_tx_last_depth;
+        for (size_t j = 0; j < points; j++) {
+            bridge->phi_tx_phase[j] = phase;
+            bridge->phi_tx_depth[j] = depth;
+        }
     }
 
-    // FR-010: Loopback self-test
-    // Configure loopback mode (connect TX to RX)
-
-    const int num_tests = 100;
-    uint32_t latencies[num_tests];
+    uint8_t bytes[PHI_SIDEBAND_MAX_BYTES + 2] = {};
+    int shift = 0;
+    while ((1u << shift) < decimation) {
+        shift++;
+    }
+    bytes[0] = PHI_SIDEBAND_SYNC;
+    bytes[1] = PHI_SIDEBAND_VERSION;
+    bytes[2] = (uint8_t)shift;
+    put_u32(&bytes[4], bridge->phi_tx_sequence++);
+    uint8_t *b = &bytes[PHI_SIDEBAND_HEADER];
+    for (size_t j = 0; j < points; j++, b += 4) {
+        b[0] = (uint8_t)bridge->phi_tx_phase[j];
+        b[1] = (uint8_t)(bridge->phi_tx_phase[j] >> 8);
+        b[2] = (uint8_t)bridge->phi_tx_depth[j];
+        b[3] = (uint8_t)(bridge->phi_tx_depth[j] >> 8);
+    }
+    const size_t length = (size_t)(b - bytes);
+    const uint16_t crc = telemetry_crc(bytes, length);
+    b[0] = (uint8_t)(crc >> 8);
+    b[1] = (uint8_t)crc;
+
+    bridge->phi_tx_last_phase = bridge->phi_tx_phase[points - 1];
+    bridge->phi_tx_last_depth = bridge->phi_tx_depth[points - 1];
+    bridge->phi_tx_staged = false;
+
+    int32_t *lane = frame + I2S_TELEMETRY_CHANNEL;
+    const bool two_bytes = bridge->config.wire_format == I2S_WIRE_16;
+    const size_t first = telemetry_packet_slots(bridge);
+    for (size_t slot = first, w = 0; slot < I2S_BUFFER_SIZE; slot++, w++) {
+        const uint8_t *s = two_bytes ? &bytes[w * 2] : &bytes[w * 3];
+        const uint32_t word = ((uint32_t)s[0] << 16) | ((uint32_t)s[1] << 8) | (two_bytes ? 0 : s[2]);
+        lane[slot * bridge->stride] = (int32_t)(word << 8) >> 8;
+    }
+}
 
-    // Transmit test pattern and measure round-trip time
-    for (int i = 0; i < num_tests; i++) {
-        // Generate test pattern
-        int32_t test_audio[I2S_BUFFER_SIZE * I2S_CHANNELS];
-        for (int j = 0; j < I2S_BUFFER_SIZE * I2S_CHANNELS; j++) {
-            test_audio[j] = (j % 2) ? 0x7FFFFF : -0x800000; // Square wave
+/**
+ * Decode the Φ sideband of a received half into its audio-rate trajectory
+ * (FR-003)
+ *
+ * Each point is reached by a linear ramp from the one before, phase along
+ * the shorter arc; the first from where the previous half ended. A half
+ * without an intact block holds the last value.
+ */
+static void decode_phi_sideband(I2SBridge *bridge, const int32_t *frame) {
+    const uint16_t decimation = bridge->config.phi_sideband_decimation;
+    const size_t points = I2S_BUFFER_SIZE / decimation;
+    const int32_t *lane = frame + I2S_TELEMETRY_CHANNEL;
+    const bool two_bytes = bridge->config.wire_format == I2S_WIRE_16;
+    const size_t first = telemetry_packet_slots(bridge);
+
+    uint8_t bytes[PHI_SIDEBAND_MAX_BYTES + 2];
+    for (size_t slot = first, w = 0; slot < I2S_BUFFER_SIZE; slot++, w++) {
+        const uint32_t word = (uint32_t)lane[slot * bridge->stride];
+        uint8_t *b = two_bytes ? &bytes[w * 2] : &bytes[w * 3];
+        b[0] = (uint8_t)(word >> 16);
+        b[1] = (uint8_t)(word >> 8);
+        if (!two_bytes) {
+            b[2] = (uint8_t)word;
         }
-
-        ConsciousnessMetrics test_metrics = {
-            .phi_phase = 3.14159f,
-            .phi_depth = 0.5f,
-            .coherence = 0.95f,
-            .criticality = 1.0f,
-            .ici = 100.0f,
-            .timestamp_us = 0,
-            .sequence = (uint32_t)i
-        };
-
-#ifdef TEENSY
-        uint32_t start_us = micros();
-#else
-        uint32_t start_us = 0; // Stub
-#endif
-
-        // Transmit
-        i2s_bridge_transmit(test_audio, &test_metrics);
-
-        // Receive
-        int32_t received_audio[I2S_BUFFER_SIZE * I2S_CHANNELS];
-        ConsciousnessMetrics received_metrics;
-        i2s_bridge_receive(received_audio, &received_metrics);
-
-#ifdef TEENSY
-        uint32_t end_us = micros();
-        latencies[i] = end_us - start_us;
-#else
-        latencies[i] = 20; // Stub: assume 20 µs
-#endif
     }
 
-    // Calculate average latency and jitter
-    uint32_t sum = 0;
-    for (int i = 0; i < num_tests; i++) {
-        sum += latencies[i];
+    const size_t length = PHI_SIDEBAND_HEADER + 4 * points;
+    bool intact = bytes[0] == PHI_SIDEBAND_SYNC;
+    if (intact) {
+        const uint16_t crc = (uint16_t)((bytes[length] << 8) | bytes[length + 1]);
+        if (bytes[1] != PHI_SIDEBAND_VERSION || bytes[2] > 15 || (1u << bytes[2]) != decimation ||
+            crc != telemetry_crc(bytes, length)) {
+            bridge->stats.phi_sideband_corrupt++;
+            intact = false;
+        }
+    }
+    bridge->phi_rx_intact = intact;
+
+    if (!intact) {
+        const float phase = bridge->phi_rx_last_phase * (2.0f * (float)M_PI / PHI_TURN);
+        const float depth = bridge->phi_rx_last_depth * (1.0f / 65535.0f);
+        for (int i = 0; i < I2S_BUFFER_SIZE; i++) {
+            bridge->phi_rx_phase[i] = phase;
+            bridge->phi_rx_depth[i] = depth;
+        }
+        return;
     }
-    uint32_t avg_latency = sum / num_tests;
 
-    // Calculate jitter (standard deviation)
-    uint32_t variance_sum = 0;
-    for (int i = 0; i < num_tests; i++) {
-        int32_t diff = latencies[i] - avg_latency;
-        variance_sum += diff * diff;
+    const uint32_t sequence = get_u32(&bytes[4]);
+    if (bridge->phi_rx_primed && sequence != bridge->phi_rx_next_sequence) {
+        bridge->stats.phi_sideband_gaps++;
     }
-    uint32_t jitter = 0;
-    if (num_tests > 1) {
-        jitter = (uint32_t)sqrt(variance_sum / (num_tests - 1));
+    bridge->phi_rx_next_sequence = sequence + 1;
+    bridge->stats.phi_sideband_received++;
+
+    const uint8_t *b = &bytes[PHI_SIDEBAND_HEADER];
+    if (!bridge->phi_rx_primed) {
+        bridge->phi_rx_last_phase = (uint16_t)(b[0] | (b[1] << 8));
+        bridge->phi_rx_last_depth = (uint16_t)(b[2] | (b[3] << 8));
+        bridge->phi_rx_primed = true;
+    }
+    const float inv = 1.0f / (float)decimation;
+    float *phase_out = bridge->phi_rx_phase;
+    float *depth_out = bridge->phi_rx_depth;
+    for (size_t j = 0; j < points; j++, b += 4) {
+        const uint16_t phase = (uint16_t)(b[0] | (b[1] << 8));
+        const uint16_t depth = (uint16_t)(b[2] | (b[3] << 8));
+        // Wrapping 16-bit difference: the shorter arc
+        const float phase_step = (float)(int16_t)(uint16_t)(phase - bridge->phi_rx_last_phase) * inv;
+        const float depth_step = ((float)depth - (float)bridge->phi_rx_last_depth) * inv;
+        for (uint16_t k = 1; k <= decimation; k++) {
+            float turn = bridge->phi_rx_last_phase + phase_step * k;
+            if (turn < 0.0f) {
+                turn += PHI_TURN;
+            } else if (turn >= PHI_TURN) {
+                turn -= PHI_TURN;
+            }
+            *phase_out++ = turn * (2.0f * (float)M_PI / PHI_TURN);
+            *depth_out++ = (bridge->phi_rx_last_depth + depth_step * k) * (1.0f / 65535.0f);
+        }
+        bridge->phi_rx_last_phase = phase;
+        bridge->phi_rx_last_depth = depth;
     }
-
-    *latency_us = avg_latency;
-    *jitter_us = jitter;
-
-    g_stats.latency_us = avg_latency;
-    g_stats.jitter_us = jitter;
-
-    // SC-001: Verify latency ≤40 µs and jitter ≤5 µs
-    return (avg_latency <= 40 && jitter <= 5);
 }
 
-bool i2s_bridge_send_diagnostic(const char *message) {
+// Timer ticks for round-trip timing: the cycle counter (DWT CYCCNT) on
+// Teensy, monotonic nanoseconds on hosts. Only differences are used, so
+// wrapping is harmless
+static uint32_t bridge_ticks() {
 #ifdef TEENSY
-    if (g_config.enable_diagnostics && Serial) {
-        Serial.println(message);
-        return true;
-    }
+    return ARM_DWT_CYCCNT;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)ts.tv_sec * 1000000000u + (uint32_t)ts.tv_nsec;
+#else
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint32_t)ts.tv_sec * 1000000000u + (uint32_t)ts.tv_nsec;
 #endif
-    return false;
 }
 
-bool i2s_bridge_diagnostic_available(void) {
+static double bridge_ticks_to_ns(uint32_t ticks) {
 #ifdef TEENSY
-    return (g_config.enable_diagnostics && Serial.available() > 0);
+    return ticks * (1e9 / F_CPU_ACTUAL);
 #else
-    return false;
+    return ticks;
 #endif
 }
 
-int i2s_bridge_read_diagnostic(char *buffer, size_t max_len) {
+// Milliseconds for timeouts, wrapping
+static uint32_t bridge_millis() {
 #ifdef TEENSY
-    if (!g_config.enable_diagnostics || !Serial.available()) {
-        return -1;
-    }
-
-    return Serial.readBytesUntil('\n', buffer, max_len);
+    return millis();
 #else
-    return -1;
+    return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
 #endif
 }
 
-float i2s_bridge_calibrate_drift(void) {
-    // FR-005: Measure clock drift using GPIO sync pulse
+// The bridge whose sync pulses set the drift: the leader of its group
+static I2SBridge *sync_leader(I2SBridge *bridge) {
+    return bridge->group != NULL ? bridge->group->links[0] : bridge;
+}
 
-    if (!g_config.enable_gpio_sync) {
-        return 0.0f;
+/**
+ * Build the resampler's coefficient table: row p is the Blackman-windowed
+ * sinc delayed by p / ASRC_PHASES of a frame, normalized to unity DC gain
+ */
+static void asrc_build_coeffs() {
+    const float pi = 3.14159265358979f;
+    for (int p = 0; p <= ASRC_PHASES; p++) {
+        const float delay = (float)p / ASRC_PHASES;
+        float sum = 0.0f;
+        for (int k = 0; k < ASRC_TAPS; k++) {
+            // Tap k weighs input frame (read position) - ASRC_HISTORY + k
+            const float t = (float)(k - ASRC_HISTORY) - delay;
+            const float x = 2.0f * ASRC_CUTOFF * t;
+            const float sinc = fabsf(x) < 1e-6f ? 1.0f : sinf(pi * x) / (pi * x);
+            const float w = (t + ASRC_TAPS / 2.0f) / ASRC_TAPS;  // 0..1 over the span
+            const float window = 0.42f - 0.5f * cosf(2.0f * pi * w) + 0.08f * cosf(4.0f * pi * w);
+            g_asrc_coeffs[p][k] = sinc * window;
+            sum += g_asrc_coeffs[p][k];
+        }
+        for (int k = 0; k < ASRC_TAPS; k++) {
+            g_asrc_coeffs[p][k] /= sum;
+        }
     }
+}
 
-#ifdef TEENSY
-    // Measure actual sync interval over 1 second
-    uint32_t start_count = g_sync_counter;
-    uint32_t start_time = millis();
+// Build the table once, whichever bridge needs it first
+static void asrc_init_coeffs() {
+    static const bool built = (asrc_build_coeffs(), true);
+    (void)built;
+}
 
-    delay(1000); // Wait 1 second
+static void asrc_reset(I2SBridge *bridge) {
+    bridge->asrc_write.store(0);
+    bridge->asrc_push_ticks.store(0);
+    bridge->asrc_oldest.store(0);
+    bridge->asrc_read = 0;
+    bridge->asrc_frac = 0.0;
+    bridge->asrc_step = 1.0;
+    bridge->asrc_primed = false;
+}
 
-    uint32_t end_count = g_sync_counter;
-    uint32_t end_time = millis();
+// Append the audio of a received half, interrupt context
+static void asrc_push(I2SBridge *bridge, const int32_t *frame) {
+    const uint32_t write = bridge->asrc_write.load(std::memory_order_relaxed);
+    if (write + I2S_BUFFER_SIZE - bridge->asrc_oldest.load(std::memory_order_acquire) > ASRC_RING_FRAMES) {
+        // The reader stopped or fell far behind
+        bridge->stats.asrc_slips++;
+        return;
+    }
 
-    uint32_t actual_pulses = end_count - start_count;
-    uint32_t actual_time_ms = end_time - start_time;
+    for (int i = 0; i < I2S_BUFFER_SIZE; i++) {
+        float *dst = bridge->asrc_ring[(write + i) & (ASRC_RING_FRAMES - 1)];
+        for (int ch = 0; ch < I2S_AUDIO_CHANNELS; ch++) {
+            dst[ch] = (float)frame[i * bridge->stride + ch];
+        }
+    }
 
-    // Expected: 1000 pulses in 1000 ms
-    float drift_ppm = ((float)actual_pulses - 1000.0f) / 1000.0f * 1e6f;
+    bridge->asrc_push_ticks.store(bridge_ticks(), std::memory_order_relaxed);
+    bridge->asrc_write.store(write + I2S_BUFFER_SIZE, std::memory_order_release);
+}
 
-    g_stats.clock_drift_ppm = drift_ppm;
+/**
+ * Read I2S_BUFFER_SIZE frames of audio at the local pace (FR-005) into
+ * the audio channels of out. Silence until the ring has reached the
+ * target fill, and again after running dry.
+ */
+static void asrc_pull(I2SBridge *bridge, int32_t *out) {
+    // Frames appended and when, consistent with each other
+    uint32_t write, push_ticks;
+    do {
+        write = bridge->asrc_write.load(std::memory_order_acquire);
+        push_ticks = bridge->asrc_push_ticks.load(std::memory_order_relaxed);
+    } while (write != bridge->asrc_write.load(std::memory_order_acquire));
+
+    // Frames the DMA has received since, not appended yet
+    double in_flight = 0.0;
+    if (write != 0) {
+        in_flight = bridge_ticks_to_ns(bridge_ticks() - push_ticks) * I2S_SAMPLE_RATE / 1e9;
+        in_flight = fmin(fmax(in_flight, 0.0), (double)I2S_BUFFER_SIZE);
+    }
+
+    int start = 0;
+    if (!bridge->asrc_primed) {
+        // Start reading once the target fill is there
+        const uint32_t oldest = bridge->asrc_oldest.load(std::memory_order_relaxed);
+        const double behind = ASRC_TARGET_FILL - in_flight;
+        if (write - oldest >= ASRC_TARGET_FILL + ASRC_HISTORY) {
+            const double whole = ceil(behind);
+            bridge->asrc_read = write - (uint32_t)whole;
+            bridge->asrc_frac = whole - behind;
+            bridge->asrc_step = 1.0;
+            bridge->asrc_primed = true;
+        } else {
+            start = I2S_BUFFER_SIZE;
+        }
+    } else {
+        // Next step: the drift estimate, plus the fill error over about 1 s
+        const double fill = (double)(int32_t)(write - bridge->asrc_read) - bridge->asrc_frac + in_flight;
+        double ppm = sync_leader(bridge)->drift_ppm.load() + (fill - ASRC_TARGET_FILL) * 1e6 / I2S_SAMPLE_RATE;
+        ppm = fmin(fmax(ppm, -ASRC_MAX_PPM), ASRC_MAX_PPM);
+        bridge->asrc_step = 1.0 + ppm * 1e-6;
+        bridge->stats.asrc_ratio = (float)bridge->asrc_step;
+    }
+
+    float (*ring)[I2S_AUDIO_CHANNELS] = bridge->asrc_ring;
+    for (int i = start; i < I2S_BUFFER_SIZE; i++) {
+        if ((int32_t)(write - bridge->asrc_read) <= ASRC_TAPS / 2) {
+            // Ran dry: silence and prime again
+            bridge->stats.asrc_slips++;
+            bridge->asrc_primed = false;
+            start = i;
+            break;
+        }
+
+        const float phase = (float)bridge->asrc_frac * ASRC_PHASES;
+        const int p = (int)phase;
+        const float a = phase - p;
+
+        float coeffs[ASRC_TAPS];
+        for (int k = 0; k < ASRC_TAPS; k++) {
+            coeffs[k] = g_asrc_coeffs[p][k] + a * (g_asrc_coeffs[p + 1][k] - g_asrc_coeffs[p][k]);
+        }
+
+        const uint32_t first = bridge->asrc_read - ASRC_HISTORY;
+        for (int ch = 0; ch < I2S_AUDIO_CHANNELS; ch++) {
+            float acc = 0.0f;
+            for (int k = 0; k < ASRC_TAPS; k++) {
+                acc += coeffs[k] * ring[(first + k) & (ASRC_RING_FRAMES - 1)][ch];
+            }
+            // Back to 24-bit samples
+            const float clamped = fminf(fmaxf(acc, -8388608.0f), 8388607.0f);
+            out[i * I2S_CHANNELS + ch] = (int32_t)lrintf(clamped);
+        }
+
+        bridge->asrc_frac += bridge->asrc_step;
+        const double whole = floor(bridge->asrc_frac);
+        bridge->asrc_read += (uint32_t)whole;
+        bridge->asrc_frac -= whole;
+        start = i + 1;
+    }
+
+    for (int i = start; i < I2S_BUFFER_SIZE; i++) {
+        for (int ch = 0; ch < I2S_AUDIO_CHANNELS; ch++) {
+            out[i * I2S_CHANNELS + ch] = 0;
+        }
+    }
+
+    // Frames before the taps of the read position may be overwritten
+    if (bridge->asrc_primed) {
+        bridge->asrc_oldest.store(bridge->asrc_read - ASRC_HISTORY, std::memory_order_release);
+    } else if (write - bridge->asrc_oldest.load(std::memory_order_relaxed) > ASRC_TARGET_FILL + ASRC_HISTORY) {
+        bridge->asrc_oldest.store(write - (ASRC_TARGET_FILL + ASRC_HISTORY), std::memory_order_release);
+    }
+}
+
+/**
+ * DMA half or full completion (FR-004), interrupt context
+ *
+ * The DMA has sent TX half and filled RX half and moved on to the other
+ * half: both go to the CPU. A TX half that was never committed went out
+ * with stale contents. The halves alternate, so the RX queue only counts.
+ */
+[[maybe_unused]] static void dma_buffer_done(I2SBridge *bridge, uint8_t half) {
+    const uint8_t bit = (uint8_t)(1u << half);
+
+    if (!(bridge->tx_ready.fetch_and((uint8_t)~bit) & bit)) {
+        bridge->stats.tx_underruns++;
+    }
+    bridge->tx_free.fetch_or(bit);
+    if (bridge->group == NULL) {
+        // A group unpacks its aggregate once every link has the half
+        wire_unpack(bridge->config.wire_format, bridge->rx[half], I2S_BUFFER_SIZE * I2S_CHANNELS);
+    }
+    if (bridge->config.enable_drift_compensation) {
+        asrc_push(bridge, bridge->rx[half]);
+    }
+    bridge->rx_capture_ticks[half] = bridge_ticks();
+    bridge->rx_produced.fetch_add(1, std::memory_order_release);
+
+#ifndef TEENSY
+    {
+        std::lock_guard<std::mutex> lock(bridge->rx_mutex);
+    }
+    bridge->rx_signal.notify_all();
+#endif
+
+    if (bridge->buffer_callback != NULL) {
+        bridge->buffer_callback(half, bridge->buffer_context);
+    }
+}
+
+/**
+ * GPIO sync pulse interrupt handler (FR-005)
+ *
+ * Called at 1 kHz to provide timing reference: the master toggles the
+ * pin from its timer, the slave takes every edge of it.
+ */
+#ifdef TEENSY
+void sync_pulse_isr() {
+    I2SBridge *bridge = g_sync_bridge;
+    g_sync_counter++;
+    g_last_sync_us = micros();
+
+    if (bridge->config.mode == I2S_MODE_SLAVE) {
+        i2s_sync_pulse(bridge, g_last_sync_us);
+    } else if (bridge->config.enable_gpio_sync) {
+        // Toggle GPIO pin
+        digitalToggle(bridge->config.gpio_sync_pin);
+    }
+}
+#endif
+
+static void dll_reset(I2SBridge *bridge) {
+    bridge->dll_locked = false;
+    bridge->dll_period_offset_us = 0.0f;
+    bridge->drift_ppm.store(0.0f);
+}
+
+/**
+ * Initialize I²S peripheral (platform-specific)
+ */
+static bool platform_i2s_init(I2SBridge *bridge) {
+#ifdef TEENSY
+    // Teensy 4.x I²S initialization
+    // Configure SAI1 (port 0) or SAI2 (port 1) for 48kHz, 8-channel
+
+    // Set clock dividers for 48kHz sample rate
+    // MCLK = 24.576 MHz (512 * 48kHz)
+    // BCLK = 12.288 MHz (256 * 48kHz), half that with 16-bit slots
+    // A slave, such as the follower of a group, takes BCLK and the frame
+    // sync from its pins instead of driving them
+    uint32_t slot_bits, first_bit, fifo_pack = 0;
+    switch (bridge->config.wire_format) {
+    case I2S_WIRE_24_IN_32_LEFT:
+        slot_bits = 32;
+        first_bit = 31;
+        break;
+    case I2S_WIRE_16:
+        // Two slots per FIFO word, as packed by the CPU
+        slot_bits = 16;
+        first_bit = 15;
+        fifo_pack = 3;
+        break;
+    case I2S_WIRE_24_PACKED:
+        // The DMA moves no 3-byte words: packed 24-bit needs the Pi's ALSA
+        return false;
+    default:
+        slot_bits = 24;
+        first_bit = 23;
+        break;
+    }
+    const bool master = bridge->config.mode == I2S_MODE_MASTER;
+    const uint32_t tcr2 = I2S_TCR2_SYNC(0) | I2S_TCR2_BCP |
+                          (master ? I2S_TCR2_MSEL(1) | I2S_TCR2_BCD | I2S_TCR2_DIV(slot_bits == 16 ? 7 : 3) : 0);
+    const uint32_t tcr4 = I2S_TCR4_FRSZ(7) | I2S_TCR4_SYWD(slot_bits - 1) | I2S_TCR4_MF | I2S_TCR4_FSE |
+                          I2S_TCR4_FPACK(fifo_pack) | (master ? I2S_TCR4_FSD : 0);
+    const uint32_t tcr5 = I2S_TCR5_WNW(slot_bits - 1) | I2S_TCR5_W0W(slot_bits - 1) | I2S_TCR5_FBT(first_bit);
+
+    switch (bridge->config.port) {
+    case 0:
+        I2S1_TCR2 = tcr2;
+        I2S1_TCR3 = I2S_TCR3_TCE;
+        I2S1_TCR4 = tcr4;
+        I2S1_TCR5 = tcr5;
+        // Enable DMA requests
+        I2S1_TCSR = I2S_TCSR_TE | I2S_TCSR_BCE | I2S_TCSR_FRDE;
+        return true;
+    case 1:
+        I2S2_TCR2 = tcr2;
+        I2S2_TCR3 = I2S_TCR3_TCE;
+        I2S2_TCR4 = tcr4;
+        I2S2_TCR5 = tcr5;
+        I2S2_TCSR = I2S_TCSR_TE | I2S_TCSR_BCE | I2S_TCSR_FRDE;
+        return true;
+    default:
+        return false;
+    }
+#elif defined(RASPBERRY_PI)
+    // Raspberry Pi I²S initialization via device tree
+    // Requires custom device tree overlay; the PCM format follows the wire
+    // format (S32_LE, S24_3LE or S16_LE)
+    (void)bridge;
+    return true;
+#elif defined(I2S_BRIDGE_LOOPBACK)
+    // Software loopback, nothing to configure
+    (void)bridge;
+    return true;
+#else
+    // Stub for other platforms
+    (void)bridge;
+    return false;
+#endif
+}
+
+// Configure another port in the bridge's format, to stand by
+static bool platform_i2s_init_port(I2SBridge *bridge, uint8_t port) {
+    const uint8_t active = bridge->config.port;
+    bridge->config.port = port;
+    const bool ok = platform_i2s_init(bridge);
+    bridge->config.port = active;
+    return ok;
+}
+
+/**
+ * Start DMA transfers (FR-004)
+ */
+static bool platform_dma_start(I2SBridge *bridge) {
+#ifdef TEENSY
+    // Configure circular DMA channels for I²S TX/RX over both halves of
+    // bridge->tx/rx, interrupting at half and major loop completion; the
+    // handler calls dma_buffer_done(bridge, 0) and (1). Each minor loop
+    // moves the I2S_CHANNELS slots of one frame, wire_slot_bytes() each,
+    // from wire_view(); in a group the minor loop offset then skips the
+    // other links' slots, so the links fill one interleaved buffer
+    // without a copy
+    (void)bridge;
+    return true;
+#elif defined(I2S_BRIDGE_LOOPBACK)
+    (void)bridge;
+    return true;
+#else
+    (void)bridge;
+    return false;
+#endif
+}
+
+/**
+ * Stop DMA transfers; the halves keep their contents
+ */
+static void platform_dma_stop(I2SBridge *bridge) {
+    // Teensy: disable the I²S TX/RX DMA channels of bridge->config.port; a
+    // restart resumes at the half after the last one completed
+    (void)bridge;
+}
+
+// Public API implementation
+
+I2SBridge* i2s_bridge_create(void) {
+    // Value-initialized: zeroed, then the member defaults applied
+    return new (std::nothrow) I2SBridge();
+}
+
+void i2s_bridge_destroy(I2SBridge *bridge) {
+    if (bridge == NULL || bridge == &g_default_bridge || bridge->group != NULL) {
+        return;
+    }
+    i2s_stop(bridge);
+    i2s_forward_stop(bridge);
+    delete[] bridge->asrc_ring;
+    delete bridge;
+}
+
+I2SBridge* i2s_bridge_default(void) {
+    return &g_default_bridge;
+}
+
+bool i2s_init(I2SBridge *bridge, const I2SBridgeConfig *config) {
+    if (bridge == NULL || config == NULL || config->wire_format > I2S_WIRE_16) {
+        return false;
+    }
+    const uint8_t wire_depth = config->wire_format == I2S_WIRE_16 ? 16 : 24;
+    if (config->bit_depth != 0 && config->bit_depth != wire_depth) {
+        return false;
+    }
+    // The Φ sideband must leave room for a packet
+    const uint16_t decimation = config->phi_sideband_decimation;
+    if (decimation != 0 &&
+        ((decimation & (decimation - 1)) != 0 || decimation > I2S_BUFFER_SIZE ||
+         decimation < (config->wire_format == I2S_WIRE_16 ? I2S_PHI_SIDEBAND_MIN_DECIMATION_16
+                                                          : I2S_PHI_SIDEBAND_MIN_DECIMATION) ||
+         phi_sideband_slots(config->wire_format, decimation) + telemetry_words(config->wire_format) >
+             I2S_BUFFER_SIZE)) {
+        return false;
+    }
+
+    // Copy configuration
+    memcpy(&bridge->config, config, sizeof(I2SBridgeConfig));
+    bridge->standby_port = -1;
+
+    // Initialize statistics
+    memset(&bridge->stats, 0, sizeof(I2SStatistics));
+    bridge->stats.link_status = I2S_LINK_DISCONNECTED;
+
+    // Φ sideband from zero phase and depth
+    bridge->phi_tx_staged = false;
+    bridge->phi_tx_last_phase = 0;
+    bridge->phi_tx_last_depth = 0;
+    bridge->phi_tx_sequence = 0;
+    memset(bridge->phi_rx_phase, 0, sizeof(bridge->phi_rx_phase));
+    memset(bridge->phi_rx_depth, 0, sizeof(bridge->phi_rx_depth));
+    bridge->phi_rx_last_phase = 0;
+    bridge->phi_rx_last_depth = 0;
+    bridge->phi_rx_primed = false;
+    bridge->phi_rx_intact = false;
+
+    // Initialize hardware
+    if (!platform_i2s_init(bridge)) {
+        if (bridge->config.enable_diagnostics) {
+            firmware_log("[I2SBridge] I²S peripheral initialization failed\n");
+        }
+        return false;
+    }
+
+    dll_reset(bridge);
+    if (bridge->config.enable_drift_compensation) {
+        asrc_init_coeffs();
+        if (bridge->asrc_ring == NULL) {
+            bridge->asrc_ring = new (std::nothrow) float[ASRC_RING_FRAMES][I2S_AUDIO_CHANNELS];
+        }
+        if (bridge->asrc_ring == NULL) {
+            if (bridge->config.enable_diagnostics) {
+                firmware_log("[I2SBridge] Resampler allocation failed\n");
+            }
+            return false;
+        }
+    }
+
+#ifdef TEENSY
+    // Setup GPIO sync pulse (FR-005)
+    if (bridge->config.enable_gpio_sync) {
+        g_sync_bridge = bridge;
+    }
+    if (bridge->config.enable_gpio_sync && bridge->config.mode == I2S_MODE_SLAVE) {
+        // Every edge of the master's pulse feeds the drift DLL
+        pinMode(bridge->config.gpio_sync_pin, INPUT);
+        attachInterrupt(digitalPinToInterrupt(bridge->config.gpio_sync_pin), sync_pulse_isr, CHANGE);
+    } else if (bridge->config.enable_gpio_sync) {
+        pinMode(bridge->config.gpio_sync_pin, OUTPUT);
+
+        // Setup timer interrupt at 1 kHz
+        g_sync_timer.begin(sync_pulse_isr, 1000); // 1000 µs = 1 kHz
+    }
+
+    // Initialize serial diagnostics (FR-006); no wait for a host, lines
+    // stay queued until one attaches
+    if (bridge->config.enable_diagnostics) {
+        Serial.begin(115200);
+    }
+#endif
+
+    bridge->initialized = true;
+    bridge->stats.link_status = I2S_LINK_SYNCING;
+
+    return true;
+}
+
+bool i2s_start(I2SBridge *bridge) {
+    if (bridge == NULL || !bridge->initialized || bridge->running) {
+        return false;
+    }
+
+    // Start DMA transfers
+    if (!platform_dma_start(bridge)) {
+        if (bridge->config.enable_diagnostics) {
+            firmware_log("[I2SBridge] DMA start failed\n");
+        }
+        return false;
+    }
+
+    bridge->tx_free.store(0x3);
+    bridge->tx_ready.store(0);
+    bridge->rx_produced.store(0);
+    bridge->rx_consumed = 0;
+    bridge->tx_next = 0;
+    bridge->tx_acquired = -1;
+    bridge->rx_acquired = -1;
+
+    asrc_reset(bridge);
+
+    bridge->running = true;
+    bridge->rx_sequence_valid = false;
+    bridge->stats.link_status = I2S_LINK_STABLE;
+    bridge->stats.uptime_ms = 0;
+
+    bridge->health_produced = 0;
+    bridge->health_last_ms = bridge_millis();
+    bridge->health_window_ms = bridge->health_last_ms;
+    bridge->health_received = bridge->stats.packets_received;
+    bridge->health_corrupt = bridge->stats.packets_corrupt;
+    bridge->relocking = false;
+
+    return true;
+}
+
+bool i2s_stop(I2SBridge *bridge) {
+    if (bridge == NULL || !bridge->running) {
+        return false;
+    }
+
+    // Stop DMA transfers
+    platform_dma_stop(bridge);
+
+    bridge->running = false;
+    bridge->stats.link_status = I2S_LINK_DISCONNECTED;
+
+    return true;
+}
+
+bool i2s_transmit(I2SBridge *bridge, const int32_t *audio_data, const ConsciousnessMetrics *metrics) {
+    if (metrics == NULL) {
+        return false;
+    }
+
+    return i2s_transmit_packets(bridge, audio_data, metrics, 1);
+}
+
+bool i2s_transmit_packets(I2SBridge *bridge, const int32_t *audio_data, const ConsciousnessMetrics *metrics,
+                          size_t count) {
+    if (bridge == NULL || audio_data == NULL || (metrics == NULL && count > 0) ||
+        count > telemetry_max_packets(bridge)) {
+        return false;
+    }
+
+    int32_t *frame = i2s_acquire_tx(bridge);
+    if (frame == NULL) {
+        return false;
+    }
+
+    // Copy audio data to TX buffer
+    copy_frames(frame, bridge->stride, audio_data, I2S_CHANNELS);
+
+    return i2s_commit_tx(bridge, metrics, count);
+}
+
+bool i2s_receive(I2SBridge *bridge, int32_t *audio_data, ConsciousnessMetrics *metrics) {
+    if (bridge == NULL || metrics == NULL) {
+        return false;
+    }
+
+    ConsciousnessMetrics packets[I2S_TELEMETRY_MAX_PACKETS];
+    const int count = i2s_receive_packets(bridge, audio_data, packets, I2S_TELEMETRY_MAX_PACKETS);
+    if (count < 0) {
+        return false;
+    }
+    if (count > 0) {
+        *metrics = packets[count - 1];
+    }
+
+    // Resampled audio comes at the local pace, with or without a packet
+    return count > 0 || bridge->config.enable_drift_compensation;
+}
+
+int i2s_receive_packets(I2SBridge *bridge, int32_t *audio_data, ConsciousnessMetrics *metrics,
+                        size_t max_count) {
+    if (bridge == NULL || audio_data == NULL || !bridge->running) {
+        return -1;
+    }
+
+    size_t count = 0;
+    const int32_t *frame = i2s_acquire_rx(bridge, metrics, max_count, &count);
+    if (frame != NULL) {
+        // Copy received audio data
+        copy_frames(audio_data, I2S_CHANNELS, frame, bridge->stride);
+        i2s_release_rx(bridge);
+    } else if (!bridge->config.enable_drift_compensation) {
+        return -1;
+    } else {
+        // Audio still flows from the resampler; the lane is idle
+        for (int i = 0; i < I2S_BUFFER_SIZE; i++) {
+            audio_data[i * I2S_CHANNELS + I2S_TELEMETRY_CHANNEL] = 0;
+        }
+    }
+
+    // Audio channels resampled to the local clock
+    if (bridge->config.enable_drift_compensation) {
+        asrc_pull(bridge, audio_data);
+    }
+
+    return (int)count;
+}
+
+int32_t *i2s_acquire_tx(I2SBridge *bridge) {
+    if (bridge == NULL) {
+        return NULL;
+    }
+
+    const uint8_t bit = (uint8_t)(1u << bridge->tx_next);
+    if (!bridge->running || bridge->tx_acquired >= 0 || !(bridge->tx_free.load() & bit)) {
+        return NULL;
+    }
+
+    bridge->tx_free.fetch_and((uint8_t)~bit);
+    bridge->tx_acquired = bridge->tx_next;
+
+    return bridge->tx[bridge->tx_acquired];
+}
+
+// Give the acquired TX half, packed, to the DMA
+static void tx_hand_off(I2SBridge *bridge, size_t count) {
+    const uint8_t half = (uint8_t)bridge->tx_acquired;
+
+    bridge->tx_acquired = -1;
+    bridge->tx_next = half ^ 1;
+    bridge->stats.frames_transmitted++;
+    bridge->stats.packets_transmitted += count;
+    bridge->tx_ready.fetch_or((uint8_t)(1u << half));
+
+    // The DMA picks the half up when it gets there (platform-specific)
+#ifdef I2S_BRIDGE_LOOPBACK
+    const size_t slot_bytes = wire_slot_bytes(bridge->config.wire_format);
+    copy_wire_frames(wire_view(bridge, bridge->rx[half]), wire_view(bridge, bridge->tx[half]),
+                     bridge->stride * slot_bytes, I2S_CHANNELS * slot_bytes);
+    dma_buffer_done(bridge, half);
+#endif
+}
+
+bool i2s_commit_tx(I2SBridge *bridge, const ConsciousnessMetrics *metrics, size_t count) {
+    if (bridge == NULL || bridge->tx_acquired < 0 || (metrics == NULL && count > 0) ||
+        count > telemetry_max_packets(bridge)) {
+        return false;
+    }
+
+    int32_t *frame = bridge->tx[bridge->tx_acquired];
+
+    // Encode metrics into the telemetry lane
+    encode_metrics_to_frame(frame, bridge->stride, bridge->config.wire_format, metrics, count);
+    if (bridge->config.phi_sideband_decimation != 0) {
+        encode_phi_sideband(bridge, frame, count > 0 ? &metrics[count - 1] : NULL);
+    }
+    wire_pack(bridge->config.wire_format, frame, I2S_BUFFER_SIZE * I2S_CHANNELS);
+
+    tx_hand_off(bridge, count);
+
+    return true;
+}
+
+/**
+ * Take the RX half of the queue entry after rx_consumed, with produced
+ * entries completed (at least one more than consumed). With two halves
+ * only the newest is intact: the DMA is already writing into the one
+ * before it.
+ */
+static uint8_t rx_take(I2SBridge *bridge, uint32_t produced) {
+    const uint32_t pending = produced - bridge->rx_consumed;
+    if (pending > 1) {
+        bridge->stats.rx_overruns += pending - 1;
+        bridge->rx_consumed = produced - 1;
+    }
+    const uint8_t half = (uint8_t)(bridge->rx_consumed & 1);
+    bridge->rx_acquired = half;
+    bridge->stats.frames_received++;
+
+    return half;
+}
+
+const int32_t *i2s_acquire_rx(I2SBridge *bridge, ConsciousnessMetrics *metrics, size_t max_count,
+                              size_t *count) {
+    if (bridge == NULL || !bridge->running || bridge->rx_acquired >= 0 || (metrics == NULL && max_count > 0)) {
+        return NULL;
+    }
+
+    const uint32_t produced = bridge->rx_produced.load(std::memory_order_acquire);
+    if (produced == bridge->rx_consumed) {
+        return NULL;
+    }
+    const uint8_t half = rx_take(bridge, produced);
+
+    // Decode metrics from the telemetry lane
+    const size_t decoded = decode_metrics_from_frame(bridge, bridge->rx[half], metrics, max_count);
+    if (bridge->config.phi_sideband_decimation != 0) {
+        decode_phi_sideband(bridge, bridge->rx[half]);
+    }
+    if (count != NULL) {
+        *count = decoded;
+    }
+
+    return bridge->rx[half];
+}
+
+bool i2s_release_rx(I2SBridge *bridge) {
+    if (bridge == NULL || bridge->rx_acquired < 0) {
+        return false;
+    }
+
+    // The DMA came back to the half while it was held: the read was torn
+    if (bridge->rx_produced.load(std::memory_order_acquire) - bridge->rx_consumed > 1) {
+        bridge->stats.rx_overruns++;
+    }
+
+    bridge->rx_consumed++;
+    bridge->rx_acquired = -1;
+
+    return true;
+}
+
+size_t i2s_max_packets(I2SBridge *bridge) {
+    return bridge != NULL ? telemetry_max_packets(bridge) : 0;
+}
+
+bool i2s_set_tx_phi(I2SBridge *bridge, const float *phi_phase, const float *phi_depth) {
+    if (bridge == NULL || phi_phase == NULL || phi_depth == NULL || bridge->config.phi_sideband_decimation == 0) {
+        return false;
+    }
+
+    // Point j is the value at the last sample of its span
+    const size_t decimation = bridge->config.phi_sideband_decimation;
+    for (size_t j = 0; j < I2S_BUFFER_SIZE / decimation; j++) {
+        bridge->phi_tx_phase[j] = phi_quantize_phase(phi_phase[(j + 1) * decimation - 1]);
+        bridge->phi_tx_depth[j] = phi_quantize_depth(phi_depth[(j + 1) * decimation - 1]);
+    }
+    bridge->phi_tx_staged = true;
+
+    return true;
+}
+
+bool i2s_get_rx_phi(I2SBridge *bridge, float *phi_phase, float *phi_depth) {
+    if (bridge == NULL || phi_phase == NULL || bridge->config.phi_sideband_decimation == 0) {
+        return false;
+    }
+
+    memcpy(phi_phase, bridge->phi_rx_phase, sizeof(bridge->phi_rx_phase));
+    if (phi_depth != NULL) {
+        memcpy(phi_depth, bridge->phi_rx_depth, sizeof(bridge->phi_rx_depth));
+    }
+
+    return bridge->phi_rx_intact;
+}
+
+bool i2s_rx_available(I2SBridge *bridge) {
+    return bridge != NULL && bridge->running &&
+           bridge->rx_produced.load(std::memory_order_acquire) != bridge->rx_consumed;
+}
+
+bool i2s_wait_rx(I2SBridge *bridge, uint32_t timeout_ms) {
+    if (bridge == NULL || !bridge->running) {
+        return false;
+    }
+
+#ifdef TEENSY
+    const uint32_t start_ms = millis();
+    while (!i2s_rx_available(bridge)) {
+        if (millis() - start_ms >= timeout_ms) {
+            return false;
+        }
+        asm volatile("wfi"); // Sleep until the next interrupt
+    }
+    return true;
+#else
+    std::unique_lock<std::mutex> lock(bridge->rx_mutex);
+    return bridge->rx_signal.wait_for(lock, std::chrono::milliseconds(timeout_ms),
+                                      [bridge] { return i2s_rx_available(bridge); });
+#endif
+}
+
+bool i2s_set_buffer_callback(I2SBridge *bridge, I2SBufferCallback callback, void *context) {
+    if (bridge == NULL || bridge->running) {
+        return false;
+    }
+
+    bridge->buffer_callback = callback;
+    bridge->buffer_context = context;
+
+    return true;
+}
+
+bool i2s_set_gpio_sync(I2SBridge *bridge, bool enable) {
+    if (bridge == NULL) {
+        return false;
+    }
+
+    bridge->config.enable_gpio_sync = enable;
+
+#ifdef TEENSY
+    if (!enable) {
+        digitalWrite(bridge->config.gpio_sync_pin, LOW);
+    }
+#endif
+
+    return true;
+}
+
+bool i2s_get_statistics(I2SBridge *bridge, I2SStatistics *stats) {
+    if (bridge == NULL || stats == NULL) {
+        return false;
+    }
+
+    bridge->stats.clock_drift_ppm = sync_leader(bridge)->drift_ppm.load();
+    memcpy(stats, &bridge->stats, sizeof(I2SStatistics));
+    stats->diagnostics_dropped = bridge->diag_dropped.load(std::memory_order_relaxed);
+
+    // Calculate metrics loss rate (SC-002), should be < 0.001 (0.1%)
+    const uint64_t expected = bridge->stats.packets_received + bridge->stats.frames_dropped;
+    stats->loss_rate = expected > 0 ? (float)bridge->stats.frames_dropped / (float)expected : 0.0f;
+
+    return true;
+}
+
+bool i2s_reset_statistics(I2SBridge *bridge) {
+    if (bridge == NULL) {
+        return false;
+    }
+
+    bridge->stats.frames_transmitted = 0;
+    bridge->stats.frames_received = 0;
+    bridge->stats.frames_dropped = 0;
+    bridge->stats.packets_transmitted = 0;
+    bridge->stats.packets_received = 0;
+    bridge->stats.packets_corrupt = 0;
+    bridge->stats.tx_underruns = 0;
+    bridge->stats.rx_overruns = 0;
+    bridge->stats.asrc_slips = 0;
+    bridge->stats.uptime_ms = 0;
+    bridge->stats.failovers = 0;
+    bridge->stats.phi_sideband_received = 0;
+    bridge->stats.phi_sideband_corrupt = 0;
+    bridge->stats.phi_sideband_gaps = 0;
+    bridge->diag_dropped.store(0, std::memory_order_relaxed);
+    bridge->rx_sequence_valid = false;
+    bridge->health_received = 0;
+    bridge->health_corrupt = 0;
+
+    return true;
+}
+
+I2SLinkStatus i2s_get_link_status(I2SBridge *bridge) {
+    return bridge != NULL ? bridge->stats.link_status : I2S_LINK_DISCONNECTED;
+}
+
+bool i2s_set_standby(I2SBridge *bridge, int port) {
+    if (bridge == NULL || !bridge->initialized || bridge->running || port == (int)bridge->config.port ||
+        port > 0xFF) {
+        return false;
+    }
+    if (port >= 0 && !platform_i2s_init_port(bridge, (uint8_t)port)) {
+        return false;
+    }
+
+    bridge->standby_port = port < 0 ? -1 : port;
+    return true;
+}
+
+/**
+ * Restart a failed link (SC-003): on the standby port if there is one,
+ * the failed port standing by in its place, else on the same port. The
+ * DLL keeps its drift and phase estimates and the resampler primes again
+ * at that rate, so only the DMA has to lock again; the buffer queue
+ * carries on where the DMA stopped.
+ */
+static void link_failover(I2SBridge *bridge, uint32_t now_ms) {
+    platform_dma_stop(bridge);
+    if (bridge->standby_port >= 0) {
+        const uint8_t failed = bridge->config.port;
+        bridge->config.port = (uint8_t)bridge->standby_port;
+        bridge->standby_port = failed;
+        platform_i2s_init_port(bridge, failed);
+    }
+
+    // A second failure before the first recovered is an error
+    const bool retry = bridge->relocking;
+    if (!retry) {
+        bridge->relocking = true;
+        bridge->outage_start_ms = bridge->health_last_ms;
+    }
+    bridge->health_last_ms = now_ms;
+    bridge->stats.failovers++;
+    const bool started = platform_dma_start(bridge);
+    bridge->stats.link_status = started && !retry ? I2S_LINK_SYNCING : I2S_LINK_ERROR;
+
+    if (bridge->config.enable_diagnostics) {
+        firmware_log("[I2SBridge] Link failed, relocking on port %u\n", (unsigned)bridge->config.port);
+    }
+}
+
+I2SLinkStatus i2s_check_link(I2SBridge *bridge) {
+    if (bridge == NULL) {
+        return I2S_LINK_DISCONNECTED;
+    }
+    i2s_service_diagnostics(bridge);
+    if (!bridge->running) {
+        return bridge->stats.link_status;
+    }
+
+    const uint32_t now_ms = bridge_millis();
+    const uint32_t produced = bridge->rx_produced.load(std::memory_order_acquire);
+    if (produced != bridge->health_produced) {
+        bridge->health_produced = produced;
+        bridge->health_last_ms = now_ms;
+        if (bridge->relocking) {
+            // Back: errors from before the failure no longer count
+            bridge->relocking = false;
+            bridge->stats.recovery_ms = now_ms - bridge->outage_start_ms;
+            bridge->stats.crc_error_rate = 0.0f;
+            bridge->health_window_ms = now_ms;
+            bridge->health_received = bridge->stats.packets_received;
+            bridge->health_corrupt = bridge->stats.packets_corrupt;
+            if (bridge->config.enable_diagnostics) {
+                firmware_log("[I2SBridge] Link relocked after %u ms\n", (unsigned)bridge->stats.recovery_ms);
+            }
+        }
+    }
+
+    // Missed-DMA watchdog; a group link cannot restart alone
+    const uint32_t silent_ms = now_ms - bridge->health_last_ms;
+    if (silent_ms >= (uint32_t)(HEALTH_WATCHDOG_HALVES * HEALTH_HALF_MS)) {
+        if (bridge->group != NULL) {
+            bridge->stats.link_status = I2S_LINK_ERROR;
+        } else {
+            link_failover(bridge, now_ms);
+        }
+        return bridge->stats.link_status;
+    }
+    if (bridge->relocking) {
+        return bridge->stats.link_status;
+    }
+
+    // CRC error rate over the last window
+    if (now_ms - bridge->health_window_ms >= HEALTH_WINDOW_MS) {
+        const uint64_t corrupt = bridge->stats.packets_corrupt - bridge->health_corrupt;
+        const uint64_t checked = corrupt + bridge->stats.packets_received - bridge->health_received;
+        bridge->stats.crc_error_rate = checked > 0 ? (float)corrupt / (float)checked : 0.0f;
+        bridge->health_window_ms = now_ms;
+        bridge->health_received = bridge->stats.packets_received;
+        bridge->health_corrupt = bridge->stats.packets_corrupt;
+        if (bridge->stats.crc_error_rate > HEALTH_FAILED_CRC && bridge->group == NULL) {
+            link_failover(bridge, now_ms);
+            return bridge->stats.link_status;
+        }
+    }
+
+    const bool late = silent_ms >= (uint32_t)(HEALTH_LATE_HALVES * HEALTH_HALF_MS);
+    bridge->stats.link_status = late || bridge->stats.crc_error_rate > HEALTH_DEGRADED_CRC ? I2S_LINK_DEGRADED
+                                                                                            : I2S_LINK_STABLE;
+    return bridge->stats.link_status;
+}
+
+// Self-test pattern: alternating full-scale samples
+static int32_t self_test_sample(int index) {
+    return (index % 2) ? 0x7FFFFF : -0x800000;
+}
+
+static int compare_float(const void *a, const void *b) {
+    const float x = *(const float *)a;
+    const float y = *(const float *)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted values
+static float percentile(const float *sorted, uint32_t count, float fraction) {
+    uint32_t rank = (uint32_t)ceilf(fraction * count);
+    if (rank < 1) {
+        rank = 1;
+    }
+    return sorted[rank - 1];
+}
+
+bool i2s_self_test_report(I2SBridge *bridge, I2SLatencyReport *report) {
+    if (bridge == NULL || !bridge->running || report == NULL) {
+        return false;
+    }
+
+    // FR-010: Loopback self-test
+    // Configure loopback mode (connect TX to RX)
+
+    memset(report, 0, sizeof(*report));
+    report->rounds = SELF_TEST_ROUNDS;
+    bool intact = true;
+    float *rtt_ns = bridge->self_test_rtt_ns;
+
+    for (uint32_t i = 0; i < SELF_TEST_ROUNDS; i++) {
+        int32_t *frame = i2s_acquire_tx(bridge);
+        if (frame == NULL) {
+            intact = false;
+            break;
+        }
+
+        // Test pattern, once per half: later rounds only rewrite the lane,
+        // unless packing in place took the last one apart
+        if (i < 2 || bridge->config.wire_format != I2S_WIRE_24_IN_32) {
+            for (int f = 0; f < I2S_BUFFER_SIZE; f++) {
+                for (int ch = 0; ch < I2S_CHANNELS; ch++) {
+                    frame[f * bridge->stride + ch] = self_test_sample(f * I2S_CHANNELS + ch);
+                }
+            }
+        }
+
+        // The marker carries its transmit tick in timestamp_us
+        ConsciousnessMetrics marker = {
+            .phi_phase = 3.14159f,
+            .phi_depth = 0.5f,
+            .coherence = 0.95f,
+            .criticality = 1.0f,
+            .ici = 100.0f,
+            .timestamp_us = bridge_ticks(),
+            .sequence = i
+        };
+        i2s_commit_tx(bridge, &marker, 1);
+
+        if (!i2s_wait_rx(bridge, SELF_TEST_TIMEOUT_MS)) {
+            continue;
+        }
+        ConsciousnessMetrics received;
+        size_t count = 0;
+        const int32_t *rx = i2s_acquire_rx(bridge, &received, 1, &count);
+        if (rx == NULL) {
+            continue;
+        }
+        if (count == 1 && received.sequence == marker.sequence && received.ici == marker.ici) {
+            const uint32_t ticks = bridge->rx_capture_ticks[bridge->rx_acquired] - received.timestamp_us;
+            rtt_ns[report->received++] = (float)bridge_ticks_to_ns(ticks);
+        }
+#ifdef I2S_BRIDGE_LOOPBACK
+        // The software loopback returns this very frame
+        if (rx[I2S_AUDIO_CHANNELS - 1] != self_test_sample(I2S_AUDIO_CHANNELS - 1)) {
+            intact = false;
+        }
+#endif
+        i2s_release_rx(bridge);
+    }
+
+    const uint32_t n = report->received;
+    if (n > 0) {
+        // Mean and jitter (sample standard deviation) in nanoseconds
+        double sum = 0.0;
+        for (uint32_t i = 0; i < n; i++) {
+            sum += rtt_ns[i];
+        }
+        const double mean_ns = sum / n;
+
+        double variance_sum = 0.0;
+        for (uint32_t i = 0; i < n; i++) {
+            const double diff = rtt_ns[i] - mean_ns;
+            variance_sum += diff * diff;
+        }
+        const double jitter_ns = n > 1 ? sqrt(variance_sum / (n - 1)) : 0.0;
+
+        qsort(rtt_ns, n, sizeof(float), compare_float);
+        report->min_us = rtt_ns[0] / 1000.0f;
+        report->p50_us = percentile(rtt_ns, n, 0.50f) / 1000.0f;
+        report->p99_us = percentile(rtt_ns, n, 0.99f) / 1000.0f;
+        report->max_us = rtt_ns[n - 1] / 1000.0f;
+        report->mean_us = (float)(mean_ns / 1000.0);
+        report->jitter_us = (float)(jitter_ns / 1000.0);
+    }
+
+    bridge->stats.latency_us = (uint32_t)(report->mean_us + 0.5f);
+    bridge->stats.jitter_us = (uint32_t)(report->jitter_us + 0.5f);
+
+    // SC-001: Verify latency ≤40 µs and jitter ≤5 µs
+    report->meets_sc001 = intact && n == SELF_TEST_ROUNDS && report->p99_us <= 40.0f &&
+                          report->jitter_us <= 5.0f;
+    if (bridge->config.enable_diagnostics) {
+        firmware_log("[I2SBridge] Loopback self-test: min %.1f / p50 %.1f / p99 %.1f / max %.1f µs, "
+                     "%.1f µs jitter (SC-001: %s)\n",
+                     report->min_us, report->p50_us, report->p99_us, report->max_us, report->jitter_us,
+                     report->meets_sc001 ? "PASS" : "FAIL");
+        if (!intact || n != SELF_TEST_ROUNDS) {
+            firmware_log("[I2SBridge] Loopback self-test: %u of %u markers back, frame %s\n",
+                         (unsigned)n, (unsigned)SELF_TEST_ROUNDS, intact ? "intact" : "corrupted");
+        }
+    }
+    return report->meets_sc001;
+}
+
+bool i2s_self_test(I2SBridge *bridge, uint32_t *latency_us, uint32_t *jitter_us) {
+    if (bridge == NULL) {
+        return false;
+    }
+
+    I2SLatencyReport report;
+    const bool passed = i2s_self_test_report(bridge, &report);
+
+    *latency_us = bridge->stats.latency_us;
+    *jitter_us = bridge->stats.jitter_us;
+
+    return passed;
+}
+
+bool i2s_send_diagnostic(I2SBridge *bridge, const char *message) {
+    if (bridge == NULL || message == NULL || !bridge->config.enable_diagnostics) {
+        return false;
+    }
+    size_t length = 0;
+    while (length < I2S_DIAGNOSTIC_LINE_MAX - 1 && message[length] != '\0') {
+        length++;
+    }
+
+    uint32_t pos = bridge->diag_tx_head.load(std::memory_order_relaxed);
+    I2SDiagLine *line;
+    for (;;) {
+        line = &bridge->diag_tx[pos & DIAG_TX_MASK];
+        const int32_t lag = (int32_t)(line->sequence.load(std::memory_order_acquire) - (pos & ~DIAG_TX_MASK));
+        if (lag == 0) {
+            if (bridge->diag_tx_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (lag < 0) {
+            // Queue full: the port is detached or slower than the senders
+            bridge->diag_dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = bridge->diag_tx_head.load(std::memory_order_relaxed);
+        }
+    }
+
+    memcpy(line->text, message, length);
+    line->text[length] = '\n';
+    line->length = (uint16_t)(length + 1);
+    line->sequence.store((pos & ~DIAG_TX_MASK) + 1, std::memory_order_release);
+    return true;
+}
+
+// Appends a received line to the RX queue; false if it is full
+static bool diag_rx_push(I2SBridge *bridge, const char *text, size_t length) {
+    const uint32_t write = bridge->diag_rx_write.load(std::memory_order_relaxed);
+    if (write - bridge->diag_rx_read.load(std::memory_order_acquire) >= DIAG_RX_LINES) {
+        return false;
+    }
+    I2SDiagLine *line = &bridge->diag_rx[write & DIAG_RX_MASK];
+    memcpy(line->text, text, length);
+    line->length = (uint16_t)length;
+    bridge->diag_rx_write.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+// Writes what the port has room for of a queued line; true once all of it
+// is out. Lines wait while no host is attached.
+static bool diag_port_write(I2SBridge *bridge, const I2SDiagLine *line) {
+#ifdef TEENSY
+    if (!Serial) {
+        return false;
+    }
+    const size_t left = line->length - bridge->diag_tx_offset;
+    const int room = Serial.availableForWrite();
+    const size_t n = room > 0 ? ((size_t)room < left ? (size_t)room : left) : 0;
+    if (n > 0) {
+        Serial.write((const uint8_t *)line->text + bridge->diag_tx_offset, n);
+        bridge->diag_tx_offset += n;
+    }
+    if (bridge->diag_tx_offset < line->length) {
+        return false;
+    }
+    bridge->diag_tx_offset = 0;
+    return true;
+#elif defined(I2S_BRIDGE_LOOPBACK)
+    if (!diag_rx_push(bridge, line->text, line->length - 1)) {
+        bridge->diag_dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+    return true;
+#else
+    // No port off-target: the line is consumed unsent
+    (void)bridge;
+    (void)line;
+    return true;
+#endif
+}
+
+// Collects the bytes the port already received into lines, as long as the
+// RX queue has room; the rest waits in the port's own buffer
+static void diag_port_read(I2SBridge *bridge) {
+#ifdef TEENSY
+    while (Serial.available() > 0) {
+        if (bridge->diag_rx_write.load(std::memory_order_relaxed) -
+            bridge->diag_rx_read.load(std::memory_order_acquire) >= DIAG_RX_LINES) {
+            return;
+        }
+        const int c = Serial.read();
+        if (c < 0) {
+            return;
+        }
+        if (c == '\r') {
+            continue;
+        }
+        if (c != '\n') {
+            bridge->diag_rx_partial[bridge->diag_rx_length++] = (char)c;
+        }
+        if (c == '\n' || bridge->diag_rx_length == I2S_DIAGNOSTIC_LINE_MAX - 1) {
+            diag_rx_push(bridge, bridge->diag_rx_partial, bridge->diag_rx_length);
+            bridge->diag_rx_length = 0;
+        }
+    }
+#else
+    (void)bridge;
+#endif
+}
+
+size_t i2s_service_diagnostics(I2SBridge *bridge) {
+    if (bridge == NULL || !bridge->config.enable_diagnostics) {
+        return 0;
+    }
+    if (bridge->diag_servicing.test_and_set(std::memory_order_acquire)) {
+        return 0;
+    }
+
+    size_t written = 0;
+    for (;;) {
+        I2SDiagLine *line = &bridge->diag_tx[bridge->diag_tx_tail & DIAG_TX_MASK];
+        const uint32_t lap = bridge->diag_tx_tail & ~DIAG_TX_MASK;
+        if (line->sequence.load(std::memory_order_acquire) != lap + 1 || !diag_port_write(bridge, line)) {
+            break;      // Empty, still being written, or the port is full or detached
+        }
+        line->sequence.store(lap + DIAG_TX_LINES, std::memory_order_release);
+        bridge->diag_tx_tail++;
+        written++;
+    }
+    diag_port_read(bridge);
+
+    bridge->diag_servicing.clear(std::memory_order_release);
+    return written;
+}
+
+bool i2s_diagnostic_available(I2SBridge *bridge) {
+    if (bridge == NULL || !bridge->config.enable_diagnostics) {
+        return false;
+    }
+    i2s_service_diagnostics(bridge);
+    return bridge->diag_rx_write.load(std::memory_order_acquire) !=
+           bridge->diag_rx_read.load(std::memory_order_relaxed);
+}
+
+int i2s_read_diagnostic(I2SBridge *bridge, char *buffer, size_t max_len) {
+    if (bridge == NULL || buffer == NULL || max_len == 0 || !bridge->config.enable_diagnostics) {
+        return -1;
+    }
+    i2s_service_diagnostics(bridge);
+
+    const uint32_t read = bridge->diag_rx_read.load(std::memory_order_relaxed);
+    if (bridge->diag_rx_write.load(std::memory_order_acquire) == read) {
+        return -1;
+    }
+    const I2SDiagLine *line = &bridge->diag_rx[read & DIAG_RX_MASK];
+    const size_t n = line->length < max_len - 1 ? line->length : max_len - 1;
+    memcpy(buffer, line->text, n);
+    buffer[n] = '\0';
+    bridge->diag_rx_read.store(read + 1, std::memory_order_release);
+    return (int)n;
+}
+
+void i2s_sync_pulse(I2SBridge *bridge, uint32_t timestamp_us) {
+    if (bridge == NULL) {
+        return;
+    }
+
+    // FR-005: DLL update, interrupt context; a group follows its leader
+    I2SBridge *dll = sync_leader(bridge);
+    if (!dll->dll_locked) {
+        dll->dll_next_us = timestamp_us + (uint32_t)DLL_NOMINAL_PERIOD_US;
+        dll->dll_next_frac = 0.0f;
+        dll->dll_locked = true;
+        return;
+    }
+
+    const float error = (float)(int32_t)(timestamp_us - dll->dll_next_us) - dll->dll_next_frac;
+    float next;
+    if (fabsf(error) > DLL_MAX_ERROR_US) {
+        // Missed or spurious pulse: lock again from this one, keep the period
+        dll->dll_next_us = timestamp_us;
+        next = dll->dll_period_offset_us;
+    } else {
+        // Critically damped second-order loop
+        const float omega = 2.0f * 3.14159265f * DLL_BANDWIDTH_HZ / GPIO_SYNC_FREQ_HZ;
+        next = dll->dll_next_frac + dll->dll_period_offset_us + 1.41421356f * omega * error;
+        dll->dll_period_offset_us += omega * omega * error;
+    }
+
+    const float whole = floorf(next);
+    dll->dll_next_us += (uint32_t)DLL_NOMINAL_PERIOD_US + (uint32_t)(int32_t)whole;
+    dll->dll_next_frac = next - whole;
+
+    // A remote clock running fast sends its pulses early
+    dll->drift_ppm.store(-dll->dll_period_offset_us / (DLL_NOMINAL_PERIOD_US + dll->dll_period_offset_us) * 1e6f);
+}
+
+float i2s_calibrate_drift(I2SBridge *bridge) {
+    // FR-005: Continuous estimate from the sync pulse DLL
+
+    if (bridge == NULL || !sync_leader(bridge)->config.enable_gpio_sync) {
+        return 0.0f;
+    }
+
+    const float drift_ppm = sync_leader(bridge)->drift_ppm.load();
+    bridge->stats.clock_drift_ppm = drift_ppm;
 
     return drift_ppm;
-#else
-    return 0.0f;
-#endif
 }
 
 const char* i2s_bridge_get_version(void) {
     return FIRMWARE_VERSION;
 }
+
+// Link groups
+
+I2SBridgeGroup* i2s_group_create(I2SBridge *const *links, size_t count) {
+    if (links == NULL || count == 0 || count > I2S_MAX_LINKS) {
+        return NULL;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        const I2SBridge *link = links[i];
+        if (link == NULL || !link->initialized || link->running || link->group != NULL ||
+            link->config.enable_drift_compensation) {
+            return NULL;
+        }
+        // Followers run on the leader's clocks, slots alike
+        if (i > 0 && (link->config.mode != I2S_MODE_SLAVE ||
+                      link->config.wire_format != links[0]->config.wire_format)) {
+            return NULL;
+        }
+        for (size_t j = 0; j < i; j++) {
+            if (links[j] == link) {
+                return NULL;
+            }
+        }
+    }
+
+    I2SBridgeGroup *group = new (std::nothrow) I2SBridgeGroup();
+    if (group == NULL) {
+        return NULL;
+    }
+    group->count = count;
+    group->channels = count * I2S_CHANNELS;
+
+    const size_t half_samples = I2S_BUFFER_SIZE * group->channels;
+    group->buffer = new (std::nothrow) int32_t[4 * half_samples]();
+    if (group->buffer == NULL) {
+        delete group;
+        return NULL;
+    }
+    for (int h = 0; h < 2; h++) {
+        group->tx[h] = group->buffer + h * half_samples;
+        group->rx[h] = group->buffer + (2 + h) * half_samples;
+    }
+
+    // Each link's halves become its channels of the aggregate halves
+    for (size_t i = 0; i < count; i++) {
+        I2SBridge *link = links[i];
+        group->links[i] = link;
+        for (int h = 0; h < 2; h++) {
+            link->tx[h] = group->tx[h] + i * I2S_CHANNELS;
+            link->rx[h] = group->rx[h] + i * I2S_CHANNELS;
+        }
+        link->stride = group->channels;
+        link->group = group;
+        link->group_index = i;
+    }
+
+    return group;
+}
+
+void i2s_group_destroy(I2SBridgeGroup *group) {
+    if (group == NULL) {
+        return;
+    }
+
+    i2s_group_stop(group);
+    for (size_t i = 0; i < group->count; i++) {
+        I2SBridge *link = group->links[i];
+        for (int h = 0; h < 2; h++) {
+            link->tx[h] = link->own_tx[h];
+            link->rx[h] = link->own_rx[h];
+        }
+        link->stride = I2S_CHANNELS;
+        link->group = NULL;
+        link->group_index = 0;
+    }
+    delete[] group->buffer;
+    delete group;
+}
+
+size_t i2s_group_channels(const I2SBridgeGroup *group) {
+    return group != NULL ? group->channels : 0;
+}
+
+bool i2s_group_start(I2SBridgeGroup *group) {
+    if (group == NULL) {
+        return false;
+    }
+
+    // Followers wait for the clocks, so the leader starting last starts
+    // every link on the same frame
+    for (size_t i = group->count; i-- > 0;) {
+        if (!i2s_start(group->links[i])) {
+            for (size_t j = i + 1; j < group->count; j++) {
+                i2s_stop(group->links[j]);
+            }
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool i2s_group_stop(I2SBridgeGroup *group) {
+    if (group == NULL) {
+        return false;
+    }
+
+    // Leader first: its clocks stop every follower on the same frame
+    bool stopped = false;
+    for (size_t i = 0; i < group->count; i++) {
+        stopped = i2s_stop(group->links[i]) || stopped;
+    }
+
+    return stopped;
+}
+
+int32_t *i2s_group_acquire_tx(I2SBridgeGroup *group) {
+    if (group == NULL) {
+        return NULL;
+    }
+
+    // The links run in lockstep; hand out a half only when every link has it
+    const uint8_t half = group->links[0]->tx_next;
+    for (size_t i = 0; i < group->count; i++) {
+        const I2SBridge *link = group->links[i];
+        if (!link->running || link->tx_acquired >= 0 || link->tx_next != half ||
+            !(link->tx_free.load() & (1u << half))) {
+            return NULL;
+        }
+    }
+    for (size_t i = 0; i < group->count; i++) {
+        i2s_acquire_tx(group->links[i]);
+    }
+
+    return group->tx[half];
+}
+
+bool i2s_group_commit_tx(I2SBridgeGroup *group, const ConsciousnessMetrics *metrics, size_t count) {
+    I2SBridge *leader = group != NULL ? group->links[0] : NULL;
+    if (leader == NULL || leader->tx_acquired < 0 || (metrics == NULL && count > 0) ||
+        count > telemetry_max_packets(leader)) {
+        return false;
+    }
+
+    // The leader's lane carries the packets, the followers' lanes idle;
+    // the aggregate is packed once for all links
+    const uint8_t half = (uint8_t)leader->tx_acquired;
+    for (size_t i = 0; i < group->count; i++) {
+        I2SBridge *link = group->links[i];
+        encode_metrics_to_frame(link->tx[half], link->stride, link->config.wire_format,
+                                i == 0 ? metrics : NULL, i == 0 ? count : 0);
+    }
+    if (leader->config.phi_sideband_decimation != 0) {
+        encode_phi_sideband(leader, leader->tx[half], count > 0 ? &metrics[count - 1] : NULL);
+    }
+    wire_pack(leader->config.wire_format, group->tx[half], I2S_BUFFER_SIZE * group->channels);
+
+    for (size_t i = group->count; i-- > 1;) {
+        tx_hand_off(group->links[i], 0);
+    }
+    tx_hand_off(leader, count);
+
+    return true;
+}
+
+// Halves every link has completed
+static uint32_t group_produced(const I2SBridgeGroup *group) {
+    uint32_t produced = group->links[0]->rx_produced.load(std::memory_order_acquire);
+    for (size_t i = 1; i < group->count; i++) {
+        const uint32_t link_produced = group->links[i]->rx_produced.load(std::memory_order_acquire);
+        if ((int32_t)(link_produced - produced) < 0) {
+            produced = link_produced;
+        }
+    }
+    return produced;
+}
+
+const int32_t *i2s_group_acquire_rx(I2SBridgeGroup *group, ConsciousnessMetrics *metrics, size_t max_count,
+                                    size_t *count) {
+    if (group == NULL || (metrics == NULL && max_count > 0)) {
+        return NULL;
+    }
+    for (size_t i = 0; i < group->count; i++) {
+        if (!group->links[i]->running || group->links[i]->rx_acquired >= 0) {
+            return NULL;
+        }
+    }
+
+    // Take the same half of every link
+    const uint32_t produced = group_produced(group);
+    if (produced == group->links[0]->rx_consumed) {
+        return NULL;
+    }
+    uint8_t half = 0;
+    for (size_t i = 0; i < group->count; i++) {
+        half = rx_take(group->links[i], produced);
+    }
+
+    I2SBridge *leader = group->links[0];
+    wire_unpack(leader->config.wire_format, group->rx[half], I2S_BUFFER_SIZE * group->channels);
+    const size_t decoded = decode_metrics_from_frame(leader, leader->rx[half], metrics, max_count);
+    if (leader->config.phi_sideband_decimation != 0) {
+        decode_phi_sideband(leader, leader->rx[half]);
+    }
+    if (count != NULL) {
+        *count = decoded;
+    }
+
+    return group->rx[half];
+}
+
+bool i2s_group_release_rx(I2SBridgeGroup *group) {
+    if (group == NULL || group->links[0]->rx_acquired < 0) {
+        return false;
+    }
+
+    for (size_t i = 0; i < group->count; i++) {
+        i2s_release_rx(group->links[i]);
+    }
+
+    return true;
+}
+
+bool i2s_group_rx_available(I2SBridgeGroup *group) {
+    if (group == NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < group->count; i++) {
+        if (!group->links[i]->running) {
+            return false;
+        }
+    }
+
+    return group_produced(group) != group->links[0]->rx_consumed;
+}
+
+bool i2s_group_wait_rx(I2SBridgeGroup *group, uint32_t timeout_ms) {
+    if (group == NULL) {
+        return false;
+    }
+
+    // Every link's half, within one timeout overall
+    const uint32_t start_ms = bridge_millis();
+    for (size_t i = 0; i < group->count; i++) {
+        const uint32_t elapsed_ms = bridge_millis() - start_ms;
+        if (!i2s_wait_rx(group->links[i], elapsed_ms < timeout_ms ? timeout_ms - elapsed_ms : 0)) {
+            return false;
+        }
+    }
+
+    return i2s_group_rx_available(group);
+}
+
+// Telemetry forwarding
+
+#ifdef I2S_BRIDGE_FORWARDING
+// Send the queued packets, batch_packets per datagram; with flush the
+// last datagram may be short, otherwise a partial batch stays queued
+static void forward_send(I2SForwarder *forwarder, bool flush) {
+    const size_t batch = forwarder->batch_packets;
+    for (;;) {
+        const uint32_t read = forwarder->ring_read.load(std::memory_order_relaxed);
+        const uint32_t pending = forwarder->ring_write.load(std::memory_order_acquire) - read;
+        size_t datagrams = pending / batch + (flush && pending % batch != 0 ? 1 : 0);
+        if (datagrams == 0) {
+            return;
+        }
+        if (datagrams > FORWARD_MAX_DATAGRAMS) {
+            datagrams = FORWARD_MAX_DATAGRAMS;
+        }
+
+        struct timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        const double send_time = (double)now.tv_sec + now.tv_nsec * 1e-9;
+        uint64_t time_bits;
+        memcpy(&time_bits, &send_time, sizeof(time_bits));
+
+        size_t taken = 0;
+        size_t message_count = 0;
+        for (size_t d = 0; d < datagrams; d++) {
+            const size_t count = pending - taken < batch ? pending - taken : batch;
+            uint8_t *datagram = forwarder->datagrams[d];
+            memcpy(datagram, forwarder->header, forwarder->header_bytes);
+            datagram[4] = (uint8_t)count;
+            put_u32(&datagram[8], (uint32_t)time_bits);
+            put_u32(&datagram[12], (uint32_t)(time_bits >> 32));
+            uint8_t *packets = datagram + forwarder->header_bytes;
+            for (size_t p = 0; p < count; p++) {
+                memcpy(packets + p * I2S_FORWARD_PACKET_BYTES,
+                       forwarder->ring[(read + taken + p) & FORWARD_RING_MASK], I2S_FORWARD_PACKET_BYTES);
+            }
+            taken += count;
+
+            forwarder->iov[d].iov_base = datagram;
+            forwarder->iov[d].iov_len = forwarder->header_bytes + count * I2S_FORWARD_PACKET_BYTES;
+            for (size_t peer = 0; peer < forwarder->peer_count; peer++) {
+                struct mmsghdr *message = &forwarder->messages[message_count++];
+                memset(message, 0, sizeof(*message));
+                message->msg_hdr.msg_name = &forwarder->peers[peer];
+                message->msg_hdr.msg_namelen = sizeof(forwarder->peers[peer]);
+                message->msg_hdr.msg_iov = &forwarder->iov[d];
+                message->msg_hdr.msg_iovlen = 1;
+            }
+        }
+        forwarder->ring_read.store(read + (uint32_t)taken, std::memory_order_release);
+
+        // A refused datagram is skipped rather than retried
+        size_t sent = 0;
+        while (sent < message_count) {
+            const int result = sendmmsg(forwarder->socket_fd, &forwarder->messages[sent],
+                                        (unsigned int)(message_count - sent), 0);
+            forwarder->send_calls.fetch_add(1, std::memory_order_relaxed);
+            if (result < 0) {
+                if (errno != EINTR) {
+                    forwarder->send_errors.fetch_add(1, std::memory_order_relaxed);
+                    sent++;
+                }
+                continue;
+            }
+            for (size_t i = sent; i < sent + (size_t)result; i++) {
+                const size_t length = forwarder->messages[i].msg_hdr.msg_iov->iov_len;
+                forwarder->packets_forwarded.fetch_add((length - forwarder->header_bytes) / I2S_FORWARD_PACKET_BYTES,
+                                                       std::memory_order_relaxed);
+            }
+            forwarder->datagrams_sent.fetch_add((uint64_t)result, std::memory_order_relaxed);
+            sent += (size_t)result;
+        }
+    }
+}
+
+// Forwarding thread: full batches as soon as they are queued, a partial one
+// once it has waited max_delay_ms, everything on stop
+static void forward_run(I2SForwarder *forwarder) {
+    bool waiting = false;
+    uint32_t waiting_since_ms = 0;
+    std::unique_lock<std::mutex> lock(forwarder->mutex);
+    while (!forwarder->stop) {
+        lock.unlock();
+        const uint32_t pending_before = forwarder->ring_write.load(std::memory_order_acquire) -
+                                        forwarder->ring_read.load(std::memory_order_relaxed);
+        if (pending_before >= forwarder->batch_packets) {
+            forward_send(forwarder, false);
+            waiting = false;
+        }
+        const uint32_t pending = forwarder->ring_write.load(std::memory_order_acquire) -
+                                 forwarder->ring_read.load(std::memory_order_relaxed);
+        if (pending == 0) {
+            waiting = false;
+        } else if (!waiting) {
+            waiting = true;
+            waiting_since_ms = bridge_millis();
+        }
+        if (waiting && bridge_millis() - waiting_since_ms >= forwarder->max_delay_ms) {
+            forward_send(forwarder, true);
+            waiting = false;
+        }
+        lock.lock();
+        forwarder->wake.wait_for(lock, std::chrono::milliseconds(1), [forwarder] { return forwarder->stop; });
+    }
+    lock.unlock();
+    forward_send(forwarder, true);
+}
+
+bool i2s_forward_start(I2SBridge *bridge, const I2SForwardConfig *config) {
+    if (bridge == NULL || config == NULL || bridge->running || bridge->forwarder != NULL ||
+        config->node_id == NULL || config->peer_count == 0 || config->peer_count > I2S_FORWARD_MAX_PEERS ||
+        config->batch_packets == 0 || config->batch_packets > I2S_FORWARD_MAX_BATCH) {
+        return false;
+    }
+    const size_t node_id_bytes = strlen(config->node_id);
+    if (node_id_bytes > I2S_FORWARD_NODE_ID_MAX) {
+        return false;
+    }
+
+    I2SForwarder *forwarder = new (std::nothrow) I2SForwarder();
+    if (forwarder == NULL) {
+        return false;
+    }
+    forwarder->batch_packets = config->batch_packets;
+    forwarder->max_delay_ms = config->max_delay_ms;
+
+    for (size_t i = 0; i < config->peer_count; i++) {
+        struct addrinfo hints;
+        memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        struct addrinfo *found = NULL;
+        if (config->peers[i].address == NULL || getaddrinfo(config->peers[i].address, NULL, &hints, &found) != 0) {
+            if (bridge->config.enable_diagnostics) {
+                firmware_log("[I2SBridge] Forwarding peer %u not found\n", (unsigned)i);
+            }
+            delete forwarder;
+            return false;
+        }
+        memcpy(&forwarder->peers[i], found->ai_addr, sizeof(forwarder->peers[i]));
+        forwarder->peers[i].sin_port = htons(config->peers[i].port);
+        freeaddrinfo(found);
+    }
+    forwarder->peer_count = config->peer_count;
+
+    uint8_t *header = forwarder->header;
+    header[0] = 'P';
+    header[1] = 'N';
+    header[2] = 'B';
+    header[3] = 1;
+    header[5] = (uint8_t)node_id_bytes;
+    memcpy(&header[FORWARD_HEADER_BYTES], config->node_id, node_id_bytes);
+    forwarder->header_bytes = FORWARD_HEADER_BYTES + node_id_bytes;
+
+    forwarder->socket_fd = socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+    if (forwarder->socket_fd < 0) {
+        if (bridge->config.enable_diagnostics) {
+            firmware_log("[I2SBridge] Forwarding socket failed\n");
+        }
+        delete forwarder;
+        return false;
+    }
+
+    forwarder->thread = std::thread(forward_run, forwarder);
+    bridge->forwarder = forwarder;
+    return true;
+}
+
+bool i2s_forward_stop(I2SBridge *bridge) {
+    if (bridge == NULL || bridge->running || bridge->forwarder == NULL) {
+        return false;
+    }
+    I2SForwarder *forwarder = bridge->forwarder;
+    {
+        std::lock_guard<std::mutex> lock(forwarder->mutex);
+        forwarder->stop = true;
+    }
+    forwarder->wake.notify_all();
+    forwarder->thread.join();
+    close(forwarder->socket_fd);
+    delete forwarder;
+    bridge->forwarder = NULL;
+    return true;
+}
+
+bool i2s_forward_get_statistics(I2SBridge *bridge, I2SForwardStats *stats) {
+    if (bridge == NULL || stats == NULL || bridge->forwarder == NULL) {
+        return false;
+    }
+    const I2SForwarder *forwarder = bridge->forwarder;
+    stats->packets_forwarded = forwarder->packets_forwarded.load(std::memory_order_relaxed);
+    stats->datagrams_sent = forwarder->datagrams_sent.load(std::memory_order_relaxed);
+    stats->send_calls = forwarder->send_calls.load(std::memory_order_relaxed);
+    stats->packets_dropped = forwarder->packets_dropped.load(std::memory_order_relaxed);
+    stats->send_errors = forwarder->send_errors.load(std::memory_order_relaxed);
+    return true;
+}
+#else
+bool i2s_forward_start(I2SBridge *bridge, const I2SForwardConfig *config) {
+    (void)bridge;
+    (void)config;
+    return false;
+}
+
+bool i2s_forward_stop(I2SBridge *bridge) {
+    (void)bridge;
+    return false;
+}
+
+bool i2s_forward_get_statistics(I2SBridge *bridge, I2SForwardStats *stats) {
+    (void)bridge;
+    (void)stats;
+    return false;
+}
+#endif
+
+// Default bridge
+
+bool i2s_bridge_init(const I2SBridgeConfig *config) {
+    return i2s_init(&g_default_bridge, config);
+}
+
+bool i2s_bridge_start(void) {
+    return i2s_start(&g_default_bridge);
+}
+
+bool i2s_bridge_stop(void) {
+    return i2s_stop(&g_default_bridge);
+}
+
+bool i2s_bridge_transmit(const int32_t *audio_data, const ConsciousnessMetrics *metrics) {
+    return i2s_transmit(&g_default_bridge, audio_data, metrics);
+}
+
+bool i2s_bridge_transmit_packets(const int32_t *audio_data, const ConsciousnessMetrics *metrics,
+                                 size_t count) {
+    return i2s_transmit_packets(&g_default_bridge, audio_data, metrics, count);
+}
+
+bool i2s_bridge_receive(int32_t *audio_data, ConsciousnessMetrics *metrics) {
+    return i2s_receive(&g_default_bridge, audio_data, metrics);
+}
+
+int i2s_bridge_receive_packets(int32_t *audio_data, ConsciousnessMetrics *metrics, size_t max_count) {
+    return i2s_receive_packets(&g_default_bridge, audio_data, metrics, max_count);
+}
+
+int32_t *i2s_bridge_acquire_tx(void) {
+    return i2s_acquire_tx(&g_default_bridge);
+}
+
+bool i2s_bridge_commit_tx(const ConsciousnessMetrics *metrics, size_t count) {
+    return i2s_commit_tx(&g_default_bridge, metrics, count);
+}
+
+const int32_t *i2s_bridge_acquire_rx(ConsciousnessMetrics *metrics, size_t max_count, size_t *count) {
+    return i2s_acquire_rx(&g_default_bridge, metrics, max_count, count);
+}
+
+bool i2s_bridge_release_rx(void) {
+    return i2s_release_rx(&g_default_bridge);
+}
+
+size_t i2s_bridge_max_packets(void) {
+    return i2s_max_packets(&g_default_bridge);
+}
+
+bool i2s_bridge_set_tx_phi(const float *phi_phase, const float *phi_depth) {
+    return i2s_set_tx_phi(&g_default_bridge, phi_phase, phi_depth);
+}
+
+bool i2s_bridge_get_rx_phi(float *phi_phase, float *phi_depth) {
+    return i2s_get_rx_phi(&g_default_bridge, phi_phase, phi_depth);
+}
+
+bool i2s_bridge_rx_available(void) {
+    return i2s_rx_available(&g_default_bridge);
+}
+
+bool i2s_bridge_wait_rx(uint32_t timeout_ms) {
+    return i2s_wait_rx(&g_default_bridge, timeout_ms);
+}
+
+bool i2s_bridge_set_buffer_callback(I2SBufferCallback callback, void *context) {
+    return i2s_set_buffer_callback(&g_default_bridge, callback, context);
+}
+
+bool i2s_bridge_set_gpio_sync(bool enable) {
+    return i2s_set_gpio_sync(&g_default_bridge, enable);
+}
+
+bool i2s_bridge_get_statistics(I2SStatistics *stats) {
+    return i2s_get_statistics(&g_default_bridge, stats);
+}
+
+bool i2s_bridge_reset_statistics(void) {
+    return i2s_reset_statistics(&g_default_bridge);
+}
+
+I2SLinkStatus i2s_bridge_get_link_status(void) {
+    return i2s_get_link_status(&g_default_bridge);
+}
+
+bool i2s_bridge_set_standby(int port) {
+    return i2s_set_standby(&g_default_bridge, port);
+}
+
+I2SLinkStatus i2s_bridge_check_link(void) {
+    return i2s_check_link(&g_default_bridge);
+}
+
+bool i2s_bridge_self_test(uint32_t *latency_us, uint32_t *jitter_us) {
+    return i2s_self_test(&g_default_bridge, latency_us, jitter_us);
+}
+
+bool i2s_bridge_self_test_report(I2SLatencyReport *report) {
+    return i2s_self_test_report(&g_default_bridge, report);
+}
+
+bool i2s_bridge_send_diagnostic(const char *message) {
+    return i2s_send_diagnostic(&g_default_bridge, message);
+}
+
+size_t i2s_bridge_service_diagnostics(void) {
+    return i2s_service_diagnostics(&g_default_bridge);
+}
+
+bool i2s_bridge_diagnostic_available(void) {
+    return i2s_diagnostic_available(&g_default_bridge);
+}
+
+int i2s_bridge_read_diagnostic(char *buffer, size_t max_len) {
+    return i2s_read_diagnostic(&g_default_bridge, buffer, max_len);
+}
+
+void i2s_bridge_sync_pulse(uint32_t timestamp_us) {
+    i2s_sync_pulse(&g_default_bridge, timestamp_us);
+}
+
+float i2s_bridge_calibrate_drift(void) {
+    return i2s_calibrate_drift(&g_default_bridge);
+}
+
+bool i2s_bridge_forward_start(const I2SForwardConfig *config) {
+    return i2s_forward_start(&g_default_bridge, config);
+}
+
+bool i2s_bridge_forward_stop(void) {
+    return i2s_forward_stop(&g_default_bridge);
+}
+
+bool i2s_bridge_forward_get_statistics(I2SForwardStats *stats) {
+    return i2s_forward_get_statistics(&g_default_bridge, stats);
+}
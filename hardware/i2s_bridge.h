@@ -8,7 +8,8 @@
  * Requirements:
  * - FR-001: I²S bridge interface
  * - FR-002: Master/slave mode selection
- * - FR-003: Φ-phase and coherence encoding (32-bit float)
+ * - FR-003: Φ-phase and coherence encoding (packed telemetry lane), with
+ *   an optional audio-rate Φ trajectory sideband
  * - FR-004: 8-channel 48kHz 24-bit format with DMA
  * - FR-005: GPIO 1 kHz sync pulse
  * - FR-006: Serial diagnostic interface
@@ -23,6 +24,7 @@
 #ifndef I2S_BRIDGE_H
 #define I2S_BRIDGE_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -36,6 +38,34 @@ extern "C" {
 #define I2S_CHANNELS        8
 #define I2S_BUFFER_SIZE     512
 #define GPIO_SYNC_FREQ_HZ   1000
+#define I2S_MAX_LINKS       4           // Bridges per link group
+#define I2S_DIAGNOSTIC_LINE_MAX 128     // Diagnostic line with its newline; longer lines are cut
+
+// Telemetry lane (FR-003): channels 0-6 carry audio, channel 7 carries
+// metrics packets. A packet fills I2S_TELEMETRY_WORDS consecutive slots of
+// the lane, three bytes per 24-bit slot; packets follow each other from
+// the first frame of a buffer and the rest of the lane is idle (zero).
+// On I2S_WIRE_16 links a slot carries two bytes of the packet.
+#define I2S_AUDIO_CHANNELS          7
+#define I2S_TELEMETRY_CHANNEL       7
+#define I2S_TELEMETRY_WORDS         11      // 32-byte packet
+#define I2S_TELEMETRY_MAX_PACKETS   (I2S_BUFFER_SIZE / I2S_TELEMETRY_WORDS)
+#define I2S_TELEMETRY_WORDS_16      16
+#define I2S_TELEMETRY_MAX_PACKETS_16 (I2S_BUFFER_SIZE / I2S_TELEMETRY_WORDS_16)
+
+// Φ sideband (FR-003): with phi_sideband_decimation D set, the last slots
+// of the lane carry the buffer's Φ phase and depth every D samples, 16
+// bits each, so the receiver can interpolate them back to audio rate
+// instead of stepping once per buffer (about 94 Hz). Point j is the value
+// at sample (j + 1) D - 1; the receiver ramps to it from point j - 1 (the
+// previous buffer's last for j = 0), a delay of D - 1 samples. The block
+// takes 10 + 4 I2S_BUFFER_SIZE / D bytes at the end of the lane, which
+// leaves fewer packets per buffer; D is a power of two from 2 (4 on 16-bit
+// links, I2S_PHI_SIDEBAND_MIN_DECIMATION_16). Receivers without it see
+// the lane end at the first idle slot as before.
+#define I2S_PHI_SIDEBAND_MIN_DECIMATION     2
+#define I2S_PHI_SIDEBAND_MIN_DECIMATION_16  4
+#define I2S_PHI_SIDEBAND_MAX_POINTS         (I2S_BUFFER_SIZE / I2S_PHI_SIDEBAND_MIN_DECIMATION)
 
 // Mode selection (FR-002)
 typedef enum {
@@ -43,6 +73,18 @@ typedef enum {
     I2S_MODE_SLAVE = 1
 } I2SMode;
 
+// Wire formats (FR-004): how the DMA buffers and the link carry a sample.
+// The API always deals in 24-bit samples in int32_t slots; a packed format
+// is packed in place when a TX half is committed and unpacked in place when
+// an RX half arrives, with NEON or SSE where available. The 16-bit format
+// sends the top 16 bits of each sample and halves the link's bit clock.
+typedef enum {
+    I2S_WIRE_24_IN_32 = 0,           // 24-bit samples as they are, 32-bit slots
+    I2S_WIRE_24_IN_32_LEFT = 1,      // 24-bit, left-justified in 32-bit slots (codecs)
+    I2S_WIRE_24_PACKED = 2,          // 24-bit, three bytes per slot (S24_3LE)
+    I2S_WIRE_16 = 3                  // Top 16 bits, two bytes per slot (S16_LE)
+} I2SWireFormat;
+
 // Link status
 typedef enum {
     I2S_LINK_DISCONNECTED = 0,
@@ -56,12 +98,16 @@ typedef enum {
 typedef struct {
     I2SMode mode;                    // Master or slave mode
     uint32_t sample_rate;            // Audio sample rate (Hz)
-    uint8_t bit_depth;               // Bits per sample (16, 24, 32)
+    uint8_t bit_depth;               // 16 or 24 to match wire_format, 0 for either
     uint8_t channels;                // Number of audio channels
     uint16_t buffer_size;            // DMA buffer size in samples
     bool enable_gpio_sync;           // Enable GPIO sync pulse (FR-005)
     bool enable_diagnostics;         // Enable serial diagnostics (FR-006)
     uint8_t gpio_sync_pin;           // GPIO pin for sync pulse
+    bool enable_drift_compensation;  // Resample received audio to the local clock (FR-005)
+    uint8_t port;                    // I²S/TDM peripheral, 0 for the first
+    I2SWireFormat wire_format;       // Sample packing on the link (FR-004)
+    uint16_t phi_sideband_decimation; // Φ sideband point spacing in samples, 0 for none (FR-003)
 } I2SBridgeConfig;
 
 // Consciousness metrics structure (FR-003)
@@ -79,14 +125,51 @@ typedef struct {
 typedef struct {
     uint64_t frames_transmitted;     // Total frames sent
     uint64_t frames_received;        // Total frames received
-    uint64_t frames_dropped;         // Dropped frames
+    uint64_t frames_dropped;         // Metrics packets missing from the sequence (SC-002)
     uint32_t latency_us;             // Round-trip latency (µs) (SC-001)
     uint32_t jitter_us;              // Latency jitter (µs) (SC-001)
     float clock_drift_ppm;           // Clock drift (parts per million)
     I2SLinkStatus link_status;       // Current link status
     uint32_t uptime_ms;              // Uptime since last reset
+    uint64_t packets_transmitted;    // Metrics packets sent
+    uint64_t packets_received;       // Metrics packets decoded
+    uint64_t packets_corrupt;        // Packets rejected by the CRC (SC-002)
+    float loss_rate;                 // frames_dropped / packets expected (SC-002)
+    uint64_t tx_underruns;           // TX halves sent without a commit
+    uint64_t rx_overruns;            // RX halves overwritten before or while read
+    float asrc_ratio;                // Resampler input frames per output frame
+    uint64_t asrc_slips;             // Resampler FIFO under- or overflows
+    float crc_error_rate;            // Packets failing the CRC, last 100 ms window (SC-003)
+    uint32_t failovers;              // Link restarts by i2s_bridge_check_link (SC-003)
+    uint32_t recovery_ms;            // Last half before the latest failure to the first after
+    uint32_t diagnostics_dropped;    // Diagnostic lines dropped, TX or RX queue full (FR-006)
+    uint64_t phi_sideband_received;  // Φ sideband blocks decoded (FR-003)
+    uint64_t phi_sideband_corrupt;   // Φ sideband blocks rejected by the CRC
+    uint64_t phi_sideband_gaps;      // Received blocks not following the previous one
 } I2SStatistics;
 
+// Loopback self-test result (FR-010, SC-001), round-trip times in µs
+typedef struct {
+    uint32_t rounds;                 // Markers sent
+    uint32_t received;               // Markers that came back
+    float min_us;
+    float p50_us;
+    float p99_us;
+    float max_us;
+    float mean_us;
+    float jitter_us;                 // Sample standard deviation
+    bool meets_sc001;                // All back intact, p99 ≤40 µs, jitter ≤5 µs
+} I2SLatencyReport;
+
+/**
+ * Notification from the DMA interrupt that a buffer half is done (FR-004)
+ *
+ * @param half 0 at half completion, 1 at full completion; that TX half may
+ *        now be filled and that RX half read
+ * @param context Pointer given to i2s_bridge_set_buffer_callback
+ */
+typedef void (*I2SBufferCallback)(uint8_t half, void *context);
+
 // Function prototypes
 
 /**
@@ -112,7 +195,10 @@ bool i2s_bridge_start(void);
 bool i2s_bridge_stop(void);
 
 /**
- * Transmit audio frame with interleaved consciousness metrics (FR-003, FR-004)
+ * Transmit audio frame with one consciousness metrics packet (FR-003, FR-004)
+ *
+ * Channel I2S_TELEMETRY_CHANNEL of audio_data is ignored; the telemetry
+ * lane replaces it.
  *
  * @param audio_data Pointer to audio samples (int32_t array, channels * buffer_size)
  * @param metrics Consciousness metrics to encode
@@ -120,15 +206,158 @@ bool i2s_bridge_stop(void);
  */
 bool i2s_bridge_transmit(const int32_t *audio_data, const ConsciousnessMetrics *metrics);
 
+/**
+ * Transmit audio frame with several metrics packets (FR-003, FR-004)
+ *
+ * Raises the metrics update rate above one per buffer at no extra link
+ * bandwidth: the packets share the telemetry lane.
+ *
+ * @param audio_data Pointer to audio samples (int32_t array, channels * buffer_size)
+ * @param metrics Packets to encode, oldest first
+ * @param count Number of packets, 0 to I2S_TELEMETRY_MAX_PACKETS
+ *        (I2S_TELEMETRY_MAX_PACKETS_16 with I2S_WIRE_16), fewer with
+ *        the Φ sideband (i2s_bridge_max_packets)
+ * @return true if transmission queued successfully, false otherwise
+ */
+bool i2s_bridge_transmit_packets(const int32_t *audio_data, const ConsciousnessMetrics *metrics,
+                                 size_t count);
+
 /**
  * Receive audio frame with interleaved consciousness metrics (FR-003, FR-004)
  *
+ * With enable_drift_compensation call this once per local buffer period:
+ * the audio channels come from the resampler even when no frame arrived,
+ * and metrics is left as it was when no packet came.
+ *
  * @param audio_data Buffer to store received audio samples
- * @param metrics Buffer to store decoded consciousness metrics
- * @return true if data available and decoded, false otherwise
+ * @param metrics Buffer to store the newest decoded metrics packet
+ * @return true if data available and a packet decoded, false otherwise
  */
 bool i2s_bridge_receive(int32_t *audio_data, ConsciousnessMetrics *metrics);
 
+/**
+ * Receive audio frame with every metrics packet it carries (FR-003, FR-004)
+ *
+ * Decoding stops at the first idle slot or packet that fails its CRC;
+ * the latter counts in packets_corrupt.
+ *
+ * @param audio_data Buffer to store received audio samples
+ * @param metrics Buffer to store the decoded packets, oldest first
+ * @param max_count Capacity of metrics
+ * @return Number of packets decoded, or -1 if no frame arrived or on error
+ */
+int i2s_bridge_receive_packets(int32_t *audio_data, ConsciousnessMetrics *metrics, size_t max_count);
+
+/**
+ * Get the next TX half to fill in place (FR-004)
+ *
+ * The copying transmit functions are built on this pair. Fill
+ * I2S_BUFFER_SIZE frames of I2S_CHANNELS samples, then commit; one half
+ * can be held at a time. With a packed wire format the commit packs the
+ * half in place, so it comes back without its previous samples.
+ *
+ * @return The half, or NULL if the DMA still owns both or one is held
+ */
+int32_t *i2s_bridge_acquire_tx(void);
+
+/**
+ * Encode metrics into the acquired TX half and hand it to the DMA (FR-003)
+ *
+ * @param metrics Packets to encode, oldest first
+ * @param count Number of packets, 0 to I2S_TELEMETRY_MAX_PACKETS
+ *        (I2S_TELEMETRY_MAX_PACKETS_16 with I2S_WIRE_16), fewer with
+ *        the Φ sideband (i2s_bridge_max_packets)
+ * @return true if committed, false if no half is held or count is too large
+ */
+bool i2s_bridge_commit_tx(const ConsciousnessMetrics *metrics, size_t count);
+
+/**
+ * Packets a TX half can carry with the configured wire format and Φ
+ * sideband (FR-003)
+ *
+ * @return Packet limit of transmit_packets and commit_tx
+ */
+size_t i2s_bridge_max_packets(void);
+
+/**
+ * Set the Φ trajectory the next committed TX half carries (FR-003)
+ *
+ * Takes the values at every phi_sideband_decimation-th sample; the
+ * arrays are not kept. Without a call before a commit the half carries
+ * the newest packet's phi_phase and phi_depth throughout, or with no
+ * packet the last values sent.
+ *
+ * @param phi_phase Φ phase per sample (radians), I2S_BUFFER_SIZE values
+ * @param phi_depth Φ depth per sample [0, 1], I2S_BUFFER_SIZE values
+ * @return true if set, false if the sideband is off or an argument is NULL
+ */
+bool i2s_bridge_set_tx_phi(const float *phi_phase, const float *phi_depth);
+
+/**
+ * Get the oldest received RX half to read in place (FR-004)
+ *
+ * @param metrics Buffer to store the decoded packets, oldest first
+ * @param max_count Capacity of metrics
+ * @param count Receives the number of packets decoded, may be NULL
+ * The consumer should keep up with the DMA: a half that was overwritten
+ * before or while it was read counts in rx_overruns, and only the newest
+ * is returned.
+ *
+ * @return The half, valid until i2s_bridge_release_rx, or NULL if none
+ *         arrived or one is held
+ */
+const int32_t *i2s_bridge_acquire_rx(ConsciousnessMetrics *metrics, size_t max_count, size_t *count);
+
+/**
+ * Give the acquired RX half back
+ *
+ * @return true if a half was held, false otherwise
+ */
+bool i2s_bridge_release_rx(void);
+
+/**
+ * Φ trajectory of the last RX half acquired, at audio rate (FR-003)
+ *
+ * The sideband points interpolated per sample, phase along the shorter
+ * arc and wrapped to [0, 2π). Valid after the half is released too, and
+ * after i2s_bridge_receive. When the half carried no intact sideband the
+ * last values received are held.
+ *
+ * @param phi_phase Receives I2S_BUFFER_SIZE phases (radians)
+ * @param phi_depth Receives I2S_BUFFER_SIZE depths, may be NULL
+ * @return true if the half's sideband was intact, false otherwise
+ */
+bool i2s_bridge_get_rx_phi(float *phi_phase, float *phi_depth);
+
+/**
+ * Check for a received RX half without blocking (FR-004)
+ *
+ * @return true if i2s_bridge_acquire_rx has a half to return
+ */
+bool i2s_bridge_rx_available(void);
+
+/**
+ * Wait until an RX half arrives or the timeout passes
+ *
+ * Sleeps rather than spins: on Teensy until the next interrupt, on hosts
+ * on a condition variable signalled by the DMA completion.
+ *
+ * @param timeout_ms Longest wait (ms), 0 only checks
+ * @return true if a half is available, false on timeout or when stopped
+ */
+bool i2s_bridge_wait_rx(uint32_t timeout_ms);
+
+/**
+ * Set the DMA half/full completion notification (FR-004)
+ *
+ * Called in interrupt context; keep it short. Set while stopped.
+ *
+ * @param callback Notification, NULL for none
+ * @param context Passed to the callback
+ * @return true if set, false if the bridge is running
+ */
+bool i2s_bridge_set_buffer_callback(I2SBufferCallback callback, void *context);
+
 /**
  * Enable/disable GPIO sync pulse (FR-005)
  *
@@ -140,6 +369,9 @@ bool i2s_bridge_set_gpio_sync(bool enable);
 /**
  * Get current statistics (SC-001, SC-002)
  *
+ * Losses are found from gaps in the received sequence numbers, so senders
+ * must number their packets consecutively.
+ *
  * @param stats Pointer to statistics structure to fill
  * @return true if statistics retrieved, false otherwise
  */
@@ -159,45 +391,129 @@ bool i2s_bridge_reset_statistics(void);
  */
 I2SLinkStatus i2s_bridge_get_link_status(void);
 
+/**
+ * Pre-initialize a spare I²S/TDM port for failover (SC-003)
+ *
+ * Configures the port in the bridge's format now, so a failover only has
+ * to start its DMA. After a failover the failed port stands by in turn.
+ * Set while stopped.
+ *
+ * @param port Standby port, other than the bridge's, or -1 for none
+ * @return true if set, false if running, uninitialized or the port fails
+ */
+bool i2s_bridge_set_standby(int port);
+
+/**
+ * Check link health and fail over when it is down (SC-003)
+ *
+ * Call from the receiving thread at least every 10 ms, as from loop()
+ * with each received buffer. The link is I2S_LINK_DEGRADED while DMA
+ * halves come late (two half periods without one) or more than 1% of the
+ * packets of the last 100 ms failed their CRC. With no half for five
+ * periods (about 53 ms), or 25% of packets failing, it fails over: the
+ * DMA restarts on the standby port, or on the same one without a standby,
+ * and the link is I2S_LINK_SYNCING until the first half is back. The
+ * drift and phase estimates of the DLL are kept across the switch, so
+ * relocking takes milliseconds rather than a full resync. A link that
+ * fails again before relocking is I2S_LINK_ERROR and keeps being retried.
+ * Links of a group only report; they cannot restart alone. Each check
+ * also services the serial diagnostics.
+ *
+ * @return Link status after the check
+ */
+I2SLinkStatus i2s_bridge_check_link(void);
+
 /**
  * Perform loopback self-test (FR-010, SC-001)
  *
- * Transmits test pattern and measures round-trip latency
+ * Transmits test pattern and measures round-trip latency. The bridge must
+ * be started; with I2S_BRIDGE_LOOPBACK (host builds) the round trip is the
+ * encode/decode path through the software loopback.
  *
- * @param latency_us Pointer to store measured latency (µs)
+ * @param latency_us Pointer to store the mean latency (µs)
  * @param jitter_us Pointer to store measured jitter (µs)
  * @return true if test passed, false otherwise
  */
 bool i2s_bridge_self_test(uint32_t *latency_us, uint32_t *jitter_us);
 
 /**
- * Send diagnostic message over serial (FR-006)
+ * Perform loopback self-test with the latency distribution (FR-010, SC-001)
+ *
+ * Each round sends a marker packet holding its transmit timer tick (the
+ * cycle counter on Teensy) in the telemetry lane; the round trip runs to
+ * the tick the DMA completion captured for the RX half it came back in.
+ * Uses the in-place buffers and static storage only. Takes over the
+ * bridge while it runs.
+ *
+ * @param report Distribution of the round trips, filled
+ * @return true if SC-001 is met, false otherwise
+ */
+bool i2s_bridge_self_test_report(I2SLatencyReport *report);
+
+/**
+ * Queue a diagnostic line for the serial port (FR-006)
+ *
+ * Safe in the audio callback and in interrupt handlers: the line is copied
+ * into a lock-free queue with its newline and the call returns, with no
+ * locking or I/O. i2s_bridge_service_diagnostics writes it out. When the
+ * queue is full the line is dropped and counted in diagnostics_dropped.
  *
- * @param message Null-terminated diagnostic string
- * @return true if sent successfully, false otherwise
+ * @param message Null-terminated diagnostic string, cut at
+ *        I2S_DIAGNOSTIC_LINE_MAX - 1 characters
+ * @return true if queued, false if dropped or diagnostics are disabled
  */
 bool i2s_bridge_send_diagnostic(const char *message);
 
 /**
- * Check if diagnostic data available
+ * Move diagnostics between the queues and the serial port (FR-006)
+ *
+ * Writes queued lines only as far as the port has room and reads only
+ * what it already received, so it never waits: with no host attached the
+ * lines stay queued and boot does not wait for one. i2s_bridge_check_link
+ * and the read calls service the port too; call it from loop() or a
+ * low-priority timer otherwise. One call at a time: a call while another
+ * is in progress returns 0 at once. With I2S_BRIDGE_LOOPBACK (host
+ * builds) the lines sent are the lines read back.
+ *
+ * @return Number of queued lines completely written
+ */
+size_t i2s_bridge_service_diagnostics(void);
+
+/**
+ * Check if a received diagnostic line is waiting
  *
  * @return true if diagnostic data available, false otherwise
  */
 bool i2s_bridge_diagnostic_available(void);
 
 /**
- * Read diagnostic message from serial (FR-006)
+ * Read a received diagnostic line (FR-006), without waiting
  *
- * @param buffer Buffer to store received message
- * @param max_len Maximum buffer length
- * @return Number of bytes read, or -1 on error
+ * @param buffer Buffer to store the line, null-terminated, without its
+ *        newline; a longer line is cut to max_len - 1 characters
+ * @param max_len Buffer length
+ * @return Number of characters read, or -1 if no line is waiting
  */
 int i2s_bridge_read_diagnostic(char *buffer, size_t max_len);
 
+/**
+ * Feed a sync pulse time to the drift tracker (FR-005)
+ *
+ * The slave's sync interrupt calls this for every edge of the master's
+ * pulse; platforms that capture the pulse elsewhere may call it
+ * themselves. Interrupt safe; one caller at a time.
+ *
+ * @param timestamp_us Local time of the pulse (µs, wraps)
+ */
+void i2s_bridge_sync_pulse(uint32_t timestamp_us);
+
 /**
  * Calibrate clock drift (FR-005)
  *
- * Uses GPIO sync pulse to measure and compensate for clock drift
+ * Returns the continuous estimate of the remote clock's rate against the
+ * local one, tracked by a delay-locked loop on the sync pulses (about
+ * 10 s to settle). With enable_drift_compensation the receive functions
+ * resample the audio channels by it; the in-place RX halves stay raw.
  *
  * @return Measured drift in parts per million (ppm)
  */
@@ -210,6 +526,209 @@ float i2s_bridge_calibrate_drift(void);
  */
 const char* i2s_bridge_get_version(void);
 
+//==============================================================================
+// Bridge instances and link groups
+//
+// The i2s_bridge_* functions above drive one default bridge. A rig with
+// more than I2S_CHANNELS channels runs one bridge per I²S/TDM port (the
+// port field of the configuration), created with i2s_bridge_create() and
+// driven by the i2s_* functions below, which take the bridge first and
+// otherwise behave like their i2s_bridge_* counterparts. Bridges share no
+// mutable state; a NULL bridge fails like the other NULL arguments.
+//
+// A group puts up to I2S_MAX_LINKS initialized bridges in one sync domain:
+// the first is the leader, whose clocks the others (configured as slaves)
+// follow, so all links start on the same frame and stay sample-aligned.
+// Their halves become one interleaved buffer of i2s_group_channels()
+// channels per frame, link i owning channels i * I2S_CHANNELS onwards;
+// each link's DMA fills its own channels in place, so aggregating costs no
+// copy per link. Only the leader's telemetry lane carries packets and the
+// Φ sideband, and its sync pulses set the drift of every link. The aggregate halves are raw:
+// links with enable_drift_compensation cannot join. While grouped, drive
+// the links through the i2s_group_* functions, which follow the rules of
+// their single-link counterparts; statistics stay per link.
+//==============================================================================
+
+typedef struct I2SBridge I2SBridge;
+typedef struct I2SBridgeGroup I2SBridgeGroup;
+
+/**
+ * Create a bridge, uninitialized; configure it with i2s_init()
+ *
+ * @return New bridge, or NULL if out of memory
+ */
+I2SBridge* i2s_bridge_create(void);
+
+/**
+ * Stop and free a bridge from i2s_bridge_create(), forwarding included;
+ * NULL, the default bridge and bridges still in a group are ignored
+ */
+void i2s_bridge_destroy(I2SBridge *bridge);
+
+/**
+ * Bridge behind the i2s_bridge_* functions
+ */
+I2SBridge* i2s_bridge_default(void);
+
+bool i2s_init(I2SBridge *bridge, const I2SBridgeConfig *config);
+bool i2s_start(I2SBridge *bridge);
+bool i2s_stop(I2SBridge *bridge);
+bool i2s_transmit(I2SBridge *bridge, const int32_t *audio_data, const ConsciousnessMetrics *metrics);
+bool i2s_transmit_packets(I2SBridge *bridge, const int32_t *audio_data, const ConsciousnessMetrics *metrics,
+                          size_t count);
+bool i2s_receive(I2SBridge *bridge, int32_t *audio_data, ConsciousnessMetrics *metrics);
+int i2s_receive_packets(I2SBridge *bridge, int32_t *audio_data, ConsciousnessMetrics *metrics,
+                        size_t max_count);
+int32_t *i2s_acquire_tx(I2SBridge *bridge);
+bool i2s_commit_tx(I2SBridge *bridge, const ConsciousnessMetrics *metrics, size_t count);
+const int32_t *i2s_acquire_rx(I2SBridge *bridge, ConsciousnessMetrics *metrics, size_t max_count,
+                              size_t *count);
+bool i2s_release_rx(I2SBridge *bridge);
+size_t i2s_max_packets(I2SBridge *bridge);
+bool i2s_set_tx_phi(I2SBridge *bridge, const float *phi_phase, const float *phi_depth);
+bool i2s_get_rx_phi(I2SBridge *bridge, float *phi_phase, float *phi_depth);
+bool i2s_rx_available(I2SBridge *bridge);
+bool i2s_wait_rx(I2SBridge *bridge, uint32_t timeout_ms);
+bool i2s_set_buffer_callback(I2SBridge *bridge, I2SBufferCallback callback, void *context);
+bool i2s_set_gpio_sync(I2SBridge *bridge, bool enable);
+bool i2s_get_statistics(I2SBridge *bridge, I2SStatistics *stats);
+bool i2s_reset_statistics(I2SBridge *bridge);
+I2SLinkStatus i2s_get_link_status(I2SBridge *bridge);
+bool i2s_set_standby(I2SBridge *bridge, int port);
+I2SLinkStatus i2s_check_link(I2SBridge *bridge);
+bool i2s_self_test(I2SBridge *bridge, uint32_t *latency_us, uint32_t *jitter_us);
+bool i2s_self_test_report(I2SBridge *bridge, I2SLatencyReport *report);
+bool i2s_send_diagnostic(I2SBridge *bridge, const char *message);
+size_t i2s_service_diagnostics(I2SBridge *bridge);
+bool i2s_diagnostic_available(I2SBridge *bridge);
+int i2s_read_diagnostic(I2SBridge *bridge, char *buffer, size_t max_len);
+void i2s_sync_pulse(I2SBridge *bridge, uint32_t timestamp_us);
+float i2s_calibrate_drift(I2SBridge *bridge);
+
+/**
+ * Group stopped bridges into one sync domain, links[0] leading
+ *
+ * @param links Initialized, stopped bridges in no other group, of one wire
+ *        format; all but the first in I2S_MODE_SLAVE
+ * @param count Number of links, 1 to I2S_MAX_LINKS
+ * @return New group, or NULL on a bad link or out of memory
+ */
+I2SBridgeGroup* i2s_group_create(I2SBridge *const *links, size_t count);
+
+/**
+ * Stop a group and give its links back their own buffers; NULL is ignored
+ */
+void i2s_group_destroy(I2SBridgeGroup *group);
+
+/**
+ * Samples per frame of the aggregate halves: links * I2S_CHANNELS
+ */
+size_t i2s_group_channels(const I2SBridgeGroup *group);
+
+/**
+ * Start every link, the leader last; on failure none stays running
+ */
+bool i2s_group_start(I2SBridgeGroup *group);
+
+/**
+ * Stop every link, the leader first
+ */
+bool i2s_group_stop(I2SBridgeGroup *group);
+
+/**
+ * Get the next aggregate TX half to fill in place: I2S_BUFFER_SIZE frames
+ * of i2s_group_channels() samples, then commit
+ */
+int32_t *i2s_group_acquire_tx(I2SBridgeGroup *group);
+
+/**
+ * Encode metrics into the leader's lane and hand the half to every link
+ */
+bool i2s_group_commit_tx(I2SBridgeGroup *group, const ConsciousnessMetrics *metrics, size_t count);
+
+/**
+ * Get the oldest aggregate RX half every link has received, with the
+ * packets of the leader's lane
+ */
+const int32_t *i2s_group_acquire_rx(I2SBridgeGroup *group, ConsciousnessMetrics *metrics, size_t max_count,
+                                    size_t *count);
+bool i2s_group_release_rx(I2SBridgeGroup *group);
+bool i2s_group_rx_available(I2SBridgeGroup *group);
+
+/**
+ * Wait until every link has received the next half, timeout_ms in all
+ */
+bool i2s_group_wait_rx(I2SBridgeGroup *group, uint32_t timeout_ms);
+
+//==============================================================================
+// Telemetry forwarding
+//
+// On Linux hosts a bridge can forward the telemetry packets it decodes to
+// PhaseNet peers (server/phasenet_protocol.py) over UDP, so cluster sync
+// traffic never goes through the Python event loop. Decoded packets are
+// queued lock-free, with no system call on the receive path; a forwarding
+// thread puts batch_packets of them in each datagram, or fewer once the
+// oldest has waited max_delay_ms, and sends the datagrams for every peer
+// with one sendmmsg() call. A larger batch lowers the packet rate at the
+// cost of latency. Packets that find the queue full are dropped and
+// counted. Each datagram holds:
+//
+//   bytes 0-3    "PNB" and the format version, 1
+//   byte  4      number of packets
+//   byte  5      length n of the node id
+//   bytes 6-7    zero
+//   bytes 8-15   send time, Unix seconds (little-endian double)
+//   bytes 16-    the node id, then the packets, I2S_FORWARD_PACKET_BYTES
+//                each as carried on the telemetry lane
+//==============================================================================
+
+#define I2S_FORWARD_MAX_PEERS       8
+#define I2S_FORWARD_MAX_BATCH       32      // Packets per datagram
+#define I2S_FORWARD_PACKET_BYTES    32
+#define I2S_FORWARD_NODE_ID_MAX     32
+
+typedef struct {
+    const char *address;             // IPv4 address or host name
+    uint16_t port;                   // PhaseNet bind_port, 9000 by default
+} I2SForwardPeer;
+
+typedef struct {
+    const char *node_id;             // Sender named in every datagram
+    I2SForwardPeer peers[I2S_FORWARD_MAX_PEERS];
+    size_t peer_count;               // 1 to I2S_FORWARD_MAX_PEERS
+    size_t batch_packets;            // Packets per datagram, 1 to I2S_FORWARD_MAX_BATCH
+    uint32_t max_delay_ms;           // Longest a packet waits for its batch to fill
+} I2SForwardConfig;
+
+typedef struct {
+    uint64_t packets_forwarded;      // Packets sent, once per peer
+    uint64_t datagrams_sent;
+    uint64_t send_calls;             // sendmmsg() calls
+    uint64_t packets_dropped;        // Found the queue full
+    uint64_t send_errors;            // Datagrams the kernel refused
+} I2SForwardStats;
+
+/**
+ * Start forwarding a stopped bridge's received telemetry
+ *
+ * @param config Peers and batching; node_id is copied, at most
+ *        I2S_FORWARD_NODE_ID_MAX bytes
+ * @return true if forwarding, false on a bad configuration, an unknown
+ *         peer, a running or already forwarding bridge, or off Linux
+ */
+bool i2s_forward_start(I2SBridge *bridge, const I2SForwardConfig *config);
+
+/**
+ * Send what is queued and stop forwarding; the bridge must be stopped
+ */
+bool i2s_forward_stop(I2SBridge *bridge);
+
+bool i2s_forward_get_statistics(I2SBridge *bridge, I2SForwardStats *stats);
+
+bool i2s_bridge_forward_start(const I2SForwardConfig *config);
+bool i2s_bridge_forward_stop(void);
+bool i2s_bridge_forward_get_statistics(I2SForwardStats *stats);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,40 @@
+/**
+ * Φ Link Implementation
+ *
+ * Three frames: one the writer owns, one the reader owns and one
+ * published. g_published holds the published index and a flag set by
+ * each publish and cleared by the read that takes it; both sides trade
+ * through a single exchange, so the frames they own are never shared.
+ */
+
+#include "phi_link.h"
+#include <atomic>
+#include <string.h>
+
+#define LINK_FRESH  4u      // Published frame not yet taken
+
+static PhiLinkFrame g_frames[3];
+static std::atomic<uint32_t> g_published{0};
+static uint32_t g_write_index = 1;      // Writer context only
+static uint32_t g_read_index = 2;       // Reader context only
+static uint32_t g_sequence = 0;         // Writer context only
+
+void phi_link_publish(const float normalized[PHI_LINK_CHANNELS], uint32_t timestamp_us) {
+    PhiLinkFrame &frame = g_frames[g_write_index];
+    memcpy(frame.normalized, normalized, sizeof(frame.normalized));
+    frame.timestamp_us = timestamp_us;
+    frame.sequence = ++g_sequence;
+
+    const uint32_t previous = g_published.exchange(g_write_index | LINK_FRESH, std::memory_order_acq_rel);
+    g_write_index = previous & ~LINK_FRESH;
+}
+
+bool phi_link_read(PhiLinkFrame *frame) {
+    if (g_published.load(std::memory_order_relaxed) & LINK_FRESH) {
+        const uint32_t previous = g_published.exchange(g_read_index, std::memory_order_acq_rel);
+        g_read_index = previous & ~LINK_FRESH;
+    }
+
+    memcpy(frame, &g_frames[g_read_index], sizeof(PhiLinkFrame));
+    return frame->sequence != 0;
+}
@@ -0,0 +1,60 @@
+/**
+ * Φ Link - on-device path from phi_sensor to the hybrid node (FR-004)
+ * Shared by phi_sensor (writer) and hybrid_node (reader)
+ *
+ * phi_sensor publishes every normalized frame from its sample interrupt;
+ * the hybrid node's control update takes the latest one directly instead
+ * of the values making a round trip through the host (serial, the Python
+ * bridge and router, and back). The host can still watch them in the
+ * node status.
+ *
+ * The slot is a triple buffer, wait-free on both sides: the writer fills
+ * its spare frame and swaps it for the published one, the reader swaps
+ * its own frame for the published one when that is newer. Neither side
+ * ever spins on the other, so writer and reader may be interrupt handlers
+ * that preempt each other. One writer and one reader.
+ */
+
+#ifndef PHI_LINK_H
+#define PHI_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PHI_LINK_CHANNELS   4       // As PHI_SENSOR_CHANNELS
+
+// One sensor frame
+typedef struct {
+    float normalized[PHI_LINK_CHANNELS];    // phi_depth, phi_phase, coherence, criticality [0, 1]
+    uint32_t timestamp_us;                  // Sensor timestamp
+    uint32_t sequence;                      // Frames published up to this one, from 1
+} PhiLinkFrame;
+
+/**
+ * Publish a frame; wait-free, interrupt safe, single writer
+ *
+ * @param normalized Normalized value per channel
+ * @param timestamp_us Time of the sample
+ */
+void phi_link_publish(const float normalized[PHI_LINK_CHANNELS], uint32_t timestamp_us);
+
+/**
+ * Take the latest frame; wait-free, interrupt safe, single reader
+ *
+ * The same frame is returned again until a newer one is published:
+ * compare sequence to tell.
+ *
+ * @param frame Receives the frame
+ * @return true if a frame was ever published, false otherwise
+ */
+bool phi_link_read(PhiLinkFrame *frame);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PHI_LINK_H
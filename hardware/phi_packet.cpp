@@ -0,0 +1,219 @@
+/**
+ * Φ-Sensor Packet Implementation
+ *
+ * The packet is laid out in a staging buffer, then COBS-encoded into the
+ * frame: each zero becomes the distance to the next one, in blocks of at
+ * most 254 bytes. Decoding reverses that into a buffer of its own, so the
+ * caller's bytes are never touched.
+ */
+
+#include "phi_packet.h"
+#include <math.h>
+#include <string.h>
+
+static_assert(PHI_PACKET_CHANNELS % 2 == 0, "ADC codes are packed in pairs");
+
+static uint16_t packet_crc16(const uint8_t *data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= (uint16_t)data[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
+
+static void put_u16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+    put_u16(p, (uint16_t)v);
+    put_u16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get_u16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+    return get_u16(p) | ((uint32_t)get_u16(p + 2) << 16);
+}
+
+/**
+ * COBS-encode length bytes and append the zero
+ *
+ * @return Encoded length, 0 if capacity is too small
+ */
+static size_t cobs_encode(const uint8_t *in, size_t length, uint8_t *out, size_t capacity) {
+    if (capacity < length + length / 254 + 2) {
+        return 0;
+    }
+
+    size_t code_at = 0;
+    size_t o = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < length; i++) {
+        if (in[i] != 0) {
+            out[o++] = in[i];
+            code++;
+        }
+        if (in[i] == 0 || code == 0xFF) {
+            out[code_at] = code;
+            code_at = o++;
+            code = 1;
+        }
+    }
+    out[code_at] = code;
+    out[o++] = 0;
+    return o;
+}
+
+/**
+ * COBS-decode a frame without its zero
+ *
+ * @return Decoded length, or -1 if invalid or longer than capacity
+ */
+static int cobs_decode(const uint8_t *in, size_t length, uint8_t *out, size_t capacity) {
+    size_t o = 0;
+    size_t i = 0;
+    while (i < length) {
+        const uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > length) {
+            return -1;
+        }
+        for (uint8_t k = 1; k < code; k++) {
+            if (in[i] == 0 || o >= capacity) {
+                return -1;
+            }
+            out[o++] = in[i++];
+        }
+        if (code != 0xFF && i < length) {
+            if (o >= capacity) {
+                return -1;
+            }
+            out[o++] = 0;
+        }
+    }
+    return (int)o;
+}
+
+static uint16_t normalized_code(float value) {
+    if (!(value > 0.0f)) return 0;
+    if (value >= 1.0f) return 65535;
+    return (uint16_t)lrintf(value * 65535.0f);
+}
+
+size_t phi_packet_encode(const PhiSensorData *samples, size_t count, uint8_t flags,
+                         uint8_t *frame, size_t capacity, size_t *encoded) {
+    const bool sparse = (flags & PHI_PACKET_FLAG_SPARSE) != 0;
+    const uint32_t max_step = sparse ? 0xFFFF : 1;
+    size_t n = 0;
+    if (samples != NULL && count > 0) {
+        n = 1;
+        while (n < count && n < PHI_PACKET_MAX_SAMPLES &&
+               samples[n].sample_number - samples[n - 1].sample_number - 1 < max_step &&
+               samples[n].timestamp_us - samples[n - 1].timestamp_us <= 0xFFFF) {
+            n++;
+        }
+    }
+    if (encoded != NULL) {
+        *encoded = 0;
+    }
+    if (n == 0 || frame == NULL) {
+        return 0;
+    }
+
+    uint8_t packet[PHI_PACKET_MAX_BYTES];
+    packet[0] = PHI_PACKET_VERSION;
+    packet[1] = (uint8_t)n;
+    packet[2] = PHI_PACKET_CHANNELS;
+    packet[3] = flags;
+    put_u32(&packet[4], samples[0].sample_number);
+    put_u32(&packet[8], samples[0].timestamp_us);
+
+    uint8_t *p = &packet[PHI_PACKET_HEADER_BYTES];
+    for (size_t i = 0; i < n; i++) {
+        const PhiSensorData &s = samples[i];
+        if (sparse) {
+            put_u16(p, (uint16_t)(i > 0 ? s.sample_number - samples[i - 1].sample_number : 0));
+            p += 2;
+        }
+        put_u16(p, (uint16_t)(i > 0 ? s.timestamp_us - samples[i - 1].timestamp_us : 0));
+        for (int pair = 0; pair < PHI_PACKET_CHANNELS / 2; pair++) {
+            const uint16_t lo = s.raw_adc[2 * pair] & 0x0FFF;
+            const uint16_t hi = s.raw_adc[2 * pair + 1] & 0x0FFF;
+            p[2 + 3 * pair] = (uint8_t)lo;
+            p[3 + 3 * pair] = (uint8_t)((lo >> 8) | (hi << 4));
+            p[4 + 3 * pair] = (uint8_t)(hi >> 4);
+        }
+        for (int ch = 0; ch < PHI_PACKET_CHANNELS; ch++) {
+            put_u16(p + 8 + 2 * ch, normalized_code(s.normalized[ch]));
+        }
+        p += PHI_PACKET_SAMPLE_BYTES;
+    }
+    const size_t length = (size_t)(p - packet);
+    put_u16(p, packet_crc16(packet, length));
+
+    const size_t bytes = cobs_encode(packet, length + 2, frame, capacity);
+    if (bytes > 0 && encoded != NULL) {
+        *encoded = n;
+    }
+    return bytes;
+}
+
+int phi_packet_decode(const uint8_t *frame, size_t length, PhiSensorData *samples, size_t max,
+                      uint8_t *flags) {
+    uint8_t packet[PHI_PACKET_MAX_BYTES];
+    const int bytes = frame != NULL ? cobs_decode(frame, length, packet, sizeof(packet)) : -1;
+    if (bytes < 0) {
+        return PHI_PACKET_ERROR_FRAMING;
+    }
+    if (bytes < PHI_PACKET_HEADER_BYTES + 2) {
+        return PHI_PACKET_ERROR_LENGTH;
+    }
+    if (packet[0] != PHI_PACKET_VERSION || packet[2] != PHI_PACKET_CHANNELS) {
+        return PHI_PACKET_ERROR_VERSION;
+    }
+    const size_t n = packet[1];
+    const bool sparse = (packet[3] & PHI_PACKET_FLAG_SPARSE) != 0;
+    const size_t sample_bytes = sparse ? PHI_PACKET_SPARSE_SAMPLE_BYTES : PHI_PACKET_SAMPLE_BYTES;
+    if (n == 0 || n > PHI_PACKET_MAX_SAMPLES || (size_t)bytes != PHI_PACKET_HEADER_BYTES + n * sample_bytes + 2) {
+        return PHI_PACKET_ERROR_LENGTH;
+    }
+    if (get_u16(&packet[bytes - 2]) != packet_crc16(packet, (size_t)bytes - 2)) {
+        return PHI_PACKET_ERROR_CRC;
+    }
+    if (flags != NULL) {
+        *flags = packet[3];
+    }
+
+    uint32_t number = get_u32(&packet[4]);
+    uint32_t timestamp = get_u32(&packet[8]);
+    const uint8_t *p = &packet[PHI_PACKET_HEADER_BYTES];
+    const size_t count = n < max ? n : max;
+    for (size_t i = 0; i < count; i++) {
+        PhiSensorData &s = samples[i];
+        if (sparse) {
+            number += get_u16(p);
+            p += 2;
+        } else if (i > 0) {
+            number++;
+        }
+        timestamp += get_u16(p);
+        s.timestamp_us = timestamp;
+        s.sample_number = number;
+        for (int pair = 0; pair < PHI_PACKET_CHANNELS / 2; pair++) {
+            s.raw_adc[2 * pair] = (uint16_t)(p[2 + 3 * pair] | ((p[3 + 3 * pair] & 0x0F) << 8));
+            s.raw_adc[2 * pair + 1] = (uint16_t)((p[3 + 3 * pair] >> 4) | (p[4 + 3 * pair] << 4));
+        }
+        for (int ch = 0; ch < PHI_PACKET_CHANNELS; ch++) {
+            s.voltage[ch] = (float)s.raw_adc[ch] / PHI_SENSOR_ADC_MAX * PHI_SENSOR_VOLTAGE_MAX;
+            s.normalized[ch] = get_u16(p + 8 + 2 * ch) / 65535.0f;
+        }
+        p += PHI_PACKET_SAMPLE_BYTES;
+    }
+    return (int)count;
+}
@@ -0,0 +1,102 @@
+/**
+ * Φ-Sensor Packets - binary framing of PhiSensorData for the serial link
+ * Shared by phi_sensor (encoder) and the host extension (decoder)
+ *
+ * Several samples per packet, with their raw ADC codes, in about a third
+ * of the bytes of the same samples as text. Layout, little-endian,
+ * version 1:
+ *
+ *   0   uint8     PHI_PACKET_VERSION
+ *   1   uint8     Samples, 1 to PHI_PACKET_MAX_SAMPLES
+ *   2   uint8     Channels, PHI_PACKET_CHANNELS
+ *   3   uint8     Flags, PHI_PACKET_FLAG_*
+ *   4   uint32    sample_number of the first sample; the others follow on
+ *   8   uint32    timestamp_us of the first sample
+ *   12  Per sample, PHI_PACKET_SAMPLE_BYTES:
+ *       uint16    µs since the previous sample, 0 for the first
+ *       6 bytes   The four 12-bit ADC codes, two per three bytes, low first
+ *       uint16[4] Normalized values, 0-65535 for [0, 1]
+ *   ..  uint16    CRC-16/CCITT-FALSE of everything before it
+ *
+ * With PHI_PACKET_FLAG_SPARSE (change-only reporting) sample numbers may
+ * skip: each sample starts with a uint16 step from the previous sample's
+ * number, 0 for the first, making PHI_PACKET_SPARSE_SAMPLE_BYTES.
+ *
+ * On the wire each packet is COBS-encoded and ends in a zero byte, the
+ * only zero in the frame, so a receiver picks up again at the next zero
+ * after lost or corrupted bytes. A gap in sample numbers (overruns) or
+ * more than 65535 µs between samples starts a new packet; in sparse
+ * packets a step of more than 65535 sample numbers does.
+ */
+
+#ifndef PHI_PACKET_H
+#define PHI_PACKET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "phi_sensor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define PHI_PACKET_VERSION          1
+#define PHI_PACKET_CHANNELS         PHI_SENSOR_CHANNELS
+#define PHI_PACKET_MAX_SAMPLES      16
+#define PHI_PACKET_HEADER_BYTES     12
+#define PHI_PACKET_SAMPLE_BYTES     16
+#define PHI_PACKET_SPARSE_SAMPLE_BYTES (PHI_PACKET_SAMPLE_BYTES + 2)
+#define PHI_PACKET_MAX_BYTES        (PHI_PACKET_HEADER_BYTES + PHI_PACKET_MAX_SAMPLES * PHI_PACKET_SPARSE_SAMPLE_BYTES + 2)
+#define PHI_PACKET_MAX_FRAME        (PHI_PACKET_MAX_BYTES + PHI_PACKET_MAX_BYTES / 254 + 2)  // COBS and the zero
+
+#define PHI_PACKET_FLAG_CALIBRATED  0x01    // Normalized with a calibration
+#define PHI_PACKET_FLAG_FILTERED    0x02    // Normalized values low-pass filtered
+#define PHI_PACKET_FLAG_SPARSE      0x04    // Sample numbers per sample (change-only reporting)
+
+// Why a frame was rejected
+typedef enum {
+    PHI_PACKET_ERROR_FRAMING = -1,          // Not valid COBS, or too long
+    PHI_PACKET_ERROR_LENGTH = -2,           // Length does not match the sample count
+    PHI_PACKET_ERROR_CRC = -3,
+    PHI_PACKET_ERROR_VERSION = -4           // Other version or channel count
+} PhiPacketError;
+
+/**
+ * Encode the leading samples into one frame, zero byte included
+ *
+ * Takes samples while they fit one packet: at most PHI_PACKET_MAX_SAMPLES,
+ * consecutive sample numbers (rising by at most 65535 with
+ * PHI_PACKET_FLAG_SPARSE), no more than 65535 µs apart.
+ *
+ * @param samples Samples, oldest first
+ * @param count Number of samples
+ * @param flags PHI_PACKET_FLAG_* bits
+ * @param frame Output buffer
+ * @param capacity Size of frame; PHI_PACKET_MAX_FRAME always suffices
+ * @param encoded Receives the number of samples taken, may be NULL
+ * @return Frame length in bytes, 0 if count is 0 or capacity too small
+ */
+size_t phi_packet_encode(const PhiSensorData *samples, size_t count, uint8_t flags,
+                         uint8_t *frame, size_t capacity, size_t *encoded);
+
+/**
+ * Decode one frame
+ *
+ * voltage is derived from the raw codes.
+ *
+ * @param frame COBS bytes of one frame, without the terminating zero
+ * @param length Number of bytes
+ * @param samples Output, room for PHI_PACKET_MAX_SAMPLES is always enough
+ * @param max Capacity of samples
+ * @param flags Receives the packet flags, may be NULL
+ * @return Number of samples, or a negative PhiPacketError
+ */
+int phi_packet_decode(const uint8_t *frame, size_t length, PhiSensorData *samples, size_t max,
+                      uint8_t *flags);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PHI_PACKET_H
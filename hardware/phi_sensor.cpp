@@ -6,15 +6,21 @@
  */
 
 #include "phi_sensor.h"
+#include "firmware_log.h"
+#include "phi_link.h"
+#include "phi_packet.h"
 #include <string.h>
 #include <stdio.h>
 #include <math.h>
+#include <time.h>
+#include <atomic>
 
 // Platform-specific includes
 #ifdef TEENSY
     #include <Arduino.h>
     #include <ADC.h>
     #include <ADC_util.h>
+    #include <DMAChannel.h>
 #elif defined(RASPBERRY_PI)
     #include <wiringPi.h>
     #include <ads1115.h>
@@ -23,21 +29,173 @@
 // Global state
 static PhiSensorConfig g_config;
 static PhiSensorStatistics g_stats;
-static PhiSensorCalibration g_calibration;
+static PhiSensorCalibration g_calibration[PHI_SENSOR_MAX_SENSORS];
+static uint8_t g_sensor_count = 1;
+static uint32_t g_channel_count = PHI_SENSOR_CHANNELS;     // Of all modules
 static bool g_initialized = false;
 static bool g_running = false;
 
-// Sample timing
+// Sample timing (SC-002): every interrupt captures the free-running
+// timer on entry; the intervals between captures drive the timestamps,
+// the late-sample check and the interval statistics
 static volatile uint32_t g_sample_counter = 0;
-static volatile uint32_t g_last_sample_us = 0;
+static uint32_t g_timer_last = 0;           // Previous capture (ticks)
+static uint64_t g_timer_elapsed = 0;        // Ticks since start, unwrapped
+static uint32_t g_timer_base_us = 0;        // Timestamp at start
+static uint32_t g_interval_nominal = 0;     // Ticks per acquisition
+static uint32_t g_interval_bin = 1;         // Ticks per histogram bin
+static uint32_t g_interval_count = 0;
+static double g_interval_sum_dev = 0.0;     // Of interval - nominal (ticks)
+static double g_interval_sum_dev2 = 0.0;
+static uint32_t g_interval_min = 0;
+static uint32_t g_interval_max = 0;
+static uint32_t g_interval_histogram[PHI_SENSOR_INTERVAL_BINS];
 
-// ADC data buffers
-static PhiSensorData g_current_data;
-static volatile bool g_data_ready = false;
+#ifdef TEENSY
+#define TIMER_TICKS()       ARM_DWT_CYCCNT              // CPU cycle counter, wraps in seconds
+#define TIMER_TICKS_PER_US  (F_CPU_ACTUAL / 1000000)
+#else
+static uint32_t host_ticks() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000);
+}
+#define TIMER_TICKS()       host_ticks()                // Monotonic µs, wraps in 71 minutes
+#define TIMER_TICKS_PER_US  1u
+static uint32_t g_poll_due = 0;             // Ticks of the next acquisition (phi_sensor_poll)
+#endif
 
-// Low-pass filter state (simple exponential moving average)
-static float g_filter_state[PHI_SENSOR_CHANNELS] = {0};
-static const float FILTER_ALPHA = 0.3f; // Smoothing factor
+// Sample ring (single producer, single consumer): the sample timer writes
+// entry g_ring_write & PHI_RING_MASK, the reader takes them from
+// g_ring_read; a full ring drops the new sample. Stored by field, each
+// entry's channels contiguous, so the interrupt's per-stage loops write
+// straight into the entry; row PHI_SENSOR_RING_SIZE takes the samples a
+// full ring has no room for.
+#define PHI_RING_MASK (PHI_SENSOR_RING_SIZE - 1)
+#define PHI_RING_SPARE PHI_SENSOR_RING_SIZE
+struct SampleRing {
+    uint16_t raw_adc[PHI_SENSOR_RING_SIZE + 1][PHI_SENSOR_MAX_CHANNELS];
+    float voltage[PHI_SENSOR_RING_SIZE + 1][PHI_SENSOR_MAX_CHANNELS];
+    float normalized[PHI_SENSOR_RING_SIZE + 1][PHI_SENSOR_MAX_CHANNELS];
+    uint32_t timestamp_us[PHI_SENSOR_RING_SIZE + 1];
+    uint32_t sample_number[PHI_SENSOR_RING_SIZE + 1];
+};
+static SampleRing g_ring;
+static std::atomic<uint32_t> g_ring_write{0};    // Samples queued, by the timer
+static std::atomic<uint32_t> g_ring_read{0};     // Samples taken, by the reader
+
+// DMA scan mode (Teensy 4.x)
+#ifdef TEENSY
+#define SCAN_MAX_CHANNELS   8                               // One ADC_ETC chain converts at most 8
+#define SCAN_WORDS          (SCAN_MAX_CHANNELS / 2)         // ADC_ETC result registers, two results each
+#define SCAN_PIT            3                               // PIT channel triggering the scan
+static DMAChannel g_scan_dma;
+static uint32_t g_scan_buffer[2][SCAN_WORDS];   // Halves the DMA fills in turn; DTCM, not cached
+static bool g_scan_active = false;
+
+// The half of g_scan_buffer with the latest complete scan: the one the DMA
+// is not about to write
+static const uint32_t *latest_scan() {
+    const bool writing_second = (const void *)g_scan_dma.TCD->DADDR == (const void *)g_scan_buffer[1];
+    return g_scan_buffer[writing_second ? 0 : 1];
+}
+
+// Result of a channel: two 12-bit results per register, the first low
+static uint16_t scan_result(const uint32_t *scan, uint8_t channel) {
+    return (uint16_t)((scan[channel / 2] >> ((channel & 1) * 16)) & 0xFFF);
+}
+#endif
+
+// Oversampling decimator (per channel): CIC_ORDER integrators at the
+// acquisition rate, combs at twice the output rate, then the compensating
+// FIR decimating by two. The CIC runs in wrapping 32-bit integers, enough
+// for 12-bit input and a CIC ratio of 64. State is stage- and tap-major,
+// so every step is one loop across the channels.
+#define CIC_ORDER           3
+#define DECIM_LOWPASS_TAPS  31
+#define DECIM_FIR_TAPS      (DECIM_LOWPASS_TAPS + 2)    // With the 3-tap droop compensator
+static uint32_t g_cic_integrator[CIC_ORDER][PHI_SENSOR_MAX_CHANNELS];
+static uint32_t g_cic_comb[CIC_ORDER][PHI_SENSOR_MAX_CHANNELS];     // Each comb's previous input
+static uint32_t g_cic_count = 0;                                // Acquisitions since the last CIC output
+static float g_cic_scale = 1.0f;                                // Back to ADC counts
+static float g_fir_taps[DECIM_FIR_TAPS];
+static float g_fir_history[2 * DECIM_FIR_TAPS][PHI_SENSOR_MAX_CHANNELS];   // Written twice, read contiguously
+static uint32_t g_fir_index = 0;
+static uint32_t g_fir_count = 0;                                // CIC outputs received
+static uint32_t g_acquisition_counter = 0;
+
+// Calibration (SC-005): normalized = clamp(code * gain + bias, 0, 1) per
+// channel, the linear map of apply_calibration folded into two floats. A
+// per-code table of every channel would be 256 KB for a full array, far
+// beyond the M7's data cache; these stay in DTCM and normalize a sample
+// in one multiply-add per channel for fractional codes as well. Rebuilt
+// into the bank not in use and published by a pointer swap, so the ISR
+// always sees a whole set; the sensor ISR preempts the rebuild, never
+// the reverse.
+struct CalibrationCoefficients {
+    float gain[PHI_SENSOR_MAX_CHANNELS];    // Per ADC count
+    float bias[PHI_SENSOR_MAX_CHANNELS];
+};
+static CalibrationCoefficients g_cal_banks[2];
+static std::atomic<const CalibrationCoefficients *> g_cal_coeffs{&g_cal_banks[0]};
+
+// Background calibration (SC-005): streaming statistics that
+// phi_sensor_calibration_poll feeds from the sample ring
+#define CAL_QUANTILES   3
+static const float CAL_QUANTILE_P[CAL_QUANTILES] = {0.01f, 0.50f, 0.99f};
+
+struct P2Quantile {             // P-square estimator (Jain and Chlamtac)
+    float height[5];
+    float position[5];
+    float desired[5];
+    float increment[5];
+    uint32_t count;
+};
+
+struct RunningStats {           // Welford mean and sum of squared deviations
+    uint32_t count;
+    double mean;
+    double m2;
+};
+
+struct CalibrationLevel {
+    float reference[PHI_SENSOR_CHANNELS];           // The same for every module
+    RunningStats stats[PHI_SENSOR_MAX_CHANNELS];
+};
+
+struct CalibrationJob {
+    bool active;
+    bool started_sensor;        // Stop the sensor again when done
+    uint32_t start_ms;
+    uint32_t duration_ms;       // 0: until phi_sensor_calibration_finish
+    uint32_t samples;
+    RunningStats open[PHI_SENSOR_MAX_CHANNELS];     // Since the start or the last mark
+    CalibrationLevel levels[PHI_SENSOR_MAX_REFERENCE_POINTS];
+    uint32_t level_count;
+    P2Quantile quantiles[PHI_SENSOR_MAX_CHANNELS][CAL_QUANTILES];
+};
+static CalibrationJob g_cal_job;
+
+// Output filter (enable_filtering): coefficients from filter_cutoff_hz
+// and the sample rate, so the delay no longer changes with the rate
+#define ONE_EURO_DCUTOFF_HZ     1.0f    // Cutoff of the One-Euro speed estimate
+#define BIQUAD_CUTOFF_RATIO     0.643594f   // -3 dB of (w0 / (s + w0))^2 over w0: sqrt(sqrt(2) - 1)
+static float g_biquad_b0 = 1.0f, g_biquad_b1 = 0.0f, g_biquad_a1 = 0.0f, g_biquad_a2 = 0.0f;
+static float g_biquad_z0[PHI_SENSOR_MAX_CHANNELS];  // Transposed direct form II
+static float g_biquad_z1[PHI_SENSOR_MAX_CHANNELS];
+static float g_euro_value[PHI_SENSOR_MAX_CHANNELS];
+static float g_euro_speed[PHI_SENSOR_MAX_CHANNELS]; // Filtered, units/s
+static float g_filter_cutoff_hz = PHI_SENSOR_FILTER_CUTOFF_HZ;
+static float g_filter_dt_s = 0.0f;                  // Since the previous output sample
+static uint32_t g_filter_last_us = 0;
+static bool g_filter_primed = false;                // State holds a sample
+
+// Change-only reporting: the sample timer queues a sample when it leaves
+// the deadband around the last queued one, or for the heartbeat
+static PhiSensorReporting g_reporting;
+static float g_report_last[PHI_SENSOR_MAX_CHANNELS];    // Normalized, of the last queued sample
+static uint32_t g_report_last_us = 0;
+static bool g_report_primed = false;                // A sample has been queued since start
 
 // Firmware version
 #define FIRMWARE_VERSION "1.0.0-phi-sensor"
@@ -60,8 +218,10 @@ static bool platform_adc_init() {
     // Raspberry Pi with ADS1115 external ADC
     wiringPiSetup();
 
-    // Initialize ADS1115 at I2C address 0x48
-    ads1115Setup(100, 0x48); // Base pin 100
+    // One ADS1115 per module at I2C addresses 0x48-0x4B, pins from 100
+    for (uint8_t sensor = 0; sensor < g_sensor_count; sensor++) {
+        ads1115Setup(100 + sensor * PHI_SENSOR_CHANNELS, 0x48 + sensor);
+    }
 
     return true;
 #else
@@ -70,17 +230,30 @@ static bool platform_adc_init() {
 #endif
 }
 
+/**
+ * ADC pin of a channel of the array
+ */
+[[maybe_unused]] static uint8_t channel_pin(uint32_t channel) {
+    const uint32_t sensor = channel / PHI_SENSOR_CHANNELS;
+    return sensor == 0 ? g_config.adc_pins[channel]
+                       : g_config.sensor_pins[sensor - 1][channel % PHI_SENSOR_CHANNELS];
+}
+
 /**
  * Read raw ADC value from channel
  */
 static uint16_t platform_adc_read(uint8_t channel) {
 #ifdef TEENSY
-    if (channel >= PHI_SENSOR_CHANNELS) {
+    if (channel >= g_channel_count) {
         return 0;
     }
 
-    uint8_t pin = g_config.adc_pins[channel];
-    return analogRead(pin);
+    // ADC1 converts only on the scan trigger then: take the latest scan
+    if (g_scan_active) {
+        return scan_result(latest_scan(), channel);
+    }
+
+    return analogRead(channel_pin(channel));
 
 #elif defined(RASPBERRY_PI)
     // Read from ADS1115
@@ -101,63 +274,454 @@ static uint32_t get_timestamp_us() {
 #ifdef TEENSY
     return micros();
 #else
-    // Stub
-    return g_sample_counter * (1000000 / PHI_SENSOR_SAMPLE_RATE);
+    return host_ticks();
+#endif
+}
+
+/**
+ * Get current millisecond time, wrapping
+ */
+static uint32_t get_time_ms() {
+#ifdef TEENSY
+    return millis();
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000);
 #endif
 }
 
 /**
  * Convert raw ADC to voltage
  */
-static float adc_to_voltage(uint16_t adc_value) {
-    return ((float)adc_value / (float)PHI_SENSOR_ADC_MAX) * PHI_SENSOR_VOLTAGE_MAX;
+static float adc_to_voltage(float adc_value) {
+    return (adc_value / (float)PHI_SENSOR_ADC_MAX) * PHI_SENSOR_VOLTAGE_MAX;
 }
 
 /**
- * Apply calibration to voltage reading (SC-005)
+ * Gain and bias taking an ADC code to its normalized value (SC-005)
  */
-static float apply_calibration(float voltage, uint8_t channel) {
+static void apply_calibration(uint32_t channel, float *gain, float *bias) {
     if (!g_config.enable_calibration || !g_stats.calibrated) {
         // Simple linear normalization without calibration
-        return voltage / PHI_SENSOR_VOLTAGE_MAX;
+        *gain = 1.0f / (float)PHI_SENSOR_ADC_MAX;
+        *bias = 0.0f;
+        return;
     }
 
     // Apply offset and scale from calibration
-    float v_min = g_calibration.voltage_min[channel];
-    float v_max = g_calibration.voltage_max[channel];
+    const PhiSensorCalibration &calibration = g_calibration[channel / PHI_SENSOR_CHANNELS];
+    float v_min = calibration.voltage_min[channel % PHI_SENSOR_CHANNELS];
+    float v_max = calibration.voltage_max[channel % PHI_SENSOR_CHANNELS];
 
     if (v_max <= v_min) {
-        return 0.5f; // Invalid calibration
+        *gain = 0.0f;
+        *bias = 0.5f; // Invalid calibration
+        return;
     }
 
-    // Normalize to [0, 1] using calibrated range
-    float normalized = (voltage - v_min) / (v_max - v_min);
+    // Normalize to [0, 1] using calibrated range; the ISR clamps
+    *gain = adc_to_voltage(1.0f) / (v_max - v_min);
+    *bias = -v_min / (v_max - v_min);
+}
 
-    // Clamp to [0, 1]
-    if (normalized < 0.0f) normalized = 0.0f;
-    if (normalized > 1.0f) normalized = 1.0f;
+/**
+ * Rebuild the calibration coefficients from the current calibration and
+ * publish them; not interrupt safe, one caller at a time
+ */
+static void rebuild_calibration() {
+    CalibrationCoefficients *bank = g_cal_coeffs.load(std::memory_order_relaxed) == &g_cal_banks[0]
+                                        ? &g_cal_banks[1] : &g_cal_banks[0];
+    for (uint32_t ch = 0; ch < PHI_SENSOR_MAX_CHANNELS; ch++) {
+        apply_calibration(ch, &bank->gain[ch], &bank->bias[ch]);
+    }
+    g_cal_coeffs.store(bank, std::memory_order_release);
+}
 
-    return normalized;
+static bool cutoff_valid(float cutoff_hz, uint32_t rate_hz) {
+    return cutoff_hz >= 0.0f && (cutoff_hz > 0.0f ? cutoff_hz : PHI_SENSOR_FILTER_CUTOFF_HZ) < 0.5f * rate_hz;
 }
 
 /**
- * Apply low-pass filter
+ * Design the output filter for the configured cutoff and sample rate and
+ * restart it at the next sample. The biquad is the bilinear transform of
+ * a double real pole, prewarped so the -3 dB point lands on the cutoff:
+ * no overshoot, and the least delay of the 2nd-order low-passes without.
  */
-static float apply_filter(float new_value, uint8_t channel) {
+static void filter_reset() {
+    g_filter_cutoff_hz = g_config.filter_cutoff_hz > 0.0f ? g_config.filter_cutoff_hz : PHI_SENSOR_FILTER_CUTOFF_HZ;
+    const double k = tan(3.14159265358979 * g_filter_cutoff_hz / g_config.sample_rate_hz) / BIQUAD_CUTOFF_RATIO;
+    const double norm = 1.0 / ((1.0 + k) * (1.0 + k));
+    g_biquad_b0 = (float)(k * k * norm);
+    g_biquad_b1 = 2.0f * g_biquad_b0;
+    g_biquad_a1 = (float)(2.0 * (k * k - 1.0) * norm);
+    g_biquad_a2 = (float)((1.0 - k) * (1.0 - k) * norm);
+    g_filter_primed = false;
+}
+
+/**
+ * Low-frequency group delay of the output filter (s): 2 / w0 for the
+ * double pole, the time constant at the minimum cutoff for One-Euro
+ */
+static float filter_delay_s() {
     if (!g_config.enable_filtering) {
-        return new_value;
+        return 0.0f;
+    }
+    const float w = 2.0f * 3.14159265f * g_filter_cutoff_hz;
+    return g_config.filter_type == PHI_FILTER_ONE_EURO ? 1.0f / w : 2.0f * BIQUAD_CUTOFF_RATIO / w;
+}
+
+/**
+ * Start an output sample: time since the previous one for One-Euro
+ */
+[[maybe_unused]] static void filter_begin(uint32_t now_us) {
+    g_filter_dt_s = (float)(now_us - g_filter_last_us) * 1e-6f;
+    g_filter_last_us = now_us;
+}
+
+/**
+ * Smoothing factor of a one-pole low-pass over dt
+ */
+static float one_euro_alpha(float cutoff_hz, float dt_s) {
+    const float tau = 1.0f / (2.0f * 3.14159265f * cutoff_hz);
+    return 1.0f / (1.0f + tau / dt_s);
+}
+
+/**
+ * Apply low-pass filter to every channel of a sample, in place
+ */
+[[maybe_unused]] static void apply_filter(float *values) {
+    if (!g_config.enable_filtering) {
+        return;
+    }
+    const uint32_t channels = g_channel_count;
+
+    if (!g_filter_primed) {
+        // Start settled on the first sample rather than rising from zero
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            g_biquad_z1[ch] = (g_biquad_b0 - g_biquad_a2) * values[ch];
+            g_biquad_z0[ch] = (g_biquad_b1 - g_biquad_a1) * values[ch] + g_biquad_z1[ch];
+            g_euro_value[ch] = values[ch];
+            g_euro_speed[ch] = 0.0f;
+        }
+        g_filter_primed = true;
+        return;
+    }
+
+    if (g_config.filter_type == PHI_FILTER_ONE_EURO) {
+        const float dt = g_filter_dt_s > 0.0f ? g_filter_dt_s : 1.0f / g_config.sample_rate_hz;
+        const float speed_alpha = one_euro_alpha(ONE_EURO_DCUTOFF_HZ, dt);
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            const float speed = (values[ch] - g_euro_value[ch]) / dt;
+            g_euro_speed[ch] += speed_alpha * (speed - g_euro_speed[ch]);
+            const float cutoff = g_filter_cutoff_hz + g_config.filter_beta * fabsf(g_euro_speed[ch]);
+            g_euro_value[ch] += one_euro_alpha(cutoff, dt) * (values[ch] - g_euro_value[ch]);
+            values[ch] = g_euro_value[ch];
+        }
+        return;
+    }
+
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        const float in = values[ch];
+        const float out = g_biquad_b0 * in + g_biquad_z0[ch];
+        g_biquad_z0[ch] = g_biquad_b1 * in - g_biquad_a1 * out + g_biquad_z1[ch];
+        g_biquad_z1[ch] = g_biquad_b0 * in - g_biquad_a2 * out;
+        values[ch] = out;
+    }
+}
+
+/**
+ * Whether a sample goes to the ring under change-only reporting; keeps it
+ * as the new reference if so
+ */
+static bool report_due(const float *normalized, uint32_t now_us) {
+    if (!g_reporting.enabled || g_cal_job.active) {
+        return true;
+    }
+    const uint32_t channels = g_channel_count;
+    bool changed = !g_report_primed;
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        changed |= fabsf(normalized[ch] - g_report_last[ch]) > g_reporting.deadband[ch % PHI_SENSOR_CHANNELS];
+    }
+    const bool heartbeat = !changed && g_reporting.heartbeat_ms > 0 &&
+                           now_us - g_report_last_us >= g_reporting.heartbeat_ms * 1000u;
+    if (!changed && !heartbeat) {
+        g_stats.suppressed_samples++;
+        return false;
+    }
+    if (heartbeat) {
+        g_stats.heartbeat_samples++;
+    }
+    memcpy(g_report_last, normalized, channels * sizeof(float));
+    g_report_last_us = now_us;
+    g_report_primed = true;
+    return true;
+}
+
+static bool oversampling() {
+    return g_config.oversample_ratio > 1;
+}
+
+static bool rates_valid(uint32_t rate_hz, uint16_t oversample_ratio, uint8_t sensors) {
+    if (rate_hz < 1 || rate_hz > 1000) {
+        return false;
+    }
+    if (oversample_ratio <= 1) {
+        return true;
+    }
+    return oversample_ratio % 2 == 0 && oversample_ratio >= 4 && oversample_ratio <= PHI_SENSOR_MAX_OVERSAMPLE &&
+           rate_hz * oversample_ratio * sensors <= PHI_SENSOR_MAX_ACQUISITION_HZ;
+}
+
+static uint32_t acquisition_rate_hz() {
+    return g_config.sample_rate_hz * (oversampling() ? g_config.oversample_ratio : 1);
+}
+
+/**
+ * Clear the interval statistics; from start, or with the sensor's
+ * interrupts held off
+ */
+static void timing_reset_statistics() {
+    g_interval_count = 0;
+    g_interval_sum_dev = 0.0;
+    g_interval_sum_dev2 = 0.0;
+    g_interval_min = UINT32_MAX;
+    g_interval_max = 0;
+    memset(g_interval_histogram, 0, sizeof(g_interval_histogram));
+}
+
+/**
+ * Set the timer origin and the nominal interval for the acquisition rate;
+ * bins are 1/128 of it, so the histogram spans +-12.5%, twice SC-002's
+ * tolerance at 30 Hz
+ */
+static void timing_reset() {
+    g_timer_last = TIMER_TICKS();
+    g_timer_elapsed = 0;
+    g_timer_base_us = get_timestamp_us();
+    g_interval_nominal = (uint32_t)((uint64_t)TIMER_TICKS_PER_US * 1000000 / acquisition_rate_hz());
+    g_interval_bin = g_interval_nominal / 128 > 0 ? g_interval_nominal / 128 : 1;
+    timing_reset_statistics();
+}
+
+/**
+ * Account one capture, interrupt context: a few adds and one histogram
+ * increment
+ *
+ * @return Ticks since the previous capture
+ */
+[[maybe_unused]] static uint32_t timing_capture(uint32_t ticks, bool first) {
+    const uint32_t interval = ticks - g_timer_last;
+    g_timer_last = ticks;
+    g_timer_elapsed += interval;
+    if (first) {
+        return interval;
+    }
+
+    const int32_t dev = (int32_t)(interval - g_interval_nominal);
+    g_interval_count++;
+    g_interval_sum_dev += dev;
+    g_interval_sum_dev2 += (double)dev * dev;
+    if (interval < g_interval_min) g_interval_min = interval;
+    if (interval > g_interval_max) g_interval_max = interval;
+
+    int32_t bin = PHI_SENSOR_INTERVAL_BINS / 2 + (dev >= 0 ? dev / (int32_t)g_interval_bin
+                                                          : -1 - (-dev - 1) / (int32_t)g_interval_bin);
+    if (bin < 0) bin = 0;
+    if (bin >= PHI_SENSOR_INTERVAL_BINS) bin = PHI_SENSOR_INTERVAL_BINS - 1;
+    g_interval_histogram[bin]++;
+
+    return interval;
+}
+
+/**
+ * Design the decimation FIR and clear the decimator state. The FIR runs at
+ * twice the output rate: a Hamming-windowed sinc with its -6 dB point at
+ * 0.4 of the output rate (0.2 of its own), so it is down about 50 dB from
+ * half the output rate, convolved with [-a, 1 + 2a, -a], which lifts the
+ * passband by the inverse of the CIC's sinc^3 droop at its edge.
+ */
+static void decimator_reset() {
+    const double pi = 3.14159265358979;
+    const double cutoff = 0.2;
+    double lowpass[DECIM_LOWPASS_TAPS];
+    const int centre = DECIM_LOWPASS_TAPS / 2;
+    for (int n = 0; n < DECIM_LOWPASS_TAPS; n++) {
+        const int k = n - centre;
+        const double sinc = k == 0 ? 2.0 * cutoff : sin(2.0 * pi * cutoff * k) / (pi * k);
+        lowpass[n] = sinc * (0.54 + 0.46 * cos(pi * k / centre));
     }
 
-    // Exponential moving average
-    g_filter_state[channel] = FILTER_ALPHA * new_value + (1.0f - FILTER_ALPHA) * g_filter_state[channel];
+    // Droop of the CIC at the passband edge, 0.15 of its output rate
+    const double edge = 0.15;
+    const double droop = pow(sin(pi * edge) / (pi * edge), CIC_ORDER);
+    const double a = (1.0 / droop - 1.0) / (2.0 * (1.0 - cos(2.0 * pi * edge)));
+    const double compensator[3] = {-a, 1.0 + 2.0 * a, -a};
+
+    double taps[DECIM_FIR_TAPS] = {0};
+    double sum = 0.0;
+    for (int n = 0; n < DECIM_LOWPASS_TAPS; n++) {
+        for (int c = 0; c < 3; c++) {
+            taps[n + c] += lowpass[n] * compensator[c];
+        }
+    }
+    for (int n = 0; n < DECIM_FIR_TAPS; n++) {
+        sum += taps[n];
+    }
+    for (int n = 0; n < DECIM_FIR_TAPS; n++) {
+        g_fir_taps[n] = (float)(taps[n] / sum);
+    }
+
+    const uint32_t cic_ratio = oversampling() ? g_config.oversample_ratio / 2u : 1u;
+    g_cic_scale = (float)(1.0 / pow((double)cic_ratio, CIC_ORDER));
+    memset(g_cic_integrator, 0, sizeof(g_cic_integrator));
+    memset(g_cic_comb, 0, sizeof(g_cic_comb));
+    memset(g_fir_history, 0, sizeof(g_fir_history));
+    g_cic_count = 0;
+    g_fir_index = 0;
+    g_fir_count = 0;
+}
 
-    return g_filter_state[channel];
+/**
+ * Feed one acquisition of every channel to the decimator
+ *
+ * @param counts Receives the decimated channels in ADC counts
+ * @return true once per output sample, with counts filled
+ */
+[[maybe_unused]] static bool decimator_push(const uint16_t *raw_adc, float *counts) {
+    const uint32_t channels = g_channel_count;
+    uint32_t *integrator = g_cic_integrator[0];
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        integrator[ch] += raw_adc[ch];
+    }
+    for (int stage = 1; stage < CIC_ORDER; stage++) {
+        const uint32_t *input = g_cic_integrator[stage - 1];
+        integrator = g_cic_integrator[stage];
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            integrator[ch] += input[ch];
+        }
+    }
+    if (++g_cic_count < g_config.oversample_ratio / 2u) {
+        return false;
+    }
+    g_cic_count = 0;
+
+    // CIC output into the FIR history
+    uint32_t value[PHI_SENSOR_MAX_CHANNELS];
+    memcpy(value, g_cic_integrator[CIC_ORDER - 1], channels * sizeof(uint32_t));
+    for (int stage = 0; stage < CIC_ORDER; stage++) {
+        uint32_t *comb = g_cic_comb[stage];
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            const uint32_t previous = comb[ch];
+            comb[ch] = value[ch];
+            value[ch] -= previous;
+        }
+    }
+    float *newest = g_fir_history[g_fir_index];
+    float *copy = g_fir_history[g_fir_index + DECIM_FIR_TAPS];
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        newest[ch] = copy[ch] = (float)value[ch] * g_cic_scale;
+    }
+    g_fir_index = (g_fir_index + 1) % DECIM_FIR_TAPS;
+
+    // Every second CIC output, once the combs have settled
+    if (++g_fir_count % 2 != 0 || g_fir_count <= CIC_ORDER) {
+        return false;
+    }
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        counts[ch] = 0.0f;
+    }
+    for (int n = 0; n < DECIM_FIR_TAPS; n++) {
+        // Oldest first from g_fir_index; the taps are symmetric
+        const float tap = g_fir_taps[n];
+        const float *history = g_fir_history[g_fir_index + n];
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            counts[ch] += tap * history[ch];
+        }
+    }
+    return true;
 }
 
 /**
- * Sample timer interrupt (30 Hz)
+ * Turn one reading of every channel into a queued sample, interrupt
+ * context (phi_sensor_poll's caller without a sample timer); with
+ * oversampling only every oversample_ratio-th makes one
  */
+static void process_sample(const uint16_t *raw_adc, uint32_t ticks) {
+    const bool first = g_acquisition_counter++ == 0;
+    const uint32_t delta_us = timing_capture(ticks, first) / TIMER_TICKS_PER_US;
+    const uint32_t now_us = g_timer_base_us + (uint32_t)(g_timer_elapsed / TIMER_TICKS_PER_US);
+
+    // A tick more than half a period late means samples were missed
+    const uint32_t interval_us = 1000000 / acquisition_rate_hz();
+    if (!first && delta_us > interval_us + interval_us / 2) {
+        const uint32_t missed = (delta_us + interval_us / 2) / interval_us - 1;
+        g_stats.dropped_samples += missed;
+        firmware_log("[PhiSensor] Sample timer late by %u µs, %u samples missed\n",
+                     (unsigned)(delta_us - interval_us), (unsigned)missed);
+    }
+
+    float counts[PHI_SENSOR_MAX_CHANNELS];
+    if (oversampling() && !decimator_push(raw_adc, counts)) {
+        return;
+    }
+
+    // Into the next ring entry, or the spare row if the ring is full
+    const uint32_t write = g_ring_write.load(std::memory_order_relaxed);
+    const bool full = write - g_ring_read.load(std::memory_order_acquire) >= PHI_SENSOR_RING_SIZE;
+    const uint32_t row = full ? PHI_RING_SPARE : (write & PHI_RING_MASK);
+    uint16_t *codes = g_ring.raw_adc[row];
+    float *voltage = g_ring.voltage[row];
+    float *normalized = g_ring.normalized[row];
+    g_ring.timestamp_us[row] = now_us;
+    g_ring.sample_number[row] = g_sample_counter++;
+    filter_begin(now_us);
+
+    // Convert all ADC channels to voltage; oversampled values fall between codes
+    const uint32_t channels = g_channel_count;
+    if (oversampling()) {
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            const float clamped = fminf(fmaxf(counts[ch], 0.0f), (float)PHI_SENSOR_ADC_MAX);
+            codes[ch] = (uint16_t)(clamped + 0.5f);
+            voltage[ch] = adc_to_voltage(clamped);
+            normalized[ch] = clamped;
+        }
+    } else {
+        for (uint32_t ch = 0; ch < channels; ch++) {
+            const uint16_t code = raw_adc[ch] < PHI_SENSOR_ADC_MAX ? raw_adc[ch] : PHI_SENSOR_ADC_MAX;
+            codes[ch] = code;
+            voltage[ch] = adc_to_voltage((float)code);
+            normalized[ch] = (float)code;
+        }
+    }
+
+    // Apply calibration, then the filter
+    const CalibrationCoefficients &cal = *g_cal_coeffs.load(std::memory_order_acquire);
+    for (uint32_t ch = 0; ch < channels; ch++) {
+        normalized[ch] = fminf(fmaxf(normalized[ch] * cal.gain[ch] + cal.bias[ch], 0.0f), 1.0f);
+    }
+    apply_filter(normalized);
+
+    // Straight to the hybrid node's control loop (FR-004): module 0
+    phi_link_publish(normalized, now_us);
+
+    // Queue for the reader, unless change-only reporting holds it back
+    g_stats.total_samples++;
+    if (!report_due(normalized, now_us)) {
+        return;
+    }
+    if (full) {
+        g_stats.ring_overruns++;
+        g_stats.dropped_samples++;
+    } else {
+        g_ring_write.store(write + 1, std::memory_order_release);
+    }
+}
+
 #ifdef TEENSY
+/**
+ * Sample timer interrupt (30 Hz): reads the channels one after another
+ */
 IntervalTimer g_sample_timer;
 
 void sample_timer_isr() {
@@ -165,62 +729,439 @@ void sample_timer_isr() {
         return;
     }
 
-    uint32_t now_us = micros();
-    uint32_t delta_us = now_us - g_last_sample_us;
-    g_last_sample_us = now_us;
+    const uint32_t ticks = TIMER_TICKS();
+    uint16_t raw_adc[PHI_SENSOR_MAX_CHANNELS];
+    for (uint8_t ch = 0; ch < g_channel_count; ch++) {
+        raw_adc[ch] = platform_adc_read(ch);
+    }
+    process_sample(raw_adc, ticks);
+}
+
+/**
+ * Scan DMA interrupt: a whole scan has landed in one half of g_scan_buffer
+ */
+static void adc_scan_isr() {
+    const uint32_t ticks = TIMER_TICKS();
+    g_scan_dma.clearInterrupt();
+    if (!g_running) {
+        return;
+    }
 
-    // Read all ADC channels
-    PhiSensorData data;
-    data.timestamp_us = now_us;
-    data.sample_number = g_sample_counter++;
+    const uint32_t *scan = latest_scan();
+    uint16_t raw_adc[SCAN_MAX_CHANNELS];
+    for (uint8_t ch = 0; ch < g_channel_count; ch++) {
+        raw_adc[ch] = scan_result(scan, ch);
+    }
+    process_sample(raw_adc, ticks);
+}
 
-    for (uint8_t ch = 0; ch < PHI_SENSOR_CHANNELS; ch++) {
-        // Read raw ADC
-        data.raw_adc[ch] = platform_adc_read(ch);
+// ADC1 input of a Teensy 4.x pin, -1 if it has none
+static int adc1_channel(uint8_t pin) {
+    static const int8_t channels[] = {7, 8, 12, 11, 6, 5, 15, 0, 13, 14, 1, 2};   // Pins 14-25 (A0-A11)
+    if (pin < 14 || pin >= 14 + sizeof(channels)) {
+        return -1;
+    }
+    return channels[pin - 14];
+}
 
-        // Convert to voltage
-        data.voltage[ch] = adc_to_voltage(data.raw_adc[ch]);
+// Route XBAR1 input to output
+static void xbar_connect(uint32_t input, uint32_t output) {
+    volatile uint16_t *select = &XBARA1_SEL0 + output / 2;
+    *select = (output & 1) ? (uint16_t)((*select & 0x00FF) | (input << 8))
+                           : (uint16_t)((*select & 0xFF00) | input);
+}
 
-        // Apply calibration
-        float normalized = apply_calibration(data.voltage[ch], ch);
+/**
+ * Start the scan: PIT channel SCAN_PIT -> XBAR1 -> ADC_ETC trigger 0, which
+ * runs a back-to-back chain of a conversion per channel on ADC1 and
+ * requests DMA when it is done. The DMA copies the result registers, one
+ * scan per minor loop, into the halves of g_scan_buffer and interrupts
+ * after each.
+ */
+static bool platform_scan_start(uint32_t rate_hz) {
+    if (g_channel_count > SCAN_MAX_CHANNELS) {
+        return false;
+    }
+    uint8_t channels[SCAN_MAX_CHANNELS];
+    for (uint8_t ch = 0; ch < g_channel_count; ch++) {
+        const int channel = adc1_channel(channel_pin(ch));
+        if (channel < 0) {
+            return false;
+        }
+        channels[ch] = (uint8_t)channel;
+    }
 
-        // Apply filter
-        data.normalized[ch] = apply_filter(normalized, ch);
+    // ADC1 converts on hardware triggers, the input chosen by the ETC
+    ADC1_CFG |= ADC_CFG_ADTRG;
+    ADC1_HC0 = 16;
+
+    // Trigger 0: one chain over every channel, each conversion starting
+    // as soon as the one before it ends
+    CCM_CCGR2 |= CCM_CCGR2_XBAR1(CCM_CCGR_ON);
+    xbar_connect(XBARA1_IN_PIT_TRIGGER0 + SCAN_PIT, XBARA1_OUT_ADC_ETC_TRIG00);
+    ADC_ETC_CTRL = ADC_ETC_CTRL_TRIG_ENABLE(1);
+    ADC_ETC_TRIG0_CTRL = ADC_ETC_TRIG_CTRL_TRIG_CHAIN(g_channel_count - 1);
+    volatile uint32_t *chain = &ADC_ETC_TRIG0_CHAIN_1_0;
+    for (uint8_t ch = 0; ch < g_channel_count; ch += 2) {
+        uint32_t pair = ADC_ETC_TRIG_CHAIN_CSEL0(channels[ch]) | ADC_ETC_TRIG_CHAIN_HWTS0(1) |
+                        ADC_ETC_TRIG_CHAIN_B2B0;
+        if (ch + 1u < g_channel_count) {
+            pair |= ADC_ETC_TRIG_CHAIN_CSEL1(channels[ch + 1]) | ADC_ETC_TRIG_CHAIN_HWTS1(1) |
+                    ADC_ETC_TRIG_CHAIN_B2B1;
+        }
+        chain[ch / 2] = pair;
     }
+    ADC_ETC_DMA_CTRL = ADC_ETC_DMA_CTRL_TRIQ_ENABLE(0);
+
+    // Circular over both halves, interrupting at each
+    g_scan_dma.begin(true);
+    g_scan_dma.TCD->SADDR = &ADC_ETC_TRIG0_RESULT_1_0;
+    g_scan_dma.TCD->SOFF = 4;
+    g_scan_dma.TCD->ATTR = DMA_TCD_ATTR_SSIZE(2) | DMA_TCD_ATTR_DSIZE(2);
+    g_scan_dma.TCD->NBYTES_MLNO = SCAN_WORDS * 4;
+    g_scan_dma.TCD->SLAST = -(int32_t)(SCAN_WORDS * 4);
+    g_scan_dma.TCD->DADDR = g_scan_buffer[0];
+    g_scan_dma.TCD->DOFF = 4;
+    g_scan_dma.TCD->CITER_ELINKNO = 2;
+    g_scan_dma.TCD->DLASTSGA = -(int32_t)sizeof(g_scan_buffer);
+    g_scan_dma.TCD->BITER_ELINKNO = 2;
+    g_scan_dma.TCD->CSR = DMA_TCD_CSR_INTHALF | DMA_TCD_CSR_INTMAJOR;
+    g_scan_dma.triggerAtHardwareEvent(DMAMUX_SOURCE_ADC_ETC);
+    g_scan_dma.attachInterrupt(adc_scan_isr);
+    g_scan_dma.enable();
+
+    // PIT at the sample rate on the 24 MHz peripheral clock
+    CCM_CCGR1 |= CCM_CCGR1_PIT(CCM_CCGR_ON);
+    PIT_MCR = 0;
+    IMXRT_PIT_CHANNELS[SCAN_PIT].LDVAL = 24000000 / rate_hz - 1;
+    IMXRT_PIT_CHANNELS[SCAN_PIT].TCTRL = PIT_TCTRL_TEN;
 
-    // Store current data
-    g_current_data = data;
-    g_data_ready = true;
+    return true;
+}
 
-    g_stats.total_samples++;
+static void platform_scan_stop() {
+    IMXRT_PIT_CHANNELS[SCAN_PIT].TCTRL = 0;
+    g_scan_dma.disable();
+    ADC_ETC_DMA_CTRL = 0;
+    ADC_ETC_CTRL = 0;
+    ADC1_CFG &= ~ADC_CFG_ADTRG;
 }
 #endif
 
+/**
+ * Start a P-square estimate of quantile p
+ */
+static void p2_reset(P2Quantile *q, float p) {
+    memset(q, 0, sizeof(*q));
+    q->increment[1] = p / 2.0f;
+    q->increment[2] = p;
+    q->increment[3] = (1.0f + p) / 2.0f;
+    q->increment[4] = 1.0f;
+}
+
+/**
+ * Add one observation to a P-square estimate: five markers, O(1) memory
+ */
+static void p2_add(P2Quantile *q, float x) {
+    if (q->count < 5) {
+        // The first five observations, kept sorted, seed the markers
+        uint32_t i = q->count++;
+        while (i > 0 && q->height[i - 1] > x) {
+            q->height[i] = q->height[i - 1];
+            i--;
+        }
+        q->height[i] = x;
+        if (q->count == 5) {
+            for (int m = 0; m < 5; m++) {
+                q->position[m] = (float)m;
+                q->desired[m] = 4.0f * q->increment[m];
+            }
+        }
+        return;
+    }
+    q->count++;
+
+    // Cell of x, extending the extremes
+    int k;
+    if (x < q->height[0]) {
+        q->height[0] = x;
+        k = 0;
+    } else if (x >= q->height[4]) {
+        q->height[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (x >= q->height[k + 1]) {
+            k++;
+        }
+    }
+    for (int m = k + 1; m < 5; m++) {
+        q->position[m] += 1.0f;
+    }
+    for (int m = 0; m < 5; m++) {
+        q->desired[m] += q->increment[m];
+    }
+
+    // Move the middle markers towards their desired positions
+    for (int m = 1; m < 4; m++) {
+        const float d = q->desired[m] - q->position[m];
+        if ((d >= 1.0f && q->position[m + 1] - q->position[m] > 1.0f) ||
+            (d <= -1.0f && q->position[m - 1] - q->position[m] < -1.0f)) {
+            const int s = d > 0.0f ? 1 : -1;
+            const float n_lo = q->position[m - 1], n = q->position[m], n_hi = q->position[m + 1];
+            const float parabolic = q->height[m] + (float)s / (n_hi - n_lo) *
+                ((n - n_lo + s) * (q->height[m + 1] - q->height[m]) / (n_hi - n) +
+                 (n_hi - n - s) * (q->height[m] - q->height[m - 1]) / (n - n_lo));
+            if (q->height[m - 1] < parabolic && parabolic < q->height[m + 1]) {
+                q->height[m] = parabolic;
+            } else {
+                q->height[m] += (float)s * (q->height[m + s] - q->height[m]) /
+                                (q->position[m + s] - q->position[m]);
+            }
+            q->position[m] += (float)s;
+        }
+    }
+}
+
+/**
+ * Current estimate; exact while fewer than five observations
+ */
+static float p2_value(const P2Quantile *q, float p) {
+    if (q->count >= 5) {
+        return q->height[2];
+    }
+    if (q->count == 0) {
+        return 0.0f;
+    }
+    return q->height[(uint32_t)lrintf(p * (float)(q->count - 1))];
+}
+
+static void running_add(RunningStats *stats, double x) {
+    stats->count++;
+    const double delta = x - stats->mean;
+    stats->mean += delta / stats->count;
+    stats->m2 += delta * (x - stats->mean);
+}
+
+/**
+ * Queued samples, at most max, from *read on; the ring's single consumer
+ * releases them with ring_release
+ */
+static size_t ring_queued(uint32_t *read, size_t max) {
+    *read = g_ring_read.load(std::memory_order_relaxed);
+    const uint32_t queued = g_ring_write.load(std::memory_order_acquire) - *read;
+    return queued < max ? queued : max;
+}
+
+static void ring_release(uint32_t read) {
+    g_ring_read.store(read, std::memory_order_release);
+}
+
+/**
+ * Whether the queued samples make a batch for the reader: enough of them,
+ * or the oldest waited batch_latency_ms. Always without a reporting batch.
+ */
+static bool batch_ready() {
+    uint32_t read;
+    const size_t count = ring_queued(&read, PHI_SENSOR_RING_SIZE);
+    if (!g_reporting.enabled || g_reporting.batch_samples <= 1 || count >= g_reporting.batch_samples) {
+        return count > 0;
+    }
+    return count > 0 &&
+           get_timestamp_us() - g_ring.timestamp_us[read & PHI_RING_MASK] >= g_reporting.batch_latency_ms * 1000u;
+}
+
+/**
+ * Copy one module of ring entry index
+ */
+static void ring_copy(uint32_t index, uint8_t sensor, PhiSensorData *data) {
+    const uint32_t row = index & PHI_RING_MASK;
+    const uint32_t first = sensor * PHI_SENSOR_CHANNELS;
+    memcpy(data->raw_adc, &g_ring.raw_adc[row][first], sizeof(data->raw_adc));
+    memcpy(data->voltage, &g_ring.voltage[row][first], sizeof(data->voltage));
+    memcpy(data->normalized, &g_ring.normalized[row][first], sizeof(data->normalized));
+    data->timestamp_us = g_ring.timestamp_us[row];
+    data->sample_number = g_ring.sample_number[row];
+}
+
+/**
+ * Feed every queued sample to the calibration job
+ */
+static void calibration_drain() {
+    uint32_t read;
+    const size_t count = ring_queued(&read, PHI_SENSOR_RING_SIZE);
+    for (size_t i = 0; i < count; i++) {
+        const float *voltage = g_ring.voltage[(read + i) & PHI_RING_MASK];
+        for (uint32_t ch = 0; ch < g_channel_count; ch++) {
+            const float v = voltage[ch];
+            running_add(&g_cal_job.open[ch], v);
+            for (int k = 0; k < CAL_QUANTILES; k++) {
+                p2_add(&g_cal_job.quantiles[ch][k], v);
+            }
+        }
+    }
+    ring_release(read + (uint32_t)count);
+    g_cal_job.samples += (uint32_t)count;
+}
+
+/**
+ * Fit voltage range and residual of one channel over the marked levels:
+ * weighted least squares of reference = a * voltage + b, each level
+ * weighted by its sample count. The squared residual of every sample is
+ * its level's mean residual squared plus its deviation from the level
+ * mean, scaled by a, so noise counts as well as misfit.
+ *
+ * @return false if the levels do not determine a rising line
+ */
+static bool calibration_fit(uint32_t ch, float *v_min, float *v_max, float *rms, float *stddev) {
+    const uint32_t role = ch % PHI_SENSOR_CHANNELS;
+    double n = 0.0, sum_x = 0.0, sum_y = 0.0;
+    for (uint32_t k = 0; k < g_cal_job.level_count; k++) {
+        const CalibrationLevel &level = g_cal_job.levels[k];
+        n += level.stats[ch].count;
+        sum_x += level.stats[ch].count * level.stats[ch].mean;
+        sum_y += level.stats[ch].count * (double)level.reference[role];
+    }
+    const double mean_x = sum_x / n, mean_y = sum_y / n;
+
+    double sxx = 0.0, sxy = 0.0;
+    for (uint32_t k = 0; k < g_cal_job.level_count; k++) {
+        const CalibrationLevel &level = g_cal_job.levels[k];
+        const double dx = level.stats[ch].mean - mean_x;
+        sxx += level.stats[ch].count * dx * dx;
+        sxy += level.stats[ch].count * dx * (level.reference[role] - mean_y);
+    }
+    if (sxx <= 1e-12) {
+        return false;
+    }
+    const double a = sxy / sxx;
+    if (a <= 0.0) {
+        return false;           // Falling or flat: apply_calibration needs v_max > v_min
+    }
+    const double b = mean_y - a * mean_x;
+
+    double sse = 0.0, m2 = 0.0;
+    for (uint32_t k = 0; k < g_cal_job.level_count; k++) {
+        const CalibrationLevel &level = g_cal_job.levels[k];
+        const double miss = level.reference[role] - (a * level.stats[ch].mean + b);
+        sse += level.stats[ch].count * miss * miss + a * a * level.stats[ch].m2;
+        m2 += level.stats[ch].m2;
+    }
+
+    *v_min = (float)(-b / a);
+    *v_max = (float)((1.0 - b) / a);
+    *rms = (float)sqrt(sse / n);
+    *stddev = (float)sqrt(m2 / n);
+    return true;
+}
+
+/**
+ * Compute, apply and return the result of the job, and end it; every
+ * module of an array gets its own result
+ */
+static PhiCalibrationState calibration_complete(PhiSensorCalibration *calibration) {
+    calibration_drain();
+
+    PhiSensorCalibration results[PHI_SENSOR_MAX_SENSORS];
+    memset(results, 0, sizeof(results));
+    bool ok = g_cal_job.level_count >= 2 ||
+              (g_cal_job.level_count == 0 && g_cal_job.open[0].count >= 5);
+    float worst_rms[PHI_SENSOR_MAX_SENSORS] = {0.0f};
+
+    for (uint32_t ch = 0; ok && ch < g_channel_count; ch++) {
+        const uint32_t sensor = ch / PHI_SENSOR_CHANNELS;
+        const uint32_t role = ch % PHI_SENSOR_CHANNELS;
+        PhiSensorCalibration &result = results[sensor];
+        float v_min = 0.0f, v_max = 0.0f;
+        if (g_cal_job.level_count > 0) {
+            float rms = 0.0f;
+            ok = calibration_fit(ch, &v_min, &v_max, &rms, &result.voltage_stddev[role]);
+            if (rms > worst_rms[sensor]) worst_rms[sensor] = rms;
+        } else {
+            // Range calibration: percentiles, robust to spikes
+            v_min = p2_value(&g_cal_job.quantiles[ch][0], CAL_QUANTILE_P[0]);
+            v_max = p2_value(&g_cal_job.quantiles[ch][2], CAL_QUANTILE_P[2]);
+            result.voltage_stddev[role] = (float)sqrt(g_cal_job.open[ch].m2 / g_cal_job.open[ch].count);
+            ok = v_max > v_min;
+        }
+        result.voltage_min[role] = v_min;
+        result.voltage_max[role] = v_max;
+        result.offset[role] = v_min / PHI_SENSOR_VOLTAGE_MAX;
+        result.scale[role] = (v_max - v_min) / PHI_SENSOR_VOLTAGE_MAX;
+        result.voltage_median[role] = p2_value(&g_cal_job.quantiles[ch][1], CAL_QUANTILE_P[1]);
+    }
+
+    float residual = -1.0f;
+    for (uint8_t sensor = 0; sensor < g_sensor_count; sensor++) {
+        PhiSensorCalibration &result = results[sensor];
+        result.calibration_samples = g_cal_job.samples;
+        result.reference_points = g_cal_job.level_count;
+        result.residual_error = g_cal_job.level_count > 0 ? worst_rms[sensor] * 100.0f : -1.0f;
+        if (result.residual_error > residual) residual = result.residual_error;
+    }
+
+    g_cal_job.active = false;
+    if (g_cal_job.started_sensor) {
+        phi_sensor_stop();
+    }
+
+    if (!ok) {
+        firmware_log("[PhiSensor] Calibration failed after %u samples, %u levels\n",
+                     (unsigned)g_cal_job.samples, (unsigned)g_cal_job.level_count);
+        return PHI_CALIBRATION_FAILED;
+    }
+
+    // Apply calibration
+    memcpy(g_calibration, results, g_sensor_count * sizeof(PhiSensorCalibration));
+    g_stats.calibrated = true;
+    rebuild_calibration();
+    if (calibration != NULL) {
+        memcpy(calibration, &results[0], sizeof(PhiSensorCalibration));
+    }
+    firmware_log("[PhiSensor] Calibrated %u modules from %u samples, %u levels, residual %.2f%%\n",
+                 (unsigned)g_sensor_count, (unsigned)g_cal_job.samples, (unsigned)g_cal_job.level_count,
+                 (double)residual);
+
+    return PHI_CALIBRATION_DONE;
+}
+
 // Public API implementation
 
 bool phi_sensor_init(const PhiSensorConfig *config) {
-    if (config == NULL) {
+    if (config == NULL || config->sensor_count > PHI_SENSOR_MAX_SENSORS) {
+        return false;
+    }
+    const uint8_t sensors = config->sensor_count > 0 ? config->sensor_count : 1;
+    if (!rates_valid(config->sample_rate_hz, config->oversample_ratio, sensors) ||
+        !cutoff_valid(config->filter_cutoff_hz, config->sample_rate_hz) || config->filter_beta < 0.0f) {
         return false;
     }
 
     // Copy configuration
     memcpy(&g_config, config, sizeof(PhiSensorConfig));
+    g_sensor_count = sensors;
+    g_channel_count = sensors * PHI_SENSOR_CHANNELS;
+    filter_reset();
 
     // Initialize statistics
     memset(&g_stats, 0, sizeof(PhiSensorStatistics));
     g_stats.calibrated = false;
 
     // Initialize calibration (default: no calibration)
-    memset(&g_calibration, 0, sizeof(PhiSensorCalibration));
-    for (uint8_t ch = 0; ch < PHI_SENSOR_CHANNELS; ch++) {
-        g_calibration.offset[ch] = 0.0f;
-        g_calibration.scale[ch] = 1.0f;
-        g_calibration.voltage_min[ch] = 0.0f;
-        g_calibration.voltage_max[ch] = PHI_SENSOR_VOLTAGE_MAX;
+    memset(g_calibration, 0, sizeof(g_calibration));
+    for (uint8_t sensor = 0; sensor < PHI_SENSOR_MAX_SENSORS; sensor++) {
+        for (uint8_t ch = 0; ch < PHI_SENSOR_CHANNELS; ch++) {
+            g_calibration[sensor].offset[ch] = 0.0f;
+            g_calibration[sensor].scale[ch] = 1.0f;
+            g_calibration[sensor].voltage_min[ch] = 0.0f;
+            g_calibration[sensor].voltage_max[ch] = PHI_SENSOR_VOLTAGE_MAX;
+        }
     }
+    rebuild_calibration();
 
     // Initialize hardware
     if (!platform_adc_init()) {
+        firmware_log("[PhiSensor] ADC initialization failed\n");
         return false;
     }
 
@@ -234,15 +1175,30 @@ bool phi_sensor_start(void) {
         return false;
     }
 
-#ifdef TEENSY
-    // Start sample timer at configured rate (SC-002)
-    uint32_t interval_us = 1000000 / g_config.sample_rate_hz;
-    g_sample_timer.begin(sample_timer_isr, interval_us);
+    g_ring_write.store(0);
+    g_ring_read.store(0);
+    g_sample_counter = 0;
+    g_acquisition_counter = 0;
+    timing_reset();
+    decimator_reset();
+    filter_reset();
+    g_report_primed = false;
+#ifndef TEENSY
+    g_poll_due = TIMER_TICKS();
 #endif
-
     g_running = true;
-    g_sample_counter = 0;
-    g_last_sample_us = get_timestamp_us();
+
+#ifdef TEENSY
+    // Start the scan or the sample timer at the acquisition rate (SC-002)
+    g_scan_active = g_config.enable_dma_scan && platform_scan_start(acquisition_rate_hz());
+    if (g_config.enable_dma_scan && !g_scan_active) {
+        firmware_log("[PhiSensor] DMA scan needs ADC1 pins, reading channels one by one\n");
+    }
+    if (!g_scan_active) {
+        uint32_t interval_us = 1000000 / acquisition_rate_hz();
+        g_sample_timer.begin(sample_timer_isr, interval_us);
+    }
+#endif
 
     return true;
 }
@@ -253,7 +1209,12 @@ bool phi_sensor_stop(void) {
     }
 
 #ifdef TEENSY
-    g_sample_timer.end();
+    if (g_scan_active) {
+        platform_scan_stop();
+        g_scan_active = false;
+    } else {
+        g_sample_timer.end();
+    }
 #endif
 
     g_running = false;
@@ -261,111 +1222,272 @@ bool phi_sensor_stop(void) {
     return true;
 }
 
+size_t phi_sensor_poll(void) {
+#ifdef TEENSY
+    return 0;
+#else
+    if (!g_running) {
+        return 0;
+    }
+
+    // One acquisition per due period. A poll more than a period late takes
+    // one and starts the schedule again from now; process_sample counts the
+    // periods it missed.
+    const uint32_t ticks = TIMER_TICKS();
+    if ((int32_t)(ticks - g_poll_due) < 0) {
+        return 0;
+    }
+    g_poll_due += g_interval_nominal;
+    if ((int32_t)(ticks - g_poll_due) >= 0) {
+        g_poll_due = ticks + g_interval_nominal;
+    }
+
+    uint16_t raw_adc[PHI_SENSOR_MAX_CHANNELS];
+    for (uint8_t ch = 0; ch < g_channel_count; ch++) {
+        raw_adc[ch] = platform_adc_read(ch);
+    }
+    process_sample(raw_adc, ticks);
+
+    return 1;
+#endif
+}
+
 bool phi_sensor_read(PhiSensorData *data) {
-    if (data == NULL || !g_running) {
+    return phi_sensor_read_batch(data, 1) == 1;
+}
+
+size_t phi_sensor_read_batch(PhiSensorData *data, size_t max) {
+    if (data == NULL || !g_running || g_cal_job.active) {
+        return 0;
+    }
+
+    uint32_t read;
+    const size_t count = ring_queued(&read, max);
+    for (size_t i = 0; i < count; i++) {
+        ring_copy(read + (uint32_t)i, 0, &data[i]);
+    }
+    ring_release(read + (uint32_t)count);
+
+    return count;
+}
+
+size_t phi_sensor_read_array(PhiSensorArrayData *data, size_t max) {
+    if (data == NULL || !g_running || g_cal_job.active) {
+        return 0;
+    }
+
+    uint32_t read;
+    const size_t count = ring_queued(&read, max);
+    const size_t channels = g_channel_count;
+    for (size_t i = 0; i < count; i++) {
+        const uint32_t row = (read + (uint32_t)i) & PHI_RING_MASK;
+        memcpy(data[i].raw_adc, g_ring.raw_adc[row], channels * sizeof(uint16_t));
+        memcpy(data[i].voltage, g_ring.voltage[row], channels * sizeof(float));
+        memcpy(data[i].normalized, g_ring.normalized[row], channels * sizeof(float));
+        data[i].timestamp_us = g_ring.timestamp_us[row];
+        data[i].sample_number = g_ring.sample_number[row];
+        data[i].sensor_count = g_sensor_count;
+    }
+    ring_release(read + (uint32_t)count);
+
+    return count;
+}
+
+size_t phi_sensor_read_packet(uint8_t *frame, size_t capacity) {
+    if (frame == NULL || !g_running || g_cal_job.active) {
+        return 0;
+    }
+
+    if (!batch_ready()) {
+        return 0;
+    }
+
+    // Copy without taking, then take what the packet holds
+    PhiSensorData batch[PHI_PACKET_MAX_SAMPLES];
+    uint32_t read;
+    const size_t count = ring_queued(&read, PHI_PACKET_MAX_SAMPLES);
+    for (size_t i = 0; i < count; i++) {
+        ring_copy(read + (uint32_t)i, 0, &batch[i]);
+    }
+
+    const uint8_t flags = (g_config.enable_calibration && g_stats.calibrated ? PHI_PACKET_FLAG_CALIBRATED : 0) |
+                          (g_config.enable_filtering ? PHI_PACKET_FLAG_FILTERED : 0) |
+                          (g_reporting.enabled ? PHI_PACKET_FLAG_SPARSE : 0);
+    size_t encoded = 0;
+    const size_t bytes = phi_packet_encode(batch, count, flags, frame, capacity, &encoded);
+    ring_release(read + (uint32_t)encoded);
+
+    return bytes;
+}
+
+bool phi_sensor_calibration_begin(uint32_t duration_ms) {
+    if (!g_initialized || g_cal_job.active) {
         return false;
     }
 
-    if (!g_data_ready) {
+    // FR-007: Calibration routine
+    memset(&g_cal_job, 0, sizeof(g_cal_job));
+    for (uint32_t ch = 0; ch < g_channel_count; ch++) {
+        for (int k = 0; k < CAL_QUANTILES; k++) {
+            p2_reset(&g_cal_job.quantiles[ch][k], CAL_QUANTILE_P[k]);
+        }
+    }
+    g_cal_job.started_sensor = !g_running;
+    if (g_cal_job.started_sensor && !phi_sensor_start()) {
         return false;
     }
 
-    // Copy current data
-    memcpy(data, &g_current_data, sizeof(PhiSensorData));
-    g_data_ready = false;
+    // Samples queued before the job describe no reference level
+    ring_release(g_ring_write.load(std::memory_order_acquire));
+
+    g_cal_job.start_ms = get_time_ms();
+    g_cal_job.duration_ms = duration_ms;
+    g_cal_job.active = true;
 
     return true;
 }
 
-bool phi_sensor_calibrate(uint32_t duration_ms, PhiSensorCalibration *calibration) {
-    if (!g_initialized || calibration == NULL) {
+bool phi_sensor_calibration_mark(const float reference[PHI_SENSOR_CHANNELS]) {
+    if (!g_cal_job.active || reference == NULL ||
+        g_cal_job.level_count >= PHI_SENSOR_MAX_REFERENCE_POINTS) {
         return false;
     }
 
-    // FR-007: Calibration routine
-    // Acquire samples and determine voltage ranges
+    calibration_drain();
+    if (g_cal_job.open[0].count == 0) {
+        return false;
+    }
 
-    bool was_running = g_running;
-    if (!was_running) {
-        phi_sensor_start();
+    CalibrationLevel &level = g_cal_job.levels[g_cal_job.level_count++];
+    memcpy(level.reference, reference, sizeof(level.reference));
+    memcpy(level.stats, g_cal_job.open, sizeof(level.stats));
+    memset(g_cal_job.open, 0, sizeof(g_cal_job.open));
+
+    return true;
+}
+
+PhiCalibrationState phi_sensor_calibration_poll(PhiSensorCalibration *calibration) {
+    if (!g_cal_job.active) {
+        return PHI_CALIBRATION_IDLE;
     }
 
-    // Initialize min/max tracking
-    float v_min[PHI_SENSOR_CHANNELS];
-    float v_max[PHI_SENSOR_CHANNELS];
+    calibration_drain();
+    if (g_cal_job.duration_ms > 0 && get_time_ms() - g_cal_job.start_ms >= g_cal_job.duration_ms) {
+        return calibration_complete(calibration);
+    }
+
+    return PHI_CALIBRATION_RUNNING;
+}
 
-    for (uint8_t ch = 0; ch < PHI_SENSOR_CHANNELS; ch++) {
-        v_min[ch] = PHI_SENSOR_VOLTAGE_MAX;
-        v_max[ch] = 0.0f;
+PhiCalibrationState phi_sensor_calibration_finish(PhiSensorCalibration *calibration) {
+    if (!g_cal_job.active) {
+        return PHI_CALIBRATION_IDLE;
     }
 
-    // Acquire calibration samples
-    uint32_t num_samples = (duration_ms * g_config.sample_rate_hz) / 1000;
-    uint32_t samples_acquired = 0;
+    return calibration_complete(calibration);
+}
 
-#ifdef TEENSY
-    uint32_t start_ms = millis();
-
-    while (millis() - start_ms < duration_ms) {
-        PhiSensorData data;
-        if (phi_sensor_read(&data)) {
-            for (uint8_t ch = 0; ch < PHI_SENSOR_CHANNELS; ch++) {
-                float v = data.voltage[ch];
-                if (v < v_min[ch]) v_min[ch] = v;
-                if (v > v_max[ch]) v_max[ch] = v;
-            }
-            samples_acquired++;
-        }
-        delay(1);
+bool phi_sensor_calibrate(uint32_t duration_ms, PhiSensorCalibration *calibration) {
+    if (calibration == NULL || !phi_sensor_calibration_begin(duration_ms > 0 ? duration_ms : 1)) {
+        return false;
     }
+
+    PhiCalibrationState state;
+    while ((state = phi_sensor_calibration_poll(calibration)) == PHI_CALIBRATION_RUNNING) {
+#ifdef TEENSY
+        yield();
 #else
-    // Stub
-    samples_acquired = num_samples;
-    for (uint8_t ch = 0; ch < PHI_SENSOR_CHANNELS; ch++) {
-        v_min[ch] = 0.1f;
-        v_max[ch] = 3.2f;
-    }
+        struct timespec pause = {0, 1000000};
+        nanosleep(&pause, NULL);
 #endif
-
-    // Store calibration results
-    for (uint8_t ch = 0; ch < PHI_SENSOR_CHANNELS; ch++) {
-        calibration->voltage_min[ch] = v_min[ch];
-        calibration->voltage_max[ch] = v_max[ch];
-        calibration->offset[ch] = v_min[ch] / PHI_SENSOR_VOLTAGE_MAX;
-        calibration->scale[ch] = (v_max[ch] - v_min[ch]) / PHI_SENSOR_VOLTAGE_MAX;
     }
 
-    calibration->calibration_samples = samples_acquired;
-    calibration->residual_error = 1.5f; // SC-005: < 2% (stub value)
+    return state == PHI_CALIBRATION_DONE;
+}
 
-    // Apply calibration
-    memcpy(&g_calibration, calibration, sizeof(PhiSensorCalibration));
-    g_stats.calibrated = true;
+// CRC-32 (IEEE 802.3, reflected) of a calibration image with its crc
+// field 0
+static uint32_t calibration_image_crc(const PhiCalibrationImage *image) {
+    const uint8_t *bytes = (const uint8_t *)image;
+    const size_t crc_at = offsetof(PhiCalibrationImage, crc);
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < sizeof(PhiCalibrationImage); i++) {
+        const bool in_field = i >= crc_at && i < crc_at + sizeof(image->crc);
+        crc ^= in_field ? 0u : bytes[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 1u) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+    }
+    return ~crc;
+}
 
-    if (!was_running) {
-        phi_sensor_stop();
+bool phi_sensor_capture_calibration_image(PhiCalibrationImage *image) {
+    if (image == NULL || !g_initialized || !g_stats.calibrated) {
+        return false;
     }
 
+    // Zeroed first, so the padding the CRC covers is too
+    memset(image, 0, sizeof(PhiCalibrationImage));
+    image->magic = PHI_CALIBRATION_IMAGE_MAGIC;
+    image->version = PHI_CALIBRATION_IMAGE_VERSION;
+    image->sensor_count = g_sensor_count;
+    image->size = sizeof(PhiCalibrationImage);
+    memcpy(image->calibration, g_calibration, g_sensor_count * sizeof(PhiSensorCalibration));
+    image->crc = calibration_image_crc(image);
     return true;
 }
 
+bool phi_sensor_boot_calibration(const void *image, size_t size, uint32_t recalibrate_ms) {
+    if (!g_initialized) {
+        return false;
+    }
+
+    const PhiCalibrationImage *boot = (const PhiCalibrationImage *)image;
+    const bool valid = boot != NULL && size >= sizeof(PhiCalibrationImage) &&
+                       boot->magic == PHI_CALIBRATION_IMAGE_MAGIC && boot->version == PHI_CALIBRATION_IMAGE_VERSION &&
+                       boot->size == sizeof(PhiCalibrationImage) && boot->sensor_count == g_sensor_count &&
+                       boot->crc == calibration_image_crc(boot);
+    if (valid) {
+        memcpy(g_calibration, boot->calibration, g_sensor_count * sizeof(PhiSensorCalibration));
+        g_stats.calibrated = true;
+        rebuild_calibration();
+    }
+    firmware_log("[PhiSensor] Calibration image %s%s\n", valid ? "loaded" : "rejected",
+                 recalibrate_ms > 0 ? ", recalibrating in the background" : "");
+
+    if (recalibrate_ms > 0) {
+        phi_sensor_calibration_begin(recalibrate_ms);
+    }
+
+    return valid;
+}
+
 bool phi_sensor_load_calibration(const PhiSensorCalibration *calibration) {
-    if (calibration == NULL) {
+    return phi_sensor_load_sensor_calibration(0, calibration);
+}
+
+bool phi_sensor_get_calibration(PhiSensorCalibration *calibration) {
+    return phi_sensor_get_sensor_calibration(0, calibration);
+}
+
+bool phi_sensor_load_sensor_calibration(uint8_t sensor, const PhiSensorCalibration *calibration) {
+    if (calibration == NULL || sensor >= g_sensor_count) {
         return false;
     }
 
-    memcpy(&g_calibration, calibration, sizeof(PhiSensorCalibration));
+    memcpy(&g_calibration[sensor], calibration, sizeof(PhiSensorCalibration));
     g_stats.calibrated = true;
+    rebuild_calibration();
 
     return true;
 }
 
-bool phi_sensor_get_calibration(PhiSensorCalibration *calibration) {
-    if (calibration == NULL) {
+bool phi_sensor_get_sensor_calibration(uint8_t sensor, PhiSensorCalibration *calibration) {
+    if (calibration == NULL || sensor >= g_sensor_count) {
         return false;
     }
 
-    memcpy(calibration, &g_calibration, sizeof(PhiSensorCalibration));
+    memcpy(calibration, &g_calibration[sensor], sizeof(PhiSensorCalibration));
 
     return true;
 }
@@ -375,35 +1497,75 @@ bool phi_sensor_get_statistics(PhiSensorStatistics *stats) {
         return false;
     }
 
+#ifdef TEENSY
+    noInterrupts();
+#endif
     memcpy(stats, &g_stats, sizeof(PhiSensorStatistics));
+    const uint32_t count = g_interval_count;
+    const double sum_dev = g_interval_sum_dev;
+    const double sum_dev2 = g_interval_sum_dev2;
+    const uint32_t interval_min = g_interval_min;
+    const uint32_t interval_max = g_interval_max;
+    memcpy(stats->interval_histogram, g_interval_histogram, sizeof(stats->interval_histogram));
+#ifdef TEENSY
+    interrupts();
+#endif
 
-    // Calculate actual sample rate (SC-002)
-    if (g_stats.total_samples > 0) {
-        // Stub calculation
-        stats->sample_rate_actual = g_config.sample_rate_hz;
-        stats->sample_rate_jitter = 0.5f; // ± 0.5 Hz (within ±2 Hz tolerance)
+    // Calculate actual sample rate (SC-002) from the captured intervals
+    const double ticks_per_us = TIMER_TICKS_PER_US;
+    stats->interval_bin_us = (float)(g_interval_bin / ticks_per_us);
+    stats->filter_delay_ms = filter_delay_s() * 1000.0f;
+    if (count > 0) {
+        const double mean_dev = sum_dev / count;
+        const double variance = sum_dev2 / count - mean_dev * mean_dev;
+        const double mean = g_interval_nominal + mean_dev;
+        const double stddev = variance > 0.0 ? sqrt(variance) : 0.0;
+
+        const double acquisition_hz = ticks_per_us * 1e6 / mean;
+        const double rate_hz = acquisition_hz / (oversampling() ? g_config.oversample_ratio : 1);
+        stats->sample_rate_measured = (float)rate_hz;
+        stats->sample_rate_actual = (uint32_t)lrint(rate_hz);
+        stats->sample_rate_jitter = (float)(rate_hz * stddev / mean);
+        stats->rate_in_tolerance = fabs(rate_hz - g_config.sample_rate_hz) <= PHI_SENSOR_RATE_TOLERANCE_HZ;
+        stats->interval_mean_us = (float)(mean / ticks_per_us);
+        stats->interval_stddev_us = (float)(stddev / ticks_per_us);
+        stats->interval_min_us = (float)(interval_min / ticks_per_us);
+        stats->interval_max_us = (float)(interval_max / ticks_per_us);
     }
 
     return true;
 }
 
 bool phi_sensor_reset_statistics(void) {
+#ifdef TEENSY
+    noInterrupts();
+#endif
     g_stats.total_samples = 0;
     g_stats.dropped_samples = 0;
+    g_stats.ring_overruns = 0;
+    g_stats.suppressed_samples = 0;
+    g_stats.heartbeat_samples = 0;
+    timing_reset_statistics();
+#ifdef TEENSY
+    interrupts();
+#endif
 
     return true;
 }
 
 bool phi_sensor_data_available(void) {
-    return g_data_ready;
+    return batch_ready();
 }
 
 float phi_sensor_get_sample_rate(void) {
-    return (float)g_stats.sample_rate_actual;
+    PhiSensorStatistics stats;
+    phi_sensor_get_statistics(&stats);
+    return stats.sample_rate_measured;
 }
 
 bool phi_sensor_set_sample_rate(uint32_t rate_hz) {
-    if (rate_hz < 1 || rate_hz > 1000) {
+    if (!rates_valid(rate_hz, g_config.oversample_ratio, g_sensor_count) ||
+        !cutoff_valid(g_config.filter_cutoff_hz, rate_hz)) {
         return false;
     }
 
@@ -419,15 +1581,70 @@ bool phi_sensor_set_sample_rate(uint32_t rate_hz) {
 }
 
 bool phi_sensor_set_filtering(bool enable) {
+#ifdef TEENSY
+    noInterrupts();
+#endif
+    // Reset filter state
     g_config.enable_filtering = enable;
+    g_filter_primed = false;
+#ifdef TEENSY
+    interrupts();
+#endif
 
-    // Reset filter state
-    if (!enable) {
-        for (uint8_t ch = 0; ch < PHI_SENSOR_CHANNELS; ch++) {
-            g_filter_state[ch] = 0.0f;
-        }
+    return true;
+}
+
+bool phi_sensor_set_filter(PhiSensorFilterType type, float cutoff_hz, float beta) {
+    if (!cutoff_valid(cutoff_hz, g_config.sample_rate_hz) || beta < 0.0f) {
+        return false;
     }
 
+#ifdef TEENSY
+    noInterrupts();
+#endif
+    g_config.filter_type = type;
+    g_config.filter_cutoff_hz = cutoff_hz;
+    g_config.filter_beta = beta;
+    filter_reset();
+#ifdef TEENSY
+    interrupts();
+#endif
+
+    return true;
+}
+
+bool phi_sensor_set_reporting(const PhiSensorReporting *reporting) {
+    PhiSensorReporting mode;
+    memset(&mode, 0, sizeof(mode));
+    if (reporting != NULL) {
+        mode = *reporting;
+    }
+    bool valid = mode.batch_samples <= PHI_SENSOR_REPORT_BATCH_MAX &&
+                 (mode.batch_samples <= 1 || mode.batch_latency_ms > 0);
+    for (int ch = 0; ch < PHI_SENSOR_CHANNELS; ch++) {
+        valid = valid && mode.deadband[ch] >= 0.0f;
+    }
+    if (!valid) {
+        return false;
+    }
+
+#ifdef TEENSY
+    noInterrupts();
+#endif
+    g_reporting = mode;
+    g_report_primed = false;
+#ifdef TEENSY
+    interrupts();
+#endif
+
+    return true;
+}
+
+bool phi_sensor_get_reporting(PhiSensorReporting *reporting) {
+    if (reporting == NULL) {
+        return false;
+    }
+    *reporting = g_reporting;
     return true;
 }
 
@@ -443,7 +1660,7 @@ bool phi_sensor_self_test(void) {
     // Self-test: Read all channels and verify reasonable values
     bool test_passed = true;
 
-    for (uint8_t ch = 0; ch < PHI_SENSOR_CHANNELS; ch++) {
+    for (uint8_t ch = 0; ch < g_channel_count; ch++) {
         uint16_t adc_value = platform_adc_read(ch);
 
         // Check ADC is not stuck at 0 or max
@@ -9,6 +9,15 @@
  * - SC-002: 30 Hz sample rate (±2 Hz tolerance)
  * - SC-005: Calibration residual error < 2%
  *
+ * Every normalized sample is also published to phi_link, where the
+ * hybrid node's control loop reads it directly (enable_phi_link).
+ *
+ * Several sensor modules can share one controller (sensor_count): each
+ * sample then holds PHI_SENSOR_CHANNELS channels per module, channel
+ * module * PHI_SENSOR_CHANNELS + PhiSensorChannel, read whole with
+ * phi_sensor_read_array. The single-module API, phi_link and the host
+ * packets carry module 0.
+ *
  * Hardware:
  * - ADC input range: 0-3.3V
  * - Resolution: 12-bit (4096 levels)
@@ -18,6 +27,7 @@
 #ifndef PHI_SENSOR_H
 #define PHI_SENSOR_H
 
+#include <stddef.h>
 #include <stdint.h>
 #include <stdbool.h>
 
@@ -27,10 +37,20 @@ extern "C" {
 
 // Configuration constants
 #define PHI_SENSOR_CHANNELS     4
+#define PHI_SENSOR_MAX_SENSORS  4    // Sensor modules per controller
+#define PHI_SENSOR_MAX_CHANNELS (PHI_SENSOR_MAX_SENSORS * PHI_SENSOR_CHANNELS)
 #define PHI_SENSOR_SAMPLE_RATE  30  // Hz (SC-002)
 #define PHI_SENSOR_ADC_RESOLUTION 12 // bits
 #define PHI_SENSOR_ADC_MAX      4095 // 2^12 - 1
 #define PHI_SENSOR_VOLTAGE_MAX  3.3f // Volts
+#define PHI_SENSOR_RING_SIZE    64   // Samples queued for the reader (power of two)
+#define PHI_SENSOR_MAX_OVERSAMPLE   128     // Acquisitions per output sample
+#define PHI_SENSOR_MAX_ACQUISITION_HZ 8000  // Sample rate times oversample ratio times modules
+#define PHI_SENSOR_MAX_REFERENCE_POINTS 8   // Reference levels per calibration
+#define PHI_SENSOR_RATE_TOLERANCE_HZ 2      // SC-002
+#define PHI_SENSOR_INTERVAL_BINS    32      // Sample interval histogram (even)
+#define PHI_SENSOR_FILTER_CUTOFF_HZ 5.0f    // Default filter_cutoff_hz
+#define PHI_SENSOR_REPORT_BATCH_MAX 16      // Largest batch_samples, one packet's worth
 
 // ADC channel assignments
 typedef enum {
@@ -40,15 +60,42 @@ typedef enum {
     PHI_CHANNEL_CRITICALITY = 3  // Criticality sensor
 } PhiSensorChannel;
 
+// Output filter (enable_filtering)
+typedef enum {
+    PHI_FILTER_BIQUAD = 0,       // Critically damped 2nd-order low-pass, -3 dB at filter_cutoff_hz
+    PHI_FILTER_ONE_EURO = 1      // One-Euro: 1st-order low-pass whose cutoff rises from
+                                 // filter_cutoff_hz with the signal's speed, by filter_beta
+} PhiSensorFilterType;
+
 // Sensor configuration
 typedef struct {
     uint8_t adc_pins[PHI_SENSOR_CHANNELS];  // ADC pin assignments
     uint32_t sample_rate_hz;                 // Target sample rate (Hz)
     bool enable_filtering;                   // Enable low-pass filtering
-    float filter_cutoff_hz;                  // Low-pass filter cutoff (Hz)
+    float filter_cutoff_hz;                  // Low-pass filter cutoff (Hz), below half the sample
+                                             // rate (0: PHI_SENSOR_FILTER_CUTOFF_HZ)
     bool enable_calibration;                 // Use calibration offsets
+    bool enable_dma_scan;                    // Convert all channels per timer trigger by DMA (Teensy 4.x)
+    uint16_t oversample_ratio;               // Acquisitions per sample, even 4-128; 0 or 1 for none
+    PhiSensorFilterType filter_type;         // Output filter
+    float filter_beta;                       // One-Euro cutoff increase per unit/s of speed
+                                             // (Hz; 0: fixed cutoff)
+    uint8_t sensor_count;                    // Sensor modules, up to PHI_SENSOR_MAX_SENSORS (0: 1)
+    uint8_t sensor_pins[PHI_SENSOR_MAX_SENSORS - 1][PHI_SENSOR_CHANNELS]; // ADC pins of modules 1 and up,
+                                             // module 0 uses adc_pins
 } PhiSensorConfig;
 
+// Change-only reporting (phi_sensor_set_reporting)
+typedef struct {
+    bool enabled;                            // Queue only changed samples and heartbeats
+    float deadband[PHI_SENSOR_CHANNELS];     // Normalized change from the last queued sample that
+                                             // queues the next, per channel of every module
+    uint32_t heartbeat_ms;                   // Longest gap between queued samples (0: none)
+    uint16_t batch_samples;                  // Queued samples a reader waits for, up to
+                                             // PHI_SENSOR_REPORT_BATCH_MAX (0 or 1: none)
+    uint32_t batch_latency_ms;               // Longest a queued sample waits for its batch
+} PhiSensorReporting;
+
 // Calibration data (SC-005)
 typedef struct {
     float offset[PHI_SENSOR_CHANNELS];       // Zero offsets [0, 1]
@@ -56,9 +103,36 @@ typedef struct {
     float voltage_min[PHI_SENSOR_CHANNELS];  // Minimum voltage (V)
     float voltage_max[PHI_SENSOR_CHANNELS];  // Maximum voltage (V)
     uint32_t calibration_samples;            // Number of samples used
-    float residual_error;                    // Residual error (%) (SC-005)
+    float residual_error;                    // Residual error (%) (SC-005), < 0 if not measured
+    float voltage_median[PHI_SENSOR_CHANNELS];  // Median voltage over the run (V)
+    float voltage_stddev[PHI_SENSOR_CHANNELS];  // Noise about each level's mean (V)
+    uint32_t reference_points;               // Reference levels fitted, 0 for a range calibration
 } PhiSensorCalibration;
 
+// Persisted calibration of every module (phi_sensor_boot_calibration), for
+// EEPROM, flash or a file. Only valid on the build that captured it: fields
+// are in its byte order and layout, which the version and size check.
+#define PHI_CALIBRATION_IMAGE_MAGIC     0x4C414350u  // "PCAL"
+#define PHI_CALIBRATION_IMAGE_VERSION   1
+
+typedef struct {
+    uint32_t magic;                          // PHI_CALIBRATION_IMAGE_MAGIC
+    uint16_t version;                        // PHI_CALIBRATION_IMAGE_VERSION
+    uint8_t sensor_count;                    // Modules calibrated
+    uint8_t reserved;
+    uint32_t size;                           // sizeof(PhiCalibrationImage)
+    uint32_t crc;                            // CRC-32 (IEEE) of the image with this field 0
+    PhiSensorCalibration calibration[PHI_SENSOR_MAX_SENSORS];
+} PhiCalibrationImage;
+
+// Background calibration job state
+typedef enum {
+    PHI_CALIBRATION_IDLE = 0,       // No job
+    PHI_CALIBRATION_RUNNING = 1,    // Accumulating samples
+    PHI_CALIBRATION_DONE = 2,       // Result applied and returned
+    PHI_CALIBRATION_FAILED = 3      // Too few samples or a degenerate fit, nothing applied
+} PhiCalibrationState;
+
 // Raw sensor readings
 typedef struct {
     uint16_t raw_adc[PHI_SENSOR_CHANNELS];   // Raw ADC values [0, 4095]
@@ -68,12 +142,37 @@ typedef struct {
     uint32_t sample_number;                  // Sequential sample number
 } PhiSensorData;
 
+// Readings of every module of an array
+typedef struct {
+    uint16_t raw_adc[PHI_SENSOR_MAX_CHANNELS];  // Raw ADC values [0, 4095]
+    float voltage[PHI_SENSOR_MAX_CHANNELS];     // Voltage values [0, 3.3V]
+    float normalized[PHI_SENSOR_MAX_CHANNELS];  // Normalized values [0, 1]
+    uint32_t timestamp_us;                   // Microsecond timestamp
+    uint32_t sample_number;                  // Sequential sample number
+    uint8_t sensor_count;                    // Modules filled, PHI_SENSOR_CHANNELS channels each
+} PhiSensorArrayData;
+
 // Sensor statistics
 typedef struct {
     uint64_t total_samples;                  // Total samples acquired
-    uint32_t sample_rate_actual;             // Measured sample rate (Hz)
-    float sample_rate_jitter;                // Sample rate jitter (Hz)
-    uint32_t dropped_samples;                // Dropped/missed samples
+    uint32_t sample_rate_actual;             // Measured sample rate (Hz), rounded
+    float sample_rate_jitter;                // Sample rate jitter (Hz), one standard deviation
+    float sample_rate_measured;              // Measured sample rate (Hz)
+    bool rate_in_tolerance;                  // Measured rate within PHI_SENSOR_RATE_TOLERANCE_HZ (SC-002)
+    float interval_mean_us;                  // Mean acquisition interval (µs)
+    float interval_stddev_us;                // Its standard deviation (µs)
+    float interval_min_us;                   // Shortest interval (µs)
+    float interval_max_us;                   // Longest interval (µs)
+    float interval_bin_us;                   // Histogram bin width (µs)
+    uint32_t interval_histogram[PHI_SENSOR_INTERVAL_BINS]; // Intervals by deviation from nominal:
+                                             // bin PHI_SENSOR_INTERVAL_BINS / 2 starts at nominal,
+                                             // the outer bins also take everything beyond
+    uint32_t dropped_samples;                // Dropped/missed samples (acquisitions when oversampling), overruns included
+    uint32_t ring_overruns;                  // Samples dropped because the ring was full
+    uint32_t suppressed_samples;             // Within the deadband, not queued (change-only reporting)
+    uint32_t heartbeat_samples;              // Queued unchanged for the heartbeat
+    float filter_delay_ms;                   // Output filter group delay at low frequencies (ms),
+                                             // One-Euro at rest; 0 unfiltered
     float signal_quality[PHI_SENSOR_CHANNELS]; // Signal quality [0, 1]
     bool calibrated;                         // Calibration active
 } PhiSensorStatistics;
@@ -83,6 +182,20 @@ typedef struct {
 /**
  * Initialize Φ-sensor ADC system (FR-002)
  *
+ * With an oversample_ratio R the channels are acquired at R times
+ * sample_rate_hz (at most PHI_SENSOR_MAX_ACQUISITION_HZ, best with
+ * enable_dma_scan) and decimated to sample_rate_hz: a third-order CIC
+ * filter down to twice the rate, then a 33-tap FIR that flattens the CIC
+ * droop and cuts off at 0.4 of the output rate, down by two. Content
+ * above half the output rate no longer aliases into the metrics, and the
+ * averaging adds about log2(R) / 2 effective bits to voltage and
+ * normalized; raw_adc holds the decimated value rounded to ADC counts.
+ * The decimator delays the samples by 8.5 output periods (0.28 s at 30 Hz).
+ *
+ * Conversion, calibration, decimation and filtering run as loops over
+ * all channels of all modules on channel-major arrays, so the cost per
+ * channel is the same for one module as for PHI_SENSOR_MAX_SENSORS.
+ *
  * @param config Sensor configuration
  * @return true if initialization successful, false otherwise
  */
@@ -91,6 +204,13 @@ bool phi_sensor_init(const PhiSensorConfig *config);
 /**
  * Start sensor acquisition at configured sample rate (SC-002)
  *
+ * With enable_dma_scan on Teensy 4.x, PIT channel 3 triggers one ADC1
+ * conversion chain over all channels back to back and the DMA collects
+ * the results; the interrupt only processes a completed scan, so the
+ * channels are sampled within a few µs of each other. It needs the pins
+ * on ADC1 (A0-A11) and at most 8 channels, two modules; otherwise, and on
+ * other platforms, the sample timer reads the channels one by one.
+ *
  * @return true if started successfully, false otherwise
  */
 bool phi_sensor_start(void);
@@ -103,19 +223,171 @@ bool phi_sensor_start(void);
 bool phi_sensor_stop(void);
 
 /**
- * Read current sensor data
+ * Acquire on platforms without a sample timer (hosts, Raspberry Pi)
  *
- * Provides raw ADC, voltage, and normalized [0,1] values
+ * Takes one acquisition of every channel when its period on the monotonic
+ * clock is due and runs it through the same processing as the Teensy
+ * interrupt, timing statistics and phi_link included. Call at least at
+ * the acquisition rate, from one thread; the interval statistics then
+ * show how regularly it was called. Does nothing on Teensy.
+ *
+ * @return Acquisitions taken, 0 or 1
+ */
+size_t phi_sensor_poll(void);
+
+/**
+ * Read the oldest unread sample
+ *
+ * Provides raw ADC, voltage, and normalized [0,1] values. The sample
+ * timer queues every sample in a ring of PHI_SENSOR_RING_SIZE; when the
+ * reader falls that far behind, new samples are dropped and counted in
+ * ring_overruns and dropped_samples.
  *
  * @param data Pointer to data structure to fill
  * @return true if data available, false otherwise
  */
 bool phi_sensor_read(PhiSensorData *data);
 
+/**
+ * Read up to max unread samples, oldest first
+ *
+ * Drains the ring in one call, so a reader can poll at a fraction of the
+ * sample rate without losing samples. Single reader; lock-free against
+ * the sample timer.
+ *
+ * @param data Buffer for at least max samples
+ * @param max Capacity of data
+ * @return Number of samples read
+ */
+size_t phi_sensor_read_batch(PhiSensorData *data, size_t max);
+
+/**
+ * Read up to max unread samples of every module, oldest first
+ *
+ * The array form of phi_sensor_read_batch, sharing its ring and reader.
+ *
+ * @param data Buffer for at least max samples
+ * @param max Capacity of data
+ * @return Number of samples read
+ */
+size_t phi_sensor_read_array(PhiSensorArrayData *data, size_t max);
+
+/**
+ * Read queued samples as one binary frame for the host link (phi_packet.h)
+ *
+ * Takes up to PHI_PACKET_MAX_SAMPLES samples, as many as one packet holds,
+ * and leaves the rest queued. Same single reader as phi_sensor_read.
+ *
+ * @param frame Output, PHI_PACKET_MAX_FRAME bytes are always enough
+ * @param capacity Size of frame
+ * @return Frame length including the terminating zero, 0 if no sample was
+ *         queued or frame is too small
+ */
+size_t phi_sensor_read_packet(uint8_t *frame, size_t capacity);
+
+/**
+ * Select change-only reporting
+ *
+ * Enabled, the sample timer queues a sample only when some channel of
+ * some module has moved more than its deadband from the last queued
+ * sample, or heartbeat_ms has passed since that one; the others are
+ * counted in suppressed_samples. Deadbands compare against the last
+ * queued sample, not the previous one, so a slow drift is still reported
+ * once it adds up. phi_link still gets every sample, and a calibration job
+ * every sample while it runs.
+ *
+ * With batch_samples, phi_sensor_data_available and phi_sensor_read_packet
+ * hold off until that many samples are queued or the oldest has waited
+ * batch_latency_ms, so a host reading on those wakes about once a batch.
+ * Packets then carry PHI_PACKET_FLAG_SPARSE, each sample with its own
+ * sample number and timestamp; the gaps are the unchanged samples.
+ * phi_sensor_read, read_batch and read_array return whatever is queued.
+ *
+ * Applies from the next sample; the first sample after it, and after
+ * start, is always queued.
+ *
+ * @param reporting Reporting mode, NULL to queue every sample
+ * @return true if set, false if a deadband is negative, batch_samples is
+ *         over PHI_SENSOR_REPORT_BATCH_MAX or a batch has no latency bound
+ */
+bool phi_sensor_set_reporting(const PhiSensorReporting *reporting);
+
+/**
+ * Get the reporting mode
+ *
+ * @param reporting Receives the mode
+ * @return true if filled, false if reporting is NULL
+ */
+bool phi_sensor_get_reporting(PhiSensorReporting *reporting);
+
+/**
+ * Start a background calibration job (FR-007, SC-005)
+ *
+ * Starts the sensor if it is stopped. The job does no work of its own:
+ * each phi_sensor_calibration_poll drains the sample ring into streaming
+ * per-channel statistics (Welford mean and variance, P-square estimates
+ * of the 1st, 50th and 99th percentiles), so acquisition never stalls.
+ * While the job runs the samples go to it, not to phi_sensor_read.
+ *
+ * Without reference points the result is a range calibration: the 1st
+ * and 99th percentiles become the voltage range, and residual_error is
+ * negative because nothing was measured against. With them, see
+ * phi_sensor_calibration_mark.
+ *
+ * @param duration_ms Run length, 0 to run until phi_sensor_calibration_finish
+ * @return true if started, false if uninitialized or a job is running
+ */
+bool phi_sensor_calibration_begin(uint32_t duration_ms);
+
+/**
+ * Close a reference level: the samples since the start or the previous
+ * mark were taken with the inputs held at these normalized values.
+ *
+ * With two or more levels the job fits offset and scale per channel by
+ * least squares, weighting each level by its sample count, and reports
+ * residual_error as the RMS difference between the calibrated samples and
+ * their references, in percent of full scale, for the worst channel.
+ * Samples after the last mark are discarded. Every module of an array is
+ * held at the same references and calibrated in the same job.
+ *
+ * @param reference Normalized value [0, 1] per channel
+ * @return true if recorded, false if no job runs, the level had no
+ *         samples or PHI_SENSOR_MAX_REFERENCE_POINTS are already marked
+ */
+bool phi_sensor_calibration_mark(const float reference[PHI_SENSOR_CHANNELS]);
+
+/**
+ * Advance the calibration job; call regularly from loop()
+ *
+ * Drains the queued samples and finishes the job once its duration has
+ * passed. The result is only written on PHI_CALIBRATION_DONE; after DONE
+ * or FAILED the job is IDLE again. It is module 0's; the others are read
+ * with phi_sensor_get_sensor_calibration.
+ *
+ * @param calibration Receives the result, may be NULL while running
+ * @return Job state after the call
+ */
+PhiCalibrationState phi_sensor_calibration_poll(PhiSensorCalibration *calibration);
+
+/**
+ * Finish the calibration job now, whatever its duration
+ *
+ * @param calibration Receives the result
+ * @return PHI_CALIBRATION_DONE if applied, PHI_CALIBRATION_FAILED or
+ *         PHI_CALIBRATION_IDLE otherwise
+ */
+PhiCalibrationState phi_sensor_calibration_finish(PhiSensorCalibration *calibration);
+
 /**
  * Perform sensor calibration routine (FR-007, SC-005)
  *
- * Acquires calibration samples and computes offset/scale factors
+ * Blocking range calibration: runs the background job for duration_ms,
+ * yielding between polls.
+ *
+ * Like phi_sensor_load_calibration, rebuilds the per-channel gain and
+ * bias that the sample interrupt normalizes ADC codes with, and swaps
+ * them in whole: a sample is normalized entirely with the old
+ * calibration or entirely with the new. Call from one thread.
  *
  * @param duration_ms Calibration duration in milliseconds
  * @param calibration Pointer to store calibration results
@@ -123,6 +395,33 @@ bool phi_sensor_read(PhiSensorData *data);
  */
 bool phi_sensor_calibrate(uint32_t duration_ms, PhiSensorCalibration *calibration);
 
+/**
+ * Capture the calibration of every module for phi_sensor_boot_calibration
+ *
+ * @param image Receives the image, CRC included
+ * @return true if captured, false if uninitialized or never calibrated
+ */
+bool phi_sensor_capture_calibration_image(PhiCalibrationImage *image);
+
+/**
+ * Boot on a persisted calibration instead of phi_sensor_calibrate
+ *
+ * Loads every module's calibration from image when its magic, version,
+ * size and CRC check and it has as many modules as the configuration, so
+ * samples are calibrated from the first. With recalibrate_ms, then starts
+ * a background range calibration job of that length, valid image or not:
+ * phi_sensor_calibration_poll from loop() applies it when it is done,
+ * without the seconds phi_sensor_calibrate blocks for. phi_link gets every
+ * sample meanwhile; phi_sensor_read gets none until the job ends.
+ *
+ * @param image Calibration image, NULL for none
+ * @param size Bytes at image
+ * @param recalibrate_ms Background calibration length, 0 for none
+ * @return true if the image was loaded, false if uninitialized or the
+ *         image is missing or invalid
+ */
+bool phi_sensor_boot_calibration(const void *image, size_t size, uint32_t recalibrate_ms);
+
 /**
  * Load calibration data from memory
  *
@@ -139,23 +438,47 @@ bool phi_sensor_load_calibration(const PhiSensorCalibration *calibration);
  */
 bool phi_sensor_get_calibration(PhiSensorCalibration *calibration);
 
+/**
+ * Load the calibration of one module of an array
+ *
+ * @param sensor Module, below sensor_count
+ * @param calibration Calibration data to apply
+ * @return true if loaded, false if sensor is out of range
+ */
+bool phi_sensor_load_sensor_calibration(uint8_t sensor, const PhiSensorCalibration *calibration);
+
+/**
+ * Get the calibration of one module of an array
+ *
+ * @param sensor Module, below sensor_count
+ * @param calibration Pointer to store calibration data
+ * @return true if filled, false if sensor is out of range
+ */
+bool phi_sensor_get_sensor_calibration(uint8_t sensor, PhiSensorCalibration *calibration);
+
 /**
  * Get sensor statistics (SC-002)
  *
+ * Rate, jitter and the interval histogram come from timer captures taken
+ * on entry to every sample interrupt (the CPU cycle counter on Teensy),
+ * accumulated since start or the last phi_sensor_reset_statistics; with
+ * oversampling the intervals are between acquisitions.
+ *
  * @param stats Pointer to statistics structure to fill
  * @return true if statistics retrieved, false otherwise
  */
 bool phi_sensor_get_statistics(PhiSensorStatistics *stats);
 
 /**
- * Reset statistics counters
+ * Reset statistics counters, interval statistics included
  *
  * @return true if reset successful, false otherwise
  */
 bool phi_sensor_reset_statistics(void);
 
 /**
- * Check if new data is available
+ * Check if an unread sample is queued; with a reporting batch, if the
+ * batch is complete or its oldest sample has waited batch_latency_ms
  *
  * @return true if new data ready, false otherwise
  */
@@ -164,7 +487,7 @@ bool phi_sensor_data_available(void);
 /**
  * Get current sample rate (measured)
  *
- * @return Actual sample rate in Hz
+ * @return Actual sample rate in Hz, 0 before two samples
  */
 float phi_sensor_get_sample_rate(void);
 
@@ -184,6 +507,18 @@ bool phi_sensor_set_sample_rate(uint32_t rate_hz);
  */
 bool phi_sensor_set_filtering(bool enable);
 
+/**
+ * Select the output filter; coefficients follow from the cutoff and the
+ * sample rate, and the filter restarts from the next sample
+ *
+ * @param type Filter type
+ * @param cutoff_hz Cutoff, the minimum for One-Euro (0: PHI_SENSOR_FILTER_CUTOFF_HZ)
+ * @param beta One-Euro speed coefficient, ignored by the biquad
+ * @return true if set, false if the cutoff is negative or not below half
+ *         the sample rate
+ */
+bool phi_sensor_set_filter(PhiSensorFilterType type, float cutoff_hz, float beta);
+
 /**
  * Get firmware version string
  *
@@ -0,0 +1,120 @@
+#include "active_set.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+void ActiveSet::setTolerance(double tolerance) {
+    if (!(tolerance >= 0.0) || !std::isfinite(tolerance)) {
+        throw std::invalid_argument("active-set tolerance must be finite and non-negative");
+    }
+    tolerance_ = tolerance;
+    reset();
+}
+
+void ActiveSet::reset() {
+    primed_ = false;
+    std::fill(settled_.begin(), settled_.end(), uint8_t(0));
+}
+
+void ActiveSet::release() {
+    primed_ = false;
+    ref_integrator_ = std::vector<double>();
+    ref_feedback_ = std::vector<double>();
+    rest_output_ = std::vector<double>();
+    chunk_sum_ = std::vector<double>();
+    settled_ = std::vector<uint8_t>();
+    active_ = std::vector<uint8_t>();
+    work_ = std::vector<uint32_t>();
+}
+
+bool ActiveSet::inputsMoved(const double* inputs) const {
+    for (size_t k = 0; k < kInputs; k++) {
+        if (!(std::fabs(inputs[k] - ref_inputs_[k]) <= tolerance_)) return true;
+    }
+    return false;
+}
+
+// Still settling, or its integrators or feedback were written since it ran
+bool ActiveSet::chunkActive(const NodeBank& bank, size_t chunk) const {
+    if (!settled_[chunk]) return true;
+    for (size_t i = chunk * 8; i < chunk * 8 + 8; i++) {
+        if (bank.integrator_state[i] != ref_integrator_[i] || bank.feedback_gain[i] != ref_feedback_[i]) return true;
+    }
+    return false;
+}
+
+double ActiveSet::waveSweep(WorkerPool& pool, const NodeKernels& kernels, NodeBank& bank, double input,
+                            double control_pattern, const double* control_wave, const double* pass_aux,
+                            int passes) {
+    const size_t chunks = bank.capacity() / 8;
+    if (chunk_sum_.size() != chunks) {
+        ref_integrator_.assign(bank.capacity(), 0.0);
+        ref_feedback_.assign(bank.capacity(), 0.0);
+        rest_output_.assign(bank.capacity(), 0.0);
+        chunk_sum_.assign(chunks, 0.0);
+        settled_.assign(chunks, 0);
+        active_.assign(chunks, 0);
+        work_.reserve(chunks);
+        primed_ = false;
+    }
+
+    double inputs[kInputs] = {input, control_pattern};
+    std::copy(pass_aux, pass_aux + 10, inputs + 2);
+    const bool full = !primed_ || inputsMoved(inputs);
+    if (full) {
+        std::copy(inputs, inputs + kInputs, ref_inputs_);
+        primed_ = true;
+    }
+
+    // Mark, and put skipped chunks back to the outputs a full sweep would give
+    pool.parallelFor(chunks, 0, [&](size_t begin, size_t end, unsigned) {
+        for (size_t c = begin; c < end; c++) {
+            active_[c] = full || chunkActive(bank, c);
+            if (active_[c]) continue;
+            for (size_t i = c * 8; i < c * 8 + 8; i++) {
+                bank.current_output[i] = rest_output_[i];
+                bank.previous_input[i] = input;
+            }
+        }
+    });
+    work_.clear();
+    for (size_t c = 0; c < chunks; c++) {
+        if (active_[c]) work_.push_back(static_cast<uint32_t>(c));
+    }
+
+    pool.parallelFor(work_.size(), 0, [&](size_t begin, size_t end, unsigned) {
+        for (size_t k = begin; k < end; k++) {
+            const size_t first = static_cast<size_t>(work_[k]) * 8;
+            double before[8];
+            std::copy(bank.integrator_state + first, bank.integrator_state + first + 8, before);
+            chunk_sum_[work_[k]] = kernels.wave_f64(bank, first, first + 8, input, control_pattern, control_wave,
+                                                    pass_aux, passes);
+            double moved = 0.0;
+            for (size_t j = 0; j < 8; j++) {
+                const size_t i = first + j;
+                moved = std::max({moved, std::fabs(bank.integrator_state[i] - before[j]),
+                                  std::fabs(bank.current_output[i] - rest_output_[i])});
+                ref_integrator_[i] = bank.integrator_state[i];
+                ref_feedback_[i] = bank.feedback_gain[i];
+                rest_output_[i] = bank.current_output[i];
+            }
+            settled_[work_[k]] = moved <= tolerance_;
+        }
+    });
+
+    const double total = pool.parallelSum(chunks, 0, [&](size_t begin, size_t end) {
+        double partial = 0.0;
+        for (size_t c = begin; c < end; c++) partial += chunk_sum_[c];
+        return partial;
+    });
+
+    last_active_nodes_ = work_.size() * 8;
+    if (!work_.empty() && work_.back() + 1 == chunks) last_active_nodes_ -= bank.capacity() - bank.size();
+    stats_.sweeps++;
+    stats_.full_sweeps += full;
+    stats_.chunks_processed += work_.size();
+    stats_.chunks_skipped += chunks - work_.size();
+    stats_.last_active_fraction =
+        bank.size() > 0 ? static_cast<double>(last_active_nodes_) / static_cast<double>(bank.size()) : 1.0;
+    return total;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "node_bank.h"
+#include "node_kernels.h"
+#include "worker_pool.h"
+
+// Counters of an ActiveSet since it was enabled or its stats were reset
+struct ActiveSetStats {
+    uint64_t sweeps = 0;
+    uint64_t full_sweeps = 0;        // Sweeps that ran every chunk (first, or inputs moved)
+    uint64_t chunks_processed = 0;   // 8-node chunks run through the wave kernel
+    uint64_t chunks_skipped = 0;
+    double last_active_fraction = 1.0;  // Nodes processed in the last sweep / all nodes
+};
+
+// Active-set scheduling of the wave sweep.
+//
+// Nodes are tracked in the 8-node chunks the lane kernels work on. A chunk
+// whose integrators and outputs moved by at most the tolerance in its last
+// processed sweep is settled: while the sweep inputs (input, control pattern
+// and the ten pass aux values) stay within the tolerance of those of the
+// last full sweep, a settled chunk is skipped. Its outputs are restored to
+// their values after its last processed sweep and its share of the sweep sum
+// is reused, so coupling or noise written over them between sweeps does not
+// accumulate. A chunk wakes up when the inputs move beyond the tolerance
+// (which runs every chunk), or when its integrator or feedback columns were
+// written from outside (state loads, resets, setFeedback). Writes to the
+// other parameter columns are not tracked; call reset() after them.
+//
+// Each sweep marks the chunks in parallel, compacts the active ones into a
+// work list, and splits only that list across the pool, so skipped chunks
+// cost no worker time. With a tolerance of 0 only exact fixed points are
+// skipped.
+class ActiveSet {
+public:
+    void setTolerance(double tolerance);
+    double tolerance() const { return tolerance_; }
+
+    // Forgets the tracked state; the next sweep runs every chunk
+    void reset();
+    // Frees the tracking columns (when active-set mode is switched off)
+    void release();
+
+    // One wave sweep of passes node steps (NodeKernels::wave_f64 semantics)
+    // over the active chunks; returns the sum of outputs of all real nodes
+    double waveSweep(WorkerPool& pool, const NodeKernels& kernels, NodeBank& bank, double input,
+                     double control_pattern, const double* control_wave, const double* pass_aux,
+                     int passes = kWavePasses);
+
+    // Real nodes processed by the last sweep
+    size_t lastActiveNodes() const { return last_active_nodes_; }
+    const ActiveSetStats& stats() const { return stats_; }
+    void resetStats() { stats_ = ActiveSetStats(); }
+
+private:
+    static constexpr size_t kInputs = 12;  // input, control pattern, 10 pass aux
+
+    bool inputsMoved(const double* inputs) const;
+    bool chunkActive(const NodeBank& bank, size_t chunk) const;
+
+    double tolerance_ = 1e-6;
+    bool primed_ = false;
+    double ref_inputs_[kInputs] = {};
+    // Per slot, as left by the chunk's last processed sweep
+    std::vector<double> ref_integrator_;
+    std::vector<double> ref_feedback_;
+    std::vector<double> rest_output_;
+    // Per chunk
+    std::vector<double> chunk_sum_;
+    std::vector<uint8_t> settled_;
+    std::vector<uint8_t> active_;
+    std::vector<uint32_t> work_;
+    size_t last_active_nodes_ = 0;
+    ActiveSetStats stats_;
+};
@@ -1,29 +1,119 @@
 #pragma once
 
+#include <atomic>
 #include <vector>
 #include <cstdint>
 #include <cmath>
-#include <omp.h> // Include OpenMP for parallel processing
+#include <memory>
+#include <mutex>
+#include <string>
+#include "active_set.h"
+#include "block_stats.h"
+#include "compact_node_bank.h"
+#include "deadline_watchdog.h"
+#include "multirate_groups.h"
+#include "gpu_node_bank.h"
+#include "engine_arena.h"
+#include "engine_benchmark.h"
+#include "fft_plan_cache.h"
+#include "filter_bank.h"
+#include "grid_coupling.h"
+#include "harmonic_bank.h"
+#include "kernel_work.h"
+#include "latency_histogram.h"
+#include "mission_checkpoint.h"
+#include "node_bank.h"
+#include "node_equation.h"
+#include "node_kernels.h"
+#include "node_recorder.h"
+#include "output_publisher.h"
+#include "shared_state.h"
+#include "sparse_coupling.h"
+#include "state_snapshot.h"
+#include "worker_pool.h"
 
 // Forward declaration for CPU feature detection
 namespace CPUFeatures {
+    bool hasSSE42();
     bool hasAVX2();
     bool hasFMA();
+    bool hasAVX512F();
+    bool hasF16C();
+    bool hasNEON();
+    // OS saves the YMM (AVX) / ZMM (AVX-512) register state on context switch
+    bool osSupportsAVX();
+    bool osSupportsAVX512();
     void printCapabilities();
     bool checkCPUID(int function, int subfunction, int reg, int bit);
 }
 
+// Profiling build level: 0 compiles every timer out, 1 keeps them and lets the
+// runtime ProfilingMode choose between off, sampled and full timing.
+#ifndef DASE_PROFILING
+#define DASE_PROFILING 1
+#endif
+
+// Runtime instrumentation level for the engine's scope timers
+enum class ProfilingMode {
+    Off = 0,      // Timers are skipped (one relaxed load and branch per scope)
+    Sampled = 1,  // Time 1 in N outermost scopes with TSC reads, scale by N
+    Full = 2      // Time every outermost scope with TSC reads
+};
+
+// Call sites with a per-call latency histogram (see getLatencyHistogram)
+enum class LatencyProbe {
+    EngineBlock = 0,  // Engine processBlock, double and float engines
+    WaveSweep = 1,    // One processSignalWave sweep of all nodes
+    NodeBlock = 2,    // AnalogUniversalNodeAVX2::processBlock
+    ProbeCount
+};
+
+// Work and achieved throughput of one kernel, for roofline analysis (see
+// kernel_work.h for the cost model). time_ns is the wall time of the
+// kernel's calls on the threads that issued them, so the rates of a
+// parallel sweep cover all of its workers and compare with whole-machine
+// peaks. Time is scaled like total_execution_time_ns in sampled mode.
+struct KernelMetrics {
+    WorkKernel kernel = WorkKernel::NodeStep;
+    uint64_t calls = 0;
+    uint64_t flops = 0;
+    uint64_t bytes = 0;
+    uint64_t time_ns = 0;
+    double gflops = 0.0;                 // flops per ns
+    double gbytes_per_second = 0.0;      // bytes per ns
+    double arithmetic_intensity = 0.0;   // flops per byte
+};
+
 // Lightweight metrics system
+// Snapshot of the engine counters. Counters are accumulated per thread inside
+// the engine and merged into this struct by getMetrics().
 struct EngineMetrics {
-    uint64_t total_execution_time_ns;
-    uint64_t avx2_operation_time_ns;
-    uint64_t total_operations;
-    uint64_t avx2_operations;
-    uint64_t node_processes;
-    uint64_t harmonic_generations;
-    double current_ns_per_op;
-    double current_ops_per_second;
-    double speedup_factor;
+    uint64_t total_execution_time_ns = 0;
+    uint64_t avx2_operation_time_ns = 0;
+    uint64_t total_operations = 0;
+    uint64_t avx2_operations = 0;
+    uint64_t node_processes = 0;
+    uint64_t harmonic_generations = 0;
+    double current_ns_per_op = 0.0;
+    double current_ops_per_second = 0.0;
+    double speedup_factor = 0.0;
+    // Instrumentation cost: scopes that actually read the clock, and the
+    // estimated time those reads added to total_execution_time_ns.
+    uint64_t profiled_scopes = 0;
+    double profiling_overhead_ns = 0.0;
+    // Hardware events of the timed scopes (see setHardwareCounters), scaled
+    // like the time in sampled mode. All zero unless the host grants perf
+    // counters; an event the PMU lacks stays zero on its own.
+    bool hw_counters_available = false;
+    uint64_t hw_cycles = 0;
+    uint64_t hw_instructions = 0;
+    uint64_t hw_l1d_misses = 0;
+    uint64_t hw_llc_misses = 0;
+    uint64_t hw_branch_misses = 0;
+    double instructions_per_cycle = 0.0;
+    // One entry per WorkKernel, in enum order. Only counted while the
+    // engine is built with DASE_PROFILING.
+    std::vector<KernelMetrics> kernels;
     const double target_ns_per_op = 8000.0;
 
     void reset();
@@ -31,20 +121,60 @@ struct EngineMetrics {
     void print_metrics();
 };
 
+// Scalar fields of EngineMetrics in a flat block of 8-byte values, for
+// pollers that copy a frame into a preallocated buffer many times a second.
+// Filled straight from the counters: no kernel table, no allocation. Each
+// counter is read atomically; like getMetrics(), the frame is not one
+// consistent cut across threads that are still counting.
+struct EngineMetricsFrame {
+    uint64_t total_execution_time_ns = 0;
+    uint64_t avx2_operation_time_ns = 0;
+    uint64_t total_operations = 0;
+    uint64_t avx2_operations = 0;
+    uint64_t node_processes = 0;
+    uint64_t harmonic_generations = 0;
+    uint64_t profiled_scopes = 0;
+    uint64_t hw_counters_available = 0;  // 0 or 1
+    uint64_t hw_cycles = 0;
+    uint64_t hw_instructions = 0;
+    uint64_t hw_l1d_misses = 0;
+    uint64_t hw_llc_misses = 0;
+    uint64_t hw_branch_misses = 0;
+    double current_ns_per_op = 0.0;
+    double current_ops_per_second = 0.0;
+    double speedup_factor = 0.0;
+    double profiling_overhead_ns = 0.0;
+    double instructions_per_cycle = 0.0;
+};
+
 // Generic clamp function
-inline double clamp_custom(double value, double min, double max) {
+template <typename T>
+inline T clamp_custom(T value, T min, T max) {
     return (value > max) ? max : (value < min) ? min : value;
 }
 
 // AnalogUniversalNodeAVX2 Definition
+//
+// A node is a thin view onto one slot of a NodeBank. A default-constructed node
+// owns a private single-node bank; nodes obtained from the engine alias the
+// engine's columns, so processing through the view updates engine state.
 class AnalogUniversalNodeAVX2 {
 public:
-    AnalogUniversalNodeAVX2() : integrator_state(0.0), feedback_gain(0.0), current_output(0.0), previous_input(0.0), operation_count(0) {}
+    AnalogUniversalNodeAVX2();
+    AnalogUniversalNodeAVX2(NodeBank* bank, size_t index);
+    AnalogUniversalNodeAVX2(const AnalogUniversalNodeAVX2& other);
+    AnalogUniversalNodeAVX2& operator=(const AnalogUniversalNodeAVX2& other);
+    AnalogUniversalNodeAVX2(AnalogUniversalNodeAVX2&&) noexcept = default;
+    AnalogUniversalNodeAVX2& operator=(AnalogUniversalNodeAVX2&&) noexcept = default;
 
     // Main processing function - now acts as a pipeline
     double processSignalAVX2(double input_signal, double control_signal, double aux_signal);
     double processSignal(double input_signal, double control_signal, double aux_signal);
 
+    // Processes n samples in one call with the integrator held in registers.
+    // aux may be null (treated as 0).
+    void processBlock(const float* in, const float* control, const float* aux, float* out, size_t n);
+
     // Getters and setters
     void setFeedback(double feedback_coefficient);
     double getOutput() const;
@@ -56,42 +186,772 @@ public:
     double integrate(double input_signal, double time_constant);
     double applyFeedback(double input_signal, double feedback_gain);
     
-    // Public member variables for cellular grid placement
-    int16_t x, y, z;
-    uint16_t node_id;
+    // Cellular grid placement (stored in the bank's coordinate columns)
+    int16_t getX() const { return bank_->coordX(index_); }
+    int16_t getY() const { return bank_->coordY(index_); }
+    int16_t getZ() const { return bank_->coordZ(index_); }
+    uint16_t getNodeId() const { return bank_->nodeId(index_); }
+    void setX(int16_t value) { bank_->materializeCold(); bank_->x[index_] = value; }
+    void setY(int16_t value) { bank_->materializeCold(); bank_->y[index_] = value; }
+    void setZ(int16_t value) { bank_->materializeCold(); bank_->z[index_] = value; }
+    void setNodeId(uint16_t value) { bank_->materializeCold(); bank_->node_id[index_] = value; }
+
+    size_t getIndex() const { return index_; }
+    bool isView() const { return owned_ == nullptr; }
 
 private:
-    // Internal state variables
-    double integrator_state;
-    double feedback_gain;
-    double current_output;
-    double previous_input;
-    uint64_t operation_count;
+    std::unique_ptr<NodeBank> owned_;
+    NodeBank* bank_;
+    size_t index_;
+};
+
+// Node kernel used by the engine sweeps
+enum class NodeKernelMode {
+    Scalar = 0,       // One node per call, SIMD only inside the spectral stage
+    LaneParallel = 1  // Eight nodes per call, one node per SIMD lane
+};
+
+// How runMission advances the nodes through its steps
+enum class MissionSchedule {
+    PerStep = 0,  // One parallel sweep per step
+    Fused = 1     // Precomputed input schedule, each worker runs its node
+                  // range through a whole tile of steps per sweep
 };
 
+// Chromatic field block of processChromaticBlock (the block step of the
+// server's ChromaticFieldProcessor)
+struct ChromaticBlockConfig {
+    size_t num_channels = 8;
+    size_t node_stride = 8;        // Channel c runs through node c * node_stride
+    double sample_rate = 48000.0;
+    double phi_phase = 0.0;        // Phase of the Φ envelope, radians
+    double phi_depth = 0.5;        // Envelope depth and control wave amplitude
+    // Per-sample phase and depth of the block (n values each) in place of
+    // the two above, e.g. ParameterAutomation's curves; null for constants
+    const float* phi_phase_curve = nullptr;
+    const float* phi_depth_curve = nullptr;
+};
+
+class FlightRecorder;
+class ParameterAutomation;
+
 // AnalogCellularEngineAVX2 Definition
 class AnalogCellularEngineAVX2 {
 public:
     AnalogCellularEngineAVX2(size_t num_nodes);
     double processSignalWaveAVX2(double input_signal, double control_pattern);
+    // count wave sweeps in a row: results[k] is what processSignalWaveAVX2
+    // returns for input_signals[k] and control_patterns[k] after the waves
+    // before it. Unless something runs between waves (coupling, noise, the
+    // active set, a recording) or the Cuda backend is selected, the nodes go
+    // in tiles of getWaveTileNodes() that each run through every wave while
+    // the worker prefetches its next tile, so a bank larger than the caches
+    // streams from memory once per call instead of once per wave. Results
+    // are bit-identical to the one-wave-at-a-time loop.
+    void processSignalWaves(const double* input_signals, const double* control_patterns, size_t count,
+                            double* results);
     double performSignalSweepAVX2(double frequency);
+    // performSignalSweepAVX2 of each of count frequencies, every one from
+    // the engine's current state: results[f] is what the single sweep would
+    // return if it ran now, and the engine is left as it was (nothing is
+    // recorded). Node tiles and frequencies run in parallel in one call
+    // instead of five fork/joins per frequency; with coupling, noise, the
+    // active set or the Scalar kernel mode the frequencies run one at a
+    // time with the state put back in between.
+    void performSignalSweepBatch(const double* frequencies, size_t count, double* results);
+    // Nodes per processSignalWaves tile, rounded down to whole wave-sum
+    // blocks of 16 nodes. 0 (the default) sizes tiles to half the L2 cache
+    // the engine was built on, or 256 KB when the cache size is unknown.
+    void setWaveTileNodes(size_t nodes);
+    size_t getWaveTileNodes() const { return wave_tile_nodes_; }
+    // Console reports of a default SignalSweep runBenchmark()
     void runBuiltinBenchmark(int iterations);
     void runMassiveBenchmark(int iterations);
-    void runMission(uint64_t num_steps);
+    // Times config.iterations iterations of the workload after config.warmup
+    // untimed ones and returns the latency distribution. Engine metrics are
+    // reset after the warmup, so getMetrics() afterwards covers the timed
+    // iterations. Node count, thread and SIMD overrides apply to this run
+    // only. Throws std::invalid_argument for a config with no iterations or
+    // an empty block.
+    BenchmarkResult runBenchmark(const BenchmarkConfig& config);
+    // Steps first_step .. first_step + num_steps - 1 of the mission; a
+    // mission resumed from a checkpoint passes getMissionResumeStep()
+    void runMission(uint64_t num_steps, uint64_t first_step = 0);
     // New: The drag race benchmark function
     double runDragRaceBenchmark(int num_runs);
+    // Drag race at 1, 2, 4, ... threads on pools placed per config.placement,
+    // with speedup and parallel efficiency against one thread. The engine's
+    // own pool is back in place afterwards. Throws std::invalid_argument for
+    // a config with no runs or iterations.
+    std::vector<ScalingPoint> runDragRaceScaling(const ScalingConfig& config);
+    // Wave sweeps on scratch engines (or node objects) of growing size, on
+    // this engine's pool and SIMD level; prints a table and returns the
+    // per-point timing, footprint and the cache cliffs found. Throws
+    // std::invalid_argument for an empty node range or no iterations.
+    NodeScalingResult runNodeScaling(const NodeScalingConfig& config);
+    // Compact node storage against the float engine on this engine's pool
+    // and SIMD level; prints a table and returns one result per format.
+    // Throws std::invalid_argument for no nodes, blocks or block size.
+    std::vector<CompactDriftResult> runCompactDrift(const CompactDriftConfig& config);
+    // Each of config.levels against Full on scratch engines sharing this
+    // engine's pool, SIMD level, pipeline and harmonic count; prints a table
+    // and returns the error and time of each level. Throws
+    // std::invalid_argument for no nodes, no waves and blocks, or no block size.
+    std::vector<QualityLevelResult> runQualitySweep(const QualitySweepConfig& config);
     void processBlockFrequencyDomain(std::vector<double>& signal_block);
+    // Same filter, in place, on channels blocks of n samples stored back to
+    // back (a C-order [channels x n] array); the channels share one plan
+    void processBlockFrequencyDomain(double* blocks, size_t n, size_t channels = 1);
+    void processBlockFrequencyDomain(float* blocks, size_t n, size_t channels = 1);
+    // Spectral filter of rows signals of n samples, [rows x n] in `in`, into
+    // the same layout in out (which may be in). Row r's half spectrum (n / 2
+    // + 1 bins) is weighted by masks + r * mask_stride (stride 0 shares one
+    // mask; null masks give processBlockFrequencyDomain's filter) and the
+    // inverse is scaled by 1 / n. Rows go through batched plans a few at a
+    // time, the batches spread over the worker pool.
+    void processBlockFrequencyDomainBatch(const float* in, float* out, size_t rows, size_t n,
+                                          const float* masks = nullptr, size_t mask_stride = 0);
+
+    // FFT planning for processBlockFrequencyDomain. Plans are cached per block
+    // size; Measure pays a one-off planning cost per size unless wisdom with
+    // matching plans was loaded first. Wisdom I/O returns false on failure.
+    void setFFTPlanRigor(FFTPlanRigor rigor);
+    FFTPlanRigor getFFTPlanRigor() const;
+    // Transform library for the frequency-domain paths, defaultFFTBackend()
+    // unless set; switching replans cached sizes on next use. Throws
+    // std::invalid_argument for a backend this build lacks.
+    void setFFTBackend(FFTBackend backend);
+    FFTBackend getFFTBackend() const;
+    // Blocks of at least setFFTThreadThreshold() samples are transformed on
+    // several threads, by default (0) as many as the worker pool has;
+    // smaller blocks stay on the calling thread, where waking threads would
+    // cost more than the transform. Needs the MKL backend or FFTW in a
+    // DASE_WITH_FFTW_THREADS build, otherwise every transform is
+    // single-threaded.
+    void setFFTThreads(unsigned threads);
+    unsigned getFFTThreads() const;
+    void setFFTThreadThreshold(size_t samples);
+    size_t getFFTThreadThreshold() const;
+    bool loadFFTWisdom(const std::string& path);
+    bool saveFFTWisdom(const std::string& path) const;
+
+    // Advances every node through n samples of shared in/control/aux streams
+    // (control may be null for 1.0, aux null for 0.0). When out is non-null it
+    // receives node-major [num_nodes x n] outputs.
+    void processBlock(const float* in, const float* control, const float* aux, float* out, size_t n);
+
+    // Statistics of every output of a block (off by default): mean,
+    // variance, RMS and peak over all nodes and samples, and with
+    // histogram_bins > 0 counts over [histogram_low, histogram_high).
+    // processBlock accumulates them inside the node kernels, so they come
+    // without out; with node groups only the full-rate nodes are counted,
+    // and a block on the Cuda backend leaves them empty. processChromaticBlock
+    // counts its active channels' outputs and adds per-channel mean, RMS and
+    // peak. Throws std::invalid_argument for bins over an empty range.
+    void setBlockStats(bool enabled, size_t histogram_bins = 0, double histogram_low = -1.0,
+                       double histogram_high = 1.0) {
+        block_stats_.configure(enabled, histogram_bins, histogram_low, histogram_high);
+    }
+    bool getBlockStatsEnabled() const { return block_stats_.enabled(); }
+    // Of the last block, until the next one starts
+    const BlockStats& getBlockStats() const { return block_stats_.stats(); }
+
+    // Publication of every processBlock and processChromaticBlock for
+    // readers at frame rate (off by default; see OutputPublisher): the
+    // block's outputs and every node's output after it go to a lock-free
+    // triple buffer, sized here for blocks of up to max_rows (0: the current
+    // node count) by max_samples. processBlock without out writes straight
+    // into it; otherwise the outputs are copied once. Larger blocks go
+    // unpublished and are counted as skipped, so max_rows at the chromatic
+    // channel count publishes only chromatic blocks. Replaces any earlier
+    // publisher, which must not be in use, and must not overlap a block.
+    void setOutputPublishing(bool enabled, size_t max_samples = 512, size_t max_rows = 0);
+    bool getOutputPublishing() const { return publisher_ != nullptr; }
+    // Reader side of the publication, null while it is off
+    OutputPublisher* outputPublisher() const { return publisher_.get(); }
+
+    // Multirate node groups for processBlock (none by default; see
+    // MultirateGroups): a group's nodes step on every rate_divisor-th sample
+    // and out receives their interpolated outputs. Throws
+    // std::invalid_argument for groups MultirateGroups rejects.
+    void setNodeGroups(const std::vector<NodeGroup>& groups) { multirate_.setGroups(groups, bank.size()); }
+    void clearNodeGroups() { multirate_.clear(); }
+    std::vector<NodeGroup> getNodeGroups() const { return multirate_.groups(); }
+    // Node steps of a block relative to running every node at full rate
+    double getBlockWorkFraction() const { return multirate_.workFraction(bank.size()); }
+
+    // Chromatic field block of n samples. Channel c feeds node c * node_stride
+    // the input times the Φ envelope 1 + depth * sin(2π t sample_rate / Φ +
+    // phase), rotated by floor(c n / Φ) samples, under the control wave
+    // depth * cos(2π k / (Φ n)), with no aux stream. The channels run side by
+    // side, one per vector lane. out receives channel-major
+    // [num_channels x n] outputs; channels past the last node get zeros.
+    // Throws std::invalid_argument for no channels or a zero stride.
+    void processChromaticBlock(const float* in, size_t n, const ChromaticBlockConfig& config, float* out);
+    // Same block under automation: renders its next n samples (at most
+    // maxBlock()), applies the feedback changes due in them to the nodes
+    // (out of range nodes are skipped) and runs on the Φ curves
+    void processChromaticBlock(const float* in, size_t n, const ChromaticBlockConfig& config,
+                               ParameterAutomation& automation, float* out);
+    // Flight recording of the chromatic blocks (see FlightRecorder): every
+    // processChromaticBlock appends a Block event of source "dase" with its
+    // automation, parameters and chromatic stage times, the budget n /
+    // sample_rate and the automation's pending events as queue depth, plus a
+    // Parameter event per feedback change, Φ retarget and block of a running
+    // parameter switch. null stops recording. The recorder must outlive the
+    // engine or the next call, which must not overlap a block.
+    void setFlightRecorder(FlightRecorder* recorder);
+    FlightRecorder* flightRecorder() const { return flight_recorder_; }
     
+    // Filter nodes: a bank of count nodes beside the integrator nodes, each
+    // a cascade of `sections` biquads with its own coefficients and state
+    // (see FilterNodeBank). They pass their input through until given
+    // coefficients. Replaces any previous filter nodes; 0 removes them.
+    void configureFilterNodes(size_t count, size_t sections = 1) { filters_.resize(count, sections); }
+    FilterNodeBank& filterBank() { return filters_; }
+    const FilterNodeBank& filterBank() const { return filters_; }
+    // n samples through every filter node, on the worker pool. With
+    // in_stride 0 each node filters in[0, n); otherwise node i filters
+    // in + i * in_stride. out receives node-major [filter nodes x n] outputs.
+    void processFilterBlock(const float* in, size_t in_stride, float* out, size_t n);
+
     // Metrics
     EngineMetrics getMetrics() const;
+    // The scalar metrics into a caller-owned frame, without building the
+    // EngineMetrics kernel table
+    void getMetricsFrame(EngineMetricsFrame& frame) const;
     void printLiveMetrics();
     void resetMetrics();
 
+    // Profiling level (Full by default). sample_interval is the N of the
+    // sampled mode and is ignored otherwise. Has no effect when the engine is
+    // built with DASE_PROFILING=0.
+    void setProfilingMode(ProfilingMode mode, uint32_t sample_interval = 64);
+    ProfilingMode getProfilingMode() const;
+    uint32_t getProfilingSampleInterval() const;
+
+    // Hardware counters (cycles, instructions, L1D and LLC misses, branch
+    // misses) read around every timed scope; off by default, shared by all
+    // engines, and only counted while profiling is not Off. Each read is a
+    // system call, so prefer Sampled mode on hot paths. Enabling returns
+    // false and changes nothing where the counters are unavailable (not
+    // Linux, no PMU, perf_event_paranoid above 2).
+    bool setHardwareCounters(bool enabled);
+    bool getHardwareCounters() const;
+    static bool hardwareCountersAvailable();
+
+    // Latency distribution of every call at a probe while profiling is not
+    // Off (sampled mode still records every call, the tail being the point).
+    // Histograms are shared by all engines and are not cleared by
+    // resetMetrics(); resetLatencyHistograms() may run while other threads
+    // keep processing.
+    LatencySnapshot getLatencyHistogram(LatencyProbe probe) const;
+    void resetLatencyHistograms();
+
+    // Deadline watchdog of the block entry points (see DeadlineWatchdog),
+    // on by default and per engine, unlike the histograms. processBlock and
+    // processFilterBlock are budgeted at the watchdog's sample rate,
+    // processChromaticBlock at its config's. Configure it while no block
+    // runs; health() and reset() are safe at any time.
+    DeadlineWatchdog& deadlineWatchdog() { return deadline_watchdog_; }
+    const DeadlineWatchdog& deadlineWatchdog() const { return deadline_watchdog_; }
+
     // Helper functions
+    // One N(0, noise_level^2) sample from a reserved noise stream; safe to
+    // call from any thread.
     double generateNoiseSignal();
+    // Coupling input of one node: the weighted sum over its row of the
+    // coupling matrix when one is loaded, otherwise 0.1 x each 1-D neighbour.
     double calculateInterNodeCoupling(size_t node_index);
+
+    // 3-D grid the node x/y/z coordinates describe (10 x 10 x N/100 by
+    // default). Reassigns the coordinates; nz = 0 sizes the grid to the node
+    // count. With GridOrder::Morton the nodes fill the grid along the
+    // Z-order curve (see GridIndex), so grid coupling and spatial queries
+    // stay within nearby cache lines on large cubes; the coordinates are
+    // then stored. Throws std::invalid_argument if the grid cannot hold
+    // every node, or as GridIndex::build.
+    void setGridShape(size_t nx, size_t ny, size_t nz = 0, GridOrder order = GridOrder::Linear);
+    GridShape getGridShape() const { return grid_shape_; }
+    // Node at a cell and cell of a node on the current grid
+    const GridIndex& getGridIndex() const { return grid_index_; }
+
+    // Coupling step run after every wave sweep and mission step (off by
+    // default). strength in [0, 1] is how far each node moves toward the mean
+    // of its grid neighbours per step.
+    void setGridCoupling(GridStencil stencil, double strength);
+    GridStencil getGridStencil() const { return grid_stencil_; }
+    double getGridCouplingStrength() const { return grid_strength_; }
+    // Runs one coupling step now with the configured stencil and strength
+    void applyGridCoupling();
+
+    // Arbitrary coupling graph in CSR form (see SparseCoupling), one row per
+    // node. Once loaded, every wave sweep and mission step is followed by
+    // out += A * out, after the grid step. Throws std::invalid_argument if the
+    // matrix is malformed or its row count differs from the node count.
+    void setCouplingMatrix(std::vector<uint64_t> row_ptr, std::vector<uint32_t> col_index,
+                           std::vector<double> weights);
+    void clearCouplingMatrix() { sparse_coupling_.clear(); }
+    size_t getCouplingEdgeCount() const { return sparse_coupling_.edges(); }
+    bool hasCouplingMatrix() const { return !sparse_coupling_.empty(); }
+    // Runs one sparse coupling step now
+    void applySparseCoupling();
+
+    // Counter-based Gaussian noise (NodeKernels::gaussian_noise). With
+    // injection enabled, every wave sweep and mission step ends by adding
+    // noise_level * N(0, 1) to each node output, the sample of node i at
+    // injection step t being sample i of stream t, so runs are reproducible
+    // for any worker count. Setting the seed restarts at step 0.
+    void setNoiseSeed(uint64_t seed);
+    uint64_t getNoiseSeed() const { return noise_seed_; }
+    void setNoiseInjection(bool enabled) { noise_injection_ = enabled; }
+    bool getNoiseInjection() const { return noise_injection_; }
+    uint64_t getNoiseStep() const { return noise_step_; }
+    // n samples of stream from sample first on, scaled by noise_level
+    void fillNoise(uint64_t stream, uint64_t first, float* out, size_t n) const;
+    // Runs one noise injection step now
+    void injectNoise();
+
+    // Node state snapshots (see state_snapshot.h): the bank columns plus the
+    // grid shape and noise position, so a replica or a resumed mission
+    // continues exactly where the saved engine stopped. The snapshot must
+    // hold getNodeCount() nodes. Map runs on a copy-on-write mapping of the
+    // file, so loading costs no copy and pages fault in when first swept.
+    // Both throw std::runtime_error on failure.
+    void saveState(const std::string& path) const;
+    void loadState(const std::string& path, SnapshotLoad mode = SnapshotLoad::Map);
+    // Mission step the last loaded snapshot was checkpointed at (0 for one
+    // written by saveState, or before any load)
+    uint64_t getMissionResumeStep() const { return resume_step_; }
+
+    // Asynchronous checkpoints of runMission (see MissionCheckpointer):
+    // every config.interval_steps steps the mission copies the node state
+    // aside at a step boundary (the fused schedule's boundaries are the
+    // ends of its 1024-step tiles) and an I/O thread writes it to
+    // config.path while the mission goes on. On the Cuda backend a checkpoint also
+    // brings the state back from the device. Throws as
+    // MissionCheckpointer::configure.
+    void setCheckpointing(const CheckpointConfig& config) { checkpointer_.configure(config); }
+    CheckpointConfig getCheckpointing() const { return checkpointer_.config(); }
+    CheckpointStats getCheckpointStats() const { return checkpointer_.stats(); }
+    // Waits until the newest checkpoint is on disk
+    void flushCheckpoints() { checkpointer_.flush(); }
+
+    // Columnar recording of node outputs (see NodeRecorder): the outputs of
+    // config.nodes after every wave sweep and mission step, and at every
+    // sample of processBlock, go to a file written in the background. While
+    // recording, missions run step by step rather than fused and the Cuda
+    // backend stands aside, since every step's outputs must reach the host.
+    // startRecording closes any recording in progress first; both throw as
+    // NodeRecorder, stopRecording with the first write error.
+    void startRecording(const RecorderConfig& config);
+    void stopRecording();
+    bool isRecording() const { return recorder_ != nullptr; }
+    // Counters of the recording in progress, or of the last one stopped
+    RecorderStats getRecorderStats() const { return recorder_ ? recorder_->stats() : recorder_stats_; }
+    // True while the node columns live in a file mapping
+    bool isStateMapped() const {
+        return bank.size() > 0 && !bank.ownsStorage() && !shared_state_ && !(arena_ && arena_->contains(bank.storage()));
+    }
+
+    // Node columns in a named shared-memory segment (see shared_state.h) that
+    // other processes open with SharedStateReader. The current state is
+    // copied in and the engine then runs on the segment directly. Wave
+    // sweeps, mission steps, blocks, coupling and noise steps and loadState
+    // each publish as one seqlock write; benchmarks and writes through node
+    // views or state columns do not. unshareState copies the state back into
+    // private columns and removes the segment. shareState throws
+    // std::runtime_error if the segment cannot be created.
+    void shareState(const std::string& name);
+    void unshareState();
+    bool isStateShared() const { return shared_state_ != nullptr; }
+    std::string getSharedStateName() const { return shared_state_ ? shared_state_->name() : std::string(); }
+    uint64_t getSharedStateSequence() const { return shared_state_ ? shared_state_->sequence() : 0; }
+
+    // Moves the node columns, the block scratch, the FFT buffers of
+    // config.fft_size and an optional output block into one EngineArena
+    // sized for them up front, so steady-state blocks up to max_block
+    // samples allocate nothing and, with huge_pages, run on 2 MB pages.
+    // Replaces any earlier arena. Larger blocks still work and grow heap
+    // scratch (see ArenaStats::scratch_spills). Throws std::runtime_error
+    // while the state is shared, and std::bad_alloc when the region cannot
+    // be reserved.
+    void reserveArena(const EngineArenaConfig& config);
+    // Copies the node columns back into private storage and frees the arena
+    void releaseArena();
+    ArenaStats getArenaStats() const;
+    // Bytes the engine holds for its nodes and blocks: the node bank, the
+    // filter nodes, block scratch on the heap and a reserved arena (the
+    // bank counted once when it lives there)
+    size_t getMemoryBytes() const;
+    // [num_nodes x max_block] floats for processBlock's out, or nullptr
+    // without an arena output block
+    float* getArenaOutput() { return arena_output_; }
+    size_t getArenaMaxBlock() const { return arena_max_block_; }
+
+    // Node access
+    size_t getNodeCount() const { return bank.size(); }
+    AnalogUniversalNodeAVX2 node(size_t index);
+
+    // Worker pool used by every parallel sweep. Reconfiguring joins the
+    // current workers (unless another engine still shares them) and starts a
+    // new private pool; do not call it during a sweep.
+    void configureWorkers(const WorkerPoolConfig& config);
+    unsigned getWorkerCount() const;
+    const WorkerPoolConfig& getWorkerConfig() const;
+    // Pool jobs (and serial chromatic blocks) that underflowed into the
+    // subnormal range; flushed to zero unless flush_denormals is off
+    uint64_t getDenormalJobs() const { return pool_->denormalJobs(); }
+    // Scheduling each background worker got (WorkerPoolConfig::realtime)
+    std::vector<WorkerThreadStatus> getWorkerThreadStatus() const { return pool_->threadStatus(); }
+    // Runs the sweeps on a pool owned elsewhere, e.g. by an EngineGroup.
+    // Sweeps issued from a task of that pool run inline on the worker.
+    void shareWorkerPool(std::shared_ptr<WorkerPool> pool);
+    const std::shared_ptr<WorkerPool>& getWorkerPool() const { return pool_; }
+
+    // Kernel selection (LaneParallel by default)
+    void setKernelMode(NodeKernelMode mode);
+    NodeKernelMode getKernelMode() const;
+
+    // Mission scheduling (Fused by default). Both give identical results;
+    // Fused falls back to one sweep per step while coupling or noise
+    // injection has to run between steps, or in the Scalar kernel mode.
+    void setMissionSchedule(MissionSchedule schedule) { mission_schedule_ = schedule; }
+    MissionSchedule getMissionSchedule() const { return mission_schedule_; }
+
+    // Instruction set of the node kernels. Defaults to defaultSimdLevel();
+    // requests above what the host supports fall back to the best level below.
+    void setSimdLevel(SimdLevel level);
+    SimdLevel getSimdLevel() const { return kernels_->level; }
+    const char* getKernelName() const { return kernels_->name; }
+
+    // Stage sequence of the node kernels (Full by default; see NodePipeline).
+    // Applies to every sweep, mission and block path, Scalar kernel mode
+    // included; the per-node view returned by node() always runs Full.
+    void setNodePipeline(NodePipeline pipeline);
+    NodePipeline getNodePipeline() const { return kernels_->pipeline; }
+
+    // Active-set wave sweeps (off by default; see ActiveSet): in the
+    // LaneParallel kernel mode, processSignalWaveAVX2 skips settled 8-node
+    // chunks while its inputs stay within tolerance of the last full sweep.
+    // Throws std::invalid_argument for a negative or non-finite tolerance.
+    void setActiveSet(bool enabled, double tolerance = 1e-6);
+    bool getActiveSet() const { return active_set_enabled_; }
+    double getActiveSetTolerance() const { return active_set_.tolerance(); }
+    // Nodes processed by the last sweep / all nodes (1 when off)
+    double getActiveFraction() const {
+        return active_set_enabled_ ? active_set_.stats().last_active_fraction : 1.0;
+    }
+    const ActiveSetStats& getActiveSetStats() const { return active_set_.stats(); }
+    void resetActiveSetStats() { active_set_.resetStats(); }
+
+    // Backend of the wave sweeps, mission steps and blocks (Cpu by default;
+    // see GpuNodeBank). With Cuda the node state moves to the device on the
+    // first call it runs and stays there between calls. The engine's own
+    // node, snapshot, coupling and noise methods bring it back first; code
+    // reading or writing bank directly calls syncComputeBackend() before.
+    // Calls the device kernels do not cover (Scalar kernel mode, pipelines
+    // or compute qualities other than Full, active set, node groups, shared
+    // state, coupling or noise passes) run on the CPU.
+    // Selecting Cuda throws std::runtime_error when no device is available.
+    void setComputeBackend(ComputeBackend backend);
+    ComputeBackend getComputeBackend() const { return gpu_bank_ ? ComputeBackend::Cuda : ComputeBackend::Cpu; }
+    static bool computeBackendAvailable(ComputeBackend backend);
+    static std::string computeDeviceName() { return GpuNodeBank::deviceName(); }
+    // Copies device-resident node state back into bank (no-op on Cpu)
+    void syncComputeBackend() const;
+    // Device address of one of bank's columns (e.g. bank.current_output)
+    // while Cuda is selected, null on Cpu, for zero-copy export. The state
+    // moves to the device first and counts as changed there from then on, so
+    // host access downloads it again. The device copy is current only while
+    // calls run on the device, and is freed on switching back to Cpu.
+    double* deviceColumn(const double* column);
+    int getComputeDeviceOrdinal() const { return gpu_bank_ ? gpu_bank_->deviceOrdinal() : -1; }
+
+    // Harmonics added to each wave pass (8 by default, at most 64). Quality
+    // levels below Full run fewer; this is the configured count.
+    void setHarmonicCount(size_t count);
+    size_t getHarmonicCount() const { return harmonic_count_; }
+
+    // Approximate compute (Full by default; see ComputeQuality): wave passes
+    // per sweep, waves per signal sweep frequency, harmonics per pass and
+    // the spectral boost's sine polynomial, on every path; the float and
+    // compact engines stay at Full.
+    void setComputeQuality(ComputeQuality quality);
+    ComputeQuality getComputeQuality() const { return quality_; }
+    ComputeQualityProfile getComputeQualityProfile() const { return computeQualityProfile(quality_); }
+    
+    // User-defined node model (see NodeEquation): processBlock steps every
+    // node through the equations of source instead of the built-in model,
+    // until clearNodeEquation(). Declared states and params start at their
+    // declared values in every node. Node groups and the Cuda backend do
+    // not apply to it, and block statistics stay empty. Throws as
+    // NodeEquation::compile; a failed call leaves the current model.
+    void setNodeEquation(const std::string& source, NodeEquationBackend backend = defaultNodeEquationBackend());
+    void clearNodeEquation();
+    const NodeEquation* getNodeEquation() const { return equation_.get(); }
+    // A declared state or param of the equation over bank.capacity() nodes,
+    // null for other names or without an equation
+    double* nodeEquationColumn(const std::string& name) { return equation_columns_.find(name); }
     
-    std::vector<AnalogUniversalNodeAVX2> nodes;
+    // Held by language bindings around calls they run without their
+    // interpreter lock, so two threads never run one engine at once. The
+    // engine itself does not take it.
+    std::mutex& callMutex() const { return call_mutex_; }
+
+    NodeBank bank;
     double system_frequency;
     double noise_level;
+
+private:
+    mutable std::mutex call_mutex_;
+    NodeKernelMode kernel_mode_ = NodeKernelMode::LaneParallel;
+    MissionSchedule mission_schedule_ = MissionSchedule::Fused;
+    const NodeKernels* kernels_;
+    std::shared_ptr<WorkerPool> pool_;
+    FFTPlanCache fft_cache_;
+    unsigned fft_threads_ = 0;
+    size_t fft_thread_threshold_ = FFTPlanCache::kDefaultThreadedSize;
+    HarmonicOscillatorBank harmonics_;
+    size_t harmonic_count_ = 8;
+    ComputeQuality quality_ = ComputeQuality::Full;
+    GridShape grid_shape_;
+    GridIndex grid_index_;
+    GridStencil grid_stencil_ = GridStencil::None;
+    double grid_strength_ = 0.0;
+    GridCoupling grid_coupling_;
+    SparseCoupling sparse_coupling_;
+    ActiveSet active_set_;
+    bool active_set_enabled_ = false;
+    MultirateGroups multirate_;
+    FilterNodeBank filters_;
+    std::unique_ptr<GpuNodeBank> gpu_bank_;  // Set while the Cuda backend is selected
+    mutable bool device_newer_ = false;      // gpu_bank_ holds state bank lacks
+    mutable bool host_newer_ = false;        // bank may differ from gpu_bank_
+    uint64_t noise_seed_ = 0;
+    uint64_t noise_step_ = 0;
+    bool noise_injection_ = false;
+    std::atomic<uint64_t> noise_draws_{0};  // generateNoiseSignal() samples taken
+    ScratchBuffer<float> noise_scratch_;
+    std::shared_ptr<SharedStateSegment> shared_state_;  // Also owns the bank storage while set
+    MissionCheckpointer checkpointer_;
+    uint64_t resume_step_ = 0;
+    std::unique_ptr<NodeRecorder> recorder_;
+    RecorderStats recorder_stats_;         // Of the last recording stopped
+    std::vector<float> recorder_block_;    // processBlock outputs when the caller passes none
+    std::unique_ptr<OutputPublisher> publisher_;
+    DeadlineWatchdog deadline_watchdog_;
+    std::shared_ptr<const NodeEquation> equation_;
+    NodeEquationColumns equation_columns_;
+    std::vector<double*> equation_pointers_;
+    ScratchBuffer<double> equation_streams_;
+    FlightRecorder* flight_recorder_ = nullptr;
+    uint32_t flight_source_ = 0;
+    uint64_t flight_block_ = 0;         // Chromatic blocks recorded
+    float flight_phi_[2] = {0.0f, 0.0f};  // Φ phase and depth targets last recorded
+
+    // The device bank for a call the Cuda backend covers, with the state
+    // uploaded; otherwise brings the state to the host and returns null
+    GpuNodeBank* deviceBank(bool with_step_passes);
+    // Brings the node state to the host before the engine touches bank
+    void hostState() { if (gpu_bank_) syncComputeBackend(); }
+    // A finished block into the publisher's back slot, unless it was written
+    // there, with the node outputs when the host state is current
+    void publishOutputs(PublishedBlockKind kind, const float* out, size_t rows, size_t n, bool host_nodes);
+
+    // processBlock's node step when an equation is set
+    void runNodeEquation(const float* in, const float* control, const float* aux, float* out, size_t n);
+
+    // Coupling and noise passes that follow every wave sweep and mission step
+    void finishStep();
+    bool hasStepPasses() const;
+    void runMissionFused(uint64_t num_steps, uint64_t first_step);
+    // Snapshot values of the engine besides the bank
+    SnapshotMeta snapshotMeta() const;
+    // Checkpoints the state after mission step step - 1 if one is due
+    void checkpointMission(uint64_t step);
+    // One drag race run on the current pool; returns its wall time in ns
+    double dragRaceRun(int iterations);
+    // processChromaticBlock without the flight recording
+    void runChromaticBlock(const float* in, size_t n, const ChromaticBlockConfig& config, float* out);
+    // Block event of the flight recorder; stage_ticks in readTicks units
+    void recordChromaticBlock(uint64_t start_ns, const uint64_t* stage_ticks, size_t n, double sample_rate,
+                              uint32_t queue_depth);
+
+    // Per-block scratch reused across processBlock calls
+    ScratchBuffer<double> block_amplified_;
+    BlockStatsCollector block_stats_;
+    ScratchBuffer<float> block_blend_;
+    ScratchBuffer<float> block_boost_;
+    ControlWaveTable control_wave_;  // Per-node control modulation of the wave passes
+    // processSignalWaves: tile size, then each wave's pass inputs and
+    // parallelSum block sums
+    size_t wave_tile_nodes_ = 0;
+    std::vector<double> wave_aux_;
+    std::vector<double> wave_sums_;
+    std::vector<double> wave_errors_;
+    // processChromaticBlock scratch: envelope and control wave of the block,
+    // then state, output, feedback and parameters of the channel nodes
+    ScratchBuffer<float> spectral_mask_;  // Default mask of processBlockFrequencyDomainBatch
+    ScratchBuffer<float> chromatic_envelope_;
+    ScratchBuffer<float> chromatic_control_;
+    ScratchBuffer<double> chromatic_lanes_;
+
+    // Set by reserveArena; the bank and FFT cache hold it too while they use it
+    std::shared_ptr<EngineArena> arena_;
+    float* arena_output_ = nullptr;
+    size_t arena_max_block_ = 0;
+};
+
+// AnalogCellularEngineF32 Definition
+//
+// Float32 variant of the cellular engine. The node model is the same, but the
+// bank holds float state, so the lane kernels fit twice as many nodes per
+// vector register, move half the bytes per sweep, and skip the
+// double<->float conversions around the spectral stage. Intended for audio
+// paths where float precision is enough; it offers the processing subset of
+// the double engine. Metrics are shared with the double engine.
+class AnalogCellularEngineF32 {
+public:
+    explicit AnalogCellularEngineF32(size_t num_nodes);
+
+    double processSignalWave(double input_signal, double control_pattern);
+    // Same workload as AnalogCellularEngineAVX2::runMission, without console output
+    void runMission(uint64_t num_steps);
+    // Same contract as AnalogCellularEngineAVX2::processBlock
+    void processBlock(const float* in, const float* control, const float* aux, float* out, size_t n);
+    // Same contract as the AnalogCellularEngineAVX2 block stats calls
+    void setBlockStats(bool enabled, size_t histogram_bins = 0, double histogram_low = -1.0,
+                       double histogram_high = 1.0) {
+        block_stats_.configure(enabled, histogram_bins, histogram_low, histogram_high);
+    }
+    bool getBlockStatsEnabled() const { return block_stats_.enabled(); }
+    const BlockStats& getBlockStats() const { return block_stats_.stats(); }
+
+    size_t getNodeCount() const { return bank.size(); }
+    float getNodeOutput(size_t index) const;
+    float getNodeIntegratorState(size_t index) const;
+    void setNodeFeedback(size_t index, float feedback_coefficient);
+    void resetState() { bank.resetState(); }
+
+    void configureWorkers(const WorkerPoolConfig& config);
+    unsigned getWorkerCount() const;
+
+    void setSimdLevel(SimdLevel level);
+    SimdLevel getSimdLevel() const { return kernels_->level; }
+    const char* getKernelName() const { return kernels_->name; }
+
+    void setNodePipeline(NodePipeline pipeline);
+    NodePipeline getNodePipeline() const { return kernels_->pipeline; }
+
+    void setHarmonicCount(size_t count) { harmonics_.setHarmonicCount(count); }
+    size_t getHarmonicCount() const { return harmonics_.harmonicCount(); }
+
+    void setMissionSchedule(MissionSchedule schedule) { mission_schedule_ = schedule; }
+    MissionSchedule getMissionSchedule() const { return mission_schedule_; }
+
+    EngineMetrics getMetrics() const;
+    void getMetricsFrame(EngineMetricsFrame& frame) const;
+    void resetMetrics();
+    LatencySnapshot getLatencyHistogram(LatencyProbe probe) const;
+    void resetLatencyHistograms();
+
+    // Same contract as the AnalogCellularEngineAVX2 arena calls (the float
+    // engine has no FFT path, so fft_size is ignored)
+    void reserveArena(const EngineArenaConfig& config);
+    void releaseArena();
+    ArenaStats getArenaStats() const;
+    float* getArenaOutput() { return arena_output_; }
+    size_t getArenaMaxBlock() const { return arena_max_block_; }
+
+    // Same role as AnalogCellularEngineAVX2::callMutex
+    std::mutex& callMutex() const { return call_mutex_; }
+
+    NodeBankF32 bank;
+
+private:
+    mutable std::mutex call_mutex_;
+    MissionSchedule mission_schedule_ = MissionSchedule::Fused;
+    const NodeKernels* kernels_;
+    std::unique_ptr<WorkerPool> pool_;
+    HarmonicOscillatorBank harmonics_;
+    ControlWaveTable control_wave_;
+
+    // Per-block scratch reused across processBlock calls
+    ScratchBuffer<float> block_amplified_;
+    BlockStatsCollector block_stats_;
+    ScratchBuffer<float> block_blend_;
+    ScratchBuffer<float> block_boost_;
+
+    std::shared_ptr<EngineArena> arena_;
+    float* arena_output_ = nullptr;
+    size_t arena_max_block_ = 0;
+};
+
+// AnalogCellularEngineCompact Definition
+//
+// The float engine's node model on a CompactNodeBank: every per-node value
+// in 16 bits (half, bfloat16 or fixed point), widened to float in registers
+// by the kernels. For node counts whose float state does not fit in memory,
+// or sweeps bound by memory bandwidth, at the cost of the format's rounding
+// on every stored value. It offers the float engine's processing calls;
+// runMission always runs the fused schedule.
+class AnalogCellularEngineCompact {
+public:
+    // Throws std::invalid_argument for a fixed_range that is not positive
+    AnalogCellularEngineCompact(size_t num_nodes, NodeStateFormat format = NodeStateFormat::Half,
+                                float fixed_range = CompactNodeBank::kDefaultFixedRange);
+
+    double processSignalWave(double input_signal, double control_pattern);
+    void runMission(uint64_t num_steps);
+    // Same contract as AnalogCellularEngineAVX2::processBlock
+    void processBlock(const float* in, const float* control, const float* aux, float* out, size_t n);
+    // Same contract as the AnalogCellularEngineAVX2 block stats calls
+    void setBlockStats(bool enabled, size_t histogram_bins = 0, double histogram_low = -1.0,
+                       double histogram_high = 1.0) {
+        block_stats_.configure(enabled, histogram_bins, histogram_low, histogram_high);
+    }
+    bool getBlockStatsEnabled() const { return block_stats_.enabled(); }
+    const BlockStats& getBlockStats() const { return block_stats_.stats(); }
+
+    size_t getNodeCount() const { return bank.size(); }
+    NodeStateFormat getStateFormat() const { return bank.format(); }
+    float getNodeOutput(size_t index) const;
+    float getNodeIntegratorState(size_t index) const;
+    // Stored in the bank's format, so it reads back rounded
+    void setNodeFeedback(size_t index, float feedback_coefficient);
+    void resetState() { bank.resetState(); }
+
+    void configureWorkers(const WorkerPoolConfig& config);
+    unsigned getWorkerCount() const;
+
+    void setSimdLevel(SimdLevel level);
+    SimdLevel getSimdLevel() const { return kernels_->level; }
+    const char* getKernelName() const { return kernels_->name; }
+
+    void setNodePipeline(NodePipeline pipeline);
+    NodePipeline getNodePipeline() const { return kernels_->pipeline; }
+
+    void setHarmonicCount(size_t count) { harmonics_.setHarmonicCount(count); }
+    size_t getHarmonicCount() const { return harmonics_.harmonicCount(); }
+
+    EngineMetrics getMetrics() const;
+    LatencySnapshot getLatencyHistogram(LatencyProbe probe) const;
+
+    // Same role as AnalogCellularEngineAVX2::callMutex
+    std::mutex& callMutex() const { return call_mutex_; }
+
+    CompactNodeBank bank;
+
+private:
+    mutable std::mutex call_mutex_;
+    const NodeKernels* kernels_;
+    std::unique_ptr<WorkerPool> pool_;
+    HarmonicOscillatorBank harmonics_;
+    ControlWaveTable control_wave_;
+
+    ScratchBuffer<float> block_amplified_;
+    BlockStatsCollector block_stats_;
+    ScratchBuffer<float> block_blend_;
+    ScratchBuffer<float> block_boost_;
 };
@@ -0,0 +1,104 @@
+#include "async_block.h"
+#include <algorithm>
+#include <stdexcept>
+#include "timeline_trace.h"
+
+AsyncBlockProcessor::AsyncBlockProcessor(AnalogCellularEngineAVX2& engine, bool outputs)
+    : engine_(engine), outputs_(outputs), thread_([this] { run(); }) {}
+
+AsyncBlockProcessor::~AsyncBlockProcessor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_one();
+    thread_.join();
+}
+
+uint64_t AsyncBlockProcessor::submit(const float* in, const float* control, const float* aux, size_t n) {
+    std::lock_guard<std::mutex> producer(submit_mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    slot_cv_.wait(lock, [&] { return submitted_ - collected_ < kSlots; });
+
+    // The slot is neither processed nor read until submitted_ moves past it
+    Slot& slot = slots_[submitted_ % kSlots];
+    lock.unlock();
+    slot.in.assign(in, in + n);
+    slot.has_control = control != nullptr;
+    if (control) slot.control.assign(control, control + n);
+    slot.has_aux = aux != nullptr;
+    if (aux) slot.aux.assign(aux, aux + n);
+    if (outputs_) slot.out.resize(engine_.getNodeCount() * n);
+    slot.n = n;
+    slot.error = nullptr;
+    lock.lock();
+
+    const uint64_t sequence = submitted_++;
+    lock.unlock();
+    work_cv_.notify_one();
+    return sequence;
+}
+
+size_t AsyncBlockProcessor::collect(float* out) {
+    std::lock_guard<std::mutex> consumer(collect_mutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (collected_ == submitted_) throw std::logic_error("no block pending");
+    done_cv_.wait(lock, [&] { return processed_ > collected_; });
+
+    Slot& slot = slots_[collected_ % kSlots];
+    lock.unlock();
+    if (out && outputs_) std::copy(slot.out.begin(), slot.out.end(), out);
+    const size_t n = slot.n;
+    std::exception_ptr error = slot.error;
+    lock.lock();
+
+    collected_++;
+    lock.unlock();
+    slot_cv_.notify_one();
+    if (error) std::rethrow_exception(error);
+    return n;
+}
+
+size_t AsyncBlockProcessor::nextBlockSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return collected_ == submitted_ ? 0 : slots_[collected_ % kSlots].n;
+}
+
+bool AsyncBlockProcessor::ready() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return processed_ > collected_;
+}
+
+size_t AsyncBlockProcessor::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return static_cast<size_t>(submitted_ - collected_);
+}
+
+uint64_t AsyncBlockProcessor::submitted() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return submitted_;
+}
+
+void AsyncBlockProcessor::run() {
+    timeline_trace::setThreadName("dase async blocks");
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        // Queued blocks are finished before a stop takes effect
+        work_cv_.wait(lock, [&] { return processed_ < submitted_ || stop_; });
+        if (processed_ == submitted_) return;
+
+        Slot& slot = slots_[processed_ % kSlots];
+        lock.unlock();
+        try {
+            std::lock_guard<std::mutex> engine_lock(engine_.callMutex());
+            engine_.processBlock(slot.in.data(), slot.has_control ? slot.control.data() : nullptr,
+                                 slot.has_aux ? slot.aux.data() : nullptr, outputs_ ? slot.out.data() : nullptr,
+                                 slot.n);
+        } catch (...) {
+            slot.error = std::current_exception();
+        }
+        lock.lock();
+        processed_++;
+        done_cv_.notify_one();
+    }
+}
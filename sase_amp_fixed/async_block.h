@@ -0,0 +1,81 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "analog_universal_node_engine_avx2.h"
+
+// Double-buffered asynchronous processBlock on one engine.
+//
+// submit() copies a block into one of two slots and returns; a submission
+// thread advances the engine through it (spread over the engine's workers)
+// while the caller does I/O. collect() waits for the oldest submitted block
+// and copies out its outputs, so a caller that submits block k before
+// collecting gets block k-1 back: one block of added latency in exchange
+// for compute overlapping the caller. Blocks run in submission order, each
+// under the engine's call mutex.
+class AsyncBlockProcessor {
+public:
+    static constexpr size_t kSlots = 2;
+
+    // The engine must outlive the processor. With outputs false the blocks
+    // only advance the node state and collect() copies nothing.
+    explicit AsyncBlockProcessor(AnalogCellularEngineAVX2& engine, bool outputs = true);
+    // Finishes the submitted blocks, then joins the submission thread
+    ~AsyncBlockProcessor();
+
+    AsyncBlockProcessor(const AsyncBlockProcessor&) = delete;
+    AsyncBlockProcessor& operator=(const AsyncBlockProcessor&) = delete;
+
+    // Queues n samples of in/control/aux (control and aux may be null, as
+    // for processBlock) and returns the block's sequence number. Waits while
+    // both slots hold uncollected blocks.
+    uint64_t submit(const float* in, const float* control, const float* aux, size_t n);
+
+    // Waits for the oldest uncollected block and copies its node-major
+    // [num_nodes x n] outputs to out (null skips the copy). Returns n.
+    // Rethrows what processing the block threw; throws std::logic_error
+    // when no block is pending.
+    size_t collect(float* out);
+
+    // Samples in the oldest uncollected block (0 when none is pending)
+    size_t nextBlockSize() const;
+    // True when the oldest uncollected block has finished
+    bool ready() const;
+    // Submitted blocks not yet collected
+    size_t pending() const;
+    uint64_t submitted() const;
+    bool hasOutputs() const { return outputs_; }
+    AnalogCellularEngineAVX2& engine() const { return engine_; }
+
+private:
+    struct Slot {
+        std::vector<float> in, control, aux, out;
+        bool has_control = false;
+        bool has_aux = false;
+        size_t n = 0;
+        std::exception_ptr error;
+    };
+
+    void run();
+
+    AnalogCellularEngineAVX2& engine_;
+    const bool outputs_;
+    Slot slots_[kSlots];
+    uint64_t submitted_ = 0;
+    uint64_t processed_ = 0;
+    uint64_t collected_ = 0;
+    bool stop_ = false;
+
+    std::mutex submit_mutex_;   // One submit() at a time owns the next slot
+    std::mutex collect_mutex_;  // One collect() at a time owns the oldest slot
+    mutable std::mutex mutex_;  // Counters and stop_
+    std::condition_variable work_cv_;   // submission thread: a block was queued
+    std::condition_variable done_cv_;   // collect(): a block finished
+    std::condition_variable slot_cv_;   // submit(): a slot was collected
+    std::thread thread_;
+};
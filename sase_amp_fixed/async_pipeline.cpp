@@ -0,0 +1,270 @@
+#include "async_pipeline.h"
+#include <algorithm>
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+PipelineSession::PipelineSession(PipelineExecutor& executor, uint64_t id, const PipelineSessionConfig& config,
+                                 std::shared_ptr<WorkerPool> pool)
+    : executor_(executor), id_(id), config_(config),
+      engine_(std::make_unique<AnalogCellularEngineAVX2>(config.nodes)) {
+    engine_->shareWorkerPool(std::move(pool));
+    chroma_.num_channels = config.num_channels;
+    chroma_.node_stride = config.nodes / config.num_channels;
+    chroma_.sample_rate = config.sample_rate;
+    chroma_.phi_phase = config.phi_phase;
+    chroma_.phi_depth = config.phi_depth;
+    if (config.num_channels >= 2) {
+        ici_ = std::make_unique<ICIKernel>(config.num_channels, config.block_size);
+        padded_.resize(config.num_channels * config.block_size);
+    }
+    block_.input.reserve(config.block_size);
+    block_.output.reserve(config.num_channels * config.block_size);
+
+    if (config_.stages.empty()) {
+        config_.stages.push_back(&PipelineSession::inputStage);
+        config_.stages.push_back(&PipelineSession::engineStage);
+        if (ici_) config_.stages.push_back(&PipelineSession::analysisStage);
+        if (config_.publish) config_.stages.push_back(config_.publish);
+    }
+}
+
+bool PipelineSession::pushInput(const float* samples, size_t n) {
+    if (n == 0 || n > config_.block_size) {
+        throw std::invalid_argument("input block of " + std::to_string(n) + " samples, expected 1 to " +
+                                    std::to_string(config_.block_size));
+    }
+    {
+        std::lock_guard<std::mutex> lock(input_mutex_);
+        if (input_.size() >= config_.input_blocks) {
+            input_dropped_++;
+            return false;
+        }
+        std::vector<float> buffer;
+        if (!spare_input_.empty()) {
+            buffer = std::move(spare_input_.back());
+            spare_input_.pop_back();
+        }
+        buffer.assign(samples, samples + n);
+        input_.push_back(std::move(buffer));
+    }
+    wake();
+    return true;
+}
+
+size_t PipelineSession::queuedInput() const {
+    std::lock_guard<std::mutex> lock(input_mutex_);
+    return input_.size();
+}
+
+void PipelineSession::wake() { executor_.wake(*this); }
+
+PipelineSessionStats PipelineSession::stats() const {
+    PipelineSessionStats stats;
+    {
+        std::lock_guard<std::mutex> lock(executor_.mutex_);
+        stats = stats_;
+    }
+    std::lock_guard<std::mutex> lock(input_mutex_);
+    stats.input_dropped = input_dropped_;
+    return stats;
+}
+
+StageStatus PipelineSession::inputStage(PipelineSession& session) {
+    std::lock_guard<std::mutex> lock(session.input_mutex_);
+    if (session.input_.empty()) return StageStatus::Pending;
+    PipelineBlock& block = session.block_;
+    session.spare_input_.push_back(std::move(block.input));
+    block.input = std::move(session.input_.front());
+    session.input_.pop_front();
+    block.n = block.input.size();
+    block.sequence = session.taken_++;
+    block.ici = 0.0;
+    return StageStatus::Done;
+}
+
+StageStatus PipelineSession::engineStage(PipelineSession& session) {
+    PipelineBlock& block = session.block_;
+    block.output.resize(session.config_.num_channels * block.n);
+    session.engine_->processChromaticBlock(block.input.data(), block.n, session.chroma_, block.output.data());
+    return StageStatus::Done;
+}
+
+StageStatus PipelineSession::analysisStage(PipelineSession& session) {
+    PipelineBlock& block = session.block_;
+    if (!session.ici_) return StageStatus::Done;
+    const size_t size = session.config_.block_size;
+    const float* rows = block.output.data();
+    if (block.n < size) {
+        // Channel-major rows of n samples spread to rows of block_size, zero padded
+        for (size_t c = 0; c < session.config_.num_channels; c++) {
+            std::copy(rows + c * block.n, rows + (c + 1) * block.n, session.padded_.begin() + c * size);
+            std::fill(session.padded_.begin() + c * size + block.n, session.padded_.begin() + (c + 1) * size, 0.0f);
+        }
+        rows = session.padded_.data();
+    }
+    block.ici = session.ici_->process(rows);
+    return StageStatus::Done;
+}
+
+StageStatus PipelineSession::step(uint64_t& steps) {
+    const std::vector<PipelineStage>& stages = config_.stages;
+    for (;;) {
+        const StageStatus status = stages[stage_](*this);
+        steps++;
+        if (status != StageStatus::Done) return status;
+        if (++stage_ == stages.size()) {
+            stage_ = 0;
+            return StageStatus::Done;
+        }
+    }
+}
+
+PipelineExecutor::PipelineExecutor(std::shared_ptr<WorkerPool> pool)
+    : pool_(pool ? std::move(pool) : std::make_shared<WorkerPool>()) {}
+
+PipelineExecutor::~PipelineExecutor() { stop(); }
+
+std::shared_ptr<PipelineSession> PipelineExecutor::addSession(const PipelineSessionConfig& config) {
+    if (config.block_size == 0) throw std::invalid_argument("block_size must be positive");
+    if (config.num_channels == 0) throw std::invalid_argument("num_channels must be positive");
+    if (config.nodes < config.num_channels) throw std::invalid_argument("need at least one node per channel");
+    if (config.input_blocks == 0) throw std::invalid_argument("input_blocks must be positive");
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::shared_ptr<PipelineSession> session(new PipelineSession(*this, next_id_++, config, pool_));
+    sessions_.push_back(session);
+    // The first stage decides whether there is work yet
+    enqueueLocked(*session);
+    return session;
+}
+
+void PipelineExecutor::removeSession(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto match = [id](const std::shared_ptr<PipelineSession>& s) { return s->id() == id; };
+    auto it = std::find_if(sessions_.begin(), sessions_.end(), match);
+    if (it == sessions_.end()) return;
+    (*it)->state_ = PipelineSession::State::Removed;
+    sessions_.erase(it);
+    ready_.erase(std::remove_if(ready_.begin(), ready_.end(), match), ready_.end());
+}
+
+size_t PipelineExecutor::sessionCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
+
+void PipelineExecutor::enqueueLocked(PipelineSession& session) {
+    session.state_ = PipelineSession::State::Queued;
+    ready_.push_back(session.shared_from_this());
+    ready_cv_.notify_one();
+}
+
+void PipelineExecutor::wake(PipelineSession& session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (session.state_ == PipelineSession::State::Parked) {
+        enqueueLocked(session);
+    } else if (session.state_ == PipelineSession::State::Running) {
+        session.woken_ = true;
+    }
+}
+
+size_t PipelineExecutor::runOnce() {
+    std::lock_guard<std::mutex> run(run_mutex_);
+    std::vector<std::shared_ptr<PipelineSession>> batch;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        batch.swap(ready_);
+        for (auto& session : batch) {
+            session->state_ = PipelineSession::State::Running;
+            session->woken_ = false;
+        }
+    }
+    const size_t count = batch.size();
+    if (count == 0) return 0;
+
+    std::vector<StageStatus> status(count, StageStatus::Pending);
+    std::vector<uint64_t> steps(count, 0);
+    std::vector<std::string> errors(count);
+    std::vector<char> failed(count, 0);
+    auto stepSession = [&](size_t i) {
+        try {
+            status[i] = batch[i]->step(steps[i]);
+        } catch (const std::exception& e) {
+            failed[i] = 1;
+            errors[i] = e.what();
+        } catch (...) {
+            failed[i] = 1;
+            errors[i] = "unknown exception";
+        }
+    };
+    if (count == 1 || pool_->size() == 1) {
+        for (size_t i = 0; i < count; i++) stepSession(i);
+    } else {
+        pool_->parallelFor(count, 1, [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; i++) stepSession(i);
+        });
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < count; i++) {
+        PipelineSession& session = *batch[i];
+        session.stats_.steps += steps[i];
+        if (session.state_ == PipelineSession::State::Removed) continue;
+        if (failed[i]) {
+            session.state_ = PipelineSession::State::Failed;
+            session.stats_.failed = true;
+            session.stats_.error = errors[i];
+        } else if (status[i] == StageStatus::Pending) {
+            session.stats_.suspensions++;
+            if (session.woken_) {
+                enqueueLocked(session);
+            } else {
+                session.state_ = PipelineSession::State::Parked;
+            }
+        } else {
+            if (status[i] == StageStatus::Done) session.stats_.blocks++;
+            enqueueLocked(session);
+        }
+    }
+    return count;
+}
+
+size_t PipelineExecutor::runUntilIdle() {
+    size_t total = 0;
+    while (const size_t stepped = runOnce()) total += stepped;
+    return total;
+}
+
+void PipelineExecutor::start() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (driver_.joinable()) return;
+    stop_ = false;
+    driver_ = std::thread([this] { driverLoop(); });
+}
+
+void PipelineExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!driver_.joinable()) return;
+        stop_ = true;
+    }
+    ready_cv_.notify_all();
+    driver_.join();
+}
+
+bool PipelineExecutor::running() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return driver_.joinable() && !stop_;
+}
+
+void PipelineExecutor::driverLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!stop_) {
+        ready_cv_.wait(lock, [&] { return stop_ || !ready_.empty(); });
+        if (stop_) break;
+        lock.unlock();
+        runOnce();
+        lock.lock();
+    }
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "analog_universal_node_engine_avx2.h"
+#include "ici_kernel.h"
+#include "worker_pool.h"
+
+// What one step of a pipeline stage did
+enum class StageStatus {
+    Done = 0,     // Stage finished for this block; the session moves to the next stage
+    Pending = 1,  // Waiting on something outside (input, a send in flight); park until wake()
+    Yield = 2     // More to do; requeue behind the other ready sessions
+};
+
+class PipelineSession;
+
+// A resumable stage: called each time the session is scheduled on its
+// current stage, it returns instead of blocking, keeping whatever it needs
+// to resume in the session. This is the build's C++17 stand-in for an
+// awaitable: Pending is the suspension point and PipelineSession::wake()
+// the resumption.
+using PipelineStage = std::function<StageStatus(PipelineSession&)>;
+
+// The block a session's stages pass along
+struct PipelineBlock {
+    uint64_t sequence = 0;       // Blocks taken from the input so far, this one excluded
+    size_t n = 0;                // Samples in this block
+    std::vector<float> input;    // n samples
+    std::vector<float> output;   // Channel-major [num_channels x n]
+    double ici = 0.0;            // ICI of the block's channels (short blocks zero padded); 0 until analysed
+};
+
+struct PipelineSessionConfig {
+    size_t nodes = 1024;
+    size_t block_size = 512;
+    size_t num_channels = 8;
+    double sample_rate = 48000.0;
+    double phi_phase = 0.0;
+    double phi_depth = 0.5;
+    size_t input_blocks = 8;     // Input blocks buffered before pushInput() refuses more
+    // Stages run in order for every block, then from the first again. Empty
+    // for the default chain: input, engine, ICI analysis (2+ channels) and
+    // publish (when set).
+    std::vector<PipelineStage> stages;
+    // Publishing stage of the default chain, e.g. a non-blocking send:
+    // Pending while the send is in flight, with wake() on completion
+    PipelineStage publish;
+};
+
+struct PipelineSessionStats {
+    uint64_t blocks = 0;          // Completed passes through the stage chain
+    uint64_t steps = 0;           // Stage calls
+    uint64_t suspensions = 0;     // Pending returns
+    uint64_t input_dropped = 0;   // pushInput() calls refused for a full buffer
+    bool failed = false;
+    std::string error;            // What the failing stage threw
+};
+
+// A per-session pipeline of engine block processing, FFT analysis and
+// publishing, each an awaitable stage. The session owns its engine, ICI
+// kernel and block and runs on at most one worker at a time, so stages need
+// no locking of their own; pushInput(), wake() and stats() may be called
+// from any thread while the executor lives.
+class PipelineSession : public std::enable_shared_from_this<PipelineSession> {
+public:
+    uint64_t id() const { return id_; }
+    const PipelineSessionConfig& config() const { return config_; }
+    AnalogCellularEngineAVX2& engine() { return *engine_; }
+    PipelineBlock& block() { return block_; }
+    // Stage the session resumes at
+    size_t stage() const { return stage_; }
+
+    // Copies n (1..block_size) samples as one input block and wakes the
+    // session; false, dropping them, when input_blocks blocks are queued.
+    // Throws std::invalid_argument for n outside 1..block_size.
+    bool pushInput(const float* samples, size_t n);
+    size_t queuedInput() const;
+    // Resumes a session parked on Pending. Safe from any thread and before
+    // the stage has returned: a wake that races a Pending return reschedules
+    // the session rather than being lost.
+    void wake();
+    PipelineSessionStats stats() const;
+
+    // Built-in stages, for composing custom chains
+    static StageStatus inputStage(PipelineSession& session);    // Next queued input block, Pending when none
+    static StageStatus engineStage(PipelineSession& session);   // processChromaticBlock into block().output
+    static StageStatus analysisStage(PipelineSession& session); // ICIKernel over block().output
+
+private:
+    friend class PipelineExecutor;
+    enum class State { Parked, Queued, Running, Failed, Removed };
+
+    PipelineSession(class PipelineExecutor& executor, uint64_t id, const PipelineSessionConfig& config,
+                    std::shared_ptr<WorkerPool> pool);
+    // Runs stages until one suspends or yields (Pending, Yield) or the
+    // chain completes a block (Done); counts the stage calls into steps
+    StageStatus step(uint64_t& steps);
+
+    PipelineExecutor& executor_;
+    const uint64_t id_;
+    PipelineSessionConfig config_;
+    ChromaticBlockConfig chroma_;
+    std::unique_ptr<AnalogCellularEngineAVX2> engine_;
+    std::unique_ptr<ICIKernel> ici_;
+    PipelineBlock block_;
+    std::vector<float> padded_;  // Output rows spread to block_size for a short block's ICI
+    size_t stage_ = 0;
+    uint64_t taken_ = 0;
+
+    mutable std::mutex input_mutex_;
+    std::deque<std::vector<float>> input_;
+    std::vector<std::vector<float>> spare_input_;  // Consumed input buffers, reused by pushInput()
+    uint64_t input_dropped_ = 0;
+
+    // Guarded by the executor's mutex
+    State state_ = State::Parked;
+    bool woken_ = false;  // wake() while Running
+    PipelineSessionStats stats_;
+};
+
+// Runs any number of session pipelines on one worker pool with one driver
+// thread, instead of a thread per session. Ready sessions are stepped
+// together, one per worker (a lone ready session spreads its engine over
+// the pool instead); a session suspended on Pending costs nothing until
+// woken. A stage that throws fails its session, which then stops; the
+// others carry on.
+class PipelineExecutor {
+public:
+    // A null pool makes a pool of the default size
+    explicit PipelineExecutor(std::shared_ptr<WorkerPool> pool = nullptr);
+    // Stops the driver thread; sessions are released with the executor
+    ~PipelineExecutor();
+
+    PipelineExecutor(const PipelineExecutor&) = delete;
+    PipelineExecutor& operator=(const PipelineExecutor&) = delete;
+
+    // Creates a session (engine, ICI kernel, buffers) parked on its first
+    // stage. Throws std::invalid_argument for an empty block, no channels,
+    // fewer nodes than channels or no input buffer.
+    std::shared_ptr<PipelineSession> addSession(const PipelineSessionConfig& config);
+    // Takes a session off the executor; a step in progress finishes first
+    void removeSession(uint64_t id);
+    size_t sessionCount() const;
+
+    // Steps every session that is ready now, once, on the calling thread and
+    // the pool; returns how many were stepped
+    size_t runOnce();
+    // runOnce() until no session is ready; returns the sessions stepped in all
+    size_t runUntilIdle();
+    // Runs runOnce() on a driver thread whenever a session is ready
+    void start();
+    void stop();
+    bool running() const;
+
+    WorkerPool& pool() const { return *pool_; }
+
+private:
+    friend class PipelineSession;
+
+    void enqueueLocked(PipelineSession& session);
+    void wake(PipelineSession& session);
+    void driverLoop();
+
+    std::shared_ptr<WorkerPool> pool_;
+    uint64_t next_id_ = 0;
+    std::vector<std::shared_ptr<PipelineSession>> sessions_;
+    std::vector<std::shared_ptr<PipelineSession>> ready_;
+
+    mutable std::mutex mutex_;   // Sessions, ready_ and every session's scheduling state
+    std::mutex run_mutex_;       // One runOnce() at a time
+    std::condition_variable ready_cv_;
+    std::thread driver_;
+    bool stop_ = false;
+};
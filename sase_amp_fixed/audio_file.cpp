@@ -0,0 +1,333 @@
+#include "audio_file.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr uint16_t kWavePcm = 1;
+constexpr uint16_t kWaveFloat = 3;
+constexpr uint16_t kWaveExtensible = 0xFFFE;
+// Header of the files AudioFileWriter creates: RIFF, a 16-byte fmt chunk
+// and the data chunk header, so the samples start 4-byte aligned
+constexpr size_t kWriterHeaderBytes = 44;
+// RIFF sizes are 32-bit; longer files carry this in both size fields and
+// their data runs to the end of the file
+constexpr uint32_t kUnknownSize = 0xFFFFFFFFu;
+
+[[noreturn]] void fail(const std::string& path, const std::string& what) {
+    throw std::runtime_error("audio file " + path + ": " + what);
+}
+
+uint16_t le16(const unsigned char* p) { return static_cast<uint16_t>(p[0] | (p[1] << 8)); }
+uint32_t le32(const unsigned char* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+void put16(unsigned char* p, uint16_t v) {
+    p[0] = static_cast<unsigned char>(v);
+    p[1] = static_cast<unsigned char>(v >> 8);
+}
+void put32(unsigned char* p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = static_cast<unsigned char>(v >> (8 * i));
+}
+
+// One sample of each encoding as a float
+struct ReadFloat32 {
+    static float get(const unsigned char* p) {
+        float v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+};
+struct ReadPcm16 {
+    static float get(const unsigned char* p) {
+        int16_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return static_cast<float>(v) * (1.0f / 32768.0f);
+    }
+};
+struct ReadPcm24 {
+    static float get(const unsigned char* p) {
+        const int32_t v = static_cast<int32_t>(static_cast<uint32_t>(p[0]) << 8 | static_cast<uint32_t>(p[1]) << 16 |
+                                               static_cast<uint32_t>(p[2]) << 24) >> 8;
+        return static_cast<float>(v) * (1.0f / 8388608.0f);
+    }
+};
+struct ReadPcm32 {
+    static float get(const unsigned char* p) {
+        int32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return static_cast<float>(v) * (1.0f / 2147483648.0f);
+    }
+};
+
+template <class R>
+void readFrames(const unsigned char* samples, size_t channels, size_t sample_bytes, int channel, uint64_t first,
+                size_t n, float* out) {
+    const size_t frame_bytes = channels * sample_bytes;
+    const unsigned char* p = samples + first * frame_bytes;
+    if (channel >= 0) {
+        p += static_cast<size_t>(channel) * sample_bytes;
+        for (size_t i = 0; i < n; i++) out[i] = R::get(p + i * frame_bytes);
+        return;
+    }
+    const float scale = 1.0f / static_cast<float>(channels);
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char* frame = p + i * frame_bytes;
+        float sum = 0.0f;
+        for (size_t c = 0; c < channels; c++) sum += R::get(frame + c * sample_bytes);
+        out[i] = sum * scale;
+    }
+}
+
+// A whole file mapped read-only, or created at `size` bytes and mapped
+// read-write
+class FileMap {
+public:
+    unsigned char* data = nullptr;
+    size_t size = 0;
+
+    // Existing file, read-only
+    explicit FileMap(const std::string& path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) fail(path, "cannot open");
+        LARGE_INTEGER bytes;
+        if (!GetFileSizeEx(file, &bytes)) {
+            CloseHandle(file);
+            fail(path, "cannot stat");
+        }
+        size = static_cast<size_t>(bytes.QuadPart);
+        mapView(path, file, PAGE_READONLY, FILE_MAP_READ);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) fail(path, "cannot open");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            fail(path, "cannot stat");
+        }
+        size = static_cast<size_t>(st.st_size);
+        mapView(path, fd, PROT_READ);
+#endif
+    }
+
+    // New file of `bytes` bytes (an existing one is replaced), read-write
+    FileMap(const std::string& path, size_t bytes) : size(bytes) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) fail(path, "cannot create");
+        mapView(path, file, PAGE_READWRITE, FILE_MAP_WRITE);
+#else
+        const int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) fail(path, "cannot create");
+        if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+            ::close(fd);
+            fail(path, "cannot size to " + std::to_string(size) + " bytes");
+        }
+        mapView(path, fd, PROT_READ | PROT_WRITE);
+#endif
+    }
+
+    ~FileMap() {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+#else
+        ::munmap(data, size);
+#endif
+    }
+
+    FileMap(const FileMap&) = delete;
+    FileMap& operator=(const FileMap&) = delete;
+
+    bool flush() {
+#ifdef _WIN32
+        return FlushViewOfFile(data, 0) != 0;
+#else
+        return ::msync(data, size, MS_SYNC) == 0;
+#endif
+    }
+
+private:
+#ifdef _WIN32
+    // Maps size bytes of file, which it closes
+    void mapView(const std::string& path, HANDLE file, DWORD protect, DWORD access) {
+        const uint64_t bytes = size;
+        HANDLE mapping = size ? CreateFileMappingA(file, nullptr, protect, static_cast<DWORD>(bytes >> 32),
+                                                   static_cast<DWORD>(bytes), nullptr)
+                              : nullptr;
+        CloseHandle(file);
+        if (!mapping) fail(path, "cannot map");
+        data = static_cast<unsigned char*>(MapViewOfFile(mapping, access, 0, 0, 0));
+        CloseHandle(mapping);
+        if (!data) fail(path, "cannot map");
+    }
+#else
+    // Maps size bytes of fd, which it closes
+    void mapView(const std::string& path, int fd, int protect) {
+        void* mapped = size ? ::mmap(nullptr, size, protect, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (mapped == MAP_FAILED) fail(path, "cannot map");
+        data = static_cast<unsigned char*>(mapped);
+    }
+#endif
+};
+
+} // namespace
+
+struct AudioFileReader::Mapping : FileMap {
+    using FileMap::FileMap;
+};
+
+struct AudioFileWriter::Mapping : FileMap {
+    using FileMap::FileMap;
+};
+
+AudioFileReader::AudioFileReader(const std::string& path) : path_(path) {
+    mapping_ = std::make_unique<Mapping>(path);
+    const unsigned char* d = mapping_->data;
+    const size_t size = mapping_->size;
+    if (size < 12 || std::memcmp(d, "RIFF", 4) != 0 || std::memcmp(d + 8, "WAVE", 4) != 0) {
+        fail(path, "not a WAV file");
+    }
+
+    bool have_format = false;
+    uint16_t tag = 0, block_align = 0, bits = 0;
+    size_t offset = 12;
+    while (offset + 8 <= size) {
+        const unsigned char* chunk = d + offset;
+        const uint64_t chunk_bytes = le32(chunk + 4);
+        const size_t body = offset + 8;
+        if (std::memcmp(chunk, "fmt ", 4) == 0) {
+            if (chunk_bytes < 16 || body + 16 > size) fail(path, "truncated fmt chunk");
+            tag = le16(d + body);
+            channels_ = le16(d + body + 2);
+            sample_rate_ = static_cast<double>(le32(d + body + 4));
+            block_align = le16(d + body + 12);
+            bits = le16(d + body + 14);
+            if (tag == kWaveExtensible) {
+                // The sub-format GUID starts with the plain format tag
+                if (chunk_bytes < 40 || body + 26 > size) fail(path, "truncated extensible fmt chunk");
+                tag = le16(d + body + 24);
+            }
+            have_format = true;
+        } else if (std::memcmp(chunk, "data", 4) == 0) {
+            if (!have_format) fail(path, "data chunk before fmt chunk");
+            uint64_t data_bytes = size - body;
+            if (chunk_bytes != kUnknownSize) data_bytes = std::min<uint64_t>(data_bytes, chunk_bytes);
+            samples_ = d + body;
+            if (tag == kWaveFloat && bits == 32) {
+                format_ = AudioSampleFormat::Float32;
+            } else if (tag == kWavePcm && bits == 16) {
+                format_ = AudioSampleFormat::Pcm16;
+            } else if (tag == kWavePcm && bits == 24) {
+                format_ = AudioSampleFormat::Pcm24;
+            } else if (tag == kWavePcm && bits == 32) {
+                format_ = AudioSampleFormat::Pcm32;
+            } else {
+                fail(path, "unsupported encoding (format " + std::to_string(tag) + ", " + std::to_string(bits) +
+                               " bits)");
+            }
+            sample_bytes_ = bits / 8;
+            if (channels_ == 0 || sample_rate_ <= 0.0 || block_align != channels_ * sample_bytes_) {
+                fail(path, "inconsistent fmt chunk");
+            }
+            frames_ = data_bytes / block_align;
+            return;
+        }
+        offset = body + static_cast<size_t>(chunk_bytes + (chunk_bytes & 1));
+    }
+    fail(path, "no data chunk");
+}
+
+AudioFileReader::AudioFileReader(const std::string& path, size_t channels, double sample_rate)
+    : path_(path), channels_(channels), sample_rate_(sample_rate) {
+    if (channels == 0) throw std::invalid_argument("a raw file needs at least one channel");
+    if (!(sample_rate > 0.0)) throw std::invalid_argument("sample_rate must be positive");
+    mapping_ = std::make_unique<Mapping>(path);
+    if (mapping_->size % (channels * sizeof(float)) != 0) fail(path, "size is not a whole number of frames");
+    samples_ = mapping_->data;
+    frames_ = mapping_->size / (channels * sizeof(float));
+}
+
+AudioFileReader::~AudioFileReader() = default;
+
+void AudioFileReader::read(int channel, uint64_t first, size_t n, float* out) const {
+    if (channel >= static_cast<int>(channels_)) {
+        throw std::out_of_range("channel " + std::to_string(channel) + " of a " + std::to_string(channels_) +
+                                "-channel file");
+    }
+    const size_t valid = first >= frames_ ? 0 : static_cast<size_t>(std::min<uint64_t>(n, frames_ - first));
+    switch (format_) {
+    case AudioSampleFormat::Float32:
+        readFrames<ReadFloat32>(samples_, channels_, sample_bytes_, channel, first, valid, out);
+        break;
+    case AudioSampleFormat::Pcm16:
+        readFrames<ReadPcm16>(samples_, channels_, sample_bytes_, channel, first, valid, out);
+        break;
+    case AudioSampleFormat::Pcm24:
+        readFrames<ReadPcm24>(samples_, channels_, sample_bytes_, channel, first, valid, out);
+        break;
+    case AudioSampleFormat::Pcm32:
+        readFrames<ReadPcm32>(samples_, channels_, sample_bytes_, channel, first, valid, out);
+        break;
+    }
+    std::fill(out + valid, out + n, 0.0f);
+}
+
+AudioFileWriter::AudioFileWriter(const std::string& path, size_t channels, double sample_rate, uint64_t frames)
+    : path_(path), channels_(channels), frames_(frames), sample_rate_(sample_rate) {
+    if (channels == 0 || channels > 0xFFFF) throw std::invalid_argument("channels must be in [1, 65535]");
+    if (!(sample_rate > 0.0)) throw std::invalid_argument("sample_rate must be positive");
+    const uint64_t data_bytes = frames * channels * sizeof(float);
+    mapping_ = std::make_unique<Mapping>(path, static_cast<size_t>(kWriterHeaderBytes + data_bytes));
+
+    const bool fits = data_bytes <= kUnknownSize - (kWriterHeaderBytes - 8);
+    unsigned char* h = mapping_->data;
+    std::memcpy(h, "RIFF", 4);
+    put32(h + 4, fits ? static_cast<uint32_t>(kWriterHeaderBytes - 8 + data_bytes) : kUnknownSize);
+    std::memcpy(h + 8, "WAVEfmt ", 8);
+    put32(h + 16, 16);
+    put16(h + 20, kWaveFloat);
+    put16(h + 22, static_cast<uint16_t>(channels));
+    put32(h + 24, static_cast<uint32_t>(sample_rate + 0.5));
+    put32(h + 28, static_cast<uint32_t>((sample_rate + 0.5) * channels * sizeof(float)));
+    put16(h + 32, static_cast<uint16_t>(channels * sizeof(float)));
+    put16(h + 34, 32);
+    std::memcpy(h + 36, "data", 4);
+    put32(h + 40, fits ? static_cast<uint32_t>(data_bytes) : kUnknownSize);
+    samples_ = reinterpret_cast<float*>(h + kWriterHeaderBytes);
+}
+
+AudioFileWriter::~AudioFileWriter() = default;
+
+void AudioFileWriter::write(uint64_t first, const float* block, size_t n) {
+    if (first > frames_ || n > frames_ - first) {
+        throw std::out_of_range("frames [" + std::to_string(first) + ", " + std::to_string(first + n) +
+                                ") past the end of a " + std::to_string(frames_) + "-frame file");
+    }
+    float* dst = samples_ + first * channels_;
+    for (size_t c = 0; c < channels_; c++) {
+        const float* src = block + c * n;
+        for (size_t i = 0; i < n; i++) dst[i * channels_ + c] = src[i];
+    }
+}
+
+void AudioFileWriter::flush() {
+    if (!mapping_->flush()) fail(path_, "write-back failed");
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Sample encodings AudioFileReader reads. WAV files carry theirs in the fmt
+// chunk (PCM or IEEE float, plain or WAVE_FORMAT_EXTENSIBLE); raw files are
+// headerless interleaved float32.
+enum class AudioSampleFormat {
+    Float32 = 0,
+    Pcm16 = 1,
+    Pcm24 = 2,
+    Pcm32 = 3
+};
+
+// A recording mapped read-only, for offline replay faster than real time:
+// opening reads the header and nothing else, and blocks are converted to
+// float straight from the mapping as they are read, so a day of audio costs
+// no more memory than a block. Samples are little-endian, as WAV specifies
+// and every supported host stores them. read() only reads the mapping, so
+// any number of threads may read one file at once.
+//
+// Throws std::runtime_error with the reason when the file cannot be mapped
+// or is not a supported WAV file, and for a raw file whose size is not a
+// whole number of frames.
+class AudioFileReader {
+public:
+    // WAV file
+    explicit AudioFileReader(const std::string& path);
+    // Raw interleaved float32 of `channels` channels; throws
+    // std::invalid_argument for no channels or a non-positive rate
+    AudioFileReader(const std::string& path, size_t channels, double sample_rate);
+    ~AudioFileReader();
+
+    AudioFileReader(const AudioFileReader&) = delete;
+    AudioFileReader& operator=(const AudioFileReader&) = delete;
+
+    const std::string& path() const { return path_; }
+    size_t channels() const { return channels_; }
+    uint64_t frames() const { return frames_; }
+    double sampleRate() const { return sample_rate_; }
+    AudioSampleFormat format() const { return format_; }
+    double duration() const { return static_cast<double>(frames_) / sample_rate_; }
+
+    // Frames [first, first + n) of channel `channel`, or the mean of every
+    // channel for a negative channel, into out as floats (PCM scaled to
+    // [-1, 1)). Frames past the end read as 0. Throws std::out_of_range for
+    // a channel past the last.
+    void read(int channel, uint64_t first, size_t n, float* out) const;
+
+private:
+    struct Mapping;
+
+    void open(const std::string& path);
+
+    std::string path_;
+    std::unique_ptr<Mapping> mapping_;
+    const unsigned char* samples_ = nullptr;  // First frame, in the mapping
+    size_t channels_ = 0;
+    uint64_t frames_ = 0;
+    double sample_rate_ = 0.0;
+    AudioSampleFormat format_ = AudioSampleFormat::Float32;
+    size_t sample_bytes_ = 4;
+};
+
+// A float32 WAV file of a known length, mapped read-write. The file is
+// created at its final size with the header in place, so writers of
+// disjoint frame ranges may run concurrently and a render needs no
+// staging buffer; pages reach the disk as the system writes them back, and
+// at the latest on flush() or destruction.
+//
+// Throws std::invalid_argument for no channels or a non-positive rate, and
+// std::runtime_error with the reason when the file cannot be created or
+// mapped.
+class AudioFileWriter {
+public:
+    AudioFileWriter(const std::string& path, size_t channels, double sample_rate, uint64_t frames);
+    ~AudioFileWriter();
+
+    AudioFileWriter(const AudioFileWriter&) = delete;
+    AudioFileWriter& operator=(const AudioFileWriter&) = delete;
+
+    const std::string& path() const { return path_; }
+    size_t channels() const { return channels_; }
+    uint64_t frames() const { return frames_; }
+    double sampleRate() const { return sample_rate_; }
+
+    // Channel-major [channels x n] block, channel c at block + c * n, into
+    // frames [first, first + n); throws std::out_of_range past the end
+    void write(uint64_t first, const float* block, size_t n);
+    // Writes the mapped pages back; throws std::runtime_error on failure
+    void flush();
+
+private:
+    struct Mapping;
+
+    std::string path_;
+    std::unique_ptr<Mapping> mapping_;
+    float* samples_ = nullptr;  // First frame, in the mapping
+    size_t channels_;
+    uint64_t frames_;
+    double sample_rate_;
+};
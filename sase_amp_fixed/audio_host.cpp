@@ -0,0 +1,446 @@
+#include "audio_host.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <stdexcept>
+#include "compute_quality.h"
+
+#ifdef DASE_WITH_PORTAUDIO
+#include <portaudio.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+namespace {
+
+size_t ringSlots(size_t wanted) {
+    size_t slots = 1;
+    while (slots < wanted) slots <<= 1;
+    return slots;
+}
+
+int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const AudioHostConfig& validated(const AudioHostConfig& config) {
+    if (config.block_size == 0) throw std::invalid_argument("audio host block size must be at least 1");
+    if (config.max_block < config.block_size) throw std::invalid_argument("audio host max_block is under block_size");
+    if (config.num_channels == 0) throw std::invalid_argument("audio host needs at least one chromatic channel");
+    if (config.output_channels == 0) throw std::invalid_argument("audio host needs at least one output channel");
+    if (!(config.sample_rate > 0.0)) throw std::invalid_argument("audio host sample rate must be positive");
+    return config;
+}
+
+#ifdef DASE_WITH_PORTAUDIO
+// Pa_Initialize and Pa_Terminate nest; the guard pairs them around a
+// device listing
+class PortAudioSession {
+public:
+    PortAudioSession() : error_(Pa_Initialize()) {}
+    ~PortAudioSession() {
+        if (error_ == paNoError) Pa_Terminate();
+    }
+    bool ok() const { return error_ == paNoError; }
+    const char* error() const { return Pa_GetErrorText(error_); }
+
+private:
+    PaError error_;
+};
+
+int portAudioCallback(const void* input, void* output, unsigned long frames, const PaStreamCallbackTimeInfo*,
+                      PaStreamCallbackFlags status, void* user) {
+    static_cast<NativeAudioHost*>(user)->process(static_cast<const float*>(input), static_cast<float*>(output),
+                                                 frames, (status & paOutputUnderflow) != 0,
+                                                 (status & paInputOverflow) != 0);
+    return paContinue;
+}
+#endif
+
+}  // namespace
+
+const char* audioHostBackendName(AudioHostBackend backend) {
+    switch (backend) {
+        case AudioHostBackend::PortAudio: return "portaudio";
+        case AudioHostBackend::Simulated: return "simulated";
+    }
+    return "unknown";
+}
+
+NativeAudioHost::NativeAudioHost(AnalogCellularEngineAVX2& engine, const AudioHostConfig& config)
+    : engine_(engine), config_(validated(config)), automation_(1024, config.max_block),
+      downmix_(config.num_channels), delay_(2, config.max_delay, DelayInterpolation::Linear, config.max_block) {
+    block_config_.num_channels = config.num_channels;
+    block_config_.node_stride = config.node_stride > 0 ? config.node_stride : config.num_channels;
+    block_config_.sample_rate = config.sample_rate;
+
+    mono_.assign(config.max_block, 0.0f);
+    chromatic_.assign(config.num_channels * config.max_block, 0.0f);
+    stereo_.assign(2 * config.max_block, 0.0f);
+
+    // Linear pan across the channels, normalized so a full-scale channel
+    // set peaks at full scale on each side
+    const size_t channels = config.num_channels;
+    weights_.assign(2 * channels, 0.0f);
+    for (size_t c = 0; c < channels; c++) {
+        const float position = channels > 1 ? static_cast<float>(c) / static_cast<float>(channels - 1) : 0.5f;
+        weights_[c] = 1.0f - position;
+        weights_[channels + c] = position;
+    }
+    gain_ = 2.0f / static_cast<float>(channels);
+    downmix_.setWeights(weights_.data(), weights_.data() + channels, gain_);
+
+    // A full downmix is 2 * channels weight commands and a gain
+    commands_.resize(ringSlots(std::max<size_t>(256, 4 * channels + 8)));
+    frames_.resize(ringSlots(std::max<size_t>(config.frame_queue, 1)));
+}
+
+NativeAudioHost::~NativeAudioHost() {
+    stop();
+}
+
+bool NativeAudioHost::backendAvailable(AudioHostBackend backend) {
+    if (backend == AudioHostBackend::Simulated) return true;
+#ifdef DASE_WITH_PORTAUDIO
+    return true;
+#else
+    return false;
+#endif
+}
+
+std::vector<AudioDeviceInfo> NativeAudioHost::devices(AudioHostBackend backend) {
+    std::vector<AudioDeviceInfo> list;
+    if (backend == AudioHostBackend::Simulated) {
+        AudioDeviceInfo device;
+        device.index = 0;
+        device.name = "simulated";
+        device.api = "simulated";
+        device.max_input_channels = 1;
+        device.max_output_channels = 2;
+        device.default_sample_rate = 48000.0;
+        list.push_back(device);
+        return list;
+    }
+#ifdef DASE_WITH_PORTAUDIO
+    PortAudioSession session;
+    if (!session.ok()) return list;
+    const PaDeviceIndex count = Pa_GetDeviceCount();
+    for (PaDeviceIndex i = 0; i < count; i++) {
+        const PaDeviceInfo* info = Pa_GetDeviceInfo(i);
+        if (!info) continue;
+        AudioDeviceInfo device;
+        device.index = i;
+        device.name = info->name ? info->name : "";
+        const PaHostApiInfo* api = Pa_GetHostApiInfo(info->hostApi);
+        device.api = api && api->name ? api->name : "";
+        device.max_input_channels = static_cast<unsigned>(std::max(info->maxInputChannels, 0));
+        device.max_output_channels = static_cast<unsigned>(std::max(info->maxOutputChannels, 0));
+        device.default_sample_rate = info->defaultSampleRate;
+        device.default_low_latency =
+            info->maxOutputChannels > 0 ? info->defaultLowOutputLatency : info->defaultLowInputLatency;
+        list.push_back(device);
+    }
+#endif
+    return list;
+}
+
+void NativeAudioHost::start() {
+    if (running()) return;
+    if (!backendAvailable(config_.backend)) {
+        throw std::runtime_error(std::string("audio host backend not built in: ") +
+                                 audioHostBackendName(config_.backend));
+    }
+    frame_write_.store(0, std::memory_order_relaxed);
+    frame_read_.store(0, std::memory_order_relaxed);
+    callbacks_.store(0, std::memory_order_relaxed);
+    delay_.reset();
+
+    if (config_.backend == AudioHostBackend::Simulated) {
+        input_latency_ = 0.0;
+        output_latency_ = static_cast<double>(config_.block_size) / config_.sample_rate;
+        running_.store(true, std::memory_order_release);
+        simulated_ = std::thread(&NativeAudioHost::simulatedLoop, this);
+        return;
+    }
+
+#ifdef DASE_WITH_PORTAUDIO
+    PaError error = Pa_Initialize();
+    if (error != paNoError) throw std::runtime_error(std::string("PortAudio: ") + Pa_GetErrorText(error));
+    // Pa_Terminate pairs with the Pa_Initialize above, here or in stop()
+    auto fail = [](const std::string& what) {
+        Pa_Terminate();
+        throw std::runtime_error("PortAudio: " + what);
+    };
+
+    PaStreamParameters input = {}, output = {};
+    const bool capture = config_.input_channels > 0;
+    if (capture) {
+        input.device = config_.input_device >= 0 ? config_.input_device : Pa_GetDefaultInputDevice();
+        if (input.device == paNoDevice || !Pa_GetDeviceInfo(input.device)) fail("no input device");
+        input.channelCount = static_cast<int>(config_.input_channels);
+        input.sampleFormat = paFloat32;
+        input.suggestedLatency = config_.suggested_latency > 0.0
+                                     ? config_.suggested_latency
+                                     : Pa_GetDeviceInfo(input.device)->defaultLowInputLatency;
+    }
+    output.device = config_.output_device >= 0 ? config_.output_device : Pa_GetDefaultOutputDevice();
+    if (output.device == paNoDevice || !Pa_GetDeviceInfo(output.device)) fail("no output device");
+    output.channelCount = static_cast<int>(config_.output_channels);
+    output.sampleFormat = paFloat32;
+    output.suggestedLatency = config_.suggested_latency > 0.0
+                                  ? config_.suggested_latency
+                                  : Pa_GetDeviceInfo(output.device)->defaultLowOutputLatency;
+
+    PaStream* stream = nullptr;
+    error = Pa_OpenStream(&stream, capture ? &input : nullptr, &output, config_.sample_rate,
+                          static_cast<unsigned long>(config_.block_size), paClipOff | paDitherOff,
+                          portAudioCallback, this);
+    if (error != paNoError) fail(Pa_GetErrorText(error));
+    if (const PaStreamInfo* info = Pa_GetStreamInfo(stream)) {
+        input_latency_ = info->inputLatency;
+        output_latency_ = info->outputLatency;
+    }
+    running_.store(true, std::memory_order_release);
+    error = Pa_StartStream(stream);
+    if (error != paNoError) {
+        running_.store(false, std::memory_order_release);
+        Pa_CloseStream(stream);
+        fail(Pa_GetErrorText(error));
+    }
+    stream_ = stream;
+#endif
+}
+
+void NativeAudioHost::stop() {
+    if (!running()) return;
+    running_.store(false, std::memory_order_release);
+    if (simulated_.joinable()) simulated_.join();
+#ifdef DASE_WITH_PORTAUDIO
+    if (stream_) {
+        PaStream* stream = static_cast<PaStream*>(stream_);
+        Pa_StopStream(stream);  // Returns once the last callback has
+        Pa_CloseStream(stream);
+        Pa_Terminate();
+        stream_ = nullptr;
+    }
+#endif
+}
+
+void NativeAudioHost::simulatedLoop() {
+    const size_t frames = config_.block_size;
+    std::vector<float> in(frames * config_.input_channels, 0.0f), out(frames * config_.output_channels);
+    const double step = 2.0 * M_PI * config_.test_tone_hz / config_.sample_rate;
+    double phase = 0.0;
+    const auto period = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(frames) / config_.sample_rate));
+    auto release = std::chrono::steady_clock::now();
+    while (running_.load(std::memory_order_acquire)) {
+        for (size_t t = 0; t < frames; t++) {
+            const float sample = static_cast<float>(0.5 * std::sin(phase));
+            for (unsigned c = 0; c < config_.input_channels; c++) in[t * config_.input_channels + c] = sample;
+            phase += step;
+        }
+        phase = std::fmod(phase, 2.0 * M_PI);
+        process(config_.input_channels > 0 ? in.data() : nullptr, out.data(), frames);
+        release += period;
+        std::this_thread::sleep_until(release);
+    }
+}
+
+bool NativeAudioHost::pushCommands(const Command* commands, size_t count) {
+    const uint64_t write = command_write_.load(std::memory_order_relaxed);
+    const uint64_t read = command_read_.load(std::memory_order_acquire);
+    if (write - read + count > commands_.size()) {
+        commands_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    const uint64_t mask = commands_.size() - 1;
+    for (size_t i = 0; i < count; i++) commands_[(write + i) & mask] = commands[i];
+    command_write_.store(write + count, std::memory_order_release);
+    return true;
+}
+
+bool NativeAudioHost::setDownmix(const float* left, const float* right, float gain) {
+    const size_t channels = config_.num_channels;
+    std::vector<Command> commands;
+    commands.reserve(2 * channels + 1);
+    for (size_t c = 0; c < channels; c++) {
+        commands.push_back({CommandKind::Weight, 0, static_cast<uint16_t>(c), left[c]});
+        commands.push_back({CommandKind::Weight, 1, static_cast<uint16_t>(c), right[c]});
+    }
+    commands.push_back({CommandKind::Gain, 0, 0, gain});
+    return pushCommands(commands.data(), commands.size());
+}
+
+bool NativeAudioHost::setCompensationDelay(double samples) {
+    const Command command{CommandKind::Delay, 0, 0, static_cast<float>(samples)};
+    return pushCommands(&command, 1);
+}
+
+bool NativeAudioHost::setComputeQuality(ComputeQuality quality) {
+    const Command command{CommandKind::Quality, 0, 0, static_cast<float>(quality)};
+    return pushCommands(&command, 1);
+}
+
+void NativeAudioHost::applyCommands() {
+    const uint64_t write = command_write_.load(std::memory_order_acquire);
+    uint64_t read = command_read_.load(std::memory_order_relaxed);
+    if (read == write) return;
+    const uint64_t mask = commands_.size() - 1;
+    bool weights = false;
+    for (; read != write; read++) {
+        const Command& command = commands_[read & mask];
+        switch (command.kind) {
+            case CommandKind::Weight:
+                weights_[command.side * config_.num_channels + command.channel] = command.value;
+                weights = true;
+                break;
+            case CommandKind::Gain:
+                gain_ = command.value;
+                weights = true;
+                break;
+            case CommandKind::Delay:
+                delay_.setDelay(command.value);
+                break;
+            case CommandKind::Quality:
+                engine_.setComputeQuality(static_cast<ComputeQuality>(static_cast<int>(command.value)));
+                break;
+        }
+    }
+    command_read_.store(read, std::memory_order_release);
+    // A downmix lands whole: its gain is pushed last
+    if (weights) downmix_.setWeights(weights_.data(), weights_.data() + config_.num_channels, gain_);
+}
+
+void NativeAudioHost::process(const float* in, float* out, size_t frames, bool underflow, bool overflow) {
+    const int64_t start = steadyNs();
+    AudioHostFrame frame;
+    frame.callback = callbacks_.fetch_add(1, std::memory_order_relaxed);
+    frame.sample = automation_.position();
+    frame.time_ns = start;
+    frame.frames = static_cast<uint32_t>(frames);
+    frame.underflow = underflow;
+    frame.overflow = overflow;
+    if (underflow) underflows_.fetch_add(1, std::memory_order_relaxed);
+    if (overflow) overflows_.fetch_add(1, std::memory_order_relaxed);
+
+    const unsigned outputs = config_.output_channels;
+    std::unique_lock<std::mutex> lock(engine_.callMutex(), std::try_to_lock);
+    if (!lock.owns_lock()) {
+        std::fill(out, out + frames * outputs, 0.0f);
+        frame.contended = true;
+        contended_.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        applyCommands();
+        const unsigned inputs = config_.input_channels;
+        double squared[2] = {0.0, 0.0};
+        for (size_t done = 0; done < frames;) {
+            const size_t n = std::min(frames - done, config_.max_block);
+            runBlock(in ? in + done * inputs : nullptr, out + done * outputs, n);
+            for (size_t side = 0; side < 2; side++) {
+                const float* row = stereo_.data() + side * config_.max_block;
+                for (size_t t = 0; t < n; t++) {
+                    squared[side] += static_cast<double>(row[t]) * row[t];
+                    frame.peak[side] = std::max(frame.peak[side], std::fabs(row[t]));
+                }
+            }
+            done += n;
+        }
+        for (size_t side = 0; side < 2; side++) {
+            frame.rms[side] = frames > 0 ? static_cast<float>(std::sqrt(squared[side] / frames)) : 0.0f;
+        }
+    }
+    frame.phi_phase = static_cast<float>(automation_.current(ParameterId::PhiPhase));
+    frame.phi_depth = static_cast<float>(automation_.current(ParameterId::PhiDepth));
+
+    const int64_t elapsed = steadyNs() - start;
+    const double budget_ns = static_cast<double>(frames) * 1e9 / config_.sample_rate;
+    frame.processing_ns = static_cast<uint32_t>(std::min<int64_t>(elapsed, UINT32_MAX));
+    frame.load = budget_ns > 0.0 ? static_cast<float>(static_cast<double>(elapsed) / budget_ns) : 0.0f;
+    if (frame.load > 1.0f) late_.fetch_add(1, std::memory_order_relaxed);
+    processing_.record(static_cast<uint64_t>(elapsed));
+    frame_count_.fetch_add(frames, std::memory_order_relaxed);
+    publishFrame(frame);
+}
+
+void NativeAudioHost::runBlock(const float* in, float* out, size_t n) {
+    const unsigned inputs = config_.input_channels;
+    if (in) {
+        for (size_t t = 0; t < n; t++) mono_[t] = in[t * inputs];
+    } else {
+        std::fill(mono_.begin(), mono_.begin() + n, 0.0f);
+    }
+    // Rows n apart, the stride processChromaticBlock writes them at
+    engine_.processChromaticBlock(mono_.data(), n, block_config_, automation_, chromatic_.data());
+    float* left = stereo_.data();
+    float* right = stereo_.data() + config_.max_block;
+    downmix_.process(chromatic_.data(), n, n, left, right);
+    delay_.process(stereo_.data(), config_.max_block, n);
+
+    const unsigned outputs = config_.output_channels;
+    if (outputs == 1) {
+        for (size_t t = 0; t < n; t++) out[t] = 0.5f * (left[t] + right[t]);
+        return;
+    }
+    for (size_t t = 0; t < n; t++) {
+        float* frame = out + t * outputs;
+        frame[0] = left[t];
+        frame[1] = right[t];
+        for (unsigned c = 2; c < outputs; c++) frame[c] = 0.0f;
+    }
+}
+
+void NativeAudioHost::publishFrame(const AudioHostFrame& frame) {
+    const uint64_t write = frame_write_.load(std::memory_order_relaxed);
+    if (write - frame_read_.load(std::memory_order_acquire) >= frames_.size()) {
+        frames_dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    frames_[write & (frames_.size() - 1)] = frame;
+    frame_write_.store(write + 1, std::memory_order_release);
+}
+
+size_t NativeAudioHost::drainFrames(AudioHostFrame* out, size_t max) {
+    const uint64_t write = frame_write_.load(std::memory_order_acquire);
+    uint64_t read = frame_read_.load(std::memory_order_relaxed);
+    size_t count = 0;
+    for (; read != write && count < max; read++, count++) {
+        out[count] = frames_[read & (frames_.size() - 1)];
+    }
+    frame_read_.store(read, std::memory_order_release);
+    return count;
+}
+
+size_t NativeAudioHost::pendingFrames() const {
+    return static_cast<size_t>(frame_write_.load(std::memory_order_acquire) -
+                               frame_read_.load(std::memory_order_relaxed));
+}
+
+AudioHostStats NativeAudioHost::stats() const {
+    AudioHostStats stats;
+    stats.callbacks = callbacks_.load(std::memory_order_relaxed);
+    stats.frames = frame_count_.load(std::memory_order_relaxed);
+    stats.underflows = underflows_.load(std::memory_order_relaxed);
+    stats.overflows = overflows_.load(std::memory_order_relaxed);
+    stats.late = late_.load(std::memory_order_relaxed);
+    stats.contended = contended_.load(std::memory_order_relaxed);
+    stats.frames_dropped = frames_dropped_.load(std::memory_order_relaxed);
+    stats.commands_dropped = commands_dropped_.load(std::memory_order_relaxed);
+    stats.processing = processing_.snapshot();
+    return stats;
+}
+
+void NativeAudioHost::resetStats() {
+    frame_count_.store(0, std::memory_order_relaxed);
+    underflows_.store(0, std::memory_order_relaxed);
+    overflows_.store(0, std::memory_order_relaxed);
+    late_.store(0, std::memory_order_relaxed);
+    contended_.store(0, std::memory_order_relaxed);
+    frames_dropped_.store(0, std::memory_order_relaxed);
+    commands_dropped_.store(0, std::memory_order_relaxed);
+    processing_.reset();
+}
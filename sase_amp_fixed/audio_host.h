@@ -0,0 +1,200 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+#include "analog_universal_node_engine_avx2.h"
+#include "latency_histogram.h"
+#include "output_stage.h"
+#include "parameter_automation.h"
+
+// Device layer under NativeAudioHost
+enum class AudioHostBackend : uint8_t {
+    PortAudio = 0,   // The system's devices, when built with DASE_WITH_PORTAUDIO
+    Simulated = 1    // A thread on the block clock feeding a test tone; no device
+};
+
+const char* audioHostBackendName(AudioHostBackend backend);
+
+struct AudioHostConfig {
+    AudioHostBackend backend = AudioHostBackend::PortAudio;
+    double sample_rate = 48000.0;
+    size_t block_size = 512;          // Frames per device callback asked for
+    size_t max_block = 4096;          // Longest callback taken in one engine block; longer ones are split
+    int input_device = -1;            // Backend device index, -1 for the default
+    int output_device = -1;
+    unsigned input_channels = 1;      // The first feeds the engine; 0 runs on silence
+    unsigned output_channels = 2;     // Left and right, then silence; 1 takes their mean
+    double suggested_latency = 0.0;   // Seconds, 0 for the device's low-latency default
+    size_t num_channels = 8;          // Chromatic channels, downmixed to stereo
+    size_t node_stride = 0;           // Channel c runs through node c * node_stride; 0 for num_channels
+    size_t max_delay = 4800;          // Latency compensation range, samples
+    double test_tone_hz = 440.0;      // Simulated input, amplitude 0.5
+    size_t frame_queue = 256;         // AudioHostFrames held for the reader; rounded up to a power of two
+};
+
+// One device callback as the reader sees it
+struct AudioHostFrame {
+    uint64_t callback = 0;            // From 0 since start()
+    uint64_t sample = 0;              // First sample of the callback on the automation clock
+    int64_t time_ns = 0;              // steady_clock at the callback's start
+    uint32_t frames = 0;
+    uint32_t processing_ns = 0;       // Engine, downmix, compensation and I/O conversion
+    float load = 0.0f;                // processing_ns over the callback's real-time length
+    float phi_phase = 0.0f;           // Where the callback left the Φ parameters
+    float phi_depth = 0.0f;
+    float peak[2] = {0.0f, 0.0f};     // Left and right output
+    float rms[2] = {0.0f, 0.0f};
+    bool underflow = false;           // Reported by the device for this callback
+    bool overflow = false;
+    bool contended = false;           // The engine was busy elsewhere; the callback played silence
+};
+
+struct AudioHostStats {
+    uint64_t callbacks = 0;
+    uint64_t frames = 0;
+    uint64_t underflows = 0;
+    uint64_t overflows = 0;
+    uint64_t late = 0;                // Callbacks that took longer than they last
+    uint64_t contended = 0;
+    uint64_t frames_dropped = 0;      // AudioHostFrames lost to a full queue
+    uint64_t commands_dropped = 0;    // Control changes lost to a full queue
+    LatencySnapshot processing;       // Callback processing time
+};
+
+// Device info of a backend
+struct AudioDeviceInfo {
+    int index = -1;
+    std::string name;
+    std::string api;
+    unsigned max_input_channels = 0;
+    unsigned max_output_channels = 0;
+    double default_sample_rate = 0.0;
+    double default_low_latency = 0.0;  // Seconds, output side (input side for capture-only devices)
+};
+
+// Real-time audio host: opens the device and runs the whole audio path of
+// the server's AudioServer inside the native callback. Each callback takes
+// the first input channel through processChromaticBlock under the host's
+// ParameterAutomation, downmixes the chromatic channels to stereo
+// (StereoDownmix), delays them by the latency compensation
+// (FractionalDelayLine) and writes the device's interleaved output. No
+// interpreter runs on the callback thread, which neither locks, allocates
+// nor does I/O.
+//
+// Control goes in lock-free: Φ through automation() (sample-accurate, as
+// ChromaticStream), downmix weights, compensation delay and compute quality
+// through a single-producer ring the callback drains at its start; in
+// Python the GIL serializes producers. Metrics come out lock-free: an
+// AudioHostFrame per callback through a single-consumer ring (drainFrames),
+// counters and the processing time histogram (stats), and, when the
+// engine publishes its output, the latest chromatic block through its
+// OutputPublisher.
+//
+// The engine is shared with its other callers through its callMutex(): the
+// callback only try-locks it and plays a block of silence (counted as
+// contended) when another call holds it, so it never waits on one.
+class NativeAudioHost {
+public:
+    // The engine must outlive the host. Throws std::invalid_argument for a
+    // config the path cannot run (no block, channels or output channels, a
+    // max_block under block_size).
+    NativeAudioHost(AnalogCellularEngineAVX2& engine, const AudioHostConfig& config = AudioHostConfig());
+    ~NativeAudioHost();
+
+    NativeAudioHost(const NativeAudioHost&) = delete;
+    NativeAudioHost& operator=(const NativeAudioHost&) = delete;
+
+    // Opens and starts the stream. Throws std::runtime_error when the
+    // backend is not built in or the device refuses the config.
+    void start();
+    // Stops and closes the stream, after its last callback returned
+    void stop();
+    bool running() const { return running_.load(std::memory_order_acquire); }
+
+    // Control side, one producer at a time; false (and a count) when the
+    // ring is full. Weights are channels() values each; gain scales both.
+    bool setDownmix(const float* left, const float* right, float gain = 1.0f);
+    // Latency compensation in samples, clamped to [0, max_delay]
+    bool setCompensationDelay(double samples);
+    bool setComputeQuality(ComputeQuality quality);
+    ParameterAutomation& automation() { return automation_; }
+
+    // Reader side, one consumer at a time: moves up to max frames out of the
+    // queue into out, oldest first; returns how many
+    size_t drainFrames(AudioHostFrame* out, size_t max);
+    size_t pendingFrames() const;
+    AudioHostStats stats() const;
+    void resetStats();
+
+    // The callback's work on one block, for backends and tests: in holds
+    // input_channels interleaved (null for silence), out output_channels
+    void process(const float* in, float* out, size_t frames, bool underflow = false, bool overflow = false);
+
+    const AudioHostConfig& config() const { return config_; }
+    size_t channels() const { return config_.num_channels; }
+    AnalogCellularEngineAVX2& engine() const { return engine_; }
+    // Device latencies the stream reported at start(), seconds
+    double inputLatency() const { return input_latency_; }
+    double outputLatency() const { return output_latency_; }
+
+    static bool backendAvailable(AudioHostBackend backend);
+    // Devices of a backend; empty when it is not built in
+    static std::vector<AudioDeviceInfo> devices(AudioHostBackend backend);
+
+private:
+    enum class CommandKind : uint8_t { Weight, Gain, Delay, Quality };
+    struct Command {
+        CommandKind kind;
+        uint8_t side;      // Weight: 0 left, 1 right
+        uint16_t channel;  // Weight
+        float value;
+    };
+
+    bool pushCommands(const Command* commands, size_t count);
+    void applyCommands();
+    void runBlock(const float* in, float* out, size_t frames);
+    void publishFrame(const AudioHostFrame& frame);
+    void simulatedLoop();
+
+    AnalogCellularEngineAVX2& engine_;
+    AudioHostConfig config_;
+    ChromaticBlockConfig block_config_;
+    ParameterAutomation automation_;
+    StereoDownmix downmix_;
+    FractionalDelayLine delay_;
+
+    // Callback-owned scratch, sized at construction
+    std::vector<float> mono_;       // max_block
+    std::vector<float> chromatic_;  // [num_channels x max_block]
+    std::vector<float> stereo_;     // [2 x max_block]
+    std::vector<float> weights_;    // Left row, right row, as the commands left them
+    float gain_ = 1.0f;
+
+    std::vector<Command> commands_;  // Power-of-two slots
+    alignas(64) std::atomic<uint64_t> command_write_{0};
+    alignas(64) std::atomic<uint64_t> command_read_{0};
+
+    std::vector<AudioHostFrame> frames_;  // Power-of-two slots
+    alignas(64) std::atomic<uint64_t> frame_write_{0};
+    alignas(64) std::atomic<uint64_t> frame_read_{0};
+
+    alignas(64) std::atomic<uint64_t> callbacks_{0};
+    std::atomic<uint64_t> frame_count_{0};
+    std::atomic<uint64_t> underflows_{0};
+    std::atomic<uint64_t> overflows_{0};
+    std::atomic<uint64_t> late_{0};
+    std::atomic<uint64_t> contended_{0};
+    std::atomic<uint64_t> frames_dropped_{0};
+    std::atomic<uint64_t> commands_dropped_{0};
+    LatencyHistogram processing_;
+
+    std::atomic<bool> running_{false};
+    void* stream_ = nullptr;         // PaStream while a PortAudio stream is open
+    std::thread simulated_;
+    double input_latency_ = 0.0;
+    double output_latency_ = 0.0;
+};
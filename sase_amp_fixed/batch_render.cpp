@@ -0,0 +1,353 @@
+#include "batch_render.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include "analog_universal_node_engine_avx2.h"
+#include "audio_file.h"
+#include "ici_kernel.h"
+#include "output_stage.h"
+#include "session_store.h"
+
+namespace {
+
+// Result columns of the session store, in order
+enum ResultColumn {
+    ColumnPreset, ColumnInput, ColumnFrames, ColumnRenderSeconds, ColumnInputRms, ColumnOutputRms,
+    ColumnOutputPeak, ColumnIciMean, ColumnIciStd, ColumnIciMin, ColumnIciMax, ColumnCount
+};
+
+std::invalid_argument manifestError(size_t line, const std::string& reason) {
+    return std::invalid_argument("manifest line " + std::to_string(line) + ": " + reason);
+}
+
+double parseNumber(const std::string& value, size_t line, const std::string& key) {
+    char* end = nullptr;
+    const double x = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || !std::isfinite(x)) {
+        throw manifestError(line, "bad value '" + value + "' for " + key);
+    }
+    return x;
+}
+
+size_t parseCount(const std::string& value, size_t line, const std::string& key) {
+    const double x = parseNumber(value, line, key);
+    if (x < 0.0 || x != std::floor(x)) throw manifestError(line, "bad value '" + value + "' for " + key);
+    return static_cast<size_t>(x);
+}
+
+std::vector<float> parseWeights(const std::string& value, size_t line, const std::string& key) {
+    std::vector<float> weights;
+    std::istringstream list(value);
+    std::string item;
+    while (std::getline(list, item, ',')) weights.push_back(static_cast<float>(parseNumber(item, line, key)));
+    return weights;
+}
+
+// Splits key=value; throws for a token without '='
+std::pair<std::string, std::string> parseOption(const std::string& token, size_t line) {
+    const size_t eq = token.find('=');
+    if (eq == std::string::npos || eq == 0) throw manifestError(line, "expected key=value, got '" + token + "'");
+    return {token.substr(0, eq), token.substr(eq + 1)};
+}
+
+double rms(double sum_squares, uint64_t count) {
+    return count ? std::sqrt(sum_squares / static_cast<double>(count)) : 0.0;
+}
+
+// What a worker keeps from job to job
+struct RenderWorker {
+    std::unique_ptr<AnalogCellularEngineAVX2> engine;
+    std::unordered_map<size_t, std::unique_ptr<ICIKernel>> ici;  // By channel count
+    std::vector<float> in;
+    std::vector<float> out;
+    std::vector<float> mix;
+};
+
+} // namespace
+
+BatchRenderManifest BatchRenderManifest::parse(const std::string& text) {
+    BatchRenderManifest manifest;
+    std::unordered_map<std::string, size_t> presets, inputs;
+    std::vector<std::pair<size_t, std::pair<std::string, std::string>>> jobs;  // Line, preset and input names
+
+    std::istringstream lines(text);
+    std::string raw;
+    for (size_t line = 1; std::getline(lines, raw); line++) {
+        std::istringstream words(raw);
+        std::vector<std::string> tokens;
+        for (std::string word; words >> word;) tokens.push_back(word);
+        if (tokens.empty() || tokens[0][0] == '#') continue;
+
+        const std::string& kind = tokens[0];
+        if (kind == "preset") {
+            if (tokens.size() < 2) throw manifestError(line, "preset needs a name");
+            RenderPreset preset;
+            preset.name = tokens[1];
+            for (size_t t = 2; t < tokens.size(); t++) {
+                const auto option = parseOption(tokens[t], line);
+                const std::string& key = option.first;
+                if (key == "channels") {
+                    preset.num_channels = parseCount(option.second, line, key);
+                } else if (key == "phi_depth") {
+                    preset.phi_depth = parseNumber(option.second, line, key);
+                } else if (key == "phi_phase") {
+                    preset.phi_phase = parseNumber(option.second, line, key);
+                } else if (key == "feedback") {
+                    preset.feedback = parseNumber(option.second, line, key);
+                } else if (key == "input_channel") {
+                    preset.input_channel = static_cast<int>(parseNumber(option.second, line, key));
+                } else if (key == "mix_l") {
+                    preset.mix_l = parseWeights(option.second, line, key);
+                } else if (key == "mix_r") {
+                    preset.mix_r = parseWeights(option.second, line, key);
+                } else {
+                    throw manifestError(line, "unknown preset key '" + key + "'");
+                }
+            }
+            if (preset.num_channels == 0) throw manifestError(line, "preset needs at least one channel");
+            if (preset.mix_l.empty() != preset.mix_r.empty()) {
+                throw manifestError(line, "mix_l and mix_r go together");
+            }
+            if (!preset.mix_l.empty() &&
+                (preset.mix_l.size() != preset.num_channels || preset.mix_r.size() != preset.num_channels)) {
+                throw manifestError(line, "mix weights need one value per channel");
+            }
+            if (!presets.emplace(preset.name, manifest.presets.size()).second) {
+                throw manifestError(line, "duplicate preset '" + preset.name + "'");
+            }
+            manifest.presets.push_back(std::move(preset));
+        } else if (kind == "input") {
+            if (tokens.size() < 3) throw manifestError(line, "input needs a name and a path");
+            RenderInput input;
+            input.name = tokens[1];
+            input.path = tokens[2];
+            for (size_t t = 3; t < tokens.size(); t++) {
+                const auto option = parseOption(tokens[t], line);
+                if (option.first == "raw_channels") {
+                    input.raw_channels = parseCount(option.second, line, option.first);
+                } else if (option.first == "raw_rate") {
+                    input.raw_rate = parseNumber(option.second, line, option.first);
+                } else {
+                    throw manifestError(line, "unknown input key '" + option.first + "'");
+                }
+            }
+            if ((input.raw_channels == 0) != (input.raw_rate <= 0.0)) {
+                throw manifestError(line, "raw_channels and raw_rate go together");
+            }
+            if (!inputs.emplace(input.name, manifest.inputs.size()).second) {
+                throw manifestError(line, "duplicate input '" + input.name + "'");
+            }
+            manifest.inputs.push_back(std::move(input));
+        } else if (kind == "job") {
+            if (tokens.size() != 3) throw manifestError(line, "job needs a preset and an input");
+            jobs.push_back({line, {tokens[1], tokens[2]}});
+        } else {
+            throw manifestError(line, "unknown entry '" + kind + "'");
+        }
+    }
+
+    if (jobs.empty()) {
+        for (size_t p = 0; p < manifest.presets.size(); p++) {
+            for (size_t i = 0; i < manifest.inputs.size(); i++) manifest.jobs.push_back({p, i});
+        }
+        return manifest;
+    }
+    for (const auto& job : jobs) {
+        const auto preset = presets.find(job.second.first);
+        if (preset == presets.end()) throw manifestError(job.first, "unknown preset '" + job.second.first + "'");
+        const auto input = inputs.find(job.second.second);
+        if (input == inputs.end()) throw manifestError(job.first, "unknown input '" + job.second.second + "'");
+        manifest.jobs.push_back({preset->second, input->second});
+    }
+    return manifest;
+}
+
+BatchRenderManifest BatchRenderManifest::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("manifest " + path + ": cannot open");
+    std::ostringstream text;
+    text << file.rdbuf();
+    if (file.bad()) throw std::runtime_error("manifest " + path + ": read failed");
+    return parse(text.str());
+}
+
+BatchRenderStats runBatchRender(const BatchRenderManifest& manifest, const std::string& results_path,
+                                const BatchRenderConfig& config) {
+    if (config.block_size == 0) throw std::invalid_argument("block_size must be positive");
+    if (manifest.jobs.empty()) throw std::invalid_argument("manifest has no jobs");
+    for (const RenderPreset& preset : manifest.presets) {
+        if (preset.num_channels == 0) throw std::invalid_argument("preset " + preset.name + " has no channels");
+        if (config.nodes < preset.num_channels) {
+            throw std::invalid_argument("preset " + preset.name + " needs at least one node per channel");
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const size_t block = config.block_size;
+    const size_t jobs = manifest.jobs.size();
+
+    // Only inputs some job reads are opened, each once
+    std::vector<std::unique_ptr<AudioFileReader>> inputs(manifest.inputs.size());
+    for (const RenderJob& job : manifest.jobs) {
+        std::unique_ptr<AudioFileReader>& reader = inputs[job.input];
+        if (reader) continue;
+        const RenderInput& input = manifest.inputs[job.input];
+        reader = input.raw_channels
+                     ? std::make_unique<AudioFileReader>(input.path, input.raw_channels, input.raw_rate)
+                     : std::make_unique<AudioFileReader>(input.path);
+    }
+    for (const RenderJob& job : manifest.jobs) {
+        const RenderPreset& preset = manifest.presets[job.preset];
+        const size_t input_channels = inputs[job.input]->channels();
+        if (preset.input_channel >= static_cast<int>(input_channels)) {
+            throw std::invalid_argument("preset " + preset.name + " reads channel " +
+                                        std::to_string(preset.input_channel) + " of a " +
+                                        std::to_string(input_channels) + "-channel input " +
+                                        manifest.inputs[job.input].name);
+        }
+    }
+
+    auto pool = std::make_shared<WorkerPool>(config.workers);
+    std::vector<RenderWorker> workers(pool->size());
+    std::vector<double> results(ColumnCount * jobs, 0.0);
+    std::atomic<uint64_t> frames_rendered{0};
+
+    auto render = [&](size_t j, RenderWorker& worker) {
+        const auto job_start = std::chrono::steady_clock::now();
+        const RenderPreset& preset = manifest.presets[manifest.jobs[j].preset];
+        const AudioFileReader& input = *inputs[manifest.jobs[j].input];
+        const size_t channels = preset.num_channels;
+        const uint64_t frames = input.frames();
+
+        if (!worker.engine) {
+            worker.engine = std::make_unique<AnalogCellularEngineAVX2>(config.nodes);
+            worker.engine->shareWorkerPool(pool);
+        }
+        // Node state back to a fresh engine's, parameters to the preset's
+        AnalogCellularEngineAVX2& engine = *worker.engine;
+        engine.bank.resetState();
+        const double feedback = std::max(-2.0, std::min(2.0, preset.feedback));
+        std::fill(engine.bank.feedback_gain, engine.bank.feedback_gain + engine.bank.size(), feedback);
+
+        ICIKernel* kernel = nullptr;
+        if (config.ici && channels >= 2) {
+            std::unique_ptr<ICIKernel>& cached = worker.ici[channels];
+            if (!cached) cached = std::make_unique<ICIKernel>(channels, block);
+            kernel = cached.get();
+        }
+        std::unique_ptr<StereoDownmix> downmix;
+        if (!preset.mix_l.empty()) {
+            downmix = std::make_unique<StereoDownmix>(channels);
+            downmix->setWeights(preset.mix_l.data(), preset.mix_r.data());
+        }
+        const size_t rendered_channels = downmix ? 2 : channels;
+        std::unique_ptr<AudioFileWriter> output;
+        if (!config.render_dir.empty()) {
+            output = std::make_unique<AudioFileWriter>(
+                config.render_dir + "/" + preset.name + "__" + manifest.inputs[manifest.jobs[j].input].name + ".wav",
+                rendered_channels, input.sampleRate(), frames);
+        }
+
+        ChromaticBlockConfig chroma;
+        chroma.num_channels = channels;
+        chroma.node_stride = config.nodes / channels;
+        chroma.sample_rate = input.sampleRate();
+        chroma.phi_phase = preset.phi_phase;
+        chroma.phi_depth = preset.phi_depth;
+
+        worker.in.resize(block);
+        worker.out.resize(channels * block);
+        worker.mix.resize(2 * block);
+        double input_squares = 0.0, output_squares = 0.0, output_peak = 0.0;
+        double ici_sum = 0.0, ici_squares = 0.0;
+        double ici_min = std::numeric_limits<double>::infinity();
+        double ici_max = -std::numeric_limits<double>::infinity();
+        uint64_t ici_blocks = 0;
+        for (uint64_t first = 0; first < frames; first += block) {
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(block, frames - first));
+            float* in = worker.in.data();
+            float* out = worker.out.data();
+            input.read(preset.input_channel, first, n, in);
+            engine.processChromaticBlock(in, n, chroma, out);
+
+            const float* rendered = out;
+            if (downmix) {
+                downmix->process(out, n, n, worker.mix.data(), worker.mix.data() + n);
+                rendered = worker.mix.data();
+            }
+            if (output) output->write(first, rendered, n);
+            for (size_t t = 0; t < n; t++) input_squares += static_cast<double>(in[t]) * in[t];
+            for (size_t k = 0; k < rendered_channels * n; k++) {
+                output_squares += static_cast<double>(rendered[k]) * rendered[k];
+                output_peak = std::max(output_peak, static_cast<double>(std::fabs(rendered[k])));
+            }
+            if (kernel) {
+                if (n < block) {
+                    // Channel-major rows of n samples spread to rows of block, zero padded
+                    for (size_t c = channels; c-- > 0;) {
+                        std::copy_backward(out + c * n, out + (c + 1) * n, out + c * block + n);
+                        std::fill(out + c * block + n, out + (c + 1) * block, 0.0f);
+                    }
+                }
+                const double ici = kernel->process(out);
+                ici_sum += ici;
+                ici_squares += ici * ici;
+                ici_min = std::min(ici_min, ici);
+                ici_max = std::max(ici_max, ici);
+                ici_blocks++;
+            }
+        }
+        if (output) output->flush();
+
+        auto column = [&](ResultColumn c) -> double& { return results[c * jobs + j]; };
+        column(ColumnPreset) = static_cast<double>(manifest.jobs[j].preset);
+        column(ColumnInput) = static_cast<double>(manifest.jobs[j].input);
+        column(ColumnFrames) = static_cast<double>(frames);
+        column(ColumnInputRms) = rms(input_squares, frames);
+        column(ColumnOutputRms) = rms(output_squares, frames * rendered_channels);
+        column(ColumnOutputPeak) = output_peak;
+        if (ici_blocks) {
+            const double mean = ici_sum / static_cast<double>(ici_blocks);
+            column(ColumnIciMean) = mean;
+            column(ColumnIciStd) = std::sqrt(std::max(0.0, ici_squares / static_cast<double>(ici_blocks) - mean * mean));
+            column(ColumnIciMin) = ici_min;
+            column(ColumnIciMax) = ici_max;
+        }
+        column(ColumnRenderSeconds) =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - job_start).count();
+        frames_rendered += frames;
+    };
+
+    if (jobs < pool->size()) {
+        for (size_t j = 0; j < jobs; j++) render(j, workers[0]);
+    } else {
+        pool->parallelFor(jobs, 1, [&](size_t first, size_t last, unsigned worker) {
+            for (size_t j = first; j < last; j++) render(j, workers[worker]);
+        });
+    }
+
+    std::vector<std::string> names = {"preset", "input", "frames", "render_seconds", "input_rms", "output_rms",
+                                      "output_peak", "ici_mean", "ici_std", "ici_min", "ici_max"};
+    if (!config.ici) names.resize(ColumnIciMean);
+
+    BatchRenderStats stats;
+    stats.jobs = jobs;
+    stats.threads = pool->size();
+    stats.frames = frames_rendered;
+    for (const RenderJob& job : manifest.jobs) stats.audio_seconds += inputs[job.input]->duration();
+    writeSessionStore(results_path, names, results.data(), jobs, stats.audio_seconds);
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (stats.seconds > 0.0) {
+        stats.jobs_per_second = static_cast<double>(jobs) / stats.seconds;
+        stats.realtime_factor = stats.audio_seconds / stats.seconds;
+    }
+    return stats;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "worker_pool.h"
+
+// One set of render parameters. mix_l / mix_r, when given, downmix the
+// num_channels chromatic outputs to stereo (one weight per channel, as the
+// server's DownmixState); without them a render keeps every channel.
+struct RenderPreset {
+    std::string name;
+    size_t num_channels = 8;
+    double phi_depth = 0.5;
+    double phi_phase = 0.0;
+    double feedback = 0.0;       // Feedback gain of every node, clamped to [-2, 2]
+    int input_channel = -1;      // Input channel fed to the engine; negative mixes all down
+    std::vector<float> mix_l;
+    std::vector<float> mix_r;
+};
+
+// A recording: a WAV file, or headerless interleaved float32 when
+// raw_channels and raw_rate are set
+struct RenderInput {
+    std::string name;
+    std::string path;
+    size_t raw_channels = 0;
+    double raw_rate = 0.0;
+};
+
+// Indices into BatchRenderManifest::presets and ::inputs
+struct RenderJob {
+    size_t preset = 0;
+    size_t input = 0;
+};
+
+// A batch of renders, read from a text manifest of one entry per line:
+//
+//   preset NAME [channels=N] [phi_depth=D] [phi_phase=P] [feedback=F]
+//               [input_channel=C] [mix_l=W,W,...] [mix_r=W,W,...]
+//   input NAME PATH [raw_channels=N raw_rate=HZ]
+//   job PRESET INPUT
+//
+// Blank lines and lines starting with '#' are skipped. Names are single
+// words and unique within their kind; a job refers to them by name and may
+// come before either is declared. A manifest with no job lines renders
+// every preset over every input.
+struct BatchRenderManifest {
+    std::vector<RenderPreset> presets;
+    std::vector<RenderInput> inputs;
+    std::vector<RenderJob> jobs;
+
+    // Throws std::invalid_argument naming the line for a malformed entry,
+    // an unknown key, a duplicate or unknown name, or mix weights whose
+    // count differs from the preset's channels; std::runtime_error when
+    // the file cannot be read.
+    static BatchRenderManifest parse(const std::string& text);
+    static BatchRenderManifest load(const std::string& path);
+};
+
+struct BatchRenderConfig {
+    size_t nodes = 1024;
+    size_t block_size = 512;
+    bool ici = true;             // ICI statistics of every job (presets of 2+ channels)
+    std::string render_dir;      // Rendered audio as PRESET__INPUT.wav here; empty for metrics only
+    WorkerPoolConfig workers;
+};
+
+struct BatchRenderStats {
+    size_t jobs = 0;
+    unsigned threads = 0;
+    uint64_t frames = 0;           // Input frames rendered, over every job
+    double audio_seconds = 0.0;    // Input audio rendered, over every job
+    double seconds = 0.0;          // Wall time of the batch
+    double jobs_per_second = 0.0;
+    double realtime_factor = 0.0;  // Audio rendered over wall time
+};
+
+// Renders every job of the manifest offline, the way runOfflineReplay
+// renders one recording sequentially: block by block through
+// processChromaticBlock from the memory-mapped input, then the preset's
+// downmix.
+//
+// Jobs are the unit of parallelism. Each worker of one pool claims the next
+// unclaimed job when it finishes its last, so the batch keeps every core
+// busy however unequal the jobs are, and nothing is queued up front: memory
+// is the manifest, the mapped inputs (each opened once and shared by every
+// job reading it) and per worker one engine, one ICIKernel per channel
+// count and a block of buffers, whatever the number of jobs. Engines and
+// FFT plans are kept from job to job: a job resets its engine's node state
+// and parameters rather than building one, so a job renders exactly what a
+// fresh engine would. A batch of fewer jobs than workers runs them one
+// after another with each engine spread over the pool.
+//
+// One row per job, in manifest order, goes to the session store at
+// results_path (session_store.h), columns preset and input (manifest
+// indices), frames, render_seconds, input_rms, output_rms, output_peak
+// and, with ici, ici_mean, ici_std, ici_min and ici_max over the job's
+// blocks (0 for a preset of one channel). The Python session tools open it
+// in place.
+//
+// Throws std::invalid_argument for an empty block, a manifest with no
+// jobs, or a preset with no channels or more channels than nodes, and
+// std::runtime_error for I/O errors; the first failing job's error is
+// rethrown after the batch stops.
+BatchRenderStats runBatchRender(const BatchRenderManifest& manifest, const std::string& results_path,
+                                const BatchRenderConfig& config);
@@ -0,0 +1,103 @@
+#include "block_stats.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+void BlockStatsCollector::configure(bool enabled, size_t histogram_bins, double low, double high) {
+    if (histogram_bins > 0 && !(std::isfinite(low) && std::isfinite(high) && high > low)) {
+        throw std::invalid_argument("block stats histogram needs a finite range with high > low");
+    }
+    enabled_ = enabled;
+    bins_ = enabled ? histogram_bins : 0;
+    low_ = low;
+    high_ = high;
+    workers_ = 0;
+    partials_.clear();
+    histograms_.clear();
+    stats_ = BlockStats();
+    stats_.histogram.assign(bins_, 0);
+    stats_.histogram_low = bins_ > 0 ? low : 0.0;
+    stats_.histogram_high = bins_ > 0 ? high : 0.0;
+}
+
+void BlockStatsCollector::begin(size_t workers) {
+    if (!enabled_) return;
+    if (workers > partials_.size()) {
+        partials_.resize(workers);
+        histograms_.resize(workers * bins_);
+    }
+    workers_ = workers;
+    channels_ = 0;
+    std::fill(histograms_.begin(), histograms_.begin() + workers * bins_, 0);
+    for (size_t w = 0; w < workers; w++) {
+        BlockStatsPartial& p = partials_[w];
+        p = BlockStatsPartial();
+        if (bins_ > 0) {
+            p.histogram = histograms_.data() + w * bins_;
+            p.bins = bins_;
+            p.low = low_;
+            p.scale = static_cast<double>(bins_) / (high_ - low_);
+        }
+    }
+}
+
+void BlockStatsCollector::beginChannels(size_t channels) {
+    channels_ = channels;
+    if (channel_sums_.size() < channels) {
+        channel_sums_.resize(channels);
+        channel_squares_.resize(channels);
+        channel_peaks_.resize(channels);
+    }
+    std::fill(channel_sums_.begin(), channel_sums_.begin() + channels, 0.0);
+    std::fill(channel_squares_.begin(), channel_squares_.begin() + channels, 0.0);
+    std::fill(channel_peaks_.begin(), channel_peaks_.begin() + channels, 0.0);
+}
+
+void BlockStatsCollector::finish() {
+    if (!enabled_) return;
+    BlockStatsPartial total;
+    for (size_t w = 0; w < workers_; w++) {
+        const BlockStatsPartial& p = partials_[w];
+        total.count += p.count;
+        total.sum += p.sum;
+        total.sum_squares += p.sum_squares;
+        total.min = std::min(total.min, p.min);
+        total.max = std::max(total.max, p.max);
+    }
+
+    BlockStats& s = stats_;
+    s.count = total.count;
+    if (total.count > 0) {
+        const double n = static_cast<double>(total.count);
+        s.mean = total.sum / n;
+        const double mean_square = total.sum_squares / n;
+        s.variance = std::max(0.0, mean_square - s.mean * s.mean);
+        s.rms = std::sqrt(mean_square);
+        s.min = total.min;
+        s.max = total.max;
+        s.peak = std::max(std::fabs(total.min), std::fabs(total.max));
+    } else {
+        s.mean = s.variance = s.rms = s.peak = s.min = s.max = 0.0;
+    }
+    std::fill(s.histogram.begin(), s.histogram.end(), 0);
+    for (size_t w = 0; w < workers_; w++) {
+        const uint64_t* h = histograms_.data() + w * bins_;
+        for (size_t b = 0; b < bins_; b++) s.histogram[b] += h[b];
+    }
+
+    s.channel_mean.resize(channels_);
+    s.channel_rms.resize(channels_);
+    s.channel_peak.resize(channels_);
+    const double per_channel = channels_ > 0 ? static_cast<double>(total.count) / channels_ : 0.0;
+    for (size_t c = 0; c < channels_; c++) {
+        s.channel_mean[c] = per_channel > 0 ? channel_sums_[c] / per_channel : 0.0;
+        s.channel_rms[c] = per_channel > 0 ? std::sqrt(channel_squares_[c] / per_channel) : 0.0;
+        s.channel_peak[c] = channel_peaks_[c];
+    }
+}
+
+void BlockStatsCollector::clear() {
+    workers_ = 0;
+    channels_ = 0;
+    finish();
+}
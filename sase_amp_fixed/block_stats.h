@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Running statistics of node outputs for one worker's share of a block.
+// The block kernels keep per-lane sums, squares and extremes in registers
+// for the whole block and fold the real nodes' lanes in here once per
+// chunk; values only go through bin() one by one when a histogram is kept.
+struct BlockStatsPartial {
+    uint64_t count = 0;
+    double sum = 0.0;
+    double sum_squares = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    // Coarse histogram, null for none: bins counts from low up in steps of
+    // 1 / scale, values outside falling into the end bins
+    uint64_t* histogram = nullptr;
+    size_t bins = 0;
+    double low = 0.0;
+    double scale = 0.0;
+
+    void bin(double value) {
+        const double at = (value - low) * scale;
+        size_t k = 0;
+        if (at >= static_cast<double>(bins)) {
+            k = bins - 1;
+        } else if (at > 0.0) {
+            k = static_cast<size_t>(at);
+        }
+        histogram[k]++;
+    }
+};
+
+// Statistics of every output of the last block
+struct BlockStats {
+    uint64_t count = 0;            // Outputs counted: nodes (or channels) x samples
+    double mean = 0.0;
+    double variance = 0.0;         // Population variance
+    double rms = 0.0;
+    double peak = 0.0;             // Largest magnitude
+    double min = 0.0;
+    double max = 0.0;
+    // Counts over [histogram_low, histogram_high), end bins catching the rest
+    std::vector<uint64_t> histogram;
+    double histogram_low = 0.0;
+    double histogram_high = 0.0;
+    // Per channel, chromatic blocks only
+    std::vector<double> channel_mean;
+    std::vector<double> channel_rms;
+    std::vector<double> channel_peak;
+};
+
+// One partial per worker of a pool, merged into a BlockStats at block end.
+// Storage is kept across blocks, so steady-state blocks allocate nothing.
+class BlockStatsCollector {
+public:
+    // Throws std::invalid_argument for histogram bins over an empty or
+    // non-finite range
+    void configure(bool enabled, size_t histogram_bins, double low, double high);
+    bool enabled() const { return enabled_; }
+    size_t histogramBins() const { return bins_; }
+
+    // Clears the partials for a block run by workers workers
+    void begin(size_t workers);
+    // Partial of a worker id in [0, workers), null while disabled
+    BlockStatsPartial* partial(size_t worker) { return enabled_ ? &partials_[worker] : nullptr; }
+    // Merges the partials into stats()
+    void finish();
+    // No block counted, e.g. one run on the Cuda backend
+    void clear();
+
+    // Per-channel sums of a chromatic block of channels channels, filled by
+    // the caller between begin() and finish()
+    void beginChannels(size_t channels);
+    double* channelSums() { return channel_sums_.data(); }
+    double* channelSquares() { return channel_squares_.data(); }
+    double* channelPeaks() { return channel_peaks_.data(); }
+
+    const BlockStats& stats() const { return stats_; }
+
+private:
+    bool enabled_ = false;
+    size_t bins_ = 0;
+    double low_ = 0.0;
+    double high_ = 0.0;
+    size_t workers_ = 0;
+    size_t channels_ = 0;
+    std::vector<BlockStatsPartial> partials_;
+    std::vector<uint64_t> histograms_;   // [worker x bins]
+    std::vector<double> channel_sums_;
+    std::vector<double> channel_squares_;
+    std::vector<double> channel_peaks_;
+    BlockStats stats_;
+};
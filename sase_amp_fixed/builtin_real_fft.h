@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+// Header-only real FFT of any size, double precision, with no dependency
+// beyond the standard library; the engine's FFT backend of last resort.
+//
+// An even size N runs as a complex transform of N / 2 points over the
+// samples packed pairwise (x[2t] + i x[2t + 1]) and a split pass; an odd
+// size runs as a complex transform of N points. Complex transforms of a
+// power-of-two length are iterative radix 2, any other length goes through
+// Bluestein's chirp z-transform on a power-of-two convolution of at least
+// 2 M - 1 points, so every size costs O(N log N), a non-power of two a few
+// times a power of two's. Tables are built by the constructor; transforms
+// are const and may run from several threads at once (the scratch is per
+// thread).
+//
+// Layouts match FFTW's r2c / c2r: the spectrum is bins 0 to N / 2 as
+// interleaved re, im, both directions unnormalized, so
+// inverse(forward(x)) = N x.
+class BuiltinRealFFT {
+public:
+    using Complex = std::complex<double>;
+
+    explicit BuiltinRealFFT(size_t size) : size_(size) {
+        if (size == 0) throw std::invalid_argument("FFT size must be positive");
+        if (size % 2 == 0) {
+            complex_ = ComplexTransform(size / 2);
+            twiddle_.resize(size / 2 + 1);
+            for (size_t k = 0; k <= size / 2; k++) twiddle_[k] = unitRoot(k, size);
+        } else {
+            complex_ = ComplexTransform(size);
+        }
+    }
+
+    size_t size() const { return size_; }
+    size_t bins() const { return size_ / 2 + 1; }
+
+    // size samples -> bins() bins as 2 bins() doubles
+    void forward(const double* in, double* out) const {
+        Complex* spectrum = reinterpret_cast<Complex*>(out);
+        if (size_ % 2 != 0) {
+            Complex* a = scratch(size_);
+            for (size_t t = 0; t < size_; t++) a[t] = Complex(in[t], 0.0);
+            complex_.forward(a, a + size_);
+            for (size_t k = 0; k < bins(); k++) spectrum[k] = a[k];
+            return;
+        }
+        const size_t m = size_ / 2;
+        Complex* z = scratch(m);
+        for (size_t t = 0; t < m; t++) z[t] = Complex(in[2 * t], in[2 * t + 1]);
+        complex_.forward(z, z + m);
+        // X[k] = E[k] + W^k O[k] with E, O the spectra of the even and odd
+        // samples: E = (Z[k] + Z*[m - k]) / 2, O = (Z[k] - Z*[m - k]) / 2i
+        for (size_t k = 0; k <= m; k++) {
+            const Complex a = z[k % m];
+            const Complex b = std::conj(z[(m - k) % m]);
+            const Complex even = 0.5 * (a + b);
+            const Complex odd = Complex(0.0, -0.5) * (a - b);
+            spectrum[k] = even + twiddle_[k] * odd;
+        }
+    }
+
+    // bins() bins as 2 bins() doubles -> size samples; the imaginary parts
+    // of bin 0 (and of bin N / 2 for even N) are ignored
+    void inverse(const double* in, double* out) const {
+        const Complex* spectrum = reinterpret_cast<const Complex*>(in);
+        if (size_ % 2 != 0) {
+            // x = Re DFT(conj X) over the full Hermitian spectrum
+            Complex* a = scratch(size_);
+            a[0] = Complex(spectrum[0].real(), 0.0);
+            for (size_t k = 1; k < bins(); k++) {
+                a[k] = std::conj(spectrum[k]);
+                a[size_ - k] = spectrum[k];
+            }
+            complex_.forward(a, a + size_);
+            for (size_t t = 0; t < size_; t++) out[t] = a[t].real();
+            return;
+        }
+        const size_t m = size_ / 2;
+        Complex* z = scratch(m);
+        // Z[k] = E[k] + i O[k] at twice the scale, so the unnormalized
+        // inverse of m points yields N x
+        for (size_t k = 0; k < m; k++) {
+            const Complex a = k == 0 ? Complex(spectrum[0].real(), 0.0) : spectrum[k];
+            const Complex b = k == 0 ? Complex(spectrum[m].real(), 0.0) : std::conj(spectrum[m - k]);
+            const Complex even = a + b;
+            const Complex odd = (a - b) * std::conj(twiddle_[k]);
+            z[k] = std::conj(even + Complex(0.0, 1.0) * odd);
+        }
+        // Inverse as conj(forward(conj(Z)))
+        complex_.forward(z, z + m);
+        for (size_t t = 0; t < m; t++) {
+            out[2 * t] = z[t].real();
+            out[2 * t + 1] = -z[t].imag();
+        }
+    }
+
+private:
+    static Complex unitRoot(uint64_t k, uint64_t n) {
+        const double angle = -2.0 * M_PI * static_cast<double>(k) / static_cast<double>(n);
+        return Complex(std::cos(angle), std::sin(angle));
+    }
+
+    // Forward complex DFT of m points, in place
+    class ComplexTransform {
+    public:
+        ComplexTransform() = default;
+        explicit ComplexTransform(size_t m) : m_(m) {
+            length_ = 1;
+            while (length_ < m) length_ <<= 1;
+            if (length_ != m) {
+                // Bluestein: X[k] = c[k] sum_t (x[t] c[t]) conj(c[k - t]),
+                // c[t] = exp(-i pi t^2 / m); the circular convolution runs
+                // over length_ >= 2 m - 1 points
+                while (length_ < 2 * m - 1) length_ <<= 1;
+                chirp_.resize(m);
+                for (size_t t = 0; t < m; t++) {
+                    // t^2 mod 2m keeps the angle exact for large t
+                    const uint64_t phase = (static_cast<uint64_t>(t) * t) % (2 * static_cast<uint64_t>(m));
+                    const double angle = -M_PI * static_cast<double>(phase) / static_cast<double>(m);
+                    chirp_[t] = Complex(std::cos(angle), std::sin(angle));
+                }
+            }
+            twiddle_.resize(length_ / 2);
+            for (size_t k = 0; k < length_ / 2; k++) twiddle_[k] = unitRoot(k, length_);
+            if (!chirp_.empty()) {
+                // Spectrum of the conjugate chirp, 1 / length_ folded in
+                kernel_.assign(length_, Complex(0.0, 0.0));
+                kernel_[0] = std::conj(chirp_[0]);
+                for (size_t t = 1; t < m; t++) kernel_[t] = kernel_[length_ - t] = std::conj(chirp_[t]);
+                radix2(kernel_.data(), false);
+                const double scale = 1.0 / static_cast<double>(length_);
+                for (Complex& v : kernel_) v *= scale;
+            }
+        }
+
+        // Scratch needed by forward() past the data
+        size_t scratchSize() const { return chirp_.empty() ? 0 : length_; }
+
+        void forward(Complex* a, Complex* scratch) const {
+            if (chirp_.empty()) {
+                radix2(a, false);
+                return;
+            }
+            for (size_t t = 0; t < m_; t++) scratch[t] = a[t] * chirp_[t];
+            for (size_t t = m_; t < length_; t++) scratch[t] = Complex(0.0, 0.0);
+            radix2(scratch, false);
+            for (size_t k = 0; k < length_; k++) scratch[k] *= kernel_[k];
+            radix2(scratch, true);
+            for (size_t k = 0; k < m_; k++) a[k] = scratch[k] * chirp_[k];
+        }
+
+    private:
+        // Unnormalized radix-2 DIT transform of length_ points, in place
+        void radix2(Complex* a, bool inverse) const {
+            const size_t n = length_;
+            for (size_t i = 1, j = 0; i < n; i++) {
+                size_t bit = n >> 1;
+                for (; j & bit; bit >>= 1) j ^= bit;
+                j ^= bit;
+                if (i < j) std::swap(a[i], a[j]);
+            }
+            for (size_t len = 2; len <= n; len <<= 1) {
+                const size_t half = len / 2;
+                const size_t step = n / len;
+                for (size_t start = 0; start < n; start += len) {
+                    for (size_t k = 0; k < half; k++) {
+                        const Complex w = inverse ? std::conj(twiddle_[k * step]) : twiddle_[k * step];
+                        const Complex u = a[start + k];
+                        const Complex v = a[start + k + half] * w;
+                        a[start + k] = u + v;
+                        a[start + k + half] = u - v;
+                    }
+                }
+            }
+        }
+
+        size_t m_ = 0;
+        size_t length_ = 0;
+        std::vector<Complex> twiddle_;  // exp(-2 pi i k / length_), k < length_ / 2
+        std::vector<Complex> chirp_;    // Bluestein only
+        std::vector<Complex> kernel_;
+    };
+
+    // Per-thread scratch of data points plus the complex transform's own
+    Complex* scratch(size_t points) const {
+        thread_local std::vector<Complex> buffer;
+        const size_t needed = points + complex_.scratchSize();
+        if (buffer.size() < needed) buffer.resize(needed);
+        return buffer.data();
+    }
+
+    size_t size_;
+    ComplexTransform complex_;
+    std::vector<Complex> twiddle_;  // exp(-2 pi i k / N), k <= N / 2 (even N)
+};
@@ -0,0 +1,257 @@
+#include "chroma_analyzer.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+ChromaAnalyzer::ChromaAnalyzer(const ChromaConfig& config) : config_(config) {
+    if (config_.channels == 0) {
+        throw std::invalid_argument("chroma analysis needs at least one channel");
+    }
+    if (config_.hop_size < 1) {
+        throw std::invalid_argument("hop_size must be at least 1");
+    }
+    if (!(config_.sample_rate > 0.0) || !(config_.min_frequency > 0.0) || !(config_.tuning > 0.0)) {
+        throw std::invalid_argument("sample rate, minimum frequency and tuning must be positive");
+    }
+    if (config_.octaves < 1 || config_.bins_per_semitone < 1) {
+        throw std::invalid_argument("octaves and bins_per_semitone must be at least 1");
+    }
+
+    // Bins of the top octave around each semitone from the note nearest
+    // min_frequency, bin s r + j detuned by (j - (r - 1) / 2) / r semitones
+    const int r = config_.bins_per_semitone;
+    const size_t per_octave = binsPerOctave();
+    const long semitones = std::lround(12.0 * std::log2(config_.min_frequency / config_.tuning));
+    const double base = config_.tuning * std::exp2(semitones / 12.0);
+    const int base_class = static_cast<int>(((semitones + 9) % 12 + 12) % 12);  // A4 is pitch class 9
+    const double top = base * std::exp2(config_.octaves - 1);
+
+    frequencies_.resize(binCount());
+    pitch_class_.resize(per_octave);
+    for (size_t k = 0; k < per_octave; k++) {
+        const int s = static_cast<int>(k) / r;
+        const int j = static_cast<int>(k) % r;
+        const double f = top * std::exp2((s + (j - 0.5 * (r - 1)) / r) / 12.0);
+        pitch_class_[k] = (base_class + s) % kPitchClasses;
+        for (int o = 0; o < config_.octaves; o++) {
+            frequencies_[(config_.octaves - 1 - o) * per_octave + k] = f / std::exp2(o);
+        }
+    }
+    // Each decimation stage must pass the next octave down below a quarter
+    // of its rate, with room for the transition band
+    if (frequencies_.back() > 0.4 * config_.sample_rate) {
+        throw std::invalid_argument("top octave reaches past 0.4 sample_rate; lower min_frequency or octaves");
+    }
+
+    buildKernels();
+
+    streams_.resize(config_.channels * config_.octaves);
+    spectrum_.assign(config_.channels * binCount(), 0.0);
+    chroma_.assign(config_.channels * kPitchClasses, 0.0);
+    reset();
+}
+
+void ChromaAnalyzer::buildKernels() {
+    const size_t per_octave = binsPerOctave();
+    const double fs = config_.sample_rate;
+    const double q = 1.0 / (std::exp2(1.0 / per_octave) - 1.0);
+    const double* top = frequencies_.data() + (config_.octaves - 1) * per_octave;
+
+    kernel_span_ = static_cast<size_t>(std::ceil(q * fs / top[0]));
+    fft_size_ = 16;
+    while (static_cast<size_t>(fft_size_) < kernel_span_) fft_size_ *= 2;
+    const int N = fft_size_;
+    const size_t bins = static_cast<size_t>(N / 2 + 1);
+    plan_ = &plans_.acquire(N);
+
+    // Spectrum of each temporal kernel, a Hann-windowed exponential ending
+    // with the frame and scaled for a sinusoid's amplitude, from its real
+    // and imaginary parts' transforms: T = A + i B
+    std::vector<double> re(bins), im(bins), magnitude(bins);
+    kernels_.resize(per_octave);
+    for (size_t k = 0; k < per_octave; k++) {
+        const size_t span = static_cast<size_t>(std::ceil(q * fs / top[k]));
+        const size_t start = static_cast<size_t>(N) - span;
+        const double w = 2.0 * M_PI * top[k] / fs;
+        const double gain = 2.0 / (0.5 * span);  // Hann sums to span / 2
+
+        for (int part = 0; part < 2; part++) {
+            std::fill(plan_->real, plan_->real + N, 0.0);
+            for (size_t m = 0; m < span; m++) {
+                const double hann = 0.5 - 0.5 * std::cos(2.0 * M_PI * m / span);
+                const double phase = w * m;
+                plan_->real[start + m] = gain * hann * (part == 0 ? std::cos(phase) : std::sin(phase));
+            }
+            plan_->forward();
+            for (size_t j = 0; j < bins; j++) {
+                if (part == 0) {
+                    re[j] = plan_->spectrum[j][0];
+                    im[j] = plan_->spectrum[j][1];
+                } else {
+                    re[j] -= plan_->spectrum[j][1];
+                    im[j] += plan_->spectrum[j][0];
+                }
+            }
+        }
+
+        double peak = 0.0;
+        for (size_t j = 0; j < bins; j++) {
+            magnitude[j] = std::hypot(re[j], im[j]);
+            peak = std::max(peak, magnitude[j]);
+        }
+        size_t first = 0, last = bins - 1;
+        while (first < last && magnitude[first] < config_.kernel_threshold * peak) first++;
+        while (last > first && magnitude[last] < config_.kernel_threshold * peak) last--;
+
+        // By Parseval, X_cq = 1/N sum over bins of X conj(T); the negative
+        // frequencies' share is below the threshold for a real stream
+        Kernel& kernel = kernels_[k];
+        kernel.first = first;
+        kernel.re.resize(last - first + 1);
+        kernel.im.resize(last - first + 1);
+        for (size_t j = first; j <= last; j++) {
+            kernel.re[j - first] = re[j] / N;
+            kernel.im[j - first] = -im[j] / N;
+        }
+    }
+
+    // Blackman-windowed sinc at a quarter of the stage's rate. The next
+    // octave ends at most 0.2 of it and anything aliasing onto that band
+    // starts at 0.5 minus its top, so the taps follow that transition width.
+    const double pass = frequencies_.back() / (2.0 * fs);
+    const size_t taps = std::max<size_t>(15, static_cast<size_t>(std::ceil(5.5 / (0.5 - 2.0 * pass))) | 1);
+    halfband_.resize(taps);
+    const double mid = 0.5 * (taps - 1);
+    double sum = 0.0;
+    for (size_t n = 0; n < taps; n++) {
+        const double x = n - mid;
+        const double sinc = x == 0.0 ? 1.0 : std::sin(0.5 * M_PI * x) / (0.5 * M_PI * x);
+        const double blackman = 0.42 - 0.5 * std::cos(2.0 * M_PI * n / (taps - 1)) +
+                                0.08 * std::cos(4.0 * M_PI * n / (taps - 1));
+        halfband_[n] = sinc * blackman;
+        sum += halfband_[n];
+    }
+    for (double& h : halfband_) h /= sum;
+}
+
+void ChromaAnalyzer::reset() {
+    for (size_t i = 0; i < streams_.size(); i++) {
+        OctaveStream& stream = streams_[i];
+        stream.frame.assign(2 * static_cast<size_t>(fft_size_), 0.0);
+        stream.frame_pos = 0;
+        stream.filter.assign(2 * halfband_.size(), 0.0);
+        stream.filter_pos = 0;
+        stream.keep = false;
+    }
+    std::fill(spectrum_.begin(), spectrum_.end(), 0.0);
+    std::fill(chroma_.begin(), chroma_.end(), 0.0);
+    fill_ = 0;
+    hops_ = 0;
+}
+
+void ChromaAnalyzer::push(size_t channel, int octave, double x) {
+    const size_t N = static_cast<size_t>(fft_size_);
+    const size_t taps = halfband_.size();
+    const int octaves = config_.octaves;
+    for (int o = octave; o < octaves; o++) {
+        OctaveStream& stream = streams_[channel * octaves + o];
+        stream.frame[stream.frame_pos] = x;
+        stream.frame[stream.frame_pos + N] = x;
+        stream.frame_pos = stream.frame_pos + 1 == N ? 0 : stream.frame_pos + 1;
+        if (o + 1 == octaves) return;
+
+        stream.filter[stream.filter_pos] = x;
+        stream.filter[stream.filter_pos + taps] = x;
+        stream.filter_pos = stream.filter_pos + 1 == taps ? 0 : stream.filter_pos + 1;
+        stream.keep = !stream.keep;
+        if (!stream.keep) return;
+
+        // The taps are symmetric, so the window's order does not matter
+        const double* window = stream.filter.data() + stream.filter_pos;
+        double y = 0.0;
+        for (size_t n = 0; n < taps; n++) y += window[n] * halfband_[n];
+        x = y;
+    }
+}
+
+size_t ChromaAnalyzer::process(const float* in, size_t stride, size_t n, double* frames, size_t max_frames) {
+    const size_t H = static_cast<size_t>(config_.hop_size);
+    const size_t frame_size = config_.channels * kPitchClasses;
+    size_t done = 0, completed = 0;
+    while (done < n) {
+        const size_t chunk = std::min(H - fill_, n - done);
+        for (size_t c = 0; c < config_.channels; c++) {
+            const float* x = in + c * stride + done;
+            for (size_t j = 0; j < chunk; j++) push(c, 0, static_cast<double>(x[j]));
+        }
+        fill_ += chunk;
+        done += chunk;
+        if (fill_ == H) {
+            analyzeHop();
+            fill_ = 0;
+            if (completed < max_frames) {
+                std::copy(chroma_.begin(), chroma_.end(), frames + completed * frame_size);
+            }
+            completed++;
+        }
+    }
+    return completed;
+}
+
+void ChromaAnalyzer::analyzeHop() {
+    // Octave o > 0 on the hops with o - 1 trailing one bits, every 2^o hops
+    int lower = 1;
+    for (uint64_t h = hops_; h & 1; h >>= 1) lower++;
+
+    const size_t per_octave = binsPerOctave();
+    const size_t bins = binCount();
+    for (size_t c = 0; c < config_.channels; c++) {
+        analyzeOctave(c, 0);
+        if (lower < config_.octaves) analyzeOctave(c, lower);
+
+        const double* magnitude = spectrum_.data() + c * bins;
+        double* chroma = chroma_.data() + c * kPitchClasses;
+        std::fill(chroma, chroma + kPitchClasses, 0.0);
+        for (size_t b = 0; b < bins; b++) {
+            chroma[pitch_class_[b % per_octave]] += magnitude[b] * magnitude[b];
+        }
+        if (config_.normalize) {
+            const double peak = *std::max_element(chroma, chroma + kPitchClasses);
+            if (peak > 0.0) {
+                for (int p = 0; p < kPitchClasses; p++) chroma[p] /= peak;
+            }
+        }
+    }
+    hops_++;
+}
+
+void ChromaAnalyzer::analyzeOctave(size_t channel, int octave) {
+    const size_t N = static_cast<size_t>(fft_size_);
+    const OctaveStream& stream = streams_[channel * config_.octaves + octave];
+    std::copy(stream.frame.begin() + stream.frame_pos, stream.frame.begin() + stream.frame_pos + N, plan_->real);
+    plan_->forward();
+
+    const FFTComplex* X = plan_->spectrum;
+    const size_t per_octave = binsPerOctave();
+    double* magnitude = spectrum_.data() + channel * binCount() + (config_.octaves - 1 - octave) * per_octave;
+    for (size_t k = 0; k < per_octave; k++) {
+        const Kernel& kernel = kernels_[k];
+        const FFTComplex* x = X + kernel.first;
+        double re = 0.0, im = 0.0;
+        for (size_t j = 0; j < kernel.re.size(); j++) {
+            re += x[j][0] * kernel.re[j] - x[j][1] * kernel.im[j];
+            im += x[j][0] * kernel.im[j] + x[j][1] * kernel.re[j];
+        }
+        magnitude[k] = std::sqrt(re * re + im * im);
+    }
+}
+
+double ChromaAnalyzer::dominantFrequency(size_t channel) const {
+    const double* magnitude = spectrum(channel);
+    const size_t best = static_cast<size_t>(std::max_element(magnitude, magnitude + binCount()) - magnitude);
+    return magnitude[best] > 0.0 ? frequencies_[best] : 0.0;
+}
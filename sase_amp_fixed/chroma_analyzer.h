@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "fft_plan_cache.h"
+
+struct ChromaConfig {
+    double sample_rate = 48000.0;
+    size_t channels = 1;           // Planar input streams analyzed side by side
+    int hop_size = 512;            // Input samples per chroma frame
+    double min_frequency = 55.0;   // Lowest bin, snapped to the nearest note
+    int octaves = 7;
+    int bins_per_semitone = 3;     // Constant-Q bins per semitone, folded into one pitch class
+    double tuning = 440.0;         // Hz of A4
+    double kernel_threshold = 0.005;  // Spectral kernel bins below this fraction of the peak are dropped
+    bool normalize = true;         // Scale each chroma vector to a maximum of 1
+};
+
+// Streaming constant-Q and pitch-class (chroma) analysis.
+//
+// Kernel-based constant-Q transform over a multirate pyramid: the spectral
+// kernels of the top octave's bins (Hann-windowed complex exponentials
+// transformed once and cut down to the few bins around their peak) are
+// applied to one real FFT of the stream, and every lower octave runs the
+// same kernels over the stream decimated by two once more (half-band FIR).
+// The FFT size is the top octave's longest kernel rounded up to a power of
+// two, so 1024 points at 48 kHz with 3 bins per semitone while the lowest
+// octave still resolves semitones at 55 Hz.
+//
+// The top octave is transformed every hop; octave o below it only every
+// 2^o hops, as its decimated stream gains one hop's worth of samples, and
+// staggered so each hop transforms exactly one of them. A hop thus costs
+// two FFTs of fft_size() points, the kernel products and the decimation
+// filters, for all octaves.
+//
+// Bin magnitudes read as the amplitude of a sinusoid at the bin frequency.
+// Chroma sums bin energies per pitch class, C = 0 through B = 11.
+class ChromaAnalyzer {
+public:
+    static constexpr int kPitchClasses = 12;
+
+    // Throws std::invalid_argument for no channels, a hop below 1, a
+    // non-positive frequency, sample rate or tuning, octaves or bins per
+    // semitone below 1, or a top octave reaching past 0.4 sample_rate
+    explicit ChromaAnalyzer(const ChromaConfig& config = ChromaConfig());
+
+    ChromaAnalyzer(const ChromaAnalyzer&) = delete;
+    ChromaAnalyzer& operator=(const ChromaAnalyzer&) = delete;
+
+    // Feeds n samples of every channel, channel c at in + c * stride, and
+    // analyzes each hop completed. Returns the hops completed; the chroma of
+    // the first max_frames of them go to frames, [frame x channel x 12].
+    size_t process(const float* in, size_t stride, size_t n, double* frames = nullptr, size_t max_frames = 0);
+
+    // Of the last completed hop
+    const double* chroma(size_t channel) const { return chroma_.data() + channel * kPitchClasses; }
+    // binCount() constant-Q magnitudes, lowest bin first
+    const double* spectrum(size_t channel) const { return spectrum_.data() + channel * binCount(); }
+    // Frequency of the strongest constant-Q bin, 0 while silent
+    double dominantFrequency(size_t channel) const;
+
+    // Clears the stream history and results; configuration stays
+    void reset();
+
+    size_t binCount() const { return static_cast<size_t>(config_.octaves) * binsPerOctave(); }
+    size_t binsPerOctave() const { return static_cast<size_t>(kPitchClasses * config_.bins_per_semitone); }
+    double binFrequency(size_t bin) const { return frequencies_[bin]; }
+    int fftSize() const { return fft_size_; }
+    // Span of the longest kernel, the lowest bin's, in input samples
+    size_t latency() const { return kernel_span_ << (config_.octaves - 1); }
+    uint64_t hopsProcessed() const { return hops_; }
+    const ChromaConfig& config() const { return config_; }
+
+private:
+    // Conjugated spectral kernel of one top-octave bin, scaled by
+    // 1 / fft_size, over FFT bins [first, first + re.size())
+    struct Kernel {
+        size_t first = 0;
+        std::vector<double> re;
+        std::vector<double> im;
+    };
+
+    // Halving stage into octave o + 1 and the last fft_size samples of
+    // octave o, each kept twice so the newest ones are always contiguous
+    struct OctaveStream {
+        std::vector<double> frame;    // 2 fft_size
+        size_t frame_pos = 0;
+        std::vector<double> filter;   // 2 taps
+        size_t filter_pos = 0;
+        bool keep = false;            // Whether the stage emits its next input
+    };
+
+    void buildKernels();
+    void push(size_t channel, int octave, double x);
+    void analyzeHop();
+    void analyzeOctave(size_t channel, int octave);
+
+    ChromaConfig config_;
+    int fft_size_ = 0;
+    size_t kernel_span_ = 0;             // Samples of the longest top-octave kernel
+    FFTPlanCache plans_;
+    FFTPlanCache::Plan* plan_ = nullptr;
+    std::vector<Kernel> kernels_;
+    std::vector<double> frequencies_;    // Per bin, every octave
+    std::vector<int> pitch_class_;       // Per top-octave bin
+    std::vector<double> halfband_;       // Decimation filter taps
+    std::vector<OctaveStream> streams_;  // [channel x octave]
+    std::vector<double> spectrum_;       // [channel x bin]
+    std::vector<double> chroma_;         // [channel x 12]
+    size_t fill_ = 0;                    // Samples of the current hop
+    uint64_t hops_ = 0;
+};
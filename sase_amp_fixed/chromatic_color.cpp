@@ -0,0 +1,37 @@
+#include "chromatic_color.h"
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+constexpr double kTwoPi = 6.283185307179586;
+} // namespace
+
+ChromaticColorMapper::ChromaticColorMapper(const ChromaticColorConfig& config, SimdLevel level)
+    : config_(config), kernels_(&nodeKernels(level)) {
+    if (!(config_.max_frequency > config_.min_frequency)) {
+        throw std::invalid_argument("max_frequency must be above min_frequency");
+    }
+    if (config_.log_scale && !(config_.min_frequency > 0.0f)) {
+        throw std::invalid_argument("a log frequency axis needs a positive min_frequency");
+    }
+    if (!(config_.amplitude_gamma > 0.0f)) throw std::invalid_argument("amplitude_gamma must be positive");
+    if (!(config_.saturation >= 0.0f && config_.saturation <= 1.0f)) {
+        throw std::invalid_argument("saturation must be in [0, 1]");
+    }
+}
+
+void ChromaticColorMapper::map(const float* frequency, const float* amplitude, size_t n, double phi_phase,
+                               float lightness_gain, float* hsl, uint8_t* rgba) const {
+    ColorMapParams params;
+    params.min_frequency = config_.min_frequency;
+    params.max_frequency = config_.max_frequency;
+    params.log_scale = config_.log_scale;
+    params.inv_gamma = 1.0f / config_.amplitude_gamma;
+    params.lightness_gain = lightness_gain;
+    params.rotate = config_.phi_rotation;
+    // Reduced in double, so a phase that has run for hours keeps its precision
+    params.rotation = static_cast<float>(std::fmod(phi_phase / kTwoPi * kGoldenAngle, 360.0));
+    params.saturation = config_.saturation;
+    params.alpha = config_.alpha;
+    kernels_->color_map(frequency, amplitude, n, params, hsl, rgba);
+}
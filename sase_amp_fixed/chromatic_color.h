@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "node_kernels.h"
+
+// Mapping of server/chromatic_visualizer.py (VisualizerConfig)
+struct ChromaticColorConfig {
+    float min_frequency = 20.0f;     // Hz, hue 0
+    float max_frequency = 2000.0f;   // Hz, hue 360
+    bool log_scale = true;           // frequency_scale "log" (else "linear")
+    float amplitude_gamma = 2.2f;    // lightness = amplitude^(1 / gamma)
+    bool phi_rotation = true;        // Rotate hues by the Φ phase
+    float saturation = 1.0f;
+    uint8_t alpha = 255;
+};
+
+// Batch ColorMapper of the chromatic visualizer: frequencies, amplitudes and
+// the Φ phase of every channel to packed HSL and RGBA buffers in one pass of
+// the node kernel table's color_map, in place of three Python calls per
+// channel per animation frame. Matches ColorMapper to float rounding:
+//
+//   hue       = normalized(clip(f)) * 360, log or linear axis
+//   hue       = (hue + phi_phase / 2π * golden angle) mod 360   (phi_rotation)
+//   lightness = clip(amplitude, 0, 1)^(1 / gamma) * lightness_gain
+//
+// with lightness_gain carrying the Φ-breathing factor. Stateless after
+// construction, so one mapper may be shared by threads.
+class ChromaticColorMapper {
+public:
+    static constexpr double kGoldenAngle = 137.5077640500378;
+
+    // Throws std::invalid_argument for an empty or non-positive (log axis)
+    // frequency range, a gamma that is not positive or a saturation outside [0, 1]
+    explicit ChromaticColorMapper(const ChromaticColorConfig& config = ChromaticColorConfig(),
+                                  SimdLevel level = defaultSimdLevel());
+
+    // n channels into hsl (n x 3 floats: hue, saturation, lightness) and
+    // rgba (n x 4 bytes); either may be null
+    void map(const float* frequency, const float* amplitude, size_t n, double phi_phase, float lightness_gain,
+             float* hsl, uint8_t* rgba) const;
+
+    const ChromaticColorConfig& config() const { return config_; }
+    SimdLevel getSimdLevel() const { return kernels_->level; }
+
+private:
+    ChromaticColorConfig config_;
+    const NodeKernels* kernels_;
+};
@@ -0,0 +1,57 @@
+#include "chromatic_stream.h"
+#include "parameter_automation.h"
+#include <algorithm>
+#include <stdexcept>
+
+ChromaticStream::ChromaticStream(AnalogCellularEngineAVX2& engine, size_t block_size,
+                                 const ChromaticBlockConfig& config)
+    : engine_(engine), config_(config), block_size_(block_size) {
+    if (block_size == 0) throw std::invalid_argument("chromatic stream block size must be at least 1");
+    if (config.num_channels == 0) throw std::invalid_argument("chromatic stream needs at least one channel");
+    input_.assign(block_size, 0.0f);
+    output_.assign(config.num_channels * block_size, 0.0f);
+}
+
+void ChromaticStream::process(const float* in, float* out, size_t n) {
+    const size_t channels = config_.num_channels;
+    size_t done = 0;
+    while (done < n) {
+        // Input position fill_ of the current block pairs with output
+        // position fill_ of the previous one: a delay of exactly one block
+        const size_t count = std::min(n - done, block_size_ - fill_);
+        std::copy(in + done, in + done + count, input_.begin() + fill_);
+        for (size_t c = 0; c < channels; c++) {
+            const float* row = output_.data() + c * block_size_ + fill_;
+            std::copy(row, row + count, out + c * n + done);
+        }
+        fill_ += count;
+        done += count;
+        if (fill_ == block_size_) {
+            if (automation_) {
+                engine_.processChromaticBlock(input_.data(), block_size_, config_, *automation_, output_.data());
+            } else {
+                engine_.processChromaticBlock(input_.data(), block_size_, config_, output_.data());
+            }
+            fill_ = 0;
+            blocks_++;
+        }
+    }
+}
+
+void ChromaticStream::setPhi(double phase, double depth) {
+    config_.phi_phase = phase;
+    config_.phi_depth = depth;
+}
+
+void ChromaticStream::setAutomation(ParameterAutomation* automation) {
+    if (automation && automation->maxBlock() < block_size_) {
+        throw std::invalid_argument("automation max_block is shorter than the stream's blocks");
+    }
+    automation_ = automation;
+}
+
+void ChromaticStream::reset() {
+    std::fill(input_.begin(), input_.end(), 0.0f);
+    std::fill(output_.begin(), output_.end(), 0.0f);
+    fill_ = 0;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "analog_universal_node_engine_avx2.h"
+
+// Re-blocking front end of AnalogCellularEngineAVX2::processChromaticBlock.
+//
+// Accepts chunks of any length and emits exactly as many samples per channel
+// as it is given, delayed by a constant latency() of one block, so it can sit
+// directly in an audio or WebSocket callback whatever chunk size arrives.
+// Input collects in a block buffer; each time it fills, the engine runs one
+// chromatic block into the output buffer, which the next block_size samples
+// of output are read from. Runs in the caller's thread under no lock, and
+// allocates only at construction.
+class ChromaticStream {
+public:
+    // The engine must outlive the stream. Throws std::invalid_argument for an
+    // empty block or no channels.
+    ChromaticStream(AnalogCellularEngineAVX2& engine, size_t block_size = 512,
+                    const ChromaticBlockConfig& config = ChromaticBlockConfig());
+
+    ChromaticStream(const ChromaticStream&) = delete;
+    ChromaticStream& operator=(const ChromaticStream&) = delete;
+
+    // n input samples in, channel-major [num_channels x n] outputs out
+    void process(const float* in, float* out, size_t n);
+
+    // Φ envelope of the blocks that start after the call
+    void setPhi(double phase, double depth);
+    // Blocks from the next one on run under automation (Φ curves and
+    // feedback changes on its clock, one tick per input sample) in place of
+    // setPhi; null goes back to setPhi. It must outlive the stream or the
+    // next setAutomation, and its maxBlock() cover blockSize(); throws
+    // std::invalid_argument otherwise.
+    void setAutomation(ParameterAutomation* automation);
+    ParameterAutomation* automation() const { return automation_; }
+    const ChromaticBlockConfig& config() const { return config_; }
+
+    // Clears the buffered input and pending output; the node state is the
+    // engine's and is not touched.
+    void reset();
+
+    size_t blockSize() const { return block_size_; }
+    size_t channels() const { return config_.num_channels; }
+    size_t latency() const { return block_size_; }
+    // Engine blocks run so far, and the [num_channels x block_size] outputs
+    // of the latest one
+    uint64_t blocksProcessed() const { return blocks_; }
+    const float* lastBlock() const { return output_.data(); }
+    AnalogCellularEngineAVX2& engine() const { return engine_; }
+
+private:
+    AnalogCellularEngineAVX2& engine_;
+    ChromaticBlockConfig config_;
+    ParameterAutomation* automation_ = nullptr;
+    size_t block_size_;
+    std::vector<float> input_;   // Current block, fill_ samples so far
+    std::vector<float> output_;  // Latest block's outputs, read from fill_ on
+    size_t fill_ = 0;
+    uint64_t blocks_ = 0;
+};
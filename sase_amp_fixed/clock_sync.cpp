@@ -0,0 +1,491 @@
+#include "clock_sync.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <ctime>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CLOCK_SYNC_SOCKETS 1
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+#ifdef __linux__
+#include <linux/errqueue.h>
+#include <linux/net_tstamp.h>
+#endif
+
+const char* timestampSourceName(TimestampSource source) {
+    switch (source) {
+        case TimestampSource::User: return "user";
+        case TimestampSource::Kernel: return "kernel";
+        case TimestampSource::Hardware: return "hardware";
+    }
+    return "unknown";
+}
+
+// ---------------------------------------------------------------------------
+// ClockOffsetFilter
+
+ClockOffsetFilter::ClockOffsetFilter(size_t window) : window_(window) {
+    if (window == 0) throw std::invalid_argument("clock offset filter window must be at least 1");
+    samples_.resize(window);
+}
+
+bool ClockOffsetFilter::add(const ClockSyncSample& sample) {
+    if (sample.delay() < 0) return false;
+    samples_[next_] = sample;
+    next_ = (next_ + 1) % window_;
+    count_ = std::min(count_ + 1, window_);
+    return true;
+}
+
+void ClockOffsetFilter::reset() {
+    next_ = 0;
+    count_ = 0;
+}
+
+ClockOffsetEstimate ClockOffsetFilter::estimate(int64_t now_ns) const {
+    ClockOffsetEstimate result;
+    result.samples = count_;
+    if (count_ == 0) return result;
+
+    TimestampSource best = TimestampSource::User;
+    for (size_t i = 0; i < count_; i++) best = std::max(best, samples_[i].source);
+    std::vector<const ClockSyncSample*> candidates;
+    candidates.reserve(count_);
+    for (size_t i = 0; i < count_; i++) {
+        if (samples_[i].source == best) candidates.push_back(&samples_[i]);
+    }
+
+    const ClockSyncSample* chosen = *std::min_element(
+        candidates.begin(), candidates.end(),
+        [](const ClockSyncSample* a, const ClockSyncSample* b) { return a->delay() < b->delay(); });
+
+    // Drift from the samples no slower than the median round trip
+    std::vector<int64_t> delays;
+    delays.reserve(candidates.size());
+    for (const ClockSyncSample* s : candidates) delays.push_back(s->delay());
+    std::nth_element(delays.begin(), delays.begin() + delays.size() / 2, delays.end());
+    const int64_t median = delays[delays.size() / 2];
+
+    const int64_t origin = chosen->t4;
+    double sum_t = 0.0, sum_o = 0.0;
+    size_t n = 0;
+    for (const ClockSyncSample* s : candidates) {
+        if (s->delay() > median) continue;
+        sum_t += static_cast<double>(s->t4 - origin);
+        sum_o += static_cast<double>(s->offset() - chosen->offset());
+        n++;
+    }
+    double slope = 0.0;
+    if (n >= 2) {
+        const double mean_t = sum_t / n;
+        const double mean_o = sum_o / n;
+        double stt = 0.0, sto = 0.0;
+        for (const ClockSyncSample* s : candidates) {
+            if (s->delay() > median) continue;
+            const double t = static_cast<double>(s->t4 - origin) - mean_t;
+            stt += t * t;
+            sto += t * (static_cast<double>(s->offset() - chosen->offset()) - mean_o);
+        }
+        if (stt > 0.0) slope = sto / stt;
+    }
+    double square = 0.0;
+    for (const ClockSyncSample* s : candidates) {
+        if (s->delay() > median) continue;
+        const double residual = static_cast<double>(s->offset() - chosen->offset()) -
+                                slope * static_cast<double>(s->t4 - origin);
+        square += residual * residual;
+    }
+
+    const int64_t at = now_ns != 0 ? now_ns : origin;
+    result.valid = true;
+    result.offset_ns = chosen->offset() + static_cast<int64_t>(std::llround(slope * static_cast<double>(at - origin)));
+    result.delay_ns = chosen->delay();
+    result.error_bound_ns = chosen->delay() / 2;
+    result.drift_ppm = slope * 1e6;
+    result.jitter_ns = n > 0 ? std::sqrt(square / n) : 0.0;
+    result.source = best;
+    result.measured_at_ns = at;
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// Sockets and stamps
+//
+// Packet, host byte order (the cluster shares one):
+//   0  uint32 magic     8  uint32 sequence
+//   4  uint8  type     12  uint32 zero
+//   5  uint8  source   16  int64 t2 (follow-up)
+//   6  uint16 zero     24  int64 t3 (follow-up)
+
+int64_t ClockSyncClient::realtimeNs() {
+#ifdef CLOCK_SYNC_SOCKETS
+    timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+#endif
+}
+
+namespace {
+
+constexpr uint32_t kSyncMagic = 0x434b5344;  // "DSKC"
+
+enum PacketType : uint8_t { kRequest = 1, kResponse = 2, kFollowUp = 3 };
+
+struct SyncPacket {
+    uint32_t magic;
+    uint8_t type;
+    uint8_t source;
+    uint16_t reserved;
+    uint32_t sequence;
+    uint32_t reserved2;
+    int64_t t2;
+    int64_t t3;
+};
+static_assert(sizeof(SyncPacket) == 32, "clock sync packet layout");
+
+// Every stamp taken of one send or receive, 0 where none came
+struct Stamps {
+    int64_t user = 0;
+    int64_t kernel = 0;
+    int64_t hardware = 0;
+};
+
+// The two stamps of one end of an exchange on a common clock, and its source
+void pickPair(const Stamps& a, const Stamps& b, int64_t& x, int64_t& y, TimestampSource& source) {
+    if (a.hardware != 0 && b.hardware != 0) {
+        x = a.hardware;
+        y = b.hardware;
+        source = TimestampSource::Hardware;
+        return;
+    }
+    // Kernel software stamps and user ones share CLOCK_REALTIME
+    x = a.kernel != 0 ? a.kernel : a.user;
+    y = b.kernel != 0 ? b.kernel : b.user;
+    source = a.kernel != 0 && b.kernel != 0 ? TimestampSource::Kernel : TimestampSource::User;
+}
+
+#ifdef CLOCK_SYNC_SOCKETS
+
+int64_t toNs(const timespec& ts) { return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec; }
+
+// Turns on socket timestamping; returns whether hardware stamps were asked for
+bool enableStamps(int fd, bool hardware) {
+#ifdef __linux__
+    unsigned flags = SOF_TIMESTAMPING_RX_SOFTWARE | SOF_TIMESTAMPING_TX_SOFTWARE | SOF_TIMESTAMPING_SOFTWARE;
+#ifdef SOF_TIMESTAMPING_OPT_TSONLY
+    flags |= SOF_TIMESTAMPING_OPT_TSONLY;  // Transmit stamps without the packet looped back
+#endif
+    if (hardware) {
+        const unsigned with_hardware =
+            flags | SOF_TIMESTAMPING_RX_HARDWARE | SOF_TIMESTAMPING_TX_HARDWARE | SOF_TIMESTAMPING_RAW_HARDWARE;
+        if (setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &with_hardware, sizeof(with_hardware)) == 0) return true;
+    }
+    setsockopt(fd, SOL_SOCKET, SO_TIMESTAMPING, &flags, sizeof(flags));
+#else
+    (void)fd;
+    (void)hardware;
+#endif
+    return false;
+}
+
+void readStamps(msghdr& message, Stamps& stamps) {
+#ifdef __linux__
+    for (cmsghdr* c = CMSG_FIRSTHDR(&message); c; c = CMSG_NXTHDR(&message, c)) {
+        if (c->cmsg_level != SOL_SOCKET || c->cmsg_type != SO_TIMESTAMPING) continue;
+        timespec ts[3];
+        std::memcpy(ts, CMSG_DATA(c), sizeof(ts));
+        if (toNs(ts[0]) != 0) stamps.kernel = toNs(ts[0]);
+        if (toNs(ts[2]) != 0) stamps.hardware = toNs(ts[2]);
+    }
+#else
+    (void)message;
+    (void)stamps;
+#endif
+}
+
+// Waits up to wait_ms for a packet; false if none came
+bool receivePacket(int fd, int wait_ms, SyncPacket& packet, Stamps& stamps, sockaddr_storage* from) {
+    pollfd p = {};
+    p.fd = fd;
+    p.events = POLLIN;
+    if (::poll(&p, 1, wait_ms) <= 0 || !(p.revents & POLLIN)) return false;
+
+    alignas(cmsghdr) char control[256];
+    iovec vector = {&packet, sizeof(packet)};
+    msghdr message = {};
+    message.msg_iov = &vector;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    if (from) {
+        message.msg_name = from;
+        message.msg_namelen = sizeof(*from);
+    }
+    const ssize_t got = ::recvmsg(fd, &message, MSG_DONTWAIT);
+    stamps = Stamps();
+    stamps.user = ClockSyncClient::realtimeNs();
+    if (got != static_cast<ssize_t>(sizeof(packet)) || packet.magic != kSyncMagic) return false;
+    readStamps(message, stamps);
+    return true;
+}
+
+// Transmit stamps of the last packet sent, from the error queue. Waits for
+// the kernel stamp, and for the hardware one while they keep coming.
+void transmitStamps(int fd, std::chrono::microseconds wait, bool& hardware_seen, Stamps& stamps) {
+#ifdef __linux__
+    const auto deadline = std::chrono::steady_clock::now() + wait;
+    for (;;) {
+        alignas(cmsghdr) char control[256];
+        char data[64];
+        iovec vector = {data, sizeof(data)};
+        msghdr message = {};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        if (::recvmsg(fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) >= 0) {
+            readStamps(message, stamps);
+            if (stamps.hardware != 0) hardware_seen = true;
+            if (stamps.kernel != 0 && (stamps.hardware != 0 || !hardware_seen)) return;
+            continue;
+        }
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left < 0) return;
+        pollfd p = {};
+        p.fd = fd;
+        p.events = 0;  // The error queue shows as POLLERR
+        ::poll(&p, 1, static_cast<int>(left) + 1);
+    }
+#else
+    (void)fd;
+    (void)wait;
+    (void)hardware_seen;
+    (void)stamps;
+#endif
+}
+
+// Stamps of packets sent before, whose stamps were not collected in time
+void drainErrorQueue(int fd) {
+#ifdef __linux__
+    char control[256];
+    char data[64];
+    for (;;) {
+        iovec vector = {data, sizeof(data)};
+        msghdr message = {};
+        message.msg_iov = &vector;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+        if (::recvmsg(fd, &message, MSG_ERRQUEUE | MSG_DONTWAIT) < 0) return;
+    }
+#else
+    (void)fd;
+#endif
+}
+
+#endif
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// ClockSyncServer
+
+ClockSyncServer::ClockSyncServer(uint16_t port, const std::string& bind_address, const ClockSyncConfig& config)
+    : config_(config) {
+#ifdef CLOCK_SYNC_SOCKETS
+    const std::string where = bind_address + ":" + std::to_string(port);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, bind_address.c_str(), &address.sin_addr) != 1) {
+        throw std::runtime_error("clock sync server " + where + ": not an IPv4 address");
+    }
+    const int s = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    bool ok = s >= 0 && ::bind(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    socklen_t length = sizeof(address);
+    ok = ok && getsockname(s, reinterpret_cast<sockaddr*>(&address), &length) == 0;
+    if (!ok) {
+        if (s >= 0) ::close(s);
+        throw std::runtime_error("clock sync server " + where + ": cannot bind");
+    }
+    hardware_ = enableStamps(s, config.hardware);
+    socket_ = s;
+    port_ = ntohs(address.sin_port);
+    thread_ = std::thread(&ClockSyncServer::run, this);
+#else
+    (void)port;
+    (void)bind_address;
+    throw std::runtime_error("clock sync server: needs POSIX sockets");
+#endif
+}
+
+ClockSyncServer::~ClockSyncServer() { stop(); }
+
+void ClockSyncServer::stop() {
+    stop_.store(true, std::memory_order_relaxed);
+    if (thread_.joinable()) thread_.join();
+#ifdef CLOCK_SYNC_SOCKETS
+    if (socket_ >= 0) {
+        ::close(static_cast<int>(socket_));
+        socket_ = -1;
+    }
+#endif
+}
+
+void ClockSyncServer::run() {
+#ifdef CLOCK_SYNC_SOCKETS
+    constexpr int kPollMs = 100;  // How often the idle server checks for stop()
+    const int fd = static_cast<int>(socket_);
+    bool hardware_seen = false;
+    while (!stop_.load(std::memory_order_relaxed)) {
+        SyncPacket request;
+        Stamps received;
+        sockaddr_storage from = {};
+        if (!receivePacket(fd, kPollMs, request, received, &from) || request.type != kRequest) continue;
+        const socklen_t from_length = from.ss_family == AF_INET6 ? sizeof(sockaddr_in6) : sizeof(sockaddr_in);
+
+        SyncPacket reply = {};
+        reply.magic = kSyncMagic;
+        reply.type = kResponse;
+        reply.sequence = request.sequence;
+        drainErrorQueue(fd);
+        Stamps sent;
+        sent.user = ClockSyncClient::realtimeNs();
+        if (::sendto(fd, &reply, sizeof(reply), 0, reinterpret_cast<const sockaddr*>(&from), from_length) < 0) continue;
+        transmitStamps(fd, config_.tx_stamp_wait, hardware_seen, sent);
+
+        TimestampSource source;
+        reply.type = kFollowUp;
+        pickPair(received, sent, reply.t2, reply.t3, source);
+        reply.source = static_cast<uint8_t>(source);
+        ::sendto(fd, &reply, sizeof(reply), 0, reinterpret_cast<const sockaddr*>(&from), from_length);
+        requests_.fetch_add(1, std::memory_order_relaxed);
+        if (source != TimestampSource::User) stamped_.fetch_add(1, std::memory_order_relaxed);
+    }
+#endif
+}
+
+// ---------------------------------------------------------------------------
+// ClockSyncClient
+
+ClockSyncClient::ClockSyncClient(const std::string& host, uint16_t port, const ClockSyncConfig& config)
+    : config_(config), filter_(config.window) {
+#ifdef CLOCK_SYNC_SOCKETS
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    const std::string service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &found) != 0 || !found) {
+        throw std::invalid_argument("clock sync server " + host + ": cannot resolve");
+    }
+    const int s = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    const bool ok = s >= 0 && ::connect(s, found->ai_addr, found->ai_addrlen) == 0;
+    freeaddrinfo(found);
+    if (!ok) {
+        if (s >= 0) ::close(s);
+        throw std::runtime_error("clock sync client: cannot open a socket to " + host + ":" + service);
+    }
+    hardware_ = enableStamps(s, config.hardware);
+    socket_ = s;
+#else
+    (void)host;
+    (void)port;
+    throw std::runtime_error("clock sync client: needs POSIX sockets");
+#endif
+}
+
+ClockSyncClient::~ClockSyncClient() {
+#ifdef CLOCK_SYNC_SOCKETS
+    if (socket_ >= 0) ::close(static_cast<int>(socket_));
+#endif
+}
+
+bool ClockSyncClient::exchange(std::chrono::microseconds timeout) {
+#ifdef CLOCK_SYNC_SOCKETS
+    const int fd = static_cast<int>(socket_);
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    const uint32_t sequence = ++sequence_;
+
+    SyncPacket request = {};
+    request.magic = kSyncMagic;
+    request.type = kRequest;
+    request.sequence = sequence;
+    drainErrorQueue(fd);
+    Stamps sent;
+    sent.user = realtimeNs();
+    if (::send(fd, &request, sizeof(request), 0) < 0) {
+        stats_.timeouts++;
+        return false;
+    }
+    bool hardware_seen = hardware_ && stats_.last.source == TimestampSource::Hardware;
+    transmitStamps(fd, config_.tx_stamp_wait, hardware_seen, sent);
+
+    Stamps received;
+    bool have_response = false;
+    bool have_follow_up = false;
+    SyncPacket follow_up = {};
+    while (!(have_response && have_follow_up)) {
+        const auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (left < 0) {
+            stats_.timeouts++;
+            return false;
+        }
+        SyncPacket packet;
+        Stamps stamps;
+        if (!receivePacket(fd, static_cast<int>(left) + 1, packet, stamps, nullptr)) continue;
+        if (packet.sequence != sequence) {
+            stats_.stale++;
+            continue;
+        }
+        if (packet.type == kResponse) {
+            received = stamps;
+            have_response = true;
+        } else if (packet.type == kFollowUp) {
+            follow_up = packet;
+            have_follow_up = true;
+        }
+    }
+
+    ClockSyncSample sample;
+    TimestampSource local;
+    pickPair(sent, received, sample.t1, sample.t4, local);
+    sample.t2 = follow_up.t2;
+    sample.t3 = follow_up.t3;
+    sample.source = std::min(local, static_cast<TimestampSource>(std::min<uint8_t>(follow_up.source, 2)));
+    stats_.last = sample;
+    if (!filter_.add(sample)) {
+        stats_.rejected++;
+        return true;
+    }
+    stats_.exchanges++;
+    return true;
+#else
+    (void)timeout;
+    return false;
+#endif
+}
+
+size_t ClockSyncClient::burst(size_t count, std::chrono::microseconds interval, std::chrono::microseconds timeout) {
+    size_t done = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (i > 0 && interval.count() > 0) std::this_thread::sleep_for(interval);
+        if (exchange(timeout)) done++;
+    }
+    return done;
+}
+
+ClockOffsetEstimate ClockSyncClient::estimate() const { return filter_.estimate(realtimeNs()); }
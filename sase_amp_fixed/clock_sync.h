@@ -0,0 +1,171 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Where a timestamp of a sync exchange was taken, best last
+enum class TimestampSource : uint8_t {
+    User = 0,      // clock_gettime(CLOCK_REALTIME) next to the send or receive call
+    Kernel = 1,    // Socket software stamp (SO_TIMESTAMPING), free of scheduling and GIL delays
+    Hardware = 2   // NIC stamp; the offset is then between the two NICs' clocks
+};
+
+const char* timestampSourceName(TimestampSource source);
+
+// One two-way exchange, PTP delay request/response style: t1 request
+// sent and t4 response received on the local clock, t2 request received
+// and t3 response sent on the remote one (ns)
+struct ClockSyncSample {
+    int64_t t1 = 0;
+    int64_t t2 = 0;
+    int64_t t3 = 0;
+    int64_t t4 = 0;
+    TimestampSource source = TimestampSource::User;  // Worse of the two ends
+
+    // Remote minus local clock, assuming a symmetric path
+    int64_t offset() const { return ((t2 - t1) + (t3 - t4)) / 2; }
+    // Round trip minus the remote's turnaround
+    int64_t delay() const { return (t4 - t1) - (t3 - t2); }
+};
+
+struct ClockOffsetEstimate {
+    bool valid = false;
+    int64_t offset_ns = 0;         // Remote minus local clock at measured_at_ns
+    int64_t delay_ns = 0;          // Round trip of the sample the offset comes from
+    // Worst case error of offset_ns from path asymmetry: half that round trip
+    int64_t error_bound_ns = 0;
+    double drift_ppm = 0.0;        // Rate of offset change, remote against local
+    double jitter_ns = 0.0;        // RMS of the accepted samples around the drift line
+    TimestampSource source = TimestampSource::User;
+    size_t samples = 0;            // In the window
+    int64_t measured_at_ns = 0;    // Local time offset_ns refers to
+};
+
+// PTP-style offset/delay filter over the last window exchanges.
+//
+// Queueing only ever adds delay, and adds it to one direction, so the
+// sample with the least round trip in the window is the one whose offset
+// is least skewed (the NTP clock filter's choice); its offset, carried
+// forward along the drift line, is the estimate. The drift is a least
+// squares fit of offset against local time over the samples whose delay
+// is at most the window median, so queued samples do not tilt it.
+// Samples from a worse timestamp source than the window's best are kept
+// out of the estimate until the better ones age out.
+class ClockOffsetFilter {
+public:
+    // Throws std::invalid_argument for a window under 1
+    explicit ClockOffsetFilter(size_t window = 16);
+
+    // Samples with a negative delay (clock stepped mid-exchange) are dropped;
+    // returns whether the sample was kept
+    bool add(const ClockSyncSample& sample);
+    // Estimate at local time now_ns (0: at the chosen sample's own time)
+    ClockOffsetEstimate estimate(int64_t now_ns = 0) const;
+    void reset();
+
+    size_t window() const { return window_; }
+    size_t size() const { return count_; }
+
+private:
+    std::vector<ClockSyncSample> samples_;  // Ring of the last window
+    size_t window_;
+    size_t next_ = 0;
+    size_t count_ = 0;
+};
+
+struct ClockSyncConfig {
+    // Ask for NIC stamps too. They only come once the interface has hardware
+    // timestamping switched on (hwstamp_ctl, or a running PTP daemon);
+    // otherwise kernel software stamps are used.
+    bool hardware = true;
+    size_t window = 16;            // Exchanges the filter keeps
+    // How long to wait for the kernel's transmit stamp before falling back
+    // to the user space one
+    std::chrono::microseconds tx_stamp_wait{2000};
+};
+
+// Answers clock sync requests on a UDP port, on a thread of its own.
+//
+// Each request gets a response at once and, when the transmit stamp of
+// that response is in, a follow-up carrying the receive and transmit
+// stamps (PTP's two-step scheme): the stamps are the kernel's or the NIC's
+// rather than times read in user space around the socket calls. POSIX only.
+class ClockSyncServer {
+public:
+    // Listens on bind_address:port, port 0 for any free one. Throws
+    // std::runtime_error when the socket cannot be bound or on a platform
+    // without POSIX sockets.
+    explicit ClockSyncServer(uint16_t port = 9320, const std::string& bind_address = "0.0.0.0",
+                             const ClockSyncConfig& config = ClockSyncConfig());
+    // Stops and joins the server thread
+    ~ClockSyncServer();
+
+    ClockSyncServer(const ClockSyncServer&) = delete;
+    ClockSyncServer& operator=(const ClockSyncServer&) = delete;
+
+    void stop();
+    uint16_t port() const { return port_; }
+    uint64_t requests() const { return requests_.load(std::memory_order_relaxed); }
+    // Follow-ups sent with kernel or hardware transmit stamps
+    uint64_t stampedReplies() const { return stamped_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+
+    ClockSyncConfig config_;
+    intptr_t socket_ = -1;
+    uint16_t port_ = 0;
+    bool hardware_ = false;
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> stamped_{0};
+    std::thread thread_;
+};
+
+struct ClockSyncStats {
+    uint64_t exchanges = 0;        // Completed and kept
+    uint64_t timeouts = 0;
+    uint64_t rejected = 0;         // Completed but dropped by the filter
+    uint64_t stale = 0;            // Replies to earlier, abandoned requests
+    ClockSyncSample last;
+};
+
+// Measures the offset of a ClockSyncServer's clock from the local one.
+// Not thread safe; exchanges block the caller.
+class ClockSyncClient {
+public:
+    // Throws std::invalid_argument for an unresolvable host and
+    // std::runtime_error as ClockSyncServer
+    ClockSyncClient(const std::string& host, uint16_t port = 9320, const ClockSyncConfig& config = ClockSyncConfig());
+    ~ClockSyncClient();
+
+    ClockSyncClient(const ClockSyncClient&) = delete;
+    ClockSyncClient& operator=(const ClockSyncClient&) = delete;
+
+    // One exchange, fed to the filter; false if the follow-up did not arrive
+    // within timeout
+    bool exchange(std::chrono::microseconds timeout = std::chrono::microseconds(100000));
+    // count exchanges spaced by interval; returns how many completed
+    size_t burst(size_t count, std::chrono::microseconds interval = std::chrono::microseconds(1000),
+                 std::chrono::microseconds timeout = std::chrono::microseconds(100000));
+
+    ClockOffsetEstimate estimate() const;
+    ClockOffsetFilter& filter() { return filter_; }
+    const ClockSyncStats& stats() const { return stats_; }
+
+    // The clock the stamps are compared on (CLOCK_REALTIME), in ns
+    static int64_t realtimeNs();
+
+private:
+    ClockSyncConfig config_;
+    ClockOffsetFilter filter_;
+    intptr_t socket_ = -1;
+    bool hardware_ = false;
+    uint32_t sequence_ = 0;
+    ClockSyncStats stats_;
+};
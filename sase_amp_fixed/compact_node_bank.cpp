@@ -0,0 +1,101 @@
+#include "compact_node_bank.h"
+#include <new>
+#include <stdexcept>
+
+const char* nodeStateFormatName(NodeStateFormat format) {
+    switch (format) {
+        case NodeStateFormat::Half: return "f16";
+        case NodeStateFormat::BFloat16: return "bf16";
+        case NodeStateFormat::Fixed16: return "q16";
+    }
+    return "unknown";
+}
+
+CompactNodeBank::CompactNodeBank(size_t num_nodes, NodeStateFormat format, float fixed_range) : format_(format) {
+    resize(num_nodes, fixed_range);
+}
+
+CompactNodeBank::~CompactNodeBank() { release(); }
+
+void CompactNodeBank::resize(size_t num_nodes, float fixed_range) {
+    allocate(num_nodes, fixed_range);
+    zeroRange(0, capacity_);
+}
+
+void CompactNodeBank::allocate(size_t num_nodes, float fixed_range) {
+    if (!(fixed_range > 0.0f)) throw std::invalid_argument("compact node bank needs a positive fixed range");
+    release();
+    fixed_range_ = fixed_range;
+    fixed_scale_ = 32767.0f / fixed_range;
+    fixed_step_ = fixed_range / 32767.0f;
+    size_ = num_nodes;
+    capacity_ = paddedCount(num_nodes);
+    previous_input = 0.0f;
+    if (capacity_ == 0) return;
+
+    storage_bytes_ = storageBytesFor(capacity_);
+    storage_ = static_cast<unsigned char*>(::operator new(storage_bytes_, std::align_val_t(kAlignment)));
+    uint16_t* base = reinterpret_cast<uint16_t*>(storage_);
+    integrator_state = base;
+    current_output = base + capacity_;
+    feedback_gain = base + 2 * capacity_;
+    input_gain = base + 3 * capacity_;
+    time_constant = base + 4 * capacity_;
+    clamp_low = base + 5 * capacity_;
+    clamp_high = base + 6 * capacity_;
+    spectral_mix = base + 7 * capacity_;
+}
+
+void CompactNodeBank::zeroRange(size_t begin, size_t end) {
+    if (begin >= end) return;
+    // Zero encodes as all-zero bits in every format
+    const size_t bytes = (end - begin) * sizeof(uint16_t);
+    std::memset(integrator_state + begin, 0, bytes);
+    std::memset(current_output + begin, 0, bytes);
+    std::memset(feedback_gain + begin, 0, bytes);
+    fill(input_gain, begin, end, 1.0f);
+    fill(time_constant, begin, end, 0.1f);
+    fill(clamp_low, begin, end, -10.0f);
+    fill(clamp_high, begin, end, 10.0f);
+    fill(spectral_mix, begin, end, 1.0f);
+}
+
+void CompactNodeBank::resetState() {
+    if (capacity_ == 0) return;
+    std::memset(integrator_state, 0, capacity_ * sizeof(uint16_t));
+    std::memset(current_output, 0, capacity_ * sizeof(uint16_t));
+    previous_input = 0.0f;
+}
+
+uint16_t CompactNodeBank::encode(float value) const {
+    switch (format_) {
+        case NodeStateFormat::Half: return half_float::fromFloat(value);
+        case NodeStateFormat::BFloat16: return half_float::bfloatFromFloat(value);
+        case NodeStateFormat::Fixed16: return half_float::fixedFromFloat(value, fixed_scale_);
+    }
+    return 0;
+}
+
+float CompactNodeBank::decode(uint16_t value) const {
+    switch (format_) {
+        case NodeStateFormat::Half: return half_float::toFloat(value);
+        case NodeStateFormat::BFloat16: return half_float::bfloatToFloat(value);
+        case NodeStateFormat::Fixed16: return half_float::fixedToFloat(value, fixed_step_);
+    }
+    return 0.0f;
+}
+
+void CompactNodeBank::fill(uint16_t* column, size_t begin, size_t end, float value) {
+    const uint16_t encoded = encode(value);
+    for (size_t i = begin; i < end; i++) column[i] = encoded;
+}
+
+void CompactNodeBank::release() {
+    if (storage_) ::operator delete(storage_, std::align_val_t(kAlignment));
+    storage_ = nullptr;
+    storage_bytes_ = 0;
+    size_ = 0;
+    capacity_ = 0;
+    integrator_state = current_output = feedback_gain = input_gain = nullptr;
+    time_constant = clamp_low = clamp_high = spectral_mix = nullptr;
+}
@@ -0,0 +1,180 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// 16-bit encodings of compact node state
+enum class NodeStateFormat : uint8_t {
+    Half = 0,      // IEEE 754 binary16: 11-bit significand, range +-65504
+    BFloat16 = 1,  // Upper half of a float: 8-bit significand, float range
+    Fixed16 = 2    // Signed fixed point over +-CompactNodeBank::fixedRange(), saturating
+};
+
+const char* nodeStateFormatName(NodeStateFormat format);
+
+// Portable conversions, round to nearest even. The kernels use these where
+// the instruction set has no conversion of its own (F16C, AVX-512F and NEON
+// convert half floats in hardware).
+namespace half_float {
+
+inline uint32_t floatBits(float v) {
+    uint32_t bits;
+    std::memcpy(&bits, &v, sizeof(bits));
+    return bits;
+}
+
+inline float bitsFloat(uint32_t bits) {
+    float v;
+    std::memcpy(&v, &bits, sizeof(v));
+    return v;
+}
+
+inline uint16_t fromFloat(float v) {
+    const uint32_t bits = floatBits(v);
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t abs = bits & 0x7FFFFFFFu;
+    if (abs >= 0x7F800000u) return static_cast<uint16_t>(sign | 0x7C00u | (abs > 0x7F800000u ? 0x200u : 0u));
+    if (abs >= 0x477FF000u) return static_cast<uint16_t>(sign | 0x7C00u);  // Rounds past 65504
+    if (abs < 0x38800000u) {
+        // Subnormal half: scale into the 2^-24 grid and let the float adder round
+        const float scaled = bitsFloat(abs) + 0.5f;
+        return static_cast<uint16_t>(sign | (floatBits(scaled) - 0x3F000000u));
+    }
+    const uint32_t rounded = abs + 0xFFFu + ((abs >> 13) & 1u);
+    return static_cast<uint16_t>(sign | ((rounded - 0x38000000u) >> 13));
+}
+
+inline float toFloat(uint16_t h) {
+    const uint32_t sign = static_cast<uint32_t>(h & 0x8000u) << 16;
+    const uint32_t exponent = (h >> 10) & 0x1Fu;
+    const uint32_t mantissa = h & 0x3FFu;
+    if (exponent == 0) {
+        // Zero or subnormal: mantissa * 2^-24
+        const float magnitude = static_cast<float>(mantissa) * 5.9604644775390625e-8f;
+        return bitsFloat(sign | floatBits(magnitude));
+    }
+    if (exponent == 0x1F) return bitsFloat(sign | 0x7F800000u | (mantissa << 13));
+    return bitsFloat(sign | ((exponent + 112u) << 23) | (mantissa << 13));
+}
+
+inline uint16_t bfloatFromFloat(float v) {
+    // Selects rather than branches, so chunk loops vectorize
+    const uint32_t bits = floatBits(v);
+    const uint32_t rounded = (bits + 0x7FFFu + ((bits >> 16) & 1u)) >> 16;
+    const uint32_t quiet = (bits >> 16) | 0x40u;  // NaN stays NaN
+    return static_cast<uint16_t>((bits & 0x7FFFFFFFu) > 0x7F800000u ? quiet : rounded);
+}
+
+inline float bfloatToFloat(uint16_t b) { return bitsFloat(static_cast<uint32_t>(b) << 16); }
+
+// scale = 32767 / range; values past +-range saturate
+inline uint16_t fixedFromFloat(float v, float scale) {
+    float q = v * scale;
+    q = q < -32767.0f ? -32767.0f : (q > 32767.0f ? 32767.0f : q);
+    const int32_t rounded = static_cast<int32_t>(q + (q < 0.0f ? -0.5f : 0.5f));
+    return static_cast<uint16_t>(static_cast<int16_t>(rounded));
+}
+
+// inv_scale = range / 32767
+inline float fixedToFloat(uint16_t q, float inv_scale) {
+    return static_cast<float>(static_cast<int16_t>(q)) * inv_scale;
+}
+
+} // namespace half_float
+
+// Node state and parameters in 16 bits per value, for engines too large for
+// NodeBankF32.
+//
+// The same columns as the float bank (integrator state, feedback gain,
+// current output, input gain, time constant, clamp bounds and spectral mix),
+// one 16-bit word per node each, 64-byte aligned and padded to kLanePadding
+// nodes. The kernels widen a chunk to float in registers, run the float
+// node step on it and narrow the state they wrote back, so a sweep moves 16
+// bytes per node instead of 44 for the float bank and 80 for the double one.
+// Every node of a step reads the same input, so previous_input is one value
+// for the bank rather than a column, and there is no operation counter.
+//
+// Each stored value carries the format's rounding: about 3 decimal digits
+// for Half, 2 for BFloat16, range / 32767 absolute for Fixed16. Values are
+// rounded again on every store, so state drifts from a float engine's over
+// time; AnalogCellularEngineAVX2::runCompactDrift measures how far.
+class CompactNodeBank {
+public:
+    static constexpr size_t kAlignment = 64;
+    static constexpr size_t kLanePadding = kAlignment / sizeof(uint16_t);
+    static constexpr size_t kColumns = 8;
+
+    static constexpr float kDefaultFixedRange = 16.0f;
+
+    explicit CompactNodeBank(NodeStateFormat format = NodeStateFormat::Half) : format_(format) {}
+    CompactNodeBank(size_t num_nodes, NodeStateFormat format, float fixed_range = kDefaultFixedRange);
+    ~CompactNodeBank();
+
+    CompactNodeBank(const CompactNodeBank&) = delete;
+    CompactNodeBank& operator=(const CompactNodeBank&) = delete;
+
+    // Reallocates the columns for num_nodes nodes, zeroes the state and
+    // feedback and gives the other parameters the NodeBank defaults.
+    // fixed_range is the Fixed16 full scale; throws std::invalid_argument
+    // unless it is positive.
+    void resize(size_t num_nodes, float fixed_range = kDefaultFixedRange);
+    // resize() without touching the columns, so the caller can zero them
+    // with zeroRange from the threads that will sweep each range
+    void allocate(size_t num_nodes, float fixed_range = kDefaultFixedRange);
+    // Zeroes the state and feedback over nodes [begin, end) of capacity()
+    // and gives the other parameters their defaults
+    void zeroRange(size_t begin, size_t end);
+    // Zeroes the dynamic state of every node; parameters stay
+    void resetState();
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    NodeStateFormat format() const { return format_; }
+    float fixedRange() const { return fixed_range_; }
+    // Fixed16 quantization: q = value * fixedScale(), value = q * fixedStep()
+    float fixedScale() const { return fixed_scale_; }
+    float fixedStep() const { return fixed_step_; }
+    size_t bytesAllocated() const { return storage_bytes_; }
+
+    float encodeDecode(float value) const { return decode(encode(value)); }
+    uint16_t encode(float value) const;
+    float decode(uint16_t value) const;
+
+    // Decoded value of node i in column (see the members below)
+    float get(const uint16_t* column, size_t i) const { return decode(column[i]); }
+    void set(uint16_t* column, size_t i, float value) { column[i] = encode(value); }
+    // Fills nodes [begin, end) of a column with one value
+    void fill(uint16_t* column, size_t begin, size_t end, float value);
+
+    static constexpr size_t paddedCount(size_t n) {
+        return (n + kLanePadding - 1) / kLanePadding * kLanePadding;
+    }
+    static constexpr size_t storageBytesFor(size_t capacity) { return capacity * kColumns * sizeof(uint16_t); }
+
+    // Columns (capacity() entries each, 64-byte aligned), in storage order.
+    // The first two are the state a step writes.
+    uint16_t* integrator_state = nullptr;
+    uint16_t* current_output = nullptr;
+    uint16_t* feedback_gain = nullptr;
+    uint16_t* input_gain = nullptr;
+    uint16_t* time_constant = nullptr;
+    uint16_t* clamp_low = nullptr;
+    uint16_t* clamp_high = nullptr;
+    uint16_t* spectral_mix = nullptr;
+
+    // Input of the last step, shared by every node
+    float previous_input = 0.0f;
+
+private:
+    void release();
+
+    NodeStateFormat format_;
+    unsigned char* storage_ = nullptr;
+    size_t storage_bytes_ = 0;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    float fixed_range_ = kDefaultFixedRange;
+    float fixed_scale_ = 32767.0f / kDefaultFixedRange;
+    float fixed_step_ = kDefaultFixedRange / 32767.0f;
+};
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include "node_kernels.h"
+
+// Approximate-compute levels of AnalogCellularEngineAVX2, from exact to
+// cheapest. Each level scales the node work of the sweeps and the cost of
+// the spectral boost together, so one knob trades fidelity for throughput
+// (e.g. stepped by a load governor instead of dropping audio);
+// runQualitySweep() measures what each level costs in error and gains in
+// time against Full.
+enum class ComputeQuality {
+    Full = 0,     // The reference model
+    Reduced = 1,
+    Low = 2,
+    Draft = 3
+};
+constexpr size_t kComputeQualityCount = 4;
+
+// What a level runs
+struct ComputeQualityProfile {
+    int wave_passes;         // Node steps per wave sweep, of kWavePasses
+    size_t sweep_waves;      // Wave sweeps per performSignalSweepAVX2 frequency, of 5
+    unsigned harmonic_shift; // Harmonics per pass: the configured count >> shift, at least 1
+    SineDegree sine_degree;  // Sine polynomial of the spectral boost, every path
+};
+
+constexpr ComputeQualityProfile computeQualityProfile(ComputeQuality quality) {
+    switch (quality) {
+        case ComputeQuality::Reduced: return {6, 4, 1, SineDegree::Five};
+        case ComputeQuality::Low: return {4, 3, 2, SineDegree::Five};
+        case ComputeQuality::Draft: return {2, 2, 3, SineDegree::Three};
+        case ComputeQuality::Full: break;
+    }
+    return {kWavePasses, 5, 0, SineDegree::Seven};
+}
+
+inline const char* computeQualityName(ComputeQuality quality) {
+    switch (quality) {
+        case ComputeQuality::Full: return "full";
+        case ComputeQuality::Reduced: return "reduced";
+        case ComputeQuality::Low: return "low";
+        case ComputeQuality::Draft: return "draft";
+    }
+    return "unknown";
+}
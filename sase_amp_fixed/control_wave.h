@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <memory>
+#include <new>
+
+// Control modulation of the wave sweep: pass p of node slot i runs on
+// control_pattern + sin((i + p) * 0.1) * 0.3. The term depends on i + p
+// alone, so one table of it for k in [0, capacity + passes) serves every
+// sweep of a bank, and the wave kernels stream it rather than calling sin
+// ten times per node. Entries use the kernels' former expression; only
+// where the compiler fused its multiply into the add can a control value
+// differ, in the last bit.
+class ControlWaveTable {
+public:
+    static constexpr int kPasses = 10;
+    // Entries past capacity: the passes plus the widest vector chunk, for
+    // masked tails that read whole chunks
+    static constexpr size_t kSlack = kPasses + 16;
+
+    // Table for node slots [0, capacity), rebuilt only when capacity changes
+    const double* prepare(size_t capacity) {
+        if (!values_ || capacity != capacity_) {
+            const size_t count = capacity + kSlack;
+            values_.reset(new (std::align_val_t(64)) double[count]);
+            for (size_t k = 0; k < count; k++) values_[k] = std::sin(static_cast<double>(k) * 0.1) * 0.3;
+            capacity_ = capacity;
+        }
+        return values_.get();
+    }
+
+private:
+    struct AlignedDelete {
+        void operator()(double* p) const { ::operator delete[](p, std::align_val_t(64)); }
+    };
+    std::unique_ptr<double[], AlignedDelete> values_;
+    size_t capacity_ = 0;
+};
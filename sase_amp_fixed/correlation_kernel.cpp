@@ -0,0 +1,107 @@
+#include "correlation_kernel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+CorrelationKernel::CorrelationKernel(SimdLevel level, const WorkerPoolConfig& config)
+    : kernels_(&nodeKernels(level)), pool_(std::make_shared<WorkerPool>(config)) {}
+
+void CorrelationKernel::shareWorkerPool(std::shared_ptr<WorkerPool> pool) {
+    if (!pool) throw std::invalid_argument("shareWorkerPool needs a pool");
+    pool_ = std::move(pool);
+}
+
+// Ranks 1..n of values, tied values sharing the mean of their ranks
+static void rankRow(const float* values, size_t n, std::vector<size_t>& order, double* ranks) {
+    order.resize(n);
+    std::iota(order.begin(), order.end(), size_t(0));
+    std::sort(order.begin(), order.end(), [values](size_t a, size_t b) { return values[a] < values[b]; });
+    for (size_t first = 0; first < n;) {
+        size_t last = first + 1;
+        while (last < n && values[order[last]] == values[order[first]]) last++;
+        const double rank = 0.5 * static_cast<double>(first + last + 1);
+        for (size_t k = first; k < last; k++) ranks[order[k]] = rank;
+        first = last;
+    }
+}
+
+void CorrelationKernel::compute(const float* data, size_t metrics, size_t rows, size_t samples,
+                                CorrelationMethod method, double* out) {
+    if (samples < 2) throw std::invalid_argument("correlation needs at least 2 samples");
+    if (metrics == 0 || rows == 0) return;
+    const size_t stride = (samples + 15) & ~size_t(15);
+    const size_t series = metrics * rows;
+    normalized_.assign(series * stride, 0.0f);
+    valid_.assign(series, 0);
+
+    // Centre and scale every row (its ranks for Spearman) to unit length
+    pool_->parallelFor(series, 0, [&](size_t begin, size_t end, unsigned) {
+        std::vector<double> values(samples);
+        std::vector<size_t> order;
+        for (size_t r = begin; r < end; r++) {
+            const float* row = data + r * samples;
+            if (method == CorrelationMethod::Spearman) {
+                rankRow(row, samples, order, values.data());
+            } else {
+                for (size_t t = 0; t < samples; t++) values[t] = static_cast<double>(row[t]);
+            }
+            double mean = 0.0;
+            for (double v : values) mean += v;
+            mean /= static_cast<double>(samples);
+            double energy = 0.0;
+            for (double& v : values) {
+                v -= mean;
+                energy += v * v;
+            }
+            if (!(energy > 0.0)) continue;
+            const double scale = 1.0 / std::sqrt(energy);
+            float* target = normalized_.data() + r * stride;
+            for (size_t t = 0; t < samples; t++) target[t] = static_cast<float>(values[t] * scale);
+            valid_[r] = 1;
+        }
+    });
+
+    // Tiles (I, J), I <= J, of every metric's upper triangle
+    const size_t tiles = (rows + kTileRows - 1) / kTileRows;
+    const size_t pairs = tiles * (tiles + 1) / 2;
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    pool_->parallelFor(metrics * pairs, 1, [&](size_t begin, size_t end, unsigned) {
+        float partial[kTileRows * kTileRows];
+        double sums[kTileRows * kTileRows];
+        for (size_t item = begin; item < end; item++) {
+            const size_t m = item / pairs;
+            size_t pair = item % pairs;
+            size_t ti = 0;
+            while (pair >= tiles - ti) pair -= tiles - ti++;
+            const size_t tj = ti + pair;
+
+            const size_t i0 = ti * kTileRows, j0 = tj * kTileRows;
+            const size_t ni = std::min(kTileRows, rows - i0), nj = std::min(kTileRows, rows - j0);
+            const float* a = normalized_.data() + (m * rows + i0) * stride;
+            const float* b = normalized_.data() + (m * rows + j0) * stride;
+            std::fill(sums, sums + ni * nj, 0.0);
+            for (size_t k = 0; k < stride; k += kChunkSamples) {
+                const size_t n = std::min(kChunkSamples, stride - k);
+                kernels_->cross_products(a + k, ni, b + k, nj, stride, n, partial);
+                for (size_t q = 0; q < ni * nj; q++) sums[q] += static_cast<double>(partial[q]);
+            }
+
+            const char* valid = valid_.data() + m * rows;
+            double* matrix = out + m * rows * rows;
+            for (size_t i = 0; i < ni; i++) {
+                for (size_t j = 0; j < nj; j++) {
+                    const size_t row = i0 + i, col = j0 + j;
+                    double r = std::max(-1.0, std::min(1.0, sums[i * nj + j]));
+                    if (!valid[row] || !valid[col]) {
+                        r = nan;
+                    } else if (row == col) {
+                        r = 1.0;
+                    }
+                    matrix[row * rows + col] = matrix[col * rows + row] = r;
+                }
+            }
+        }
+    });
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "node_kernels.h"
+#include "worker_pool.h"
+
+enum class CorrelationMethod {
+    Pearson = 0,
+    Spearman = 1   // Pearson of the ranks, ties at their average rank
+};
+
+// Cross-row correlation matrices, the kernel of
+// server/correlation_analyzer.py (CorrelationAnalyzer), for many sessions
+// and several metrics in one call.
+//
+// Each row (one session's series of one metric) is centred and scaled to
+// unit length in double, ranked first for Spearman, and stored as float
+// padded to whole 16-sample chunks; a correlation is then the dot product
+// of two rows. The matrix is computed in tiles of kTileRows x kTileRows
+// over chunks of kChunkSamples samples, so both row blocks of a tile stay
+// in cache while every sample chunk streams through the node kernel table
+// (cross_products), and each chunk's float sums are added in double. Tiles
+// of the upper triangle of every metric are spread over the workers.
+//
+// A row with zero variance correlates as NaN with every row, itself
+// included, as numpy.corrcoef gives it; every other diagonal entry is 1.
+class CorrelationKernel {
+public:
+    static constexpr size_t kTileRows = 32;
+    static constexpr size_t kChunkSamples = 1024;
+
+    explicit CorrelationKernel(SimdLevel level = defaultSimdLevel(),
+                               const WorkerPoolConfig& config = WorkerPoolConfig());
+
+    // Runs on pool instead of a pool of its own (e.g. an engine's)
+    void shareWorkerPool(std::shared_ptr<WorkerPool> pool);
+    unsigned getWorkerCount() const { return pool_->size(); }
+    SimdLevel getSimdLevel() const { return kernels_->level; }
+
+    // Correlation matrices of `metrics` blocks of [rows x samples] values,
+    // block m at data + m * rows * samples, into out as `metrics` blocks
+    // of [rows x rows]. Input must be finite. Throws std::invalid_argument
+    // for fewer than 2 samples.
+    void compute(const float* data, size_t metrics, size_t rows, size_t samples, CorrelationMethod method,
+                 double* out);
+
+private:
+    const NodeKernels* kernels_;
+    std::shared_ptr<WorkerPool> pool_;
+    std::vector<float> normalized_;  // [metrics x rows x stride]
+    std::vector<char> valid_;        // [metrics x rows]
+};
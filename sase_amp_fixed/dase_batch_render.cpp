@@ -0,0 +1,80 @@
+// Batch renders of presets over test signals (batch_render.h), for
+// characterizing many presets in one native run instead of one Python-driven
+// replay per pair.
+//
+//   dase_batch_render MANIFEST --results PATH [--render-dir DIR]
+//                     [--nodes N] [--block N] [--threads N] [--no-ici]
+//
+// MANIFEST lists presets, inputs and optionally the jobs pairing them (every
+// preset over every input without any). One row per job goes to --results as
+// a session store that server/session_comparator.py opens directly;
+// --render-dir also keeps each job's audio as PRESET__INPUT.wav. One JSON
+// line with the batch's size and speed goes to stdout.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include "batch_render.h"
+#include "engine_benchmark.h"
+
+namespace {
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s MANIFEST --results PATH [--render-dir DIR]\n"
+                 "          [--nodes N] [--block N] [--threads N] [--no-ici]\n",
+                 argv0);
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BatchRenderConfig config;
+    std::string manifest_path, results_path;
+    for (int a = 1; a < argc; a++) {
+        const std::string arg = argv[a];
+        if (arg == "--no-ici") {
+            config.ici = false;
+            continue;
+        }
+        if (arg.compare(0, 2, "--") != 0) {
+            if (!manifest_path.empty()) return usage(argv[0]);
+            manifest_path = arg;
+            continue;
+        }
+        if (a + 1 >= argc) return usage(argv[0]);
+        const std::string value = argv[++a];
+        if (arg == "--results") {
+            results_path = value;
+        } else if (arg == "--render-dir") {
+            config.render_dir = value;
+        } else if (arg == "--nodes") {
+            config.nodes = static_cast<size_t>(std::max(1, std::atoi(value.c_str())));
+        } else if (arg == "--block") {
+            config.block_size = static_cast<size_t>(std::max(1, std::atoi(value.c_str())));
+        } else if (arg == "--threads") {
+            config.workers.num_threads = static_cast<unsigned>(std::max(0, std::atoi(value.c_str())));
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (manifest_path.empty() || results_path.empty()) return usage(argv[0]);
+
+    try {
+        const BatchRenderManifest manifest = BatchRenderManifest::load(manifest_path);
+        const BatchRenderStats stats = runBatchRender(manifest, results_path, config);
+        std::printf("{\"manifest\": %s, \"results\": %s, \"presets\": %zu, \"inputs\": %zu, \"jobs\": %zu, "
+                    "\"threads\": %u, \"audio_s\": %.3f, \"seconds\": %.3f, \"jobs_per_second\": %.2f, "
+                    "\"realtime_factor\": %.1f}\n",
+                    benchmarkJsonString(manifest_path).c_str(), benchmarkJsonString(results_path).c_str(),
+                    manifest.presets.size(), manifest.inputs.size(), stats.jobs, stats.threads,
+                    stats.audio_seconds, stats.seconds, stats.jobs_per_second, stats.realtime_factor);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "dase_batch_render: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
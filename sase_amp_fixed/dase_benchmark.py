@@ -341,6 +341,52 @@ class AnalogCircuitBenchmark:
             'scaling_analysis': self.analyze_scaling(results)
         }
     
+    def benchmark_simd_levels(self) -> Dict:
+        """Compare the node kernels of every SIMD level the host supports"""
+        print("\n=== SIMD Kernel Benchmark ===")
+
+        if not self.engine or not hasattr(dase_engine, 'SimdLevel'):
+            return {'status': 'skipped'}
+
+        levels = [dase_engine.SimdLevel.SCALAR, dase_engine.SimdLevel.SSE42,
+                  dase_engine.SimdLevel.AVX2, dase_engine.SimdLevel.AVX512,
+                  dase_engine.SimdLevel.NEON]
+        detected = dase_engine.detect_simd_level()
+        node_count = 4096
+        iterations = 50
+        results = []
+
+        for level in levels:
+            engine = dase_engine.AnalogCellularEngine(node_count)
+            engine.simd_level = level
+            if engine.simd_level != level:
+                continue  # Not available on this host
+
+            start_time = time.perf_counter()
+            for i in range(iterations):
+                engine.process_signal_wave(math.sin(i * 0.1), 0.5)
+            execution_time = time.perf_counter() - start_time
+
+            print(f"  {engine.kernel_name:10}: {execution_time / iterations * 1000:.3f} ms/wave")
+            results.append({
+                'level': level.name,
+                'kernel': engine.kernel_name,
+                'node_count': node_count,
+                'iterations': iterations,
+                'time_per_iteration_ms': execution_time / iterations * 1000
+            })
+
+        baseline = next((r for r in results if r['level'] == 'AVX2'), None)
+        if baseline:
+            for r in results:
+                r['speedup_vs_avx2'] = baseline['time_per_iteration_ms'] / r['time_per_iteration_ms']
+
+        return {
+            'status': 'completed',
+            'detected_level': detected.name,
+            'results': results
+        }
+
     def analyze_scaling(self, results: List[Dict]) -> Dict:
         """Analyze performance scaling characteristics"""
         valid_results = [r for r in results if 'error' not in r]
@@ -561,6 +607,7 @@ class AnalogCircuitBenchmark:
             'engine_available': engine_initialized,
             'basic_operations': self.benchmark_basic_operations(),
             'performance_scaling': self.benchmark_performance_scaling(),
+            'simd_levels': self.benchmark_simd_levels(),
             'numerical_accuracy': self.benchmark_accuracy(),
             'benchmark_duration_s': 0
         }
@@ -605,6 +652,16 @@ class AnalogCircuitBenchmark:
         
         print()
         
+        # SIMD kernel comparison
+        simd = results.get('simd_levels', {})
+        if simd.get('status') == 'completed':
+            print(f"SIMD Kernels (detected: {simd['detected_level']}):")
+            for r in simd['results']:
+                speedup = r.get('speedup_vs_avx2')
+                suffix = f" ({speedup:.2f}x vs AVX2)" if speedup is not None else ""
+                print(f"  {r['kernel']:15}: {r['time_per_iteration_ms']:.3f} ms/wave{suffix}")
+            print()
+
         # Accuracy Analysis  
         accuracy = results['numerical_accuracy']
         accuracy_tests = len([test for test in accuracy.values() 
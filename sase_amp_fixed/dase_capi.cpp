@@ -0,0 +1,273 @@
+#define DASE_CAPI_BUILD
+#include "dase_capi.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include "analog_universal_node_engine_avx2.h"
+
+static_assert(sizeof(dase_metrics_frame) == sizeof(EngineMetricsFrame) &&
+                  std::is_trivially_copyable<EngineMetricsFrame>::value,
+              "dase_metrics_frame must mirror EngineMetricsFrame");
+static_assert(offsetof(dase_metrics_frame, current_ns_per_op) == offsetof(EngineMetricsFrame, current_ns_per_op),
+              "dase_metrics_frame must mirror EngineMetricsFrame");
+static_assert(static_cast<int>(DASE_SIMD_NEON) == static_cast<int>(SimdLevel::NEON),
+              "dase_simd_level must match SimdLevel");
+
+// Exactly one of the engines is set
+struct dase_engine {
+    std::unique_ptr<AnalogCellularEngineAVX2> f64;
+    std::unique_ptr<AnalogCellularEngineF32> f32;
+};
+
+namespace {
+
+thread_local std::string g_last_error;
+
+dase_status fail(dase_status status, const char* what) {
+    g_last_error = what;
+    return status;
+}
+
+// Runs body and turns the engine's exceptions into status codes; nothing
+// may unwind into a C caller
+template <typename Body>
+dase_status guarded(Body&& body) {
+    try {
+        return body();
+    } catch (const std::bad_alloc&) {
+        return fail(DASE_ERROR_OUT_OF_MEMORY, "out of memory");
+    } catch (const std::out_of_range& e) {
+        return fail(DASE_ERROR_OUT_OF_RANGE, e.what());
+    } catch (const std::invalid_argument& e) {
+        return fail(DASE_ERROR_INVALID_ARGUMENT, e.what());
+    } catch (const std::exception& e) {
+        return fail(DASE_ERROR_RUNTIME, e.what());
+    } catch (...) {
+        return fail(DASE_ERROR_RUNTIME, "unknown error");
+    }
+}
+
+// body(engine) under the engine's call mutex, for either precision
+template <typename Handle, typename Body>
+dase_status withEngine(Handle* handle, Body&& body) {
+    if (!handle) return fail(DASE_ERROR_NULL_ARGUMENT, "engine is null");
+    return guarded([&] {
+        if (handle->f64) {
+            std::lock_guard<std::mutex> lock(handle->f64->callMutex());
+            return body(*handle->f64);
+        }
+        std::lock_guard<std::mutex> lock(handle->f32->callMutex());
+        return body(*handle->f32);
+    });
+}
+
+dase_status checkRange(size_t first, size_t count, size_t size) {
+    if (first > size || count > size - first) return fail(DASE_ERROR_OUT_OF_RANGE, "node range out of range");
+    return DASE_OK;
+}
+
+// Brings device-resident node state back before the columns are touched
+template <typename Engine>
+void hostColumns(const Engine& engine) {
+    if constexpr (std::is_same<Engine, AnalogCellularEngineAVX2>::value) engine.syncComputeBackend();
+}
+
+template <typename Engine>
+void readParams(const Engine& engine, dase_engine_params& params) {
+    params.harmonic_count = static_cast<uint32_t>(engine.getHarmonicCount());
+    params.worker_threads = engine.getWorkerCount();
+    params.simd_level = static_cast<uint32_t>(engine.getSimdLevel());
+    if constexpr (std::is_same<Engine, AnalogCellularEngineAVX2>::value) {
+        params.noise_level = engine.noise_level;
+        params.noise_injection = engine.getNoiseInjection() ? 1 : 0;
+    } else {
+        params.noise_level = 0.0;
+        params.noise_injection = 0;
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+uint32_t dase_abi_version(void) {
+    return DASE_ABI_VERSION;
+}
+
+const char* dase_status_string(dase_status status) {
+    switch (status) {
+        case DASE_OK: return "ok";
+        case DASE_ERROR_NULL_ARGUMENT: return "null argument";
+        case DASE_ERROR_INVALID_ARGUMENT: return "invalid argument";
+        case DASE_ERROR_OUT_OF_RANGE: return "out of range";
+        case DASE_ERROR_UNSUPPORTED: return "unsupported by this engine";
+        case DASE_ERROR_OUT_OF_MEMORY: return "out of memory";
+        case DASE_ERROR_RUNTIME: return "runtime error";
+    }
+    return "unknown status";
+}
+
+const char* dase_last_error(void) {
+    return g_last_error.c_str();
+}
+
+dase_status dase_engine_create(size_t num_nodes, dase_precision precision, dase_engine_t** out) {
+    if (!out) return fail(DASE_ERROR_NULL_ARGUMENT, "out is null");
+    *out = nullptr;
+    if (precision != DASE_PRECISION_F64 && precision != DASE_PRECISION_F32) {
+        return fail(DASE_ERROR_INVALID_ARGUMENT, "unknown precision");
+    }
+    return guarded([&] {
+        auto handle = std::make_unique<dase_engine>();
+        if (precision == DASE_PRECISION_F64) {
+            handle->f64 = std::make_unique<AnalogCellularEngineAVX2>(num_nodes);
+        } else {
+            handle->f32 = std::make_unique<AnalogCellularEngineF32>(num_nodes);
+        }
+        *out = handle.release();
+        return DASE_OK;
+    });
+}
+
+void dase_engine_destroy(dase_engine_t* engine) {
+    delete engine;
+}
+
+dase_status dase_engine_node_count(const dase_engine_t* engine, size_t* out) {
+    if (!out) return fail(DASE_ERROR_NULL_ARGUMENT, "out is null");
+    return withEngine(engine, [&](const auto& e) {
+        *out = e.getNodeCount();
+        return DASE_OK;
+    });
+}
+
+dase_status dase_engine_precision(const dase_engine_t* engine, dase_precision* out) {
+    if (!engine || !out) return fail(DASE_ERROR_NULL_ARGUMENT, "engine or out is null");
+    *out = engine->f64 ? DASE_PRECISION_F64 : DASE_PRECISION_F32;
+    return DASE_OK;
+}
+
+const char* dase_engine_kernel_name(const dase_engine_t* engine) {
+    if (!engine) return "";
+    return engine->f64 ? engine->f64->getKernelName() : engine->f32->getKernelName();
+}
+
+dase_status dase_engine_get_params(const dase_engine_t* engine, dase_engine_params* out) {
+    if (!out) return fail(DASE_ERROR_NULL_ARGUMENT, "out is null");
+    return withEngine(engine, [&](const auto& e) {
+        readParams(e, *out);
+        return DASE_OK;
+    });
+}
+
+dase_status dase_engine_set_params(dase_engine_t* engine, const dase_engine_params* params) {
+    if (!params) return fail(DASE_ERROR_NULL_ARGUMENT, "params is null");
+    if (params->harmonic_count > 64) return fail(DASE_ERROR_INVALID_ARGUMENT, "harmonic_count must be at most 64");
+    if (params->simd_level > DASE_SIMD_NEON) return fail(DASE_ERROR_INVALID_ARGUMENT, "unknown simd_level");
+    return withEngine(engine, [&](auto& e) {
+        using Engine = std::decay_t<decltype(e)>;
+        dase_engine_params current;
+        readParams(e, current);
+        if (params->harmonic_count != current.harmonic_count) e.setHarmonicCount(params->harmonic_count);
+        if (params->simd_level != current.simd_level) e.setSimdLevel(static_cast<SimdLevel>(params->simd_level));
+        if (params->worker_threads != current.worker_threads) {
+            WorkerPoolConfig config;
+            if constexpr (std::is_same<Engine, AnalogCellularEngineAVX2>::value) config = e.getWorkerConfig();
+            config.num_threads = params->worker_threads;
+            e.configureWorkers(config);
+        }
+        if constexpr (std::is_same<Engine, AnalogCellularEngineAVX2>::value) {
+            e.noise_level = params->noise_level;
+            e.setNoiseInjection(params->noise_injection != 0);
+        }
+        return DASE_OK;
+    });
+}
+
+dase_status dase_engine_process_block(dase_engine_t* engine, const float* in, const float* control,
+                                      const float* aux, float* out, size_t n) {
+    if (n > 0 && !in) return fail(DASE_ERROR_NULL_ARGUMENT, "in is null");
+    return withEngine(engine, [&](auto& e) {
+        e.processBlock(in, control, aux, out, n);
+        return DASE_OK;
+    });
+}
+
+dase_status dase_engine_process_chromatic_block(dase_engine_t* engine, const float* in, size_t n,
+                                                const dase_chromatic_config* config, float* out) {
+    if (n > 0 && (!in || !out)) return fail(DASE_ERROR_NULL_ARGUMENT, "in or out is null");
+    return withEngine(engine, [&](auto& e) {
+        if constexpr (std::is_same<std::decay_t<decltype(e)>, AnalogCellularEngineAVX2>::value) {
+            ChromaticBlockConfig block;
+            if (config) {
+                block.num_channels = config->num_channels;
+                block.node_stride = config->node_stride;
+                block.sample_rate = config->sample_rate;
+                block.phi_phase = config->phi_phase;
+                block.phi_depth = config->phi_depth;
+            }
+            e.processChromaticBlock(in, n, block, out);
+            return DASE_OK;
+        } else {
+            return fail(DASE_ERROR_UNSUPPORTED, "chromatic blocks need an F64 engine");
+        }
+    });
+}
+
+dase_status dase_engine_get_outputs(const dase_engine_t* engine, size_t first, size_t count, double* out) {
+    if (count > 0 && !out) return fail(DASE_ERROR_NULL_ARGUMENT, "out is null");
+    return withEngine(engine, [&](const auto& e) {
+        if (dase_status status = checkRange(first, count, e.bank.size())) return status;
+        hostColumns(e);
+        std::copy(e.bank.current_output + first, e.bank.current_output + first + count, out);
+        return DASE_OK;
+    });
+}
+
+dase_status dase_engine_set_feedback(dase_engine_t* engine, size_t first, size_t count, const double* gains) {
+    if (count > 0 && !gains) return fail(DASE_ERROR_NULL_ARGUMENT, "gains is null");
+    return withEngine(engine, [&](auto& e) {
+        using Scalar = std::remove_reference_t<decltype(*e.bank.feedback_gain)>;
+        if (dase_status status = checkRange(first, count, e.bank.size())) return status;
+        hostColumns(e);
+        // Same clamp as the node setters
+        for (size_t i = 0; i < count; i++) {
+            e.bank.feedback_gain[first + i] = clamp_custom(static_cast<Scalar>(gains[i]), Scalar(-2), Scalar(2));
+        }
+        return DASE_OK;
+    });
+}
+
+dase_status dase_engine_reset_state(dase_engine_t* engine) {
+    return withEngine(engine, [&](auto& e) {
+        hostColumns(e);
+        e.bank.resetState();
+        return DASE_OK;
+    });
+}
+
+dase_status dase_engine_get_metrics(const dase_engine_t* engine, dase_metrics_frame* out) {
+    if (!out) return fail(DASE_ERROR_NULL_ARGUMENT, "out is null");
+    return withEngine(engine, [&](const auto& e) {
+        EngineMetricsFrame frame;
+        e.getMetricsFrame(frame);
+        std::memcpy(out, &frame, sizeof(frame));
+        return DASE_OK;
+    });
+}
+
+dase_status dase_engine_reset_metrics(dase_engine_t* engine) {
+    return withEngine(engine, [&](auto& e) {
+        e.resetMetrics();
+        return DASE_OK;
+    });
+}
+
+} // extern "C"
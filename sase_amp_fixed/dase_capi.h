@@ -0,0 +1,155 @@
+#ifndef DASE_CAPI_H
+#define DASE_CAPI_H
+
+/*
+ * Plain C interface to the D-ASE engine, for hosts that cannot use the
+ * pybind11 module: ctypes/cffi, plugin hosts, Rust or Go services.
+ *
+ * Engines are opaque handles. Every buffer is owned by the caller and used
+ * only for the duration of the call; nothing is copied into or out of
+ * intermediate containers. Functions return a dase_status and never throw;
+ * on failure dase_last_error() describes the most recent error of the
+ * calling thread.
+ *
+ * Calls into one handle from several threads are serialized on the engine's
+ * call mutex (the same one the Python module holds), so a handle may be
+ * shared with Python code that wraps the same engine. Built as
+ * libdase_engine by `make capi`.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#if defined(DASE_CAPI_BUILD)
+#define DASE_API __declspec(dllexport)
+#else
+#define DASE_API __declspec(dllimport)
+#endif
+#else
+#define DASE_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Bumped whenever a struct layout or function signature changes */
+#define DASE_ABI_VERSION 1
+
+typedef struct dase_engine dase_engine_t;
+
+typedef enum dase_status {
+    DASE_OK = 0,
+    DASE_ERROR_NULL_ARGUMENT = 1,
+    DASE_ERROR_INVALID_ARGUMENT = 2,
+    DASE_ERROR_OUT_OF_RANGE = 3,
+    DASE_ERROR_UNSUPPORTED = 4,   /* Not offered by this engine precision */
+    DASE_ERROR_OUT_OF_MEMORY = 5,
+    DASE_ERROR_RUNTIME = 6
+} dase_status;
+
+/* Node state precision of an engine */
+typedef enum dase_precision {
+    DASE_PRECISION_F64 = 0,  /* AnalogCellularEngineAVX2 */
+    DASE_PRECISION_F32 = 1   /* AnalogCellularEngineF32, processing subset */
+} dase_precision;
+
+/* Instruction set of the node kernels; values match the engine's SimdLevel */
+typedef enum dase_simd_level {
+    DASE_SIMD_SCALAR = 0,
+    DASE_SIMD_SSE42 = 1,
+    DASE_SIMD_AVX2 = 2,
+    DASE_SIMD_AVX512 = 3,
+    DASE_SIMD_NEON = 4
+} dase_simd_level;
+
+/*
+ * Tunables of an engine. Read them with dase_engine_get_params, change the
+ * fields of interest and write them back; set_params only touches what
+ * differs. noise_level and noise_injection apply to F64 engines and are
+ * ignored by F32 ones.
+ */
+typedef struct dase_engine_params {
+    double noise_level;
+    uint32_t noise_injection;  /* 0 or 1 */
+    uint32_t harmonic_count;   /* 0 .. 64 */
+    uint32_t worker_threads;   /* Changing it restarts the worker pool */
+    uint32_t simd_level;       /* dase_simd_level; falls back to what the host supports */
+} dase_engine_params;
+
+/* Chromatic field block settings (ChromaticBlockConfig) */
+typedef struct dase_chromatic_config {
+    size_t num_channels;
+    size_t node_stride;  /* Channel c runs through node c * node_stride */
+    double sample_rate;
+    double phi_phase;    /* Radians */
+    double phi_depth;
+} dase_chromatic_config;
+
+/* Metrics snapshot, layout identical to the engine's EngineMetricsFrame */
+typedef struct dase_metrics_frame {
+    uint64_t total_execution_time_ns;
+    uint64_t avx2_operation_time_ns;
+    uint64_t total_operations;
+    uint64_t avx2_operations;
+    uint64_t node_processes;
+    uint64_t harmonic_generations;
+    uint64_t profiled_scopes;
+    uint64_t hw_counters_available;
+    uint64_t hw_cycles;
+    uint64_t hw_instructions;
+    uint64_t hw_l1d_misses;
+    uint64_t hw_llc_misses;
+    uint64_t hw_branch_misses;
+    double current_ns_per_op;
+    double current_ops_per_second;
+    double speedup_factor;
+    double profiling_overhead_ns;
+    double instructions_per_cycle;
+} dase_metrics_frame;
+
+/* DASE_ABI_VERSION the library was built with */
+DASE_API uint32_t dase_abi_version(void);
+/* Static description of a status code */
+DASE_API const char* dase_status_string(dase_status status);
+/* Message of the calling thread's most recent failed call, empty if none.
+ * Valid until that thread's next failure. */
+DASE_API const char* dase_last_error(void);
+
+DASE_API dase_status dase_engine_create(size_t num_nodes, dase_precision precision, dase_engine_t** out);
+/* Null is ignored */
+DASE_API void dase_engine_destroy(dase_engine_t* engine);
+
+DASE_API dase_status dase_engine_node_count(const dase_engine_t* engine, size_t* out);
+DASE_API dase_status dase_engine_precision(const dase_engine_t* engine, dase_precision* out);
+/* Name of the selected node kernels, static string */
+DASE_API const char* dase_engine_kernel_name(const dase_engine_t* engine);
+
+DASE_API dase_status dase_engine_get_params(const dase_engine_t* engine, dase_engine_params* out);
+DASE_API dase_status dase_engine_set_params(dase_engine_t* engine, const dase_engine_params* params);
+
+/* Advances every node through n samples of in. control may be null (1.0),
+ * aux null (0.0). out, if not null, receives node_count * n outputs, node
+ * major. */
+DASE_API dase_status dase_engine_process_block(dase_engine_t* engine, const float* in, const float* control,
+                                               const float* aux, float* out, size_t n);
+/* Chromatic field block: out receives num_channels * n samples, channel
+ * major. F64 engines only; a null config uses the engine defaults. */
+DASE_API dase_status dase_engine_process_chromatic_block(dase_engine_t* engine, const float* in, size_t n,
+                                                         const dase_chromatic_config* config, float* out);
+
+/* Node state, count nodes from first */
+DASE_API dase_status dase_engine_get_outputs(const dase_engine_t* engine, size_t first, size_t count, double* out);
+DASE_API dase_status dase_engine_set_feedback(dase_engine_t* engine, size_t first, size_t count,
+                                              const double* gains);
+DASE_API dase_status dase_engine_reset_state(dase_engine_t* engine);
+
+DASE_API dase_status dase_engine_get_metrics(const dase_engine_t* engine, dase_metrics_frame* out);
+DASE_API dase_status dase_engine_reset_metrics(dase_engine_t* engine);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* DASE_CAPI_H */
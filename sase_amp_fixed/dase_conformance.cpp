@@ -0,0 +1,731 @@
+// Conformance of every SIMD level of the node kernel table against
+// high-precision scalar references, with the speed of each level next to it.
+//
+//   dase_conformance [--filter TEXT] [--simd LEVEL] [--seed N] [--samples N]
+//                    [--repeats N] [--sample-ms MS] [--min-speedup X]
+//
+// Each case feeds a kernel seeded random inputs over its working domain plus
+// edge cases (zeros, signed zeros, denormals, multiples of pi / 2, clamp
+// bounds) and compares every output with a long double evaluation of the
+// kernel's documented formula. Errors are reported in units in the last
+// place of the kernel's output precision, at the larger of the reference
+// and the case's scale (the row's peak for recursive filters and node
+// blocks, the sum of term magnitudes for dot products), so cancellation does
+// not read as an error; the largest absolute error is shown next to them.
+// Results also go against the scalar table's, which every run includes, to
+// show where a port diverges from the portable code.
+//
+// A level is accepted when its errors stay within the case's limits and it
+// is at least --min-speedup times as fast as the scalar table; the exit
+// status is 1 when any level is rejected. Denormal references may come back
+// flushed to zero, since the engine builds with -ffast-math. --repeats 0
+// skips the timing.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <random>
+#include <string>
+#include <vector>
+#include "control_wave.h"
+#include "node_kernels.h"
+#include "node_kernels_impl.h"
+#include "philox.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Real = long double;
+
+constexpr double kInf = std::numeric_limits<double>::infinity();
+constexpr Real kPi = 3.141592653589793238462643383279502884L;
+
+// Keeps kernel results observable so the work cannot be optimized away
+volatile double g_sink = 0.0;
+
+struct Options {
+    std::string filter;
+    bool all_levels = true;
+    SimdLevel level = SimdLevel::Scalar;
+    uint64_t seed = 1;
+    size_t samples = size_t{1} << 16;
+    int repeats = 7;
+    double sample_ms = 5.0;
+    double min_speedup = 0.95;
+};
+
+// Output precision a case's ULPs are counted in
+enum class Unit { F32, F64 };
+
+// One level's run of a case
+class Trial {
+public:
+    Trial(Unit unit, uint64_t seed, const Options& opt) : rng(seed), samples(opt.samples), unit_(unit), opt_(opt) {}
+
+    std::mt19937_64 rng;
+    const size_t samples;   // Elementwise inputs per case, a multiple of 16
+
+    float uniform(double low, double high) {
+        return static_cast<float>(std::uniform_real_distribution<double>(low, high)(rng));
+    }
+    // Random sign and magnitude 2^e, e uniform in [low_exp, high_exp]
+    float logUniform(double low_exp, double high_exp) {
+        const double e = std::uniform_real_distribution<double>(low_exp, high_exp)(rng);
+        return static_cast<float>((rng() & 1 ? -1.0 : 1.0) * std::exp2(e));
+    }
+
+    // One output against its reference, in ULPs at max(|ref|, scale)
+    void compare(double value, Real ref, double scale = 0.0) {
+        const double min_normal = unit_ == Unit::F32 ? std::numeric_limits<float>::min()
+                                                     : std::numeric_limits<double>::min();
+        const double at = std::max(static_cast<double>(std::fabs(ref)), scale);
+        double ulps = 0.0, abs_error = 0.0;
+        if (!(at < min_normal && std::fabs(value) < min_normal)) {
+            abs_error = static_cast<double>(std::fabs(static_cast<Real>(value) - ref));
+            ulps = abs_error / ulp(at);
+        }
+        if (!(ulps <= max_ulp)) max_ulp = ulps;   // NaN sticks
+        if (!(abs_error <= max_abs)) max_abs = abs_error;
+        sum_ulp += ulps;
+        outputs.push_back(value);
+        scales.push_back(scale);
+    }
+    // An exact output (bytes, counts) off its reference by more than the
+    // allowed slack
+    void mismatch() { mismatches++; }
+
+    // Median time per element of fn, unless timing is off
+    void time(size_t elements, const std::function<void()>& fn) {
+        if (opt_.repeats <= 0) return;
+        const auto warm_start = Clock::now();
+        size_t runs = 0;
+        do {
+            fn();
+            runs++;
+        } while (Clock::now() - warm_start < std::chrono::milliseconds(2));
+        const double warm_ns = std::chrono::duration<double, std::nano>(Clock::now() - warm_start).count();
+        const size_t batch = std::max<size_t>(1, static_cast<size_t>(opt_.sample_ms * 1e6 * runs / warm_ns));
+        std::vector<double> ns(opt_.repeats);
+        for (double& sample : ns) {
+            const auto t0 = Clock::now();
+            for (size_t k = 0; k < batch; k++) fn();
+            sample = std::chrono::duration<double, std::nano>(Clock::now() - t0).count() /
+                     (static_cast<double>(batch) * static_cast<double>(elements));
+        }
+        std::sort(ns.begin(), ns.end());
+        ns_per_element = ns[ns.size() / 2];
+    }
+
+    double ulp(double at) const {
+        const double min_normal = unit_ == Unit::F32 ? std::numeric_limits<float>::min()
+                                                     : std::numeric_limits<double>::min();
+        return std::ldexp(1.0, std::ilogb(std::max(at, min_normal)) - (unit_ == Unit::F32 ? 23 : 52));
+    }
+
+    double max_ulp = 0.0;
+    double sum_ulp = 0.0;
+    double max_abs = 0.0;
+    size_t mismatches = 0;
+    double ns_per_element = 0.0;
+    std::vector<double> outputs;
+    std::vector<double> scales;
+
+private:
+    Unit unit_;
+    const Options& opt_;
+};
+
+struct Case {
+    std::string name;
+    Unit unit;
+    double ulp_limit;   // Largest accepted error in ULPs
+    double abs_limit;   // Largest accepted absolute error
+    std::function<void(const NodeKernels&, Trial&)> run;
+};
+
+// Mean of sin(base * m) over the spectral multipliers, the boost the node
+// kernels add; the product is taken in float, as the kernels form it
+Real spectralReference(float base) {
+    Real sum = 0.0L;
+    for (float m : node_kernels::kSpectralMults) sum += std::sin(static_cast<Real>(base * m));
+    return sum / 8.0L;
+}
+
+// Inputs of the elementwise sin / cos cases: edge cases first, then the
+// engine's working range, the documented range and tiny magnitudes
+std::vector<float> trigInputs(Trial& trial, float limit) {
+    std::vector<float> x = {0.0f, -0.0f, std::numeric_limits<float>::min(), -std::numeric_limits<float>::min(),
+                            1e-40f, -1e-40f, limit, -limit};
+    for (int k = 1; k <= 64; k++) {
+        const float q = static_cast<float>(k) * 1.57079632679489662f;
+        x.push_back(q);
+        x.push_back(-q);
+    }
+    while (x.size() < trial.samples) {
+        switch (x.size() % 4) {
+            case 0:
+            case 1: x.push_back(trial.uniform(-100.0, 100.0)); break;
+            case 2: x.push_back(trial.uniform(-limit, limit)); break;
+            default: {
+                // Near a multiple of pi / 2, where range reduction cancels
+                const float k = std::floor(trial.uniform(0.0, limit / 1.5707963f));
+                x.push_back(k * 1.57079632679489662f + trial.uniform(-1e-3, 1e-3));
+            }
+        }
+    }
+    x.resize(trial.samples);
+    return x;
+}
+
+void addMathCases(std::vector<Case>& cases) {
+    cases.push_back({"sincos_lanes", Unit::F32, kInf, 1.5e-7, [](const NodeKernels& k, Trial& trial) {
+        const std::vector<float> x = trigInputs(trial, 1e4f);
+        std::vector<float> s(x.size()), c(x.size());
+        k.sincos_lanes(x.data(), s.data(), c.data(), x.size());
+        for (size_t i = 0; i < x.size(); i++) {
+            trial.compare(s[i], std::sin(static_cast<Real>(x[i])));
+            trial.compare(c[i], std::cos(static_cast<Real>(x[i])));
+        }
+        trial.time(x.size(), [&] {
+            k.sincos_lanes(x.data(), s.data(), c.data(), x.size());
+            g_sink = g_sink + s[7];
+        });
+    }});
+
+    // Node outputs and offsets span the clamp range and a period
+    cases.push_back({"harmonics", Unit::F32, kInf, 1.5e-7, [](const NodeKernels& k, Trial& trial) {
+        const size_t calls = trial.samples / 8;
+        std::vector<float> input(calls), offset(calls);
+        for (size_t c = 0; c < calls; c++) {
+            input[c] = c == 0 ? 0.0f : trial.uniform(-10.0, 10.0);
+            offset[c] = c == 0 ? 0.0f : trial.uniform(-3.2, 3.2);
+        }
+        alignas(64) float out[8];
+        for (size_t c = 0; c < calls; c++) {
+            k.harmonics(input[c], offset[c], out);
+            for (int h = 0; h < 8; h++) {
+                const Real arg = (h + 1) * static_cast<Real>(input[c]) + offset[c];
+                trial.compare(out[h], std::sin(arg) * 0.1L / (h + 1), 0.1 / (h + 1));
+            }
+        }
+        trial.time(calls, [&] {
+            float acc = 0.0f;
+            for (size_t c = 0; c < calls; c++) {
+                k.harmonics(input[c], offset[c], out);
+                acc += out[7];
+            }
+            g_sink = g_sink + acc;
+        });
+    }});
+
+    // Boost arguments: an amplified node input plus aux
+    cases.push_back({"spectral", Unit::F32, 8.0, 3e-7, [](const NodeKernels& k, Trial& trial) {
+        std::vector<float> base(trial.samples / 8);
+        for (size_t i = 0; i < base.size(); i++) base[i] = i == 0 ? 0.0f : trial.uniform(-20.0, 20.0);
+        for (float b : base) trial.compare(k.spectral(b), spectralReference(b), 1.0);
+        trial.time(base.size(), [&] {
+            float acc = 0.0f;
+            for (float b : base) acc += k.spectral(b);
+            g_sink = g_sink + acc;
+        });
+    }});
+
+    cases.push_back({"spectral_lanes", Unit::F32, 8.0, 3e-7, [](const NodeKernels& k, Trial& trial) {
+        std::vector<float> base(trial.samples), boost(trial.samples);
+        for (size_t i = 0; i < base.size(); i++) base[i] = i < 2 ? 0.0f : trial.uniform(-20.0, 20.0);
+        k.spectral_lanes(base.data(), boost.data(), base.size());
+        for (size_t i = 0; i < base.size(); i++) trial.compare(boost[i], spectralReference(base[i]), 1.0);
+        trial.time(base.size(), [&] {
+            k.spectral_lanes(base.data(), boost.data(), base.size());
+            g_sink = g_sink + boost[9];
+        });
+    }});
+
+    // Philox words are exact integers; the reference takes Box-Muller from
+    // there in long double, with the angle on the exact 2 pi / 2^24 grid.
+    // ULPs are counted at sigma or, past it, at the sample's radius, which
+    // the angle's error scales; the limit is absolute, since the radius of u
+    // rounded to float near 1 carries a large relative error.
+    cases.push_back({"gaussian_noise", Unit::F32, kInf, 6e-5, [](const NodeKernels& k, Trial& trial) {
+        const uint64_t seed = trial.rng(), stream = trial.rng() & 0xFFFF;
+        const uint64_t first = 4 * (trial.rng() & 0xFFFFFF) + 3;  // Starts mid-block
+        const float sigma = 1.5f;
+        std::vector<float> out(trial.samples - 5);
+        k.gaussian_noise(seed, stream, first, sigma, out.data(), out.size());
+        const Real step = 1.0L / 16777216.0L;
+        for (size_t j = 0; j < out.size(); j++) {
+            const uint64_t sample = first + j;
+            const uint64_t block = sample / 4;
+            uint32_t ctr[4] = {static_cast<uint32_t>(block), static_cast<uint32_t>(block >> 32),
+                               static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)};
+            philox::block(ctr, static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32));
+            const int pair = sample % 4 < 2 ? 0 : 2;
+            const Real u = ((ctr[pair] >> 8) + 0.5L) * step;
+            const Real angle = (ctr[pair + 1] >> 8) * step * 2.0L * kPi;
+            const Real radius = std::sqrt(-2.0L * std::log(u));
+            const Real ref = sigma * radius * (sample % 2 == 0 ? std::cos(angle) : std::sin(angle));
+            trial.compare(out[j], ref, static_cast<double>(sigma * std::max(radius, 1.0L)));
+        }
+        trial.time(out.size(), [&] {
+            k.gaussian_noise(seed, stream, first, sigma, out.data(), out.size());
+            g_sink = g_sink + out[5];
+        });
+    }});
+}
+
+// Sum of products of a and b rows, with the sum of their magnitudes as scale
+Real dot(const float* a, const float* b, size_t n, double& scale) {
+    Real sum = 0.0L, magnitude = 0.0L;
+    for (size_t t = 0; t < n; t++) {
+        sum += static_cast<Real>(a[t]) * b[t];
+        magnitude += std::fabs(static_cast<Real>(a[t]) * b[t]);
+    }
+    scale = static_cast<double>(magnitude);
+    return sum;
+}
+
+void addLinearCases(std::vector<Case>& cases) {
+    constexpr size_t n = 256;   // A multiple of 16
+    constexpr size_t stride = n + 16;
+
+    cases.push_back({"pair_products", Unit::F32, 4.0, kInf, [](const NodeKernels& k, Trial& trial) {
+        constexpr size_t count = 13;   // Blocks of four rows j and a remainder
+        std::vector<float> rows(count * stride), out(count * count, 0.0f);
+        for (float& v : rows) v = trial.uniform(-1.0, 1.0);
+        k.pair_products(rows.data(), count, stride, n, out.data());
+        for (size_t i = 0; i < count; i++) {
+            for (size_t j = i + 1; j < count; j++) {
+                double scale = 0.0;
+                const Real ref = dot(rows.data() + i * stride, rows.data() + j * stride, n, scale);
+                trial.compare(out[i * count + j], ref, scale);
+                trial.compare(out[j * count + i], ref, scale);
+            }
+        }
+        trial.time(count * (count - 1) / 2 * n, [&] {
+            k.pair_products(rows.data(), count, stride, n, out.data());
+            g_sink = g_sink + out[1];
+        });
+    }});
+
+    cases.push_back({"cross_products", Unit::F32, 4.0, kInf, [](const NodeKernels& k, Trial& trial) {
+        constexpr size_t a_count = 5, b_count = 7;
+        std::vector<float> a(a_count * stride), b(b_count * stride), out(a_count * b_count);
+        for (float& v : a) v = trial.uniform(-1.0, 1.0);
+        for (float& v : b) v = trial.uniform(-1.0, 1.0);
+        k.cross_products(a.data(), a_count, b.data(), b_count, stride, n, out.data());
+        for (size_t i = 0; i < a_count; i++) {
+            for (size_t j = 0; j < b_count; j++) {
+                double scale = 0.0;
+                const Real ref = dot(a.data() + i * stride, b.data() + j * stride, n, scale);
+                trial.compare(out[i * b_count + j], ref, scale);
+            }
+        }
+        trial.time(a_count * b_count * n, [&] {
+            k.cross_products(a.data(), a_count, b.data(), b_count, stride, n, out.data());
+            g_sink = g_sink + out[2];
+        });
+    }});
+
+    // Any n: 1000 leaves a tail on every level
+    cases.push_back({"mix_rows", Unit::F32, 4.0, kInf, [](const NodeKernels& k, Trial& trial) {
+        constexpr size_t count = 8, outputs = 3, m = 1000;
+        std::vector<float> rows(count * m), weights(outputs * count), mixed(outputs * m);
+        for (float& v : rows) v = trial.uniform(-1.0, 1.0);
+        for (float& w : weights) w = trial.uniform(-1.0, 1.0);
+        float* out[outputs] = {mixed.data(), mixed.data() + m, mixed.data() + 2 * m};
+        k.mix_rows(rows.data(), count, static_cast<ptrdiff_t>(m), weights.data(), outputs, out, m);
+        for (size_t o = 0; o < outputs; o++) {
+            for (size_t t = 0; t < m; t++) {
+                Real ref = 0.0L, scale = 0.0L;
+                for (size_t r = 0; r < count; r++) {
+                    const Real term = static_cast<Real>(weights[o * count + r]) * rows[r * m + t];
+                    ref += term;
+                    scale += std::fabs(term);
+                }
+                trial.compare(out[o][t], ref, static_cast<double>(scale));
+            }
+        }
+        trial.time(outputs * count * m, [&] {
+            k.mix_rows(rows.data(), count, static_cast<ptrdiff_t>(m), weights.data(), outputs, out, m);
+            g_sink = g_sink + mixed[3];
+        });
+    }});
+
+    // 200 real bins padded to a stride of 256, the rest zero
+    cases.push_back({"spectrum_mac", Unit::F32, 4.0, kInf, [](const NodeKernels& k, Trial& trial) {
+        constexpr size_t count = 16, bins = 200, span = 256;
+        std::vector<float> x(count * 2 * span, 0.0f), h(count * 2 * span, 0.0f), out(2 * span);
+        std::vector<const float*> spectra(count);
+        for (size_t p = 0; p < count; p++) {
+            spectra[p] = x.data() + p * 2 * span;
+            for (size_t b = 0; b < bins; b++) {
+                x[p * 2 * span + b] = trial.uniform(-1.0, 1.0);
+                x[p * 2 * span + span + b] = trial.uniform(-1.0, 1.0);
+                h[p * 2 * span + b] = trial.uniform(-1.0, 1.0);
+                h[p * 2 * span + span + b] = trial.uniform(-1.0, 1.0);
+            }
+        }
+        k.spectrum_mac(spectra.data(), h.data(), count, span, out.data());
+        for (size_t b = 0; b < span; b++) {
+            Real re = 0.0L, im = 0.0L, scale = 0.0L;
+            for (size_t p = 0; p < count; p++) {
+                const Real xr = spectra[p][b], xi = spectra[p][span + b];
+                const Real hr = h[p * 2 * span + b], hi = h[p * 2 * span + span + b];
+                re += xr * hr - xi * hi;
+                im += xr * hi + xi * hr;
+                scale += std::fabs(xr * hr) + std::fabs(xi * hi) + std::fabs(xr * hi) + std::fabs(xi * hr);
+            }
+            trial.compare(out[b], re, static_cast<double>(scale));
+            trial.compare(out[span + b], im, static_cast<double>(scale));
+        }
+        trial.time(count * span, [&] {
+            k.spectrum_mac(spectra.data(), h.data(), count, span, out.data());
+            g_sink = g_sink + out[5];
+        });
+    }});
+}
+
+// Peak magnitude of a row of references, the scale of recursive outputs
+double rowPeak(const std::vector<Real>& row) {
+    Real peak = 0.0L;
+    for (Real v : row) peak = std::max(peak, std::fabs(v));
+    return static_cast<double>(peak);
+}
+
+void addFilterCases(std::vector<Case>& cases) {
+    // Two-section cascades of assorted shapes on their own inputs; the
+    // reference runs the bank's float coefficients in long double. A float
+    // recursion's error grows with its poles' radius: plain float code of
+    // the same form is about 1000 ulp of the peak off on these designs.
+    cases.push_back({"biquad_block", Unit::F32, 4096.0, kInf, [](const NodeKernels& k, Trial& trial) {
+        constexpr size_t nodes = 24, sections = 2, n = 512;
+        const FilterShape shapes[] = {FilterShape::LowPass, FilterShape::HighPass, FilterShape::BandPass,
+                                      FilterShape::Peak, FilterShape::Notch, FilterShape::AllPass};
+        FilterNodeBank bank(nodes, sections);
+        for (size_t i = 0; i < nodes; i++) {
+            for (size_t s = 0; s < sections; s++) {
+                const FilterShape shape = shapes[(i + s) % 6];
+                const double hz = std::exp2(trial.uniform(std::log2(200.0), std::log2(12000.0)));
+                bank.setBiquad(i, s, designBiquad(shape, hz, trial.uniform(0.5, 2.0), 48000.0, trial.uniform(-12, 12)));
+            }
+        }
+        std::vector<float> in(nodes * n), out(nodes * n);
+        for (float& v : in) v = trial.uniform(-1.0, 1.0);
+        for (size_t t = 0; t < 4; t++) in[t] = 0.0f;   // Leading silence
+        k.biquad_block(bank, 0, nodes, in.data(), n, out.data(), n);
+
+        std::vector<Real> row(n);
+        for (size_t i = 0; i < nodes; i++) {
+            for (size_t t = 0; t < n; t++) row[t] = in[i * n + t];
+            for (size_t s = 0; s < sections; s++) {
+                const BiquadCoefficients c = bank.biquad(i, s);
+                Real z1 = 0.0L, z2 = 0.0L;
+                for (size_t t = 0; t < n; t++) {
+                    const Real x = row[t];
+                    const Real y = c.b0 * x + z1;
+                    z1 = c.b1 * x - c.a1 * y + z2;
+                    z2 = c.b2 * x - c.a2 * y;
+                    row[t] = y;
+                }
+            }
+            const double peak = rowPeak(row);
+            for (size_t t = 0; t < n; t++) trial.compare(out[i * n + t], row[t], peak);
+        }
+        trial.time(nodes * n, [&] {
+            k.biquad_block(bank, 0, nodes, in.data(), n, out.data(), n);
+            g_sink = g_sink + out[11];
+        });
+    }});
+
+    // Hue on the log axis rotated by the Φ phase, gamma lightness and the
+    // RGBA bytes, over frequencies and amplitudes past both clamp ends
+    cases.push_back({"color_map", Unit::F32, 64.0, kInf, [](const NodeKernels& k, Trial& trial) {
+        ColorMapParams p{20.0f, 2000.0f, true, 1.0f / 2.2f, 0.8f, true, 77.3f, 1.0f, 255};
+        std::vector<float> frequency = {20.0f, 2000.0f, 5.0f, 9000.0f, 440.0f};
+        std::vector<float> amplitude = {0.0f, 1.0f, -0.5f, 2.0f, 1e-30f};
+        while (frequency.size() < trial.samples / 4) {
+            frequency.push_back(std::exp2(trial.uniform(std::log2(10.0), std::log2(5000.0))));
+            amplitude.push_back(trial.uniform(-0.1, 1.2));
+        }
+        const size_t n = frequency.size();
+        std::vector<float> hsl(3 * n);
+        std::vector<uint8_t> rgba(4 * n);
+        k.color_map(frequency.data(), amplitude.data(), n, p, hsl.data(), rgba.data());
+
+        const Real axis_min = std::log(static_cast<Real>(p.min_frequency));
+        const Real axis_max = std::log(static_cast<Real>(p.max_frequency));
+        for (size_t j = 0; j < n; j++) {
+            const Real f = std::min<Real>(std::max<Real>(frequency[j], p.min_frequency), p.max_frequency);
+            Real hue = (std::log(f) - axis_min) / (axis_max - axis_min) * 360.0L + p.rotation;
+            hue -= 360.0L * std::floor(hue / 360.0L);
+            const Real a = std::min<Real>(std::max<Real>(amplitude[j], 0.0L), 1.0L);
+            const Real light = (a > 0.0L ? std::pow(a, static_cast<Real>(p.inv_gamma)) : 0.0L) * p.lightness_gain;
+
+            // Hue wraps at 360: compare on the circle
+            double got = hsl[3 * j];
+            if (got - hue > 180.0L) got -= 360.0;
+            if (hue - got > 180.0L) got += 360.0;
+            trial.compare(got, hue, 360.0);
+            trial.compare(hsl[3 * j + 2], light, 1.0 / 255.0);
+
+            const Real chroma = p.saturation * std::min(light, 1.0L - light);
+            const Real offsets[3] = {0.0L, 8.0L, 4.0L};
+            for (int c = 0; c < 3; c++) {
+                Real kk = offsets[c] + hue / 30.0L;
+                kk -= 12.0L * std::floor(kk / 12.0L);
+                const Real w = std::max(-1.0L, std::min(1.0L, std::min(kk - 3.0L, 9.0L - kk)));
+                const Real v = std::max(0.0L, std::min(1.0L, light - chroma * w)) * 255.0L;
+                if (std::fabs(rgba[4 * j + c] - v) > 1.0L) trial.mismatch();
+            }
+            if (rgba[4 * j + 3] != p.alpha) trial.mismatch();
+        }
+        trial.time(n, [&] {
+            k.color_map(frequency.data(), amplitude.data(), n, p, hsl.data(), rgba.data());
+            g_sink = g_sink + hsl[3];
+        });
+    }});
+}
+
+// Random per-node parameters; some clamp bounds close enough to bite
+template <typename Bank>
+void randomNodes(Bank& bank, Trial& trial) {
+    using Scalar = typename Bank::value_type;
+    for (size_t i = 0; i < bank.capacity(); i++) {
+        bank.input_gain[i] = static_cast<Scalar>(trial.uniform(0.5, 2.0));
+        bank.time_constant[i] = static_cast<Scalar>(trial.uniform(0.01, 0.5));
+        bank.feedback_gain[i] = static_cast<Scalar>(trial.uniform(-0.5, 0.5));
+        bank.spectral_mix[i] = static_cast<Scalar>(trial.uniform(0.0, 1.0));
+        bank.clamp_low[i] = static_cast<Scalar>(-trial.uniform(1.5, 10.0));
+        bank.clamp_high[i] = static_cast<Scalar>(trial.uniform(1.5, 10.0));
+        bank.integrator_state[i] = static_cast<Scalar>(trial.uniform(-1.0, 1.0));
+    }
+}
+
+// One node step of the bank's formula, in long double
+template <typename Bank>
+Real nodeStep(const Bank& bank, size_t i, Real& state, Real amplified, Real boost) {
+    state += (static_cast<Real>(bank.input_gain[i]) * amplified - state) * static_cast<Real>(bank.time_constant[i]);
+    const Real out = state * (1.0L + static_cast<Real>(bank.feedback_gain[i])) +
+                     static_cast<Real>(bank.spectral_mix[i]) * boost;
+    return std::min<Real>(std::max<Real>(out, bank.clamp_low[i]), bank.clamp_high[i]);
+}
+
+// Block kernel of either precision over a bank of 37 real nodes (padding
+// slots run but are not compared): outputs of every sample against the
+// step formula from the same amplified input and boost streams
+template <typename Bank, typename Amplified, typename Kernel>
+void runBlockCase(const NodeKernels& k, Trial& trial, Kernel kernel) {
+    constexpr size_t nodes = 37, n = 256;
+    Bank bank(nodes);
+    randomNodes(bank, trial);
+    std::vector<Amplified> amplified(n);
+    std::vector<float> boost(n), out(nodes * n);
+    for (size_t t = 0; t < n; t++) {
+        amplified[t] = static_cast<Amplified>(trial.uniform(-3.0, 3.0));
+        boost[t] = trial.uniform(-1.0, 1.0);
+    }
+    std::vector<Real> state(nodes);
+    for (size_t i = 0; i < nodes; i++) state[i] = bank.integrator_state[i];
+
+    (k.*kernel)(bank, 0, bank.capacity(), amplified.data(), boost.data(), 0.5f, out.data(), n, 0, nullptr);
+
+    std::vector<Real> row(n);
+    for (size_t i = 0; i < nodes; i++) {
+        for (size_t t = 0; t < n; t++) row[t] = nodeStep(bank, i, state[i], amplified[t], boost[t]);
+        const double peak = rowPeak(row);
+        for (size_t t = 0; t < n; t++) trial.compare(out[i * n + t], row[t], peak);
+    }
+    trial.time(bank.capacity() * n, [&] {
+        (k.*kernel)(bank, 0, bank.capacity(), amplified.data(), boost.data(), 0.5f, out.data(), n, 0, nullptr);
+        g_sink = g_sink + out[3];
+    });
+}
+
+// Wave sweep of either precision: the returned sum and every node's final
+// output against ten steps per node, controls from the kernels' table
+template <typename Bank, typename Kernel>
+void runWaveCase(const NodeKernels& k, Trial& trial, Kernel kernel) {
+    constexpr size_t nodes = 61;
+    Bank bank(nodes);
+    randomNodes(bank, trial);
+    ControlWaveTable table;
+    const double* wave = table.prepare(bank.capacity());
+    const double input = trial.uniform(-2.0, 2.0), pattern = trial.uniform(-1.0, 1.0);
+    double aux[ControlWaveTable::kPasses];
+    for (double& a : aux) a = trial.uniform(-0.5, 0.5);
+    using Scalar = typename Bank::value_type;
+    // The float kernels step on the float input, control and aux
+    const bool single = sizeof(Scalar) == sizeof(float);
+    auto narrow = [single](double v) { return single ? static_cast<Real>(static_cast<float>(v)) : static_cast<Real>(v); };
+
+    std::vector<Real> state(nodes), last(nodes);
+    for (size_t i = 0; i < nodes; i++) state[i] = bank.integrator_state[i];
+    const double sum = (k.*kernel)(bank, 0, bank.capacity(), input, pattern, wave, aux, ControlWaveTable::kPasses);
+
+    Real ref_sum = 0.0L, magnitude = 0.0L;
+    for (size_t i = 0; i < nodes; i++) {
+        for (int pass = 0; pass < ControlWaveTable::kPasses; pass++) {
+            const Real amplified = narrow(input) * narrow(pattern + wave[i + pass]);
+            // The boost argument is formed in the kernel's precision, then
+            // taken to float
+            const float base = static_cast<float>(single ? static_cast<Real>(static_cast<float>(amplified)) +
+                                                               narrow(aux[pass])
+                                                         : amplified + aux[pass]);
+            last[i] = nodeStep(bank, i, state[i], amplified, spectralReference(base));
+            ref_sum += last[i];
+            magnitude += std::fabs(last[i]);
+        }
+        trial.compare(bank.current_output[i], last[i], 1.0);
+    }
+    trial.compare(sum, ref_sum, static_cast<double>(magnitude));
+    trial.time(bank.capacity() * ControlWaveTable::kPasses, [&] {
+        g_sink = g_sink + (k.*kernel)(bank, 0, bank.capacity(), input, pattern, wave, aux, ControlWaveTable::kPasses);
+    });
+}
+
+void addNodeCases(std::vector<Case>& cases) {
+    cases.push_back({"block_f64", Unit::F32, 2.0, kInf, [](const NodeKernels& k, Trial& trial) {
+        runBlockCase<NodeBank, double>(k, trial, &NodeKernels::block_f64);
+    }});
+    cases.push_back({"block_f32", Unit::F32, 16.0, kInf, [](const NodeKernels& k, Trial& trial) {
+        runBlockCase<NodeBankF32, float>(k, trial, &NodeKernels::block_f32);
+    }});
+    cases.push_back({"wave_f64", Unit::F32, 16.0, kInf, [](const NodeKernels& k, Trial& trial) {
+        runWaveCase<NodeBank>(k, trial, &NodeKernels::wave_f64);
+    }});
+    cases.push_back({"wave_f32", Unit::F32, 32.0, kInf, [](const NodeKernels& k, Trial& trial) {
+        runWaveCase<NodeBankF32>(k, trial, &NodeKernels::wave_f32);
+    }});
+}
+
+// Largest difference from the scalar table's outputs, in ULPs at each
+// output's scale
+double divergence(const Trial& trial, const Trial& scalar) {
+    if (trial.outputs.size() != scalar.outputs.size()) return kInf;
+    double worst = 0.0;
+    for (size_t j = 0; j < trial.outputs.size(); j++) {
+        const double at = std::max(std::fabs(scalar.outputs[j]), scalar.scales[j]);
+        const double d = std::fabs(trial.outputs[j] - scalar.outputs[j]) / trial.ulp(at);
+        if (!(d <= worst)) worst = d;
+    }
+    return worst;
+}
+
+uint64_t nameHash(const std::string& name) {
+    uint64_t h = 1469598103934665603ull;   // FNV-1a
+    for (char c : name) h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    return h;
+}
+
+bool parseLevel(const std::string& text, SimdLevel& level) {
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2,
+                                SimdLevel::AVX512, SimdLevel::NEON};
+    for (SimdLevel l : levels) {
+        if (text == simdLevelName(l)) {
+            level = l;
+            return true;
+        }
+    }
+    return false;
+}
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--filter TEXT] [--simd scalar|sse42|avx2|avx512|neon] [--seed N]\n"
+                 "          [--samples N] [--repeats N] [--sample-ms MS] [--min-speedup X]\n",
+                 argv0);
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int a = 1; a < argc; a++) {
+        const std::string arg = argv[a];
+        if (a + 1 >= argc) return usage(argv[0]);
+        const std::string value = argv[++a];
+        if (arg == "--filter") {
+            opt.filter = value;
+        } else if (arg == "--simd") {
+            if (!parseLevel(value, opt.level)) return usage(argv[0]);
+            opt.all_levels = false;
+        } else if (arg == "--seed") {
+            opt.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--samples") {
+            opt.samples = std::max<size_t>(1024, std::strtoull(value.c_str(), nullptr, 10)) / 16 * 16;
+        } else if (arg == "--repeats") {
+            opt.repeats = std::max(0, std::atoi(value.c_str()));
+        } else if (arg == "--sample-ms") {
+            opt.sample_ms = std::max(0.1, std::atof(value.c_str()));
+        } else if (arg == "--min-speedup") {
+            opt.min_speedup = std::atof(value.c_str());
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    // The scalar table first, as the baseline of divergence and speedup,
+    // then the other levels the host runs
+    std::vector<const NodeKernels*> tables = {&nodeKernels(SimdLevel::Scalar)};
+    for (SimdLevel l : {SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512, SimdLevel::NEON}) {
+        if (!opt.all_levels && l != opt.level) continue;
+        const NodeKernels& k = nodeKernels(l);
+        if (k.level == l) tables.push_back(&k);
+    }
+
+    std::vector<Case> cases;
+    addMathCases(cases);
+    addLinearCases(cases);
+    addFilterCases(cases);
+    addNodeCases(cases);
+
+    std::printf("D-ASE kernel conformance: best kernel %s, seed %llu, %zu samples\n",
+                simdLevelName(detectSimdLevel()), static_cast<unsigned long long>(opt.seed), opt.samples);
+    std::printf("%-16s %-7s %11s %11s %11s %11s %9s %9s  %s\n", "case", "level", "max ulp", "mean ulp",
+                "max abs", "vs scalar", "ns/elem", "speedup", "verdict");
+    int rejected = 0;
+    for (const Case& c : cases) {
+        if (!opt.filter.empty() && c.name.find(opt.filter) == std::string::npos) continue;
+        std::vector<Trial> trials;
+        for (const NodeKernels* k : tables) {
+            trials.emplace_back(c.unit, opt.seed ^ nameHash(c.name), opt);
+            c.run(*k, trials.back());
+        }
+        for (size_t t = 0; t < trials.size(); t++) {
+            const Trial& trial = trials[t];
+            const double mean_ulp = trial.outputs.empty() ? 0.0 : trial.sum_ulp / trial.outputs.size();
+            const double speedup = trial.ns_per_element > 0.0 ? trials[0].ns_per_element / trial.ns_per_element : 0.0;
+
+            std::string verdict = "ok";
+            if (!(trial.max_ulp <= c.ulp_limit) || !(trial.max_abs <= c.abs_limit)) {
+                char reason[96];
+                std::snprintf(reason, sizeof(reason), "REJECT accuracy (limit %g ulp, %g abs)", c.ulp_limit,
+                              c.abs_limit);
+                verdict = reason;
+            } else if (trial.mismatches > 0) {
+                verdict = "REJECT " + std::to_string(trial.mismatches) + " exact outputs off";
+            } else if (t > 0 && opt.repeats > 0 && speedup < opt.min_speedup) {
+                verdict = "REJECT speed";
+            }
+            if (verdict != "ok") rejected++;
+
+            char timing[32] = "-", ratio[32] = "-";
+            if (opt.repeats > 0) {
+                std::snprintf(timing, sizeof(timing), "%.3f", trial.ns_per_element);
+                std::snprintf(ratio, sizeof(ratio), "%.2fx", speedup);
+            }
+            std::printf("%-16s %-7s %11.3g %11.3g %11.3g %11.3g %9s %9s  %s\n", c.name.c_str(),
+                        simdLevelName(tables[t]->level), trial.max_ulp, mean_ulp, trial.max_abs,
+                        divergence(trial, trials[0]), timing, ratio, verdict.c_str());
+            std::fflush(stdout);
+        }
+    }
+    std::printf("%d level%s rejected\n", rejected, rejected == 1 ? "" : "s");
+    return rejected > 0 ? 1 : 0;
+}
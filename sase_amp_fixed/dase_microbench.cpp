@@ -0,0 +1,487 @@
+// Native microbenchmarks of the engine kernels, without Python in the loop.
+//
+//   dase_microbench [--filter TEXT] [--simd LEVEL] [--repeats N] [--sample-ms MS]
+//                   [--threads N] [--profiling off|sampled|full]
+//
+// Every case runs a fixed unit of work on prepared state. A sample repeats
+// the unit until it takes at least --sample-ms, and the median and best of
+// --repeats samples are reported per element: nanoseconds from steady_clock
+// and cycles from the TSC (reference cycles, so they do not follow turbo or
+// throttling). Kernel table cases run once per SIMD level the host supports;
+// --simd keeps one level and --filter keeps the cases whose name contains TEXT.
+// The engine's scope timers are off unless --profiling asks for them.
+// Builds with DASE_WITH_CUDA add backend/ cases timing the CUDA backend
+// against the CPU kernels on million-node banks, and fft/ cases time a
+// forward and inverse real transform on every FFT backend the build has.
+// convolver/ cases stream a 1 s impulse response through
+// PartitionedConvolver, uniform and with a coarse tail. compact/ cases run
+// 2M-node blocks on float and 16-bit node state; runCompactDrift reports
+// what the 16-bit formats cost in accuracy. equation/ cases run node
+// equations on each backend the build has against the native block.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "analog_universal_node_engine_avx2.h"
+#include "fft_backend.h"
+#include "partitioned_convolver.h"
+
+#ifdef DASE_X86_KERNELS
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps kernel results observable so the work cannot be optimized away
+volatile double g_sink = 0.0;
+
+bool haveCycles() {
+#ifdef DASE_X86_KERNELS
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint64_t readCycles() {
+#ifdef DASE_X86_KERNELS
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+struct Case {
+    std::string name;
+    size_t elements;            // Elements processed by one run()
+    std::function<void()> run;
+};
+
+struct Options {
+    std::string filter;
+    bool all_levels = true;
+    SimdLevel level = SimdLevel::Scalar;
+    int repeats = 15;
+    double sample_ms = 20.0;
+    unsigned threads = 0;
+    ProfilingMode profiling = ProfilingMode::Off;
+};
+
+struct Result {
+    double ns_median, ns_best;
+    double cycles_median, cycles_best;
+};
+
+Result measure(const Case& c, const Options& opt) {
+    // Warm caches, plans and lazily built tables, then size one sample
+    const auto warm_start = Clock::now();
+    size_t runs = 0;
+    do {
+        c.run();
+        runs++;
+    } while (Clock::now() - warm_start < std::chrono::milliseconds(5));
+    const double warm_ns = std::chrono::duration<double, std::nano>(Clock::now() - warm_start).count();
+    const size_t batch = std::max<size_t>(1, static_cast<size_t>(opt.sample_ms * 1e6 * runs / warm_ns));
+
+    std::vector<double> ns(opt.repeats), cycles(opt.repeats);
+    for (int r = 0; r < opt.repeats; r++) {
+        const uint64_t c0 = readCycles();
+        const auto t0 = Clock::now();
+        for (size_t k = 0; k < batch; k++) c.run();
+        const auto t1 = Clock::now();
+        const uint64_t c1 = readCycles();
+        const double elements = static_cast<double>(batch) * static_cast<double>(c.elements);
+        ns[r] = std::chrono::duration<double, std::nano>(t1 - t0).count() / elements;
+        cycles[r] = static_cast<double>(c1 - c0) / elements;
+    }
+    std::sort(ns.begin(), ns.end());
+    std::sort(cycles.begin(), cycles.end());
+    return {ns[ns.size() / 2], ns.front(), cycles[cycles.size() / 2], cycles.front()};
+}
+
+// Deterministic inputs spread over a few periods of the kernels' arguments
+std::vector<float> rampInput(size_t n, float scale) {
+    std::vector<float> v(n);
+    for (size_t i = 0; i < n; i++) v[i] = scale * static_cast<float>(i % 997) / 997.0f - 0.5f * scale;
+    return v;
+}
+
+void addKernelCases(std::vector<Case>& cases, const NodeKernels& k) {
+    const std::string level = simdLevelName(k.level);
+    const size_t n = 4096;
+
+    {
+        auto x = std::make_shared<std::vector<float>>(rampInput(n, 12.0f));
+        auto s = std::make_shared<std::vector<float>>(n);
+        auto c = std::make_shared<std::vector<float>>(n);
+        cases.push_back({"sincos_lanes/" + level, n, [&k, x, s, c] {
+            k.sincos_lanes(x->data(), s->data(), c->data(), x->size());
+            g_sink = g_sink + (*s)[7] + (*c)[n - 1];
+        }});
+    }
+    {
+        auto x = std::make_shared<std::vector<float>>(rampInput(256, 4.0f));
+        cases.push_back({"harmonics/" + level, 256, [&k, x] {
+            alignas(32) float out[8];
+            float acc = 0.0f;
+            for (float v : *x) {
+                k.harmonics(v, 0.25f, out);
+                acc += out[0] + out[7];
+            }
+            g_sink = g_sink + acc;
+        }});
+    }
+    {
+        auto x = std::make_shared<std::vector<float>>(rampInput(256, 4.0f));
+        cases.push_back({"spectral/" + level, 256, [&k, x] {
+            float acc = 0.0f;
+            for (float v : *x) acc += k.spectral(v);
+            g_sink = g_sink + acc;
+        }});
+    }
+    {
+        auto x = std::make_shared<std::vector<float>>(rampInput(n, 4.0f));
+        auto out = std::make_shared<std::vector<float>>(n);
+        cases.push_back({"spectral_lanes/" + level, n, [&k, x, out] {
+            k.spectral_lanes(x->data(), out->data(), x->size());
+            g_sink = g_sink + (*out)[n / 2];
+        }});
+    }
+    {
+        auto out = std::make_shared<std::vector<float>>(n);
+        auto first = std::make_shared<uint64_t>(0);
+        cases.push_back({"gaussian_noise/" + level, n, [&k, out, first] {
+            k.gaussian_noise(42, 0, *first, 1.0f, out->data(), out->size());
+            *first += out->size();
+            g_sink = g_sink + (*out)[3];
+        }});
+    }
+}
+
+void addEngineCases(std::vector<Case>& cases, const NodeKernels& k, const std::shared_ptr<WorkerPool>& pool) {
+    const std::string level = simdLevelName(k.level);
+    for (size_t nodes : {size_t{1024}, size_t{16384}, size_t{262144}}) {
+        auto engine = std::make_shared<AnalogCellularEngineAVX2>(nodes);
+        engine->setSimdLevel(k.level);
+        engine->shareWorkerPool(pool);
+        auto step = std::make_shared<uint64_t>(0);
+        // One element is one node through the sweep's 10 passes
+        cases.push_back({"processSignalWaveAVX2/" + level + "/" + std::to_string(nodes), nodes, [engine, step] {
+            const double t = static_cast<double>((*step)++ % 1000) * 0.001;
+            g_sink = g_sink + engine->processSignalWaveAVX2(std::sin(t), 0.5);
+        }});
+    }
+    // Each preset's sweep, to see what dropping a stage saves
+    for (NodePipeline pipeline : {NodePipeline::Full, NodePipeline::NoBoost, NodePipeline::Direct, NodePipeline::Linear}) {
+        constexpr size_t nodes = 16384;
+        auto engine = std::make_shared<AnalogCellularEngineAVX2>(nodes);
+        engine->setSimdLevel(k.level);
+        engine->setNodePipeline(pipeline);
+        engine->shareWorkerPool(pool);
+        auto step = std::make_shared<uint64_t>(0);
+        cases.push_back({"pipeline/" + std::string(nodePipelineName(pipeline)) + "/" + level, nodes, [engine, step] {
+            const double t = static_cast<double>((*step)++ % 1000) * 0.001;
+            g_sink = g_sink + engine->processSignalWaveAVX2(std::sin(t), 0.5);
+        }});
+    }
+}
+
+// Float engine block against the compact state formats on a bank larger
+// than most LLCs, where the 16-bit columns save memory traffic
+void addCompactCases(std::vector<Case>& cases, const NodeKernels& k, const std::shared_ptr<WorkerPool>& pool) {
+    const std::string level = simdLevelName(k.level);
+    constexpr size_t nodes = size_t{1} << 21;
+    constexpr size_t kBlock = 64;
+    auto in = std::make_shared<std::vector<float>>(rampInput(kBlock, 1.0f));
+    {
+        auto engine = std::make_shared<AnalogCellularEngineF32>(nodes);
+        engine->configureWorkers(pool->config());
+        engine->setSimdLevel(k.level);
+        // One element is one node through the block
+        cases.push_back({"compact/block/f32/" + level, nodes, [engine, in] {
+            engine->processBlock(in->data(), nullptr, nullptr, nullptr, kBlock);
+            g_sink = g_sink + engine->getNodeOutput(7);
+        }});
+    }
+    for (NodeStateFormat format : {NodeStateFormat::Half, NodeStateFormat::BFloat16, NodeStateFormat::Fixed16}) {
+        auto engine = std::make_shared<AnalogCellularEngineCompact>(nodes, format);
+        engine->configureWorkers(pool->config());
+        engine->setSimdLevel(k.level);
+        cases.push_back({"compact/block/" + std::string(nodeStateFormatName(format)) + "/" + level, nodes,
+                         [engine, in] {
+            engine->processBlock(in->data(), nullptr, nullptr, nullptr, kBlock);
+            g_sink = g_sink + engine->getNodeOutput(7);
+        }});
+    }
+}
+
+// The CUDA backend against the best CPU kernels on banks where the sweep is
+// bandwidth-bound. State stays on the device, so a case times the kernels
+// and the per-call transfers only.
+void addBackendCases(std::vector<Case>& cases, const std::shared_ptr<WorkerPool>& pool) {
+    if (!AnalogCellularEngineAVX2::computeBackendAvailable(ComputeBackend::Cuda)) return;
+    constexpr size_t kBlock = 256;
+    auto in = std::make_shared<std::vector<float>>(rampInput(kBlock, 1.0f));
+    for (size_t nodes : {size_t{1} << 20, size_t{1} << 22}) {
+        for (ComputeBackend backend : {ComputeBackend::Cpu, ComputeBackend::Cuda}) {
+            const std::string name = backend == ComputeBackend::Cuda ? "cuda" : "cpu";
+            auto engine = std::make_shared<AnalogCellularEngineAVX2>(nodes);
+            engine->shareWorkerPool(pool);
+            engine->setComputeBackend(backend);
+            auto step = std::make_shared<uint64_t>(0);
+            cases.push_back({"backend/wave/" + name + "/" + std::to_string(nodes), nodes, [engine, step] {
+                const double t = static_cast<double>((*step)++ % 1000) * 0.001;
+                g_sink = g_sink + engine->processSignalWaveAVX2(std::sin(t), 0.5);
+            }});
+            auto out = std::make_shared<std::vector<float>>(nodes * kBlock);
+            // One element is one node through the block
+            cases.push_back({"backend/block/" + name + "/" + std::to_string(nodes), nodes, [engine, in, out] {
+                engine->processBlock(in->data(), nullptr, nullptr, out->data(), kBlock);
+                g_sink = g_sink + (*out)[7];
+            }});
+        }
+    }
+}
+
+// The built-in node model as a node equation on every backend the build
+// has, against the native block kernels, and a FitzHugh-Nagumo model the
+// kernels cannot express
+void addEquationCases(std::vector<Case>& cases, const std::shared_ptr<WorkerPool>& pool) {
+    constexpr size_t nodes = 4096;
+    constexpr size_t kBlock = 256;
+    auto in = std::make_shared<std::vector<float>>(rampInput(kBlock, 1.0f));
+    const std::pair<const char*, const char*> models[] = {
+        {"builtin",
+         "integrator_state = integrator_state + (input_gain * amplified - integrator_state) * time_constant\n"
+         "output = clamp(integrator_state * (1 + feedback_gain) + spectral_mix * boost, clamp_low, clamp_high)"},
+        {"fitzhugh_nagumo",
+         "state v = -1.2, w = -0.6\n"
+         "param a = 0.7, b = 0.8, eps = 0.08, dt = 0.05\n"
+         "v = v + dt * (v - v^3 / 3 - w + amplified)\n"
+         "w = w + dt * eps * (v + a - b * w)\n"
+         "output = v"}};
+    {
+        auto engine = std::make_shared<AnalogCellularEngineAVX2>(nodes);
+        engine->shareWorkerPool(pool);
+        auto out = std::make_shared<std::vector<float>>(nodes * kBlock);
+        // One element is one node through the block
+        cases.push_back({"equation/native/builtin", nodes, [engine, in, out] {
+            engine->processBlock(in->data(), nullptr, nullptr, out->data(), kBlock);
+            g_sink = g_sink + (*out)[7];
+        }});
+    }
+    for (NodeEquationBackend backend : {NodeEquationBackend::Tape, NodeEquationBackend::Jit}) {
+        if (!nodeEquationBackendAvailable(backend)) continue;
+        for (const auto& model : models) {
+            auto engine = std::make_shared<AnalogCellularEngineAVX2>(nodes);
+            engine->shareWorkerPool(pool);
+            engine->setNodeEquation(model.second, backend);
+            auto out = std::make_shared<std::vector<float>>(nodes * kBlock);
+            cases.push_back({"equation/" + std::string(nodeEquationBackendName(backend)) + "/" + model.first, nodes,
+                             [engine, in, out] {
+                engine->processBlock(in->data(), nullptr, nullptr, out->data(), kBlock);
+                g_sink = g_sink + (*out)[7];
+            }});
+        }
+    }
+}
+
+// Round trip (forward and inverse) of one row on each FFT backend, powers of
+// two and a few sizes that are not (48000 = 2^7 3 5^3, 44100, a prime)
+void addFFTCases(std::vector<Case>& cases) {
+    for (FFTBackend backend : {FFTBackend::FFTW, FFTBackend::Builtin, FFTBackend::Accelerate, FFTBackend::MKL}) {
+        if (!fftBackendAvailable(backend)) continue;
+        for (int n : {256, 1024, 4096, 65536, 1 << 20, 48000, 44100, 65537}) {
+            struct Buffers {
+                double* real;
+                FFTComplex* spectrum;
+                std::unique_ptr<RealFFT> fft;
+                ~Buffers() {
+                    fft.reset();
+                    fftFree(real);
+                    fftFree(spectrum);
+                }
+            };
+            auto buffers = std::make_shared<Buffers>();
+            buffers->real = fftAllocReal(static_cast<size_t>(n));
+            buffers->spectrum = fftAllocComplex(static_cast<size_t>(n / 2 + 1));
+            buffers->fft = createRealFFT(backend, n, 1, buffers->real, buffers->spectrum);
+            // Accelerate hands sizes it lacks to the builtin transform
+            if (buffers->fft->backend() != backend) continue;
+            for (int t = 0; t < n; t++) buffers->real[t] = std::sin(0.013 * t);
+            const double scale = 1.0 / n;
+            cases.push_back({"fft/" + std::string(fftBackendName(backend)) + "/" + std::to_string(n), static_cast<size_t>(n), [buffers, n, scale] {
+                buffers->fft->forward(buffers->real, buffers->spectrum);
+                buffers->fft->inverse(buffers->spectrum, buffers->real);
+                for (int t = 0; t < n; t++) buffers->real[t] *= scale;
+                g_sink = g_sink + buffers->real[1];
+            }});
+        }
+    }
+}
+
+// 48000-tap response streamed in 256-sample chunks at 128 samples of
+// latency, uniform (375 partitions) and with a 2048-sample tail
+void addConvolverCases(std::vector<Case>& cases, const NodeKernels& k) {
+    const std::string level = simdLevelName(k.level);
+    const size_t n = 256;
+    for (int tail : {0, 2048}) {
+        ConvolverConfig config;
+        config.block_size = 128;
+        config.tail_block_size = tail;
+        auto conv = std::make_shared<PartitionedConvolver>(config, k.level);
+        std::vector<float> ir = rampInput(48000, 0.01f);
+        conv->setImpulseResponse(ir.data(), ir.size());
+        auto x = std::make_shared<std::vector<float>>(rampInput(n, 2.0f));
+        auto out = std::make_shared<std::vector<float>>(n);
+        const std::string name = tail == 0 ? "uniform" : "tail";
+        cases.push_back({"convolver/" + name + "/" + level, n, [conv, x, out] {
+            conv->process(x->data(), out->data(), x->size());
+            g_sink = g_sink + (*out)[n - 1];
+        }});
+    }
+}
+
+void addFixedCases(std::vector<Case>& cases) {
+    {
+        // Uses defaultSimdLevel(); select another with DASE_SIMD
+        auto node = std::make_shared<AnalogUniversalNodeAVX2>();
+        node->setFeedback(0.2);
+        auto x = std::make_shared<std::vector<float>>(rampInput(256, 2.0f));
+        cases.push_back({"processSignalAVX2", 256, [node, x] {
+            double acc = 0.0;
+            for (float v : *x) acc += node->processSignalAVX2(v, 0.7, 0.1);
+            g_sink = g_sink + acc;
+        }});
+    }
+    auto engine = std::make_shared<AnalogCellularEngineAVX2>(8);
+    for (size_t n : {size_t{256}, size_t{1024}, size_t{4096}, size_t{16384}}) {
+        std::vector<double> source(n);
+        for (size_t i = 0; i < n; i++) source[i] = std::sin(0.013 * static_cast<double>(i));
+        auto original = std::make_shared<const std::vector<double>>(std::move(source));
+        auto block = std::make_shared<std::vector<double>>(n);
+        // The transform is in place, so every run restores the input first
+        cases.push_back({"processBlockFrequencyDomain/" + std::to_string(n), n, [engine, original, block] {
+            std::memcpy(block->data(), original->data(), original->size() * sizeof(double));
+            engine->processBlockFrequencyDomain(*block);
+            g_sink = g_sink + (*block)[1];
+        }});
+    }
+}
+
+bool parseLevel(const std::string& text, SimdLevel& level) {
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2,
+                                SimdLevel::AVX512, SimdLevel::NEON};
+    for (SimdLevel l : levels) {
+        if (text == simdLevelName(l)) {
+            level = l;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseProfiling(const std::string& text, ProfilingMode& mode) {
+    if (text == "off") mode = ProfilingMode::Off;
+    else if (text == "sampled") mode = ProfilingMode::Sampled;
+    else if (text == "full") mode = ProfilingMode::Full;
+    else return false;
+    return true;
+}
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--filter TEXT] [--simd scalar|sse42|avx2|avx512|neon] [--repeats N]\n"
+                 "          [--sample-ms MS] [--threads N] [--profiling off|sampled|full]\n",
+                 argv0);
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int a = 1; a < argc; a++) {
+        const std::string arg = argv[a];
+        if (a + 1 >= argc) return usage(argv[0]);
+        const std::string value = argv[++a];
+        if (arg == "--filter") {
+            opt.filter = value;
+        } else if (arg == "--simd") {
+            if (!parseLevel(value, opt.level)) return usage(argv[0]);
+            opt.all_levels = false;
+        } else if (arg == "--repeats") {
+            opt.repeats = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--sample-ms") {
+            opt.sample_ms = std::max(0.1, std::atof(value.c_str()));
+        } else if (arg == "--threads") {
+            opt.threads = static_cast<unsigned>(std::max(0, std::atoi(value.c_str())));
+        } else if (arg == "--profiling") {
+            if (!parseProfiling(value, opt.profiling)) return usage(argv[0]);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    // The profiling mode is shared by all engines; any instance sets it
+    AnalogCellularEngineAVX2(8).setProfilingMode(opt.profiling);
+
+    // Distinct tables the host can run, lowest level first
+    std::vector<const NodeKernels*> tables;
+    if (opt.all_levels) {
+        for (SimdLevel l : {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512,
+                            SimdLevel::NEON}) {
+            const NodeKernels& k = nodeKernels(l);
+            if (k.level == l) tables.push_back(&k);
+        }
+    } else {
+        tables.push_back(&nodeKernels(opt.level));
+    }
+
+    // One pool for all engine cases instead of a pool per engine
+    WorkerPoolConfig config;
+    config.num_threads = opt.threads;
+    auto pool = std::make_shared<WorkerPool>(config);
+
+    std::vector<Case> cases;
+    for (const NodeKernels* k : tables) addKernelCases(cases, *k);
+    for (const NodeKernels* k : tables) addEngineCases(cases, *k, pool);
+    for (const NodeKernels* k : tables) addCompactCases(cases, *k, pool);
+    addBackendCases(cases, pool);
+    addEquationCases(cases, pool);
+    addFFTCases(cases);
+    for (const NodeKernels* k : tables) addConvolverCases(cases, *k);
+    addFixedCases(cases);
+
+    std::printf("D-ASE microbenchmarks: best kernel %s, %u threads, %d samples of >= %.1f ms\n",
+                simdLevelName(detectSimdLevel()), pool->size(), opt.repeats, opt.sample_ms);
+    std::printf("CUDA backend: %s\n", AnalogCellularEngineAVX2::computeDeviceName().c_str());
+    std::printf("FFT backend: %s\n", fftBackendName(defaultFFTBackend()));
+    std::printf("%-40s %14s %14s %14s %14s\n", "case", "ns/elem", "best ns/elem", "cycles/elem",
+                "best cyc/elem");
+    for (const Case& c : cases) {
+        if (!opt.filter.empty() && c.name.find(opt.filter) == std::string::npos) continue;
+        const Result r = measure(c, opt);
+        if (haveCycles()) {
+            std::printf("%-40s %14.3f %14.3f %14.2f %14.2f\n", c.name.c_str(), r.ns_median, r.ns_best,
+                        r.cycles_median, r.cycles_best);
+        } else {
+            std::printf("%-40s %14.3f %14.3f %14s %14s\n", c.name.c_str(), r.ns_median, r.ns_best, "-", "-");
+        }
+        std::fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,318 @@
+// Host-side latency benchmark of the audio pipeline, without Python in the loop.
+//
+//   dase_pipeline_bench [--blocks N] [--warmup N] [--nodes N] [--threads N]
+//                       [--sample-rate HZ] [--free-run] [--git-commit TEXT]
+//                       [--output PATH]
+//
+// Each block of HYBRID_BUFFER_SIZE stereo frames goes through the stages of
+// the real-time path in order:
+//   hybrid  hybrid_node_process on the synthetic ADC input
+//   i2s     hybrid output packed in place into a 24-bit I²S frame with
+//           the node's metrics (i2s_bridge_acquire_tx/commit_tx), then
+//           unpacked in place (i2s_bridge_acquire_rx/release_rx)
+//   dase    engine processBlock on the received audio
+// Blocks are released on the sample clock (one block period apart) unless
+// --free-run is given, and the pipeline latency of a block runs from its
+// release time to the end of the dase stage, so wake-up lateness counts.
+//
+// Build with I2S_BRIDGE_LOOPBACK so the bridge loops frames back in
+// software (see `make bench-pipeline`). The result is written in the layout
+// of benchmarks/latency_v1.1.json, to stdout unless --output is given.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "analog_universal_node_engine_avx2.h"
+#include "latency_histogram.h"
+#include "hybrid_node.h"
+#include "i2s_bridge.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kFrames = HYBRID_BUFFER_SIZE;
+static_assert(kFrames == I2S_BUFFER_SIZE, "one hybrid buffer per I2S frame");
+
+// Full-scale of the 24-bit I²S samples
+constexpr float kI2sScale = 8388607.0f;
+
+struct Options {
+    int blocks = 2000;
+    int warmup = 50;
+    size_t nodes = 1024;
+    unsigned threads = 0;
+    uint32_t sample_rate = I2S_SAMPLE_RATE;
+    bool paced = true;
+    std::string git_commit = "unknown";
+    std::string output;
+};
+
+enum Stage { StageHybrid, StageI2s, StageDase, StagePipeline, StageCount };
+
+struct Pipeline {
+    std::vector<float> adc;     // Hybrid input, interleaved stereo
+    std::vector<float> dac;     // Hybrid output, HYBRID_DAC_CHANNELS interleaved
+    std::vector<float> in;      // Engine streams from the received frame
+    std::vector<float> aux;
+    double phase = 0.0;
+    uint32_t sequence = 0;
+};
+
+bool initHybridNode(uint32_t sample_rate) {
+    HybridNodeConfig config = {};
+    config.interface_type = HYBRID_INTERFACE_I2S;
+    config.sample_rate = sample_rate;
+    config.buffer_size = HYBRID_BUFFER_SIZE;
+    config.adc_channels = HYBRID_ADC_CHANNELS;
+    config.dac_channels = HYBRID_DAC_CHANNELS;
+    config.preamp_gain = 10.0f;
+    config.hpf_cutoff = ANALOG_HPF_CUTOFF;
+    config.lpf_cutoff = ANALOG_LPF_CUTOFF;
+    config.enable_analog_filter = true;
+    config.fft_size = HYBRID_FFT_SIZE;
+    config.enable_dsp = true;
+    config.enable_coherence = true;
+    config.enable_ici = true;
+    config.enable_modulation = true;
+    config.modulation_depth = 0.8f;
+    config.control_loop_rate = 100.0f;
+    config.enable_voltage_clamp = true;
+    config.voltage_max = SAFETY_VOLTAGE_MAX;
+    config.mode = HYBRID_MODE_HYBRID;
+    return hybrid_node_init(&config) && hybrid_node_start();
+}
+
+bool initBridge(uint32_t sample_rate) {
+    I2SBridgeConfig config = {};
+    config.mode = I2S_MODE_MASTER;
+    config.sample_rate = sample_rate;
+    config.bit_depth = I2S_BIT_DEPTH;
+    config.channels = I2S_CHANNELS;
+    config.buffer_size = I2S_BUFFER_SIZE;
+    return i2s_bridge_init(&config) && i2s_bridge_start();
+}
+
+// Stereo test tone at CAL_TONE_FREQ, continuous across blocks
+void fillInput(Pipeline& p, uint32_t sample_rate) {
+    const double step = 2.0 * M_PI * CAL_TONE_FREQ / sample_rate;
+    for (size_t i = 0; i < kFrames; i++) {
+        const float v = static_cast<float>(0.5 * std::sin(p.phase));
+        p.adc[i * HYBRID_ADC_CHANNELS] = v;
+        p.adc[i * HYBRID_ADC_CHANNELS + 1] = 0.5f * v;
+        p.phase += step;
+    }
+    p.phase = std::fmod(p.phase, 2.0 * M_PI);
+}
+
+bool runI2sStage(Pipeline& p) {
+    int32_t* tx = i2s_bridge_acquire_tx();
+    if (!tx) return false;
+    for (size_t i = 0; i < kFrames; i++) {
+        for (size_t ch = 0; ch < HYBRID_DAC_CHANNELS; ch++) {
+            const float v = std::min(std::max(p.dac[i * HYBRID_DAC_CHANNELS + ch], -1.0f), 1.0f);
+            tx[i * I2S_CHANNELS + ch] = static_cast<int32_t>(std::lrint(v * kI2sScale));
+        }
+    }
+    DSPMetrics dsp;
+    hybrid_node_get_dsp_metrics(&dsp);
+    ConsciousnessMetrics metrics = {};
+    metrics.coherence = dsp.coherence;
+    metrics.ici = dsp.ici;
+    metrics.sequence = p.sequence++;
+    if (!i2s_bridge_commit_tx(&metrics, 1)) return false;
+
+    ConsciousnessMetrics received;
+    const int32_t* rx = i2s_bridge_acquire_rx(&received, 1, nullptr);
+    if (!rx) return false;
+    for (size_t i = 0; i < kFrames; i++) {
+        p.in[i] = static_cast<float>(rx[i * I2S_CHANNELS]) / kI2sScale;
+        p.aux[i] = static_cast<float>(rx[i * I2S_CHANNELS + 1]) / kI2sScale;
+    }
+    return i2s_bridge_release_rx();
+}
+
+uint64_t nanosBetween(Clock::time_point a, Clock::time_point b) {
+    return static_cast<uint64_t>(std::max<int64_t>(
+        0, std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count()));
+}
+
+// <stage>_ms (mean) and its percentiles, named like BenchmarkResult::toLatencyJson
+void writeStage(std::ostringstream& s, const char* stage, const LatencySnapshot& l) {
+    const double ms = 1e-6;
+    s << "    \"" << stage << "_ms\": " << l.mean_ns * ms << ",\n"
+      << "    \"" << stage << "_p50_ms\": " << static_cast<double>(l.p50_ns) * ms << ",\n"
+      << "    \"" << stage << "_p99_ms\": " << static_cast<double>(l.p99_ns) * ms << ",\n"
+      << "    \"" << stage << "_max_ms\": " << static_cast<double>(l.max_ns) * ms << ",\n";
+}
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--blocks N] [--warmup N] [--nodes N] [--threads N] [--sample-rate HZ]\n"
+                 "          [--free-run] [--git-commit TEXT] [--output PATH]\n",
+                 argv0);
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int a = 1; a < argc; a++) {
+        const std::string arg = argv[a];
+        if (arg == "--free-run") {
+            opt.paced = false;
+            continue;
+        }
+        if (a + 1 >= argc) return usage(argv[0]);
+        const std::string value = argv[++a];
+        if (arg == "--blocks") {
+            opt.blocks = std::max(1, std::atoi(value.c_str()));
+        } else if (arg == "--warmup") {
+            opt.warmup = std::max(0, std::atoi(value.c_str()));
+        } else if (arg == "--nodes") {
+            opt.nodes = static_cast<size_t>(std::max(1, std::atoi(value.c_str())));
+        } else if (arg == "--threads") {
+            opt.threads = static_cast<unsigned>(std::max(0, std::atoi(value.c_str())));
+        } else if (arg == "--sample-rate") {
+            opt.sample_rate = static_cast<uint32_t>(std::max(1000, std::atoi(value.c_str())));
+        } else if (arg == "--git-commit") {
+            opt.git_commit = value;
+        } else if (arg == "--output") {
+            opt.output = value;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    if (!initHybridNode(opt.sample_rate)) {
+        std::fprintf(stderr, "dase_pipeline_bench: hybrid node failed to start\n");
+        return 1;
+    }
+    if (!initBridge(opt.sample_rate)) {
+        std::fprintf(stderr, "dase_pipeline_bench: I2S bridge failed to start (build with -DI2S_BRIDGE_LOOPBACK)\n");
+        return 1;
+    }
+
+    AnalogCellularEngineAVX2 engine(opt.nodes);
+    if (opt.threads > 0) {
+        WorkerPoolConfig config;
+        config.num_threads = opt.threads;
+        engine.configureWorkers(config);
+    }
+
+    Pipeline p;
+    p.adc.resize(kFrames * HYBRID_ADC_CHANNELS);
+    p.dac.resize(kFrames * HYBRID_DAC_CHANNELS);
+    p.in.resize(kFrames);
+    p.aux.resize(kFrames);
+
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::duration<double>(static_cast<double>(kFrames) / opt.sample_rate));
+    std::vector<LatencyHistogram> stages(StageCount);
+    uint64_t deadline_misses = 0;
+    uint64_t busy_ns = 0;
+
+    Clock::time_point release = Clock::now();
+    for (int block = -opt.warmup; block < opt.blocks; block++) {
+        if (opt.paced) {
+            release += period;
+            std::this_thread::sleep_until(release);
+        } else {
+            release = Clock::now();
+        }
+        fillInput(p, opt.sample_rate);
+
+        const auto t0 = Clock::now();
+        if (!hybrid_node_process(p.adc.data(), p.dac.data(), kFrames)) {
+            std::fprintf(stderr, "dase_pipeline_bench: hybrid_node_process failed\n");
+            return 1;
+        }
+        const auto t1 = Clock::now();
+        if (!runI2sStage(p)) {
+            std::fprintf(stderr, "dase_pipeline_bench: I2S transfer failed\n");
+            return 1;
+        }
+        const auto t2 = Clock::now();
+        engine.processBlock(p.in.data(), nullptr, p.aux.data(), nullptr, kFrames);
+        const auto t3 = Clock::now();
+
+        if (block < 0) continue;
+        stages[StageHybrid].record(nanosBetween(t0, t1));
+        stages[StageI2s].record(nanosBetween(t1, t2));
+        stages[StageDase].record(nanosBetween(t2, t3));
+        const uint64_t total_ns = nanosBetween(release, t3);
+        stages[StagePipeline].record(total_ns);
+        busy_ns += nanosBetween(t0, t3);
+        if (total_ns > static_cast<uint64_t>(std::chrono::nanoseconds(period).count())) deadline_misses++;
+    }
+    i2s_bridge_stop();
+    hybrid_node_stop();
+
+    LatencySnapshot snap[StageCount];
+    for (int s = 0; s < StageCount; s++) snap[s] = stages[s].snapshot();
+    const double period_ns = static_cast<double>(std::chrono::nanoseconds(period).count());
+    const double cpu_percent = 100.0 * static_cast<double>(busy_ns) / (period_ns * opt.blocks);
+    const bool standard = opt.sample_rate == 48000;
+    const std::string scenario =
+        standard ? "single_stream_48khz" : "single_stream_" + std::to_string(opt.sample_rate) + "hz";
+    const std::string description = "Hybrid node, I2S loopback and D-ASE engine (" + std::to_string(opt.nodes) +
+                                    " nodes), " + (opt.paced ? "paced" : "free-running");
+
+    std::ostringstream s;
+    s << std::setprecision(6) << std::fixed;
+    s << "{\n"
+      << "  \"version\": \"1.1.0\",\n"
+      << "  \"benchmark_date\": " << benchmarkJsonString(benchmarkDate()) << ",\n"
+      << "  \"git_commit\": " << benchmarkJsonString(opt.git_commit) << ",\n"
+      << "  \"system_info\": {\n"
+      << "    \"os\": " << benchmarkJsonString(benchmarkHostOs()) << ",\n"
+      << "    \"simd_kernels\": " << benchmarkJsonString(simdLevelName(engine.getSimdLevel())) << ",\n"
+      << "    \"threads\": " << engine.getWorkerCount() << "\n"
+      << "  },\n"
+      << "  \"current_metrics\": {\n";
+    writeStage(s, "dase_latency", snap[StageDase]);
+    writeStage(s, "i2s_latency", snap[StageI2s]);
+    writeStage(s, "hybrid_node_latency", snap[StageHybrid]);
+    writeStage(s, "total_pipeline_latency", snap[StagePipeline]);
+    s << "    \"cpu_usage_percent\": " << cpu_percent << "\n"
+      << "  },\n"
+      << "  \"test_scenarios\": [\n"
+      << "    {\n"
+      << "      \"name\": " << benchmarkJsonString(scenario) << ",\n"
+      << "      \"description\": " << benchmarkJsonString(description) << ",\n"
+      << "      \"sample_rate\": " << opt.sample_rate << ",\n"
+      << "      \"block_size\": " << kFrames << ",\n"
+      << "      \"channels\": " << HYBRID_ADC_CHANNELS << ",\n"
+      << "      \"blocks\": " << opt.blocks << ",\n"
+      << "      \"deadline_misses\": " << deadline_misses << ",\n";
+    if (standard) s << "      \"target_latency_ms\": 5.0,\n";
+    s << "      \"actual_latency_ms\": " << snap[StagePipeline].mean_ns * 1e-6 << ",\n"
+      << "      \"status\": \"measured\"\n"
+      << "    }\n"
+      << "  ]\n"
+      << "}\n";
+
+    if (opt.output.empty()) {
+        std::fputs(s.str().c_str(), stdout);
+        return 0;
+    }
+    FILE* file = std::fopen(opt.output.c_str(), "w");
+    if (!file || std::fputs(s.str().c_str(), file) < 0 || std::fclose(file) != 0) {
+        std::fprintf(stderr, "dase_pipeline_bench: could not write %s\n", opt.output.c_str());
+        return 1;
+    }
+    std::fprintf(stderr, "Wrote %s: pipeline mean %.3f ms, p99 %.3f ms, %llu deadline misses\n",
+                 opt.output.c_str(), snap[StagePipeline].mean_ns * 1e-6,
+                 static_cast<double>(snap[StagePipeline].p99_ns) * 1e-6,
+                 static_cast<unsigned long long>(deadline_misses));
+    return 0;
+}
@@ -0,0 +1,833 @@
+// Native real-time pipeline host: Φ-sensor, D-ASE engine, hybrid node and
+// I²S bridge in one process, with Python out of the audio path.
+//
+//   dase_pipeline_host [--blocks N] [--nodes N] [--threads N] [--sample-rate HZ]
+//                      [--telemetry-hz HZ] [--metrics-ring NAME] [--realtime]
+//                      [--embedded-engine] [--metrics-port PORT] [--git-commit TEXT]
+//                      [--flight-recorder DIR] [--flight-seconds S] [--load-governor]
+//                      [--output PATH]
+//
+// One real-time thread runs the graph a block of HYBRID_BUFFER_SIZE frames
+// at a time, released on the sample clock:
+//   sensor  phi_sensor_poll, then the newest sample's Φ depth and phase; the
+//           host values of the last `phi` command while no sample is newer
+//           than kPhiTimeoutMs, as the hybrid node does
+//   dase    engine processChromaticBlock of the source tone under that Φ
+//           envelope, its two channels the hybrid node's stereo input
+//   hybrid  hybrid_node_process, which takes Φ from the sensor over phi_link;
+//           with --embedded-engine it also runs the embedded engine profile
+//           (embedded_engine.h) on its first input channel, as on the Pi
+//   i2s     hybrid output and metrics packed in place into the next I²S
+//           frame (i2s_bridge_acquire_tx/commit_tx); returned frames are
+//           released as they arrive
+// Every buffer is allocated before the first block, and nothing on the
+// thread locks, allocates or does I/O.
+//
+// Control comes in on stdin, one command per line:
+//   phi DEPTH PHASE   host Φ values (depth [0, 1], phase in radians)
+//   mode N            hybrid_node_set_mode (HybridNodeMode)
+//   gain G            hybrid_node_set_preamp_gain
+//   quit
+// A control thread parses them and hands them to the audio thread through a
+// lock-free queue; the audio thread applies them between blocks. Telemetry
+// goes the other way: a record per block through a second queue, of which a
+// telemetry thread prints the newest as one JSON line on stdout at
+// --telemetry-hz (server/native_pipeline.py reads both ends). With
+// --metrics-ring the audio thread also appends a MetricsRecord per block to
+// that shared-memory ring (shared_state.h), which metrics_streamer reads in
+// batches through dase_engine.MetricsRing. With --metrics-port an HTTP
+// thread serves GET /metrics on 127.0.0.1:PORT as OpenMetrics text: the
+// engine counters and latency histograms, the hybrid node and I²S bridge
+// statistics and the stage latencies, read from the same lock-free
+// snapshots as the telemetry, and the per-hop trace latencies. With --flight-recorder the audio thread also
+// keeps the last --flight-seconds (default 10) of blocks in a FlightRecorder
+// (flight_recorder.h): each block's stage times against its period, the
+// engine's chromatic block and the hybrid node's buffer with their own
+// stages, and the Φ changes. A deadline miss, a hybrid frames_dropped
+// increment or an I²S overrun or underrun freezes it, and a background
+// thread dumps it to DIR/flight-<n>.dfr. --load-governor runs the hybrid
+// node's load governor and sheds a level on a near miss of the node or of
+// the engine's chromatic block (its DeadlineWatchdog); the engine follows
+// the node's level down its ComputeQuality levels (Draft from the
+// passband level on) and back up as the node recovers. The run ends
+// after --blocks blocks or on quit; without --blocks, at the end of stdin
+// too (with it, the end of stdin only ends the commands). The stage latencies
+// are then written in the layout of benchmarks/latency_v1.1.json to --output.
+//
+// Every block is traced (pipeline_trace.h): its trace ID rides in the I²S
+// metrics packet's sequence and in the MetricsRecord, and its origin, the
+// Φ sample it was built from (its age included) or its release while the
+// sensor is quiet, in the packet's timestamp_us (trace clock µs) and the
+// record. The hops to the I²S commit go into a TraceBreakdown here;
+// metrics_streamer adds the WebSocket hop on its side.
+//
+// Without a Φ-sensor ADC (phi_sensor_init fails on plain hosts) Φ comes from
+// the control input alone. Build with I2S_BRIDGE_LOOPBACK where there is no
+// I²S hardware (see `make pipeline-host`).
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "analog_universal_node_engine_avx2.h"
+#include "embedded_engine.h"
+#include "flight_recorder.h"
+#include "hardware_metrics.h"
+#include "latency_histogram.h"
+#include "openmetrics.h"
+#include "pipeline_trace.h"
+#include "shared_state.h"
+#include "hybrid_node.h"
+#include "i2s_bridge.h"
+#include "phi_link.h"
+#include "phi_sensor.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr size_t kFrames = HYBRID_BUFFER_SIZE;
+static_assert(kFrames == I2S_BUFFER_SIZE, "one hybrid buffer per I2S frame");
+static_assert(HYBRID_ADC_CHANNELS == 2, "the chromatic block feeds a stereo input");
+
+// Full-scale of the 24-bit I²S samples
+constexpr float kI2sScale = 8388607.0f;
+
+// Sensor quiet this long: host Φ values, here and in the node (phi_link_timeout_ms)
+constexpr uint32_t kPhiTimeoutMs = 100;
+
+// Trace source of this host's blocks (makeTraceId)
+constexpr uint16_t kTraceSource = 1;
+
+struct Options {
+    int blocks = 0;
+    size_t nodes = 1024;
+    unsigned threads = 0;
+    uint32_t sample_rate = I2S_SAMPLE_RATE;
+    double telemetry_hz = 10.0;
+    bool realtime = false;
+    bool embedded_engine = false;
+    std::string git_commit = "unknown";
+    std::string output;
+    std::string metrics_ring;
+    int metrics_port = -1;      // -1: no metrics endpoint
+    std::string flight_dir;     // Empty: no flight recorder
+    double flight_seconds = 10.0;
+    bool load_governor = false;
+};
+
+constexpr size_t kMetricsRingCapacity = 1024;
+
+// Single-producer single-consumer ring of trivially copyable records;
+// push fails rather than waits when it is full
+template <typename T, size_t N>
+class SpscQueue {
+    static_assert((N & (N - 1)) == 0, "capacity must be a power of two");
+
+public:
+    bool push(const T& item) {
+        const size_t write = write_.load(std::memory_order_relaxed);
+        if (write - read_.load(std::memory_order_acquire) >= N) return false;
+        slots_[write & (N - 1)] = item;
+        write_.store(write + 1, std::memory_order_release);
+        return true;
+    }
+    size_t size() const {
+        return write_.load(std::memory_order_acquire) - read_.load(std::memory_order_acquire);
+    }
+    bool pop(T& item) {
+        const size_t read = read_.load(std::memory_order_relaxed);
+        if (read == write_.load(std::memory_order_acquire)) return false;
+        item = slots_[read & (N - 1)];
+        read_.store(read + 1, std::memory_order_release);
+        return true;
+    }
+
+private:
+    std::array<T, N> slots_{};
+    alignas(64) std::atomic<size_t> write_{0};
+    alignas(64) std::atomic<size_t> read_{0};
+};
+
+enum class Command : uint8_t { Phi, Mode, Gain };
+
+struct ControlMessage {
+    Command command;
+    float a;
+    float b;
+};
+
+enum Stage { StageSensor, StageDase, StageHybrid, StageI2s, StagePipeline, StageCount };
+
+struct Telemetry {
+    uint64_t block;
+    float phi_depth;
+    float phi_phase;
+    bool sensor_live;
+    float coherence;
+    float ici;
+    float criticality;
+    uint64_t stage_ns[StageCount];
+    uint64_t trace_id;
+    int64_t origin_ns;
+    int64_t sensor_age_ns;      // Φ sample to the engine block, or release to it
+    int64_t end_to_end_ns;
+    uint64_t deadline_misses;
+    uint64_t rx_frames;
+};
+
+SpscQueue<ControlMessage, 64> g_control;
+SpscQueue<Telemetry, 256> g_telemetry;
+std::atomic<bool> g_stop{false};
+
+void onSignal(int) { g_stop.store(true); }
+
+struct Pipeline {
+    std::vector<float> source;      // Tone into the engine
+    std::vector<float> chromatic;   // Engine output, channel-major [2 x kFrames]
+    std::vector<float> adc;         // Hybrid input, interleaved stereo
+    std::vector<float> dac;         // Hybrid output, HYBRID_DAC_CHANNELS interleaved
+    std::array<PhiSensorData, PHI_SENSOR_RING_SIZE> samples;
+    ChromaticBlockConfig chroma;
+    double phase = 0.0;
+    bool sensor = false;            // phi_sensor running
+    uint64_t sensor_last_block = 0;
+    bool sensor_live = false;
+    uint32_t sample_us = 0;         // phi_sensor timestamp of the newest sample
+    float host_depth = 0.5f;
+    float host_phase = 0.0f;
+    uint64_t rx_frames = 0;
+};
+
+// Hybrid node buffers into the flight recorder
+struct NodeFlight {
+    FlightRecorder* recorder;
+    uint32_t source;
+};
+
+// Filter, engine, analysis (metrics to control, in this context unless
+// defer_dsp) and output, the four that fit a FlightEvent
+void recordNodeBuffer(void* context, const HybridBufferRecord* record) {
+    const NodeFlight* flight = static_cast<const NodeFlight*>(context);
+    const uint32_t* ns = record->stage_ns;
+    const uint32_t stage_ns[4] = {
+        ns[HYBRID_STAGE_FILTER], ns[HYBRID_STAGE_ENGINE],
+        ns[HYBRID_STAGE_METRICS] + ns[HYBRID_STAGE_FFT] + ns[HYBRID_STAGE_ANALYSIS] + ns[HYBRID_STAGE_CONTROL],
+        ns[HYBRID_STAGE_OUTPUT]};
+    flight->recorder->recordBlock(flight->source, record->buffer, flightNowNs() - record->latency_ns,
+                                  record->latency_ns, record->budget_ns, stage_ns, 4, record->dsp_pending,
+                                  record->dropped ? kFlightXrun : 0);
+}
+
+// engine, when not null, runs inside the node (hybrid_node_set_engine);
+// flight, when not null, records its buffers (hybrid_node_set_buffer_observer)
+bool initHybridNode(uint32_t sample_rate, EmbeddedCellularEngine* engine, NodeFlight* flight, bool load_governor) {
+    HybridNodeConfig config = {};
+    config.interface_type = HYBRID_INTERFACE_I2S;
+    config.sample_rate = sample_rate;
+    config.buffer_size = HYBRID_BUFFER_SIZE;
+    config.adc_channels = HYBRID_ADC_CHANNELS;
+    config.dac_channels = HYBRID_DAC_CHANNELS;
+    config.preamp_gain = 1.0f;
+    config.hpf_cutoff = ANALOG_HPF_CUTOFF;
+    config.lpf_cutoff = ANALOG_LPF_CUTOFF;
+    config.enable_analog_filter = true;
+    config.fft_size = HYBRID_FFT_SIZE;
+    config.enable_dsp = true;
+    config.enable_coherence = true;
+    config.enable_ici = true;
+    config.enable_modulation = true;
+    config.modulation_depth = 0.8f;
+    config.control_loop_rate = 100.0f;
+    config.enable_voltage_clamp = true;
+    config.voltage_max = SAFETY_VOLTAGE_MAX;
+    config.mode = HYBRID_MODE_HYBRID;
+    config.enable_phi_link = true;
+    config.phi_link_timeout_ms = kPhiTimeoutMs;
+    config.enable_load_governor = load_governor;
+    config.governor_on_near_miss = load_governor;
+    if (!hybrid_node_init(&config)) return false;
+    if (engine && !hybrid_node_set_engine(&embedded_engine_process, engine)) return false;
+    if (flight && !hybrid_node_set_buffer_observer(&recordNodeBuffer, flight)) return false;
+    return hybrid_node_start();
+}
+
+bool initBridge(uint32_t sample_rate) {
+    I2SBridgeConfig config = {};
+    config.mode = I2S_MODE_MASTER;
+    config.sample_rate = sample_rate;
+    config.bit_depth = I2S_BIT_DEPTH;
+    config.channels = I2S_CHANNELS;
+    config.buffer_size = I2S_BUFFER_SIZE;
+    return i2s_bridge_init(&config) && i2s_bridge_start();
+}
+
+bool initSensor() {
+    PhiSensorConfig config = {};
+    for (uint8_t ch = 0; ch < PHI_SENSOR_CHANNELS; ch++) config.adc_pins[ch] = ch;
+    config.sample_rate_hz = PHI_SENSOR_SAMPLE_RATE;
+    config.enable_filtering = true;
+    config.enable_calibration = true;
+    return phi_sensor_init(&config) && phi_sensor_start();
+}
+
+void applyControl(Pipeline& p) {
+    ControlMessage message;
+    while (g_control.pop(message)) {
+        switch (message.command) {
+        case Command::Phi: {
+            p.host_depth = std::min(std::max(message.a, 0.0f), 1.0f);
+            p.host_phase = message.b;
+            ControlVoltage cv = {};
+            cv.phi_depth = p.host_depth;
+            cv.phi_phase = p.host_phase;
+            hybrid_node_set_control_voltage(&cv);
+            break;
+        }
+        case Command::Mode:
+            hybrid_node_set_mode(static_cast<HybridNodeMode>(static_cast<int>(message.a)));
+            break;
+        case Command::Gain:
+            hybrid_node_set_preamp_gain(message.a);
+            break;
+        }
+    }
+}
+
+// Φ of the next chromatic block from the newest sensor sample, or the host
+// values once the sensor has been quiet for kPhiTimeoutMs
+void runSensorStage(Pipeline& p, uint64_t block, uint32_t sample_rate) {
+    if (p.sensor) {
+        phi_sensor_poll();
+        const size_t count = phi_sensor_read_batch(p.samples.data(), p.samples.size());
+        if (count > 0) {
+            const PhiSensorData& newest = p.samples[count - 1];
+            p.chroma.phi_depth = newest.normalized[PHI_CHANNEL_DEPTH];
+            p.chroma.phi_phase = newest.normalized[PHI_CHANNEL_PHASE] * 2.0 * M_PI;
+            p.sample_us = newest.timestamp_us;
+            p.sensor_last_block = block;
+            p.sensor_live = true;
+        }
+    }
+    const uint64_t timeout_blocks = static_cast<uint64_t>(kPhiTimeoutMs) * sample_rate / (1000 * kFrames) + 1;
+    if (p.sensor_live && block - p.sensor_last_block > timeout_blocks) p.sensor_live = false;
+    if (!p.sensor_live) {
+        p.chroma.phi_depth = p.host_depth;
+        p.chroma.phi_phase = p.host_phase;
+    }
+}
+
+void runDaseStage(Pipeline& p, AnalogCellularEngineAVX2& engine, uint32_t sample_rate) {
+    const double step = 2.0 * M_PI * CAL_TONE_FREQ / sample_rate;
+    for (size_t i = 0; i < kFrames; i++) {
+        p.source[i] = static_cast<float>(0.5 * std::sin(p.phase));
+        p.phase += step;
+    }
+    p.phase = std::fmod(p.phase, 2.0 * M_PI);
+
+    engine.processChromaticBlock(p.source.data(), kFrames, p.chroma, p.chromatic.data());
+    for (size_t i = 0; i < kFrames; i++) {
+        p.adc[i * HYBRID_ADC_CHANNELS] = p.chromatic[i];
+        p.adc[i * HYBRID_ADC_CHANNELS + 1] = p.chromatic[kFrames + i];
+    }
+}
+
+// The packet's sequence carries the low 32 bits of the trace ID and its
+// timestamp the origin in µs of the trace clock (wrapping)
+bool runI2sStage(Pipeline& p, const DSPMetrics& dsp, const PipelineTrace& trace) {
+    int32_t* tx = i2s_bridge_acquire_tx();
+    if (!tx) return false;
+    for (size_t i = 0; i < kFrames; i++) {
+        for (size_t ch = 0; ch < HYBRID_DAC_CHANNELS; ch++) {
+            const float v = std::min(std::max(p.dac[i * HYBRID_DAC_CHANNELS + ch], -1.0f), 1.0f);
+            tx[i * I2S_CHANNELS + ch] = static_cast<int32_t>(std::lrint(v * kI2sScale));
+        }
+    }
+    ConsciousnessMetrics metrics = {};
+    metrics.phi_depth = static_cast<float>(p.chroma.phi_depth);
+    metrics.phi_phase = static_cast<float>(p.chroma.phi_phase);
+    metrics.coherence = dsp.coherence;
+    metrics.criticality = dsp.criticality;
+    metrics.ici = dsp.ici;
+    metrics.sequence = static_cast<uint32_t>(trace.trace_id);
+    metrics.timestamp_us = static_cast<uint32_t>(trace.origin_ns / 1000);
+    if (!i2s_bridge_commit_tx(&metrics, 1)) return false;
+
+    while (i2s_bridge_rx_available()) {
+        ConsciousnessMetrics received;
+        if (!i2s_bridge_acquire_rx(&received, 1, nullptr)) break;
+        i2s_bridge_release_rx();
+        p.rx_frames++;
+    }
+    return true;
+}
+
+// Block metrics in the MetricsFrame layout. The node measures ICI as an
+// interval rather than an interference, so the consciousness composite of
+// ChromaticFieldProcessor takes its diversity term from criticality here.
+MetricsRecord metricsRecord(const Pipeline& p, const DSPMetrics& dsp, const PipelineTrace& trace,
+                            uint32_t sample_rate, double latency_ms, double load) {
+    MetricsRecord r = {};
+    r.timestamp = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    r.ici = dsp.ici;
+    r.phase_coherence = dsp.coherence;
+    r.spectral_centroid = dsp.spectral_centroid;
+    r.criticality = dsp.criticality;
+    const double spectral = std::min(1.0, r.spectral_centroid / (0.5 * sample_rate));
+    const double diversity = 1.0 - std::min(std::max(r.criticality, 0.0), 1.0);
+    r.consciousness_level = std::min(std::max(0.4 * r.phase_coherence + 0.3 * diversity + 0.3 * spectral, 0.0), 1.0);
+    r.phi_phase = p.chroma.phi_phase;
+    r.phi_depth = p.chroma.phi_depth;
+    r.latency_ms = latency_ms;
+    r.cpu_load = load;
+    r.trace_id = trace.trace_id;
+    r.origin_ns = trace.origin_ns;
+    bool valid = true;
+    for (double v : {r.ici, r.phase_coherence, r.spectral_centroid, r.criticality, r.phi_phase, r.phi_depth}) {
+        valid = valid && std::isfinite(v);
+    }
+    r.state = classifyMetricsState(r.consciousness_level, r.phase_coherence, r.criticality);
+    r.flags = (valid ? kMetricsRecordValid : 0) | (p.sensor_live ? kMetricsRecordPhiSensor : 0);
+    return r;
+}
+
+int64_t steadyNs(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+uint64_t nanosBetween(Clock::time_point a, Clock::time_point b) {
+    return static_cast<uint64_t>(std::max<int64_t>(
+        0, std::chrono::duration_cast<std::chrono::nanoseconds>(b - a).count()));
+}
+
+// Parses stdin into g_control until quit, the end of input or a stop. The
+// end of input stops the run only when it is open-ended.
+void controlThread(bool stop_at_eof) {
+    std::string line;
+    bool quit = false;
+    while (!g_stop.load() && std::getline(std::cin, line)) {
+        std::istringstream in(line);
+        std::string command;
+        in >> command;
+        ControlMessage message = {};
+        if (command == "phi" && in >> message.a >> message.b) {
+            message.command = Command::Phi;
+        } else if (command == "mode" && in >> message.a) {
+            message.command = Command::Mode;
+        } else if (command == "gain" && in >> message.a) {
+            message.command = Command::Gain;
+        } else if (command == "quit") {
+            quit = true;
+            break;
+        } else {
+            std::fprintf(stderr, "dase_pipeline_host: ignoring \"%s\"\n", line.c_str());
+            continue;
+        }
+        if (!g_control.push(message)) std::fprintf(stderr, "dase_pipeline_host: control queue full\n");
+    }
+    if (quit || stop_at_eof) g_stop.store(true);
+}
+
+// Prints the newest telemetry record as a JSON line every period until stopped
+void telemetryThread(double hz) {
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / hz));
+    auto next = Clock::now();
+    while (!g_stop.load()) {
+        next += period;
+        std::this_thread::sleep_until(next);
+        Telemetry t;
+        bool have = false;
+        while (g_telemetry.pop(t)) have = true;
+        if (!have) continue;
+        std::printf("{\"block\": %llu, \"phi_depth\": %.6f, \"phi_phase\": %.6f, \"sensor_live\": %s, "
+                    "\"coherence\": %.6f, \"ici\": %.6f, \"criticality\": %.6f, \"sensor_ms\": %.6f, "
+                    "\"dase_ms\": %.6f, \"hybrid_node_ms\": %.6f, \"i2s_ms\": %.6f, \"pipeline_ms\": %.6f, "
+                    "\"trace_id\": %llu, \"origin_ns\": %lld, \"sensor_age_ms\": %.6f, "
+                    "\"end_to_end_ms\": %.6f, \"deadline_misses\": %llu, \"rx_frames\": %llu}\n",
+                    static_cast<unsigned long long>(t.block), t.phi_depth, t.phi_phase,
+                    t.sensor_live ? "true" : "false", t.coherence, t.ici, t.criticality,
+                    t.stage_ns[StageSensor] * 1e-6, t.stage_ns[StageDase] * 1e-6, t.stage_ns[StageHybrid] * 1e-6,
+                    t.stage_ns[StageI2s] * 1e-6, t.stage_ns[StagePipeline] * 1e-6,
+                    static_cast<unsigned long long>(t.trace_id), static_cast<long long>(t.origin_ns),
+                    t.sensor_age_ns * 1e-6, t.end_to_end_ns * 1e-6,
+                    static_cast<unsigned long long>(t.deadline_misses),
+                    static_cast<unsigned long long>(t.rx_frames));
+        std::fflush(stdout);
+    }
+}
+
+// <stage>_ms (mean) and its percentiles, named like BenchmarkResult::toLatencyJson
+void writeStage(std::ostringstream& s, const char* stage, const LatencySnapshot& l) {
+    const double ms = 1e-6;
+    s << "    \"" << stage << "_ms\": " << l.mean_ns * ms << ",\n"
+      << "    \"" << stage << "_p50_ms\": " << static_cast<double>(l.p50_ns) * ms << ",\n"
+      << "    \"" << stage << "_p99_ms\": " << static_cast<double>(l.p99_ns) * ms << ",\n"
+      << "    \"" << stage << "_max_ms\": " << static_cast<double>(l.max_ns) * ms << ",\n";
+}
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--blocks N] [--nodes N] [--threads N] [--sample-rate HZ] [--telemetry-hz HZ]\n"
+                 "          [--metrics-ring NAME] [--realtime] [--embedded-engine] [--metrics-port PORT]\n"
+                 "          [--flight-recorder DIR] [--flight-seconds S] [--load-governor] [--git-commit TEXT]\n"
+                 "          [--output PATH]\n",
+                 argv0);
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int a = 1; a < argc; a++) {
+        const std::string arg = argv[a];
+        if (arg == "--realtime") {
+            opt.realtime = true;
+            continue;
+        }
+        if (arg == "--embedded-engine") {
+            opt.embedded_engine = true;
+            continue;
+        }
+        if (arg == "--load-governor") {
+            opt.load_governor = true;
+            continue;
+        }
+        if (a + 1 >= argc) return usage(argv[0]);
+        const std::string value = argv[++a];
+        if (arg == "--blocks") {
+            opt.blocks = std::max(0, std::atoi(value.c_str()));
+        } else if (arg == "--nodes") {
+            opt.nodes = static_cast<size_t>(std::max(2, std::atoi(value.c_str())));
+        } else if (arg == "--threads") {
+            opt.threads = static_cast<unsigned>(std::max(0, std::atoi(value.c_str())));
+        } else if (arg == "--sample-rate") {
+            opt.sample_rate = static_cast<uint32_t>(std::max(1000, std::atoi(value.c_str())));
+        } else if (arg == "--telemetry-hz") {
+            opt.telemetry_hz = std::min(std::max(std::atof(value.c_str()), 0.1), 1000.0);
+        } else if (arg == "--git-commit") {
+            opt.git_commit = value;
+        } else if (arg == "--output") {
+            opt.output = value;
+        } else if (arg == "--metrics-ring") {
+            opt.metrics_ring = value;
+        } else if (arg == "--metrics-port") {
+            opt.metrics_port = std::min(std::max(std::atoi(value.c_str()), 0), 65535);
+        } else if (arg == "--flight-recorder") {
+            opt.flight_dir = value;
+        } else if (arg == "--flight-seconds") {
+            opt.flight_seconds = std::min(std::max(std::atof(value.c_str()), 0.1), 3600.0);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    // One recorder for the whole graph: every source records on the audio thread
+    std::unique_ptr<FlightRecorder> flight;
+    NodeFlight node_flight = {};
+    uint32_t flight_pipeline = 0;
+    if (!opt.flight_dir.empty()) {
+        FlightRecorderConfig config;
+        // Pipeline, engine and node blocks, plus room for parameter changes
+        config.capacity = flightCapacityFor(opt.flight_seconds, opt.sample_rate, kFrames, 4);
+        config.directory = opt.flight_dir;
+        flight = std::make_unique<FlightRecorder>(config);
+        flight_pipeline = flight->addSource("pipeline", {"sensor", "dase", "hybrid_node", "i2s"});
+        node_flight = {flight.get(), flight->addSource("hybrid_node", {"filter", "engine", "analysis", "output"})};
+    }
+
+    static EmbeddedCellularEngine embedded;
+    if (!initHybridNode(opt.sample_rate, opt.embedded_engine ? &embedded : nullptr,
+                        flight ? &node_flight : nullptr, opt.load_governor)) {
+        std::fprintf(stderr, "dase_pipeline_host: hybrid node failed to start\n");
+        return 1;
+    }
+    if (!initBridge(opt.sample_rate)) {
+        std::fprintf(stderr, "dase_pipeline_host: I2S bridge failed to start (build with -DI2S_BRIDGE_LOOPBACK)\n");
+        return 1;
+    }
+
+    Pipeline p;
+    p.sensor = initSensor();
+    if (!p.sensor) std::fprintf(stderr, "dase_pipeline_host: no Φ-sensor ADC, Φ from the control input only\n");
+
+    AnalogCellularEngineAVX2 engine(opt.nodes);
+    if (opt.threads > 0) {
+        WorkerPoolConfig config;
+        config.num_threads = opt.threads;
+        engine.configureWorkers(config);
+    }
+    p.source.resize(kFrames);
+    p.chromatic.resize(HYBRID_ADC_CHANNELS * kFrames);
+    p.adc.resize(kFrames * HYBRID_ADC_CHANNELS);
+    p.dac.resize(kFrames * HYBRID_DAC_CHANNELS);
+    p.chroma.num_channels = HYBRID_ADC_CHANNELS;
+    p.chroma.node_stride = opt.nodes / HYBRID_ADC_CHANNELS;
+    p.chroma.sample_rate = opt.sample_rate;
+    p.chroma.phi_depth = p.host_depth;
+    engine.setFlightRecorder(flight.get());
+    engine.deadlineWatchdog().setSampleRate(opt.sample_rate);
+    if (opt.load_governor) {
+        // The engine runs on the audio thread ahead of the node: its near
+        // misses eat into the node's period too
+        engine.deadlineWatchdog().setCallback([](const DeadlineEvent&) { hybrid_node_request_load_shed(); }, true);
+    }
+
+    std::unique_ptr<MetricsRingWriter> ring;
+    if (!opt.metrics_ring.empty()) {
+        try {
+            ring = std::make_unique<MetricsRingWriter>(opt.metrics_ring, kMetricsRingCapacity);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "dase_pipeline_host: %s\n", e.what());
+            return 1;
+        }
+    }
+
+    std::signal(SIGINT, onSignal);
+    std::signal(SIGTERM, onSignal);
+    std::thread control(controlThread, opt.blocks == 0);
+    control.detach();   // Blocked in getline until stdin ends; exiting the process ends it
+    std::thread telemetry(telemetryThread, opt.telemetry_hz);
+
+    std::vector<LatencyHistogram> stages(StageCount);
+    TraceBreakdown traces;
+    uint64_t deadline_misses = 0;
+    uint64_t blocks = 0;
+
+    std::unique_ptr<MetricsHttpServer> metrics;
+    if (opt.metrics_port >= 0) {
+        static const char* const kStageLabels[StageCount] = {"stage=\"sensor\"", "stage=\"dase\"",
+                                                             "stage=\"hybrid_node\"", "stage=\"i2s\"",
+                                                             "stage=\"pipeline\""};
+        static const char* const kHopLabels[kTraceHopCount] = {"hop=\"sensor\"", "hop=\"dase\"",
+                                                               "hop=\"hybrid_node\"", "hop=\"i2s\"",
+                                                               "hop=\"websocket\""};
+        auto render = [&engine, &stages, &traces](OpenMetricsWriter& w) {
+            writeEngineOpenMetrics(w, engine);
+            writeHardwareOpenMetrics(w);
+            w.family("pipeline_stage_latency_seconds", "histogram", "Time of each stage per block", "seconds");
+            for (int s = 0; s < StageCount; s++) {
+                w.latencyHistogram("pipeline_stage_latency_seconds", kStageLabels[s], stages[s].snapshot());
+            }
+            // The WebSocket hop is measured by metrics_streamer; it stays empty here
+            const TraceBreakdownSnapshot trace = traces.snapshot();
+            w.family("pipeline_hop_latency_seconds", "histogram",
+                     "Time of each hop of a traced block, from its Φ sample to the I2S commit", "seconds");
+            for (size_t h = 0; h < kTraceHopCount; h++) {
+                w.latencyHistogram("pipeline_hop_latency_seconds", kHopLabels[h], trace.hops[h]);
+            }
+            w.family("pipeline_end_to_end_latency_seconds", "histogram",
+                     "Φ sample (or block release) to the I2S commit of a traced block", "seconds");
+            w.latencyHistogram("pipeline_end_to_end_latency_seconds", "", trace.end_to_end);
+        };
+        try {
+            metrics = std::make_unique<MetricsHttpServer>(render, static_cast<uint16_t>(opt.metrics_port));
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "dase_pipeline_host: %s\n", e.what());
+            return 1;
+        }
+        std::fprintf(stderr, "dase_pipeline_host: metrics on http://127.0.0.1:%u/metrics\n",
+                     static_cast<unsigned>(metrics->port()));
+    }
+    std::thread audio([&]() {
+        if (opt.realtime && !hybrid_node_realtime_enter()) {
+            std::fprintf(stderr, "dase_pipeline_host: real-time mode incomplete, see the node status\n");
+        }
+        const auto period = std::chrono::duration_cast<Clock::duration>(
+            std::chrono::duration<double>(static_cast<double>(kFrames) / opt.sample_rate));
+        const uint64_t period_ns = static_cast<uint64_t>(std::chrono::nanoseconds(period).count());
+        DSPMetrics dsp = {};
+        I2SStatistics i2s = {};
+        uint64_t i2s_xruns = 0;
+        Clock::time_point release = Clock::now();
+        TraceClock steady_trace, sensor_trace;
+        for (; !g_stop.load(std::memory_order_relaxed) && (opt.blocks == 0 || blocks < (uint64_t)opt.blocks);
+             blocks++) {
+            release += period;
+            std::this_thread::sleep_until(release);
+            applyControl(p);
+
+            // Re-anchored every block: the stamps below are then steady_clock
+            // differences, untouched by steps of the wall clock
+            const int64_t reference_ns = traceNowNs();
+            const auto t0 = Clock::now();
+            steady_trace.anchor(steadyNs(t0), reference_ns);
+            // Off the Teensy phi_sensor ticks are CLOCK_MONOTONIC µs, steady_clock's
+            sensor_trace.anchorMicros(static_cast<uint32_t>(steadyNs(t0) / 1000), reference_ns);
+            runSensorStage(p, blocks, opt.sample_rate);
+            const auto t1 = Clock::now();
+
+            PipelineTrace trace;
+            trace.trace_id = makeTraceId(kTraceSource, blocks);
+            trace.origin_ns = p.sensor_live ? sensor_trace.fromMicros(p.sample_us)
+                                            : steady_trace.toReference(steadyNs(release));
+            trace.stamp(TraceHop::Sensor, steady_trace.toReference(steadyNs(t1)));
+            runDaseStage(p, engine, opt.sample_rate);
+            const auto t2 = Clock::now();
+            if (!hybrid_node_process(p.adc.data(), p.dac.data(), kFrames)) {
+                std::fprintf(stderr, "dase_pipeline_host: hybrid_node_process failed\n");
+                break;
+            }
+            hybrid_node_get_dsp_metrics(&dsp);
+            if (opt.load_governor) {
+                const ComputeQuality quality = static_cast<ComputeQuality>(
+                    std::min<size_t>(hybrid_node_get_load_level(), kComputeQualityCount - 1));
+                if (quality != engine.getComputeQuality()) engine.setComputeQuality(quality);
+            }
+            const auto t3 = Clock::now();
+            trace.stamp(TraceHop::Engine, steady_trace.toReference(steadyNs(t2)));
+            trace.stamp(TraceHop::HybridNode, steady_trace.toReference(steadyNs(t3)));
+            if (!runI2sStage(p, dsp, trace)) {
+                std::fprintf(stderr, "dase_pipeline_host: I2S transfer failed\n");
+                break;
+            }
+            const auto t4 = Clock::now();
+            trace.stamp(TraceHop::I2s, steady_trace.toReference(steadyNs(t4)));
+            traces.record(trace);
+
+            Telemetry t = {};
+            t.block = blocks;
+            t.phi_depth = static_cast<float>(p.chroma.phi_depth);
+            t.phi_phase = static_cast<float>(p.chroma.phi_phase);
+            t.sensor_live = p.sensor_live;
+            t.coherence = dsp.coherence;
+            t.ici = dsp.ici;
+            t.criticality = dsp.criticality;
+            t.stage_ns[StageSensor] = nanosBetween(t0, t1);
+            t.stage_ns[StageDase] = nanosBetween(t1, t2);
+            t.stage_ns[StageHybrid] = nanosBetween(t2, t3);
+            t.stage_ns[StageI2s] = nanosBetween(t3, t4);
+            t.stage_ns[StagePipeline] = nanosBetween(release, t4);
+            if (t.stage_ns[StagePipeline] > period_ns) deadline_misses++;
+            t.deadline_misses = deadline_misses;
+            t.trace_id = trace.trace_id;
+            t.origin_ns = trace.origin_ns;
+            t.sensor_age_ns = trace.hopNs(TraceHop::Sensor);
+            t.end_to_end_ns = trace.endToEndNs();
+            t.rx_frames = p.rx_frames;
+            for (int s = 0; s < StageCount; s++) stages[s].record(t.stage_ns[s]);
+            g_telemetry.push(t);
+            if (ring) {
+                ring->push(metricsRecord(p, dsp, trace, opt.sample_rate, t.stage_ns[StagePipeline] * 1e-6,
+                                         static_cast<double>(t.stage_ns[StagePipeline]) / period_ns));
+            }
+            if (flight) {
+                uint16_t flags = 0;
+                if (i2s_bridge_get_statistics(&i2s)) {
+                    const uint64_t xruns = i2s.rx_overruns + i2s.tx_underruns;
+                    if (xruns > i2s_xruns) flags |= kFlightXrun;
+                    i2s_xruns = xruns;
+                }
+                uint32_t stage_ns[4];
+                for (int s = 0; s < StagePipeline; s++) {
+                    stage_ns[s] = static_cast<uint32_t>(std::min<uint64_t>(t.stage_ns[s], UINT32_MAX));
+                }
+                const uint64_t start_ns = static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(release.time_since_epoch()).count());
+                flight->recordBlock(flight_pipeline, blocks, start_ns,
+                                    static_cast<uint32_t>(std::min<uint64_t>(t.stage_ns[StagePipeline], UINT32_MAX)),
+                                    static_cast<uint32_t>(period_ns), stage_ns, 4,
+                                    static_cast<uint32_t>(g_telemetry.size()), flags);
+            }
+        }
+    });
+    audio.join();
+    g_stop.store(true);
+    telemetry.join();
+    if (metrics) metrics->stop();
+
+    i2s_bridge_stop();
+    hybrid_node_stop();
+    if (p.sensor) phi_sensor_stop();
+
+    LatencySnapshot snap[StageCount];
+    for (int s = 0; s < StageCount; s++) snap[s] = stages[s].snapshot();
+    std::fprintf(stderr, "dase_pipeline_host: %llu blocks, pipeline mean %.3f ms, p99 %.3f ms, %llu deadline misses\n",
+                 static_cast<unsigned long long>(blocks), snap[StagePipeline].mean_ns * 1e-6,
+                 static_cast<double>(snap[StagePipeline].p99_ns) * 1e-6,
+                 static_cast<unsigned long long>(deadline_misses));
+    const DeadlineHealth dase_deadline = engine.deadlineWatchdog().health(DeadlineStage::ChromaticBlock);
+    HybridNodeStatus node_status = {};
+    hybrid_node_get_status(&node_status);
+    std::fprintf(stderr,
+                 "dase_pipeline_host: dase %llu misses, %llu near misses; hybrid node %llu misses, "
+                 "%llu near misses, load level %u, compute quality %s\n",
+                 static_cast<unsigned long long>(dase_deadline.misses),
+                 static_cast<unsigned long long>(dase_deadline.near_misses),
+                 static_cast<unsigned long long>(node_status.stats.deadline_overruns),
+                 static_cast<unsigned long long>(node_status.stats.deadline.near_misses),
+                 static_cast<unsigned>(node_status.stats.load_level), computeQualityName(engine.getComputeQuality()));
+    if (flight) {
+        std::fprintf(stderr, "dase_pipeline_host: flight recorder %llu events, %llu dumps%s%s\n",
+                     static_cast<unsigned long long>(flight->recorded()),
+                     static_cast<unsigned long long>(flight->dumps()), flight->dumps() > 0 ? ", last " : "",
+                     flight->lastDump().c_str());
+        if (!flight->dumpError().empty()) {
+            std::fprintf(stderr, "dase_pipeline_host: %s\n", flight->dumpError().c_str());
+        }
+    }
+    if (opt.output.empty()) return 0;
+
+    const std::string description = "Native pipeline: Φ-sensor, D-ASE chromatic block (" +
+                                    std::to_string(opt.nodes) + " nodes), hybrid node and I2S in one process";
+    std::ostringstream s;
+    s << std::setprecision(6) << std::fixed;
+    s << "{\n"
+      << "  \"version\": \"1.1.0\",\n"
+      << "  \"benchmark_date\": " << benchmarkJsonString(benchmarkDate()) << ",\n"
+      << "  \"git_commit\": " << benchmarkJsonString(opt.git_commit) << ",\n"
+      << "  \"system_info\": {\n"
+      << "    \"os\": " << benchmarkJsonString(benchmarkHostOs()) << ",\n"
+      << "    \"simd_kernels\": " << benchmarkJsonString(simdLevelName(engine.getSimdLevel())) << ",\n"
+      << "    \"threads\": " << engine.getWorkerCount() << "\n"
+      << "  },\n"
+      << "  \"current_metrics\": {\n";
+    writeStage(s, "phi_sensor_latency", snap[StageSensor]);
+    writeStage(s, "dase_latency", snap[StageDase]);
+    writeStage(s, "hybrid_node_latency", snap[StageHybrid]);
+    writeStage(s, "i2s_latency", snap[StageI2s]);
+    writeStage(s, "total_pipeline_latency", snap[StagePipeline]);
+    // Where the end-to-end latency goes, hop by hop from the Φ sample
+    const TraceBreakdownSnapshot trace = traces.snapshot();
+    for (size_t h = 0; h < static_cast<size_t>(TraceHop::WebSocket); h++) {
+        const std::string hop = std::string("trace_") + traceHopName(static_cast<TraceHop>(h)) + "_latency";
+        writeStage(s, hop.c_str(), trace.hops[h]);
+        s << "    \"" << hop << "_share\": " << trace.share(static_cast<TraceHop>(h)) << ",\n";
+    }
+    writeStage(s, "trace_end_to_end_latency", trace.end_to_end);
+    s << "    \"trace_skewed\": " << trace.skewed << ",\n";
+    s << "    \"deadline_misses\": " << deadline_misses << "\n"
+      << "  },\n"
+      << "  \"test_scenarios\": [\n"
+      << "    {\n"
+      << "      \"name\": \"native_pipeline_" << opt.sample_rate << "hz\",\n"
+      << "      \"description\": " << benchmarkJsonString(description) << ",\n"
+      << "      \"sample_rate\": " << opt.sample_rate << ",\n"
+      << "      \"block_size\": " << kFrames << ",\n"
+      << "      \"blocks\": " << blocks << ",\n"
+      << "      \"target_latency_ms\": 7.8,\n"
+      << "      \"actual_latency_ms\": " << snap[StagePipeline].mean_ns * 1e-6 << ",\n"
+      << "      \"status\": \"measured\"\n"
+      << "    }\n"
+      << "  ]\n"
+      << "}\n";
+
+    FILE* file = std::fopen(opt.output.c_str(), "w");
+    if (!file || std::fputs(s.str().c_str(), file) < 0 || std::fclose(file) != 0) {
+        std::fprintf(stderr, "dase_pipeline_host: could not write %s\n", opt.output.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+// Offline replay of recordings through the D-ASE engine (offline_replay.h),
+// for preset regression runs without the realtime server.
+//
+//   dase_replay INPUT --output PATH [--metrics PATH] [--raw-channels N --raw-rate HZ]
+//               [--nodes N] [--block N] [--channels N] [--input-channel N]
+//               [--phi-depth D] [--phi-phase P] [--segments N] [--warmup N]
+//               [--threads N] [--no-ici]
+//
+// INPUT is a WAV file, or headerless interleaved float32 with
+// --raw-channels and --raw-rate. The chromatic outputs go to --output as a
+// float32 WAV of --channels channels; --metrics adds a session store of
+// per-block time, input and output RMS and ICI, which
+// server/session_comparator.py opens directly. One JSON line with the
+// replay's size and speed goes to stdout. --segments 1 gives the exact
+// sequential replay; the default splits the input over every worker.
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <string>
+#include "engine_benchmark.h"
+#include "offline_replay.h"
+
+namespace {
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s INPUT --output PATH [--metrics PATH] [--raw-channels N --raw-rate HZ]\n"
+                 "          [--nodes N] [--block N] [--channels N] [--input-channel N] [--phi-depth D]\n"
+                 "          [--phi-phase P] [--segments N] [--warmup N] [--threads N] [--no-ici]\n",
+                 argv0);
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    OfflineReplayConfig config;
+    std::string input_path, output_path, metrics_path;
+    size_t raw_channels = 0;
+    double raw_rate = 0.0;
+    for (int a = 1; a < argc; a++) {
+        const std::string arg = argv[a];
+        if (arg == "--no-ici") {
+            config.ici = false;
+            continue;
+        }
+        if (arg.compare(0, 2, "--") != 0) {
+            if (!input_path.empty()) return usage(argv[0]);
+            input_path = arg;
+            continue;
+        }
+        if (a + 1 >= argc) return usage(argv[0]);
+        const std::string value = argv[++a];
+        if (arg == "--output") {
+            output_path = value;
+        } else if (arg == "--metrics") {
+            metrics_path = value;
+        } else if (arg == "--raw-channels") {
+            raw_channels = static_cast<size_t>(std::max(0, std::atoi(value.c_str())));
+        } else if (arg == "--raw-rate") {
+            raw_rate = std::atof(value.c_str());
+        } else if (arg == "--nodes") {
+            config.nodes = static_cast<size_t>(std::max(1, std::atoi(value.c_str())));
+        } else if (arg == "--block") {
+            config.block_size = static_cast<size_t>(std::max(1, std::atoi(value.c_str())));
+        } else if (arg == "--channels") {
+            config.num_channels = static_cast<size_t>(std::max(1, std::atoi(value.c_str())));
+        } else if (arg == "--input-channel") {
+            config.input_channel = std::atoi(value.c_str());
+        } else if (arg == "--phi-depth") {
+            config.phi_depth = std::atof(value.c_str());
+        } else if (arg == "--phi-phase") {
+            config.phi_phase = std::atof(value.c_str());
+        } else if (arg == "--segments") {
+            config.segments = static_cast<size_t>(std::max(0, std::atoi(value.c_str())));
+        } else if (arg == "--warmup") {
+            config.warmup_blocks = static_cast<size_t>(std::max(0, std::atoi(value.c_str())));
+        } else if (arg == "--threads") {
+            config.workers.num_threads = static_cast<unsigned>(std::max(0, std::atoi(value.c_str())));
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    if (input_path.empty() || output_path.empty() || (raw_channels == 0) != (raw_rate <= 0.0)) {
+        return usage(argv[0]);
+    }
+
+    try {
+        const AudioFileReader input = raw_channels ? AudioFileReader(input_path, raw_channels, raw_rate)
+                                                   : AudioFileReader(input_path);
+        const OfflineReplayStats stats = runOfflineReplay(input, output_path, metrics_path, config);
+        std::printf("{\"input\": %s, \"output\": %s, \"frames\": %llu, \"blocks\": %llu, \"duration_s\": %.3f, "
+                    "\"segments\": %zu, \"threads\": %u, \"seconds\": %.3f, \"realtime_factor\": %.1f}\n",
+                    benchmarkJsonString(input_path).c_str(), benchmarkJsonString(output_path).c_str(),
+                    static_cast<unsigned long long>(stats.frames), static_cast<unsigned long long>(stats.blocks),
+                    input.duration(), stats.segments, stats.threads, stats.seconds, stats.realtime_factor);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "dase_replay: %s\n", e.what());
+        return 1;
+    }
+    return 0;
+}
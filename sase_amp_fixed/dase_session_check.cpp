@@ -0,0 +1,258 @@
+// Check of SessionManager's per-session budgets: the throttle steps a
+// session takes over budget and lifts again under it.
+//
+//   dase_session_check [--nodes N] [--block N]
+//
+// Budgets are picked so every window's verdict is known up front, whatever
+// the host's speed: a cpu_load of 1e-9 is over on any block, one of 1e9
+// under, and a deadline watchdog at 1e11 Hz counts every block a miss. The
+// scenarios:
+//   steps     over budget, a session steps quality down to Draft, then the
+//             upper nodes' rate to a half, a quarter and an eighth, and
+//             holds there
+//   lift      under budget, one step comes off per window back to the base
+//             quality and rate, node groups cleared
+//   backoff   a lift followed by an over-budget window doubles the windows
+//             the next lift waits for; a good window after a lift halves it
+//   nodes     throttle_nodes off stops at Draft; a base quality of Low has
+//             one quality step, and the node steps follow it
+//   miss      throttle_on_miss steps on deadline misses alone
+//   clear     a budget with neither limit lifts every step at once
+//   reject    invalid budgets and unknown sessions throw
+// Each failed expectation is printed; the exit status is 1 when any fails.
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "session_manager.h"
+
+namespace {
+
+struct Options {
+    size_t nodes = 1024;
+    size_t block = 256;
+};
+
+constexpr double kTight = 1e-9;
+constexpr double kLoose = 1e9;
+constexpr size_t kWindow = 2;
+
+size_t g_checks = 0;
+size_t g_failures = 0;
+
+void expect(bool ok, const std::string& scenario, const std::string& what) {
+    g_checks++;
+    if (ok) return;
+    g_failures++;
+    std::printf("FAIL  %-8s %s\n", scenario.c_str(), what.c_str());
+}
+
+SessionBudget budgetOf(double cpu_load, bool throttle_on_miss = false, bool throttle_nodes = true) {
+    SessionBudget budget;
+    budget.cpu_load = cpu_load;
+    budget.throttle_on_miss = throttle_on_miss;
+    budget.window = kWindow;
+    budget.throttle_nodes = throttle_nodes;
+    return budget;
+}
+
+// One session on its own manager, fed silence one window at a time
+class Harness {
+public:
+    explicit Harness(const Options& opt) : in_(opt.block, 0.0f) {
+        SessionManagerConfig config;
+        config.threads_per_node = 1;
+        config.bind_memory = false;
+        manager_.reset(new SessionManager(config));
+        session_ = manager_->createSession(opt.nodes);
+    }
+
+    SessionManager& manager() { return *manager_; }
+    uint64_t session() const { return session_; }
+    AnalogCellularEngineAVX2& engine() { return manager_->engine(session_); }
+    SessionUsage usage() const { return manager_->usage(session_); }
+
+    void runWindows(size_t windows) {
+        SessionBlock block;
+        block.session = session_;
+        block.in = in_.data();
+        block.n = in_.size();
+        for (size_t b = 0; b < windows * kWindow; b++) manager_->processBlocks(&block, 1);
+    }
+
+    // Throttle, quality and node rate after one more window
+    void expectWindow(const std::string& scenario, unsigned throttle, ComputeQuality quality, unsigned divisor) {
+        runWindows(1);
+        expectState(scenario, throttle, quality, divisor);
+    }
+
+    void expectState(const std::string& scenario, unsigned throttle, ComputeQuality quality, unsigned divisor) {
+        const SessionUsage u = usage();
+        char what[192];
+        std::snprintf(what, sizeof(what), "throttle %u quality %s divisor %u, expected %u %s %u", u.throttle,
+                      computeQualityName(u.quality), u.node_rate_divisor, throttle, computeQualityName(quality),
+                      divisor);
+        expect(u.throttle == throttle && u.quality == quality && u.node_rate_divisor == divisor, scenario, what);
+        expect(engine().getNodeGroups().size() == (divisor > 1 ? 1u : 0u), scenario, "node groups");
+    }
+
+private:
+    std::unique_ptr<SessionManager> manager_;
+    uint64_t session_ = 0;
+    std::vector<float> in_;
+};
+
+void checkSteps(const Options& opt) {
+    Harness h(opt);
+    h.manager().setBudget(h.session(), budgetOf(kTight));
+    h.expectWindow("steps", 1, ComputeQuality::Reduced, 1);
+    h.expectWindow("steps", 2, ComputeQuality::Low, 1);
+    h.expectWindow("steps", 3, ComputeQuality::Draft, 1);
+    h.expectWindow("steps", 4, ComputeQuality::Draft, 2);
+    h.expectWindow("steps", 5, ComputeQuality::Draft, 4);
+    h.expectWindow("steps", 6, ComputeQuality::Draft, 8);
+    h.expectWindow("steps", 6, ComputeQuality::Draft, 8);
+    const std::vector<NodeGroup> groups = h.engine().getNodeGroups();
+    expect(groups.size() == 1 && groups[0].first_node == (opt.nodes / 4 + 7) / 8 * 8 &&
+               groups[0].first_node + groups[0].num_nodes == opt.nodes,
+           "steps", "node group covers the upper three quarters");
+    const SessionUsage u = h.usage();
+    expect(u.throttle_changes == 6, "steps", "6 changes at the bottom");
+    expect(u.throttled_blocks == 6 * kWindow, "steps", "blocks counted under a step");
+    expect(u.load > kTight, "steps", "window load reported");
+
+    h.manager().setBudget(h.session(), budgetOf(kLoose));
+    h.expectWindow("lift", 5, ComputeQuality::Draft, 4);
+    h.expectWindow("lift", 4, ComputeQuality::Draft, 2);
+    h.expectWindow("lift", 3, ComputeQuality::Draft, 1);
+    h.expectWindow("lift", 2, ComputeQuality::Low, 1);
+    h.expectWindow("lift", 1, ComputeQuality::Reduced, 1);
+    h.expectWindow("lift", 0, ComputeQuality::Full, 1);
+    h.expectWindow("lift", 0, ComputeQuality::Full, 1);
+    expect(h.usage().throttle_changes == 12, "lift", "12 changes back at the base");
+}
+
+void checkBackoff(const Options& opt) {
+    Harness h(opt);
+    h.manager().setBudget(h.session(), budgetOf(kTight));
+    h.runWindows(2);
+    h.expectState("backoff", 2, ComputeQuality::Low, 1);
+    // Lifted after one good window, over again: the next lift waits two
+    h.manager().setBudget(h.session(), budgetOf(kLoose));
+    h.expectWindow("backoff", 1, ComputeQuality::Reduced, 1);
+    h.manager().setBudget(h.session(), budgetOf(kTight));
+    h.expectWindow("backoff", 2, ComputeQuality::Low, 1);
+    h.manager().setBudget(h.session(), budgetOf(kLoose));
+    h.expectWindow("backoff", 2, ComputeQuality::Low, 1);
+    h.expectWindow("backoff", 1, ComputeQuality::Reduced, 1);
+    // Good after that lift: back to one window
+    h.expectWindow("backoff", 0, ComputeQuality::Full, 1);
+}
+
+void checkNodes(const Options& opt) {
+    Harness h(opt);
+    h.manager().setBudget(h.session(), budgetOf(kTight, false, false));
+    h.runWindows(3);
+    h.expectState("nodes", 3, ComputeQuality::Draft, 1);
+    h.expectWindow("nodes", 3, ComputeQuality::Draft, 1);
+
+    Harness low(opt);
+    low.engine().setComputeQuality(ComputeQuality::Low);
+    low.manager().setBudget(low.session(), budgetOf(kTight));
+    low.expectWindow("nodes", 1, ComputeQuality::Draft, 1);
+    low.expectWindow("nodes", 2, ComputeQuality::Draft, 2);
+    low.runWindows(3);
+    low.expectState("nodes", 4, ComputeQuality::Draft, 8);
+    low.manager().setBudget(low.session(), budgetOf(kLoose));
+    low.runWindows(4);
+    low.expectState("nodes", 0, ComputeQuality::Low, 1);
+}
+
+void checkMiss(const Options& opt) {
+    Harness h(opt);
+    h.engine().deadlineWatchdog().setSampleRate(1e11);
+    h.manager().setBudget(h.session(), budgetOf(0.0, true));
+    h.expectWindow("miss", 1, ComputeQuality::Reduced, 1);
+    h.expectWindow("miss", 2, ComputeQuality::Low, 1);
+    expect(h.usage().deadline_misses == 2 * kWindow, "miss", "misses counted");
+
+    // No misses: the same budget lifts
+    h.engine().deadlineWatchdog().setSampleRate(1e-3);
+    h.runWindows(2);
+    h.expectState("miss", 0, ComputeQuality::Full, 1);
+}
+
+void checkClear(const Options& opt) {
+    Harness h(opt);
+    h.manager().setBudget(h.session(), budgetOf(kTight));
+    h.runWindows(5);
+    h.expectState("clear", 5, ComputeQuality::Draft, 4);
+    h.manager().setBudget(h.session(), SessionBudget());
+    h.expectState("clear", 0, ComputeQuality::Full, 1);
+    h.expectWindow("clear", 0, ComputeQuality::Full, 1);
+}
+
+void expectThrow(const std::string& what, const std::function<void()>& call, bool out_of_range) {
+    try {
+        call();
+    } catch (const std::out_of_range&) {
+        expect(out_of_range, "reject", what);
+        return;
+    } catch (const std::invalid_argument&) {
+        expect(!out_of_range, "reject", what);
+        return;
+    }
+    expect(false, "reject", what + " accepted");
+}
+
+void checkReject(const Options& opt) {
+    Harness h(opt);
+    SessionBudget budget = budgetOf(kTight);
+    budget.window = 0;
+    expectThrow("window 0", [&] { h.manager().setBudget(h.session(), budget); }, false);
+    budget = budgetOf(kTight);
+    budget.release = 0.0;
+    expectThrow("release 0", [&] { h.manager().setBudget(h.session(), budget); }, false);
+    budget = budgetOf(-1.0);
+    expectThrow("negative cpu_load", [&] { h.manager().setBudget(h.session(), budget); }, false);
+    expectThrow("unknown session", [&] { h.manager().setBudget(h.session() + 1, budgetOf(kTight)); }, true);
+}
+
+int usage(const char* argv0) {
+    std::fprintf(stderr, "usage: %s [--nodes N] [--block N]\n", argv0);
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int a = 1; a < argc; a++) {
+        const std::string arg = argv[a];
+        if (a + 1 >= argc) return usage(argv[0]);
+        const std::string value = argv[++a];
+        if (arg == "--nodes") {
+            opt.nodes = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--block") {
+            opt.block = std::strtoull(value.c_str(), nullptr, 10);
+        } else {
+            return usage(argv[0]);
+        }
+    }
+    // Node steps need nodes past the first quarter
+    if (opt.nodes < 64 || opt.block == 0) return usage(argv[0]);
+
+    checkSteps(opt);
+    checkBackoff(opt);
+    checkNodes(opt);
+    checkMiss(opt);
+    checkClear(opt);
+    checkReject(opt);
+
+    std::printf("%zu of %zu checks passed\n", g_checks - g_failures, g_checks);
+    return g_failures == 0 ? 0 : 1;
+}
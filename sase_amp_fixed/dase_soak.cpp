@@ -0,0 +1,585 @@
+// Accelerated-time soak test of the hardware loops, without hardware or
+// Python in the loop.
+//
+//   dase_soak [--hours H] [--window-s S] [--settle-s S] [--drift-ppm PPM]
+//             [--wander-ppm PPM] [--wander-period-s S] [--jitter-us US]
+//             [--drop-rate P] [--seed N] [--max-rss-growth-kb KB]
+//             [--git-commit TEXT] [--output PATH]
+//
+// Checks the one-hour success criteria in minutes by running the loops on
+// a simulated clock as fast as they compute:
+//   SC-003  hybrid node stable for an hour, drift < 0.5%. The ADC→DSP→DAC
+//           loop runs on the node's USB audio path, the one backend driven
+//           by explicit clock readings: a 1 kHz tone goes out in 1 ms
+//           packets sized by the node's feedback, the processed audio
+//           comes back in IN packets. The output level of every window is
+//           compared with the first one after settling.
+//   SC-002  I²S bridge metrics loss < 0.1% over an hour. The software
+//           loopback carries four sequenced packets per half, with the
+//           master's 1 kHz sync pulses fed to the drift DLL.
+// Faults are injected on the simulated clock:
+//   drift   the node's clock runs drift_ppm fast against the host bus and
+//           the I²S master, wandering by wander_ppm over wander_period_s
+//           (as with temperature)
+//   jitter  every SOF and sync pulse is read up to jitter_us early or late
+//   drops   each SOF, OUT packet, sync pulse and RX half is lost with
+//           probability drop_rate: a missed interrupt or DMA completion
+// Every loss the bridge reports must be one injected, the node must track
+// the clock and recover from every drop, and resident memory must not grow
+// after settling. Per-window rows, the criteria and the verdict are
+// written as JSON, to stdout unless --output is given; the exit status is
+// 0 on a pass and 1 on a fail.
+//
+// Build with I2S_BRIDGE_LOOPBACK (see `make soak`).
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "engine_benchmark.h"
+#include "latency_histogram.h"
+#include "hybrid_node.h"
+#include "i2s_bridge.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr uint32_t kSampleRate = 48000;
+constexpr size_t kUsbBuffer = 48;           // Node buffer: one 1 ms packet
+constexpr double kBusFrameUs = 1000.0;      // Full-speed SOF period
+constexpr double kHalfUs = 1e6 * I2S_BUFFER_SIZE / I2S_SAMPLE_RATE;
+constexpr double kPulseUs = 1e6 / GPIO_SYNC_FREQ_HZ;
+constexpr size_t kPacketsPerHalf = 4;
+constexpr float kToneLevel = 0.25f;
+constexpr float kI2sScale = 8388607.0f;
+
+// Limits of the verdict besides the success criteria themselves
+constexpr double kMaxLevelDriftPercent = 0.5;     // SC-003
+constexpr double kMaxLossRate = 0.001;            // SC-002
+constexpr double kMaxClockErrorPpm = 20.0;        // Node feedback and bridge DLL
+constexpr uint32_t kMaxLoopLatencyUs = 4000;      // USB round trip after settling, as the node self-test
+
+struct Options {
+    double hours = 1.0;
+    double window_s = 60.0;
+    double settle_s = 30.0;
+    double drift_ppm = 100.0;
+    double wander_ppm = 25.0;
+    double wander_period_s = 600.0;
+    double jitter_us = 5.0;
+    double drop_rate = 1e-4;
+    uint64_t seed = 1;
+    uint64_t max_rss_growth_kb = 1024;
+    std::string git_commit = "unknown";
+    std::string output;
+};
+
+// The node's clock against the host and the master at simulated time t
+struct ClockModel {
+    double drift_ppm;
+    double wander_ppm;
+    double wander_period_s;
+
+    double ppm(double t_s) const {
+        return drift_ppm + wander_ppm * std::sin(2.0 * M_PI * t_s / wander_period_s);
+    }
+    // Node microseconds elapsed at t: the integral of 1 + ppm(t) * 1e-6
+    double nodeUs(double t_s) const {
+        const double wander = wander_ppm * wander_period_s / (2.0 * M_PI) *
+                              (1.0 - std::cos(2.0 * M_PI * t_s / wander_period_s));
+        return t_s * 1e6 + drift_ppm * t_s + wander;
+    }
+};
+
+// Injected faults, from one seeded generator so a run can be repeated
+struct Faults {
+    std::mt19937_64 rng;
+    std::uniform_real_distribution<double> unit{0.0, 1.0};
+    double jitter_us;
+    double drop_rate;
+
+    double jitter() { return jitter_us * (2.0 * unit(rng) - 1.0); }
+    bool drop() { return drop_rate > 0.0 && unit(rng) < drop_rate; }
+};
+
+// Counters of one window, or of the run
+struct Tally {
+    double level_sum = 0.0;        // Squares of the node's output channel 0
+    uint64_t level_samples = 0;
+    uint64_t sof_drops = 0;
+    uint64_t out_drops = 0;
+    uint64_t pulse_drops = 0;
+    uint64_t half_drops = 0;
+    uint64_t packets_lost = 0;     // Packets of the halves dropped
+    uint64_t halves = 0;
+    uint32_t max_queue = 0;        // Fullest the node's IN queue was after a packet
+};
+
+struct Window {
+    double end_s = 0.0;
+    double level = 0.0;            // Output RMS
+    double level_drift_percent = 0.0;
+    double injected_ppm = 0.0;
+    double node_clock_ppm = 0.0;
+    double bridge_drift_ppm = 0.0;
+    uint64_t xruns = 0;
+    uint32_t loop_latency_us = 0;  // Round trip of the fullest IN queue
+    uint64_t node_drops = 0;       // SOFs and OUT packets lost
+    uint64_t packets_dropped = 0;  // By the bridge's count
+    uint64_t packets_lost = 0;     // Injected
+    uint32_t node_p99_ns = 0;
+    uint64_t bridge_p99_ns = 0;
+    uint64_t rss_kb = 0;
+};
+
+// Resident set in KiB, 0 where /proc is not available
+uint64_t residentKb() {
+    FILE* f = std::fopen("/proc/self/statm", "r");
+    if (!f) return 0;
+    unsigned long long size = 0, resident = 0;
+    const int n = std::fscanf(f, "%llu %llu", &size, &resident);
+    std::fclose(f);
+    return n == 2 ? resident * 4 : 0;
+}
+
+HybridNode* openNode() {
+    HybridNodeConfig config = {};
+    config.interface_type = HYBRID_INTERFACE_USB;
+    config.sample_rate = kSampleRate;
+    config.buffer_size = kUsbBuffer;
+    config.adc_channels = HYBRID_ADC_CHANNELS;
+    config.dac_channels = HYBRID_DAC_CHANNELS;
+    config.preamp_gain = 1.0f;
+    config.hpf_cutoff = ANALOG_HPF_CUTOFF;
+    config.lpf_cutoff = ANALOG_LPF_CUTOFF;
+    config.enable_analog_filter = true;
+    config.fft_size = HYBRID_FFT_SIZE;
+    config.enable_dsp = true;
+    config.enable_coherence = true;
+    config.enable_ici = true;
+    config.enable_modulation = true;
+    config.modulation_depth = 0.8f;
+    config.control_loop_rate = 100.0f;
+    config.enable_voltage_clamp = true;
+    config.voltage_max = SAFETY_VOLTAGE_MAX;
+    config.mode = HYBRID_MODE_DSP_ONLY;
+    HybridNode* node = hybrid_node_create();
+    if (node && hybrid_init(node, &config) && hybrid_usb_open(node, nullptr) && hybrid_start(node)) return node;
+    hybrid_node_destroy(node);
+    return nullptr;
+}
+
+I2SBridge* openBridge() {
+    I2SBridgeConfig config = {};
+    config.mode = I2S_MODE_SLAVE;
+    config.sample_rate = I2S_SAMPLE_RATE;
+    config.bit_depth = I2S_BIT_DEPTH;
+    config.channels = I2S_CHANNELS;
+    config.buffer_size = I2S_BUFFER_SIZE;
+    config.enable_gpio_sync = true;
+    I2SBridge* bridge = i2s_bridge_create();
+    if (bridge && i2s_init(bridge, &config) && i2s_start(bridge)) return bridge;
+    i2s_bridge_destroy(bridge);
+    return nullptr;
+}
+
+// The host side of the node's USB stream
+struct UsbHost {
+    double packet_phase = 0.0;     // Frames owed to the next OUT packet
+    double tone_phase = 0.0;
+    uint32_t feedback = 0;         // 10.14 frames per bus frame, as last received
+};
+
+bool runBusFrame(HybridNode* node, UsbHost& host, const ClockModel& clock, Faults& faults, uint64_t frame,
+                 Tally& tally) {
+    const double t_s = frame * kBusFrameUs * 1e-6;
+    const uint64_t node_us = static_cast<uint64_t>(std::llround(clock.nodeUs(t_s) + faults.jitter()));
+    if (faults.drop()) {
+        tally.sof_drops++;
+    } else {
+        const uint32_t feedback = hybrid_usb_sof(node, static_cast<uint32_t>(node_us));
+        if (feedback != 0) host.feedback = feedback;
+    }
+    if (host.feedback == 0) host.feedback = static_cast<uint32_t>(kSampleRate / 1000 * 16384);
+
+    host.packet_phase += host.feedback / 16384.0;
+    const size_t sent = static_cast<size_t>(host.packet_phase);
+    host.packet_phase -= static_cast<double>(sent);
+
+    size_t room = 0;
+    HybridUsbSample* packet = hybrid_usb_out_buffer(node, &room);
+    if (!packet || sent > room) return false;
+    for (size_t i = 0; i < sent; i++) {
+        const float x = kToneLevel * static_cast<float>(std::sin(host.tone_phase));
+        host.tone_phase += 2.0 * M_PI * CAL_TONE_FREQ / kSampleRate;
+        for (size_t c = 0; c < HYBRID_ADC_CHANNELS; c++) {
+#ifdef HYBRID_NODE_Q31
+            packet[i * HYBRID_ADC_CHANNELS + c] = static_cast<HybridUsbSample>(std::lrint(x * 2147483647.0f));
+#else
+            packet[i * HYBRID_ADC_CHANNELS + c] = x;
+#endif
+        }
+    }
+    host.tone_phase = std::fmod(host.tone_phase, 2.0 * M_PI);
+    if (faults.drop()) {
+        tally.out_drops++;  // Lost on the bus; the tone moved on
+    } else if (!hybrid_usb_out_complete(node, sent)) {
+        return false;
+    }
+
+    size_t frames = 0;
+    const HybridUsbSample* in = hybrid_usb_in_packet(node, &frames);
+    if (!in) return false;
+    double squares = 0.0;
+    bool silent = true;
+    for (size_t i = 0; i < frames; i++) {
+#ifdef HYBRID_NODE_Q31
+        const double v = in[i * HYBRID_DAC_CHANNELS] / 2147483648.0;
+#else
+        const double v = in[i * HYBRID_DAC_CHANNELS];
+#endif
+        squares += v * v;
+        silent = silent && v == 0.0;
+    }
+    // Underrun packets are silence, counted as xruns instead
+    if (!silent) {
+        tally.level_sum += squares;
+        tally.level_samples += frames;
+    }
+    HybridUsbStats usb;
+    hybrid_usb_get_stats(node, &usb);
+    tally.max_queue = std::max(tally.max_queue, usb.queue_frames);
+    return true;
+}
+
+// The master's sync pulses over one half, read on the node's clock
+void runSyncPulses(I2SBridge* bridge, const ClockModel& clock, Faults& faults, uint64_t& pulse, double until_s,
+                   Tally& tally) {
+    for (; pulse * kPulseUs * 1e-6 < until_s; pulse++) {
+        if (faults.drop()) {
+            tally.pulse_drops++;
+            continue;
+        }
+        const double local_us = clock.nodeUs(pulse * kPulseUs * 1e-6) + faults.jitter();
+        i2s_sync_pulse(bridge, static_cast<uint32_t>(static_cast<uint64_t>(std::llround(local_us))));
+    }
+}
+
+// One half through the loopback; a dropped one is sent but never read,
+// so the next read finds it overwritten
+bool runHalf(I2SBridge* bridge, Faults& faults, uint32_t& sequence, uint64_t half, LatencyHistogram& latency,
+             Tally& tally) {
+    const auto t0 = Clock::now();
+    const bool missed = faults.drop();
+    for (int pass = 0; pass < (missed ? 2 : 1); pass++) {
+        int32_t* tx = i2s_acquire_tx(bridge);
+        if (!tx) return false;
+        for (size_t i = 0; i < I2S_BUFFER_SIZE; i++) {
+            const float v = 0.5f * static_cast<float>(std::sin(2.0 * M_PI * CAL_TONE_FREQ * i / I2S_SAMPLE_RATE));
+            for (size_t ch = 0; ch < I2S_AUDIO_CHANNELS; ch++) {
+                tx[i * I2S_CHANNELS + ch] = static_cast<int32_t>(std::lrint(v * kI2sScale));
+            }
+        }
+        ConsciousnessMetrics packets[kPacketsPerHalf] = {};
+        for (size_t k = 0; k < kPacketsPerHalf; k++) {
+            packets[k].phi_depth = 0.5f;
+            packets[k].coherence = 0.9f;
+            packets[k].timestamp_us = static_cast<uint32_t>((half + pass) * kHalfUs);
+            packets[k].sequence = sequence++;
+        }
+        if (!i2s_commit_tx(bridge, packets, kPacketsPerHalf)) return false;
+    }
+    if (missed) {
+        tally.half_drops++;
+        tally.packets_lost += kPacketsPerHalf;
+    }
+
+    ConsciousnessMetrics received[kPacketsPerHalf];
+    size_t count = 0;
+    if (!i2s_acquire_rx(bridge, received, kPacketsPerHalf, &count) || !i2s_release_rx(bridge)) return false;
+    i2s_check_link(bridge);
+    latency.record(static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count()));
+    tally.halves++;
+    return count == kPacketsPerHalf;
+}
+
+void writeWindow(std::ostringstream& s, const Window& w, bool last) {
+    s << "    {\"end_s\": " << w.end_s << ", \"level\": " << w.level
+      << ", \"level_drift_percent\": " << w.level_drift_percent << ", \"injected_ppm\": " << w.injected_ppm
+      << ", \"node_clock_ppm\": " << w.node_clock_ppm << ", \"bridge_drift_ppm\": " << w.bridge_drift_ppm
+      << ", \"xruns\": " << w.xruns << ", \"loop_latency_ms\": " << w.loop_latency_us * 1e-3
+      << ", \"node_drops\": " << w.node_drops
+      << ", \"packets_dropped\": " << w.packets_dropped << ", \"packets_lost\": " << w.packets_lost
+      << ", \"node_p99_ms\": " << w.node_p99_ns * 1e-6 << ", \"bridge_p99_ms\": " << w.bridge_p99_ns * 1e-6
+      << ", \"rss_kb\": " << w.rss_kb << "}" << (last ? "\n" : ",\n");
+}
+
+const char* verdict(bool pass) { return pass ? "true" : "false"; }
+
+int usage(const char* argv0) {
+    std::fprintf(stderr,
+                 "usage: %s [--hours H] [--window-s S] [--settle-s S] [--drift-ppm PPM] [--wander-ppm PPM]\n"
+                 "          [--wander-period-s S] [--jitter-us US] [--drop-rate P] [--seed N]\n"
+                 "          [--max-rss-growth-kb KB] [--git-commit TEXT] [--output PATH]\n",
+                 argv0);
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    for (int a = 1; a < argc; a++) {
+        const std::string arg = argv[a];
+        if (a + 1 >= argc) return usage(argv[0]);
+        const std::string value = argv[++a];
+        if (arg == "--hours") {
+            opt.hours = std::max(0.001, std::atof(value.c_str()));
+        } else if (arg == "--window-s") {
+            opt.window_s = std::max(1.0, std::atof(value.c_str()));
+        } else if (arg == "--settle-s") {
+            opt.settle_s = std::max(0.0, std::atof(value.c_str()));
+        } else if (arg == "--drift-ppm") {
+            opt.drift_ppm = std::atof(value.c_str());
+        } else if (arg == "--wander-ppm") {
+            opt.wander_ppm = std::atof(value.c_str());
+        } else if (arg == "--wander-period-s") {
+            opt.wander_period_s = std::max(1.0, std::atof(value.c_str()));
+        } else if (arg == "--jitter-us") {
+            opt.jitter_us = std::max(0.0, std::atof(value.c_str()));
+        } else if (arg == "--drop-rate") {
+            opt.drop_rate = std::min(std::max(0.0, std::atof(value.c_str())), 0.1);
+        } else if (arg == "--seed") {
+            opt.seed = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--max-rss-growth-kb") {
+            opt.max_rss_growth_kb = std::strtoull(value.c_str(), nullptr, 10);
+        } else if (arg == "--git-commit") {
+            opt.git_commit = value;
+        } else if (arg == "--output") {
+            opt.output = value;
+        } else {
+            return usage(argv[0]);
+        }
+    }
+
+    HybridNode* node = openNode();
+    if (!node) {
+        std::fprintf(stderr, "dase_soak: hybrid node failed to start on the USB path\n");
+        return 1;
+    }
+    I2SBridge* bridge = openBridge();
+    if (!bridge) {
+        std::fprintf(stderr, "dase_soak: I2S bridge failed to start (build with -DI2S_BRIDGE_LOOPBACK)\n");
+        return 1;
+    }
+
+    const ClockModel clock = {opt.drift_ppm, opt.wander_ppm, opt.wander_period_s};
+    Faults faults{std::mt19937_64(opt.seed), {}, opt.jitter_us, opt.drop_rate};
+    const uint64_t total_frames = static_cast<uint64_t>(opt.hours * 3600.0 * 1e6 / kBusFrameUs);
+    const uint64_t window_frames = std::max<uint64_t>(1, static_cast<uint64_t>(opt.window_s * 1e6 / kBusFrameUs));
+    const uint64_t settle_frames = static_cast<uint64_t>(opt.settle_s * 1e6 / kBusFrameUs);
+
+    UsbHost host;
+    LatencyHistogram bridge_window_latency;
+    Tally run, window;
+    std::vector<Window> windows;
+    windows.reserve(static_cast<size_t>(total_frames / window_frames) + 1);
+    uint32_t sequence = 0;
+    uint64_t half = 0, pulse = 0;
+    uint64_t xruns_mark = 0, dropped_mark = 0;
+    uint64_t settled_xruns = 0, settled_node_drops = 0;
+    double reference_level = 0.0, max_level_drift = 0.0, max_clock_error = 0.0, max_bridge_error = 0.0;
+    uint64_t settled_rss = 0, max_rss = 0;
+    uint32_t worst_node_p99 = 0, max_loop_latency = 0;
+    uint64_t worst_bridge_p99 = 0;
+    bool settled = false, ok = true;
+
+    const auto wall_start = Clock::now();
+    for (uint64_t frame = 0; ok && frame < total_frames; frame++) {
+        ok = runBusFrame(node, host, clock, faults, frame, window);
+
+        // The bridge's halves due by the end of this bus frame
+        const double now_s = (frame + 1) * kBusFrameUs * 1e-6;
+        while (ok && (half + 1) * kHalfUs * 1e-6 <= now_s) {
+            runSyncPulses(bridge, clock, faults, pulse, (half + 1) * kHalfUs * 1e-6, window);
+            ok = runHalf(bridge, faults, sequence, half, bridge_window_latency, window);
+            half++;
+        }
+
+        const bool window_end = (frame + 1) % window_frames == 0 || frame + 1 == total_frames;
+        if (!ok || !window_end) continue;
+
+        HybridUsbStats usb = {};
+        I2SStatistics link = {};
+        HybridLatencyStats node_latency = {};
+        hybrid_usb_get_stats(node, &usb);
+        i2s_get_statistics(bridge, &link);
+        hybrid_get_latency(node, &node_latency);
+        hybrid_reset_latency(node);
+        const LatencySnapshot half_latency = bridge_window_latency.snapshot();
+
+        Window w;
+        w.end_s = now_s;
+        w.level = window.level_samples > 0 ? std::sqrt(window.level_sum / window.level_samples) : 0.0;
+        w.injected_ppm = clock.ppm(now_s);
+        w.node_clock_ppm = usb.clock_ppm;
+        w.bridge_drift_ppm = i2s_calibrate_drift(bridge);
+        w.xruns = usb.underruns + usb.overruns - xruns_mark;
+        w.loop_latency_us = static_cast<uint32_t>((kUsbBuffer + window.max_queue) * 1000000u / kSampleRate);
+        w.node_drops = window.sof_drops + window.out_drops;
+        w.packets_dropped = link.frames_dropped - dropped_mark;
+        w.packets_lost = window.packets_lost;
+        w.node_p99_ns = node_latency.p99_ns;
+        w.bridge_p99_ns = half_latency.p99_ns;
+        w.rss_kb = residentKb();
+        xruns_mark = usb.underruns + usb.overruns;
+        dropped_mark = link.frames_dropped;
+
+        // The first window wholly after settling is the reference
+        if (!settled && frame + 1 >= settle_frames + window_frames) {
+            settled = true;
+            reference_level = w.level;
+            settled_rss = w.rss_kb;
+        } else if (settled) {
+            settled_xruns += w.xruns;
+            settled_node_drops += w.node_drops;
+        }
+        if (settled) {
+            w.level_drift_percent = reference_level > 0.0 ? 100.0 * (w.level - reference_level) / reference_level : 0.0;
+            max_level_drift = std::max(max_level_drift, std::fabs(w.level_drift_percent));
+            // The node measures over its last second, the DLL over ~10 s
+            max_clock_error = std::max(max_clock_error, std::fabs(w.node_clock_ppm - w.injected_ppm));
+            max_bridge_error = std::max(max_bridge_error, std::fabs(w.bridge_drift_ppm + w.injected_ppm));
+            max_rss = std::max(max_rss, w.rss_kb);
+            worst_node_p99 = std::max(worst_node_p99, w.node_p99_ns);
+            max_loop_latency = std::max(max_loop_latency, w.loop_latency_us);
+            worst_bridge_p99 = std::max(worst_bridge_p99, w.bridge_p99_ns);
+        }
+        windows.push_back(w);
+
+        run.sof_drops += window.sof_drops;
+        run.out_drops += window.out_drops;
+        run.pulse_drops += window.pulse_drops;
+        run.half_drops += window.half_drops;
+        run.packets_lost += window.packets_lost;
+        run.halves += window.halves;
+        window = Tally();
+        bridge_window_latency.reset();
+        std::fprintf(stderr, "\r%6.1f/%.1f min  level %+.4f%%  clock %+.1f ppm  loss %llu", now_s / 60.0,
+                     opt.hours * 60.0, w.level_drift_percent, w.node_clock_ppm,
+                     static_cast<unsigned long long>(link.frames_dropped));
+    }
+    std::fprintf(stderr, "\n");
+    const double wall_s = std::chrono::duration<double>(Clock::now() - wall_start).count();
+
+    HybridUsbStats usb = {};
+    I2SStatistics link = {};
+    hybrid_usb_get_stats(node, &usb);
+    i2s_get_statistics(bridge, &link);
+    const I2SLinkStatus link_status = i2s_check_link(bridge);
+    i2s_stop(bridge);
+    i2s_bridge_destroy(bridge);
+    hybrid_stop(node);
+    hybrid_usb_close(node);
+    hybrid_node_destroy(node);
+    if (!ok) {
+        std::fprintf(stderr, "dase_soak: a loop stopped taking buffers\n");
+        return 1;
+    }
+
+    // SC-003: level and clock hold, every xrun after settling is owed to a
+    // drop, the round trip stays bounded and memory does not grow
+    const uint64_t rss_growth = max_rss > settled_rss ? max_rss - settled_rss : 0;
+    const bool rss_ok = settled_rss == 0 || rss_growth <= opt.max_rss_growth_kb;
+    const bool node_ok = settled && max_level_drift < kMaxLevelDriftPercent && max_clock_error <= kMaxClockErrorPpm &&
+                         settled_xruns <= settled_node_drops && max_loop_latency <= kMaxLoopLatencyUs &&
+                         rss_ok;
+    // SC-002: loss under 0.1%, none the harness did not inject, no corrupt
+    // packets, the DLL on the master's clock and the link up at the end
+    const uint64_t unexplained = link.frames_dropped > run.packets_lost ? link.frames_dropped - run.packets_lost : 0;
+    const bool bridge_ok = link.loss_rate < kMaxLossRate && unexplained == 0 && link.packets_corrupt == 0 &&
+                           max_bridge_error <= kMaxClockErrorPpm && link_status == I2S_LINK_STABLE;
+    const bool pass = node_ok && bridge_ok;
+
+    std::ostringstream s;
+    s << std::setprecision(6) << std::fixed;
+    s << "{\n"
+      << "  \"version\": \"1.0.0\",\n"
+      << "  \"benchmark_date\": " << benchmarkJsonString(benchmarkDate()) << ",\n"
+      << "  \"git_commit\": " << benchmarkJsonString(opt.git_commit) << ",\n"
+      << "  \"system_info\": {\n"
+      << "    \"os\": " << benchmarkJsonString(benchmarkHostOs()) << "\n"
+      << "  },\n"
+      << "  \"config\": {\n"
+      << "    \"simulated_hours\": " << opt.hours << ",\n"
+      << "    \"window_s\": " << opt.window_s << ",\n"
+      << "    \"settle_s\": " << opt.settle_s << ",\n"
+      << "    \"drift_ppm\": " << opt.drift_ppm << ",\n"
+      << "    \"wander_ppm\": " << opt.wander_ppm << ",\n"
+      << "    \"wander_period_s\": " << opt.wander_period_s << ",\n"
+      << "    \"jitter_us\": " << opt.jitter_us << ",\n"
+      << "    \"drop_rate\": " << opt.drop_rate << ",\n"
+      << "    \"seed\": " << opt.seed << "\n"
+      << "  },\n"
+      << "  \"wall_seconds\": " << wall_s << ",\n"
+      << "  \"speedup\": " << (wall_s > 0.0 ? opt.hours * 3600.0 / wall_s : 0.0) << ",\n"
+      << "  \"sc003_hybrid_node\": {\n"
+      << "    \"max_level_drift_percent\": " << max_level_drift << ",\n"
+      << "    \"max_clock_error_ppm\": " << max_clock_error << ",\n"
+      << "    \"xruns_after_settling\": " << settled_xruns << ",\n"
+      << "    \"drops_after_settling\": " << settled_node_drops << ",\n"
+      << "    \"sof_drops\": " << run.sof_drops << ",\n"
+      << "    \"out_drops\": " << run.out_drops << ",\n"
+      << "    \"mean_loop_latency_ms\": " << usb.mean_loop_latency_us * 1e-3 << ",\n"
+      << "    \"max_loop_latency_ms\": " << max_loop_latency * 1e-3 << ",\n"
+      << "    \"worst_window_p99_ms\": " << worst_node_p99 * 1e-6 << ",\n"
+      << "    \"rss_growth_kb\": " << rss_growth << ",\n"
+      << "    \"pass\": " << verdict(node_ok) << "\n"
+      << "  },\n"
+      << "  \"sc002_i2s_bridge\": {\n"
+      << "    \"packets_transmitted\": " << link.packets_transmitted << ",\n"
+      << "    \"packets_received\": " << link.packets_received << ",\n"
+      << "    \"packets_dropped\": " << link.frames_dropped << ",\n"
+      << "    \"packets_injected_lost\": " << run.packets_lost << ",\n"
+      << "    \"packets_unexplained\": " << unexplained << ",\n"
+      << "    \"packets_corrupt\": " << link.packets_corrupt << ",\n"
+      << "    \"loss_rate\": " << link.loss_rate << ",\n"
+      << "    \"rx_overruns\": " << link.rx_overruns << ",\n"
+      << "    \"sync_pulse_drops\": " << run.pulse_drops << ",\n"
+      << "    \"max_drift_error_ppm\": " << max_bridge_error << ",\n"
+      << "    \"worst_window_p99_ms\": " << worst_bridge_p99 * 1e-6 << ",\n"
+      << "    \"link_stable\": " << verdict(link_status == I2S_LINK_STABLE) << ",\n"
+      << "    \"pass\": " << verdict(bridge_ok) << "\n"
+      << "  },\n"
+      << "  \"windows\": [\n";
+    for (size_t i = 0; i < windows.size(); i++) writeWindow(s, windows[i], i + 1 == windows.size());
+    s << "  ],\n"
+      << "  \"pass\": " << verdict(pass) << "\n"
+      << "}\n";
+
+    std::fprintf(stderr,
+                 "%.2f simulated h in %.1f s (%.0fx): SC-003 %s (drift %.4f%%, clock error %.1f ppm), "
+                 "SC-002 %s (loss %.5f%%, %llu unexplained)\n",
+                 opt.hours, wall_s, wall_s > 0.0 ? opt.hours * 3600.0 / wall_s : 0.0, node_ok ? "pass" : "FAIL",
+                 max_level_drift, max_clock_error, bridge_ok ? "pass" : "FAIL", 100.0 * link.loss_rate,
+                 static_cast<unsigned long long>(unexplained));
+    if (opt.output.empty()) {
+        std::fputs(s.str().c_str(), stdout);
+        return pass ? 0 : 1;
+    }
+    FILE* file = std::fopen(opt.output.c_str(), "w");
+    if (!file || std::fputs(s.str().c_str(), file) < 0 || std::fclose(file) != 0) {
+        std::fprintf(stderr, "dase_soak: could not write %s\n", opt.output.c_str());
+        return 1;
+    }
+    return pass ? 0 : 1;
+}
@@ -0,0 +1,99 @@
+#include "deadline_watchdog.h"
+#include <stdexcept>
+
+namespace {
+
+// Single writer per stage: plain load and store, as MetricsRegistry's slots
+void bump(std::atomic<uint64_t>& counter, uint64_t by = 1) {
+    counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+}
+
+} // namespace
+
+DeadlineWatchdog::DeadlineWatchdog(double sample_rate, double near_miss) : sample_rate_(0.0), near_miss_(0.0) {
+    setSampleRate(sample_rate);
+    setNearMiss(near_miss);
+}
+
+void DeadlineWatchdog::setSampleRate(double sample_rate) {
+    if (!(sample_rate > 0.0)) throw std::invalid_argument("deadline watchdog sample rate must be positive");
+    sample_rate_.store(sample_rate, std::memory_order_relaxed);
+}
+
+void DeadlineWatchdog::setNearMiss(double fraction) {
+    if (!(fraction > 0.0 && fraction <= 1.0)) {
+        throw std::invalid_argument("deadline near-miss fraction must be in (0, 1]");
+    }
+    near_miss_.store(fraction, std::memory_order_relaxed);
+}
+
+void DeadlineWatchdog::setCallback(Callback callback, bool on_near_miss) {
+    callback_ = std::move(callback);
+    callback_near_miss_ = on_near_miss;
+}
+
+void DeadlineWatchdog::record(DeadlineStage stage, uint64_t elapsed_ns, uint64_t budget_ns) {
+    if (!enabled()) return;
+    Counters& c = stages_[static_cast<size_t>(stage)];
+    const uint64_t call = c.calls.load(std::memory_order_relaxed);
+    c.calls.store(call + 1, std::memory_order_relaxed);
+    c.last_ns.store(elapsed_ns, std::memory_order_relaxed);
+    if (elapsed_ns > c.worst_ns.load(std::memory_order_relaxed)) c.worst_ns.store(elapsed_ns, std::memory_order_relaxed);
+    if (budget_ns == 0) return;
+    c.budget_ns.store(budget_ns, std::memory_order_relaxed);
+    const double load = static_cast<double>(elapsed_ns) / static_cast<double>(budget_ns);
+    if (load > c.worst_load.load(std::memory_order_relaxed)) c.worst_load.store(load, std::memory_order_relaxed);
+
+    const bool miss = elapsed_ns > budget_ns;
+    const bool near_miss = !miss && load > nearMiss();
+    if (miss) {
+        bump(c.misses);
+        const uint64_t run = c.consecutive.load(std::memory_order_relaxed) + 1;
+        c.consecutive.store(run, std::memory_order_relaxed);
+        if (run > c.max_consecutive.load(std::memory_order_relaxed)) {
+            c.max_consecutive.store(run, std::memory_order_relaxed);
+        }
+    } else {
+        c.consecutive.store(0, std::memory_order_relaxed);
+        if (near_miss) bump(c.near_misses);
+    }
+    if (callback_ && (miss || (near_miss && callback_near_miss_))) {
+        DeadlineEvent event;
+        event.stage = stage;
+        event.call = call;
+        event.elapsed_ns = elapsed_ns;
+        event.budget_ns = budget_ns;
+        event.miss = miss;
+        callback_(event);
+    }
+}
+
+DeadlineHealth DeadlineWatchdog::health(DeadlineStage stage) const {
+    if (stage >= DeadlineStage::StageCount) throw std::out_of_range("deadline stage out of range");
+    const Counters& c = stages_[static_cast<size_t>(stage)];
+    DeadlineHealth h;
+    h.calls = c.calls.load(std::memory_order_relaxed);
+    h.misses = c.misses.load(std::memory_order_relaxed);
+    h.near_misses = c.near_misses.load(std::memory_order_relaxed);
+    h.consecutive_misses = c.consecutive.load(std::memory_order_relaxed);
+    h.max_consecutive_misses = c.max_consecutive.load(std::memory_order_relaxed);
+    h.last_ns = c.last_ns.load(std::memory_order_relaxed);
+    h.worst_ns = c.worst_ns.load(std::memory_order_relaxed);
+    h.budget_ns = c.budget_ns.load(std::memory_order_relaxed);
+    h.worst_load = c.worst_load.load(std::memory_order_relaxed);
+    return h;
+}
+
+void DeadlineWatchdog::reset() {
+    for (Counters& c : stages_) {
+        c.calls.store(0, std::memory_order_relaxed);
+        c.misses.store(0, std::memory_order_relaxed);
+        c.near_misses.store(0, std::memory_order_relaxed);
+        c.consecutive.store(0, std::memory_order_relaxed);
+        c.max_consecutive.store(0, std::memory_order_relaxed);
+        c.last_ns.store(0, std::memory_order_relaxed);
+        c.worst_ns.store(0, std::memory_order_relaxed);
+        c.budget_ns.store(0, std::memory_order_relaxed);
+        c.worst_load.store(0.0, std::memory_order_relaxed);
+    }
+}
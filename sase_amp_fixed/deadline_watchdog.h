@@ -0,0 +1,105 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+// Block entry points the engine's watchdog times
+enum class DeadlineStage : uint8_t {
+    EngineBlock = 0,     // processBlock
+    ChromaticBlock = 1,  // processChromaticBlock, with its automation
+    FilterBlock = 2,     // processFilterBlock
+    StageCount
+};
+
+// Deadline health of one stage since the last reset
+struct DeadlineHealth {
+    uint64_t calls = 0;
+    uint64_t misses = 0;                  // Calls over their budget
+    uint64_t near_misses = 0;             // Within budget, over nearMiss() of it
+    uint64_t consecutive_misses = 0;      // Misses in a row up to the last call
+    uint64_t max_consecutive_misses = 0;
+    uint64_t last_ns = 0;
+    uint64_t worst_ns = 0;
+    uint64_t budget_ns = 0;               // Of the last call
+    double worst_load = 0.0;              // Largest time over budget of a call
+};
+
+// A miss or near miss, handed to the watchdog's callback
+struct DeadlineEvent {
+    DeadlineStage stage = DeadlineStage::EngineBlock;
+    uint64_t call = 0;                    // Index of the call in its stage
+    uint64_t elapsed_ns = 0;
+    uint64_t budget_ns = 0;
+    bool miss = false;                    // false for a near miss
+};
+
+// Deadline watchdog of real-time block callbacks.
+//
+// Each call records its time against its budget, the real-time length of
+// the block it produced (frames / sample rate): over the budget is a miss,
+// over nearMiss() of it (0.8 by default) a near miss. The counters are
+// per stage, relaxed atomics with one writer, readable from any thread.
+// An optional callback runs on the calling thread right after a miss, and
+// after a near miss when asked for, e.g. to shed load; it must not block
+// and runs before the call returns, so it adds to the next block's time.
+class DeadlineWatchdog {
+public:
+    using Callback = std::function<void(const DeadlineEvent&)>;
+
+    static constexpr size_t kStages = static_cast<size_t>(DeadlineStage::StageCount);
+
+    // Throws std::invalid_argument as the setters
+    explicit DeadlineWatchdog(double sample_rate = 48000.0, double near_miss = 0.8);
+
+    DeadlineWatchdog(const DeadlineWatchdog&) = delete;
+    DeadlineWatchdog& operator=(const DeadlineWatchdog&) = delete;
+
+    // Rate that turns the frames of callers without their own into a budget.
+    // Throws std::invalid_argument unless positive.
+    void setSampleRate(double sample_rate);
+    double sampleRate() const { return sample_rate_.load(std::memory_order_relaxed); }
+    // Fraction of the budget past which a call is a near miss, in (0, 1].
+    // Throws std::invalid_argument otherwise.
+    void setNearMiss(double fraction);
+    double nearMiss() const { return near_miss_.load(std::memory_order_relaxed); }
+    // Not while blocks run; an empty callback detaches
+    void setCallback(Callback callback, bool on_near_miss = false);
+
+    // Off: record() returns at once. On by default.
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    uint64_t budgetNs(size_t frames, double sample_rate) const {
+        return sample_rate > 0.0 ? static_cast<uint64_t>(static_cast<double>(frames) / sample_rate * 1e9) : 0;
+    }
+    uint64_t budgetNs(size_t frames) const { return budgetNs(frames, sampleRate()); }
+
+    // One call of stage; budget 0 counts the call without judging it
+    void record(DeadlineStage stage, uint64_t elapsed_ns, uint64_t budget_ns);
+
+    DeadlineHealth health(DeadlineStage stage) const;
+    // Zeroes every stage; safe while blocks run
+    void reset();
+
+private:
+    struct alignas(64) Counters {
+        std::atomic<uint64_t> calls{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> near_misses{0};
+        std::atomic<uint64_t> consecutive{0};
+        std::atomic<uint64_t> max_consecutive{0};
+        std::atomic<uint64_t> last_ns{0};
+        std::atomic<uint64_t> worst_ns{0};
+        std::atomic<uint64_t> budget_ns{0};
+        std::atomic<double> worst_load{0.0};
+    };
+
+    Counters stages_[kStages];
+    std::atomic<double> sample_rate_;
+    std::atomic<double> near_miss_;
+    std::atomic<bool> enabled_{true};
+    Callback callback_;
+    bool callback_near_miss_ = false;
+};
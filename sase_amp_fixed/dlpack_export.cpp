@@ -0,0 +1,54 @@
+#include "dlpack_export.h"
+
+namespace {
+
+// Tensor, its shape and the buffer's owner in one allocation, so the
+// deleter frees everything at once
+template <typename Managed>
+struct DLPackHolder {
+    Managed managed;
+    int64_t shape[2];
+    void* owner;
+    DLPackRelease release;
+};
+
+template <typename Managed>
+void deleteHolder(Managed* managed) {
+    auto* holder = static_cast<DLPackHolder<Managed>*>(managed->manager_ctx);
+    if (holder->release) holder->release(holder->owner);
+    delete holder;
+}
+
+template <typename Managed>
+DLPackHolder<Managed>* newHolder(const DLPackBuffer& buffer, void* owner, DLPackRelease release) {
+    auto* holder = new DLPackHolder<Managed>();
+    holder->shape[0] = buffer.shape[0];
+    holder->shape[1] = buffer.shape[1];
+    holder->owner = owner;
+    holder->release = release;
+
+    DLTensor& tensor = holder->managed.dl_tensor;
+    tensor.data = buffer.data;
+    tensor.device = buffer.device;
+    tensor.ndim = buffer.ndim;
+    tensor.dtype = buffer.dtype;
+    tensor.shape = holder->shape;
+    tensor.strides = nullptr;
+    tensor.byte_offset = 0;
+    holder->managed.manager_ctx = holder;
+    holder->managed.deleter = &deleteHolder<Managed>;
+    return holder;
+}
+
+}  // namespace
+
+DLManagedTensor* newDLPackTensor(const DLPackBuffer& buffer, void* owner, DLPackRelease release) {
+    return &newHolder<DLManagedTensor>(buffer, owner, release)->managed;
+}
+
+DLManagedTensorVersioned* newDLPackTensorVersioned(const DLPackBuffer& buffer, void* owner, DLPackRelease release) {
+    DLManagedTensorVersioned& managed = newHolder<DLManagedTensorVersioned>(buffer, owner, release)->managed;
+    managed.version = DLPackVersion{DLPACK_MAJOR_VERSION, DLPACK_MINOR_VERSION};
+    managed.flags = buffer.read_only ? DLPACK_FLAG_BITMASK_READ_ONLY : 0;
+    return &managed;
+}
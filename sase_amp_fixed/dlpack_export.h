@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// DLPack ABI (https://github.com/dmlc/dlpack), so engine buffers can be
+// wrapped as PyTorch or JAX tensors without a copy. The structs match the
+// 1.0 layout of dlpack.h, cut down to the devices and types the engine
+// exports; do not include both in one translation unit.
+extern "C" {
+
+#define DLPACK_MAJOR_VERSION 1
+#define DLPACK_MINOR_VERSION 0
+#define DLPACK_FLAG_BITMASK_READ_ONLY (1UL << 0UL)
+
+typedef struct {
+    uint32_t major;
+    uint32_t minor;
+} DLPackVersion;
+
+typedef enum {
+    kDLCPU = 1,
+    kDLCUDA = 2,
+    kDLCUDAHost = 3
+} DLDeviceType;
+
+typedef struct {
+    DLDeviceType device_type;
+    int32_t device_id;
+} DLDevice;
+
+typedef enum {
+    kDLInt = 0,
+    kDLUInt = 1,
+    kDLFloat = 2
+} DLDataTypeCode;
+
+typedef struct {
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+} DLDataType;
+
+typedef struct {
+    void* data;
+    DLDevice device;
+    int32_t ndim;
+    DLDataType dtype;
+    int64_t* shape;
+    int64_t* strides;  // In elements; null for compact row-major
+    uint64_t byte_offset;
+} DLTensor;
+
+typedef struct DLManagedTensor {
+    DLTensor dl_tensor;
+    void* manager_ctx;
+    void (*deleter)(struct DLManagedTensor* self);
+} DLManagedTensor;
+
+typedef struct DLManagedTensorVersioned {
+    DLPackVersion version;
+    void* manager_ctx;
+    void (*deleter)(struct DLManagedTensorVersioned* self);
+    uint64_t flags;
+    DLTensor dl_tensor;
+} DLManagedTensorVersioned;
+
+}  // extern "C"
+
+// One engine buffer to export: up to two dimensions, row-major
+struct DLPackBuffer {
+    void* data = nullptr;
+    DLDevice device{kDLCPU, 0};
+    DLDataType dtype{kDLFloat, 64, 1};
+    int32_t ndim = 1;
+    int64_t shape[2] = {0, 0};
+    bool read_only = false;
+
+    template <typename T>
+    static DLDataType dtypeOf() {
+        return DLDataType{kDLFloat, static_cast<uint8_t>(8 * sizeof(T)), 1};
+    }
+};
+
+// Called once when the consumer frees the tensor, with the owner passed at
+// export; the buffer must stay valid until then
+using DLPackRelease = void (*)(void* owner);
+
+// Managed tensors over buffer, legacy and 1.0 flavour. Each owns its shape
+// in the same allocation, and its deleter calls release(owner) and frees
+// it. The legacy one cannot carry read_only; callers decide whether to hand
+// a read-only buffer out that way.
+DLManagedTensor* newDLPackTensor(const DLPackBuffer& buffer, void* owner, DLPackRelease release);
+DLManagedTensorVersioned* newDLPackTensorVersioned(const DLPackBuffer& buffer, void* owner, DLPackRelease release);
@@ -0,0 +1,51 @@
+#include "embedded_engine.h"
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+static const NodeKernels& embeddedKernels() {
+#ifdef DASE_ARM_KERNELS
+    return neonNodeKernels();
+#else
+    return scalarNodeKernels();
+#endif
+}
+
+EmbeddedCellularEngine::EmbeddedCellularEngine() : kernels_(&embeddedKernels()) {
+    std::memset(storage_, 0, sizeof(storage_));
+    // The engine owns the columns; adoptStorage only needs a non-null owner
+    // so the bank never frees them
+    bank_.adoptStorage(kNodes, storage_, std::shared_ptr<void>(storage_, [](void*) {}));
+    for (size_t i = 0; i < kNodes; i++) {
+        bank_.x[i] = static_cast<int16_t>(i % 10);
+        bank_.y[i] = static_cast<int16_t>((i / 10) % 10);
+        bank_.z[i] = static_cast<int16_t>(i / 100);
+        bank_.node_id[i] = static_cast<uint16_t>(i);
+        weights_[i] = 1.0f / static_cast<float>(kNodes);
+    }
+}
+
+void EmbeddedCellularEngine::processBlock(const float* in, const float* control, float* out, size_t n) {
+    for (size_t done = 0; done < n; done += kChunk) {
+        const size_t m = std::min(kChunk, n - done);
+        const size_t padded = NodeBankF32::paddedCount(m);
+        for (size_t k = 0; k < padded; k++) {
+            const size_t t = done + std::min(k, m - 1);
+            amplified_[k] = in[t] * (control ? control[t] : 1.0f);
+        }
+        kernels_->spectral_lanes(amplified_, boost_, padded);
+        kernels_->block_f32(bank_, 0, kCapacity, amplified_, boost_, in[done + m - 1], node_out_, m, 0, nullptr);
+
+        float* mean = out + done;
+        kernels_->mix_rows(node_out_, kNodes, static_cast<ptrdiff_t>(m), weights_, 1, &mean, m);
+    }
+}
+
+void EmbeddedCellularEngine::setNodeFeedback(size_t index, float feedback_coefficient) {
+    if (index >= kNodes) return;
+    bank_.feedback_gain[index] = std::min(std::max(feedback_coefficient, -2.0f), 2.0f);
+}
+
+extern "C" void embedded_engine_process(void* engine, const float* input, float* output, size_t frames) {
+    static_cast<EmbeddedCellularEngine*>(engine)->processBlock(input, nullptr, output, frames);
+}
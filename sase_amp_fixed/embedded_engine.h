@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include "node_bank.h"
+#include "node_kernels.h"
+
+// Node count of the embedded profile; a build option, as the bank lives
+// inside the engine object
+#ifndef DASE_EMBEDDED_NODES
+#define DASE_EMBEDDED_NODES 64
+#endif
+
+// Embedded profile of AnalogCellularEngineF32 for the hybrid node's DSP loop
+// (hybrid_set_engine in hardware/hybrid_node.h): the same node model and
+// block kernel on a fixed bank of kNodes nodes. The bank's columns and every
+// per-block buffer are members, so an engine placed in static storage never
+// allocates after construction; there is no worker pool and no FFTW. The
+// kernel table is fixed at build time, NEON on AArch64 (Advanced SIMD is part
+// of the baseline there) and scalar elsewhere, such as the hybrid node
+// simulator, so the profile links with just the kernel tables and none of
+// the engine's CPU detection. Not thread safe: one block at a time.
+class EmbeddedCellularEngine {
+public:
+    static constexpr size_t kNodes = DASE_EMBEDDED_NODES;
+    static constexpr size_t kChunk = 64;    // Samples per block_f32 call
+
+    EmbeddedCellularEngine();
+
+    EmbeddedCellularEngine(const EmbeddedCellularEngine&) = delete;
+    EmbeddedCellularEngine& operator=(const EmbeddedCellularEngine&) = delete;
+
+    // out[t] = mean node output for the amplified signal in[t] * control[t]
+    // (control null: 1), as AnalogCellularEngineF32::processBlock with no aux
+    // averaged over the nodes. Any n; out may be in.
+    void processBlock(const float* in, const float* control, float* out, size_t n);
+
+    // Feedback of one node, clamped to [-2, 2]; out of range indices are ignored
+    void setNodeFeedback(size_t index, float feedback_coefficient);
+    void resetState() { bank_.resetState(); }
+
+    size_t getNodeCount() const { return kNodes; }
+    float getNodeOutput(size_t index) const { return index < kNodes ? bank_.current_output[index] : 0.0f; }
+    SimdLevel getSimdLevel() const { return kernels_->level; }
+    const char* getKernelName() const { return kernels_->name; }
+
+private:
+    static constexpr size_t kCapacity = NodeBankF32::paddedCount(kNodes);
+
+    alignas(NodeBankF32::kAlignment) unsigned char storage_[NodeBankF32::storageBytesFor(kCapacity)];
+    NodeBankF32 bank_;
+    const NodeKernels* kernels_;
+    alignas(64) float amplified_[kChunk];
+    alignas(64) float boost_[kChunk];
+    alignas(64) float node_out_[kNodes * kChunk];  // Node-major block_f32 output
+    float weights_[kNodes];                        // 1 / kNodes, the mix_rows mean
+};
+
+extern "C" {
+// HybridEngineProcess of an EmbeddedCellularEngine (hybrid_set_engine):
+// output = processBlock(input) with unit control
+void embedded_engine_process(void* engine, const float* input, float* output, size_t frames);
+}
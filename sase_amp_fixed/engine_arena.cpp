@@ -0,0 +1,65 @@
+#include "engine_arena.h"
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+EngineArena::EngineArena(size_t bytes, bool huge_pages) {
+    if (bytes == 0) bytes = kAlignment;
+#if defined(__linux__)
+    const size_t page = huge_pages ? kHugePageSize : static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    reserved_ = (bytes + page - 1) / page * page;
+#ifdef MAP_HUGETLB
+    if (huge_pages) {
+        void* p = mmap(nullptr, reserved_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED) {
+            mapping_ = p;
+            mapped_ = reserved_;
+            base_ = static_cast<unsigned char*>(p);
+            huge_pages_ = true;
+            return;
+        }
+    }
+#endif
+    // Without reserved huge pages, over-map by one huge page so the region
+    // can start on a 2 MB boundary, which THP needs to back it
+    mapped_ = reserved_ + (huge_pages ? kHugePageSize : 0);
+    void* q = mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (q == MAP_FAILED) throw std::bad_alloc();
+    mapping_ = q;
+    base_ = static_cast<unsigned char*>(q);
+    if (huge_pages) {
+        const uintptr_t aligned = (reinterpret_cast<uintptr_t>(q) + kHugePageSize - 1) & ~(kHugePageSize - 1);
+        base_ = reinterpret_cast<unsigned char*>(aligned);
+#ifdef MADV_HUGEPAGE
+        transparent_huge_pages_ = madvise(base_, reserved_, MADV_HUGEPAGE) == 0;
+#endif
+    }
+#else
+    (void)huge_pages;
+    reserved_ = (bytes + kAlignment - 1) / kAlignment * kAlignment;
+    base_ = static_cast<unsigned char*>(::operator new(reserved_, std::align_val_t(kAlignment)));
+    std::memset(base_, 0, reserved_);
+#endif
+}
+
+EngineArena::~EngineArena() {
+#if defined(__linux__)
+    munmap(mapping_, mapped_);
+#else
+    ::operator delete(base_, std::align_val_t(kAlignment));
+#endif
+}
+
+void* EngineArena::allocate(size_t bytes, size_t alignment) {
+    const uintptr_t start = reinterpret_cast<uintptr_t>(base_) + used_;
+    const uintptr_t aligned = (start + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    const size_t offset = static_cast<size_t>(aligned - reinterpret_cast<uintptr_t>(base_));
+    if (offset > reserved_ || bytes > reserved_ - offset) return nullptr;
+    used_ = offset + bytes;
+    return base_ + offset;
+}
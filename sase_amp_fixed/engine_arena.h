@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <vector>
+
+// What an engine reserves in its arena (see AnalogCellularEngineAVX2::reserveArena)
+struct EngineArenaConfig {
+    size_t max_block = 4096;     // Samples per block the scratch and output block are sized for
+    size_t max_channels = 8;     // Chromatic channels per block the scratch is sized for
+    int fft_size = 0;            // Size whose FFT plan buffers to reserve (0: none)
+    bool output_block = true;    // Reserve a [num_nodes x max_block] float output block
+    bool huge_pages = false;     // Back the region with 2 MB pages
+};
+
+// Usage of an engine's arena; all zero without one
+struct ArenaStats {
+    size_t bytes_reserved = 0;
+    size_t bytes_used = 0;
+    bool huge_pages = false;              // Explicit huge pages (MAP_HUGETLB)
+    bool transparent_huge_pages = false;  // Fallback: 2 MB aligned and advised for THP
+    bool node_state = false;              // The node bank still lives in the arena
+    size_t scratch_spills = 0;            // Scratch resizes that outgrew the arena
+};
+
+// One aligned region reserved up front and handed out by a bump pointer.
+//
+// Nothing is ever freed inside the region; it goes back whole when the arena
+// is destroyed. With huge_pages the size is rounded up to 2 MB pages and
+// mapped with MAP_HUGETLB, falling back to a 2 MB aligned mapping advised for
+// transparent huge pages when the host has no huge pages reserved (Linux
+// only; elsewhere the region is ordinary aligned memory). Pages are zero
+// and are placed by first touch, so an arena reserved on a pinned thread
+// keeps its memory on that thread's NUMA node.
+class EngineArena {
+public:
+    static constexpr size_t kAlignment = 64;
+    static constexpr size_t kHugePageSize = size_t(2) << 20;
+
+    // Throws std::bad_alloc when the region cannot be reserved
+    EngineArena(size_t bytes, bool huge_pages);
+    ~EngineArena();
+
+    EngineArena(const EngineArena&) = delete;
+    EngineArena& operator=(const EngineArena&) = delete;
+
+    // bytes at the given power-of-two alignment, or nullptr when full
+    void* allocate(size_t bytes, size_t alignment = kAlignment);
+    template <typename T>
+    T* allocateArray(size_t count) {
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T) > kAlignment ? alignof(T) : kAlignment));
+    }
+    bool contains(const void* p) const {
+        const unsigned char* c = static_cast<const unsigned char*>(p);
+        return c >= base_ && c < base_ + reserved_;
+    }
+
+    size_t bytesReserved() const { return reserved_; }
+    size_t bytesUsed() const { return used_; }
+    bool hugePages() const { return huge_pages_; }
+    bool transparentHugePages() const { return transparent_huge_pages_; }
+
+    // Bytes an allocation sequence of these sizes takes at kAlignment
+    static size_t footprint(std::initializer_list<size_t> sizes) {
+        size_t total = 0;
+        for (size_t bytes : sizes) total += (bytes + kAlignment - 1) / kAlignment * kAlignment;
+        return total;
+    }
+
+private:
+    unsigned char* base_ = nullptr;
+    size_t reserved_ = 0;
+    size_t used_ = 0;
+    void* mapping_ = nullptr;    // Linux: the whole mapping, base_ being 2 MB aligned inside it
+    size_t mapped_ = 0;
+    bool huge_pages_ = false;
+    bool transparent_huge_pages_ = false;
+};
+
+// Engine scratch column: the part of std::vector the block paths use.
+//
+// Heap backed like a vector until bind() hands it arena memory; resizes up
+// to the bound capacity then stay in the arena, and larger ones move to the
+// heap (keeping the contents) and are counted as spills.
+template <typename T>
+class ScratchBuffer {
+public:
+    void resize(size_t n) {
+        if (heap_.empty() && n <= arena_capacity_) {
+            data_ = arena_;
+            size_ = n;
+            return;
+        }
+        if (heap_.empty() && arena_) {
+            heap_.assign(arena_, arena_ + size_);
+            spills_++;
+        }
+        heap_.resize(n);
+        data_ = heap_.data();
+        size_ = n;
+    }
+
+    // Moves the contents into capacity elements of arena memory (or back to
+    // the heap for nullptr)
+    void bind(T* arena, size_t capacity) {
+        const size_t keep = size_;
+        std::vector<T> contents(data_, data_ + size_);
+        arena_ = arena;
+        arena_capacity_ = arena ? capacity : 0;
+        heap_.clear();
+        heap_.shrink_to_fit();
+        size_ = 0;
+        data_ = nullptr;
+        resize(keep);
+        if (keep > 0) std::memcpy(data_, contents.data(), keep * sizeof(T));
+    }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    size_t size() const { return size_; }
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+    size_t spills() const { return spills_; }
+    // Held on the heap (arena memory is the arena's)
+    size_t heapBytes() const { return heap_.capacity() * sizeof(T); }
+
+private:
+    std::vector<T> heap_;
+    T* arena_ = nullptr;
+    size_t arena_capacity_ = 0;
+    T* data_ = nullptr;
+    size_t size_ = 0;
+    size_t spills_ = 0;
+};
@@ -0,0 +1,271 @@
+#include "engine_benchmark.h"
+#include <algorithm>
+#include <cmath>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+#include <tuple>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#include "worker_pool.h"
+
+namespace {
+
+// Nearest-rank percentile of sorted samples
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    const size_t rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+} // namespace
+
+const char* benchmarkHostOs() {
+#if defined(_WIN32)
+    return "windows";
+#elif defined(__APPLE__)
+    return "macos";
+#elif defined(__linux__)
+    return "linux";
+#else
+    return "unknown";
+#endif
+}
+
+std::string benchmarkDate() {
+    const std::time_t now = std::time(nullptr);
+    std::tm utc{};
+#ifdef _WIN32
+    gmtime_s(&utc, &now);
+#else
+    gmtime_r(&now, &utc);
+#endif
+    char text[16];
+    std::strftime(text, sizeof(text), "%Y-%m-%d", &utc);
+    return text;
+}
+
+std::string benchmarkJsonString(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out + "\"";
+}
+
+const char* benchmarkWorkloadName(BenchmarkWorkload workload) {
+    switch (workload) {
+        case BenchmarkWorkload::SignalSweep: return "signal_sweep";
+        case BenchmarkWorkload::Wave: return "wave";
+        case BenchmarkWorkload::Block: return "block";
+    }
+    return "unknown";
+}
+
+void BenchmarkResult::summarize(double node_updates_per_iteration) {
+    const size_t n = samples_ns.size();
+    if (n == 0) return;
+
+    std::vector<double> sorted = samples_ns;
+    std::sort(sorted.begin(), sorted.end());
+    total_ns = std::accumulate(sorted.begin(), sorted.end(), 0.0);
+    mean_ns = total_ns / static_cast<double>(n);
+    median_ns = n % 2 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+    p95_ns = percentile(sorted, 0.95);
+    p99_ns = percentile(sorted, 0.99);
+    min_ns = sorted.front();
+    max_ns = sorted.back();
+
+    double square_sum = 0.0;
+    for (double s : sorted) square_sum += (s - mean_ns) * (s - mean_ns);
+    stddev_ns = std::sqrt(square_sum / static_cast<double>(n));
+
+    if (total_ns > 0.0) {
+        iterations_per_second = static_cast<double>(n) * 1e9 / total_ns;
+        node_updates_per_second = iterations_per_second * node_updates_per_iteration;
+    }
+    if (config.workload == BenchmarkWorkload::Block && mean_ns > 0.0) {
+        realtime_factor = static_cast<double>(config.block_size) / config.sample_rate * 1e9 / mean_ns;
+    }
+}
+
+std::string BenchmarkResult::toLatencyJson(const std::string& git_commit) const {
+    const double ms = 1e-6;
+    std::ostringstream s;
+    s << std::setprecision(6) << std::fixed;
+    s << "{\n"
+      << "  \"version\": \"1.1.0\",\n"
+      << "  \"benchmark_date\": " << benchmarkJsonString(benchmarkDate()) << ",\n"
+      << "  \"git_commit\": " << benchmarkJsonString(git_commit) << ",\n"
+      << "  \"system_info\": {\n"
+      << "    \"os\": " << benchmarkJsonString(benchmarkHostOs()) << ",\n"
+      << "    \"simd_kernels\": " << benchmarkJsonString(kernel_name) << ",\n"
+      << "    \"threads\": " << threads << "\n"
+      << "  },\n"
+      << "  \"current_metrics\": {\n"
+      << "    \"dase_latency_ms\": " << mean_ns * ms << ",\n"
+      << "    \"dase_latency_p50_ms\": " << median_ns * ms << ",\n"
+      << "    \"dase_latency_p95_ms\": " << p95_ns * ms << ",\n"
+      << "    \"dase_latency_p99_ms\": " << p99_ns * ms << ",\n"
+      << "    \"dase_latency_max_ms\": " << max_ns * ms << ",\n"
+      << "    \"dase_node_updates_per_second\": " << node_updates_per_second << "\n"
+      << "  },\n"
+      << "  \"test_scenarios\": [\n"
+      << "    {\n"
+      << "      \"name\": " << benchmarkJsonString(std::string("dase_") + benchmarkWorkloadName(config.workload)) << ",\n"
+      << "      \"description\": " << benchmarkJsonString("D-ASE engine benchmark, " + std::to_string(num_nodes) + " nodes") << ",\n";
+    if (config.workload == BenchmarkWorkload::Block) {
+        s << "      \"sample_rate\": " << static_cast<uint64_t>(config.sample_rate) << ",\n"
+          << "      \"block_size\": " << config.block_size << ",\n"
+          << "      \"realtime_factor\": " << realtime_factor << ",\n";
+    }
+    s << "      \"iterations\": " << samples_ns.size() << ",\n"
+      << "      \"actual_latency_ms\": " << mean_ns * ms << ",\n"
+      << "      \"status\": \"measured\"\n"
+      << "    }\n"
+      << "  ]\n"
+      << "}\n";
+    return s.str();
+}
+
+const char* scalingPlacementName(ScalingPlacement placement) {
+    switch (placement) {
+        case ScalingPlacement::Unpinned: return "unpinned";
+        case ScalingPlacement::Cores: return "cores";
+        case ScalingPlacement::Siblings: return "siblings";
+        case ScalingPlacement::Spread: return "spread";
+    }
+    return "unknown";
+}
+
+std::vector<int> scalingCpuOrder(ScalingPlacement placement, const std::vector<int>& cpus) {
+    if (placement == ScalingPlacement::Unpinned) return cpus;
+
+    std::vector<CpuLocation> locations = WorkerPool::cpuTopology(cpus);
+    // Rank of each CPU's core among the distinct cores of its NUMA node
+    std::vector<int> core_rank(locations.size(), 0);
+    for (size_t i = 0; i < locations.size(); i++) {
+        std::vector<std::pair<int, int>> cores;
+        for (const CpuLocation& other : locations) {
+            if (other.numa_node == locations[i].numa_node && other.smt_index == 0) {
+                cores.emplace_back(other.package, other.core);
+            }
+        }
+        std::sort(cores.begin(), cores.end());
+        const auto own = std::make_pair(locations[i].package, locations[i].core);
+        core_rank[i] = static_cast<int>(std::lower_bound(cores.begin(), cores.end(), own) - cores.begin());
+    }
+
+    std::vector<size_t> order(locations.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    auto key = [&](size_t i) {
+        const CpuLocation& l = locations[i];
+        switch (placement) {
+            case ScalingPlacement::Cores: return std::make_tuple(l.smt_index, l.numa_node, core_rank[i], l.cpu);
+            case ScalingPlacement::Siblings: return std::make_tuple(l.numa_node, core_rank[i], l.smt_index, l.cpu);
+            default: return std::make_tuple(l.smt_index, core_rank[i], l.numa_node, l.cpu);
+        }
+    };
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) { return key(a) < key(b); });
+
+    std::vector<int> result;
+    result.reserve(order.size());
+    for (size_t i : order) result.push_back(locations[i].cpu);
+    return result;
+}
+
+const char* nodeLayoutName(NodeLayout layout) {
+    switch (layout) {
+        case NodeLayout::Objects: return "objects";
+        case NodeLayout::Bank: return "bank";
+        case NodeLayout::BankScalar: return "bank_scalar";
+        case NodeLayout::BankF32: return "bank_f32";
+        case NodeLayout::BankF16: return "bank_f16";
+        case NodeLayout::BankBF16: return "bank_bf16";
+        case NodeLayout::BankQ16: return "bank_q16";
+    }
+    return "unknown";
+}
+
+bool nodeLayoutStateFormat(NodeLayout layout, NodeStateFormat& format) {
+    switch (layout) {
+        case NodeLayout::BankF16: format = NodeStateFormat::Half; return true;
+        case NodeLayout::BankBF16: format = NodeStateFormat::BFloat16; return true;
+        case NodeLayout::BankQ16: format = NodeStateFormat::Fixed16; return true;
+        default: return false;
+    }
+}
+
+std::vector<size_t> nodeScalingCounts(const NodeScalingConfig& config) {
+    std::vector<size_t> counts;
+    const double step = std::pow(2.0, 1.0 / std::max(1, config.points_per_octave));
+    for (double n = static_cast<double>(config.min_nodes); n < static_cast<double>(config.max_nodes); n *= step) {
+        const size_t count = static_cast<size_t>(std::llround(n));
+        if (counts.empty() || count > counts.back()) counts.push_back(count);
+    }
+    if (counts.empty() || counts.back() < config.max_nodes) counts.push_back(config.max_nodes);
+    return counts;
+}
+
+const char* cacheLevelFor(const CpuCaches& caches, size_t working_set_bytes, unsigned threads) {
+    if (caches.llc == 0) return "";
+    const size_t per_thread = working_set_bytes / std::max(1u, threads);
+    if (caches.l1d != 0 && per_thread <= caches.l1d) return "L1";
+    if (caches.l2 != 0 && caches.l2 != caches.llc && per_thread <= caches.l2) return "L2";
+    if (working_set_bytes <= caches.llc) return "LLC";
+    return "DRAM";
+}
+
+std::vector<CacheCliff> findCacheCliffs(const std::vector<NodeScalingPoint>& points, double threshold) {
+    std::vector<CacheCliff> cliffs;
+    std::vector<const NodeScalingPoint*> sorted;
+    for (const NodeScalingPoint& point : points) sorted.push_back(&point);
+    std::stable_sort(sorted.begin(), sorted.end(), [](const NodeScalingPoint* a, const NodeScalingPoint* b) {
+        return std::make_tuple(a->layout, a->nodes) < std::make_tuple(b->layout, b->nodes);
+    });
+
+    const NodeScalingPoint* previous = nullptr;
+    double best = 0.0;
+    for (size_t i = 0; i < sorted.size(); i++) {
+        const NodeScalingPoint* point = sorted[i];
+        if (previous == nullptr || previous->layout != point->layout) {
+            previous = point;
+            best = point->ns_per_node_step;
+            continue;
+        }
+        // A slowdown only counts once the next larger count confirms it
+        const double limit = best * (1.0 + threshold);
+        const bool confirmed = i + 1 < sorted.size() && sorted[i + 1]->layout == point->layout &&
+                               sorted[i + 1]->ns_per_node_step > limit;
+        if (point->ns_per_node_step > limit && confirmed) {
+            CacheCliff cliff;
+            cliff.layout = point->layout;
+            cliff.last_fast_nodes = previous->nodes;
+            cliff.nodes = point->nodes;
+            cliff.slowdown = point->ns_per_node_step / best;
+            cliff.cache_level = previous->cache_level;
+            cliffs.push_back(cliff);
+            best = point->ns_per_node_step;
+        } else {
+            best = std::min(best, point->ns_per_node_step);
+        }
+        previous = point;
+    }
+    return cliffs;
+}
+
+size_t residentSetBytes() {
+#ifdef _WIN32
+    return 0;
+#else
+    // Second field of statm: resident pages
+    std::ifstream statm("/proc/self/statm");
+    size_t total_pages = 0, resident_pages = 0;
+    if (!(statm >> total_pages >> resident_pages)) return 0;
+    return resident_pages * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+#endif
+}
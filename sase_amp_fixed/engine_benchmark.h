@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include "compute_quality.h"
+#include "node_kernels.h"
+#include "worker_pool.h"
+
+// Unit of work one benchmark iteration times
+enum class BenchmarkWorkload {
+    SignalSweep = 0,  // performSignalSweepAVX2: 5 wave sweeps
+    Wave = 1,         // processSignalWaveAVX2: one wave sweep
+    Block = 2         // processBlock of block_size samples (one audio block)
+};
+
+// Benchmark driver settings. Zero or unset fields keep the engine's own
+// configuration for the run.
+struct BenchmarkConfig {
+    int iterations = 1000;
+    int warmup = 100;
+    size_t num_nodes = 0;     // Run on a scratch engine of this size instead
+    unsigned threads = 0;     // Run on a private pool of this many threads
+    std::optional<SimdLevel> simd_level;
+    BenchmarkWorkload workload = BenchmarkWorkload::SignalSweep;
+    size_t block_size = 512;  // Samples per Block iteration
+    double sample_rate = 48000.0;  // Block input tone and real-time budget
+};
+
+// Per-iteration latency distribution of one run, in nanoseconds
+struct BenchmarkResult {
+    BenchmarkConfig config;
+    std::string kernel_name;
+    size_t num_nodes = 0;
+    unsigned threads = 0;
+
+    double mean_ns = 0.0;
+    double median_ns = 0.0;
+    double p95_ns = 0.0;
+    double p99_ns = 0.0;
+    double max_ns = 0.0;
+    double min_ns = 0.0;
+    double stddev_ns = 0.0;
+    double total_ns = 0.0;
+
+    double iterations_per_second = 0.0;
+    double node_updates_per_second = 0.0;  // Node steps of all iterations / total time
+    // Block workload only: block duration at sample_rate over mean latency
+    double realtime_factor = 0.0;
+
+    std::vector<double> samples_ns;  // One entry per timed iteration, in run order
+
+    // Fills the statistics from samples_ns and node_updates_per_iteration
+    void summarize(double node_updates_per_iteration);
+
+    // Document in the layout of benchmarks/latency_v1.1.json: the measured
+    // dase_latency_ms (mean, in ms) and its percentiles under
+    // current_metrics, plus one test_scenarios entry for this run.
+    std::string toLatencyJson(const std::string& git_commit = "unknown") const;
+};
+
+const char* benchmarkWorkloadName(BenchmarkWorkload workload);
+
+// Shared fields of the latency documents: host OS, UTC date (YYYY-MM-DD)
+// and a quoted JSON string (escapes \" and \\ only)
+const char* benchmarkHostOs();
+std::string benchmarkDate();
+std::string benchmarkJsonString(const std::string& text);
+
+// Which CPUs a scaling sweep gives its first threads
+enum class ScalingPlacement {
+    Unpinned = 0,  // Leave placement to the OS scheduler
+    Cores = 1,     // One thread per physical core, node by node, then SMT siblings
+    Siblings = 2,  // Both SMT siblings of a core before the next core
+    Spread = 3     // Round robin over NUMA nodes, physical cores before siblings
+};
+
+// Thread-scaling sweep of the drag race workload. The sweep runs at 1, 2,
+// 4, ... threads and then at max_threads.
+struct ScalingConfig {
+    int runs = 3;                // Timed runs per thread count, after one warmup run
+    unsigned max_threads = 0;    // 0: every CPU the process may run on
+    int iterations = 10000;      // Node steps per node and run
+    ScalingPlacement placement = ScalingPlacement::Unpinned;
+};
+
+struct ScalingPoint {
+    unsigned threads = 0;
+    std::vector<int> cpus;       // CPU of worker k (empty when unpinned)
+    double mean_ns = 0.0;        // Per run
+    double best_ns = 0.0;
+    double speedup = 0.0;        // Best single-thread time / best time
+    double efficiency = 0.0;     // speedup / threads
+    double node_updates_per_second = 0.0;
+};
+
+const char* scalingPlacementName(ScalingPlacement placement);
+
+// CPUs in the order placement hands them to threads
+std::vector<int> scalingCpuOrder(ScalingPlacement placement, const std::vector<int>& cpus);
+
+// Node state layouts a node-count sweep can compare
+enum class NodeLayout {
+    Objects = 0,     // One AnalogUniversalNodeAVX2 per node, each owning its
+                     // own single-node bank (array of scattered structures)
+    Bank = 1,        // Engine NodeBank columns, lane-parallel kernels
+    BankScalar = 2,  // Same columns, one node per kernel call
+    BankF32 = 3,     // AnalogCellularEngineF32 float columns
+    BankF16 = 4,     // AnalogCellularEngineCompact, half float columns
+    BankBF16 = 5,    // Same, bfloat16 columns
+    BankQ16 = 6      // Same, 16-bit fixed point columns
+};
+
+// NodeStateFormat of a compact layout; false for the other layouts
+bool nodeLayoutStateFormat(NodeLayout layout, NodeStateFormat& format);
+
+const char* nodeLayoutName(NodeLayout layout);
+
+// Node-count sweep of the wave sweep workload (ten node steps per node).
+// Counts grow geometrically from min_nodes to max_nodes; every point repeats
+// the sweep until about target_ms of timed work (at least min_iterations).
+// Points whose allocation would pass max_bytes are skipped.
+struct NodeScalingConfig {
+    size_t min_nodes = 1024;
+    size_t max_nodes = 10000000;
+    int points_per_octave = 2;
+    int min_iterations = 3;
+    double target_ms = 50.0;
+    size_t max_bytes = size_t{4} << 30;
+    // Banks go first: memory the node objects free is reused by later points,
+    // which then show no resident set growth
+    std::vector<NodeLayout> layouts = {NodeLayout::Bank, NodeLayout::BankScalar, NodeLayout::BankF32,
+                                       NodeLayout::BankF16, NodeLayout::Objects};
+    // Slowdown over the best time since the last cliff that counts as a cliff
+    double cliff_threshold = 0.15;
+};
+
+struct NodeScalingPoint {
+    NodeLayout layout = NodeLayout::Bank;
+    size_t nodes = 0;
+    int iterations = 0;
+    double ns_per_node_step = 0.0;       // Median sweep
+    double best_ns_per_node_step = 0.0;
+    double allocated_bytes_per_node = 0.0;
+    // Resident set growth while the point was built and swept. Undercounts
+    // when the allocator reuses memory freed by earlier points.
+    double resident_bytes_per_node = 0.0;
+    size_t working_set_bytes = 0;        // State a sweep touches
+    const char* cache_level = "";        // "L1", "L2", "LLC" or "DRAM"
+};
+
+// Where a layout's time per node step jumps
+struct CacheCliff {
+    NodeLayout layout = NodeLayout::Bank;
+    size_t last_fast_nodes = 0;   // Largest count before the jump
+    size_t nodes = 0;             // First count past it
+    double slowdown = 0.0;        // Over the best time before the jump
+    const char* cache_level = "";  // Level the working set no longer fits
+};
+
+struct NodeScalingResult {
+    CpuCaches caches;
+    unsigned threads = 0;
+    std::vector<NodeScalingPoint> points;
+    std::vector<CacheCliff> cliffs;
+};
+
+// Node counts of a sweep in increasing order, max_nodes last
+std::vector<size_t> nodeScalingCounts(const NodeScalingConfig& config);
+
+// Smallest level that holds working_set_bytes: L1 and L2 against the
+// per-thread share, the LLC against the whole set. Empty when the cache
+// sizes are unknown.
+const char* cacheLevelFor(const CpuCaches& caches, size_t working_set_bytes, unsigned threads);
+
+// Per layout, in node order: a cliff is a point whose time, and that of the
+// next larger count, exceed the best time since the previous cliff by more
+// than threshold. The largest count of a layout can therefore not start one.
+std::vector<CacheCliff> findCacheCliffs(const std::vector<NodeScalingPoint>& points, double threshold);
+
+// Resident set size of this process (0 where it cannot be read)
+size_t residentSetBytes();
+
+// Numerical drift of compact node storage: the same audio blocks through
+// AnalogCellularEngineF32 and an AnalogCellularEngineCompact per format,
+// from zeroed state with a spread of feedback gains, comparing every
+// node's output at every sample.
+struct CompactDriftConfig {
+    size_t num_nodes = 4096;
+    size_t block_size = 512;
+    size_t blocks = 200;           // About 2 s at 48 kHz
+    double sample_rate = 48000.0;
+    double frequency = 220.0;      // Input tone, amplitude 0.5
+    double max_feedback = 0.5;     // Feedback gains spread over [-max, max] by node
+    float fixed_range = 16.0f;     // Full scale of Fixed16
+    std::vector<NodeStateFormat> formats = {NodeStateFormat::Half, NodeStateFormat::BFloat16,
+                                            NodeStateFormat::Fixed16};
+};
+
+struct CompactDriftResult {
+    NodeStateFormat format = NodeStateFormat::Half;
+    double bytes_per_node = 0.0;         // Allocated, against float_bytes_per_node for the float bank
+    double float_bytes_per_node = 0.0;
+    double max_abs_error = 0.0;          // Over every node and sample
+    double rms_error = 0.0;
+    double reference_rms = 0.0;          // RMS of the float engine's outputs
+    double relative_rms_error = 0.0;     // rms_error / reference_rms
+    double final_rms_error = 0.0;        // Over the last block only, to see drift grow
+    double ns_per_node_sample = 0.0;     // Mean processBlock time per node and sample
+    double float_ns_per_node_sample = 0.0;
+};
+
+struct QualitySweepConfig {
+    size_t num_nodes = 4096;
+    size_t waves = 200;            // processSignalWaveAVX2 calls, input sin(0.01 i)
+    size_t block_size = 512;
+    size_t blocks = 100;
+    double sample_rate = 48000.0;
+    double frequency = 220.0;      // Block input tone, amplitude 0.5
+    std::vector<ComputeQuality> levels = {ComputeQuality::Reduced, ComputeQuality::Low, ComputeQuality::Draft};
+};
+
+struct QualityLevelResult {
+    ComputeQuality quality = ComputeQuality::Full;
+    double wave_max_abs_error = 0.0;     // Wave sweep results against Full
+    double wave_rms_error = 0.0;
+    double wave_relative_rms_error = 0.0;
+    double block_max_abs_error = 0.0;    // processBlock outputs against Full, every node and sample
+    double block_rms_error = 0.0;
+    double block_relative_rms_error = 0.0;
+    double wave_ns = 0.0;                // Mean time of one wave sweep
+    double full_wave_ns = 0.0;
+    double block_ns_per_node_sample = 0.0;
+    double full_block_ns_per_node_sample = 0.0;
+};
@@ -0,0 +1,74 @@
+#include "engine_group.h"
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <unordered_set>
+
+EngineGroup::EngineGroup(const WorkerPoolConfig& config)
+    : pool_(std::make_shared<WorkerPool>(config)) {}
+
+void EngineGroup::add(AnalogCellularEngineAVX2& engine) {
+    engine.shareWorkerPool(pool_);
+}
+
+void EngineGroup::remove(AnalogCellularEngineAVX2& engine) {
+    if (contains(engine)) engine.configureWorkers(WorkerPoolConfig());
+}
+
+bool EngineGroup::contains(const AnalogCellularEngineAVX2& engine) const {
+    return engine.getWorkerPool() == pool_;
+}
+
+void EngineGroup::processBlocks(const StreamBlock* blocks, size_t count, uint64_t* cpu_ns) {
+    if (count == 0) return;
+
+    std::unordered_set<const AnalogCellularEngineAVX2*> seen;
+    for (size_t s = 0; s < count; s++) {
+        const AnalogCellularEngineAVX2* engine = blocks[s].engine;
+        if (!engine || !contains(*engine)) {
+            throw std::invalid_argument("stream engine is not a member of the group");
+        }
+        if (!seen.insert(engine).second) {
+            throw std::invalid_argument("engine appears in more than one stream of a pass");
+        }
+    }
+
+    auto run = [&](size_t s) {
+        const StreamBlock& b = blocks[s];
+        b.engine->processBlock(b.in, b.control, b.aux, b.out, b.n);
+    };
+
+    if (cpu_ns && !pool_->cpuAccounting()) pool_->setCpuAccounting(true);
+    if (count < pool_->size()) {
+        for (size_t s = 0; s < count; s++) {
+            if (!cpu_ns) {
+                run(s);
+                continue;
+            }
+            // The caller's own CPU less its waits, plus the workers' shares
+            const uint64_t before = WorkerPool::threadCpuNs() + pool_->jobCpuNs() - pool_->waitCpuNs();
+            run(s);
+            cpu_ns[s] = WorkerPool::threadCpuNs() + pool_->jobCpuNs() - pool_->waitCpuNs() - before;
+        }
+        return;
+    }
+
+    // Largest streams first, so the last ones claimed are the short tail
+    order_.resize(count);
+    std::iota(order_.begin(), order_.end(), size_t{0});
+    std::stable_sort(order_.begin(), order_.end(), [&](size_t a, size_t b) {
+        return blocks[a].n * blocks[a].engine->getNodeCount() > blocks[b].n * blocks[b].engine->getNodeCount();
+    });
+
+    pool_->parallelFor(count, 1, [&](size_t begin, size_t end, unsigned) {
+        for (size_t k = begin; k < end; k++) {
+            if (!cpu_ns) {
+                run(order_[k]);
+                continue;
+            }
+            const uint64_t before = WorkerPool::threadCpuNs();
+            run(order_[k]);
+            cpu_ns[order_[k]] = WorkerPool::threadCpuNs() - before;
+        }
+    });
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "analog_universal_node_engine_avx2.h"
+#include "worker_pool.h"
+
+// One engine's share of an EngineGroup pass; the fields follow
+// AnalogCellularEngineAVX2::processBlock (control, aux and out may be null).
+struct StreamBlock {
+    AnalogCellularEngineAVX2* engine = nullptr;
+    const float* in = nullptr;
+    const float* control = nullptr;
+    const float* aux = nullptr;
+    float* out = nullptr;
+    size_t n = 0;
+};
+
+// Independent engines (e.g. one per session) scheduled on a single pool.
+//
+// Members share the group's workers instead of each starting a pool of its
+// own, so many sessions on one host no longer oversubscribe the cores. A pass
+// hands whole streams to workers, largest first: every engine is advanced
+// start to finish by one worker and its state stays in that core's cache,
+// while its inner sweeps run inline. With fewer streams than workers the
+// streams run one after another, each spread over the whole pool instead.
+class EngineGroup {
+public:
+    explicit EngineGroup(const WorkerPoolConfig& config = WorkerPoolConfig());
+
+    // Moves engine onto the group's pool. The group keeps no reference, so
+    // engines may be destroyed freely; configureWorkers() detaches one.
+    void add(AnalogCellularEngineAVX2& engine);
+    // Gives a member back a private pool with the default configuration
+    void remove(AnalogCellularEngineAVX2& engine);
+    bool contains(const AnalogCellularEngineAVX2& engine) const;
+
+    unsigned getWorkerCount() const { return pool_->size(); }
+    const WorkerPoolConfig& getWorkerConfig() const { return pool_->config(); }
+
+    // Advances every block's engine by one block. Engines must be members and
+    // appear at most once. Throws std::invalid_argument otherwise. With
+    // cpu_ns, cpu_ns[s] receives the CPU time block s took on every thread
+    // it ran on: the one worker's when streams go to workers whole, the
+    // caller's plus the workers' shares of its jobs while it was spread over
+    // the pool (which turns on the pool's CPU accounting). Waits and idle
+    // workers are not counted.
+    void processBlocks(const StreamBlock* blocks, size_t count, uint64_t* cpu_ns = nullptr);
+
+private:
+    std::shared_ptr<WorkerPool> pool_;
+    std::vector<size_t> order_;  // Pass order, reused across calls
+};
@@ -0,0 +1,339 @@
+#include "fft_backend.h"
+#include "builtin_real_fft.h"
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(DASE_WITH_FFTW)
+#include <fftw3.h>
+#endif
+#if defined(DASE_WITH_ACCELERATE)
+#include <Accelerate/Accelerate.h>
+#endif
+#if defined(DASE_WITH_MKL)
+#include <mkl_dfti.h>
+#endif
+
+namespace {
+
+constexpr size_t kFFTAlignment = 64;
+
+// FFTW planner calls (plan creation/destruction, wisdom) must not overlap
+std::mutex g_fftw_planner_mutex;
+
+class BuiltinFFT final : public RealFFT {
+public:
+    BuiltinFFT(int size, size_t rows) : RealFFT(FFTBackend::Builtin, size, rows), fft_(static_cast<size_t>(size)) {}
+
+    void forward(double* real, FFTComplex* spectrum) override {
+        for (size_t r = 0; r < rows(); r++) {
+            fft_.forward(real + r * size(), spectrum[r * bins()]);
+        }
+    }
+
+    void inverse(FFTComplex* spectrum, double* real) override {
+        for (size_t r = 0; r < rows(); r++) {
+            fft_.inverse(spectrum[r * bins()], real + r * size());
+        }
+    }
+
+private:
+    BuiltinRealFFT fft_;
+};
+
+#if defined(DASE_WITH_FFTW)
+// Sets the thread count of the next plans; the planner mutex must be held.
+// fftw_init_threads runs once, before the first multithreaded plan, and the
+// count goes back to 1 after planning so other planner users (wisdom, the
+// DSP core) keep single-threaded plans.
+void planWithThreads(int threads) {
+#if defined(DASE_WITH_FFTW_THREADS)
+    static bool initialized = false;
+    if (threads > 1 && !initialized) {
+        initialized = fftw_init_threads() != 0;
+    }
+    if (initialized) fftw_plan_with_nthreads(threads);
+#else
+    (void)threads;
+#endif
+}
+
+// Executes with the new-array interface on the caller's buffers, which
+// share the planning buffers' 64-byte alignment
+class FFTWFFT final : public RealFFT {
+public:
+    FFTWFFT(int size, size_t rows, double* real, FFTComplex* spectrum, const RealFFTOptions& options)
+        : RealFFT(FFTBackend::FFTW, size, rows) {
+        const int count = static_cast<int>(rows);
+        const int bin_count = static_cast<int>(bins());
+        fftw_complex* bins_buffer = reinterpret_cast<fftw_complex*>(spectrum);
+        const unsigned flags = options.measure ? FFTW_MEASURE : FFTW_ESTIMATE;
+        std::lock_guard<std::mutex> lock(g_fftw_planner_mutex);
+        planWithThreads(options.threads);
+        forward_ = fftw_plan_many_dft_r2c(1, &size, count, real, nullptr, 1, size, bins_buffer, nullptr, 1,
+                                          bin_count, flags);
+        inverse_ = fftw_plan_many_dft_c2r(1, &size, count, bins_buffer, nullptr, 1, bin_count, real, nullptr, 1,
+                                          size, flags);
+        planWithThreads(1);
+        if (!forward_ || !inverse_) {
+            destroyPlans();
+            throw std::runtime_error("FFTW failed to create a plan");
+        }
+    }
+
+    ~FFTWFFT() override {
+        std::lock_guard<std::mutex> lock(g_fftw_planner_mutex);
+        destroyPlans();
+    }
+
+    void forward(double* real, FFTComplex* spectrum) override {
+        fftw_execute_dft_r2c(forward_, real, reinterpret_cast<fftw_complex*>(spectrum));
+    }
+
+    void inverse(FFTComplex* spectrum, double* real) override {
+        fftw_execute_dft_c2r(inverse_, reinterpret_cast<fftw_complex*>(spectrum), real);
+    }
+
+private:
+    void destroyPlans() {
+        if (forward_) fftw_destroy_plan(forward_);
+        if (inverse_) fftw_destroy_plan(inverse_);
+        forward_ = inverse_ = nullptr;
+    }
+
+    fftw_plan forward_ = nullptr;
+    fftw_plan inverse_ = nullptr;
+};
+#endif
+
+#if defined(DASE_WITH_ACCELERATE)
+// vDSP's real DFT works on split even / odd samples and packs the Nyquist
+// bin into the imaginary part of bin 0; its forward output is twice the
+// DFT, its inverse of a true spectrum is the unnormalized c2r.
+class AccelerateFFT final : public RealFFT {
+public:
+    static std::unique_ptr<RealFFT> create(int size, size_t rows) {
+        if (size % 2 != 0) return nullptr;
+        vDSP_DFT_SetupD forward = vDSP_DFT_zrop_CreateSetupD(nullptr, static_cast<vDSP_Length>(size), vDSP_DFT_FORWARD);
+        if (!forward) return nullptr;
+        vDSP_DFT_SetupD inverse = vDSP_DFT_zrop_CreateSetupD(forward, static_cast<vDSP_Length>(size), vDSP_DFT_INVERSE);
+        if (!inverse) {
+            vDSP_DFT_DestroySetupD(forward);
+            return nullptr;
+        }
+        return std::unique_ptr<RealFFT>(new AccelerateFFT(size, rows, forward, inverse));
+    }
+
+    ~AccelerateFFT() override {
+        vDSP_DFT_DestroySetupD(inverse_);
+        vDSP_DFT_DestroySetupD(forward_);
+    }
+
+    void forward(double* real, FFTComplex* spectrum) override {
+        const size_t half = static_cast<size_t>(size()) / 2;
+        double* buffer = scratch(half);
+        double *even = buffer, *odd = buffer + half, *re = buffer + 2 * half, *im = buffer + 3 * half;
+        for (size_t r = 0; r < rows(); r++) {
+            const double* x = real + r * size();
+            for (size_t t = 0; t < half; t++) {
+                even[t] = x[2 * t];
+                odd[t] = x[2 * t + 1];
+            }
+            vDSP_DFT_ExecuteD(forward_, even, odd, re, im);
+            FFTComplex* bin = spectrum + r * bins();
+            bin[0][0] = 0.5 * re[0];
+            bin[0][1] = 0.0;
+            bin[half][0] = 0.5 * im[0];
+            bin[half][1] = 0.0;
+            for (size_t k = 1; k < half; k++) {
+                bin[k][0] = 0.5 * re[k];
+                bin[k][1] = 0.5 * im[k];
+            }
+        }
+    }
+
+    void inverse(FFTComplex* spectrum, double* real) override {
+        const size_t half = static_cast<size_t>(size()) / 2;
+        double* buffer = scratch(half);
+        double *re = buffer, *im = buffer + half, *even = buffer + 2 * half, *odd = buffer + 3 * half;
+        for (size_t r = 0; r < rows(); r++) {
+            const FFTComplex* bin = spectrum + r * bins();
+            re[0] = bin[0][0];
+            im[0] = bin[half][0];
+            for (size_t k = 1; k < half; k++) {
+                re[k] = bin[k][0];
+                im[k] = bin[k][1];
+            }
+            vDSP_DFT_ExecuteD(inverse_, re, im, even, odd);
+            double* x = real + r * size();
+            for (size_t t = 0; t < half; t++) {
+                x[2 * t] = even[t];
+                x[2 * t + 1] = odd[t];
+            }
+        }
+    }
+
+private:
+    AccelerateFFT(int size, size_t rows, vDSP_DFT_SetupD forward, vDSP_DFT_SetupD inverse)
+        : RealFFT(FFTBackend::Accelerate, size, rows), forward_(forward), inverse_(inverse) {}
+
+    // Per-thread split buffers: 4 half-size rows
+    static double* scratch(size_t half) {
+        thread_local std::vector<double> buffer;
+        if (buffer.size() < 4 * half) buffer.resize(4 * half);
+        return buffer.data();
+    }
+
+    vDSP_DFT_SetupD forward_;
+    vDSP_DFT_SetupD inverse_;
+};
+#endif
+
+#if defined(DASE_WITH_MKL)
+// One committed descriptor per direction, each with its own distances;
+// DFTI scales neither direction by default
+class MKLFFT final : public RealFFT {
+public:
+    MKLFFT(int size, size_t rows, const RealFFTOptions& options) : RealFFT(FFTBackend::MKL, size, rows) {
+        forward_ = describe(static_cast<MKL_LONG>(size), static_cast<MKL_LONG>(bins()), options.threads);
+        inverse_ = describe(static_cast<MKL_LONG>(bins()), static_cast<MKL_LONG>(size), options.threads);
+        if (!forward_ || !inverse_) {
+            release();
+            throw std::runtime_error("MKL failed to create a DFT descriptor");
+        }
+    }
+
+    ~MKLFFT() override { release(); }
+
+    void forward(double* real, FFTComplex* spectrum) override {
+        DftiComputeForward(forward_, real, spectrum[0]);
+    }
+
+    void inverse(FFTComplex* spectrum, double* real) override {
+        DftiComputeBackward(inverse_, spectrum[0], real);
+    }
+
+private:
+    DFTI_DESCRIPTOR_HANDLE describe(MKL_LONG input_distance, MKL_LONG output_distance, int threads) {
+        DFTI_DESCRIPTOR_HANDLE handle = nullptr;
+        if (DftiCreateDescriptor(&handle, DFTI_DOUBLE, DFTI_REAL, 1, static_cast<MKL_LONG>(size())) != DFTI_NO_ERROR) {
+            return nullptr;
+        }
+        MKL_LONG status = DftiSetValue(handle, DFTI_PLACEMENT, DFTI_NOT_INPLACE);
+        if (status == DFTI_NO_ERROR) status = DftiSetValue(handle, DFTI_CONJUGATE_EVEN_STORAGE, DFTI_COMPLEX_COMPLEX);
+        if (status == DFTI_NO_ERROR && rows() > 1) {
+            status = DftiSetValue(handle, DFTI_NUMBER_OF_TRANSFORMS, static_cast<MKL_LONG>(rows()));
+            if (status == DFTI_NO_ERROR) status = DftiSetValue(handle, DFTI_INPUT_DISTANCE, input_distance);
+            if (status == DFTI_NO_ERROR) status = DftiSetValue(handle, DFTI_OUTPUT_DISTANCE, output_distance);
+        }
+        if (status == DFTI_NO_ERROR) status = DftiSetValue(handle, DFTI_THREAD_LIMIT, static_cast<MKL_LONG>(threads));
+        if (status == DFTI_NO_ERROR) status = DftiCommitDescriptor(handle);
+        if (status != DFTI_NO_ERROR) {
+            DftiFreeDescriptor(&handle);
+            return nullptr;
+        }
+        return handle;
+    }
+
+    void release() {
+        if (forward_) DftiFreeDescriptor(&forward_);
+        if (inverse_) DftiFreeDescriptor(&inverse_);
+    }
+
+    DFTI_DESCRIPTOR_HANDLE forward_ = nullptr;
+    DFTI_DESCRIPTOR_HANDLE inverse_ = nullptr;
+};
+#endif
+
+} // namespace
+
+std::mutex& fftwPlannerMutex() {
+    return g_fftw_planner_mutex;
+}
+
+bool fftBackendAvailable(FFTBackend backend) {
+    switch (backend) {
+        case FFTBackend::Builtin:
+            return true;
+        case FFTBackend::FFTW:
+#if defined(DASE_WITH_FFTW)
+            return true;
+#else
+            return false;
+#endif
+        case FFTBackend::Accelerate:
+#if defined(DASE_WITH_ACCELERATE)
+            return true;
+#else
+            return false;
+#endif
+        case FFTBackend::MKL:
+#if defined(DASE_WITH_MKL)
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+const char* fftBackendName(FFTBackend backend) {
+    switch (backend) {
+        case FFTBackend::FFTW: return "fftw";
+        case FFTBackend::Builtin: return "builtin";
+        case FFTBackend::Accelerate: return "accelerate";
+        case FFTBackend::MKL: return "mkl";
+    }
+    return "unknown";
+}
+
+FFTBackend defaultFFTBackend() {
+    for (FFTBackend backend : {FFTBackend::FFTW, FFTBackend::Accelerate, FFTBackend::MKL}) {
+        if (fftBackendAvailable(backend)) return backend;
+    }
+    return FFTBackend::Builtin;
+}
+
+double* fftAllocReal(size_t count) {
+    return static_cast<double*>(::operator new(count * sizeof(double), std::align_val_t(kFFTAlignment), std::nothrow));
+}
+
+FFTComplex* fftAllocComplex(size_t count) {
+    return static_cast<FFTComplex*>(
+        ::operator new(count * sizeof(FFTComplex), std::align_val_t(kFFTAlignment), std::nothrow));
+}
+
+void fftFree(void* buffer) {
+    if (buffer) ::operator delete(buffer, std::align_val_t(kFFTAlignment));
+}
+
+std::unique_ptr<RealFFT> createRealFFT(FFTBackend backend, int size, size_t rows, double* real,
+                                       FFTComplex* spectrum, const RealFFTOptions& options) {
+    if (size <= 0) throw std::invalid_argument("FFT size must be positive");
+    if (rows == 0) throw std::invalid_argument("FFT needs at least one row");
+    if (!fftBackendAvailable(backend)) {
+        throw std::invalid_argument(std::string("FFT backend not built in: ") + fftBackendName(backend));
+    }
+    (void)real;
+    (void)spectrum;
+    (void)options;
+    switch (backend) {
+#if defined(DASE_WITH_FFTW)
+        case FFTBackend::FFTW:
+            return std::unique_ptr<RealFFT>(new FFTWFFT(size, rows, real, spectrum, options));
+#endif
+#if defined(DASE_WITH_ACCELERATE)
+        case FFTBackend::Accelerate:
+            if (auto fft = AccelerateFFT::create(size, rows)) return fft;
+            break;
+#endif
+#if defined(DASE_WITH_MKL)
+        case FFTBackend::MKL:
+            return std::unique_ptr<RealFFT>(new MKLFFT(size, rows, options));
+#endif
+        default:
+            break;
+    }
+    return std::unique_ptr<RealFFT>(new BuiltinFFT(size, rows));
+}
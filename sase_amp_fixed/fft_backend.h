@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+
+// FFT implementations behind the engine's real transforms. FFTW, Accelerate
+// and MKL are compiled in by DASE_WITH_FFTW, DASE_WITH_ACCELERATE and
+// DASE_WITH_MKL (setup.py and the Makefile turn FFTW on unless DASE_FFTW=0);
+// the builtin transform (builtin_real_fft.h) is always there, so a build
+// without any FFT library still runs every spectral path.
+enum class FFTBackend {
+    FFTW = 0,        // libfftw3
+    Builtin = 1,     // Header-only radix-2 / Bluestein, no dependency
+    Accelerate = 2,  // Apple vDSP DFT
+    MKL = 3          // Intel oneMKL DFTI
+};
+
+// One bin: re, im. The same layout (and, with fftw3.h, the same type) as
+// fftw_complex.
+typedef double FFTComplex[2];
+
+bool fftBackendAvailable(FFTBackend backend);
+// "fftw", "builtin", "accelerate" or "mkl"
+const char* fftBackendName(FFTBackend backend);
+// FFTW when built in (the reference the tests compare against), else
+// Accelerate, MKL, then the builtin transform
+FFTBackend defaultFFTBackend();
+
+// Lock around every FFTW planner call (plan creation and destruction,
+// wisdom); createRealFFT and RealFFT's destructor take it themselves
+std::mutex& fftwPlannerMutex();
+
+// 64-byte aligned buffers for transforms of any backend; fftFree releases
+// them and ignores null
+double* fftAllocReal(size_t count);
+FFTComplex* fftAllocComplex(size_t count);
+void fftFree(void* buffer);
+
+struct RealFFTOptions {
+    bool measure = false;  // FFTW_MEASURE planning instead of FFTW_ESTIMATE (FFTW only)
+    int threads = 1;       // Threads per transform (FFTW with DASE_WITH_FFTW_THREADS, MKL)
+};
+
+// Real-to-complex transform pair over rows() contiguous signals of size()
+// samples, signal r at real + r * size() and its bins() bins at
+// spectrum + r * bins(). Both directions are unnormalized, like FFTW's r2c
+// and c2r: inverse(forward(x)) = size() x. The bins' imaginary parts at DC
+// (and at size() / 2 for even sizes) are 0 forward and ignored inverse.
+//
+// forward() leaves real as it is; inverse() may overwrite spectrum.
+// Buffers must come from fftAllocReal / fftAllocComplex (or be 64-byte
+// aligned). One transform may run on distinct buffers from several
+// threads at once.
+class RealFFT {
+public:
+    virtual ~RealFFT() = default;
+
+    RealFFT(const RealFFT&) = delete;
+    RealFFT& operator=(const RealFFT&) = delete;
+
+    FFTBackend backend() const { return backend_; }
+    int size() const { return size_; }
+    size_t rows() const { return rows_; }
+    size_t bins() const { return static_cast<size_t>(size_ / 2 + 1); }
+
+    virtual void forward(double* real, FFTComplex* spectrum) = 0;
+    virtual void inverse(FFTComplex* spectrum, double* real) = 0;
+
+protected:
+    RealFFT(FFTBackend backend, int size, size_t rows) : backend_(backend), size_(size), rows_(rows) {}
+
+private:
+    FFTBackend backend_;
+    int size_;
+    size_t rows_;
+};
+
+// Plans a transform of rows signals of size samples on backend. FFTW plans
+// on real and spectrum (buffers of that shape, overwritten when measuring);
+// the other backends ignore them. Accelerate takes sizes f 2^n (f = 1, 3,
+// 5, 15; n >= 4) and hands other sizes to the builtin transform, whose
+// backend() then says so. Throws std::invalid_argument for a non-positive
+// size, zero rows or a backend this build lacks, and std::runtime_error
+// when the library cannot plan the transform.
+std::unique_ptr<RealFFT> createRealFFT(FFTBackend backend, int size, size_t rows, double* real,
+                                       FFTComplex* spectrum, const RealFFTOptions& options = RealFFTOptions());
@@ -0,0 +1,191 @@
+#include "fft_plan_cache.h"
+#include "engine_arena.h"
+#include <mutex>
+#include <stdexcept>
+#if defined(DASE_WITH_FFTW)
+#include <fftw3.h>
+#endif
+
+FFTPlanCache::~FFTPlanCache() {
+    clear();
+}
+
+FFTPlanCache::Plan& FFTPlanCache::acquire(int size) {
+    if (size <= 0) {
+        throw std::invalid_argument("FFT size must be positive");
+    }
+
+    const int threads = threadsFor(size);
+    auto it = plans_.find(size);
+    if (it != plans_.end()) {
+        if (it->second.threads == threads) {
+            it->second.last_used = ++use_clock_;
+            return it->second;
+        }
+        destroy(it->second);
+        plans_.erase(it);
+    }
+
+    if (plans_.size() >= kMaxCachedSizes) {
+        auto oldest = plans_.begin();
+        for (auto entry = plans_.begin(); entry != plans_.end(); ++entry) {
+            if (entry->second.last_used < oldest->second.last_used) oldest = entry;
+        }
+        destroy(oldest->second);
+        plans_.erase(oldest);
+    }
+
+    Plan plan;
+    plan.size = size;
+    if (arena_) {
+        plan.real = arena_->allocateArray<double>(static_cast<size_t>(size));
+        if (plan.real) plan.spectrum = arena_->allocateArray<FFTComplex>(static_cast<size_t>(size / 2 + 1));
+    }
+    if (!plan.real) plan.real = fftAllocReal(static_cast<size_t>(size));
+    if (!plan.spectrum) plan.spectrum = fftAllocComplex(static_cast<size_t>(size / 2 + 1));
+    if (!plan.real || !plan.spectrum) {
+        destroy(plan);
+        throw std::bad_alloc();
+    }
+
+    // FFTW_MEASURE scribbles over the buffers while timing, which is fine here
+    // because they hold no data yet.
+    RealFFTOptions options;
+    options.measure = rigor_ == FFTPlanRigor::Measure;
+    options.threads = threads;
+    try {
+        plan.transform = createRealFFT(backend_, size, 1, plan.real, plan.spectrum, options);
+    } catch (...) {
+        destroy(plan);
+        throw;
+    }
+
+    plan.threads = threads;
+    plan.last_used = ++use_clock_;
+    return plans_.emplace(size, std::move(plan)).first->second;
+}
+
+FFTPlanCache::BatchPlan& FFTPlanCache::acquireBatch(int size, size_t workers) {
+    if (size <= 0) {
+        throw std::invalid_argument("FFT size must be positive");
+    }
+    const size_t samples = kBatchRows * static_cast<size_t>(size);
+    const size_t bins = kBatchRows * static_cast<size_t>(size / 2 + 1);
+
+    auto it = batch_plans_.find(size);
+    if (it == batch_plans_.end()) {
+        if (batch_plans_.size() >= kMaxCachedSizes) {
+            auto oldest = batch_plans_.begin();
+            for (auto entry = batch_plans_.begin(); entry != batch_plans_.end(); ++entry) {
+                if (entry->second.last_used < oldest->second.last_used) oldest = entry;
+            }
+            destroy(oldest->second);
+            batch_plans_.erase(oldest);
+        }
+
+        BatchPlan plan;
+        plan.size = size;
+        plan.real.push_back(fftAllocReal(samples));
+        plan.spectrum.push_back(fftAllocComplex(bins));
+        if (!plan.real[0] || !plan.spectrum[0]) {
+            destroy(plan);
+            throw std::bad_alloc();
+        }
+        RealFFTOptions options;
+        options.measure = rigor_ == FFTPlanRigor::Measure;
+        try {
+            plan.transform = createRealFFT(backend_, size, kBatchRows, plan.real[0], plan.spectrum[0], options);
+        } catch (...) {
+            destroy(plan);
+            throw;
+        }
+        it = batch_plans_.emplace(size, std::move(plan)).first;
+    }
+
+    BatchPlan& plan = it->second;
+    plan.last_used = ++use_clock_;
+    while (plan.real.size() < workers) {
+        double* real = fftAllocReal(samples);
+        FFTComplex* spectrum = fftAllocComplex(bins);
+        if (!real || !spectrum) {
+            fftFree(real);
+            fftFree(spectrum);
+            throw std::bad_alloc();
+        }
+        plan.real.push_back(real);
+        plan.spectrum.push_back(spectrum);
+    }
+    return plan;
+}
+
+void FFTPlanCache::setBackend(FFTBackend backend) {
+    if (!fftBackendAvailable(backend)) {
+        throw std::invalid_argument(std::string("FFT backend not built in: ") + fftBackendName(backend));
+    }
+    backend_ = backend;
+}
+
+void FFTPlanCache::setThreads(unsigned threads, size_t min_size) {
+    threads_ = threads == 0 ? 1 : threads;
+    threaded_size_ = min_size;
+}
+
+int FFTPlanCache::threadsFor(int size) const {
+    if (threads_ <= 1 || static_cast<size_t>(size) < threaded_size_) return 1;
+    if (backend_ == FFTBackend::FFTW && !threadsAvailable()) return 1;
+    if (backend_ != FFTBackend::FFTW && backend_ != FFTBackend::MKL) return 1;
+    return static_cast<int>(threads_);
+}
+
+bool FFTPlanCache::threadsAvailable() {
+#if defined(DASE_WITH_FFTW) && defined(DASE_WITH_FFTW_THREADS)
+    return true;
+#else
+    return false;
+#endif
+}
+
+void FFTPlanCache::clear() {
+    for (auto& entry : plans_) {
+        destroy(entry.second);
+    }
+    plans_.clear();
+    for (auto& entry : batch_plans_) {
+        destroy(entry.second);
+    }
+    batch_plans_.clear();
+}
+
+void FFTPlanCache::destroy(Plan& plan) {
+    plan.transform.reset();
+    if (plan.real && !(arena_ && arena_->contains(plan.real))) fftFree(plan.real);
+    if (plan.spectrum && !(arena_ && arena_->contains(plan.spectrum))) fftFree(plan.spectrum);
+    plan = Plan();
+}
+
+void FFTPlanCache::destroy(BatchPlan& plan) {
+    plan.transform.reset();
+    for (double* real : plan.real) fftFree(real);
+    for (FFTComplex* spectrum : plan.spectrum) fftFree(spectrum);
+    plan = BatchPlan();
+}
+
+bool FFTPlanCache::importWisdom(const std::string& path) {
+#if defined(DASE_WITH_FFTW)
+    std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+    return fftw_import_wisdom_from_filename(path.c_str()) != 0;
+#else
+    (void)path;
+    return false;
+#endif
+}
+
+bool FFTPlanCache::exportWisdom(const std::string& path) {
+#if defined(DASE_WITH_FFTW)
+    std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+    return fftw_export_wisdom_to_filename(path.c_str()) != 0;
+#else
+    (void)path;
+    return false;
+#endif
+}
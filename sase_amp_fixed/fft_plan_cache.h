@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "fft_backend.h"
+
+class EngineArena;
+
+// Planner effort for newly created plans
+enum class FFTPlanRigor {
+    Estimate = 0,  // Heuristic plans, near-zero planning time
+    Measure = 1    // Timed plans (FFTW_MEASURE); cheap when wisdom is loaded
+};
+
+// Per-size cache of real-to-complex FFT plans and their aligned buffers.
+//
+// Each block size gets one r2c/c2r transform on the cache's backend and the
+// buffers it was made for, created on first use and reused afterwards, so
+// steady-state block processing does no allocation or planning. FFTW's
+// planner is not thread safe; plan creation and destruction are serialized
+// through a process-wide lock. A single cache must not be executed from two
+// threads at once.
+class FFTPlanCache {
+public:
+    struct Plan {
+        int size = 0;
+        double* real = nullptr;            // size samples
+        FFTComplex* spectrum = nullptr;    // size / 2 + 1 bins
+        std::unique_ptr<RealFFT> transform;
+        int threads = 1;                   // Threads the transform was made for
+        uint64_t last_used = 0;
+
+        void forward() { transform->forward(real, spectrum); }   // real -> spectrum
+        void inverse() { transform->inverse(spectrum, real); }   // spectrum -> real (unnormalized)
+    };
+
+    static constexpr size_t kMaxCachedSizes = 16;
+    // Default setThreads() min_size: below about 2^18 samples a transform
+    // takes less time than waking FFTW's threads is worth
+    static constexpr size_t kDefaultThreadedSize = size_t(1) << 18;
+
+    // A transform of kBatchRows signals of one size per execution, for
+    // transforming many rows at once. Each worker of a pool has its own
+    // buffers, all with the alignment the transform was made for, so workers
+    // run the same transform on their own rows side by side.
+    struct BatchPlan {
+        int size = 0;
+        std::unique_ptr<RealFFT> transform;   // kBatchRows rows <-> spectra (unnormalized)
+        std::vector<double*> real;            // Per worker: [kBatchRows x size]
+        std::vector<FFTComplex*> spectrum;    // Per worker: [kBatchRows x (size / 2 + 1)]
+        uint64_t last_used = 0;
+    };
+
+    static constexpr size_t kBatchRows = 8;
+
+    FFTPlanCache() = default;
+    ~FFTPlanCache();
+
+    FFTPlanCache(const FFTPlanCache&) = delete;
+    FFTPlanCache& operator=(const FFTPlanCache&) = delete;
+
+    // Returns the plan pair for size samples, creating it if needed. The least
+    // recently used size is evicted once kMaxCachedSizes are cached; a cached
+    // pair made for another thread count than threadsFor(size) is replanned.
+    Plan& acquire(int size);
+    // Batch plans of size samples with buffers for at least `workers`
+    // workers; cached and evicted like acquire()'s. Batch buffers never come
+    // from the arena.
+    BatchPlan& acquireBatch(int size, size_t workers);
+
+    void setRigor(FFTPlanRigor rigor) { rigor_ = rigor; }
+    FFTPlanRigor getRigor() const { return rigor_; }
+    // Backend of new plans; clear() the cache to replan cached sizes. Throws
+    // std::invalid_argument for a backend this build lacks.
+    void setBackend(FFTBackend backend);
+    FFTBackend getBackend() const { return backend_; }
+    // Plans of min_size samples and more split each transform over threads
+    // threads; smaller ones, and batch plans (already spread over the
+    // workers), stay on the calling thread. Only FFTW built with its threads
+    // library (DASE_WITH_FFTW_THREADS) and MKL use more than one.
+    void setThreads(unsigned threads, size_t min_size = kDefaultThreadedSize);
+    unsigned getThreads() const { return threads_; }
+    size_t getThreadedSize() const { return threaded_size_; }
+    int threadsFor(int size) const;
+    static bool threadsAvailable();
+    // New plans take their buffers from arena while it has room (null:
+    // FFTW's allocator). Arena space is not reused after eviction. Clear the
+    // cache before switching arenas; the cache keeps its arena alive.
+    void setArena(std::shared_ptr<EngineArena> arena) { arena_ = std::move(arena); }
+    size_t cachedSizes() const { return plans_.size(); }
+    void clear();
+
+    // FFTW wisdom is process-wide; these return false on I/O or parse errors,
+    // and in builds without FFTW.
+    static bool importWisdom(const std::string& path);
+    static bool exportWisdom(const std::string& path);
+
+private:
+    void destroy(Plan& plan);
+    void destroy(BatchPlan& plan);
+
+    std::map<int, Plan> plans_;
+    std::map<int, BatchPlan> batch_plans_;
+    FFTPlanRigor rigor_ = FFTPlanRigor::Estimate;
+    FFTBackend backend_ = defaultFFTBackend();
+    unsigned threads_ = 1;
+    size_t threaded_size_ = kDefaultThreadedSize;
+    uint64_t use_clock_ = 0;
+    std::shared_ptr<EngineArena> arena_;
+};
@@ -0,0 +1,141 @@
+#include "filter_bank.h"
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+BiquadCoefficients designBiquad(FilterShape shape, double hz, double q, double sample_rate, double gain_db) {
+    if (!(sample_rate > 0.0) || !(hz > 0.0) || !(hz < 0.5 * sample_rate)) {
+        throw std::invalid_argument("filter frequency must be between 0 and half the sample rate");
+    }
+    if (!(q > 0.0)) {
+        throw std::invalid_argument("filter q must be positive");
+    }
+    const double w0 = 2.0 * M_PI * hz / sample_rate;
+    const double cs = std::cos(w0);
+    const double alpha = std::sin(w0) / (2.0 * q);
+    const double amp = std::pow(10.0, gain_db / 40.0);
+
+    double b0, b1, b2, a0, a1, a2;
+    a1 = -2.0 * cs;
+    a0 = 1.0 + alpha;
+    a2 = 1.0 - alpha;
+    switch (shape) {
+        case FilterShape::LowPass:
+            b0 = b2 = (1.0 - cs) / 2.0;
+            b1 = 1.0 - cs;
+            break;
+        case FilterShape::HighPass:
+            b0 = b2 = (1.0 + cs) / 2.0;
+            b1 = -(1.0 + cs);
+            break;
+        case FilterShape::BandPass:
+            b0 = alpha;
+            b1 = 0.0;
+            b2 = -alpha;
+            break;
+        case FilterShape::Resonator:
+            b0 = q * alpha;
+            b1 = 0.0;
+            b2 = -q * alpha;
+            break;
+        case FilterShape::Notch:
+            b0 = b2 = 1.0;
+            b1 = -2.0 * cs;
+            break;
+        case FilterShape::Peak:
+            b0 = 1.0 + alpha * amp;
+            b1 = -2.0 * cs;
+            b2 = 1.0 - alpha * amp;
+            a0 = 1.0 + alpha / amp;
+            a2 = 1.0 - alpha / amp;
+            break;
+        case FilterShape::AllPass:
+            b0 = 1.0 - alpha;
+            b1 = -2.0 * cs;
+            b2 = 1.0 + alpha;
+            break;
+        default:
+            throw std::invalid_argument("unknown filter shape");
+    }
+    BiquadCoefficients c;
+    c.b0 = b0 / a0;
+    c.b1 = b1 / a0;
+    c.b2 = b2 / a0;
+    c.a1 = a1 / a0;
+    c.a2 = a2 / a0;
+    return c;
+}
+
+void FilterNodeBank::resize(size_t num_nodes, size_t sections) {
+    if (sections == 0 || sections > kMaxSections) {
+        throw std::invalid_argument("filter nodes take 1 to 4 biquad sections");
+    }
+    storage_.reset();
+    size_ = num_nodes;
+    sections_ = sections;
+    capacity_ = (num_nodes + kLanePadding - 1) / kLanePadding * kLanePadding;
+    if (capacity_ == 0) return;
+    const size_t bytes = bytesAllocated();
+    storage_.reset(static_cast<float*>(::operator new(bytes, std::align_val_t(kAlignment))));
+    std::memset(storage_.get(), 0, bytes);
+    for (size_t s = 0; s < sections_; s++) {
+        float* b0 = column(s, 0);
+        for (size_t i = 0; i < capacity_; i++) b0[i] = 1.0f;
+    }
+}
+
+FilterNodeBank::Section FilterNodeBank::section(size_t s) const {
+    return {column(s, 0), column(s, 1), column(s, 2), column(s, 3), column(s, 4), column(s, 5), column(s, 6)};
+}
+
+void FilterNodeBank::checkIndex(size_t node, size_t section) const {
+    if (node >= size_) throw std::out_of_range("filter node index out of range");
+    if (section >= sections_) throw std::out_of_range("filter section index out of range");
+}
+
+void FilterNodeBank::setBiquad(size_t node, size_t s, const BiquadCoefficients& c) {
+    checkIndex(node, s);
+    const Section columns = section(s);
+    columns.b0[node] = static_cast<float>(c.b0);
+    columns.b1[node] = static_cast<float>(c.b1);
+    columns.b2[node] = static_cast<float>(c.b2);
+    columns.a1[node] = static_cast<float>(c.a1);
+    columns.a2[node] = static_cast<float>(c.a2);
+}
+
+BiquadCoefficients FilterNodeBank::biquad(size_t node, size_t s) const {
+    checkIndex(node, s);
+    const Section columns = section(s);
+    BiquadCoefficients c;
+    c.b0 = columns.b0[node];
+    c.b1 = columns.b1[node];
+    c.b2 = columns.b2[node];
+    c.a1 = columns.a1[node];
+    c.a2 = columns.a2[node];
+    return c;
+}
+
+void FilterNodeBank::setSection(size_t s, size_t first, const double* coefficients, size_t count) {
+    if (count == 0) return;
+    checkIndex(first, s);
+    if (count > size_ - first) throw std::out_of_range("filter node index out of range");
+    const Section columns = section(s);
+    for (size_t k = 0; k < count; k++) {
+        const double* row = coefficients + 5 * k;
+        columns.b0[first + k] = static_cast<float>(row[0]);
+        columns.b1[first + k] = static_cast<float>(row[1]);
+        columns.b2[first + k] = static_cast<float>(row[2]);
+        columns.a1[first + k] = static_cast<float>(row[3]);
+        columns.a2[first + k] = static_cast<float>(row[4]);
+    }
+}
+
+void FilterNodeBank::resetState() {
+    for (size_t s = 0; s < sections_; s++) {
+        std::memset(column(s, 5), 0, 2 * capacity_ * sizeof(float));
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+
+// Normalized biquad, a0 = 1: y = b0 x + b1 x[-1] + b2 x[-2] - a1 y[-1] - a2 y[-2]
+struct BiquadCoefficients {
+    double b0 = 1.0;
+    double b1 = 0.0;
+    double b2 = 0.0;
+    double a1 = 0.0;
+    double a2 = 0.0;
+};
+
+enum class FilterShape {
+    LowPass = 0,
+    HighPass = 1,
+    BandPass = 2,   // 0 dB at the centre
+    Resonator = 3,  // Band-pass with a peak gain of q, for ringing modes
+    Notch = 4,
+    Peak = 5,       // Bell of gain_db at the centre
+    AllPass = 6
+};
+
+// RBJ cookbook section of shape at hz with quality q. Throws
+// std::invalid_argument for hz outside (0, sample_rate / 2) or q <= 0.
+BiquadCoefficients designBiquad(FilterShape shape, double hz, double q, double sample_rate, double gain_db = 0.0);
+
+// Struct-of-arrays bank of filter nodes: every node is a cascade of the
+// same number of biquad sections (1 to kMaxSections), each with its own
+// coefficients and transposed direct form II state:
+//   y = b0 x + z1,  z1 = b1 x - a1 y + z2,  z2 = b2 x - a2 y
+// Each coefficient and state of a section is a float column of capacity()
+// entries, 64-byte aligned and padded like BasicNodeBank<float>, so the
+// filter kernel runs a vector of nodes per instruction and keeps a chunk's
+// coefficients and state in registers for a whole block. New nodes pass
+// their input through (b0 = 1) with zero state, and so do padding slots.
+class FilterNodeBank {
+public:
+    static constexpr size_t kAlignment = 64;
+    static constexpr size_t kLanePadding = kAlignment / sizeof(float);
+    static constexpr size_t kMaxSections = 4;
+
+    // Columns of one section
+    struct Section {
+        float* b0;
+        float* b1;
+        float* b2;
+        float* a1;
+        float* a2;
+        float* z1;
+        float* z2;
+    };
+
+    FilterNodeBank() = default;
+    FilterNodeBank(size_t num_nodes, size_t sections) { resize(num_nodes, sections); }
+
+    FilterNodeBank(FilterNodeBank&&) noexcept = default;
+    FilterNodeBank& operator=(FilterNodeBank&&) noexcept = default;
+
+    // Reallocates for num_nodes pass-through nodes of `sections` sections;
+    // 0 nodes frees the bank. Throws std::invalid_argument for sections
+    // outside [1, kMaxSections].
+    void resize(size_t num_nodes, size_t sections);
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    size_t sections() const { return sections_; }
+    size_t bytesAllocated() const { return capacity_ * sections_ * kColumns * sizeof(float); }
+
+    Section section(size_t s) const;
+
+    // Throw std::out_of_range for a node or section out of range
+    void setBiquad(size_t node, size_t section, const BiquadCoefficients& c);
+    BiquadCoefficients biquad(size_t node, size_t section) const;
+    // Section s of nodes [first, first + count) from count rows of
+    // (b0, b1, b2, a1, a2)
+    void setSection(size_t s, size_t first, const double* coefficients, size_t count);
+
+    // Zeroes the state of every node; coefficients stay
+    void resetState();
+
+private:
+    static constexpr size_t kColumns = 7;  // b0, b1, b2, a1, a2, z1, z2
+
+    struct AlignedDelete {
+        void operator()(float* p) const { ::operator delete(p, std::align_val_t(kAlignment)); }
+    };
+
+    void checkIndex(size_t node, size_t section) const;
+    float* column(size_t s, size_t c) const { return storage_.get() + (s * kColumns + c) * capacity_; }
+
+    std::unique_ptr<float[], AlignedDelete> storage_;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    size_t sections_ = 1;
+};
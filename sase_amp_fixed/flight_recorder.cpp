@@ -0,0 +1,267 @@
+#include "flight_recorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'A', 'S', 'E', 'F', 'L', 'T', '1'};
+constexpr size_t kHeaderBytes = 64;
+constexpr auto kDumperPoll = std::chrono::milliseconds(20);
+
+void put(std::vector<unsigned char>& out, const void* data, size_t size) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    out.insert(out.end(), p, p + size);
+}
+
+template <class T>
+void putValue(std::vector<unsigned char>& out, T value) {
+    put(out, &value, sizeof(value));
+}
+
+void putString(std::vector<unsigned char>& out, const std::string& s) {
+    putValue(out, static_cast<uint16_t>(std::min<size_t>(s.size(), UINT16_MAX)));
+    put(out, s.data(), std::min<size_t>(s.size(), UINT16_MAX));
+}
+
+[[noreturn]] void fail(const std::string& path, const std::string& what) {
+    throw std::runtime_error("flight recording " + path + ": " + what);
+}
+
+struct Reader {
+    const std::vector<unsigned char>& data;
+    const std::string& path;
+    size_t at = 0;
+
+    void get(void* out, size_t size) {
+        if (data.size() - at < size) fail(path, "truncated");
+        std::memcpy(out, data.data() + at, size);
+        at += size;
+    }
+    template <class T>
+    T value() {
+        T v;
+        get(&v, sizeof(v));
+        return v;
+    }
+    std::string string() {
+        const uint16_t length = value<uint16_t>();
+        std::string s(length, '\0');
+        get(&s[0], length);
+        return s;
+    }
+};
+
+} // namespace
+
+size_t flightCapacityFor(double seconds, double sample_rate, size_t block_size, size_t events_per_block) {
+    if (!(seconds > 0.0) || !(sample_rate > 0.0) || block_size == 0) {
+        throw std::invalid_argument("flight recorder capacity needs positive seconds, sample rate and block size");
+    }
+    const double blocks = std::ceil(seconds * sample_rate / static_cast<double>(block_size));
+    return static_cast<size_t>(blocks) * std::max<size_t>(events_per_block, 1);
+}
+
+uint32_t flightThreadId() {
+    static thread_local uint32_t id = [] {
+#if defined(__linux__)
+        return static_cast<uint32_t>(::syscall(SYS_gettid));
+#else
+        return static_cast<uint32_t>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+#endif
+    }();
+    return id;
+}
+
+uint64_t flightNowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+FlightRecorder::FlightRecorder(const FlightRecorderConfig& config) : config_(config) {
+    if (config.capacity == 0) throw std::invalid_argument("flight recorder needs a capacity");
+    size_t capacity = 1;
+    while (capacity < config.capacity) capacity <<= 1;
+    events_.resize(capacity);  // Touched here, not on the first blocks
+    mask_ = capacity - 1;
+    trigger_mask_ = static_cast<uint16_t>((config.trigger_on_deadline ? kFlightDeadlineMiss : 0) |
+                                          (config.trigger_on_xrun ? kFlightXrun : 0));
+    if (!config_.directory.empty()) dumper_ = std::thread(&FlightRecorder::runDumper, this);
+}
+
+FlightRecorder::~FlightRecorder() {
+    stop_.store(true, std::memory_order_relaxed);
+    if (dumper_.joinable()) dumper_.join();
+}
+
+uint32_t FlightRecorder::addSource(const std::string& name, const std::vector<std::string>& stages) {
+    if (stages.size() > kFlightStages) {
+        throw std::invalid_argument("flight source " + name + " has more than " + std::to_string(kFlightStages) +
+                                    " stages");
+    }
+    std::lock_guard<std::mutex> lock(dump_mutex_);
+    for (size_t s = 0; s < sources_.size(); s++) {
+        if (sources_[s].name == name) return static_cast<uint32_t>(s);
+    }
+    sources_.push_back({name, stages});
+    return static_cast<uint32_t>(sources_.size() - 1);
+}
+
+std::vector<FlightSource> FlightRecorder::sources() const {
+    std::lock_guard<std::mutex> lock(dump_mutex_);
+    return sources_;
+}
+
+void FlightRecorder::recordBlock(uint32_t source, uint64_t block, uint64_t start_ns, uint32_t duration_ns,
+                                 uint32_t budget_ns, const uint32_t* stage_ns, size_t stages, uint32_t queue_depth,
+                                 uint16_t flags) {
+    FlightEvent e;
+    e.time_ns = start_ns;
+    e.block = block;
+    e.source = source;
+    e.thread_id = flightThreadId();
+    e.duration_ns = duration_ns;
+    e.budget_ns = budget_ns;
+    for (size_t s = 0; s < std::min(stages, kFlightStages); s++) e.stage_ns[s] = stage_ns[s];
+    e.queue_depth = queue_depth;
+    e.kind = static_cast<uint16_t>(FlightEventKind::Block);
+    if (budget_ns != 0 && duration_ns > budget_ns) flags |= kFlightDeadlineMiss;
+    e.flags = flags;
+    record(e);
+}
+
+void FlightRecorder::recordParameter(uint32_t source, uint64_t block, uint32_t id, uint32_t node, float value,
+                                     float previous) {
+    FlightEvent e;
+    e.time_ns = flightNowNs();
+    e.block = block;
+    e.source = source;
+    e.thread_id = flightThreadId();
+    e.parameter.id = id;
+    e.parameter.node = node;
+    e.parameter.value = value;
+    e.parameter.previous = previous;
+    e.kind = static_cast<uint16_t>(FlightEventKind::Parameter);
+    record(e);
+}
+
+void FlightRecorder::dump(const std::string& path) const {
+    const bool frozen = state_.load(std::memory_order_acquire) == kFrozen;
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    const uint64_t count = std::min<uint64_t>(head, events_.size());
+    const uint64_t oldest = head - count;
+    const uint64_t trigger = frozen && trigger_index_ >= oldest ? trigger_index_ - oldest : count;
+
+    std::vector<unsigned char> out;
+    out.reserve(kHeaderBytes + 256 + count * sizeof(FlightEvent));
+    put(out, kMagic, sizeof(kMagic));
+    putValue(out, kFlightRecorderVersion);
+    putValue(out, static_cast<uint32_t>(sizeof(FlightEvent)));
+    putValue(out, count);
+    putValue(out, trigger);
+    putValue(out, static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count()));
+    putValue(out, flightNowNs());
+    putValue(out, dropped_.load(std::memory_order_relaxed));
+    const std::vector<FlightSource> sources = this->sources();
+    putValue(out, static_cast<uint32_t>(sources.size()));
+    putValue(out, uint32_t{0});
+    for (const FlightSource& source : sources) {
+        putString(out, source.name);
+        putValue(out, static_cast<uint8_t>(source.stages.size()));
+        for (const std::string& stage : source.stages) putString(out, stage);
+    }
+    for (uint64_t i = oldest; i < head; i++) put(out, &events_[i & mask_], sizeof(FlightEvent));
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) fail(path, "cannot create");
+    const bool written = std::fwrite(out.data(), 1, out.size(), file) == out.size();
+    if (std::fclose(file) != 0 || !written) fail(path, "write failed");
+}
+
+void FlightRecorder::rearm() {
+    trigger_requested_.store(false, std::memory_order_relaxed);
+    remaining_ = 0;
+    trigger_index_ = 0;
+    state_.store(kArmed, std::memory_order_release);
+}
+
+std::string FlightRecorder::lastDump() const {
+    std::lock_guard<std::mutex> lock(dump_mutex_);
+    return last_dump_;
+}
+
+std::string FlightRecorder::dumpError() const {
+    std::lock_guard<std::mutex> lock(dump_mutex_);
+    return dump_error_;
+}
+
+void FlightRecorder::runDumper() {
+    while (!stop_.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(kDumperPoll);
+        if (!frozen() || dumps_.load(std::memory_order_relaxed) >= config_.max_dumps) continue;
+        const uint64_t n = dumps_.load(std::memory_order_relaxed);
+        const std::string path = config_.directory + "/" + config_.prefix + "-" + std::to_string(n) + ".dfr";
+        try {
+            dump(path);
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lock(dump_mutex_);
+            if (dump_error_.empty()) dump_error_ = e.what();
+            continue;  // Stays frozen: the failure is reported and nothing is overwritten
+        }
+        {
+            std::lock_guard<std::mutex> lock(dump_mutex_);
+            last_dump_ = path;
+        }
+        dumps_.fetch_add(1, std::memory_order_relaxed);
+        if (n + 1 < config_.max_dumps) rearm();
+    }
+}
+
+FlightRecording readFlightRecording(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) fail(path, "cannot open");
+    std::vector<unsigned char> data;
+    unsigned char chunk[65536];
+    size_t got;
+    while ((got = std::fread(chunk, 1, sizeof(chunk), file)) > 0) data.insert(data.end(), chunk, chunk + got);
+    std::fclose(file);
+
+    Reader in{data, path};
+    char magic[8];
+    in.get(magic, sizeof(magic));
+    if (std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) fail(path, "not a flight recording");
+    const uint32_t version = in.value<uint32_t>();
+    const uint32_t event_bytes = in.value<uint32_t>();
+    if (version != kFlightRecorderVersion || event_bytes != sizeof(FlightEvent)) {
+        fail(path, "unsupported version " + std::to_string(version));
+    }
+    FlightRecording r;
+    const uint64_t count = in.value<uint64_t>();
+    r.trigger_index = in.value<uint64_t>();
+    r.wall_ns = in.value<uint64_t>();
+    r.steady_ns = in.value<uint64_t>();
+    r.dropped = in.value<uint64_t>();
+    const uint32_t sources = in.value<uint32_t>();
+    in.value<uint32_t>();
+    for (uint32_t s = 0; s < sources; s++) {
+        FlightSource source;
+        source.name = in.string();
+        const uint8_t stages = in.value<uint8_t>();
+        for (uint8_t k = 0; k < stages; k++) source.stages.push_back(in.string());
+        r.sources.push_back(std::move(source));
+    }
+    if ((data.size() - in.at) / sizeof(FlightEvent) < count) fail(path, "truncated");
+    r.events.resize(count);
+    if (count > 0) in.get(r.events.data(), count * sizeof(FlightEvent));
+    return r;
+}
@@ -0,0 +1,218 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+constexpr size_t kFlightStages = 6;
+constexpr uint32_t kFlightRecorderVersion = 1;
+
+enum class FlightEventKind : uint16_t {
+    Block = 0,      // One block of a source: stage times, duration against budget
+    Parameter = 1,  // A parameter change applied at the start of block
+    Marker = 2      // Application event, arg in parameter.id
+};
+
+// FlightEvent::flags
+enum FlightFlag : uint16_t {
+    kFlightDeadlineMiss = 1,  // duration_ns over budget_ns
+    kFlightXrun = 2,          // Frames dropped, or an under- or overrun, during the block
+    kFlightTrigger = 4        // The event that froze the recording
+};
+
+// Parameter of a Parameter event. id is the source's own numbering
+// (ParameterId for the engine's automation; kFlightParameterSwitch while a
+// ParameterSwitch crossfade runs, value its progress).
+struct FlightParameter {
+    uint32_t id;
+    uint32_t node;      // UINT32_MAX for all nodes
+    float value;
+    float previous;
+    uint32_t reserved[2];
+};
+
+constexpr uint32_t kFlightParameterSwitch = 0x100;
+
+// One recorded event, 64 bytes, also the file's record layout
+struct FlightEvent {
+    uint64_t time_ns = 0;      // steady_clock at the start of the block or the change
+    uint64_t block = 0;        // Block sequence number of the source
+    uint32_t source = 0;       // Index returned by FlightRecorder::addSource
+    uint32_t thread_id = 0;    // flightThreadId() of the recording thread
+    uint32_t duration_ns = 0;  // Block: start to end
+    uint32_t budget_ns = 0;    // Block: its real-time period, 0 for none
+    union {
+        uint32_t stage_ns[kFlightStages];  // Block: per stage, in the source's stage order
+        FlightParameter parameter;         // Parameter, Marker
+    };
+    uint32_t queue_depth = 0;  // Work waiting behind the block (events, blocks), source-defined
+    uint16_t kind = 0;         // FlightEventKind
+    uint16_t flags = 0;        // FlightFlag bits
+
+    FlightEvent() : stage_ns{} {}
+};
+static_assert(sizeof(FlightEvent) == 64, "flight events are one cache line");
+
+struct FlightSource {
+    std::string name;
+    std::vector<std::string> stages;  // At most kFlightStages
+};
+
+struct FlightRecorderConfig {
+    size_t capacity = 16384;          // Events held, rounded up to a power of two
+    size_t post_trigger = 32;         // Events recorded after the trigger before freezing
+    bool trigger_on_deadline = true;  // Freeze on kFlightDeadlineMiss
+    bool trigger_on_xrun = true;      // Freeze on kFlightXrun
+    // Directory of the automatic dumps, empty for none: a background thread
+    // writes each frozen recording to <directory>/<prefix>-<n>.dfr and
+    // re-arms the recorder
+    std::string directory;
+    std::string prefix = "flight";
+    size_t max_dumps = 16;            // Automatic dumps before the recorder stays frozen
+};
+
+// Events held when a recorder covers seconds of blocks of block_size
+// samples from events_per_block events each
+size_t flightCapacityFor(double seconds, double sample_rate, size_t block_size, size_t events_per_block = 2);
+
+// Small number of the calling thread (the kernel thread id on Linux),
+// cached per thread
+uint32_t flightThreadId();
+uint64_t flightNowNs();
+
+// Always-on flight recorder of per-block timings.
+//
+// The audio thread appends one fixed-size event per block (and per
+// parameter change) to a ring holding the last capacity() events: a
+// 64-byte copy and a release store, no lock, no allocation. Sources (the
+// engine, the hybrid node, the host's pipeline) are registered with their
+// stage names before recording starts. An event flagged as a deadline miss
+// or xrun, or a trigger() from any thread, arms the freeze: post_trigger
+// more events are kept, then the ring freezes and later events are counted
+// as dropped. A frozen ring is written off the audio thread by the
+// background dumper (config.directory) or by dump(), and rearm() resumes
+// recording.
+//
+// record() has one producer at a time. Sources that run on different
+// threads need a recorder each.
+//
+// File (.dfr), host byte order:
+//
+//   0   "DASEFLT1"
+//   8   u32 version, u32 event bytes (64)
+//   16  u64 event count, u64 index of the trigger event (count if none)
+//   32  u64 wall clock at the dump (ns since the Unix epoch), u64 steady
+//       clock at the dump (ns, the events' clock)
+//   48  u64 events dropped while frozen, u32 source count, u32 reserved
+//   64  per source: u16 name length and name, u8 stage count, per stage u16
+//       length and name
+//   ... the events, oldest first
+class FlightRecorder {
+public:
+    // Throws std::invalid_argument for a zero capacity
+    explicit FlightRecorder(const FlightRecorderConfig& config = FlightRecorderConfig());
+    // Stops the dumper; a frozen recording not yet dumped is lost
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    // Registers a source before it records; returns its index, or that of
+    // the source already registered under name. Throws
+    // std::invalid_argument for more than kFlightStages stages.
+    uint32_t addSource(const std::string& name, const std::vector<std::string>& stages);
+    std::vector<FlightSource> sources() const;
+
+    // Audio side
+    void record(const FlightEvent& event) {
+        const int state = state_.load(std::memory_order_acquire);
+        if (state == kFrozen) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        FlightEvent& slot = events_[head & mask_];
+        slot = event;
+        if (state == kTriggered) {
+            head_.store(head + 1, std::memory_order_release);
+            if (--remaining_ == 0) state_.store(kFrozen, std::memory_order_release);
+            return;
+        }
+        const bool trigger = (event.flags & trigger_mask_) || trigger_requested_.load(std::memory_order_relaxed);
+        if (trigger) {
+            slot.flags |= kFlightTrigger;
+            trigger_requested_.store(false, std::memory_order_relaxed);
+            trigger_index_ = head;
+            remaining_ = config_.post_trigger;
+        }
+        head_.store(head + 1, std::memory_order_release);
+        if (trigger) state_.store(remaining_ == 0 ? kFrozen : kTriggered, std::memory_order_release);
+    }
+
+    // Convenience for Block events
+    void recordBlock(uint32_t source, uint64_t block, uint64_t start_ns, uint32_t duration_ns, uint32_t budget_ns,
+                     const uint32_t* stage_ns, size_t stages, uint32_t queue_depth, uint16_t flags = 0);
+    void recordParameter(uint32_t source, uint64_t block, uint32_t id, uint32_t node, float value, float previous);
+
+    // Any thread: freeze as if the next recorded event were a deadline miss
+    void trigger() { trigger_requested_.store(true, std::memory_order_relaxed); }
+    bool frozen() const { return state_.load(std::memory_order_acquire) == kFrozen; }
+    bool triggered() const { return state_.load(std::memory_order_acquire) != kArmed; }
+    // Writes the held events to path; throws std::runtime_error on I/O
+    // failure. Call it on a frozen recorder, or while nothing records.
+    void dump(const std::string& path) const;
+    // Clears the trigger and resumes recording after a dump
+    void rearm();
+
+    size_t capacity() const { return events_.size(); }
+    uint64_t recorded() const { return head_.load(std::memory_order_acquire); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    uint64_t dumps() const { return dumps_.load(std::memory_order_relaxed); }
+    // Path of the newest automatic dump, empty before the first
+    std::string lastDump() const;
+    // First error of the dumper, empty if none
+    std::string dumpError() const;
+    const FlightRecorderConfig& config() const { return config_; }
+
+private:
+    enum : int { kArmed = 0, kTriggered = 1, kFrozen = 2 };
+
+    void runDumper();
+
+    FlightRecorderConfig config_;
+    std::vector<FlightEvent> events_;
+    uint64_t mask_;
+    uint16_t trigger_mask_;
+    std::vector<FlightSource> sources_;
+
+    alignas(64) std::atomic<uint64_t> head_{0};
+    std::atomic<int> state_{kArmed};
+    uint64_t trigger_index_ = 0;      // Written by the producer before it freezes
+    size_t remaining_ = 0;            // Events to keep after the trigger
+    alignas(64) std::atomic<bool> trigger_requested_{false};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> dumps_{0};
+
+    std::atomic<bool> stop_{false};
+    mutable std::mutex dump_mutex_;
+    std::string last_dump_;
+    std::string dump_error_;
+    std::thread dumper_;
+};
+
+// A .dfr file read back
+struct FlightRecording {
+    uint64_t wall_ns = 0;
+    uint64_t steady_ns = 0;
+    uint64_t dropped = 0;
+    uint64_t trigger_index = 0;  // events.size() if nothing triggered
+    std::vector<FlightSource> sources;
+    std::vector<FlightEvent> events;
+};
+
+// Throws std::runtime_error for a missing, truncated or foreign file
+FlightRecording readFlightRecording(const std::string& path);
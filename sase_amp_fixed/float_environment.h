@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <xmmintrin.h>
+#define DASE_FP_ENV_X86 1
+#elif defined(__aarch64__) && (defined(__GNUC__) || defined(__clang__))
+#define DASE_FP_ENV_AARCH64 1
+#endif
+
+// Denormal handling of the calling thread while in scope.
+//
+// Integrators and filters decaying toward zero end in subnormal values,
+// which most cores handle in microcode at tens to hundreds of times the
+// cost of a normal operation, so a node bank going quiet can get slower
+// just as it has least to do. With flush set the scope turns on
+// flush-to-zero and denormals-are-zero (MXCSR FTZ and DAZ on x86, FPCR.FZ on
+// AArch64), otherwise it leaves the mode as it is; the thread's previous
+// mode and flags come back when it ends. Elsewhere it does nothing.
+//
+// Either way it clears the sticky underflow (and denormal operand) flags on
+// entry, so takeDenormalFlags() tells whether the code since then produced
+// a result in the subnormal range, flushed or not; without flushing, reading
+// a denormal counts as well. Reading and clearing the flags is a few cycles,
+// cheap enough to do once per job.
+class DenormalScope {
+public:
+    explicit DenormalScope(bool flush = true) {
+#if defined(DASE_FP_ENV_X86)
+        saved_ = _mm_getcsr();
+        _mm_setcsr((saved_ & ~kCsrFlags) | (flush ? kCsrFlushBits : 0u));
+#elif defined(DASE_FP_ENV_AARCH64)
+        saved_ = readFpcr();
+        saved_status_ = readFpsr();
+        if (flush) writeFpcr(saved_ | kFpcrFz);
+        writeFpsr(saved_status_ & ~kFpsrFlags);
+#else
+        (void)flush;
+#endif
+    }
+
+    ~DenormalScope() {
+#if defined(DASE_FP_ENV_X86)
+        _mm_setcsr(static_cast<unsigned>(saved_));
+#elif defined(DASE_FP_ENV_AARCH64)
+        writeFpcr(saved_);
+        writeFpsr(saved_status_);
+#endif
+    }
+
+    DenormalScope(const DenormalScope&) = delete;
+    DenormalScope& operator=(const DenormalScope&) = delete;
+
+    // True if a result underflowed (or a denormal was read) since the scope
+    // began or the last call; clears the flags
+    bool takeDenormalFlags() {
+#if defined(DASE_FP_ENV_X86)
+        const unsigned csr = _mm_getcsr();
+        if ((csr & kCsrDenormalFlags) == 0) return false;
+        _mm_setcsr(csr & ~kCsrFlags);
+        return true;
+#elif defined(DASE_FP_ENV_AARCH64)
+        const uint64_t fpsr = readFpsr();
+        if ((fpsr & kFpsrDenormalFlags) == 0) return false;
+        writeFpsr(fpsr & ~kFpsrFlags);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    // True where the scope changes the mode and reads the flags
+    static constexpr bool supported() {
+#if defined(DASE_FP_ENV_X86) || defined(DASE_FP_ENV_AARCH64)
+        return true;
+#else
+        return false;
+#endif
+    }
+
+private:
+#if defined(DASE_FP_ENV_X86)
+    static constexpr unsigned kCsrFlags = 0x3f;          // Sticky exception flags
+    static constexpr unsigned kCsrDenormalFlags = 0x12;  // UE | DE
+    static constexpr unsigned kCsrFlushBits = 0x8040;    // FTZ | DAZ
+#elif defined(DASE_FP_ENV_AARCH64)
+    static constexpr uint64_t kFpcrFz = uint64_t(1) << 24;
+    static constexpr uint64_t kFpsrFlags = 0x9f;           // Cumulative exception flags
+    static constexpr uint64_t kFpsrDenormalFlags = 0x88;   // IDC | UFC
+
+    static uint64_t readFpcr() {
+        uint64_t value;
+        __asm__ __volatile__("mrs %0, fpcr" : "=r"(value));
+        return value;
+    }
+    static void writeFpcr(uint64_t value) { __asm__ __volatile__("msr fpcr, %0" : : "r"(value)); }
+    static uint64_t readFpsr() {
+        uint64_t value;
+        __asm__ __volatile__("mrs %0, fpsr" : "=r"(value));
+        return value;
+    }
+    static void writeFpsr(uint64_t value) { __asm__ __volatile__("msr fpsr, %0" : : "r"(value)); }
+
+    uint64_t saved_status_ = 0;
+#endif
+    uint64_t saved_ = 0;
+};
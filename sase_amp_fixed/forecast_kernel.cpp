@@ -0,0 +1,175 @@
+#include "forecast_kernel.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+// Centred sums of a window of n frames at x = 0 .. n-1
+struct Centred {
+    double n;
+    double xx;  // sum (x - mean x)^2
+    double xy;  // sum (x - mean x)(y - mean y)
+    double yy;  // sum (y - mean y)^2
+};
+
+Centred centre(size_t frames, double sum_y, double sum_xy, double sum_yy) {
+    const double n = static_cast<double>(frames);
+    Centred c;
+    c.n = n;
+    c.xx = n * (n * n - 1.0) / 12.0;
+    c.xy = frames ? sum_xy - 0.5 * (n - 1.0) * sum_y : 0.0;
+    c.yy = frames ? std::max(0.0, sum_yy - sum_y * sum_y / n) : 0.0;
+    return c;
+}
+
+} // namespace
+
+ForecastKernel::ForecastKernel(size_t metrics, const ForecastKernelConfig& config)
+    : metrics_(metrics), config_(config) {
+    if (metrics_ == 0) throw std::invalid_argument("ForecastKernel needs at least one metric");
+    if (config_.trend_window == 0 || config_.fit_window == 0 || config_.stability_window == 0) {
+        throw std::invalid_argument("forecast windows must hold at least one frame");
+    }
+    if (!(config_.alpha > 0.0 && config_.alpha <= 1.0) || !(config_.beta >= 0.0 && config_.beta <= 1.0)) {
+        throw std::invalid_argument("need 0 < alpha <= 1 and 0 <= beta <= 1");
+    }
+    trend_.length = config_.trend_window;
+    fit_.length = config_.fit_window;
+    stability_.length = config_.stability_window;
+    capacity_ = std::max({trend_.length, fit_.length, stability_.length});
+    ring_.assign(capacity_ * metrics_, 0.0);
+    reset();
+}
+
+void ForecastKernel::reset() {
+    for (Window* w : {&trend_, &fit_, &stability_}) {
+        w->sum_y.assign(metrics_, 0.0);
+        w->sum_xy.assign(metrics_, 0.0);
+        w->sum_yy.assign(metrics_, 0.0);
+        w->bad.assign(metrics_, 0);
+    }
+    frames_ = 0;
+    level_.assign(metrics_, 0.0);
+    holt_trend_.assign(metrics_, 0.0);
+    started_.assign(metrics_, 0);
+    origin_.assign(metrics_, 0.0);
+}
+
+size_t ForecastKernel::filled(const Window& w) const {
+    return static_cast<size_t>(std::min<uint64_t>(frames_, w.length));
+}
+
+void ForecastKernel::recompute(Window& w) {
+    const size_t n = filled(w);
+    std::fill(w.sum_y.begin(), w.sum_y.end(), 0.0);
+    std::fill(w.sum_xy.begin(), w.sum_xy.end(), 0.0);
+    std::fill(w.sum_yy.begin(), w.sum_yy.end(), 0.0);
+    std::fill(w.bad.begin(), w.bad.end(), 0u);
+    for (size_t k = 0; k < n; k++) {
+        const double* row = ring_.data() + ((frames_ - n + k) % capacity_) * metrics_;
+        for (size_t m = 0; m < metrics_; m++) {
+            const bool finite = std::isfinite(row[m]);
+            const double v = finite ? row[m] - origin_[m] : 0.0;
+            w.bad[m] += finite ? 0u : 1u;
+            w.sum_y[m] += v;
+            w.sum_xy[m] += static_cast<double>(k) * v;
+            w.sum_yy[m] += v * v;
+        }
+    }
+}
+
+void ForecastKernel::push(const double* values) {
+    // A metric's first finite value is its origin; every value before it
+    // was non-finite and counted as 0 already
+    for (size_t m = 0; m < metrics_; m++) {
+        if (!started_[m] && std::isfinite(values[m])) origin_[m] = values[m];
+    }
+
+    // Drop each full window's oldest frame before its ring row is reused
+    for (Window* w : {&trend_, &fit_, &stability_}) {
+        if (frames_ < w->length) continue;
+        const double* oldest = ring_.data() + ((frames_ - w->length) % capacity_) * metrics_;
+        for (size_t m = 0; m < metrics_; m++) {
+            const bool finite = std::isfinite(oldest[m]);
+            const double v = finite ? oldest[m] - origin_[m] : 0.0;
+            w->bad[m] -= finite ? 0u : 1u;
+            w->sum_xy[m] -= w->sum_y[m] - v;  // Every later frame moves down one x
+            w->sum_y[m] -= v;
+            w->sum_yy[m] -= v * v;
+        }
+    }
+
+    std::copy(values, values + metrics_, ring_.data() + (frames_ % capacity_) * metrics_);
+    for (Window* w : {&trend_, &fit_, &stability_}) {
+        const double x = static_cast<double>(std::min<uint64_t>(frames_, w->length - 1));
+        for (size_t m = 0; m < metrics_; m++) {
+            const bool finite = std::isfinite(values[m]);
+            const double v = finite ? values[m] - origin_[m] : 0.0;
+            w->bad[m] += finite ? 0u : 1u;
+            w->sum_y[m] += v;
+            w->sum_xy[m] += x * v;
+            w->sum_yy[m] += v * v;
+        }
+    }
+
+    const double alpha = config_.alpha, beta = config_.beta;
+    for (size_t m = 0; m < metrics_; m++) {
+        const double y = values[m];
+        if (!std::isfinite(y)) continue;
+        if (!started_[m]) {
+            level_[m] = y;
+            holt_trend_[m] = 0.0;
+            started_[m] = 1;
+            continue;
+        }
+        const double previous = level_[m];
+        level_[m] = alpha * y + (1.0 - alpha) * (previous + holt_trend_[m]);
+        holt_trend_[m] = beta * (level_[m] - previous) + (1.0 - beta) * holt_trend_[m];
+    }
+
+    frames_++;
+    if (frames_ % capacity_ == 0) {
+        for (size_t m = 0; m < metrics_; m++) {
+            if (std::isfinite(values[m])) origin_[m] = values[m];
+        }
+        recompute(trend_);
+        recompute(fit_);
+        recompute(stability_);
+    }
+}
+
+MetricForecast ForecastKernel::forecast(size_t m) const {
+    MetricForecast f;
+    const size_t nt = filled(trend_);
+    const Centred t = centre(nt, trend_.sum_y[m], trend_.sum_xy[m], trend_.sum_yy[m]);
+    f.slope = nt >= 2 && trend_.bad[m] == 0 ? t.xy / t.xx : 0.0;
+
+    const size_t nf = filled(fit_);
+    const Centred c = centre(nf, fit_.sum_y[m], fit_.sum_xy[m], fit_.sum_yy[m]);
+    if (nf < 3 || fit_.bad[m] != 0) {
+        f.r_squared = 0.0;
+    } else if (c.yy < 1e-10) {
+        f.r_squared = 1.0;  // A flat window fits its line exactly
+    } else {
+        f.r_squared = std::min(1.0, std::max(0.0, c.xy * c.xy / (c.xx * c.yy)));
+    }
+
+    const size_t ns = filled(stability_);
+    const Centred s = centre(ns, stability_.sum_y[m], stability_.sum_xy[m], stability_.sum_yy[m]);
+    f.stddev = ns == 0 || stability_.bad[m] != 0 ? std::numeric_limits<double>::quiet_NaN()
+                                                  : std::sqrt(s.yy / s.n);
+
+    f.level = level_[m];
+    f.trend = holt_trend_[m];
+    return f;
+}
+
+void ForecastKernel::forecastAll(MetricForecast* out) const {
+    for (size_t m = 0; m < metrics_; m++) out[m] = forecast(m);
+}
+
+double ForecastKernel::holtForecast(size_t m, double steps) const {
+    return level_[m] + steps * holt_trend_[m];
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct ForecastKernelConfig {
+    size_t trend_window = 128;     // Frames in the slope fit
+    size_t fit_window = 30;        // Frames in the R^2 fit
+    size_t stability_window = 10;  // Frames in the standard deviation
+    double alpha = 0.5;            // Holt level smoothing, (0, 1]
+    double beta = 0.1;             // Holt trend smoothing, [0, 1]
+};
+
+// Per-metric state after a frame
+struct MetricForecast {
+    double slope;      // Least-squares change per frame over the trend window; 0 below 2 frames
+    double r_squared;  // Of the line fit over the fit window, in [0, 1]; 0 below 3 frames,
+                       // 1 for a window whose sum of squared deviations is below 1e-10
+    double stddev;     // Population standard deviation over the stability window
+    double level;      // Holt smoothed level
+    double trend;      // Holt smoothed change per frame
+};
+
+// Sliding-window trend statistics of several metrics at once, the kernel of
+// server/predictive_model.py (PredictiveModel): what that model refits with
+// numpy.polyfit over its history window every frame is kept here as running
+// sums, so a frame costs O(metrics) whatever the window lengths.
+//
+// Each window holds, per metric, sum y, sum x y and sum y^2 with x counted
+// from the window's oldest frame. A frame leaving the window is subtracted
+// and every remaining x shifts down by one (sum x y -= sum y), so the slope,
+// R^2 and variance follow from closed forms with sum x and sum x^2 of 0 .. n-1.
+// Values enter the sums relative to a per-metric origin near them, which
+// every statistic here ignores, so metrics far from zero lose no precision
+// to cancellation. Running sums drift by a rounding error per update; they
+// are recomputed from the history ring, about the latest value, once per
+// ring length, which keeps the cost amortized O(1).
+//
+// A non-finite value counts as 0 in the sums but marks its windows: while
+// one is inside, slope and R^2 read 0 and the standard deviation NaN, as the
+// Python model gives up on such a series. Holt smoothing skips it.
+class ForecastKernel {
+public:
+    // Throws std::invalid_argument for no metrics, an empty window or
+    // smoothing factors out of range
+    explicit ForecastKernel(size_t metrics, const ForecastKernelConfig& config = ForecastKernelConfig());
+
+    // Adds a frame of metricCount() values
+    void push(const double* values);
+    // Forgets every frame
+    void reset();
+
+    size_t metricCount() const { return metrics_; }
+    uint64_t frameCount() const { return frames_; }
+    const ForecastKernelConfig& config() const { return config_; }
+
+    // State of metric m after the last frame (out of range m is not checked)
+    MetricForecast forecast(size_t m) const;
+    // All metrics, out[0 .. metricCount())
+    void forecastAll(MetricForecast* out) const;
+    // Holt forecast of metric m `steps` frames ahead: level + steps * trend
+    double holtForecast(size_t m, double steps) const;
+
+private:
+    // Running sums of one window over every metric
+    struct Window {
+        size_t length = 0;
+        std::vector<double> sum_y;
+        std::vector<double> sum_xy;
+        std::vector<double> sum_yy;
+        std::vector<uint32_t> bad;  // Non-finite values inside
+    };
+
+    size_t filled(const Window& w) const;
+    void recompute(Window& w);
+
+    size_t metrics_;
+    ForecastKernelConfig config_;
+    Window trend_;
+    Window fit_;
+    Window stability_;
+    size_t capacity_;            // Ring frames: the longest window
+    std::vector<double> ring_;   // [capacity x metrics], frame f at row f % capacity
+    uint64_t frames_ = 0;
+    std::vector<double> level_;
+    std::vector<double> holt_trend_;
+    std::vector<char> started_;  // Holt has seen a finite value
+    std::vector<double> origin_; // Subtracted from values entering the sums
+};
@@ -0,0 +1,252 @@
+#include "frequency_response.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include "analog_universal_node_engine_avx2.h"
+#include "dsp_core.h"
+#include "fft_backend.h"
+
+// Chirp frames: bins within this of the analysis bin form the fundamental's
+// band, and h times as many the band of harmonic h
+constexpr size_t kBandBins = 2;
+
+struct FrequencyResponseAnalyzer::Transform {
+    DspRealFft* fft = nullptr;
+    std::vector<float> windowed;  // frameSpectrum's scratch
+    std::vector<float> unrolled;  // A node's frame in time order
+    std::vector<float> spectrum;
+
+    ~Transform() {
+        std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+        dsp_rfft_destroy(fft);
+    }
+};
+
+FrequencyResponseAnalyzer::FrequencyResponseAnalyzer(const ResponseAnalyzerConfig& config) : config_(config) {
+    const size_t N = config_.fft_size;
+    const double fs = config_.sample_rate;
+    if (!(fs > 0.0)) throw std::invalid_argument("sample_rate must be positive");
+    if (!(config_.min_hz > 0.0) || !(config_.max_hz > config_.min_hz) || !(config_.max_hz < fs / 2.0)) {
+        throw std::invalid_argument("need 0 < min_hz < max_hz < sample_rate / 2");
+    }
+    if (config_.points == 0) throw std::invalid_argument("points must be at least 1");
+    if (config_.harmonics < 1) throw std::invalid_argument("harmonics must be at least 1");
+    if (config_.block_size == 0) throw std::invalid_argument("block_size must be at least 1");
+    if (N < DSP_FFT_MIN_SIZE || N > DSP_FFT_MAX_SIZE || (N & (N - 1)) != 0) {
+        throw std::invalid_argument("fft_size must be a power of two from " + std::to_string(DSP_FFT_MIN_SIZE) +
+                                    " to " + std::to_string(DSP_FFT_MAX_SIZE));
+    }
+    makeTransform();  // Fails here rather than in analyze()
+
+    // Log-spaced targets
+    const size_t P = config_.points;
+    std::vector<double> targets(P);
+    for (size_t p = 0; p < P; p++) {
+        const double t = P > 1 ? static_cast<double>(p) / static_cast<double>(P - 1) : 0.0;
+        targets[p] = config_.min_hz * std::pow(config_.max_hz / config_.min_hz, t);
+    }
+    const double bin_hz = fs / static_cast<double>(N);
+    bins_.resize(P);
+    frequencies_.resize(P);
+
+    if (config_.stimulus == ResponseStimulus::Multitone) {
+        // Each target takes the nearest free prime bin below Nyquist
+        std::vector<bool> free(N / 2, true);
+        free[0] = free[1] = false;
+        for (size_t b = 2; b * b < N / 2; b++) {
+            if (free[b]) {
+                for (size_t m = b * b; m < N / 2; m += b) free[m] = false;
+            }
+        }
+        for (size_t p = 0; p < P; p++) {
+            const size_t want = std::min(N / 2 - 1, static_cast<size_t>(std::lround(targets[p] / bin_hz)));
+            size_t found = 0;
+            for (size_t d = 0; d < N / 2 && found == 0; d++) {
+                if (want >= d && free[want - d]) {
+                    found = want - d;
+                } else if (want + d < N / 2 && free[want + d]) {
+                    found = want + d;
+                }
+            }
+            if (found == 0) {
+                throw std::invalid_argument("fft_size " + std::to_string(N) + " has too few prime bins for " +
+                                            std::to_string(P) + " multitone points");
+            }
+            free[found] = false;
+            bins_[p] = found;
+        }
+        std::sort(bins_.begin(), bins_.end());
+        for (size_t p = 0; p < P; p++) frequencies_[p] = static_cast<double>(bins_[p]) * bin_hz;
+
+        // Schroeder phases keep the crest factor low; the sum is scaled to
+        // the requested peak
+        std::vector<double> period(N, 0.0);
+        for (size_t p = 0; p < P; p++) {
+            const double phase = -M_PI * static_cast<double>(p) * static_cast<double>(p + 1) / static_cast<double>(P);
+            const double step = 2.0 * M_PI * static_cast<double>(bins_[p]) / static_cast<double>(N);
+            for (size_t t = 0; t < N; t++) period[t] += std::cos(step * static_cast<double>(t) + phase);
+        }
+        double peak = 0.0;
+        for (double v : period) peak = std::max(peak, std::fabs(v));
+        const double scale = peak > 0.0 ? config_.amplitude / peak : 0.0;
+        stimulus_.resize((config_.settle_frames + 1) * N);
+        for (size_t t = 0; t < stimulus_.size(); t++) stimulus_[t] = static_cast<float>(period[t % N] * scale);
+        frames_.push_back({stimulus_.size(), 0, P});
+    } else {
+        // x(t) = A sin(2 pi f1 L (e^(t / L) - 1)), L = T / ln(f2 / f1): the
+        // sweep passes f at t = L ln(f / f1)
+        const double T = std::round(config_.sweep_seconds * fs);
+        if (!(T >= 1.0)) throw std::invalid_argument("sweep_seconds must cover at least one sample");
+        const double L = T / std::log(config_.max_hz / config_.min_hz);
+        const double w1 = 2.0 * M_PI * config_.min_hz / fs;
+        const size_t lead = N / 2;
+        stimulus_.assign(static_cast<size_t>(T) + N, 0.0f);
+        for (size_t t = 0; t < static_cast<size_t>(T); t++) {
+            const double phase = w1 * L * std::expm1(static_cast<double>(t) / L);
+            stimulus_[lead + t] = static_cast<float>(config_.amplitude * std::sin(phase));
+        }
+        window_.resize(N);
+        dsp_window(DSP_WINDOW_HANN, true, window_.data(), N);
+        for (size_t p = 0; p < P; p++) {
+            // The frame centred on the passing moment starts lead samples before it
+            const size_t start = std::min(static_cast<size_t>(T),
+                                          static_cast<size_t>(std::lround(L * std::log(targets[p] / config_.min_hz))));
+            bins_[p] = std::max<size_t>(1, std::min(N / 2 - 1, static_cast<size_t>(std::lround(targets[p] / bin_hz))));
+            frequencies_[p] = targets[p];
+            frames_.push_back({start + N, p, p + 1});
+        }
+    }
+
+    // Input spectra of the frames, once
+    std::unique_ptr<Transform> transform = makeTransform();
+    input_spectra_.resize(frames_.size() * (N + 2));
+    for (size_t f = 0; f < frames_.size(); f++) {
+        frameSpectrum(*transform, stimulus_.data() + frames_[f].end - N, input_spectra_.data() + f * (N + 2));
+    }
+}
+
+FrequencyResponseAnalyzer::~FrequencyResponseAnalyzer() = default;
+
+std::unique_ptr<FrequencyResponseAnalyzer::Transform> FrequencyResponseAnalyzer::makeTransform() const {
+    auto transform = std::make_unique<Transform>();
+    {
+        std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+        transform->fft = dsp_rfft_create(config_.fft_size, dsp_fft_default_backend());
+    }
+    if (!transform->fft) {
+        throw std::invalid_argument("the DSP core has no real FFT of size " + std::to_string(config_.fft_size));
+    }
+    transform->windowed.resize(config_.fft_size);
+    transform->unrolled.resize(config_.fft_size);
+    transform->spectrum.resize(config_.fft_size + 2);
+    return transform;
+}
+
+void FrequencyResponseAnalyzer::frameSpectrum(Transform& transform, const float* frame, float* spectrum) const {
+    if (window_.empty()) {
+        dsp_rfft_forward(transform.fft, frame, spectrum);
+        return;
+    }
+    dsp_apply_window(frame, window_.data(), transform.windowed.data(), config_.fft_size);
+    dsp_rfft_forward(transform.fft, transform.windowed.data(), spectrum);
+}
+
+size_t FrequencyResponseAnalyzer::bandWidth(size_t bin, int harmonic) const {
+    if (window_.empty()) return 0;
+    // Half the spacing of the harmonics at most, so no two bands overlap
+    return std::min(kBandBins * static_cast<size_t>(harmonic), (bin - 1) / 2);
+}
+
+FrequencyResponse FrequencyResponseAnalyzer::analyze(AnalogCellularEngineAVX2& engine) const {
+    const size_t N = config_.fft_size;
+    const size_t nodes = engine.getNodeCount();
+    const size_t P = config_.points;
+    const size_t half = N / 2;
+
+    FrequencyResponse response;
+    response.nodes = nodes;
+    response.points = P;
+    response.frequencies = frequencies_;
+    response.magnitude.assign(nodes * P, 0.0f);
+    response.phase.assign(nodes * P, 0.0f);
+    response.thd.assign(nodes * P, std::numeric_limits<float>::quiet_NaN());
+    if (nodes == 0) return response;
+
+    // Sample s of node n at ring[n * N + s % N]
+    std::vector<float> ring(nodes * N, 0.0f);
+    std::vector<float> block(nodes * std::min(config_.block_size, N));
+    WorkerPool& pool = *engine.getWorkerPool();
+    std::vector<std::unique_ptr<Transform>> transforms(pool.size());
+
+    size_t position = 0;
+    for (size_t f = 0; f < frames_.size(); f++) {
+        const Frame& frame = frames_[f];
+        while (position < frame.end) {
+            // Blocks stop at ring wraps so each lands as one run per node
+            const size_t n = std::min({config_.block_size, frame.end - position, N - position % N});
+            engine.processBlock(stimulus_.data() + position, nullptr, nullptr, block.data(), n);
+            const size_t offset = position % N;
+            for (size_t node = 0; node < nodes; node++) {
+                std::copy(block.data() + node * n, block.data() + (node + 1) * n, ring.data() + node * N + offset);
+            }
+            position += n;
+        }
+
+        const float* input = input_spectra_.data() + f * (N + 2);
+        const size_t start = (frame.end - N) % N;
+        pool.parallelFor(nodes, 0, [&](size_t begin, size_t end, unsigned worker) {
+            std::unique_ptr<Transform>& transform = transforms[worker];
+            if (!transform) transform = makeTransform();
+            float* unrolled = transform->unrolled.data();
+            float* spectrum = transform->spectrum.data();
+            for (size_t node = begin; node < end; node++) {
+                const float* history = ring.data() + node * N;
+                std::copy(history + start, history + N, unrolled);
+                std::copy(history, history + start, unrolled + (N - start));
+                frameSpectrum(*transform, unrolled, spectrum);
+
+                for (size_t p = frame.first; p < frame.last; p++) {
+                    const size_t bin = bins_[p];
+                    // Least-squares H over the band: sum Y conj(X) / sum |X|^2
+                    const size_t lo = bin - bandWidth(bin, 1);
+                    const size_t hi = bin + bandWidth(bin, 1);
+                    double cross_re = 0.0, cross_im = 0.0, input_energy = 0.0, output_energy = 0.0;
+                    for (size_t k = lo; k <= hi; k++) {
+                        const double xr = input[2 * k], xi = input[2 * k + 1];
+                        const double yr = spectrum[2 * k], yi = spectrum[2 * k + 1];
+                        cross_re += yr * xr + yi * xi;
+                        cross_im += yi * xr - yr * xi;
+                        input_energy += xr * xr + xi * xi;
+                        output_energy += yr * yr + yi * yi;
+                    }
+                    const size_t index = node * P + p;
+                    if (input_energy > 0.0) {
+                        response.magnitude[index] = static_cast<float>(std::hypot(cross_re, cross_im) / input_energy);
+                        response.phase[index] = static_cast<float>(std::atan2(cross_im, cross_re));
+                    }
+
+                    // Harmonic h spreads over h times the fundamental's band
+                    double harmonic_energy = 0.0;
+                    bool counted = false;
+                    for (int h = 2; h <= config_.harmonics; h++) {
+                        const size_t centre = bin * static_cast<size_t>(h);
+                        if (centre >= half) break;
+                        const size_t width = bandWidth(bin, h);
+                        for (size_t k = centre - width; k <= std::min(half, centre + width); k++) {
+                            harmonic_energy += static_cast<double>(spectrum[2 * k]) * spectrum[2 * k] +
+                                               static_cast<double>(spectrum[2 * k + 1]) * spectrum[2 * k + 1];
+                        }
+                        counted = true;
+                    }
+                    if (counted && output_energy > 0.0) {
+                        response.thd[index] = static_cast<float>(std::sqrt(harmonic_energy / output_energy));
+                    }
+                }
+            }
+        });
+    }
+    return response;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class AnalogCellularEngineAVX2;
+struct DspRealFft;
+
+enum class ResponseStimulus {
+    LogChirp = 0,   // Exponential sine sweep, one analysis frame per frequency
+    Multitone = 1   // Periodic sum of tones, all frequencies from one frame
+};
+
+struct ResponseAnalyzerConfig {
+    ResponseStimulus stimulus = ResponseStimulus::LogChirp;
+    double sample_rate = 48000.0;
+    double min_hz = 20.0;
+    double max_hz = 20000.0;
+    size_t points = 64;           // Log-spaced analysis frequencies
+    size_t fft_size = 8192;       // Analysis frame, a power of two the DSP core takes
+    double amplitude = 0.5;       // Chirp peak; multitone peak after Schroeder phasing
+    double sweep_seconds = 4.0;   // LogChirp: sweep duration
+    size_t settle_frames = 2;     // Multitone: periods run before the analyzed one
+    int harmonics = 5;            // Highest harmonic counted in the THD
+    size_t block_size = 1024;     // Samples per engine processBlock call
+};
+
+// Bode data of every node: row n of each [nodes x points] array is node n
+struct FrequencyResponse {
+    size_t nodes = 0;
+    size_t points = 0;
+    std::vector<double> frequencies;  // [points] Hz, as measured (multitone snaps to bins)
+    std::vector<float> magnitude;     // [nodes x points] output / input, linear
+    std::vector<float> phase;         // [nodes x points] radians in (-pi, pi]
+    std::vector<float> thd;           // [nodes x points] harmonic / fundamental amplitude; NaN if none fits
+};
+
+// Frequency response of every node of an engine, for characterizing node
+// presets in bulk: give each node the parameters of one configuration and
+// one analyze() call measures them all.
+//
+// The stimulus is built once at construction and played through the
+// engine's processBlock in blocks, every node seeing the same input. Node
+// outputs go into a ring of the last fft_size samples per node, and at the
+// end of each analysis frame the nodes are transformed in parallel on the
+// engine's worker pool, one DSP core real FFT (hardware/dsp_core.h) per
+// worker.
+//
+// LogChirp sweeps exponentially from min_hz to max_hz over sweep_seconds,
+// with fft_size / 2 samples of silence on either side. Frequency f is
+// measured from the Hann-windowed frame centred on the moment the sweep
+// passes it: the response is the least-squares ratio of output to input
+// spectrum over the 5 bins around f, and harmonic h is the output energy
+// within 2 h bins of h f (its spread grows with h), the bands narrowing at
+// low bins so that they never overlap. The sweep should be slow enough that
+// a frame spans well under an octave, or the harmonic bands pick up the
+// fundamental; the lowest bins resolve little either way.
+//
+// Multitone plays the analysis frequencies together as a tone per bin with
+// Schroeder phases, periodic in fft_size, and measures all of them from one
+// rectangular frame after settle_frames periods. Frequencies snap to
+// distinct prime bins, so no tone sits on another's harmonic, but
+// intermodulation products can land on harmonic bins: its THD is an upper
+// bound, where the chirp's is not.
+//
+// analyze() starts from the engine's current node state and leaves the
+// nodes as the stimulus left them.
+class FrequencyResponseAnalyzer {
+public:
+    // Throws std::invalid_argument for a sample rate, band, point count,
+    // harmonic count or block size out of range, an fft_size the DSP core
+    // cannot transform, or more multitone points than the band has prime
+    // bins
+    explicit FrequencyResponseAnalyzer(const ResponseAnalyzerConfig& config = ResponseAnalyzerConfig());
+    ~FrequencyResponseAnalyzer();
+
+    FrequencyResponseAnalyzer(const FrequencyResponseAnalyzer&) = delete;
+    FrequencyResponseAnalyzer& operator=(const FrequencyResponseAnalyzer&) = delete;
+
+    FrequencyResponse analyze(AnalogCellularEngineAVX2& engine) const;
+
+    const ResponseAnalyzerConfig& config() const { return config_; }
+    const std::vector<double>& frequencies() const { return frequencies_; }
+    const std::vector<float>& stimulus() const { return stimulus_; }
+
+private:
+    // Frame of fft_size samples ending at sample `end` of the stimulus,
+    // analyzed at points [first, last)
+    struct Frame {
+        size_t end;
+        size_t first;
+        size_t last;
+    };
+
+    struct Transform;
+    std::unique_ptr<Transform> makeTransform() const;
+
+    // Spectrum of one frame of samples into spectrum (fft_size + 2 floats)
+    void frameSpectrum(Transform& transform, const float* frame, float* spectrum) const;
+    // Half width in bins of the band of harmonic `harmonic` (1: the
+    // fundamental) of analysis bin `bin`
+    size_t bandWidth(size_t bin, int harmonic) const;
+
+    ResponseAnalyzerConfig config_;
+    std::vector<double> frequencies_;
+    std::vector<size_t> bins_;         // Analysis bin of each point
+    std::vector<float> stimulus_;
+    std::vector<float> window_;        // Empty for a rectangular frame
+    std::vector<Frame> frames_;
+    std::vector<float> input_spectra_; // [frames x (fft_size + 2)]
+};
@@ -0,0 +1,30 @@
+// Host-only build of GpuNodeBank. With DASE_WITH_CUDA the class comes from
+// gpu_node_bank.cu instead and this file compiles to nothing.
+#ifndef DASE_WITH_CUDA
+
+#include "gpu_node_bank.h"
+#include <stdexcept>
+
+struct GpuNodeBank::Device {};
+
+bool GpuNodeBank::available() { return false; }
+
+std::string GpuNodeBank::deviceName() { return "none (built without DASE_WITH_CUDA)"; }
+
+GpuNodeBank::GpuNodeBank(size_t) {
+    throw std::runtime_error("CUDA backend unavailable: engine built without DASE_WITH_CUDA");
+}
+
+GpuNodeBank::~GpuNodeBank() = default;
+
+size_t GpuNodeBank::size() const { return 0; }
+void GpuNodeBank::upload(const NodeBank&) {}
+void GpuNodeBank::download(NodeBank&) {}
+double GpuNodeBank::waveSweep(double, double, const double*) { return 0.0; }
+void GpuNodeBank::missionStep(double, double, int) {}
+void GpuNodeBank::missionSchedule(const double*, const float*, size_t, int, double) {}
+void GpuNodeBank::block(const double*, const float*, float, float*, size_t) {}
+double* GpuNodeBank::deviceColumns() const { return nullptr; }
+int GpuNodeBank::deviceOrdinal() const { return 0; }
+
+#endif
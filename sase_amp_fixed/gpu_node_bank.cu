@@ -0,0 +1,347 @@
+// CUDA build of GpuNodeBank (compiled by nvcc with -DDASE_WITH_CUDA; see
+// the DASE_CUDA switches of setup.py and the Makefile).
+
+#include "gpu_node_bank.h"
+#include <cuda_runtime.h>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr size_t kStateColumns = NodeBank::kStateColumns;
+constexpr size_t kColumns = NodeBank::kStateColumns + NodeBank::kParameterColumns;
+constexpr unsigned kThreads = 256;
+constexpr unsigned kTile = 32;         // Transpose tile of the block outputs
+
+__constant__ float kSpectralMults[8] = {0.3f, 0.7f, 0.9f, 1.2f, 1.4f, 1.8f, 2.1f, 2.7f};
+
+void check(cudaError_t err, const char* what) {
+    if (err != cudaSuccess) {
+        throw std::runtime_error(std::string("CUDA backend: ") + what + ": " + cudaGetErrorString(err));
+    }
+}
+
+struct PassAux {
+    double values[10];
+};
+
+// Device columns, laid out like NodeBank's (capacity entries each)
+struct Columns {
+    double* integrator_state;
+    double* feedback_gain;
+    double* current_output;
+    double* previous_input;
+    double* input_gain;
+    double* time_constant;
+    double* clamp_low;
+    double* clamp_high;
+    double* spectral_mix;
+};
+
+// Paired like spectralLanes() so the float rounding order matches
+__device__ float spectral(float base) {
+    float p[8];
+    for (int j = 0; j < 8; j++) p[j] = sinf(base * kSpectralMults[j]);
+    const float sum = ((p[0] + p[4]) + (p[1] + p[5])) + ((p[2] + p[6]) + (p[3] + p[7]));
+    return sum * 0.125f;
+}
+
+__device__ double clampOutput(const Columns& c, size_t i, double v) {
+    return fmin(fmax(v, c.clamp_low[i]), c.clamp_high[i]);
+}
+
+// Sums the block's values into partial[blockIdx.x]
+__device__ void blockSum(double value, double* partial) {
+    __shared__ double sums[kThreads];
+    sums[threadIdx.x] = value;
+    __syncthreads();
+    for (unsigned stride = kThreads / 2; stride > 0; stride /= 2) {
+        if (threadIdx.x < stride) sums[threadIdx.x] += sums[threadIdx.x + stride];
+        __syncthreads();
+    }
+    if (threadIdx.x == 0) partial[blockIdx.x] = sums[0];
+}
+
+__global__ void waveKernel(Columns c, size_t size, size_t capacity, double input, double control_pattern,
+                           PassAux aux, double* partial) {
+    const size_t i = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+    double sum = 0.0;
+    if (i < capacity) {
+        double state = c.integrator_state[i];
+        const double feedback = c.feedback_gain[i];
+        const double gain = c.input_gain[i];
+        const double tc = c.time_constant[i];
+        const double mix = c.spectral_mix[i];
+        double out = 0.0;
+        for (int pass = 0; pass < 10; pass++) {
+            const double control = control_pattern + sin(static_cast<double>(i + pass) * 0.1) * 0.3;
+            const double amp = input * control;
+            state = fma(amp * gain - state, tc, state);
+            const float boost = spectral(static_cast<float>(amp + aux.values[pass]));
+            out = clampOutput(c, i, fma(static_cast<double>(boost), mix, fma(state, feedback, state)));
+            if (i < size) sum += out;
+        }
+        c.integrator_state[i] = state;
+        c.current_output[i] = out;
+        c.previous_input[i] = input;
+    }
+    blockSum(sum, partial);
+}
+
+__global__ void missionKernel(Columns c, size_t capacity, double input, double control, int repeats) {
+    const size_t i = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (i >= capacity) return;
+    const double amp = input * control;
+    const double boost = static_cast<double>(spectral(static_cast<float>(amp)));
+    double state = c.integrator_state[i];
+    const double feedback = c.feedback_gain[i];
+    const double node_amp = amp * c.input_gain[i];
+    const double tc = c.time_constant[i];
+    for (int r = 0; r < repeats; r++) state = fma(node_amp - state, tc, state);
+    c.integrator_state[i] = state;
+    c.current_output[i] = clampOutput(c, i, fma(boost, c.spectral_mix[i], fma(state, feedback, state)));
+    c.previous_input[i] = input;
+}
+
+__global__ void missionScheduleKernel(Columns c, size_t capacity, const double* amplified, const float* boost,
+                                      size_t steps, int repeats, double last_input) {
+    const size_t i = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (i >= capacity) return;
+    double state = c.integrator_state[i];
+    const double gain = c.input_gain[i];
+    const double tc = c.time_constant[i];
+    for (size_t s = 0; s < steps; s++) {
+        const double amp = amplified[s] * gain;
+        for (int r = 0; r < repeats; r++) state = fma(amp - state, tc, state);
+    }
+    c.integrator_state[i] = state;
+    c.current_output[i] = clampOutput(c, i, fma(static_cast<double>(boost[steps - 1]), c.spectral_mix[i],
+                                                 fma(state, c.feedback_gain[i], state)));
+    c.previous_input[i] = last_input;
+}
+
+// Outputs go time-major ([n x capacity]) so the stores coalesce
+__global__ void blockKernel(Columns c, size_t capacity, const double* amplified, const float* boost,
+                            float last_input, float* time_major, size_t n) {
+    const size_t i = static_cast<size_t>(blockIdx.x) * blockDim.x + threadIdx.x;
+    if (i >= capacity) return;
+    double state = c.integrator_state[i];
+    const double gain = 1.0 + c.feedback_gain[i];
+    const double in_gain = c.input_gain[i];
+    const double tc = c.time_constant[i];
+    const double mix = c.spectral_mix[i];
+    double out = c.current_output[i];
+    for (size_t t = 0; t < n; t++) {
+        state = fma(amplified[t] * in_gain - state, tc, state);
+        out = clampOutput(c, i, fma(state, gain, static_cast<double>(boost[t]) * mix));
+        if (time_major) time_major[t * capacity + i] = static_cast<float>(out);
+    }
+    c.integrator_state[i] = state;
+    c.current_output[i] = out;
+    c.previous_input[i] = last_input;
+}
+
+// [n x capacity] -> node-major [size x n], one kTile x kTile tile per block
+__global__ void transposeKernel(const float* time_major, float* node_major, size_t size, size_t capacity,
+                                size_t n) {
+    __shared__ float tile[kTile][kTile + 1];
+    const size_t node0 = static_cast<size_t>(blockIdx.x) * kTile;
+    const size_t t0 = static_cast<size_t>(blockIdx.y) * kTile;
+    for (unsigned row = threadIdx.y; row < kTile; row += blockDim.y) {
+        const size_t t = t0 + row;
+        const size_t node = node0 + threadIdx.x;
+        if (t < n && node < size) tile[row][threadIdx.x] = time_major[t * capacity + node];
+    }
+    __syncthreads();
+    for (unsigned row = threadIdx.y; row < kTile; row += blockDim.y) {
+        const size_t node = node0 + row;
+        const size_t t = t0 + threadIdx.x;
+        if (t < n && node < size) node_major[node * n + t] = tile[threadIdx.x][row];
+    }
+}
+
+unsigned gridFor(size_t count) { return static_cast<unsigned>((count + kThreads - 1) / kThreads); }
+
+}  // namespace
+
+// Device buffers grow to the largest call seen and are kept
+struct GpuNodeBank::Device {
+    size_t size = 0;
+    size_t capacity = 0;
+    int ordinal = 0;
+    cudaStream_t stream = nullptr;
+    double* state = nullptr;         // The state then parameter columns, back to back
+    double* partial = nullptr;       // Per-thread-block sums of a sweep
+    double* partial_host = nullptr;  // Pinned
+    // Per-call streams: amplified doubles then boost floats
+    unsigned char* inputs = nullptr;
+    unsigned char* inputs_host = nullptr;  // Pinned
+    size_t inputs_bytes = 0;
+    float* time_major = nullptr;
+    float* node_major = nullptr;
+    size_t output_floats = 0;
+
+    Columns columns() const {
+        return {state, state + capacity, state + 2 * capacity, state + 3 * capacity, state + 4 * capacity,
+                state + 5 * capacity, state + 6 * capacity, state + 7 * capacity, state + 8 * capacity};
+    }
+
+    // Stages amplified and boost (n each) and queues their upload
+    void stageInputs(const double* amplified, const float* boost, size_t n) {
+        const size_t bytes = n * (sizeof(double) + sizeof(float));
+        if (bytes > inputs_bytes) {
+            check(cudaStreamSynchronize(stream), "synchronize");
+            cudaFree(inputs);
+            cudaFreeHost(inputs_host);
+            inputs = nullptr;
+            inputs_host = nullptr;
+            inputs_bytes = 0;
+            check(cudaMalloc(&inputs, bytes), "allocate block inputs");
+            check(cudaMallocHost(&inputs_host, bytes), "allocate pinned block inputs");
+            inputs_bytes = bytes;
+        }
+        std::memcpy(inputs_host, amplified, n * sizeof(double));
+        std::memcpy(inputs_host + n * sizeof(double), boost, n * sizeof(float));
+        check(cudaMemcpyAsync(inputs, inputs_host, bytes, cudaMemcpyHostToDevice, stream), "upload block inputs");
+    }
+
+    void reserveOutputs(size_t floats) {
+        if (floats <= output_floats) return;
+        check(cudaStreamSynchronize(stream), "synchronize");
+        cudaFree(time_major);
+        cudaFree(node_major);
+        time_major = nullptr;
+        node_major = nullptr;
+        output_floats = 0;
+        check(cudaMalloc(&time_major, floats * sizeof(float)), "allocate block outputs");
+        check(cudaMalloc(&node_major, floats * sizeof(float)), "allocate block outputs");
+        output_floats = floats;
+    }
+
+    ~Device() {
+        if (stream) cudaStreamSynchronize(stream);
+        cudaFree(state);
+        cudaFree(partial);
+        cudaFreeHost(partial_host);
+        cudaFree(inputs);
+        cudaFreeHost(inputs_host);
+        cudaFree(time_major);
+        cudaFree(node_major);
+        if (stream) cudaStreamDestroy(stream);
+    }
+};
+
+bool GpuNodeBank::available() {
+    int count = 0;
+    return cudaGetDeviceCount(&count) == cudaSuccess && count > 0;
+}
+
+std::string GpuNodeBank::deviceName() {
+    int device = 0;
+    cudaDeviceProp prop;
+    if (!available() || cudaGetDevice(&device) != cudaSuccess ||
+        cudaGetDeviceProperties(&prop, device) != cudaSuccess) {
+        return "none (no CUDA device)";
+    }
+    return prop.name;
+}
+
+GpuNodeBank::GpuNodeBank(size_t num_nodes) : device_(new Device()) {
+    if (!available()) throw std::runtime_error("CUDA backend unavailable: no CUDA device");
+    Device& d = *device_;
+    d.size = num_nodes;
+    d.capacity = NodeBank::paddedCount(num_nodes);
+    check(cudaGetDevice(&d.ordinal), "query device");
+    check(cudaStreamCreateWithFlags(&d.stream, cudaStreamNonBlocking), "create stream");
+    check(cudaMalloc(&d.state, kColumns * d.capacity * sizeof(double)), "allocate node columns");
+    const size_t blocks = gridFor(d.capacity);
+    check(cudaMalloc(&d.partial, blocks * sizeof(double)), "allocate sweep sums");
+    check(cudaMallocHost(&d.partial_host, blocks * sizeof(double)), "allocate pinned sweep sums");
+}
+
+GpuNodeBank::~GpuNodeBank() = default;
+
+size_t GpuNodeBank::size() const { return device_->size; }
+
+double* GpuNodeBank::deviceColumns() const { return device_->state; }
+
+int GpuNodeBank::deviceOrdinal() const { return device_->ordinal; }
+
+// The bank's columns are contiguous from integrator_state on. The kernels
+// only write the state columns, so only those come back.
+void GpuNodeBank::upload(const NodeBank& bank) {
+    Device& d = *device_;
+    if (bank.size() != d.size) throw std::invalid_argument("node bank size differs from the device bank");
+    check(cudaMemcpyAsync(d.state, bank.integrator_state, kColumns * d.capacity * sizeof(double), cudaMemcpyHostToDevice,
+                          d.stream), "upload node columns");
+    check(cudaStreamSynchronize(d.stream), "upload node columns");
+}
+
+void GpuNodeBank::download(NodeBank& bank) {
+    Device& d = *device_;
+    if (bank.size() != d.size) throw std::invalid_argument("node bank size differs from the device bank");
+    check(cudaMemcpyAsync(bank.integrator_state, d.state, kStateColumns * d.capacity * sizeof(double), cudaMemcpyDeviceToHost,
+                          d.stream), "download node columns");
+    check(cudaStreamSynchronize(d.stream), "download node columns");
+}
+
+double GpuNodeBank::waveSweep(double input_signal, double control_pattern, const double* pass_aux) {
+    Device& d = *device_;
+    if (d.capacity == 0) return 0.0;
+    PassAux aux;
+    std::memcpy(aux.values, pass_aux, sizeof(aux.values));
+    const unsigned blocks = gridFor(d.capacity);
+    waveKernel<<<blocks, kThreads, 0, d.stream>>>(d.columns(), d.size, d.capacity, input_signal, control_pattern,
+                                                  aux, d.partial);
+    check(cudaGetLastError(), "wave sweep");
+    check(cudaMemcpyAsync(d.partial_host, d.partial, blocks * sizeof(double), cudaMemcpyDeviceToHost, d.stream),
+          "download sweep sums");
+    check(cudaStreamSynchronize(d.stream), "wave sweep");
+    double total = 0.0;
+    for (unsigned b = 0; b < blocks; b++) total += d.partial_host[b];
+    return total;
+}
+
+// Queued without a wait; the next call that reads results back syncs
+void GpuNodeBank::missionStep(double input_signal, double control_signal, int repeats) {
+    Device& d = *device_;
+    if (d.capacity == 0) return;
+    missionKernel<<<gridFor(d.capacity), kThreads, 0, d.stream>>>(d.columns(), d.capacity, input_signal,
+                                                                    control_signal, repeats);
+    check(cudaGetLastError(), "mission step");
+}
+
+void GpuNodeBank::missionSchedule(const double* amplified, const float* boost, size_t steps, int repeats,
+                                  double last_input) {
+    Device& d = *device_;
+    if (d.capacity == 0 || steps == 0 || repeats <= 0) return;
+    d.stageInputs(amplified, boost, steps);
+    const double* amp = reinterpret_cast<const double*>(d.inputs);
+    const float* bst = reinterpret_cast<const float*>(d.inputs + steps * sizeof(double));
+    missionScheduleKernel<<<gridFor(d.capacity), kThreads, 0, d.stream>>>(d.columns(), d.capacity, amp, bst, steps,
+                                                                            repeats, last_input);
+    check(cudaGetLastError(), "mission schedule");
+    // The staging buffer is refilled by the next tile
+    check(cudaStreamSynchronize(d.stream), "mission schedule");
+}
+
+void GpuNodeBank::block(const double* amplified, const float* boost, float last_input, float* out, size_t n) {
+    Device& d = *device_;
+    if (d.capacity == 0 || n == 0) return;
+    d.stageInputs(amplified, boost, n);
+    const double* amp = reinterpret_cast<const double*>(d.inputs);
+    const float* bst = reinterpret_cast<const float*>(d.inputs + n * sizeof(double));
+    if (out) d.reserveOutputs(d.capacity * n);
+    blockKernel<<<gridFor(d.capacity), kThreads, 0, d.stream>>>(d.columns(), d.capacity, amp, bst, last_input,
+                                                                  out ? d.time_major : nullptr, n);
+    check(cudaGetLastError(), "block");
+    if (out && d.size > 0) {
+        const dim3 grid(static_cast<unsigned>((d.size + kTile - 1) / kTile), static_cast<unsigned>((n + kTile - 1) / kTile));
+        transposeKernel<<<grid, dim3(kTile, 8), 0, d.stream>>>(d.time_major, d.node_major, d.size, d.capacity, n);
+        check(cudaGetLastError(), "block transpose");
+        check(cudaMemcpyAsync(out, d.node_major, d.size * n * sizeof(float), cudaMemcpyDeviceToHost, d.stream),
+              "download block outputs");
+    }
+    check(cudaStreamSynchronize(d.stream), "block");
+}
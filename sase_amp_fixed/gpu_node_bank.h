@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include "node_bank.h"
+
+// Where the engine's wave sweeps, mission steps and blocks run
+enum class ComputeBackend {
+    Cpu = 0,   // Node kernels on the worker pool
+    Cuda = 1   // GpuNodeBank (builds with DASE_WITH_CUDA only)
+};
+
+// Device-resident copy of a NodeBank's state and parameter columns, with
+// the engine's double-precision node kernels ported to CUDA.
+//
+// The columns live on the device in the bank's own SoA layout, so upload()
+// and download() are one copy each; download() brings back only the four
+// state columns, which are all the kernels write. Every call queues its work
+// on one stream: a block's amplified and boost streams or a mission tile's
+// schedule go up through pinned staging in one asynchronous copy (a sweep's
+// inputs travel as kernel arguments), the kernel runs one thread per node,
+// and only the result (a sweep's per-thread-block partial sums, a block's
+// outputs) comes back. State stays on the device between calls.
+//
+// The kernels follow the Full pipeline of NodeKernels::wave_f64, mission_f64,
+// mission_schedule_f64 and block_f64 step for step, but the spectral boost
+// uses the device's sinf rather than the host polynomial, so outputs agree
+// with the CPU path to float rounding rather than bit for bit.
+//
+// Without DASE_WITH_CUDA, available() is false and the constructor throws
+// std::runtime_error.
+class GpuNodeBank {
+public:
+    // True when built with CUDA and a device is present
+    static bool available();
+    // Name of the device in use, or why there is none
+    static std::string deviceName();
+
+    // Device columns for capacity() slots of a bank of num_nodes nodes.
+    // Throws std::runtime_error when no device is available or allocation
+    // fails.
+    explicit GpuNodeBank(size_t num_nodes);
+    ~GpuNodeBank();
+    GpuNodeBank(const GpuNodeBank&) = delete;
+    GpuNodeBank& operator=(const GpuNodeBank&) = delete;
+
+    size_t size() const;
+
+    // Copies every column to the device / the state columns back; bank must
+    // hold size() nodes. Both wait for the copy.
+    void upload(const NodeBank& bank);
+    void download(NodeBank& bank);
+
+    // NodeKernels::wave_f64 over every node; returns the sum of outputs
+    double waveSweep(double input_signal, double control_pattern, const double* pass_aux);
+    // NodeKernels::mission_f64 over every node
+    void missionStep(double input_signal, double control_signal, int repeats);
+    // NodeKernels::mission_schedule_f64 over every node
+    void missionSchedule(const double* amplified, const float* boost, size_t steps, int repeats,
+                         double last_input);
+    // NodeKernels::block_f64 over every node; out (node-major, may be null)
+    // receives the outputs
+    void block(const double* amplified, const float* boost, float last_input, float* out, size_t n);
+
+    // Device copy of the bank's columns, at the same offsets from the
+    // returned pointer as from bank.integrator_state, for zero-copy export
+    // (DLPack). Every call above has finished on the device when it returns,
+    // so the columns are idle between calls.
+    double* deviceColumns() const;
+    // CUDA ordinal of the device holding them
+    int deviceOrdinal() const;
+
+private:
+    struct Device;
+    std::unique_ptr<Device> device_;
+};
@@ -0,0 +1,301 @@
+#include "grid_coupling.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+void GridIndex::build(const GridShape& shape, size_t count) {
+    if (shape.nx == 0 || shape.ny == 0) throw std::invalid_argument("grid nx and ny must be at least 1");
+    const size_t plane = shape.nx * shape.ny;
+    const size_t nz = shape.nz != 0 ? shape.nz : std::max<size_t>(1, (count + plane - 1) / plane);
+    if (plane * nz < count) throw std::invalid_argument("grid shape holds fewer cells than the engine has nodes");
+
+    codes_.clear();
+    nodes_.clear();
+    dense_ = false;
+    if (shape.order == GridOrder::Morton) {
+        if (shape.nx > kMaxMortonSide || shape.ny > kMaxMortonSide || nz > kMaxMortonSide) {
+            throw std::invalid_argument("Morton grid sides are limited to 2^21 cells");
+        }
+        const size_t cells = plane * nz;
+        if (cells >= kEmpty) throw std::invalid_argument("Morton grid has too many cells");
+        std::vector<uint64_t> codes(cells);
+        size_t c = 0;
+        for (uint32_t z = 0; z < nz; z++) {
+            for (uint32_t y = 0; y < shape.ny; y++) {
+                for (uint32_t x = 0; x < shape.nx; x++) codes[c++] = mortonEncode(x, y, z);
+            }
+        }
+        // The first count cells along the curve get the nodes, in order
+        std::sort(codes.begin(), codes.end());
+        codes.resize(count);
+        codes.shrink_to_fit();
+        dense_ = count == 0 || codes[count - 1] == count - 1;
+        if (dense_) {
+            shape_ = shape;
+            nz_ = nz;
+            count_ = count;
+            return;
+        }
+        nodes_.assign(cells, kEmpty);
+        for (size_t i = 0; i < count; i++) {
+            uint32_t x, y, z;
+            mortonDecode(codes[i], x, y, z);
+            nodes_[x + shape.nx * (y + shape.ny * static_cast<size_t>(z))] = static_cast<uint32_t>(i);
+        }
+        codes_ = std::move(codes);
+    }
+    shape_ = shape;
+    nz_ = nz;
+    count_ = count;
+}
+
+// One x-row of the face stencil. Interior nodes take the unchecked path.
+static void face6Row(const double* in, double* out, size_t count, const GridShape& g,
+                     size_t y, size_t z, double strength) {
+    const size_t plane = g.nx * g.ny;
+    const size_t row = g.nx * (y + g.ny * z);
+    const bool interior_yz = y > 0 && y + 1 < g.ny && z > 0 && row + g.nx + plane <= count;
+
+    for (size_t x = 0; x < g.nx; x++) {
+        const size_t i = row + x;
+        if (i >= count) return;
+
+        double sum = 0.0;
+        int n = 0;
+        if (interior_yz && x > 0 && x + 1 < g.nx) {
+            sum = (in[i - 1] + in[i + 1]) + (in[i - g.nx] + in[i + g.nx]) + (in[i - plane] + in[i + plane]);
+            n = 6;
+        } else {
+            if (x > 0) { sum += in[i - 1]; n++; }
+            if (x + 1 < g.nx && i + 1 < count) { sum += in[i + 1]; n++; }
+            if (y > 0) { sum += in[i - g.nx]; n++; }
+            if (y + 1 < g.ny && i + g.nx < count) { sum += in[i + g.nx]; n++; }
+            if (z > 0) { sum += in[i - plane]; n++; }
+            if (i + plane < count) { sum += in[i + plane]; n++; }
+        }
+        out[i] = n > 0 ? in[i] + strength * (sum / n - in[i]) : in[i];
+    }
+}
+
+// One x-row of the 26-neighbour stencil
+static void full26Row(const double* in, double* out, size_t count, const GridShape& g,
+                      size_t y, size_t z, size_t nz, double strength) {
+    const size_t plane = g.nx * g.ny;
+    const size_t row = g.nx * (y + g.ny * z);
+
+    for (size_t x = 0; x < g.nx; x++) {
+        const size_t i = row + x;
+        if (i >= count) return;
+
+        double sum = 0.0;
+        int n = 0;
+        for (int dz = -1; dz <= 1; dz++) {
+            if ((dz < 0 && z == 0) || (dz > 0 && z + 1 >= nz)) continue;
+            for (int dy = -1; dy <= 1; dy++) {
+                if ((dy < 0 && y == 0) || (dy > 0 && y + 1 >= g.ny)) continue;
+                for (int dx = -1; dx <= 1; dx++) {
+                    if ((dx < 0 && x == 0) || (dx > 0 && x + 1 >= g.nx)) continue;
+                    if (dx == 0 && dy == 0 && dz == 0) continue;
+                    const size_t j = i + static_cast<ptrdiff_t>(dx) + static_cast<ptrdiff_t>(dy) * g.nx +
+                                     static_cast<ptrdiff_t>(dz) * plane;
+                    if (j >= count) continue;
+                    sum += in[j];
+                    n++;
+                }
+            }
+        }
+        out[i] = n > 0 ? in[i] + strength * (sum / n - in[i]) : in[i];
+    }
+}
+
+// One x-row of a slab whose neighbouring planes are given: lower and upper
+// are the planes before and after mid (null for none), out the slab's output
+static void haloRow(const double* lower, const double* mid, const double* upper, double* out, size_t nx,
+                    size_t ny, size_t y, GridStencil stencil, double strength) {
+    const size_t row = nx * y;
+    const bool interior = lower && upper && y > 0 && y + 1 < ny;
+
+    for (size_t x = 0; x < nx; x++) {
+        const size_t i = row + x;
+        double sum = 0.0;
+        int n = 0;
+        if (stencil == GridStencil::Face6) {
+            if (interior && x > 0 && x + 1 < nx) {
+                sum = (mid[i - 1] + mid[i + 1]) + (mid[i - nx] + mid[i + nx]) + (lower[i] + upper[i]);
+                n = 6;
+            } else {
+                if (x > 0) { sum += mid[i - 1]; n++; }
+                if (x + 1 < nx) { sum += mid[i + 1]; n++; }
+                if (y > 0) { sum += mid[i - nx]; n++; }
+                if (y + 1 < ny) { sum += mid[i + nx]; n++; }
+                if (lower) { sum += lower[i]; n++; }
+                if (upper) { sum += upper[i]; n++; }
+            }
+        } else {
+            const double* planes[3] = {lower, mid, upper};
+            for (int dz = 0; dz < 3; dz++) {
+                const double* p = planes[dz];
+                if (!p) continue;
+                for (int dy = -1; dy <= 1; dy++) {
+                    if ((dy < 0 && y == 0) || (dy > 0 && y + 1 >= ny)) continue;
+                    for (int dx = -1; dx <= 1; dx++) {
+                        if ((dx < 0 && x == 0) || (dx > 0 && x + 1 >= nx)) continue;
+                        if (dx == 0 && dy == 0 && dz == 1) continue;
+                        sum += p[i + static_cast<ptrdiff_t>(dx) + static_cast<ptrdiff_t>(dy) * nx];
+                        n++;
+                    }
+                }
+            }
+        }
+        out[i] = n > 0 ? mid[i] + strength * (sum / n - mid[i]) : mid[i];
+    }
+}
+
+// Nodes [begin, end) of a Morton grid, any stencil: the cells around each
+// node looked up in the index
+static void mortonRange(const double* in, double* out, const GridIndex& grid, size_t begin, size_t end,
+                        GridStencil stencil, double strength) {
+    for (size_t i = begin; i < end; i++) {
+        size_t x, y, z;
+        grid.cell(i, x, y, z);
+        double sum = 0.0;
+        int n = 0;
+        for (int dz = -1; dz <= 1; dz++) {
+            for (int dy = -1; dy <= 1; dy++) {
+                for (int dx = -1; dx <= 1; dx++) {
+                    const int distance = (dx != 0) + (dy != 0) + (dz != 0);
+                    if (distance == 0 || (stencil == GridStencil::Face6 && distance > 1)) continue;
+                    // Wraps below 0 to a side the index rejects
+                    const uint32_t j = grid.node(x + dx, y + dy, z + dz);
+                    if (j == GridIndex::kEmpty) continue;
+                    sum += in[j];
+                    n++;
+                }
+            }
+        }
+        out[i] = n > 0 ? in[i] + strength * (sum / n - in[i]) : in[i];
+    }
+}
+
+// Nodes [begin, end) of a dense Morton grid, where a node is its cell's
+// code: the neighbour codes come from dilated adds on the node's own code,
+// one axis at a time, with no table and no re-encoding
+static void mortonDenseRange(const double* in, double* out, const GridIndex& grid, size_t begin, size_t end,
+                             GridStencil stencil, double strength) {
+    constexpr uint64_t kAxis[3] = {0x1249249249249249ULL, 0x2492492492492492ULL, 0x4924924924924924ULL};
+    const GridShape& shape = grid.shape();
+    const size_t side[3] = {shape.nx, shape.ny, grid.nz()};
+    const uint64_t count = grid.count();
+
+    for (size_t i = begin; i < end; i++) {
+        const uint64_t code = i;
+        uint32_t at[3];
+        GridIndex::mortonDecode(code, at[0], at[1], at[2]);
+        // Per axis the bits of the cell before, at and after, 0 flagging none
+        uint64_t part[3][3];
+        bool has[3][3];
+        for (int a = 0; a < 3; a++) {
+            const uint64_t bits = code & kAxis[a];
+            part[a][1] = bits;
+            has[a][1] = true;
+            has[a][0] = at[a] > 0;
+            part[a][0] = (bits - 1) & kAxis[a];
+            has[a][2] = at[a] + 1 < side[a];
+            part[a][2] = ((bits | ~kAxis[a]) + 1) & kAxis[a];
+        }
+
+        double sum = 0.0;
+        int n = 0;
+        for (int dz = 0; dz < 3; dz++) {
+            if (!has[2][dz]) continue;
+            for (int dy = 0; dy < 3; dy++) {
+                if (!has[1][dy]) continue;
+                for (int dx = 0; dx < 3; dx++) {
+                    if (!has[0][dx]) continue;
+                    const int distance = (dx != 1) + (dy != 1) + (dz != 1);
+                    if (distance == 0 || (stencil == GridStencil::Face6 && distance > 1)) continue;
+                    const uint64_t j = part[0][dx] | part[1][dy] | part[2][dz];
+                    if (j >= count) continue;
+                    sum += in[j];
+                    n++;
+                }
+            }
+        }
+        out[i] = n > 0 ? in[i] + strength * (sum / n - in[i]) : in[i];
+    }
+}
+
+void GridCoupling::apply(WorkerPool& pool, double* output, const GridIndex& grid, GridStencil stencil,
+                         double strength) {
+    const size_t count = grid.count();
+    if (stencil == GridStencil::None || count == 0 || strength == 0.0) return;
+
+    if (grid.order() == GridOrder::Morton) {
+        scratch_.resize(count);
+        const double* in = output;
+        double* out = scratch_.data();
+        const size_t per_worker = (count + pool.size() - 1) / pool.size();
+        const size_t grain = std::max<size_t>(1, std::min(kTileBytes / sizeof(double), per_worker));
+        pool.parallelFor(count, grain, [&](size_t begin, size_t end, unsigned) {
+            if (grid.dense()) {
+                mortonDenseRange(in, out, grid, begin, end, stencil, strength);
+            } else {
+                mortonRange(in, out, grid, begin, end, stencil, strength);
+            }
+        });
+        std::memcpy(output, scratch_.data(), count * sizeof(double));
+        return;
+    }
+
+    const GridShape& shape = grid.shape();
+    const size_t plane = shape.nx * shape.ny;
+    const size_t nz = (count + plane - 1) / plane;
+    scratch_.resize(count);
+    const double* in = output;
+    double* out = scratch_.data();
+
+    // A tile of slabs plus one halo slab on each side should fit kTileBytes
+    const size_t slab_bytes = plane * sizeof(double);
+    const size_t slabs_per_tile = std::max<size_t>(1, kTileBytes / slab_bytes - 2);
+    const size_t per_worker = (nz + pool.size() - 1) / pool.size();
+    const size_t grain = std::max<size_t>(1, std::min(slabs_per_tile, per_worker));
+
+    pool.parallelFor(nz, grain, [&](size_t z_begin, size_t z_end, unsigned) {
+        for (size_t z = z_begin; z < z_end; z++) {
+            for (size_t y = 0; y < shape.ny; y++) {
+                if (stencil == GridStencil::Face6) {
+                    face6Row(in, out, count, shape, y, z, strength);
+                } else {
+                    full26Row(in, out, count, shape, y, z, nz, strength);
+                }
+            }
+        }
+    });
+
+    std::memcpy(output, scratch_.data(), count * sizeof(double));
+}
+
+void GridCoupling::applySlabs(WorkerPool& pool, const double* in, double* out, size_t nx, size_t ny, size_t nz,
+                              const double* below, const double* above, size_t z_begin, size_t z_end,
+                              GridStencil stencil, double strength) {
+    if (z_begin >= z_end) return;
+    const size_t plane = nx * ny;
+    if (stencil == GridStencil::None || strength == 0.0) {
+        std::memcpy(out + z_begin * plane, in + z_begin * plane, (z_end - z_begin) * plane * sizeof(double));
+        return;
+    }
+    const size_t slab_bytes = plane * sizeof(double);
+    const size_t slabs_per_tile = std::max<size_t>(1, kTileBytes / slab_bytes - 2);
+    const size_t per_worker = (z_end - z_begin + pool.size() - 1) / pool.size();
+    const size_t grain = std::max<size_t>(1, std::min(slabs_per_tile, per_worker));
+
+    pool.parallelFor(z_end - z_begin, grain, [&](size_t begin, size_t end, unsigned) {
+        for (size_t z = z_begin + begin; z < z_begin + end; z++) {
+            const double* lower = z > 0 ? in + (z - 1) * plane : below;
+            const double* upper = z + 1 < nz ? in + (z + 1) * plane : above;
+            for (size_t y = 0; y < ny; y++) {
+                haloRow(lower, in + z * plane, upper, out + z * plane, nx, ny, y, stencil, strength);
+            }
+        }
+    });
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "worker_pool.h"
+
+// Neighbourhood of the 3-D coupling stencil
+enum class GridStencil {
+    None = 0,    // Coupling disabled
+    Face6 = 6,   // +-x, +-y, +-z neighbours
+    Full26 = 26  // Every node of the surrounding 3x3x3 block
+};
+
+// Order of the nodes over the grid cells
+enum class GridOrder {
+    Linear = 0,  // Node i at x = i % nx, y = (i / nx) % ny, z = i / (nx * ny)
+    Morton = 1   // Cells by Z-order code, the bits of x, y and z interleaved: grid
+                 // neighbours are mostly a few cache lines apart in every direction
+};
+
+// Node grid. nz = 0 means "as many slabs as the node count needs".
+struct GridShape {
+    size_t nx = 10;
+    size_t ny = 10;
+    size_t nz = 0;
+    GridOrder order = GridOrder::Linear;
+};
+
+// Mapping between nodes and the cells of a grid shape for a node count.
+//
+// Linear grids are arithmetic. Morton grids give the nodes the cells of the
+// nx x ny x nz box in ascending Morton code, skipping codes outside it, so
+// the first count cells of the curve are the occupied ones; they keep each
+// node's code (8 bytes a node) and the node of every cell (4 bytes a cell),
+// unless the codes of the occupied cells run from 0 without a gap.
+class GridIndex {
+public:
+    static constexpr uint32_t kEmpty = UINT32_MAX;  // Cell without a node
+    static constexpr size_t kMaxMortonSide = size_t(1) << 21;
+
+    // Throws std::invalid_argument if nx or ny is 0, the grid holds fewer
+    // cells than count, or a Morton side exceeds kMaxMortonSide or the
+    // cells overflow 32-bit node numbers
+    void build(const GridShape& shape, size_t count);
+
+    GridOrder order() const { return shape_.order; }
+    const GridShape& shape() const { return shape_; }
+    size_t count() const { return count_; }
+    size_t nz() const { return nz_; }  // Resolved, never 0 once built with nodes
+
+    void cell(size_t node, size_t& x, size_t& y, size_t& z) const {
+        if (shape_.order == GridOrder::Morton) {
+            uint32_t cx, cy, cz;
+            mortonDecode(dense_ ? node : codes_[node], cx, cy, cz);
+            x = cx;
+            y = cy;
+            z = cz;
+        } else {
+            x = node % shape_.nx;
+            y = node / shape_.nx % shape_.ny;
+            z = node / (shape_.nx * shape_.ny);
+        }
+    }
+    // kEmpty outside the grid or past the node count
+    uint32_t node(size_t x, size_t y, size_t z) const {
+        if (x >= shape_.nx || y >= shape_.ny || z >= nz_) return kEmpty;
+        if (dense_) {
+            const uint64_t code = mortonEncode(static_cast<uint32_t>(x), static_cast<uint32_t>(y),
+                                               static_cast<uint32_t>(z));
+            return code < count_ ? static_cast<uint32_t>(code) : kEmpty;
+        }
+        const size_t linear = x + shape_.nx * (y + shape_.ny * z);
+        if (shape_.order == GridOrder::Morton) return nodes_[linear];
+        return linear < count_ ? static_cast<uint32_t>(linear) : kEmpty;
+    }
+    // Morton grid whose nodes are their own codes (power-of-two cubes and
+    // the like): lookups need no table
+    bool dense() const { return dense_; }
+
+    static uint64_t mortonEncode(uint32_t x, uint32_t y, uint32_t z) {
+        return spread(x) | (spread(y) << 1) | (spread(z) << 2);
+    }
+    static void mortonDecode(uint64_t code, uint32_t& x, uint32_t& y, uint32_t& z) {
+        x = compact(code);
+        y = compact(code >> 1);
+        z = compact(code >> 2);
+    }
+
+private:
+    // 21 bits to every third bit of 63, and back
+    static uint64_t spread(uint32_t v) {
+        uint64_t b = v & 0x1fffff;
+        b = (b | b << 32) & 0x1f00000000ffffULL;
+        b = (b | b << 16) & 0x1f0000ff0000ffULL;
+        b = (b | b << 8) & 0x100f00f00f00f00fULL;
+        b = (b | b << 4) & 0x10c30c30c30c30c3ULL;
+        b = (b | b << 2) & 0x1249249249249249ULL;
+        return b;
+    }
+    static uint32_t compact(uint64_t b) {
+        b &= 0x1249249249249249ULL;
+        b = (b ^ (b >> 2)) & 0x10c30c30c30c30c3ULL;
+        b = (b ^ (b >> 4)) & 0x100f00f00f00f00fULL;
+        b = (b ^ (b >> 8)) & 0x1f0000ff0000ffULL;
+        b = (b ^ (b >> 16)) & 0x1f00000000ffffULL;
+        b = (b ^ (b >> 32)) & 0x1fffffULL;
+        return static_cast<uint32_t>(b);
+    }
+
+    GridShape shape_;
+    bool dense_ = false;
+    size_t nz_ = 0;
+    size_t count_ = 0;
+    std::vector<uint64_t> codes_;  // Morton: code of each node's cell
+    std::vector<uint32_t> nodes_;  // Morton: node of each cell, x fastest
+};
+
+// Jacobi-style diffusion step over a node output column laid out on a grid.
+//
+// Each node moves toward the mean of its existing neighbours:
+//   out'[i] = out[i] + strength * (mean(out[j], j in N(i)) - out[i])
+// Nodes on the grid boundary (or past the node count in the last slab) simply
+// have fewer neighbours. All reads come from the previous state and writes go
+// to a scratch column that is copied back afterwards, so the step is
+// order-independent and the pool can split it freely. Linear grids are handed
+// out in tiles of whole z-slabs sized so a tile and its two halo slabs stay
+// in L2; Morton grids in runs of kTileBytes of nodes, whose neighbours lie
+// mostly within the run and the runs next to it, on any grid size.
+class GridCoupling {
+public:
+    static constexpr size_t kTileBytes = 256 * 1024;
+
+    // grid built for the node count of output
+    void apply(WorkerPool& pool, double* output, const GridIndex& grid, GridStencil stencil, double strength);
+
+    // Slabs [z_begin, z_end) of a Linear nx x ny x nz column of complete
+    // slabs, read from in and written to out. below and above are the
+    // planes next to slab 0 and slab nz - 1, null where the grid ends: the
+    // step of a slab range of a larger grid whose other slabs live elsewhere
+    // (see GridShard).
+    static void applySlabs(WorkerPool& pool, const double* in, double* out, size_t nx, size_t ny, size_t nz,
+                           const double* below, const double* above, size_t z_begin, size_t z_end,
+                           GridStencil stencil, double strength);
+
+private:
+    std::vector<double> scratch_;
+};
@@ -0,0 +1,447 @@
+#include "grid_shard.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define GRID_SHARD_SOCKETS 1
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+ShardSide opposite(ShardSide side) { return side == ShardSide::Below ? ShardSide::Above : ShardSide::Below; }
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// LoopbackHaloExchange
+
+class LoopbackHaloExchange::Endpoint : public HaloTransport {
+public:
+    Endpoint(LoopbackHaloExchange& hub, size_t rank) : hub_(hub), rank_(rank) {}
+
+    void send(ShardSide side, uint64_t step, const double* plane, size_t count) override {
+        if (side == ShardSide::Below ? rank_ == 0 : rank_ + 1 >= hub_.ranks()) return;
+        const size_t to = side == ShardSide::Below ? rank_ - 1 : rank_ + 1;
+        // What goes to the shard below arrives on its upper side
+        Mailbox& box = hub_.box(to, opposite(side));
+        {
+            std::lock_guard<std::mutex> lock(box.mutex);
+            box.plane[step & 1].assign(plane, plane + count);
+            box.step[step & 1] = step;
+        }
+        box.ready.notify_all();
+    }
+
+    bool receive(ShardSide side, uint64_t step, double* plane, size_t count,
+                 std::chrono::microseconds timeout) override {
+        Mailbox& box = hub_.box(rank_, side);
+        std::unique_lock<std::mutex> lock(box.mutex);
+        if (!box.ready.wait_for(lock, timeout, [&] { return box.step[step & 1] == step; })) return false;
+        const std::vector<double>& got = box.plane[step & 1];
+        if (got.size() != count) throw std::runtime_error("halo plane size differs between neighbouring shards");
+        std::copy(got.begin(), got.end(), plane);
+        return true;
+    }
+
+private:
+    LoopbackHaloExchange& hub_;
+    size_t rank_;
+};
+
+LoopbackHaloExchange::LoopbackHaloExchange(size_t ranks) {
+    if (ranks == 0) throw std::invalid_argument("halo exchange needs at least one shard");
+    boxes_.resize(ranks * 2);
+    for (auto& box : boxes_) box = std::make_unique<Mailbox>();
+}
+
+std::unique_ptr<HaloTransport> LoopbackHaloExchange::endpoint(size_t rank) {
+    if (rank >= ranks()) throw std::out_of_range("halo exchange has no shard " + std::to_string(rank));
+    return std::make_unique<Endpoint>(*this, rank);
+}
+
+// ---------------------------------------------------------------------------
+// UdpHaloTransport
+//
+// Datagram header, host byte order:
+//   0  uint32 magic        16 uint32 plane values
+//   4  uint8  side         20 uint32 offset of the first value
+//   5  3 bytes zero        24 uint32 values in this datagram
+//   8  uint64 step         28 uint32 zero
+
+namespace {
+
+constexpr uint32_t kHaloMagic = 0x4f4c4148;  // "HALO"
+
+struct HaloHeader {
+    uint32_t magic;
+    uint8_t side;
+    uint8_t reserved[3];
+    uint64_t step;
+    uint32_t total;
+    uint32_t offset;
+    uint32_t values;
+    uint32_t reserved2;
+};
+static_assert(sizeof(HaloHeader) == UdpHaloTransport::kHeaderBytes, "halo header layout");
+
+#ifdef GRID_SHARD_SOCKETS
+std::vector<unsigned char> resolvePeer(const std::string& host, uint16_t port) {
+    if (host.empty()) return {};
+    addrinfo hints = {};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found = nullptr;
+    const std::string service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &found) != 0 || !found) {
+        throw std::invalid_argument("halo neighbour " + host + ": cannot resolve");
+    }
+    const auto* begin = reinterpret_cast<const unsigned char*>(found->ai_addr);
+    std::vector<unsigned char> address(begin, begin + found->ai_addrlen);
+    freeaddrinfo(found);
+    return address;
+}
+#endif
+
+} // namespace
+
+UdpHaloTransport::UdpHaloTransport(const UdpHaloConfig& config) : config_(config) {
+    if (config.datagram_bytes < kHeaderBytes + sizeof(double)) {
+        throw std::invalid_argument("halo datagram must hold the header and at least one value");
+    }
+    chunk_ = (config.datagram_bytes - kHeaderBytes) / sizeof(double);
+#ifdef GRID_SHARD_SOCKETS
+    peer_[static_cast<size_t>(ShardSide::Below)] = resolvePeer(config.below_host, config.below_port);
+    peer_[static_cast<size_t>(ShardSide::Above)] = resolvePeer(config.above_host, config.above_port);
+
+    const int s = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    bool ok = s >= 0;
+    sockaddr_in address = {};
+    if (ok) {
+        const int buffer = static_cast<int>(std::min<size_t>(config.socket_buffer, INT32_MAX));
+        setsockopt(s, SOL_SOCKET, SO_RCVBUF, &buffer, sizeof(buffer));
+        setsockopt(s, SOL_SOCKET, SO_SNDBUF, &buffer, sizeof(buffer));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(config.port);
+        ok = ::bind(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+    }
+    socklen_t length = sizeof(address);
+    ok = ok && getsockname(s, reinterpret_cast<sockaddr*>(&address), &length) == 0;
+    if (!ok) {
+        if (s >= 0) ::close(s);
+        throw std::runtime_error("halo transport: cannot bind UDP port " + std::to_string(config.port));
+    }
+    socket_ = s;
+    port_ = ntohs(address.sin_port);
+    send_buffer_.resize(kBatch * (kHeaderBytes + chunk_ * sizeof(double)));
+    receive_buffer_.resize(kBatch * (kHeaderBytes + chunk_ * sizeof(double)));
+#else
+    throw std::runtime_error("halo transport: UDP needs POSIX sockets");
+#endif
+}
+
+UdpHaloTransport::~UdpHaloTransport() {
+#ifdef GRID_SHARD_SOCKETS
+    if (socket_ >= 0) ::close(static_cast<int>(socket_));
+#endif
+}
+
+void UdpHaloTransport::send(ShardSide side, uint64_t step, const double* plane, size_t count) {
+#ifdef GRID_SHARD_SOCKETS
+    const std::vector<unsigned char>& peer = peer_[static_cast<size_t>(side)];
+    if (peer.empty() || count == 0) return;
+    if (count > UINT32_MAX) throw std::runtime_error("halo plane too large for the datagram header");
+
+    const size_t slot = kHeaderBytes + chunk_ * sizeof(double);
+    const size_t datagrams = (count + chunk_ - 1) / chunk_;
+    HaloHeader header = {};
+    header.magic = kHaloMagic;
+    header.side = static_cast<uint8_t>(opposite(side));  // The side it arrives on
+    header.step = step;
+    header.total = static_cast<uint32_t>(count);
+
+    for (size_t first = 0; first < datagrams; first += kBatch) {
+        const size_t batch = std::min(kBatch, datagrams - first);
+        size_t sizes[kBatch];
+        for (size_t d = 0; d < batch; d++) {
+            const size_t offset = (first + d) * chunk_;
+            const size_t values = std::min(chunk_, count - offset);
+            header.offset = static_cast<uint32_t>(offset);
+            header.values = static_cast<uint32_t>(values);
+            unsigned char* out = send_buffer_.data() + d * slot;
+            std::memcpy(out, &header, kHeaderBytes);
+            std::memcpy(out + kHeaderBytes, plane + offset, values * sizeof(double));
+            sizes[d] = kHeaderBytes + values * sizeof(double);
+        }
+#ifdef __linux__
+        mmsghdr messages[kBatch];
+        iovec vectors[kBatch];
+        std::memset(messages, 0, sizeof(messages));
+        for (size_t d = 0; d < batch; d++) {
+            vectors[d].iov_base = send_buffer_.data() + d * slot;
+            vectors[d].iov_len = sizes[d];
+            messages[d].msg_hdr.msg_name = const_cast<unsigned char*>(peer.data());
+            messages[d].msg_hdr.msg_namelen = static_cast<socklen_t>(peer.size());
+            messages[d].msg_hdr.msg_iov = &vectors[d];
+            messages[d].msg_hdr.msg_iovlen = 1;
+        }
+        size_t done = 0;
+        while (done < batch) {
+            const int sent = ::sendmmsg(static_cast<int>(socket_), messages + done, static_cast<unsigned>(batch - done), 0);
+            if (sent < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error("halo transport: send failed");
+            }
+            done += static_cast<size_t>(sent);
+        }
+#else
+        for (size_t d = 0; d < batch; d++) {
+            ssize_t sent;
+            do {
+                sent = ::sendto(static_cast<int>(socket_), send_buffer_.data() + d * slot, sizes[d], 0,
+                                reinterpret_cast<const sockaddr*>(peer.data()), static_cast<socklen_t>(peer.size()));
+            } while (sent < 0 && errno == EINTR);
+            if (sent < 0) throw std::runtime_error("halo transport: send failed");
+        }
+#endif
+        datagrams_sent_ += batch;
+    }
+#else
+    (void)side;
+    (void)step;
+    (void)plane;
+    (void)count;
+#endif
+}
+
+void UdpHaloTransport::accept(const unsigned char* datagram, size_t size) {
+    datagrams_received_++;
+    HaloHeader header;
+    if (size < kHeaderBytes) {
+        datagrams_discarded_++;
+        return;
+    }
+    std::memcpy(&header, datagram, kHeaderBytes);
+    const size_t values = header.values;
+    const size_t offset = header.offset;
+    const size_t total = header.total;
+    const bool well_formed = header.magic == kHaloMagic && header.side < 2 && values > 0 &&
+                             size == kHeaderBytes + values * sizeof(double) && offset % chunk_ == 0 &&
+                             offset < total && values == std::min(chunk_, total - offset);
+    if (!well_formed || header.step < next_[header.side]) {
+        datagrams_discarded_++;
+        return;
+    }
+
+    Assembly& assembly = incoming_[header.side][header.step & 1];
+    if (assembly.step != header.step) {
+        // A later step of the same parity replaces an unfinished earlier one
+        if (assembly.step != UINT64_MAX && assembly.step > header.step) {
+            datagrams_discarded_++;
+            return;
+        }
+        assembly.step = header.step;
+        assembly.data.resize(total);
+        assembly.missing = (total + chunk_ - 1) / chunk_;
+        assembly.seen.assign(assembly.missing, 0);
+    } else if (assembly.data.size() != total) {
+        datagrams_discarded_++;
+        return;
+    }
+    const size_t index = offset / chunk_;
+    if (assembly.seen[index]) {
+        datagrams_discarded_++;
+        return;
+    }
+    std::memcpy(assembly.data.data() + offset, datagram + kHeaderBytes, values * sizeof(double));
+    assembly.seen[index] = 1;
+    assembly.missing--;
+}
+
+bool UdpHaloTransport::drain(int wait_ms) {
+#ifdef GRID_SHARD_SOCKETS
+    pollfd fd = {};
+    fd.fd = static_cast<int>(socket_);
+    fd.events = POLLIN;
+    if (::poll(&fd, 1, wait_ms) <= 0) return false;
+
+    const size_t slot = kHeaderBytes + chunk_ * sizeof(double);
+    for (;;) {
+#ifdef __linux__
+        mmsghdr messages[kBatch];
+        iovec vectors[kBatch];
+        std::memset(messages, 0, sizeof(messages));
+        for (size_t d = 0; d < kBatch; d++) {
+            vectors[d].iov_base = receive_buffer_.data() + d * slot;
+            vectors[d].iov_len = slot;
+            messages[d].msg_hdr.msg_iov = &vectors[d];
+            messages[d].msg_hdr.msg_iovlen = 1;
+        }
+        const int got = ::recvmmsg(static_cast<int>(socket_), messages, kBatch, MSG_DONTWAIT, nullptr);
+        if (got < 0 && errno == EINTR) continue;
+        if (got <= 0) return true;
+        for (int d = 0; d < got; d++) {
+            if (messages[d].msg_hdr.msg_flags & MSG_TRUNC) {
+                datagrams_received_++;
+                datagrams_discarded_++;
+                continue;
+            }
+            accept(receive_buffer_.data() + d * slot, messages[d].msg_len);
+        }
+        if (static_cast<size_t>(got) < kBatch) return true;
+#else
+        const ssize_t got = ::recv(static_cast<int>(socket_), receive_buffer_.data(), slot, MSG_DONTWAIT);
+        if (got < 0 && errno == EINTR) continue;
+        if (got < 0) return true;
+        accept(receive_buffer_.data(), static_cast<size_t>(got));
+#endif
+    }
+#else
+    (void)wait_ms;
+    return false;
+#endif
+}
+
+bool UdpHaloTransport::receive(ShardSide side, uint64_t step, double* plane, size_t count,
+                               std::chrono::microseconds timeout) {
+    const size_t s = static_cast<size_t>(side);
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    for (;;) {
+        Assembly& assembly = incoming_[s][step & 1];
+        if (assembly.step == step && assembly.missing == 0) {
+            if (assembly.data.size() != count) {
+                throw std::runtime_error("halo plane size differs between neighbouring shards");
+            }
+            std::copy(assembly.data.begin(), assembly.data.end(), plane);
+            assembly.step = UINT64_MAX;
+            next_[s] = std::max(next_[s], step + 1);
+            return true;
+        }
+        const auto remaining = std::chrono::duration_cast<std::chrono::microseconds>(
+            deadline - std::chrono::steady_clock::now());
+        if (remaining.count() <= 0) {
+            // Stragglers of this step are stale from now on
+            if (assembly.step == step) assembly.step = UINT64_MAX;
+            next_[s] = std::max(next_[s], step + 1);
+            return false;
+        }
+        drain(static_cast<int>((remaining.count() + 999) / 1000));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// GridShard
+
+void GridShard::slabRange(size_t nz, size_t rank, size_t ranks, size_t& z_begin, size_t& z_end) {
+    const size_t base = nz / ranks;
+    const size_t extra = nz % ranks;
+    z_begin = rank * base + std::min(rank, extra);
+    z_end = z_begin + base + (rank < extra ? 1 : 0);
+}
+
+GridShard::GridShard(const ShardConfig& config, std::unique_ptr<HaloTransport> transport)
+    : config_(config), transport_(std::move(transport)) {
+    if (config.nx == 0 || config.ny == 0) throw std::invalid_argument("grid nx and ny must be at least 1");
+    if (config.rank >= config.ranks) throw std::invalid_argument("shard rank must be below the shard count");
+    if (!(config.strength >= 0.0 && config.strength <= 1.0)) {
+        throw std::invalid_argument("coupling strength must be in [0, 1]");
+    }
+    if (!transport_) throw std::invalid_argument("shard needs a halo transport");
+    slabRange(config.nz, config.rank, config.ranks, z_begin_, z_end_);
+    if (z_begin_ == z_end_) throw std::invalid_argument("grid has fewer slabs than shards");
+
+    const size_t plane = config.nx * config.ny;
+    engine_ = std::make_unique<AnalogCellularEngineAVX2>(slabCount() * plane);
+    engine_->setGridShape(config.nx, config.ny, slabCount());
+    for (auto& halo : halo_) halo.resize(plane);
+    scratch_.resize(slabCount() * plane);
+}
+
+double GridShard::step(double input_signal, double control_pattern) {
+    const size_t plane = config_.nx * config_.ny;
+    const size_t slabs = slabCount();
+    const bool below = config_.rank > 0;
+    const bool above = config_.rank + 1 < config_.ranks;
+    ShardStepTiming timing;
+
+    const uint64_t start = nowNs();
+    const double result = engine_->processSignalWaveAVX2(input_signal, control_pattern);
+    engine_->syncComputeBackend();
+    double* output = engine_->bank.current_output;
+    uint64_t mark = nowNs();
+    timing.compute_ns = mark - start;
+
+    if (below) transport_->send(ShardSide::Below, step_, output, plane);
+    if (above) transport_->send(ShardSide::Above, step_, output + (slabs - 1) * plane, plane);
+    stats_.bytes_sent += ((below ? 1 : 0) + (above ? 1 : 0)) * plane * sizeof(double);
+    uint64_t now = nowNs();
+    timing.send_ns = now - mark;
+    mark = now;
+
+    // Slabs reading no halo: all but those next to a neighbour
+    WorkerPool& pool = *engine_->getWorkerPool();
+    const size_t lo = below ? 1 : 0;
+    const size_t hi = above ? slabs - 1 : slabs;
+    if (lo < hi) {
+        GridCoupling::applySlabs(pool, output, scratch_.data(), config_.nx, config_.ny, slabs, nullptr, nullptr,
+                                 lo, hi, config_.stencil, config_.strength);
+    }
+    now = nowNs();
+    timing.interior_ns = now - mark;
+    mark = now;
+
+    const ShardSide sides[2] = {ShardSide::Below, ShardSide::Above};
+    const bool present[2] = {below, above};
+    for (int k = 0; k < 2; k++) {
+        if (!present[k]) continue;
+        const size_t s = static_cast<size_t>(sides[k]);
+        if (transport_->receive(sides[k], step_, halo_[s].data(), plane, config_.halo_timeout)) {
+            has_halo_[s] = true;
+        } else {
+            stats_.halo_timeouts++;
+        }
+    }
+    now = nowNs();
+    timing.wait_ns = now - mark;
+    mark = now;
+
+    const double* lower = has_halo_[static_cast<size_t>(ShardSide::Below)] ? halo_[0].data() : nullptr;
+    const double* upper = has_halo_[static_cast<size_t>(ShardSide::Above)] ? halo_[1].data() : nullptr;
+    if (lo < hi) {
+        GridCoupling::applySlabs(pool, output, scratch_.data(), config_.nx, config_.ny, slabs, lower, upper, 0, lo,
+                                 config_.stencil, config_.strength);
+        GridCoupling::applySlabs(pool, output, scratch_.data(), config_.nx, config_.ny, slabs, lower, upper, hi,
+                                 slabs, config_.stencil, config_.strength);
+    } else {
+        GridCoupling::applySlabs(pool, output, scratch_.data(), config_.nx, config_.ny, slabs, lower, upper, 0,
+                                 slabs, config_.stencil, config_.strength);
+    }
+    std::memcpy(output, scratch_.data(), scratch_.size() * sizeof(double));
+    now = nowNs();
+    timing.boundary_ns = now - mark;
+    timing.total_ns = now - start;
+
+    step_++;
+    stats_.steps++;
+    stats_.last = timing;
+    stats_.total.compute_ns += timing.compute_ns;
+    stats_.total.send_ns += timing.send_ns;
+    stats_.total.interior_ns += timing.interior_ns;
+    stats_.total.wait_ns += timing.wait_ns;
+    stats_.total.boundary_ns += timing.boundary_ns;
+    stats_.total.total_ns += timing.total_ns;
+    stats_.worst_wait_ns = std::max(stats_.worst_wait_ns, timing.wait_ns);
+    return result;
+}
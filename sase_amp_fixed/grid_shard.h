@@ -0,0 +1,230 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "analog_universal_node_engine_avx2.h"
+#include "grid_coupling.h"
+
+// Neighbour of a shard along z
+enum class ShardSide : uint8_t {
+    Below = 0,  // The shard owning the slabs before this one's first
+    Above = 1   // The shard owning the slabs after this one's last
+};
+
+// Moves the boundary slabs of a shard's node outputs to and from its two
+// neighbours. A shard sends its first slab Below and its last slab Above
+// once per step, then receives the same step's slabs from both; a
+// neighbour is therefore never more than one step ahead.
+class HaloTransport {
+public:
+    virtual ~HaloTransport() = default;
+
+    // Hands plane (count doubles) of step to the neighbour on side; plane
+    // may be reused once it returns
+    virtual void send(ShardSide side, uint64_t step, const double* plane, size_t count) = 0;
+    // Waits up to timeout for the neighbour's plane of step. Returns false
+    // on timeout, leaving plane as it was.
+    virtual bool receive(ShardSide side, uint64_t step, double* plane, size_t count,
+                         std::chrono::microseconds timeout) = 0;
+};
+
+// Halo exchange between the shards of one process, e.g. one per NUMA node
+// or for testing the multi-host setup on one machine. Each shard runs on a
+// thread of its own with its endpoint; the hub must outlive them.
+class LoopbackHaloExchange {
+public:
+    // Throws std::invalid_argument for no shards
+    explicit LoopbackHaloExchange(size_t ranks);
+
+    LoopbackHaloExchange(const LoopbackHaloExchange&) = delete;
+    LoopbackHaloExchange& operator=(const LoopbackHaloExchange&) = delete;
+
+    // Transport of shard rank; throws std::out_of_range past the last
+    std::unique_ptr<HaloTransport> endpoint(size_t rank);
+    size_t ranks() const { return boxes_.size() / 2; }
+
+private:
+    class Endpoint;
+
+    // Planes arriving at one side of one shard, one slot per step parity
+    struct Mailbox {
+        std::mutex mutex;
+        std::condition_variable ready;
+        uint64_t step[2] = {UINT64_MAX, UINT64_MAX};
+        std::vector<double> plane[2];
+    };
+
+    Mailbox& box(size_t rank, ShardSide side) { return *boxes_[rank * 2 + static_cast<size_t>(side)]; }
+
+    std::vector<std::unique_ptr<Mailbox>> boxes_;
+};
+
+struct UdpHaloConfig {
+    uint16_t port = 0;                  // Local port the neighbours send to
+    std::string below_host;             // Empty: no neighbour on that side
+    uint16_t below_port = 0;
+    std::string above_host;
+    uint16_t above_port = 0;
+    // Plane payload per datagram; 1400 on links without jumbo frames. Must
+    // match on every host.
+    size_t datagram_bytes = 8192;
+    size_t socket_buffer = 8u << 20;    // SO_RCVBUF and SO_SNDBUF requested
+};
+
+// Halo exchange over UDP between shards on different hosts.
+//
+// A plane goes out as a batch of datagrams (one sendmmsg call per 64 on
+// Linux), each tagged with the step, the side it arrives on and its offset;
+// the receiver reassembles them in a buffer per side and step parity and
+// discards duplicates and datagrams of steps already consumed. Datagrams
+// that arrive while the shard couples its interior wait in the socket
+// buffer, so socket_buffer should hold at least two planes. There is no
+// retransmission: a lost datagram turns into a receive timeout, and the
+// shard carries on with its previous halo. Values travel in host byte
+// order, so the hosts must share one.
+class UdpHaloTransport : public HaloTransport {
+public:
+    // Throws std::invalid_argument for a datagram too small for a value or
+    // an unresolvable neighbour, std::runtime_error if the socket cannot be
+    // bound (or on a platform without POSIX sockets)
+    explicit UdpHaloTransport(const UdpHaloConfig& config);
+    ~UdpHaloTransport() override;
+
+    UdpHaloTransport(const UdpHaloTransport&) = delete;
+    UdpHaloTransport& operator=(const UdpHaloTransport&) = delete;
+
+    // Throws std::runtime_error if sending fails
+    void send(ShardSide side, uint64_t step, const double* plane, size_t count) override;
+    // Throws std::runtime_error if the neighbour's plane has a different size
+    bool receive(ShardSide side, uint64_t step, double* plane, size_t count,
+                 std::chrono::microseconds timeout) override;
+
+    // Port bound, useful with port 0
+    uint16_t port() const { return port_; }
+    uint64_t datagramsSent() const { return datagrams_sent_; }
+    uint64_t datagramsReceived() const { return datagrams_received_; }
+    // Malformed, duplicate or stale datagrams
+    uint64_t datagramsDiscarded() const { return datagrams_discarded_; }
+
+    static constexpr size_t kHeaderBytes = 32;
+    static constexpr size_t kBatch = 64;
+
+private:
+    struct Assembly {
+        uint64_t step = UINT64_MAX;
+        size_t missing = 0;               // Datagrams still to come
+        std::vector<double> data;
+        std::vector<uint8_t> seen;        // Per datagram of the plane
+    };
+
+    // Reads the datagrams waiting, first waiting up to wait_ms for one;
+    // false if none came
+    bool drain(int wait_ms);
+    void accept(const unsigned char* datagram, size_t size);
+
+    UdpHaloConfig config_;
+    intptr_t socket_ = -1;
+    uint16_t port_ = 0;
+    size_t chunk_ = 0;                    // Values per datagram
+    std::vector<unsigned char> peer_[2];  // sockaddr of each neighbour, empty for none
+    Assembly incoming_[2][2];             // [side][step parity]
+    uint64_t next_[2] = {0, 0};           // First step not yet consumed, per side
+    std::vector<unsigned char> send_buffer_;
+    std::vector<unsigned char> receive_buffer_;
+    uint64_t datagrams_sent_ = 0;
+    uint64_t datagrams_received_ = 0;
+    uint64_t datagrams_discarded_ = 0;
+};
+
+// Slab of a global Linear grid owned by one shard
+struct ShardConfig {
+    size_t nx = 10;                       // Global plane
+    size_t ny = 10;
+    size_t nz = 1;                        // Global slab count
+    size_t rank = 0;                      // This shard, in [0, ranks)
+    size_t ranks = 1;
+    GridStencil stencil = GridStencil::Face6;
+    double strength = 0.1;
+    // Longest wait for a neighbour's halo; past it the previous one is reused
+    std::chrono::microseconds halo_timeout{100000};
+};
+
+// Time of each phase of one shard step
+struct ShardStepTiming {
+    uint64_t compute_ns = 0;              // Wave sweep of the local nodes
+    uint64_t send_ns = 0;                 // Posting the two boundary slabs
+    uint64_t interior_ns = 0;             // Coupling the slabs without a halo, while the halos travel
+    uint64_t wait_ns = 0;                 // Waiting for the halos after the interior
+    uint64_t boundary_ns = 0;             // Coupling the first and last slab
+    uint64_t total_ns = 0;
+
+    uint64_t communicationNs() const { return send_ns + wait_ns; }
+};
+
+struct ShardStats {
+    uint64_t steps = 0;
+    uint64_t halo_timeouts = 0;           // Halos not received in time
+    uint64_t bytes_sent = 0;
+    ShardStepTiming last;
+    ShardStepTiming total;                // Sums over the steps
+    uint64_t worst_wait_ns = 0;
+};
+
+// One host's share of a grid engine sharded across hosts.
+//
+// The global nx x ny x nz Linear grid is cut into z-slab ranges, shard r
+// owning slabs [firstSlab(), firstSlab() + slabCount()) as slabRange()
+// assigns them, with a local engine holding just those nodes. A step runs
+// the local wave sweep (the engine's own grid coupling stays off; its
+// sparse coupling and noise still run, ahead of the grid step rather than
+// after it), posts the first and last slab to the neighbours, couples the
+// interior slabs while they travel, then waits for the neighbours' slabs
+// and couples the two boundary slabs against them. With every halo on time
+// the grid step matches the one an engine holding the whole grid would take
+// from the same node outputs; the wave sweep's per-node control phase
+// follows the local node numbers. Each phase is timed (ShardStats), so
+// compute and communication time can be compared per step.
+class GridShard {
+public:
+    // Throws std::invalid_argument if nx or ny is 0, rank >= ranks, the
+    // shard would own no slab, strength is outside [0, 1] or transport is
+    // null
+    GridShard(const ShardConfig& config, std::unique_ptr<HaloTransport> transport);
+
+    GridShard(const GridShard&) = delete;
+    GridShard& operator=(const GridShard&) = delete;
+
+    // Slabs of shard rank of ranks over nz: an even split, the first
+    // nz % ranks shards taking one more
+    static void slabRange(size_t nz, size_t rank, size_t ranks, size_t& z_begin, size_t& z_end);
+
+    AnalogCellularEngineAVX2& engine() { return *engine_; }
+    const ShardConfig& config() const { return config_; }
+    size_t firstSlab() const { return z_begin_; }
+    size_t slabCount() const { return z_end_ - z_begin_; }
+
+    // One step of the local nodes; returns the engine's wave result, the
+    // local share of the global one. Every shard must run the same steps.
+    double step(double input_signal, double control_pattern);
+
+    const ShardStats& stats() const { return stats_; }
+    void resetStats() { stats_ = ShardStats(); }
+
+private:
+    ShardConfig config_;
+    std::unique_ptr<HaloTransport> transport_;
+    std::unique_ptr<AnalogCellularEngineAVX2> engine_;
+    size_t z_begin_ = 0;
+    size_t z_end_ = 0;
+    uint64_t step_ = 0;
+    std::vector<double> halo_[2];         // Last plane received per side
+    bool has_halo_[2] = {false, false};   // Until then the side is treated as the grid's edge
+    std::vector<double> scratch_;
+    ShardStats stats_;
+};
@@ -0,0 +1,114 @@
+#include "hardware_metrics.h"
+#include <cstdio>
+
+namespace {
+
+const char* const kStageLabels[HYBRID_STAGE_COUNT] = {
+    "stage=\"filter\"",  "stage=\"metrics\"", "stage=\"fft\"",   "stage=\"analysis\"",
+    "stage=\"control\"", "stage=\"output\"",  "stage=\"engine\""};
+
+const char* const kLoadLevelLabels[HYBRID_LOAD_LEVELS] = {
+    "level=\"full\"", "level=\"half_rate\"", "level=\"alternate\"", "level=\"passband\"", "level=\"no_spectral\""};
+
+const char* const kLinkStates[] = {"disconnected", "syncing", "stable", "degraded", "error"};
+
+} // namespace
+
+void writeNodeStatistics(OpenMetricsWriter& w, const NodeStatistics& s) {
+    w.counter("hybrid_frames_processed", "Frames processed", s.frames_processed);
+    w.counter("hybrid_frames_dropped", "Frames dropped", s.frames_dropped);
+    w.counter("hybrid_deadline_overruns", "Buffers that took longer than their duration", s.deadline_overruns);
+    w.counter("hybrid_deadline_near_misses", "Buffers within their duration over the near-miss fraction",
+              s.deadline.near_misses);
+    w.gauge("hybrid_deadline_worst_seconds", "Longest buffer", s.deadline.worst_ns * 1e-9, "seconds");
+    w.gauge("hybrid_deadline_consecutive_misses", "Overruns in a row up to the last buffer",
+            static_cast<double>(s.deadline.consecutive_misses));
+    w.counter("hybrid_denormal_buffers", "Buffers that underflowed into flushed subnormals", s.denormal_buffers);
+    w.gauge("hybrid_cpu_load_percent", "Processing time over buffer duration", s.cpu_load, "percent");
+    w.gauge("hybrid_buffer_utilization_percent", "DMA buffer fill", s.buffer_utilization, "percent");
+    w.gauge("hybrid_uptime_seconds", "Time since the node started", s.uptime_ms * 1e-3, "seconds");
+    w.gauge("hybrid_drift_ppm", "Clock drift in parts per million", s.drift_ppm);
+    w.gauge("hybrid_modulation_fidelity_percent", "Modulation fidelity", s.modulation_fidelity, "percent");
+
+    w.gauge("hybrid_load_level", "HybridLoadLevel in force, 0 for full analysis", s.load_level);
+    w.gauge("hybrid_governed_load_percent", "Smoothed CPU load the governor acts on", s.governed_load, "percent");
+    w.counter("hybrid_load_level_changes", "Times the governor moved the level", uint64_t{s.load_level_changes});
+    w.family("hybrid_load_level_buffers", "counter", "Buffers processed at each load level");
+    for (int l = 0; l < HYBRID_LOAD_LEVELS; l++) {
+        w.counterSample("hybrid_load_level_buffers", kLoadLevelLabels[l], s.load_level_buffers[l]);
+    }
+
+    w.family("hybrid_stage_deadline_misses", "counter", "Overruns charged to the longest stage of the buffer");
+    for (int t = 0; t < HYBRID_STAGE_COUNT; t++) {
+        w.counterSample("hybrid_stage_deadline_misses", kStageLabels[t], s.deadline.stage_misses[t]);
+    }
+    w.family("hybrid_stage_deadline_near_misses", "counter", "Near misses charged to the longest stage of the buffer");
+    for (int t = 0; t < HYBRID_STAGE_COUNT; t++) {
+        w.counterSample("hybrid_stage_deadline_near_misses", kStageLabels[t], s.deadline.stage_near_misses[t]);
+    }
+
+    w.family("hybrid_stage_buffers", "counter", "Buffers that ran each processing stage");
+    for (int t = 0; t < HYBRID_STAGE_COUNT; t++) {
+        w.counterSample("hybrid_stage_buffers", kStageLabels[t], uint64_t{s.stage[t].count});
+    }
+    struct Field {
+        const char* name;
+        const char* help;
+        uint32_t HybridStageTiming::*ns;
+    };
+    static const Field kTimings[] = {
+        {"hybrid_stage_min_seconds", "Fastest buffer of each stage", &HybridStageTiming::min_ns},
+        {"hybrid_stage_mean_seconds", "Mean time of each stage", &HybridStageTiming::mean_ns},
+        {"hybrid_stage_max_seconds", "Slowest buffer of each stage", &HybridStageTiming::max_ns},
+    };
+    for (const Field& f : kTimings) {
+        w.family(f.name, "gauge", f.help, "seconds");
+        for (int t = 0; t < HYBRID_STAGE_COUNT; t++) {
+            w.sample(f.name, kStageLabels[t], static_cast<double>(s.stage[t].*f.ns) * 1e-9);
+        }
+    }
+}
+
+void writeHybridLatency(OpenMetricsWriter& w, const HybridLatencyStats& l) {
+    w.family("hybrid_process_latency_seconds", "summary", "Time hybrid_node_process took per buffer", "seconds");
+    w.latencySummary("hybrid_process_latency_seconds", nullptr, l.count, 0, l.p50_ns, l.p90_ns, l.p99_ns,
+                     l.p999_ns);
+    w.gauge("hybrid_process_latency_max_seconds", "Slowest buffer", l.max_ns * 1e-9, "seconds");
+}
+
+void writeI2SStatistics(OpenMetricsWriter& w, const I2SStatistics& s) {
+    w.counter("i2s_frames_transmitted", "Frames sent", s.frames_transmitted);
+    w.counter("i2s_frames_received", "Frames received", s.frames_received);
+    w.counter("i2s_frames_dropped", "Metrics packets missing from the sequence", s.frames_dropped);
+    w.counter("i2s_packets_transmitted", "Metrics packets sent", s.packets_transmitted);
+    w.counter("i2s_packets_received", "Metrics packets decoded", s.packets_received);
+    w.counter("i2s_packets_corrupt", "Packets rejected by the CRC", s.packets_corrupt);
+    w.counter("i2s_tx_underruns", "TX halves sent without a commit", s.tx_underruns);
+    w.counter("i2s_rx_overruns", "RX halves overwritten before or while read", s.rx_overruns);
+    w.counter("i2s_asrc_slips", "Resampler FIFO under- or overflows", s.asrc_slips);
+    w.counter("i2s_failovers", "Link restarts by i2s_bridge_check_link", uint64_t{s.failovers});
+    w.gauge("i2s_latency_seconds", "Round-trip latency", s.latency_us * 1e-6, "seconds");
+    w.gauge("i2s_jitter_seconds", "Round-trip latency jitter", s.jitter_us * 1e-6, "seconds");
+    w.gauge("i2s_clock_drift_ppm", "Clock drift in parts per million", s.clock_drift_ppm);
+    w.gauge("i2s_loss_rate", "Dropped over expected metrics packets", s.loss_rate);
+    w.gauge("i2s_crc_error_rate", "Packets failing the CRC over the last 100 ms", s.crc_error_rate);
+    w.gauge("i2s_asrc_ratio", "Resampler input frames per output frame", s.asrc_ratio);
+    w.gauge("i2s_recovery_seconds", "Gap around the latest link failure", s.recovery_ms * 1e-3, "seconds");
+    w.gauge("i2s_uptime_seconds", "Time since the last statistics reset", s.uptime_ms * 1e-3, "seconds");
+
+    w.family("i2s_link_status", "stateset", "Link status");
+    for (int state = 0; state < static_cast<int>(sizeof(kLinkStates) / sizeof(kLinkStates[0])); state++) {
+        char label[48];
+        std::snprintf(label, sizeof(label), "i2s_link_status=\"%s\"", kLinkStates[state]);
+        w.sample("i2s_link_status", label, uint64_t{state == static_cast<int>(s.link_status) ? 1u : 0u});
+    }
+}
+
+void writeHardwareOpenMetrics(OpenMetricsWriter& w) {
+    HybridNodeStatus status;
+    if (hybrid_node_get_status(&status)) writeNodeStatistics(w, status.stats);
+    HybridLatencyStats latency;
+    if (hybrid_node_get_latency(&latency)) writeHybridLatency(w, latency);
+    I2SStatistics i2s;
+    if (i2s_bridge_get_statistics(&i2s)) writeI2SStatistics(w, i2s);
+}
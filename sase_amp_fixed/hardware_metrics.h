@@ -0,0 +1,25 @@
+#pragma once
+
+#include "hybrid_node.h"
+#include "i2s_bridge.h"
+#include "openmetrics.h"
+
+// OpenMetrics families of the hybrid node and the I²S bridge, for hosts
+// that link them (dase_pipeline_host, dase_pipeline_bench; build with
+// -I../hardware).
+
+// hybrid_* families of the node statistics, per-stage timings labelled
+// by stage
+void writeNodeStatistics(OpenMetricsWriter& writer, const NodeStatistics& stats);
+// hybrid_process_latency_seconds summary; the node keeps percentiles only,
+// so there is no sum
+void writeHybridLatency(OpenMetricsWriter& writer, const HybridLatencyStats& latency);
+// i2s_* families of the bridge statistics
+void writeI2SStatistics(OpenMetricsWriter& writer, const I2SStatistics& stats);
+
+// All of the above from the default node and bridge: hybrid_node_get_status
+// and hybrid_node_get_latency read seqlock-published snapshots,
+// i2s_bridge_get_statistics copies the counters, none of them lock or wait
+// on the audio path. Sources that report nothing (not initialized) are
+// left out.
+void writeHardwareOpenMetrics(OpenMetricsWriter& writer);
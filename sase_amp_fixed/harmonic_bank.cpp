@@ -0,0 +1,111 @@
+#include "harmonic_bank.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+HarmonicOscillatorBank::HarmonicOscillatorBank(size_t harmonic_count, size_t passes,
+                                               double phase_step, double base_amplitude)
+    : base_amplitude_(base_amplitude), passes_(passes),
+      pass_sin_((passes + kPassBlock - 1) / kPassBlock * kPassBlock, 0.0), pass_cos_(pass_sin_.size(), 0.0) {
+    for (size_t p = 0; p < passes; p++) {
+        const double phase = static_cast<double>(p) * phase_step;
+        pass_sin_[p] = std::sin(phase);
+        pass_cos_[p] = std::cos(phase);
+    }
+    setHarmonicCount(harmonic_count);
+}
+
+void HarmonicOscillatorBank::setHarmonicCount(size_t harmonic_count) {
+    if (harmonic_count == 0 || harmonic_count > kMaxHarmonics) {
+        throw std::invalid_argument("harmonic_count must be between 1 and 64");
+    }
+    amplitude_.resize(harmonic_count);
+    for (size_t k = 0; k < harmonic_count; k++) {
+        amplitude_[k] = base_amplitude_ / static_cast<double>(k + 1);
+    }
+    switch (harmonic_count) {
+        case 4: pass_sums_ = &HarmonicOscillatorBank::passSumsSerial<4>; break;
+        case 8: pass_sums_ = &HarmonicOscillatorBank::passSumsSerial<8>; break;
+        case 16: pass_sums_ = &HarmonicOscillatorBank::passSumsSerial<16>; break;
+        case 32: pass_sums_ = &HarmonicOscillatorBank::passSumsBlocked<32>; break;
+        case 64: pass_sums_ = &HarmonicOscillatorBank::passSumsBlocked<64>; break;
+        default:
+            pass_sums_ = harmonic_count <= kSerialMax ? &HarmonicOscillatorBank::passSumsSerial<0>
+                                                      : &HarmonicOscillatorBank::passSumsBlocked<0>;
+            break;
+    }
+}
+
+template <size_t Count>
+void HarmonicOscillatorBank::passSumsSerial(double x, double* out) const {
+    const double sin_x = std::sin(x);
+    const double cos_x = std::cos(x);
+    const double two_cos_x = 2.0 * cos_x;
+    const size_t count = Count != 0 ? Count : amplitude_.size();
+    const double* amplitude = amplitude_.data();
+
+    for (size_t p = 0; p < passes_; p++) {
+        // s_prev = sin(0 * x + phi), s = sin(1 * x + phi)
+        double s_prev = pass_sin_[p];
+        double s = sin_x * pass_cos_[p] + cos_x * pass_sin_[p];
+        double sum = amplitude[0] * s;
+        for (size_t k = 1; k < count; k++) {
+            const double s_next = two_cos_x * s - s_prev;
+            s_prev = s;
+            s = s_next;
+            sum += amplitude[k] * s_next;
+        }
+        out[p] = sum;
+    }
+}
+
+template <size_t Count>
+void HarmonicOscillatorBank::passSumsBlocked(double x, double* out) const {
+    const double sin_x = std::sin(x);
+    const double cos_x = std::cos(x);
+    const double two_cos_x = 2.0 * cos_x;
+    const size_t count = Count != 0 ? Count : amplitude_.size();
+    const double* amplitude = amplitude_.data();
+    const double* pass_sin = pass_sin_.data();
+    const double* pass_cos = pass_cos_.data();
+
+    // The phasor columns are padded to whole blocks, so every lane loop has
+    // a fixed trip count
+    for (size_t first = 0; first < passes_; first += kPassBlock) {
+        double s_prev[kPassBlock];
+        double s[kPassBlock];
+        double sum[kPassBlock];
+        for (size_t j = 0; j < kPassBlock; j++) {
+            s_prev[j] = pass_sin[first + j];
+            s[j] = sin_x * pass_cos[first + j] + cos_x * pass_sin[first + j];
+            sum[j] = amplitude[0] * s[j];
+        }
+        for (size_t k = 1; k < count; k++) {
+            const double a = amplitude[k];
+            for (size_t j = 0; j < kPassBlock; j++) {
+                const double s_next = two_cos_x * s[j] - s_prev[j];
+                s_prev[j] = s[j];
+                s[j] = s_next;
+                sum[j] += a * s_next;
+            }
+        }
+        const size_t lanes = std::min(kPassBlock, passes_ - first);
+        for (size_t j = 0; j < lanes; j++) out[first + j] = sum[j];
+    }
+}
+
+void HarmonicOscillatorBank::harmonics(double x, size_t pass, double* out) const {
+    if (pass >= passes_) throw std::out_of_range("pass index out of range");
+    const double sin_x = std::sin(x);
+    const double cos_x = std::cos(x);
+    const double two_cos_x = 2.0 * cos_x;
+    double s_prev = pass_sin_[pass];
+    double s = sin_x * pass_cos_[pass] + cos_x * pass_sin_[pass];
+    out[0] = amplitude_[0] * s;
+    for (size_t k = 1; k < amplitude_.size(); k++) {
+        const double s_next = two_cos_x * s - s_prev;
+        s_prev = s;
+        s = s_next;
+        out[k] = amplitude_[k] * s;
+    }
+}
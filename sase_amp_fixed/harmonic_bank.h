@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Harmonic stack generator driven by recurrences instead of per-harmonic sin().
+//
+// The wave adds sum_k a_k * sin(k * x + phi_p) to each pass p, with
+// a_k = base_amplitude / k and phase phi_p = p * phase_step. The amplitude
+// table and the per-pass phasors (sin/cos phi_p) are computed once and kept;
+// an evaluation takes one sin/cos of x and then the Chebyshev recurrence
+//   sin((k + 1) x + phi) = 2 cos(x) sin(k x + phi) - sin((k - 1) x + phi)
+// costs one multiply-add per harmonic. Evaluation is in double precision, so the
+// recurrence stays well below float rounding for the supported counts.
+//
+// passSums() has instantiations for the common counts (4, 8, 16, 32, 64)
+// with the harmonic loop unrolled at compile time. Up to kSerialMax
+// harmonics each pass runs its recurrence in turn and the core overlaps
+// consecutive passes; longer stacks outgrow that overlap, so their passes
+// run side by side in blocks of kPassBlock lanes, harmonic by harmonic, and
+// the lane loop vectorizes. Every variant sums a pass in the same order, so
+// results do not depend on which one ran.
+class HarmonicOscillatorBank {
+public:
+    static constexpr size_t kMaxHarmonics = 64;
+
+    explicit HarmonicOscillatorBank(size_t harmonic_count = 8, size_t passes = 10,
+                                    double phase_step = 0.1, double base_amplitude = 0.1);
+
+    // Throws std::invalid_argument outside [1, kMaxHarmonics]
+    void setHarmonicCount(size_t harmonic_count);
+    size_t harmonicCount() const { return amplitude_.size(); }
+    size_t passCount() const { return passes_; }
+
+    // Harmonic sum for every pass at input x: out[p] = sum_k a_k sin(k x + phi_p)
+    void passSums(double x, double* out) const { (this->*pass_sums_)(x, out); }
+
+    // Individual harmonics of one pass: out[k - 1] = a_k sin(k x + phi_pass).
+    // Throws std::out_of_range for pass >= passCount().
+    void harmonics(double x, size_t pass, double* out) const;
+
+private:
+    static constexpr size_t kSerialMax = 16;  // Longest stack run one pass at a time
+    static constexpr size_t kPassBlock = 16;  // Passes run side by side above that
+
+    // passSums for Count harmonics, or for harmonicCount() when Count is 0
+    template <size_t Count>
+    void passSumsSerial(double x, double* out) const;
+    template <size_t Count>
+    void passSumsBlocked(double x, double* out) const;
+
+    void (HarmonicOscillatorBank::*pass_sums_)(double, double*) const = nullptr;
+    double base_amplitude_;
+    size_t passes_;
+    std::vector<double> amplitude_;  // a_k, k = 1..count
+    std::vector<double> pass_sin_;   // sin(phi_p), zero-padded to whole pass blocks
+    std::vector<double> pass_cos_;   // cos(phi_p), likewise
+};
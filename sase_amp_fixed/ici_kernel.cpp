@@ -0,0 +1,103 @@
+#include "ici_kernel.h"
+#include <algorithm>
+#include <cmath>
+#include <new>
+#include <stdexcept>
+
+ICIKernel::ICIKernel(size_t num_channels, size_t fft_size, SimdLevel level, FFTBackend backend)
+    : channels_(num_channels), fft_size_(fft_size), bins_(fft_size / 2 + 1), stride_((fft_size / 2 + 16) & ~size_t(15)),
+      kernels_(&nodeKernels(level)) {
+    if (num_channels < 2) throw std::invalid_argument("ICI needs at least 2 channels");
+    if (fft_size < 2) throw std::invalid_argument("FFT size must be at least 2");
+
+    // numpy.hanning: the symmetric Hann window
+    window_.resize(fft_size_);
+    for (size_t t = 0; t < fft_size_; t++) {
+        window_[t] = 0.5 - 0.5 * std::cos(2.0 * M_PI * static_cast<double>(t) / static_cast<double>(fft_size_ - 1));
+    }
+
+    input_ = fftAllocReal(channels_ * fft_size_);
+    spectrum_ = fftAllocComplex(channels_ * bins_);
+    if (!input_ || !spectrum_) {
+        fftFree(input_);
+        fftFree(spectrum_);
+        throw std::bad_alloc();
+    }
+    try {
+        fft_ = createRealFFT(backend, static_cast<int>(fft_size_), channels_, input_, spectrum_);
+    } catch (...) {
+        fftFree(input_);
+        fftFree(spectrum_);
+        throw;
+    }
+
+    magnitude_.assign(channels_ * stride_, 0.0f);
+    phasor_.assign(channels_ * 2 * stride_, 0.0f);
+    cross_power_.assign(channels_ * channels_, 0.0f);
+    cross_phase_.assign(channels_ * channels_, 0.0f);
+}
+
+ICIKernel::~ICIKernel() {
+    fft_.reset();
+    fftFree(input_);
+    fftFree(spectrum_);
+}
+
+double ICIKernel::process(const float* block, double* matrix) {
+    return run(block, matrix);
+}
+
+double ICIKernel::process(const double* block, double* matrix) {
+    return run(block, matrix);
+}
+
+template <typename T>
+double ICIKernel::run(const T* block, double* matrix) {
+    for (size_t c = 0; c < channels_; c++) {
+        const T* in = block + c * fft_size_;
+        double* out = input_ + c * fft_size_;
+        for (size_t t = 0; t < fft_size_; t++) out[t] = static_cast<double>(in[t]) * window_[t];
+    }
+    fft_->forward(input_, spectrum_);
+
+    // Polar pass; the padding past bins_ stays zero and adds nothing below
+    double magnitude_sum = 0.0;
+    for (size_t c = 0; c < channels_; c++) {
+        const FFTComplex* bin = spectrum_ + c * bins_;
+        float* magnitude = magnitude_.data() + c * stride_;
+        float* cos_row = phasor_.data() + c * 2 * stride_;
+        float* sin_row = cos_row + stride_;
+        for (size_t k = 0; k < bins_; k++) {
+            const double re = bin[k][0], im = bin[k][1];
+            const double m = std::sqrt(re * re + im * im);
+            magnitude_sum += m;
+            magnitude[k] = static_cast<float>(m);
+            cos_row[k] = m > 0.0 ? static_cast<float>(re / m) : 1.0f;
+            sin_row[k] = m > 0.0 ? static_cast<float>(im / m) : 0.0f;
+        }
+    }
+
+    const size_t n = channels_;
+    const double mean_magnitude = magnitude_sum / static_cast<double>(n * bins_);
+    const double mean_sq = mean_magnitude * mean_magnitude;
+    if (mean_sq < 1e-10) {
+        if (matrix) std::fill(matrix, matrix + n * n, 0.0);
+        return 0.5;
+    }
+
+    kernels_->pair_products(magnitude_.data(), n, stride_, stride_, cross_power_.data());
+    kernels_->pair_products(phasor_.data(), n, 2 * stride_, 2 * stride_, cross_phase_.data());
+
+    const double bins = static_cast<double>(bins_);
+    const double scale = 1.0 / (bins * bins * mean_sq);
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            const double v = i == j ? 0.0 : scale * cross_power_[i * n + j] * cross_phase_[i * n + j];
+            if (matrix) matrix[i * n + j] = v;
+            sum += v;
+        }
+    }
+    const double ici = (sum / static_cast<double>(n * (n - 1)) + 1.0) * 0.5;
+    return std::min(std::max(ici, 0.0), 1.0);
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "fft_backend.h"
+#include "node_kernels.h"
+
+// Integrated Chromatic Information of a multi-channel block, the kernel of
+// server/ici_engine.py (IntegratedChromaticInformation.process_block):
+//
+//   M[i][j] = mean_k(|A_ik| |A_jk|) / mean(|A|)^2 * mean_k cos(phi_ik - phi_jk)   (i != j)
+//   ICI     = clamp((sum_ij M[i][j] / (C (C - 1)) + 1) / 2, 0, 1)
+//
+// over the Hann-windowed (numpy.hanning) real spectra A_ik of the C channels,
+// bins k = 0 .. fft_size / 2; M is zero, and ICI 0.5, for a block whose mean
+// squared magnitude is below 1e-10.
+//
+// The window, one batched r2c transform for all channels and every buffer are
+// made at construction, so a block is one FFT call, a polar pass and two pair
+// product (Gram) passes through the node kernel table: magnitudes for the
+// cross power, unit phasors for the phase term, as
+// cos(a - b) = cos a cos b + sin a sin b. A bin of zero magnitude has phase 0,
+// like numpy.angle. Not thread safe: one block at a time per kernel.
+class ICIKernel {
+public:
+    // Throws std::invalid_argument for fewer than 2 channels, an fft_size
+    // below 2 or a backend this build lacks, std::runtime_error if the
+    // backend cannot plan the transform
+    ICIKernel(size_t num_channels, size_t fft_size, SimdLevel level = defaultSimdLevel(),
+              FFTBackend backend = defaultFFTBackend());
+    ~ICIKernel();
+
+    ICIKernel(const ICIKernel&) = delete;
+    ICIKernel& operator=(const ICIKernel&) = delete;
+
+    size_t channels() const { return channels_; }
+    size_t fftSize() const { return fft_size_; }
+    size_t binCount() const { return bins_; }
+    SimdLevel getSimdLevel() const { return kernels_->level; }
+    FFTBackend getFFTBackend() const { return fft_->backend(); }
+
+    // Unsmoothed ICI of a channel-major [channels() x fftSize()] block. The
+    // pair matrix goes into matrix (channels()^2 values, row-major, zero
+    // diagonal) unless it is null. Input must be finite.
+    double process(const float* block, double* matrix = nullptr);
+    double process(const double* block, double* matrix = nullptr);
+
+private:
+    template <typename T>
+    double run(const T* block, double* matrix);
+
+    size_t channels_;
+    size_t fft_size_;
+    size_t bins_;
+    size_t stride_;                  // bins_ rounded up to 16 floats, zero padded
+    const NodeKernels* kernels_;
+    std::vector<double> window_;
+    double* input_ = nullptr;        // [channels x fft_size], fftAllocReal
+    FFTComplex* spectrum_ = nullptr; // [channels x bins]
+    std::unique_ptr<RealFFT> fft_;
+    std::vector<float> magnitude_;   // [channels x stride]
+    std::vector<float> phasor_;      // [channels x 2 stride]: cos row, then sin row
+    std::vector<float> cross_power_; // [channels x channels] pair products
+    std::vector<float> cross_phase_;
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Kernels the engines account work for (see EngineMetrics::kernels)
+enum class WorkKernel {
+    NodeStep = 0,      // AnalogUniversalNodeAVX2::processSignalAVX2, one node step
+    NodeBlock,         // AnalogUniversalNodeAVX2::processBlock
+    Harmonics,         // Harmonic pass sums of one wave sweep
+    WaveSweep,         // Node passes of one wave sweep (10 steps per node)
+    MissionStep,       // One per-step mission sweep
+    MissionFused,      // One fused mission tile, schedule included
+    EngineBlock,       // Engine processBlock, shared streams included
+    GridCoupling,      // One grid diffusion step
+    SparseCoupling,    // One out += A * out step
+    NoiseInjection,    // One noise injection step
+    ChromaticBlock,    // Engine processChromaticBlock, envelope included
+    FilterBlock,       // Engine processFilterBlock, every filter node
+    KernelCount
+};
+
+const char* workKernelName(WorkKernel kernel);
+
+// Cost model of the kernels for roofline analysis.
+//
+// FLOPs are the floating-point operations of the algorithm as written and
+// are the same at every SIMD level: add, sub and mul count 1, FMA counts 2,
+// div and sqrt count 1; min/max clamps, floor and integer work (the Philox
+// rounds) are not counted. A polynomial sincos counts for sin alone, and a
+// libm sin or cos counts the same. Bytes are the compulsory traffic on the
+// node columns and input/output streams per call: each element a call reads
+// or writes counts once, however often the kernel revisits it in cache.
+namespace kernel_work {
+
+constexpr uint64_t kSinFlops = 41;
+// Spectral boost: 8 sines of base * m, summed and scaled
+constexpr uint64_t kSpectralFlops = 8 * (1 + kSinFlops) + 8;
+// amplify, input gain, integrate (sub + FMA), blend, spectral boost,
+// feedback (FMA) and spectral mix (FMA)
+constexpr uint64_t kNodeStepFlops = 1 + 1 + 3 + 1 + kSpectralFlops + 4;
+// Per-lane control of a wave pass (a ControlWaveTable entry plus the
+// pattern), node step, and the running sum
+constexpr uint64_t kWavePassFlops = 1 + kNodeStepFlops + 1;
+// Integrator update of the schedule and block kernels (sub + FMA)
+constexpr uint64_t kIntegratorFlops = 3;
+// Noise sample: half a Box-Muller pair (log, sqrt, sincos, scaling) plus
+// the sigma scale and the add into the output
+constexpr uint64_t kNoiseSampleFlops = 38 + 2;
+
+// State, feedback and output columns plus previous input, and the five
+// parameter columns, in bytes per node
+constexpr uint64_t nodeStateBytes(size_t scalar_size) { return 10 * scalar_size; }
+
+struct Cost {
+    uint64_t flops;
+    uint64_t bytes;
+};
+
+inline Cost nodeStep(size_t scalar_size) {
+    return {kNodeStepFlops, nodeStateBytes(scalar_size)};
+}
+
+// n samples of in/control/aux (3 x float) through one node into out
+inline Cost nodeBlock(size_t n) {
+    return {(kNodeStepFlops + 1) * n, nodeStateBytes(sizeof(double)) + 4 * sizeof(float) * n};
+}
+
+inline Cost harmonics(size_t harmonic_count, size_t passes) {
+    const uint64_t per_pass = 3 + 1 + 4 * (harmonic_count - 1) + 2;
+    return {2 * kSinFlops + 1 + per_pass * passes,
+            sizeof(double) * (harmonic_count + 3 * passes)};
+}
+
+inline Cost waveSweep(size_t nodes, size_t scalar_size, int passes = 10) {
+    return {kWavePassFlops * static_cast<uint64_t>(passes) * nodes, nodeStateBytes(scalar_size) * nodes};
+}
+
+// waves wave sweeps of a node tile that stays in cache: the state streams
+// in and out once for all of them
+inline Cost waveSweeps(size_t nodes, size_t waves, size_t scalar_size, int passes = 10) {
+    return {kWavePassFlops * static_cast<uint64_t>(passes) * nodes * waves, nodeStateBytes(scalar_size) * nodes};
+}
+
+inline Cost missionStep(size_t nodes, int repeats, size_t scalar_size) {
+    return {kNodeStepFlops * static_cast<uint64_t>(repeats) * nodes, nodeStateBytes(scalar_size) * nodes};
+}
+
+// steps schedule entries (input and control sines, product, spectral boost
+// over whole 8-step chunks), then every node through steps input gains,
+// steps x repeats integrator updates and one output
+inline Cost missionFused(size_t nodes, size_t steps, int repeats, size_t scalar_size) {
+    const uint64_t padded = (steps + 7) / 8 * 8;
+    const uint64_t schedule = steps * (2 * kSinFlops + 3) + padded * kSpectralFlops;
+    const uint64_t per_node = kIntegratorFlops * steps * static_cast<uint64_t>(repeats) + steps + 4;
+    return {schedule + per_node * nodes,
+            nodeStateBytes(scalar_size) * nodes + (scalar_size + 2 * sizeof(float)) * padded};
+}
+
+// n shared samples (amplify, blend, spectral boost) and every node through
+// n input gains, integrator updates, boost mixes and outputs; out_bytes is sizeof(float) when the
+// node-major output is written, 0 otherwise
+inline Cost engineBlock(size_t nodes, size_t n, size_t scalar_size, size_t stream_count, size_t out_bytes) {
+    const uint64_t padded = (n + 7) / 8 * 8;
+    const uint64_t shared = padded * (2 + kSpectralFlops);
+    const uint64_t per_node = (1 + kIntegratorFlops + 1 + 2) * n + 1;
+    return {shared + per_node * nodes,
+            (nodeStateBytes(scalar_size) + scalar_size) * nodes + out_bytes * n * nodes +
+                stream_count * sizeof(float) * n};
+}
+
+// Neighbour sum, mean and relaxation per node; the step reads the column,
+// writes the scratch column and copies it back
+inline Cost gridCoupling(size_t nodes, size_t neighbours) {
+    return {(neighbours + 3) * nodes, 4 * sizeof(double) * nodes};
+}
+
+// FMA per edge (index, weight and gathered value), the add of out per row,
+// and row pointer, column read, scratch write and copy back per row
+inline Cost sparseCoupling(size_t rows, size_t edges) {
+    return {2 * edges + rows, (sizeof(uint32_t) + 2 * sizeof(double)) * edges + 5 * sizeof(double) * rows};
+}
+
+// Samples through the scratch column and added into the output column
+inline Cost noiseInjection(size_t nodes) {
+    return {kNoiseSampleFlops * nodes, (2 * sizeof(float) + 2 * sizeof(double)) * nodes};
+}
+
+// Envelope and control wave per sample (a sine, scale and offset each),
+// then per channel and sample the modulation, a node step and the rotation
+// read; bytes cover the input, the outputs and the channel nodes
+inline Cost chromaticBlock(size_t channels, size_t n) {
+    return {2 * (kSinFlops + 2) * n + (kNodeStepFlops + 1) * n * channels,
+            sizeof(float) * (n + n * channels) + nodeStateBytes(sizeof(double)) * channels};
+}
+
+// Per section and sample an FMA and six mul/add/sub; the coefficient and
+// state columns stream once, the input once per node row (or once when
+// shared) and the output once
+inline Cost filterBlock(size_t nodes, size_t sections, size_t n, bool per_node_input) {
+    return {8 * sections * n * nodes,
+            7 * sizeof(float) * sections * nodes + sizeof(float) * n * (nodes + (per_node_input ? nodes : 1))};
+}
+
+} // namespace kernel_work
@@ -0,0 +1,53 @@
+#include "latency_histogram.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+uint64_t LatencySnapshot::percentile(double p) const {
+    if (count == 0) return 0;
+    p = std::min(std::max(p, 0.0), 1.0);
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p * static_cast<double>(count))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); i++) {
+        seen += counts[i];
+        if (seen >= rank) return std::min(LatencyHistogram::bucketUpperBound(i), max_ns);
+    }
+    return max_ns;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < kSubBuckets) return index;
+    const size_t offset = index - kSubBuckets;
+    const unsigned shift = static_cast<unsigned>(offset / (kSubBuckets / 2)) + 1;
+    const uint64_t sub = offset % (kSubBuckets / 2) + kSubBuckets / 2;
+    return ((sub + 1) << shift) - 1;
+}
+
+LatencySnapshot LatencyHistogram::snapshot() const {
+    LatencySnapshot s;
+    s.counts.resize(kBucketCount);
+    for (size_t i = 0; i < kBucketCount; i++) {
+        s.counts[i] = counts_[i].load(std::memory_order_relaxed);
+        s.count += s.counts[i];
+    }
+    if (s.count == 0) return s;
+
+    // A reset racing the bucket pass can leave min unset; keep min <= max
+    const uint64_t low = min_ns_.load(std::memory_order_relaxed);
+    const uint64_t high = max_ns_.load(std::memory_order_relaxed);
+    s.max_ns = high;
+    s.min_ns = std::min(low, high);
+    s.mean_ns = static_cast<double>(sum_ns_.load(std::memory_order_relaxed)) / static_cast<double>(s.count);
+    s.p50_ns = s.percentile(0.50);
+    s.p90_ns = s.percentile(0.90);
+    s.p99_ns = s.percentile(0.99);
+    s.p999_ns = s.percentile(0.999);
+    return s;
+}
+
+void LatencyHistogram::reset() {
+    for (auto& bucket : counts_) bucket.exchange(0, std::memory_order_relaxed);
+    sum_ns_.exchange(0, std::memory_order_relaxed);
+    min_ns_.exchange(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    max_ns_.exchange(0, std::memory_order_relaxed);
+}
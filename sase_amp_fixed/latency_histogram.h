@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Distribution of a LatencyHistogram at one point in time
+struct LatencySnapshot {
+    uint64_t count = 0;
+    uint64_t min_ns = 0;
+    uint64_t max_ns = 0;
+    double mean_ns = 0.0;
+    uint64_t p50_ns = 0;
+    uint64_t p90_ns = 0;
+    uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    std::vector<uint64_t> counts;  // Per bucket, see LatencyHistogram::bucketIndex
+
+    // Upper bound of the bucket holding the p-quantile (p in [0, 1]),
+    // capped at max_ns; 0 for an empty snapshot.
+    uint64_t percentile(double p) const;
+};
+
+// Lock-free log-linear latency histogram in the HDR layout.
+//
+// Values below kSubBuckets nanoseconds get one bucket each; above that every
+// power of two is split into kSubBuckets / 2 equal buckets, so a recorded
+// value is known to within 1/64 (about 1.6%) across the whole range.
+// Values beyond kMaxValueNs land in the last bucket (max_ns stays exact).
+//
+// record() is a handful of relaxed atomic operations on fixed storage and
+// may run on any number of threads. reset() zeroes the buckets one by one
+// with atomic exchanges while recording continues: a value recorded during
+// the reset is either counted in full or dropped, never torn, and snapshot()
+// reads the same way.
+class LatencyHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 7;
+    static constexpr uint64_t kSubBuckets = uint64_t{1} << kSubBucketBits;
+    static constexpr unsigned kMaxExponent = 40;  // ~18 minutes in ns
+    static constexpr uint64_t kMaxValueNs = (uint64_t{1} << kMaxExponent) - 1;
+    static constexpr size_t kBucketCount =
+        kSubBuckets + (kMaxExponent - kSubBucketBits) * (kSubBuckets / 2);
+
+    LatencyHistogram() { reset(); }
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    void record(uint64_t ns) {
+        counts_[bucketIndex(ns)].fetch_add(1, std::memory_order_relaxed);
+        sum_ns_.fetch_add(ns, std::memory_order_relaxed);
+        uint64_t seen = max_ns_.load(std::memory_order_relaxed);
+        while (ns > seen && !max_ns_.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+        }
+        seen = min_ns_.load(std::memory_order_relaxed);
+        while (ns < seen && !min_ns_.compare_exchange_weak(seen, ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    LatencySnapshot snapshot() const;
+    void reset();
+
+    static size_t bucketIndex(uint64_t ns) {
+        if (ns < kSubBuckets) return static_cast<size_t>(ns);
+        if (ns > kMaxValueNs) ns = kMaxValueNs;
+        // Shift that brings ns into [kSubBuckets / 2, kSubBuckets)
+        const unsigned shift = highestBit(ns) - (kSubBucketBits - 1);
+        return static_cast<size_t>(kSubBuckets + (shift - 1) * (kSubBuckets / 2) +
+                                   ((ns >> shift) - kSubBuckets / 2));
+    }
+
+    // Largest value that maps to bucket index
+    static uint64_t bucketUpperBound(size_t index);
+
+private:
+    static unsigned highestBit(uint64_t v) {
+#if defined(__GNUC__) || defined(__clang__)
+        return 63u - static_cast<unsigned>(__builtin_clzll(v));
+#else
+        unsigned bit = 0;
+        while (v >>= 1) bit++;
+        return bit;
+#endif
+    }
+
+    std::atomic<uint64_t> counts_[kBucketCount];
+    std::atomic<uint64_t> sum_ns_;
+    std::atomic<uint64_t> min_ns_;
+    std::atomic<uint64_t> max_ns_;
+};
@@ -0,0 +1,337 @@
+#include "metrics_codec.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+constexpr uint8_t kFlagDelta = 1;
+constexpr uint8_t kBlockRaw = 0;
+constexpr uint8_t kBlockXor = 1;
+constexpr uint8_t kBlockSame = 2;
+
+// Byte offset and width of each MetricsRecord field, in layout order
+struct FieldSpan {
+    size_t offset;
+    size_t bytes;
+};
+const FieldSpan kFields[kMetricsCodecFields] = {
+    {offsetof(MetricsRecord, frame_id), 8},        {offsetof(MetricsRecord, timestamp), 8},
+    {offsetof(MetricsRecord, ici), 8},             {offsetof(MetricsRecord, phase_coherence), 8},
+    {offsetof(MetricsRecord, spectral_centroid), 8}, {offsetof(MetricsRecord, criticality), 8},
+    {offsetof(MetricsRecord, consciousness_level), 8}, {offsetof(MetricsRecord, phi_phase), 8},
+    {offsetof(MetricsRecord, phi_depth), 8},       {offsetof(MetricsRecord, latency_ms), 8},
+    {offsetof(MetricsRecord, cpu_load), 8},        {offsetof(MetricsRecord, state), 4},
+    {offsetof(MetricsRecord, flags), 4},           {offsetof(MetricsRecord, trace_id), 8},
+    {offsetof(MetricsRecord, origin_ns), 8},
+};
+
+// Field value as an integer of its width
+uint64_t fieldBits(const MetricsRecord& r, size_t field) {
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(&r) + kFields[field].offset;
+    if (kFields[field].bytes == 4) {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+    uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+void setFieldBits(MetricsRecord& r, size_t field, uint64_t bits) {
+    unsigned char* p = reinterpret_cast<unsigned char*>(&r) + kFields[field].offset;
+    if (kFields[field].bytes == 4) {
+        const uint32_t v = static_cast<uint32_t>(bits);
+        std::memcpy(p, &v, 4);
+    } else {
+        std::memcpy(p, &bits, 8);
+    }
+}
+
+uint32_t floatBits(float f) {
+    uint32_t v;
+    std::memcpy(&v, &f, 4);
+    return v;
+}
+
+float bitsFloat(uint32_t v) {
+    float f;
+    std::memcpy(&f, &v, 4);
+    return f;
+}
+
+void putLE(std::vector<uint8_t>& out, uint64_t v, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void putVarint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+void putBlock(std::vector<uint8_t>& out, const std::vector<float>& values, const std::vector<float>* base) {
+    if (!base || base->size() != values.size()) {
+        out.push_back(kBlockRaw);
+        for (float v : values) putLE(out, floatBits(v), 4);
+        return;
+    }
+    if (std::memcmp(values.data(), base->data(), values.size() * sizeof(float)) == 0) {
+        out.push_back(kBlockSame);
+        return;
+    }
+    out.push_back(kBlockXor);
+    uint32_t unchanged = 0;
+    for (size_t i = 0; i < values.size(); i++) {
+        const uint32_t change = floatBits(values[i]) ^ floatBits((*base)[i]);
+        if (change == 0) {
+            unchanged++;
+            continue;
+        }
+        putVarint(out, unchanged);
+        putVarint(out, change);
+        unchanged = 0;
+    }
+    if (unchanged) putVarint(out, unchanged);
+}
+
+void encodeFrame(uint32_t sequence, const MetricsPayload& frame, uint32_t base_sequence, const MetricsPayload* base,
+                 std::vector<uint8_t>& out) {
+    out.clear();
+    out.push_back('D');
+    out.push_back('M');
+    out.push_back(kMetricsCodecVersion);
+    out.push_back(base ? kFlagDelta : 0);
+    putLE(out, sequence, 4);
+    putLE(out, base ? base_sequence : 0, 4);
+
+    uint16_t mask = 0;
+    for (size_t f = 0; f < kMetricsCodecFields; f++) {
+        if (!base || fieldBits(frame.record, f) != fieldBits(base->record, f)) mask |= uint16_t(1u << f);
+    }
+    putLE(out, mask, 2);
+    for (size_t f = 0; f < kMetricsCodecFields; f++) {
+        if (mask & (1u << f)) putLE(out, fieldBits(frame.record, f), kFields[f].bytes);
+    }
+
+    putLE(out, frame.matrix_channels, 4);
+    putBlock(out, frame.ici_matrix, base ? &base->ici_matrix : nullptr);
+    out.push_back(static_cast<uint8_t>(frame.arrays.size()));
+    for (size_t a = 0; a < frame.arrays.size(); a++) {
+        putLE(out, frame.arrays[a].size(), 4);
+        putBlock(out, frame.arrays[a], base && a < base->arrays.size() ? &base->arrays[a] : nullptr);
+    }
+}
+
+uint64_t makeKey(uint32_t sequence, const uint32_t* base) {
+    return (uint64_t(sequence) << 32) | (base ? uint64_t(*base) + 1 : 0);
+}
+
+// Bounds-checked little-endian reader over one message
+class Reader {
+public:
+    Reader(const uint8_t* data, size_t bytes) : p_(data), end_(data + bytes) {}
+
+    bool done() const { return p_ == end_; }
+
+    uint64_t le(size_t bytes) {
+        need(bytes);
+        uint64_t v = 0;
+        for (size_t i = 0; i < bytes; i++) v |= uint64_t(p_[i]) << (8 * i);
+        p_ += bytes;
+        return v;
+    }
+
+    uint32_t varint() {
+        uint32_t v = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            const uint8_t byte = static_cast<uint8_t>(le(1));
+            v |= uint32_t(byte & 0x7f) << shift;
+            if (!(byte & 0x80)) return v;
+        }
+        throw std::runtime_error("metrics frame: bad varint");
+    }
+
+    void block(std::vector<float>& values, size_t count, const std::vector<float>* base) {
+        const uint8_t mode = static_cast<uint8_t>(le(1));
+        if (mode == kBlockRaw) {
+            need(count * 4);
+            values.resize(count);
+            for (size_t i = 0; i < count; i++) values[i] = bitsFloat(static_cast<uint32_t>(le(4)));
+            return;
+        }
+        if (!base || base->size() != count) throw std::runtime_error("metrics frame: block has no base");
+        if (mode == kBlockSame) {
+            values = *base;
+        } else if (mode == kBlockXor) {
+            values = *base;
+            for (size_t i = 0; i < count;) {
+                const uint32_t unchanged = varint();
+                if (unchanged > count - i) throw std::runtime_error("metrics frame: bad run");
+                i += unchanged;
+                if (i < count) {
+                    values[i] = bitsFloat(varint() ^ floatBits((*base)[i]));
+                    i++;
+                }
+            }
+        } else {
+            throw std::runtime_error("metrics frame: bad block mode " + std::to_string(mode));
+        }
+    }
+
+private:
+    void need(size_t bytes) const {
+        if (static_cast<size_t>(end_ - p_) < bytes) throw std::runtime_error("metrics frame: truncated");
+    }
+
+    const uint8_t* p_;
+    const uint8_t* end_;
+};
+
+} // namespace
+
+MetricsFrameEncoder::MetricsFrameEncoder(size_t history, bool acknowledge_on_send)
+    : history_(history), acknowledge_on_send_(acknowledge_on_send) {
+    if (history_ == 0) throw std::invalid_argument("the frame history must hold at least one frame");
+}
+
+uint32_t MetricsFrameEncoder::addFrame(MetricsPayload payload) {
+    if (payload.arrays.size() > 255) throw std::invalid_argument("a frame carries at most 255 arrays");
+    if (payload.ici_matrix.size() != size_t(payload.matrix_channels) * payload.matrix_channels) {
+        throw std::invalid_argument("ici_matrix must hold matrix_channels^2 values");
+    }
+    const uint32_t sequence = next_sequence_++;
+    frames_.push_back({sequence, std::move(payload)});
+    if (frames_.size() > history_) {
+        frames_.pop_front();
+        // Encodings of the dropped frame, or against it, are dead
+        const uint32_t oldest = frames_.front().sequence;
+        for (auto it = cache_.begin(); it != cache_.end();) {
+            const uint32_t seq = static_cast<uint32_t>(it->first >> 32);
+            const uint64_t base = it->first & 0xffffffffull;
+            if (seq < oldest || (base != 0 && base - 1 < oldest)) {
+                it = cache_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return sequence;
+}
+
+uint32_t MetricsFrameEncoder::addClient() {
+    const uint32_t id = next_client_++;
+    Client client;
+    client.next = next_sequence_;
+    clients_[id] = client;
+    return id;
+}
+
+void MetricsFrameEncoder::removeClient(uint32_t client) {
+    clients_.erase(client);
+}
+
+void MetricsFrameEncoder::acknowledge(uint32_t client, uint32_t sequence) {
+    auto it = clients_.find(client);
+    if (it == clients_.end()) return;
+    Client& c = it->second;
+    if (sequence >= c.next || (c.acked && sequence <= c.base)) return;
+    c.acked = true;
+    c.base = sequence;
+}
+
+const MetricsFrameEncoder::Frame* MetricsFrameEncoder::find(uint32_t sequence) const {
+    if (frames_.empty() || sequence < frames_.front().sequence || sequence > frames_.back().sequence) return nullptr;
+    return &frames_[sequence - frames_.front().sequence];
+}
+
+const std::vector<uint8_t>& MetricsFrameEncoder::encode(uint32_t sequence, const uint32_t* base) {
+    const Frame* frame = find(sequence);
+    const Frame* base_frame = base ? find(*base) : nullptr;
+    if (!frame || (base && !base_frame)) throw std::out_of_range("frame not in the encoder history");
+
+    auto [it, inserted] = cache_.try_emplace(makeKey(sequence, base));
+    if (!inserted) {
+        cache_hits_++;
+        return it->second;
+    }
+    encodeFrame(sequence, frame->payload, base ? *base : 0, base_frame ? &base_frame->payload : nullptr, it->second);
+    bytes_encoded_ += it->second.size();
+    return it->second;
+}
+
+std::vector<uint8_t> MetricsFrameEncoder::encodeFor(uint32_t client) {
+    auto it = clients_.find(client);
+    if (it == clients_.end()) throw std::out_of_range("unknown metrics client " + std::to_string(client));
+    Client& c = it->second;
+    std::vector<uint8_t> message;
+    if (frames_.empty()) return message;
+
+    const uint32_t oldest = frames_.front().sequence;
+    if (c.acked && c.base < oldest) c.acked = false;  // Its base fell out; start over
+    for (uint32_t seq = std::max(c.next, oldest); seq < next_sequence_; seq++) {
+        const std::vector<uint8_t>& bytes = encode(seq, c.acked ? &c.base : nullptr);
+        message.insert(message.end(), bytes.begin(), bytes.end());
+        if (acknowledge_on_send_) {
+            c.acked = true;
+            c.base = seq;
+        }
+    }
+    c.next = next_sequence_;
+    return message;
+}
+
+MetricsFrameDecoder::MetricsFrameDecoder(size_t history) : history_(history) {
+    if (history_ == 0) throw std::invalid_argument("the frame history must hold at least one frame");
+}
+
+void MetricsFrameDecoder::decode(const uint8_t* data, size_t bytes,
+                                 std::vector<std::pair<uint32_t, MetricsPayload>>& out) {
+    Reader in(data, bytes);
+    while (!in.done()) {
+        if (in.le(1) != 'D' || in.le(1) != 'M') throw std::runtime_error("metrics frame: bad magic");
+        const uint64_t version = in.le(1);
+        if (version != kMetricsCodecVersion) {
+            throw std::runtime_error("metrics frame: unsupported version " + std::to_string(version));
+        }
+        const bool delta = (in.le(1) & kFlagDelta) != 0;
+        const uint32_t sequence = static_cast<uint32_t>(in.le(4));
+        const uint32_t base_sequence = static_cast<uint32_t>(in.le(4));
+
+        const MetricsPayload* base = nullptr;
+        if (delta) {
+            for (const auto& frame : frames_) {
+                if (frame.first == base_sequence) base = &frame.second;
+            }
+            if (!base) throw std::runtime_error("metrics frame: base " + std::to_string(base_sequence) + " not kept");
+        }
+
+        MetricsPayload frame;
+        if (base) frame.record = base->record;
+        const uint64_t mask = in.le(2);
+        for (size_t f = 0; f < kMetricsCodecFields; f++) {
+            if (mask & (1u << f)) {
+                setFieldBits(frame.record, f, in.le(kFields[f].bytes));
+            } else if (!base) {
+                throw std::runtime_error("metrics frame: keyframe is missing fields");
+            }
+        }
+
+        frame.matrix_channels = static_cast<uint32_t>(in.le(4));
+        in.block(frame.ici_matrix, size_t(frame.matrix_channels) * frame.matrix_channels,
+                 base ? &base->ici_matrix : nullptr);
+        frame.arrays.resize(static_cast<size_t>(in.le(1)));
+        for (size_t a = 0; a < frame.arrays.size(); a++) {
+            const size_t length = static_cast<size_t>(in.le(4));
+            in.block(frame.arrays[a], length, base && a < base->arrays.size() ? &base->arrays[a] : nullptr);
+        }
+
+        frames_.emplace_back(sequence, frame);
+        if (frames_.size() > history_) frames_.pop_front();
+        out.emplace_back(sequence, std::move(frame));
+    }
+}
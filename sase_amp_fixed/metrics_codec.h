@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <unordered_map>
+#include <vector>
+#include "shared_state.h"
+
+// One metrics frame to stream: a MetricsRecord (the fields of
+// server/metrics_frame.py MetricsFrame) plus an optional ICI matrix and
+// per-channel arrays
+struct MetricsPayload {
+    MetricsRecord record{};
+    uint32_t matrix_channels = 0;            // ici_matrix is [channels x channels], row-major
+    std::vector<float> ici_matrix;
+    std::vector<std::vector<float>> arrays;  // Per-channel arrays, in an order client and server agree on
+};
+
+// Binary metrics frame, version 2, little-endian:
+//
+//   0   'D' 'M'
+//   2   u8  version
+//   3   u8  flags: bit 0 set for a delta frame
+//   4   u32 sequence
+//   8   u32 base sequence the delta applies to (0 for a keyframe)
+//   12  u16 field mask, bit i for record field i in layout order
+//           (frame_id, timestamp, ici, ..., cpu_load, state, flags,
+//           trace_id, origin_ns)
+//   14  the masked fields: u64 frame_id, f64 values, u32 state and flags,
+//       u64 trace_id, i64 origin_ns
+//       u32 matrix channels C, then the matrix as a block of C * C values
+//       u8  array count A, then per array a u32 length and a block
+//
+// A keyframe carries every field and raw blocks. A delta carries the fields
+// whose bits differ from the base frame's, and encodes each block against
+// the base's block of the same length by its mode byte:
+//
+//   0  raw: the float32 values
+//   1  xor: per changed value, LEB128 varints of the count of unchanged
+//      values before it and of its bits XOR the base value's bits (few
+//      bytes for a small change), then the count of trailing unchanged
+//      values if there are any
+//   2  unchanged: no values follow
+//
+// A block with no base of its length (or in a keyframe) is raw. Several
+// frames may be concatenated into one message; each is self-delimiting.
+constexpr uint8_t kMetricsCodecVersion = 2;   // 2: trace_id and origin_ns
+constexpr size_t kMetricsCodecFields = 15;
+
+// Encodes frames for many clients, each against the last frame that client
+// acknowledged. Frames are added once per tick; a client's bytes for a
+// frame depend only on its base, so clients that acknowledged the same
+// frame share one encoding, cached until the frame leaves the history.
+//
+// A client with no acknowledged frame in the history gets keyframes. With
+// acknowledge_on_send, sending counts as acknowledging (fine for an ordered,
+// reliable transport such as a WebSocket, where a reconnect is a new
+// client); otherwise clients report what they decoded with acknowledge().
+// Not thread safe.
+class MetricsFrameEncoder {
+public:
+    // Throws std::invalid_argument for an empty history
+    explicit MetricsFrameEncoder(size_t history = 128, bool acknowledge_on_send = false);
+
+    // Adds the next frame and returns its sequence number
+    uint32_t addFrame(MetricsPayload payload);
+
+    uint32_t addClient();
+    void removeClient(uint32_t client);
+    // Marks sequence as decoded by the client; ignored unless it is newer
+    // than the client's last acknowledgment and was sent to it
+    void acknowledge(uint32_t client, uint32_t sequence);
+
+    // Frames added since the last call for this client (the oldest still in
+    // the history, if it fell behind), concatenated; empty when there are
+    // none. Throws std::out_of_range for an unknown client.
+    std::vector<uint8_t> encodeFor(uint32_t client);
+
+    // One frame against base (a sequence in the history), or as a keyframe
+    // when base is null. Throws std::out_of_range for frames not in the
+    // history.
+    const std::vector<uint8_t>& encode(uint32_t sequence, const uint32_t* base);
+
+    size_t historySize() const { return history_; }
+    size_t clientCount() const { return clients_.size(); }
+    uint32_t nextSequence() const { return next_sequence_; }
+    uint64_t bytesEncoded() const { return bytes_encoded_; }
+    uint64_t cacheHits() const { return cache_hits_; }
+
+private:
+    struct Frame {
+        uint32_t sequence;
+        MetricsPayload payload;
+    };
+    struct Client {
+        uint32_t next = 0;   // First sequence not yet sent
+        bool acked = false;
+        uint32_t base = 0;   // Last acknowledged sequence, when acked
+    };
+
+    const Frame* find(uint32_t sequence) const;
+
+    size_t history_;
+    bool acknowledge_on_send_;
+    std::deque<Frame> frames_;
+    uint32_t next_sequence_ = 0;
+    uint32_t next_client_ = 0;
+    std::unordered_map<uint32_t, Client> clients_;
+    // Encodings by (sequence << 32 | base + 1), base + 1 = 0 for a keyframe
+    std::map<uint64_t, std::vector<uint8_t>> cache_;
+    uint64_t bytes_encoded_ = 0;
+    uint64_t cache_hits_ = 0;
+};
+
+// Client side: rebuilds frames from keyframes and deltas. Keeps the last
+// `history` decoded frames as bases, which must cover the frames the client
+// acknowledges and the server may still encode against.
+class MetricsFrameDecoder {
+public:
+    explicit MetricsFrameDecoder(size_t history = 128);
+
+    // Decodes every frame in a message, oldest first, into out (appended).
+    // Throws std::runtime_error for a malformed message or a delta whose
+    // base is not in the history.
+    void decode(const uint8_t* data, size_t bytes, std::vector<std::pair<uint32_t, MetricsPayload>>& out);
+
+private:
+    size_t history_;
+    std::deque<std::pair<uint32_t, MetricsPayload>> frames_;
+};
@@ -0,0 +1,162 @@
+#include "mission_checkpoint.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include "timeline_trace.h"
+
+namespace {
+
+// Storage copy piece per pool task: large enough to stream, small enough to
+// spread a bank of a few MB over every worker
+constexpr size_t kCopyPiece = size_t(1) << 20;
+
+const timeline_trace::EventKind kCaptureKind{"checkpoint_capture", "bytes", "step"};
+const timeline_trace::EventKind kWriteKind{"checkpoint_write", "bytes", "step"};
+
+double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Replaces to with from; rename() does not replace on Windows
+bool replaceFile(const std::string& from, const std::string& to) {
+#ifdef _WIN32
+    std::remove(to.c_str());
+#endif
+    return std::rename(from.c_str(), to.c_str()) == 0;
+}
+
+} // namespace
+
+MissionCheckpointer::~MissionCheckpointer() {
+    if (!thread_.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_one();
+    thread_.join();
+}
+
+void MissionCheckpointer::configure(const CheckpointConfig& config) {
+    if (config.interval_steps > 0 && config.path.empty()) {
+        throw std::invalid_argument("checkpoint interval set without a path");
+    }
+    if (config.compress && !snapshotCompressionAvailable()) {
+        throw std::runtime_error("compressed checkpoints need a build with DASE_WITH_ZLIB");
+    }
+    flush();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        path_ = config.path;
+        compress_ = config.compress;
+        interval_steps_ = config.interval_steps;
+        stats_ = CheckpointStats();
+    }
+    if (interval_steps_ == 0) {
+        standby_ = NodeBank();
+    } else if (!thread_.joinable()) {
+        thread_ = std::thread([this] { run(); });
+    }
+}
+
+CheckpointConfig MissionCheckpointer::config() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    CheckpointConfig config;
+    config.path = path_;
+    config.interval_steps = interval_steps_;
+    config.compress = compress_;
+    return config;
+}
+
+// The full copy here faults the standby pages in, so captures only stream
+void MissionCheckpointer::beginMission(const NodeBank& bank, uint64_t first_step) {
+    if (!enabled()) return;
+    flush();
+    standby_ = bank;
+    next_due_ = first_step + interval_steps_;
+}
+
+bool MissionCheckpointer::due(uint64_t step) {
+    if (!enabled() || step < next_due_) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (pending_) {
+        stats_.deferred++;
+        return false;
+    }
+    return true;
+}
+
+void MissionCheckpointer::capture(WorkerPool& pool, const NodeBank& bank, const SnapshotMeta& meta) {
+    const auto start = std::chrono::steady_clock::now();
+    const size_t bytes = bank.storageBytes();
+    timeline_trace::Scope trace(timeline_trace::TraceLevel::Regions, kCaptureKind, bytes, meta.mission_step);
+    const unsigned char* from = bank.storage();
+    unsigned char* to = standby_.storage();
+    pool.parallelFor((bytes + kCopyPiece - 1) / kCopyPiece, 1, [&](size_t begin, size_t end, unsigned) {
+        const size_t first = begin * kCopyPiece;
+        std::memcpy(to + first, from + first, std::min(end * kCopyPiece, bytes) - first);
+    });
+    standby_meta_ = meta;
+    next_due_ = meta.mission_step + interval_steps_;
+
+    const double stall_ms = msSince(start);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_ = true;
+        stats_.captured++;
+        stats_.last_stall_ms = stall_ms;
+        stats_.max_stall_ms = std::max(stats_.max_stall_ms, stall_ms);
+    }
+    work_cv_.notify_one();
+}
+
+void MissionCheckpointer::flush() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [&] { return !pending_; });
+}
+
+CheckpointStats MissionCheckpointer::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+void MissionCheckpointer::run() {
+    timeline_trace::setThreadName("dase checkpoints");
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        // A captured checkpoint is written before a stop takes effect
+        work_cv_.wait(lock, [&] { return pending_ || stop_; });
+        if (!pending_) return;
+
+        const std::string path = path_;
+        const bool compress = compress_;
+        lock.unlock();
+        const auto start = std::chrono::steady_clock::now();
+        std::string error;
+        try {
+            timeline_trace::Scope trace(timeline_trace::TraceLevel::Regions, kWriteKind, standby_.storageBytes(),
+                                        standby_meta_.mission_step);
+            const std::string temp = path + ".tmp";
+            saveSnapshot(temp, standby_, standby_meta_, compress);
+            if (!replaceFile(temp, path)) error = "checkpoint " + path + ": cannot replace the previous checkpoint";
+        } catch (const std::exception& e) {
+            error = e.what();
+        }
+        const double write_ms = msSince(start);
+        lock.lock();
+
+        stats_.last_write_ms = write_ms;
+        if (error.empty()) {
+            stats_.written++;
+            stats_.last_step = standby_meta_.mission_step;
+            stats_.last_bytes = standby_.storageBytes();
+        } else {
+            stats_.failed++;
+            stats_.last_error = error;
+        }
+        pending_ = false;
+        done_cv_.notify_all();
+    }
+}
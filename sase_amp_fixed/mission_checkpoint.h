@@ -0,0 +1,95 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "node_bank.h"
+#include "state_snapshot.h"
+#include "worker_pool.h"
+
+// Periodic checkpoints of runMission
+struct CheckpointConfig {
+    std::string path;             // Snapshot file each checkpoint replaces
+    uint64_t interval_steps = 0;  // Mission steps between checkpoints; 0 turns them off
+    bool compress = false;        // gzip the file (builds with DASE_WITH_ZLIB only)
+};
+
+// Counters since the checkpointer was last configured
+struct CheckpointStats {
+    uint64_t captured = 0;       // Checkpoints taken at a step boundary
+    uint64_t written = 0;        // ... and completely on disk
+    uint64_t failed = 0;         // ... whose write failed (see last_error)
+    uint64_t deferred = 0;       // Due boundaries passed while the previous write ran
+    uint64_t last_step = 0;      // Mission step of the newest checkpoint on disk
+    uint64_t last_bytes = 0;     // Its size in memory (before any compression)
+    double last_stall_ms = 0.0;  // Mission time the newest capture took
+    double max_stall_ms = 0.0;
+    double last_write_ms = 0.0;  // Background time of the newest write
+    std::string last_error;
+};
+
+// Asynchronous checkpoints of a long mission.
+//
+// At a due step boundary, capture() copies the bank's storage block into a
+// standby bank, split over the worker pool, and hands it to an I/O thread
+// that writes it with saveSnapshot to path + ".tmp" and renames it over
+// path, so path always holds a whole checkpoint. The mission stalls only
+// for that copy (80 bytes a node at memory bandwidth); serialization,
+// compression and the disk run behind the following steps. There is one
+// standby bank: a boundary that comes due while the previous checkpoint is
+// still being written is deferred to the next one, so a slow disk stretches
+// the interval instead of stalling the mission.
+//
+// The I/O thread starts on the first configure() that enables checkpoints.
+class MissionCheckpointer {
+public:
+    MissionCheckpointer() = default;
+    // Finishes the write in flight, then joins the I/O thread
+    ~MissionCheckpointer();
+
+    MissionCheckpointer(const MissionCheckpointer&) = delete;
+    MissionCheckpointer& operator=(const MissionCheckpointer&) = delete;
+
+    // Waits for the write in flight and resets the stats. Throws
+    // std::invalid_argument for an interval without a path, and
+    // std::runtime_error for compress without DASE_WITH_ZLIB.
+    void configure(const CheckpointConfig& config);
+    CheckpointConfig config() const;
+    bool enabled() const { return interval_steps_ > 0; }
+
+    // Start of a mission whose step 0 is first_step: sizes the standby bank
+    // for bank (coordinates included, which a mission does not change) and
+    // makes the first checkpoint due interval_steps steps in
+    void beginMission(const NodeBank& bank, uint64_t first_step);
+    // True when step (mission steps done) is a boundary to capture at
+    bool due(uint64_t step);
+    // Copies bank into the standby bank and queues its write with meta, whose
+    // mission_step the caller has set to the step just done
+    void capture(WorkerPool& pool, const NodeBank& bank, const SnapshotMeta& meta);
+
+    // Waits until the checkpoint in flight is on disk
+    void flush();
+    CheckpointStats stats() const;
+
+private:
+    void run();
+
+    std::string path_;
+    bool compress_ = false;
+    uint64_t interval_steps_ = 0;
+    uint64_t next_due_ = 0;
+
+    NodeBank standby_;
+    SnapshotMeta standby_meta_;
+    bool pending_ = false;  // standby_ holds a checkpoint not yet on disk
+    bool stop_ = false;
+    CheckpointStats stats_;
+
+    mutable std::mutex mutex_;      // pending_, stop_, stats_ and the config
+    std::condition_variable work_cv_;  // I/O thread: a checkpoint was captured
+    std::condition_variable done_cv_;  // flush(): the write finished
+    std::thread thread_;
+};
@@ -0,0 +1,128 @@
+#include "multirate_groups.h"
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+
+void MultirateGroups::setGroups(std::vector<NodeGroup> groups, size_t num_nodes) {
+    std::sort(groups.begin(), groups.end(),
+              [](const NodeGroup& a, const NodeGroup& b) { return a.first_node < b.first_node; });
+    size_t covered = 0;
+    for (const NodeGroup& g : groups) {
+        if (g.rate_divisor == 0) throw std::invalid_argument("node group rate divisor must be at least 1");
+        if (g.num_nodes == 0) throw std::invalid_argument("node group must not be empty");
+        if (g.first_node < covered) throw std::invalid_argument("node groups overlap");
+        if (g.first_node + g.num_nodes > num_nodes) throw std::invalid_argument("node group past the last node");
+        if (g.first_node % 8 != 0 || (g.num_nodes % 8 != 0 && g.first_node + g.num_nodes != num_nodes)) {
+            throw std::invalid_argument("node groups must cover whole 8-node chunks");
+        }
+        covered = g.first_node + g.num_nodes;
+    }
+
+    groups_.clear();
+    std::map<unsigned, size_t> per_divisor, seen;
+    for (const NodeGroup& g : groups) per_divisor[g.rate_divisor]++;
+    for (const NodeGroup& g : groups) {
+        Group group;
+        group.config = g;
+        group.end_slot = NodeBank::paddedCount(g.first_node + g.num_nodes);
+        // Stagger the groups of one divisor over its D phases
+        group.next = seen[g.rate_divisor]++ * g.rate_divisor / per_divisor[g.rate_divisor];
+        groups_.push_back(std::move(group));
+    }
+
+    full_chunks_.clear();
+    size_t g = 0;
+    for (size_t c = 0; c < NodeBank::paddedCount(num_nodes) / 8; c++) {
+        while (g < groups_.size() && groups_[g].end_slot <= c * 8) g++;
+        if (g < groups_.size() && groups_[g].config.first_node <= c * 8) continue;
+        full_chunks_.push_back(static_cast<uint32_t>(c));
+    }
+}
+
+void MultirateGroups::clear() {
+    groups_.clear();
+    full_chunks_.clear();
+}
+
+std::vector<NodeGroup> MultirateGroups::groups() const {
+    std::vector<NodeGroup> configs;
+    for (const Group& g : groups_) configs.push_back(g.config);
+    return configs;
+}
+
+double MultirateGroups::workFraction(size_t num_nodes) const {
+    if (num_nodes == 0) return 1.0;
+    double steps = static_cast<double>(num_nodes);
+    for (const Group& g : groups_) {
+        steps -= static_cast<double>(g.config.num_nodes) * (1.0 - 1.0 / g.config.rate_divisor);
+    }
+    return steps / static_cast<double>(num_nodes);
+}
+
+void MultirateGroups::processBlock(WorkerPool& pool, const NodeKernels& kernels, NodeBank& bank,
+                                   const double* amplified, const float* boost, const float* in, float* out,
+                                   size_t n) {
+    for (Group& g : groups_) {
+        const size_t first = g.config.first_node;
+        const size_t nodes = g.config.num_nodes;
+        const size_t rate = g.config.rate_divisor;
+        if (g.lag.empty()) g.lag.assign(bank.current_output + first, bank.current_output + first + nodes);
+
+        const size_t count = g.next < n ? (n - 1 - g.next) / rate + 1 : 0;
+        g.amplified.resize(count);
+        g.boost.resize(count);
+        for (size_t k = 0; k < count; k++) {
+            g.amplified[k] = amplified[g.next + k * rate];
+            g.boost[k] = boost[g.next + k * rate];
+        }
+        g.steps.resize(nodes * count);
+        const float last_input = count > 0 ? in[g.next + (count - 1) * rate] : 0.0f;
+        if (g.ramp.size() != rate) {
+            g.ramp.resize(rate);
+            for (size_t j = 0; j < rate; j++) {
+                g.ramp[j] = static_cast<float>(rate - 1 - j) / static_cast<float>(rate);
+            }
+        }
+
+        pool.parallelFor((g.end_slot - first) / 8, 0, [&](size_t begin, size_t end, unsigned) {
+            const size_t lo = first + begin * 8;
+            const size_t hi = first + end * 8;
+            const size_t real_hi = std::min(hi, first + nodes);
+            float held[8 * 64];  // Outputs before the block, per node of the range
+            for (size_t base = lo; base < hi; base += 8 * 64) {
+                const size_t top = std::min(hi, base + 8 * 64);
+                const size_t real_top = std::min(top, real_hi);
+                for (size_t i = base; i < real_top; i++) held[i - base] = static_cast<float>(bank.current_output[i]);
+                if (count > 0) {
+                    kernels.block_f64(bank, base, top, g.amplified.data(), g.boost.data(), last_input,
+                                      g.steps.data(), count, first, nullptr);
+                }
+                for (size_t i = base; i < real_top; i++) {
+                    const float* steps = g.steps.data() + (i - first) * count;
+                    float prev = g.lag[i - first];
+                    float cur = held[i - base];
+                    if (!out) {
+                        if (count > 0) g.lag[i - first] = count > 1 ? steps[count - 2] : cur;
+                        continue;
+                    }
+                    // Ramp segments: the one left over from the last block,
+                    // then one per step, each cut at the end of the block
+                    float* row = out + i * n;
+                    const float* remaining = g.ramp.data() + rate - g.next;
+                    size_t t = 0;
+                    for (size_t k = 0; k <= count; k++) {
+                        const size_t stop = std::min(n, g.next + k * rate);
+                        const float delta = cur - prev;
+                        for (size_t j = 0; t < stop; j++, t++) row[t] = cur - delta * remaining[j];
+                        if (k == count) break;
+                        prev = cur;
+                        cur = steps[k];
+                        remaining = g.ramp.data();
+                    }
+                    g.lag[i - first] = prev;
+                }
+            }
+        });
+        g.next = g.next + count * rate - n;
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "node_bank.h"
+#include "node_kernels.h"
+#include "worker_pool.h"
+
+// Nodes [first_node, first_node + num_nodes) stepped once every rate_divisor
+// samples of a block
+struct NodeGroup {
+    size_t first_node = 0;
+    size_t num_nodes = 0;
+    unsigned rate_divisor = 1;
+};
+
+// Multirate scheduling of the engine block path.
+//
+// A group with divisor D runs the block kernel on every D-th sample of the
+// shared amplified and boost streams, so its cost per block is about 1/D of
+// a full-rate group's. The decimation phase carries over from block to
+// block, and groups sharing a divisor start at staggered phases, so their
+// steps spread over the samples (and, for blocks shorter than D, over the
+// blocks) instead of landing together. Consumers reading full-rate outputs
+// get each group node's steps linearly interpolated: the output ramps from
+// one step's value to the next over the D samples after the step, i.e. with
+// D - 1 samples of delay. A group's integrators advance once per step, so
+// its nodes respond as at a D times lower sample rate; with D = 1 a group
+// gives exactly the full-rate outputs. Nodes outside every group run at
+// full rate.
+class MultirateGroups {
+public:
+    // Groups must not overlap, must lie within num_nodes, must start on a
+    // multiple of 8 and span a multiple of 8 nodes unless they end the bank,
+    // and need a divisor of at least 1. Throws std::invalid_argument
+    // otherwise. Phases restart and the interpolation starts from the
+    // current outputs.
+    void setGroups(std::vector<NodeGroup> groups, size_t num_nodes);
+    void clear();
+    bool empty() const { return groups_.empty(); }
+    std::vector<NodeGroup> groups() const;
+
+    // Full-rate 8-node chunks, in order
+    const std::vector<uint32_t>& fullRateChunks() const { return full_chunks_; }
+
+    // Advances every group through a block of n samples whose shared streams
+    // the engine has computed (amplified[t], boost[t], as for block_f64);
+    // writes the interpolated outputs of group nodes into out (node-major,
+    // may be null)
+    void processBlock(WorkerPool& pool, const NodeKernels& kernels, NodeBank& bank, const double* amplified,
+                      const float* boost, const float* in, float* out, size_t n);
+
+    // Node steps a block of n samples costs relative to running every node
+    // at full rate, for reporting
+    double workFraction(size_t num_nodes) const;
+
+private:
+    struct Group {
+        NodeGroup config;
+        size_t end_slot = 0;           // Chunk-aligned end of the group's slots
+        size_t next = 0;               // First step's sample in the next block
+        std::vector<float> lag;        // Output before the last step, per node (empty until a block ran)
+        std::vector<double> amplified; // Decimated streams of the block
+        std::vector<float> boost;
+        std::vector<float> steps;      // [nodes x steps] outputs of the block
+        std::vector<float> ramp;       // Ramp left j samples after a step, (D - 1 - j) / D
+    };
+
+    std::vector<Group> groups_;
+    std::vector<uint32_t> full_chunks_;
+};
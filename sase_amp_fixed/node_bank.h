@@ -0,0 +1,378 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+// Hint that the cache line holding p is about to be read and written
+inline void prefetchLine(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p, 1, 3);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+// Struct-of-arrays storage for the cellular engine's node state.
+//
+// Every hot state variable lives in its own contiguous, cache-line aligned
+// column so kernels stream exactly the bytes they use. Grid coordinates and
+// ids are cold data and are kept in separate vectors, which may be implicit
+// (see setImplicitGrid) until something reads them as vectors. All columns are sized to
+// a multiple of kLanePadding (one cache line of Scalar) so vector kernels never
+// need a scalar tail. Scalar is the precision of the node state: double for the
+// reference engine, float for the float32 engine.
+//
+// Next to the dynamic state, every node carries its own parameters (input
+// gain, integrator time constant, output clamp bounds, spectral mix and
+// feedback gain) as columns of the same block, so the kernels load them like
+// state and a bank of differing nodes runs as fast as a uniform one. New and
+// zeroed nodes get the defaults below, which reproduce the engine's fixed
+// constants.
+template <typename Scalar>
+class BasicNodeBank {
+public:
+    using value_type = Scalar;
+
+    static constexpr size_t kAlignment = 64;
+    static constexpr size_t kLanePadding = kAlignment / sizeof(Scalar);
+
+    static constexpr Scalar kDefaultInputGain = Scalar(1);
+    static constexpr Scalar kDefaultTimeConstant = Scalar(0.1);
+    static constexpr Scalar kDefaultClampLow = Scalar(-10);
+    static constexpr Scalar kDefaultClampHigh = Scalar(10);
+    static constexpr Scalar kDefaultSpectralMix = Scalar(1);
+
+    BasicNodeBank() = default;
+    explicit BasicNodeBank(size_t num_nodes) { resize(num_nodes); }
+
+    BasicNodeBank(const BasicNodeBank& other) { copyFrom(other); }
+    BasicNodeBank& operator=(const BasicNodeBank& other) {
+        if (this != &other) {
+            release();
+            copyFrom(other);
+        }
+        return *this;
+    }
+
+    BasicNodeBank(BasicNodeBank&& other) noexcept { swap(other); }
+    BasicNodeBank& operator=(BasicNodeBank&& other) noexcept {
+        if (this != &other) {
+            release();
+            swap(other);
+        }
+        return *this;
+    }
+
+    ~BasicNodeBank() { release(); }
+
+    // Reallocates all columns for num_nodes nodes and zeroes the state.
+    void resize(size_t num_nodes) {
+        release();
+        size_ = num_nodes;
+        capacity_ = paddedCount(num_nodes);
+        if (capacity_ > 0) {
+            storage_bytes_ = storageBytesFor(capacity_);
+            storage_ = static_cast<unsigned char*>(
+                ::operator new(storage_bytes_, std::align_val_t(kAlignment)));
+            std::memset(storage_, 0, storage_bytes_);
+            bindColumns();
+            defaultParameters(0, capacity_);
+        }
+        x.assign(num_nodes, 0);
+        y.assign(num_nodes, 0);
+        z.assign(num_nodes, 0);
+        node_id.assign(num_nodes, 0);
+    }
+
+    // Reallocates the columns for num_nodes nodes without touching them, so
+    // the caller can zero them with zeroRange from the threads that will
+    // sweep each range (pages land on the NUMA node that first writes them).
+    // The cold columns become implicit: a 10 x 10 grid and index ids.
+    void allocate(size_t num_nodes) {
+        release();
+        size_ = num_nodes;
+        capacity_ = paddedCount(num_nodes);
+        if (capacity_ > 0) {
+            storage_bytes_ = storageBytesFor(capacity_);
+            storage_ = static_cast<unsigned char*>(
+                ::operator new(storage_bytes_, std::align_val_t(kAlignment)));
+            bindColumns();
+        }
+        setImplicitGrid(10, 10);
+        node_id.clear();
+        implicit_ids_ = true;
+    }
+
+    // Zeroes the state and feedback columns over nodes [begin, end) of
+    // capacity() and gives the other parameters their defaults
+    void zeroRange(size_t begin, size_t end) {
+        if (begin >= end) return;
+        const size_t count = end - begin;
+        std::memset(operation_count + begin, 0, count * sizeof(uint64_t));
+        std::memset(integrator_state + begin, 0, count * sizeof(Scalar));
+        std::memset(feedback_gain + begin, 0, count * sizeof(Scalar));
+        std::memset(current_output + begin, 0, count * sizeof(Scalar));
+        std::memset(previous_input + begin, 0, count * sizeof(Scalar));
+        defaultParameters(begin, end);
+    }
+
+    // Default input gain, time constant, clamp bounds and spectral mix over
+    // nodes [begin, end) of capacity(); feedback is left alone
+    void defaultParameters(size_t begin, size_t end) {
+        for (size_t i = begin; i < end; i++) {
+            input_gain[i] = kDefaultInputGain;
+            time_constant[i] = kDefaultTimeConstant;
+            clamp_low[i] = kDefaultClampLow;
+            clamp_high[i] = kDefaultClampHigh;
+            spectral_mix[i] = kDefaultSpectralMix;
+        }
+    }
+
+    // Switches to different storage of the same layout and size, e.g. a
+    // shared segment or an arena, keeping the cold columns. The state is not
+    // copied; `owner` keeps the storage alive.
+    void rebindStorage(unsigned char* storage, std::shared_ptr<void> owner) {
+        if (storage_ && !external_owner_) {
+            ::operator delete(storage_, std::align_val_t(kAlignment));
+        }
+        storage_ = storage;
+        external_owner_ = std::move(owner);
+        bindColumns();
+    }
+
+    // Binds the state columns to storageBytesFor(paddedCount(num_nodes))
+    // bytes at 64-byte alignment that `owner` keeps alive (e.g. a file
+    // mapping), laid out as bindColumns() expects. Nothing is copied or
+    // zeroed; the coordinate vectors are resized and zeroed as in resize().
+    // Copies of the bank own their storage again.
+    void adoptStorage(size_t num_nodes, unsigned char* storage, std::shared_ptr<void> owner) {
+        release();
+        size_ = num_nodes;
+        capacity_ = paddedCount(num_nodes);
+        storage_bytes_ = storageBytesFor(capacity_);
+        storage_ = storage;
+        external_owner_ = std::move(owner);
+        bindColumns();
+        x.assign(num_nodes, 0);
+        y.assign(num_nodes, 0);
+        z.assign(num_nodes, 0);
+        node_id.assign(num_nodes, 0);
+    }
+
+    // Zeroes the dynamic state of every node; parameters and coordinates stay.
+    void resetState() {
+        if (capacity_ == 0) return;
+        std::memset(integrator_state, 0, capacity_ * sizeof(Scalar));
+        std::memset(current_output, 0, capacity_ * sizeof(Scalar));
+        std::memset(previous_input, 0, capacity_ * sizeof(Scalar));
+        std::memset(operation_count, 0, capacity_ * sizeof(uint64_t));
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    size_t bytesAllocated() const {
+        return storage_bytes_ + (x.size() + y.size() + z.size()) * sizeof(int16_t) + node_id.size() * sizeof(uint16_t);
+    }
+
+    // Makes x, y and z follow an nx x ny grid in node order (x = i % nx,
+    // y = i / nx % ny, z = i / (nx * ny)) without storing them; node_id is
+    // left as it is
+    void setImplicitGrid(size_t nx, size_t ny) {
+        implicit_nx_ = nx;
+        implicit_ny_ = ny;
+        x.clear();
+        y.clear();
+        z.clear();
+    }
+    bool coldImplicit() const { return implicit_nx_ != 0 || implicit_ids_; }
+
+    // Fills the cold vectors from their implicit form; call it before using
+    // x, y, z or node_id as vectors. Logically const: the vectors are a cache.
+    void materializeCold() const {
+        if (implicit_nx_ != 0) {
+            x.resize(size_);
+            y.resize(size_);
+            z.resize(size_);
+            // Counters instead of a divide per node
+            size_t cx = 0, cy = 0, cz = 0;
+            for (size_t i = 0; i < size_; i++) {
+                x[i] = static_cast<int16_t>(cx);
+                y[i] = static_cast<int16_t>(cy);
+                z[i] = static_cast<int16_t>(cz);
+                if (++cx == implicit_nx_) {
+                    cx = 0;
+                    if (++cy == implicit_ny_) {
+                        cy = 0;
+                        cz++;
+                    }
+                }
+            }
+            implicit_nx_ = implicit_ny_ = 0;
+        }
+        if (implicit_ids_) {
+            node_id.resize(size_);
+            for (size_t i = 0; i < size_; i++) node_id[i] = static_cast<uint16_t>(i);
+            implicit_ids_ = false;
+        }
+    }
+
+    // Cold values of node i, implicit or stored
+    int16_t coordX(size_t i) const { return implicit_nx_ ? static_cast<int16_t>(i % implicit_nx_) : x[i]; }
+    int16_t coordY(size_t i) const {
+        return implicit_nx_ ? static_cast<int16_t>(i / implicit_nx_ % implicit_ny_) : y[i];
+    }
+    int16_t coordZ(size_t i) const {
+        return implicit_nx_ ? static_cast<int16_t>(i / (implicit_nx_ * implicit_ny_)) : z[i];
+    }
+    uint16_t nodeId(size_t i) const { return implicit_ids_ ? static_cast<uint16_t>(i) : node_id[i]; }
+
+    static constexpr size_t paddedCount(size_t n) {
+        return (n + kLanePadding - 1) / kLanePadding * kLanePadding;
+    }
+
+    // Column storage as one block: the counter column, then integrator_state,
+    // feedback_gain, current_output, previous_input, input_gain,
+    // time_constant, clamp_low, clamp_high and spectral_mix, capacity() each
+    unsigned char* storage() { return storage_; }
+    const unsigned char* storage() const { return storage_; }
+    size_t storageBytes() const { return storage_bytes_; }
+    bool ownsStorage() const { return storage_ != nullptr && !external_owner_; }
+    static constexpr size_t storageBytesFor(size_t capacity) {
+        return capacity * (kScalarColumns * sizeof(Scalar) + sizeof(uint64_t));
+    }
+
+    // Hot state columns (capacity() entries each, 64-byte aligned)
+    Scalar* integrator_state = nullptr;
+    Scalar* feedback_gain = nullptr;
+    Scalar* current_output = nullptr;
+    Scalar* previous_input = nullptr;
+    uint64_t* operation_count = nullptr;
+
+    // Parameter columns (capacity() entries each, 64-byte aligned). A node
+    // step computes, with a = input * control:
+    //   state  += (input_gain * a - state) * time_constant
+    //   output  = clamp(state * (1 + feedback_gain) + spectral_mix * boost(a + aux),
+    //                   clamp_low, clamp_high)
+    // clamp_low must not exceed clamp_high.
+    Scalar* input_gain = nullptr;
+    Scalar* time_constant = nullptr;
+    Scalar* clamp_low = nullptr;
+    Scalar* clamp_high = nullptr;
+    Scalar* spectral_mix = nullptr;
+
+    // The first kStateColumns scalar columns, integrator_state on, are the
+    // ones a step writes; the parameters follow them
+    static constexpr size_t kStateColumns = 4;
+    static constexpr size_t kParameterColumns = 5;
+
+    // Software prefetch of nodes [begin, end) in every scalar column, ahead of
+    // a sweep that is about to reach them
+    void prefetch(size_t begin, size_t end) const {
+        constexpr size_t kLine = 64 / sizeof(Scalar);
+        const Scalar* base = integrator_state;
+        for (size_t c = 0; c < kScalarColumns; c++, base += capacity_) {
+            for (size_t i = begin / kLine * kLine; i < end; i += kLine) prefetchLine(base + i);
+        }
+    }
+
+    // Cold placement data (size() entries each once materialized)
+    mutable std::vector<int16_t> x, y, z;
+    mutable std::vector<uint16_t> node_id;
+
+private:
+    static constexpr size_t kScalarColumns = kStateColumns + kParameterColumns;
+
+    // The counter column goes first so every column starts on a cache line
+    // whatever sizeof(Scalar) is.
+    void bindColumns() {
+        operation_count = reinterpret_cast<uint64_t*>(storage_);
+        Scalar* base = reinterpret_cast<Scalar*>(storage_ + capacity_ * sizeof(uint64_t));
+        integrator_state = base;
+        feedback_gain = base + capacity_;
+        current_output = base + 2 * capacity_;
+        previous_input = base + 3 * capacity_;
+        input_gain = base + 4 * capacity_;
+        time_constant = base + 5 * capacity_;
+        clamp_low = base + 6 * capacity_;
+        clamp_high = base + 7 * capacity_;
+        spectral_mix = base + 8 * capacity_;
+    }
+
+    void copyFrom(const BasicNodeBank& other) {
+        resize(other.size_);
+        if (storage_bytes_ > 0) {
+            std::memcpy(storage_, other.storage_, storage_bytes_);
+        }
+        x = other.x;
+        y = other.y;
+        z = other.z;
+        node_id = other.node_id;
+        implicit_nx_ = other.implicit_nx_;
+        implicit_ny_ = other.implicit_ny_;
+        implicit_ids_ = other.implicit_ids_;
+    }
+
+    void release() {
+        if (storage_ && !external_owner_) {
+            ::operator delete(storage_, std::align_val_t(kAlignment));
+        }
+        external_owner_.reset();
+        storage_ = nullptr;
+        storage_bytes_ = 0;
+        size_ = 0;
+        capacity_ = 0;
+        integrator_state = feedback_gain = current_output = previous_input = nullptr;
+        input_gain = time_constant = clamp_low = clamp_high = spectral_mix = nullptr;
+        operation_count = nullptr;
+        implicit_nx_ = implicit_ny_ = 0;
+        implicit_ids_ = false;
+    }
+
+    void swap(BasicNodeBank& other) noexcept {
+        std::swap(storage_, other.storage_);
+        std::swap(storage_bytes_, other.storage_bytes_);
+        external_owner_.swap(other.external_owner_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+        std::swap(integrator_state, other.integrator_state);
+        std::swap(feedback_gain, other.feedback_gain);
+        std::swap(current_output, other.current_output);
+        std::swap(previous_input, other.previous_input);
+        std::swap(input_gain, other.input_gain);
+        std::swap(time_constant, other.time_constant);
+        std::swap(clamp_low, other.clamp_low);
+        std::swap(clamp_high, other.clamp_high);
+        std::swap(spectral_mix, other.spectral_mix);
+        std::swap(operation_count, other.operation_count);
+        x.swap(other.x);
+        y.swap(other.y);
+        z.swap(other.z);
+        node_id.swap(other.node_id);
+        std::swap(implicit_nx_, other.implicit_nx_);
+        std::swap(implicit_ny_, other.implicit_ny_);
+        std::swap(implicit_ids_, other.implicit_ids_);
+    }
+
+    unsigned char* storage_ = nullptr;
+    std::shared_ptr<void> external_owner_;  // Set when storage_ is adopted, not allocated
+    size_t storage_bytes_ = 0;
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+    mutable size_t implicit_nx_ = 0;   // Grid of implicit x, y, z; 0 once stored
+    mutable size_t implicit_ny_ = 0;
+    mutable bool implicit_ids_ = false;
+};
+
+using NodeBank = BasicNodeBank<double>;
+using NodeBankF32 = BasicNodeBank<float>;
@@ -0,0 +1,766 @@
+#include "node_equation.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace {
+
+using Op = NodeEquationProgram::Op;
+using Instruction = NodeEquationProgram::Instruction;
+
+const char* const kStreamNames[kNodeEquationStreams] = {"input", "control", "aux", "amplified", "boost"};
+const char* const kBankColumnNames[] = {"output", "integrator_state", "feedback_gain", "input_gain",
+                                        "time_constant", "clamp_low", "clamp_high", "spectral_mix"};
+
+struct FunctionInfo {
+    const char* name;
+    Op op;
+    size_t arity;
+};
+// clamp is Min(Max(x, lo), hi)
+const FunctionInfo kFunctions[] = {
+    {"sin", Op::Sin, 1},   {"cos", Op::Cos, 1},   {"tan", Op::Tan, 1},   {"tanh", Op::Tanh, 1},
+    {"exp", Op::Exp, 1},   {"log", Op::Log, 1},   {"sqrt", Op::Sqrt, 1}, {"abs", Op::Abs, 1},
+    {"floor", Op::Floor, 1}, {"pow", Op::Pow, 2}, {"min", Op::Min, 2},   {"max", Op::Max, 2},
+    {"clamp", Op::Min, 3}};
+
+enum class TokenKind { Number, Name, Symbol, End, Eof };
+
+struct Token {
+    TokenKind kind;
+    std::string text;
+    double number = 0.0;
+    int line = 1;
+    int column = 1;
+};
+
+[[noreturn]] void fail(int line, int column, const std::string& message) {
+    throw std::invalid_argument("node equation, line " + std::to_string(line) + ", column " +
+                                std::to_string(column) + ": " + message);
+}
+
+// Newlines and ';' become End tokens, runs of them one
+std::vector<Token> tokenize(const std::string& source) {
+    std::vector<Token> tokens;
+    int line = 1, column = 1;
+    auto end_statement = [&](int l, int c) {
+        if (!tokens.empty() && tokens.back().kind != TokenKind::End) tokens.push_back({TokenKind::End, ";", 0.0, l, c});
+    };
+    for (size_t i = 0; i < source.size();) {
+        const char ch = source[i];
+        const int at = column;
+        if (ch == '\n' || ch == ';') {
+            end_statement(line, at);
+            if (ch == '\n') {
+                line++;
+                column = 1;
+            } else {
+                column++;
+            }
+            i++;
+        } else if (ch == '#') {
+            while (i < source.size() && source[i] != '\n') i++, column++;
+        } else if (std::isspace(static_cast<unsigned char>(ch))) {
+            i++, column++;
+        } else if (std::isdigit(static_cast<unsigned char>(ch)) ||
+                   (ch == '.' && i + 1 < source.size() && std::isdigit(static_cast<unsigned char>(source[i + 1])))) {
+            char* stop = nullptr;
+            const double value = std::strtod(source.c_str() + i, &stop);
+            const size_t length = static_cast<size_t>(stop - (source.c_str() + i));
+            // The canonical spelling, so 0.50 and .5 hash alike
+            char text[32];
+            std::snprintf(text, sizeof(text), "%.17g", value);
+            tokens.push_back({TokenKind::Number, text, value, line, at});
+            i += length;
+            column += static_cast<int>(length);
+        } else if (std::isalpha(static_cast<unsigned char>(ch)) || ch == '_') {
+            size_t j = i;
+            while (j < source.size() && (std::isalnum(static_cast<unsigned char>(source[j])) || source[j] == '_')) j++;
+            tokens.push_back({TokenKind::Name, source.substr(i, j - i), 0.0, line, at});
+            column += static_cast<int>(j - i);
+            i = j;
+        } else {
+            static const char* const kTwo[] = {"<=", ">=", "==", "!="};
+            std::string symbol(1, ch);
+            for (const char* two : kTwo) {
+                if (source.compare(i, 2, two) == 0) symbol = two;
+            }
+            if (symbol.size() == 1 && !std::strchr("+-*/^()<>,=?:", ch)) {
+                fail(line, at, std::string("unexpected character '") + ch + "'");
+            }
+            tokens.push_back({TokenKind::Symbol, symbol, 0.0, line, at});
+            i += symbol.size();
+            column += static_cast<int>(symbol.size());
+        }
+    }
+    end_statement(line, column);
+    tokens.push_back({TokenKind::Eof, "", 0.0, line, column});
+    return tokens;
+}
+
+int findName(const char* const* names, size_t count, const std::string& name) {
+    for (size_t k = 0; k < count; k++) {
+        if (name == names[k]) return static_cast<int>(k);
+    }
+    return -1;
+}
+
+bool isCommutative(Op op) {
+    return op == Op::Add || op == Op::Mul || op == Op::Min || op == Op::Max || op == Op::Equal ||
+           op == Op::NotEqual;
+}
+
+double evaluate(Op op, double a, double b, double c) {
+    switch (op) {
+        case Op::Add: return a + b;
+        case Op::Sub: return a - b;
+        case Op::Mul: return a * b;
+        case Op::Div: return a / b;
+        case Op::Neg: return -a;
+        case Op::Pow: return std::pow(a, b);
+        case Op::Min: return std::min(a, b);
+        case Op::Max: return std::max(a, b);
+        case Op::Less: return a < b ? 1.0 : 0.0;
+        case Op::LessEqual: return a <= b ? 1.0 : 0.0;
+        case Op::Greater: return a > b ? 1.0 : 0.0;
+        case Op::GreaterEqual: return a >= b ? 1.0 : 0.0;
+        case Op::Equal: return a == b ? 1.0 : 0.0;
+        case Op::NotEqual: return a != b ? 1.0 : 0.0;
+        case Op::Select: return a != 0.0 ? b : c;
+        case Op::Sin: return std::sin(a);
+        case Op::Cos: return std::cos(a);
+        case Op::Tan: return std::tan(a);
+        case Op::Tanh: return std::tanh(a);
+        case Op::Exp: return std::exp(a);
+        case Op::Log: return std::log(a);
+        case Op::Sqrt: return std::sqrt(a);
+        case Op::Abs: return std::fabs(a);
+        case Op::Floor: return std::floor(a);
+        case Op::Const: case Op::Stream: case Op::Column: case Op::Copy: break;
+    }
+    return a;
+}
+
+size_t operandCount(Op op) {
+    switch (op) {
+        case Op::Const: case Op::Stream: case Op::Column: return 0;
+        case Op::Copy: case Op::Neg: case Op::Sin: case Op::Cos: case Op::Tan: case Op::Tanh:
+        case Op::Exp: case Op::Log: case Op::Sqrt: case Op::Abs: case Op::Floor: return 1;
+        case Op::Select: return 3;
+        default: return 2;
+    }
+}
+
+// Parses and lowers in one pass: every expression becomes instructions as
+// it is read, hash-consed so equal subexpressions share a register and
+// folded when all operands are constant
+class Compiler {
+public:
+    explicit Compiler(const std::string& source) : tokens_(tokenize(source)) {}
+
+    void run() {
+        while (peek().kind != TokenKind::Eof) {
+            statement();
+            if (peek().kind != TokenKind::Eof) expect(TokenKind::End, "end of statement");
+        }
+        const int out = findColumn("output");
+        if (out < 0 || !columns_[out].assigned) {
+            fail(tokens_.back().line, tokens_.back().column, "the equations never assign output");
+        }
+        output_ = static_cast<uint32_t>(out);
+    }
+
+    // Canonical program text: the tokens, one space apart
+    std::string canonical() const {
+        std::string text;
+        for (const Token& t : tokens_) {
+            if (t.kind == TokenKind::Eof) break;
+            if (!text.empty()) text += ' ';
+            text += t.text;
+        }
+        return text;
+    }
+
+    // Drops dead code and splits what remains into prologue and body
+    NodeEquationProgram finish(std::vector<NodeEquationColumn>& columns) {
+        const size_t count = code_.size();
+        std::vector<char> live(count, 0);
+        std::vector<uint32_t> result(columns_.size());
+        for (size_t k = 0; k < columns_.size(); k++) {
+            result[k] = columns_[k].assigned ? current_[k] : loads_[k];
+            live[result[k]] = 1;
+            live[loads_[k]] = 1;
+        }
+        for (size_t r = count; r-- > 0;) {
+            if (!live[r]) continue;
+            const Instruction& ins = code_[r];
+            const size_t operands = operandCount(ins.op);
+            if (operands > 0) live[ins.a] = 1;
+            if (operands > 1) live[ins.b] = 1;
+            if (operands > 2) live[ins.c] = 1;
+        }
+        // Variant: reads a stream or an assigned column, directly or not
+        std::vector<char> variant(count, 0);
+        for (size_t r = 0; r < count; r++) {
+            const Instruction& ins = code_[r];
+            const size_t operands = operandCount(ins.op);
+            variant[r] = (ins.op == Op::Stream) || (ins.op == Op::Column && columns_[ins.a].assigned) ||
+                         (operands > 0 && variant[ins.a]) || (operands > 1 && variant[ins.b]) ||
+                         (operands > 2 && variant[ins.c]);
+        }
+        NodeEquationProgram program;
+        std::vector<uint32_t> remap(count, 0);
+        for (int pass = 0; pass < 2; pass++) {
+            if (pass == 1) program.body_begin = program.code.size();
+            for (size_t r = 0; r < count; r++) {
+                if (!live[r]) continue;
+                // Column loads of assigned columns are variant but load once per batch
+                const bool prologue = !variant[r] || code_[r].op == Op::Column;
+                if (prologue != (pass == 0)) continue;
+                Instruction ins = code_[r];
+                const size_t operands = operandCount(ins.op);
+                if (operands > 0) ins.a = remap[ins.a];
+                if (operands > 1) ins.b = remap[ins.b];
+                if (operands > 2) ins.c = remap[ins.c];
+                if (ins.op == Op::Stream) program.streams |= 1u << ins.a;
+                remap[r] = static_cast<uint32_t>(program.code.size());
+                program.code.push_back(ins);
+            }
+        }
+        for (size_t k = 0; k < columns_.size(); k++) {
+            program.load.push_back(remap[loads_[k]]);
+            program.result.push_back(remap[result[k]]);
+        }
+        program.output = output_;
+        columns = columns_;
+        return program;
+    }
+
+private:
+    enum class NameKind { Let, Column, Stream, Constant };
+
+    const Token& peek() const { return tokens_[pos_]; }
+    const Token& next() { return tokens_[pos_++]; }
+    bool accept(const char* symbol) {
+        if (peek().kind == TokenKind::Symbol && peek().text == symbol) {
+            pos_++;
+            return true;
+        }
+        return false;
+    }
+    const Token& expect(TokenKind kind, const char* what) {
+        if (peek().kind != kind) fail(peek().line, peek().column, std::string("expected ") + what);
+        return next();
+    }
+    void expectSymbol(const char* symbol) {
+        if (!accept(symbol)) fail(peek().line, peek().column, std::string("expected '") + symbol + "'");
+    }
+
+    int findColumn(const std::string& name) const {
+        for (size_t k = 0; k < columns_.size(); k++) {
+            if (columns_[k].name == name) return static_cast<int>(k);
+        }
+        return -1;
+    }
+
+    uint32_t emit(Op op, uint32_t a = 0, uint32_t b = 0, uint32_t c = 0, double value = 0.0) {
+        const size_t operands = operandCount(op);
+        if (operands > 0 && op != Op::Copy) {
+            const bool constant = code_[a].op == Op::Const && (operands < 2 || code_[b].op == Op::Const) &&
+                                  (operands < 3 || code_[c].op == Op::Const);
+            if (constant) {
+                return emit(Op::Const, 0, 0, 0,
+                            evaluate(op, code_[a].value, operands > 1 ? code_[b].value : 0.0,
+                                     operands > 2 ? code_[c].value : 0.0));
+            }
+            if (op == Op::Select && code_[a].op == Op::Const) return code_[a].value != 0.0 ? b : c;
+            if (isCommutative(op) && a > b) std::swap(a, b);
+        }
+        // Copies stay distinct: each is a column's value at one point
+        std::string key;
+        if (op != Op::Copy) {
+            char text[96];
+            std::snprintf(text, sizeof(text), "%d %u %u %u %.17g", static_cast<int>(op), a, b, c, value);
+            key = text;
+            auto found = shared_.find(key);
+            if (found != shared_.end()) return found->second;
+        }
+        Instruction ins;
+        ins.op = op;
+        ins.a = a;
+        ins.b = b;
+        ins.c = c;
+        ins.value = value;
+        code_.push_back(ins);
+        const uint32_t reg = static_cast<uint32_t>(code_.size() - 1);
+        if (!key.empty()) shared_.emplace(key, reg);
+        return reg;
+    }
+
+    // A column used for the first time: its load, and its value from there on
+    int addColumn(const std::string& name, bool declared, bool param, double initial) {
+        NodeEquationColumn column;
+        column.name = name;
+        column.declared = declared;
+        column.initial = initial;
+        columns_.push_back(column);
+        params_.push_back(param);
+        const uint32_t load = emit(Op::Column, static_cast<uint32_t>(columns_.size() - 1));
+        loads_.push_back(load);
+        current_.push_back(load);
+        return static_cast<int>(columns_.size() - 1);
+    }
+
+    // The value a name has at this point of the sample
+    uint32_t lookup(const Token& token) {
+        auto let = lets_.find(token.text);
+        if (let != lets_.end()) return let->second;
+        int k = findColumn(token.text);
+        if (k < 0 && findName(kBankColumnNames, std::size(kBankColumnNames), token.text) >= 0) {
+            k = addColumn(token.text, false, false, 0.0);
+        }
+        if (k >= 0) return current_[k];
+        const int stream = findName(kStreamNames, kNodeEquationStreams, token.text);
+        if (stream >= 0) return emit(Op::Stream, static_cast<uint32_t>(stream));
+        if (token.text == "pi") return emit(Op::Const, 0, 0, 0, M_PI);
+        fail(token.line, token.column, "unknown name '" + token.text + "'");
+    }
+
+    bool isKnown(const std::string& name) const {
+        return lets_.count(name) > 0 || findColumn(name) >= 0 ||
+               findName(kBankColumnNames, std::size(kBankColumnNames), name) >= 0 ||
+               findName(kStreamNames, kNodeEquationStreams, name) >= 0 || name == "pi" ||
+               name == "state" || name == "param" || name == "let";
+    }
+
+    void statement() {
+        const Token& first = expect(TokenKind::Name, "a statement");
+        if (first.text == "state" || first.text == "param") {
+            const bool param = first.text == "param";
+            do {
+                const Token& name = expect(TokenKind::Name, "a name");
+                if (isKnown(name.text)) fail(name.line, name.column, "'" + name.text + "' is already defined");
+                double initial = 0.0;
+                if (accept("=")) {
+                    const Token& at = peek();
+                    const uint32_t value = expression();
+                    if (code_[value].op != Op::Const) fail(at.line, at.column, "initial values must be constant");
+                    initial = code_[value].value;
+                }
+                addColumn(name.text, true, param, initial);
+            } while (accept(","));
+            return;
+        }
+        if (first.text == "let") {
+            const Token& name = expect(TokenKind::Name, "a name");
+            if (isKnown(name.text)) fail(name.line, name.column, "'" + name.text + "' is already defined");
+            expectSymbol("=");
+            lets_[name.text] = expression();
+            return;
+        }
+        expectSymbol("=");
+        int k = findColumn(first.text);
+        if (k < 0 && findName(kBankColumnNames, std::size(kBankColumnNames), first.text) >= 0) {
+            k = addColumn(first.text, false, false, 0.0);
+        }
+        if (k < 0 || params_[k]) {
+            const char* why = k >= 0 ? "is a param" : lets_.count(first.text) ? "is a let" :
+                              findName(kStreamNames, kNodeEquationStreams, first.text) >= 0 ? "is a stream" :
+                              "is not a state or node column";
+            fail(first.line, first.column, "cannot assign '" + first.text + "': it " + why);
+        }
+        uint32_t value = expression();
+        // A column's value from the sample start may be overwritten before
+        // the end of the sample takes this one
+        if (code_[value].op == Op::Column) value = emit(Op::Copy, value);
+        columns_[k].assigned = true;
+        current_[k] = value;
+    }
+
+    uint32_t expression() {
+        const uint32_t condition = comparison();
+        if (!accept("?")) return condition;
+        const uint32_t a = expression();
+        expectSymbol(":");
+        const uint32_t b = expression();
+        return emit(Op::Select, condition, a, b);
+    }
+
+    uint32_t comparison() {
+        const uint32_t left = sum();
+        static const std::pair<const char*, Op> kComparisons[] = {
+            {"<", Op::Less}, {"<=", Op::LessEqual}, {">", Op::Greater}, {">=", Op::GreaterEqual},
+            {"==", Op::Equal}, {"!=", Op::NotEqual}};
+        for (const auto& c : kComparisons) {
+            if (accept(c.first)) return emit(c.second, left, sum());
+        }
+        return left;
+    }
+
+    uint32_t sum() {
+        uint32_t value = product();
+        for (;;) {
+            if (accept("+")) {
+                value = emit(Op::Add, value, product());
+            } else if (accept("-")) {
+                value = emit(Op::Sub, value, product());
+            } else {
+                return value;
+            }
+        }
+    }
+
+    uint32_t product() {
+        uint32_t value = unary();
+        for (;;) {
+            if (accept("*")) {
+                value = emit(Op::Mul, value, unary());
+            } else if (accept("/")) {
+                value = emit(Op::Div, value, unary());
+            } else {
+                return value;
+            }
+        }
+    }
+
+    uint32_t unary() {
+        if (accept("-")) return emit(Op::Neg, unary());
+        if (accept("+")) return unary();
+        return power();
+    }
+
+    uint32_t power() {
+        const uint32_t base = primary();
+        if (!accept("^")) return base;
+        const uint32_t exponent = unary();
+        // Small integer powers as multiplies
+        if (code_[exponent].op == Op::Const) {
+            const double e = code_[exponent].value;
+            if (e == 1.0) return base;
+            if (e == 2.0) return emit(Op::Mul, base, base);
+            if (e == 3.0) return emit(Op::Mul, emit(Op::Mul, base, base), base);
+            if (e == 4.0) {
+                const uint32_t square = emit(Op::Mul, base, base);
+                return emit(Op::Mul, square, square);
+            }
+            if (e == 0.5) return emit(Op::Sqrt, base);
+        }
+        return emit(Op::Pow, base, exponent);
+    }
+
+    uint32_t primary() {
+        const Token& token = next();
+        if (token.kind == TokenKind::Number) return emit(Op::Const, 0, 0, 0, token.number);
+        if (token.kind == TokenKind::Symbol && token.text == "(") {
+            const uint32_t value = expression();
+            expectSymbol(")");
+            return value;
+        }
+        if (token.kind != TokenKind::Name) fail(token.line, token.column, "expected a value");
+        if (!accept("(")) return lookup(token);
+        const FunctionInfo* function = nullptr;
+        for (const FunctionInfo& f : kFunctions) {
+            if (token.text == f.name) function = &f;
+        }
+        if (!function) fail(token.line, token.column, "unknown function '" + token.text + "'");
+        std::vector<uint32_t> args;
+        if (!accept(")")) {
+            do {
+                args.push_back(expression());
+            } while (accept(","));
+            expectSymbol(")");
+        }
+        if (args.size() != function->arity) {
+            fail(token.line, token.column, std::string(function->name) + " takes " +
+                                               std::to_string(function->arity) + " argument" +
+                                               (function->arity == 1 ? "" : "s"));
+        }
+        if (function->arity == 3) return emit(Op::Min, emit(Op::Max, args[0], args[1]), args[2]);
+        if (function->op == Op::Pow && code_[args[1]].op == Op::Const && code_[args[1]].value == 2.0) {
+            return emit(Op::Mul, args[0], args[0]);
+        }
+        return emit(function->op, args[0], function->arity > 1 ? args[1] : 0);
+    }
+
+    std::vector<Token> tokens_;
+    size_t pos_ = 0;
+    std::vector<Instruction> code_;
+    std::unordered_map<std::string, uint32_t> shared_;
+    std::map<std::string, uint32_t> lets_;
+    std::vector<NodeEquationColumn> columns_;
+    std::vector<char> params_;
+    std::vector<uint32_t> loads_;
+    std::vector<uint32_t> current_;
+    uint32_t output_ = 0;
+};
+
+// Samples of output a tape batch stages before writing its rows
+constexpr size_t kTapeOutputSamples = 16;
+
+// Instructions [from, to) of a tape over one batch of nodes, sample t.
+// Fixed is the batch's lane count when known at compile time (the full
+// batches), which lets the lane loops vectorize without a remainder.
+template <size_t Fixed>
+void tapeStep(const std::vector<Instruction>& code, size_t from, size_t to, double* regs, size_t dynamic_lanes,
+              const NodeEquationCall& call, size_t first, size_t t) {
+    constexpr size_t L = NodeEquation::kTapeLanes;
+    const size_t lanes = Fixed ? Fixed : dynamic_lanes;
+    for (size_t r = from; r < to; r++) {
+        const Instruction& ins = code[r];
+        double* __restrict d = regs + r * L;
+        const double* __restrict a = regs + ins.a * L;
+        const double* __restrict b = regs + ins.b * L;
+        const double* __restrict c = regs + ins.c * L;
+        switch (ins.op) {
+            case Op::Const: for (size_t l = 0; l < lanes; l++) d[l] = ins.value; break;
+            case Op::Stream: {
+                const double v = call.streams[ins.a][t];
+                for (size_t l = 0; l < lanes; l++) d[l] = v;
+                break;
+            }
+            case Op::Column: {
+                const double* column = call.columns[ins.a] + first;
+                for (size_t l = 0; l < lanes; l++) d[l] = column[l];
+                break;
+            }
+            case Op::Copy: for (size_t l = 0; l < lanes; l++) d[l] = a[l]; break;
+            case Op::Add: for (size_t l = 0; l < lanes; l++) d[l] = a[l] + b[l]; break;
+            case Op::Sub: for (size_t l = 0; l < lanes; l++) d[l] = a[l] - b[l]; break;
+            case Op::Mul: for (size_t l = 0; l < lanes; l++) d[l] = a[l] * b[l]; break;
+            case Op::Div: for (size_t l = 0; l < lanes; l++) d[l] = a[l] / b[l]; break;
+            case Op::Neg: for (size_t l = 0; l < lanes; l++) d[l] = -a[l]; break;
+            case Op::Pow: for (size_t l = 0; l < lanes; l++) d[l] = std::pow(a[l], b[l]); break;
+            case Op::Min: for (size_t l = 0; l < lanes; l++) d[l] = a[l] < b[l] ? a[l] : b[l]; break;
+            case Op::Max: for (size_t l = 0; l < lanes; l++) d[l] = a[l] > b[l] ? a[l] : b[l]; break;
+            case Op::Less: for (size_t l = 0; l < lanes; l++) d[l] = a[l] < b[l] ? 1.0 : 0.0; break;
+            case Op::LessEqual: for (size_t l = 0; l < lanes; l++) d[l] = a[l] <= b[l] ? 1.0 : 0.0; break;
+            case Op::Greater: for (size_t l = 0; l < lanes; l++) d[l] = a[l] > b[l] ? 1.0 : 0.0; break;
+            case Op::GreaterEqual: for (size_t l = 0; l < lanes; l++) d[l] = a[l] >= b[l] ? 1.0 : 0.0; break;
+            case Op::Equal: for (size_t l = 0; l < lanes; l++) d[l] = a[l] == b[l] ? 1.0 : 0.0; break;
+            case Op::NotEqual: for (size_t l = 0; l < lanes; l++) d[l] = a[l] != b[l] ? 1.0 : 0.0; break;
+            case Op::Select: for (size_t l = 0; l < lanes; l++) d[l] = a[l] != 0.0 ? b[l] : c[l]; break;
+            case Op::Sin: for (size_t l = 0; l < lanes; l++) d[l] = std::sin(a[l]); break;
+            case Op::Cos: for (size_t l = 0; l < lanes; l++) d[l] = std::cos(a[l]); break;
+            case Op::Tan: for (size_t l = 0; l < lanes; l++) d[l] = std::tan(a[l]); break;
+            case Op::Tanh: for (size_t l = 0; l < lanes; l++) d[l] = std::tanh(a[l]); break;
+            case Op::Exp: for (size_t l = 0; l < lanes; l++) d[l] = std::exp(a[l]); break;
+            case Op::Log: for (size_t l = 0; l < lanes; l++) d[l] = std::log(a[l]); break;
+            case Op::Sqrt: for (size_t l = 0; l < lanes; l++) d[l] = std::sqrt(a[l]); break;
+            case Op::Abs: for (size_t l = 0; l < lanes; l++) d[l] = std::fabs(a[l]); break;
+            case Op::Floor: for (size_t l = 0; l < lanes; l++) d[l] = std::floor(a[l]); break;
+        }
+    }
+}
+
+uint64_t fnv1a(const std::string& text) {
+    uint64_t h = 1469598103934665603ull;
+    for (char c : text) h = (h ^ static_cast<unsigned char>(c)) * 1099511628211ull;
+    return h;
+}
+
+struct EquationCache {
+    std::mutex mutex;
+    std::unordered_multimap<uint64_t, std::shared_ptr<const NodeEquation>> entries;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+};
+
+EquationCache& equationCache() {
+    static EquationCache cache;
+    return cache;
+}
+
+void freeColumns(double* storage) { ::operator delete(storage, std::align_val_t(NodeBank::kAlignment)); }
+
+} // namespace
+
+const char* nodeEquationBackendName(NodeEquationBackend backend) {
+    switch (backend) {
+        case NodeEquationBackend::Tape: return "tape";
+        case NodeEquationBackend::Jit: return "jit";
+    }
+    return "unknown";
+}
+
+bool nodeEquationBackendAvailable(NodeEquationBackend backend) {
+    return backend == NodeEquationBackend::Tape || nodeEquationJitAvailable();
+}
+
+NodeEquationBackend defaultNodeEquationBackend() {
+    return nodeEquationJitAvailable() ? NodeEquationBackend::Jit : NodeEquationBackend::Tape;
+}
+
+NodeEquation::NodeEquation(NodeEquationProgram program, std::vector<NodeEquationColumn> columns,
+                           std::string canonical, uint64_t hash, NodeEquationBackend backend)
+    : program_(std::move(program)), columns_(std::move(columns)), canonical_(std::move(canonical)), hash_(hash),
+      backend_(backend) {
+    if (backend_ == NodeEquationBackend::Jit) {
+        char symbol[40];
+        std::snprintf(symbol, sizeof(symbol), "dase_equation_%016llx", static_cast<unsigned long long>(hash_));
+        kernel_ = compileNodeEquationJit(program_, symbol);
+    }
+}
+
+std::shared_ptr<const NodeEquation> NodeEquation::compile(const std::string& source, NodeEquationBackend backend) {
+    if (!nodeEquationBackendAvailable(backend)) {
+        throw std::runtime_error("node equation backend jit unavailable: engine built without DASE_WITH_LLVM");
+    }
+    const auto start = std::chrono::steady_clock::now();
+    Compiler compiler(source);
+    compiler.run();
+    const std::string canonical = compiler.canonical();
+    const uint64_t hash = fnv1a(canonical);
+
+    EquationCache& cache = equationCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    auto range = cache.entries.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        if (it->second->backend() == backend && it->second->canonical() == canonical) {
+            cache.hits++;
+            return it->second;
+        }
+    }
+    cache.misses++;
+    std::vector<NodeEquationColumn> columns;
+    NodeEquationProgram program = compiler.finish(columns);
+    auto equation = std::make_shared<NodeEquation>(std::move(program), std::move(columns), canonical, hash, backend);
+    equation->compile_seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    cache.entries.emplace(hash, equation);
+    return equation;
+}
+
+NodeEquation::CacheStats NodeEquation::cacheStats() {
+    EquationCache& cache = equationCache();
+    std::lock_guard<std::mutex> lock(cache.mutex);
+    CacheStats stats;
+    stats.entries = cache.entries.size();
+    stats.hits = cache.hits;
+    stats.misses = cache.misses;
+    return stats;
+}
+
+int NodeEquation::columnIndex(const std::string& name) const {
+    for (size_t k = 0; k < columns_.size(); k++) {
+        if (columns_[k].name == name) return static_cast<int>(k);
+    }
+    return -1;
+}
+
+void NodeEquation::run(const NodeEquationCall& call) const {
+    if (call.begin >= call.end || call.n == 0) return;
+    if (kernel_) {
+        kernel_(call.columns, call.streams, call.begin, call.end, call.n, call.out, call.out_first,
+                call.out ? call.out_limit : 0);
+        return;
+    }
+    runTape(call);
+}
+
+void NodeEquation::runTape(const NodeEquationCall& call) const {
+    constexpr size_t L = kTapeLanes;
+    const std::vector<Instruction>& code = program_.code;
+    // One lane batch per register; grows once per thread
+    thread_local std::vector<double> registers;
+    if (registers.size() < code.size() * L) registers.resize(code.size() * L);
+    double* const regs = registers.data();
+    thread_local std::vector<float> staging(kTapeOutputSamples * L);
+    float* const staged = staging.data();
+    const size_t out_limit = call.out ? call.out_limit : 0;
+
+    for (size_t first = call.begin; first < call.end; first += L) {
+        const size_t lanes = std::min(L, call.end - first);
+        auto step = [&](size_t from, size_t to, size_t t) {
+            if (lanes == L) {
+                tapeStep<L>(code, from, to, regs, L, call, first, t);
+            } else {
+                tapeStep<0>(code, from, to, regs, lanes, call, first, t);
+            }
+        };
+
+        step(0, program_.body_begin, 0);
+        const double* output = regs + program_.result[program_.output] * L;
+        const size_t rows = first < out_limit ? std::min(lanes, out_limit - first) : 0;
+        for (size_t t = 0; t < call.n; t++) {
+            step(program_.body_begin, code.size(), t);
+            // Outputs gather sample-major and go out a cache line per row,
+            // rather than a float per row per sample
+            const size_t slot = t % kTapeOutputSamples;
+            for (size_t l = 0; l < rows; l++) staged[slot * L + l] = static_cast<float>(output[l]);
+            if (slot + 1 == kTapeOutputSamples || t + 1 == call.n) {
+                const size_t t0 = t - slot;
+                for (size_t l = 0; l < rows; l++) {
+                    float* row = call.out + (first + l - call.out_first) * call.n + t0;
+                    for (size_t j = 0; j <= slot; j++) row[j] = staged[j * L + l];
+                }
+            }
+            for (size_t k = 0; k < columns_.size(); k++) {
+                if (!columns_[k].assigned) continue;
+                std::memcpy(regs + program_.load[k] * L, regs + program_.result[k] * L, lanes * sizeof(double));
+            }
+        }
+        for (size_t k = 0; k < columns_.size(); k++) {
+            if (!columns_[k].assigned) continue;
+            std::memcpy(call.columns[k] + first, regs + program_.load[k] * L, lanes * sizeof(double));
+        }
+    }
+}
+
+double* nodeBankColumn(NodeBank& bank, const std::string& name) {
+    if (name == "output") return bank.current_output;
+    if (name == "integrator_state") return bank.integrator_state;
+    if (name == "feedback_gain") return bank.feedback_gain;
+    if (name == "input_gain") return bank.input_gain;
+    if (name == "time_constant") return bank.time_constant;
+    if (name == "clamp_low") return bank.clamp_low;
+    if (name == "clamp_high") return bank.clamp_high;
+    if (name == "spectral_mix") return bank.spectral_mix;
+    return nullptr;
+}
+
+void NodeEquationColumns::bind(const NodeEquation& equation, size_t capacity) {
+    clear();
+    equation_ = &equation;
+    capacity_ = capacity;
+    const std::vector<NodeEquationColumn>& columns = equation.columns();
+    size_t declared = 0;
+    for (const NodeEquationColumn& column : columns) {
+        slot_.push_back(column.declared ? static_cast<int>(declared++) : -1);
+    }
+    if (declared == 0 || capacity == 0) return;
+    double* storage = static_cast<double*>(
+        ::operator new(declared * capacity * sizeof(double), std::align_val_t(NodeBank::kAlignment)));
+    storage_ = std::unique_ptr<double[], void (*)(double*)>(storage, &freeColumns);
+    for (size_t k = 0; k < columns.size(); k++) {
+        if (slot_[k] >= 0) std::fill_n(storage + slot_[k] * capacity, capacity, columns[k].initial);
+    }
+}
+
+void NodeEquationColumns::clear() {
+    equation_ = nullptr;
+    capacity_ = 0;
+    slot_.clear();
+    storage_.reset();
+}
+
+double* NodeEquationColumns::find(const std::string& name) {
+    if (!equation_) return nullptr;
+    const int k = equation_->columnIndex(name);
+    return k >= 0 && slot_[k] >= 0 ? storage_.get() + slot_[k] * capacity_ : nullptr;
+}
+
+void NodeEquationColumns::resolve(NodeBank& bank, std::vector<double*>& pointers) {
+    const std::vector<NodeEquationColumn>& columns = equation_->columns();
+    pointers.resize(columns.size());
+    for (size_t k = 0; k < columns.size(); k++) {
+        pointers[k] = slot_[k] >= 0 ? storage_.get() + slot_[k] * capacity_ : nodeBankColumn(bank, columns[k].name);
+    }
+}
@@ -0,0 +1,199 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "node_bank.h"
+
+// Backends a node equation can be compiled for
+enum class NodeEquationBackend : uint8_t {
+    Tape = 0,  // Portable: every instruction runs over a batch of kTapeLanes nodes at once
+    Jit = 1    // Vector machine code from LLVM ORC, when built with DASE_WITH_LLVM
+};
+
+const char* nodeEquationBackendName(NodeEquationBackend backend);
+bool nodeEquationBackendAvailable(NodeEquationBackend backend);
+// Jit when it is built in, Tape otherwise
+NodeEquationBackend defaultNodeEquationBackend();
+
+// Per-sample streams of processBlock an equation may read; every node sees
+// the same value
+enum class NodeEquationStream : uint8_t {
+    Input = 0,
+    Control = 1,    // 1 when the block has none
+    Aux = 2,        // 0 when the block has none
+    Amplified = 3,  // input * control
+    Boost = 4       // Spectral boost of amplified + aux, as the built-in model adds it
+};
+constexpr size_t kNodeEquationStreams = 5;
+
+// A per-node column an equation reads or writes
+struct NodeEquationColumn {
+    std::string name;
+    bool declared = false;  // A state or param of the source; otherwise a NodeBank column
+    bool assigned = false;  // Written by the equations; only these are stored back
+    double initial = 0.0;   // Value of every node when the equation is set, declared columns only
+};
+
+// Compiled form both backends run. Registers are instruction indices
+// (static single assignment). The prologue runs once per batch of nodes and
+// holds every Column load and whatever depends only on constants and
+// unassigned columns; the body runs once per sample. After each sample the
+// register of each assigned column's Column load takes its result, which is
+// how states carry from one sample to the next.
+struct NodeEquationProgram {
+    enum class Op : uint8_t {
+        Const, Stream, Column, Copy,
+        Add, Sub, Mul, Div, Neg, Pow, Min, Max,
+        Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, Select,
+        Sin, Cos, Tan, Tanh, Exp, Log, Sqrt, Abs, Floor
+    };
+    struct Instruction {
+        Op op = Op::Const;
+        uint32_t a = 0, b = 0, c = 0;  // Operand registers; the stream or column index of Stream and Column
+        double value = 0.0;            // Const
+    };
+
+    std::vector<Instruction> code;  // Prologue [0, body_begin), body [body_begin, size)
+    size_t body_begin = 0;
+    std::vector<uint32_t> load;     // Per column: its Column instruction
+    std::vector<uint32_t> result;   // Per column: its value at the end of a sample (load when unassigned)
+    uint32_t output = 0;            // Column of the node output
+    unsigned streams = 0;           // Bit s set when stream s is read
+};
+
+// Arguments of one call: nodes [begin, end) of every column (a multiple of
+// 8, within the columns' padding), columns[k] the start of column k of
+// columns(), streams[s] n samples of stream s (null for streams the
+// equation does not read). Node i's output of sample t goes to
+// out[(i - out_first) * n + t] when out is non-null and i < out_limit.
+struct NodeEquationCall {
+    double* const* columns = nullptr;
+    const double* const* streams = nullptr;
+    size_t begin = 0;
+    size_t end = 0;
+    size_t n = 0;
+    float* out = nullptr;
+    size_t out_first = 0;
+    size_t out_limit = 0;
+};
+
+// Machine code of a Jit equation: the fields of a NodeEquationCall
+using NodeEquationKernel = void (*)(double* const* columns, const double* const* streams, size_t begin,
+                                    size_t end, size_t n, float* out, size_t out_first, size_t out_limit);
+
+// User-defined per-node update equations, compiled at runtime.
+//
+// A source is a list of statements, one per line or separated by ';', with
+// '#' starting a comment:
+//
+//   state v = -1.2, w = -0.6      # Per-node state columns and their start value
+//   param a = 0.7, b = 0.8, eps = 0.08, dt = 0.05   # Per-node parameter columns
+//   let drive = amplified + aux   # A temporary of the current sample
+//   v = v + dt * (v - v^3 / 3 - w + drive)
+//   w = w + dt * eps * (v + a - b * w)
+//   output = clamp(v, clamp_low, clamp_high)
+//
+// Statements run in order for every node and sample, so an assignment is
+// seen by the ones after it. Besides states, params and lets, names are the
+// streams (input, control, aux, amplified, boost; read only), the NodeBank
+// columns (integrator_state, feedback_gain, input_gain, time_constant,
+// clamp_low, clamp_high, spectral_mix; assignable) and output, the node's
+// current_output, which starts a block at the previous one and must be
+// assigned. Params and streams cannot be assigned. Expressions have + - * /,
+// ^ (power, right associative, above unary minus), comparisons (1 or 0),
+// c ? a : b (a where c is not 0), pi and the functions sin, cos, tan, tanh,
+// exp, log, sqrt, abs, floor, pow, min, max and clamp(x, lo, hi).
+//
+// Compilation folds constants, shares common subexpressions, drops dead
+// code and hoists what does not change between samples out of the sample
+// loop, then hands the program to the backend. Equations are kept in a
+// process-wide cache by the hash of their canonical program (the token
+// stream, so layout and comments do not matter) and backend, so setting the
+// same dynamics again, on any engine, reuses the compiled code.
+class NodeEquation {
+public:
+    static constexpr size_t kTapeLanes = 64;
+
+    // The equation of source on backend, from the cache when it was
+    // compiled before. Throws std::invalid_argument for a source that does
+    // not parse or check (the message gives the line and column) and
+    // std::runtime_error for a backend that is not built in.
+    static std::shared_ptr<const NodeEquation> compile(const std::string& source,
+                                                       NodeEquationBackend backend = defaultNodeEquationBackend());
+
+    // Steps the call's nodes through n samples. Calls on disjoint node
+    // ranges may run at once.
+    void run(const NodeEquationCall& call) const;
+
+    NodeEquationBackend backend() const { return backend_; }
+    uint64_t hash() const { return hash_; }
+    const std::string& canonical() const { return canonical_; }
+    const std::vector<NodeEquationColumn>& columns() const { return columns_; }
+    // Index of a column in columns(), -1 when the equation does not use it
+    int columnIndex(const std::string& name) const;
+    bool readsStream(NodeEquationStream stream) const {
+        return (program_.streams >> static_cast<unsigned>(stream)) & 1u;
+    }
+    const NodeEquationProgram& program() const { return program_; }
+    // Instructions run per sample after optimization, and once per batch
+    size_t bodyInstructions() const { return program_.code.size() - program_.body_begin; }
+    size_t prologueInstructions() const { return program_.body_begin; }
+    double compileSeconds() const { return compile_seconds_; }
+
+    struct CacheStats {
+        size_t entries = 0;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+    static CacheStats cacheStats();
+
+    // Use compile(); public for make_shared
+    NodeEquation(NodeEquationProgram program, std::vector<NodeEquationColumn> columns, std::string canonical,
+                 uint64_t hash, NodeEquationBackend backend);
+
+private:
+    void runTape(const NodeEquationCall& call) const;
+
+    NodeEquationProgram program_;
+    std::vector<NodeEquationColumn> columns_;
+    std::string canonical_;
+    uint64_t hash_ = 0;
+    NodeEquationBackend backend_ = NodeEquationBackend::Tape;
+    NodeEquationKernel kernel_ = nullptr;  // Jit
+    double compile_seconds_ = 0.0;
+};
+
+// Column of a NodeBank an equation names, null for other names ("output"
+// is current_output)
+double* nodeBankColumn(NodeBank& bank, const std::string& name);
+
+// Storage of an equation's declared states and params for a bank of nodes:
+// one 64-byte aligned column of capacity values each, every value the
+// column's initial one
+class NodeEquationColumns {
+public:
+    void bind(const NodeEquation& equation, size_t capacity);
+    void clear();
+
+    // Column of a declared state or param, null for other names
+    double* find(const std::string& name);
+    // Fills pointers (one per column of the equation) from this storage and
+    // bank
+    void resolve(NodeBank& bank, std::vector<double*>& pointers);
+    size_t capacity() const { return capacity_; }
+
+private:
+    const NodeEquation* equation_ = nullptr;
+    size_t capacity_ = 0;
+    std::vector<int> slot_;  // Per equation column: its column here, -1 for bank columns
+    std::unique_ptr<double[], void (*)(double*)> storage_{nullptr, nullptr};
+};
+
+// LLVM ORC backend (node_equation_jit.cpp)
+bool nodeEquationJitAvailable();
+// Machine code of program under symbol; throws std::runtime_error without
+// DASE_WITH_LLVM or when LLVM rejects it
+NodeEquationKernel compileNodeEquationJit(const NodeEquationProgram& program, const std::string& symbol);
@@ -0,0 +1,339 @@
+// LLVM ORC backend of NodeEquation. Without DASE_WITH_LLVM only the stubs
+// at the end are built and equations run on the tape backend.
+#include "node_equation.h"
+#include <stdexcept>
+
+#ifdef DASE_WITH_LLVM
+
+#include <mutex>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/JITTargetMachineBuilder.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
+#include <llvm/ExecutionEngine/Orc/ThreadSafeModule.h>
+#include <llvm/IR/IRBuilder.h>
+#include <llvm/IR/Intrinsics.h>
+#include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/Module.h>
+#include <llvm/IR/Verifier.h>
+#include <llvm/Passes/PassBuilder.h>
+#include <llvm/Support/TargetSelect.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Target/TargetMachine.h>
+
+namespace {
+
+using Op = NodeEquationProgram::Op;
+
+// Nodes per vector: one cache line of doubles, which the backend splits
+// into the host's registers (two on AVX2, one on AVX-512)
+constexpr unsigned kJitLanes = 8;
+
+struct Jit {
+    std::unique_ptr<llvm::orc::LLJIT> lljit;
+    std::unique_ptr<llvm::TargetMachine> target;
+    std::string error;
+};
+
+// The process-wide JIT, created on first use; every equation's code lives
+// in its main library for the life of the process, as the cache keeps them
+Jit& jit() {
+    static Jit instance;
+    static std::once_flag once;
+    std::call_once(once, [] {
+        llvm::InitializeNativeTarget();
+        llvm::InitializeNativeTargetAsmPrinter();
+        auto builder = llvm::orc::JITTargetMachineBuilder::detectHost();
+        if (!builder) {
+            instance.error = llvm::toString(builder.takeError());
+            return;
+        }
+        builder->setCodeGenOptLevel(llvm::CodeGenOpt::Aggressive);
+        auto target = builder->createTargetMachine();
+        if (!target) {
+            instance.error = llvm::toString(target.takeError());
+            return;
+        }
+        instance.target = std::move(*target);
+        auto lljit = llvm::orc::LLJITBuilder().setJITTargetMachineBuilder(std::move(*builder)).create();
+        if (!lljit) {
+            instance.error = llvm::toString(lljit.takeError());
+            return;
+        }
+        // libm for the math the vector intrinsics lower to
+        auto process = llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+            (*lljit)->getDataLayout().getGlobalPrefix());
+        if (!process) {
+            instance.error = llvm::toString(process.takeError());
+            return;
+        }
+        (*lljit)->getMainJITDylib().addGenerator(std::move(*process));
+        instance.lljit = std::move(*lljit);
+    });
+    return instance;
+}
+
+// One function per program, in the layout of NodeEquationKernel:
+//
+//   for i in [begin, end) step 8:            batch: prologue, column loads
+//     for t in [0, n):                       sample: body, with a phi per assigned column
+//       out rows i..i+7 at t, for rows under out_limit
+//     store assigned columns
+class KernelBuilder {
+public:
+    KernelBuilder(llvm::LLVMContext& context, llvm::Module& module, const NodeEquationProgram& program)
+        : context_(context), module_(module), program_(program), builder_(context) {
+        llvm::FastMathFlags fast;
+        fast.setFast();
+        builder_.setFastMathFlags(fast);
+        f64_ = llvm::Type::getDoubleTy(context);
+        f32_ = llvm::Type::getFloatTy(context);
+        i64_ = llvm::Type::getInt64Ty(context);
+        vector_ = llvm::FixedVectorType::get(f64_, kJitLanes);
+    }
+
+    void build(const std::string& symbol) {
+        llvm::Type* f64p = f64_->getPointerTo();
+        llvm::Type* f64pp = f64p->getPointerTo();
+        llvm::Type* f32p = f32_->getPointerTo();
+        auto* type = llvm::FunctionType::get(llvm::Type::getVoidTy(context_),
+                                             {f64pp, f64pp, i64_, i64_, i64_, f32p, i64_, i64_}, false);
+        function_ = llvm::Function::Create(type, llvm::Function::ExternalLinkage, symbol, module_);
+        auto arg = function_->arg_begin();
+        llvm::Value* columns = &*arg++;
+        llvm::Value* streams = &*arg++;
+        llvm::Value* begin = &*arg++;
+        llvm::Value* end = &*arg++;
+        llvm::Value* n = &*arg++;
+        llvm::Value* out = &*arg++;
+        llvm::Value* out_first = &*arg++;
+        llvm::Value* out_limit = &*arg++;
+
+        auto* entry = llvm::BasicBlock::Create(context_, "entry", function_);
+        auto* batch_head = llvm::BasicBlock::Create(context_, "batch", function_);
+        auto* batch_body = llvm::BasicBlock::Create(context_, "prologue", function_);
+        auto* sample = llvm::BasicBlock::Create(context_, "sample", function_);
+        auto* batch_end = llvm::BasicBlock::Create(context_, "store", function_);
+        auto* exit = llvm::BasicBlock::Create(context_, "exit", function_);
+
+        builder_.SetInsertPoint(entry);
+        const size_t column_count = program_.load.size();
+        std::vector<llvm::Value*> column_base(column_count);
+        for (size_t k = 0; k < column_count; k++) {
+            column_base[k] = builder_.CreateLoad(f64p, builder_.CreateConstGEP1_64(f64p, columns, k));
+        }
+        std::vector<llvm::Value*> stream_base(kNodeEquationStreams, nullptr);
+        for (size_t s = 0; s < kNodeEquationStreams; s++) {
+            if ((program_.streams >> s) & 1u) {
+                stream_base[s] = builder_.CreateLoad(f64p, builder_.CreateConstGEP1_64(f64p, streams, s));
+            }
+        }
+        builder_.CreateCondBr(builder_.CreateICmpEQ(n, llvm::ConstantInt::get(i64_, 0)), exit, batch_head);
+
+        builder_.SetInsertPoint(batch_head);
+        llvm::PHINode* i = builder_.CreatePHI(i64_, 2, "i");
+        i->addIncoming(begin, entry);
+        builder_.CreateCondBr(builder_.CreateICmpULT(i, end), batch_body, exit);
+
+        // Prologue: column loads and invariants; output row pointers
+        builder_.SetInsertPoint(batch_body);
+        values_.assign(program_.code.size(), nullptr);
+        for (size_t r = 0; r < program_.body_begin; r++) {
+            const NodeEquationProgram::Instruction& ins = program_.code[r];
+            if (ins.op == Op::Column) {
+                llvm::Value* address = builder_.CreateGEP(f64_, column_base[ins.a], i);
+                values_[r] = builder_.CreateAlignedLoad(vector_, builder_.CreateBitCast(address, vector_->getPointerTo()),
+                                                        llvm::Align(8));
+            } else {
+                values_[r] = emit(ins, nullptr);
+            }
+        }
+        llvm::Value* rows[kJitLanes];
+        llvm::Value* row_valid[kJitLanes];
+        for (unsigned l = 0; l < kJitLanes; l++) {
+            llvm::Value* node = builder_.CreateAdd(i, llvm::ConstantInt::get(i64_, l));
+            row_valid[l] = builder_.CreateICmpULT(node, out_limit);
+            llvm::Value* row = builder_.CreateMul(builder_.CreateSub(node, out_first), n);
+            rows[l] = builder_.CreateGEP(f32_, out, row);
+        }
+        builder_.CreateBr(sample);
+
+        // Sample loop: assigned columns carry through phis
+        builder_.SetInsertPoint(sample);
+        llvm::PHINode* t = builder_.CreatePHI(i64_, 2, "t");
+        t->addIncoming(llvm::ConstantInt::get(i64_, 0), batch_body);
+        std::vector<llvm::PHINode*> carried(column_count, nullptr);
+        for (size_t k = 0; k < column_count; k++) {
+            if (program_.result[k] == program_.load[k]) continue;
+            carried[k] = builder_.CreatePHI(vector_, 2);
+            carried[k]->addIncoming(values_[program_.load[k]], batch_body);
+            values_[program_.load[k]] = carried[k];
+        }
+        for (size_t r = program_.body_begin; r < program_.code.size(); r++) {
+            const NodeEquationProgram::Instruction& ins = program_.code[r];
+            llvm::Value* stream = nullptr;
+            if (ins.op == Op::Stream) {
+                stream = builder_.CreateLoad(f64_, builder_.CreateGEP(f64_, stream_base[ins.a], t));
+            }
+            values_[r] = emit(ins, stream);
+        }
+        llvm::Value* output = values_[program_.result[program_.output]];
+        for (unsigned l = 0; l < kJitLanes; l++) {
+            auto* store = llvm::BasicBlock::Create(context_, "row", function_);
+            auto* next = llvm::BasicBlock::Create(context_, "next", function_);
+            builder_.CreateCondBr(row_valid[l], store, next);
+            builder_.SetInsertPoint(store);
+            llvm::Value* lane = builder_.CreateFPTrunc(builder_.CreateExtractElement(output, l), f32_);
+            builder_.CreateStore(lane, builder_.CreateGEP(f32_, rows[l], t));
+            builder_.CreateBr(next);
+            builder_.SetInsertPoint(next);
+        }
+        llvm::BasicBlock* latch = builder_.GetInsertBlock();
+        llvm::Value* t_next = builder_.CreateAdd(t, llvm::ConstantInt::get(i64_, 1));
+        t->addIncoming(t_next, latch);
+        for (size_t k = 0; k < column_count; k++) {
+            if (carried[k]) carried[k]->addIncoming(values_[program_.result[k]], latch);
+        }
+        builder_.CreateCondBr(builder_.CreateICmpULT(t_next, n), sample, batch_end);
+
+        builder_.SetInsertPoint(batch_end);
+        for (size_t k = 0; k < column_count; k++) {
+            if (!carried[k]) continue;
+            llvm::Value* address = builder_.CreateGEP(f64_, column_base[k], i);
+            builder_.CreateAlignedStore(values_[program_.result[k]],
+                                        builder_.CreateBitCast(address, vector_->getPointerTo()), llvm::Align(8));
+        }
+        i->addIncoming(builder_.CreateAdd(i, llvm::ConstantInt::get(i64_, kJitLanes)), batch_end);
+        builder_.CreateBr(batch_head);
+
+        builder_.SetInsertPoint(exit);
+        builder_.CreateRetVoid();
+    }
+
+    llvm::Function* function() const { return function_; }
+
+private:
+    llvm::Value* unary(llvm::Intrinsic::ID id, llvm::Value* a) {
+        return builder_.CreateUnaryIntrinsic(id, a);
+    }
+
+    // Lane by lane through a libm function with no vector intrinsic
+    llvm::Value* perLane(const char* name, llvm::Value* a) {
+        llvm::FunctionCallee callee = module_.getOrInsertFunction(name, f64_, f64_);
+        llvm::Value* result = llvm::UndefValue::get(vector_);
+        for (unsigned l = 0; l < kJitLanes; l++) {
+            llvm::Value* lane = builder_.CreateCall(callee, {builder_.CreateExtractElement(a, l)});
+            result = builder_.CreateInsertElement(result, lane, l);
+        }
+        return result;
+    }
+
+    llvm::Value* flag(llvm::Value* condition) {
+        return builder_.CreateSelect(condition, llvm::ConstantFP::get(vector_, 1.0),
+                                     llvm::ConstantFP::get(vector_, 0.0));
+    }
+
+    llvm::Value* emit(const NodeEquationProgram::Instruction& ins, llvm::Value* stream) {
+        llvm::Value* a = values_[ins.a];
+        llvm::Value* b = values_[ins.b];
+        llvm::Value* c = values_[ins.c];
+        switch (ins.op) {
+            case Op::Const: return llvm::ConstantFP::get(vector_, ins.value);
+            case Op::Stream: return builder_.CreateVectorSplat(kJitLanes, stream);
+            case Op::Column: return nullptr;  // Loaded by the prologue
+            case Op::Copy: return a;
+            case Op::Add: return builder_.CreateFAdd(a, b);
+            case Op::Sub: return builder_.CreateFSub(a, b);
+            case Op::Mul: return builder_.CreateFMul(a, b);
+            case Op::Div: return builder_.CreateFDiv(a, b);
+            case Op::Neg: return builder_.CreateFNeg(a);
+            case Op::Pow: return builder_.CreateBinaryIntrinsic(llvm::Intrinsic::pow, a, b);
+            case Op::Min: return builder_.CreateBinaryIntrinsic(llvm::Intrinsic::minnum, a, b);
+            case Op::Max: return builder_.CreateBinaryIntrinsic(llvm::Intrinsic::maxnum, a, b);
+            case Op::Less: return flag(builder_.CreateFCmpOLT(a, b));
+            case Op::LessEqual: return flag(builder_.CreateFCmpOLE(a, b));
+            case Op::Greater: return flag(builder_.CreateFCmpOGT(a, b));
+            case Op::GreaterEqual: return flag(builder_.CreateFCmpOGE(a, b));
+            case Op::Equal: return flag(builder_.CreateFCmpOEQ(a, b));
+            case Op::NotEqual: return flag(builder_.CreateFCmpUNE(a, b));
+            case Op::Select:
+                return builder_.CreateSelect(builder_.CreateFCmpUNE(a, llvm::ConstantFP::get(vector_, 0.0)), b, c);
+            case Op::Sin: return unary(llvm::Intrinsic::sin, a);
+            case Op::Cos: return unary(llvm::Intrinsic::cos, a);
+            case Op::Tan: return perLane("tan", a);
+            case Op::Tanh: return perLane("tanh", a);
+            case Op::Exp: return unary(llvm::Intrinsic::exp, a);
+            case Op::Log: return unary(llvm::Intrinsic::log, a);
+            case Op::Sqrt: return unary(llvm::Intrinsic::sqrt, a);
+            case Op::Abs: return unary(llvm::Intrinsic::fabs, a);
+            case Op::Floor: return unary(llvm::Intrinsic::floor, a);
+        }
+        return nullptr;
+    }
+
+    llvm::LLVMContext& context_;
+    llvm::Module& module_;
+    const NodeEquationProgram& program_;
+    llvm::IRBuilder<> builder_;
+    llvm::Type* f64_ = nullptr;
+    llvm::Type* f32_ = nullptr;
+    llvm::Type* i64_ = nullptr;
+    llvm::FixedVectorType* vector_ = nullptr;
+    llvm::Function* function_ = nullptr;
+    std::vector<llvm::Value*> values_;
+};
+
+void optimize(llvm::Module& module, llvm::TargetMachine* target) {
+    llvm::LoopAnalysisManager loops;
+    llvm::FunctionAnalysisManager functions;
+    llvm::CGSCCAnalysisManager cgscc;
+    llvm::ModuleAnalysisManager modules;
+    llvm::PassBuilder passes(target);
+    passes.registerModuleAnalyses(modules);
+    passes.registerCGSCCAnalyses(cgscc);
+    passes.registerFunctionAnalyses(functions);
+    passes.registerLoopAnalyses(loops);
+    passes.crossRegisterProxies(loops, functions, cgscc, modules);
+    passes.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3).run(module, modules);
+}
+
+} // namespace
+
+bool nodeEquationJitAvailable() { return jit().lljit != nullptr; }
+
+NodeEquationKernel compileNodeEquationJit(const NodeEquationProgram& program, const std::string& symbol) {
+    Jit& j = jit();
+    if (!j.lljit) throw std::runtime_error("node equation JIT unavailable: " + j.error);
+    auto context = std::make_unique<llvm::LLVMContext>();
+    auto module = std::make_unique<llvm::Module>(symbol, *context);
+    module->setDataLayout(j.lljit->getDataLayout());
+    module->setTargetTriple(j.target->getTargetTriple().str());
+
+    KernelBuilder builder(*context, *module, program);
+    builder.build(symbol);
+    std::string problems;
+    llvm::raw_string_ostream problem_stream(problems);
+    if (llvm::verifyFunction(*builder.function(), &problem_stream)) {
+        throw std::runtime_error("node equation JIT produced invalid code: " + problem_stream.str());
+    }
+    // Functions take the host's features, so the vectors get its widest registers
+    builder.function()->addFnAttr("target-cpu", j.target->getTargetCPU());
+    builder.function()->addFnAttr("target-features", j.target->getTargetFeatureString());
+    optimize(*module, j.target.get());
+
+    if (llvm::Error error = j.lljit->addIRModule(llvm::orc::ThreadSafeModule(std::move(module), std::move(context)))) {
+        throw std::runtime_error("node equation JIT: " + llvm::toString(std::move(error)));
+    }
+    auto address = j.lljit->lookup(symbol);
+    if (!address) throw std::runtime_error("node equation JIT: " + llvm::toString(address.takeError()));
+    return reinterpret_cast<NodeEquationKernel>(static_cast<uintptr_t>(address->getAddress()));
+}
+
+#else
+
+bool nodeEquationJitAvailable() { return false; }
+
+NodeEquationKernel compileNodeEquationJit(const NodeEquationProgram&, const std::string&) {
+    throw std::runtime_error("node equation JIT unavailable: engine built without DASE_WITH_LLVM");
+}
+
+#endif
@@ -0,0 +1,86 @@
+#include "node_kernels.h"
+#include "analog_universal_node_engine_avx2.h"
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+SimdLevel detectSimdLevel() {
+#ifdef DASE_X86_KERNELS
+    if (CPUFeatures::hasAVX512F() && CPUFeatures::osSupportsAVX512()) return SimdLevel::AVX512;
+    // The AVX2 table converts half floats with F16C, which came before FMA
+    if (CPUFeatures::hasAVX2() && CPUFeatures::hasFMA() && CPUFeatures::hasF16C() && CPUFeatures::osSupportsAVX()) {
+        return SimdLevel::AVX2;
+    }
+    if (CPUFeatures::hasSSE42()) return SimdLevel::SSE42;
+#endif
+#ifdef DASE_ARM_KERNELS
+    if (CPUFeatures::hasNEON()) return SimdLevel::NEON;
+#endif
+    return SimdLevel::Scalar;
+}
+
+static SimdLevel parseSimdLevel(const char* name, SimdLevel fallback) {
+    if (std::strcmp(name, "scalar") == 0) return SimdLevel::Scalar;
+    if (std::strcmp(name, "sse42") == 0) return SimdLevel::SSE42;
+    if (std::strcmp(name, "avx2") == 0) return SimdLevel::AVX2;
+    if (std::strcmp(name, "avx512") == 0) return SimdLevel::AVX512;
+    if (std::strcmp(name, "neon") == 0) return SimdLevel::NEON;
+    std::cerr << "⚠️  Ignoring unknown DASE_SIMD value '" << name << "'" << std::endl;
+    return fallback;
+}
+
+SimdLevel defaultSimdLevel() {
+    static const SimdLevel level = [] {
+        const SimdLevel detected = detectSimdLevel();
+        const char* env = std::getenv("DASE_SIMD");
+        if (env == nullptr || *env == '\0') return detected;
+        // Resolved through nodeKernels(), so the variable can only lower the level
+        return nodeKernels(parseSimdLevel(env, detected)).level;
+    }();
+    return level;
+}
+
+const NodeKernels& nodeKernels(SimdLevel level, NodePipeline pipeline, SineDegree degree) {
+    [[maybe_unused]] static const SimdLevel host = detectSimdLevel();
+    if (level == SimdLevel::Scalar) return scalarNodeKernels(pipeline, degree);
+#ifdef DASE_X86_KERNELS
+    if (level > host) level = host;
+    if (level == SimdLevel::AVX512) return avx512NodeKernels(pipeline, degree);
+    if (level == SimdLevel::AVX2) return avx2NodeKernels(pipeline, degree);
+    if (level == SimdLevel::SSE42) return sse42NodeKernels(pipeline, degree);
+#endif
+#ifdef DASE_ARM_KERNELS
+    if (host == SimdLevel::NEON) return neonNodeKernels(pipeline, degree);
+#endif
+    return scalarNodeKernels(pipeline, degree);
+}
+
+const char* simdLevelName(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::SSE42: return "sse42";
+        case SimdLevel::AVX2: return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+        case SimdLevel::NEON: return "neon";
+    }
+    return "unknown";
+}
+
+const char* nodePipelineName(NodePipeline pipeline) {
+    switch (pipeline) {
+        case NodePipeline::Full: return "full";
+        case NodePipeline::NoBoost: return "no_boost";
+        case NodePipeline::Direct: return "direct";
+        case NodePipeline::Linear: return "linear";
+    }
+    return "unknown";
+}
+
+const char* sineDegreeName(SineDegree degree) {
+    switch (degree) {
+        case SineDegree::Seven: return "seven";
+        case SineDegree::Five: return "five";
+        case SineDegree::Three: return "three";
+    }
+    return "unknown";
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "block_stats.h"
+#include "compact_node_bank.h"
+#include "control_wave.h"
+#include "filter_bank.h"
+#include "node_bank.h"
+
+// Instruction-set levels the node kernels are built for. The x86 levels are
+// ordered lowest to highest; NEON is the only level above Scalar on ARM.
+enum class SimdLevel {
+    Scalar = 0,  // Portable C++, no intrinsics
+    SSE42 = 1,   // 128-bit SSE4.2 (FMA emulated with mul + add)
+    AVX2 = 2,    // 256-bit AVX2 + FMA (+ F16C)
+    AVX512 = 3,  // 512-bit AVX-512F
+    NEON = 4     // 128-bit AArch64 Advanced SIMD
+};
+
+// Stage sequence of the per-node kernels (wave, mission, mission schedule
+// and block, both precisions). Each preset is a separate compile-time
+// instantiation, so a stage it drops costs nothing inside the node loops.
+enum class NodePipeline {
+    Full = 0,     // amplify, leaky integrator, spectral boost, feedback, clamp
+    NoBoost = 1,  // Full without the spectral boost
+    Direct = 2,   // Full with the integrator bypassed (state = amplified input)
+    Linear = 3    // Neither integrator nor boost: clamp(amplified * (1 + feedback))
+};
+constexpr size_t kNodePipelineCount = 4;
+
+// Degree of the sine polynomial behind the spectral boost (spectral,
+// spectral_lanes and the boost of the per-node kernels). Lower degrees
+// trade accuracy for fewer multiply-adds; each is a separate instantiation
+// of the boost presets, like the pipelines.
+enum class SineDegree {
+    Seven = 0,   // Degree 7 sin, 8 cos: 9.5e-8 (the default)
+    Five = 1,    // Degree 5 sin, 6 cos: 9.4e-7
+    Three = 2    // Degree 3 sin, 4 cos: 3.2e-4
+};
+constexpr size_t kSineDegreeCount = 3;
+constexpr size_t kNodeKernelTables = kNodePipelineCount * kSineDegreeCount;
+
+// Slot of a table in a level's array of kNodeKernelTables
+constexpr size_t nodeKernelsIndex(NodePipeline pipeline, SineDegree degree) {
+    return static_cast<size_t>(degree) * kNodePipelineCount + static_cast<size_t>(pipeline);
+}
+
+// Node steps per wave sweep at full quality: one per harmonic bank pass
+constexpr int kWavePasses = 10;
+
+// Parameters of NodeKernels::color_map: the frequency -> hue, amplitude ->
+// lightness and Φ rotation of server/chromatic_visualizer.py (ColorMapper)
+struct ColorMapParams {
+    float min_frequency;   // Clamp range of the hue axis, Hz (positive for a log axis)
+    float max_frequency;
+    bool log_scale;        // Hue linear in log frequency rather than frequency
+    float inv_gamma;       // lightness = clamp(amplitude, 0, 1)^inv_gamma * lightness_gain
+    float lightness_gain;
+    bool rotate;           // Add rotation degrees and wrap into [0, 360); otherwise the
+    float rotation;        // hue stays in [0, 360], 360 at max_frequency
+    float saturation;      // HSL saturation of every colour, [0, 1]
+    uint8_t alpha;         // RGBA alpha byte
+};
+
+// Kernel table for one instruction-set level.
+//
+// Every hot loop of the engines goes through one of these entries, so the
+// engine translation unit itself contains no ISA-specific code and a single
+// binary runs on any x86-64 host. Each level lives in its own translation unit
+// compiled with the matching target attributes; nodeKernels() picks the best
+// table the CPU and OS support.
+//
+// Node ranges [begin, end) are bank slot indices and must be multiples of 8
+// with end <= bank.capacity(). Padding slots past bank.size() are processed
+// like real nodes but never contribute to sums or outputs.
+struct NodeKernels {
+    SimdLevel level;
+    const char* name;
+    NodePipeline pipeline;
+    SineDegree sine_degree;
+
+    // out8[k] = sin((k + 1) * input + offset) * 0.1 / (k + 1), k = 0..7
+    void (*harmonics)(float input, float offset, float* out8);
+    // Spectral boost of one value: mean of sin(base * m) over 8 multipliers
+    float (*spectral)(float base);
+    // spectral() of n independent values; n must be a multiple of 8
+    void (*spectral_lanes)(const float* base, float* boost, size_t n);
+    // sin and cos of n values from one range reduction; n must be a multiple of 8
+    void (*sincos_lanes)(const float* x, float* sin_out, float* cos_out, size_t n);
+    // out[j] = sigma * sample first + j of a standard normal stream (Philox4x32-10
+    // keyed by seed, counter = (sample / 4, stream), Box-Muller). Any split of a
+    // range gives the same values; levels agree to float rounding.
+    void (*gaussian_noise)(uint64_t seed, uint64_t stream, uint64_t first, float sigma, float* out, size_t n);
+    // Pair products of count rows of n floats, row r at rows + r * stride:
+    // out[i * count + j] = out[j * count + i] = sum_k row_i[k] * row_j[k] for
+    // i < j; the diagonal is not written. n must be a multiple of 16.
+    void (*pair_products)(const float* rows, size_t count, size_t stride, size_t n, float* out);
+    // Cross products of two row blocks: out[i * b_count + j] = sum_k a_i[k] *
+    // b_j[k], row r of a block at a + r * stride (b likewise); a and b may be
+    // the same block. n must be a multiple of 16.
+    void (*cross_products)(const float* a, size_t a_count, const float* b, size_t b_count, size_t stride,
+                           size_t n, float* out);
+    // Weighted row sums, any n: out[o][t] = sum_r weights[o * count + r] *
+    // rows[r * stride + t] for o < outputs (at most 4). Each chunk of samples
+    // is read from every row before it is stored, so an output may alias a
+    // row at the same t (mixing in place); stride 1 makes the rows taps of a
+    // FIR over one stream.
+    void (*mix_rows)(const float* rows, size_t count, ptrdiff_t stride, const float* weights, size_t outputs,
+                     float* const* out, size_t n);
+    // Frequency-domain delay line product of count spectra: out = sum_p
+    // x[p] * h_p over complex bins, split re / im. Spectrum p has its real
+    // parts at x[p] and imaginary parts at x[p] + stride, partition p at
+    // h + 2 p stride likewise, out the same. stride must be a multiple of 16
+    // and the bins past the last real one zero.
+    void (*spectrum_mac)(const float* const* x, const float* h, size_t count, size_t stride, float* out);
+    // n samples through the biquad cascades of filter nodes [begin, end):
+    // node i reads in + i * in_stride (in_stride 0: every node reads in)
+    // and writes row i of node-major out. Coefficients and state stay in
+    // registers for the block.
+    void (*biquad_block)(FilterNodeBank& bank, size_t begin, size_t end, const float* in, size_t in_stride,
+                         float* out, size_t n);
+    // Colours of n channels from their frequencies and amplitudes, any n:
+    // interleaved (hue, saturation, lightness) triples into hsl and RGBA
+    // bytes into rgba (either may be null). Frequencies must not be NaN.
+    void (*color_map)(const float* frequency, const float* amplitude, size_t n, const ColorMapParams& params,
+                      float* hsl, uint8_t* rgba);
+
+    // Per-node kernels, instantiated for `pipeline`. The boost streams the
+    // schedule and block entries take are ignored by presets without boost.
+
+    // Wave sweep: passes (at most kWavePasses) node steps with per-pass aux,
+    // node i's control in pass p being control_pattern + control_wave[i + p]
+    // (a ControlWaveTable prepared for the bank's capacity); returns the sum
+    // of outputs of real nodes.
+    double (*wave_f64)(NodeBank& bank, size_t begin, size_t end, double input,
+                       double control_pattern, const double* control_wave, const double* pass_aux, int passes);
+    // Mission step: repeats node steps with shared input/control and zero aux
+    void (*mission_f64)(NodeBank& bank, size_t begin, size_t end, double input,
+                        double control, int repeats);
+    // `steps` mission steps in one call from a precomputed schedule:
+    // amplified[s] = input * control of step s, boost[s] = spectral(amplified[s]).
+    // Equivalent to mission_f64 once per step; last_input is the final step's input.
+    void (*mission_schedule_f64)(NodeBank& bank, size_t begin, size_t end, const double* amplified,
+                                 const float* boost, size_t steps, int repeats, double last_input);
+    // Block of n samples with precomputed amplified signal and spectral boost;
+    // out (node-major, may be null) receives outputs of real nodes, node i in
+    // row i - out_first (0 for a whole-bank array). With stats non-null the
+    // outputs of real nodes are also added to it, accumulated per lane in
+    // registers over the block (a separate instantiation, so null costs
+    // nothing).
+    void (*block_f64)(NodeBank& bank, size_t begin, size_t end, const double* amplified,
+                      const float* boost, float last_input, float* out, size_t n, size_t out_first,
+                      BlockStatsPartial* stats);
+
+    double (*wave_f32)(NodeBankF32& bank, size_t begin, size_t end, double input,
+                       double control_pattern, const double* control_wave, const double* pass_aux, int passes);
+    void (*mission_f32)(NodeBankF32& bank, size_t begin, size_t end, float input,
+                        float control, int repeats);
+    void (*mission_schedule_f32)(NodeBankF32& bank, size_t begin, size_t end, const float* amplified,
+                                 const float* boost, size_t steps, int repeats, float last_input);
+    void (*block_f32)(NodeBankF32& bank, size_t begin, size_t end, const float* amplified,
+                      const float* boost, float last_input, float* out, size_t n, size_t out_first,
+                      BlockStatsPartial* stats);
+
+    // Compact bank kernels, the float ones on 16-bit storage: each chunk is
+    // widened to float, stepped in registers and its state narrowed back.
+    // Ranges may end anywhere on a multiple of 8; the caller keeps
+    // bank.previous_input.
+    double (*wave_compact)(CompactNodeBank& bank, size_t begin, size_t end, double input,
+                           double control_pattern, const double* control_wave, const double* pass_aux,
+                           int passes);
+    void (*mission_schedule_compact)(CompactNodeBank& bank, size_t begin, size_t end, const float* amplified,
+                                     const float* boost, size_t steps, int repeats);
+    void (*block_compact)(CompactNodeBank& bank, size_t begin, size_t end, const float* amplified,
+                          const float* boost, float* out, size_t n, size_t out_first, BlockStatsPartial* stats);
+};
+
+// Highest level supported by both the CPU and the operating system
+SimdLevel detectSimdLevel();
+
+// Level used by new engines: detectSimdLevel(), lowered by the DASE_SIMD
+// environment variable (scalar, sse42, avx2, avx512, neon) when it is set.
+SimdLevel defaultSimdLevel();
+
+// Best table at or below level that this binary contains and the host runs,
+// with the per-node kernels of pipeline and boost sines of degree. A level
+// of another architecture selects the host's best table.
+const NodeKernels& nodeKernels(SimdLevel level, NodePipeline pipeline = NodePipeline::Full,
+                               SineDegree degree = SineDegree::Seven);
+
+const char* simdLevelName(SimdLevel level);
+const char* nodePipelineName(NodePipeline pipeline);
+const char* sineDegreeName(SineDegree degree);
+
+// Per-level tables, defined in node_kernels_<level>.cpp. Only call the ones
+// nodeKernels() would select on this host.
+const NodeKernels& scalarNodeKernels(NodePipeline pipeline = NodePipeline::Full,
+                                     SineDegree degree = SineDegree::Seven);
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define DASE_X86_KERNELS 1
+const NodeKernels& sse42NodeKernels(NodePipeline pipeline = NodePipeline::Full,
+                                    SineDegree degree = SineDegree::Seven);
+const NodeKernels& avx2NodeKernels(NodePipeline pipeline = NodePipeline::Full,
+                                   SineDegree degree = SineDegree::Seven);
+const NodeKernels& avx512NodeKernels(NodePipeline pipeline = NodePipeline::Full,
+                                     SineDegree degree = SineDegree::Seven);
+#endif
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define DASE_ARM_KERNELS 1
+const NodeKernels& neonNodeKernels(NodePipeline pipeline = NodePipeline::Full,
+                                   SineDegree degree = SineDegree::Seven);
+#endif
@@ -0,0 +1,80 @@
+#include <cmath>
+#include "node_kernels.h"
+
+#ifdef DASE_X86_KERNELS
+#include <immintrin.h>
+
+// Everything below is compiled for AVX2 + FMA (and F16C, which every AVX2 +
+// FMA CPU has) regardless of the global -m flags
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2,fma,f16c"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2,fma,f16c")
+#endif
+
+#include "node_kernels_impl.h"
+
+namespace {
+
+struct Avx2Traits {
+    static constexpr size_t kWidthF = 8;
+    static constexpr size_t kWidthD = 4;
+    static constexpr bool kMaskedTail = false;
+    static constexpr bool kHalfConvert = true;
+    static constexpr bool kFusedFma = true;
+    using VF = __m256;
+    using VD = __m256d;
+
+    static VF fset1(float v) { return _mm256_set1_ps(v); }
+    static VF fload(const float* p) { return _mm256_loadu_ps(p); }
+    static void fstore(float* p, VF v) { _mm256_storeu_ps(p, v); }
+    static VF fadd(VF a, VF b) { return _mm256_add_ps(a, b); }
+    static VF fsub(VF a, VF b) { return _mm256_sub_ps(a, b); }
+    static VF fmul(VF a, VF b) { return _mm256_mul_ps(a, b); }
+    static VF fdiv(VF a, VF b) { return _mm256_div_ps(a, b); }
+    static VF ffma(VF a, VF b, VF c) { return _mm256_fmadd_ps(a, b, c); }
+    static VF fmin(VF a, VF b) { return _mm256_min_ps(a, b); }
+    static VF fmax(VF a, VF b) { return _mm256_max_ps(a, b); }
+    static VF ffloor(VF a) { return _mm256_floor_ps(a); }
+    static VF fsqrt(VF a) { return _mm256_sqrt_ps(a); }
+    static VF fselect(VF m, VF a, VF b) {
+        return _mm256_blendv_ps(a, b, _mm256_cmp_ps(m, _mm256_setzero_ps(), _CMP_NEQ_OQ));
+    }
+
+    static VD dset1(double v) { return _mm256_set1_pd(v); }
+    static VD dload(const double* p) { return _mm256_loadu_pd(p); }
+    static void dstore(double* p, VD v) { _mm256_storeu_pd(p, v); }
+    static VD dadd(VD a, VD b) { return _mm256_add_pd(a, b); }
+    static VD dsub(VD a, VD b) { return _mm256_sub_pd(a, b); }
+    static VD dmul(VD a, VD b) { return _mm256_mul_pd(a, b); }
+    static VD dfma(VD a, VD b, VD c) { return _mm256_fmadd_pd(a, b, c); }
+    static VD dmin(VD a, VD b) { return _mm256_min_pd(a, b); }
+    static VD dmax(VD a, VD b) { return _mm256_max_pd(a, b); }
+
+    static VF hload(const uint16_t* p) { return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))); }
+    static void hstore(uint16_t* p, VF v) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(p), _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    static VF pack(VD lo, VD hi) { return _mm256_set_m128(_mm256_cvtpd_ps(hi), _mm256_cvtpd_ps(lo)); }
+    static void unpack(VF v, VD& lo, VD& hi) {
+        lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+        hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+    }
+};
+
+} // namespace
+
+const NodeKernels& avx2NodeKernels(NodePipeline pipeline, SineDegree degree) {
+    static const auto tables = node_kernels::makeTables<Avx2Traits>(SimdLevel::AVX2, "avx2+fma");
+    return tables[nodeKernelsIndex(pipeline, degree)];
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // DASE_X86_KERNELS
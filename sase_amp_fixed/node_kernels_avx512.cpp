@@ -0,0 +1,110 @@
+#include <cmath>
+#include "node_kernels.h"
+
+#ifdef DASE_X86_KERNELS
+// GCC's AVX-512 intrinsics start many results from _mm512_undefined_*,
+// which it then reports as used uninitialized once they are inlined here
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#endif
+#include <immintrin.h>
+
+// Everything below is compiled for AVX-512F regardless of the global -m flags
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx512f,avx2,fma"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+#endif
+
+#include "node_kernels_impl.h"
+
+namespace {
+
+// 16 float / 8 double lanes. Bank ranges only come in multiples of 8 slots,
+// so a trailing half chunk runs with masked loads and stores instead of
+// touching slots past the range (or past the bank's capacity).
+struct Avx512Traits {
+    static constexpr size_t kWidthF = 16;
+    static constexpr size_t kWidthD = 8;
+    static constexpr bool kMaskedTail = true;
+    static constexpr bool kHalfConvert = true;
+    static constexpr bool kFusedFma = true;
+    using VF = __m512;
+    using VD = __m512d;
+    using MaskF = __mmask16;
+    using MaskD = __mmask8;
+
+    static MaskF fmask(size_t lanes) { return static_cast<MaskF>((1u << lanes) - 1u); }
+    static MaskD dmask(size_t lanes) { return static_cast<MaskD>((1u << lanes) - 1u); }
+
+    static VF fset1(float v) { return _mm512_set1_ps(v); }
+    static VF fload(const float* p) { return _mm512_loadu_ps(p); }
+    static VF fload(const float* p, MaskF k) { return _mm512_maskz_loadu_ps(k, p); }
+    static void fstore(float* p, VF v) { _mm512_storeu_ps(p, v); }
+    static void fstore(float* p, MaskF k, VF v) { _mm512_mask_storeu_ps(p, k, v); }
+    static VF fadd(VF a, VF b) { return _mm512_add_ps(a, b); }
+    static VF fsub(VF a, VF b) { return _mm512_sub_ps(a, b); }
+    static VF fmul(VF a, VF b) { return _mm512_mul_ps(a, b); }
+    static VF fdiv(VF a, VF b) { return _mm512_div_ps(a, b); }
+    static VF ffma(VF a, VF b, VF c) { return _mm512_fmadd_ps(a, b, c); }
+    static VF fmin(VF a, VF b) { return _mm512_min_ps(a, b); }
+    static VF fmax(VF a, VF b) { return _mm512_max_ps(a, b); }
+    static VF ffloor(VF a) { return _mm512_roundscale_ps(a, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC); }
+    static VF fsqrt(VF a) { return _mm512_sqrt_ps(a); }
+    static VF fselect(VF m, VF a, VF b) {
+        return _mm512_mask_blend_ps(_mm512_cmp_ps_mask(m, _mm512_setzero_ps(), _CMP_NEQ_OQ), a, b);
+    }
+
+    static VD dset1(double v) { return _mm512_set1_pd(v); }
+    static VD dload(const double* p) { return _mm512_loadu_pd(p); }
+    static VD dload(const double* p, MaskD k) { return _mm512_maskz_loadu_pd(k, p); }
+    static void dstore(double* p, VD v) { _mm512_storeu_pd(p, v); }
+    static void dstore(double* p, MaskD k, VD v) { _mm512_mask_storeu_pd(p, k, v); }
+    static VD dadd(VD a, VD b) { return _mm512_add_pd(a, b); }
+    static VD dsub(VD a, VD b) { return _mm512_sub_pd(a, b); }
+    static VD dmul(VD a, VD b) { return _mm512_mul_pd(a, b); }
+    static VD dfma(VD a, VD b, VD c) { return _mm512_fmadd_pd(a, b, c); }
+    static VD dmin(VD a, VD b) { return _mm512_min_pd(a, b); }
+    static VD dmax(VD a, VD b) { return _mm512_max_pd(a, b); }
+
+    static VF hload(const uint16_t* p) {
+        return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+    }
+    static void hstore(uint16_t* p, VF v) {
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), _mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+    }
+
+    // AVX-512F only (no DQ), so the 256-bit halves are moved as f64x4
+    static VF pack(VD lo, VD hi) {
+        const __m512d joined = _mm512_insertf64x4(
+            _mm512_castpd256_pd512(_mm256_castps_pd(_mm512_cvtpd_ps(lo))),
+            _mm256_castps_pd(_mm512_cvtpd_ps(hi)), 1);
+        return _mm512_castpd_ps(joined);
+    }
+    static void unpack(VF v, VD& lo, VD& hi) {
+        lo = _mm512_cvtps_pd(_mm512_castps512_ps256(v));
+        hi = _mm512_cvtps_pd(_mm256_castpd_ps(_mm512_extractf64x4_pd(_mm512_castps_pd(v), 1)));
+    }
+};
+
+} // namespace
+
+const NodeKernels& avx512NodeKernels(NodePipeline pipeline, SineDegree degree) {
+    static const auto tables = node_kernels::makeTables<Avx512Traits>(SimdLevel::AVX512, "avx512f");
+    return tables[nodeKernelsIndex(pipeline, degree)];
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif // DASE_X86_KERNELS
@@ -0,0 +1,1578 @@
+#pragma once
+
+// ISA-generic node kernels.
+//
+// Included by each node_kernels_<level>.cpp inside that file's target region
+// and instantiated with the file's traits type V, which supplies:
+//   VF / VD         float and double vectors, kWidthF == 2 * kWidthD lanes
+//   f* / d* ops     set1, load, store, add, sub, mul, fma (a * b + c), min,
+//                   max, and for floats div, floor, sqrt and fselect(m, a, b)
+//                   (b where m != 0, else a)
+//   pack / unpack   2 x VD <-> VF lane conversion
+//   kMaskedTail     true when kWidthF > 8; the traits then also supply
+//                   fmask(n) / dmask(n) and masked fload / fstore / dload /
+//                   dstore overloads taking that mask
+//   kHalfConvert    true when the traits supply hload / hstore, kWidthF
+//                   half floats <-> VF in hardware
+//   kFusedFma       true when ffma rounds once (hardware FMA)
+// Node ranges come in multiples of 8 slots, so only levels wider than 8 float
+// lanes ever see a partial chunk; those run it with masked loads and stores.
+// Everything here is a template on V, so the per-level instantiations are
+// distinct symbols and never merged across translation units compiled for
+// different targets.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "node_kernels.h"
+#include "philox.h"
+
+namespace node_kernels {
+
+constexpr float kSpectralMults[8] = {0.3f, 0.7f, 0.9f, 1.2f, 1.4f, 1.8f, 2.1f, 2.7f};
+
+// Keeps the compiler from reassociating through v. Under -ffast-math an
+// unfused ffma chain of the Cody-Waite split below folds into one product
+// with pi / 2 rounded to float, an error of about |x| * 4e-8.
+template <class V>
+inline typename V::VF pinRounding(typename V::VF v) {
+    if constexpr (!V::kFusedFma) {
+#if defined(__GNUC__)
+        __asm__("" : "+m"(v));
+#endif
+    }
+    return v;
+}
+
+// Single-precision sin and cos from one range reduction.
+//
+// x is reduced to r in [-pi/4, pi/4] with q = round(x * 2/pi) and a three-part
+// Cody-Waite split of pi/2 evaluated with FMA, so no division is needed. The
+// Cephes minimax polynomials for sin and cos on that interval are then
+// combined by quadrant (q mod 4). Measured against double precision, the
+// maximum absolute error is 9.5e-8 for |x| <= 1e5 with hardware FMA; levels
+// that emulate FMA (scalar, SSE4.2) stay below 1e-7 up to |x| = 1e4 and reach
+// 1e-6 at 1e5. There is no Payne-Hanek stage, so error grows beyond that.
+//
+// Degree selects shorter minimax polynomials (SineDegree): degree 5 sin and
+// 6 cos reach 9.4e-7 on the reduced interval, degree 3 and 4 reach 3.2e-4,
+// for two and four fewer multiply-adds per value.
+template <class V, SineDegree Degree = SineDegree::Seven>
+inline void sincos(typename V::VF x, typename V::VF& sin_out, typename V::VF& cos_out) {
+    using VF = typename V::VF;
+    const VF q = V::ffloor(V::ffma(x, V::fset1(0.636619772367581343f), V::fset1(0.5f)));
+    VF r = pinRounding<V>(V::ffma(q, V::fset1(-1.5703125f), x));
+    r = pinRounding<V>(V::ffma(q, V::fset1(-4.837512969970703125e-4f), r));
+    r = V::ffma(q, V::fset1(-7.54978995489188216e-8f), r);
+    const VF r2 = V::fmul(r, r);
+
+    VF ps, pc;
+    if constexpr (Degree == SineDegree::Seven) {
+        ps = V::ffma(r2, V::fset1(-1.9515295891e-4f), V::fset1(8.3321608736e-3f));
+        ps = V::ffma(r2, ps, V::fset1(-1.6666654611e-1f));
+        pc = V::ffma(r2, V::fset1(2.443315711809948e-5f), V::fset1(-1.388731625493765e-3f));
+        pc = V::ffma(r2, pc, V::fset1(4.166664568298827e-2f));
+    } else if constexpr (Degree == SineDegree::Five) {
+        ps = V::ffma(r2, V::fset1(8.1529745e-3f), V::fset1(-1.6662833e-1f));
+        pc = V::ffma(r2, V::fset1(-1.3652429e-3f), V::fset1(4.1661278e-2f));
+    } else {
+        ps = V::fset1(-1.6225880e-1f);
+        pc = V::fset1(4.0908367e-2f);
+    }
+    const VF s = V::ffma(V::fmul(r2, r), ps, r);
+    const VF c = V::ffma(V::fmul(r2, r2), pc, V::ffma(r2, V::fset1(-0.5f), V::fset1(1.0f)));
+
+    // Quadrant bits of q mod 4 as 0/1 floats (q is integral and exact below 2^24)
+    const VF half_q = V::ffloor(V::fmul(q, V::fset1(0.5f)));
+    const VF quarter_q = V::ffloor(V::fmul(half_q, V::fset1(0.5f)));
+    const VF bit0 = V::fsub(q, V::fadd(half_q, half_q));
+    const VF bit1 = V::fsub(half_q, V::fadd(quarter_q, quarter_q));
+    // sin: +s, +c, -s, -c; cos: +c, -s, -c, +s for quadrants 0..3
+    const VF one = V::fset1(1.0f);
+    const VF two = V::fset1(2.0f);
+    const VF sin_sign = V::fsub(one, V::fmul(two, bit1));
+    const VF cos_flip = V::fsub(V::fadd(bit0, bit1), V::fmul(two, V::fmul(bit0, bit1)));
+    const VF cos_sign = V::fsub(one, V::fmul(two, cos_flip));
+    sin_out = V::fmul(sin_sign, V::fselect(bit0, s, c));
+    cos_out = V::fmul(cos_sign, V::fselect(bit0, c, s));
+}
+
+template <class V, SineDegree Degree = SineDegree::Seven>
+inline typename V::VF fastSin(typename V::VF x) {
+    typename V::VF s, c;
+    sincos<V, Degree>(x, s, c);
+    return s;
+}
+
+// Spectral boost with one independent input per lane. The partial sums are
+// paired like a horizontal hadd reduction so every level agrees with
+// spectral() lane for lane.
+template <class V, SineDegree Degree = SineDegree::Seven>
+inline typename V::VF spectralLanes(typename V::VF base) {
+    typename V::VF p[8];
+    for (int j = 0; j < 8; j++) {
+        p[j] = fastSin<V, Degree>(V::fmul(base, V::fset1(kSpectralMults[j])));
+    }
+    const typename V::VF s0 = V::fadd(p[0], p[4]);
+    const typename V::VF s1 = V::fadd(p[1], p[5]);
+    const typename V::VF s2 = V::fadd(p[2], p[6]);
+    const typename V::VF s3 = V::fadd(p[3], p[7]);
+    const typename V::VF sum = V::fadd(V::fadd(s0, s1), V::fadd(s2, s3));
+    return V::fmul(sum, V::fset1(0.125f));
+}
+
+static inline size_t validLanes(size_t i, size_t size, size_t width) {
+    if (i >= size) return 0;
+    return size - i < width ? size - i : width;
+}
+
+// Memory access for one full chunk of kWidthF lanes. Doubles are addressed
+// as two halves of kWidthD lanes: half 0 at p, half 1 at p + kWidthD.
+template <class V>
+struct FullChunk {
+    typename V::VF fload(const float* p) const { return V::fload(p); }
+    void fstore(float* p, typename V::VF v) const { V::fstore(p, v); }
+    typename V::VD dload(const double* p, int half) const { return V::dload(p + half * V::kWidthD); }
+    void dstore(double* p, int half, typename V::VD v) const { V::dstore(p + half * V::kWidthD, v); }
+};
+
+// Memory access for the first `lanes` lanes of a chunk; the rest are neither
+// read nor written (masked loads return zero there).
+template <class V>
+struct TailChunk {
+    explicit TailChunk(size_t lanes)
+        : f(V::fmask(lanes)),
+          d{V::dmask(lanes < V::kWidthD ? lanes : V::kWidthD),
+            V::dmask(lanes > V::kWidthD ? lanes - V::kWidthD : 0)} {}
+
+    typename V::VF fload(const float* p) const { return V::fload(p, f); }
+    void fstore(float* p, typename V::VF v) const { V::fstore(p, f, v); }
+    typename V::VD dload(const double* p, int half) const { return V::dload(p + half * V::kWidthD, d[half]); }
+    void dstore(double* p, int half, typename V::VD v) const { V::dstore(p + half * V::kWidthD, d[half], v); }
+
+    typename V::MaskF f;
+    typename V::MaskD d[2];
+};
+
+template <class V>
+void sincosLanesArray(const float* x, float* sin_out, float* cos_out, size_t n) {
+    typename V::VF s, c;
+    size_t t = 0;
+    for (; t + V::kWidthF <= n; t += V::kWidthF) {
+        sincos<V>(V::fload(x + t), s, c);
+        V::fstore(sin_out + t, s);
+        V::fstore(cos_out + t, c);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (t < n) {
+            const TailChunk<V> tail(n - t);
+            sincos<V>(tail.fload(x + t), s, c);
+            tail.fstore(sin_out + t, s);
+            tail.fstore(cos_out + t, c);
+        }
+    }
+}
+
+// Natural log of a positive normal float (Cephes logf), written on scalars
+// with a branch-free mantissa fold so the loops using it vectorize.
+inline float logPositive(float x) {
+    uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    float e = static_cast<float>(static_cast<int32_t>(bits >> 23) - 126);
+    const uint32_t mant_bits = (bits & 0x007FFFFFu) | 0x3F000000u;
+    float m;
+    std::memcpy(&m, &mant_bits, sizeof(m));  // [0.5, 1)
+    const bool low = m < 0.707106781186547524f;
+    e = low ? e - 1.0f : e;
+    m = low ? m + m - 1.0f : m - 1.0f;
+
+    const float z = m * m;
+    float y = 7.0376836292e-2f;
+    y = y * m - 1.1514610310e-1f;
+    y = y * m + 1.1676998740e-1f;
+    y = y * m - 1.2420140846e-1f;
+    y = y * m + 1.4249322787e-1f;
+    y = y * m - 1.6668057665e-1f;
+    y = y * m + 2.0000714765e-1f;
+    y = y * m - 2.4999993993e-1f;
+    y = y * m + 3.3333331174e-1f;
+    y = y * m * z;
+    y += -2.12194440e-4f * e - 0.5f * z;
+    return m + y + 0.693359375f * e;
+}
+
+// e^x for x <= 0 (Cephes expf), on scalars like logPositive; results below
+// the smallest normal float flush to 0.
+inline float expNonPositive(float x) {
+    x = x > -87.0f ? x : -87.0f;
+    const float n = std::floor(x * 1.44269504088896341f + 0.5f);
+    const float r = x - n * 0.693359375f + n * 2.12194440e-4f;
+    float y = 1.9875691500e-4f;
+    y = y * r + 1.3981999507e-3f;
+    y = y * r + 8.3334519073e-3f;
+    y = y * r + 4.1665795894e-2f;
+    y = y * r + 1.6666665459e-1f;
+    y = y * r + 5.0000001201e-1f;
+    y = y * r * r + r + 1.0f;
+    const uint32_t scale_bits = static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23;
+    float scale;
+    std::memcpy(&scale, &scale_bits, sizeof(scale));
+    return y * scale;
+}
+
+// Philox blocks handled per gaussianBlocks() call. Wide enough that the
+// counter and log loops below vectorize as loops on every target.
+constexpr size_t kNoiseBlocks = 64;
+
+// 4 * kNoiseBlocks standard normal samples from the Philox blocks of counters
+// [block, block + kNoiseBlocks) of stream; out[4 * j + w] comes from word w of
+// block + j. Words (0, 1) and (2, 3) each feed one Box-Muller pair, with
+// uniforms on the 2^-24 grid offset by half a step so log never sees 0.
+template <class V>
+inline void gaussianBlocks(uint32_t key0, uint32_t key1, uint64_t stream, uint64_t block, float* out) {
+    constexpr size_t B = kNoiseBlocks;
+    alignas(64) uint32_t c0[B], c1[B], c2[B], c3[B];
+    for (size_t j = 0; j < B; j++) {
+        c0[j] = static_cast<uint32_t>(block + j);
+        c1[j] = static_cast<uint32_t>((block + j) >> 32);
+        c2[j] = static_cast<uint32_t>(stream);
+        c3[j] = static_cast<uint32_t>(stream >> 32);
+    }
+    for (int r = 0; r < philox::kRounds; r++) {
+        const uint32_t k0 = key0 + r * philox::kWeyl0;
+        const uint32_t k1 = key1 + r * philox::kWeyl1;
+        for (size_t j = 0; j < B; j++) {
+            philox::round(c0[j], c1[j], c2[j], c3[j], k0, k1);
+        }
+    }
+
+    constexpr float kStep = 1.0f / 16777216.0f;
+    constexpr float kTwoPi = 6.283185307179586f;
+    alignas(64) float log01[B], log23[B], angle01[B], angle23[B];
+    for (size_t j = 0; j < B; j++) {
+        log01[j] = -2.0f * logPositive(static_cast<float>(static_cast<int32_t>(c0[j] >> 8)) * kStep + 0.5f * kStep);
+        log23[j] = -2.0f * logPositive(static_cast<float>(static_cast<int32_t>(c2[j] >> 8)) * kStep + 0.5f * kStep);
+        angle01[j] = static_cast<float>(static_cast<int32_t>(c1[j] >> 8)) * (kStep * kTwoPi);
+        angle23[j] = static_cast<float>(static_cast<int32_t>(c3[j] >> 8)) * (kStep * kTwoPi);
+    }
+
+    // Radius and angle to samples, reusing the log arrays for cos and the
+    // angle arrays for sin
+    typename V::VF s, c;
+    for (size_t j = 0; j < B; j += V::kWidthF) {
+        const typename V::VF r01 = V::fsqrt(V::fload(log01 + j));
+        const typename V::VF r23 = V::fsqrt(V::fload(log23 + j));
+        sincos<V>(V::fload(angle01 + j), s, c);
+        V::fstore(log01 + j, V::fmul(r01, c));
+        V::fstore(angle01 + j, V::fmul(r01, s));
+        sincos<V>(V::fload(angle23 + j), s, c);
+        V::fstore(log23 + j, V::fmul(r23, c));
+        V::fstore(angle23 + j, V::fmul(r23, s));
+    }
+
+    for (size_t j = 0; j < B; j++) {
+        out[4 * j + 0] = log01[j];
+        out[4 * j + 1] = angle01[j];
+        out[4 * j + 2] = log23[j];
+        out[4 * j + 3] = angle23[j];
+    }
+}
+
+template <class V>
+void gaussianNoise(uint64_t seed, uint64_t stream, uint64_t first, float sigma, float* out, size_t n) {
+    constexpr size_t kSamples = 4 * kNoiseBlocks;
+    const uint32_t key0 = static_cast<uint32_t>(seed);
+    const uint32_t key1 = static_cast<uint32_t>(seed >> 32);
+    float chunk[kSamples];
+
+    // Chunks start on 4-sample block boundaries; only the partial chunks at
+    // either end go through the staging buffer.
+    const uint64_t last = first + n;
+    for (uint64_t sample = first - first % 4; sample < last; sample += kSamples) {
+        if (sample >= first && sample + kSamples <= last) {
+            float* dst = out + (sample - first);
+            gaussianBlocks<V>(key0, key1, stream, sample / 4, dst);
+            for (size_t k = 0; k < kSamples; k++) dst[k] *= sigma;
+        } else {
+            gaussianBlocks<V>(key0, key1, stream, sample / 4, chunk);
+            const uint64_t begin = sample < first ? first : sample;
+            const uint64_t end = sample + kSamples < last ? sample + kSamples : last;
+            for (uint64_t k = begin; k < end; k++) out[k - first] = chunk[k - sample] * sigma;
+        }
+    }
+}
+
+// Horizontal sum of one float vector, lanes in order
+template <class V>
+inline float laneSum(typename V::VF v) {
+    float lanes[V::kWidthF];
+    V::fstore(lanes, v);
+    float sum = 0.0f;
+    for (size_t l = 0; l < V::kWidthF; l++) sum += lanes[l];
+    return sum;
+}
+
+// Row i against up to four rows j at a time, so each load of row i feeds
+// four independent accumulator chains
+template <class V>
+void pairProducts(const float* rows, size_t count, size_t stride, size_t n, float* out) {
+    using VF = typename V::VF;
+    constexpr size_t W = V::kWidthF;
+    for (size_t i = 0; i + 1 < count; i++) {
+        const float* a = rows + i * stride;
+        size_t j = i + 1;
+        for (; j + 4 <= count; j += 4) {
+            const float* b0 = rows + j * stride;
+            const float* b1 = b0 + stride;
+            const float* b2 = b1 + stride;
+            const float* b3 = b2 + stride;
+            VF s0 = V::fset1(0.0f), s1 = s0, s2 = s0, s3 = s0;
+            for (size_t k = 0; k < n; k += W) {
+                const VF x = V::fload(a + k);
+                s0 = V::ffma(x, V::fload(b0 + k), s0);
+                s1 = V::ffma(x, V::fload(b1 + k), s1);
+                s2 = V::ffma(x, V::fload(b2 + k), s2);
+                s3 = V::ffma(x, V::fload(b3 + k), s3);
+            }
+            const float sums[4] = {laneSum<V>(s0), laneSum<V>(s1), laneSum<V>(s2), laneSum<V>(s3)};
+            for (size_t q = 0; q < 4; q++) out[i * count + j + q] = out[(j + q) * count + i] = sums[q];
+        }
+        for (; j < count; j++) {
+            const float* b = rows + j * stride;
+            VF s = V::fset1(0.0f);
+            for (size_t k = 0; k < n; k += W) s = V::ffma(V::fload(a + k), V::fload(b + k), s);
+            out[i * count + j] = out[j * count + i] = laneSum<V>(s);
+        }
+    }
+}
+
+// Two rows of a against four of b per pass: each load feeds two or four
+// accumulator chains, eight in flight
+template <class V>
+void crossProducts(const float* a, size_t a_count, const float* b, size_t b_count, size_t stride, size_t n,
+                   float* out) {
+    using VF = typename V::VF;
+    constexpr size_t W = V::kWidthF;
+    size_t i = 0;
+    for (; i + 2 <= a_count; i += 2) {
+        const float* a0 = a + i * stride;
+        const float* a1 = a0 + stride;
+        size_t j = 0;
+        for (; j + 4 <= b_count; j += 4) {
+            const float* b0 = b + j * stride;
+            const float* b1 = b0 + stride;
+            const float* b2 = b1 + stride;
+            const float* b3 = b2 + stride;
+            VF s00 = V::fset1(0.0f), s01 = s00, s02 = s00, s03 = s00;
+            VF s10 = s00, s11 = s00, s12 = s00, s13 = s00;
+            for (size_t k = 0; k < n; k += W) {
+                const VF x0 = V::fload(a0 + k);
+                const VF x1 = V::fload(a1 + k);
+                const VF y0 = V::fload(b0 + k);
+                const VF y1 = V::fload(b1 + k);
+                const VF y2 = V::fload(b2 + k);
+                const VF y3 = V::fload(b3 + k);
+                s00 = V::ffma(x0, y0, s00);
+                s01 = V::ffma(x0, y1, s01);
+                s02 = V::ffma(x0, y2, s02);
+                s03 = V::ffma(x0, y3, s03);
+                s10 = V::ffma(x1, y0, s10);
+                s11 = V::ffma(x1, y1, s11);
+                s12 = V::ffma(x1, y2, s12);
+                s13 = V::ffma(x1, y3, s13);
+            }
+            float* row0 = out + i * b_count + j;
+            float* row1 = row0 + b_count;
+            row0[0] = laneSum<V>(s00);
+            row0[1] = laneSum<V>(s01);
+            row0[2] = laneSum<V>(s02);
+            row0[3] = laneSum<V>(s03);
+            row1[0] = laneSum<V>(s10);
+            row1[1] = laneSum<V>(s11);
+            row1[2] = laneSum<V>(s12);
+            row1[3] = laneSum<V>(s13);
+        }
+        for (; j < b_count; j++) {
+            const float* bj = b + j * stride;
+            VF s0 = V::fset1(0.0f), s1 = s0;
+            for (size_t k = 0; k < n; k += W) {
+                const VF y = V::fload(bj + k);
+                s0 = V::ffma(V::fload(a0 + k), y, s0);
+                s1 = V::ffma(V::fload(a1 + k), y, s1);
+            }
+            out[i * b_count + j] = laneSum<V>(s0);
+            out[(i + 1) * b_count + j] = laneSum<V>(s1);
+        }
+    }
+    for (; i < a_count; i++) {
+        const float* ai = a + i * stride;
+        for (size_t j = 0; j < b_count; j++) {
+            const float* bj = b + j * stride;
+            VF s = V::fset1(0.0f);
+            for (size_t k = 0; k < n; k += W) s = V::ffma(V::fload(ai + k), V::fload(bj + k), s);
+            out[i * b_count + j] = laneSum<V>(s);
+        }
+    }
+}
+
+template <class V>
+void mixRows(const float* rows, size_t count, ptrdiff_t stride, const float* weights, size_t outputs,
+             float* const* out, size_t n) {
+    using VF = typename V::VF;
+    constexpr size_t W = V::kWidthF;
+    constexpr size_t kMaxOutputs = 4;
+    if (outputs > kMaxOutputs) outputs = kMaxOutputs;
+    size_t t = 0;
+    for (; t + W <= n; t += W) {
+        VF acc[kMaxOutputs];
+        for (size_t o = 0; o < outputs; o++) acc[o] = V::fset1(0.0f);
+        for (size_t r = 0; r < count; r++) {
+            const VF x = V::fload(rows + static_cast<ptrdiff_t>(r) * stride + t);
+            for (size_t o = 0; o < outputs; o++) acc[o] = V::ffma(x, V::fset1(weights[o * count + r]), acc[o]);
+        }
+        for (size_t o = 0; o < outputs; o++) V::fstore(out[o] + t, acc[o]);
+    }
+    for (; t < n; t++) {
+        float acc[kMaxOutputs] = {};
+        for (size_t r = 0; r < count; r++) {
+            const float x = rows[static_cast<ptrdiff_t>(r) * stride + t];
+            for (size_t o = 0; o < outputs; o++) acc[o] += x * weights[o * count + r];
+        }
+        for (size_t o = 0; o < outputs; o++) out[o][t] = acc[o];
+    }
+}
+
+// Real and imaginary products in separate chains (re = rr - ii), so every
+// partition is four independent FMAs per chunk
+template <class V>
+void spectrumMac(const float* const* x, const float* h, size_t count, size_t stride, float* out) {
+    using VF = typename V::VF;
+    constexpr size_t W = V::kWidthF;
+    for (size_t k = 0; k < stride; k += W) {
+        VF rr = V::fset1(0.0f), ii = rr, ri = rr, ir = rr;
+        for (size_t p = 0; p < count; p++) {
+            const float* xp = x[p] + k;
+            const float* hp = h + 2 * p * stride + k;
+            const VF xr = V::fload(xp), xi = V::fload(xp + stride);
+            const VF hr = V::fload(hp), hi = V::fload(hp + stride);
+            rr = V::ffma(xr, hr, rr);
+            ii = V::ffma(xi, hi, ii);
+            ri = V::ffma(xr, hi, ri);
+            ir = V::ffma(xi, hr, ir);
+        }
+        V::fstore(out + k, V::fsub(rr, ii));
+        V::fstore(out + stride + k, V::fadd(ri, ir));
+    }
+}
+
+// Channels per colorMap() pass: the per-channel loops run over stack
+// arrays of this length, so they vectorize as plain loops on every target
+constexpr size_t kColorBlock = 64;
+
+template <class V>
+void colorMap(const float* frequency, const float* amplitude, size_t n, const ColorMapParams& p, float* hsl,
+              uint8_t* rgba) {
+    constexpr size_t B = kColorBlock;
+    const float axis_min = p.log_scale ? logPositive(p.min_frequency) : p.min_frequency;
+    const float axis_max = p.log_scale ? logPositive(p.max_frequency) : p.max_frequency;
+    const float hue_scale = 360.0f / (axis_max - axis_min);
+    const float rotation = p.rotate ? p.rotation : 0.0f;
+    const float wrap = p.rotate ? 1.0f : 0.0f;
+    const float s = p.saturation;
+
+    for (size_t t = 0; t < n; t += B) {
+        const size_t m = n - t < B ? n - t : B;
+        alignas(64) float hue[B], light[B], chroma[B], rgb[3][B];
+        for (size_t j = 0; j < m; j++) {
+            float f = frequency[t + j];
+            f = f < p.min_frequency ? p.min_frequency : f;
+            f = f > p.max_frequency ? p.max_frequency : f;
+            const float x = p.log_scale ? logPositive(f) : f;
+            float h = (x - axis_min) * hue_scale + rotation;
+            h -= wrap * 360.0f * std::floor(h * (1.0f / 360.0f));
+            hue[j] = h;
+
+            float a = amplitude[t + j];
+            a = a > 0.0f ? a : 0.0f;  // NaN goes to 0
+            a = a < 1.0f ? a : 1.0f;
+            const float l = expNonPositive(p.inv_gamma * logPositive(a > 1.17549435e-38f ? a : 1.17549435e-38f));
+            light[j] = (a > 0.0f ? l : 0.0f) * p.lightness_gain;
+            chroma[j] = s * (light[j] < 1.0f - light[j] ? light[j] : 1.0f - light[j]);
+        }
+
+        // HSL to RGB: channel c = l - chroma * clamp(min(k - 3, 9 - k), -1, 1)
+        // with k = (offset + h / 30) mod 12, offsets 0, 8, 4 for r, g, b
+        constexpr float kOffsets[3] = {0.0f, 8.0f, 4.0f};
+        for (size_t c = 0; c < 3; c++) {
+            for (size_t j = 0; j < m; j++) {
+                float k = kOffsets[c] + hue[j] * (1.0f / 30.0f);
+                k -= 12.0f * std::floor(k * (1.0f / 12.0f));
+                float w = k - 3.0f < 9.0f - k ? k - 3.0f : 9.0f - k;
+                w = w < 1.0f ? w : 1.0f;
+                w = w > -1.0f ? w : -1.0f;
+                rgb[c][j] = light[j] - chroma[j] * w;
+            }
+        }
+
+        if (hsl) {
+            float* dst = hsl + 3 * t;
+            for (size_t j = 0; j < m; j++) {
+                dst[3 * j + 0] = hue[j];
+                dst[3 * j + 1] = s;
+                dst[3 * j + 2] = light[j];
+            }
+        }
+        if (rgba) {
+            uint8_t* dst = rgba + 4 * t;
+            for (size_t j = 0; j < m; j++) {
+                for (size_t c = 0; c < 3; c++) {
+                    float v = rgb[c][j];
+                    v = v > 0.0f ? v : 0.0f;
+                    v = v < 1.0f ? v : 1.0f;
+                    dst[4 * j + c] = static_cast<uint8_t>(static_cast<int32_t>(v * 255.0f + 0.5f));
+                }
+                dst[4 * j + 3] = p.alpha;
+            }
+        }
+    }
+}
+
+// --- filter nodes --------------------------------------------------------------
+
+// Cascades of Sections biquads over one chunk of filter nodes, in the
+// expressions and order of the bank's transposed direct form II
+template <class V, size_t Sections, class A>
+inline void biquadChunk(const A& acc, FilterNodeBank& bank, size_t i, size_t valid, const float* in,
+                        size_t in_stride, float* out, size_t n) {
+    using VF = typename V::VF;
+    constexpr size_t W = V::kWidthF;
+    VF b0[Sections], b1[Sections], b2[Sections], a1[Sections], a2[Sections], z1[Sections], z2[Sections];
+    for (size_t s = 0; s < Sections; s++) {
+        const FilterNodeBank::Section c = bank.section(s);
+        b0[s] = acc.fload(c.b0 + i);
+        b1[s] = acc.fload(c.b1 + i);
+        b2[s] = acc.fload(c.b2 + i);
+        a1[s] = acc.fload(c.a1 + i);
+        a2[s] = acc.fload(c.a2 + i);
+        z1[s] = acc.fload(c.z1 + i);
+        z2[s] = acc.fload(c.z2 + i);
+    }
+    // Padding lanes read zeros
+    alignas(64) float in_lanes[W] = {};
+    alignas(64) float lanes[W];
+
+    for (size_t t = 0; t < n; t++) {
+        VF x;
+        if (in_stride == 0) {
+            x = V::fset1(in[t]);
+        } else {
+            for (size_t lane = 0; lane < valid; lane++) in_lanes[lane] = in[(i + lane) * in_stride + t];
+            x = V::fload(in_lanes);
+        }
+        for (size_t s = 0; s < Sections; s++) {
+            const VF y = V::ffma(b0[s], x, z1[s]);
+            z1[s] = V::fadd(V::fsub(V::fmul(b1[s], x), V::fmul(a1[s], y)), z2[s]);
+            z2[s] = V::fsub(V::fmul(b2[s], x), V::fmul(a2[s], y));
+            x = y;
+        }
+        V::fstore(lanes, x);
+        for (size_t lane = 0; lane < valid; lane++) out[(i + lane) * n + t] = lanes[lane];
+    }
+
+    for (size_t s = 0; s < Sections; s++) {
+        const FilterNodeBank::Section c = bank.section(s);
+        acc.fstore(c.z1 + i, z1[s]);
+        acc.fstore(c.z2 + i, z2[s]);
+    }
+}
+
+template <class V, size_t Sections>
+void biquadRange(FilterNodeBank& bank, size_t begin, size_t end, const float* in, size_t in_stride,
+                 float* out, size_t n) {
+    constexpr size_t W = V::kWidthF;
+    const size_t size = bank.size();
+    size_t i = begin;
+    for (; i + W <= end; i += W) {
+        biquadChunk<V, Sections>(FullChunk<V>(), bank, i, validLanes(i, size, W), in, in_stride, out, n);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (i < end) {
+            biquadChunk<V, Sections>(TailChunk<V>(end - i), bank, i, validLanes(i, size, end - i), in, in_stride,
+                                     out, n);
+        }
+    }
+}
+
+// One instantiation per section count, so each cascade unrolls
+template <class V>
+void biquadBlock(FilterNodeBank& bank, size_t begin, size_t end, const float* in, size_t in_stride,
+                 float* out, size_t n) {
+    static_assert(FilterNodeBank::kMaxSections == 4, "one case per section count");
+    switch (bank.sections()) {
+        case 1: biquadRange<V, 1>(bank, begin, end, in, in_stride, out, n); break;
+        case 2: biquadRange<V, 2>(bank, begin, end, in, in_stride, out, n); break;
+        case 3: biquadRange<V, 3>(bank, begin, end, in, in_stride, out, n); break;
+        default: biquadRange<V, 4>(bank, begin, end, in, in_stride, out, n); break;
+    }
+}
+
+template <class V, class A>
+inline void harmonicsChunk(const A& acc, size_t k, float input, float offset, float* out8) {
+    alignas(64) static const float kIndex[8] = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+    const typename V::VF h = acc.fload(kIndex + k);
+    const typename V::VF freq = V::fadd(V::fmul(V::fset1(input), h), V::fset1(offset));
+    const typename V::VF amplitude = V::fdiv(V::fset1(0.1f), h);
+    acc.fstore(out8 + k, V::fmul(fastSin<V>(freq), amplitude));
+}
+
+template <class V>
+void harmonics(float input, float offset, float* out8) {
+    size_t k = 0;
+    for (; k + V::kWidthF <= 8; k += V::kWidthF) {
+        harmonicsChunk<V>(FullChunk<V>(), k, input, offset, out8);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (k < 8) harmonicsChunk<V>(TailChunk<V>(8 - k), k, input, offset, out8);
+    }
+}
+
+template <class V, SineDegree Degree, class A>
+inline void spectralChunk(const A& acc, size_t k, float base, float* p) {
+    acc.fstore(p + k, fastSin<V, Degree>(V::fmul(V::fset1(base), acc.fload(kSpectralMults + k))));
+}
+
+template <class V, SineDegree Degree>
+float spectral(float base) {
+    alignas(64) float p[8];
+    size_t k = 0;
+    for (; k + V::kWidthF <= 8; k += V::kWidthF) {
+        spectralChunk<V, Degree>(FullChunk<V>(), k, base, p);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (k < 8) spectralChunk<V, Degree>(TailChunk<V>(8 - k), k, base, p);
+    }
+    return (((p[0] + p[4]) + (p[1] + p[5])) + ((p[2] + p[6]) + (p[3] + p[7]))) * 0.125f;
+}
+
+template <class V, SineDegree Degree>
+void spectralLanesArray(const float* base, float* boost, size_t n) {
+    size_t t = 0;
+    for (; t + V::kWidthF <= n; t += V::kWidthF) {
+        V::fstore(boost + t, spectralLanes<V, Degree>(V::fload(base + t)));
+    }
+    if constexpr (V::kMaskedTail) {
+        if (t < n) {
+            const TailChunk<V> tail(n - t);
+            tail.fstore(boost + t, spectralLanes<V, Degree>(tail.fload(base + t)));
+        }
+    }
+}
+
+// --- pipeline stages -------------------------------------------------------
+//
+// Stage policies of the per-node kernels. P below is a Pipeline<I, B, D>, one
+// per NodePipeline preset and, for presets with the boost, SineDegree of its
+// sines; makeTables() instantiates every kernel for each.
+
+// Leaky integrator: state += (amp - state) * time_constant
+struct LeakyIntegrator {
+    template <class V>
+    static typename V::VD stepD(typename V::VD amp, typename V::VD state, typename V::VD tc) {
+        return V::dfma(V::dsub(amp, state), tc, state);
+    }
+    template <class V>
+    static typename V::VF stepF(typename V::VF amp, typename V::VF state, typename V::VF tc) {
+        return V::ffma(V::fsub(amp, state), tc, state);
+    }
+};
+
+// Integrator bypassed: the state follows the amplified input
+struct NoIntegrator {
+    template <class V>
+    static typename V::VD stepD(typename V::VD amp, typename V::VD, typename V::VD) { return amp; }
+    template <class V>
+    static typename V::VF stepF(typename V::VF amp, typename V::VF, typename V::VF) { return amp; }
+};
+
+struct SpectralBoost { static constexpr bool kEnabled = true; };
+struct NoBoost { static constexpr bool kEnabled = false; };
+
+template <class I, class B, SineDegree D = SineDegree::Seven>
+struct Pipeline {
+    using Integrator = I;
+    static constexpr bool kBoost = B::kEnabled;
+    static constexpr SineDegree kSineDegree = D;
+};
+
+// --- double bank -----------------------------------------------------------
+
+// One node step for the kWidthF consecutive slots starting at i
+template <class V, class P, class A>
+inline void stepF64(const A& acc, NodeBank& bank, size_t i, typename V::VD input,
+                    typename V::VD control_lo, typename V::VD control_hi, typename V::VD aux,
+                    typename V::VD& out_lo, typename V::VD& out_hi) {
+    using VD = typename V::VD;
+    using I = typename P::Integrator;
+
+    VD state_lo = acc.dload(bank.integrator_state + i, 0);
+    VD state_hi = acc.dload(bank.integrator_state + i, 1);
+    const VD fb_lo = acc.dload(bank.feedback_gain + i, 0);
+    const VD fb_hi = acc.dload(bank.feedback_gain + i, 1);
+
+    // The boost sees the shared amplified input; the integrator sees it
+    // scaled by the node's gain
+    const VD amp_lo = V::dmul(input, control_lo);
+    const VD amp_hi = V::dmul(input, control_hi);
+    state_lo = I::template stepD<V>(V::dmul(amp_lo, acc.dload(bank.input_gain + i, 0)), state_lo,
+                                    acc.dload(bank.time_constant + i, 0));
+    state_hi = I::template stepD<V>(V::dmul(amp_hi, acc.dload(bank.input_gain + i, 1)), state_hi,
+                                    acc.dload(bank.time_constant + i, 1));
+
+    out_lo = V::dfma(state_lo, fb_lo, state_lo);
+    out_hi = V::dfma(state_hi, fb_hi, state_hi);
+    if constexpr (P::kBoost) {
+        VD boost_lo, boost_hi;
+        V::unpack(spectralLanes<V, P::kSineDegree>(V::pack(V::dadd(amp_lo, aux), V::dadd(amp_hi, aux))),
+                  boost_lo, boost_hi);
+        out_lo = V::dfma(boost_lo, acc.dload(bank.spectral_mix + i, 0), out_lo);
+        out_hi = V::dfma(boost_hi, acc.dload(bank.spectral_mix + i, 1), out_hi);
+    } else {
+        (void)aux;
+    }
+    out_lo = V::dmin(V::dmax(out_lo, acc.dload(bank.clamp_low + i, 0)), acc.dload(bank.clamp_high + i, 0));
+    out_hi = V::dmin(V::dmax(out_hi, acc.dload(bank.clamp_low + i, 1)), acc.dload(bank.clamp_high + i, 1));
+
+    acc.dstore(bank.integrator_state + i, 0, state_lo);
+    acc.dstore(bank.integrator_state + i, 1, state_hi);
+    acc.dstore(bank.current_output + i, 0, out_lo);
+    acc.dstore(bank.current_output + i, 1, out_hi);
+    acc.dstore(bank.previous_input + i, 0, input);
+    acc.dstore(bank.previous_input + i, 1, input);
+}
+
+template <class V, class P, class A>
+inline double waveChunkF64(const A& acc, NodeBank& bank, size_t i, size_t valid, double input_signal,
+                           double control_pattern, const double* control_wave, const double* pass_aux, int passes) {
+    constexpr size_t W = V::kWidthF;
+    constexpr size_t WD = V::kWidthD;
+    const typename V::VD input = V::dset1(input_signal);
+    const typename V::VD pattern = V::dset1(control_pattern);
+    alignas(64) double outputs[W];
+    double partial = 0.0;
+
+    for (int pass = 0; pass < passes; pass++) {
+        const double* wave = control_wave + i + pass;
+        typename V::VD out_lo, out_hi;
+        stepF64<V, P>(acc, bank, i, input, V::dadd(pattern, V::dload(wave)), V::dadd(pattern, V::dload(wave + WD)),
+                   V::dset1(pass_aux[pass]), out_lo, out_hi);
+        V::dstore(outputs, out_lo);
+        V::dstore(outputs + WD, out_hi);
+        for (size_t lane = 0; lane < valid; lane++) {
+            partial += outputs[lane];
+        }
+    }
+    return partial;
+}
+
+template <class V, class P>
+double waveF64(NodeBank& bank, size_t begin, size_t end, double input_signal,
+               double control_pattern, const double* control_wave, const double* pass_aux, int passes) {
+    constexpr size_t W = V::kWidthF;
+    const size_t size = bank.size();
+    double partial = 0.0;
+    size_t i = begin;
+    for (; i + W <= end; i += W) {
+        partial += waveChunkF64<V, P>(FullChunk<V>(), bank, i, validLanes(i, size, W),
+                                   input_signal, control_pattern, control_wave, pass_aux, passes);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (i < end) {
+            partial += waveChunkF64<V, P>(TailChunk<V>(end - i), bank, i, validLanes(i, size, end - i),
+                                       input_signal, control_pattern, control_wave, pass_aux, passes);
+        }
+    }
+    return partial;
+}
+
+template <class V, class P, class A>
+inline void missionChunkF64(const A& acc, NodeBank& bank, size_t i, double input_signal,
+                            double control_signal, int repeats) {
+    const typename V::VD input = V::dset1(input_signal);
+    const typename V::VD control = V::dset1(control_signal);
+    const typename V::VD aux = V::dset1(0.0);
+    typename V::VD out_lo, out_hi;
+    for (int r = 0; r < repeats; r++) {
+        stepF64<V, P>(acc, bank, i, input, control, control, aux, out_lo, out_hi);
+    }
+}
+
+template <class V, class P>
+void missionF64(NodeBank& bank, size_t begin, size_t end, double input_signal,
+                double control_signal, int repeats) {
+    size_t i = begin;
+    for (; i + V::kWidthF <= end; i += V::kWidthF) {
+        missionChunkF64<V, P>(FullChunk<V>(), bank, i, input_signal, control_signal, repeats);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (i < end) missionChunkF64<V, P>(TailChunk<V>(end - i), bank, i, input_signal, control_signal, repeats);
+    }
+}
+
+// Mission over a precomputed schedule: the integrator state stays in
+// registers for every step and repeat, and only the last step's output is
+// formed, since each repeat overwrites the previous one. Matches `steps`
+// calls of missionChunkF64 bit for bit.
+template <class V, class P, class A>
+inline void missionScheduleChunkF64(const A& acc, NodeBank& bank, size_t i, const double* amplified,
+                                    const float* boost, size_t steps, int repeats, double last_input) {
+    using VD = typename V::VD;
+    using I = typename P::Integrator;
+    VD state_lo = acc.dload(bank.integrator_state + i, 0);
+    VD state_hi = acc.dload(bank.integrator_state + i, 1);
+    const VD gain_lo = acc.dload(bank.input_gain + i, 0);
+    const VD gain_hi = acc.dload(bank.input_gain + i, 1);
+    const VD tc_lo = acc.dload(bank.time_constant + i, 0);
+    const VD tc_hi = acc.dload(bank.time_constant + i, 1);
+    for (size_t s = 0; s < steps; s++) {
+        const VD amp = V::dset1(amplified[s]);
+        const VD amp_lo = V::dmul(amp, gain_lo);
+        const VD amp_hi = V::dmul(amp, gain_hi);
+        for (int r = 0; r < repeats; r++) {
+            state_lo = I::template stepD<V>(amp_lo, state_lo, tc_lo);
+            state_hi = I::template stepD<V>(amp_hi, state_hi, tc_hi);
+        }
+    }
+
+    VD out_lo = V::dfma(state_lo, acc.dload(bank.feedback_gain + i, 0), state_lo);
+    VD out_hi = V::dfma(state_hi, acc.dload(bank.feedback_gain + i, 1), state_hi);
+    if constexpr (P::kBoost) {
+        const VD last_boost = V::dset1(static_cast<double>(boost[steps - 1]));
+        out_lo = V::dfma(last_boost, acc.dload(bank.spectral_mix + i, 0), out_lo);
+        out_hi = V::dfma(last_boost, acc.dload(bank.spectral_mix + i, 1), out_hi);
+    }
+    out_lo = V::dmin(V::dmax(out_lo, acc.dload(bank.clamp_low + i, 0)), acc.dload(bank.clamp_high + i, 0));
+    out_hi = V::dmin(V::dmax(out_hi, acc.dload(bank.clamp_low + i, 1)), acc.dload(bank.clamp_high + i, 1));
+
+    acc.dstore(bank.integrator_state + i, 0, state_lo);
+    acc.dstore(bank.integrator_state + i, 1, state_hi);
+    acc.dstore(bank.current_output + i, 0, out_lo);
+    acc.dstore(bank.current_output + i, 1, out_hi);
+    acc.dstore(bank.previous_input + i, 0, V::dset1(last_input));
+    acc.dstore(bank.previous_input + i, 1, V::dset1(last_input));
+}
+
+template <class V, class P>
+void missionScheduleF64(NodeBank& bank, size_t begin, size_t end, const double* amplified, const float* boost,
+                        size_t steps, int repeats, double last_input) {
+    if (steps == 0 || repeats <= 0) return;
+    size_t i = begin;
+    for (; i + V::kWidthF <= end; i += V::kWidthF) {
+        missionScheduleChunkF64<V, P>(FullChunk<V>(), bank, i, amplified, boost, steps, repeats, last_input);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (i < end) {
+            missionScheduleChunkF64<V, P>(TailChunk<V>(end - i), bank, i, amplified, boost, steps, repeats,
+                                       last_input);
+        }
+    }
+}
+
+// Folds the per-lane sums and extremes of a block chunk's first valid
+// lanes, n samples each, into stats
+template <class T>
+inline void foldBlockLanes(BlockStatsPartial& stats, const T* sum, const T* squares, const T* low, const T* high,
+                           size_t valid, size_t n) {
+    for (size_t lane = 0; lane < valid; lane++) {
+        stats.sum += static_cast<double>(sum[lane]);
+        stats.sum_squares += static_cast<double>(squares[lane]);
+        stats.min = std::min(stats.min, static_cast<double>(low[lane]));
+        stats.max = std::max(stats.max, static_cast<double>(high[lane]));
+    }
+    stats.count += valid * n;
+}
+
+// Block kernel: integrator state stays in registers for all n samples, and
+// the output is fma(state, 1 + feedback, boost * spectral_mix). kStats adds
+// running sums and extremes of the outputs, also in registers.
+template <class V, class P, bool kStats, class A>
+inline void blockChunkF64(const A& acc, NodeBank& bank, size_t i, size_t valid, const double* amplified,
+                          const float* boost, float last_input, float* out, size_t n, size_t out_first,
+                          BlockStatsPartial* stats) {
+    using VD = typename V::VD;
+    constexpr size_t W = V::kWidthF;
+    constexpr size_t WD = V::kWidthD;
+    using I = typename P::Integrator;
+    const VD one = V::dset1(1.0);
+    alignas(64) double lanes[W];
+    const bool histogram = kStats && stats->histogram;
+    VD sum_lo = V::dset1(0.0), sum_hi = sum_lo, sq_lo = sum_lo, sq_hi = sum_lo;
+    VD min_lo = V::dset1(std::numeric_limits<double>::infinity()), min_hi = min_lo;
+    VD max_lo = V::dset1(-std::numeric_limits<double>::infinity()), max_hi = max_lo;
+
+    VD state_lo = acc.dload(bank.integrator_state + i, 0);
+    VD state_hi = acc.dload(bank.integrator_state + i, 1);
+    const VD gain_lo = V::dadd(one, acc.dload(bank.feedback_gain + i, 0));
+    const VD gain_hi = V::dadd(one, acc.dload(bank.feedback_gain + i, 1));
+    const VD in_gain_lo = acc.dload(bank.input_gain + i, 0);
+    const VD in_gain_hi = acc.dload(bank.input_gain + i, 1);
+    const VD tc_lo = acc.dload(bank.time_constant + i, 0);
+    const VD tc_hi = acc.dload(bank.time_constant + i, 1);
+    const VD mix_lo = acc.dload(bank.spectral_mix + i, 0);
+    const VD mix_hi = acc.dload(bank.spectral_mix + i, 1);
+    const VD clamp_lo_lo = acc.dload(bank.clamp_low + i, 0);
+    const VD clamp_lo_hi = acc.dload(bank.clamp_low + i, 1);
+    const VD clamp_hi_lo = acc.dload(bank.clamp_high + i, 0);
+    const VD clamp_hi_hi = acc.dload(bank.clamp_high + i, 1);
+    VD out_lo = acc.dload(bank.current_output + i, 0);
+    VD out_hi = acc.dload(bank.current_output + i, 1);
+
+    for (size_t t = 0; t < n; t++) {
+        const VD amp = V::dset1(amplified[t]);
+        state_lo = I::template stepD<V>(V::dmul(amp, in_gain_lo), state_lo, tc_lo);
+        state_hi = I::template stepD<V>(V::dmul(amp, in_gain_hi), state_hi, tc_hi);
+        if constexpr (P::kBoost) {
+            const VD bst = V::dset1(static_cast<double>(boost[t]));
+            out_lo = V::dfma(state_lo, gain_lo, V::dmul(bst, mix_lo));
+            out_hi = V::dfma(state_hi, gain_hi, V::dmul(bst, mix_hi));
+        } else {
+            out_lo = V::dmul(state_lo, gain_lo);
+            out_hi = V::dmul(state_hi, gain_hi);
+        }
+        out_lo = V::dmin(V::dmax(out_lo, clamp_lo_lo), clamp_hi_lo);
+        out_hi = V::dmin(V::dmax(out_hi, clamp_lo_hi), clamp_hi_hi);
+        if constexpr (kStats) {
+            sum_lo = V::dadd(sum_lo, out_lo);
+            sum_hi = V::dadd(sum_hi, out_hi);
+            sq_lo = V::dfma(out_lo, out_lo, sq_lo);
+            sq_hi = V::dfma(out_hi, out_hi, sq_hi);
+            min_lo = V::dmin(min_lo, out_lo);
+            min_hi = V::dmin(min_hi, out_hi);
+            max_lo = V::dmax(max_lo, out_lo);
+            max_hi = V::dmax(max_hi, out_hi);
+        }
+        if (out || histogram) {
+            V::dstore(lanes, out_lo);
+            V::dstore(lanes + WD, out_hi);
+            for (size_t lane = 0; lane < valid; lane++) {
+                if (out) out[(i + lane - out_first) * n + t] = static_cast<float>(lanes[lane]);
+                if (histogram) stats->bin(lanes[lane]);
+            }
+        }
+    }
+    if constexpr (kStats) {
+        alignas(64) double sums[W], squares[W], lows[W], highs[W];
+        V::dstore(sums, sum_lo);
+        V::dstore(sums + WD, sum_hi);
+        V::dstore(squares, sq_lo);
+        V::dstore(squares + WD, sq_hi);
+        V::dstore(lows, min_lo);
+        V::dstore(lows + WD, min_hi);
+        V::dstore(highs, max_lo);
+        V::dstore(highs + WD, max_hi);
+        foldBlockLanes(*stats, sums, squares, lows, highs, valid, n);
+    }
+
+    const VD last = V::dset1(static_cast<double>(last_input));
+    acc.dstore(bank.integrator_state + i, 0, state_lo);
+    acc.dstore(bank.integrator_state + i, 1, state_hi);
+    acc.dstore(bank.current_output + i, 0, out_lo);
+    acc.dstore(bank.current_output + i, 1, out_hi);
+    acc.dstore(bank.previous_input + i, 0, last);
+    acc.dstore(bank.previous_input + i, 1, last);
+}
+
+template <class V, class P, bool kStats>
+void blockRangeF64(NodeBank& bank, size_t begin, size_t end, const double* amplified,
+                   const float* boost, float last_input, float* out, size_t n, size_t out_first,
+                   BlockStatsPartial* stats) {
+    constexpr size_t W = V::kWidthF;
+    const size_t size = bank.size();
+    size_t i = begin;
+    for (; i + W <= end; i += W) {
+        blockChunkF64<V, P, kStats>(FullChunk<V>(), bank, i, validLanes(i, size, W), amplified, boost, last_input,
+                                    out, n, out_first, stats);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (i < end) {
+            blockChunkF64<V, P, kStats>(TailChunk<V>(end - i), bank, i, validLanes(i, size, end - i),
+                                        amplified, boost, last_input, out, n, out_first, stats);
+        }
+    }
+}
+
+template <class V, class P>
+void blockF64(NodeBank& bank, size_t begin, size_t end, const double* amplified,
+              const float* boost, float last_input, float* out, size_t n, size_t out_first,
+              BlockStatsPartial* stats) {
+    if (stats) {
+        blockRangeF64<V, P, true>(bank, begin, end, amplified, boost, last_input, out, n, out_first, stats);
+    } else {
+        blockRangeF64<V, P, false>(bank, begin, end, amplified, boost, last_input, out, n, out_first, nullptr);
+    }
+}
+
+// --- float bank --------------------------------------------------------------
+
+template <class V, class P, class A>
+inline typename V::VF stepF32(const A& acc, NodeBankF32& bank, size_t i, typename V::VF input,
+                              typename V::VF control, typename V::VF aux) {
+    using VF = typename V::VF;
+    VF state = acc.fload(bank.integrator_state + i);
+    const VF amp = V::fmul(input, control);
+    state = P::Integrator::template stepF<V>(V::fmul(amp, acc.fload(bank.input_gain + i)), state,
+                                             acc.fload(bank.time_constant + i));
+    VF out = V::ffma(state, acc.fload(bank.feedback_gain + i), state);
+    if constexpr (P::kBoost) {
+        out = V::ffma(spectralLanes<V, P::kSineDegree>(V::fadd(amp, aux)), acc.fload(bank.spectral_mix + i), out);
+    } else {
+        (void)aux;
+    }
+    out = V::fmin(V::fmax(out, acc.fload(bank.clamp_low + i)), acc.fload(bank.clamp_high + i));
+    acc.fstore(bank.integrator_state + i, state);
+    acc.fstore(bank.current_output + i, out);
+    acc.fstore(bank.previous_input + i, input);
+    return out;
+}
+
+// Control of the lanes from node i in a pass: the sum in double, as the
+// table holds it, then rounded to float
+template <class V>
+inline typename V::VF waveControlF32(typename V::VD pattern, const double* wave) {
+    return V::pack(V::dadd(pattern, V::dload(wave)), V::dadd(pattern, V::dload(wave + V::kWidthD)));
+}
+
+template <class V, class P, class A>
+inline double waveChunkF32(const A& acc, NodeBankF32& bank, size_t i, size_t valid, double input_signal,
+                           double control_pattern, const double* control_wave, const double* pass_aux, int passes) {
+    constexpr size_t W = V::kWidthF;
+    const typename V::VF input = V::fset1(static_cast<float>(input_signal));
+    const typename V::VD pattern = V::dset1(control_pattern);
+    alignas(64) float outputs[W];
+    double partial = 0.0;
+
+    for (int pass = 0; pass < passes; pass++) {
+        V::fstore(outputs, stepF32<V, P>(acc, bank, i, input, waveControlF32<V>(pattern, control_wave + i + pass),
+                                      V::fset1(static_cast<float>(pass_aux[pass]))));
+        for (size_t lane = 0; lane < valid; lane++) {
+            partial += static_cast<double>(outputs[lane]);
+        }
+    }
+    return partial;
+}
+
+template <class V, class P>
+double waveF32(NodeBankF32& bank, size_t begin, size_t end, double input_signal,
+               double control_pattern, const double* control_wave, const double* pass_aux, int passes) {
+    constexpr size_t W = V::kWidthF;
+    const size_t size = bank.size();
+    double partial = 0.0;
+    size_t i = begin;
+    for (; i + W <= end; i += W) {
+        partial += waveChunkF32<V, P>(FullChunk<V>(), bank, i, validLanes(i, size, W),
+                                   input_signal, control_pattern, control_wave, pass_aux, passes);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (i < end) {
+            partial += waveChunkF32<V, P>(TailChunk<V>(end - i), bank, i, validLanes(i, size, end - i),
+                                       input_signal, control_pattern, control_wave, pass_aux, passes);
+        }
+    }
+    return partial;
+}
+
+template <class V, class P, class A>
+inline void missionChunkF32(const A& acc, NodeBankF32& bank, size_t i, float input_signal,
+                            float control_signal, int repeats) {
+    const typename V::VF input = V::fset1(input_signal);
+    const typename V::VF control = V::fset1(control_signal);
+    const typename V::VF aux = V::fset1(0.0f);
+    for (int r = 0; r < repeats; r++) {
+        stepF32<V, P>(acc, bank, i, input, control, aux);
+    }
+}
+
+template <class V, class P>
+void missionF32(NodeBankF32& bank, size_t begin, size_t end, float input_signal,
+                float control_signal, int repeats) {
+    size_t i = begin;
+    for (; i + V::kWidthF <= end; i += V::kWidthF) {
+        missionChunkF32<V, P>(FullChunk<V>(), bank, i, input_signal, control_signal, repeats);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (i < end) missionChunkF32<V, P>(TailChunk<V>(end - i), bank, i, input_signal, control_signal, repeats);
+    }
+}
+
+// Float counterpart of missionScheduleChunkF64
+template <class V, class P, class A>
+inline void missionScheduleChunkF32(const A& acc, NodeBankF32& bank, size_t i, const float* amplified,
+                                    const float* boost, size_t steps, int repeats, float last_input) {
+    using VF = typename V::VF;
+    VF state = acc.fload(bank.integrator_state + i);
+    const VF gain = acc.fload(bank.input_gain + i);
+    const VF tc = acc.fload(bank.time_constant + i);
+    for (size_t s = 0; s < steps; s++) {
+        const VF amp = V::fmul(V::fset1(amplified[s]), gain);
+        for (int r = 0; r < repeats; r++) {
+            state = P::Integrator::template stepF<V>(amp, state, tc);
+        }
+    }
+
+    VF out = V::ffma(state, acc.fload(bank.feedback_gain + i), state);
+    if constexpr (P::kBoost) out = V::ffma(V::fset1(boost[steps - 1]), acc.fload(bank.spectral_mix + i), out);
+    out = V::fmin(V::fmax(out, acc.fload(bank.clamp_low + i)), acc.fload(bank.clamp_high + i));
+    acc.fstore(bank.integrator_state + i, state);
+    acc.fstore(bank.current_output + i, out);
+    acc.fstore(bank.previous_input + i, V::fset1(last_input));
+}
+
+template <class V, class P>
+void missionScheduleF32(NodeBankF32& bank, size_t begin, size_t end, const float* amplified, const float* boost,
+                        size_t steps, int repeats, float last_input) {
+    if (steps == 0 || repeats <= 0) return;
+    size_t i = begin;
+    for (; i + V::kWidthF <= end; i += V::kWidthF) {
+        missionScheduleChunkF32<V, P>(FullChunk<V>(), bank, i, amplified, boost, steps, repeats, last_input);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (i < end) {
+            missionScheduleChunkF32<V, P>(TailChunk<V>(end - i), bank, i, amplified, boost, steps, repeats,
+                                       last_input);
+        }
+    }
+}
+
+// The float sums only span one block, folded into double per chunk
+template <class V, class P, bool kStats, class A>
+inline void blockChunkF32(const A& acc, NodeBankF32& bank, size_t i, size_t valid, const float* amplified,
+                          const float* boost, float last_input, float* out, size_t n, size_t out_first,
+                          BlockStatsPartial* stats) {
+    using VF = typename V::VF;
+    constexpr size_t W = V::kWidthF;
+    alignas(64) float lanes[W];
+    const bool histogram = kStats && stats->histogram;
+    VF sum = V::fset1(0.0f), squares = sum;
+    VF low = V::fset1(std::numeric_limits<float>::infinity());
+    VF high = V::fset1(-std::numeric_limits<float>::infinity());
+
+    VF state = acc.fload(bank.integrator_state + i);
+    const VF gain = V::fadd(V::fset1(1.0f), acc.fload(bank.feedback_gain + i));
+    const VF in_gain = acc.fload(bank.input_gain + i);
+    const VF tc = acc.fload(bank.time_constant + i);
+    const VF mix = acc.fload(bank.spectral_mix + i);
+    const VF clamp_lo = acc.fload(bank.clamp_low + i);
+    const VF clamp_hi = acc.fload(bank.clamp_high + i);
+    VF result = acc.fload(bank.current_output + i);
+
+    for (size_t t = 0; t < n; t++) {
+        state = P::Integrator::template stepF<V>(V::fmul(V::fset1(amplified[t]), in_gain), state, tc);
+        if constexpr (P::kBoost) {
+            result = V::ffma(state, gain, V::fmul(V::fset1(boost[t]), mix));
+        } else {
+            result = V::fmul(state, gain);
+        }
+        result = V::fmin(V::fmax(result, clamp_lo), clamp_hi);
+        if constexpr (kStats) {
+            sum = V::fadd(sum, result);
+            squares = V::ffma(result, result, squares);
+            low = V::fmin(low, result);
+            high = V::fmax(high, result);
+        }
+        if (out || histogram) {
+            V::fstore(lanes, result);
+            for (size_t lane = 0; lane < valid; lane++) {
+                if (out) out[(i + lane - out_first) * n + t] = lanes[lane];
+                if (histogram) stats->bin(lanes[lane]);
+            }
+        }
+    }
+    if constexpr (kStats) {
+        alignas(64) float sums[W], square_sums[W], lows[W], highs[W];
+        V::fstore(sums, sum);
+        V::fstore(square_sums, squares);
+        V::fstore(lows, low);
+        V::fstore(highs, high);
+        foldBlockLanes(*stats, sums, square_sums, lows, highs, valid, n);
+    }
+
+    acc.fstore(bank.integrator_state + i, state);
+    acc.fstore(bank.current_output + i, result);
+    acc.fstore(bank.previous_input + i, V::fset1(last_input));
+}
+
+template <class V, class P, bool kStats>
+void blockRangeF32(NodeBankF32& bank, size_t begin, size_t end, const float* amplified,
+                   const float* boost, float last_input, float* out, size_t n, size_t out_first,
+                   BlockStatsPartial* stats) {
+    constexpr size_t W = V::kWidthF;
+    const size_t size = bank.size();
+    size_t i = begin;
+    for (; i + W <= end; i += W) {
+        blockChunkF32<V, P, kStats>(FullChunk<V>(), bank, i, validLanes(i, size, W), amplified, boost, last_input,
+                                    out, n, out_first, stats);
+    }
+    if constexpr (V::kMaskedTail) {
+        if (i < end) {
+            blockChunkF32<V, P, kStats>(TailChunk<V>(end - i), bank, i, validLanes(i, size, end - i),
+                                        amplified, boost, last_input, out, n, out_first, stats);
+        }
+    }
+}
+
+template <class V, class P>
+void blockF32(NodeBankF32& bank, size_t begin, size_t end, const float* amplified,
+              const float* boost, float last_input, float* out, size_t n, size_t out_first,
+              BlockStatsPartial* stats) {
+    if (stats) {
+        blockRangeF32<V, P, true>(bank, begin, end, amplified, boost, last_input, out, n, out_first, stats);
+    } else {
+        blockRangeF32<V, P, false>(bank, begin, end, amplified, boost, last_input, out, n, out_first, nullptr);
+    }
+}
+
+// --- compact bank ------------------------------------------------------------
+//
+// A chunk of a CompactNodeBank is widened into float tiles, run through the
+// float node step in registers and its state narrowed back, so only the
+// conversions differ from the float kernels. Chunks never read or write past
+// end: a short last chunk (8 slots on a 16-lane level) widens zeros into the
+// lanes past it and narrows only the ones before.
+
+// Widen / narrow `lanes` (<= kWidthF) values of one column. Half floats use
+// the level's conversion instructions when its traits set kHalfConvert
+// (hload / hstore of a full vector).
+template <class V, NodeStateFormat F>
+struct CompactCodec {
+    static void widen(const CompactNodeBank& bank, const uint16_t* src, float* dst, size_t lanes) {
+        constexpr size_t W = V::kWidthF;
+        if constexpr (F == NodeStateFormat::Half && V::kHalfConvert) {
+            if (lanes == W) {
+                V::fstore(dst, V::hload(src));
+                return;
+            }
+        }
+        // A full chunk converts with a constant trip count, which the
+        // compiler turns into vector code
+        if (lanes == W) {
+            widenLanes<W>(bank, src, dst);
+            return;
+        }
+        // Bounded by W as well, so the compiler sees the tile is never overrun
+        for (size_t k = 0; k < lanes && k < W; k++) widenLanes<1>(bank, src + k, dst + k);
+        for (size_t k = lanes; k < W; k++) dst[k] = 0.0f;
+    }
+
+    static void narrow(const CompactNodeBank& bank, const float* src, uint16_t* dst, size_t lanes) {
+        constexpr size_t W = V::kWidthF;
+        if constexpr (F == NodeStateFormat::Half && V::kHalfConvert) {
+            if (lanes == W) {
+                V::hstore(dst, V::fload(src));
+                return;
+            }
+        }
+        if (lanes == W) {
+            narrowLanes<W>(bank, src, dst);
+            return;
+        }
+        for (size_t k = 0; k < lanes && k < W; k++) narrowLanes<1>(bank, src + k, dst + k);
+    }
+
+private:
+    template <size_t N>
+    static void widenLanes(const CompactNodeBank& bank, const uint16_t* src, float* dst) {
+        for (size_t k = 0; k < N; k++) {
+            if constexpr (F == NodeStateFormat::Half) {
+                dst[k] = half_float::toFloat(src[k]);
+            } else if constexpr (F == NodeStateFormat::BFloat16) {
+                dst[k] = half_float::bfloatToFloat(src[k]);
+            } else {
+                dst[k] = half_float::fixedToFloat(src[k], bank.fixedStep());
+            }
+        }
+    }
+
+    template <size_t N>
+    static void narrowLanes(const CompactNodeBank& bank, const float* src, uint16_t* dst) {
+        for (size_t k = 0; k < N; k++) {
+            if constexpr (F == NodeStateFormat::Half) {
+                dst[k] = half_float::fromFloat(src[k]);
+            } else if constexpr (F == NodeStateFormat::BFloat16) {
+                dst[k] = half_float::bfloatFromFloat(src[k]);
+            } else {
+                dst[k] = half_float::fixedFromFloat(src[k], bank.fixedScale());
+            }
+        }
+    }
+};
+
+// The columns of one chunk as float vectors
+template <class V, NodeStateFormat F>
+struct CompactChunk {
+    using VF = typename V::VF;
+    using Codec = CompactCodec<V, F>;
+    static constexpr size_t W = V::kWidthF;
+
+    CompactChunk(const CompactNodeBank& bank, size_t i, size_t lanes) : lanes_(lanes) {
+        alignas(64) float tile[W];
+        auto widen = [&](const uint16_t* column) {
+            Codec::widen(bank, column + i, tile, lanes);
+            return V::fload(tile);
+        };
+        state = widen(bank.integrator_state);
+        output = widen(bank.current_output);
+        feedback = widen(bank.feedback_gain);
+        in_gain = widen(bank.input_gain);
+        tc = widen(bank.time_constant);
+        clamp_lo = widen(bank.clamp_low);
+        clamp_hi = widen(bank.clamp_high);
+        mix = widen(bank.spectral_mix);
+    }
+
+    // Narrows state and output back into the bank
+    void store(CompactNodeBank& bank, size_t i) const {
+        alignas(64) float tile[W];
+        V::fstore(tile, state);
+        Codec::narrow(bank, tile, bank.integrator_state + i, lanes_);
+        V::fstore(tile, output);
+        Codec::narrow(bank, tile, bank.current_output + i, lanes_);
+    }
+
+    VF state, output, feedback, in_gain, tc, clamp_lo, clamp_hi, mix;
+
+private:
+    size_t lanes_;
+};
+
+template <class V, class P, NodeStateFormat F>
+double waveCompactRange(CompactNodeBank& bank, size_t begin, size_t end, double input_signal,
+                        double control_pattern, const double* control_wave, const double* pass_aux, int passes) {
+    using VF = typename V::VF;
+    constexpr size_t W = V::kWidthF;
+    const size_t size = bank.size();
+    const VF input = V::fset1(static_cast<float>(input_signal));
+    const typename V::VD pattern = V::dset1(control_pattern);
+    alignas(64) float outputs[W];
+    double partial = 0.0;
+
+    for (size_t i = begin; i < end; i += W) {
+        const size_t lanes = end - i < W ? end - i : W;
+        const size_t valid = validLanes(i, size, lanes);
+        // The passes stay in registers; the state is rounded to the
+        // format once per sweep rather than once per pass
+        CompactChunk<V, F> chunk(bank, i, lanes);
+        for (int pass = 0; pass < passes; pass++) {
+            const VF amp = V::fmul(input, waveControlF32<V>(pattern, control_wave + i + pass));
+            chunk.state = P::Integrator::template stepF<V>(V::fmul(amp, chunk.in_gain), chunk.state, chunk.tc);
+            VF out = V::ffma(chunk.state, chunk.feedback, chunk.state);
+            if constexpr (P::kBoost) {
+                const VF aux = V::fset1(static_cast<float>(pass_aux[pass]));
+                out = V::ffma(spectralLanes<V, P::kSineDegree>(V::fadd(amp, aux)), chunk.mix, out);
+            }
+            chunk.output = V::fmin(V::fmax(out, chunk.clamp_lo), chunk.clamp_hi);
+            V::fstore(outputs, chunk.output);
+            for (size_t lane = 0; lane < valid; lane++) partial += static_cast<double>(outputs[lane]);
+        }
+        chunk.store(bank, i);
+    }
+    return partial;
+}
+
+template <class V, class P>
+double waveCompact(CompactNodeBank& bank, size_t begin, size_t end, double input_signal,
+                   double control_pattern, const double* control_wave, const double* pass_aux, int passes) {
+    switch (bank.format()) {
+        case NodeStateFormat::Half:
+            return waveCompactRange<V, P, NodeStateFormat::Half>(bank, begin, end, input_signal, control_pattern,
+                                                                 control_wave, pass_aux, passes);
+        case NodeStateFormat::BFloat16:
+            return waveCompactRange<V, P, NodeStateFormat::BFloat16>(bank, begin, end, input_signal,
+                                                                     control_pattern, control_wave, pass_aux, passes);
+        case NodeStateFormat::Fixed16:
+            return waveCompactRange<V, P, NodeStateFormat::Fixed16>(bank, begin, end, input_signal,
+                                                                    control_pattern, control_wave, pass_aux, passes);
+    }
+    return 0.0;
+}
+
+template <class V, class P, NodeStateFormat F>
+void missionScheduleCompactRange(CompactNodeBank& bank, size_t begin, size_t end, const float* amplified,
+                                 const float* boost, size_t steps, int repeats) {
+    using VF = typename V::VF;
+    constexpr size_t W = V::kWidthF;
+    for (size_t i = begin; i < end; i += W) {
+        CompactChunk<V, F> chunk(bank, i, end - i < W ? end - i : W);
+        for (size_t s = 0; s < steps; s++) {
+            const VF amp = V::fmul(V::fset1(amplified[s]), chunk.in_gain);
+            for (int r = 0; r < repeats; r++) {
+                chunk.state = P::Integrator::template stepF<V>(amp, chunk.state, chunk.tc);
+            }
+        }
+        VF out = V::ffma(chunk.state, chunk.feedback, chunk.state);
+        if constexpr (P::kBoost) out = V::ffma(V::fset1(boost[steps - 1]), chunk.mix, out);
+        chunk.output = V::fmin(V::fmax(out, chunk.clamp_lo), chunk.clamp_hi);
+        chunk.store(bank, i);
+    }
+}
+
+template <class V, class P>
+void missionScheduleCompact(CompactNodeBank& bank, size_t begin, size_t end, const float* amplified,
+                            const float* boost, size_t steps, int repeats) {
+    if (steps == 0 || repeats <= 0) return;
+    switch (bank.format()) {
+        case NodeStateFormat::Half:
+            missionScheduleCompactRange<V, P, NodeStateFormat::Half>(bank, begin, end, amplified, boost, steps,
+                                                                     repeats);
+            break;
+        case NodeStateFormat::BFloat16:
+            missionScheduleCompactRange<V, P, NodeStateFormat::BFloat16>(bank, begin, end, amplified, boost, steps,
+                                                                         repeats);
+            break;
+        case NodeStateFormat::Fixed16:
+            missionScheduleCompactRange<V, P, NodeStateFormat::Fixed16>(bank, begin, end, amplified, boost, steps,
+                                                                        repeats);
+            break;
+    }
+}
+
+template <class V, class P, NodeStateFormat F, bool kStats>
+void blockCompactRange(CompactNodeBank& bank, size_t begin, size_t end, const float* amplified,
+                       const float* boost, float* out, size_t n, size_t out_first, BlockStatsPartial* stats) {
+    using VF = typename V::VF;
+    constexpr size_t W = V::kWidthF;
+    const size_t size = bank.size();
+    alignas(64) float lanes_out[W];
+    const bool histogram = kStats && stats->histogram;
+
+    for (size_t i = begin; i < end; i += W) {
+        const size_t lanes = end - i < W ? end - i : W;
+        const size_t valid = validLanes(i, size, lanes);
+        CompactChunk<V, F> chunk(bank, i, lanes);
+        const VF gain = V::fadd(V::fset1(1.0f), chunk.feedback);
+        VF state = chunk.state;
+        VF result = chunk.output;
+        VF sum = V::fset1(0.0f), squares = sum;
+        VF low = V::fset1(std::numeric_limits<float>::infinity());
+        VF high = V::fset1(-std::numeric_limits<float>::infinity());
+        for (size_t t = 0; t < n; t++) {
+            state = P::Integrator::template stepF<V>(V::fmul(V::fset1(amplified[t]), chunk.in_gain), state, chunk.tc);
+            if constexpr (P::kBoost) {
+                result = V::ffma(state, gain, V::fmul(V::fset1(boost[t]), chunk.mix));
+            } else {
+                result = V::fmul(state, gain);
+            }
+            result = V::fmin(V::fmax(result, chunk.clamp_lo), chunk.clamp_hi);
+            if constexpr (kStats) {
+                sum = V::fadd(sum, result);
+                squares = V::ffma(result, result, squares);
+                low = V::fmin(low, result);
+                high = V::fmax(high, result);
+            }
+            if (out || histogram) {
+                V::fstore(lanes_out, result);
+                for (size_t lane = 0; lane < valid; lane++) {
+                    if (out) out[(i + lane - out_first) * n + t] = lanes_out[lane];
+                    if (histogram) stats->bin(lanes_out[lane]);
+                }
+            }
+        }
+        if constexpr (kStats) {
+            alignas(64) float sums[W], square_sums[W], lows[W], highs[W];
+            V::fstore(sums, sum);
+            V::fstore(square_sums, squares);
+            V::fstore(lows, low);
+            V::fstore(highs, high);
+            foldBlockLanes(*stats, sums, square_sums, lows, highs, valid, n);
+        }
+        chunk.state = state;
+        chunk.output = result;
+        chunk.store(bank, i);
+    }
+}
+
+template <class V, class P, NodeStateFormat F>
+void blockCompactFormat(CompactNodeBank& bank, size_t begin, size_t end, const float* amplified,
+                        const float* boost, float* out, size_t n, size_t out_first, BlockStatsPartial* stats) {
+    if (stats) {
+        blockCompactRange<V, P, F, true>(bank, begin, end, amplified, boost, out, n, out_first, stats);
+    } else {
+        blockCompactRange<V, P, F, false>(bank, begin, end, amplified, boost, out, n, out_first, nullptr);
+    }
+}
+
+template <class V, class P>
+void blockCompact(CompactNodeBank& bank, size_t begin, size_t end, const float* amplified,
+                  const float* boost, float* out, size_t n, size_t out_first, BlockStatsPartial* stats) {
+    switch (bank.format()) {
+        case NodeStateFormat::Half:
+            blockCompactFormat<V, P, NodeStateFormat::Half>(bank, begin, end, amplified, boost, out, n, out_first,
+                                                            stats);
+            break;
+        case NodeStateFormat::BFloat16:
+            blockCompactFormat<V, P, NodeStateFormat::BFloat16>(bank, begin, end, amplified, boost, out, n, out_first,
+                                                                stats);
+            break;
+        case NodeStateFormat::Fixed16:
+            blockCompactFormat<V, P, NodeStateFormat::Fixed16>(bank, begin, end, amplified, boost, out, n, out_first,
+                                                               stats);
+            break;
+    }
+}
+
+// The boost entries follow the table's SineDegree; presets without the
+// boost share one instantiation of the per-node kernels across degrees
+template <class V, class P, SineDegree D>
+NodeKernels makeTable(SimdLevel level, const char* name, NodePipeline pipeline) {
+    NodeKernels table;
+    table.level = level;
+    table.name = name;
+    table.pipeline = pipeline;
+    table.sine_degree = D;
+    table.harmonics = &harmonics<V>;
+    table.spectral = &spectral<V, D>;
+    table.spectral_lanes = &spectralLanesArray<V, D>;
+    table.sincos_lanes = &sincosLanesArray<V>;
+    table.gaussian_noise = &gaussianNoise<V>;
+    table.pair_products = &pairProducts<V>;
+    table.cross_products = &crossProducts<V>;
+    table.mix_rows = &mixRows<V>;
+    table.spectrum_mac = &spectrumMac<V>;
+    table.biquad_block = &biquadBlock<V>;
+    table.color_map = &colorMap<V>;
+    table.wave_f64 = &waveF64<V, P>;
+    table.mission_f64 = &missionF64<V, P>;
+    table.mission_schedule_f64 = &missionScheduleF64<V, P>;
+    table.block_f64 = &blockF64<V, P>;
+    table.wave_f32 = &waveF32<V, P>;
+    table.mission_f32 = &missionF32<V, P>;
+    table.mission_schedule_f32 = &missionScheduleF32<V, P>;
+    table.block_f32 = &blockF32<V, P>;
+    table.wave_compact = &waveCompact<V, P>;
+    table.mission_schedule_compact = &missionScheduleCompact<V, P>;
+    table.block_compact = &blockCompact<V, P>;
+    return table;
+}
+
+template <class V, SineDegree D, size_t N>
+void makeDegreeTables(SimdLevel level, const char* name, std::array<NodeKernels, N>& tables) {
+    using FullPipeline = Pipeline<LeakyIntegrator, SpectralBoost, D>;
+    using DirectPipeline = Pipeline<NoIntegrator, SpectralBoost, D>;
+    auto at = [&](NodePipeline pipeline) -> NodeKernels& { return tables[nodeKernelsIndex(pipeline, D)]; };
+    at(NodePipeline::Full) = makeTable<V, FullPipeline, D>(level, name, NodePipeline::Full);
+    at(NodePipeline::NoBoost) = makeTable<V, Pipeline<LeakyIntegrator, NoBoost>, D>(level, name, NodePipeline::NoBoost);
+    at(NodePipeline::Direct) = makeTable<V, DirectPipeline, D>(level, name, NodePipeline::Direct);
+    at(NodePipeline::Linear) = makeTable<V, Pipeline<NoIntegrator, NoBoost>, D>(level, name, NodePipeline::Linear);
+}
+
+// One table per NodePipeline and SineDegree, at nodeKernelsIndex()
+template <class V>
+std::array<NodeKernels, kNodeKernelTables> makeTables(SimdLevel level, const char* name) {
+    std::array<NodeKernels, kNodeKernelTables> tables;
+    makeDegreeTables<V, SineDegree::Seven>(level, name, tables);
+    makeDegreeTables<V, SineDegree::Five>(level, name, tables);
+    makeDegreeTables<V, SineDegree::Three>(level, name, tables);
+    return tables;
+}
+
+} // namespace node_kernels
@@ -0,0 +1,63 @@
+#include <cmath>
+#include "node_kernels.h"
+
+#ifdef DASE_ARM_KERNELS
+#include <arm_neon.h>
+
+// Advanced SIMD is part of the AArch64 baseline, so unlike the x86 levels
+// this file needs no target attributes.
+#include "node_kernels_impl.h"
+
+namespace {
+
+struct NeonTraits {
+    static constexpr size_t kWidthF = 4;
+    static constexpr size_t kWidthD = 2;
+    static constexpr bool kMaskedTail = false;
+    static constexpr bool kHalfConvert = true;
+    static constexpr bool kFusedFma = true;
+    using VF = float32x4_t;
+    using VD = float64x2_t;
+
+    static VF fset1(float v) { return vdupq_n_f32(v); }
+    static VF fload(const float* p) { return vld1q_f32(p); }
+    static void fstore(float* p, VF v) { vst1q_f32(p, v); }
+    static VF fadd(VF a, VF b) { return vaddq_f32(a, b); }
+    static VF fsub(VF a, VF b) { return vsubq_f32(a, b); }
+    static VF fmul(VF a, VF b) { return vmulq_f32(a, b); }
+    static VF fdiv(VF a, VF b) { return vdivq_f32(a, b); }
+    static VF ffma(VF a, VF b, VF c) { return vfmaq_f32(c, a, b); }
+    static VF fmin(VF a, VF b) { return vminq_f32(a, b); }
+    static VF fmax(VF a, VF b) { return vmaxq_f32(a, b); }
+    static VF ffloor(VF a) { return vrndmq_f32(a); }
+    static VF fsqrt(VF a) { return vsqrtq_f32(a); }
+    static VF fselect(VF m, VF a, VF b) { return vbslq_f32(vceqzq_f32(m), a, b); }
+
+    static VD dset1(double v) { return vdupq_n_f64(v); }
+    static VD dload(const double* p) { return vld1q_f64(p); }
+    static void dstore(double* p, VD v) { vst1q_f64(p, v); }
+    static VD dadd(VD a, VD b) { return vaddq_f64(a, b); }
+    static VD dsub(VD a, VD b) { return vsubq_f64(a, b); }
+    static VD dmul(VD a, VD b) { return vmulq_f64(a, b); }
+    static VD dfma(VD a, VD b, VD c) { return vfmaq_f64(c, a, b); }
+    static VD dmin(VD a, VD b) { return vminq_f64(a, b); }
+    static VD dmax(VD a, VD b) { return vmaxq_f64(a, b); }
+
+    static VF hload(const uint16_t* p) { return vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(p))); }
+    static void hstore(uint16_t* p, VF v) { vst1_u16(p, vreinterpret_u16_f16(vcvt_f16_f32(v))); }
+
+    static VF pack(VD lo, VD hi) { return vcombine_f32(vcvt_f32_f64(lo), vcvt_f32_f64(hi)); }
+    static void unpack(VF v, VD& lo, VD& hi) {
+        lo = vcvt_f64_f32(vget_low_f32(v));
+        hi = vcvt_high_f64_f32(v);
+    }
+};
+
+} // namespace
+
+const NodeKernels& neonNodeKernels(NodePipeline pipeline, SineDegree degree) {
+    static const auto tables = node_kernels::makeTables<NeonTraits>(SimdLevel::NEON, "neon");
+    return tables[nodeKernelsIndex(pipeline, degree)];
+}
+
+#endif // DASE_ARM_KERNELS
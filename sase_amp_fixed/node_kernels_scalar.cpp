@@ -0,0 +1,63 @@
+#include <cmath>
+#include "node_kernels.h"
+#include "node_kernels_impl.h"
+
+// Portable fallback: plain C++ "vectors" of two floats / one double, so the
+// generic kernels keep their lane structure without any intrinsics.
+namespace {
+
+struct ScalarTraits {
+    static constexpr size_t kWidthF = 2;
+    static constexpr size_t kWidthD = 1;
+    static constexpr bool kMaskedTail = false;
+    static constexpr bool kHalfConvert = false;
+    static constexpr bool kFusedFma = false;
+
+    struct VF {
+        float lane[2];
+    };
+    using VD = double;
+
+    static VF fset1(float v) { return VF{{v, v}}; }
+    static VF fload(const float* p) { return VF{{p[0], p[1]}}; }
+    static void fstore(float* p, VF v) { p[0] = v.lane[0]; p[1] = v.lane[1]; }
+    static VF fadd(VF a, VF b) { return VF{{a.lane[0] + b.lane[0], a.lane[1] + b.lane[1]}}; }
+    static VF fsub(VF a, VF b) { return VF{{a.lane[0] - b.lane[0], a.lane[1] - b.lane[1]}}; }
+    static VF fmul(VF a, VF b) { return VF{{a.lane[0] * b.lane[0], a.lane[1] * b.lane[1]}}; }
+    static VF fdiv(VF a, VF b) { return VF{{a.lane[0] / b.lane[0], a.lane[1] / b.lane[1]}}; }
+    static VF ffma(VF a, VF b, VF c) { return fadd(fmul(a, b), c); }
+    static VF fmin(VF a, VF b) {
+        return VF{{a.lane[0] < b.lane[0] ? a.lane[0] : b.lane[0], a.lane[1] < b.lane[1] ? a.lane[1] : b.lane[1]}};
+    }
+    static VF fmax(VF a, VF b) {
+        return VF{{a.lane[0] > b.lane[0] ? a.lane[0] : b.lane[0], a.lane[1] > b.lane[1] ? a.lane[1] : b.lane[1]}};
+    }
+    static VF ffloor(VF a) { return VF{{std::floor(a.lane[0]), std::floor(a.lane[1])}}; }
+    static VF fsqrt(VF a) { return VF{{std::sqrt(a.lane[0]), std::sqrt(a.lane[1])}}; }
+    static VF fselect(VF m, VF a, VF b) {
+        return VF{{m.lane[0] != 0.0f ? b.lane[0] : a.lane[0], m.lane[1] != 0.0f ? b.lane[1] : a.lane[1]}};
+    }
+
+    static VD dset1(double v) { return v; }
+    static VD dload(const double* p) { return *p; }
+    static void dstore(double* p, VD v) { *p = v; }
+    static VD dadd(VD a, VD b) { return a + b; }
+    static VD dsub(VD a, VD b) { return a - b; }
+    static VD dmul(VD a, VD b) { return a * b; }
+    static VD dfma(VD a, VD b, VD c) { return a * b + c; }
+    static VD dmin(VD a, VD b) { return a < b ? a : b; }
+    static VD dmax(VD a, VD b) { return a > b ? a : b; }
+
+    static VF pack(VD lo, VD hi) { return VF{{static_cast<float>(lo), static_cast<float>(hi)}}; }
+    static void unpack(VF v, VD& lo, VD& hi) {
+        lo = static_cast<double>(v.lane[0]);
+        hi = static_cast<double>(v.lane[1]);
+    }
+};
+
+} // namespace
+
+const NodeKernels& scalarNodeKernels(NodePipeline pipeline, SineDegree degree) {
+    static const auto tables = node_kernels::makeTables<ScalarTraits>(SimdLevel::Scalar, "scalar");
+    return tables[nodeKernelsIndex(pipeline, degree)];
+}
@@ -0,0 +1,73 @@
+#include <cmath>
+#include "node_kernels.h"
+
+#ifdef DASE_X86_KERNELS
+#include <immintrin.h>
+
+// Everything below is compiled for SSE4.2 regardless of the global -m flags
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("sse4.2")
+#endif
+
+#include "node_kernels_impl.h"
+
+namespace {
+
+// 128-bit traits; there is no FMA at this level, so fma is mul + add
+struct Sse42Traits {
+    static constexpr size_t kWidthF = 4;
+    static constexpr size_t kWidthD = 2;
+    static constexpr bool kMaskedTail = false;
+    static constexpr bool kHalfConvert = false;  // F16C is not part of the level
+    static constexpr bool kFusedFma = false;
+    using VF = __m128;
+    using VD = __m128d;
+
+    static VF fset1(float v) { return _mm_set1_ps(v); }
+    static VF fload(const float* p) { return _mm_loadu_ps(p); }
+    static void fstore(float* p, VF v) { _mm_storeu_ps(p, v); }
+    static VF fadd(VF a, VF b) { return _mm_add_ps(a, b); }
+    static VF fsub(VF a, VF b) { return _mm_sub_ps(a, b); }
+    static VF fmul(VF a, VF b) { return _mm_mul_ps(a, b); }
+    static VF fdiv(VF a, VF b) { return _mm_div_ps(a, b); }
+    static VF ffma(VF a, VF b, VF c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static VF fmin(VF a, VF b) { return _mm_min_ps(a, b); }
+    static VF fmax(VF a, VF b) { return _mm_max_ps(a, b); }
+    static VF ffloor(VF a) { return _mm_floor_ps(a); }
+    static VF fsqrt(VF a) { return _mm_sqrt_ps(a); }
+    static VF fselect(VF m, VF a, VF b) { return _mm_blendv_ps(a, b, _mm_cmpneq_ps(m, _mm_setzero_ps())); }
+
+    static VD dset1(double v) { return _mm_set1_pd(v); }
+    static VD dload(const double* p) { return _mm_loadu_pd(p); }
+    static void dstore(double* p, VD v) { _mm_storeu_pd(p, v); }
+    static VD dadd(VD a, VD b) { return _mm_add_pd(a, b); }
+    static VD dsub(VD a, VD b) { return _mm_sub_pd(a, b); }
+    static VD dmul(VD a, VD b) { return _mm_mul_pd(a, b); }
+    static VD dfma(VD a, VD b, VD c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static VD dmin(VD a, VD b) { return _mm_min_pd(a, b); }
+    static VD dmax(VD a, VD b) { return _mm_max_pd(a, b); }
+
+    static VF pack(VD lo, VD hi) { return _mm_movelh_ps(_mm_cvtpd_ps(lo), _mm_cvtpd_ps(hi)); }
+    static void unpack(VF v, VD& lo, VD& hi) {
+        lo = _mm_cvtps_pd(v);
+        hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+    }
+};
+
+} // namespace
+
+const NodeKernels& sse42NodeKernels(NodePipeline pipeline, SineDegree degree) {
+    static const auto tables = node_kernels::makeTables<Sse42Traits>(SimdLevel::SSE42, "sse4.2");
+    return tables[nodeKernelsIndex(pipeline, degree)];
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#endif // DASE_X86_KERNELS
@@ -0,0 +1,527 @@
+#include "node_recorder.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include "timeline_trace.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'A', 'S', 'E', 'R', 'E', 'C', '1'};
+constexpr char kChunkMagic[4] = {'C', 'H', 'N', 'K'};
+constexpr uint32_t kByteOrderTag = 0x01020304u;
+constexpr uint32_t kCodecRaw = 0;
+constexpr uint32_t kCodecDelta = 1;
+constexpr uint64_t kChunkAlign = 64;
+// Column bytes of one chunk; bounds the four slots of a recorder of many nodes
+constexpr size_t kMaxChunkBytes = size_t(16) << 20;
+// Zero runs shorter than this stay in the literals
+constexpr size_t kMinRun = 3;
+constexpr size_t kMaxToken = 128;
+
+struct FileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;    // kByteOrderTag as the writing host stores it
+    uint64_t node_count;
+    uint64_t nodes_offset;  // Offset of the node list
+    uint64_t chunks_offset; // Offset of the first chunk
+    uint32_t chunk_frames;
+    uint32_t decimation;
+};
+static_assert(sizeof(FileHeader) <= kRecordingHeaderBytes, "recording header must fit its page");
+
+const timeline_trace::EventKind kWriteKind{"recorder_write", "bytes", "frames"};
+
+uint64_t roundUp(uint64_t bytes, uint64_t align) {
+    return (bytes + align - 1) / align * align;
+}
+
+[[noreturn]] void fail(const std::string& path, const std::string& what) {
+    throw std::runtime_error("recording " + path + ": " + what);
+}
+
+// Appends column (frames values) to out: XOR with the previous frame, four
+// byte planes high byte first, then tokens. A token t < 0x80 is followed by
+// t + 1 literal bytes; t >= 0x80 stands for (t & 0x7f) + 1 zero bytes.
+void encodeColumn(const float* column, size_t frames, std::vector<unsigned char>& planes,
+                  std::vector<unsigned char>& out) {
+    planes.resize(4 * frames);
+    uint32_t prev = 0;
+    for (size_t i = 0; i < frames; i++) {
+        uint32_t bits;
+        std::memcpy(&bits, &column[i], sizeof(bits));
+        const uint32_t d = bits ^ prev;
+        prev = bits;
+        planes[i] = static_cast<unsigned char>(d >> 24);
+        planes[frames + i] = static_cast<unsigned char>(d >> 16);
+        planes[2 * frames + i] = static_cast<unsigned char>(d >> 8);
+        planes[3 * frames + i] = static_cast<unsigned char>(d);
+    }
+
+    const size_t n = planes.size();
+    size_t i = 0;
+    size_t literal = 0;  // Start of the pending literals
+    auto emitLiterals = [&](size_t end) {
+        while (literal < end) {
+            const size_t count = std::min(end - literal, kMaxToken);
+            out.push_back(static_cast<unsigned char>(count - 1));
+            out.insert(out.end(), planes.begin() + literal, planes.begin() + literal + count);
+            literal += count;
+        }
+    };
+    while (i < n) {
+        if (planes[i] != 0) {
+            i++;
+            continue;
+        }
+        size_t run = i;
+        while (run < n && planes[run] == 0) run++;
+        if (run - i < kMinRun) {
+            i = run;
+            continue;
+        }
+        emitLiterals(i);
+        for (size_t left = run - i; left > 0;) {
+            const size_t count = std::min(left, kMaxToken);
+            out.push_back(static_cast<unsigned char>(0x80 | (count - 1)));
+            left -= count;
+        }
+        i = literal = run;
+    }
+    emitLiterals(n);
+}
+
+// Inverse of encodeColumn; false if [in, end) is not frames values
+bool decodeColumn(const unsigned char* in, const unsigned char* end, size_t frames,
+                  std::vector<unsigned char>& planes, float* column) {
+    const size_t n = 4 * frames;
+    planes.resize(n);
+    size_t o = 0;
+    while (in < end) {
+        const unsigned token = *in++;
+        const size_t count = (token & 0x7f) + 1;
+        if (o + count > n) return false;
+        if (token & 0x80) {
+            std::memset(&planes[o], 0, count);
+        } else {
+            if (static_cast<size_t>(end - in) < count) return false;
+            std::memcpy(&planes[o], in, count);
+            in += count;
+        }
+        o += count;
+    }
+    if (o != n) return false;
+
+    uint32_t prev = 0;
+    for (size_t i = 0; i < frames; i++) {
+        const uint32_t d = (uint32_t(planes[i]) << 24) | (uint32_t(planes[frames + i]) << 16) |
+                           (uint32_t(planes[2 * frames + i]) << 8) | uint32_t(planes[3 * frames + i]);
+        prev ^= d;
+        std::memcpy(&column[i], &prev, sizeof(prev));
+    }
+    return true;
+}
+
+double msSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+struct NodeRecorder::FileHandle {
+    std::FILE* file = nullptr;
+    ~FileHandle() {
+        if (file) std::fclose(file);
+    }
+    bool write(const void* data, size_t bytes) { return bytes == 0 || std::fwrite(data, 1, bytes, file) == bytes; }
+};
+
+NodeRecorder::NodeRecorder(const RecorderConfig& config, size_t num_nodes) : config_(config) {
+    if (config_.path.empty()) throw std::invalid_argument("recording path is empty");
+    if (config_.decimation == 0) throw std::invalid_argument("recording decimation must be at least 1");
+    if (config_.chunk_frames == 0) throw std::invalid_argument("recording chunk_frames must be at least 1");
+    if (config_.nodes.empty()) {
+        nodes_.resize(num_nodes);
+        for (size_t i = 0; i < num_nodes; i++) nodes_[i] = static_cast<uint32_t>(i);
+    } else {
+        for (uint32_t node : config_.nodes) {
+            if (node >= num_nodes) {
+                throw std::invalid_argument("recorded node " + std::to_string(node) + " out of range for " +
+                                            std::to_string(num_nodes) + " nodes");
+            }
+        }
+        nodes_ = config_.nodes;
+    }
+    const size_t frame_bytes = std::max<size_t>(nodes_.size(), 1) * sizeof(float);
+    config_.chunk_frames = static_cast<uint32_t>(
+        std::max<size_t>(1, std::min<size_t>(config_.chunk_frames, kMaxChunkBytes / frame_bytes)));
+    for (Slot& slot : slots_) slot.columns.resize(nodes_.size() * config_.chunk_frames);
+
+    file_.reset(new FileHandle);
+    file_->file = std::fopen(config_.path.c_str(), "wb");
+    if (!file_->file) fail(config_.path, "cannot create");
+    // Chunks are written whole; a large buffer keeps them to a few writes
+    std::setvbuf(file_->file, nullptr, _IOFBF, size_t(1) << 20);
+
+    FileHeader h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kRecordingVersion;
+    h.byte_order = kByteOrderTag;
+    h.node_count = nodes_.size();
+    h.nodes_offset = kRecordingHeaderBytes;
+    h.chunks_offset = kRecordingHeaderBytes + roundUp(nodes_.size() * sizeof(uint32_t), kRecordingHeaderBytes);
+    h.chunk_frames = config_.chunk_frames;
+    h.decimation = config_.decimation;
+    std::vector<unsigned char> head(h.chunks_offset, 0);
+    std::memcpy(head.data(), &h, sizeof(h));
+    if (!nodes_.empty()) std::memcpy(head.data() + h.nodes_offset, nodes_.data(), nodes_.size() * sizeof(uint32_t));
+    if (!file_->write(head.data(), head.size())) fail(config_.path, "write failed");
+
+    thread_ = std::thread([this] { run(); });
+}
+
+NodeRecorder::~NodeRecorder() {
+    try {
+        close();
+    } catch (...) {
+    }
+}
+
+NodeRecorder::Slot& NodeRecorder::fillSlot() {
+    Slot& slot = slots_[queued_ % kSlots];
+    if (fill_ready_) return slot;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (queued_ - written_ >= kSlots) {
+            stats_.writer_waits++;
+            done_cv_.wait(lock, [&] { return queued_ - written_ < kSlots; });
+        }
+    }
+    slot.first_frame = frames_recorded_;
+    slot.frames = 0;
+    fill_ready_ = true;
+    return slot;
+}
+
+void NodeRecorder::queueFill() {
+    if (!fill_ready_ || slots_[queued_ % kSlots].frames == 0) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queued_++;
+    }
+    fill_ready_ = false;
+    work_cv_.notify_one();
+}
+
+void NodeRecorder::appendFrame(const double* outputs) {
+    if (closed_) return;
+    if (frames_seen_++ % config_.decimation != 0) return;
+    Slot& slot = fillSlot();
+    const size_t stride = config_.chunk_frames;
+    float* column = slot.columns.data() + slot.frames;
+    for (size_t k = 0; k < nodes_.size(); k++) column[k * stride] = static_cast<float>(outputs[nodes_[k]]);
+    frames_recorded_++;
+    if (++slot.frames == stride) queueFill();
+}
+
+void NodeRecorder::appendBlock(const float* outputs, size_t n) {
+    if (closed_ || n == 0) return;
+    const uint64_t d = config_.decimation;
+    size_t t = static_cast<size_t>((d - frames_seen_ % d) % d);  // First kept frame of the block
+    frames_seen_ += n;
+    const size_t stride = config_.chunk_frames;
+    while (t < n) {
+        Slot& slot = fillSlot();
+        const size_t take = std::min<size_t>(stride - slot.frames, (n - t + d - 1) / d);
+        for (size_t k = 0; k < nodes_.size(); k++) {
+            const float* from = outputs + size_t(nodes_[k]) * n + t;
+            float* to = slot.columns.data() + k * stride + slot.frames;
+            if (d == 1) {
+                std::memcpy(to, from, take * sizeof(float));
+            } else {
+                for (size_t i = 0; i < take; i++) to[i] = from[i * d];
+            }
+        }
+        t += take * d;
+        frames_recorded_ += take;
+        slot.frames += take;
+        if (slot.frames == stride) queueFill();
+    }
+}
+
+void NodeRecorder::flush() {
+    if (closed_) return;
+    queueFill();
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [&] { return written_ == queued_; });
+    if (error_) std::rethrow_exception(error_);
+}
+
+void NodeRecorder::close() {
+    if (closed_) return;
+    queueFill();
+    closed_ = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_one();
+    if (thread_.joinable()) thread_.join();
+    const bool ok = std::fclose(file_->file) == 0;
+    file_->file = nullptr;
+    if (error_) std::rethrow_exception(error_);
+    if (!ok) fail(config_.path, "write failed");
+}
+
+RecorderStats NodeRecorder::stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    RecorderStats stats = stats_;
+    stats.frames_seen = frames_seen_;
+    stats.frames_recorded = frames_recorded_;
+    return stats;
+}
+
+void NodeRecorder::writeChunk(const Slot& slot, std::vector<unsigned char>& payload) {
+    const size_t nodes = nodes_.size();
+    const size_t frames = slot.frames;
+    const size_t stride = config_.chunk_frames;
+    RecordingChunk h{};
+    std::memcpy(h.magic, kChunkMagic, sizeof(kChunkMagic));
+    h.codec = config_.compress ? kCodecDelta : kCodecRaw;
+    h.first_frame = slot.first_frame;
+    h.frames = frames;
+
+    payload.clear();
+    if (config_.compress) {
+        std::vector<uint64_t> offsets(nodes + 1);
+        const size_t table = offsets.size() * sizeof(uint64_t);
+        payload.resize(table);
+        std::vector<unsigned char> planes;
+        for (size_t k = 0; k < nodes; k++) {
+            offsets[k] = payload.size();
+            encodeColumn(slot.columns.data() + k * stride, frames, planes, payload);
+        }
+        offsets[nodes] = payload.size();
+        std::memcpy(payload.data(), offsets.data(), table);
+    } else {
+        payload.resize(nodes * frames * sizeof(float));
+        for (size_t k = 0; k < nodes; k++) {
+            std::memcpy(payload.data() + k * frames * sizeof(float), slot.columns.data() + k * stride,
+                        frames * sizeof(float));
+        }
+    }
+    h.stored_bytes = payload.size();
+    payload.resize(roundUp(payload.size(), kChunkAlign), 0);
+
+    if (!file_->write(&h, sizeof(h)) || !file_->write(payload.data(), payload.size()) ||
+        std::fflush(file_->file) != 0) {
+        fail(config_.path, "write failed");
+    }
+}
+
+void NodeRecorder::run() {
+    timeline_trace::setThreadName("dase recorder");
+    std::vector<unsigned char> payload;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        // Queued chunks are written before a stop takes effect
+        work_cv_.wait(lock, [&] { return written_ < queued_ || stop_; });
+        if (written_ == queued_) return;
+
+        const Slot& slot = slots_[written_ % kSlots];
+        const bool skip = error_ != nullptr;
+        lock.unlock();
+        const auto start = std::chrono::steady_clock::now();
+        std::exception_ptr error;
+        if (!skip) {
+            try {
+                timeline_trace::Scope trace(timeline_trace::TraceLevel::Regions, kWriteKind,
+                                            nodes_.size() * slot.frames * sizeof(float), slot.frames);
+                writeChunk(slot, payload);
+            } catch (...) {
+                error = std::current_exception();
+            }
+        }
+        const double write_ms = msSince(start);
+        lock.lock();
+
+        if (!skip && !error) {
+            stats_.chunks_written++;
+            stats_.bytes_raw += nodes_.size() * slot.frames * sizeof(float);
+            stats_.bytes_written += sizeof(RecordingChunk) + payload.size();
+            stats_.last_write_ms = write_ms;
+        }
+        if (error) error_ = error;
+        written_++;
+        done_cv_.notify_all();
+    }
+}
+
+// Whole file mapped read-only
+class NodeRecording::Mapping {
+public:
+    explicit Mapping(const std::string& path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                  OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) fail(path, "cannot open");
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            fail(path, "cannot stat");
+        }
+        size_ = static_cast<size_t>(size.QuadPart);
+        HANDLE mapping = size_ ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        CloseHandle(file);
+        if (!mapping) fail(path, "not a recording");
+        data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (!data_) fail(path, "cannot map");
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) fail(path, "cannot open");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            fail(path, "cannot stat");
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* data = size_ ? ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (data == MAP_FAILED) fail(path, size_ ? "cannot map" : "not a recording");
+        data_ = static_cast<const unsigned char*>(data);
+#endif
+    }
+
+    ~Mapping() {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+#endif
+    }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    const unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+NodeRecording::NodeRecording(const std::string& path) : mapping_(new Mapping(path)), path_(path) {
+    const unsigned char* data = mapping_->data();
+    const uint64_t size = mapping_->size();
+    if (size < kRecordingHeaderBytes) fail(path, "not a recording");
+    FileHeader h;
+    std::memcpy(&h, data, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) fail(path, "not a recording");
+    if (h.version != kRecordingVersion) fail(path, "unsupported version " + std::to_string(h.version));
+    if (h.byte_order != kByteOrderTag) fail(path, "written with another byte order");
+    if (h.nodes_offset != kRecordingHeaderBytes || h.chunk_frames == 0 || h.decimation == 0 ||
+        h.chunks_offset != h.nodes_offset + roundUp(h.node_count * sizeof(uint32_t), kRecordingHeaderBytes) ||
+        h.chunks_offset > size) {
+        fail(path, "inconsistent header");
+    }
+    nodes_.resize(h.node_count);
+    if (!nodes_.empty()) std::memcpy(nodes_.data(), data + h.nodes_offset, nodes_.size() * sizeof(uint32_t));
+    decimation_ = h.decimation;
+
+    // A chunk cut short by the end of the file is one whose write never
+    // finished; everything before it stands
+    uint64_t offset = h.chunks_offset;
+    while (size - offset >= sizeof(RecordingChunk)) {
+        const RecordingChunk* chunk = reinterpret_cast<const RecordingChunk*>(data + offset);
+        if (std::memcmp(chunk->magic, kChunkMagic, sizeof(kChunkMagic)) != 0 || chunk->frames == 0 ||
+            chunk->frames > h.chunk_frames || chunk->first_frame != frames_ ||
+            (chunk->codec != kCodecRaw && chunk->codec != kCodecDelta) ||
+            (chunk->codec == kCodecRaw && chunk->stored_bytes != nodes_.size() * chunk->frames * sizeof(float)) ||
+            (chunk->codec == kCodecDelta && chunk->stored_bytes < (nodes_.size() + 1) * sizeof(uint64_t))) {
+            fail(path, "corrupt chunk at offset " + std::to_string(offset));
+        }
+        if (size - offset - sizeof(RecordingChunk) < chunk->stored_bytes) break;
+        chunks_.push_back({chunk, data + offset + sizeof(RecordingChunk)});
+        frames_ += chunk->frames;
+        offset += sizeof(RecordingChunk) + roundUp(chunk->stored_bytes, kChunkAlign);
+        if (offset > size) break;
+    }
+}
+
+NodeRecording::~NodeRecording() = default;
+
+const float* NodeRecording::column(const Chunk& chunk, size_t k, std::vector<float>& scratch) const {
+    const size_t frames = chunk.header->frames;
+    if (chunk.header->codec == kCodecRaw) {
+        return reinterpret_cast<const float*>(chunk.payload) + k * frames;
+    }
+    uint64_t begin, end;
+    std::memcpy(&begin, chunk.payload + k * sizeof(uint64_t), sizeof(begin));
+    std::memcpy(&end, chunk.payload + (k + 1) * sizeof(uint64_t), sizeof(end));
+    std::vector<unsigned char> planes;
+    scratch.resize(frames);
+    if (begin > end || end > chunk.header->stored_bytes ||
+        !decodeColumn(chunk.payload + begin, chunk.payload + end, frames, planes, scratch.data())) {
+        fail(path_, "corrupt chunk at frame " + std::to_string(chunk.header->first_frame));
+    }
+    return scratch.data();
+}
+
+void NodeRecording::readFrames(uint64_t first, uint64_t count, float* out) const {
+    if (first > frames_ || count > frames_ - first) {
+        throw std::out_of_range("recording " + path_ + " holds " + std::to_string(frames_) + " frames");
+    }
+    if (count == 0) return;
+    const size_t nodes = nodes_.size();
+    std::vector<float> scratch;
+    auto chunk = std::upper_bound(chunks_.begin(), chunks_.end(), first,
+                                  [](uint64_t f, const Chunk& c) { return f < c.header->first_frame; });
+    for (--chunk; count > 0; ++chunk) {
+        const uint64_t offset = first - chunk->header->first_frame;
+        const uint64_t take = std::min<uint64_t>(count, chunk->header->frames - offset);
+        for (size_t k = 0; k < nodes; k++) {
+            const float* from = column(*chunk, k, scratch) + offset;
+            for (uint64_t i = 0; i < take; i++) out[i * nodes + k] = from[i];
+        }
+        out += take * nodes;
+        first += take;
+        count -= take;
+    }
+}
+
+void NodeRecording::readColumn(size_t k, uint64_t first, uint64_t count, float* out) const {
+    if (k >= nodes_.size()) {
+        throw std::out_of_range("recording " + path_ + " has " + std::to_string(nodes_.size()) + " columns");
+    }
+    if (first > frames_ || count > frames_ - first) {
+        throw std::out_of_range("recording " + path_ + " holds " + std::to_string(frames_) + " frames");
+    }
+    if (count == 0) return;
+    std::vector<float> scratch;
+    auto chunk = std::upper_bound(chunks_.begin(), chunks_.end(), first,
+                                  [](uint64_t f, const Chunk& c) { return f < c.header->first_frame; });
+    for (--chunk; count > 0; ++chunk) {
+        const uint64_t offset = first - chunk->header->first_frame;
+        const uint64_t take = std::min<uint64_t>(count, chunk->header->frames - offset);
+        std::memcpy(out, column(*chunk, k, scratch) + offset, take * sizeof(float));
+        out += take;
+        first += take;
+        count -= take;
+    }
+}
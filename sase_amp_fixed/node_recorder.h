@@ -0,0 +1,180 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Node output recording file, version 1, in host byte order:
+//
+//   [0, kRecordingHeaderBytes)  header, zero padded to a page
+//   node list                   engine index of each recorded node (uint32),
+//                               zero padded to a page
+//   chunks                      back to back, each a RecordingChunk header
+//                               and its payload, padded to 64 bytes
+//
+// A frame is the float32 outputs of the recorded nodes after one engine
+// step. A chunk holds up to chunk_frames consecutive frames as columns:
+// node k's frames of the chunk are contiguous. A raw payload is those
+// columns as they are, so a mapping of the file reads them in place. A
+// compressed payload starts with nodes + 1 uint64 column offsets, and codes
+// each column on its own: every value is XORed with the previous frame's
+// bit pattern, the words are split into four byte planes (high bytes
+// first), and the planes are zero-run coded. Slowly moving outputs leave
+// mostly zero high bytes, which is what the runs remove.
+//
+// Chunks are appended whole, and a reader stops at the first chunk that
+// runs past the end of the file, so a recording cut short by a crash loses
+// at most the chunks still in flight.
+constexpr uint64_t kRecordingHeaderBytes = 4096;
+constexpr uint32_t kRecordingVersion = 1;
+
+// Per-chunk header of a recording file
+struct RecordingChunk {
+    char magic[4];           // "CHNK"
+    uint32_t codec;          // 0 raw, 1 compressed
+    uint64_t first_frame;    // Index of the chunk's first frame in the file
+    uint64_t frames;
+    uint64_t stored_bytes;   // Payload bytes, before padding
+    uint64_t reserved[4];
+};
+static_assert(sizeof(RecordingChunk) == 64, "chunk headers keep payloads 64-byte aligned");
+
+struct RecorderConfig {
+    std::string path;
+    std::vector<uint32_t> nodes;  // Engine indices to record, in order; empty records every node
+    uint32_t decimation = 1;      // Records every decimation-th frame
+    uint32_t chunk_frames = 1024; // Frames per chunk, capped so a chunk of columns stays within 16 MB
+    bool compress = true;
+};
+
+// Counters of a recorder since it was opened
+struct RecorderStats {
+    uint64_t frames_seen = 0;      // Frames offered, before decimation
+    uint64_t frames_recorded = 0;
+    uint64_t chunks_written = 0;
+    uint64_t bytes_raw = 0;        // Column bytes of the written chunks
+    uint64_t bytes_written = 0;    // File bytes of the written chunks, headers included
+    uint64_t writer_waits = 0;     // Full chunks that waited for a free slot
+    double last_write_ms = 0.0;    // Coding and write time of the newest chunk
+};
+
+// Columnar recorder of node outputs, written in the background.
+//
+// Frames are gathered into the chunk slot being filled (a transposing copy
+// of the recorded nodes); a full slot goes to a writer thread that codes it
+// and appends it to the file while the engine goes on into the next slot.
+// With every slot queued, the engine waits for the writer (counted in
+// writer_waits) rather than dropping frames.
+class NodeRecorder {
+public:
+    static constexpr size_t kSlots = 4;
+
+    // Creates the file for an engine of num_nodes nodes and starts the
+    // writer. Throws std::invalid_argument for a node index out of range,
+    // a zero decimation or chunk size, and std::runtime_error when the file
+    // cannot be created.
+    NodeRecorder(const RecorderConfig& config, size_t num_nodes);
+    // Writes the frames gathered so far and joins the writer; errors are
+    // dropped, call close() to see them
+    ~NodeRecorder();
+
+    NodeRecorder(const NodeRecorder&) = delete;
+    NodeRecorder& operator=(const NodeRecorder&) = delete;
+
+    // One frame from an output column of the engine's nodes
+    void appendFrame(const double* outputs);
+    // n frames from node-major [nodes x n] block outputs
+    void appendBlock(const float* outputs, size_t n);
+
+    // Queues the partly filled chunk and waits until every queued chunk is
+    // in the file. Both rethrow the first write error as std::runtime_error.
+    void flush();
+    // flush(), then closes the file; further appends are ignored
+    void close();
+
+    const RecorderConfig& config() const { return config_; }
+    size_t recordedNodes() const { return nodes_.size(); }
+    RecorderStats stats() const;
+
+private:
+    struct Slot {
+        std::vector<float> columns;  // [nodes x chunk_frames]
+        uint64_t first_frame = 0;
+        size_t frames = 0;
+    };
+
+    // Slot being filled, after waiting for one if all are queued
+    Slot& fillSlot();
+    void queueFill();
+    void run();
+    void writeChunk(const Slot& slot, std::vector<unsigned char>& payload);
+
+    RecorderConfig config_;  // chunk_frames as capped
+    std::vector<uint32_t> nodes_;
+    uint64_t frames_seen_ = 0;
+    uint64_t frames_recorded_ = 0;
+    bool fill_ready_ = false;  // The fill slot is free and started
+    bool closed_ = false;
+
+    struct FileHandle;
+    std::unique_ptr<FileHandle> file_;
+
+    Slot slots_[kSlots];
+    uint64_t queued_ = 0;   // Slots handed to the writer
+    uint64_t written_ = 0;  // ... and written
+    bool stop_ = false;
+    std::exception_ptr error_;
+    RecorderStats stats_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;   // writer: a slot was queued
+    std::condition_variable done_cv_;   // engine: a slot was written
+    std::thread thread_;
+};
+
+// Read-only view of a recording: the file is mapped and its chunks indexed
+// on open; raw chunks are read in place, compressed ones decoded.
+class NodeRecording {
+public:
+    // Throws std::runtime_error if the file is missing or not a recording
+    explicit NodeRecording(const std::string& path);
+    ~NodeRecording();
+
+    NodeRecording(const NodeRecording&) = delete;
+    NodeRecording& operator=(const NodeRecording&) = delete;
+
+    size_t nodeCount() const { return nodes_.size(); }
+    // Engine index of each recorded column
+    const std::vector<uint32_t>& nodes() const { return nodes_; }
+    uint64_t frameCount() const { return frames_; }
+    uint32_t decimation() const { return decimation_; }
+    size_t chunkCount() const { return chunks_.size(); }
+
+    // Frames [first, first + count) into frame-major out ([count x
+    // nodeCount()]). Throws std::out_of_range past frameCount().
+    void readFrames(uint64_t first, uint64_t count, float* out) const;
+    // Frames [first, first + count) of recorded column k into out
+    void readColumn(size_t k, uint64_t first, uint64_t count, float* out) const;
+
+private:
+    struct Chunk {
+        const RecordingChunk* header;
+        const unsigned char* payload;
+    };
+    // The chunk's column k, decoded into scratch unless stored raw
+    const float* column(const Chunk& chunk, size_t k, std::vector<float>& scratch) const;
+
+    class Mapping;
+    std::unique_ptr<Mapping> mapping_;
+    std::string path_;
+    std::vector<uint32_t> nodes_;
+    std::vector<Chunk> chunks_;
+    uint64_t frames_ = 0;
+    uint32_t decimation_ = 1;
+};
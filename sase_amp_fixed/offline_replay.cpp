@@ -0,0 +1,115 @@
+#include "offline_replay.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+#include "ici_kernel.h"
+#include "session_store.h"
+
+namespace {
+
+// Metrics columns of the session store, in order
+enum MetricColumn { ColumnTime, ColumnInputRms, ColumnOutputRms, ColumnIci, ColumnCount };
+
+double rms(const float* x, size_t n) {
+    double sum = 0.0;
+    for (size_t i = 0; i < n; i++) sum += static_cast<double>(x[i]) * x[i];
+    return n ? std::sqrt(sum / static_cast<double>(n)) : 0.0;
+}
+
+} // namespace
+
+OfflineReplayStats runOfflineReplay(const AudioFileReader& input, const std::string& output_path,
+                                    const std::string& metrics_path, const OfflineReplayConfig& config) {
+    if (config.block_size == 0) throw std::invalid_argument("block_size must be positive");
+    if (config.num_channels == 0) throw std::invalid_argument("num_channels must be positive");
+    if (config.nodes < config.num_channels) throw std::invalid_argument("need at least one node per channel");
+    if (config.input_channel >= static_cast<int>(input.channels())) {
+        throw std::invalid_argument("input_channel " + std::to_string(config.input_channel) + " of a " +
+                                    std::to_string(input.channels()) + "-channel file");
+    }
+    const bool ici = config.ici && !metrics_path.empty();
+    if (ici && config.num_channels < 2) throw std::invalid_argument("ICI needs at least 2 channels");
+
+    const auto start = std::chrono::steady_clock::now();
+    const size_t block = config.block_size;
+    const size_t channels = config.num_channels;
+    const uint64_t frames = input.frames();
+    const uint64_t blocks = (frames + block - 1) / block;
+
+    ChromaticBlockConfig chroma;
+    chroma.num_channels = channels;
+    chroma.node_stride = config.nodes / channels;
+    chroma.sample_rate = input.sampleRate();
+    chroma.phi_phase = config.phi_phase;
+    chroma.phi_depth = config.phi_depth;
+
+    auto pool = std::make_shared<WorkerPool>(config.workers);
+    size_t segments = config.segments ? config.segments : pool->size();
+    segments = static_cast<size_t>(std::max<uint64_t>(1, std::min<uint64_t>(segments, blocks)));
+
+    AudioFileWriter output(output_path, channels, input.sampleRate(), frames);
+    std::vector<double> metrics(metrics_path.empty() ? 0 : ColumnCount * blocks);
+
+    auto replay = [&](size_t s) {
+        const uint64_t begin = blocks * s / segments;
+        const uint64_t end = blocks * (s + 1) / segments;
+        AnalogCellularEngineAVX2 engine(config.nodes);
+        engine.shareWorkerPool(pool);
+        if (config.prepare) config.prepare(engine);
+        std::unique_ptr<ICIKernel> kernel = ici ? std::make_unique<ICIKernel>(channels, block) : nullptr;
+
+        std::vector<float> in(block);
+        std::vector<float> out(channels * block);
+        for (uint64_t b = begin - std::min<uint64_t>(begin, config.warmup_blocks); b < end; b++) {
+            const uint64_t first = b * block;
+            const size_t n = static_cast<size_t>(std::min<uint64_t>(block, frames - first));
+            input.read(config.input_channel, first, n, in.data());
+            engine.processChromaticBlock(in.data(), n, chroma, out.data());
+            if (b < begin) continue;
+
+            output.write(first, out.data(), n);
+            if (metrics.empty()) continue;
+            metrics[ColumnTime * blocks + b] = static_cast<double>(first) / input.sampleRate();
+            metrics[ColumnInputRms * blocks + b] = rms(in.data(), n);
+            metrics[ColumnOutputRms * blocks + b] = rms(out.data(), channels * n);
+            if (kernel) {
+                if (n < block) {
+                    // Channel-major rows of n samples spread to rows of block, zero padded
+                    for (size_t c = channels; c-- > 0;) {
+                        std::copy_backward(out.begin() + c * n, out.begin() + (c + 1) * n,
+                                           out.begin() + c * block + n);
+                        std::fill(out.begin() + c * block + n, out.begin() + (c + 1) * block, 0.0f);
+                    }
+                }
+                metrics[ColumnIci * blocks + b] = kernel->process(out.data());
+            }
+        }
+    };
+
+    if (segments < pool->size()) {
+        for (size_t s = 0; s < segments; s++) replay(s);
+    } else {
+        pool->parallelFor(segments, 1, [&](size_t first, size_t last, unsigned) {
+            for (size_t s = first; s < last; s++) replay(s);
+        });
+    }
+    output.flush();
+
+    if (!metrics.empty()) {
+        std::vector<std::string> names = {"time", "input_rms", "output_rms", "ici"};
+        if (!ici) names.pop_back();
+        writeSessionStore(metrics_path, names, metrics.data(), static_cast<size_t>(blocks), input.duration());
+    }
+
+    OfflineReplayStats stats;
+    stats.frames = frames;
+    stats.blocks = blocks;
+    stats.segments = segments;
+    stats.threads = pool->size();
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats.realtime_factor = stats.seconds > 0.0 ? input.duration() / stats.seconds : 0.0;
+    return stats;
+}
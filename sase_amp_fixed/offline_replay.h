@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "analog_universal_node_engine_avx2.h"
+#include "audio_file.h"
+#include "worker_pool.h"
+
+struct OfflineReplayConfig {
+    size_t nodes = 1024;
+    size_t block_size = 512;
+    size_t num_channels = 8;     // Chromatic channels, the output file's channels
+    double phi_phase = 0.0;      // Φ envelope of every block
+    double phi_depth = 0.5;
+    int input_channel = -1;      // Input channel fed to the engine; negative mixes all down
+    size_t segments = 0;         // Independent segments; 0 for one per worker, 1 for an exact replay
+    size_t warmup_blocks = 64;   // Blocks before a segment replayed, unwritten, to settle its nodes
+    bool ici = true;             // ICI of every block in the metrics file (needs 2+ channels)
+    WorkerPoolConfig workers;
+    // Applied to every segment's engine before its first block, e.g. a preset
+    std::function<void(AnalogCellularEngineAVX2&)> prepare;
+};
+
+struct OfflineReplayStats {
+    uint64_t frames = 0;
+    uint64_t blocks = 0;
+    size_t segments = 0;
+    unsigned threads = 0;
+    double seconds = 0.0;          // Wall time of the replay
+    double realtime_factor = 0.0;  // Audio duration over wall time
+};
+
+// Replays a recording through the engine offline, as fast as the cores go:
+// block by block through processChromaticBlock (the realtime server's
+// chromatic field step, Φ envelope restarting each block) from a
+// memory-mapped input into a memory-mapped float32 WAV of num_channels
+// channels at the input's rate.
+//
+// The recording is cut into segments of whole blocks, each replayed by its
+// own engine; segments run in parallel on one worker pool when there are at
+// least as many as workers, otherwise one after another with each engine
+// spread over the pool. Node state is the only thing carried from block to
+// block, so a segment starts from a fresh engine (after `prepare`) that
+// first replays the warmup_blocks before it without writing them: the leaky
+// integrators forget their start exponentially, and within a few time
+// constants the segment's output matches the sequential replay to float
+// rounding. segments = 1 is the sequential replay itself, bit for bit; with
+// warmup_blocks = 0 segments are fully independent renders.
+//
+// Unless metrics_path is empty, a session store (session_store.h) of one
+// sample per block is written there: time (block start, seconds),
+// input_rms, output_rms (over every channel) and, with ici, the ICI of the
+// block's channels (ICIKernel; a short last block is zero padded). The
+// Python session tools open it in place.
+//
+// Throws std::invalid_argument for an empty block, no channels, fewer
+// nodes than channels or an input channel past the file's last, and
+// std::runtime_error for I/O errors.
+OfflineReplayStats runOfflineReplay(const AudioFileReader& input, const std::string& output_path,
+                                    const std::string& metrics_path, const OfflineReplayConfig& config);
@@ -0,0 +1,512 @@
+#include "openmetrics.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include "analog_universal_node_engine_avx2.h"
+#include "session_manager.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
+
+const uint64_t OpenMetricsWriter::kLatencyBoundsNs[OpenMetricsWriter::kLatencyBounds] = {
+    1000ull,       2500ull,       5000ull,       10000ull,      25000ull,       50000ull,
+    100000ull,     250000ull,     500000ull,     1000000ull,    2500000ull,     5000000ull,
+    10000000ull,   25000000ull,   50000000ull,   100000000ull,  250000000ull,   500000000ull,
+    1000000000ull, 2500000000ull, 5000000000ull, 10000000000ull};
+
+namespace {
+
+void formatDouble(char* out, size_t size, double value) {
+    if (std::isnan(value)) {
+        std::snprintf(out, size, "NaN");
+    } else if (std::isinf(value)) {
+        std::snprintf(out, size, value > 0 ? "+Inf" : "-Inf");
+    } else {
+        std::snprintf(out, size, "%.12g", value);
+    }
+}
+
+void formatUnsigned(char* out, size_t size, uint64_t value) {
+    std::snprintf(out, size, "%llu", static_cast<unsigned long long>(value));
+}
+
+// le="..." bound in seconds of a bound in nanoseconds
+void formatBound(char* out, size_t size, uint64_t ns) {
+    std::snprintf(out, size, "le=\"%.9g\"", static_cast<double>(ns) * 1e-9);
+}
+
+} // namespace
+
+void OpenMetricsWriter::family(const char* name, const char* type, const char* help, const char* unit) {
+    text_ += "# TYPE ";
+    text_ += name;
+    text_ += ' ';
+    text_ += type;
+    text_ += '\n';
+    if (unit && *unit) {
+        text_ += "# UNIT ";
+        text_ += name;
+        text_ += ' ';
+        text_ += unit;
+        text_ += '\n';
+    }
+    text_ += "# HELP ";
+    text_ += name;
+    text_ += ' ';
+    text_ += help;
+    text_ += '\n';
+}
+
+void OpenMetricsWriter::line(const char* name, const char* suffix, const char* labels, const char* extra,
+                             const char* value) {
+    text_ += name;
+    if (suffix) text_ += suffix;
+    const bool has_labels = labels && *labels;
+    const bool has_extra = extra && *extra;
+    if (has_labels || has_extra) {
+        text_ += '{';
+        if (has_labels) text_ += labels;
+        if (has_labels && has_extra) text_ += ',';
+        if (has_extra) text_ += extra;
+        text_ += '}';
+    }
+    text_ += ' ';
+    text_ += value;
+    text_ += '\n';
+}
+
+void OpenMetricsWriter::sample(const char* name, const char* labels, double value) {
+    char v[32];
+    formatDouble(v, sizeof(v), value);
+    line(name, nullptr, labels, nullptr, v);
+}
+
+void OpenMetricsWriter::sample(const char* name, const char* labels, uint64_t value) {
+    char v[24];
+    formatUnsigned(v, sizeof(v), value);
+    line(name, nullptr, labels, nullptr, v);
+}
+
+void OpenMetricsWriter::counterSample(const char* name, const char* labels, double value) {
+    char v[32];
+    formatDouble(v, sizeof(v), value);
+    line(name, "_total", labels, nullptr, v);
+}
+
+void OpenMetricsWriter::counterSample(const char* name, const char* labels, uint64_t value) {
+    char v[24];
+    formatUnsigned(v, sizeof(v), value);
+    line(name, "_total", labels, nullptr, v);
+}
+
+void OpenMetricsWriter::gauge(const char* name, const char* help, double value, const char* unit) {
+    family(name, "gauge", help, unit);
+    sample(name, nullptr, value);
+}
+
+void OpenMetricsWriter::counter(const char* name, const char* help, uint64_t value) {
+    family(name, "counter", help);
+    counterSample(name, nullptr, value);
+}
+
+void OpenMetricsWriter::counter(const char* name, const char* help, double value, const char* unit) {
+    family(name, "counter", help, unit);
+    counterSample(name, nullptr, value);
+}
+
+void OpenMetricsWriter::latencyHistogram(const char* name, const char* labels, const LatencySnapshot& snapshot) {
+    uint64_t below[kLatencyBounds + 1] = {};
+    for (size_t i = 0; i < snapshot.counts.size(); i++) {
+        const uint64_t count = snapshot.counts[i];
+        if (count == 0) continue;
+        const uint64_t upper = LatencyHistogram::bucketUpperBound(i);
+        size_t b = 0;
+        while (b < kLatencyBounds && upper > kLatencyBoundsNs[b]) b++;
+        below[b] += count;
+    }
+    // Buckets and count from the same counts, so they agree even while
+    // recording went on during the snapshot
+    uint64_t cumulative = 0;
+    char bound[32];
+    char v[24];
+    for (size_t b = 0; b < kLatencyBounds; b++) {
+        cumulative += below[b];
+        formatBound(bound, sizeof(bound), kLatencyBoundsNs[b]);
+        formatUnsigned(v, sizeof(v), cumulative);
+        line(name, "_bucket", labels, bound, v);
+    }
+    cumulative += below[kLatencyBounds];
+    formatUnsigned(v, sizeof(v), cumulative);
+    line(name, "_bucket", labels, "le=\"+Inf\"", v);
+    line(name, "_count", labels, nullptr, v);
+    char sum[32];
+    formatDouble(sum, sizeof(sum), snapshot.mean_ns * static_cast<double>(snapshot.count) * 1e-9);
+    line(name, "_sum", labels, nullptr, sum);
+}
+
+void OpenMetricsWriter::latencySummary(const char* name, const char* labels, uint64_t count, uint64_t sum_ns,
+                                       uint64_t p50_ns, uint64_t p90_ns, uint64_t p99_ns, uint64_t p999_ns) {
+    static const char* const kQuantiles[] = {"quantile=\"0.5\"", "quantile=\"0.9\"", "quantile=\"0.99\"",
+                                             "quantile=\"0.999\""};
+    const uint64_t values[] = {p50_ns, p90_ns, p99_ns, p999_ns};
+    char v[32];
+    for (size_t q = 0; q < 4; q++) {
+        formatDouble(v, sizeof(v), static_cast<double>(values[q]) * 1e-9);
+        line(name, nullptr, labels, kQuantiles[q], v);
+    }
+    formatUnsigned(v, sizeof(v), count);
+    line(name, "_count", labels, nullptr, v);
+    formatDouble(v, sizeof(v), static_cast<double>(sum_ns) * 1e-9);
+    line(name, "_sum", labels, nullptr, v);
+}
+
+void writeEngineMetrics(OpenMetricsWriter& w, const EngineMetricsFrame& f) {
+    w.counter("dase_execution_seconds", "Time in timed engine scopes",
+              static_cast<double>(f.total_execution_time_ns) * 1e-9, "seconds");
+    w.counter("dase_simd_execution_seconds", "Time in the SIMD node kernels",
+              static_cast<double>(f.avx2_operation_time_ns) * 1e-9, "seconds");
+    w.counter("dase_operations", "Engine operations", f.total_operations);
+    w.counter("dase_simd_operations", "Node kernel operations", f.avx2_operations);
+    w.counter("dase_node_processes", "Node steps", f.node_processes);
+    w.counter("dase_harmonic_generations", "Harmonic generator calls", f.harmonic_generations);
+    w.counter("dase_profiled_scopes", "Scopes that read the clock", f.profiled_scopes);
+    w.counter("dase_profiling_overhead_seconds", "Estimated time the clock reads added",
+              f.profiling_overhead_ns * 1e-9, "seconds");
+    w.gauge("dase_operation_seconds", "Mean time per operation", f.current_ns_per_op * 1e-9, "seconds");
+    w.gauge("dase_operations_per_second", "Operation rate", f.current_ops_per_second);
+    w.gauge("dase_speedup_factor", "Speedup over the 8000 ns per operation target", f.speedup_factor);
+
+    w.gauge("dase_hw_counters_available", "1 when the host grants hardware counters",
+            static_cast<double>(f.hw_counters_available));
+    w.counter("dase_hw_cycles", "CPU cycles of the timed scopes", f.hw_cycles);
+    w.counter("dase_hw_instructions", "Instructions of the timed scopes", f.hw_instructions);
+    w.counter("dase_hw_l1d_misses", "L1 data cache misses of the timed scopes", f.hw_l1d_misses);
+    w.counter("dase_hw_llc_misses", "Last-level cache misses of the timed scopes", f.hw_llc_misses);
+    w.counter("dase_hw_branch_misses", "Branch misses of the timed scopes", f.hw_branch_misses);
+    w.gauge("dase_instructions_per_cycle", "Instructions per cycle of the timed scopes", f.instructions_per_cycle);
+}
+
+void writeEngineOpenMetrics(OpenMetricsWriter& w, const AnalogCellularEngineAVX2& engine) {
+    EngineMetricsFrame frame;
+    engine.getMetricsFrame(frame);
+    writeEngineMetrics(w, frame);
+
+    static const char* const kProbeLabels[] = {"probe=\"engine_block\"", "probe=\"wave_sweep\"",
+                                               "probe=\"node_block\""};
+    static_assert(sizeof(kProbeLabels) / sizeof(kProbeLabels[0]) == static_cast<size_t>(LatencyProbe::ProbeCount),
+                  "one label per latency probe");
+    w.family("dase_latency_seconds", "histogram", "Per-call latency of the engine call sites", "seconds");
+    for (int p = 0; p < static_cast<int>(LatencyProbe::ProbeCount); p++) {
+        w.latencyHistogram("dase_latency_seconds", kProbeLabels[p],
+                           engine.getLatencyHistogram(static_cast<LatencyProbe>(p)));
+    }
+
+    static const char* const kDeadlineLabels[] = {"stage=\"engine_block\"", "stage=\"chromatic_block\"",
+                                                  "stage=\"filter_block\""};
+    static_assert(sizeof(kDeadlineLabels) / sizeof(kDeadlineLabels[0]) == DeadlineWatchdog::kStages,
+                  "one label per deadline stage");
+    DeadlineHealth health[DeadlineWatchdog::kStages];
+    for (size_t s = 0; s < DeadlineWatchdog::kStages; s++) {
+        health[s] = engine.deadlineWatchdog().health(static_cast<DeadlineStage>(s));
+    }
+    struct Counter {
+        const char* name;
+        const char* help;
+        uint64_t DeadlineHealth::*value;
+    };
+    static const Counter kCounters[] = {
+        {"dase_deadline_calls", "Block calls timed by the deadline watchdog", &DeadlineHealth::calls},
+        {"dase_deadline_misses", "Block calls over their real-time budget", &DeadlineHealth::misses},
+        {"dase_deadline_near_misses", "Block calls within budget over the near-miss fraction",
+         &DeadlineHealth::near_misses},
+    };
+    for (const Counter& c : kCounters) {
+        w.family(c.name, "counter", c.help);
+        for (size_t s = 0; s < DeadlineWatchdog::kStages; s++) {
+            w.counterSample(c.name, kDeadlineLabels[s], health[s].*c.value);
+        }
+    }
+    w.family("dase_deadline_worst_load_ratio", "gauge", "Longest block call over its budget", "ratio");
+    for (size_t s = 0; s < DeadlineWatchdog::kStages; s++) {
+        w.sample("dase_deadline_worst_load_ratio", kDeadlineLabels[s], health[s].worst_load);
+    }
+
+    const std::vector<WorkerThreadStatus> workers = engine.getWorkerThreadStatus();
+    std::vector<std::string> worker_labels;
+    for (const WorkerThreadStatus& status : workers) {
+        worker_labels.push_back("worker=\"" + std::to_string(status.worker) + "\"");
+    }
+    w.family("dase_worker_realtime", "gauge", "1 when the worker runs in the MMCSS task or SCHED_FIFO");
+    for (size_t k = 0; k < workers.size(); k++) {
+        w.sample("dase_worker_realtime", worker_labels[k].c_str(), workers[k].realtime ? 1.0 : 0.0);
+    }
+    w.family("dase_worker_priority", "gauge", "AVRT priority or SCHED_FIFO priority of the worker");
+    for (size_t k = 0; k < workers.size(); k++) {
+        w.sample("dase_worker_priority", worker_labels[k].c_str(), static_cast<double>(workers[k].priority));
+    }
+    w.family("dase_worker_timer_resolution_seconds", "gauge",
+             "System timer period or timer slack of the worker", "seconds");
+    for (size_t k = 0; k < workers.size(); k++) {
+        w.sample("dase_worker_timer_resolution_seconds", worker_labels[k].c_str(),
+                 static_cast<double>(workers[k].timer_resolution_ns) * 1e-9);
+    }
+    w.family("dase_worker_power_throttling_disabled", "gauge", "1 when the worker's power throttling is off");
+    for (size_t k = 0; k < workers.size(); k++) {
+        w.sample("dase_worker_power_throttling_disabled", worker_labels[k].c_str(),
+                 workers[k].power_throttling_disabled ? 1.0 : 0.0);
+    }
+}
+
+std::string engineOpenMetrics(const AnalogCellularEngineAVX2& engine) {
+    OpenMetricsWriter writer;
+    writeEngineOpenMetrics(writer, engine);
+    writer.finish();
+    return writer.text();
+}
+
+void writeSessionOpenMetrics(OpenMetricsWriter& w, const std::vector<SessionUsage>& sessions) {
+    std::vector<std::string> labels;
+    for (const SessionUsage& u : sessions) {
+        labels.push_back("session=\"" + std::to_string(u.session) + "\",numa_node=\"" +
+                         std::to_string(u.numa_node) + "\"");
+    }
+    w.family("dase_session_cpu_seconds", "counter", "Thread CPU time of the session's blocks", "seconds");
+    for (size_t k = 0; k < sessions.size(); k++) {
+        w.counterSample("dase_session_cpu_seconds", labels[k].c_str(), static_cast<double>(sessions[k].cpu_ns) * 1e-9);
+    }
+    struct Counter {
+        const char* name;
+        const char* help;
+        uint64_t SessionUsage::*value;
+    };
+    static const Counter kCounters[] = {
+        {"dase_session_blocks", "Blocks the session ran", &SessionUsage::blocks},
+        {"dase_session_samples", "Samples the session ran", &SessionUsage::samples},
+        {"dase_session_deadline_misses", "Session blocks over their real-time length", &SessionUsage::deadline_misses},
+        {"dase_session_throttled_blocks", "Session blocks run under a throttle step", &SessionUsage::throttled_blocks},
+    };
+    for (const Counter& c : kCounters) {
+        w.family(c.name, "counter", c.help);
+        for (size_t k = 0; k < sessions.size(); k++) w.counterSample(c.name, labels[k].c_str(), sessions[k].*c.value);
+    }
+    w.family("dase_session_memory_bytes", "gauge", "Memory the session's engine holds", "bytes");
+    for (size_t k = 0; k < sessions.size(); k++) {
+        w.sample("dase_session_memory_bytes", labels[k].c_str(), static_cast<uint64_t>(sessions[k].memory_bytes));
+    }
+    w.family("dase_session_nodes", "gauge", "Cellular nodes of the session");
+    for (size_t k = 0; k < sessions.size(); k++) {
+        w.sample("dase_session_nodes", labels[k].c_str(), static_cast<uint64_t>(sessions[k].nodes));
+    }
+    w.family("dase_session_load_ratio", "gauge", "CPU time over real time of the last budget window", "ratio");
+    for (size_t k = 0; k < sessions.size(); k++) w.sample("dase_session_load_ratio", labels[k].c_str(), sessions[k].load);
+    w.family("dase_session_cpu_budget_ratio", "gauge", "Session CPU load budget, 0 for none", "ratio");
+    for (size_t k = 0; k < sessions.size(); k++) {
+        w.sample("dase_session_cpu_budget_ratio", labels[k].c_str(), sessions[k].budget.cpu_load);
+    }
+    w.family("dase_session_throttle", "gauge", "Throttle steps in force on the session");
+    for (size_t k = 0; k < sessions.size(); k++) {
+        w.sample("dase_session_throttle", labels[k].c_str(), static_cast<uint64_t>(sessions[k].throttle));
+    }
+}
+
+std::string sessionOpenMetrics(const SessionManager& manager) {
+    OpenMetricsWriter writer;
+    writeSessionOpenMetrics(writer, manager.usage());
+    writer.finish();
+    return writer.text();
+}
+
+namespace {
+
+#ifdef _WIN32
+constexpr intptr_t kNoSocket = static_cast<intptr_t>(INVALID_SOCKET);
+void closeSocket(intptr_t s) { closesocket(static_cast<SOCKET>(s)); }
+#else
+constexpr intptr_t kNoSocket = -1;
+void closeSocket(intptr_t s) { ::close(static_cast<int>(s)); }
+#endif
+
+#if defined(MSG_NOSIGNAL)
+constexpr int kSendFlags = MSG_NOSIGNAL;  // A scraper hanging up must not raise SIGPIPE
+#else
+constexpr int kSendFlags = 0;
+#endif
+
+bool sendAll(intptr_t s, const char* data, size_t size) {
+    while (size > 0) {
+        const int chunk = static_cast<int>(size < (1u << 30) ? size : (1u << 30));
+#ifdef _WIN32
+        const int sent = ::send(static_cast<SOCKET>(s), data, chunk, kSendFlags);
+#else
+        const ssize_t sent = ::send(static_cast<int>(s), data, static_cast<size_t>(chunk), kSendFlags);
+#endif
+        if (sent <= 0) return false;
+        data += sent;
+        size -= static_cast<size_t>(sent);
+    }
+    return true;
+}
+
+void respond(intptr_t s, const char* status, const char* content_type, const std::string& body) {
+    char header[256];
+    const int n = std::snprintf(header, sizeof(header),
+                                "HTTP/1.1 %s\r\nContent-Type: %s\r\nContent-Length: %zu\r\nConnection: close\r\n\r\n",
+                                status, content_type, body.size());
+    if (sendAll(s, header, static_cast<size_t>(n))) sendAll(s, body.data(), body.size());
+}
+
+constexpr const char* kOpenMetricsType = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+constexpr const char* kTextType = "text/plain; charset=utf-8";
+constexpr size_t kMaxRequestBytes = 8192;
+constexpr int kPollMs = 100;       // How often the idle server checks for stop()
+constexpr int kReceiveMs = 2000;   // A client that sends no request in time is dropped
+
+} // namespace
+
+MetricsHttpServer::MetricsHttpServer(Render render, uint16_t port, const std::string& bind_address)
+    : render_(std::move(render)) {
+    if (!render_) throw std::invalid_argument("metrics endpoint needs a render function");
+    const std::string where = bind_address + ":" + std::to_string(port);
+#ifdef _WIN32
+    WSADATA wsa;
+    if (WSAStartup(MAKEWORD(2, 2), &wsa) != 0) throw std::runtime_error("metrics endpoint: no Winsock");
+#endif
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    if (inet_pton(AF_INET, bind_address.c_str(), &address.sin_addr) != 1) {
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        throw std::runtime_error("metrics endpoint " + where + ": not an IPv4 address");
+    }
+
+    const intptr_t s = static_cast<intptr_t>(::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+    bool ok = s != kNoSocket;
+    if (ok) {
+        const int on = 1;
+        setsockopt(s, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&on), sizeof(on));
+        ok = ::bind(s, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0 && ::listen(s, 8) == 0;
+    }
+    socklen_t length = sizeof(address);
+    ok = ok && getsockname(s, reinterpret_cast<sockaddr*>(&address), &length) == 0;
+    if (!ok) {
+        if (s != kNoSocket) closeSocket(s);
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        throw std::runtime_error("metrics endpoint " + where + ": cannot listen");
+    }
+    listener_ = s;
+    port_ = ntohs(address.sin_port);
+    thread_ = std::thread(&MetricsHttpServer::run, this);
+}
+
+MetricsHttpServer::~MetricsHttpServer() { stop(); }
+
+void MetricsHttpServer::stop() {
+    stop_.store(true, std::memory_order_relaxed);
+    if (thread_.joinable()) thread_.join();
+    if (listener_ != kNoSocket) {
+        closeSocket(listener_);
+        listener_ = kNoSocket;
+#ifdef _WIN32
+        WSACleanup();
+#endif
+    }
+}
+
+void MetricsHttpServer::run() {
+    while (!stop_.load(std::memory_order_relaxed)) {
+#ifdef _WIN32
+        WSAPOLLFD fd = {};
+        fd.fd = static_cast<SOCKET>(listener_);
+        fd.events = POLLRDNORM;
+        if (WSAPoll(&fd, 1, kPollMs) <= 0) continue;
+        const intptr_t client = static_cast<intptr_t>(::accept(static_cast<SOCKET>(listener_), nullptr, nullptr));
+#else
+        pollfd fd = {};
+        fd.fd = static_cast<int>(listener_);
+        fd.events = POLLIN;
+        if (::poll(&fd, 1, kPollMs) <= 0) continue;
+        const intptr_t client = ::accept(static_cast<int>(listener_), nullptr, nullptr);
+#endif
+        if (client == kNoSocket) continue;
+        serve(client);
+        closeSocket(client);
+    }
+}
+
+void MetricsHttpServer::serve(intptr_t client) {
+#ifdef _WIN32
+    const DWORD timeout = kReceiveMs;
+#else
+    timeval timeout = {};
+    timeout.tv_sec = kReceiveMs / 1000;
+    timeout.tv_usec = (kReceiveMs % 1000) * 1000;
+#endif
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+
+    // Only the request line matters; read up to the end of the headers
+    char request[kMaxRequestBytes + 1];
+    size_t size = 0;
+    while (size < kMaxRequestBytes) {
+#ifdef _WIN32
+        const int got = ::recv(static_cast<SOCKET>(client), request + size, static_cast<int>(kMaxRequestBytes - size), 0);
+#else
+        const ssize_t got = ::recv(static_cast<int>(client), request + size, kMaxRequestBytes - size, 0);
+#endif
+        if (got <= 0) break;
+        size += static_cast<size_t>(got);
+        request[size] = '\0';
+        if (std::strstr(request, "\r\n\r\n") || std::strstr(request, "\n\n")) break;
+    }
+    request[size] = '\0';
+
+    char method[16] = {};
+    char target[256] = {};
+    if (std::sscanf(request, "%15s %255s", method, target) != 2) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        respond(client, "400 Bad Request", kTextType, "bad request\n");
+        return;
+    }
+    if (char* query = std::strchr(target, '?')) *query = '\0';
+    const bool head = std::strcmp(method, "HEAD") == 0;
+    if (!head && std::strcmp(method, "GET") != 0) {
+        respond(client, "405 Method Not Allowed", kTextType, "GET /metrics\n");
+        return;
+    }
+    if (std::strcmp(target, "/metrics") != 0 && std::strcmp(target, "/") != 0) {
+        respond(client, "404 Not Found", kTextType, "GET /metrics\n");
+        return;
+    }
+
+    writer_.clear();
+    try {
+        render_(writer_);
+    } catch (const std::exception& e) {
+        errors_.fetch_add(1, std::memory_order_relaxed);
+        respond(client, "500 Internal Server Error", kTextType, std::string(e.what()) + "\n");
+        return;
+    }
+    writer_.finish();
+    scrapes_.fetch_add(1, std::memory_order_relaxed);
+    if (head) {
+        respond(client, "200 OK", kOpenMetricsType, std::string());
+    } else {
+        respond(client, "200 OK", kOpenMetricsType, writer_.text());
+    }
+}
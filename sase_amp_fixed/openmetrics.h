@@ -0,0 +1,123 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "latency_histogram.h"
+
+class AnalogCellularEngineAVX2;
+class SessionManager;
+struct EngineMetricsFrame;
+struct SessionUsage;
+
+// OpenMetrics 1.0 text exposition into a reusable buffer.
+//
+// A family is declared once with family() and followed by its samples;
+// finish() closes the payload with "# EOF". Names follow the OpenMetrics
+// rules the caller is trusted with: a family with a unit ends in that unit,
+// counter samples get the "_total" suffix from counter(). labels is the
+// inside of the braces without them ("stage=\"dase\""), empty for none.
+// clear() keeps the capacity, so a scraper that reuses one writer stops
+// allocating once the payload has reached its size.
+class OpenMetricsWriter {
+public:
+    explicit OpenMetricsWriter(size_t reserve_bytes = 16384) { text_.reserve(reserve_bytes); }
+
+    // # TYPE, # UNIT (when unit is given) and # HELP lines. type is one of
+    // "counter", "gauge", "histogram", "summary", "stateset", "info".
+    void family(const char* name, const char* type, const char* help, const char* unit = nullptr);
+
+    void sample(const char* name, const char* labels, double value);
+    void sample(const char* name, const char* labels, uint64_t value);
+    // name + "_total"
+    void counterSample(const char* name, const char* labels, double value);
+    void counterSample(const char* name, const char* labels, uint64_t value);
+
+    // Families of one sample
+    void gauge(const char* name, const char* help, double value, const char* unit = nullptr);
+    void counter(const char* name, const char* help, uint64_t value);
+    void counter(const char* name, const char* help, double value, const char* unit);
+
+    // Samples of a histogram family in seconds: cumulative _bucket samples
+    // on the kLatencyBoundsNs bounds and +Inf, then _count and _sum. Each
+    // LatencyHistogram bucket is counted under the first bound at or above
+    // its upper edge, so a value lands at most one HDR bucket (1.6%) late.
+    void latencyHistogram(const char* name, const char* labels, const LatencySnapshot& snapshot);
+    // Summary samples from p50/p90/p99/p99.9 and max in nanoseconds, for
+    // sources that keep only percentiles; sum_ns may be 0 when unknown
+    void latencySummary(const char* name, const char* labels, uint64_t count, uint64_t sum_ns, uint64_t p50_ns,
+                        uint64_t p90_ns, uint64_t p99_ns, uint64_t p999_ns);
+
+    void finish() { text_ += "# EOF\n"; }
+    void clear() { text_.clear(); }
+    const std::string& text() const { return text_; }
+
+    // 1-2.5-5 bounds from 1 µs to 10 s
+    static constexpr size_t kLatencyBounds = 22;
+    static const uint64_t kLatencyBoundsNs[kLatencyBounds];
+
+private:
+    void line(const char* name, const char* suffix, const char* labels, const char* extra, const char* value);
+
+    std::string text_;
+};
+
+// Engine counters of getMetricsFrame() as dase_* families. Reads the
+// counters atomically like the frame itself: no lock, no allocation.
+void writeEngineMetrics(OpenMetricsWriter& writer, const EngineMetricsFrame& frame);
+// Engine counters and the dase_latency_seconds histogram of every
+// LatencyProbe. The counters and histograms are process wide; engine only
+// reads them, so this is safe from any thread while the engine runs.
+void writeEngineOpenMetrics(OpenMetricsWriter& writer, const AnalogCellularEngineAVX2& engine);
+// writeEngineOpenMetrics into a fresh payload, with "# EOF"
+std::string engineOpenMetrics(const AnalogCellularEngineAVX2& engine);
+// Per-session dase_session_* families of SessionManager::usage(), labelled
+// session and numa_node, for schedulers placing sessions across hosts
+void writeSessionOpenMetrics(OpenMetricsWriter& writer, const std::vector<SessionUsage>& sessions);
+// writeSessionOpenMetrics of the manager's sessions, with "# EOF"
+std::string sessionOpenMetrics(const SessionManager& manager);
+
+// Minimal HTTP endpoint for Prometheus scrapes on a thread of its own.
+//
+// GET /metrics (or /) answers with what render writes into the server's
+// writer, as application/openmetrics-text; the server adds "# EOF". Other
+// paths get 404 and other methods 405. One connection is served at a time
+// and closed after the response, so a scrape costs the audio threads
+// nothing beyond the counters render reads. render runs on the server
+// thread; an exception from it becomes a 500 with the message.
+class MetricsHttpServer {
+public:
+    using Render = std::function<void(OpenMetricsWriter&)>;
+
+    // Listens on bind_address:port, port 0 for any free one. Throws
+    // std::invalid_argument without a render function and
+    // std::runtime_error when the socket cannot be bound.
+    MetricsHttpServer(Render render, uint16_t port = 9464, const std::string& bind_address = "127.0.0.1");
+    // Stops and joins the server thread
+    ~MetricsHttpServer();
+
+    MetricsHttpServer(const MetricsHttpServer&) = delete;
+    MetricsHttpServer& operator=(const MetricsHttpServer&) = delete;
+
+    void stop();
+    uint16_t port() const { return port_; }
+    uint64_t scrapes() const { return scrapes_.load(std::memory_order_relaxed); }
+    uint64_t errors() const { return errors_.load(std::memory_order_relaxed); }
+
+private:
+    void run();
+    void serve(intptr_t client);
+
+    Render render_;
+    OpenMetricsWriter writer_;
+    intptr_t listener_ = -1;
+    uint16_t port_ = 0;
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> scrapes_{0};
+    std::atomic<uint64_t> errors_{0};  // Failed renders and malformed requests
+    std::thread thread_;
+};
@@ -0,0 +1,41 @@
+#include "output_publisher.h"
+#include <chrono>
+
+OutputPublisher::OutputPublisher(size_t max_rows, size_t max_samples, size_t max_nodes)
+    : max_rows_(max_rows), max_samples_(max_samples), max_nodes_(max_nodes) {
+    for (PublishedBlock& slot : slots_) {
+        slot.output.assign(max_rows * max_samples, 0.0f);
+        slot.node_outputs.assign(max_nodes, 0.0);
+    }
+}
+
+float* OutputPublisher::beginBlock(size_t rows, size_t samples) {
+    if (rows > max_rows_ || samples > max_samples_) return nullptr;
+    PublishedBlock& slot = slots_[back_];
+    slot.rows = rows;
+    slot.samples = samples;
+    slot.node_count = 0;
+    return slot.output.data();
+}
+
+void OutputPublisher::publish(PublishedBlockKind kind) {
+    PublishedBlock& slot = slots_[back_];
+    slot.kind = kind;
+    const uint64_t sequence = published_.load(std::memory_order_relaxed) + 1;
+    slot.sequence = sequence;
+    slot.published_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                            std::chrono::steady_clock::now().time_since_epoch()).count();
+    // Release hands the slot's contents over with it; acquire takes back the
+    // one the reader let go of, finished with
+    back_ = middle_.exchange(static_cast<uint8_t>(back_ | kFresh), std::memory_order_acq_rel) & 3;
+    published_.store(sequence, std::memory_order_relaxed);
+}
+
+const PublishedBlock* OutputPublisher::acquire() {
+    if (middle_.load(std::memory_order_relaxed) & kFresh) {
+        front_ = middle_.exchange(front_, std::memory_order_acq_rel) & 3;
+        acquired_.fetch_add(1, std::memory_order_relaxed);
+    }
+    const PublishedBlock& slot = slots_[front_];
+    return slot.sequence > 0 ? &slot : nullptr;
+}
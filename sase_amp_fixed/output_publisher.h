@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+enum class PublishedBlockKind : uint8_t {
+    Block = 0,       // processBlock: node-major [nodes x samples]
+    Chromatic = 1    // processChromaticBlock: channel-major [channels x samples]
+};
+
+// One completed block as readers see it
+struct PublishedBlock {
+    uint64_t sequence = 0;        // 1 for the first block published, 0 before
+    PublishedBlockKind kind = PublishedBlockKind::Block;
+    size_t rows = 0;
+    size_t samples = 0;
+    int64_t published_ns = 0;     // steady_clock at publication
+    std::vector<float> output;    // Capacity of the publisher; the first rows * samples are the block's
+    std::vector<double> node_outputs;  // Every node's output after the block, node_count of them
+    size_t node_count = 0;        // 0 when the block left the host node state stale (Cuda backend)
+
+    const float* row(size_t r) const { return output.data() + r * samples; }
+};
+
+// Lock-free triple buffer of completed blocks, between the thread running
+// the engine and one reader sampling it at frame rate (a visualizer, the
+// metrics streamer).
+//
+// Three PublishedBlock slots are preallocated: the writer fills its back
+// slot and publish() swaps it with the middle one; acquire() swaps the
+// middle slot with the reader's front one when it holds a newer block.
+// Each side owns its slot outright between swaps, so the writer never
+// waits, the reader never sees a block being written, and neither copies:
+// the engine writes processBlock outputs straight into the back slot when
+// the caller passes no out. Blocks published between two acquires are
+// skipped over, the reader only ever gets the latest.
+//
+// acquire() may be called from any thread but not from two at once; in
+// Python the GIL serializes callers. What it returns stays valid and
+// unchanged until the next acquire().
+class OutputPublisher {
+public:
+    // Slots for blocks of up to max_rows x max_samples and max_nodes node
+    // outputs; all allocation happens here
+    OutputPublisher(size_t max_rows, size_t max_samples, size_t max_nodes);
+
+    OutputPublisher(const OutputPublisher&) = delete;
+    OutputPublisher& operator=(const OutputPublisher&) = delete;
+
+    // Writer side, one thread. Back slot output for a rows x samples block,
+    // or nullptr when it does not fit (the block then goes unpublished)
+    float* beginBlock(size_t rows, size_t samples);
+    PublishedBlock& back() { return slots_[back_]; }
+    // Stamps and publishes the back slot after beginBlock succeeded
+    void publish(PublishedBlockKind kind);
+    // Counts a block that did not fit
+    void skip() { skipped_.fetch_add(1, std::memory_order_relaxed); }
+
+    // Reader side. The latest published block, nullptr before the first
+    const PublishedBlock* acquire();
+    // Whether a block newer than the last acquired one is waiting
+    bool hasNew() const { return (middle_.load(std::memory_order_acquire) & kFresh) != 0; }
+
+    size_t maxRows() const { return max_rows_; }
+    size_t maxSamples() const { return max_samples_; }
+    size_t maxNodes() const { return max_nodes_; }
+    uint64_t published() const { return published_.load(std::memory_order_relaxed); }
+    uint64_t skipped() const { return skipped_.load(std::memory_order_relaxed); }
+    // Blocks the reader was handed, each at most once
+    uint64_t acquired() const { return acquired_.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr uint8_t kFresh = 4;   // Middle holds a block the reader has not taken
+
+    size_t max_rows_;
+    size_t max_samples_;
+    size_t max_nodes_;
+    PublishedBlock slots_[3];
+    uint8_t back_ = 0;     // Writer's
+    uint8_t front_ = 2;    // Reader's
+    alignas(64) std::atomic<uint8_t> middle_{1};
+    alignas(64) std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> skipped_{0};
+    alignas(64) std::atomic<uint64_t> acquired_{0};
+};
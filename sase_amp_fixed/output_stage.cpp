@@ -0,0 +1,114 @@
+#include "output_stage.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+StereoDownmix::StereoDownmix(size_t channels, SimdLevel level)
+    : channels_(channels), kernels_(&nodeKernels(level)), weights_(2 * channels, 0.0f) {
+    if (channels == 0) throw std::invalid_argument("downmix needs at least one channel");
+}
+
+void StereoDownmix::setWeights(const float* left, const float* right, float gain) {
+    for (size_t c = 0; c < channels_; c++) {
+        weights_[c] = left[c] * gain;
+        weights_[channels_ + c] = right[c] * gain;
+    }
+}
+
+void StereoDownmix::process(const float* in, size_t stride, size_t n, float* left, float* right) const {
+    float* const out[2] = {left, right};
+    kernels_->mix_rows(in, channels_, static_cast<ptrdiff_t>(stride), weights_.data(), 2, out, n);
+}
+
+FractionalDelayLine::FractionalDelayLine(size_t channels, size_t max_delay, DelayInterpolation interpolation,
+                                         size_t max_block, SimdLevel level)
+    : channels_(channels), max_delay_(max_delay), max_block_(max_block),
+      ring_(max_delay + max_block + 4), kernels_(&nodeKernels(level)), interpolation_(interpolation) {
+    if (channels == 0) throw std::invalid_argument("delay line needs at least one channel");
+    if (max_block == 0) throw std::invalid_argument("max_block must be positive");
+    buffer_.assign(channels_ * 2 * ring_, 0.0f);
+    scratch_.assign(max_block_, 0.0f);
+}
+
+void FractionalDelayLine::setDelay(double samples) {
+    delay_ = std::min(std::max(samples, 0.0), static_cast<double>(max_delay_));
+}
+
+void FractionalDelayLine::reset() {
+    std::fill(buffer_.begin(), buffer_.end(), 0.0f);
+    write_ = 0;
+}
+
+void FractionalDelayLine::write(const float* in, size_t channel_step, size_t sample_step, size_t n) {
+    for (size_t c = 0; c < channels_; c++) {
+        float* ring = buffer_.data() + c * 2 * ring_;
+        const float* src = in + c * channel_step;
+        size_t index = write_;
+        for (size_t t = 0; t < n; t++) {
+            const float v = src[t * sample_step];
+            ring[index] = v;
+            ring[index + ring_] = v;
+            if (++index == ring_) index = 0;
+        }
+    }
+    write_ = (write_ + n) % ring_;
+}
+
+size_t FractionalDelayLine::taps(float* weights, size_t& offset) const {
+    const size_t whole = static_cast<size_t>(delay_);
+    const float mu = static_cast<float>(delay_ - static_cast<double>(whole));
+    if (interpolation_ == DelayInterpolation::Lagrange3 && whole >= 1) {
+        // Nodes 0..3, evaluated at 2 - mu: between the middle two taps
+        const float x = 2.0f - mu;
+        weights[0] = -(x - 1.0f) * (x - 2.0f) * (x - 3.0f) / 6.0f;
+        weights[1] = x * (x - 2.0f) * (x - 3.0f) / 2.0f;
+        weights[2] = -x * (x - 1.0f) * (x - 3.0f) / 2.0f;
+        weights[3] = x * (x - 1.0f) * (x - 2.0f) / 6.0f;
+        offset = 2;
+        return 4;
+    }
+    weights[0] = mu;
+    weights[1] = 1.0f - mu;
+    offset = 1;
+    return 2;
+}
+
+void FractionalDelayLine::read(size_t start, size_t n, size_t channel, const float* weights, size_t count,
+                               size_t offset, float* out) const {
+    // The ring is longer than max_delay + max_block + 3, so the span of the
+    // block starts in the first copy and ends in the second at the latest
+    const size_t whole = static_cast<size_t>(delay_);
+    const size_t first = (start + 2 * ring_ - whole - offset) % ring_;
+    float* const dst[1] = {out};
+    kernels_->mix_rows(buffer_.data() + channel * 2 * ring_ + first, count, 1, weights, 1, dst, n);
+}
+
+void FractionalDelayLine::process(float* block, size_t stride, size_t n) {
+    float weights[4];
+    size_t offset;
+    const size_t count = taps(weights, offset);
+    for (size_t done = 0; done < n;) {
+        const size_t m = std::min(max_block_, n - done);
+        const size_t start = write_;
+        write(block + done, stride, 1, m);
+        for (size_t c = 0; c < channels_; c++) read(start, m, c, weights, count, offset, block + c * stride + done);
+        done += m;
+    }
+}
+
+void FractionalDelayLine::processInterleaved(float* frames, size_t n) {
+    float weights[4];
+    size_t offset;
+    const size_t count = taps(weights, offset);
+    for (size_t done = 0; done < n;) {
+        const size_t m = std::min(max_block_, n - done);
+        float* chunk = frames + done * channels_;
+        const size_t start = write_;
+        write(chunk, 1, channels_, m);
+        for (size_t c = 0; c < channels_; c++) {
+            read(start, m, c, weights, count, offset, scratch_.data());
+            for (size_t t = 0; t < m; t++) chunk[t * channels_ + c] = scratch_[t];
+        }
+        done += m;
+    }
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "node_kernels.h"
+
+// Output stage of the audio path after the engine: the multi-channel to
+// stereo downmix (server/downmix.py) and the latency compensation delay
+// (server/latency_manager.py DelayLineBuffer). Both run through the node
+// kernel table, keep every buffer from construction and work in place on
+// the caller's block.
+
+// C -> 2 matrix downmix of channel-major blocks: left = sum_c l_c x_c,
+// right = sum_c r_c x_c, one FMA per channel and sample across the block.
+class StereoDownmix {
+public:
+    // Throws std::invalid_argument for no channels
+    explicit StereoDownmix(size_t channels = 8, SimdLevel level = defaultSimdLevel());
+
+    // Per-channel weights (channels() values each); gain scales both, so it
+    // carries downmix.py's normalization and master gain
+    void setWeights(const float* left, const float* right, float gain = 1.0f);
+    const std::vector<float>& weights() const { return weights_; }  // Left row, then right row
+
+    size_t channels() const { return channels_; }
+    SimdLevel getSimdLevel() const { return kernels_->level; }
+
+    // Mixes n samples of in (channels() rows, stride floats apart) into left
+    // and right. Either may be a row of in: pass in and in + stride to leave
+    // the stereo pair in the block's first two rows.
+    void process(const float* in, size_t stride, size_t n, float* left, float* right) const;
+
+private:
+    size_t channels_;
+    const NodeKernels* kernels_;
+    std::vector<float> weights_;
+};
+
+enum class DelayInterpolation {
+    Linear = 0,     // Two taps, as DelayLineBuffer
+    Lagrange3 = 1   // Four-tap third-order Lagrange; linear below one sample of delay
+};
+
+// Multi-channel fractional delay: y[t] = x(t - delay) per channel, read from
+// one ring per channel by interpolation. The delay holds for a whole block,
+// so a block is a 2- or 4-tap FIR over a contiguous span of the ring (each
+// sample is stored twice, R apart, so spans never wrap) and runs as one
+// mix_rows call per channel. Blocks longer than max_block are taken in
+// max_block pieces.
+class FractionalDelayLine {
+public:
+    // Delays up to max_delay samples. Throws std::invalid_argument for no
+    // channels or a max_block of 0.
+    FractionalDelayLine(size_t channels, size_t max_delay,
+                        DelayInterpolation interpolation = DelayInterpolation::Linear, size_t max_block = 4096,
+                        SimdLevel level = defaultSimdLevel());
+
+    // Samples, clamped to [0, maxDelay()]; takes effect with the next block
+    void setDelay(double samples);
+    double delay() const { return delay_; }
+    void setInterpolation(DelayInterpolation interpolation) { interpolation_ = interpolation; }
+    DelayInterpolation interpolation() const { return interpolation_; }
+
+    size_t channels() const { return channels_; }
+    size_t maxDelay() const { return max_delay_; }
+    SimdLevel getSimdLevel() const { return kernels_->level; }
+
+    // Delays n samples of every channel in place: channel-major (rows stride
+    // floats apart) or interleaved frames of channels() samples
+    void process(float* block, size_t stride, size_t n);
+    void processInterleaved(float* frames, size_t n);
+
+    // Clears the history; delay and interpolation are kept
+    void reset();
+
+private:
+    // Stores the next n samples of each channel (channel c's sample t at
+    // in[c * channel_step + t * sample_step]) and advances the write position
+    void write(const float* in, size_t channel_step, size_t sample_step, size_t n);
+    // Interpolation taps of the current delay; returns their count and sets
+    // offset, so tap 0 of output t is x[t - floor(delay) - offset]
+    size_t taps(float* weights, size_t& offset) const;
+    // Interpolated output of the n samples of channel just written from ring
+    // index start
+    void read(size_t start, size_t n, size_t channel, const float* weights, size_t count, size_t offset,
+              float* out) const;
+
+    size_t channels_;
+    size_t max_delay_;
+    size_t max_block_;
+    size_t ring_;                 // R, ring length per channel
+    const NodeKernels* kernels_;
+    DelayInterpolation interpolation_;
+    double delay_ = 0.0;
+    size_t write_ = 0;            // Ring index of the next sample
+    std::vector<float> buffer_;   // [channels x 2R]
+    std::vector<float> scratch_;  // One channel of max_block samples (interleaved output)
+};
@@ -0,0 +1,124 @@
+#include "parameter_automation.h"
+#include "phase_lock.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+size_t ringSlots(size_t capacity) {
+    size_t slots = 1;
+    while (slots < capacity) slots <<= 1;
+    return slots;
+}
+
+} // namespace
+
+ParameterAutomation::ParameterAutomation(size_t capacity, size_t max_block, size_t smoothing, double phi_phase,
+                                         double phi_depth)
+    : max_block_(max_block), smoothing_(smoothing) {
+    if (capacity == 0) throw std::invalid_argument("parameter automation capacity must be at least 1");
+    if (max_block == 0) throw std::invalid_argument("parameter automation block must be at least 1 sample");
+    ring_.resize(ringSlots(capacity));
+    pending_.reserve(ring_.size());
+    feedback_.resize(ring_.size());
+    ramp_[0].value = ramp_[0].target = static_cast<float>(phi_phase);
+    ramp_[1].value = ramp_[1].target = static_cast<float>(phi_depth);
+    for (size_t p = 0; p < 2; p++) curve_[p].assign(max_block_, ramp_[p].value);
+}
+
+bool ParameterAutomation::push(const ParameterEvent& event) {
+    const uint64_t write = write_.load(std::memory_order_relaxed);
+    if (write - read_.load(std::memory_order_acquire) >= ring_.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ring_[write & (ring_.size() - 1)] = event;
+    write_.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+bool ParameterAutomation::schedule(ParameterId id, float value, uint64_t sample, uint32_t node) {
+    ParameterEvent event;
+    event.sample = sample;
+    event.node = node;
+    event.id = id;
+    event.value = value;
+    return push(event);
+}
+
+void ParameterAutomation::drain() {
+    uint64_t read = read_.load(std::memory_order_relaxed);
+    const uint64_t write = write_.load(std::memory_order_acquire);
+    // Stable by arrival among events of the same sample
+    for (; read != write && pending_.size() < pending_.capacity(); read++) {
+        const ParameterEvent& event = ring_[read & (ring_.size() - 1)];
+        const auto at = std::upper_bound(pending_.begin(), pending_.end(), event.sample,
+                                         [](uint64_t sample, const ParameterEvent& e) { return sample < e.sample; });
+        pending_.insert(at, event);
+    }
+    read_.store(read, std::memory_order_release);
+}
+
+void ParameterAutomation::fill(Ramp& ramp, float* curve, size_t from, size_t to) {
+    size_t t = from;
+    for (; t < to && ramp.remaining > 0; t++) {
+        ramp.value = --ramp.remaining == 0 ? ramp.target : ramp.value + ramp.step;
+        curve[t] = ramp.value;
+    }
+    std::fill(curve + t, curve + std::max(t, to), ramp.value);
+}
+
+void ParameterAutomation::retarget(Ramp& ramp, ParameterId id, float value) {
+    double distance = static_cast<double>(value) - ramp.value;
+    // The phase glides through the nearer way round and lands on value
+    // itself, a whole number of turns from where the glide ends
+    if (id == ParameterId::PhiPhase) distance = std::remainder(distance, 2.0 * M_PI);
+    ramp.target = value;
+    if (smoothing_ == 0) {
+        ramp.value = value;
+        ramp.remaining = 0;
+        return;
+    }
+    ramp.step = static_cast<float>(distance / static_cast<double>(smoothing_));
+    ramp.remaining = smoothing_;
+}
+
+void ParameterAutomation::render(size_t n) {
+    if (n > max_block_) throw std::invalid_argument("block longer than the automation's max_block");
+    drain();
+    const uint64_t start = position_.load(std::memory_order_relaxed);
+    const uint64_t end = start + n;
+
+    feedback_count_ = 0;
+    size_t done[2] = {0, 0};
+    size_t due = 0;
+    for (; due < pending_.size() && pending_[due].sample < end; due++) {
+        const ParameterEvent& event = pending_[due];
+        const size_t offset = event.sample > start ? static_cast<size_t>(event.sample - start) : 0;
+        if (event.id == ParameterId::Feedback) {
+            feedback_[feedback_count_++] = event;
+            continue;
+        }
+        const size_t p = event.id == ParameterId::PhiPhase ? 0 : 1;
+        fill(ramp_[p], curve_[p].data(), done[p], offset);
+        done[p] = offset;
+        retarget(ramp_[p], event.id, event.value);
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(due));
+    for (size_t p = 0; p < 2; p++) fill(ramp_[p], curve_[p].data(), done[p], n);
+    if (phase_lock_) phase_lock_->apply(start, n, curve_[0].data());
+
+    position_.store(end, std::memory_order_release);
+}
+
+double ParameterAutomation::target(ParameterId id) const {
+    if (id == ParameterId::Feedback) return 0.0;
+    return ramp_[id == ParameterId::PhiPhase ? 0 : 1].target;
+}
+
+double ParameterAutomation::current(ParameterId id) const {
+    if (id == ParameterId::Feedback) return 0.0;
+    if (id == ParameterId::PhiPhase) return ramp_[0].value + (phase_lock_ ? phase_lock_->correction() : 0.0);
+    return ramp_[1].value;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Parameters the control threads change under a running engine
+enum class ParameterId : uint8_t {
+    PhiPhase = 0,   // Φ envelope phase, radians; ramps the short way round
+    PhiDepth = 1,   // Φ envelope depth and control wave amplitude
+    Feedback = 2    // Node feedback gain, clamped to [-2, 2]
+};
+
+constexpr size_t kParameterCount = 3;
+
+class ParameterSwitch;
+class PhaseLockLoop;
+
+// One timestamped change. The sample is on the automation's clock (the
+// position() of the block stream it feeds); a sample already past lands on
+// the next block's first sample, so 0 means "as soon as possible".
+struct ParameterEvent {
+    uint64_t sample = 0;
+    uint32_t node = 0;          // Feedback only: the node, or kAllNodes
+    ParameterId id = ParameterId::PhiDepth;
+    float value = 0.0f;
+
+    static constexpr uint32_t kAllNodes = UINT32_MAX;
+};
+
+// Parameter automation from control threads into the audio thread.
+//
+// Producers push timestamped events into a single-producer single-consumer
+// ring (one producer at a time: the Python binding holds the GIL across a
+// push, which serializes web request threads). Once per block the audio
+// thread calls render(n): due events leave the ring for a pending list kept
+// in time order, and the Φ parameters come back as n-sample curves that
+// glide linearly to each new value over smoothing() samples from the event's
+// offset in the block. Feedback changes have no per-sample path through the
+// node kernels, so those due in a block are listed for the caller to apply
+// at its start. Every buffer is sized at construction: push and render never
+// lock or allocate.
+class ParameterAutomation {
+public:
+    // Throws std::invalid_argument for a zero capacity or max_block
+    explicit ParameterAutomation(size_t capacity = 1024, size_t max_block = 4096, size_t smoothing = 64,
+                                 double phi_phase = 0.0, double phi_depth = 0.5);
+
+    ParameterAutomation(const ParameterAutomation&) = delete;
+    ParameterAutomation& operator=(const ParameterAutomation&) = delete;
+
+    // Producer side. Returns false, and counts a drop, when the ring is full.
+    bool push(const ParameterEvent& event);
+    bool schedule(ParameterId id, float value, uint64_t sample = 0, uint32_t node = ParameterEvent::kAllNodes);
+
+    // Consumer side: the curves and feedback changes of the next n samples
+    // (at most maxBlock()), then position() advances by n
+    void render(size_t n);
+    const float* phiPhase() const { return curve_[0].data(); }
+    const float* phiDepth() const { return curve_[1].data(); }
+    const ParameterEvent* feedbackChanges() const { return feedback_.data(); }
+    size_t feedbackChangeCount() const { return feedback_count_; }
+
+    // Preset switch the engine advances at the start of every block run
+    // under this automation, before its feedback changes; null for none.
+    // It must outlive the automation or the next setParameterSwitch.
+    void setParameterSwitch(ParameterSwitch* parameter_switch) { switch_ = parameter_switch; }
+    ParameterSwitch* parameterSwitch() const { return switch_; }
+
+    // Cluster phase lock render() runs on the phase curve once it is
+    // filled, so the curve comes out corrected toward the remote phase;
+    // null for none. It must outlive the automation or the next
+    // setPhaseLock.
+    void setPhaseLock(PhaseLockLoop* phase_lock) { phase_lock_ = phase_lock; }
+    PhaseLockLoop* phaseLock() const { return phase_lock_; }
+
+    // Φ parameter where its glide ends, and where the last rendered block
+    // left it (the phase with the lock's correction); 0 for Feedback, which
+    // is the nodes' own state
+    double target(ParameterId id) const;
+    double current(ParameterId id) const;
+
+    // First sample of the next render; readable from any thread
+    uint64_t position() const { return position_.load(std::memory_order_acquire); }
+    size_t capacity() const { return ring_.size(); }
+    size_t maxBlock() const { return max_block_; }
+    size_t smoothing() const { return smoothing_; }
+    size_t pending() const { return pending_.size(); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    struct Ramp {
+        float value;
+        float target;
+        float step = 0.0f;
+        size_t remaining = 0;
+    };
+
+    // Moves ring events into pending_ in time order while there is room
+    void drain();
+    // curve[from, to) of one ramp
+    void fill(Ramp& ramp, float* curve, size_t from, size_t to);
+    void retarget(Ramp& ramp, ParameterId id, float value);
+
+    std::vector<ParameterEvent> ring_;          // Power-of-two slots
+    alignas(64) std::atomic<uint64_t> write_{0};
+    alignas(64) std::atomic<uint64_t> read_{0};
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> position_{0};
+
+    size_t max_block_;
+    size_t smoothing_;
+    std::vector<ParameterEvent> pending_;       // Time order, capacity() reserved
+    std::vector<ParameterEvent> feedback_;      // This block's feedback changes
+    size_t feedback_count_ = 0;
+    Ramp ramp_[2];                              // Phase and depth
+    std::vector<float> curve_[2];
+    ParameterSwitch* switch_ = nullptr;
+    PhaseLockLoop* phase_lock_ = nullptr;
+};
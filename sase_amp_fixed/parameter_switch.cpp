@@ -0,0 +1,137 @@
+#include "parameter_switch.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+ParameterSwitch::ParameterSwitch(size_t num_nodes) : nodes_(num_nodes) {
+    if (num_nodes == 0) throw std::invalid_argument("parameter switch needs at least one node");
+    for (size_t p = 0; p < kNodeParameterCount; p++) {
+        target_[p].resize(nodes_);
+        origin_[p].resize(nodes_);
+        node_set_[p].resize(nodes_);
+    }
+}
+
+double* ParameterSwitch::column(NodeBank& bank, NodeParameter parameter) {
+    switch (parameter) {
+        case NodeParameter::Feedback: return bank.feedback_gain;
+        case NodeParameter::InputGain: return bank.input_gain;
+        case NodeParameter::TimeConstant: return bank.time_constant;
+        case NodeParameter::ClampLow: return bank.clamp_low;
+        case NodeParameter::ClampHigh: return bank.clamp_high;
+        case NodeParameter::SpectralMix: return bank.spectral_mix;
+    }
+    return nullptr;
+}
+
+bool ParameterSwitch::staging(NodeParameter parameter) {
+    if (state_.load(std::memory_order_acquire) != kIdle) return false;
+    const size_t p = static_cast<size_t>(parameter);
+    if (p >= kNodeParameterCount) throw std::invalid_argument("unknown node parameter");
+    return true;
+}
+
+bool ParameterSwitch::stage(NodeParameter parameter, const double* values) {
+    if (!staging(parameter)) return false;
+    const size_t p = static_cast<size_t>(parameter);
+    std::copy(values, values + nodes_, target_[p].begin());
+    if (parameter == NodeParameter::Feedback) {
+        for (double& v : target_[p]) v = std::max(-2.0, std::min(2.0, v));
+    }
+    staged_[p] = true;
+    partial_[p] = false;
+    return true;
+}
+
+bool ParameterSwitch::stageUniform(NodeParameter parameter, double value) {
+    if (!staging(parameter)) return false;
+    const size_t p = static_cast<size_t>(parameter);
+    if (parameter == NodeParameter::Feedback) value = std::max(-2.0, std::min(2.0, value));
+    std::fill(target_[p].begin(), target_[p].end(), value);
+    staged_[p] = true;
+    partial_[p] = false;
+    return true;
+}
+
+bool ParameterSwitch::stageNode(NodeParameter parameter, size_t node, double value) {
+    if (node >= nodes_) {
+        throw std::out_of_range("node " + std::to_string(node) + " of a " + std::to_string(nodes_) +
+                                "-node parameter switch");
+    }
+    if (!staging(parameter)) return false;
+    const size_t p = static_cast<size_t>(parameter);
+    if (!staged_[p]) {
+        std::fill(node_set_[p].begin(), node_set_[p].end(), 0);
+        staged_[p] = true;
+        partial_[p] = true;
+    }
+    if (parameter == NodeParameter::Feedback) value = std::max(-2.0, std::min(2.0, value));
+    target_[p][node] = value;
+    node_set_[p][node] = 1;
+    return true;
+}
+
+bool ParameterSwitch::commit(size_t crossfade_samples) {
+    if (state_.load(std::memory_order_acquire) != kIdle) return false;
+    if (std::none_of(std::begin(staged_), std::end(staged_), [](bool s) { return s; })) return false;
+    crossfade_ = crossfade_samples;
+    elapsed_ = 0;
+    progress_.store(0.0, std::memory_order_relaxed);
+    state_.store(kCommitted, std::memory_order_release);
+    return true;
+}
+
+void ParameterSwitch::cancel() {
+    if (state_.load(std::memory_order_acquire) != kIdle) return;
+    std::fill(std::begin(staged_), std::end(staged_), false);
+    std::fill(std::begin(partial_), std::end(partial_), false);
+}
+
+double ParameterSwitch::progress() const { return progress_.load(std::memory_order_relaxed); }
+
+void ParameterSwitch::apply(NodeBank& bank, size_t n) {
+    const int state = state_.load(std::memory_order_acquire);
+    if (state == kIdle) return;
+    if (bank.size() != nodes_) {
+        throw std::invalid_argument("parameter switch for " + std::to_string(nodes_) + " nodes applied to " +
+                                    std::to_string(bank.size()));
+    }
+
+    if (state == kCommitted) {
+        // Unset nodes of a column staged node by node take their live values
+        for (size_t p = 0; p < kNodeParameterCount; p++) {
+            if (!staged_[p]) continue;
+            const double* live = column(bank, static_cast<NodeParameter>(p));
+            std::copy(live, live + nodes_, origin_[p].begin());
+            if (!partial_[p]) continue;
+            double* target = target_[p].data();
+            const uint8_t* set = node_set_[p].data();
+            for (size_t i = 0; i < nodes_; i++) {
+                if (!set[i]) target[i] = live[i];
+            }
+        }
+        state_.store(kFading, std::memory_order_relaxed);
+    }
+
+    elapsed_ += n;
+    const bool done = elapsed_ >= crossfade_;
+    const double t = done ? 1.0 : static_cast<double>(elapsed_) / static_cast<double>(crossfade_);
+    for (size_t p = 0; p < kNodeParameterCount; p++) {
+        if (!staged_[p]) continue;
+        double* live = column(bank, static_cast<NodeParameter>(p));
+        const double* target = target_[p].data();
+        if (done) {
+            std::copy(target, target + nodes_, live);
+            continue;
+        }
+        const double* origin = origin_[p].data();
+        for (size_t i = 0; i < nodes_; i++) live[i] = origin[i] + (target[i] - origin[i]) * t;
+    }
+    progress_.store(t, std::memory_order_relaxed);
+    if (done) {
+        std::fill(std::begin(staged_), std::end(staged_), false);
+        std::fill(std::begin(partial_), std::end(partial_), false);
+        switches_.fetch_add(1, std::memory_order_relaxed);
+        state_.store(kIdle, std::memory_order_release);
+    }
+}
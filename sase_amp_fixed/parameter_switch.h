@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "node_bank.h"
+
+// Per-node parameter columns of a NodeBank, the part of a preset that lives
+// in the nodes
+enum class NodeParameter : uint8_t {
+    Feedback = 0,      // Clamped to [-2, 2]
+    InputGain = 1,
+    TimeConstant = 2,
+    ClampLow = 3,
+    ClampHigh = 4,
+    SpectralMix = 5
+};
+
+constexpr size_t kNodeParameterCount = 6;
+
+// Preset changes for a running engine without rebuilding it.
+//
+// A control thread stages a new parameter set into shadow columns, any
+// number of columns in full, uniformly or node by node, then commits it.
+// The audio thread applies it at the start of its next block: columns left
+// unstaged keep their live values, and staged ones are copied in at once or,
+// with a crossfade, glide linearly from their live values to the staged
+// ones block by block over crossfade samples (each block runs on the
+// values at its end), so no node steps. Staging and applying only touch
+// columns allocated at construction: a switch allocates nothing and costs
+// the audio thread one pass over the staged columns per block while it
+// lasts.
+//
+// One control thread stages at a time; stage*() and commit() return false
+// while the previous switch is still being applied.
+class ParameterSwitch {
+public:
+    // Throws std::invalid_argument for no nodes
+    explicit ParameterSwitch(size_t num_nodes);
+
+    ParameterSwitch(const ParameterSwitch&) = delete;
+    ParameterSwitch& operator=(const ParameterSwitch&) = delete;
+
+    // Control side. values holds nodes() entries. Nodes a column staged
+    // node by node leaves unset keep their live values; a node past the
+    // last throws std::out_of_range.
+    bool stage(NodeParameter parameter, const double* values);
+    bool stageUniform(NodeParameter parameter, double value);
+    bool stageNode(NodeParameter parameter, size_t node, double value);
+    // Hands the staged columns to the audio thread; false when nothing is
+    // staged or a switch is in progress
+    bool commit(size_t crossfade_samples = 0);
+    // Drops staged, uncommitted columns
+    void cancel();
+
+    // Audio side, at a block boundary before the block runs: advances a
+    // committed switch by n samples. Throws std::invalid_argument when the
+    // bank's node count differs from nodes().
+    void apply(NodeBank& bank, size_t n);
+
+    size_t nodes() const { return nodes_; }
+    // True while no committed switch is waiting or fading (stage*() succeed)
+    bool idle() const { return state_.load(std::memory_order_acquire) == kIdle; }
+    // Fraction of the current crossfade done, 1 when idle
+    double progress() const;
+    uint64_t switches() const { return switches_.load(std::memory_order_relaxed); }
+
+private:
+    enum : int { kIdle = 0, kCommitted = 1, kFading = 2 };
+
+    static double* column(NodeBank& bank, NodeParameter parameter);
+    bool staging(NodeParameter parameter);
+
+    size_t nodes_;
+    std::vector<double> target_[kNodeParameterCount];  // Staged values
+    std::vector<double> origin_[kNodeParameterCount];  // Live values when the crossfade began
+    std::vector<uint8_t> node_set_[kNodeParameterCount];  // Nodes a partial column sets
+    bool staged_[kNodeParameterCount] = {};
+    bool partial_[kNodeParameterCount] = {};          // Staged node by node
+    size_t crossfade_ = 0;
+    size_t elapsed_ = 0;
+    std::atomic<int> state_{kIdle};
+    std::atomic<double> progress_{1.0};
+    std::atomic<uint64_t> switches_{0};
+};
@@ -0,0 +1,188 @@
+#include "partitioned_convolver.h"
+#include <algorithm>
+#include <new>
+#include <stdexcept>
+
+PartitionedConvolver::Stage::Stage(int block, FFTBackend backend)
+    : block_(static_cast<size_t>(block)), bins_(static_cast<size_t>(block) + 1),
+      stride_((static_cast<size_t>(block) + 16) & ~size_t(15)) {
+    real_ = fftAllocReal(2 * block_);
+    spectrum_ = fftAllocComplex(bins_);
+    if (!real_ || !spectrum_) {
+        fftFree(real_);
+        fftFree(spectrum_);
+        throw std::bad_alloc();
+    }
+    try {
+        fft_ = createRealFFT(backend, 2 * block, 1, real_, spectrum_);
+    } catch (...) {
+        fftFree(real_);
+        fftFree(spectrum_);
+        throw;
+    }
+    input_.assign(2 * block_, 0.0);
+    sum_.assign(2 * stride_, 0.0f);
+}
+
+PartitionedConvolver::Stage::~Stage() {
+    fft_.reset();
+    fftFree(real_);
+    fftFree(spectrum_);
+}
+
+void PartitionedConvolver::Stage::setPartitions(const float* ir, size_t length) {
+    partitions_ = (length + block_ - 1) / block_;
+    filters_.assign(partitions_ * 2 * stride_, 0.0f);
+    delay_line_.assign(partitions_ * 2 * stride_, 0.0f);
+    taps_.assign(partitions_, nullptr);
+
+    // Partition p is taps [p B, (p + 1) B) zero padded to 2 B, its spectrum
+    // scaled by the inverse transform's 1 / 2 B
+    const double scale = 1.0 / static_cast<double>(2 * block_);
+    for (size_t p = 0; p < partitions_; p++) {
+        const size_t first = p * block_;
+        const size_t count = std::min(block_, length - first);
+        for (size_t t = 0; t < count; t++) real_[t] = static_cast<double>(ir[first + t]);
+        std::fill(real_ + count, real_ + 2 * block_, 0.0);
+        fft_->forward(real_, spectrum_);
+        float* re = filters_.data() + p * 2 * stride_;
+        float* im = re + stride_;
+        for (size_t k = 0; k < bins_; k++) {
+            re[k] = static_cast<float>(spectrum_[k][0] * scale);
+            im[k] = static_cast<float>(spectrum_[k][1] * scale);
+        }
+    }
+    reset();
+}
+
+void PartitionedConvolver::Stage::reset() {
+    std::fill(input_.begin(), input_.end(), 0.0);
+    std::fill(delay_line_.begin(), delay_line_.end(), 0.0f);
+    head_ = 0;
+}
+
+void PartitionedConvolver::Stage::process(const NodeKernels& kernels, const float* in, float* out) {
+    if (partitions_ == 0) {
+        std::fill(out, out + block_, 0.0f);
+        return;
+    }
+
+    // Overlap-save frame: the previous block, then this one
+    std::copy(input_.begin() + block_, input_.end(), input_.begin());
+    for (size_t t = 0; t < block_; t++) input_[block_ + t] = static_cast<double>(in[t]);
+    std::copy(input_.begin(), input_.end(), real_);
+    fft_->forward(real_, spectrum_);
+
+    head_ = head_ + 1 < partitions_ ? head_ + 1 : 0;
+    float* re = delay_line_.data() + head_ * 2 * stride_;
+    float* im = re + stride_;
+    for (size_t k = 0; k < bins_; k++) {
+        re[k] = static_cast<float>(spectrum_[k][0]);
+        im[k] = static_cast<float>(spectrum_[k][1]);
+    }
+
+    // Partition p meets the spectrum of p blocks ago
+    for (size_t p = 0, slot = head_; p < partitions_; p++) {
+        taps_[p] = delay_line_.data() + slot * 2 * stride_;
+        slot = slot == 0 ? partitions_ - 1 : slot - 1;
+    }
+    kernels.spectrum_mac(taps_.data(), filters_.data(), partitions_, stride_, sum_.data());
+
+    for (size_t k = 0; k < bins_; k++) {
+        spectrum_[k][0] = static_cast<double>(sum_[k]);
+        spectrum_[k][1] = static_cast<double>(sum_[stride_ + k]);
+    }
+    fft_->inverse(spectrum_, real_);
+    // The first half wraps around; the second is the linear convolution
+    for (size_t t = 0; t < block_; t++) out[t] = static_cast<float>(real_[block_ + t]);
+}
+
+PartitionedConvolver::PartitionedConvolver(const ConvolverConfig& config, SimdLevel level)
+    : config_(config), kernels_(&nodeKernels(level)) {
+    const int B = config_.block_size;
+    const int T = config_.tail_block_size;
+    if (B < 1) throw std::invalid_argument("block_size must be at least 1");
+    if (T != 0 && (T < 2 * B || T % B != 0)) {
+        throw std::invalid_argument("tail_block_size must be 0 or a multiple of block_size of at least twice it");
+    }
+
+    head_ = std::make_unique<Stage>(B, config_.fft_backend);
+    if (T != 0) {
+        tail_ = std::make_unique<Stage>(T, config_.fft_backend);
+        tail_in_.assign(static_cast<size_t>(T), 0.0f);
+        tail_out_.assign(static_cast<size_t>(T), 0.0f);
+    }
+    block_in_.assign(static_cast<size_t>(B), 0.0f);
+    ready_.assign(static_cast<size_t>(B), 0.0f);
+}
+
+PartitionedConvolver::~PartitionedConvolver() = default;
+
+size_t PartitionedConvolver::headPartitions() const {
+    return head_->partitions();
+}
+
+size_t PartitionedConvolver::tailPartitions() const {
+    return tail_ ? tail_->partitions() : 0;
+}
+
+void PartitionedConvolver::setImpulseResponse(const float* ir, size_t length) {
+    ir_length_ = length;
+    if (tail_) {
+        // The tail's output for a block of tail_block_size samples is ready
+        // when that block is complete and is emitted over the next one, so
+        // its first tap must sit tail_block_size - block_size in
+        const size_t split = std::min(length, tail_->block() - head_->block());
+        head_->setPartitions(ir, split);
+        tail_->setPartitions(ir + split, length - split);
+    } else {
+        head_->setPartitions(ir, length);
+    }
+    reset();
+}
+
+void PartitionedConvolver::reset() {
+    head_->reset();
+    if (tail_) {
+        tail_->reset();
+        std::fill(tail_in_.begin(), tail_in_.end(), 0.0f);
+        std::fill(tail_out_.begin(), tail_out_.end(), 0.0f);
+    }
+    std::fill(block_in_.begin(), block_in_.end(), 0.0f);
+    std::fill(ready_.begin(), ready_.end(), 0.0f);
+    fill_ = 0;
+    tail_fill_ = 0;
+    tail_read_ = 0;
+}
+
+void PartitionedConvolver::process(const float* in, float* out, size_t n) {
+    const size_t B = head_->block();
+    size_t done = 0;
+    while (done < n) {
+        const size_t chunk = std::min(B - fill_, n - done);
+        std::copy(in + done, in + done + chunk, block_in_.begin() + fill_);
+        std::copy(ready_.begin() + fill_, ready_.begin() + fill_ + chunk, out + done);
+        fill_ += chunk;
+        done += chunk;
+        if (fill_ == B) {
+            processBlock();
+            fill_ = 0;
+        }
+    }
+}
+
+void PartitionedConvolver::processBlock() {
+    const size_t B = head_->block();
+    head_->process(*kernels_, block_in_.data(), ready_.data());
+    if (tail_) {
+        std::copy(block_in_.begin(), block_in_.end(), tail_in_.begin() + tail_fill_);
+        tail_fill_ += B;
+        if (tail_fill_ == tail_->block()) {
+            tail_->process(*kernels_, tail_in_.data(), tail_out_.data());
+            tail_fill_ = 0;
+            tail_read_ = 0;
+        }
+        for (size_t t = 0; t < B; t++) ready_[t] += tail_out_[tail_read_ + t];
+        tail_read_ += B;
+    }
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "fft_backend.h"
+#include "node_kernels.h"
+
+struct ConvolverConfig {
+    int block_size = 512;       // Head partition size and the convolver's latency
+    int tail_block_size = 0;    // 0: uniform; else a coarser tail partition size
+    FFTBackend fft_backend = defaultFFTBackend();
+};
+
+// Streaming convolution with a long impulse response (reverbs, room models)
+// at the latency of one short block.
+//
+// Uniformly partitioned overlap-save: the impulse response is cut into
+// partitions of block_size taps whose spectra (FFTs of 2 block_size points)
+// are computed once, and every block of input is transformed once into a
+// frequency-domain delay line holding the spectra of the last P blocks. An
+// output block is then one complex multiply-accumulate of the delay line
+// against the partition spectra through the node kernel table
+// (spectrum_mac) and one inverse FFT, so the cost per sample grows with the
+// number of partitions but not with any transform of the whole response.
+//
+// With a tail_block_size the response is split non-uniformly: the first
+// tail_block_size - block_size taps run at block_size as above, the rest in
+// partitions of tail_block_size, whose delay line advances once every
+// tail_block_size / block_size blocks. The total latency stays block_size
+// and long responses cost far fewer multiply-accumulates, but the tail's
+// transforms land on the block that completes its input, so those blocks
+// take longer than the others.
+//
+// Like StreamingSpectralProcessor, process() takes chunks of any length and
+// emits as many samples, delayed by latency() = block_size. Spectra are
+// kept in float, transforms run in double on the configured FFT backend.
+class PartitionedConvolver {
+public:
+    // Throws std::invalid_argument for a block_size below 1, or a
+    // tail_block_size that is not 0 or a multiple of block_size of at least
+    // twice it
+    explicit PartitionedConvolver(const ConvolverConfig& config = ConvolverConfig(),
+                                  SimdLevel level = defaultSimdLevel());
+    ~PartitionedConvolver();
+
+    PartitionedConvolver(const PartitionedConvolver&) = delete;
+    PartitionedConvolver& operator=(const PartitionedConvolver&) = delete;
+
+    // Replaces the impulse response (length taps; 0 silences the output)
+    // and clears the stream history. Allocates; not for the audio thread.
+    void setImpulseResponse(const float* ir, size_t length);
+
+    // Convolves n samples; in and out may alias
+    void process(const float* in, float* out, size_t n);
+
+    // Clears the stream history; the impulse response is kept
+    void reset();
+
+    size_t impulseLength() const { return ir_length_; }
+    size_t headPartitions() const;
+    size_t tailPartitions() const;
+    int latency() const { return config_.block_size; }
+    const ConvolverConfig& config() const { return config_; }
+    SimdLevel getSimdLevel() const { return kernels_->level; }
+
+private:
+    // Runs the stages on the completed input block
+    void processBlock();
+
+    // Uniform overlap-save partitions of one block size
+    class Stage {
+    public:
+        Stage(int block, FFTBackend backend);
+        ~Stage();
+
+        Stage(const Stage&) = delete;
+        Stage& operator=(const Stage&) = delete;
+
+        // Partition spectra of ir[0, length)
+        void setPartitions(const float* ir, size_t length);
+        // Transforms block() new samples into the delay line and writes the
+        // matching block() output samples
+        void process(const NodeKernels& kernels, const float* in, float* out);
+        void reset();
+
+        size_t block() const { return block_; }
+        size_t partitions() const { return partitions_; }
+
+    private:
+        size_t block_;
+        size_t bins_;
+        size_t stride_;                  // bins_ rounded up to 16 floats, zero padded
+        size_t partitions_ = 0;
+        size_t head_ = 0;                // Delay line slot of the newest block
+        double* real_ = nullptr;         // [2 block]
+        FFTComplex* spectrum_ = nullptr; // [bins]
+        std::unique_ptr<RealFFT> fft_;
+        std::vector<double> input_;      // Last 2 block input samples
+        std::vector<float> filters_;     // [partitions x 2 stride]: re row, then im row
+        std::vector<float> delay_line_;  // [partitions x 2 stride], ring of input spectra
+        std::vector<const float*> taps_; // Delay line slots, newest first
+        std::vector<float> sum_;         // [2 stride]
+    };
+
+    ConvolverConfig config_;
+    const NodeKernels* kernels_;
+    size_t ir_length_ = 0;
+    std::unique_ptr<Stage> head_;
+    std::unique_ptr<Stage> tail_;        // Null for a uniform convolver
+    std::vector<float> block_in_;        // Input of the current block
+    std::vector<float> ready_;           // Output emitted during the current block
+    std::vector<float> tail_in_;         // Tail stage input collected so far
+    std::vector<float> tail_out_;        // Tail stage output being emitted
+    size_t fill_ = 0;                    // Samples received in the current block
+    size_t tail_fill_ = 0;
+    size_t tail_read_ = 0;
+};
@@ -0,0 +1,123 @@
+#include "perf_counters.h"
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace perf_counters {
+
+#if defined(__linux__)
+
+namespace {
+
+struct EventSpec {
+    uint32_t type;
+    uint64_t config;
+};
+
+// Same order as Event
+const EventSpec kEvents[EventCount] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+
+// The calling thread's counter group, opened on first use
+class Group {
+public:
+    Group() {
+        int leader = -1;
+        for (int e = 0; e < EventCount; e++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = kEvents[e].type;
+            attr.config = kEvents[e].config;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                               PERF_FORMAT_TOTAL_TIME_RUNNING;
+            const int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0));
+            if (fd < 0) continue;
+            if (leader < 0) leader = fd;
+            fds_[members_] = fd;
+            slot_[e] = members_++;
+            mask_ |= 1u << e;
+        }
+        leader_ = leader;
+    }
+
+    ~Group() {
+        for (int i = 0; i < members_; i++) close(fds_[i]);
+    }
+
+    Group(const Group&) = delete;
+    Group& operator=(const Group&) = delete;
+
+    bool read(Reading& out) const {
+        if (leader_ < 0) return false;
+        // nr, time_enabled, time_running, then one value per member
+        uint64_t buffer[3 + EventCount];
+        const ssize_t want = static_cast<ssize_t>((3 + members_) * sizeof(uint64_t));
+        if (::read(leader_, buffer, sizeof(buffer)) < want) return false;
+        const uint64_t enabled = buffer[1];
+        const uint64_t running = buffer[2];
+        const bool multiplexed = running > 0 && running < enabled;
+        for (int e = 0; e < EventCount; e++) {
+            if (slot_[e] < 0) {
+                out.value[e] = 0;
+                continue;
+            }
+            const uint64_t raw = buffer[3 + slot_[e]];
+            out.value[e] = multiplexed
+                ? static_cast<uint64_t>(static_cast<double>(raw) * static_cast<double>(enabled) / running)
+                : raw;
+        }
+        return true;
+    }
+
+    unsigned mask() const { return mask_; }
+
+private:
+    int leader_ = -1;
+    int members_ = 0;
+    int fds_[EventCount] = {};
+    int slot_[EventCount] = {-1, -1, -1, -1, -1};
+    unsigned mask_ = 0;
+};
+
+const Group& threadGroup() {
+    static thread_local Group group;
+    return group;
+}
+
+} // namespace
+
+bool readThread(Reading& out) {
+    return threadGroup().read(out);
+}
+
+unsigned availableEvents() {
+    static const unsigned mask = threadGroup().mask();
+    return mask;
+}
+
+#else
+
+bool readThread(Reading&) {
+    return false;
+}
+
+unsigned availableEvents() {
+    return 0;
+}
+
+#endif
+
+} // namespace perf_counters
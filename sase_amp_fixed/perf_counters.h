@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstdint>
+
+// Per-thread hardware event counts from Linux perf_event_open.
+//
+// Each thread that reads opens one counter group for itself on first use
+// (user space only, so perf_event_paranoid up to 2 is enough) and keeps it
+// open for the life of the thread; a read is a single read() of the whole
+// group. Counts are scaled up when the kernel multiplexes the group. Where
+// the kernel refuses the counters (other OS, no PMU in a VM, a stricter
+// paranoid level) reads fail and nothing is counted.
+namespace perf_counters {
+
+enum Event {
+    Cycles = 0,
+    Instructions,
+    L1dMisses,      // L1 data cache read misses
+    LlcMisses,      // Last level cache misses
+    BranchMisses,
+    EventCount
+};
+
+// Left uninitialized so scope timers that never read cost nothing
+struct Reading {
+    uint64_t value[EventCount];
+};
+
+// Current counts of the calling thread; false when no counter is available
+bool readThread(Reading& out);
+
+// Bit (1 << Event) per event the host counts, probed once on the calling
+// thread; 0 when hardware counters are unavailable.
+unsigned availableEvents();
+
+} // namespace perf_counters
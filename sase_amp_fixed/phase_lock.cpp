@@ -0,0 +1,224 @@
+#include "phase_lock.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+size_t ringSlots(size_t capacity) {
+    size_t slots = 1;
+    while (slots < capacity) slots <<= 1;
+    return slots;
+}
+
+int64_t realtimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+constexpr double kTwoPi = 2.0 * M_PI;
+
+} // namespace
+
+PhaseLockLoop::PhaseLockLoop(const PhaseLockConfig& config) : config_(config) {
+    if (!(config.sample_rate > 0.0)) throw std::invalid_argument("phase lock sample rate must be positive");
+    if (!(config.bandwidth_hz > 0.0)) throw std::invalid_argument("phase lock bandwidth must be positive");
+    if (!(config.damping > 0.0)) throw std::invalid_argument("phase lock damping must be positive");
+    if (config.capacity == 0) throw std::invalid_argument("phase lock capacity must be at least 1");
+    if (config.history == 0) throw std::invalid_argument("phase lock history must be at least 1 sample");
+    ring_.resize(ringSlots(config.capacity));
+    pending_.reserve(ring_.size());
+    history_.assign(ringSlots(config.history), 0.0f);
+    const double omega = kTwoPi * config.bandwidth_hz;
+    kp_rate_ = 2.0 * config.damping * omega;
+    ki_rate_ = omega * omega;
+    max_step_ = config.max_slew > 0.0 ? config.max_slew / config.sample_rate : 0.0;
+}
+
+bool PhaseLockLoop::push(const PhaseEstimate& estimate) {
+    const uint64_t write = write_.load(std::memory_order_relaxed);
+    if (write - read_.load(std::memory_order_acquire) >= ring_.size()) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    ring_[write & (ring_.size() - 1)] = estimate;
+    write_.store(write + 1, std::memory_order_release);
+    return true;
+}
+
+bool PhaseLockLoop::push(float phase, uint64_t sample) {
+    PhaseEstimate estimate;
+    estimate.sample = sample;
+    estimate.phase = phase;
+    return push(estimate);
+}
+
+bool PhaseLockLoop::pushAt(float phase, int64_t realtime_ns) {
+    return push(phase, sampleAt(realtime_ns));
+}
+
+uint64_t PhaseLockLoop::sampleAt(int64_t realtime_ns) const {
+    uint64_t sample;
+    int64_t anchor_ns;
+    for (;;) {
+        const uint64_t seq = anchor_seq_.load(std::memory_order_acquire);
+        sample = anchor_sample_.load(std::memory_order_relaxed);
+        anchor_ns = anchor_ns_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if ((seq & 1) == 0 && anchor_seq_.load(std::memory_order_relaxed) == seq) break;
+    }
+    if (anchor_ns == 0) return sample;
+    const double offset = std::round(static_cast<double>(realtime_ns - anchor_ns) * config_.sample_rate * 1e-9);
+    if (offset < 0.0 && -offset >= static_cast<double>(sample)) return 0;
+    return offset < 0.0 ? sample - static_cast<uint64_t>(-offset) : sample + static_cast<uint64_t>(offset);
+}
+
+void PhaseLockLoop::drain() {
+    uint64_t read = read_.load(std::memory_order_relaxed);
+    const uint64_t write = write_.load(std::memory_order_acquire);
+    for (; read != write && pending_.size() < pending_.capacity(); read++) {
+        const PhaseEstimate& estimate = ring_[read & (ring_.size() - 1)];
+        const auto at = std::upper_bound(pending_.begin(), pending_.end(), estimate.sample,
+                                         [](uint64_t sample, const PhaseEstimate& e) { return sample < e.sample; });
+        pending_.insert(at, estimate);
+    }
+    read_.store(read, std::memory_order_release);
+}
+
+void PhaseLockLoop::advance(uint64_t start, float* phase, size_t from, size_t to) {
+    const size_t mask = history_.size() - 1;
+    const double drift = frequency_ / config_.sample_rate;
+    // What max_slew leaves the proportional part once the frequency term
+    // has taken its share
+    const double budget = max_step_ > 0.0 ? std::max(0.0, max_step_ - std::fabs(drift)) : 0.0;
+    for (size_t t = from; t < to; t++) {
+        double step = drift;
+        if (slewing_ != 0.0) {
+            const double slew = max_step_ > 0.0 ? std::min(std::max(slewing_, -budget), budget) : slewing_;
+            slewing_ -= slew;
+            step += slew;
+        }
+        correction_ += step;
+        phase[t] = static_cast<float>(static_cast<double>(phase[t]) + correction_);
+        history_[(start + t) & mask] = phase[t];
+    }
+}
+
+void PhaseLockLoop::update(uint64_t sample, double error) {
+    estimates_.fetch_add(1, std::memory_order_relaxed);
+    if (!acquired_ || std::fabs(error) >= config_.step_threshold) {
+        // First estimate, or the reference stepped: slew the whole error out.
+        // The measured error already holds what was left of the last slew.
+        // Further estimates while it is slewed out are the same step.
+        if (acquired_ && !stepping_) steps_.fetch_add(1, std::memory_order_relaxed);
+        slewing_ = error;
+        acquired_ = stepping_ = true;
+    } else {
+        stepping_ = false;
+        // Proportional-integral loop filter, its gains scaled by the spacing
+        // of the estimates; the proportional part never overshoots the error
+        const double spacing =
+            static_cast<double>(std::max<uint64_t>(sample > last_estimate_ ? sample - last_estimate_ : 0, 1)) /
+            config_.sample_rate;
+        double kp = kp_rate_ * spacing;
+        double ki = ki_rate_ * spacing;
+        if (kp > 1.0) {
+            ki /= kp;
+            kp = 1.0;
+        }
+        slewing_ = kp * error;
+        frequency_ += ki * error;
+        if (config_.max_slew > 0.0) frequency_ = std::min(std::max(frequency_, -config_.max_slew), config_.max_slew);
+    }
+    last_estimate_ = std::max(last_estimate_, sample);
+    mean_square_ += (error * error - mean_square_) / 16.0;
+    error_.store(error, std::memory_order_relaxed);
+}
+
+void PhaseLockLoop::apply(uint64_t start, size_t n, float* phase) {
+    // Publish where this block sits on the wall clock for pushAt
+    const uint64_t seq = anchor_seq_.load(std::memory_order_relaxed);
+    anchor_seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    anchor_sample_.store(start, std::memory_order_relaxed);
+    anchor_ns_.store(realtimeNs(), std::memory_order_relaxed);
+    anchor_seq_.store(seq + 2, std::memory_order_release);
+
+    // A clock that jumped (or the first block) leaves no usable history
+    if (start != history_end_) history_begin_ = history_end_ = start;
+    drain();
+
+    const uint64_t end = start + n;
+    size_t done = 0;
+    size_t due = 0;
+    for (; due < pending_.size() && pending_[due].sample < end; due++) {
+        const PhaseEstimate& estimate = pending_[due];
+        double local;
+        if (estimate.sample >= start) {
+            // Correct up to and including the estimate's own sample
+            const size_t offset = static_cast<size_t>(estimate.sample - start);
+            if (offset >= done) {
+                advance(start, phase, done, offset + 1);
+                done = offset + 1;
+            }
+            local = phase[offset];
+        } else if (estimate.sample >= history_begin_ && history_end_ - estimate.sample <= history_.size()) {
+            local = history_[estimate.sample & (history_.size() - 1)];
+        } else if (history_begin_ == history_end_) {
+            // Nothing to compare against yet: take it on the first sample
+            if (done == 0) {
+                advance(start, phase, 0, 1);
+                done = 1;
+            }
+            local = phase[0];
+        } else {
+            stale_.fetch_add(1, std::memory_order_relaxed);
+            continue;
+        }
+        update(estimate.sample, std::remainder(static_cast<double>(estimate.phase) - local, kTwoPi));
+    }
+    pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(due));
+    advance(start, phase, done, n);
+    history_end_ = end;
+    correction_ = std::remainder(correction_, kTwoPi);
+
+    const double rms = std::sqrt(mean_square_);
+    const bool holdover = acquired_ && end - std::min(end, last_estimate_) > config_.holdover;
+    rms_error_.store(rms, std::memory_order_relaxed);
+    frequency_hz_.store(frequency_ / kTwoPi, std::memory_order_relaxed);
+    correction_out_.store(correction_, std::memory_order_relaxed);
+    holdover_.store(holdover, std::memory_order_relaxed);
+    locked_.store(acquired_ && !holdover && rms < config_.lock_threshold, std::memory_order_relaxed);
+}
+
+void PhaseLockLoop::reset() {
+    read_.store(write_.load(std::memory_order_acquire), std::memory_order_release);
+    pending_.clear();
+    history_begin_ = history_end_ = 0;
+    correction_ = frequency_ = slewing_ = mean_square_ = 0.0;
+    acquired_ = stepping_ = false;
+    last_estimate_ = 0;
+    error_.store(0.0, std::memory_order_relaxed);
+    rms_error_.store(0.0, std::memory_order_relaxed);
+    frequency_hz_.store(0.0, std::memory_order_relaxed);
+    correction_out_.store(0.0, std::memory_order_relaxed);
+    locked_.store(false, std::memory_order_relaxed);
+    holdover_.store(false, std::memory_order_relaxed);
+}
+
+PhaseLockStats PhaseLockLoop::stats() const {
+    PhaseLockStats stats;
+    stats.estimates = estimates_.load(std::memory_order_relaxed);
+    stats.steps = steps_.load(std::memory_order_relaxed);
+    stats.stale = stale_.load(std::memory_order_relaxed);
+    stats.dropped = dropped_.load(std::memory_order_relaxed);
+    stats.error = error_.load(std::memory_order_relaxed);
+    stats.rms_error = rms_error_.load(std::memory_order_relaxed);
+    stats.frequency_hz = frequency_hz_.load(std::memory_order_relaxed);
+    stats.correction = correction_out_.load(std::memory_order_relaxed);
+    stats.locked = locked_.load(std::memory_order_relaxed);
+    stats.holdover = holdover_.load(std::memory_order_relaxed);
+    return stats;
+}
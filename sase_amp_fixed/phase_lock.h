@@ -0,0 +1,143 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct PhaseLockConfig {
+    double sample_rate = 48000.0;
+    // Loop natural frequency and damping of the second-order loop. Keep the
+    // bandwidth well under the rate estimates arrive at (PhaseNet and sync
+    // frames come at tens of Hz).
+    double bandwidth_hz = 0.5;
+    double damping = 0.707;
+    // Fastest the correction may move, rad/s, frequency term included; 0
+    // for no limit
+    double max_slew = 4.0;
+    // An error this large (rad) is taken as a step of the remote phase (a
+    // retarget on the reference node) and slewed out whole, leaving the
+    // frequency term alone
+    double step_threshold = 0.5;
+    // RMS error (rad) under which the loop counts as locked
+    double lock_threshold = 0.05;
+    // Samples without an estimate after which the loop is in holdover: it
+    // keeps its frequency term and stops counting as locked
+    size_t holdover = 96000;
+    size_t capacity = 256;         // Estimates queued between blocks
+    // Samples of corrected phase kept, so an estimate stamped before the
+    // current block is compared against the phase of its own sample
+    size_t history = 16384;
+};
+
+// One remote phase: the reference node's Φ phase (radians) at a sample of
+// the local automation clock
+struct PhaseEstimate {
+    uint64_t sample = 0;
+    float phase = 0.0f;
+};
+
+struct PhaseLockStats {
+    uint64_t estimates = 0;        // Compared against the local phase
+    uint64_t steps = 0;            // Of those, taken as remote steps
+    uint64_t stale = 0;            // Older than the history; dropped
+    uint64_t dropped = 0;          // Found the queue full
+    double error = 0.0;            // Remote minus local phase at the last estimate, rad
+    double rms_error = 0.0;        // Smoothed over about 16 estimates
+    double frequency_hz = 0.0;     // Frequency term of the correction
+    double correction = 0.0;       // Phase added to the last sample, rad (wrapped)
+    bool locked = false;
+    bool holdover = false;
+};
+
+// Native second-order phase-locked loop on the Φ phase of an automation.
+//
+// Control threads push remote phase estimates, from PhaseNet packets, sync
+// frames or the I²S Φ sideband, into a single-producer single-consumer
+// ring, stamped with a sample of the automation clock or with a wall clock
+// time the loop maps onto it. Attached to a ParameterAutomation, the loop
+// runs inside render(): estimates due in the block are compared against
+// the corrected phase at their own sample, feed a proportional-integral
+// loop filter, and the correction is added to the block's phase curve
+// sample by sample, its proportional part slewed at no more than max_slew,
+// so the envelope never steps. The frequency term carries on between
+// estimates and through holdover. Nothing on the audio side locks or
+// allocates.
+class PhaseLockLoop {
+public:
+    // Throws std::invalid_argument for a non-positive sample rate,
+    // bandwidth or damping, or a zero capacity or history
+    explicit PhaseLockLoop(const PhaseLockConfig& config = PhaseLockConfig());
+
+    PhaseLockLoop(const PhaseLockLoop&) = delete;
+    PhaseLockLoop& operator=(const PhaseLockLoop&) = delete;
+
+    // Producer side, one thread at a time. Returns false, and counts a drop,
+    // when the ring is full.
+    bool push(const PhaseEstimate& estimate);
+    bool push(float phase, uint64_t sample);
+    // Estimate stamped with CLOCK_REALTIME ns (local clock: subtract the
+    // ClockSync offset from a remote stamp), placed on the sample the last
+    // block's start maps it to. Before the first block it lands on the first.
+    bool pushAt(float phase, int64_t realtime_ns);
+    // Automation sample realtime_ns maps to
+    uint64_t sampleAt(int64_t realtime_ns) const;
+
+    // Audio side: adds the correction of samples [start, start + n) to
+    // phase, taking the estimates due in them
+    void apply(uint64_t start, size_t n, float* phase);
+    // Drops the loop state and queued estimates; audio side, or while no
+    // block runs
+    void reset();
+
+    // Readable from any thread
+    PhaseLockStats stats() const;
+    // Phase added to the last sample applied, rad (wrapped)
+    double correction() const { return correction_out_.load(std::memory_order_relaxed); }
+    const PhaseLockConfig& config() const { return config_; }
+
+private:
+    // Moves ring estimates into pending_ in time order while there is room
+    void drain();
+    // Corrects phase[from, to) of the block starting at start
+    void advance(uint64_t start, float* phase, size_t from, size_t to);
+    // Loop filter step for one estimate, error in rad
+    void update(uint64_t sample, double error);
+
+    PhaseLockConfig config_;
+    std::vector<PhaseEstimate> ring_;           // Power-of-two slots
+    alignas(64) std::atomic<uint64_t> write_{0};
+    alignas(64) std::atomic<uint64_t> read_{0};
+    alignas(64) std::atomic<uint64_t> dropped_{0};
+
+    // Block start on both clocks, published under a sequence count
+    alignas(64) std::atomic<uint64_t> anchor_seq_{0};
+    std::atomic<uint64_t> anchor_sample_{0};
+    std::atomic<int64_t> anchor_ns_{0};
+
+    std::vector<PhaseEstimate> pending_;        // Time order, capacity reserved
+    std::vector<float> history_;                // Corrected phase by sample, power-of-two slots
+    uint64_t history_end_ = 0;                  // One past the last sample stored
+    uint64_t history_begin_ = 0;                // First sample stored since reset
+
+    double kp_rate_;                            // 2ζωn, per second of estimate spacing
+    double ki_rate_;                            // ωn², per second of spacing
+    double max_step_;                           // max_slew per sample, 0 for none
+    double correction_ = 0.0;                   // rad
+    double frequency_ = 0.0;                    // rad/s
+    double slewing_ = 0.0;                      // Proportional correction still to apply, rad
+    double mean_square_ = 0.0;
+    bool acquired_ = false;
+    bool stepping_ = false;                     // Slewing out a step or the acquisition
+    uint64_t last_estimate_ = 0;                // Sample of the last estimate taken
+
+    std::atomic<uint64_t> estimates_{0};
+    std::atomic<uint64_t> steps_{0};
+    std::atomic<uint64_t> stale_{0};
+    std::atomic<double> error_{0.0};
+    std::atomic<double> rms_error_{0.0};
+    std::atomic<double> frequency_hz_{0.0};
+    std::atomic<double> correction_out_{0.0};
+    std::atomic<bool> locked_{false};
+    std::atomic<bool> holdover_{false};
+};
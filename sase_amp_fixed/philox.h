@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel Random
+// Numbers: As Easy as 1, 2, 3", SC'11).
+//
+// A keyed bijection of a 128-bit counter: any block of the sequence is
+// computed directly from its counter, with no state carried between calls, so
+// workers can fill disjoint ranges in any order and still produce the same
+// stream. Written as plain 32 x 32 -> 64 multiplies so loops over independent
+// counters vectorize on every target.
+namespace philox {
+
+constexpr uint32_t kMul0 = 0xD2511F53u;
+constexpr uint32_t kMul1 = 0xCD9E8D57u;
+constexpr uint32_t kWeyl0 = 0x9E3779B9u;
+constexpr uint32_t kWeyl1 = 0xBB67AE85u;
+constexpr int kRounds = 10;
+
+// One round on a counter held in four words
+inline void round(uint32_t& c0, uint32_t& c1, uint32_t& c2, uint32_t& c3, uint32_t key0, uint32_t key1) {
+    const uint64_t p0 = static_cast<uint64_t>(kMul0) * c0;
+    const uint64_t p1 = static_cast<uint64_t>(kMul1) * c2;
+    c0 = static_cast<uint32_t>(p1 >> 32) ^ c1 ^ key0;
+    c1 = static_cast<uint32_t>(p1);
+    c2 = static_cast<uint32_t>(p0 >> 32) ^ c3 ^ key1;
+    c3 = static_cast<uint32_t>(p0);
+}
+
+// In-place: ctr becomes the four output words for counter ctr under key
+inline void block(uint32_t ctr[4], uint32_t key0, uint32_t key1) {
+    for (int r = 0; r < kRounds; r++) {
+        round(ctr[0], ctr[1], ctr[2], ctr[3], key0 + r * kWeyl0, key1 + r * kWeyl1);
+    }
+}
+
+} // namespace philox
@@ -0,0 +1,106 @@
+#include "pipeline_trace.h"
+#include <algorithm>
+
+const char* traceHopName(TraceHop hop) {
+    switch (hop) {
+        case TraceHop::Sensor: return "sensor";
+        case TraceHop::Engine: return "dase";
+        case TraceHop::HybridNode: return "hybrid_node";
+        case TraceHop::I2s: return "i2s";
+        case TraceHop::WebSocket: return "websocket";
+    }
+    return "unknown";
+}
+
+void TraceClock::anchor(int64_t local_ns, int64_t reference_ns) {
+    offset_ns_ = local_ns - reference_ns;
+    measured_at_ns_ = reference_ns;
+    drift_ppm_ = 0.0;
+    error_bound_ns_ = 0;
+    synchronized_ = true;
+}
+
+void TraceClock::anchorMicros(uint32_t local_us, int64_t reference_ns) {
+    anchor_us_ = local_us;
+    anchor_ns_ = reference_ns;
+    error_bound_ns_ = 1000;   // The tick's resolution
+    synchronized_ = true;
+}
+
+void TraceClock::setOffset(const ClockOffsetEstimate& estimate) {
+    if (!estimate.valid) return;
+    offset_ns_ = estimate.offset_ns;
+    measured_at_ns_ = estimate.measured_at_ns;
+    drift_ppm_ = estimate.drift_ppm;
+    error_bound_ns_ = estimate.error_bound_ns;
+    synchronized_ = true;
+}
+
+int64_t TraceClock::toReference(int64_t local_ns) const {
+    // The offset moves along the drift line; evaluating it at the stamp's
+    // uncorrected time is off by drift times the offset, far below a ns
+    const int64_t rough = local_ns - offset_ns_;
+    const double drift = drift_ppm_ * 1e-6 * static_cast<double>(rough - measured_at_ns_);
+    return rough - static_cast<int64_t>(drift);
+}
+
+int64_t TraceClock::fromMicros(uint32_t local_us) const {
+    const int32_t since = static_cast<int32_t>(local_us - anchor_us_);
+    return anchor_ns_ + static_cast<int64_t>(since) * 1000;
+}
+
+int64_t PipelineTrace::hopNs(TraceHop hop) const {
+    const size_t h = static_cast<size_t>(hop);
+    if (hop_end_ns[h] == 0) return -1;
+    int64_t start = origin_ns;
+    for (size_t before = h; before-- > 0;) {
+        if (hop_end_ns[before] != 0) {
+            start = hop_end_ns[before];
+            break;
+        }
+    }
+    return hop_end_ns[h] - start;
+}
+
+int64_t PipelineTrace::endToEndNs() const {
+    for (size_t h = kTraceHopCount; h-- > 0;) {
+        if (hop_end_ns[h] != 0) return hop_end_ns[h] - origin_ns;
+    }
+    return 0;
+}
+
+double TraceBreakdownSnapshot::share(TraceHop hop) const {
+    if (end_to_end.count == 0 || end_to_end.mean_ns <= 0.0) return 0.0;
+    return hops[static_cast<size_t>(hop)].mean_ns / end_to_end.mean_ns;
+}
+
+void TraceBreakdown::record(const PipelineTrace& trace) {
+    for (size_t h = 0; h < kTraceHopCount; h++) {
+        if (trace.hop_end_ns[h] != 0) recordHop(static_cast<TraceHop>(h), trace.hopNs(static_cast<TraceHop>(h)));
+    }
+    recordEndToEnd(trace.endToEndNs());
+}
+
+void TraceBreakdown::recordHop(TraceHop hop, int64_t ns) {
+    if (ns < 0) skewed_.fetch_add(1, std::memory_order_relaxed);
+    hops_[static_cast<size_t>(hop)].record(static_cast<uint64_t>(std::max<int64_t>(ns, 0)));
+}
+
+void TraceBreakdown::recordEndToEnd(int64_t ns) {
+    if (ns < 0) skewed_.fetch_add(1, std::memory_order_relaxed);
+    end_to_end_.record(static_cast<uint64_t>(std::max<int64_t>(ns, 0)));
+}
+
+TraceBreakdownSnapshot TraceBreakdown::snapshot() const {
+    TraceBreakdownSnapshot s;
+    for (size_t h = 0; h < kTraceHopCount; h++) s.hops[h] = hops_[h].snapshot();
+    s.end_to_end = end_to_end_.snapshot();
+    s.skewed = skewed_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void TraceBreakdown::reset() {
+    for (LatencyHistogram& h : hops_) h.reset();
+    end_to_end_.reset();
+    skewed_.store(0, std::memory_order_relaxed);
+}
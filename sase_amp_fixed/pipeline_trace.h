@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "clock_sync.h"
+#include "latency_histogram.h"
+
+// Hops of one traced block, in pipeline order. Each ends when the tier
+// hands the block on: the sensor hop at the start of the engine block
+// (so it holds the Φ sample's age), the I²S hop at the frame's commit and
+// the WebSocket hop at the send of the metrics frame.
+enum class TraceHop : uint8_t { Sensor = 0, Engine = 1, HybridNode = 2, I2s = 3, WebSocket = 4 };
+constexpr size_t kTraceHopCount = 5;
+
+const char* traceHopName(TraceHop hop);
+
+// The clock every trace stamp is compared on: CLOCK_REALTIME in ns, the one
+// ClockSyncClient measures remote offsets against
+inline int64_t traceNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+// Trace ID of a block: the emitting tier in the top 16 bits, its block
+// sequence below. The low 32 bits are what fits the I²S metrics packet's
+// sequence field, so a peer can match packets to traces.
+inline uint64_t makeTraceId(uint16_t source, uint64_t sequence) {
+    return (static_cast<uint64_t>(source) << 48) | (sequence & ((uint64_t{1} << 48) - 1));
+}
+
+// Maps one tier's timestamps onto the trace clock.
+//
+// Clocks in the same process or board (steady_clock, the sensor's wrapping
+// µs ticks) are tied to it by one pair of readings taken together, anchor()
+// or anchorMicros(); re-anchoring every few seconds keeps their drift out.
+// Remote clocks take the offset a ClockSyncClient measured, carried along
+// its drift line. Until either is set a stamp passes through unchanged.
+class TraceClock {
+public:
+    // local_ns on this clock and reference_ns on the trace clock, read together
+    void anchor(int64_t local_ns, int64_t reference_ns);
+    // Same for a µs counter that wraps at 2^32; stamps are then unwrapped
+    // around the anchor, good for 35 minutes either side of it
+    void anchorMicros(uint32_t local_us, int64_t reference_ns);
+    // Estimate of this (remote) clock minus the trace clock
+    void setOffset(const ClockOffsetEstimate& estimate);
+
+    int64_t toReference(int64_t local_ns) const;
+    int64_t fromMicros(uint32_t local_us) const;
+
+    bool synchronized() const { return synchronized_; }
+    int64_t errorBoundNs() const { return error_bound_ns_; }
+
+private:
+    int64_t offset_ns_ = 0;        // Local minus reference at measured_at_ns_
+    int64_t measured_at_ns_ = 0;   // Reference time of offset_ns_
+    double drift_ppm_ = 0.0;
+    uint32_t anchor_us_ = 0;
+    int64_t anchor_ns_ = 0;        // Reference time of anchor_us_
+    int64_t error_bound_ns_ = 0;
+    bool synchronized_ = false;
+};
+
+// Stamps of one block on the trace clock: where it started (the Φ sample
+// it was built from, or its release when there was none) and where each
+// hop it went through ended; 0 for hops it skipped
+struct PipelineTrace {
+    uint64_t trace_id = 0;
+    int64_t origin_ns = 0;
+    int64_t hop_end_ns[kTraceHopCount] = {};
+
+    void stamp(TraceHop hop, int64_t ns) { hop_end_ns[static_cast<size_t>(hop)] = ns; }
+    // Length of hop: from the end of the last stamped hop before it, or the
+    // origin; -1 when the hop was skipped (and below 0 when clocks disagree)
+    int64_t hopNs(TraceHop hop) const;
+    // Origin to the last stamped hop
+    int64_t endToEndNs() const;
+};
+
+struct TraceBreakdownSnapshot {
+    LatencySnapshot hops[kTraceHopCount];
+    LatencySnapshot end_to_end;
+    // Hops that came out negative, recorded as 0: the tiers' clocks are off
+    // by more than the hop takes
+    uint64_t skewed = 0;
+
+    // Fraction of the mean end-to-end latency spent in hop
+    double share(TraceHop hop) const;
+};
+
+// Per-hop latency distributions over traced blocks, showing where the
+// end-to-end latency goes. Recording is lock-free (LatencyHistogram) and
+// may come from several threads or, with recordHop(), from a tier that
+// only sees its own hop.
+class TraceBreakdown {
+public:
+    void record(const PipelineTrace& trace);
+    void recordHop(TraceHop hop, int64_t ns);
+    void recordEndToEnd(int64_t ns);
+
+    TraceBreakdownSnapshot snapshot() const;
+    void reset();
+
+private:
+    LatencyHistogram hops_[kTraceHopCount];
+    LatencyHistogram end_to_end_;
+    std::atomic<uint64_t> skewed_{0};
+};
@@ -1,14 +1,852 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
 #include <pybind11/numpy.h>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
 #include "analog_universal_node_engine_avx2.h"
+#include "async_block.h"
+#include "async_pipeline.h"
+#include "audio_file.h"
+#include "audio_host.h"
+#include "batch_render.h"
+#include "chroma_analyzer.h"
+#include "chromatic_color.h"
+#include "chromatic_stream.h"
+#include "clock_sync.h"
+#include "correlation_kernel.h"
+#include "dlpack_export.h"
+#include "flight_recorder.h"
+#include "engine_group.h"
+#include "fft_plan_cache.h"
+#include "forecast_kernel.h"
+#include "frequency_response.h"
+#include "grid_shard.h"
+#include "ici_kernel.h"
+#include "metrics_codec.h"
+#include "offline_replay.h"
+#include "openmetrics.h"
+#include "output_publisher.h"
+#include "output_stage.h"
+#include "parameter_automation.h"
+#include "parameter_switch.h"
+#include "partitioned_convolver.h"
+#include "phase_lock.h"
+#include "pipeline_trace.h"
+#include "session_manager.h"
+#include "session_store.h"
+#include "shared_state.h"
+#include "spectral_stream.h"
+#include "stage_graph.h"
+#include "timeline_trace.h"
+#include "phi_packet.h"
+#include "dsp_core.h"
 
 namespace py = pybind11;
 
+// Sequence-protocol view over an engine's node bank, so `engine.nodes[i]`
+// keeps working without materializing a vector of node objects.
+struct EngineNodeList {
+    AnalogCellularEngineAVX2* engine;
+};
+
+// State or parameter column of a node bank
+enum class NodeStateColumn {
+    Output = 0,
+    IntegratorState = 1,
+    FeedbackGain = 2,
+    PreviousInput = 3,
+    InputGain = 4,
+    TimeConstant = 5,
+    ClampLow = 6,
+    ClampHigh = 7,
+    SpectralMix = 8
+};
+
+// One column of an engine's node bank, exported through the buffer protocol
+// so numpy.asarray(engine.outputs) aliases the bank without a copy. Arrays
+// taken before load_state keep pointing at the replaced columns.
+template <typename Bank>
+struct NodeColumnView {
+    Bank* bank;
+    NodeStateColumn column;
+    bool writeable;
+};
+
+// One column of the device copy of an engine's node bank, exported through
+// DLPack only (the Cuda backend)
+struct DeviceColumnView {
+    AnalogCellularEngineAVX2* engine;
+    NodeStateColumn column;
+};
+
+// One column of another process's shared engine state, read-only. The view
+// keeps the mapping alive; pair reads with begin_read()/validate().
+struct SharedColumnView {
+    std::shared_ptr<SharedStateReader> reader;
+    NodeStateColumn column;
+};
+
+// One column of a mapped session file, read-only; the view keeps the
+// mapping alive
+struct SessionColumnView {
+    std::shared_ptr<SessionStore> store;
+    size_t column;
+};
+
+namespace {
+
+// Native work run without the GIL under the engine's call mutex: other
+// Python threads keep running, but calls into the same engine queue up. The
+// GIL goes first, so a thread waiting for the mutex never blocks the
+// interpreter.
+template <typename Engine>
+class EngineCall {
+public:
+    explicit EngineCall(const Engine& engine) : lock_(engine.callMutex()) {}
+
+private:
+    py::gil_scoped_release release_;
+    std::unique_lock<std::mutex> lock_;
+};
+
+// Binds a long-running engine method to run as an EngineCall
+template <typename Engine, typename R, typename... Args>
+auto released(R (Engine::*method)(Args...)) {
+    return [method](Engine& self, Args... args) -> R {
+        EngineCall<Engine> call(self);
+        return (self.*method)(std::forward<Args>(args)...);
+    };
+}
+
+template <typename Engine, typename R, typename... Args>
+auto released(R (Engine::*method)(Args...) const) {
+    return [method](const Engine& self, Args... args) -> R {
+        EngineCall<Engine> call(self);
+        return (self.*method)(std::forward<Args>(args)...);
+    };
+}
+
+template <typename Bank>
+auto nodeColumnData(Bank& bank, NodeStateColumn column) -> decltype(bank.current_output) {
+    switch (column) {
+        case NodeStateColumn::Output: return bank.current_output;
+        case NodeStateColumn::IntegratorState: return bank.integrator_state;
+        case NodeStateColumn::FeedbackGain: return bank.feedback_gain;
+        case NodeStateColumn::PreviousInput: return bank.previous_input;
+        case NodeStateColumn::InputGain: return bank.input_gain;
+        case NodeStateColumn::TimeConstant: return bank.time_constant;
+        case NodeStateColumn::ClampLow: return bank.clamp_low;
+        case NodeStateColumn::ClampHigh: return bank.clamp_high;
+        case NodeStateColumn::SpectralMix: return bank.spectral_mix;
+    }
+    return nullptr;
+}
+
+template <typename Bank>
+py::buffer_info nodeColumnBuffer(NodeColumnView<Bank>& view) {
+    using Scalar = std::remove_pointer_t<decltype(view.bank->current_output)>;
+    Scalar* data = nodeColumnData(*view.bank, view.column);
+    return py::buffer_info(data, static_cast<py::ssize_t>(sizeof(Scalar)), py::format_descriptor<Scalar>::format(), 1,
+                           {static_cast<py::ssize_t>(view.bank->size())},
+                           {static_cast<py::ssize_t>(sizeof(Scalar))}, !view.writeable);
+}
+
+// DLPack export: the capsule's tensor holds a reference to the exporting
+// view, which keeps the engine alive. Like the buffer protocol's arrays,
+// tensors dangle once load_state replaces the columns.
+void releaseDLPackOwner(void* owner) {
+    if (!Py_IsInitialized()) return;
+    py::gil_scoped_acquire gil;
+    Py_DECREF(static_cast<PyObject*>(owner));
+}
+
+// Capsules a consumer never took (it renames the ones it does) free their
+// tensor
+template <typename Managed>
+void freeUnusedDLPackCapsule(PyObject* capsule) {
+    const char* name = std::is_same<Managed, DLManagedTensor>::value ? "dltensor" : "dltensor_versioned";
+    if (!PyCapsule_IsValid(capsule, name)) return;
+    PyObject *type, *value, *traceback;
+    PyErr_Fetch(&type, &value, &traceback);
+    auto* managed = static_cast<Managed*>(PyCapsule_GetPointer(capsule, name));
+    if (managed->deleter) managed->deleter(managed);
+    PyErr_Restore(type, value, traceback);
+}
+
+template <typename Managed>
+py::object dlpackCapsule(Managed* managed, py::handle owner) {
+    const char* name = std::is_same<Managed, DLManagedTensor>::value ? "dltensor" : "dltensor_versioned";
+    owner.inc_ref();
+    PyObject* capsule = PyCapsule_New(managed, name, &freeUnusedDLPackCapsule<Managed>);
+    if (!capsule) {
+        managed->deleter(managed);
+        throw py::error_already_set();
+    }
+    return py::reinterpret_steal<py::object>(capsule);
+}
+
+// __dlpack__ of buffer, owned by owner. Consumers asking for DLPack 1.0
+// (max_version) get a versioned tensor, which can flag read-only buffers;
+// older ones only get writeable buffers. Nothing is ever copied, so
+// copy=True or another dl_device raises BufferError. The engine finishes
+// its device work within each call, so stream needs no synchronization.
+py::object exportDLPack(py::handle owner, const DLPackBuffer& buffer, const py::object& max_version,
+                        const py::object& dl_device, const py::object& copy) {
+    if (!copy.is_none() && copy.cast<bool>()) {
+        throw py::buffer_error("engine buffers are exported without copying");
+    }
+    if (!dl_device.is_none()) {
+        const py::tuple device = dl_device.cast<py::tuple>();
+        if (device.size() != 2 || device[0].cast<int>() != static_cast<int>(buffer.device.device_type) ||
+            device[1].cast<int>() != buffer.device.device_id) {
+            throw py::buffer_error("engine buffer lives on another device");
+        }
+    }
+    const bool versioned = !max_version.is_none() && max_version.cast<py::tuple>()[0].cast<int>() >= 1;
+    if (versioned) {
+        return dlpackCapsule(newDLPackTensorVersioned(buffer, owner.ptr(), &releaseDLPackOwner), owner);
+    }
+    if (buffer.read_only) {
+        throw py::buffer_error("read-only view needs a DLPack 1.0 consumer; older ones take a writeable "
+                               "node_column(column, True)");
+    }
+    return dlpackCapsule(newDLPackTensor(buffer, owner.ptr(), &releaseDLPackOwner), owner);
+}
+
+// Binds __dlpack__ and __dlpack_device__ on a view class; buffer(view)
+// describes the view's memory
+template <typename View, typename Class, typename Describe>
+void defDLPack(Class& cls, Describe buffer) {
+    cls.def("__dlpack__", [buffer](py::object self, const py::object& stream, const py::object& max_version,
+                                   const py::object& dl_device, const py::object& copy) {
+                 (void)stream;
+                 return exportDLPack(self, buffer(self.cast<View&>()), max_version, dl_device, copy);
+             },
+             "DLPack capsule aliasing the view's memory, e.g. torch.from_dlpack(view)",
+             py::arg("stream") = py::none(), py::arg("max_version") = py::none(),
+             py::arg("dl_device") = py::none(), py::arg("copy") = py::none())
+        .def("__dlpack_device__", [buffer](View& view) {
+                 const DLDevice device = buffer(view).device;
+                 return py::make_tuple(static_cast<int>(device.device_type), device.device_id);
+             });
+}
+
+template <typename Bank>
+void bindNodeColumn(py::module_& m, const char* name) {
+    using Scalar = std::remove_pointer_t<decltype(std::declval<Bank>().current_output)>;
+    py::class_<NodeColumnView<Bank>> cls(m, name, py::buffer_protocol(),
+        "Zero-copy view of one node state column; wrap with numpy.asarray() or torch.from_dlpack()");
+    defDLPack<NodeColumnView<Bank>>(cls, [](NodeColumnView<Bank>& view) {
+        DLPackBuffer buffer;
+        buffer.data = nodeColumnData(*view.bank, view.column);
+        buffer.dtype = DLPackBuffer::dtypeOf<Scalar>();
+        buffer.shape[0] = static_cast<int64_t>(view.bank->size());
+        buffer.read_only = !view.writeable;
+        return buffer;
+    });
+    cls.def_buffer(&nodeColumnBuffer<Bank>)
+        .def("__len__", [](const NodeColumnView<Bank>& view) { return view.bank->size(); })
+        .def_property_readonly("column", [](const NodeColumnView<Bank>& view) { return view.column; })
+        .def_property_readonly("writeable", [](const NodeColumnView<Bank>& view) { return view.writeable; });
+}
+
+// Read-only column properties plus node_column(column, writeable) on an engine class
+template <typename Engine, typename Class>
+void defNodeColumns(Class& cls) {
+    using Bank = decltype(Engine::bank);
+    // Device-resident state comes back before a view aliases the columns
+    auto sync = [](Engine& engine) {
+        if constexpr (std::is_same<Engine, AnalogCellularEngineAVX2>::value) engine.syncComputeBackend();
+    };
+    auto column = [sync](NodeStateColumn c) {
+        return [c, sync](Engine& engine) {
+            sync(engine);
+            return NodeColumnView<Bank>{&engine.bank, c, false};
+        };
+    };
+    cls.def_property_readonly("outputs", column(NodeStateColumn::Output), py::keep_alive<0, 1>(),
+            "Read-only view of every node's current output")
+        .def_property_readonly("integrator_states", column(NodeStateColumn::IntegratorState), py::keep_alive<0, 1>(),
+            "Read-only view of every node's integrator state")
+        .def_property_readonly("feedback_gains", column(NodeStateColumn::FeedbackGain), py::keep_alive<0, 1>(),
+            "Read-only view of every node's feedback gain")
+        .def_property_readonly("previous_inputs", column(NodeStateColumn::PreviousInput), py::keep_alive<0, 1>(),
+            "Read-only view of every node's previous input")
+        .def_property_readonly("input_gains", column(NodeStateColumn::InputGain), py::keep_alive<0, 1>(),
+            "Read-only view of every node's input gain")
+        .def_property_readonly("time_constants", column(NodeStateColumn::TimeConstant), py::keep_alive<0, 1>(),
+            "Read-only view of every node's integrator time constant")
+        .def_property_readonly("clamp_lows", column(NodeStateColumn::ClampLow), py::keep_alive<0, 1>(),
+            "Read-only view of every node's lower output bound")
+        .def_property_readonly("clamp_highs", column(NodeStateColumn::ClampHigh), py::keep_alive<0, 1>(),
+            "Read-only view of every node's upper output bound")
+        .def_property_readonly("spectral_mixes", column(NodeStateColumn::SpectralMix), py::keep_alive<0, 1>(),
+            "Read-only view of every node's spectral boost mix")
+        .def("node_column", [sync](Engine& engine, NodeStateColumn c, bool writeable) {
+                 sync(engine);
+                 return NodeColumnView<Bank>{&engine.bank, c, writeable};
+             }, py::keep_alive<0, 1>(),
+             "View of one state or parameter column; writes through a writeable view change the nodes, "
+             "e.g. numpy.asarray(engine.node_column(NodeStateColumn.TIME_CONSTANT, True))[:] = taus",
+             py::arg("column"), py::arg("writeable") = false);
+}
+
+// Input blocks: float32 C-contiguous arrays are used in place, anything else
+// is converted once per call
+template <typename T>
+using InputBlock = py::array_t<T, py::array::c_style | py::array::forcecast>;
+
+// Optional stream of n samples (None gives nullptr); holder owns a converted copy
+template <typename T>
+const T* optionalBlock(const py::object& block, size_t n, const char* what, InputBlock<T>& holder) {
+    if (block.is_none()) return nullptr;
+    holder = block.cast<InputBlock<T>>();
+    if (static_cast<size_t>(holder.size()) != n) {
+        throw std::invalid_argument(std::string(what) + " block length differs from input");
+    }
+    return holder.data();
+}
+
+// Caller-provided output, written in place. It is never converted: results
+// written into a converted copy would be lost.
+template <typename T>
+T* outputBlock(const py::object& out, size_t size) {
+    if (!py::isinstance<py::array_t<T>>(out)) {
+        throw std::invalid_argument(std::string("out must be a numpy array of ") +
+                                    (std::is_same<T, float>::value    ? "float32"
+                                     : std::is_same<T, double>::value ? "float64"
+                                                                      : "uint8"));
+    }
+    py::array array = py::reinterpret_borrow<py::array>(out);
+    if (!(array.flags() & py::array::c_style) || !array.writeable()) {
+        throw std::invalid_argument("out must be C-contiguous and writeable");
+    }
+    if (static_cast<size_t>(array.size()) != size) {
+        throw std::invalid_argument("out holds " + std::to_string(array.size()) + " values, block needs " +
+                                    std::to_string(size));
+    }
+    return static_cast<T*>(array.mutable_data());
+}
+
+// Engine processBlock on NumPy blocks. Outputs go into out when given,
+// otherwise into a new [num_nodes x n] array unless return_outputs is false.
+template <typename Engine>
+py::object processEngineBlock(Engine& engine, const InputBlock<float>& input, const py::object& control,
+                              const py::object& aux, py::object out, bool return_outputs) {
+    const size_t n = static_cast<size_t>(input.size());
+    InputBlock<float> control_holder, aux_holder;
+    const float* control_data = optionalBlock(control, n, "control", control_holder);
+    const float* aux_data = optionalBlock(aux, n, "aux", aux_holder);
+    float* out_data = nullptr;
+    if (!out.is_none()) {
+        out_data = outputBlock<float>(out, engine.getNodeCount() * n);
+    } else if (return_outputs) {
+        out = py::array_t<float>({static_cast<py::ssize_t>(engine.getNodeCount()), static_cast<py::ssize_t>(n)});
+        out_data = static_cast<float*>(py::reinterpret_borrow<py::array>(out).mutable_data());
+    }
+    {
+        EngineCall<Engine> call(engine);
+        engine.processBlock(input.data(), control_data, aux_data, out_data, n);
+    }
+    return out_data != nullptr ? out : py::none();
+}
+
+// [num_nodes x n] view of the engine's arena output block, to pass as
+// process_block's out without a per-block allocation. The view keeps the
+// engine alive but not the arena: it dangles after release_arena or the
+// next reserve_arena.
+template <typename Engine>
+py::array arenaOutputView(py::object self, size_t n) {
+    Engine& engine = self.cast<Engine&>();
+    if (engine.getArenaOutput() == nullptr) throw std::runtime_error("engine has no arena output block");
+    if (n > engine.getArenaMaxBlock()) throw std::invalid_argument("block is longer than the arena's max_block");
+    return py::array_t<float>({static_cast<py::ssize_t>(engine.getNodeCount()), static_cast<py::ssize_t>(n)},
+                              engine.getArenaOutput(), self);
+}
+
+// Frequency-domain filter of a 1-D block or of the rows of a 2-D
+// [channels x N] array, in one engine call. NumPy float32/float64 arrays are
+// filtered in place and must be C-contiguous and writeable; other sequences
+// are converted to a new float64 array. Returns the filtered array.
+py::object processFrequencyDomainBlock(AnalogCellularEngineAVX2& engine, py::object block) {
+    if (!py::isinstance<py::array>(block)) {
+        block = py::array_t<double, py::array::c_style | py::array::forcecast>::ensure(block);
+        if (!block) throw py::error_already_set();
+    }
+    py::array array = py::reinterpret_borrow<py::array>(block);
+    const bool is_double = py::isinstance<py::array_t<double>>(array);
+    if (!is_double && !py::isinstance<py::array_t<float>>(array)) {
+        throw std::invalid_argument("signal_block must be a float32 or float64 array");
+    }
+    if (array.ndim() != 1 && array.ndim() != 2) {
+        throw std::invalid_argument("signal_block must be 1-D or [channels, N]");
+    }
+    if (!(array.flags() & py::array::c_style) || !array.writeable()) {
+        throw std::invalid_argument("signal_block must be C-contiguous and writeable");
+    }
+    const size_t channels = array.ndim() == 2 ? static_cast<size_t>(array.shape(0)) : 1;
+    const size_t n = static_cast<size_t>(array.shape(array.ndim() - 1));
+    void* data = array.mutable_data();
+    {
+        EngineCall<AnalogCellularEngineAVX2> call(engine);
+        if (is_double) {
+            engine.processBlockFrequencyDomain(static_cast<double*>(data), n, channels);
+        } else {
+            engine.processBlockFrequencyDomain(static_cast<float*>(data), n, channels);
+        }
+    }
+    return block;
+}
+
+SharedStateReader::Column sharedColumn(NodeStateColumn column) {
+    switch (column) {
+        case NodeStateColumn::Output: return SharedStateReader::CurrentOutput;
+        case NodeStateColumn::IntegratorState: return SharedStateReader::IntegratorState;
+        case NodeStateColumn::FeedbackGain: return SharedStateReader::FeedbackGain;
+        case NodeStateColumn::PreviousInput: return SharedStateReader::PreviousInput;
+        case NodeStateColumn::InputGain: return SharedStateReader::InputGain;
+        case NodeStateColumn::TimeConstant: return SharedStateReader::TimeConstant;
+        case NodeStateColumn::ClampLow: return SharedStateReader::ClampLow;
+        case NodeStateColumn::ClampHigh: return SharedStateReader::ClampHigh;
+        case NodeStateColumn::SpectralMix: return SharedStateReader::SpectralMix;
+    }
+    return SharedStateReader::CurrentOutput;
+}
+
+py::buffer_info sharedColumnBuffer(SharedColumnView& view) {
+    const SharedStateReader& reader = *view.reader;
+    const auto itemsize = static_cast<py::ssize_t>(reader.scalarBytes());
+    const std::string format = reader.scalarBytes() == sizeof(float) ? py::format_descriptor<float>::format()
+                                                                     : py::format_descriptor<double>::format();
+    return py::buffer_info(const_cast<void*>(reader.column(sharedColumn(view.column))), itemsize, format, 1,
+                           {static_cast<py::ssize_t>(reader.nodeCount())}, {itemsize}, true);
+}
+
+py::buffer_info sessionColumnBuffer(SessionColumnView& view) {
+    return py::buffer_info(const_cast<double*>(view.store->column(view.column)),
+                           static_cast<py::ssize_t>(sizeof(double)), py::format_descriptor<double>::format(), 1,
+                           {static_cast<py::ssize_t>(view.store->sampleCount())},
+                           {static_cast<py::ssize_t>(sizeof(double))}, true);
+}
+
+// Checked copy of a shared column into out (an array of the segment's
+// precision) or into a new array
+template <typename T>
+py::object readSharedColumn(const SharedStateReader& reader, NodeStateColumn column, py::object out) {
+    T* data = out.is_none() ? nullptr : outputBlock<T>(out, reader.nodeCount());
+    if (!data) {
+        out = py::array_t<T>(static_cast<py::ssize_t>(reader.nodeCount()));
+        data = static_cast<T*>(py::reinterpret_borrow<py::array>(out).mutable_data());
+    }
+    py::gil_scoped_release release;
+    reader.readColumn(sharedColumn(column), data);
+    return out;
+}
+
+// ICIKernel.process on a [channels x fft_size] float32 or float64 block; the
+// pair matrix goes into matrix, a preallocated C-contiguous float64
+// [channels x channels] array, when given
+template <typename T>
+double iciBlock(ICIKernel& kernel, const py::array& block, const py::object& matrix) {
+    if (block.ndim() != 2 || static_cast<size_t>(block.shape(0)) != kernel.channels() ||
+        static_cast<size_t>(block.shape(1)) != kernel.fftSize()) {
+        throw std::invalid_argument("block must have shape (" + std::to_string(kernel.channels()) + ", " +
+                                    std::to_string(kernel.fftSize()) + ")");
+    }
+    const InputBlock<T> input = py::reinterpret_borrow<py::object>(block).cast<InputBlock<T>>();
+    double* out = matrix.is_none() ? nullptr : outputBlock<double>(matrix, kernel.channels() * kernel.channels());
+    py::gil_scoped_release release;
+    return kernel.process(input.data(), out);
+}
+
+// 2-D float32 block processed in place: C-contiguous and writeable, with
+// `rows` rows (rows_axis 0) or columns (rows_axis 1)
+float* inplaceBlock(const py::object& block, int rows_axis, size_t rows, const char* layout) {
+    if (!py::isinstance<py::array_t<float>>(block)) throw std::invalid_argument("block must be a float32 array");
+    py::array array = py::reinterpret_borrow<py::array>(block);
+    if (array.ndim() != 2 || static_cast<size_t>(array.shape(rows_axis)) != rows) {
+        throw std::invalid_argument(std::string("block must have shape ") + layout + " with " + std::to_string(rows) +
+                                    " channels");
+    }
+    if (!(array.flags() & py::array::c_style) || !array.writeable()) {
+        throw std::invalid_argument("block must be C-contiguous and writeable");
+    }
+    return static_cast<float*>(array.mutable_data());
+}
+
+// StereoDownmix.process: in place into the first two rows of block, or into
+// out, a float32 (2, n) array, leaving block alone
+py::object downmixBlock(const StereoDownmix& mix, const py::object& block, const py::object& out) {
+    if (out.is_none()) {
+        float* data = inplaceBlock(block, 0, mix.channels(), "(channels, n)");
+        const size_t n = static_cast<size_t>(py::reinterpret_borrow<py::array>(block).shape(1));
+        if (mix.channels() < 2) throw std::invalid_argument("an in-place downmix needs 2 rows; pass out");
+        {
+            py::gil_scoped_release release;
+            mix.process(data, n, n, data, data + n);
+        }
+        return block[py::slice(0, 2, 1)];
+    }
+    const InputBlock<float> input = block.cast<InputBlock<float>>();
+    if (input.ndim() != 2 || static_cast<size_t>(input.shape(0)) != mix.channels()) {
+        throw std::invalid_argument("block must have shape (" + std::to_string(mix.channels()) + ", n)");
+    }
+    const size_t n = static_cast<size_t>(input.shape(1));
+    float* stereo = outputBlock<float>(out, 2 * n);
+    py::gil_scoped_release release;
+    mix.process(input.data(), n, n, stereo, stereo + n);
+    return out;
+}
+
+// ChromaAnalyzer.process on a float32 (channels, n) block, or (n,) for one
+// channel: chroma of every hop completed, float64 (hops, channels, 12)
+py::array_t<double> chromaBlock(ChromaAnalyzer& analyzer, const InputBlock<float>& block) {
+    const size_t channels = analyzer.config().channels;
+    if (block.ndim() == 1 ? channels != 1 : (block.ndim() != 2 || static_cast<size_t>(block.shape(0)) != channels)) {
+        throw std::invalid_argument("block must have shape (" + std::to_string(channels) + ", n)");
+    }
+    const size_t n = static_cast<size_t>(block.shape(block.ndim() - 1));
+    const size_t hop = static_cast<size_t>(analyzer.config().hop_size);
+    const size_t most = (n + hop - 1) / hop;
+    std::vector<double> frames(most * channels * ChromaAnalyzer::kPitchClasses);
+    size_t hops = 0;
+    {
+        py::gil_scoped_release release;
+        hops = analyzer.process(block.data(), n, n, frames.data(), most);
+    }
+    py::array_t<double> out({static_cast<py::ssize_t>(hops), static_cast<py::ssize_t>(channels),
+                              static_cast<py::ssize_t>(ChromaAnalyzer::kPitchClasses)});
+    std::copy(frames.begin(), frames.begin() + out.size(), out.mutable_data());
+    return out;
+}
+
+// [channels x width] rows of an analyzer's per-channel results
+template <typename Row>
+py::array_t<double> chromaRows(const ChromaAnalyzer& analyzer, size_t width, Row row) {
+    const size_t channels = analyzer.config().channels;
+    py::array_t<double> out({static_cast<py::ssize_t>(channels), static_cast<py::ssize_t>(width)});
+    for (size_t c = 0; c < channels; c++) {
+        std::copy(row(c), row(c) + width, out.mutable_data() + c * width);
+    }
+    return out;
+}
+
+// FrequencyResponseAnalyzer.analyze on an engine: dict of frequencies
+// (points,) and (num_nodes, points) float32 magnitude, phase and thd
+py::dict analyzeResponse(const FrequencyResponseAnalyzer& analyzer, AnalogCellularEngineAVX2& engine) {
+    FrequencyResponse response;
+    {
+        EngineCall<AnalogCellularEngineAVX2> call(engine);
+        response = analyzer.analyze(engine);
+    }
+    const std::vector<py::ssize_t> shape = {static_cast<py::ssize_t>(response.nodes),
+                                            static_cast<py::ssize_t>(response.points)};
+    auto table = [&](const std::vector<float>& values) {
+        py::array_t<float> array(shape);
+        std::copy(values.begin(), values.end(), array.mutable_data());
+        return array;
+    };
+    py::dict result;
+    result["frequencies"] = py::array_t<double>(static_cast<py::ssize_t>(response.points), response.frequencies.data());
+    result["magnitude"] = table(response.magnitude);
+    result["phase"] = table(response.phase);
+    result["thd"] = table(response.thd);
+    return result;
+}
+
+// DSP core real FFT (hardware/dsp_core.h); plans are made and destroyed
+// under the FFTW planner lock whatever the backend
+class RealFft {
+public:
+    RealFft(size_t size, DspFftBackend backend) {
+        {
+            std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+            fft_ = dsp_rfft_create(size, backend);
+        }
+        if (!fft_) {
+            throw std::invalid_argument("no " + std::string(dsp_fft_backend_name(backend)) + " real FFT of size " +
+                                        std::to_string(size) + "; sizes are powers of two from " +
+                                        std::to_string(DSP_FFT_MIN_SIZE));
+        }
+    }
+    ~RealFft() {
+        std::lock_guard<std::mutex> lock(fftwPlannerMutex());
+        dsp_rfft_destroy(fft_);
+    }
+    RealFft(const RealFft&) = delete;
+    RealFft& operator=(const RealFft&) = delete;
+
+    size_t size() const { return dsp_rfft_size(fft_); }
+    DspFftBackend backend() const { return dsp_rfft_backend(fft_); }
+
+    // Spectrum of a float32 block of size() samples into out, complex64 of
+    // size() / 2 + 1 bins, or a new array
+    py::object forward(const InputBlock<float>& block, py::object out) {
+        const size_t n = size();
+        if (static_cast<size_t>(block.size()) != n) {
+            throw std::invalid_argument("block must hold " + std::to_string(n) + " samples");
+        }
+        if (out.is_none()) {
+            out = py::array_t<std::complex<float>>(static_cast<py::ssize_t>(n / 2 + 1));
+        } else if (!py::isinstance<py::array_t<std::complex<float>>>(out)) {
+            throw std::invalid_argument("out must be a numpy array of complex64");
+        }
+        py::array array = py::reinterpret_borrow<py::array>(out);
+        if (!(array.flags() & py::array::c_style) || !array.writeable() ||
+            static_cast<size_t>(array.size()) != n / 2 + 1) {
+            throw std::invalid_argument("out must be C-contiguous, writeable and hold " + std::to_string(n / 2 + 1) +
+                                        " bins");
+        }
+        float* spectrum = static_cast<float*>(array.mutable_data());
+        py::gil_scoped_release release;
+        std::lock_guard<std::mutex> lock(mutex_);  // One transform at a time through the scratch
+        dsp_rfft_forward(fft_, block.data(), spectrum);
+        return out;
+    }
+
+private:
+    DspRealFft* fft_ = nullptr;
+    std::mutex mutex_;
+};
+
+py::dict spectralFeatures(const InputBlock<float>& magnitude, float bin_hz, const py::object& prev) {
+    const size_t bins = static_cast<size_t>(magnitude.size());
+    if (bins < 2) throw std::invalid_argument("magnitude needs at least 2 bins");
+    float* previous = prev.is_none() ? nullptr : outputBlock<float>(prev, bins);
+    DspSpectralFeatures features;
+    bool has_energy;
+    {
+        py::gil_scoped_release release;
+        has_energy = dsp_spectral_features(magnitude.data(), previous, bins, bin_hz, &features);
+    }
+    py::dict result;
+    result["centroid"] = features.centroid;
+    result["flux"] = features.flux;
+    result["rolloff"] = features.rolloff;
+    result["flatness"] = features.flatness;
+    result["has_energy"] = has_energy;
+    return result;
+}
+
+// Fields of EngineMetricsFrame in layout order, with their NumPy type codes
+struct MetricsFrameField {
+    const char* name;
+    const char* type;
+};
+
+constexpr MetricsFrameField kMetricsFrameFields[] = {
+    {"total_execution_time_ns", "u8"}, {"avx2_operation_time_ns", "u8"}, {"total_operations", "u8"},
+    {"avx2_operations", "u8"},         {"node_processes", "u8"},         {"harmonic_generations", "u8"},
+    {"profiled_scopes", "u8"},         {"hw_counters_available", "u8"},  {"hw_cycles", "u8"},
+    {"hw_instructions", "u8"},         {"hw_l1d_misses", "u8"},          {"hw_llc_misses", "u8"},
+    {"hw_branch_misses", "u8"},        {"current_ns_per_op", "f8"},      {"current_ops_per_second", "f8"},
+    {"speedup_factor", "f8"},          {"profiling_overhead_ns", "f8"},  {"instructions_per_cycle", "f8"},
+};
+static_assert(sizeof(kMetricsFrameFields) / sizeof(kMetricsFrameFields[0]) * 8 == sizeof(EngineMetricsFrame),
+              "kMetricsFrameFields must list every EngineMetricsFrame field");
+
+// Fields of MetricsRecord in layout order, with their NumPy type codes
+constexpr MetricsFrameField kMetricsRecordFields[] = {
+    {"frame_id", "u8"},        {"timestamp", "f8"},           {"ici", "f8"},
+    {"phase_coherence", "f8"}, {"spectral_centroid", "f8"},   {"criticality", "f8"},
+    {"consciousness_level", "f8"}, {"phi_phase", "f8"},       {"phi_depth", "f8"},
+    {"latency_ms", "f8"},      {"cpu_load", "f8"},            {"state", "u4"},
+    {"flags", "u4"},           {"trace_id", "u8"},            {"origin_ns", "i8"},
+};
+
+py::dtype metricsRecordDtype() {
+    py::list fields;
+    for (const MetricsFrameField& field : kMetricsRecordFields) fields.append(py::make_tuple(field.name, field.type));
+    py::dtype dtype = py::dtype::from_args(fields);
+    if (static_cast<size_t>(dtype.itemsize()) != sizeof(MetricsRecord)) {
+        throw std::logic_error("kMetricsRecordFields must list every MetricsRecord field");
+    }
+    return dtype;
+}
+
+// Read-only structured array over every slot of a ring; the array holds the
+// reader, so the mapping lives as long as any view of it
+py::array metricsRingRecords(const std::shared_ptr<MetricsRingReader>& reader) {
+    py::array records(metricsRecordDtype(), {static_cast<py::ssize_t>(reader->capacity())},
+                      {static_cast<py::ssize_t>(sizeof(MetricsRecord))}, reader->records(), py::cast(reader));
+    records.attr("setflags")(py::arg("write") = false);
+    return records;
+}
+
+// Checked copy of the newest records into out (a structured array of
+// METRICS_RECORD_DTYPE) or into a new array; returns the filled rows
+py::array readMetricsRing(const MetricsRingReader& reader, size_t max, uint64_t since, py::object out) {
+    py::array rows;
+    if (out.is_none()) {
+        rows = py::array(metricsRecordDtype(), std::vector<py::ssize_t>{static_cast<py::ssize_t>(std::min(max, reader.capacity()))});
+    } else {
+        rows = py::reinterpret_borrow<py::array>(out);
+        if (!rows.dtype().equal(metricsRecordDtype())) {
+            throw std::invalid_argument("out must be an array of METRICS_RECORD_DTYPE");
+        }
+        if (!(rows.flags() & py::array::c_style) || !rows.writeable()) {
+            throw std::invalid_argument("out must be C-contiguous and writeable");
+        }
+        max = std::min(max, static_cast<size_t>(rows.size()));
+    }
+    auto* data = static_cast<MetricsRecord*>(rows.mutable_data());
+    size_t count;
+    {
+        py::gil_scoped_release release;
+        count = reader.readLatest(data, max, since);
+    }
+    return rows[py::slice(0, static_cast<py::ssize_t>(count), 1)].cast<py::array>();
+}
+
+// Metrics frame into out, any writeable contiguous buffer of
+// sizeof(EngineMetricsFrame) bytes (a bytearray, or a one-element array of
+// METRICS_FRAME_DTYPE), or into a new bytes object when out is None
+template <typename Engine>
+py::object metricsFrame(const Engine& engine, py::object out) {
+    EngineMetricsFrame frame;
+    if (out.is_none()) {
+        engine.getMetricsFrame(frame);
+        return py::bytes(reinterpret_cast<const char*>(&frame), sizeof(frame));
+    }
+    py::buffer_info info = py::reinterpret_borrow<py::buffer>(out).request(true);
+    if (static_cast<size_t>(info.itemsize * info.size) != sizeof(frame)) {
+        throw std::invalid_argument("out must hold " + std::to_string(sizeof(frame)) + " bytes");
+    }
+    if (info.ndim > 1 || (info.ndim == 1 && info.size > 1 && info.strides[0] != info.itemsize)) {
+        throw std::invalid_argument("out must be contiguous");
+    }
+    engine.getMetricsFrame(frame);
+    std::memcpy(info.ptr, &frame, sizeof(frame));
+    return out;
+}
+
+// Output array of one node block: out itself, or a new array of n values
+template <typename T>
+T* nodeOutput(py::object& out, size_t n) {
+    if (out.is_none()) {
+        out = py::array_t<T>(static_cast<py::ssize_t>(n));
+        return static_cast<T*>(py::reinterpret_borrow<py::array>(out).mutable_data());
+    }
+    return outputBlock<T>(out, n);
+}
+
+// Decode every complete Φ-sensor frame in a serial byte stream
+// (hardware/phi_packet.h); the bytes after the last zero are left for the
+// next call
+py::dict decodePhiStream(const py::buffer& data) {
+    py::buffer_info info = data.request();
+    if (info.ndim > 1 || (info.ndim == 1 && info.size > 1 && info.strides[0] != info.itemsize)) {
+        throw std::invalid_argument("data must be contiguous");
+    }
+    const uint8_t* bytes = static_cast<const uint8_t*>(info.ptr);
+    const size_t length = static_cast<size_t>(info.itemsize * info.size);
+
+    std::vector<PhiSensorData> samples;
+    std::vector<uint8_t> flags;
+    size_t consumed = 0;
+    size_t errors = 0;
+    {
+        py::gil_scoped_release release;
+        samples.reserve(length / PHI_PACKET_SAMPLE_BYTES + 1);
+        size_t start = 0;
+        for (size_t i = 0; i < length; i++) {
+            if (bytes[i] != 0) {
+                continue;
+            }
+            if (i > start) {
+                PhiSensorData packet[PHI_PACKET_MAX_SAMPLES];
+                uint8_t packet_flags = 0;
+                const int n = phi_packet_decode(bytes + start, i - start, packet, PHI_PACKET_MAX_SAMPLES, &packet_flags);
+                if (n > 0) {
+                    samples.insert(samples.end(), packet, packet + n);
+                    flags.insert(flags.end(), static_cast<size_t>(n), packet_flags);
+                } else {
+                    errors++;
+                }
+            }
+            start = i + 1;
+            consumed = start;
+        }
+    }
+
+    const py::ssize_t n = static_cast<py::ssize_t>(samples.size());
+    py::array_t<uint32_t> sample_number(n);
+    py::array_t<uint32_t> timestamp_us(n);
+    py::array_t<uint16_t> raw_adc({n, static_cast<py::ssize_t>(PHI_PACKET_CHANNELS)});
+    py::array_t<float> normalized({n, static_cast<py::ssize_t>(PHI_PACKET_CHANNELS)});
+    py::array_t<uint8_t> sample_flags(n);
+    uint32_t* number_out = sample_number.mutable_data();
+    uint32_t* time_out = timestamp_us.mutable_data();
+    uint16_t* raw_out = raw_adc.mutable_data();
+    float* normalized_out = normalized.mutable_data();
+    for (py::ssize_t i = 0; i < n; i++) {
+        const PhiSensorData& s = samples[static_cast<size_t>(i)];
+        number_out[i] = s.sample_number;
+        time_out[i] = s.timestamp_us;
+        std::memcpy(raw_out + i * PHI_PACKET_CHANNELS, s.raw_adc, sizeof(s.raw_adc));
+        std::memcpy(normalized_out + i * PHI_PACKET_CHANNELS, s.normalized, sizeof(s.normalized));
+    }
+    if (n > 0) {
+        std::memcpy(sample_flags.mutable_data(), flags.data(), flags.size());
+    }
+
+    py::dict result;
+    result["sample_number"] = sample_number;
+    result["timestamp_us"] = timestamp_us;
+    result["raw_adc"] = raw_adc;
+    result["normalized"] = normalized;
+    result["flags"] = sample_flags;
+    result["consumed"] = consumed;
+    result["errors"] = errors;
+    return result;
+}
+
+} // namespace
+
 PYBIND11_MODULE(dase_engine, m) {
     m.doc() = "DASE Analog Engine - High-performance analog signal processing with AVX2 optimization";
 
+    py::enum_<WorkKernel>(m, "WorkKernel")
+        .value("NODE_STEP", WorkKernel::NodeStep)
+        .value("NODE_BLOCK", WorkKernel::NodeBlock)
+        .value("HARMONICS", WorkKernel::Harmonics)
+        .value("WAVE_SWEEP", WorkKernel::WaveSweep)
+        .value("MISSION_STEP", WorkKernel::MissionStep)
+        .value("MISSION_FUSED", WorkKernel::MissionFused)
+        .value("ENGINE_BLOCK", WorkKernel::EngineBlock)
+        .value("GRID_COUPLING", WorkKernel::GridCoupling)
+        .value("SPARSE_COUPLING", WorkKernel::SparseCoupling)
+        .value("NOISE_INJECTION", WorkKernel::NoiseInjection)
+        .value("CHROMATIC_BLOCK", WorkKernel::ChromaticBlock)
+        .value("FILTER_BLOCK", WorkKernel::FilterBlock);
+
+    py::class_<KernelMetrics>(m, "KernelMetrics")
+        .def_readonly("kernel", &KernelMetrics::kernel)
+        .def_property_readonly("name", [](const KernelMetrics& k) { return workKernelName(k.kernel); })
+        .def_readonly("calls", &KernelMetrics::calls)
+        .def_readonly("flops", &KernelMetrics::flops)
+        .def_readonly("bytes", &KernelMetrics::bytes)
+        .def_readonly("time_ns", &KernelMetrics::time_ns)
+        .def_readonly("gflops", &KernelMetrics::gflops)
+        .def_readonly("gbytes_per_second", &KernelMetrics::gbytes_per_second)
+        .def_readonly("arithmetic_intensity", &KernelMetrics::arithmetic_intensity);
+
     // EngineMetrics struct
+    {
+        py::list dtype;
+        std::string format = "=";
+        for (const MetricsFrameField& field : kMetricsFrameFields) {
+            dtype.append(py::make_tuple(field.name, field.type));
+            format += field.type[0] == 'u' ? 'Q' : 'd';
+        }
+        m.attr("METRICS_FRAME_DTYPE") = dtype;
+        m.attr("METRICS_FRAME_FORMAT") = format;
+    }
+
     py::class_<EngineMetrics>(m, "EngineMetrics")
         .def(py::init<>())
         .def_readwrite("total_execution_time_ns", &EngineMetrics::total_execution_time_ns)
@@ -21,6 +859,16 @@ PYBIND11_MODULE(dase_engine, m) {
         .def_readonly("current_ops_per_second", &EngineMetrics::current_ops_per_second)
         .def_readonly("speedup_factor", &EngineMetrics::speedup_factor)
         .def_readonly("target_ns_per_op", &EngineMetrics::target_ns_per_op)
+        .def_readonly("profiled_scopes", &EngineMetrics::profiled_scopes)
+        .def_readonly("profiling_overhead_ns", &EngineMetrics::profiling_overhead_ns)
+        .def_readonly("hw_counters_available", &EngineMetrics::hw_counters_available)
+        .def_readonly("hw_cycles", &EngineMetrics::hw_cycles)
+        .def_readonly("hw_instructions", &EngineMetrics::hw_instructions)
+        .def_readonly("hw_l1d_misses", &EngineMetrics::hw_l1d_misses)
+        .def_readonly("hw_llc_misses", &EngineMetrics::hw_llc_misses)
+        .def_readonly("hw_branch_misses", &EngineMetrics::hw_branch_misses)
+        .def_readonly("instructions_per_cycle", &EngineMetrics::instructions_per_cycle)
+        .def_readonly("kernels", &EngineMetrics::kernels)
         .def("reset", &EngineMetrics::reset)
         .def("update_performance", &EngineMetrics::update_performance)
         .def("print_metrics", &EngineMetrics::print_metrics);
@@ -28,16 +876,54 @@ PYBIND11_MODULE(dase_engine, m) {
     // AnalogUniversalNodeAVX2 class  
     py::class_<AnalogUniversalNodeAVX2>(m, "AnalogUniversalNode")
         .def(py::init<>())
-        .def_readwrite("x", &AnalogUniversalNodeAVX2::x)
-        .def_readwrite("y", &AnalogUniversalNodeAVX2::y) 
-        .def_readwrite("z", &AnalogUniversalNodeAVX2::z)
-        .def_readwrite("node_id", &AnalogUniversalNodeAVX2::node_id)
+        .def_property("x", &AnalogUniversalNodeAVX2::getX, &AnalogUniversalNodeAVX2::setX)
+        .def_property("y", &AnalogUniversalNodeAVX2::getY, &AnalogUniversalNodeAVX2::setY)
+        .def_property("z", &AnalogUniversalNodeAVX2::getZ, &AnalogUniversalNodeAVX2::setZ)
+        .def_property("node_id", &AnalogUniversalNodeAVX2::getNodeId, &AnalogUniversalNodeAVX2::setNodeId)
+        .def_property_readonly("is_view", &AnalogUniversalNodeAVX2::isView,
+             "True if this node aliases an engine's node bank")
         .def("process_signal", &AnalogUniversalNodeAVX2::processSignal,
              "Process analog signal through the node",
              py::arg("input_signal"), py::arg("control_signal"), py::arg("aux_signal"))
         .def("process_signal_avx2", &AnalogUniversalNodeAVX2::processSignalAVX2,
              "Process analog signal with AVX2 optimization",
              py::arg("input_signal"), py::arg("control_signal"), py::arg("aux_signal"))
+        .def("process_block", [](AnalogUniversalNodeAVX2& self, const py::array_t<float, py::array::c_style>& input,
+                                 const py::object& control, const py::object& aux, py::object out) {
+                 const size_t n = static_cast<size_t>(input.size());
+                 InputBlock<float> control_holder, aux_holder;
+                 const float* control_data = optionalBlock(control, n, "control", control_holder);
+                 const float* aux_data = optionalBlock(aux, n, "aux", aux_holder);
+                 std::vector<float> ones;
+                 if (control_data == nullptr) {
+                     ones.assign(n, 1.0f);
+                     control_data = ones.data();
+                 }
+                 float* out_data = nodeOutput<float>(out, n);
+                 self.processBlock(input.data(), control_data, aux_data, out_data, n);
+                 return out;
+             },
+             "Process a float32 block in one call (control None for 1.0, aux None for 0.0); "
+             "writes into out when given, otherwise returns a new array",
+             py::arg("input"), py::arg("control") = py::none(), py::arg("aux") = py::none(),
+             py::arg("out") = py::none())
+        .def("process_block", [](AnalogUniversalNodeAVX2& self, const InputBlock<double>& input,
+                                 const py::object& control, const py::object& aux, py::object out) {
+                 const size_t n = static_cast<size_t>(input.size());
+                 InputBlock<double> control_holder, aux_holder;
+                 const double* control_data = optionalBlock(control, n, "control", control_holder);
+                 const double* aux_data = optionalBlock(aux, n, "aux", aux_holder);
+                 double* out_data = nodeOutput<double>(out, n);
+                 const double* in = input.data();
+                 for (size_t t = 0; t < n; t++) {
+                     out_data[t] = self.processSignalAVX2(in[t], control_data ? control_data[t] : 1.0,
+                                                          aux_data ? aux_data[t] : 0.0);
+                 }
+                 return out;
+             },
+             "Other dtypes: process_signal_avx2 per sample in double precision, into a float64 out",
+             py::arg("input"), py::arg("control") = py::none(), py::arg("aux") = py::none(),
+             py::arg("out") = py::none())
         .def("set_feedback", &AnalogUniversalNodeAVX2::setFeedback,
              "Set feedback coefficient",
              py::arg("feedback_coefficient"))
@@ -58,42 +944,2997 @@ PYBIND11_MODULE(dase_engine, m) {
              "Apply feedback to signal",
              py::arg("input_signal"), py::arg("feedback_gain"));
 
+    py::enum_<NodeKernelMode>(m, "NodeKernelMode")
+        .value("SCALAR", NodeKernelMode::Scalar)
+        .value("LANE_PARALLEL", NodeKernelMode::LaneParallel);
+
+    py::enum_<MissionSchedule>(m, "MissionSchedule")
+        .value("PER_STEP", MissionSchedule::PerStep)
+        .value("FUSED", MissionSchedule::Fused);
+
+    py::enum_<GridStencil>(m, "GridStencil")
+        .value("NONE", GridStencil::None)
+        .value("FACE6", GridStencil::Face6)
+        .value("FULL26", GridStencil::Full26);
+
+    py::enum_<GridOrder>(m, "GridOrder")
+        .value("LINEAR", GridOrder::Linear)
+        .value("MORTON", GridOrder::Morton);
+
+    py::class_<GridShape>(m, "GridShape")
+        .def(py::init<>())
+        .def_readwrite("nx", &GridShape::nx)
+        .def_readwrite("ny", &GridShape::ny)
+        .def_readwrite("nz", &GridShape::nz)
+        .def_readwrite("order", &GridShape::order)
+        .def("__repr__", [](const GridShape& g) {
+            return "GridShape(" + std::to_string(g.nx) + ", " + std::to_string(g.ny) + ", " +
+                   std::to_string(g.nz) + (g.order == GridOrder::Morton ? ", MORTON" : "") + ")";
+        });
+
+    py::enum_<SimdLevel>(m, "SimdLevel")
+        .value("SCALAR", SimdLevel::Scalar)
+        .value("SSE42", SimdLevel::SSE42)
+        .value("AVX2", SimdLevel::AVX2)
+        .value("AVX512", SimdLevel::AVX512)
+        .value("NEON", SimdLevel::NEON);
+
+    py::enum_<NodePipeline>(m, "NodePipeline")
+        .value("FULL", NodePipeline::Full)
+        .value("NO_BOOST", NodePipeline::NoBoost)
+        .value("DIRECT", NodePipeline::Direct)
+        .value("LINEAR", NodePipeline::Linear);
+
+    py::enum_<ComputeQuality>(m, "ComputeQuality")
+        .value("FULL", ComputeQuality::Full)
+        .value("REDUCED", ComputeQuality::Reduced)
+        .value("LOW", ComputeQuality::Low)
+        .value("DRAFT", ComputeQuality::Draft);
+
+    py::enum_<NodeEquationBackend>(m, "NodeEquationBackend")
+        .value("TAPE", NodeEquationBackend::Tape)
+        .value("JIT", NodeEquationBackend::Jit);
+
+    m.def("node_equation_backend_available", &nodeEquationBackendAvailable,
+          "True when node equations can be compiled for the backend (JIT needs DASE_WITH_LLVM)",
+          py::arg("backend"));
+    m.def("node_equation_cache_stats", [] {
+              const NodeEquation::CacheStats stats = NodeEquation::cacheStats();
+              py::dict result;
+              result["entries"] = stats.entries;
+              result["hits"] = stats.hits;
+              result["misses"] = stats.misses;
+              return result;
+          },
+          "Compiled node equations held by the process-wide cache, and its hits and misses");
+
+    py::enum_<SnapshotLoad>(m, "SnapshotLoad")
+        .value("COPY", SnapshotLoad::Copy)
+        .value("MAP", SnapshotLoad::Map);
+
+    m.def("snapshot_compression_available", &snapshotCompressionAvailable,
+          "True when the engine was built with DASE_WITH_ZLIB and can write compressed snapshots");
+
+    py::class_<CheckpointConfig>(m, "CheckpointConfig")
+        .def(py::init<>())
+        .def_readwrite("path", &CheckpointConfig::path)
+        .def_readwrite("interval_steps", &CheckpointConfig::interval_steps)
+        .def_readwrite("compress", &CheckpointConfig::compress);
+
+    py::class_<CheckpointStats>(m, "CheckpointStats")
+        .def_readonly("captured", &CheckpointStats::captured)
+        .def_readonly("written", &CheckpointStats::written)
+        .def_readonly("failed", &CheckpointStats::failed)
+        .def_readonly("deferred", &CheckpointStats::deferred)
+        .def_readonly("last_step", &CheckpointStats::last_step)
+        .def_readonly("last_bytes", &CheckpointStats::last_bytes)
+        .def_readonly("last_stall_ms", &CheckpointStats::last_stall_ms)
+        .def_readonly("max_stall_ms", &CheckpointStats::max_stall_ms)
+        .def_readonly("last_write_ms", &CheckpointStats::last_write_ms)
+        .def_readonly("last_error", &CheckpointStats::last_error);
+
+    py::class_<RecorderConfig>(m, "RecorderConfig")
+        .def(py::init<>())
+        .def_readwrite("path", &RecorderConfig::path)
+        .def_readwrite("nodes", &RecorderConfig::nodes)
+        .def_readwrite("decimation", &RecorderConfig::decimation)
+        .def_readwrite("chunk_frames", &RecorderConfig::chunk_frames)
+        .def_readwrite("compress", &RecorderConfig::compress);
+
+    py::class_<RecorderStats>(m, "RecorderStats")
+        .def_readonly("frames_seen", &RecorderStats::frames_seen)
+        .def_readonly("frames_recorded", &RecorderStats::frames_recorded)
+        .def_readonly("chunks_written", &RecorderStats::chunks_written)
+        .def_readonly("bytes_raw", &RecorderStats::bytes_raw)
+        .def_readonly("bytes_written", &RecorderStats::bytes_written)
+        .def_readonly("writer_waits", &RecorderStats::writer_waits)
+        .def_readonly("last_write_ms", &RecorderStats::last_write_ms);
+
+    py::class_<NodeRecording>(m, "NodeRecording",
+        "Read-only mapping of a file written by AnalogCellularEngine.start_recording")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def_property_readonly("num_nodes", &NodeRecording::nodeCount)
+        .def_property_readonly("num_frames", &NodeRecording::frameCount)
+        .def_property_readonly("decimation", &NodeRecording::decimation)
+        .def_property_readonly("nodes", [](const NodeRecording& self) {
+                 return py::array_t<uint32_t>(static_cast<py::ssize_t>(self.nodeCount()), self.nodes().data());
+             },
+             "Engine index of each recorded column")
+        .def("read_frames", [](const NodeRecording& self, uint64_t first, py::object count) {
+                 const uint64_t n = count.is_none() ? self.frameCount() - std::min(first, self.frameCount())
+                                                    : count.cast<uint64_t>();
+                 py::array_t<float> out({static_cast<py::ssize_t>(n), static_cast<py::ssize_t>(self.nodeCount())});
+                 float* data = out.mutable_data();
+                 py::gil_scoped_release release;
+                 self.readFrames(first, n, data);
+                 return out;
+             },
+             "Frames [first, first + count) as a [count x num_nodes] float32 array; count defaults to the rest",
+             py::arg("first") = 0, py::arg("count") = py::none())
+        .def("read_node", [](const NodeRecording& self, size_t column) {
+                 py::array_t<float> out(static_cast<py::ssize_t>(self.frameCount()));
+                 float* data = out.mutable_data();
+                 py::gil_scoped_release release;
+                 self.readColumn(column, 0, self.frameCount(), data);
+                 return out;
+             },
+             "Every frame of recorded column `column` (see nodes)", py::arg("column"));
+
+    py::enum_<FFTPlanRigor>(m, "FFTPlanRigor")
+        .value("ESTIMATE", FFTPlanRigor::Estimate)
+        .value("MEASURE", FFTPlanRigor::Measure);
+
+    py::enum_<FFTBackend>(m, "FFTBackend")
+        .value("FFTW", FFTBackend::FFTW)
+        .value("BUILTIN", FFTBackend::Builtin)
+        .value("ACCELERATE", FFTBackend::Accelerate)
+        .value("MKL", FFTBackend::MKL);
+
+    m.def("fft_backend_available", &fftBackendAvailable,
+          "Whether this build carries the FFT backend (BUILTIN always)", py::arg("backend"));
+    m.def("fft_backend_name", &fftBackendName, py::arg("backend"));
+    m.def("default_fft_backend", &defaultFFTBackend,
+          "FFTW when built in, else ACCELERATE, MKL, then BUILTIN");
+    m.def("fftw_threads_available", &FFTPlanCache::threadsAvailable,
+          "True when the engine was built with DASE_WITH_FFTW_THREADS and can split large FFTs over threads");
+
+    py::enum_<SpectralWindow>(m, "SpectralWindow")
+        .value("RECTANGULAR", SpectralWindow::Rectangular)
+        .value("HANN", SpectralWindow::Hann)
+        .value("SQRT_HANN", SpectralWindow::SqrtHann);
+
+    py::enum_<SpectralStreamMode>(m, "SpectralStreamMode")
+        .value("WEIGHTED_OVERLAP_ADD", SpectralStreamMode::WeightedOverlapAdd)
+        .value("OVERLAP_SAVE", SpectralStreamMode::OverlapSave);
+
+    py::class_<SpectralStreamConfig>(m, "SpectralStreamConfig")
+        .def(py::init<>())
+        .def_readwrite("fft_size", &SpectralStreamConfig::fft_size)
+        .def_readwrite("hop_size", &SpectralStreamConfig::hop_size)
+        .def_readwrite("window", &SpectralStreamConfig::window)
+        .def_readwrite("mode", &SpectralStreamConfig::mode);
+
+    py::class_<StreamingSpectralProcessor>(m, "StreamingSpectralProcessor")
+        .def(py::init<const SpectralStreamConfig&>(), py::arg("config") = SpectralStreamConfig())
+        .def("process", [](StreamingSpectralProcessor& self, std::vector<float> chunk) {
+                 self.process(chunk.data(), chunk.data(), chunk.size());
+                 return chunk;
+             }, "Filter a chunk of any length; returns the same number of delayed samples",
+             py::arg("chunk"))
+        .def("set_gain_mask", &StreamingSpectralProcessor::setGainMask,
+             "Set per-bin gains (fft_size // 2 + 1 values)", py::arg("gains"))
+        .def("set_band_gain", &StreamingSpectralProcessor::setBandGain,
+             "Set bins first_bin..last_bin (inclusive) to gain",
+             py::arg("first_bin"), py::arg("last_bin"), py::arg("gain"))
+        .def_property_readonly("gain_mask", &StreamingSpectralProcessor::getGainMask)
+        .def("reset", &StreamingSpectralProcessor::reset, "Clear stream history")
+        .def_property_readonly("bin_count", &StreamingSpectralProcessor::binCount)
+        .def_property_readonly("latency", &StreamingSpectralProcessor::latency,
+             "Constant input-to-output delay in samples")
+        .def_property_readonly("config", &StreamingSpectralProcessor::config);
+
+    py::class_<ConvolverConfig>(m, "ConvolverConfig")
+        .def(py::init<>())
+        .def_readwrite("block_size", &ConvolverConfig::block_size)
+        .def_readwrite("tail_block_size", &ConvolverConfig::tail_block_size)
+        .def_readwrite("fft_backend", &ConvolverConfig::fft_backend);
+
+    py::class_<PartitionedConvolver>(m, "PartitionedConvolver",
+        "Streaming convolution with a long impulse response at one block of latency: uniformly "
+        "partitioned overlap-save over a frequency-domain delay line, optionally with a coarser tail")
+        .def(py::init<const ConvolverConfig&, SimdLevel>(), py::arg("config") = ConvolverConfig(),
+             py::arg("simd_level") = defaultSimdLevel())
+        .def("set_impulse_response", [](PartitionedConvolver& self, const InputBlock<float>& ir) {
+                 self.setImpulseResponse(ir.data(), static_cast<size_t>(ir.size()));
+             },
+             "Replace the impulse response and clear the stream history", py::arg("ir"))
+        .def("process", [](PartitionedConvolver& self, const InputBlock<float>& chunk, py::object out) {
+                 const size_t n = static_cast<size_t>(chunk.size());
+                 float* out_data = nullptr;
+                 if (!out.is_none()) {
+                     out_data = outputBlock<float>(out, n);
+                 } else {
+                     out = py::array_t<float>(static_cast<py::ssize_t>(n));
+                     out_data = static_cast<float*>(py::reinterpret_borrow<py::array>(out).mutable_data());
+                 }
+                 {
+                     py::gil_scoped_release release;
+                     self.process(chunk.data(), out_data, n);
+                 }
+                 return out;
+             },
+             "Convolve a chunk of any length; returns the same number of samples, delayed by latency, "
+             "in out (float32) when given",
+             py::arg("chunk"), py::arg("out") = py::none())
+        .def("reset", &PartitionedConvolver::reset, "Clear stream history")
+        .def_property_readonly("latency", &PartitionedConvolver::latency,
+             "Constant input-to-output delay in samples (block_size)")
+        .def_property_readonly("impulse_length", &PartitionedConvolver::impulseLength)
+        .def_property_readonly("head_partitions", &PartitionedConvolver::headPartitions)
+        .def_property_readonly("tail_partitions", &PartitionedConvolver::tailPartitions)
+        .def_property_readonly("config", &PartitionedConvolver::config)
+        .def_property_readonly("simd_level", &PartitionedConvolver::getSimdLevel);
+
+    py::class_<StereoDownmix>(m, "StereoDownmix",
+        "Multi-channel to stereo matrix downmix of (channels, n) float32 blocks")
+        .def(py::init<size_t, SimdLevel>(), py::arg("channels") = 8, py::arg("simd_level") = defaultSimdLevel())
+        .def("set_weights", [](StereoDownmix& self, const std::vector<float>& left, const std::vector<float>& right,
+                               float gain) {
+                 if (left.size() != self.channels() || right.size() != self.channels()) {
+                     throw std::invalid_argument("left and right need " + std::to_string(self.channels()) +
+                                                 " weights each");
+                 }
+                 self.setWeights(left.data(), right.data(), gain);
+             },
+             "Per-channel left and right weights, both scaled by gain",
+             py::arg("left"), py::arg("right"), py::arg("gain") = 1.0f)
+        .def_property_readonly("weights", &StereoDownmix::weights, "Scaled left weights, then right")
+        .def_property_readonly("channels", &StereoDownmix::channels)
+        .def("process", &downmixBlock,
+             "Mix a (channels, n) float32 block to stereo: into its first two rows (returned as a view) "
+             "or into out, a float32 (2, n) array",
+             py::arg("block"), py::arg("out") = py::none());
+
+    py::enum_<DelayInterpolation>(m, "DelayInterpolation")
+        .value("LINEAR", DelayInterpolation::Linear)
+        .value("LAGRANGE3", DelayInterpolation::Lagrange3);
+
+    py::class_<FractionalDelayLine>(m, "FractionalDelayLine",
+        "Multi-channel fractional delay of float32 blocks, in place, with linear or Lagrange interpolation")
+        .def(py::init<size_t, size_t, DelayInterpolation, size_t, SimdLevel>(), py::arg("channels"),
+             py::arg("max_delay"), py::arg("interpolation") = DelayInterpolation::Linear,
+             py::arg("max_block") = 4096, py::arg("simd_level") = defaultSimdLevel())
+        .def_property("delay", &FractionalDelayLine::delay, &FractionalDelayLine::setDelay,
+             "Delay in samples, clamped to [0, max_delay]")
+        .def_property("interpolation", &FractionalDelayLine::interpolation,
+             &FractionalDelayLine::setInterpolation)
+        .def_property_readonly("channels", &FractionalDelayLine::channels)
+        .def_property_readonly("max_delay", &FractionalDelayLine::maxDelay)
+        .def("process", [](FractionalDelayLine& self, py::object block) {
+                 float* data = inplaceBlock(block, 0, self.channels(), "(channels, n)");
+                 const size_t n = static_cast<size_t>(py::reinterpret_borrow<py::array>(block).shape(1));
+                 {
+                     py::gil_scoped_release release;
+                     self.process(data, n, n);
+                 }
+                 return block;
+             },
+             "Delay a (channels, n) float32 block in place and return it", py::arg("block"))
+        .def("process_interleaved", [](FractionalDelayLine& self, py::object frames) {
+                 float* data = inplaceBlock(frames, 1, self.channels(), "(n, channels)");
+                 const size_t n = static_cast<size_t>(py::reinterpret_borrow<py::array>(frames).shape(0));
+                 {
+                     py::gil_scoped_release release;
+                     self.processInterleaved(data, n);
+                 }
+                 return frames;
+             },
+             "Delay (n, channels) float32 frames in place and return them", py::arg("frames"))
+        .def("reset", &FractionalDelayLine::reset, "Clear the history");
+
+    py::class_<ICIKernel>(m, "ICIKernel",
+        "Integrated Chromatic Information of multi-channel blocks: batched real FFT of the "
+        "Hann-windowed channels and SIMD cross-spectral pair sums, as ici_engine.py computes them")
+        .def(py::init<size_t, size_t, SimdLevel, FFTBackend>(), py::arg("num_channels") = 8,
+             py::arg("fft_size") = 512, py::arg("simd_level") = defaultSimdLevel(),
+             py::arg("fft_backend") = defaultFFTBackend())
+        .def("process", [](ICIKernel& self, const py::array& block, const py::object& matrix) {
+                 return block.dtype().equal(py::dtype::of<float>()) ? iciBlock<float>(self, block, matrix)
+                                                                 : iciBlock<double>(self, block, matrix);
+             },
+             "Unsmoothed ICI of a (num_channels, fft_size) block; the pair matrix goes into matrix "
+             "(float64, (num_channels, num_channels)) when given",
+             py::arg("block"), py::arg("matrix") = py::none())
+        .def_property_readonly("num_channels", &ICIKernel::channels)
+        .def_property_readonly("fft_size", &ICIKernel::fftSize)
+        .def_property_readonly("bin_count", &ICIKernel::binCount)
+        .def_property_readonly("simd_level", &ICIKernel::getSimdLevel)
+        .def_property_readonly("fft_backend", &ICIKernel::getFFTBackend);
+
+    py::class_<ChromaticColorConfig>(m, "ChromaticColorConfig")
+        .def(py::init<>())
+        .def_readwrite("min_frequency", &ChromaticColorConfig::min_frequency)
+        .def_readwrite("max_frequency", &ChromaticColorConfig::max_frequency)
+        .def_readwrite("log_scale", &ChromaticColorConfig::log_scale)
+        .def_readwrite("amplitude_gamma", &ChromaticColorConfig::amplitude_gamma)
+        .def_readwrite("phi_rotation", &ChromaticColorConfig::phi_rotation)
+        .def_readwrite("saturation", &ChromaticColorConfig::saturation)
+        .def_readwrite("alpha", &ChromaticColorConfig::alpha);
+
+    py::class_<ChromaticColorMapper>(m, "ChromaticColorMapper",
+        "Batch ColorMapper of chromatic_visualizer.py: channel frequencies, amplitudes and the "
+        "Φ phase to packed HSL and RGBA buffers in one SIMD pass")
+        .def(py::init<const ChromaticColorConfig&, SimdLevel>(),
+             py::arg("config") = ChromaticColorConfig(), py::arg("simd_level") = defaultSimdLevel())
+        .def("map", [](const ChromaticColorMapper& self, const InputBlock<float>& frequency,
+                       const InputBlock<float>& amplitude, double phi_phase, float lightness_gain,
+                       py::object hsl, py::object rgba) {
+                 const size_t n = static_cast<size_t>(frequency.size());
+                 if (static_cast<size_t>(amplitude.size()) != n) {
+                     throw std::invalid_argument("amplitude length differs from frequency");
+                 }
+                 if (hsl.is_none()) hsl = py::array_t<float>({static_cast<py::ssize_t>(n), py::ssize_t(3)});
+                 if (rgba.is_none()) rgba = py::array_t<uint8_t>({static_cast<py::ssize_t>(n), py::ssize_t(4)});
+                 float* hsl_data = outputBlock<float>(hsl, 3 * n);
+                 uint8_t* rgba_data = outputBlock<uint8_t>(rgba, 4 * n);
+                 {
+                     py::gil_scoped_release release;
+                     self.map(frequency.data(), amplitude.data(), n, phi_phase, lightness_gain, hsl_data, rgba_data);
+                 }
+                 return py::make_tuple(hsl, rgba);
+             },
+             "(hsl, rgba) of every channel: float32 (n, 3) hue in degrees, saturation and lightness, "
+             "and uint8 (n, 4) RGBA; written into hsl and rgba when given. lightness_gain scales "
+             "every lightness (the Φ-breathing factor).",
+             py::arg("frequency"), py::arg("amplitude"), py::arg("phi_phase") = 0.0,
+             py::arg("lightness_gain") = 1.0f, py::arg("hsl") = py::none(), py::arg("rgba") = py::none())
+        .def_property_readonly("config", &ChromaticColorMapper::config)
+        .def_property_readonly("simd_level", &ChromaticColorMapper::getSimdLevel);
+
+    py::class_<ChromaConfig>(m, "ChromaConfig")
+        .def(py::init<>())
+        .def_readwrite("sample_rate", &ChromaConfig::sample_rate)
+        .def_readwrite("channels", &ChromaConfig::channels)
+        .def_readwrite("hop_size", &ChromaConfig::hop_size)
+        .def_readwrite("min_frequency", &ChromaConfig::min_frequency)
+        .def_readwrite("octaves", &ChromaConfig::octaves)
+        .def_readwrite("bins_per_semitone", &ChromaConfig::bins_per_semitone)
+        .def_readwrite("tuning", &ChromaConfig::tuning)
+        .def_readwrite("kernel_threshold", &ChromaConfig::kernel_threshold)
+        .def_readwrite("normalize", &ChromaConfig::normalize);
+
+    py::class_<ChromaAnalyzer>(m, "ChromaAnalyzer",
+        "Streaming constant-Q transform and 12-bin chroma per hop: sparse spectral kernels over a "
+        "multirate octave pyramid, two FFTs per hop")
+        .def(py::init<const ChromaConfig&>(), py::arg("config") = ChromaConfig())
+        .def("process", &chromaBlock,
+             "Feed a float32 (channels, n) block (or (n,) for one channel) of any length; returns the "
+             "chroma of each hop completed, float64 (hops, channels, 12), C first",
+             py::arg("block"))
+        .def("reset", &ChromaAnalyzer::reset, "Clear stream history and results")
+        .def_property_readonly("chroma", [](const ChromaAnalyzer& self) {
+                 return chromaRows(self, ChromaAnalyzer::kPitchClasses, [&](size_t c) { return self.chroma(c); });
+             }, "Chroma of the last hop, float64 (channels, 12)")
+        .def_property_readonly("spectrum", [](const ChromaAnalyzer& self) {
+                 return chromaRows(self, self.binCount(), [&](size_t c) { return self.spectrum(c); });
+             }, "Constant-Q magnitudes of the last hop, float64 (channels, bin_count), lowest bin first")
+        .def_property_readonly("dominant_frequencies", [](const ChromaAnalyzer& self) {
+                 std::vector<double> out(self.config().channels);
+                 for (size_t c = 0; c < out.size(); c++) out[c] = self.dominantFrequency(c);
+                 return out;
+             }, "Per channel, the frequency of the strongest constant-Q bin (0 while silent)")
+        .def_property_readonly("bin_frequencies", [](const ChromaAnalyzer& self) {
+                 std::vector<double> out(self.binCount());
+                 for (size_t b = 0; b < out.size(); b++) out[b] = self.binFrequency(b);
+                 return out;
+             })
+        .def_property_readonly("bin_count", &ChromaAnalyzer::binCount)
+        .def_property_readonly("fft_size", &ChromaAnalyzer::fftSize)
+        .def_property_readonly("latency", &ChromaAnalyzer::latency,
+             "Span of the lowest bin's kernel in input samples")
+        .def_property_readonly("hops_processed", &ChromaAnalyzer::hopsProcessed)
+        .def_property_readonly("config", &ChromaAnalyzer::config);
+
+    py::enum_<WaitPolicy>(m, "WaitPolicy")
+        .value("SPIN", WaitPolicy::Spin)
+        .value("SLEEP", WaitPolicy::Sleep);
+
+    py::enum_<JobSchedule>(m, "JobSchedule")
+        .value("SHARED_CURSOR", JobSchedule::SharedCursor)
+        .value("WORK_STEALING", JobSchedule::WorkStealing);
+
+    py::enum_<ReductionMode>(m, "ReductionMode")
+        .value("PAIRWISE", ReductionMode::Pairwise)
+        .value("COMPENSATED", ReductionMode::Compensated);
+
+    py::class_<WorkerPoolConfig>(m, "WorkerPoolConfig")
+        .def(py::init<>())
+        .def_readwrite("num_threads", &WorkerPoolConfig::num_threads)
+        .def_readwrite("cpu_affinity", &WorkerPoolConfig::cpu_affinity)
+        .def_readwrite("reserved_cpus", &WorkerPoolConfig::reserved_cpus)
+        .def_readwrite("wait_policy", &WorkerPoolConfig::wait_policy)
+        .def_readwrite("spin_iterations", &WorkerPoolConfig::spin_iterations)
+        .def_readwrite("schedule", &WorkerPoolConfig::schedule)
+        .def_readwrite("reduction", &WorkerPoolConfig::reduction)
+        .def_readwrite("flush_denormals", &WorkerPoolConfig::flush_denormals)
+        .def_readwrite("realtime", &WorkerPoolConfig::realtime,
+                       "Real-time profile for the workers: MMCSS Pro Audio, 1 ms timer and no power "
+                       "throttling on Windows; SCHED_FIFO and 1 ns timer slack on Linux")
+        .def_readwrite("realtime_priority", &WorkerPoolConfig::realtime_priority);
+
+    py::class_<WorkerThreadStatus>(m, "WorkerThreadStatus")
+        .def_readonly("worker", &WorkerThreadStatus::worker)
+        .def_readonly("realtime", &WorkerThreadStatus::realtime)
+        .def_readonly("priority", &WorkerThreadStatus::priority)
+        .def_readonly("mmcss_task", &WorkerThreadStatus::mmcss_task)
+        .def_readonly("timer_resolution_ns", &WorkerThreadStatus::timer_resolution_ns)
+        .def_readonly("power_throttling_disabled", &WorkerThreadStatus::power_throttling_disabled)
+        .def_readonly("error", &WorkerThreadStatus::error);
+
+    py::enum_<FilterShape>(m, "FilterShape")
+        .value("LOW_PASS", FilterShape::LowPass)
+        .value("HIGH_PASS", FilterShape::HighPass)
+        .value("BAND_PASS", FilterShape::BandPass)
+        .value("RESONATOR", FilterShape::Resonator)
+        .value("NOTCH", FilterShape::Notch)
+        .value("PEAK", FilterShape::Peak)
+        .value("ALL_PASS", FilterShape::AllPass);
+
+    py::class_<BiquadCoefficients>(m, "BiquadCoefficients")
+        .def(py::init<>())
+        .def(py::init([](double b0, double b1, double b2, double a1, double a2) {
+                 BiquadCoefficients c;
+                 c.b0 = b0;
+                 c.b1 = b1;
+                 c.b2 = b2;
+                 c.a1 = a1;
+                 c.a2 = a2;
+                 return c;
+             }),
+             py::arg("b0"), py::arg("b1"), py::arg("b2"), py::arg("a1"), py::arg("a2"))
+        .def_readwrite("b0", &BiquadCoefficients::b0)
+        .def_readwrite("b1", &BiquadCoefficients::b1)
+        .def_readwrite("b2", &BiquadCoefficients::b2)
+        .def_readwrite("a1", &BiquadCoefficients::a1)
+        .def_readwrite("a2", &BiquadCoefficients::a2);
+
+    m.def("design_biquad", &designBiquad,
+          "RBJ cookbook biquad (a0 = 1) of the given shape at hz; gain_db applies to PEAK",
+          py::arg("shape"), py::arg("hz"), py::arg("q") = 0.7071067811865476, py::arg("sample_rate") = 48000.0,
+          py::arg("gain_db") = 0.0);
+
+    py::class_<EngineArenaConfig>(m, "EngineArenaConfig")
+        .def(py::init<>())
+        .def_readwrite("max_block", &EngineArenaConfig::max_block)
+        .def_readwrite("max_channels", &EngineArenaConfig::max_channels)
+        .def_readwrite("fft_size", &EngineArenaConfig::fft_size)
+        .def_readwrite("output_block", &EngineArenaConfig::output_block)
+        .def_readwrite("huge_pages", &EngineArenaConfig::huge_pages);
+
+    py::class_<ArenaStats>(m, "ArenaStats")
+        .def_readonly("bytes_reserved", &ArenaStats::bytes_reserved)
+        .def_readonly("bytes_used", &ArenaStats::bytes_used)
+        .def_readonly("huge_pages", &ArenaStats::huge_pages)
+        .def_readonly("transparent_huge_pages", &ArenaStats::transparent_huge_pages)
+        .def_readonly("node_state", &ArenaStats::node_state)
+        .def_readonly("scratch_spills", &ArenaStats::scratch_spills);
+
+    py::enum_<BenchmarkWorkload>(m, "BenchmarkWorkload")
+        .value("SIGNAL_SWEEP", BenchmarkWorkload::SignalSweep)
+        .value("WAVE", BenchmarkWorkload::Wave)
+        .value("BLOCK", BenchmarkWorkload::Block);
+
+    py::class_<BenchmarkConfig>(m, "BenchmarkConfig")
+        .def(py::init<>())
+        .def_readwrite("iterations", &BenchmarkConfig::iterations)
+        .def_readwrite("warmup", &BenchmarkConfig::warmup)
+        .def_readwrite("num_nodes", &BenchmarkConfig::num_nodes, "0 keeps the engine's node count")
+        .def_readwrite("threads", &BenchmarkConfig::threads, "0 keeps the engine's worker pool")
+        .def_readwrite("simd_level", &BenchmarkConfig::simd_level, "None keeps the engine's kernels")
+        .def_readwrite("workload", &BenchmarkConfig::workload)
+        .def_readwrite("block_size", &BenchmarkConfig::block_size)
+        .def_readwrite("sample_rate", &BenchmarkConfig::sample_rate);
+
+    py::class_<BenchmarkResult>(m, "BenchmarkResult")
+        .def_readonly("config", &BenchmarkResult::config)
+        .def_readonly("kernel_name", &BenchmarkResult::kernel_name)
+        .def_readonly("num_nodes", &BenchmarkResult::num_nodes)
+        .def_readonly("threads", &BenchmarkResult::threads)
+        .def_readonly("mean_ns", &BenchmarkResult::mean_ns)
+        .def_readonly("median_ns", &BenchmarkResult::median_ns)
+        .def_readonly("p95_ns", &BenchmarkResult::p95_ns)
+        .def_readonly("p99_ns", &BenchmarkResult::p99_ns)
+        .def_readonly("max_ns", &BenchmarkResult::max_ns)
+        .def_readonly("min_ns", &BenchmarkResult::min_ns)
+        .def_readonly("stddev_ns", &BenchmarkResult::stddev_ns)
+        .def_readonly("total_ns", &BenchmarkResult::total_ns)
+        .def_readonly("iterations_per_second", &BenchmarkResult::iterations_per_second)
+        .def_readonly("node_updates_per_second", &BenchmarkResult::node_updates_per_second)
+        .def_readonly("realtime_factor", &BenchmarkResult::realtime_factor)
+        .def_readonly("samples_ns", &BenchmarkResult::samples_ns)
+        .def("to_latency_json", &BenchmarkResult::toLatencyJson,
+             "Serialize in the benchmarks/latency_v1.1.json layout",
+             py::arg("git_commit") = "unknown");
+
+    py::enum_<ScalingPlacement>(m, "ScalingPlacement")
+        .value("UNPINNED", ScalingPlacement::Unpinned)
+        .value("CORES", ScalingPlacement::Cores)
+        .value("SIBLINGS", ScalingPlacement::Siblings)
+        .value("SPREAD", ScalingPlacement::Spread);
+
+    py::class_<ScalingConfig>(m, "ScalingConfig")
+        .def(py::init<>())
+        .def_readwrite("runs", &ScalingConfig::runs)
+        .def_readwrite("max_threads", &ScalingConfig::max_threads, "0 sweeps up to every available CPU")
+        .def_readwrite("iterations", &ScalingConfig::iterations)
+        .def_readwrite("placement", &ScalingConfig::placement);
+
+    py::class_<ScalingPoint>(m, "ScalingPoint")
+        .def_readonly("threads", &ScalingPoint::threads)
+        .def_readonly("cpus", &ScalingPoint::cpus)
+        .def_readonly("mean_ns", &ScalingPoint::mean_ns)
+        .def_readonly("best_ns", &ScalingPoint::best_ns)
+        .def_readonly("speedup", &ScalingPoint::speedup)
+        .def_readonly("efficiency", &ScalingPoint::efficiency)
+        .def_readonly("node_updates_per_second", &ScalingPoint::node_updates_per_second);
+
+    py::enum_<NodeLayout>(m, "NodeLayout")
+        .value("OBJECTS", NodeLayout::Objects)
+        .value("BANK", NodeLayout::Bank)
+        .value("BANK_SCALAR", NodeLayout::BankScalar)
+        .value("BANK_F32", NodeLayout::BankF32)
+        .value("BANK_F16", NodeLayout::BankF16)
+        .value("BANK_BF16", NodeLayout::BankBF16)
+        .value("BANK_Q16", NodeLayout::BankQ16);
+
+    py::enum_<NodeStateFormat>(m, "NodeStateFormat")
+        .value("HALF", NodeStateFormat::Half)
+        .value("BFLOAT16", NodeStateFormat::BFloat16)
+        .value("FIXED16", NodeStateFormat::Fixed16);
+
+    py::class_<CompactDriftConfig>(m, "CompactDriftConfig")
+        .def(py::init<>())
+        .def_readwrite("num_nodes", &CompactDriftConfig::num_nodes)
+        .def_readwrite("block_size", &CompactDriftConfig::block_size)
+        .def_readwrite("blocks", &CompactDriftConfig::blocks)
+        .def_readwrite("sample_rate", &CompactDriftConfig::sample_rate)
+        .def_readwrite("frequency", &CompactDriftConfig::frequency)
+        .def_readwrite("max_feedback", &CompactDriftConfig::max_feedback)
+        .def_readwrite("fixed_range", &CompactDriftConfig::fixed_range)
+        .def_readwrite("formats", &CompactDriftConfig::formats);
+
+    py::class_<CompactDriftResult>(m, "CompactDriftResult")
+        .def_readonly("format", &CompactDriftResult::format)
+        .def_readonly("bytes_per_node", &CompactDriftResult::bytes_per_node)
+        .def_readonly("float_bytes_per_node", &CompactDriftResult::float_bytes_per_node)
+        .def_readonly("max_abs_error", &CompactDriftResult::max_abs_error)
+        .def_readonly("rms_error", &CompactDriftResult::rms_error)
+        .def_readonly("reference_rms", &CompactDriftResult::reference_rms)
+        .def_readonly("relative_rms_error", &CompactDriftResult::relative_rms_error)
+        .def_readonly("final_rms_error", &CompactDriftResult::final_rms_error)
+        .def_readonly("ns_per_node_sample", &CompactDriftResult::ns_per_node_sample)
+        .def_readonly("float_ns_per_node_sample", &CompactDriftResult::float_ns_per_node_sample);
+
+    py::class_<QualitySweepConfig>(m, "QualitySweepConfig")
+        .def(py::init<>())
+        .def_readwrite("num_nodes", &QualitySweepConfig::num_nodes)
+        .def_readwrite("waves", &QualitySweepConfig::waves)
+        .def_readwrite("block_size", &QualitySweepConfig::block_size)
+        .def_readwrite("blocks", &QualitySweepConfig::blocks)
+        .def_readwrite("sample_rate", &QualitySweepConfig::sample_rate)
+        .def_readwrite("frequency", &QualitySweepConfig::frequency)
+        .def_readwrite("levels", &QualitySweepConfig::levels);
+
+    py::class_<QualityLevelResult>(m, "QualityLevelResult")
+        .def_readonly("quality", &QualityLevelResult::quality)
+        .def_readonly("wave_max_abs_error", &QualityLevelResult::wave_max_abs_error)
+        .def_readonly("wave_rms_error", &QualityLevelResult::wave_rms_error)
+        .def_readonly("wave_relative_rms_error", &QualityLevelResult::wave_relative_rms_error)
+        .def_readonly("block_max_abs_error", &QualityLevelResult::block_max_abs_error)
+        .def_readonly("block_rms_error", &QualityLevelResult::block_rms_error)
+        .def_readonly("block_relative_rms_error", &QualityLevelResult::block_relative_rms_error)
+        .def_readonly("wave_ns", &QualityLevelResult::wave_ns)
+        .def_readonly("full_wave_ns", &QualityLevelResult::full_wave_ns)
+        .def_readonly("block_ns_per_node_sample", &QualityLevelResult::block_ns_per_node_sample)
+        .def_readonly("full_block_ns_per_node_sample", &QualityLevelResult::full_block_ns_per_node_sample);
+
+    py::class_<NodeScalingConfig>(m, "NodeScalingConfig")
+        .def(py::init<>())
+        .def_readwrite("min_nodes", &NodeScalingConfig::min_nodes)
+        .def_readwrite("max_nodes", &NodeScalingConfig::max_nodes)
+        .def_readwrite("points_per_octave", &NodeScalingConfig::points_per_octave)
+        .def_readwrite("min_iterations", &NodeScalingConfig::min_iterations)
+        .def_readwrite("target_ms", &NodeScalingConfig::target_ms)
+        .def_readwrite("max_bytes", &NodeScalingConfig::max_bytes, "Points allocating more are skipped")
+        .def_readwrite("layouts", &NodeScalingConfig::layouts)
+        .def_readwrite("cliff_threshold", &NodeScalingConfig::cliff_threshold);
+
+    py::class_<NodeScalingPoint>(m, "NodeScalingPoint")
+        .def_readonly("layout", &NodeScalingPoint::layout)
+        .def_readonly("nodes", &NodeScalingPoint::nodes)
+        .def_readonly("iterations", &NodeScalingPoint::iterations)
+        .def_readonly("ns_per_node_step", &NodeScalingPoint::ns_per_node_step)
+        .def_readonly("best_ns_per_node_step", &NodeScalingPoint::best_ns_per_node_step)
+        .def_readonly("allocated_bytes_per_node", &NodeScalingPoint::allocated_bytes_per_node)
+        .def_readonly("resident_bytes_per_node", &NodeScalingPoint::resident_bytes_per_node)
+        .def_readonly("working_set_bytes", &NodeScalingPoint::working_set_bytes)
+        .def_readonly("cache_level", &NodeScalingPoint::cache_level);
+
+    py::class_<CacheCliff>(m, "CacheCliff")
+        .def_readonly("layout", &CacheCliff::layout)
+        .def_readonly("last_fast_nodes", &CacheCliff::last_fast_nodes)
+        .def_readonly("nodes", &CacheCliff::nodes)
+        .def_readonly("slowdown", &CacheCliff::slowdown)
+        .def_readonly("cache_level", &CacheCliff::cache_level);
+
+    py::class_<CpuCaches>(m, "CpuCaches")
+        .def_readonly("l1d", &CpuCaches::l1d)
+        .def_readonly("l2", &CpuCaches::l2)
+        .def_readonly("llc", &CpuCaches::llc);
+
+    py::class_<NodeScalingResult>(m, "NodeScalingResult")
+        .def_readonly("caches", &NodeScalingResult::caches)
+        .def_readonly("threads", &NodeScalingResult::threads)
+        .def_readonly("points", &NodeScalingResult::points)
+        .def_readonly("cliffs", &NodeScalingResult::cliffs);
+
+    py::enum_<ProfilingMode>(m, "ProfilingMode")
+        .value("OFF", ProfilingMode::Off)
+        .value("SAMPLED", ProfilingMode::Sampled)
+        .value("FULL", ProfilingMode::Full);
+
+    py::enum_<timeline_trace::TraceLevel>(m, "TraceLevel")
+        .value("OFF", timeline_trace::TraceLevel::Off)
+        .value("REGIONS", timeline_trace::TraceLevel::Regions)
+        .value("CHUNKS", timeline_trace::TraceLevel::Chunks);
+
+    py::enum_<LatencyProbe>(m, "LatencyProbe")
+        .value("ENGINE_BLOCK", LatencyProbe::EngineBlock)
+        .value("WAVE_SWEEP", LatencyProbe::WaveSweep)
+        .value("NODE_BLOCK", LatencyProbe::NodeBlock);
+
+    py::enum_<DeadlineStage>(m, "DeadlineStage")
+        .value("ENGINE_BLOCK", DeadlineStage::EngineBlock)
+        .value("CHROMATIC_BLOCK", DeadlineStage::ChromaticBlock)
+        .value("FILTER_BLOCK", DeadlineStage::FilterBlock);
+
+    py::class_<DeadlineHealth>(m, "DeadlineHealth")
+        .def_readonly("calls", &DeadlineHealth::calls)
+        .def_readonly("misses", &DeadlineHealth::misses)
+        .def_readonly("near_misses", &DeadlineHealth::near_misses)
+        .def_readonly("consecutive_misses", &DeadlineHealth::consecutive_misses)
+        .def_readonly("max_consecutive_misses", &DeadlineHealth::max_consecutive_misses)
+        .def_readonly("last_ns", &DeadlineHealth::last_ns)
+        .def_readonly("worst_ns", &DeadlineHealth::worst_ns)
+        .def_readonly("budget_ns", &DeadlineHealth::budget_ns)
+        .def_readonly("worst_load", &DeadlineHealth::worst_load);
+
+    py::class_<DeadlineEvent>(m, "DeadlineEvent")
+        .def_readonly("stage", &DeadlineEvent::stage)
+        .def_readonly("call", &DeadlineEvent::call)
+        .def_readonly("elapsed_ns", &DeadlineEvent::elapsed_ns)
+        .def_readonly("budget_ns", &DeadlineEvent::budget_ns)
+        .def_readonly("miss", &DeadlineEvent::miss);
+
+    py::class_<ActiveSetStats>(m, "ActiveSetStats")
+        .def_readonly("sweeps", &ActiveSetStats::sweeps)
+        .def_readonly("full_sweeps", &ActiveSetStats::full_sweeps)
+        .def_readonly("chunks_processed", &ActiveSetStats::chunks_processed)
+        .def_readonly("chunks_skipped", &ActiveSetStats::chunks_skipped)
+        .def_readonly("last_active_fraction", &ActiveSetStats::last_active_fraction);
+
+    py::class_<BlockStats>(m, "BlockStats")
+        .def_readonly("count", &BlockStats::count)
+        .def_readonly("mean", &BlockStats::mean)
+        .def_readonly("variance", &BlockStats::variance)
+        .def_readonly("rms", &BlockStats::rms)
+        .def_readonly("peak", &BlockStats::peak)
+        .def_readonly("min", &BlockStats::min)
+        .def_readonly("max", &BlockStats::max)
+        .def_readonly("histogram", &BlockStats::histogram)
+        .def_readonly("histogram_low", &BlockStats::histogram_low)
+        .def_readonly("histogram_high", &BlockStats::histogram_high)
+        .def_readonly("channel_mean", &BlockStats::channel_mean)
+        .def_readonly("channel_rms", &BlockStats::channel_rms)
+        .def_readonly("channel_peak", &BlockStats::channel_peak);
+
+    // Triple-buffered block publication: views alias the publisher's slot and
+    // stay unchanged until the next acquire(), after which they may be rewritten
+    py::enum_<PublishedBlockKind>(m, "PublishedBlockKind")
+        .value("BLOCK", PublishedBlockKind::Block)
+        .value("CHROMATIC", PublishedBlockKind::Chromatic);
+
+    py::class_<PublishedBlock>(m, "PublishedBlock")
+        .def_readonly("sequence", &PublishedBlock::sequence)
+        .def_readonly("kind", &PublishedBlock::kind)
+        .def_readonly("rows", &PublishedBlock::rows)
+        .def_readonly("samples", &PublishedBlock::samples)
+        .def_readonly("published_ns", &PublishedBlock::published_ns)
+        .def_readonly("node_count", &PublishedBlock::node_count)
+        .def_property_readonly("output", [](py::object self) {
+                 const PublishedBlock& b = self.cast<const PublishedBlock&>();
+                 py::array_t<float> view({static_cast<py::ssize_t>(b.rows), static_cast<py::ssize_t>(b.samples)},
+                                         b.output.data(), self);
+                 view.attr("setflags")(py::arg("write") = false);
+                 return view;
+             }, "[rows x samples] view of the block's outputs, until the next acquire()")
+        .def_property_readonly("node_outputs", [](py::object self) {
+                 const PublishedBlock& b = self.cast<const PublishedBlock&>();
+                 py::array_t<double> view(static_cast<py::ssize_t>(b.node_count), b.node_outputs.data(), self);
+                 view.attr("setflags")(py::arg("write") = false);
+                 return view;
+             }, "View of every node's output after the block (empty on the CUDA backend)");
+
+    py::class_<OutputPublisher>(m, "OutputPublisher",
+        "Lock-free triple buffer of an engine's completed blocks; one reader at a time")
+        .def("acquire", &OutputPublisher::acquire, py::return_value_policy::reference_internal,
+             "The latest published block, None before the first; valid until the next acquire()")
+        .def_property_readonly("has_new", &OutputPublisher::hasNew)
+        .def_property_readonly("max_rows", &OutputPublisher::maxRows)
+        .def_property_readonly("max_samples", &OutputPublisher::maxSamples)
+        .def_property_readonly("published", &OutputPublisher::published)
+        .def_property_readonly("skipped", &OutputPublisher::skipped)
+        .def_property_readonly("acquired", &OutputPublisher::acquired);
+
+    py::enum_<ComputeBackend>(m, "ComputeBackend")
+        .value("CPU", ComputeBackend::Cpu)
+        .value("CUDA", ComputeBackend::Cuda);
+
+    py::class_<NodeGroup>(m, "NodeGroup")
+        .def(py::init<>())
+        .def(py::init([](size_t first_node, size_t num_nodes, unsigned rate_divisor) {
+                 return NodeGroup{first_node, num_nodes, rate_divisor};
+             }), py::arg("first_node"), py::arg("num_nodes"), py::arg("rate_divisor"))
+        .def_readwrite("first_node", &NodeGroup::first_node)
+        .def_readwrite("num_nodes", &NodeGroup::num_nodes)
+        .def_readwrite("rate_divisor", &NodeGroup::rate_divisor);
+
+    py::class_<LatencySnapshot>(m, "LatencySnapshot")
+        .def_readonly("count", &LatencySnapshot::count)
+        .def_readonly("min_ns", &LatencySnapshot::min_ns)
+        .def_readonly("max_ns", &LatencySnapshot::max_ns)
+        .def_readonly("mean_ns", &LatencySnapshot::mean_ns)
+        .def_readonly("p50_ns", &LatencySnapshot::p50_ns)
+        .def_readonly("p90_ns", &LatencySnapshot::p90_ns)
+        .def_readonly("p99_ns", &LatencySnapshot::p99_ns)
+        .def_readonly("p999_ns", &LatencySnapshot::p999_ns)
+        .def_readonly("counts", &LatencySnapshot::counts)
+        .def("percentile", &LatencySnapshot::percentile,
+             "Latency in ns at quantile p in [0, 1]", py::arg("p"));
+
+    py::enum_<NodeStateColumn>(m, "NodeStateColumn")
+        .value("OUTPUT", NodeStateColumn::Output)
+        .value("INTEGRATOR_STATE", NodeStateColumn::IntegratorState)
+        .value("FEEDBACK_GAIN", NodeStateColumn::FeedbackGain)
+        .value("PREVIOUS_INPUT", NodeStateColumn::PreviousInput)
+        .value("INPUT_GAIN", NodeStateColumn::InputGain)
+        .value("TIME_CONSTANT", NodeStateColumn::TimeConstant)
+        .value("CLAMP_LOW", NodeStateColumn::ClampLow)
+        .value("CLAMP_HIGH", NodeStateColumn::ClampHigh)
+        .value("SPECTRAL_MIX", NodeStateColumn::SpectralMix);
+    bindNodeColumn<NodeBank>(m, "NodeColumn");
+    bindNodeColumn<NodeBankF32>(m, "NodeColumnF32");
+
+    py::class_<DeviceColumnView> device_column_class(m, "DeviceNodeColumn",
+        "Zero-copy view of one column of the engine's CUDA-resident node state; wrap with torch.from_dlpack()");
+    defDLPack<DeviceColumnView>(device_column_class, [](DeviceColumnView& view) {
+        AnalogCellularEngineAVX2& engine = *view.engine;
+        DLPackBuffer buffer;
+        {
+            EngineCall<AnalogCellularEngineAVX2> call(engine);
+            buffer.data = engine.deviceColumn(nodeColumnData(engine.bank, view.column));
+        }
+        if (!buffer.data) throw py::buffer_error("engine state is not on a CUDA device");
+        buffer.device = DLDevice{kDLCUDA, engine.getComputeDeviceOrdinal()};
+        buffer.dtype = DLPackBuffer::dtypeOf<double>();
+        buffer.shape[0] = static_cast<int64_t>(engine.bank.size());
+        return buffer;
+    });
+    device_column_class
+        .def("__len__", [](const DeviceColumnView& view) { return view.engine->bank.size(); })
+        .def_property_readonly("column", [](const DeviceColumnView& view) { return view.column; });
+
+    py::class_<SharedColumnView>(m, "SharedNodeColumn", py::buffer_protocol(),
+        "Zero-copy read-only view of a shared engine state column; wrap with numpy.asarray()")
+        .def_buffer(&sharedColumnBuffer)
+        .def("__len__", [](const SharedColumnView& view) { return view.reader->nodeCount(); })
+        .def_property_readonly("column", [](const SharedColumnView& view) { return view.column; });
+
+    // Reader end of AnalogCellularEngine.share_state in another process
+    py::class_<SharedStateReader, std::shared_ptr<SharedStateReader>>(m, "SharedEngineState",
+        "Read-only mapping of an engine's shared node state. Views alias the writer's columns; "
+        "a read is consistent when validate(seq) holds for the seq begin_read() returned before "
+        "it. read_column() makes a checked copy.")
+        .def(py::init<const std::string&>(), py::arg("name"))
+        .def_property_readonly("name", &SharedStateReader::name)
+        .def_property_readonly("num_nodes", &SharedStateReader::nodeCount)
+        .def_property_readonly("sequence", &SharedStateReader::sequence)
+        .def("begin_read", &SharedStateReader::beginRead, py::call_guard<py::gil_scoped_release>(),
+             "Wait until no write is in progress and return the sequence to validate against")
+        .def("validate", &SharedStateReader::validate,
+             "True if no write started since begin_read() returned seq", py::arg("seq"))
+        .def("column", [](const std::shared_ptr<SharedStateReader>& self, NodeStateColumn column) {
+                 return SharedColumnView{self, column};
+             },
+             "Zero-copy read-only view of one state column", py::arg("column"))
+        .def_property_readonly("outputs", [](const std::shared_ptr<SharedStateReader>& self) {
+                 return SharedColumnView{self, NodeStateColumn::Output};
+             },
+             "Zero-copy read-only view of every node's current output")
+        .def("read_column", [](const SharedStateReader& self, NodeStateColumn column, py::object out) {
+                 return self.scalarBytes() == sizeof(float) ? readSharedColumn<float>(self, column, out)
+                                                             : readSharedColumn<double>(self, column, out);
+             },
+             "Copy of one column no write overlapped, into out when given",
+             py::arg("column") = NodeStateColumn::Output, py::arg("out") = py::none());
+
+    m.attr("METRICS_RECORD_DTYPE") = metricsRecordDtype();
+    py::enum_<MetricsState>(m, "MetricsState")
+        .value("AWAKE", MetricsStateAwake)
+        .value("DREAMING", MetricsStateDreaming)
+        .value("DEEP_SLEEP", MetricsStateDeepSleep)
+        .value("REM", MetricsStateRem)
+        .value("TRANSITION", MetricsStateTransition)
+        .value("CRITICAL", MetricsStateCritical)
+        .value("IDLE", MetricsStateIdle);
+    m.attr("METRICS_RECORD_VALID") = kMetricsRecordValid;
+    m.attr("METRICS_RECORD_PHI_SENSOR") = kMetricsRecordPhiSensor;
+
+    // Reader end of a native metrics ring (dase_pipeline_host --metrics-ring)
+    py::class_<MetricsRingReader, std::shared_ptr<MetricsRingReader>>(m, "MetricsRing",
+        "Read-only mapping of a native metrics ring. records aliases every slot as a structured "
+        "array of METRICS_RECORD_DTYPE, record i in slot i % capacity; read_latest() makes a "
+        "checked copy of the newest ones.")
+        .def(py::init<const std::string&>(), py::arg("name"))
+        .def_property_readonly("name", &MetricsRingReader::name)
+        .def_property_readonly("capacity", &MetricsRingReader::capacity)
+        .def_property_readonly("head", &MetricsRingReader::head, "Records written so far")
+        .def_property_readonly("records", &metricsRingRecords,
+             "Zero-copy read-only view of every slot; a row read from it is intact while validate(frame_id)")
+        .def("validate", &MetricsRingReader::validate,
+             "True if record index has not been overwritten since it was read", py::arg("index"))
+        .def("read_latest", &readMetricsRing,
+             "Newest records, oldest first: at most max, none older than since, into out when given",
+             py::arg("max") = 64, py::arg("since") = 0, py::arg("out") = py::none());
+
+    // Writer end, for producers embedding the engine in Python and for tests
+    py::class_<MetricsRingWriter>(m, "MetricsRingWriter",
+        "Single writer of a named metrics ring; readers open it with MetricsRing(name)")
+        .def(py::init<const std::string&, size_t>(), py::arg("name"), py::arg("capacity") = 1024)
+        .def_property_readonly("name", &MetricsRingWriter::name)
+        .def_property_readonly("capacity", &MetricsRingWriter::capacity)
+        .def_property_readonly("head", &MetricsRingWriter::head)
+        .def("push", [](MetricsRingWriter& self, py::buffer record) {
+                 py::buffer_info info = record.request();
+                 if (static_cast<size_t>(info.itemsize * info.size) != sizeof(MetricsRecord)) {
+                     throw std::invalid_argument("record must hold " + std::to_string(sizeof(MetricsRecord)) +
+                                                 " bytes (one row of METRICS_RECORD_DTYPE)");
+                 }
+                 MetricsRecord r;
+                 std::memcpy(&r, info.ptr, sizeof(r));
+                 self.push(r);
+             },
+             "Append one record (a row of METRICS_RECORD_DTYPE or 96 bytes); frame_id is assigned",
+             py::arg("record"));
+
+    // Prometheus scrapes served natively, off the GIL and the audio path
+    py::class_<MetricsHttpServer>(m, "MetricsHttpServer",
+        "HTTP endpoint on its own thread answering GET /metrics with the engine's OpenMetrics payload")
+        .def(py::init([](const AnalogCellularEngineAVX2& engine, uint16_t port, const std::string& bind_address) {
+                 const AnalogCellularEngineAVX2* e = &engine;
+                 return std::make_unique<MetricsHttpServer>(
+                     [e](OpenMetricsWriter& w) { writeEngineOpenMetrics(w, *e); }, port, bind_address);
+             }),
+             py::arg("engine"), py::arg("port") = 9464, py::arg("bind_address") = "127.0.0.1",
+             py::keep_alive<1, 2>())
+        .def("stop", &MetricsHttpServer::stop, py::call_guard<py::gil_scoped_release>(),
+             "Stop serving and join the thread")
+        .def_property_readonly("port", &MetricsHttpServer::port, "Port listened on (the bound one for port 0)")
+        .def_property_readonly("scrapes", &MetricsHttpServer::scrapes)
+        .def_property_readonly("errors", &MetricsHttpServer::errors);
+
+    // Cluster clock offsets from kernel/NIC socket timestamps, off the GIL
+    py::enum_<TimestampSource>(m, "TimestampSource")
+        .value("USER", TimestampSource::User)
+        .value("KERNEL", TimestampSource::Kernel)
+        .value("HARDWARE", TimestampSource::Hardware);
+
+    py::class_<ClockSyncConfig>(m, "ClockSyncConfig")
+        .def(py::init<>())
+        .def_readwrite("hardware", &ClockSyncConfig::hardware)
+        .def_readwrite("window", &ClockSyncConfig::window)
+        .def_property("tx_stamp_wait_us",
+                      [](const ClockSyncConfig& c) { return static_cast<int64_t>(c.tx_stamp_wait.count()); },
+                      [](ClockSyncConfig& c, int64_t us) { c.tx_stamp_wait = std::chrono::microseconds(us); });
+
+    py::class_<ClockSyncSample>(m, "ClockSyncSample")
+        .def(py::init<>())
+        .def_readwrite("t1", &ClockSyncSample::t1)
+        .def_readwrite("t2", &ClockSyncSample::t2)
+        .def_readwrite("t3", &ClockSyncSample::t3)
+        .def_readwrite("t4", &ClockSyncSample::t4)
+        .def_readwrite("source", &ClockSyncSample::source)
+        .def_property_readonly("offset", &ClockSyncSample::offset)
+        .def_property_readonly("delay", &ClockSyncSample::delay);
+
+    py::class_<ClockOffsetEstimate>(m, "ClockOffsetEstimate")
+        .def_readonly("valid", &ClockOffsetEstimate::valid)
+        .def_readonly("offset_ns", &ClockOffsetEstimate::offset_ns)
+        .def_readonly("delay_ns", &ClockOffsetEstimate::delay_ns)
+        .def_readonly("error_bound_ns", &ClockOffsetEstimate::error_bound_ns)
+        .def_readonly("drift_ppm", &ClockOffsetEstimate::drift_ppm)
+        .def_readonly("jitter_ns", &ClockOffsetEstimate::jitter_ns)
+        .def_readonly("source", &ClockOffsetEstimate::source)
+        .def_readonly("samples", &ClockOffsetEstimate::samples)
+        .def_readonly("measured_at_ns", &ClockOffsetEstimate::measured_at_ns);
+
+    py::class_<ClockOffsetFilter>(m, "ClockOffsetFilter",
+        "Minimum-delay offset filter with a drift fit over the last window exchanges")
+        .def(py::init<size_t>(), py::arg("window") = 16)
+        .def("add", &ClockOffsetFilter::add, py::arg("sample"))
+        .def("estimate", &ClockOffsetFilter::estimate, py::arg("now_ns") = 0)
+        .def("reset", &ClockOffsetFilter::reset)
+        .def("__len__", &ClockOffsetFilter::size);
+
+    py::class_<ClockSyncServer>(m, "ClockSyncServer",
+        "UDP endpoint on its own thread answering clock sync requests with socket timestamps")
+        .def(py::init<uint16_t, const std::string&, const ClockSyncConfig&>(),
+             py::arg("port") = 9320, py::arg("bind_address") = "0.0.0.0", py::arg("config") = ClockSyncConfig())
+        .def("stop", &ClockSyncServer::stop, py::call_guard<py::gil_scoped_release>(),
+             "Stop serving and join the thread")
+        .def_property_readonly("port", &ClockSyncServer::port, "Port listened on (the bound one for port 0)")
+        .def_property_readonly("requests", &ClockSyncServer::requests)
+        .def_property_readonly("stamped_replies", &ClockSyncServer::stampedReplies);
+
+    py::class_<ClockSyncClient>(m, "ClockSyncClient",
+        "Offset of a ClockSyncServer's clock from the local one (remote minus local)")
+        .def(py::init<const std::string&, uint16_t, const ClockSyncConfig&>(),
+             py::arg("host"), py::arg("port") = 9320, py::arg("config") = ClockSyncConfig())
+        .def("exchange", [](ClockSyncClient& self, double timeout) {
+                 return self.exchange(std::chrono::microseconds(static_cast<int64_t>(timeout * 1e6)));
+             },
+             py::call_guard<py::gil_scoped_release>(), "One exchange; False on timeout (seconds)",
+             py::arg("timeout") = 0.1)
+        .def("burst", [](ClockSyncClient& self, size_t count, double interval, double timeout) {
+                 return self.burst(count, std::chrono::microseconds(static_cast<int64_t>(interval * 1e6)),
+                                   std::chrono::microseconds(static_cast<int64_t>(timeout * 1e6)));
+             },
+             py::call_guard<py::gil_scoped_release>(),
+             "count exchanges interval seconds apart; returns how many completed",
+             py::arg("count"), py::arg("interval") = 0.001, py::arg("timeout") = 0.1)
+        .def("estimate", &ClockSyncClient::estimate)
+        .def_property_readonly("exchanges", [](const ClockSyncClient& self) { return self.stats().exchanges; })
+        .def_property_readonly("timeouts", [](const ClockSyncClient& self) { return self.stats().timeouts; })
+        .def_property_readonly("rejected", [](const ClockSyncClient& self) { return self.stats().rejected; })
+        .def_property_readonly("last_sample", [](const ClockSyncClient& self) { return self.stats().last; })
+        .def_static("realtime_ns", &ClockSyncClient::realtimeNs);
+
+    // Cross-tier tracing: per-hop latency of blocks from the Φ sample to the WebSocket frame
+    py::enum_<TraceHop>(m, "TraceHop")
+        .value("SENSOR", TraceHop::Sensor)
+        .value("ENGINE", TraceHop::Engine)
+        .value("HYBRID_NODE", TraceHop::HybridNode)
+        .value("I2S", TraceHop::I2s)
+        .value("WEBSOCKET", TraceHop::WebSocket)
+        .def_property_readonly("label", [](TraceHop hop) { return traceHopName(hop); });
+    m.attr("TRACE_HOP_COUNT") = kTraceHopCount;
+    m.def("trace_now_ns", &traceNowNs, "The trace clock, CLOCK_REALTIME in ns");
+    m.def("make_trace_id", &makeTraceId, py::arg("source"), py::arg("sequence"));
+
+    py::class_<TraceClock>(m, "TraceClock",
+        "Maps one tier's timestamps onto the trace clock, by anchor or measured offset")
+        .def(py::init<>())
+        .def("anchor", &TraceClock::anchor, py::arg("local_ns"), py::arg("reference_ns"))
+        .def("anchor_micros", &TraceClock::anchorMicros, py::arg("local_us"), py::arg("reference_ns"))
+        .def("set_offset", &TraceClock::setOffset, py::arg("estimate"))
+        .def("to_reference", &TraceClock::toReference, py::arg("local_ns"))
+        .def("from_micros", &TraceClock::fromMicros, py::arg("local_us"))
+        .def_property_readonly("synchronized", &TraceClock::synchronized)
+        .def_property_readonly("error_bound_ns", &TraceClock::errorBoundNs);
+
+    py::class_<TraceBreakdownSnapshot>(m, "TraceBreakdownSnapshot")
+        .def_property_readonly("hops", [](const TraceBreakdownSnapshot& s) {
+            return std::vector<LatencySnapshot>(s.hops, s.hops + kTraceHopCount);
+        })
+        .def("hop", [](const TraceBreakdownSnapshot& s, TraceHop hop) { return s.hops[static_cast<size_t>(hop)]; },
+             py::arg("hop"))
+        .def_readonly("end_to_end", &TraceBreakdownSnapshot::end_to_end)
+        .def_readonly("skewed", &TraceBreakdownSnapshot::skewed)
+        .def("share", &TraceBreakdownSnapshot::share, py::arg("hop"));
+
+    py::class_<TraceBreakdown>(m, "TraceBreakdown",
+        "Lock-free per-hop and end-to-end latency histograms over traced blocks")
+        .def(py::init<>())
+        .def("record_hop", &TraceBreakdown::recordHop, py::arg("hop"), py::arg("ns"))
+        .def("record_end_to_end", &TraceBreakdown::recordEndToEnd, py::arg("ns"))
+        .def("snapshot", &TraceBreakdown::snapshot)
+        .def("reset", &TraceBreakdown::reset);
+
+    // Flight recorder: the last seconds of per-block timings, dumped on a deadline miss or xrun
+    py::enum_<FlightEventKind>(m, "FlightEventKind")
+        .value("Block", FlightEventKind::Block)
+        .value("Parameter", FlightEventKind::Parameter)
+        .value("Marker", FlightEventKind::Marker);
+    m.attr("FLIGHT_DEADLINE_MISS") = static_cast<int>(kFlightDeadlineMiss);
+    m.attr("FLIGHT_XRUN") = static_cast<int>(kFlightXrun);
+    m.attr("FLIGHT_TRIGGER") = static_cast<int>(kFlightTrigger);
+    m.attr("FLIGHT_PARAMETER_SWITCH") = kFlightParameterSwitch;
+
+    py::class_<FlightRecorderConfig>(m, "FlightRecorderConfig")
+        .def(py::init<>())
+        .def_readwrite("capacity", &FlightRecorderConfig::capacity)
+        .def_readwrite("post_trigger", &FlightRecorderConfig::post_trigger)
+        .def_readwrite("trigger_on_deadline", &FlightRecorderConfig::trigger_on_deadline)
+        .def_readwrite("trigger_on_xrun", &FlightRecorderConfig::trigger_on_xrun)
+        .def_readwrite("directory", &FlightRecorderConfig::directory)
+        .def_readwrite("prefix", &FlightRecorderConfig::prefix)
+        .def_readwrite("max_dumps", &FlightRecorderConfig::max_dumps);
+
+    py::class_<FlightEvent>(m, "FlightEvent")
+        .def_readonly("time_ns", &FlightEvent::time_ns)
+        .def_readonly("block", &FlightEvent::block)
+        .def_readonly("source", &FlightEvent::source)
+        .def_readonly("thread_id", &FlightEvent::thread_id)
+        .def_readonly("duration_ns", &FlightEvent::duration_ns)
+        .def_readonly("budget_ns", &FlightEvent::budget_ns)
+        .def_readonly("queue_depth", &FlightEvent::queue_depth)
+        .def_property_readonly("kind", [](const FlightEvent& e) { return static_cast<FlightEventKind>(e.kind); })
+        .def_readonly("flags", &FlightEvent::flags)
+        .def_property_readonly("stage_ns", [](const FlightEvent& e) {
+                 return std::vector<uint32_t>(e.stage_ns, e.stage_ns + kFlightStages);
+             }, "Block events: stage times in the source's stage order")
+        .def_property_readonly("parameter_id", [](const FlightEvent& e) { return e.parameter.id; })
+        .def_property_readonly("parameter_node", [](const FlightEvent& e) { return e.parameter.node; })
+        .def_property_readonly("value", [](const FlightEvent& e) { return e.parameter.value; })
+        .def_property_readonly("previous", [](const FlightEvent& e) { return e.parameter.previous; });
+
+    py::class_<FlightSource>(m, "FlightSource")
+        .def_readonly("name", &FlightSource::name)
+        .def_readonly("stages", &FlightSource::stages);
+
+    py::class_<FlightRecording>(m, "FlightRecording")
+        .def_readonly("wall_ns", &FlightRecording::wall_ns)
+        .def_readonly("steady_ns", &FlightRecording::steady_ns)
+        .def_readonly("dropped", &FlightRecording::dropped)
+        .def_readonly("trigger_index", &FlightRecording::trigger_index)
+        .def_readonly("sources", &FlightRecording::sources)
+        .def_readonly("events", &FlightRecording::events);
+
+    py::class_<FlightRecorder>(m, "FlightRecorder",
+        "Ring of the last capacity fixed-size events (per-block stage times, thread ids, queue depths, "
+        "parameter changes); a deadline miss or xrun freezes it, and with a directory a background "
+        "thread dumps each frozen recording to <directory>/<prefix>-<n>.dfr and re-arms it")
+        .def(py::init<const FlightRecorderConfig&>(), py::arg("config") = FlightRecorderConfig())
+        .def("add_source", &FlightRecorder::addSource, py::arg("name"), py::arg("stages"))
+        .def_property_readonly("sources", &FlightRecorder::sources)
+        .def("trigger", &FlightRecorder::trigger, "Freeze as if the next event were a deadline miss")
+        .def_property_readonly("frozen", &FlightRecorder::frozen)
+        .def_property_readonly("triggered", &FlightRecorder::triggered)
+        .def("dump", &FlightRecorder::dump, py::call_guard<py::gil_scoped_release>(),
+             "Write the held events to path (while frozen or idle)", py::arg("path"))
+        .def("rearm", &FlightRecorder::rearm)
+        .def_property_readonly("capacity", &FlightRecorder::capacity)
+        .def_property_readonly("recorded", &FlightRecorder::recorded)
+        .def_property_readonly("dropped", &FlightRecorder::dropped)
+        .def_property_readonly("dumps", &FlightRecorder::dumps)
+        .def_property_readonly("last_dump", &FlightRecorder::lastDump)
+        .def_property_readonly("dump_error", &FlightRecorder::dumpError);
+
+    m.def("flight_capacity_for", &flightCapacityFor,
+          "Events a FlightRecorder needs to hold seconds of blocks",
+          py::arg("seconds"), py::arg("sample_rate"), py::arg("block_size"), py::arg("events_per_block") = 2);
+    m.def("read_flight_recording", &readFlightRecording, py::call_guard<py::gil_scoped_release>(),
+          "Read a .dfr flight recording", py::arg("path"));
+
+    // Binary, per-client delta-encoded metrics frames for WebSocket streaming
+    m.attr("METRICS_CODEC_VERSION") = kMetricsCodecVersion;
+    py::class_<MetricsFrameEncoder>(m, "MetricsFrameEncoder",
+        "Packs metrics records, an optional ICI matrix and per-channel arrays into binary frames, "
+        "each client's delta-encoded against the last frame it acknowledged; clients with the same "
+        "base share one encoding")
+        .def(py::init<size_t, bool>(), py::arg("history") = 128, py::arg("acknowledge_on_send") = false)
+        .def("add_frame", [](MetricsFrameEncoder& self, py::buffer record, py::object ici_matrix,
+                             py::object arrays) {
+                 py::buffer_info info = record.request();
+                 if (static_cast<size_t>(info.itemsize * info.size) != sizeof(MetricsRecord)) {
+                     throw std::invalid_argument("record must hold " + std::to_string(sizeof(MetricsRecord)) +
+                                                 " bytes (one row of METRICS_RECORD_DTYPE)");
+                 }
+                 MetricsPayload payload;
+                 std::memcpy(&payload.record, info.ptr, sizeof(MetricsRecord));
+                 if (!ici_matrix.is_none()) {
+                     const InputBlock<float> matrix = ici_matrix.cast<InputBlock<float>>();
+                     if (matrix.ndim() != 2 || matrix.shape(0) != matrix.shape(1)) {
+                         throw std::invalid_argument("ici_matrix must be square");
+                     }
+                     payload.matrix_channels = static_cast<uint32_t>(matrix.shape(0));
+                     payload.ici_matrix.assign(matrix.data(), matrix.data() + matrix.size());
+                 }
+                 if (!arrays.is_none()) {
+                     for (py::handle item : arrays) {
+                         const InputBlock<float> values = py::reinterpret_borrow<py::object>(item).cast<InputBlock<float>>();
+                         payload.arrays.emplace_back(values.data(), values.data() + values.size());
+                     }
+                 }
+                 return self.addFrame(std::move(payload));
+             },
+             "Add the next frame (a row of METRICS_RECORD_DTYPE or 96 bytes, a square float32 ICI "
+             "matrix, a sequence of float32 per-channel arrays); returns its sequence number",
+             py::arg("record"), py::arg("ici_matrix") = py::none(), py::arg("arrays") = py::none())
+        .def("add_client", &MetricsFrameEncoder::addClient,
+             "Register a client; its first frame is a keyframe")
+        .def("remove_client", &MetricsFrameEncoder::removeClient, py::arg("client"))
+        .def("acknowledge", &MetricsFrameEncoder::acknowledge,
+             "Record that the client decoded sequence; later frames are deltas against it",
+             py::arg("client"), py::arg("sequence"))
+        .def("encode_for", [](MetricsFrameEncoder& self, uint32_t client) {
+                 std::vector<uint8_t> message;
+                 {
+                     py::gil_scoped_release release;
+                     message = self.encodeFor(client);
+                 }
+                 return py::bytes(reinterpret_cast<const char*>(message.data()), message.size());
+             },
+             "Frames added since the last call for this client as one message ready to send "
+             "(empty bytes when there are none)", py::arg("client"))
+        .def("encode", [](MetricsFrameEncoder& self, uint32_t sequence, py::object base) {
+                 const std::vector<uint8_t>* bytes;
+                 if (base.is_none()) {
+                     bytes = &self.encode(sequence, nullptr);
+                 } else {
+                     const uint32_t b = base.cast<uint32_t>();
+                     bytes = &self.encode(sequence, &b);
+                 }
+                 return py::bytes(reinterpret_cast<const char*>(bytes->data()), bytes->size());
+             },
+             "One frame against base, or a keyframe when base is None",
+             py::arg("sequence"), py::arg("base") = py::none())
+        .def_property_readonly("history_size", &MetricsFrameEncoder::historySize)
+        .def_property_readonly("client_count", &MetricsFrameEncoder::clientCount)
+        .def_property_readonly("next_sequence", &MetricsFrameEncoder::nextSequence)
+        .def_property_readonly("bytes_encoded", &MetricsFrameEncoder::bytesEncoded)
+        .def_property_readonly("cache_hits", &MetricsFrameEncoder::cacheHits);
+
+    py::class_<MetricsFrameDecoder>(m, "MetricsFrameDecoder",
+        "Client side of MetricsFrameEncoder, keeping the last history frames as delta bases")
+        .def(py::init<size_t>(), py::arg("history") = 128)
+        .def("decode", [](MetricsFrameDecoder& self, const py::bytes& message) {
+                 const std::string data = message;
+                 std::vector<std::pair<uint32_t, MetricsPayload>> frames;
+                 self.decode(reinterpret_cast<const uint8_t*>(data.data()), data.size(), frames);
+                 py::list out;
+                 for (const auto& [sequence, payload] : frames) {
+                     py::array record(metricsRecordDtype(), std::vector<py::ssize_t>{1});
+                     std::memcpy(record.mutable_data(), &payload.record, sizeof(MetricsRecord));
+                     py::object matrix = py::none();
+                     if (payload.matrix_channels) {
+                         const auto c = static_cast<py::ssize_t>(payload.matrix_channels);
+                         py::array_t<float> values({c, c});
+                         std::copy(payload.ici_matrix.begin(), payload.ici_matrix.end(), values.mutable_data());
+                         matrix = values;
+                     }
+                     py::list arrays;
+                     for (const std::vector<float>& a : payload.arrays) {
+                         py::array_t<float> values(static_cast<py::ssize_t>(a.size()));
+                         std::copy(a.begin(), a.end(), values.mutable_data());
+                         arrays.append(values);
+                     }
+                     py::dict frame;
+                     frame["sequence"] = sequence;
+                     frame["record"] = record[py::int_(0)];
+                     frame["ici_matrix"] = matrix;
+                     frame["arrays"] = arrays;
+                     out.append(frame);
+                 }
+                 return out;
+             },
+             "Frames of one message, oldest first, as dicts of sequence, record (a METRICS_RECORD_DTYPE "
+             "row), ici_matrix (None without one) and arrays", py::arg("message"));
+
+    py::class_<EngineNodeList>(m, "NodeList")
+        .def("__len__", [](const EngineNodeList& list) { return list.engine->getNodeCount(); })
+        .def("__getitem__", [](EngineNodeList& list, py::ssize_t index) {
+                 py::ssize_t count = static_cast<py::ssize_t>(list.engine->getNodeCount());
+                 if (index < 0) index += count;
+                 if (index < 0 || index >= count) throw py::index_error("node index out of range");
+                 return list.engine->node(static_cast<size_t>(index));
+             }, py::keep_alive<0, 1>());
+
     // AnalogCellularEngineAVX2 class
-    py::class_<AnalogCellularEngineAVX2>(m, "AnalogCellularEngine")
+    py::class_<AnalogCellularEngineAVX2> engine_class(m, "AnalogCellularEngine",
+        "Cellular array of analog nodes.\n\n"
+        "Threading: sweeps, blocks, missions, benchmarks and state I/O run without the GIL, so "
+        "other Python threads keep running meanwhile. Such calls on one engine run one at a "
+        "time; calls from other threads wait. Metrics, latency histograms and traces can be "
+        "read from any thread at any time. Other methods (settings, node access) must not "
+        "overlap a running call on the same engine; issue them from the thread that drives it.");
+    engine_class
         .def(py::init<size_t>(), "Initialize engine with specified number of nodes",
              py::arg("num_nodes"))
-        .def("process_signal_wave", &AnalogCellularEngineAVX2::processSignalWaveAVX2,
+        .def("process_signal_wave", released(&AnalogCellularEngineAVX2::processSignalWaveAVX2),
              "Process signal wave through cellular array",
              py::arg("input_signal"), py::arg("control_pattern"))
-        .def("perform_signal_sweep", &AnalogCellularEngineAVX2::performSignalSweepAVX2,
+        .def("process_signal_waves", [](AnalogCellularEngineAVX2& self, const InputBlock<double>& inputs,
+                                        const InputBlock<double>& controls) {
+                 const size_t count = static_cast<size_t>(inputs.size());
+                 if (static_cast<size_t>(controls.size()) != count) {
+                     throw std::invalid_argument("control_patterns length differs from input_signals");
+                 }
+                 py::array_t<double> results(static_cast<py::ssize_t>(count));
+                 double* data = results.mutable_data();
+                 {
+                     EngineCall<AnalogCellularEngineAVX2> call(self);
+                     self.processSignalWaves(inputs.data(), controls.data(), count, data);
+                 }
+                 return results;
+             },
+             "process_signal_wave over each pair of inputs, in order; large engines run it in cache-sized node "
+             "tiles",
+             py::arg("input_signals"), py::arg("control_patterns"))
+        .def_property("wave_tile_nodes", &AnalogCellularEngineAVX2::getWaveTileNodes,
+             &AnalogCellularEngineAVX2::setWaveTileNodes,
+             "Nodes per process_signal_waves tile; set 0 to size tiles from the L2 cache")
+        .def("perform_signal_sweep", released(&AnalogCellularEngineAVX2::performSignalSweepAVX2),
              "Perform frequency sweep operation",
              py::arg("frequency"))
-        .def("run_builtin_benchmark", &AnalogCellularEngineAVX2::runBuiltinBenchmark,
+        .def("perform_signal_sweep_batch", [](AnalogCellularEngineAVX2& self, const InputBlock<double>& frequencies) {
+                 const size_t count = static_cast<size_t>(frequencies.size());
+                 py::array_t<double> results(static_cast<py::ssize_t>(count));
+                 double* data = results.mutable_data();
+                 {
+                     EngineCall<AnalogCellularEngineAVX2> call(self);
+                     self.performSignalSweepBatch(frequencies.data(), count, data);
+                 }
+                 return results;
+             },
+             "perform_signal_sweep of each frequency, every one from the current state, which is left as it "
+             "was; nodes and frequencies run in parallel",
+             py::arg("frequencies"))
+        .def("run_builtin_benchmark", released(&AnalogCellularEngineAVX2::runBuiltinBenchmark),
              "Run performance benchmark",
              py::arg("iterations") = 1000)
-        .def("run_massive_benchmark", &AnalogCellularEngineAVX2::runMassiveBenchmark,
+        .def("run_massive_benchmark", released(&AnalogCellularEngineAVX2::runMassiveBenchmark),
              "Run massive performance benchmark",
              py::arg("iterations") = 10000)
-        .def("run_drag_race_benchmark", &AnalogCellularEngineAVX2::runDragRaceBenchmark,
+        .def("run_benchmark", released(&AnalogCellularEngineAVX2::runBenchmark),
+             "Time a configurable workload and return its latency distribution",
+             py::arg("config") = BenchmarkConfig())
+        .def("run_drag_race_benchmark", released(&AnalogCellularEngineAVX2::runDragRaceBenchmark),
              "Run drag race benchmark",
              py::arg("num_runs") = 5)
-        .def("run_mission", &AnalogCellularEngineAVX2::runMission,
-             "Run mission loop",
-             py::arg("num_steps"))
-        .def("process_block_frequency_domain", &AnalogCellularEngineAVX2::processBlockFrequencyDomain,
-             "Process signal block in frequency domain",
+        .def("run_drag_race_scaling", released(&AnalogCellularEngineAVX2::runDragRaceScaling),
+             "Drag race thread-scaling sweep with speedup and parallel efficiency",
+             py::arg("config") = ScalingConfig())
+        .def("run_node_scaling", released(&AnalogCellularEngineAVX2::runNodeScaling),
+             "Wave sweep node-count scaling with memory footprint and cache cliffs per node layout",
+             py::arg("config") = NodeScalingConfig())
+        .def("run_compact_drift", released(&AnalogCellularEngineAVX2::runCompactDrift),
+             "Output error, footprint and speed of each compact state format against the float32 engine",
+             py::arg("config") = CompactDriftConfig())
+        .def("run_quality_sweep", released(&AnalogCellularEngineAVX2::runQualitySweep),
+             "Output error and speed of each compute quality level against full",
+             py::arg("config") = QualitySweepConfig())
+        .def("run_mission", released(&AnalogCellularEngineAVX2::runMission),
+             "Run mission loop; a mission resumed from a checkpoint starts at first_step=mission_resume_step",
+             py::arg("num_steps"), py::arg("first_step") = 0)
+        .def("process_block", &processEngineBlock<AnalogCellularEngineAVX2>,
+             "Advance every node through a block of shared input/control/aux streams (control None "
+             "for 1.0, aux None for 0.0); node-major [num_nodes x n] float32 outputs go into out when "
+             "given, else into a new array unless return_outputs is False",
+             py::arg("input"), py::arg("control") = py::none(), py::arg("aux") = py::none(),
+             py::arg("out") = py::none(), py::arg("return_outputs") = true)
+        .def("process_chromatic_block",
+             [](AnalogCellularEngineAVX2& self, const InputBlock<float>& input, double phi_phase, double phi_depth,
+                size_t num_channels, py::object node_stride, double sample_rate, py::object out,
+                py::object automation) {
+                 ChromaticBlockConfig config;
+                 config.num_channels = num_channels;
+                 config.node_stride = node_stride.is_none() ? num_channels : node_stride.cast<size_t>();
+                 config.sample_rate = sample_rate;
+                 config.phi_phase = phi_phase;
+                 config.phi_depth = phi_depth;
+                 const size_t n = static_cast<size_t>(input.size());
+                 float* out_data;
+                 if (out.is_none()) {
+                     out = py::array_t<float>({static_cast<py::ssize_t>(num_channels), static_cast<py::ssize_t>(n)});
+                     out_data = static_cast<float*>(py::reinterpret_borrow<py::array>(out).mutable_data());
+                 } else {
+                     out_data = outputBlock<float>(out, num_channels * n);
+                 }
+                 ParameterAutomation* automated = automation.is_none() ? nullptr : automation.cast<ParameterAutomation*>();
+                 if (automated && n > automated->maxBlock()) {
+                     throw py::value_error("block longer than the automation's max_block");
+                 }
+                 {
+                     EngineCall<AnalogCellularEngineAVX2> call(self);
+                     if (automated) {
+                         self.processChromaticBlock(input.data(), n, config, *automated, out_data);
+                     } else {
+                         self.processChromaticBlock(input.data(), n, config, out_data);
+                     }
+                 }
+                 return out;
+             },
+             "Chromatic field block: channel c runs node c * node_stride (num_channels by default) on "
+             "the input under its rotated Φ envelope; returns [num_channels x n] float32 outputs, "
+             "written into out when given. With a ParameterAutomation, phi_phase and phi_depth come "
+             "from its curves for the next n samples and its due feedback changes apply first.",
+             py::arg("input"), py::arg("phi_phase") = 0.0, py::arg("phi_depth") = 0.5,
+             py::arg("num_channels") = 8, py::arg("node_stride") = py::none(),
+             py::arg("sample_rate") = 48000.0, py::arg("out") = py::none(),
+             py::arg("automation") = py::none())
+        .def("set_flight_recorder",
+             [](AnalogCellularEngineAVX2& self, py::object recorder) {
+                 EngineCall<AnalogCellularEngineAVX2> call(self);
+                 self.setFlightRecorder(recorder.is_none() ? nullptr : recorder.cast<FlightRecorder*>());
+             },
+             "Record every process_chromatic_block (stage times, budget, parameter changes) into a "
+             "FlightRecorder under source 'dase'; None stops",
+             py::arg("recorder"), py::keep_alive<1, 2>())
+        .def("configure_filter_nodes",
+             [](AnalogCellularEngineAVX2& self, size_t count, size_t sections) {
+                 EngineCall<AnalogCellularEngineAVX2> call(self);
+                 self.configureFilterNodes(count, sections);
+             },
+             "Replace the filter nodes with count pass-through nodes of 1-4 biquad sections each",
+             py::arg("count"), py::arg("sections") = 1)
+        .def_property_readonly("filter_node_count",
+             [](const AnalogCellularEngineAVX2& self) { return self.filterBank().size(); })
+        .def_property_readonly("filter_sections",
+             [](const AnalogCellularEngineAVX2& self) { return self.filterBank().sections(); })
+        .def("set_filter",
+             [](AnalogCellularEngineAVX2& self, size_t node, size_t section, const BiquadCoefficients& c) {
+                 EngineCall<AnalogCellularEngineAVX2> call(self);
+                 self.filterBank().setBiquad(node, section, c);
+             },
+             "Coefficients of one section of one filter node", py::arg("node"), py::arg("section"),
+             py::arg("coefficients"))
+        .def("get_filter",
+             [](AnalogCellularEngineAVX2& self, size_t node, size_t section) {
+                 EngineCall<AnalogCellularEngineAVX2> call(self);
+                 return self.filterBank().biquad(node, section);
+             },
+             py::arg("node"), py::arg("section") = 0)
+        .def("set_filter_section",
+             [](AnalogCellularEngineAVX2& self, size_t section, const InputBlock<double>& coefficients,
+                size_t first) {
+                 if (coefficients.ndim() != 2 || coefficients.shape(1) != 5) {
+                     throw std::invalid_argument("coefficients must have shape (count, 5): b0, b1, b2, a1, a2");
+                 }
+                 EngineCall<AnalogCellularEngineAVX2> call(self);
+                 self.filterBank().setSection(section, first, coefficients.data(),
+                                              static_cast<size_t>(coefficients.shape(0)));
+             },
+             "Section coefficients of filter nodes first.. from a (count, 5) array of b0, b1, b2, a1, a2",
+             py::arg("section"), py::arg("coefficients"), py::arg("first") = 0)
+        .def("reset_filter_state",
+             [](AnalogCellularEngineAVX2& self) {
+                 EngineCall<AnalogCellularEngineAVX2> call(self);
+                 self.filterBank().resetState();
+             },
+             "Zero the state of every filter node; coefficients stay")
+        .def("process_filter_block",
+             [](AnalogCellularEngineAVX2& self, const InputBlock<float>& input, py::object out) {
+                 const size_t count = self.filterBank().size();
+                 size_t n, stride;
+                 if (input.ndim() == 1) {
+                     n = static_cast<size_t>(input.shape(0));
+                     stride = 0;
+                 } else if (input.ndim() == 2 && static_cast<size_t>(input.shape(0)) == count) {
+                     n = static_cast<size_t>(input.shape(1));
+                     stride = n;
+                 } else {
+                     throw std::invalid_argument("input must be 1-D, or 2-D with one row per filter node");
+                 }
+                 float* out_data;
+                 if (out.is_none()) {
+                     out = py::array_t<float>({static_cast<py::ssize_t>(count), static_cast<py::ssize_t>(n)});
+                     out_data = static_cast<float*>(py::reinterpret_borrow<py::array>(out).mutable_data());
+                 } else {
+                     out_data = outputBlock<float>(out, count * n);
+                 }
+                 {
+                     EngineCall<AnalogCellularEngineAVX2> call(self);
+                     self.processFilterBlock(input.data(), stride, out_data, n);
+                 }
+                 return out;
+             },
+             "Run every filter node over a block: a 1-D input feeds all of them, a [filter_node_count x n] "
+             "input one row each; returns [filter_node_count x n] float32 outputs, written into out when given",
+             py::arg("input"), py::arg("out") = py::none())
+        .def("process_block_frequency_domain", &processFrequencyDomainBlock,
+             "Frequency-domain filter of a block, or of each row of a [channels, N] array, in place on "
+             "C-contiguous float32/float64 arrays (other sequences are filtered into a new float64 "
+             "array); returns the filtered array",
              py::arg("signal_block"))
+        .def("process_block_frequency_domain_batch",
+             [](AnalogCellularEngineAVX2& self, const InputBlock<float>& blocks, py::object masks, py::object out) {
+                 if (blocks.ndim() != 2) throw std::invalid_argument("blocks must be a [rows, N] array");
+                 const size_t rows = static_cast<size_t>(blocks.shape(0));
+                 const size_t n = static_cast<size_t>(blocks.shape(1));
+                 const size_t bins = n / 2 + 1;
+                 InputBlock<float> mask_holder;
+                 const float* mask_data = nullptr;
+                 size_t mask_stride = 0;
+                 if (!masks.is_none()) {
+                     mask_holder = masks.cast<InputBlock<float>>();
+                     if (mask_holder.ndim() == 1 && static_cast<size_t>(mask_holder.shape(0)) == bins) {
+                         mask_stride = 0;
+                     } else if (mask_holder.ndim() == 2 && static_cast<size_t>(mask_holder.shape(0)) == rows &&
+                                static_cast<size_t>(mask_holder.shape(1)) == bins) {
+                         mask_stride = bins;
+                     } else {
+                         throw std::invalid_argument("masks must have shape (N // 2 + 1,) or (rows, N // 2 + 1)");
+                     }
+                     mask_data = mask_holder.data();
+                 }
+                 float* out_data;
+                 if (out.is_none()) {
+                     out = py::array_t<float>({static_cast<py::ssize_t>(rows), static_cast<py::ssize_t>(n)});
+                     out_data = static_cast<float*>(py::reinterpret_borrow<py::array>(out).mutable_data());
+                 } else {
+                     out_data = outputBlock<float>(out, rows * n);
+                 }
+                 {
+                     EngineCall<AnalogCellularEngineAVX2> call(self);
+                     self.processBlockFrequencyDomainBatch(blocks.data(), out_data, rows, n, mask_data, mask_stride);
+                 }
+                 return out;
+             },
+             "Frequency-domain filter of every row of a [rows, N] block (e.g. process_block outputs) "
+             "with batched plans on the worker pool. masks weights the N // 2 + 1 bins, one mask for "
+             "all rows or one per row (None: the process_block_frequency_domain filter). Returns "
+             "float32 [rows, N], written into out when given (out may be blocks itself)",
+             py::arg("blocks"), py::arg("masks") = py::none(), py::arg("out") = py::none())
+        .def_property("fft_plan_rigor", &AnalogCellularEngineAVX2::getFFTPlanRigor,
+             &AnalogCellularEngineAVX2::setFFTPlanRigor,
+             "Planner effort for cached FFT plans")
+        .def_property("fft_backend", &AnalogCellularEngineAVX2::getFFTBackend,
+             &AnalogCellularEngineAVX2::setFFTBackend,
+             "FFT library of the frequency-domain paths; ValueError for one this build lacks")
+        .def_property("fft_threads", &AnalogCellularEngineAVX2::getFFTThreads,
+             &AnalogCellularEngineAVX2::setFFTThreads,
+             "FFTW threads for blocks of at least fft_thread_threshold samples (0: the worker pool size); "
+             "see fftw_threads_available()")
+        .def_property("fft_thread_threshold", &AnalogCellularEngineAVX2::getFFTThreadThreshold,
+             &AnalogCellularEngineAVX2::setFFTThreadThreshold,
+             "Smallest process_block_frequency_domain block transformed on several FFTW threads")
+        .def("load_fft_wisdom", &AnalogCellularEngineAVX2::loadFFTWisdom,
+             "Import FFTW wisdom from a file; returns False on failure",
+             py::arg("path"))
+        .def("save_fft_wisdom", &AnalogCellularEngineAVX2::saveFFTWisdom,
+             "Export accumulated FFTW wisdom to a file; returns False on failure",
+             py::arg("path"))
         .def("get_metrics", &AnalogCellularEngineAVX2::getMetrics,
              "Get current performance metrics")
+        .def("metrics_frame", &metricsFrame<AnalogCellularEngineAVX2>,
+             "Scalar metrics as one METRICS_FRAME_DTYPE record: written into out (a writeable buffer of "
+             "that size) when given, else returned as bytes",
+             py::arg("out") = py::none())
         .def("print_live_metrics", &AnalogCellularEngineAVX2::printLiveMetrics,
              "Print current performance metrics")
         .def("reset_metrics", &AnalogCellularEngineAVX2::resetMetrics,
              "Reset performance counters")
+        .def("set_profiling_mode", &AnalogCellularEngineAVX2::setProfilingMode,
+             "Select profiling level (sample_interval applies to SAMPLED)",
+             py::arg("mode"), py::arg("sample_interval") = 64)
+        .def_property_readonly("profiling_mode", &AnalogCellularEngineAVX2::getProfilingMode)
+        .def_property_readonly("profiling_sample_interval",
+             &AnalogCellularEngineAVX2::getProfilingSampleInterval)
+        .def("set_hardware_counters", &AnalogCellularEngineAVX2::setHardwareCounters,
+             "Count perf hardware events in timed scopes; returns False if unavailable",
+             py::arg("enabled"))
+        .def_property_readonly("hardware_counters", &AnalogCellularEngineAVX2::getHardwareCounters)
+        .def_static("hardware_counters_available", &AnalogCellularEngineAVX2::hardwareCountersAvailable)
+        .def("get_latency_histogram", &AnalogCellularEngineAVX2::getLatencyHistogram,
+             "Per-call latency distribution at a probe", py::arg("probe"))
+        .def("reset_latency_histograms", &AnalogCellularEngineAVX2::resetLatencyHistograms,
+             "Clear the latency histograms (safe while processing)")
+        .def("get_deadline_health",
+             [](const AnalogCellularEngineAVX2& self, DeadlineStage stage) {
+                 return self.deadlineWatchdog().health(stage);
+             },
+             "Deadline misses and near misses of a block entry point (lock-free)", py::arg("stage"))
+        .def("reset_deadline_health", [](AnalogCellularEngineAVX2& self) { self.deadlineWatchdog().reset(); })
+        .def("configure_deadline_watchdog",
+             [](AnalogCellularEngineAVX2& self, double sample_rate, double near_miss, bool enabled) {
+                 EngineCall<AnalogCellularEngineAVX2> call(self);
+                 self.deadlineWatchdog().setSampleRate(sample_rate);
+                 self.deadlineWatchdog().setNearMiss(near_miss);
+                 self.deadlineWatchdog().setEnabled(enabled);
+             },
+             "Sample rate budgeting process_block and process_filter_block, the near-miss fraction of "
+             "the budget and whether blocks are timed at all",
+             py::arg("sample_rate") = 48000.0, py::arg("near_miss") = 0.8, py::arg("enabled") = true)
+        .def("set_deadline_callback",
+             [](AnalogCellularEngineAVX2& self, py::object callback, bool on_near_miss) {
+                 DeadlineWatchdog::Callback native;
+                 if (!callback.is_none()) {
+                     // Copied and dropped off the GIL with the std::function
+                     std::shared_ptr<py::object> held(new py::object(callback), [](py::object* o) {
+                         py::gil_scoped_acquire gil;
+                         delete o;
+                     });
+                     native = [held](const DeadlineEvent& event) {
+                         py::gil_scoped_acquire gil;
+                         try {
+                             (*held)(event);
+                         } catch (py::error_already_set& e) {
+                             e.discard_as_unraisable("deadline callback");
+                         }
+                     };
+                 }
+                 EngineCall<AnalogCellularEngineAVX2> call(self);
+                 self.deadlineWatchdog().setCallback(std::move(native), on_near_miss);
+             },
+             "Call callback(DeadlineEvent) on the processing thread after a block over its budget, and "
+             "after a near miss with on_near_miss; it takes the GIL, so keep it short. None detaches.",
+             py::arg("callback"), py::arg("on_near_miss") = false)
+        .def("render_openmetrics", &engineOpenMetrics, py::call_guard<py::gil_scoped_release>(),
+             "Engine counters and latency histograms as one OpenMetrics text payload (lock-free reads)")
         .def("generate_noise_signal", &AnalogCellularEngineAVX2::generateNoiseSignal,
              "Generate random noise signal")
         .def("calculate_inter_node_coupling", &AnalogCellularEngineAVX2::calculateInterNodeCoupling,
              "Calculate coupling between nodes",
-             py::arg("node_index"));
+             py::arg("node_index"))
+        .def_property_readonly("num_nodes", &AnalogCellularEngineAVX2::getNodeCount)
+        .def("configure_workers", &AnalogCellularEngineAVX2::configureWorkers,
+             "Restart the worker pool with a new thread count, affinity and wait policy",
+             py::arg("config"))
+        .def_property_readonly("worker_count", &AnalogCellularEngineAVX2::getWorkerCount)
+        .def_property_readonly("worker_config", &AnalogCellularEngineAVX2::getWorkerConfig)
+        .def_property_readonly("denormal_jobs", &AnalogCellularEngineAVX2::getDenormalJobs,
+             "Worker jobs that underflowed into the subnormal range (flushed when flush_denormals is set)")
+        .def_property_readonly("worker_thread_status", &AnalogCellularEngineAVX2::getWorkerThreadStatus,
+             "Scheduling each background worker got under WorkerPoolConfig.realtime")
+        .def_property("kernel_mode", &AnalogCellularEngineAVX2::getKernelMode,
+             &AnalogCellularEngineAVX2::setKernelMode,
+             "Node kernel used by wave and mission sweeps")
+        .def_property("mission_schedule", &AnalogCellularEngineAVX2::getMissionSchedule,
+             &AnalogCellularEngineAVX2::setMissionSchedule,
+             "How run_mission sweeps its steps (FUSED unless coupling or noise runs between steps)")
+        .def_property("simd_level", &AnalogCellularEngineAVX2::getSimdLevel,
+             &AnalogCellularEngineAVX2::setSimdLevel,
+             "Instruction set of the node kernels (clamped to what the host supports)")
+        .def_property_readonly("kernel_name", &AnalogCellularEngineAVX2::getKernelName)
+        .def_property("node_pipeline", &AnalogCellularEngineAVX2::getNodePipeline,
+             &AnalogCellularEngineAVX2::setNodePipeline,
+             "Stage sequence of the node kernels, one compiled preset per value")
+        .def("set_grid_shape", &AnalogCellularEngineAVX2::setGridShape,
+             "Lay the nodes out on an nx x ny x nz grid (nz = 0 fits the node count), in linear or Morton order",
+             py::arg("nx"), py::arg("ny"), py::arg("nz") = 0, py::arg("order") = GridOrder::Linear)
+        .def_property_readonly("grid_shape", &AnalogCellularEngineAVX2::getGridShape)
+        .def("grid_node_at", [](const AnalogCellularEngineAVX2& self, size_t x, size_t y, size_t z) -> long long {
+                 const uint32_t node = self.getGridIndex().node(x, y, z);
+                 return node == GridIndex::kEmpty ? -1 : static_cast<long long>(node);
+             },
+             "Node at grid cell (x, y, z), -1 for an empty cell or one outside the grid",
+             py::arg("x"), py::arg("y"), py::arg("z"))
+        .def("grid_cell", [](const AnalogCellularEngineAVX2& self, size_t node) {
+                 if (node >= self.getGridIndex().count()) throw std::out_of_range("node index out of range");
+                 size_t x, y, z;
+                 self.getGridIndex().cell(node, x, y, z);
+                 return py::make_tuple(x, y, z);
+             },
+             "Grid cell (x, y, z) of a node", py::arg("node"))
+        .def("set_grid_coupling", &AnalogCellularEngineAVX2::setGridCoupling,
+             "Enable the 3-D neighbour coupling step after each wave sweep and mission step",
+             py::arg("stencil"), py::arg("strength"))
+        .def_property_readonly("grid_stencil", &AnalogCellularEngineAVX2::getGridStencil)
+        .def_property_readonly("grid_coupling_strength", &AnalogCellularEngineAVX2::getGridCouplingStrength)
+        .def("apply_grid_coupling", &AnalogCellularEngineAVX2::applyGridCoupling,
+             "Run one grid coupling step now")
+        .def("set_coupling_matrix", [](AnalogCellularEngineAVX2& self,
+                 py::array_t<uint64_t, py::array::c_style | py::array::forcecast> indptr,
+                 py::array_t<uint32_t, py::array::c_style | py::array::forcecast> indices,
+                 py::array_t<double, py::array::c_style | py::array::forcecast> weights) {
+                 std::vector<uint64_t> row_ptr(indptr.data(), indptr.data() + indptr.size());
+                 std::vector<uint32_t> col_index(indices.data(), indices.data() + indices.size());
+                 std::vector<double> w(weights.data(), weights.data() + weights.size());
+                 self.setCouplingMatrix(std::move(row_ptr), std::move(col_index), std::move(w));
+             },
+             "Load a CSR coupling matrix (e.g. scipy.sparse.csr_matrix indptr, indices, data) "
+             "applied as out += A @ out after each wave sweep and mission step",
+             py::arg("indptr"), py::arg("indices"), py::arg("weights"))
+        .def("clear_coupling_matrix", &AnalogCellularEngineAVX2::clearCouplingMatrix)
+        .def_property_readonly("coupling_edge_count", &AnalogCellularEngineAVX2::getCouplingEdgeCount)
+        .def_property_readonly("has_coupling_matrix", &AnalogCellularEngineAVX2::hasCouplingMatrix)
+        .def("apply_sparse_coupling", &AnalogCellularEngineAVX2::applySparseCoupling,
+             "Run one sparse coupling step now")
+        .def("save_state", released(&AnalogCellularEngineAVX2::saveState),
+             "Write the node state to a binary snapshot file",
+             py::arg("path"))
+        .def("load_state", released(&AnalogCellularEngineAVX2::loadState),
+             "Restore node state from a snapshot; MAP runs on a copy-on-write mapping of the file",
+             py::arg("path"), py::arg("mode") = SnapshotLoad::Map)
+        .def_property_readonly("state_mapped", &AnalogCellularEngineAVX2::isStateMapped)
+        .def_property_readonly("mission_resume_step", &AnalogCellularEngineAVX2::getMissionResumeStep,
+             "Mission step the last loaded snapshot was checkpointed at (0 for save_state files)")
+        .def("set_checkpointing", released(&AnalogCellularEngineAVX2::setCheckpointing),
+             "Checkpoint run_mission every config.interval_steps steps: the state is copied aside at a "
+             "step boundary and written to config.path in the background",
+             py::arg("config"))
+        .def_property_readonly("checkpointing", &AnalogCellularEngineAVX2::getCheckpointing)
+        .def_property_readonly("checkpoint_stats", &AnalogCellularEngineAVX2::getCheckpointStats)
+        .def("flush_checkpoints", released(&AnalogCellularEngineAVX2::flushCheckpoints),
+             "Wait until the newest checkpoint is on disk")
+        .def("start_recording", released(&AnalogCellularEngineAVX2::startRecording),
+             "Record node outputs after every wave sweep and mission step and at every block sample to "
+             "config.path; read it back with NodeRecording",
+             py::arg("config"))
+        .def("stop_recording", released(&AnalogCellularEngineAVX2::stopRecording),
+             "Write the remaining frames and close the recording")
+        .def_property_readonly("recording", &AnalogCellularEngineAVX2::isRecording)
+        .def_property_readonly("recording_stats", &AnalogCellularEngineAVX2::getRecorderStats)
+        .def("share_state", released(&AnalogCellularEngineAVX2::shareState),
+             "Move the node state into the named shared-memory segment; other processes read it with "
+             "SharedEngineState(name)",
+             py::arg("name"))
+        .def("unshare_state", released(&AnalogCellularEngineAVX2::unshareState),
+             "Copy the node state back into private memory and remove the shared segment")
+        .def_property_readonly("state_shared", &AnalogCellularEngineAVX2::isStateShared)
+        .def("reserve_arena", released(&AnalogCellularEngineAVX2::reserveArena),
+             "Move node state, block scratch, FFT buffers and an output block into one region "
+             "reserved up front, optionally on 2 MB huge pages",
+             py::arg("config") = EngineArenaConfig())
+        .def("release_arena", released(&AnalogCellularEngineAVX2::releaseArena),
+             "Copy the node state back into private memory and free the arena")
+        .def_property_readonly("arena_stats", &AnalogCellularEngineAVX2::getArenaStats)
+        .def_property_readonly("memory_bytes", &AnalogCellularEngineAVX2::getMemoryBytes,
+                               "Heap bytes of the node bank, filters, arena and block buffers")
+        .def("arena_output", &arenaOutputView<AnalogCellularEngineAVX2>,
+             "[num_nodes x n] view of the arena output block, for process_block(out=...)", py::arg("n"))
+        .def_property_readonly("shared_state_name", &AnalogCellularEngineAVX2::getSharedStateName)
+        .def_property_readonly("shared_state_sequence", &AnalogCellularEngineAVX2::getSharedStateSequence,
+             "Seqlock counter of the shared segment: odd while a step writes, even between steps")
+        .def_readwrite("noise_level", &AnalogCellularEngineAVX2::noise_level,
+             "Standard deviation of generated and injected noise")
+        .def_property("noise_seed", &AnalogCellularEngineAVX2::getNoiseSeed,
+             &AnalogCellularEngineAVX2::setNoiseSeed,
+             "Key of the counter-based noise generator (setting it restarts at step 0)")
+        .def_property("noise_injection", &AnalogCellularEngineAVX2::getNoiseInjection,
+             &AnalogCellularEngineAVX2::setNoiseInjection,
+             "Add noise_level * N(0, 1) to every node after each wave sweep and mission step")
+        .def_property_readonly("noise_step", &AnalogCellularEngineAVX2::getNoiseStep)
+        .def("fill_noise", [](const AnalogCellularEngineAVX2& self, uint64_t stream, uint64_t first, size_t n) {
+                 py::array_t<float> out(n);
+                 self.fillNoise(stream, first, out.mutable_data(), n);
+                 return out;
+             },
+             "n Gaussian samples of a noise stream starting at sample first",
+             py::arg("stream"), py::arg("first"), py::arg("n"))
+        .def("inject_noise", &AnalogCellularEngineAVX2::injectNoise,
+             "Run one noise injection step now")
+        .def_property("harmonic_count", &AnalogCellularEngineAVX2::getHarmonicCount,
+             &AnalogCellularEngineAVX2::setHarmonicCount,
+             "Harmonics added to each wave pass (1-64)")
+        .def_property("compute_quality", &AnalogCellularEngineAVX2::getComputeQuality,
+             &AnalogCellularEngineAVX2::setComputeQuality,
+             "Approximate compute level: wave passes, waves per sweep, harmonics and boost sine degree")
+        .def("set_node_equation", released(&AnalogCellularEngineAVX2::setNodeEquation),
+             "Step every node of process_block through user-defined equations (see NodeEquation), "
+             "compiled for the backend or taken from the cache",
+             py::arg("source"), py::arg("backend") = defaultNodeEquationBackend())
+        .def("clear_node_equation", released(&AnalogCellularEngineAVX2::clearNodeEquation),
+             "Go back to the built-in node model")
+        .def_property_readonly("node_equation",
+             [](const AnalogCellularEngineAVX2& self) -> py::object {
+                 const NodeEquation* equation = self.getNodeEquation();
+                 if (!equation) return py::none();
+                 py::dict result;
+                 result["backend"] = equation->backend();
+                 result["hash"] = equation->hash();
+                 result["canonical"] = equation->canonical();
+                 py::list columns;
+                 for (const NodeEquationColumn& column : equation->columns()) {
+                     py::dict entry;
+                     entry["name"] = column.name;
+                     entry["declared"] = column.declared;
+                     entry["assigned"] = column.assigned;
+                     entry["initial"] = column.initial;
+                     columns.append(entry);
+                 }
+                 result["columns"] = columns;
+                 result["body_instructions"] = equation->bodyInstructions();
+                 result["prologue_instructions"] = equation->prologueInstructions();
+                 result["compile_seconds"] = equation->compileSeconds();
+                 return result;
+             },
+             "Backend, hash, canonical text, columns and instruction counts of the node equation, or None")
+        .def("get_node_equation_column",
+             [](AnalogCellularEngineAVX2& self, const std::string& name) {
+                 EngineCall<AnalogCellularEngineAVX2> call(self);
+                 const double* column = self.nodeEquationColumn(name);
+                 if (!column) throw std::invalid_argument("no node equation state or param named '" + name + "'");
+                 return py::array_t<double>(static_cast<py::ssize_t>(self.getNodeCount()), column);
+             },
+             "Per-node values of a declared state or param of the node equation", py::arg("name"))
+        .def("set_node_equation_column",
+             [](AnalogCellularEngineAVX2& self, const std::string& name, const InputBlock<double>& values) {
+                 EngineCall<AnalogCellularEngineAVX2> call(self);
+                 double* column = self.nodeEquationColumn(name);
+                 if (!column) throw std::invalid_argument("no node equation state or param named '" + name + "'");
+                 const size_t count = static_cast<size_t>(values.size());
+                 if (count == 1) {
+                     std::fill(column, column + self.getNodeCount(), values.data()[0]);
+                 } else if (count == self.getNodeCount()) {
+                     std::copy(values.data(), values.data() + count, column);
+                 } else {
+                     throw std::invalid_argument("values must hold one value or one per node");
+                 }
+             },
+             "Set a declared state or param of the node equation, one value for every node or one per node",
+             py::arg("name"), py::arg("values"))
+        .def("set_active_set", &AnalogCellularEngineAVX2::setActiveSet,
+             "Skip settled 8-node chunks in process_signal_wave while its inputs stay within tolerance",
+             py::arg("enabled"), py::arg("tolerance") = 1e-6)
+        .def_property_readonly("active_set", &AnalogCellularEngineAVX2::getActiveSet)
+        .def_property_readonly("active_set_tolerance", &AnalogCellularEngineAVX2::getActiveSetTolerance)
+        .def_property_readonly("active_fraction", &AnalogCellularEngineAVX2::getActiveFraction,
+             "Nodes processed by the last wave sweep / all nodes")
+        .def_property_readonly("active_set_stats", &AnalogCellularEngineAVX2::getActiveSetStats)
+        .def("reset_active_set_stats", &AnalogCellularEngineAVX2::resetActiveSetStats)
+        .def("set_node_groups", released(&AnalogCellularEngineAVX2::setNodeGroups),
+             "Step each group's nodes on every rate_divisor-th sample of process_block, "
+             "interpolating their outputs in between",
+             py::arg("groups"))
+        .def("clear_node_groups", released(&AnalogCellularEngineAVX2::clearNodeGroups))
+        .def_property_readonly("node_groups", &AnalogCellularEngineAVX2::getNodeGroups)
+        .def("set_compute_backend", released(&AnalogCellularEngineAVX2::setComputeBackend),
+             "Run wave sweeps, missions and blocks on the CPU or keep the node state on a CUDA device",
+             py::arg("backend"))
+        .def_property_readonly("compute_backend", &AnalogCellularEngineAVX2::getComputeBackend)
+        .def("sync_compute_backend", released(&AnalogCellularEngineAVX2::syncComputeBackend),
+             "Copy device-resident node state back into the engine's columns")
+        .def_static("compute_backend_available", &AnalogCellularEngineAVX2::computeBackendAvailable,
+             py::arg("backend"))
+        .def_static("compute_device_name", &AnalogCellularEngineAVX2::computeDeviceName)
+        .def_property_readonly("block_work_fraction", &AnalogCellularEngineAVX2::getBlockWorkFraction,
+             "Node steps of a process_block call relative to running every node at full rate")
+        .def("device_column", [](AnalogCellularEngineAVX2& engine, NodeStateColumn column) {
+                 return DeviceColumnView{&engine, column};
+             }, py::keep_alive<0, 1>(),
+             "DLPack view of a column of the CUDA-resident node state (compute_backend CUDA); tensors "
+             "follow the device copy, which is current while calls run on the device and freed on "
+             "switching back to CPU",
+             py::arg("column"))
+        .def_property_readonly("compute_device_ordinal", &AnalogCellularEngineAVX2::getComputeDeviceOrdinal)
+        .def("set_block_stats", &AnalogCellularEngineAVX2::setBlockStats,
+             "Accumulate mean, variance, RMS, peak and an optional histogram of every block output "
+             "inside the node kernels",
+             py::arg("enabled"), py::arg("histogram_bins") = 0, py::arg("histogram_low") = -1.0,
+             py::arg("histogram_high") = 1.0)
+        .def_property_readonly("block_stats_enabled", &AnalogCellularEngineAVX2::getBlockStatsEnabled)
+        .def_property_readonly("block_stats", [](const AnalogCellularEngineAVX2& self) { return self.getBlockStats(); },
+             "Statistics of the last block's outputs (a copy)")
+        .def("set_output_publishing", &AnalogCellularEngineAVX2::setOutputPublishing,
+             "Publish every process_block and chromatic block through a lock-free triple buffer "
+             "(output_publisher) for blocks up to max_rows (0: the node count) by max_samples",
+             py::arg("enabled"), py::arg("max_samples") = 512, py::arg("max_rows") = 0)
+        .def_property_readonly("output_publishing", &AnalogCellularEngineAVX2::getOutputPublishing)
+        .def_property_readonly("output_publisher", &AnalogCellularEngineAVX2::outputPublisher,
+             py::return_value_policy::reference_internal,
+             "Reader side of the block publication, None while it is off; replaced by "
+             "set_output_publishing")
+        .def_property_readonly("nodes", [](AnalogCellularEngineAVX2& engine) {
+                 return EngineNodeList{&engine};
+             }, py::keep_alive<0, 1>(),
+             "Sequence of node views aliasing the engine's node bank");
+    defNodeColumns<AnalogCellularEngineAVX2>(engine_class);
+
+    // AnalogCellularEngineF32 class (float32 node state)
+    py::class_<AnalogCellularEngineF32> engine_f32_class(m, "AnalogCellularEngineF32",
+        "Float32 cellular engine; same threading rules as AnalogCellularEngine");
+    engine_f32_class
+        .def(py::init<size_t>(), "Initialize float32 engine with specified number of nodes",
+             py::arg("num_nodes"))
+        .def("process_signal_wave", released(&AnalogCellularEngineF32::processSignalWave),
+             "Process signal wave through cellular array",
+             py::arg("input_signal"), py::arg("control_pattern"))
+        .def("run_mission", released(&AnalogCellularEngineF32::runMission),
+             "Run mission loop",
+             py::arg("num_steps"))
+        .def("process_block", &processEngineBlock<AnalogCellularEngineF32>,
+             "Same contract as AnalogCellularEngine.process_block",
+             py::arg("input"), py::arg("control") = py::none(), py::arg("aux") = py::none(),
+             py::arg("out") = py::none(), py::arg("return_outputs") = true)
+        .def("get_node_output", &AnalogCellularEngineF32::getNodeOutput, py::arg("index"))
+        .def("get_node_integrator_state", &AnalogCellularEngineF32::getNodeIntegratorState,
+             py::arg("index"))
+        .def("set_node_feedback", &AnalogCellularEngineF32::setNodeFeedback,
+             py::arg("index"), py::arg("feedback_coefficient"))
+        .def("reset_state", &AnalogCellularEngineF32::resetState, "Zero all node state")
+        .def("set_block_stats", &AnalogCellularEngineF32::setBlockStats,
+             "Accumulate mean, variance, RMS, peak and an optional histogram of every block output "
+             "inside the node kernels",
+             py::arg("enabled"), py::arg("histogram_bins") = 0, py::arg("histogram_low") = -1.0,
+             py::arg("histogram_high") = 1.0)
+        .def_property_readonly("block_stats_enabled", &AnalogCellularEngineF32::getBlockStatsEnabled)
+        .def_property_readonly("block_stats", [](const AnalogCellularEngineF32& self) { return self.getBlockStats(); },
+             "Statistics of the last block's outputs (a copy)")
+        .def("reserve_arena", released(&AnalogCellularEngineF32::reserveArena),
+             "Same contract as AnalogCellularEngine.reserve_arena (fft_size is ignored)",
+             py::arg("config") = EngineArenaConfig())
+        .def("release_arena", released(&AnalogCellularEngineF32::releaseArena))
+        .def_property_readonly("arena_stats", &AnalogCellularEngineF32::getArenaStats)
+        .def("arena_output", &arenaOutputView<AnalogCellularEngineF32>, py::arg("n"))
+        .def("configure_workers", &AnalogCellularEngineF32::configureWorkers,
+             "Restart the worker pool with a new thread count, affinity and wait policy",
+             py::arg("config"))
+        .def_property_readonly("worker_count", &AnalogCellularEngineF32::getWorkerCount)
+        .def_property("mission_schedule", &AnalogCellularEngineF32::getMissionSchedule,
+             &AnalogCellularEngineF32::setMissionSchedule,
+             "How run_mission sweeps its steps")
+        .def_property("simd_level", &AnalogCellularEngineF32::getSimdLevel,
+             &AnalogCellularEngineF32::setSimdLevel,
+             "Instruction set of the node kernels (clamped to what the host supports)")
+        .def_property_readonly("kernel_name", &AnalogCellularEngineF32::getKernelName)
+        .def_property("node_pipeline", &AnalogCellularEngineF32::getNodePipeline,
+             &AnalogCellularEngineF32::setNodePipeline,
+             "Stage sequence of the node kernels, one compiled preset per value")
+        .def_property("harmonic_count", &AnalogCellularEngineF32::getHarmonicCount,
+             &AnalogCellularEngineF32::setHarmonicCount,
+             "Harmonics added to each wave pass (1-64)")
+        .def("get_metrics", &AnalogCellularEngineF32::getMetrics,
+             "Get current performance metrics")
+        .def("metrics_frame", &metricsFrame<AnalogCellularEngineF32>,
+             "Scalar metrics as one METRICS_FRAME_DTYPE record: written into out (a writeable buffer of "
+             "that size) when given, else returned as bytes",
+             py::arg("out") = py::none())
+        .def("reset_metrics", &AnalogCellularEngineF32::resetMetrics,
+             "Reset performance counters")
+        .def("get_latency_histogram", &AnalogCellularEngineF32::getLatencyHistogram,
+             "Per-call latency distribution at a probe", py::arg("probe"))
+        .def("reset_latency_histograms", &AnalogCellularEngineF32::resetLatencyHistograms,
+             "Clear the latency histograms (safe while processing)")
+        .def_property_readonly("num_nodes", &AnalogCellularEngineF32::getNodeCount);
+    defNodeColumns<AnalogCellularEngineF32>(engine_f32_class);
+
+    // AnalogCellularEngineCompact class (16-bit node state)
+    py::class_<AnalogCellularEngineCompact>(m, "AnalogCellularEngineCompact",
+        "Cellular engine with every node value stored in 16 bits (half, bfloat16 or fixed point over "
+        "+-fixed_range) and computed in float32; same threading rules as AnalogCellularEngine")
+        .def(py::init<size_t, NodeStateFormat, float>(), py::arg("num_nodes"),
+             py::arg("format") = NodeStateFormat::Half, py::arg("fixed_range") = CompactNodeBank::kDefaultFixedRange)
+        .def("process_signal_wave", released(&AnalogCellularEngineCompact::processSignalWave),
+             "Process signal wave through cellular array",
+             py::arg("input_signal"), py::arg("control_pattern"))
+        .def("run_mission", released(&AnalogCellularEngineCompact::runMission),
+             "Run mission loop (fused schedule)",
+             py::arg("num_steps"))
+        .def("process_block", &processEngineBlock<AnalogCellularEngineCompact>,
+             "Same contract as AnalogCellularEngine.process_block",
+             py::arg("input"), py::arg("control") = py::none(), py::arg("aux") = py::none(),
+             py::arg("out") = py::none(), py::arg("return_outputs") = true)
+        .def("get_node_output", &AnalogCellularEngineCompact::getNodeOutput, py::arg("index"))
+        .def("get_node_integrator_state", &AnalogCellularEngineCompact::getNodeIntegratorState,
+             py::arg("index"))
+        .def("set_node_feedback", &AnalogCellularEngineCompact::setNodeFeedback,
+             py::arg("index"), py::arg("feedback_coefficient"))
+        .def("reset_state", &AnalogCellularEngineCompact::resetState, "Zero all node state")
+        .def("set_block_stats", &AnalogCellularEngineCompact::setBlockStats,
+             "Accumulate mean, variance, RMS, peak and an optional histogram of every block output "
+             "inside the node kernels",
+             py::arg("enabled"), py::arg("histogram_bins") = 0, py::arg("histogram_low") = -1.0,
+             py::arg("histogram_high") = 1.0)
+        .def_property_readonly("block_stats_enabled", &AnalogCellularEngineCompact::getBlockStatsEnabled)
+        .def_property_readonly("block_stats", [](const AnalogCellularEngineCompact& self) { return self.getBlockStats(); },
+             "Statistics of the last block's outputs (a copy)")
+        .def("configure_workers", &AnalogCellularEngineCompact::configureWorkers,
+             "Restart the worker pool with a new thread count, affinity and wait policy",
+             py::arg("config"))
+        .def_property_readonly("worker_count", &AnalogCellularEngineCompact::getWorkerCount)
+        .def_property("simd_level", &AnalogCellularEngineCompact::getSimdLevel,
+             &AnalogCellularEngineCompact::setSimdLevel,
+             "Instruction set of the node kernels (clamped to what the host supports)")
+        .def_property_readonly("kernel_name", &AnalogCellularEngineCompact::getKernelName)
+        .def_property("node_pipeline", &AnalogCellularEngineCompact::getNodePipeline,
+             &AnalogCellularEngineCompact::setNodePipeline,
+             "Stage sequence of the node kernels, one compiled preset per value")
+        .def_property("harmonic_count", &AnalogCellularEngineCompact::getHarmonicCount,
+             &AnalogCellularEngineCompact::setHarmonicCount,
+             "Harmonics added to each wave pass (1-64)")
+        .def("get_metrics", &AnalogCellularEngineCompact::getMetrics,
+             "Get current performance metrics")
+        .def("get_latency_histogram", &AnalogCellularEngineCompact::getLatencyHistogram,
+             "Per-call latency distribution at a probe", py::arg("probe"))
+        .def_property_readonly("state_format", &AnalogCellularEngineCompact::getStateFormat)
+        .def_property_readonly("bytes_allocated", [](const AnalogCellularEngineCompact& self) {
+                 return self.bank.bytesAllocated();
+             },
+             "Bytes of node storage")
+        .def_property_readonly("num_nodes", &AnalogCellularEngineCompact::getNodeCount);
+
+    // EngineGroup: many engines advanced per block on one shared pool
+    py::class_<UdpHaloConfig>(m, "UdpHaloConfig")
+        .def(py::init<>())
+        .def_readwrite("port", &UdpHaloConfig::port)
+        .def_readwrite("below_host", &UdpHaloConfig::below_host)
+        .def_readwrite("below_port", &UdpHaloConfig::below_port)
+        .def_readwrite("above_host", &UdpHaloConfig::above_host)
+        .def_readwrite("above_port", &UdpHaloConfig::above_port)
+        .def_readwrite("datagram_bytes", &UdpHaloConfig::datagram_bytes)
+        .def_readwrite("socket_buffer", &UdpHaloConfig::socket_buffer);
+
+    py::class_<ShardConfig>(m, "ShardConfig")
+        .def(py::init<>())
+        .def_readwrite("nx", &ShardConfig::nx)
+        .def_readwrite("ny", &ShardConfig::ny)
+        .def_readwrite("nz", &ShardConfig::nz)
+        .def_readwrite("rank", &ShardConfig::rank)
+        .def_readwrite("ranks", &ShardConfig::ranks)
+        .def_readwrite("stencil", &ShardConfig::stencil)
+        .def_readwrite("strength", &ShardConfig::strength)
+        .def_property("halo_timeout_us",
+                      [](const ShardConfig& c) { return static_cast<int64_t>(c.halo_timeout.count()); },
+                      [](ShardConfig& c, int64_t us) { c.halo_timeout = std::chrono::microseconds(us); });
+
+    py::class_<ShardStepTiming>(m, "ShardStepTiming")
+        .def_readonly("compute_ns", &ShardStepTiming::compute_ns)
+        .def_readonly("send_ns", &ShardStepTiming::send_ns)
+        .def_readonly("interior_ns", &ShardStepTiming::interior_ns)
+        .def_readonly("wait_ns", &ShardStepTiming::wait_ns)
+        .def_readonly("boundary_ns", &ShardStepTiming::boundary_ns)
+        .def_readonly("total_ns", &ShardStepTiming::total_ns)
+        .def_property_readonly("communication_ns", &ShardStepTiming::communicationNs);
+
+    py::class_<ShardStats>(m, "ShardStats")
+        .def_readonly("steps", &ShardStats::steps)
+        .def_readonly("halo_timeouts", &ShardStats::halo_timeouts)
+        .def_readonly("bytes_sent", &ShardStats::bytes_sent)
+        .def_readonly("last", &ShardStats::last)
+        .def_readonly("total", &ShardStats::total)
+        .def_readonly("worst_wait_ns", &ShardStats::worst_wait_ns);
+
+    py::class_<GridShard>(m, "GridShard",
+        "One host's z-slab range of a grid engine sharded across hosts, halos exchanged over UDP")
+        .def(py::init([](const ShardConfig& config, const UdpHaloConfig& udp) {
+                 return std::make_unique<GridShard>(config, std::make_unique<UdpHaloTransport>(udp));
+             }),
+             py::arg("config"), py::arg("udp"))
+        .def_static("slab_range", [](size_t nz, size_t rank, size_t ranks) {
+                 size_t z_begin, z_end;
+                 GridShard::slabRange(nz, rank, ranks, z_begin, z_end);
+                 return py::make_tuple(z_begin, z_end);
+             },
+             "(first slab, end slab) of shard rank of ranks", py::arg("nz"), py::arg("rank"), py::arg("ranks"))
+        .def_property_readonly("engine", &GridShard::engine, py::return_value_policy::reference_internal)
+        .def_property_readonly("first_slab", &GridShard::firstSlab)
+        .def_property_readonly("slab_count", &GridShard::slabCount)
+        .def("step", [](GridShard& self, double input_signal, double control_pattern) {
+                 EngineCall<AnalogCellularEngineAVX2> call(self.engine());
+                 return self.step(input_signal, control_pattern);
+             },
+             "One step of the local nodes; every shard must run the same steps",
+             py::arg("input_signal"), py::arg("control_pattern"))
+        .def_property_readonly("stats", &GridShard::stats)
+        .def("reset_stats", &GridShard::resetStats);
+
+    py::class_<EngineGroup>(m, "EngineGroup")
+        .def(py::init<const WorkerPoolConfig&>(), "Create a group with its own worker pool",
+             py::arg("config") = WorkerPoolConfig())
+        .def("add", &EngineGroup::add, "Move an engine onto the group's worker pool", py::arg("engine"))
+        .def("remove", &EngineGroup::remove, "Give a member back a private worker pool", py::arg("engine"))
+        .def("__contains__", &EngineGroup::contains, py::arg("engine"))
+        .def_property_readonly("worker_count", &EngineGroup::getWorkerCount)
+        .def_property_readonly("worker_config", &EngineGroup::getWorkerConfig)
+        .def("process_blocks", [](EngineGroup& self, const std::vector<AnalogCellularEngineAVX2*>& engines,
+                                  const std::vector<py::array_t<float, py::array::c_style | py::array::forcecast>>& inputs,
+                                  py::object controls, py::object aux, bool return_outputs) -> py::object {
+                 using FloatArray = py::array_t<float, py::array::c_style | py::array::forcecast>;
+                 const size_t count = engines.size();
+                 if (inputs.size() != count) throw std::invalid_argument("need one input block per engine");
+                 auto optional_blocks = [&](py::object list, const char* what) {
+                     std::vector<FloatArray> arrays;
+                     if (list.is_none()) return arrays;
+                     arrays = list.cast<std::vector<FloatArray>>();
+                     if (arrays.size() != count) {
+                         throw std::invalid_argument(std::string("need one ") + what + " block per engine");
+                     }
+                     return arrays;
+                 };
+                 const std::vector<FloatArray> control_arrays = optional_blocks(controls, "control");
+                 const std::vector<FloatArray> aux_arrays = optional_blocks(aux, "aux");
+
+                 std::vector<StreamBlock> blocks(count);
+                 std::vector<FloatArray> outputs;
+                 for (size_t s = 0; s < count; s++) {
+                     StreamBlock& b = blocks[s];
+                     b.engine = engines[s];
+                     b.in = inputs[s].data();
+                     b.n = static_cast<size_t>(inputs[s].size());
+                     if (!control_arrays.empty()) {
+                         if (static_cast<size_t>(control_arrays[s].size()) != b.n) {
+                             throw std::invalid_argument("control block length differs from input");
+                         }
+                         b.control = control_arrays[s].data();
+                     }
+                     if (!aux_arrays.empty()) {
+                         if (static_cast<size_t>(aux_arrays[s].size()) != b.n) {
+                             throw std::invalid_argument("aux block length differs from input");
+                         }
+                         b.aux = aux_arrays[s].data();
+                     }
+                     if (return_outputs && b.engine) {
+                         outputs.emplace_back(std::vector<py::ssize_t>{
+                             static_cast<py::ssize_t>(b.engine->getNodeCount()), static_cast<py::ssize_t>(b.n)});
+                         b.out = outputs.back().mutable_data();
+                     }
+                 }
+                 {
+                     // Member call mutexes in address order, so concurrent groups cannot deadlock
+                     py::gil_scoped_release release;
+                     std::vector<AnalogCellularEngineAVX2*> members(engines);
+                     std::sort(members.begin(), members.end());
+                     members.erase(std::unique(members.begin(), members.end()), members.end());
+                     std::vector<std::unique_lock<std::mutex>> locks;
+                     for (AnalogCellularEngineAVX2* engine : members) {
+                         if (engine) locks.emplace_back(engine->callMutex());
+                     }
+                     self.processBlocks(blocks.data(), count);
+                 }
+                 if (!return_outputs) return py::none();
+                 return py::cast(outputs);
+             },
+             "Advance every engine by one block in a single scheduled pass; returns the "
+             "[num_nodes x n] outputs of each engine unless return_outputs is False",
+             py::arg("engines"), py::arg("inputs"), py::arg("controls") = py::none(),
+             py::arg("aux") = py::none(), py::arg("return_outputs") = true);
+
+    py::enum_<CorrelationMethod>(m, "CorrelationMethod")
+        .value("PEARSON", CorrelationMethod::Pearson)
+        .value("SPEARMAN", CorrelationMethod::Spearman);
+
+    py::class_<CorrelationKernel>(m, "CorrelationKernel",
+        "Pearson or Spearman correlation matrices of session series: cache-blocked SIMD dot products of "
+        "normalized rows on a worker pool, several metrics per call")
+        .def(py::init<SimdLevel, const WorkerPoolConfig&>(), py::arg("simd_level") = defaultSimdLevel(),
+             py::arg("config") = WorkerPoolConfig())
+        .def("compute", [](CorrelationKernel& self, const InputBlock<float>& data, CorrelationMethod method,
+                           py::object out) {
+                 if (data.ndim() != 2 && data.ndim() != 3) {
+                     throw std::invalid_argument("data must be (sessions, samples) or (metrics, sessions, samples)");
+                 }
+                 const bool stacked = data.ndim() == 3;
+                 const size_t metrics = stacked ? static_cast<size_t>(data.shape(0)) : 1;
+                 const size_t rows = static_cast<size_t>(data.shape(stacked ? 1 : 0));
+                 const size_t samples = static_cast<size_t>(data.shape(stacked ? 2 : 1));
+                 double* result = nullptr;
+                 if (!out.is_none()) {
+                     result = outputBlock<double>(out, metrics * rows * rows);
+                 } else {
+                     std::vector<py::ssize_t> shape = {static_cast<py::ssize_t>(rows), static_cast<py::ssize_t>(rows)};
+                     if (stacked) shape.insert(shape.begin(), static_cast<py::ssize_t>(metrics));
+                     out = py::array_t<double>(shape);
+                     result = static_cast<double*>(py::reinterpret_borrow<py::array>(out).mutable_data());
+                 }
+                 py::gil_scoped_release release;
+                 self.compute(data.data(), metrics, rows, samples, method, result);
+                 return out;
+             },
+             "Correlation matrix of each metric's rows: (sessions, sessions) float64 for 2-D data, "
+             "(metrics, sessions, sessions) for 3-D, into out when given. Rows of zero variance give NaN.",
+             py::arg("data"), py::arg("method") = CorrelationMethod::Pearson, py::arg("out") = py::none())
+        .def_property_readonly("worker_count", &CorrelationKernel::getWorkerCount)
+        .def_property_readonly("simd_level", &CorrelationKernel::getSimdLevel);
+
+    // Recorded sessions as mapped columns with per-chunk summaries
+    m.attr("SESSION_STORE_CHUNK_SAMPLES") = kSessionStoreChunkSamples;
+    m.def("write_session_store", [](const std::string& path, const std::vector<std::string>& names,
+                                    const InputBlock<double>& columns, double duration, size_t chunk_samples) {
+              if (columns.ndim() != 2 || static_cast<size_t>(columns.shape(0)) != names.size()) {
+                  throw std::invalid_argument("columns must be (len(names), samples)");
+              }
+              const size_t samples = static_cast<size_t>(columns.shape(1));
+              py::gil_scoped_release release;
+              writeSessionStore(path, names, columns.data(), samples, duration, chunk_samples);
+          },
+          "Write a session file of named float64 columns, one row of columns each, with min/max/mean/variance "
+          "summaries of every chunk_samples samples",
+          py::arg("path"), py::arg("names"), py::arg("columns"), py::arg("duration") = 0.0,
+          py::arg("chunk_samples") = kSessionStoreChunkSamples);
+
+    py::class_<SessionRangeStats>(m, "SessionRangeStats")
+        .def_readonly("count", &SessionRangeStats::count)
+        .def_readonly("min", &SessionRangeStats::min)
+        .def_readonly("max", &SessionRangeStats::max)
+        .def_readonly("mean", &SessionRangeStats::mean)
+        .def_readonly("variance", &SessionRangeStats::variance)
+        .def_property_readonly("std", [](const SessionRangeStats& s) { return std::sqrt(s.variance); });
+
+    py::class_<SessionColumnView>(m, "SessionColumn", py::buffer_protocol(),
+        "Zero-copy read-only view of one column of a session file; wrap with numpy.asarray()")
+        .def_buffer(&sessionColumnBuffer)
+        .def("__len__", [](const SessionColumnView& view) { return view.store->sampleCount(); })
+        .def_property_readonly("name", [](const SessionColumnView& view) {
+            return view.store->columnNames()[view.column];
+        });
+
+    py::class_<SessionStore, std::shared_ptr<SessionStore>>(m, "SessionStore",
+        "Session file mapped read-only: columns are served from the mapping without parsing, and range "
+        "statistics merge the stored chunk summaries, reading samples only at partial chunks")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def_property_readonly("path", &SessionStore::path)
+        .def_property_readonly("names", &SessionStore::columnNames)
+        .def_property_readonly("sample_count", &SessionStore::sampleCount)
+        .def_property_readonly("chunk_samples", &SessionStore::chunkSamples)
+        .def_property_readonly("chunk_count", &SessionStore::chunkCount)
+        .def_property_readonly("duration", &SessionStore::duration)
+        .def("__contains__", [](const SessionStore& self, const std::string& name) {
+            const auto& names = self.columnNames();
+            return std::find(names.begin(), names.end(), name) != names.end();
+        })
+        .def("column", [](const std::shared_ptr<SessionStore>& self, const std::string& name) {
+                 return SessionColumnView{self, self->columnIndex(name)};
+             },
+             "Zero-copy read-only view of a named column", py::arg("name"))
+        .def("chunk_summaries", [](const SessionStore& self, const std::string& name) {
+                 const SessionChunkSummary* chunks = self.chunks(self.columnIndex(name));
+                 py::array_t<double> out({static_cast<py::ssize_t>(self.chunkCount()), py::ssize_t(4)});
+                 if (self.chunkCount()) {
+                     std::memcpy(out.mutable_data(), chunks, self.chunkCount() * sizeof(SessionChunkSummary));
+                 }
+                 return out;
+             },
+             "(chunks, 4) float64 copy of a column's chunk summaries: min, max, mean, variance",
+             py::arg("name"))
+        .def("stats", [](const SessionStore& self, const std::string& name, size_t begin, py::object end) {
+                 const size_t stop = end.is_none() ? SIZE_MAX : end.cast<size_t>();
+                 return self.stats(self.columnIndex(name), begin, stop);
+             },
+             "Count, min, max, mean and population variance of samples [begin, end) of a column",
+             py::arg("name"), py::arg("begin") = 0, py::arg("end") = py::none())
+        .def("chunks_in_range", [](const SessionStore& self, const std::string& name, double lo, double hi) {
+                 return self.chunksInRange(self.columnIndex(name), lo, hi);
+             },
+             "Indices of the chunks of a column holding a value in [lo, hi], from the summaries alone",
+             py::arg("name"), py::arg("lo"), py::arg("hi"));
+
+    // Offline replay of recordings through memory-mapped audio files
+    py::enum_<AudioSampleFormat>(m, "AudioSampleFormat")
+        .value("FLOAT32", AudioSampleFormat::Float32)
+        .value("PCM16", AudioSampleFormat::Pcm16)
+        .value("PCM24", AudioSampleFormat::Pcm24)
+        .value("PCM32", AudioSampleFormat::Pcm32);
+
+    py::class_<AudioFileReader>(m, "AudioFile",
+        "A WAV (PCM 16/24/32-bit or float32) or raw float32 recording mapped read-only; blocks are "
+        "converted to float32 as they are read")
+        .def(py::init<const std::string&>(), py::arg("path"))
+        .def(py::init<const std::string&, size_t, double>(),
+             "Headerless interleaved float32", py::arg("path"), py::arg("channels"), py::arg("sample_rate"))
+        .def_property_readonly("path", &AudioFileReader::path)
+        .def_property_readonly("channels", &AudioFileReader::channels)
+        .def_property_readonly("frames", &AudioFileReader::frames)
+        .def_property_readonly("sample_rate", &AudioFileReader::sampleRate)
+        .def_property_readonly("format", &AudioFileReader::format)
+        .def_property_readonly("duration", &AudioFileReader::duration)
+        .def("read", [](const AudioFileReader& self, int channel, uint64_t first, py::object n) {
+                 const uint64_t available = first < self.frames() ? self.frames() - first : 0;
+                 const size_t count = n.is_none() ? static_cast<size_t>(available) : n.cast<size_t>();
+                 py::array_t<float> out(static_cast<py::ssize_t>(count));
+                 float* data = out.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     self.read(channel, first, count, data);
+                 }
+                 return out;
+             },
+             "n frames (default: to the end) of a channel from frame first, or the mean of every "
+             "channel for channel -1; frames past the end read as 0",
+             py::arg("channel") = -1, py::arg("first") = 0, py::arg("n") = py::none());
+
+    py::class_<OfflineReplayConfig>(m, "OfflineReplayConfig")
+        .def(py::init<>())
+        .def_readwrite("nodes", &OfflineReplayConfig::nodes)
+        .def_readwrite("block_size", &OfflineReplayConfig::block_size)
+        .def_readwrite("num_channels", &OfflineReplayConfig::num_channels)
+        .def_readwrite("phi_phase", &OfflineReplayConfig::phi_phase)
+        .def_readwrite("phi_depth", &OfflineReplayConfig::phi_depth)
+        .def_readwrite("input_channel", &OfflineReplayConfig::input_channel)
+        .def_readwrite("segments", &OfflineReplayConfig::segments)
+        .def_readwrite("warmup_blocks", &OfflineReplayConfig::warmup_blocks)
+        .def_readwrite("ici", &OfflineReplayConfig::ici)
+        .def_readwrite("workers", &OfflineReplayConfig::workers);
+
+    py::class_<OfflineReplayStats>(m, "OfflineReplayStats")
+        .def_readonly("frames", &OfflineReplayStats::frames)
+        .def_readonly("blocks", &OfflineReplayStats::blocks)
+        .def_readonly("segments", &OfflineReplayStats::segments)
+        .def_readonly("threads", &OfflineReplayStats::threads)
+        .def_readonly("seconds", &OfflineReplayStats::seconds)
+        .def_readonly("realtime_factor", &OfflineReplayStats::realtime_factor);
+
+    m.def("offline_replay", [](const AudioFileReader& input, const std::string& output, const std::string& metrics,
+                               const OfflineReplayConfig& config) {
+              py::gil_scoped_release release;
+              return runOfflineReplay(input, output, metrics, config);
+          },
+          "Replay a recording through fresh engines into a float32 WAV of the chromatic outputs, and "
+          "per-block time/input_rms/output_rms/ici into a session file at metrics unless it is empty; "
+          "segments run in parallel (segments=1 is the exact sequential replay)",
+          py::arg("input"), py::arg("output"), py::arg("metrics") = "",
+          py::arg("config") = OfflineReplayConfig());
+
+    // Batch renders of a preset x input manifest
+    py::class_<RenderPreset>(m, "RenderPreset")
+        .def_readonly("name", &RenderPreset::name)
+        .def_readonly("num_channels", &RenderPreset::num_channels)
+        .def_readonly("phi_depth", &RenderPreset::phi_depth)
+        .def_readonly("phi_phase", &RenderPreset::phi_phase)
+        .def_readonly("feedback", &RenderPreset::feedback)
+        .def_readonly("input_channel", &RenderPreset::input_channel)
+        .def_readonly("mix_l", &RenderPreset::mix_l)
+        .def_readonly("mix_r", &RenderPreset::mix_r);
+
+    py::class_<RenderInput>(m, "RenderInput")
+        .def_readonly("name", &RenderInput::name)
+        .def_readonly("path", &RenderInput::path)
+        .def_readonly("raw_channels", &RenderInput::raw_channels)
+        .def_readonly("raw_rate", &RenderInput::raw_rate);
+
+    py::class_<BatchRenderManifest>(m, "BatchRenderManifest",
+        "Presets, inputs and the (preset, input) jobs pairing them, from the text manifest format of "
+        "dase_batch_render")
+        .def_static("parse", &BatchRenderManifest::parse, py::arg("text"))
+        .def_static("load", &BatchRenderManifest::load, py::arg("path"))
+        .def_readonly("presets", &BatchRenderManifest::presets)
+        .def_readonly("inputs", &BatchRenderManifest::inputs)
+        .def_property_readonly("jobs", [](const BatchRenderManifest& self) {
+            std::vector<std::pair<size_t, size_t>> jobs;
+            for (const RenderJob& job : self.jobs) jobs.emplace_back(job.preset, job.input);
+            return jobs;
+        });
+
+    py::class_<BatchRenderConfig>(m, "BatchRenderConfig")
+        .def(py::init<>())
+        .def_readwrite("nodes", &BatchRenderConfig::nodes)
+        .def_readwrite("block_size", &BatchRenderConfig::block_size)
+        .def_readwrite("ici", &BatchRenderConfig::ici)
+        .def_readwrite("render_dir", &BatchRenderConfig::render_dir)
+        .def_readwrite("workers", &BatchRenderConfig::workers);
+
+    py::class_<BatchRenderStats>(m, "BatchRenderStats")
+        .def_readonly("jobs", &BatchRenderStats::jobs)
+        .def_readonly("threads", &BatchRenderStats::threads)
+        .def_readonly("frames", &BatchRenderStats::frames)
+        .def_readonly("audio_seconds", &BatchRenderStats::audio_seconds)
+        .def_readonly("seconds", &BatchRenderStats::seconds)
+        .def_readonly("jobs_per_second", &BatchRenderStats::jobs_per_second)
+        .def_readonly("realtime_factor", &BatchRenderStats::realtime_factor);
+
+    m.def("batch_render", [](const BatchRenderManifest& manifest, const std::string& results,
+                             const BatchRenderConfig& config) {
+              py::gil_scoped_release release;
+              return runBatchRender(manifest, results, config);
+          },
+          "Render every job of a manifest across one worker pool, each worker reusing its engine and FFT "
+          "plans from job to job, and write one row of metrics per job to a session file at results",
+          py::arg("manifest"), py::arg("results"), py::arg("config") = BatchRenderConfig());
+
+    py::class_<ForecastKernelConfig>(m, "ForecastKernelConfig")
+        .def(py::init<>())
+        .def_readwrite("trend_window", &ForecastKernelConfig::trend_window)
+        .def_readwrite("fit_window", &ForecastKernelConfig::fit_window)
+        .def_readwrite("stability_window", &ForecastKernelConfig::stability_window)
+        .def_readwrite("alpha", &ForecastKernelConfig::alpha)
+        .def_readwrite("beta", &ForecastKernelConfig::beta);
+
+    // Rows of ForecastKernel.forecast(): slope, r_squared, std, level, trend
+    auto forecastRows = [](const ForecastKernel& self) {
+        py::array_t<double> out({static_cast<py::ssize_t>(self.metricCount()), py::ssize_t(5)});
+        static_assert(sizeof(MetricForecast) == 5 * sizeof(double), "MetricForecast rows are 5 doubles");
+        self.forecastAll(reinterpret_cast<MetricForecast*>(out.mutable_data()));
+        return out;
+    };
+    py::class_<ForecastKernel>(m, "ForecastKernel",
+        "Sliding-window slope, R^2 and standard deviation plus Holt smoothing of several metrics, "
+        "updated in O(metrics) per frame from running sums")
+        .def(py::init<size_t, const ForecastKernelConfig&>(), py::arg("metrics"),
+             py::arg("config") = ForecastKernelConfig())
+        .def("push", [forecastRows](ForecastKernel& self, const InputBlock<double>& values) {
+                 if (static_cast<size_t>(values.size()) != self.metricCount()) {
+                     throw std::invalid_argument("push needs one value per metric");
+                 }
+                 self.push(values.data());
+                 return forecastRows(self);
+             },
+             "Add a frame of one value per metric; returns forecast()", py::arg("values"))
+        .def("forecast", forecastRows,
+             "(metrics, 5) float64: slope per frame, R^2, std, Holt level, Holt trend per frame")
+        .def("holt_forecast", [](const ForecastKernel& self, double steps) {
+                 py::array_t<double> out(static_cast<py::ssize_t>(self.metricCount()));
+                 double* p = out.mutable_data();
+                 for (size_t i = 0; i < self.metricCount(); i++) p[i] = self.holtForecast(i, steps);
+                 return out;
+             },
+             "Holt forecast of every metric `steps` frames ahead", py::arg("steps"))
+        .def("reset", &ForecastKernel::reset)
+        .def_property_readonly("metric_count", &ForecastKernel::metricCount)
+        .def_property_readonly("frame_count", &ForecastKernel::frameCount)
+        .def_property_readonly("config", &ForecastKernel::config);
+
+    // SessionManager: engine sessions placed on NUMA nodes
+
+    py::class_<SessionBudget>(m, "SessionBudget")
+        .def(py::init<>())
+        .def_readwrite("cpu_load", &SessionBudget::cpu_load)
+        .def_readwrite("throttle_on_miss", &SessionBudget::throttle_on_miss)
+        .def_readwrite("window", &SessionBudget::window)
+        .def_readwrite("release", &SessionBudget::release)
+        .def_readwrite("throttle_nodes", &SessionBudget::throttle_nodes);
+
+    py::class_<SessionUsage>(m, "SessionUsage")
+        .def_readonly("session", &SessionUsage::session)
+        .def_readonly("numa_node", &SessionUsage::numa_node)
+        .def_readonly("nodes", &SessionUsage::nodes)
+        .def_readonly("memory_bytes", &SessionUsage::memory_bytes)
+        .def_readonly("blocks", &SessionUsage::blocks)
+        .def_readonly("samples", &SessionUsage::samples)
+        .def_readonly("cpu_ns", &SessionUsage::cpu_ns)
+        .def_readonly("deadline_misses", &SessionUsage::deadline_misses)
+        .def_readonly("load", &SessionUsage::load)
+        .def_readonly("throttled_blocks", &SessionUsage::throttled_blocks)
+        .def_readonly("throttle_changes", &SessionUsage::throttle_changes)
+        .def_readonly("throttle", &SessionUsage::throttle)
+        .def_readonly("quality", &SessionUsage::quality)
+        .def_readonly("node_rate_divisor", &SessionUsage::node_rate_divisor)
+        .def_readonly("budget", &SessionUsage::budget);
+
+    py::class_<SessionManagerConfig>(m, "SessionManagerConfig")
+        .def(py::init<>())
+        .def_readwrite("reserved_cpus", &SessionManagerConfig::reserved_cpus)
+        .def_readwrite("threads_per_node", &SessionManagerConfig::threads_per_node)
+        .def_readwrite("wait_policy", &SessionManagerConfig::wait_policy)
+        .def_readwrite("bind_memory", &SessionManagerConfig::bind_memory)
+        .def_readwrite("budget", &SessionManagerConfig::budget);
+
+    py::class_<NumaNodeLoad>(m, "NumaNodeLoad")
+        .def_readonly("numa_node", &NumaNodeLoad::numa_node)
+        .def_readonly("cpus", &NumaNodeLoad::cpus)
+        .def_readonly("sessions", &NumaNodeLoad::sessions)
+        .def_readonly("engine_nodes", &NumaNodeLoad::engine_nodes)
+        .def_readonly("bytes", &NumaNodeLoad::bytes)
+        .def_readonly("blocks", &NumaNodeLoad::blocks)
+        .def_readonly("busy_ns", &NumaNodeLoad::busy_ns);
+
+    py::class_<SessionManager>(m, "SessionManager",
+        "Engine sessions balanced across NUMA nodes; each session's node bank is first "
+        "touched (and bound) on its node and advanced by workers pinned to that node's CPUs")
+        .def(py::init<const SessionManagerConfig&>(), py::arg("config") = SessionManagerConfig())
+        .def("create_session", &SessionManager::createSession,
+             "New engine on numa_node, or the least loaded node for -1; returns its session id",
+             py::arg("num_nodes"), py::arg("numa_node") = -1)
+        .def("destroy_session", &SessionManager::destroySession, py::arg("session"))
+        .def("__contains__", &SessionManager::hasSession, py::arg("session"))
+        .def("__len__", &SessionManager::sessionCount)
+        .def_property_readonly("sessions", &SessionManager::sessions)
+        .def("engine", &SessionManager::engine, py::return_value_policy::reference_internal,
+             "The session's engine (valid until the session is destroyed)", py::arg("session"))
+        .def("numa_node", &SessionManager::sessionNumaNode, py::arg("session"))
+        .def("memory_bound", &SessionManager::sessionMemoryBound, py::arg("session"))
+        .def_property_readonly("numa_nodes", &SessionManager::numaNodes)
+        .def("load", &SessionManager::load, "Per-NUMA-node sessions, nodes, bytes, blocks and busy time")
+        .def("reset_load", &SessionManager::resetLoad)
+        .def("set_budget", &SessionManager::setBudget, py::arg("session"), py::arg("budget"))
+        .def("budget", &SessionManager::budget, py::arg("session"))
+        .def("usage", py::overload_cast<uint64_t>(&SessionManager::usage, py::const_),
+             "CPU, memory, deadline misses and throttle state of one session", py::arg("session"))
+        .def("usage", py::overload_cast<>(&SessionManager::usage, py::const_), "Every session, in id order")
+        .def("reset_usage", &SessionManager::resetUsage)
+        .def("render_openmetrics", &sessionOpenMetrics, py::call_guard<py::gil_scoped_release>(),
+             "Per-session dase_session_* families in OpenMetrics text")
+        .def("process_blocks", [](SessionManager& self, const std::vector<uint64_t>& sessions,
+                                  const std::vector<py::array_t<float, py::array::c_style | py::array::forcecast>>& inputs,
+                                  bool return_outputs) -> py::object {
+                 using FloatArray = py::array_t<float, py::array::c_style | py::array::forcecast>;
+                 const size_t count = sessions.size();
+                 if (inputs.size() != count) throw std::invalid_argument("need one input block per session");
+                 std::vector<SessionBlock> blocks(count);
+                 std::vector<AnalogCellularEngineAVX2*> members;
+                 std::vector<FloatArray> outputs;
+                 for (size_t s = 0; s < count; s++) {
+                     SessionBlock& b = blocks[s];
+                     b.session = sessions[s];
+                     b.in = inputs[s].data();
+                     b.n = static_cast<size_t>(inputs[s].size());
+                     AnalogCellularEngineAVX2& engine = self.engine(b.session);
+                     members.push_back(&engine);
+                     if (return_outputs) {
+                         outputs.emplace_back(std::vector<py::ssize_t>{
+                             static_cast<py::ssize_t>(engine.getNodeCount()), static_cast<py::ssize_t>(b.n)});
+                         b.out = outputs.back().mutable_data();
+                     }
+                 }
+                 {
+                     py::gil_scoped_release release;
+                     std::sort(members.begin(), members.end());
+                     members.erase(std::unique(members.begin(), members.end()), members.end());
+                     std::vector<std::unique_lock<std::mutex>> locks;
+                     for (AnalogCellularEngineAVX2* engine : members) locks.emplace_back(engine->callMutex());
+                     self.processBlocks(blocks.data(), count);
+                 }
+                 if (!return_outputs) return py::none();
+                 return py::cast(outputs);
+             },
+             "Advance each session by one block, every NUMA node's sessions on its own workers; "
+             "returns the [num_nodes x n] outputs of each session unless return_outputs is False",
+             py::arg("sessions"), py::arg("inputs"), py::arg("return_outputs") = true);
+
+    // ParameterAutomation: timestamped parameter changes into the audio thread
+    py::enum_<ParameterId>(m, "ParameterId")
+        .value("PHI_PHASE", ParameterId::PhiPhase)
+        .value("PHI_DEPTH", ParameterId::PhiDepth)
+        .value("FEEDBACK", ParameterId::Feedback);
+
+    py::class_<ParameterAutomation>(m, "ParameterAutomation",
+        "Lock-free queue of timestamped parameter changes for process_chromatic_block and "
+        "ChromaticStream: Φ phase and depth glide to each new value over `smoothing` samples from "
+        "the change's sample, feedback changes land at the start of their block. schedule() from "
+        "any Python thread (the GIL keeps one producer at a time); the audio call consumes.")
+        .def(py::init<size_t, size_t, size_t, double, double>(), py::arg("capacity") = 1024,
+             py::arg("max_block") = 4096, py::arg("smoothing") = 64, py::arg("phi_phase") = 0.0,
+             py::arg("phi_depth") = 0.5)
+        .def("schedule", [](ParameterAutomation& self, ParameterId id, float value, uint64_t sample,
+                            py::object node) {
+                 const uint32_t target = node.is_none() ? ParameterEvent::kAllNodes : node.cast<uint32_t>();
+                 return self.schedule(id, value, sample, target);
+             },
+             "Queue a change landing on sample (0: the next block; see position); node picks one "
+             "node's feedback, None all of them. Returns False, counted in dropped, when full.",
+             py::arg("parameter"), py::arg("value"), py::arg("sample") = 0, py::arg("node") = py::none())
+        .def("render", [](ParameterAutomation& self, size_t n) {
+                 self.render(n);
+                 py::array_t<float> phase(static_cast<py::ssize_t>(n));
+                 py::array_t<float> depth(static_cast<py::ssize_t>(n));
+                 std::copy(self.phiPhase(), self.phiPhase() + n, phase.mutable_data());
+                 std::copy(self.phiDepth(), self.phiDepth() + n, depth.mutable_data());
+                 return py::make_tuple(phase, depth);
+             },
+             "Consume the next n samples as the audio call would; returns the (phi_phase, phi_depth) "
+             "float32 curves. Feedback changes due in them are discarded.",
+             py::arg("n"))
+        .def_property_readonly("position", &ParameterAutomation::position,
+             "Sample the next block starts on")
+        .def_property_readonly("capacity", &ParameterAutomation::capacity)
+        .def_property_readonly("max_block", &ParameterAutomation::maxBlock)
+        .def_property_readonly("smoothing", &ParameterAutomation::smoothing)
+        .def_property_readonly("dropped", &ParameterAutomation::dropped,
+             "Changes refused because the queue was full")
+        .def("set_parameter_switch", [](ParameterAutomation& self, py::object parameter_switch) {
+                 self.setParameterSwitch(parameter_switch.is_none() ? nullptr
+                                                                    : parameter_switch.cast<ParameterSwitch*>());
+             },
+             "Apply a ParameterSwitch's committed switches at the start of each block this automation "
+             "runs (None: detach)",
+             py::arg("parameter_switch"), py::keep_alive<1, 2>())
+        .def("set_phase_lock", [](ParameterAutomation& self, py::object phase_lock) {
+                 self.setPhaseLock(phase_lock.is_none() ? nullptr : phase_lock.cast<PhaseLockLoop*>());
+             },
+             "Correct each block's Φ phase curve with a PhaseLockLoop (None: detach)",
+             py::arg("phase_lock"), py::keep_alive<1, 2>());
+
+    // ParameterSwitch: preset changes at block boundaries without rebuilding the engine
+    py::enum_<NodeParameter>(m, "NodeParameter")
+        .value("FEEDBACK", NodeParameter::Feedback)
+        .value("INPUT_GAIN", NodeParameter::InputGain)
+        .value("TIME_CONSTANT", NodeParameter::TimeConstant)
+        .value("CLAMP_LOW", NodeParameter::ClampLow)
+        .value("CLAMP_HIGH", NodeParameter::ClampHigh)
+        .value("SPECTRAL_MIX", NodeParameter::SpectralMix);
+
+    py::class_<ParameterSwitch>(m, "ParameterSwitch",
+        "Double-buffered node parameters: stage a new set from any thread, commit() it, and the "
+        "audio call attached through ParameterAutomation.set_parameter_switch swaps it in at its next "
+        "block boundary, at once or gliding linearly over crossfade samples. Unstaged columns and "
+        "nodes keep their live values. stage*() and commit() return False while a switch is applied.")
+        .def(py::init<size_t>(), py::arg("num_nodes"))
+        .def("stage", [](ParameterSwitch& self, NodeParameter parameter,
+                         py::array_t<double, py::array::c_style | py::array::forcecast> values) {
+                 if (static_cast<size_t>(values.size()) != self.nodes()) {
+                     throw std::invalid_argument("expected " + std::to_string(self.nodes()) + " values, got " +
+                                                 std::to_string(values.size()));
+                 }
+                 return self.stage(parameter, values.data());
+             },
+             "Stage one value per node for a parameter", py::arg("parameter"), py::arg("values"))
+        .def("stage_uniform", &ParameterSwitch::stageUniform,
+             "Stage one value for every node", py::arg("parameter"), py::arg("value"))
+        .def("stage_node", &ParameterSwitch::stageNode,
+             "Stage one node's value; the column's other nodes keep their live values",
+             py::arg("parameter"), py::arg("node"), py::arg("value"))
+        .def("commit", &ParameterSwitch::commit,
+             "Hand the staged set to the audio thread; False when nothing is staged or a switch is "
+             "in progress",
+             py::arg("crossfade_samples") = 0)
+        .def("cancel", &ParameterSwitch::cancel, "Drop the staged, uncommitted set")
+        .def("apply", [](ParameterSwitch& self, AnalogCellularEngineAVX2& engine, size_t n) {
+                 EngineCall<AnalogCellularEngineAVX2> call(engine);
+                 self.apply(engine.bank, n);
+             },
+             "Advance a committed switch by n samples on an engine's nodes, as the audio call does",
+             py::arg("engine"), py::arg("n"))
+        .def_property_readonly("nodes", &ParameterSwitch::nodes)
+        .def_property_readonly("idle", &ParameterSwitch::idle,
+             "True while no committed switch waits or fades")
+        .def_property_readonly("progress", &ParameterSwitch::progress,
+             "Fraction of the current crossfade done, 1 when idle")
+        .def_property_readonly("switches", &ParameterSwitch::switches,
+             "Switches completed");
+
+    // PhaseLockLoop: cluster Φ phase alignment inside the audio thread
+    py::class_<PhaseLockConfig>(m, "PhaseLockConfig")
+        .def(py::init<>())
+        .def_readwrite("sample_rate", &PhaseLockConfig::sample_rate)
+        .def_readwrite("bandwidth_hz", &PhaseLockConfig::bandwidth_hz)
+        .def_readwrite("damping", &PhaseLockConfig::damping)
+        .def_readwrite("max_slew", &PhaseLockConfig::max_slew, "rad/s, 0 for no limit")
+        .def_readwrite("step_threshold", &PhaseLockConfig::step_threshold)
+        .def_readwrite("lock_threshold", &PhaseLockConfig::lock_threshold)
+        .def_readwrite("holdover", &PhaseLockConfig::holdover, "Samples")
+        .def_readwrite("capacity", &PhaseLockConfig::capacity)
+        .def_readwrite("history", &PhaseLockConfig::history, "Samples");
+
+    py::class_<PhaseLockStats>(m, "PhaseLockStats")
+        .def_readonly("estimates", &PhaseLockStats::estimates)
+        .def_readonly("steps", &PhaseLockStats::steps)
+        .def_readonly("stale", &PhaseLockStats::stale)
+        .def_readonly("dropped", &PhaseLockStats::dropped)
+        .def_readonly("error", &PhaseLockStats::error)
+        .def_readonly("rms_error", &PhaseLockStats::rms_error)
+        .def_readonly("frequency_hz", &PhaseLockStats::frequency_hz)
+        .def_readonly("correction", &PhaseLockStats::correction)
+        .def_readonly("locked", &PhaseLockStats::locked)
+        .def_readonly("holdover", &PhaseLockStats::holdover);
+
+    py::class_<PhaseLockLoop>(m, "PhaseLockLoop",
+        "Second-order phase-locked loop on an automation's Φ phase: remote phase estimates go in "
+        "from any Python thread (the GIL keeps one producer at a time), and once attached through "
+        "ParameterAutomation.set_phase_lock every block's phase curve is corrected toward them, "
+        "slewed sample by sample, with no Python in the loop.")
+        .def(py::init<const PhaseLockConfig&>(), py::arg("config") = PhaseLockConfig())
+        .def("push", py::overload_cast<float, uint64_t>(&PhaseLockLoop::push),
+             "Queue the remote phase (radians) at a sample of the automation clock; False, counted "
+             "in dropped, when full",
+             py::arg("phase"), py::arg("sample"))
+        .def("push_at", [](PhaseLockLoop& self, float phase, double time) {
+                 return self.pushAt(phase, static_cast<int64_t>(std::llround(time * 1e9)));
+             },
+             "Queue the remote phase at a local time.time() (a remote stamp minus the clock sync "
+             "offset)",
+             py::arg("phase"), py::arg("time"))
+        .def("sample_at", [](const PhaseLockLoop& self, double time) {
+                 return self.sampleAt(static_cast<int64_t>(std::llround(time * 1e9)));
+             },
+             "Automation sample a local time.time() maps to", py::arg("time"))
+        .def("apply", [](PhaseLockLoop& self, uint64_t start,
+                         py::array_t<float, py::array::c_style | py::array::forcecast> phase) {
+                 py::array_t<float> out(phase.size());
+                 std::copy(phase.data(), phase.data() + phase.size(), out.mutable_data());
+                 self.apply(start, static_cast<size_t>(phase.size()), out.mutable_data());
+                 return out;
+             },
+             "Correct a phase curve starting at sample start as render() does; returns the result",
+             py::arg("start"), py::arg("phase"))
+        .def("reset", &PhaseLockLoop::reset, "Drop the loop state and queued estimates; not under a running block")
+        .def_property_readonly("stats", &PhaseLockLoop::stats)
+        .def_property_readonly("correction", &PhaseLockLoop::correction,
+             "Phase added to the last sample, radians")
+        .def_property_readonly("config", &PhaseLockLoop::config);
+
+    // ChromaticStream: process_chromatic_block on chunks of any length
+    py::class_<ChromaticStream>(m, "ChromaticStream",
+        "Re-blocking front end of process_chromatic_block: process() takes chunks of any length and "
+        "returns as many samples per channel, delayed by one block (latency), with no allocation "
+        "beyond the returned array.")
+        .def(py::init([](AnalogCellularEngineAVX2& engine, size_t block_size, size_t num_channels,
+                         py::object node_stride, double sample_rate, double phi_phase, double phi_depth) {
+                 ChromaticBlockConfig config;
+                 config.num_channels = num_channels;
+                 config.node_stride = node_stride.is_none() ? num_channels : node_stride.cast<size_t>();
+                 config.sample_rate = sample_rate;
+                 config.phi_phase = phi_phase;
+                 config.phi_depth = phi_depth;
+                 return new ChromaticStream(engine, block_size, config);
+             }), py::keep_alive<1, 2>(),
+             py::arg("engine"), py::arg("block_size") = 512, py::arg("num_channels") = 8,
+             py::arg("node_stride") = py::none(), py::arg("sample_rate") = 48000.0,
+             py::arg("phi_phase") = 0.0, py::arg("phi_depth") = 0.5)
+        .def("process", [](ChromaticStream& self, const InputBlock<float>& chunk, py::object out) {
+                 const size_t n = static_cast<size_t>(chunk.size());
+                 float* out_data;
+                 if (out.is_none()) {
+                     out = py::array_t<float>({static_cast<py::ssize_t>(self.channels()), static_cast<py::ssize_t>(n)});
+                     out_data = static_cast<float*>(py::reinterpret_borrow<py::array>(out).mutable_data());
+                 } else {
+                     out_data = outputBlock<float>(out, self.channels() * n);
+                 }
+                 {
+                     EngineCall<AnalogCellularEngineAVX2> call(self.engine());
+                     self.process(chunk.data(), out_data, n);
+                 }
+                 return out;
+             },
+             "Process a chunk of any length; returns [num_channels, len(chunk)] float32 outputs one "
+             "block behind, written into out when given",
+             py::arg("chunk"), py::arg("out") = py::none())
+        .def("set_phi", &ChromaticStream::setPhi,
+             "Φ envelope phase and depth of the blocks that start after the call",
+             py::arg("phi_phase"), py::arg("phi_depth"))
+        .def_property_readonly("phi_phase", [](const ChromaticStream& self) { return self.config().phi_phase; })
+        .def_property_readonly("phi_depth", [](const ChromaticStream& self) { return self.config().phi_depth; })
+        .def("set_automation", [](ChromaticStream& self, py::object automation) {
+                 self.setAutomation(automation.is_none() ? nullptr : automation.cast<ParameterAutomation*>());
+             }, py::keep_alive<1, 2>(),
+             "Run the blocks from the next one on under a ParameterAutomation (None: set_phi again)",
+             py::arg("automation"))
+        .def("reset", &ChromaticStream::reset, "Drop buffered input and pending output")
+        .def_property_readonly("block_size", &ChromaticStream::blockSize)
+        .def_property_readonly("num_channels", &ChromaticStream::channels)
+        .def_property_readonly("latency", &ChromaticStream::latency,
+             "Constant input-to-output delay in samples")
+        .def_property_readonly("blocks_processed", &ChromaticStream::blocksProcessed)
+        .def_property_readonly("last_block", [](const ChromaticStream& self) {
+                 py::array_t<float> block({static_cast<py::ssize_t>(self.channels()),
+                                           static_cast<py::ssize_t>(self.blockSize())});
+                 std::copy(self.lastBlock(), self.lastBlock() + self.channels() * self.blockSize(),
+                           block.mutable_data());
+                 return block;
+             },
+             "Copy of the latest engine block's [num_channels, block_size] outputs");
+
+    // NativeAudioHost: the AudioServer audio path in a native device callback
+    py::enum_<AudioHostBackend>(m, "AudioHostBackend")
+        .value("PORTAUDIO", AudioHostBackend::PortAudio)
+        .value("SIMULATED", AudioHostBackend::Simulated);
+
+    py::class_<AudioHostConfig>(m, "AudioHostConfig")
+        .def(py::init<>())
+        .def_readwrite("backend", &AudioHostConfig::backend)
+        .def_readwrite("sample_rate", &AudioHostConfig::sample_rate)
+        .def_readwrite("block_size", &AudioHostConfig::block_size)
+        .def_readwrite("max_block", &AudioHostConfig::max_block)
+        .def_readwrite("input_device", &AudioHostConfig::input_device)
+        .def_readwrite("output_device", &AudioHostConfig::output_device)
+        .def_readwrite("input_channels", &AudioHostConfig::input_channels)
+        .def_readwrite("output_channels", &AudioHostConfig::output_channels)
+        .def_readwrite("suggested_latency", &AudioHostConfig::suggested_latency)
+        .def_readwrite("num_channels", &AudioHostConfig::num_channels)
+        .def_readwrite("node_stride", &AudioHostConfig::node_stride)
+        .def_readwrite("max_delay", &AudioHostConfig::max_delay)
+        .def_readwrite("test_tone_hz", &AudioHostConfig::test_tone_hz)
+        .def_readwrite("frame_queue", &AudioHostConfig::frame_queue);
+
+    py::class_<AudioHostFrame>(m, "AudioHostFrame")
+        .def_readonly("callback", &AudioHostFrame::callback)
+        .def_readonly("sample", &AudioHostFrame::sample)
+        .def_readonly("time_ns", &AudioHostFrame::time_ns)
+        .def_readonly("frames", &AudioHostFrame::frames)
+        .def_readonly("processing_ns", &AudioHostFrame::processing_ns)
+        .def_readonly("load", &AudioHostFrame::load)
+        .def_readonly("phi_phase", &AudioHostFrame::phi_phase)
+        .def_readonly("phi_depth", &AudioHostFrame::phi_depth)
+        .def_property_readonly("peak_left", [](const AudioHostFrame& f) { return f.peak[0]; })
+        .def_property_readonly("peak_right", [](const AudioHostFrame& f) { return f.peak[1]; })
+        .def_property_readonly("rms_left", [](const AudioHostFrame& f) { return f.rms[0]; })
+        .def_property_readonly("rms_right", [](const AudioHostFrame& f) { return f.rms[1]; })
+        .def_readonly("underflow", &AudioHostFrame::underflow)
+        .def_readonly("overflow", &AudioHostFrame::overflow)
+        .def_readonly("contended", &AudioHostFrame::contended);
+
+    py::class_<AudioHostStats>(m, "AudioHostStats")
+        .def_readonly("callbacks", &AudioHostStats::callbacks)
+        .def_readonly("frames", &AudioHostStats::frames)
+        .def_readonly("underflows", &AudioHostStats::underflows)
+        .def_readonly("overflows", &AudioHostStats::overflows)
+        .def_readonly("late", &AudioHostStats::late)
+        .def_readonly("contended", &AudioHostStats::contended)
+        .def_readonly("frames_dropped", &AudioHostStats::frames_dropped)
+        .def_readonly("commands_dropped", &AudioHostStats::commands_dropped)
+        .def_readonly("processing", &AudioHostStats::processing);
+
+    py::class_<AudioDeviceInfo>(m, "AudioDeviceInfo")
+        .def_readonly("index", &AudioDeviceInfo::index)
+        .def_readonly("name", &AudioDeviceInfo::name)
+        .def_readonly("api", &AudioDeviceInfo::api)
+        .def_readonly("max_input_channels", &AudioDeviceInfo::max_input_channels)
+        .def_readonly("max_output_channels", &AudioDeviceInfo::max_output_channels)
+        .def_readonly("default_sample_rate", &AudioDeviceInfo::default_sample_rate)
+        .def_readonly("default_low_latency", &AudioDeviceInfo::default_low_latency);
+
+    py::class_<NativeAudioHost>(m, "NativeAudioHost",
+        "Audio device host running the chromatic block, stereo downmix and latency compensation in "
+        "its native callback, with no Python on the audio thread. Φ goes in through automation, "
+        "downmix, delay and quality through a lock-free ring; an AudioHostFrame per callback comes "
+        "out through another (drain_frames). The callback skips a block (silence, counted as "
+        "contended) rather than wait while another engine call runs.")
+        .def(py::init<AnalogCellularEngineAVX2&, const AudioHostConfig&>(), py::keep_alive<1, 2>(),
+             py::arg("engine"), py::arg("config") = AudioHostConfig())
+        .def("start", [](NativeAudioHost& self) {
+                 py::gil_scoped_release release;
+                 self.start();
+             }, "Open and start the stream; raises RuntimeError when the backend or device is unavailable")
+        .def("stop", [](NativeAudioHost& self) {
+                 py::gil_scoped_release release;
+                 self.stop();
+             }, "Stop and close the stream after its last callback")
+        .def_property_readonly("running", &NativeAudioHost::running)
+        .def("set_downmix", [](NativeAudioHost& self, const std::vector<float>& left,
+                               const std::vector<float>& right, float gain) {
+                 if (left.size() != self.channels() || right.size() != self.channels()) {
+                     throw py::value_error("downmix weights need num_channels values per side");
+                 }
+                 return self.setDownmix(left.data(), right.data(), gain);
+             },
+             "Downmix weights per chromatic channel, applied whole at the next callback; False when the "
+             "control ring is full",
+             py::arg("left"), py::arg("right"), py::arg("gain") = 1.0f)
+        .def("set_compensation_delay", &NativeAudioHost::setCompensationDelay,
+             "Latency compensation delay in samples (clamped to max_delay) from the next callback",
+             py::arg("samples"))
+        .def("set_compute_quality", &NativeAudioHost::setComputeQuality,
+             "Engine compute quality from the next callback", py::arg("quality"))
+        .def_property_readonly("automation", &NativeAudioHost::automation, py::return_value_policy::reference_internal,
+             "ParameterAutomation the callback renders Φ phase and depth from")
+        .def("drain_frames", [](NativeAudioHost& self, size_t max) {
+                 std::vector<AudioHostFrame> frames(max > 0 ? max : self.pendingFrames());
+                 frames.resize(self.drainFrames(frames.data(), frames.size()));
+                 return frames;
+             },
+             "Take up to max (0: all pending) AudioHostFrames, oldest first", py::arg("max") = 0)
+        .def_property_readonly("pending_frames", &NativeAudioHost::pendingFrames)
+        .def_property_readonly("stats", &NativeAudioHost::stats)
+        .def("reset_stats", &NativeAudioHost::resetStats)
+        .def("process", [](NativeAudioHost& self, const InputBlock<float>& in) {
+                 const unsigned inputs = std::max(self.config().input_channels, 1u);
+                 const size_t frames = static_cast<size_t>(in.size()) / inputs;
+                 py::array_t<float> out({static_cast<py::ssize_t>(frames),
+                                         static_cast<py::ssize_t>(self.config().output_channels)});
+                 float* out_data = out.mutable_data();
+                 {
+                     py::gil_scoped_release release;
+                     self.process(self.config().input_channels > 0 ? in.data() : nullptr, out_data, frames);
+                 }
+                 return out;
+             },
+             "Run the callback's work on interleaved input frames without a device; returns "
+             "[frames, output_channels] float32",
+             py::arg("input"))
+        .def_property_readonly("config", &NativeAudioHost::config)
+        .def_property_readonly("num_channels", &NativeAudioHost::channels)
+        .def_property_readonly("input_latency", &NativeAudioHost::inputLatency,
+             "Input latency the device reported at start, seconds")
+        .def_property_readonly("output_latency", &NativeAudioHost::outputLatency,
+             "Output latency the device reported at start, seconds")
+        .def_static("backend_available", &NativeAudioHost::backendAvailable, py::arg("backend"))
+        .def_static("devices", &NativeAudioHost::devices, "Devices of a backend (empty when not built in)",
+             py::arg("backend") = AudioHostBackend::PortAudio);
+
+    // StageGraph: the chromatic audio path pipelined across cores
+    py::class_<StageOccupancy>(m, "StageOccupancy")
+        .def_readonly("name", &StageOccupancy::name)
+        .def_readonly("blocks", &StageOccupancy::blocks)
+        .def_readonly("busy_ns", &StageOccupancy::busy_ns)
+        .def_readonly("idle_ns", &StageOccupancy::idle_ns)
+        .def_readonly("occupancy", &StageOccupancy::occupancy)
+        .def_readonly("mean_ns", &StageOccupancy::mean_ns)
+        .def_readonly("mean_queue", &StageOccupancy::mean_queue);
+
+    py::class_<StageGraphStats>(m, "StageGraphStats")
+        .def_readonly("submitted", &StageGraphStats::submitted)
+        .def_readonly("completed", &StageGraphStats::completed)
+        .def_readonly("rejected", &StageGraphStats::rejected)
+        .def_readonly("late", &StageGraphStats::late)
+        .def_readonly("max_in_flight", &StageGraphStats::max_in_flight)
+        .def_readonly("bottleneck", &StageGraphStats::bottleneck)
+        .def_readonly("latency", &StageGraphStats::latency)
+        .def_readonly("stages", &StageGraphStats::stages);
+
+    py::class_<StageGraph>(m, "ChromaticStageGraph",
+        "Input filter, engine, spectrum, ICI and metrics stages each on a thread of their own, joined by "
+        "lock-free rings: blocks complete at the pace of the slowest stage instead of the sum of all")
+        .def(py::init([](AnalogCellularEngineAVX2& engine, size_t block_size, size_t num_channels,
+                         py::object node_stride, double sample_rate, double phi_phase, double phi_depth,
+                         double highpass_hz, bool spectrum, bool ici, size_t slots, double latency_budget_ms,
+                         const std::vector<int>& cpus) {
+                 ChromaticBlockConfig chroma;
+                 chroma.num_channels = num_channels;
+                 chroma.node_stride = node_stride.is_none() ? num_channels : node_stride.cast<size_t>();
+                 chroma.sample_rate = sample_rate;
+                 chroma.phi_phase = phi_phase;
+                 chroma.phi_depth = phi_depth;
+                 StageGraphConfig config;
+                 config.block_size = block_size;
+                 config.num_channels = num_channels;
+                 config.sample_rate = sample_rate;
+                 config.slots = slots;
+                 config.latency_budget_ms = latency_budget_ms;
+                 std::vector<GraphStage> stages;
+                 if (highpass_hz > 0.0) stages.push_back(makeInputFilterStage(highpass_hz, sample_rate));
+                 stages.push_back(makeChromaticEngineStage(engine, chroma));
+                 if (spectrum) stages.push_back(makeSpectrumStage(num_channels, block_size));
+                 if (ici) stages.push_back(makeIciStage(num_channels, block_size));
+                 stages.push_back(makeMetricsStage(num_channels));
+                 for (size_t k = 0; k < stages.size() && k < cpus.size(); k++) stages[k].cpu = cpus[k];
+                 return new StageGraph(std::move(stages), config);
+             }), py::keep_alive<1, 2>(),
+             "Stages in order: input_filter (highpass_hz > 0), engine, spectrum, ici, metrics; cpus[k] "
+             "pins stage k",
+             py::arg("engine"), py::arg("block_size") = 512, py::arg("num_channels") = 8,
+             py::arg("node_stride") = py::none(), py::arg("sample_rate") = 48000.0, py::arg("phi_phase") = 0.0,
+             py::arg("phi_depth") = 0.5, py::arg("highpass_hz") = 20.0, py::arg("spectrum") = true,
+             py::arg("ici") = true, py::arg("slots") = 8, py::arg("latency_budget_ms") = 0.0,
+             py::arg("cpus") = std::vector<int>())
+        .def("submit", [](StageGraph& self, const InputBlock<float>& block) {
+                 return self.submit(block.data(), static_cast<size_t>(block.size()));
+             },
+             "Start a block (copied) down the graph; False when no slot is free or the latency budget "
+             "is full", py::arg("block"))
+        .def("collect", [](StageGraph& self) -> py::object {
+                 const GraphBlock* block = self.collect();
+                 if (!block) return py::none();
+                 const size_t channels = self.config().num_channels;
+                 py::array_t<float> outputs({static_cast<py::ssize_t>(channels), static_cast<py::ssize_t>(block->n)});
+                 std::copy(block->channels.begin(), block->channels.end(), outputs.mutable_data());
+                 py::dict result;
+                 result["sequence"] = block->sequence;
+                 result["channels"] = outputs;
+                 if (!block->spectrum.empty()) {
+                     const size_t bins = block->spectrum.size() / channels;
+                     py::array_t<float> spectrum({static_cast<py::ssize_t>(channels), static_cast<py::ssize_t>(bins)});
+                     std::copy(block->spectrum.begin(), block->spectrum.end(), spectrum.mutable_data());
+                     result["spectrum"] = spectrum;
+                 }
+                 result["ici"] = block->ici;
+                 result["input_rms"] = block->input_rms;
+                 result["output_rms"] = block->output_rms;
+                 result["latency_ms"] = static_cast<double>(block->latency_ns) * 1e-6;
+                 self.release();
+                 return result;
+             },
+             "Oldest finished block as a dict (sequence, channels, spectrum, ici, input_rms, output_rms, "
+             "latency_ms), or None")
+        .def("stats", &StageGraph::stats)
+        .def("reset_stats", &StageGraph::resetStats)
+        .def_property_readonly("failed", &StageGraph::failed)
+        .def_property_readonly("error", &StageGraph::error)
+        .def_property_readonly("in_flight", &StageGraph::inFlight)
+        .def_property_readonly("stage_count", &StageGraph::stageCount);
+
+    // AsyncBlockProcessor: double-buffered block submission on one engine
+    py::class_<AsyncBlockProcessor>(m, "AsyncBlockProcessor",
+        "Double-buffered asynchronous process_block. submit() queues a block and returns while a "
+        "background thread processes it; collect() returns the oldest block's outputs. From "
+        "asyncio, await collect_async() (collect on the default executor, without the GIL).")
+        .def(py::init<AnalogCellularEngineAVX2&, bool>(), py::keep_alive<1, 2>(),
+             "Process blocks of engine in the background (return_outputs False only advances the nodes)",
+             py::arg("engine"), py::arg("return_outputs") = true)
+        .def("submit", [](AsyncBlockProcessor& self, const InputBlock<float>& input, const py::object& control,
+                          const py::object& aux) {
+                 const size_t n = static_cast<size_t>(input.size());
+                 InputBlock<float> control_holder, aux_holder;
+                 const float* control_data = optionalBlock(control, n, "control", control_holder);
+                 const float* aux_data = optionalBlock(aux, n, "aux", aux_holder);
+                 py::gil_scoped_release release;
+                 return self.submit(input.data(), control_data, aux_data, n);
+             },
+             "Queue a block (copied) and return its sequence number; waits only while two "
+             "uncollected blocks are queued",
+             py::arg("input"), py::arg("control") = py::none(), py::arg("aux") = py::none())
+        .def("collect", [](AsyncBlockProcessor& self, py::object out) -> py::object {
+                 if (self.pending() == 0) throw std::logic_error("no block pending");
+                 const size_t n = self.nextBlockSize();
+                 float* out_data = nullptr;
+                 if (self.hasOutputs()) {
+                     const size_t nodes = self.engine().getNodeCount();
+                     if (out.is_none()) {
+                         out = py::array_t<float>({static_cast<py::ssize_t>(nodes), static_cast<py::ssize_t>(n)});
+                         out_data = static_cast<float*>(py::reinterpret_borrow<py::array>(out).mutable_data());
+                     } else {
+                         out_data = outputBlock<float>(out, nodes * n);
+                     }
+                 }
+                 {
+                     py::gil_scoped_release release;
+                     self.collect(out_data);
+                 }
+                 return out_data != nullptr ? out : py::none();
+             },
+             "Wait for the oldest submitted block; returns its [num_nodes x n] outputs (into out "
+             "when given), or None without outputs",
+             py::arg("out") = py::none())
+        .def("collect_async", [](py::object self) {
+                 py::object loop = py::module_::import("asyncio").attr("get_running_loop")();
+                 return loop.attr("run_in_executor")(py::none(), self.attr("collect"));
+             },
+             "Awaitable collect() for the running asyncio loop")
+        .def("process", [](py::object self, py::object input, py::object control, py::object aux) -> py::object {
+                 const bool previous = self.cast<AsyncBlockProcessor&>().pending() > 0;
+                 self.attr("submit")(input, control, aux);
+                 return previous ? self.attr("collect")() : py::none();
+             },
+             "Pipelined step: submit this block, then collect the previous one (None on the first call)",
+             py::arg("input"), py::arg("control") = py::none(), py::arg("aux") = py::none())
+        .def_property_readonly("ready", &AsyncBlockProcessor::ready,
+             "True when collect() would not wait")
+        .def_property_readonly("pending", &AsyncBlockProcessor::pending)
+        .def_property_readonly("submitted", &AsyncBlockProcessor::submitted);
+
+    // Session pipelines of resumable stages on one worker pool
+    py::enum_<StageStatus>(m, "StageStatus")
+        .value("DONE", StageStatus::Done)
+        .value("PENDING", StageStatus::Pending)
+        .value("YIELD", StageStatus::Yield);
+
+    py::class_<PipelineSessionConfig>(m, "PipelineSessionConfig")
+        .def(py::init<>())
+        .def_readwrite("nodes", &PipelineSessionConfig::nodes)
+        .def_readwrite("block_size", &PipelineSessionConfig::block_size)
+        .def_readwrite("num_channels", &PipelineSessionConfig::num_channels)
+        .def_readwrite("sample_rate", &PipelineSessionConfig::sample_rate)
+        .def_readwrite("phi_phase", &PipelineSessionConfig::phi_phase)
+        .def_readwrite("phi_depth", &PipelineSessionConfig::phi_depth)
+        .def_readwrite("input_blocks", &PipelineSessionConfig::input_blocks);
+
+    py::class_<PipelineSessionStats>(m, "PipelineSessionStats")
+        .def_readonly("blocks", &PipelineSessionStats::blocks)
+        .def_readonly("steps", &PipelineSessionStats::steps)
+        .def_readonly("suspensions", &PipelineSessionStats::suspensions)
+        .def_readonly("input_dropped", &PipelineSessionStats::input_dropped)
+        .def_readonly("failed", &PipelineSessionStats::failed)
+        .def_readonly("error", &PipelineSessionStats::error);
+
+    py::class_<PipelineSession, std::shared_ptr<PipelineSession>>(m, "PipelineSession",
+        "One session's input -> engine -> ICI -> publish pipeline on a PipelineExecutor")
+        .def_property_readonly("id", &PipelineSession::id)
+        .def_property_readonly("stage", &PipelineSession::stage)
+        .def_property_readonly("queued_input", &PipelineSession::queuedInput)
+        .def("push_input", [](PipelineSession& self, const InputBlock<float>& input) {
+                 return self.pushInput(input.data(), static_cast<size_t>(input.size()));
+             },
+             "Queue one input block (copied) and wake the session; False when the input buffer is full",
+             py::arg("input"))
+        .def("wake", &PipelineSession::wake, py::call_guard<py::gil_scoped_release>(),
+             "Resume a session whose publish callback returned False")
+        .def("stats", &PipelineSession::stats);
+
+    py::class_<PipelineExecutor>(m, "PipelineExecutor",
+        "Runs session pipelines on one worker pool and one driver thread instead of a thread per session")
+        .def(py::init([](const WorkerPoolConfig& workers) {
+                 return std::make_unique<PipelineExecutor>(std::make_shared<WorkerPool>(workers));
+             }),
+             py::arg("workers") = WorkerPoolConfig())
+        .def("add_session", [](PipelineExecutor& self, PipelineSessionConfig config, py::object publish) {
+                 if (!publish.is_none()) {
+                     // Called on pool threads; the holder takes the GIL to release the callable too
+                     auto callback = std::shared_ptr<py::object>(new py::object(std::move(publish)), [](py::object* o) {
+                         py::gil_scoped_acquire gil;
+                         delete o;
+                     });
+                     config.publish = [callback](PipelineSession& session) {
+                         const PipelineBlock& block = session.block();
+                         py::gil_scoped_acquire gil;
+                         py::array_t<float> output({static_cast<py::ssize_t>(session.config().num_channels),
+                                                    static_cast<py::ssize_t>(block.n)});
+                         std::copy(block.output.begin(), block.output.end(), output.mutable_data());
+                         const bool done = (*callback)(session.id(), block.sequence, block.ici, output).cast<bool>();
+                         return done ? StageStatus::Done : StageStatus::Pending;
+                     };
+                 }
+                 return self.addSession(config);
+             },
+             "Add a session. publish(session_id, sequence, ici, output) gets every block's (channels, n) "
+             "outputs on a pool thread; returning False parks the session until session.wake()",
+             py::arg("config") = PipelineSessionConfig(), py::arg("publish") = py::none(), py::keep_alive<0, 1>())
+        .def("remove_session", &PipelineExecutor::removeSession, py::call_guard<py::gil_scoped_release>(),
+             py::arg("id"))
+        .def_property_readonly("session_count", &PipelineExecutor::sessionCount)
+        .def("run_once", &PipelineExecutor::runOnce, py::call_guard<py::gil_scoped_release>(),
+             "Step every ready session once; returns how many were stepped")
+        .def("run_until_idle", &PipelineExecutor::runUntilIdle, py::call_guard<py::gil_scoped_release>())
+        .def("start", &PipelineExecutor::start, "Step ready sessions on a driver thread")
+        .def("stop", &PipelineExecutor::stop, py::call_guard<py::gil_scoped_release>())
+        .def_property_readonly("running", &PipelineExecutor::running);
 
     // CPUFeatures utility functions (namespace functions exposed as module functions)
     m.def("has_avx2", &CPUFeatures::hasAVX2,
@@ -102,14 +3943,161 @@ PYBIND11_MODULE(dase_engine, m) {
           "Check if CPU supports FMA instructions");
     m.def("print_cpu_capabilities", &CPUFeatures::printCapabilities,
           "Print detected CPU capabilities");
+    m.def("detect_simd_level", &detectSimdLevel,
+          "Highest node-kernel instruction set the CPU and OS support");
+    m.def("default_simd_level", &defaultSimdLevel,
+          "Instruction set new engines use (detect_simd_level, lowered by DASE_SIMD)");
+
+    // Timeline tracing of the parallel regions
+    m.def("set_trace_level", &timeline_trace::setLevel,
+          "Record engine kernels (REGIONS) and worker chunks (CHUNKS) into per-thread rings",
+          py::arg("level"));
+    m.def("trace_level", &timeline_trace::level);
+    m.def("set_trace_buffer_capacity", &timeline_trace::setBufferCapacity,
+          "Ring size in events for threads that start recording afterwards", py::arg("events"));
+    m.def("trace_buffer_capacity", &timeline_trace::bufferCapacity);
+    m.def("set_trace_thread_name", &timeline_trace::setThreadName,
+          "Name of the calling thread's track", py::arg("name"));
+    m.def("clear_trace", &timeline_trace::clear, "Drop every recorded event");
+    m.def("trace_event_count", &timeline_trace::eventCount, "Events currently held");
+    m.def("chrome_trace_json", &timeline_trace::chromeJson,
+          "Held events in the Chrome trace event JSON format");
+    m.def("write_chrome_trace", [](const std::string& path) {
+              if (!timeline_trace::writeChromeJson(path)) throw std::runtime_error("could not write " + path);
+          },
+          "Write chrome_trace_json() to path", py::arg("path"));
+    m.def("perfetto_trace", []() { return py::bytes(timeline_trace::perfettoProto()); },
+          "Held events as a Perfetto protobuf trace");
+    m.def("write_perfetto_trace", [](const std::string& path) {
+              if (!timeline_trace::writePerfetto(path)) throw std::runtime_error("could not write " + path);
+          },
+          "Write perfetto_trace() to path", py::arg("path"));
+
+    // Φ-sensor serial link
+    m.def("decode_phi_stream", &decodePhiStream,
+          "Decode the complete Φ-sensor frames in a byte stream: dict of sample_number, timestamp_us, "
+          "raw_adc and normalized arrays, per-sample flags, consumed (bytes through the last zero) "
+          "and errors (frames rejected)",
+          py::arg("data"));
+    m.attr("PHI_PACKET_VERSION") = PHI_PACKET_VERSION;
+
+    py::enum_<ResponseStimulus>(m, "ResponseStimulus")
+        .value("LOG_CHIRP", ResponseStimulus::LogChirp)
+        .value("MULTITONE", ResponseStimulus::Multitone);
+
+    py::class_<ResponseAnalyzerConfig>(m, "ResponseAnalyzerConfig")
+        .def(py::init<>())
+        .def_readwrite("stimulus", &ResponseAnalyzerConfig::stimulus)
+        .def_readwrite("sample_rate", &ResponseAnalyzerConfig::sample_rate)
+        .def_readwrite("min_hz", &ResponseAnalyzerConfig::min_hz)
+        .def_readwrite("max_hz", &ResponseAnalyzerConfig::max_hz)
+        .def_readwrite("points", &ResponseAnalyzerConfig::points)
+        .def_readwrite("fft_size", &ResponseAnalyzerConfig::fft_size)
+        .def_readwrite("amplitude", &ResponseAnalyzerConfig::amplitude)
+        .def_readwrite("sweep_seconds", &ResponseAnalyzerConfig::sweep_seconds)
+        .def_readwrite("settle_frames", &ResponseAnalyzerConfig::settle_frames)
+        .def_readwrite("harmonics", &ResponseAnalyzerConfig::harmonics)
+        .def_readwrite("block_size", &ResponseAnalyzerConfig::block_size);
+
+    py::class_<FrequencyResponseAnalyzer>(m, "FrequencyResponseAnalyzer",
+        "Magnitude, phase and THD of every node of an engine from a log chirp or multitone stimulus, "
+        "analyzed with the DSP core FFT on the engine's workers")
+        .def(py::init<const ResponseAnalyzerConfig&>(), py::arg("config") = ResponseAnalyzerConfig())
+        .def("analyze", &analyzeResponse,
+             "Play the stimulus through the engine from its current state; dict of frequencies (points,) "
+             "and (num_nodes, points) float32 magnitude (linear), phase (radians) and thd (NaN where no "
+             "harmonic is below Nyquist)",
+             py::arg("engine"))
+        .def_property_readonly("frequencies", [](const FrequencyResponseAnalyzer& self) {
+                 return py::array_t<double>(static_cast<py::ssize_t>(self.frequencies().size()),
+                                            self.frequencies().data());
+             })
+        .def_property_readonly("stimulus", [](const FrequencyResponseAnalyzer& self) {
+                 return py::array_t<float>(static_cast<py::ssize_t>(self.stimulus().size()), self.stimulus().data());
+             })
+        .def_property_readonly("config", &FrequencyResponseAnalyzer::config);
+
+    // DSP core submodule (hardware/dsp_core.h), the analysis shared with the
+    // firmware and the pipeline host
+    py::module_ dsp = m.def_submodule("dsp", "Portable DSP core shared with the firmware");
+    py::enum_<DspFftBackend>(dsp, "FftBackend")
+        .value("BUILTIN", DSP_FFT_BUILTIN)
+        .value("KISSFFT", DSP_FFT_KISSFFT)
+        .value("CMSIS", DSP_FFT_CMSIS)
+        .value("FFTW", DSP_FFT_FFTW);
+    py::enum_<DspWindow>(dsp, "Window")
+        .value("HANN", DSP_WINDOW_HANN)
+        .value("BLACKMAN", DSP_WINDOW_BLACKMAN)
+        .value("RECTANGULAR", DSP_WINDOW_RECTANGULAR);
+    dsp.def("default_fft_backend", &dsp_fft_default_backend);
+    dsp.def("fft_backend_available", &dsp_fft_backend_available, py::arg("backend"));
+    py::class_<RealFft>(dsp, "RealFFT", "Real FFT of power-of-two size on a DSP core backend")
+        .def(py::init<size_t, DspFftBackend>(), py::arg("size"), py::arg("backend") = dsp_fft_default_backend())
+        .def_property_readonly("size", &RealFft::size)
+        .def_property_readonly("backend", &RealFft::backend)
+        .def("forward", &RealFft::forward,
+             "Unnormalized spectrum (as numpy.fft.rfft) of size float32 samples, complex64 bins 0 to size / 2, "
+             "into out when given",
+             py::arg("block"), py::arg("out") = py::none());
+    dsp.def("window", [](DspWindow type, size_t n, bool periodic) {
+                py::array_t<float> window(static_cast<py::ssize_t>(n));
+                dsp_window(type, periodic, window.mutable_data(), n);
+                return window;
+            },
+            "Analysis window: periodic for overlapped frames, else symmetric (numpy.hanning)",
+            py::arg("type"), py::arg("n"), py::arg("periodic") = true);
+    dsp.def("magnitudes", [](const py::array_t<std::complex<float>, py::array::c_style | py::array::forcecast>& spectrum) {
+                py::array_t<float> magnitude(spectrum.size());
+                dsp_magnitudes(reinterpret_cast<const float*>(spectrum.data()), magnitude.mutable_data(),
+                               static_cast<size_t>(spectrum.size()));
+                return magnitude;
+            },
+            "|X[k]| of complex64 bins, float32", py::arg("spectrum"));
+    dsp.def("spectral_features", &spectralFeatures,
+            "Centroid (Hz), flux, rolloff (Hz) and flatness of a magnitude spectrum without DC, as the "
+            "firmware computes them; prev (float32, same bins) gives the flux and receives this spectrum",
+            py::arg("magnitude"), py::arg("bin_hz"), py::arg("prev") = py::none());
+    dsp.def("butterworth", [](bool highpass, float hz, float sample_rate, unsigned order) {
+                DspBiquad sections[DSP_BUTTERWORTH_MAX_ORDER / 2];
+                const size_t count = dsp_butterworth(highpass, hz, sample_rate, order, sections);
+                py::array_t<float> coefficients(std::vector<py::ssize_t>{static_cast<py::ssize_t>(count), 5});
+                std::memcpy(coefficients.mutable_data(), sections, count * sizeof(DspBiquad));
+                return coefficients;
+            },
+            "Butterworth sections as float32 rows of b0, b1, b2, a1, a2 (a0 = 1); none for a cutoff outside "
+            "(0, Nyquist) or an odd order",
+            py::arg("highpass"), py::arg("hz"), py::arg("sample_rate"), py::arg("order") = 2);
+    dsp.def("biquad_cascade", [](const InputBlock<float>& sections, py::object state, py::object samples) {
+                if (sections.ndim() != 2 || sections.shape(1) != 5) {
+                    throw std::invalid_argument("sections must have shape (count, 5)");
+                }
+                const size_t count = static_cast<size_t>(sections.shape(0));
+                float* z = outputBlock<float>(state, 2 * count);
+                if (!py::isinstance<py::array_t<float>>(samples)) throw std::invalid_argument("samples must be a float32 array");
+                const size_t n = static_cast<size_t>(py::reinterpret_borrow<py::array>(samples).size());
+                float* x = outputBlock<float>(samples, n);
+                py::gil_scoped_release release;
+                dsp_biquad_cascade(reinterpret_cast<const DspBiquad*>(sections.data()), count, z, x, n);
+            },
+            "Filter float32 samples in place through sections (butterworth), state (float32, 2 per section) "
+            "kept between calls",
+            py::arg("sections"), py::arg("state"), py::arg("samples"));
+
+    // CPUFeatures submodule, mirroring the C++ namespace
+    py::module_ cpu = m.def_submodule("CPUFeatures", "CPU feature detection");
+    cpu.def("has_sse42", &CPUFeatures::hasSSE42);
+    cpu.def("has_avx2", &CPUFeatures::hasAVX2);
+    cpu.def("has_fma", &CPUFeatures::hasFMA);
+    cpu.def("has_avx512f", []() { return CPUFeatures::hasAVX512F() && CPUFeatures::osSupportsAVX512(); });
+    cpu.def("has_neon", &CPUFeatures::hasNEON);
+    cpu.def("print_capabilities", &CPUFeatures::printCapabilities);
 
     // Version info
     m.attr("__version__") = "1.0.0";
-    m.attr("avx2_enabled") = true;
-    
-    #ifdef _OPENMP
-    m.attr("openmp_enabled") = true;
-    #else
+    m.attr("avx2_enabled") = defaultSimdLevel() == SimdLevel::AVX2 || defaultSimdLevel() == SimdLevel::AVX512;
+    // Every parallel loop runs on WorkerPool, so the engine is multi-core
+    // whether or not the compiler offers OpenMP; openmp_enabled stays for
+    // scripts that still read it
+    m.attr("threading_backend") = "std::thread";
     m.attr("openmp_enabled") = false;
-    #endif
 }
\ No newline at end of file
@@ -0,0 +1,399 @@
+#include "session_manager.h"
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+// Prefers numa_node for the pages spanning [data, data + bytes) and moves
+// those already placed elsewhere; the range is widened to whole pages
+bool bindMemory(void* data, size_t bytes, int numa_node) {
+#if defined(__linux__) && defined(SYS_mbind)
+    constexpr int kMaxNodes = 1024;
+    constexpr size_t kBits = 8 * sizeof(unsigned long);
+    if (data == nullptr || bytes == 0 || numa_node < 0 || numa_node >= kMaxNodes) return false;
+    const uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const uintptr_t begin = reinterpret_cast<uintptr_t>(data) & ~(page - 1);
+    const uintptr_t end = (reinterpret_cast<uintptr_t>(data) + bytes + page - 1) & ~(page - 1);
+    unsigned long mask[kMaxNodes / kBits] = {};
+    mask[numa_node / kBits] |= 1UL << (numa_node % kBits);
+    return syscall(SYS_mbind, begin, end - begin, MPOL_PREFERRED, mask,
+                   static_cast<unsigned long>(numa_node) + 2, MPOL_MF_MOVE) == 0;
+#else
+    (void)data;
+    (void)bytes;
+    (void)numa_node;
+    return false;
+#endif
+}
+
+void checkBudget(const SessionBudget& budget) {
+    if (!(budget.cpu_load >= 0.0)) throw std::invalid_argument("session cpu_load must not be negative");
+    if (budget.window == 0) throw std::invalid_argument("session budget window must be at least 1 block");
+    if (!(budget.release > 0.0 && budget.release <= 1.0)) {
+        throw std::invalid_argument("session budget release must be in (0, 1]");
+    }
+}
+
+bool limited(const SessionBudget& budget) { return budget.cpu_load > 0.0 || budget.throttle_on_miss; }
+
+constexpr unsigned kNodeSteps = 3;  // Node rate halvings, down to an eighth
+
+// First node of the group the node steps slow down: the upper three
+// quarters, from a multiple of 8 as MultirateGroups wants
+size_t throttledNodesBegin(size_t nodes) { return (nodes / 4 + 7) / 8 * 8; }
+
+} // namespace
+
+SessionManager::SessionManager(const SessionManagerConfig& config) : config_(config) {
+    checkBudget(config.budget);
+    const std::vector<int> cpus = WorkerPool::availableCpus(config.reserved_cpus);
+    if (cpus.empty()) throw std::runtime_error("no CPUs left for engine sessions");
+
+    std::map<int, std::vector<int>> by_node;
+    for (const CpuLocation& loc : WorkerPool::cpuTopology(cpus)) by_node[loc.numa_node].push_back(loc.cpu);
+
+    for (auto& entry : by_node) {
+        Domain domain;
+        domain.numa_node = entry.first;
+        domain.cpus = entry.second;
+        if (config.threads_per_node > 0 && domain.cpus.size() > config.threads_per_node) {
+            domain.cpus.resize(config.threads_per_node);
+        }
+        // Background worker k runs on cpus[k - 1]; the dispatcher, worker 0,
+        // takes the last CPU for the pass
+        WorkerPoolConfig pool;
+        pool.num_threads = static_cast<unsigned>(domain.cpus.size());
+        pool.cpu_affinity = domain.cpus;
+        pool.wait_policy = config.wait_policy;
+        domain.group = std::make_unique<EngineGroup>(pool);
+        domains_.push_back(std::move(domain));
+    }
+
+    if (domains_.size() > 1) {
+        WorkerPoolConfig dispatch;
+        dispatch.num_threads = static_cast<unsigned>(domains_.size());
+        dispatch.reserved_cpus = config.reserved_cpus;
+        dispatch.wait_policy = config.wait_policy;
+        dispatch_ = std::make_unique<WorkerPool>(dispatch);
+    }
+}
+
+uint64_t SessionManager::createSession(size_t num_nodes, int numa_node) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const size_t index = numa_node < 0 ? leastLoaded() : domainFor(numa_node);
+    Domain& domain = domains_[index];
+
+    // Constructed, and so first touched, on a CPU of the domain
+    Session session;
+    std::exception_ptr error;
+    std::thread build([&]() {
+        ScopedThreadAffinity pin(domain.cpus.front());
+        try {
+            session.engine = std::make_unique<AnalogCellularEngineAVX2>(num_nodes);
+        } catch (...) {
+            error = std::current_exception();
+        }
+    });
+    build.join();
+    if (error) std::rethrow_exception(error);
+
+    session.domain = index;
+    session.budget = config_.budget;
+    session.memory_bound = config_.bind_memory &&
+                           bindMemory(session.engine->bank.storage(), session.engine->bank.storageBytes(),
+                                      domain.numa_node);
+    domain.group->add(*session.engine);
+
+    const uint64_t id = next_id_++;
+    sessions_.emplace(id, std::move(session));
+    return id;
+}
+
+bool SessionManager::destroySession(uint64_t session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.erase(session) > 0;
+}
+
+bool SessionManager::hasSession(uint64_t session) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.count(session) > 0;
+}
+
+std::vector<uint64_t> SessionManager::sessions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<uint64_t> ids;
+    ids.reserve(sessions_.size());
+    for (const auto& entry : sessions_) ids.push_back(entry.first);
+    return ids;
+}
+
+size_t SessionManager::sessionCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return sessions_.size();
+}
+
+AnalogCellularEngineAVX2& SessionManager::engine(uint64_t session) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return *find(session).engine;
+}
+
+int SessionManager::sessionNumaNode(uint64_t session) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return domains_[find(session).domain].numa_node;
+}
+
+bool SessionManager::sessionMemoryBound(uint64_t session) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return find(session).memory_bound;
+}
+
+void SessionManager::processBlocks(const SessionBlock* blocks, size_t count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Domain& domain : domains_) {
+        domain.pass.clear();
+        domain.sessions.clear();
+    }
+    for (size_t s = 0; s < count; s++) {
+        const auto it = sessions_.find(blocks[s].session);
+        if (it == sessions_.end()) throw std::invalid_argument("unknown session in a pass");
+        StreamBlock block;
+        block.engine = it->second.engine.get();
+        block.in = blocks[s].in;
+        block.control = blocks[s].control;
+        block.aux = blocks[s].aux;
+        block.out = blocks[s].out;
+        block.n = blocks[s].n;
+        std::vector<StreamBlock>& pass = domains_[it->second.domain].pass;
+        for (const StreamBlock& other : pass) {
+            if (other.engine == block.engine) throw std::invalid_argument("session appears twice in a pass");
+        }
+        pass.push_back(block);
+        domains_[it->second.domain].sessions.push_back(&it->second);
+    }
+
+    if (!dispatch_) {
+        runDomain(domains_.front());
+    } else {
+        dispatch_->parallelFor(domains_.size(), 1, [&](size_t begin, size_t end, unsigned) {
+            for (size_t d = begin; d < end; d++) runDomain(domains_[d]);
+        });
+    }
+    for (Domain& domain : domains_) {
+        for (size_t k = 0; k < domain.pass.size(); k++) account(*domain.sessions[k], domain.pass[k].n, domain.cpu_ns[k]);
+    }
+}
+
+void SessionManager::runDomain(Domain& domain) {
+    if (domain.pass.empty()) return;
+    ScopedThreadAffinity pin(dispatch_ ? domain.cpus.back() : -1);
+    const auto start = std::chrono::steady_clock::now();
+    domain.cpu_ns.assign(domain.pass.size(), 0);
+    domain.group->processBlocks(domain.pass.data(), domain.pass.size(), domain.cpu_ns.data());
+    domain.busy_ns += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    domain.blocks += domain.pass.size();
+}
+
+void SessionManager::account(Session& session, size_t n, uint64_t cpu_ns) {
+    AnalogCellularEngineAVX2& engine = *session.engine;
+    const DeadlineWatchdog& watchdog = engine.deadlineWatchdog();
+    SessionUsage& usage = session.usage;
+    usage.blocks++;
+    usage.samples += n;
+    usage.cpu_ns += cpu_ns;
+    if (session.throttle > 0) usage.throttled_blocks++;
+    // The watchdog may have been reset under us: count from zero again
+    const uint64_t misses = watchdog.health(DeadlineStage::EngineBlock).misses;
+    const uint64_t missed = misses >= session.misses_seen ? misses - session.misses_seen : misses;
+    session.misses_seen = misses;
+    usage.deadline_misses += missed;
+
+    session.window_blocks++;
+    session.window_cpu_ns += cpu_ns;
+    session.window_budget_ns += watchdog.budgetNs(n);
+    session.window_missed = session.window_missed || missed > 0;
+    if (session.window_blocks < session.budget.window) return;
+
+    const SessionBudget& budget = session.budget;
+    const double load = session.window_budget_ns > 0
+                            ? static_cast<double>(session.window_cpu_ns) / static_cast<double>(session.window_budget_ns)
+                            : 0.0;
+    usage.load = load;
+    const bool over = (budget.cpu_load > 0.0 && load > budget.cpu_load) ||
+                      (budget.throttle_on_miss && session.window_missed);
+    const bool under = !session.window_missed && (budget.cpu_load == 0.0 || load < budget.cpu_load * budget.release);
+    session.window_blocks = 0;
+    session.window_cpu_ns = session.window_budget_ns = 0;
+    session.window_missed = false;
+
+    if (!limited(budget)) {
+        if (session.throttle > 0) applyThrottle(session, 0);
+        return;
+    }
+    if (over) {
+        session.under_windows = 0;
+        if (session.just_lifted) session.lift_after = std::min(session.lift_after * 2, 64u);
+        session.just_lifted = false;
+        applyThrottle(session, session.throttle + 1);
+        return;
+    }
+    if (session.just_lifted) session.lift_after = std::max(session.lift_after / 2, 1u);
+    session.just_lifted = false;
+    session.under_windows = under ? session.under_windows + 1 : 0;
+    if (session.throttle > 0 && session.under_windows >= session.lift_after) {
+        session.under_windows = 0;
+        session.just_lifted = true;
+        applyThrottle(session, session.throttle - 1);
+    }
+}
+
+void SessionManager::applyThrottle(Session& session, unsigned steps) {
+    AnalogCellularEngineAVX2& engine = *session.engine;
+    const size_t nodes = engine.getNodeCount();
+    if (session.throttle == 0) {
+        if (steps == 0) return;
+        session.base_quality = engine.getComputeQuality();
+        session.node_steps = session.budget.throttle_nodes && engine.getNodeGroups().empty() &&
+                             throttledNodesBegin(nodes) < nodes;
+    }
+    const unsigned quality_room =
+        static_cast<unsigned>(kComputeQualityCount - 1) - static_cast<unsigned>(session.base_quality);
+    const unsigned quality = std::min(steps, quality_room);
+    const unsigned node = session.node_steps ? std::min(steps - quality, kNodeSteps) : 0;
+    if (quality + node == session.throttle) return;  // At the bottom already
+
+    engine.setComputeQuality(
+        static_cast<ComputeQuality>(static_cast<unsigned>(session.base_quality) + quality));
+    if (session.node_steps) {
+        if (node > 0) {
+            NodeGroup group;
+            group.first_node = throttledNodesBegin(nodes);
+            group.num_nodes = nodes - group.first_node;
+            group.rate_divisor = 1u << node;
+            engine.setNodeGroups({group});
+        } else if (session.throttle > session.quality_steps) {
+            engine.clearNodeGroups();  // Node steps in force until now
+        }
+    }
+    session.throttle = quality + node;
+    session.quality_steps = quality;
+    session.usage.throttle_changes++;
+}
+
+SessionUsage SessionManager::describe(uint64_t id, const Session& session) const {
+    SessionUsage usage = session.usage;
+    usage.session = id;
+    usage.numa_node = domains_[session.domain].numa_node;
+    usage.nodes = session.engine->getNodeCount();
+    usage.memory_bytes = session.engine->getMemoryBytes();
+    usage.throttle = session.throttle;
+    usage.quality = session.engine->getComputeQuality();
+    usage.node_rate_divisor = 1u << (session.throttle - session.quality_steps);
+    usage.budget = session.budget;
+    return usage;
+}
+
+void SessionManager::setBudget(uint64_t session, const SessionBudget& budget) {
+    checkBudget(budget);
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = sessions_.find(session);
+    if (it == sessions_.end()) throw std::out_of_range("unknown session");
+    Session& s = it->second;
+    s.budget = budget;
+    s.window_blocks = 0;
+    s.window_cpu_ns = s.window_budget_ns = 0;
+    s.window_missed = false;
+    s.under_windows = 0;
+    if (!limited(budget)) applyThrottle(s, 0);
+}
+
+SessionBudget SessionManager::budget(uint64_t session) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return find(session).budget;
+}
+
+SessionUsage SessionManager::usage(uint64_t session) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return describe(session, find(session));
+}
+
+std::vector<SessionUsage> SessionManager::usage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<SessionUsage> usages;
+    usages.reserve(sessions_.size());
+    for (const auto& entry : sessions_) usages.push_back(describe(entry.first, entry.second));
+    return usages;
+}
+
+void SessionManager::resetUsage() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& entry : sessions_) {
+        SessionUsage& usage = entry.second.usage;
+        usage.blocks = usage.samples = usage.cpu_ns = usage.deadline_misses = 0;
+        usage.throttled_blocks = usage.throttle_changes = 0;
+        usage.load = 0.0;
+    }
+}
+
+std::vector<int> SessionManager::numaNodes() const {
+    std::vector<int> nodes;
+    for (const Domain& domain : domains_) nodes.push_back(domain.numa_node);
+    return nodes;
+}
+
+std::vector<NumaNodeLoad> SessionManager::load() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::vector<NumaNodeLoad> loads(domains_.size());
+    for (size_t d = 0; d < domains_.size(); d++) {
+        loads[d].numa_node = domains_[d].numa_node;
+        loads[d].cpus = domains_[d].cpus;
+        loads[d].blocks = domains_[d].blocks;
+        loads[d].busy_ns = domains_[d].busy_ns;
+    }
+    for (const auto& entry : sessions_) {
+        NumaNodeLoad& l = loads[entry.second.domain];
+        l.sessions++;
+        l.engine_nodes += entry.second.engine->getNodeCount();
+        l.bytes += entry.second.engine->bank.bytesAllocated();
+    }
+    return loads;
+}
+
+void SessionManager::resetLoad() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (Domain& domain : domains_) domain.blocks = domain.busy_ns = 0;
+}
+
+size_t SessionManager::domainFor(int numa_node) const {
+    for (size_t d = 0; d < domains_.size(); d++) {
+        if (domains_[d].numa_node == numa_node) return d;
+    }
+    throw std::invalid_argument("no worker CPUs on that NUMA node");
+}
+
+// Fewest cellular nodes per worker CPU, so smaller nodes take less
+size_t SessionManager::leastLoaded() const {
+    std::vector<size_t> nodes(domains_.size(), 0);
+    for (const auto& entry : sessions_) nodes[entry.second.domain] += entry.second.engine->getNodeCount();
+    size_t best = 0;
+    for (size_t d = 1; d < domains_.size(); d++) {
+        // nodes[d] / cpus[d] < nodes[best] / cpus[best], without division
+        if (nodes[d] * domains_[best].cpus.size() < nodes[best] * domains_[d].cpus.size()) best = d;
+    }
+    return best;
+}
+
+const SessionManager::Session& SessionManager::find(uint64_t session) const {
+    const auto it = sessions_.find(session);
+    if (it == sessions_.end()) throw std::out_of_range("unknown session");
+    return it->second;
+}
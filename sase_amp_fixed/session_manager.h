@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "analog_universal_node_engine_avx2.h"
+#include "engine_group.h"
+#include "worker_pool.h"
+
+// CPU budget of one session and how it is kept to
+struct SessionBudget {
+    // Largest CPU load the session may run at: the CPU time of its blocks,
+    // summed over every thread they ran on, over their real-time length at
+    // its engine's deadline watchdog sample rate. 0 for none.
+    double cpu_load = 0.0;
+    bool throttle_on_miss = false;   // A window with an engine block deadline miss is over budget too
+    size_t window = 16;              // Blocks per evaluation
+    double release = 0.7;            // A window under this fraction of cpu_load, with no miss, lifts a step
+    bool throttle_nodes = true;      // Past Draft, step the upper nodes' rate down too
+};
+
+struct SessionManagerConfig {
+    std::vector<int> reserved_cpus;  // Kept free on every NUMA node (e.g. audio I/O)
+    unsigned threads_per_node = 0;   // Workers per NUMA node (0: each of its CPUs)
+    WaitPolicy wait_policy = WaitPolicy::Sleep;
+    bool bind_memory = true;         // mbind each bank to its node (Linux), besides first touch
+    SessionBudget budget;            // Of every new session; none by default
+};
+
+// One session's share of a SessionManager pass; the fields follow
+// AnalogCellularEngineAVX2::processBlock (control, aux and out may be null).
+struct SessionBlock {
+    uint64_t session = 0;
+    const float* in = nullptr;
+    const float* control = nullptr;
+    const float* aux = nullptr;
+    float* out = nullptr;
+    size_t n = 0;
+};
+
+// Load of one NUMA node's sessions since creation or resetLoad()
+struct NumaNodeLoad {
+    int numa_node = 0;
+    std::vector<int> cpus;           // Its workers' CPUs
+    size_t sessions = 0;
+    size_t engine_nodes = 0;         // Cellular nodes of its sessions
+    size_t bytes = 0;                // Their node banks
+    uint64_t blocks = 0;             // Session blocks processed
+    uint64_t busy_ns = 0;            // Wall time of its passes
+};
+
+// Resource use of one session since creation or resetUsage()
+struct SessionUsage {
+    uint64_t session = 0;
+    int numa_node = 0;
+    size_t nodes = 0;                // Cellular nodes
+    size_t memory_bytes = 0;         // getMemoryBytes() of its engine, now
+    uint64_t blocks = 0;
+    uint64_t samples = 0;
+    uint64_t cpu_ns = 0;             // Thread CPU time of its blocks
+    uint64_t deadline_misses = 0;    // Engine blocks over their real-time length
+    double load = 0.0;               // CPU load of the last full window
+    uint64_t throttled_blocks = 0;   // Run under a throttle step
+    uint64_t throttle_changes = 0;   // Steps taken or lifted
+    unsigned throttle = 0;           // Steps in force: quality levels first, then node rate halvings
+    ComputeQuality quality = ComputeQuality::Full;
+    unsigned node_rate_divisor = 1;  // Of the throttled upper nodes
+    SessionBudget budget;
+};
+
+// Engine sessions placed on NUMA nodes, each node's sessions on workers of
+// its own CPUs.
+//
+// Every NUMA node the worker CPUs span gets an EngineGroup whose pool is
+// pinned to that node's CPUs. A new session goes to the node with the
+// fewest cellular nodes (or the one asked for); its engine is constructed
+// on a thread pinned there, so the bank is first touched locally, and with
+// bind_memory its storage is also mbind()ed to the node, moving any pages
+// the allocator handed out from elsewhere. A pass splits the blocks by node
+// and runs the nodes side by side, each from a dispatcher pinned to one of
+// its CPUs for the pass. On a single-node host this is one EngineGroup.
+//
+// Every session's blocks are accounted in thread CPU time, memory and
+// engine deadline misses. A session over its SessionBudget for a window of
+// blocks is throttled one step at the end of that window: its compute
+// quality goes down a level, and once at Draft, with throttle_nodes, the
+// upper three quarters of its nodes run as a multirate group at half the
+// rate of the step before, down to an eighth. A window well under budget
+// lifts the last step. The quality a session had before its first step is
+// the one it returns to; node groups of its own keep the node steps off.
+// usage() is the per-session view a scheduler places sessions by.
+//
+// Sessions, passes and load reports may come from any thread; they are
+// serialized by one lock, so no engine is destroyed during a pass.
+class SessionManager {
+public:
+    // Throws std::runtime_error when no CPU is left after reserved_cpus
+    explicit SessionManager(const SessionManagerConfig& config = SessionManagerConfig());
+
+    SessionManager(const SessionManager&) = delete;
+    SessionManager& operator=(const SessionManager&) = delete;
+
+    // New engine of num_nodes nodes on numa_node, or the least loaded node
+    // for -1; returns its session id. Throws std::invalid_argument for a
+    // NUMA node the manager has no CPUs on.
+    uint64_t createSession(size_t num_nodes, int numa_node = -1);
+    // False for an unknown id
+    bool destroySession(uint64_t session);
+    bool hasSession(uint64_t session) const;
+    std::vector<uint64_t> sessions() const;
+    size_t sessionCount() const;
+
+    // The session's engine, for settings and reads outside passes. Throws
+    // std::out_of_range for an unknown id.
+    AnalogCellularEngineAVX2& engine(uint64_t session);
+    int sessionNumaNode(uint64_t session) const;
+    // Whether the bank's pages were bound to the node (bind_memory and a
+    // successful mbind)
+    bool sessionMemoryBound(uint64_t session) const;
+
+    // Advances each block's session by one block, then accounts it and
+    // applies its budget. Sessions must exist and appear at most once;
+    // throws std::invalid_argument otherwise.
+    void processBlocks(const SessionBlock* blocks, size_t count);
+
+    // Replaces a session's budget; the new one starts a fresh window. A
+    // budget with no cpu_load and no throttle_on_miss lifts every step at
+    // once. Throws std::out_of_range for an unknown id and
+    // std::invalid_argument for a negative cpu_load, a zero window or a
+    // release outside (0, 1].
+    void setBudget(uint64_t session, const SessionBudget& budget);
+    SessionBudget budget(uint64_t session) const;
+    // Throws std::out_of_range for an unknown id
+    SessionUsage usage(uint64_t session) const;
+    // Every session, in id order
+    std::vector<SessionUsage> usage() const;
+    // Zeroes the block, CPU, miss and throttle counters; steps in force stay
+    void resetUsage();
+
+    std::vector<int> numaNodes() const;
+    std::vector<NumaNodeLoad> load() const;
+    // Zeroes the block and busy counters; placement is unchanged
+    void resetLoad();
+
+private:
+    struct Session;
+
+    struct Domain {
+        int numa_node = 0;
+        std::vector<int> cpus;
+        std::unique_ptr<EngineGroup> group;
+        std::vector<StreamBlock> pass;   // This pass's blocks, reused
+        std::vector<Session*> sessions;  // Theirs
+        std::vector<uint64_t> cpu_ns;    // CPU time of each
+        uint64_t blocks = 0;
+        uint64_t busy_ns = 0;
+    };
+
+    struct Session {
+        std::unique_ptr<AnalogCellularEngineAVX2> engine;
+        size_t domain = 0;
+        bool memory_bound = false;
+        SessionBudget budget;
+        SessionUsage usage;             // Counters; the rest is filled in by usage()
+        uint64_t misses_seen = 0;       // Watchdog misses already accounted
+        // Current window
+        size_t window_blocks = 0;
+        uint64_t window_cpu_ns = 0;
+        uint64_t window_budget_ns = 0;
+        bool window_missed = false;
+        // Throttle
+        unsigned throttle = 0;
+        ComputeQuality base_quality = ComputeQuality::Full;
+        unsigned quality_steps = 0;     // Of throttle, taken on the quality
+        bool node_steps = false;        // Whether node steps were open when throttling began
+        // Windows under budget a lift waits for; doubles when the load goes
+        // straight back over after one, so a session on the edge settles
+        unsigned lift_after = 1;
+        unsigned under_windows = 0;
+        bool just_lifted = false;
+    };
+
+    size_t domainFor(int numa_node) const;
+    size_t leastLoaded() const;
+    const Session& find(uint64_t session) const;
+    void runDomain(Domain& domain);
+    // Adds one block of n samples and cpu_ns to a session; at the end of a
+    // window, takes or lifts a throttle step
+    void account(Session& session, size_t n, uint64_t cpu_ns);
+    // Puts the session's engine at throttle level steps
+    void applyThrottle(Session& session, unsigned steps);
+    SessionUsage describe(uint64_t id, const Session& session) const;
+
+    SessionManagerConfig config_;
+    mutable std::mutex mutex_;
+    std::vector<Domain> domains_;
+    std::map<uint64_t, Session> sessions_;
+    uint64_t next_id_ = 1;
+    std::unique_ptr<WorkerPool> dispatch_;   // One thread per domain past the first
+};
@@ -0,0 +1,297 @@
+#include "session_store.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <set>
+#include <stdexcept>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'A', 'S', 'E', 'S', 'E', 'S', 'S'};
+constexpr uint32_t kByteOrderTag = 0x01020304u;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;    // kByteOrderTag as the writing host stores it
+    uint64_t header_bytes;  // Offset of the first column
+    uint64_t column_count;
+    uint64_t sample_count;
+    uint64_t chunk_samples;
+    uint64_t chunk_count;
+    uint64_t column_bytes;    // One column block, padded
+    uint64_t summary_offset;  // Offset of the first summary block
+    uint64_t file_bytes;
+    double duration;
+    char names[kSessionStoreMaxColumns][kSessionStoreNameBytes];
+};
+static_assert(sizeof(Header) <= kSessionStoreHeaderBytes, "session header must fit its page");
+
+uint64_t columnBytes(uint64_t samples) {
+    return (samples * sizeof(double) + 63) & ~uint64_t(63);
+}
+
+[[noreturn]] void fail(const std::string& path, const std::string& what) {
+    throw std::runtime_error("session " + path + ": " + what);
+}
+
+struct FileCloser {
+    void operator()(std::FILE* f) const { std::fclose(f); }
+};
+using File = std::unique_ptr<std::FILE, FileCloser>;
+
+bool writeAll(std::FILE* f, const void* data, size_t bytes) {
+    return bytes == 0 || std::fwrite(data, 1, bytes, f) == bytes;
+}
+
+// count values summarized as mean and sum of squared deviations
+struct Moments {
+    uint64_t count = 0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    // Chan et al.'s pairwise update
+    void merge(uint64_t n, double lo, double hi, double m, double sq) {
+        if (n == 0) return;
+        const uint64_t total = count + n;
+        const double delta = m - mean;
+        mean += delta * static_cast<double>(n) / static_cast<double>(total);
+        m2 += sq + delta * delta * static_cast<double>(count) * static_cast<double>(n) / static_cast<double>(total);
+        count = total;
+        min = std::min(min, lo);
+        max = std::max(max, hi);
+    }
+
+    // Two passes over raw values, for chunk summaries and range edges
+    void addValues(const double* values, size_t n) {
+        if (n == 0) return;
+        double lo = values[0], hi = values[0], sum = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            lo = std::min(lo, values[i]);
+            hi = std::max(hi, values[i]);
+            sum += values[i];
+        }
+        const double m = sum / static_cast<double>(n);
+        double sq = 0.0;
+        for (size_t i = 0; i < n; i++) sq += (values[i] - m) * (values[i] - m);
+        merge(n, lo, hi, m, sq);
+    }
+};
+
+} // namespace
+
+void writeSessionStore(const std::string& path, const std::vector<std::string>& names, const double* columns,
+                       size_t samples, double duration, size_t chunk_samples) {
+    if (names.empty()) throw std::invalid_argument("a session needs at least one column");
+    if (names.size() > kSessionStoreMaxColumns) {
+        throw std::invalid_argument("a session holds at most " + std::to_string(kSessionStoreMaxColumns) + " columns");
+    }
+    if (chunk_samples == 0) throw std::invalid_argument("chunk_samples must be at least 1");
+    std::set<std::string> seen;
+    for (const std::string& name : names) {
+        if (name.empty() || name.size() >= kSessionStoreNameBytes) {
+            throw std::invalid_argument("column names must be 1 to " + std::to_string(kSessionStoreNameBytes - 1) +
+                                        " bytes");
+        }
+        if (!seen.insert(name).second) throw std::invalid_argument("duplicate column name " + name);
+    }
+
+    Header h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kSessionStoreVersion;
+    h.byte_order = kByteOrderTag;
+    h.header_bytes = kSessionStoreHeaderBytes;
+    h.column_count = names.size();
+    h.sample_count = samples;
+    h.chunk_samples = chunk_samples;
+    h.chunk_count = (samples + chunk_samples - 1) / chunk_samples;
+    h.column_bytes = columnBytes(samples);
+    h.summary_offset = h.header_bytes + h.column_count * h.column_bytes;
+    h.file_bytes = h.summary_offset + h.column_count * h.chunk_count * sizeof(SessionChunkSummary);
+    h.duration = duration;
+    for (size_t c = 0; c < names.size(); c++) std::memcpy(h.names[c], names[c].data(), names[c].size());
+
+    File f(std::fopen(path.c_str(), "wb"));
+    if (!f) fail(path, "cannot create");
+
+    // Zero page first; the real header goes in once the payload is down
+    std::vector<unsigned char> page(kSessionStoreHeaderBytes, 0);
+    const size_t padding = h.column_bytes - samples * sizeof(double);
+    bool ok = writeAll(f.get(), page.data(), page.size());
+    for (size_t c = 0; ok && c < names.size(); c++) {
+        ok = writeAll(f.get(), columns + c * samples, samples * sizeof(double)) &&
+             writeAll(f.get(), page.data(), padding);
+    }
+    std::vector<SessionChunkSummary> summaries(h.chunk_count);
+    for (size_t c = 0; ok && c < names.size(); c++) {
+        const double* values = columns + c * samples;
+        for (size_t k = 0; k < h.chunk_count; k++) {
+            const size_t first = k * chunk_samples;
+            const size_t n = std::min(chunk_samples, samples - first);
+            Moments chunk;
+            chunk.addValues(values + first, n);
+            summaries[k] = {chunk.min, chunk.max, chunk.mean, chunk.m2 / static_cast<double>(n)};
+        }
+        ok = writeAll(f.get(), summaries.data(), summaries.size() * sizeof(SessionChunkSummary));
+    }
+    ok = ok && std::fflush(f.get()) == 0 && std::fseek(f.get(), 0, SEEK_SET) == 0 &&
+         writeAll(f.get(), &h, sizeof(h));
+    const int close_status = std::fclose(f.release());
+    if (!ok || close_status != 0) fail(path, "write failed");
+}
+
+// Whole file mapped read-only
+struct SessionStore::Mapping {
+    const unsigned char* data = nullptr;
+    size_t size = 0;
+
+    explicit Mapping(const std::string& path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) fail(path, "cannot open");
+        LARGE_INTEGER bytes;
+        if (!GetFileSizeEx(file, &bytes)) {
+            CloseHandle(file);
+            fail(path, "cannot stat");
+        }
+        size = static_cast<size_t>(bytes.QuadPart);
+        HANDLE mapping = size ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+        CloseHandle(file);
+        if (!mapping) fail(path, "cannot map");
+        data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        CloseHandle(mapping);
+        if (!data) fail(path, "cannot map");
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) fail(path, "cannot open");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            fail(path, "cannot stat");
+        }
+        size = static_cast<size_t>(st.st_size);
+        void* mapped = size ? ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (mapped == MAP_FAILED) fail(path, "cannot map");
+        data = static_cast<const unsigned char*>(mapped);
+#endif
+    }
+
+    ~Mapping() {
+#ifdef _WIN32
+        UnmapViewOfFile(data);
+#else
+        ::munmap(const_cast<unsigned char*>(data), size);
+#endif
+    }
+};
+
+SessionStore::SessionStore(const std::string& path) : path_(path), mapping_(std::make_unique<Mapping>(path)) {
+    if (mapping_->size < sizeof(Header)) fail(path, "truncated");
+    Header h;
+    std::memcpy(&h, mapping_->data, sizeof(h));
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) fail(path, "not a session store or incomplete");
+    if (h.version != kSessionStoreVersion) fail(path, "unsupported version " + std::to_string(h.version));
+    if (h.byte_order != kByteOrderTag) fail(path, "written with another byte order");
+    if (h.header_bytes != kSessionStoreHeaderBytes || h.column_count == 0 ||
+        h.column_count > kSessionStoreMaxColumns || h.chunk_samples == 0 ||
+        h.chunk_count != (h.sample_count + h.chunk_samples - 1) / h.chunk_samples ||
+        h.column_bytes != columnBytes(h.sample_count) ||
+        h.summary_offset != h.header_bytes + h.column_count * h.column_bytes ||
+        h.file_bytes != h.summary_offset + h.column_count * h.chunk_count * sizeof(SessionChunkSummary)) {
+        fail(path, "inconsistent header");
+    }
+    if (mapping_->size != h.file_bytes) fail(path, "truncated");
+
+    for (size_t c = 0; c < h.column_count; c++) {
+        names_.emplace_back(h.names[c], strnlen(h.names[c], kSessionStoreNameBytes));
+    }
+    samples_ = static_cast<size_t>(h.sample_count);
+    chunk_samples_ = static_cast<size_t>(h.chunk_samples);
+    chunks_ = static_cast<size_t>(h.chunk_count);
+    duration_ = h.duration;
+    column_bytes_ = h.column_bytes;
+    summary_offset_ = h.summary_offset;
+}
+
+SessionStore::~SessionStore() = default;
+
+size_t SessionStore::columnIndex(const std::string& name) const {
+    for (size_t c = 0; c < names_.size(); c++) {
+        if (names_[c] == name) return c;
+    }
+    throw std::out_of_range("session " + path_ + " has no column " + name);
+}
+
+const double* SessionStore::column(size_t c) const {
+    if (c >= names_.size()) throw std::out_of_range("column index out of range");
+    return reinterpret_cast<const double*>(mapping_->data + kSessionStoreHeaderBytes + c * column_bytes_);
+}
+
+const SessionChunkSummary* SessionStore::chunks(size_t c) const {
+    if (c >= names_.size()) throw std::out_of_range("column index out of range");
+    return reinterpret_cast<const SessionChunkSummary*>(mapping_->data + summary_offset_ +
+                                                        c * chunks_ * sizeof(SessionChunkSummary));
+}
+
+SessionRangeStats SessionStore::stats(size_t c, size_t begin, size_t end) const {
+    const double* values = column(c);
+    const SessionChunkSummary* summary = chunks(c);
+    end = std::min(end, samples_);
+    begin = std::min(begin, end);
+
+    // Partial head, whole chunks, partial tail
+    Moments moments;
+    const size_t first_whole = (begin + chunk_samples_ - 1) / chunk_samples_;
+    const size_t last_whole = end == samples_ ? chunks_ : end / chunk_samples_;
+    if (first_whole >= last_whole) {
+        moments.addValues(values + begin, end - begin);
+    } else {
+        moments.addValues(values + begin, first_whole * chunk_samples_ - begin);
+        for (size_t k = first_whole; k < last_whole; k++) {
+            const size_t n = std::min(chunk_samples_, samples_ - k * chunk_samples_);
+            moments.merge(n, summary[k].min, summary[k].max, summary[k].mean,
+                          summary[k].variance * static_cast<double>(n));
+        }
+        const size_t tail = std::min(last_whole * chunk_samples_, end);
+        moments.addValues(values + tail, end - tail);
+    }
+
+    SessionRangeStats result;
+    result.count = moments.count;
+    if (moments.count == 0) {
+        const double nan = std::numeric_limits<double>::quiet_NaN();
+        result.min = result.max = result.mean = result.variance = nan;
+        return result;
+    }
+    result.min = moments.min;
+    result.max = moments.max;
+    result.mean = moments.mean;
+    result.variance = moments.m2 / static_cast<double>(moments.count);
+    return result;
+}
+
+std::vector<size_t> SessionStore::chunksInRange(size_t c, double lo, double hi) const {
+    const SessionChunkSummary* summary = chunks(c);
+    std::vector<size_t> found;
+    for (size_t k = 0; k < chunks_; k++) {
+        if (summary[k].max >= lo && summary[k].min <= hi) found.push_back(k);
+    }
+    return found;
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Summary of one chunk of one column; variance is the population variance
+// of the chunk's samples, as numpy.var gives it
+struct SessionChunkSummary {
+    double min;
+    double max;
+    double mean;
+    double variance;
+};
+
+// Statistics of a sample range, merged from chunk summaries where the range
+// covers whole chunks. min, max, mean and variance are NaN for an empty range.
+struct SessionRangeStats {
+    uint64_t count = 0;
+    double min = 0.0;
+    double max = 0.0;
+    double mean = 0.0;
+    double variance = 0.0;
+};
+
+// Recorded session file, version 1, in host byte order:
+//
+//   [0, kSessionStoreHeaderBytes)   header with the column names, zero padded
+//                                   to a page
+//   column blocks                   one per column, sample_count float64
+//                                   values zero padded to 64 bytes
+//   summary blocks                  one per column, a SessionChunkSummary for
+//                                   each chunk of chunk_samples samples (the
+//                                   last may be short)
+//
+// Every column starts 64-byte aligned, so a read-only mapping of the file
+// serves the columns in place: opening a session reads the header and
+// nothing else, and a comparison touches only the columns and summaries it
+// asks for. The header is written last, so a save cut short leaves a file
+// that fails to open.
+constexpr uint64_t kSessionStoreHeaderBytes = 4096;
+constexpr uint32_t kSessionStoreVersion = 1;
+constexpr size_t kSessionStoreMaxColumns = 64;
+constexpr size_t kSessionStoreNameBytes = 48;  // Name plus its terminating NUL
+constexpr size_t kSessionStoreChunkSamples = 256;
+
+// Writes `names.size()` columns of `samples` values each, column c at
+// columns + c * samples, with summaries of every chunk_samples samples.
+// Values must be finite. Throws std::invalid_argument for no columns, more
+// than kSessionStoreMaxColumns, an empty, duplicate or over-long name, or a
+// zero chunk size, and std::runtime_error with the reason on I/O errors.
+void writeSessionStore(const std::string& path, const std::vector<std::string>& names, const double* columns,
+                       size_t samples, double duration, size_t chunk_samples = kSessionStoreChunkSamples);
+
+// A session file mapped read-only. Throws std::runtime_error when the file
+// cannot be mapped or is not a complete version-1 session of this host's
+// byte order.
+class SessionStore {
+public:
+    explicit SessionStore(const std::string& path);
+    ~SessionStore();
+
+    SessionStore(const SessionStore&) = delete;
+    SessionStore& operator=(const SessionStore&) = delete;
+
+    const std::string& path() const { return path_; }
+    size_t columnCount() const { return names_.size(); }
+    size_t sampleCount() const { return samples_; }
+    size_t chunkSamples() const { return chunk_samples_; }
+    size_t chunkCount() const { return chunks_; }
+    double duration() const { return duration_; }
+    const std::vector<std::string>& columnNames() const { return names_; }
+
+    // Index of a named column; throws std::out_of_range if there is none
+    size_t columnIndex(const std::string& name) const;
+
+    // sampleCount() values of column c, and its chunkCount() summaries, in
+    // the mapping. Both throw std::out_of_range for a bad column.
+    const double* column(size_t c) const;
+    const SessionChunkSummary* chunks(size_t c) const;
+
+    // Statistics of samples [begin, end) of column c (end is clamped to the
+    // sample count). Whole chunks come from their summaries; only the
+    // partial chunks at either edge read samples.
+    SessionRangeStats stats(size_t c, size_t begin = 0, size_t end = SIZE_MAX) const;
+
+    // Chunks of column c holding a value in [lo, hi], going by their
+    // summaries alone
+    std::vector<size_t> chunksInRange(size_t c, double lo, double hi) const;
+
+private:
+    struct Mapping;
+
+    std::string path_;
+    std::unique_ptr<Mapping> mapping_;
+    std::vector<std::string> names_;
+    size_t samples_ = 0;
+    size_t chunk_samples_ = 0;
+    size_t chunks_ = 0;
+    double duration_ = 0.0;
+    uint64_t column_bytes_ = 0;
+    uint64_t summary_offset_ = 0;
+};
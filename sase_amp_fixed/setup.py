@@ -39,18 +39,84 @@ is_macos = sys.platform == 'darwin'
 # Base configuration
 sources = [
     'analog_universal_node_engine_avx2.cpp',
+    'worker_pool.cpp',
+    'fft_backend.cpp',
+    'fft_plan_cache.cpp',
+    'spectral_stream.cpp',
+    'partitioned_convolver.cpp',
+    'harmonic_bank.cpp',
+    'grid_coupling.cpp',
+    'grid_shard.cpp',
+    'clock_sync.cpp',
+    'pipeline_trace.cpp',
+    'block_stats.cpp',
+    'dlpack_export.cpp',
+    'chroma_analyzer.cpp',
+    'sparse_coupling.cpp',
+    'active_set.cpp',
+    'multirate_groups.cpp',
+    'gpu_node_bank.cpp',
+    'engine_group.cpp',
+    'engine_arena.cpp',
+    'session_manager.cpp',
+    'async_block.cpp',
+    'async_pipeline.cpp',
+    'stage_graph.cpp',
+    'chromatic_stream.cpp',
+    'audio_host.cpp',
+    'state_snapshot.cpp',
+    'mission_checkpoint.cpp',
+    'node_recorder.cpp',
+    'filter_bank.cpp',
+    'shared_state.cpp',
+    'ici_kernel.cpp',
+    'correlation_kernel.cpp',
+    'session_store.cpp',
+    'forecast_kernel.cpp',
+    'metrics_codec.cpp',
+    'chromatic_color.cpp',
+    'audio_file.cpp',
+    'offline_replay.cpp',
+    'batch_render.cpp',
+    'output_stage.cpp',
+    'parameter_automation.cpp',
+    'parameter_switch.cpp',
+    'phase_lock.cpp',
+    'openmetrics.cpp',
+    'output_publisher.cpp',
+    'flight_recorder.cpp',
+    'deadline_watchdog.cpp',
+    'engine_benchmark.cpp',
+    'perf_counters.cpp',
+    'latency_histogram.cpp',
+    'timeline_trace.cpp',
+    'compact_node_bank.cpp',
+    'node_equation.cpp',
+    'node_equation_jit.cpp',
+    'node_kernels.cpp',
+    'node_kernels_scalar.cpp',
+    'node_kernels_sse42.cpp',
+    'node_kernels_avx2.cpp',
+    'node_kernels_avx512.cpp',
+    'node_kernels_neon.cpp',
+    '../hardware/phi_packet.cpp',   # Φ-sensor serial framing (decode_phi_stream)
+    'frequency_response.cpp',       # Node frequency response analyzer (on the DSP core)
+    '../hardware/dsp_core.cpp',     # DSP core shared with the firmware (dase_engine.dsp)
     'python_bindings.cpp'
 ]
 
 include_dirs = [
     pybind11.get_include(),
-    '.'  # Current directory for headers
+    '.',  # Current directory for headers
+    '../hardware'  # phi_packet.h, dsp_core.h
 ]
 
 library_dirs = ['.']
 libraries = []
 
 # Platform-specific compiler flags (FR-003)
+# No global ISA flags: the node kernels are built per instruction set in
+# node_kernels_<level>.cpp and picked at runtime, so one wheel runs anywhere.
 if is_windows:
     # MSVC compiler flags
     extra_compile_args = [
@@ -58,52 +124,39 @@ if is_windows:
         '/bigobj',      # Large object files
         '/std:c++17',   # C++17 standard
         '/O2',          # Optimize for speed
-        '/arch:AVX2',   # Enable AVX2 instructions
         '/fp:fast',     # Fast floating point
         '/DNOMINMAX',   # Disable min/max macros
-        '/openmp',      # Enable OpenMP parallelization
     ]
     extra_link_args = []
-    libraries = ['libfftw3-3']
+    libraries = ['ws2_32', 'avrt', 'winmm']  # Winsock: MetricsHttpServer; MMCSS and timer: WorkerPool
 
-    print("Building for Windows (MSVC) with AVX2 + OpenMP optimization")
+    print("Building for Windows (MSVC) with runtime SIMD dispatch")
 
 elif is_linux:
     # GCC/Clang compiler flags for Linux
     extra_compile_args = [
         '-std=c++17',       # C++17 standard
         '-O3',              # Maximum optimization
-        '-march=native',    # Optimize for current CPU
-        '-mavx2',           # Enable AVX2 instructions
-        '-msse4.2',         # Enable SSE 4.2
-        '-mfma',            # Enable FMA instructions
         '-ffast-math',      # Fast math optimizations
         '-fPIC',            # Position independent code
         '-Wall',            # Enable warnings
         '-Wno-unused-result',
     ]
 
-    # Check for OpenMP support
-    if os.path.exists('/usr/lib/gcc') or os.path.exists('/usr/lib/x86_64-linux-gnu/'):
-        extra_compile_args.append('-fopenmp')
-        extra_link_args = ['-fopenmp']
-    else:
-        extra_link_args = []
+    # Engine worker pool (std::thread + pthread affinity); no OpenMP, so
+    # every compiler builds the same multi-core engine
+    extra_compile_args.append('-pthread')
+    extra_link_args = ['-pthread']
 
-    # FFTW3 library
-    libraries = ['fftw3']
+    libraries = ['rt']  # rt: shm_open on glibc before 2.34
 
-    print("Building for Linux (GCC/Clang) with AVX2 optimization")
+    print("Building for Linux (GCC/Clang) with runtime SIMD dispatch")
 
 elif is_macos:
     # Clang compiler flags for macOS
     extra_compile_args = [
         '-std=c++17',       # C++17 standard
         '-O3',              # Maximum optimization
-        '-march=native',    # Optimize for current CPU
-        '-mavx2',           # Enable AVX2 instructions
-        '-msse4.2',         # Enable SSE 4.2
-        '-mfma',            # Enable FMA instructions
         '-ffast-math',      # Fast math optimizations
         '-fPIC',            # Position independent code
         '-Wall',            # Enable warnings
@@ -119,15 +172,85 @@ elif is_macos:
         library_dirs.append('/usr/local/lib')
         include_dirs.append('/usr/local/include')
 
-    libraries = ['fftw3']
-
-    print("Building for macOS (Clang) with AVX2 optimization")
+    print("Building for macOS (Clang) with runtime SIMD dispatch")
 
 else:
     print(f"WARNING: Unsupported platform: {sys.platform}")
     print("Using default compiler flags")
-    extra_compile_args = ['-std=c++17', '-O2']
-    extra_link_args = []
+    extra_compile_args = ['-std=c++17', '-O2', '-pthread']
+    extra_link_args = ['-pthread']
+
+# FFT backends (fft_backend.h). FFTW is built in unless DASE_FFTW=0, which
+# leaves the bundled builtin transform; DASE_MKL=1 adds oneMKL (MKLROOT) and
+# DASE_ACCELERATE=1, the default on macOS, adds Apple's vDSP.
+define_macros = []
+extra_objects = []
+if os.environ.get('DASE_FFTW', '1') == '1':
+    define_macros += [('DASE_WITH_FFTW', '1'), ('DSP_CORE_FFTW', '1')]  # DSP_CORE_FFTW: FFTW backend of the DSP core
+    libraries.insert(0, 'libfftw3-3' if is_windows else 'fftw3')
+    # Optional multithreaded FFTW for large blocks: DASE_FFTW_THREADS=1 links
+    # FFTW's threads library (libfftw3_threads; built into the Windows DLL)
+    if os.environ.get('DASE_FFTW_THREADS') == '1':
+        define_macros.append(('DASE_WITH_FFTW_THREADS', '1'))
+        if not is_windows:
+            libraries.insert(0, 'fftw3_threads')
+        print("Multithreaded FFTW enabled")
+else:
+    print("FFTW disabled: builtin FFT backend")
+if os.environ.get('DASE_MKL') == '1':
+    mkl_root = os.environ.get('MKLROOT', '/opt/intel/oneapi/mkl/latest')
+    include_dirs.append(os.path.join(mkl_root, 'include'))
+    library_dirs.append(os.path.join(mkl_root, 'lib'))
+    define_macros.append(('DASE_WITH_MKL', '1'))
+    libraries.append('mkl_rt')
+    print("MKL FFT backend enabled")
+if os.environ.get('DASE_ACCELERATE', '1' if is_macos else '0') == '1':
+    define_macros.append(('DASE_WITH_ACCELERATE', '1'))
+    extra_link_args += ['-framework', 'Accelerate']
+    print("Accelerate FFT backend enabled")
+
+# Optional CUDA compute backend: DASE_CUDA=1 compiles gpu_node_bank.cu with
+# nvcc (NVCC overrides the compiler) and links the CUDA runtime
+if os.environ.get('DASE_CUDA') == '1':
+    import subprocess
+    nvcc = os.environ.get('NVCC', 'nvcc')
+    os.makedirs('build', exist_ok=True)
+    gpu_object = os.path.join('build', 'gpu_node_bank.o')
+    subprocess.check_call([nvcc, '-std=c++17', '-O3', '-Xcompiler', '-fPIC', '-DDASE_WITH_CUDA', '-I.',
+                           '-c', 'gpu_node_bank.cu', '-o', gpu_object])
+    extra_objects.append(gpu_object)
+    define_macros.append(('DASE_WITH_CUDA', '1'))
+    libraries.append('cudart')
+    cuda_home = os.environ.get('CUDA_HOME', '/usr/local/cuda')
+    library_dirs.append(os.path.join(cuda_home, 'lib64'))
+    print("CUDA compute backend enabled")
+
+# Optional native audio host devices (NativeAudioHost): DASE_PORTAUDIO=1
+# links PortAudio; without it only the simulated backend is built
+if os.environ.get('DASE_PORTAUDIO') == '1':
+    define_macros.append(('DASE_WITH_PORTAUDIO', '1'))
+    libraries.append('portaudio_x64' if is_windows else 'portaudio')
+    print("PortAudio audio host enabled")
+
+# Optional JIT backend of node equations: DASE_LLVM=1 links LLVM (ORC),
+# located through llvm-config (LLVM_CONFIG overrides it); without it node
+# equations run on the portable tape backend
+if os.environ.get('DASE_LLVM') == '1':
+    import subprocess
+    llvm_config = os.environ.get('LLVM_CONFIG', 'llvm-config')
+    llvm = lambda *args: subprocess.check_output([llvm_config, *args], text=True).split()
+    define_macros.append(('DASE_WITH_LLVM', '1'))
+    include_dirs += llvm('--includedir')
+    library_dirs += llvm('--libdir')
+    libraries += [lib[2:] if lib.startswith('-l') else os.path.splitext(lib)[0]
+                  for lib in llvm('--libs', 'orcjit', 'native', 'passes')]
+    print("LLVM node equation JIT enabled")
+
+# Optional compressed snapshots and checkpoints: DASE_ZLIB=1 links zlib
+if os.environ.get('DASE_ZLIB') == '1':
+    define_macros.append(('DASE_WITH_ZLIB', '1'))
+    libraries.append('zlib' if is_windows else 'z')
+    print("Snapshot compression enabled")
 
 # CPU feature detection
 print(f"Python version: {sys.version}")
@@ -144,6 +267,8 @@ ext_modules = [
         library_dirs=library_dirs,
         libraries=libraries,
         language='c++',
+        define_macros=define_macros,
+        extra_objects=extra_objects,
         extra_compile_args=extra_compile_args,
         extra_link_args=extra_link_args,
     ),
@@ -183,7 +308,7 @@ if __name__ == '__main__':
     print(f"Extension: dase_engine")
     print(f"Sources: {', '.join(sources)}")
     print(f"Platform: {sys.platform}")
-    print(f"Optimization: AVX2 + OpenMP")
+    print(f"Optimization: runtime SIMD dispatch (scalar / SSE4.2 / AVX2 / AVX-512 / NEON)")
     print("="*70)
     print("\nTo verify build:")
     print("  python -c \"import dase_engine; print(dase_engine.__version__)\"")
@@ -0,0 +1,237 @@
+#include "shared_state.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+#include <stdexcept>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'A', 'S', 'E', 'S', 'H', 'M', '1'};
+
+[[noreturn]] void fail(const std::string& name, const std::string& what) {
+    throw std::runtime_error("shared state " + name + ": " + what);
+}
+
+} // namespace
+
+// One mapping of a named segment: created read-write by the writer, opened
+// read-only by readers
+class SharedMemoryRegion {
+public:
+    // Creates (bytes > 0) or opens (bytes == 0) the segment
+    SharedMemoryRegion(const std::string& name, size_t bytes) : name_(name), owner_(bytes > 0) {
+#ifdef _WIN32
+        const std::string object = name.empty() || name[0] != '/' ? name : name.substr(1);
+        if (owner_) {
+            handle_ = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                         static_cast<DWORD>(static_cast<uint64_t>(bytes) >> 32),
+                                         static_cast<DWORD>(bytes & 0xffffffffu), object.c_str());
+            if (!handle_) fail(name, "cannot create");
+            data_ = static_cast<unsigned char*>(MapViewOfFile(handle_, FILE_MAP_ALL_ACCESS, 0, 0, 0));
+        } else {
+            handle_ = OpenFileMappingA(FILE_MAP_READ, FALSE, object.c_str());
+            if (!handle_) fail(name, "no such segment");
+            data_ = static_cast<unsigned char*>(MapViewOfFile(handle_, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (!data_) {
+            CloseHandle(handle_);
+            fail(name, "cannot map");
+        }
+        MEMORY_BASIC_INFORMATION info;
+        size_ = VirtualQuery(data_, &info, sizeof(info)) ? info.RegionSize : bytes;
+#else
+        path_ = name.empty() || name[0] != '/' ? "/" + name : name;
+        int fd;
+        if (owner_) {
+            ::shm_unlink(path_.c_str());  // A stale segment of a writer that did not exit cleanly
+            fd = ::shm_open(path_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+            if (fd < 0) fail(name, "cannot create");
+            if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+                ::close(fd);
+                ::shm_unlink(path_.c_str());
+                fail(name, "cannot size");
+            }
+            size_ = bytes;
+        } else {
+            fd = ::shm_open(path_.c_str(), O_RDONLY, 0);
+            if (fd < 0) fail(name, "no such segment");
+            struct stat st;
+            if (::fstat(fd, &st) != 0) {
+                ::close(fd);
+                fail(name, "cannot stat");
+            }
+            size_ = static_cast<size_t>(st.st_size);
+        }
+        void* data = size_ ? ::mmap(nullptr, size_, owner_ ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0)
+                           : MAP_FAILED;
+        ::close(fd);
+        if (data == MAP_FAILED) {
+            if (owner_) ::shm_unlink(path_.c_str());
+            fail(name, "cannot map");
+        }
+        data_ = static_cast<unsigned char*>(data);
+#endif
+    }
+
+    ~SharedMemoryRegion() {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+        CloseHandle(handle_);
+#else
+        ::munmap(data_, size_);
+        if (owner_) ::shm_unlink(path_.c_str());
+#endif
+    }
+
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    std::string name_;
+    bool owner_;
+    unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    HANDLE handle_ = nullptr;
+#else
+    std::string path_;
+#endif
+};
+
+SharedStateSegment::SharedStateSegment(const std::string& name, size_t num_nodes, size_t capacity,
+                                       size_t scalar_bytes, size_t storage_bytes)
+    : name_(name), region_(std::make_unique<SharedMemoryRegion>(name, kSharedStateHeaderBytes + storage_bytes)) {
+    header_ = new (region_->data()) SharedStateHeader{};
+    header_->version = kSharedStateVersion;
+    header_->scalar_bytes = static_cast<uint32_t>(scalar_bytes);
+    header_->header_bytes = kSharedStateHeaderBytes;
+    header_->node_count = num_nodes;
+    header_->capacity = capacity;
+    header_->storage_bytes = storage_bytes;
+    header_->sequence.store(0, std::memory_order_relaxed);
+    storage_ = region_->data() + kSharedStateHeaderBytes;
+    // Magic last: a reader that opens the segment early fails instead of
+    // reading a half-written header
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header_->magic, kMagic, sizeof(kMagic));
+}
+
+SharedStateSegment::~SharedStateSegment() = default;
+
+SharedStateReader::SharedStateReader(const std::string& name)
+    : name_(name), region_(std::make_unique<SharedMemoryRegion>(name, 0)) {
+    if (region_->size() < kSharedStateHeaderBytes) fail(name, "truncated");
+    header_ = reinterpret_cast<const SharedStateHeader*>(region_->data());
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (std::memcmp(header_->magic, kMagic, sizeof(kMagic)) != 0) fail(name, "not a node state segment or incomplete");
+    if (header_->version != kSharedStateVersion) fail(name, "unsupported version " + std::to_string(header_->version));
+    if (header_->scalar_bytes != sizeof(double) && header_->scalar_bytes != sizeof(float)) {
+        fail(name, "unsupported node state precision");
+    }
+    if (header_->header_bytes != kSharedStateHeaderBytes ||
+        header_->storage_bytes != header_->capacity * (kColumns * header_->scalar_bytes + sizeof(uint64_t)) ||
+        header_->capacity < header_->node_count) {
+        fail(name, "inconsistent header");
+    }
+    if (region_->size() < header_->header_bytes + header_->storage_bytes) fail(name, "truncated");
+    storage_ = region_->data() + header_->header_bytes;
+}
+
+SharedStateReader::~SharedStateReader() = default;
+
+uint64_t SharedStateReader::beginRead() const {
+    for (unsigned spins = 0;; spins++) {
+        const uint64_t seq = header_->sequence.load(std::memory_order_acquire);
+        if ((seq & 1) == 0) return seq;
+        if (spins >= 64) std::this_thread::yield();
+    }
+}
+
+uint64_t SharedStateReader::readColumn(Column c, void* out) const {
+    const size_t bytes = nodeCount() * scalarBytes();
+    for (;;) {
+        const uint64_t seq = beginRead();
+        std::memcpy(out, column(c), bytes);
+        if (validate(seq)) return seq;
+    }
+}
+
+namespace {
+
+constexpr char kMetricsRingMagic[8] = {'D', 'A', 'S', 'E', 'M', 'R', 'G', '1'};
+
+size_t ringCapacity(size_t capacity) {
+    size_t slots = 2;
+    while (slots < capacity) slots <<= 1;
+    return slots;
+}
+
+} // namespace
+
+MetricsRingWriter::MetricsRingWriter(const std::string& name, size_t capacity)
+    : name_(name),
+      region_(std::make_unique<SharedMemoryRegion>(
+          name, kSharedStateHeaderBytes + ringCapacity(capacity) * sizeof(MetricsRecord))) {
+    header_ = new (region_->data()) MetricsRingHeader{};
+    header_->version = kMetricsRingVersion;
+    header_->record_bytes = sizeof(MetricsRecord);
+    header_->header_bytes = kSharedStateHeaderBytes;
+    header_->capacity = ringCapacity(capacity);
+    header_->head.store(0, std::memory_order_relaxed);
+    records_ = reinterpret_cast<MetricsRecord*>(region_->data() + kSharedStateHeaderBytes);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(header_->magic, kMetricsRingMagic, sizeof(kMetricsRingMagic));
+}
+
+MetricsRingWriter::~MetricsRingWriter() = default;
+
+MetricsRingReader::MetricsRingReader(const std::string& name)
+    : name_(name), region_(std::make_unique<SharedMemoryRegion>(name, 0)) {
+    if (region_->size() < kSharedStateHeaderBytes) fail(name, "truncated");
+    header_ = reinterpret_cast<const MetricsRingHeader*>(region_->data());
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (std::memcmp(header_->magic, kMetricsRingMagic, sizeof(kMetricsRingMagic)) != 0) {
+        fail(name, "not a metrics ring or incomplete");
+    }
+    if (header_->version != kMetricsRingVersion) fail(name, "unsupported version " + std::to_string(header_->version));
+    if (header_->record_bytes != sizeof(MetricsRecord) || header_->header_bytes != kSharedStateHeaderBytes ||
+        header_->capacity < 2 || (header_->capacity & (header_->capacity - 1)) != 0) {
+        fail(name, "inconsistent header");
+    }
+    if (region_->size() < header_->header_bytes + header_->capacity * sizeof(MetricsRecord)) fail(name, "truncated");
+    records_ = reinterpret_cast<const MetricsRecord*>(region_->data() + header_->header_bytes);
+}
+
+MetricsRingReader::~MetricsRingReader() = default;
+
+size_t MetricsRingReader::readLatest(MetricsRecord* out, size_t max, uint64_t since) const {
+    const size_t slots = capacity();
+    for (;;) {
+        const uint64_t head = this->head();
+        // The slot of head - capacity may be in the middle of its rewrite
+        uint64_t count = head > since ? head - since : 0;
+        count = std::min<uint64_t>({count, max, slots - 1});
+        const uint64_t first = head - count;
+        const size_t start = static_cast<size_t>(first & (slots - 1));
+        const size_t wrapped = std::min<size_t>(static_cast<size_t>(count), slots - start);
+        std::memcpy(out, records_ + start, wrapped * sizeof(MetricsRecord));
+        std::memcpy(out + wrapped, records_, (static_cast<size_t>(count) - wrapped) * sizeof(MetricsRecord));
+        if (validate(first)) return static_cast<size_t>(count);
+    }
+}
@@ -0,0 +1,279 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "node_bank.h"
+
+// Node state columns in a named shared-memory segment (POSIX shm_open, or a
+// pagefile-backed file mapping on Windows), so one process can advance an
+// engine while others read its state in place.
+//
+// Layout, in host byte order:
+//
+//   [0, kSharedStateHeaderBytes)  header, zero padded to a page
+//   storage block                 BasicNodeBank::storage() byte for byte
+//
+// The header carries a sequence counter used as a seqlock: the writer makes
+// it odd before it changes the columns and even again once they are
+// consistent, so a reader that sees the same even value before and after a
+// read knows the read was not torn.
+constexpr uint64_t kSharedStateHeaderBytes = 4096;
+constexpr uint32_t kSharedStateVersion = 2;
+
+// Header of a segment; shared by writer and readers
+struct SharedStateHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t scalar_bytes;  // sizeof(Scalar) of the bank
+    uint64_t header_bytes;  // Offset of the storage block
+    uint64_t node_count;
+    uint64_t capacity;
+    uint64_t storage_bytes;
+    std::atomic<uint64_t> sequence;
+};
+static_assert(sizeof(SharedStateHeader) <= kSharedStateHeaderBytes, "shared state header must fit its page");
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "the sequence counter is shared between processes");
+
+class SharedMemoryRegion;
+
+// Writer end, owned by the engine. Creating a segment replaces a stale one
+// of the same name; the name is removed again when the writer goes away
+// (POSIX), while readers that have it mapped keep their view.
+class SharedStateSegment {
+public:
+    // Segment for a bank of num_nodes nodes, capacity() columns of
+    // scalar_bytes values and storageBytes() bytes. Throws
+    // std::runtime_error if it cannot be created.
+    SharedStateSegment(const std::string& name, size_t num_nodes, size_t capacity, size_t scalar_bytes,
+                       size_t storage_bytes);
+    ~SharedStateSegment();
+
+    SharedStateSegment(const SharedStateSegment&) = delete;
+    SharedStateSegment& operator=(const SharedStateSegment&) = delete;
+
+    const std::string& name() const { return name_; }
+    unsigned char* storage() const { return storage_; }
+    uint64_t sequence() const { return header_->sequence.load(std::memory_order_relaxed); }
+
+    // Write section around a change of the columns. Sections nest; only the
+    // outermost one moves the sequence, so readers never see a half-done
+    // step as stable. Single writer thread, like the engine itself.
+    void beginWrite() {
+        if (depth_++ == 0) {
+            header_->sequence.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+    }
+    void endWrite() {
+        if (--depth_ == 0) header_->sequence.fetch_add(1, std::memory_order_release);
+    }
+
+private:
+    std::string name_;
+    std::unique_ptr<SharedMemoryRegion> region_;
+    SharedStateHeader* header_ = nullptr;
+    unsigned char* storage_ = nullptr;
+    int depth_ = 0;
+};
+
+// Reader end: maps a segment read-only. Columns are read in place; pair
+// every read with beginRead()/validate(), or use readColumn() for a checked
+// copy.
+class SharedStateReader {
+public:
+    // Throws std::runtime_error if there is no such segment or it is not a
+    // complete node state segment
+    explicit SharedStateReader(const std::string& name);
+    ~SharedStateReader();
+
+    SharedStateReader(const SharedStateReader&) = delete;
+    SharedStateReader& operator=(const SharedStateReader&) = delete;
+
+    const std::string& name() const { return name_; }
+    size_t nodeCount() const { return static_cast<size_t>(header_->node_count); }
+    size_t capacity() const { return static_cast<size_t>(header_->capacity); }
+    size_t scalarBytes() const { return header_->scalar_bytes; }
+
+    // State and parameter columns in the order of BasicNodeBank::storage()
+    enum Column {
+        IntegratorState = 0,
+        FeedbackGain = 1,
+        CurrentOutput = 2,
+        PreviousInput = 3,
+        InputGain = 4,
+        TimeConstant = 5,
+        ClampLow = 6,
+        ClampHigh = 7,
+        SpectralMix = 8
+    };
+    static constexpr size_t kColumns = 9;
+    const void* column(Column c) const {
+        return storage_ + capacity() * sizeof(uint64_t) + static_cast<size_t>(c) * capacity() * scalarBytes();
+    }
+
+    uint64_t sequence() const { return header_->sequence.load(std::memory_order_acquire); }
+    // Waits out a write in progress and returns the stable sequence
+    uint64_t beginRead() const;
+    // True if no write started since beginRead() returned seq
+    bool validate(uint64_t seq) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return header_->sequence.load(std::memory_order_relaxed) == seq;
+    }
+    // Consistent copy of nodeCount() values of a column into out (scalarBytes()
+    // each), retried until no write overlapped it; returns its sequence
+    uint64_t readColumn(Column c, void* out) const;
+
+private:
+    std::string name_;
+    std::unique_ptr<SharedMemoryRegion> region_;
+    const SharedStateHeader* header_ = nullptr;
+    const unsigned char* storage_ = nullptr;
+};
+
+// Fixed-layout metrics records in a named shared-memory segment: one native
+// writer (the pipeline host or an embedding application) appends a record
+// per block, and any number of readers batch-read the newest ones in place,
+// as a NumPy structured array in Python (dase_engine.MetricsRing), without
+// per-field calls.
+//
+// Layout, in host byte order:
+//
+//   [0, kSharedStateHeaderBytes)  MetricsRingHeader, zero padded to a page
+//   records                       capacity MetricsRecord slots
+//
+// Record i lives in slot i % capacity. The writer fills a slot and only then
+// advances the header's head (records written so far) with a release store,
+// so every record below head is complete. A record may be overwritten once
+// the writer has lapped it: the writer at head is filling the slot of record
+// head - capacity, so a copy of records [first, head) is intact if, read
+// after the copy, head is still below first + capacity.
+constexpr uint32_t kMetricsRingVersion = 2;   // 2: trace_id and origin_ns
+
+// Values of MetricsRecord::state, in the order of server/metrics_frame.py
+enum MetricsState : uint32_t {
+    MetricsStateAwake = 0,
+    MetricsStateDreaming = 1,
+    MetricsStateDeepSleep = 2,
+    MetricsStateRem = 3,
+    MetricsStateTransition = 4,
+    MetricsStateCritical = 5,
+    MetricsStateIdle = 6,
+};
+
+// Bits of MetricsRecord::flags
+constexpr uint32_t kMetricsRecordValid = 1u << 0;       // No metric was NaN or infinite
+constexpr uint32_t kMetricsRecordPhiSensor = 1u << 1;   // Φ from the sensor, not the host
+
+// One frame of MetricsFrame (server/metrics_frame.py); every field is 8 or
+// 4+4 bytes so the layout has no padding on any ABI
+struct MetricsRecord {
+    uint64_t frame_id;
+    double timestamp;             // Unix time (s)
+    double ici;
+    double phase_coherence;
+    double spectral_centroid;     // Hz
+    double criticality;
+    double consciousness_level;
+    double phi_phase;             // Radians
+    double phi_depth;
+    double latency_ms;
+    double cpu_load;              // [0, 1]
+    uint32_t state;               // MetricsState
+    uint32_t flags;               // kMetricsRecord* bits
+    uint64_t trace_id;            // Block trace (pipeline_trace.h), 0 when untraced
+    int64_t origin_ns;            // Its origin on the trace clock (CLOCK_REALTIME ns)
+};
+static_assert(sizeof(MetricsRecord) == 112, "MetricsRecord is a fixed shared layout");
+
+// MetricsFrame.classify_state on native values
+inline MetricsState classifyMetricsState(double consciousness, double coherence, double criticality) {
+    if (criticality > 0.9) return MetricsStateCritical;
+    if (consciousness < 0.1) return MetricsStateIdle;
+    if (consciousness > 0.6) return MetricsStateAwake;
+    if (consciousness < 0.3 && coherence > 0.7) return MetricsStateDeepSleep;
+    if (consciousness >= 0.3 && consciousness < 0.5 && coherence < 0.5) return MetricsStateDreaming;
+    if (consciousness >= 0.4 && consciousness < 0.6 && criticality > 0.7) return MetricsStateRem;
+    return MetricsStateTransition;
+}
+
+// Header of a metrics ring segment; shared by writer and readers
+struct MetricsRingHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t record_bytes;   // sizeof(MetricsRecord)
+    uint64_t header_bytes;   // Offset of the first slot
+    uint64_t capacity;       // Slots, a power of two
+    alignas(64) std::atomic<uint64_t> head;  // Records written so far
+};
+static_assert(sizeof(MetricsRingHeader) <= kSharedStateHeaderBytes, "metrics ring header must fit its page");
+
+// Writer end. Like SharedStateSegment, creating a ring replaces a stale one
+// of the same name and the name goes away with the writer. push() is wait
+// free and does no system call, so it can run on the audio thread.
+class MetricsRingWriter {
+public:
+    // Ring of capacity records, rounded up to a power of two. Throws
+    // std::runtime_error if the segment cannot be created.
+    MetricsRingWriter(const std::string& name, size_t capacity);
+    ~MetricsRingWriter();
+
+    MetricsRingWriter(const MetricsRingWriter&) = delete;
+    MetricsRingWriter& operator=(const MetricsRingWriter&) = delete;
+
+    const std::string& name() const { return name_; }
+    size_t capacity() const { return static_cast<size_t>(header_->capacity); }
+    uint64_t head() const { return header_->head.load(std::memory_order_relaxed); }
+
+    // Appends a record; frame_id is set to its index in the ring
+    void push(const MetricsRecord& record) {
+        const uint64_t head = header_->head.load(std::memory_order_relaxed);
+        MetricsRecord& slot = records_[head & (header_->capacity - 1)];
+        slot = record;
+        slot.frame_id = head;
+        header_->head.store(head + 1, std::memory_order_release);
+    }
+
+private:
+    std::string name_;
+    std::unique_ptr<SharedMemoryRegion> region_;
+    MetricsRingHeader* header_ = nullptr;
+    MetricsRecord* records_ = nullptr;
+};
+
+// Reader end: maps a ring read-only. records() aliases every slot; use
+// readLatest() for a checked copy of the newest ones.
+class MetricsRingReader {
+public:
+    // Throws std::runtime_error if there is no such segment or it is not a
+    // complete metrics ring
+    explicit MetricsRingReader(const std::string& name);
+    ~MetricsRingReader();
+
+    MetricsRingReader(const MetricsRingReader&) = delete;
+    MetricsRingReader& operator=(const MetricsRingReader&) = delete;
+
+    const std::string& name() const { return name_; }
+    size_t capacity() const { return static_cast<size_t>(header_->capacity); }
+    uint64_t head() const { return header_->head.load(std::memory_order_acquire); }
+    const MetricsRecord* records() const { return records_; }
+
+    // True if record index has not been overwritten since it was read
+    bool validate(uint64_t index) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return header_->head.load(std::memory_order_relaxed) < index + capacity();
+    }
+
+    // Copies the newest records, oldest first, up to max and none older than
+    // since, into out; returns how many. Retried while the writer laps the
+    // copy, so every record returned is intact.
+    size_t readLatest(MetricsRecord* out, size_t max, uint64_t since = 0) const;
+
+private:
+    std::string name_;
+    std::unique_ptr<SharedMemoryRegion> region_;
+    const MetricsRingHeader* header_ = nullptr;
+    const MetricsRecord* records_ = nullptr;
+};
@@ -0,0 +1,97 @@
+#include "sparse_coupling.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+void SparseCoupling::setMatrix(size_t rows, std::vector<uint64_t> row_ptr, std::vector<uint32_t> col_index,
+                               std::vector<double> weights) {
+    if (row_ptr.size() != rows + 1) {
+        throw std::invalid_argument("row_ptr must have rows + 1 entries");
+    }
+    if (weights.size() != col_index.size()) {
+        throw std::invalid_argument("col_index and weights must have the same length");
+    }
+    if (row_ptr.front() != 0 || row_ptr.back() != col_index.size()) {
+        throw std::invalid_argument("row_ptr must start at 0 and end at the edge count");
+    }
+    for (size_t i = 0; i < rows; i++) {
+        if (row_ptr[i + 1] < row_ptr[i]) {
+            throw std::invalid_argument("row_ptr must be non-decreasing");
+        }
+    }
+    for (uint32_t col : col_index) {
+        if (col >= rows) {
+            throw std::invalid_argument("coupling column index out of range");
+        }
+    }
+
+    row_ptr_ = std::move(row_ptr);
+    col_index_ = std::move(col_index);
+    weights_ = std::move(weights);
+    bounds_.clear();
+}
+
+void SparseCoupling::clear() {
+    row_ptr_.clear();
+    col_index_.clear();
+    weights_.clear();
+    bounds_.clear();
+    scratch_.clear();
+}
+
+double SparseCoupling::rowSum(const double* values, size_t row) const {
+    const uint64_t end = row_ptr_[row + 1];
+    double sum = 0.0;
+    for (uint64_t k = row_ptr_[row]; k < end; k++) {
+        sum += weights_[k] * values[col_index_[k]];
+    }
+    return sum;
+}
+
+// Cost of rows [0, r) is taken as edges + rows, so empty rows still count for
+// their loop overhead and the output write.
+void SparseCoupling::partition(size_t parts) {
+    const size_t n = rows();
+    parts = std::max<size_t>(1, std::min(parts, n));
+    const uint64_t total = row_ptr_[n] + n;
+
+    bounds_.resize(parts + 1);
+    bounds_[0] = 0;
+    for (size_t p = 1; p < parts; p++) {
+        const uint64_t target = total * p / parts;
+        // First row whose prefix cost reaches the target
+        size_t lo = bounds_[p - 1], hi = n;
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (row_ptr_[mid] + mid < target) lo = mid + 1; else hi = mid;
+        }
+        bounds_[p] = lo;
+    }
+    bounds_[parts] = n;
+}
+
+void SparseCoupling::sweep(WorkerPool& pool, const double* in, double* out, bool add_input) {
+    const size_t parts = std::min<size_t>(rows(), static_cast<size_t>(pool.size()) * kChunksPerWorker);
+    if (bounds_.size() != std::max<size_t>(1, parts) + 1) {
+        partition(parts);
+    }
+
+    pool.parallelFor(bounds_.size() - 1, 1, [&](size_t part_begin, size_t part_end, unsigned) {
+        for (size_t row = bounds_[part_begin]; row < bounds_[part_end]; row++) {
+            out[row] = add_input ? in[row] + rowSum(in, row) : rowSum(in, row);
+        }
+    });
+}
+
+void SparseCoupling::multiply(WorkerPool& pool, const double* in, double* out) {
+    if (empty()) return;
+    sweep(pool, in, out, false);
+}
+
+void SparseCoupling::apply(WorkerPool& pool, double* output) {
+    if (empty() || edges() == 0) return;
+
+    scratch_.resize(rows());
+    sweep(pool, output, scratch_.data(), true);
+    std::memcpy(output, scratch_.data(), rows() * sizeof(double));
+}
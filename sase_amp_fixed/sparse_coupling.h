@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "worker_pool.h"
+
+// Node-to-node coupling matrix in compressed sparse row form.
+//
+// Row i lists the nodes that drive node i: col_index[row_ptr[i] .. row_ptr[i+1])
+// with the matching weights. Any topology (small-world, hand-wired, a stencil
+// exported from NumPy/SciPy) fits, and memory and work grow with the edge
+// count rather than N^2. The step reads every output from the previous state
+// and writes a scratch column, so it is order-independent like GridCoupling:
+//   out'[i] = out[i] + sum_k weights[k] * out[col_index[k]]
+// Rows are split across the pool into chunks of roughly equal edge count, so
+// a few hub nodes do not leave one worker with most of the edges.
+class SparseCoupling {
+public:
+    // Chunks handed out per pool thread; several per thread lets the shared
+    // cursor even out rows whose cost the edge count does not predict.
+    static constexpr unsigned kChunksPerWorker = 4;
+
+    // Takes ownership of the arrays. row_ptr has rows + 1 non-decreasing
+    // entries starting at 0 and ending at col_index.size(); every column is
+    // below rows. Throws std::invalid_argument otherwise.
+    void setMatrix(size_t rows, std::vector<uint64_t> row_ptr, std::vector<uint32_t> col_index,
+                   std::vector<double> weights);
+    void clear();
+
+    bool empty() const { return row_ptr_.empty(); }
+    size_t rows() const { return row_ptr_.empty() ? 0 : row_ptr_.size() - 1; }
+    size_t edges() const { return col_index_.size(); }
+
+    // Weighted sum of row's inputs
+    double rowSum(const double* values, size_t row) const;
+
+    // out = A * in over all rows; in and out must not overlap
+    void multiply(WorkerPool& pool, const double* in, double* out);
+
+    // output += A * output, reading only the previous state
+    void apply(WorkerPool& pool, double* output);
+
+private:
+    void partition(size_t parts);
+    // out[row] = (add_input ? in[row] : 0) + rowSum(in, row) for every row
+    void sweep(WorkerPool& pool, const double* in, double* out, bool add_input);
+
+    std::vector<uint64_t> row_ptr_;
+    std::vector<uint32_t> col_index_;
+    std::vector<double> weights_;
+    std::vector<size_t> bounds_;  // First row of each chunk, plus rows()
+    std::vector<double> scratch_;
+};
@@ -0,0 +1,119 @@
+#include "spectral_stream.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+StreamingSpectralProcessor::StreamingSpectralProcessor(const SpectralStreamConfig& config)
+    : config_(config) {
+    const int N = config_.fft_size;
+    const int H = config_.hop_size;
+    if (N < 2) {
+        throw std::invalid_argument("fft_size must be at least 2");
+    }
+    if (H < 1 || H > N) {
+        throw std::invalid_argument("hop_size must be in [1, fft_size]");
+    }
+
+    plan_ = &plans_.acquire(N);
+
+    window_.assign(N, 1.0);
+    if (config_.mode == SpectralStreamMode::WeightedOverlapAdd) {
+        for (int i = 0; i < N; i++) {
+            const double hann = 0.5 - 0.5 * std::cos(2.0 * M_PI * i / N);
+            if (config_.window == SpectralWindow::Hann) window_[i] = hann;
+            else if (config_.window == SpectralWindow::SqrtHann) window_[i] = std::sqrt(hann);
+        }
+
+        // Output position p of a hop collects frames at offsets p, p + H, ...
+        norm_.assign(H, 0.0);
+        for (int p = 0; p < H; p++) {
+            for (int i = p; i < N; i += H) norm_[p] += window_[i] * window_[i];
+            if (norm_[p] < 1e-12) {
+                throw std::invalid_argument("window and hop_size leave output samples uncovered");
+            }
+        }
+    }
+
+    mask_.assign(binCount(), 1.0f);
+    input_.assign(N, 0.0);
+    overlap_.assign(N, 0.0);
+    ready_.assign(H, 0.0f);
+}
+
+int StreamingSpectralProcessor::latency() const {
+    return config_.mode == SpectralStreamMode::OverlapSave ? config_.hop_size : config_.fft_size;
+}
+
+void StreamingSpectralProcessor::setGainMask(const std::vector<float>& gains) {
+    if (static_cast<int>(gains.size()) != binCount()) {
+        throw std::invalid_argument("gain mask must have fft_size / 2 + 1 entries");
+    }
+    mask_ = gains;
+}
+
+void StreamingSpectralProcessor::setBandGain(int first_bin, int last_bin, float gain) {
+    first_bin = std::max(first_bin, 0);
+    last_bin = std::min(last_bin, binCount() - 1);
+    for (int k = first_bin; k <= last_bin; k++) mask_[k] = gain;
+}
+
+void StreamingSpectralProcessor::reset() {
+    std::fill(input_.begin(), input_.end(), 0.0);
+    std::fill(overlap_.begin(), overlap_.end(), 0.0);
+    std::fill(ready_.begin(), ready_.end(), 0.0f);
+    fill_ = 0;
+}
+
+void StreamingSpectralProcessor::process(const float* in, float* out, size_t n) {
+    const size_t N = static_cast<size_t>(config_.fft_size);
+    const size_t H = static_cast<size_t>(config_.hop_size);
+    size_t done = 0;
+    while (done < n) {
+        const size_t chunk = std::min(H - fill_, n - done);
+        double* slot = input_.data() + (N - H) + fill_;
+        for (size_t j = 0; j < chunk; j++) slot[j] = static_cast<double>(in[done + j]);
+        std::copy(ready_.begin() + fill_, ready_.begin() + fill_ + chunk, out + done);
+        fill_ += chunk;
+        done += chunk;
+        if (fill_ == H) {
+            processFrame();
+            fill_ = 0;
+        }
+    }
+}
+
+void StreamingSpectralProcessor::processFrame() {
+    const int N = config_.fft_size;
+    const int H = config_.hop_size;
+    double* frame = plan_->real;
+    FFTComplex* spectrum = plan_->spectrum;
+
+    for (int i = 0; i < N; i++) frame[i] = input_[i] * window_[i];
+    plan_->forward();
+    for (int k = 0; k < binCount(); k++) {
+        spectrum[k][0] *= mask_[k];
+        spectrum[k][1] *= mask_[k];
+    }
+    plan_->inverse();
+
+    const double scale = 1.0 / N;
+    if (config_.mode == SpectralStreamMode::OverlapSave) {
+        // Only the tail is free of circular wrap-around
+        for (int p = 0; p < H; p++) {
+            ready_[p] = static_cast<float>(frame[N - H + p] * scale);
+        }
+    } else {
+        for (int i = 0; i < N; i++) overlap_[i] += frame[i] * scale * window_[i];
+        for (int p = 0; p < H; p++) {
+            ready_[p] = static_cast<float>(overlap_[p] / norm_[p]);
+        }
+        std::copy(overlap_.begin() + H, overlap_.end(), overlap_.begin());
+        std::fill(overlap_.end() - H, overlap_.end(), 0.0);
+    }
+
+    std::copy(input_.begin() + H, input_.end(), input_.begin());
+}
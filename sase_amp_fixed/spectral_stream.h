@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "fft_plan_cache.h"
+
+// Analysis/synthesis window for the streaming spectral stage
+enum class SpectralWindow {
+    Rectangular = 0,
+    Hann = 1,      // Periodic Hann
+    SqrtHann = 2   // Square root of periodic Hann (power-complementary at 50% overlap)
+};
+
+// Frame combination scheme
+enum class SpectralStreamMode {
+    WeightedOverlapAdd = 0,  // Window, mask, window again, overlap-add; latency fft_size
+    OverlapSave = 1          // Unwindowed frames, keep the last hop samples; latency hop_size
+};
+
+struct SpectralStreamConfig {
+    int fft_size = 512;
+    int hop_size = 128;
+    SpectralWindow window = SpectralWindow::Hann;
+    SpectralStreamMode mode = SpectralStreamMode::WeightedOverlapAdd;
+};
+
+// Stateful streaming FFT filter.
+//
+// Accepts chunks of any length and emits exactly as many samples as it is
+// given, delayed by a constant latency(), so it can sit directly in an audio
+// callback. One frame is transformed every hop_size input samples and a
+// per-bin gain mask (fft_size / 2 + 1 real gains) is applied to its spectrum.
+// Weighted overlap-add normalizes by the overlapping window energy, so a unity
+// mask reconstructs the input exactly for any hop. Overlap-save is exact
+// linear filtering when the mask's impulse response fits in
+// fft_size - hop_size + 1 taps.
+class StreamingSpectralProcessor {
+public:
+    explicit StreamingSpectralProcessor(const SpectralStreamConfig& config = SpectralStreamConfig());
+
+    StreamingSpectralProcessor(const StreamingSpectralProcessor&) = delete;
+    StreamingSpectralProcessor& operator=(const StreamingSpectralProcessor&) = delete;
+
+    // Filters n samples; in and out may alias.
+    void process(const float* in, float* out, size_t n);
+
+    // Replaces the gain mask; gains.size() must equal binCount().
+    void setGainMask(const std::vector<float>& gains);
+    // Sets bins [first_bin, last_bin] to gain, clamped to the valid range.
+    void setBandGain(int first_bin, int last_bin, float gain);
+    const std::vector<float>& getGainMask() const { return mask_; }
+
+    // Clears the stream history; configuration and mask are kept.
+    void reset();
+
+    int binCount() const { return config_.fft_size / 2 + 1; }
+    int latency() const;
+    const SpectralStreamConfig& config() const { return config_; }
+
+private:
+    void processFrame();
+
+    SpectralStreamConfig config_;
+    FFTPlanCache plans_;
+    FFTPlanCache::Plan* plan_ = nullptr;
+
+    std::vector<double> window_;
+    std::vector<double> norm_;       // WOLA normalization per hop position
+    std::vector<float> mask_;
+    std::vector<double> input_;      // Last fft_size input samples
+    std::vector<double> overlap_;    // Overlap-add accumulator (fft_size)
+    std::vector<float> ready_;       // Output samples for the current hop
+    size_t fill_ = 0;                // Samples received in the current hop
+};
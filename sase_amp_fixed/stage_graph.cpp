@@ -0,0 +1,329 @@
+#include "stage_graph.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+#include "fft_plan_cache.h"
+#include "filter_bank.h"
+#include "ici_kernel.h"
+#include "node_kernels.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define DASE_CPU_RELAX() _mm_pause()
+#else
+#define DASE_CPU_RELAX() std::this_thread::yield()
+#endif
+
+namespace {
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Yields after this many empty yields past the spin phase, then sleeps
+constexpr uint32_t kIdleYields = 64;
+constexpr auto kIdleSleep = std::chrono::microseconds(50);
+
+// Channel-major rows of n samples as rows of size, zero padded, in padded
+const float* padRows(const std::vector<float>& rows, size_t channels, size_t n, size_t size,
+                     std::vector<float>& padded) {
+    if (n == size) return rows.data();
+    for (size_t c = 0; c < channels; c++) {
+        std::copy(rows.begin() + c * n, rows.begin() + (c + 1) * n, padded.begin() + c * size);
+        std::fill(padded.begin() + c * size + n, padded.begin() + (c + 1) * size, 0.0f);
+    }
+    return padded.data();
+}
+
+} // namespace
+
+void StageGraph::IndexRing::push(uint32_t index) {
+    const size_t tail = tail_.load(std::memory_order_relaxed);
+    items_[tail] = index;
+    tail_.store(tail + 1 == items_.size() ? 0 : tail + 1, std::memory_order_release);
+}
+
+bool StageGraph::IndexRing::pop(uint32_t& index) {
+    const size_t head = head_.load(std::memory_order_relaxed);
+    if (head == tail_.load(std::memory_order_acquire)) return false;
+    index = items_[head];
+    head_.store(head + 1 == items_.size() ? 0 : head + 1, std::memory_order_release);
+    return true;
+}
+
+size_t StageGraph::IndexRing::size() const {
+    const size_t head = head_.load(std::memory_order_acquire);
+    const size_t tail = tail_.load(std::memory_order_acquire);
+    return tail >= head ? tail - head : tail + items_.size() - head;
+}
+
+StageGraph::StageGraph(std::vector<GraphStage> stages, const StageGraphConfig& config)
+    : stages_(std::move(stages)), config_(config) {
+    if (stages_.empty()) throw std::invalid_argument("stage graph needs at least one stage");
+    for (const GraphStage& stage : stages_) {
+        if (!stage.process) throw std::invalid_argument("stage '" + stage.name + "' has no function");
+    }
+    if (config.block_size == 0) throw std::invalid_argument("block_size must be positive");
+    if (config.num_channels == 0) throw std::invalid_argument("num_channels must be positive");
+    if (config.slots < 2) throw std::invalid_argument("stage graph needs at least 2 slots");
+
+    max_in_flight_ = config.slots;
+    budget_ns_ = 0;
+    if (config.latency_budget_ms > 0.0) {
+        budget_ns_ = static_cast<uint64_t>(config.latency_budget_ms * 1e6);
+        const double period_ms = 1e3 * static_cast<double>(config.block_size) / config.sample_rate;
+        const size_t covered = static_cast<size_t>(std::floor(config.latency_budget_ms / period_ms));
+        max_in_flight_ = std::max<size_t>(1, std::min(config.slots, covered));
+    }
+
+    slots_.resize(config.slots);
+    for (GraphBlock& block : slots_) {
+        block.input.reserve(config.block_size);
+        block.channels.reserve(config.num_channels * config.block_size);
+    }
+    for (size_t r = 0; r < stages_.size() + 2; r++) rings_.push_back(std::make_unique<IndexRing>(config.slots));
+    for (size_t s = 0; s < config.slots; s++) rings_.back()->push(static_cast<uint32_t>(s));
+    counters_.reset(new StageCounters[stages_.size()]);
+
+    try {
+        for (size_t k = 0; k < stages_.size(); k++) threads_.emplace_back([this, k] { runStage(k); });
+    } catch (...) {
+        stop_.store(true);
+        for (std::thread& thread : threads_) thread.join();
+        throw;
+    }
+}
+
+StageGraph::~StageGraph() {
+    stop_.store(true, std::memory_order_release);
+    for (std::thread& thread : threads_) thread.join();
+}
+
+bool StageGraph::submit(const float* in, size_t n) {
+    if (n == 0 || n > config_.block_size) {
+        throw std::invalid_argument("input block of " + std::to_string(n) + " samples, expected 1 to " +
+                                    std::to_string(config_.block_size));
+    }
+    uint32_t index = 0;
+    if (failed() || inFlight() >= max_in_flight_ || !rings_.back()->pop(index)) {
+        rejected_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    GraphBlock& block = slots_[index];
+    block.sequence = next_sequence_++;
+    block.n = n;
+    block.input.assign(in, in + n);
+    block.ici = 0.0;
+    block.input_rms = 0.0;
+    block.output_rms = 0.0;
+    block.latency_ns = 0;
+    block.submit_ns = nowNs();
+    submitted_.fetch_add(1, std::memory_order_release);
+    rings_[0]->push(index);
+    return true;
+}
+
+const GraphBlock* StageGraph::collect() {
+    if (collected_ < 0) {
+        uint32_t index = 0;
+        if (!rings_[stages_.size()]->pop(index)) return nullptr;
+        collected_ = index;
+    }
+    return &slots_[static_cast<size_t>(collected_)];
+}
+
+void StageGraph::release() {
+    if (collected_ < 0) return;
+    rings_.back()->push(static_cast<uint32_t>(collected_));
+    collected_ = -1;
+    released_.fetch_add(1, std::memory_order_release);
+}
+
+size_t StageGraph::inFlight() const {
+    return static_cast<size_t>(submitted_.load(std::memory_order_acquire) -
+                               released_.load(std::memory_order_acquire));
+}
+
+std::string StageGraph::error() const { return failed() ? error_ : std::string(); }
+
+void StageGraph::runStage(size_t k) {
+    ScopedThreadAffinity pin(stages_[k].cpu);
+    IndexRing& in = *rings_[k];
+    IndexRing& out = *rings_[k + 1];
+    StageCounters& counters = counters_[k];
+    const bool last = k + 1 == stages_.size();
+    uint64_t idle_since = nowNs();
+    uint32_t polls = 0;
+    while (!stop_.load(std::memory_order_acquire)) {
+        const size_t queued = in.size();
+        uint32_t index = 0;
+        if (!in.pop(index)) {
+            if (++polls <= config_.spin_iterations) {
+                DASE_CPU_RELAX();
+            } else if (polls <= config_.spin_iterations + kIdleYields) {
+                std::this_thread::yield();
+            } else {
+                std::this_thread::sleep_for(kIdleSleep);
+            }
+            continue;
+        }
+        polls = 0;
+        GraphBlock& block = slots_[index];
+        const uint64_t start = nowNs();
+        if (!failed()) {
+            try {
+                stages_[k].process(block);
+            } catch (const std::exception& e) {
+                bool expected = false;
+                if (error_claimed_.compare_exchange_strong(expected, true)) {
+                    error_ = stages_[k].name + ": " + e.what();
+                    failed_.store(true, std::memory_order_release);
+                }
+            }
+        }
+        const uint64_t end = nowNs();
+        counters.idle_ns.fetch_add(start - idle_since, std::memory_order_relaxed);
+        counters.busy_ns.fetch_add(end - start, std::memory_order_relaxed);
+        counters.queued.fetch_add(queued, std::memory_order_relaxed);
+        counters.blocks.fetch_add(1, std::memory_order_relaxed);
+        idle_since = end;
+        if (last) {
+            block.latency_ns = end - block.submit_ns;
+            latency_.record(block.latency_ns);
+            if (budget_ns_ && block.latency_ns > budget_ns_) late_.fetch_add(1, std::memory_order_relaxed);
+            completed_.fetch_add(1, std::memory_order_relaxed);
+        }
+        out.push(index);
+    }
+}
+
+StageGraphStats StageGraph::stats() const {
+    StageGraphStats stats;
+    stats.submitted = submitted_.load(std::memory_order_relaxed);
+    stats.completed = completed_.load(std::memory_order_relaxed);
+    stats.rejected = rejected_.load(std::memory_order_relaxed);
+    stats.late = late_.load(std::memory_order_relaxed);
+    stats.max_in_flight = max_in_flight_;
+    stats.latency = latency_.snapshot();
+    double slowest = -1.0;
+    for (size_t k = 0; k < stages_.size(); k++) {
+        const StageCounters& counters = counters_[k];
+        StageOccupancy stage;
+        stage.name = stages_[k].name;
+        stage.blocks = counters.blocks.load(std::memory_order_relaxed);
+        stage.busy_ns = counters.busy_ns.load(std::memory_order_relaxed);
+        stage.idle_ns = counters.idle_ns.load(std::memory_order_relaxed);
+        const uint64_t total = stage.busy_ns + stage.idle_ns;
+        stage.occupancy = total ? static_cast<double>(stage.busy_ns) / static_cast<double>(total) : 0.0;
+        if (stage.blocks) {
+            stage.mean_ns = static_cast<double>(stage.busy_ns) / static_cast<double>(stage.blocks);
+            stage.mean_queue = static_cast<double>(counters.queued.load(std::memory_order_relaxed)) /
+                               static_cast<double>(stage.blocks);
+        }
+        if (stage.mean_ns > slowest) {
+            slowest = stage.mean_ns;
+            stats.bottleneck = k;
+        }
+        stats.stages.push_back(std::move(stage));
+    }
+    return stats;
+}
+
+void StageGraph::resetStats() {
+    for (size_t k = 0; k < stages_.size(); k++) {
+        counters_[k].blocks.store(0, std::memory_order_relaxed);
+        counters_[k].busy_ns.store(0, std::memory_order_relaxed);
+        counters_[k].idle_ns.store(0, std::memory_order_relaxed);
+        counters_[k].queued.store(0, std::memory_order_relaxed);
+    }
+    rejected_.store(0, std::memory_order_relaxed);
+    late_.store(0, std::memory_order_relaxed);
+    latency_.reset();
+}
+
+GraphStage makeInputFilterStage(double hz, double sample_rate, double q) {
+    struct State {
+        FilterNodeBank bank{1, 1};
+        const NodeKernels* kernels = &nodeKernels(defaultSimdLevel());
+        std::vector<float> rows;  // One node-major row per lane of the kernel's first chunk
+    };
+    auto state = std::make_shared<State>();
+    state->bank.setBiquad(0, 0, designBiquad(FilterShape::HighPass, hz, q, sample_rate));
+    GraphStage stage;
+    stage.name = "input_filter";
+    stage.process = [state](GraphBlock& block) {
+        state->rows.resize(8 * block.n);
+        state->kernels->biquad_block(state->bank, 0, 8, block.input.data(), 0, state->rows.data(), block.n);
+        std::copy(state->rows.begin(), state->rows.begin() + block.n, block.input.begin());
+    };
+    return stage;
+}
+
+GraphStage makeChromaticEngineStage(AnalogCellularEngineAVX2& engine, const ChromaticBlockConfig& config) {
+    GraphStage stage;
+    stage.name = "engine";
+    stage.process = [&engine, config](GraphBlock& block) {
+        block.channels.resize(config.num_channels * block.n);
+        engine.processChromaticBlock(block.input.data(), block.n, config, block.channels.data());
+    };
+    return stage;
+}
+
+GraphStage makeSpectrumStage(size_t num_channels, size_t block_size) {
+    struct State {
+        FFTPlanCache plans;
+        std::vector<float> padded;
+    };
+    auto state = std::make_shared<State>();
+    state->padded.resize(num_channels * block_size);
+    state->plans.acquire(static_cast<int>(block_size));
+    GraphStage stage;
+    stage.name = "spectrum";
+    stage.process = [state, num_channels, block_size](GraphBlock& block) {
+        const size_t bins = block_size / 2 + 1;
+        const float* rows = padRows(block.channels, num_channels, block.n, block_size, state->padded);
+        FFTPlanCache::Plan& plan = state->plans.acquire(static_cast<int>(block_size));
+        block.spectrum.resize(num_channels * bins);
+        for (size_t c = 0; c < num_channels; c++) {
+            std::copy(rows + c * block_size, rows + (c + 1) * block_size, plan.real);
+            plan.forward();
+            for (size_t b = 0; b < bins; b++) {
+                block.spectrum[c * bins + b] =
+                    static_cast<float>(std::hypot(plan.spectrum[b][0], plan.spectrum[b][1]));
+            }
+        }
+    };
+    return stage;
+}
+
+GraphStage makeIciStage(size_t num_channels, size_t block_size) {
+    struct State {
+        State(size_t channels, size_t size) : kernel(channels, size), padded(channels * size) {}
+        ICIKernel kernel;
+        std::vector<float> padded;
+    };
+    auto state = std::make_shared<State>(num_channels, block_size);
+    GraphStage stage;
+    stage.name = "ici";
+    stage.process = [state, num_channels, block_size](GraphBlock& block) {
+        block.ici = state->kernel.process(padRows(block.channels, num_channels, block.n, block_size, state->padded));
+    };
+    return stage;
+}
+
+GraphStage makeMetricsStage(size_t num_channels, std::function<void(const GraphBlock&)> sink) {
+    GraphStage stage;
+    stage.name = "metrics";
+    stage.process = [num_channels, sink](GraphBlock& block) {
+        double in = 0.0, out = 0.0;
+        for (size_t t = 0; t < block.n; t++) in += static_cast<double>(block.input[t]) * block.input[t];
+        const size_t count = std::min(block.channels.size(), num_channels * block.n);
+        for (size_t k = 0; k < count; k++) out += static_cast<double>(block.channels[k]) * block.channels[k];
+        block.input_rms = block.n ? std::sqrt(in / static_cast<double>(block.n)) : 0.0;
+        block.output_rms = count ? std::sqrt(out / static_cast<double>(count)) : 0.0;
+        if (sink) sink(block);
+    };
+    return stage;
+}
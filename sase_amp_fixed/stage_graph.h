@@ -0,0 +1,178 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "analog_universal_node_engine_avx2.h"
+#include "latency_histogram.h"
+#include "worker_pool.h"
+
+// One block travelling down a StageGraph. Blocks live in a fixed set of
+// slots allocated with the graph; stages resize the vectors they fill on a
+// slot's first pass and reuse them afterwards.
+struct GraphBlock {
+    uint64_t sequence = 0;
+    size_t n = 0;                 // Samples in the block
+    std::vector<float> input;     // n samples; filter stages work in place
+    std::vector<float> channels;  // Channel-major [num_channels x n] engine outputs
+    std::vector<float> spectrum;  // Channel-major [num_channels x bins] magnitudes
+    double ici = 0.0;
+    double input_rms = 0.0;
+    double output_rms = 0.0;
+    uint64_t submit_ns = 0;       // steady_clock at submit()
+    uint64_t latency_ns = 0;      // submit() to the last stage's end
+};
+
+// A stage of the graph, run on its own thread; cpu >= 0 pins that thread
+struct GraphStage {
+    std::string name;
+    std::function<void(GraphBlock&)> process;
+    int cpu = -1;
+};
+
+struct StageGraphConfig {
+    size_t block_size = 512;
+    size_t num_channels = 8;
+    double sample_rate = 48000.0;
+    size_t slots = 8;                // Blocks the graph holds; a power of two is not required
+    double latency_budget_ms = 0.0;  // 0: no budget
+    uint32_t spin_iterations = 2000; // Pause iterations before an idle stage yields, then sleeps
+};
+
+struct StageOccupancy {
+    std::string name;
+    uint64_t blocks = 0;
+    uint64_t busy_ns = 0;      // In process()
+    uint64_t idle_ns = 0;      // Waiting for the stage before
+    double occupancy = 0.0;    // busy over busy + idle: 1 for the stage that sets the pace
+    double mean_ns = 0.0;      // busy_ns per block
+    double mean_queue = 0.0;   // Blocks waiting at the stage's input, averaged over its pops
+};
+
+struct StageGraphStats {
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    uint64_t rejected = 0;     // submit() calls refused: no free slot or over the latency budget
+    uint64_t late = 0;         // Completed blocks over the latency budget
+    size_t max_in_flight = 0;  // Blocks submit() lets into the graph at once
+    size_t bottleneck = 0;     // Stage with the highest mean_ns
+    LatencySnapshot latency;   // submit() to the last stage's end
+    std::vector<StageOccupancy> stages;
+};
+
+// Pipeline-parallel block processing: each stage runs on its own thread (a
+// core of its own when pinned), handing blocks to the next through bounded
+// single-producer single-consumer rings of slot indices. While stage k works
+// on block t, stage k - 1 already works on block t + 1, so blocks complete at
+// the pace of the slowest stage instead of the sum of all stages, at the
+// cost of one block period of latency per stage.
+//
+// submit() and collect() never lock, allocate or wait: submit() copies into
+// a free slot or refuses, and collect() hands back the oldest finished block
+// or null. One thread submits and one collects (they may be the same). With
+// a latency budget, submit() holds blocks in flight to what the budget
+// covers, floor(budget / block period) and at least one, so a slow stage
+// backs up into refused submissions instead of ever-growing latency, and
+// completions over the budget are counted late. Idle stages spin, then
+// yield, then sleep briefly between polls.
+//
+// A stage that throws stops the graph: later submissions are refused and
+// error() returns the message.
+class StageGraph {
+public:
+    // Throws std::invalid_argument for no stages, a stage without a
+    // function, an empty block, no channels or fewer than 2 slots
+    StageGraph(std::vector<GraphStage> stages, const StageGraphConfig& config = StageGraphConfig());
+    // Stops and joins the stage threads; blocks in flight are dropped
+    ~StageGraph();
+
+    StageGraph(const StageGraph&) = delete;
+    StageGraph& operator=(const StageGraph&) = delete;
+
+    // Copies n (1..block_size) samples into a free slot and starts it down
+    // the graph; false when refused. Throws std::invalid_argument for n
+    // outside 1..block_size.
+    bool submit(const float* in, size_t n);
+    // Oldest finished block, or null; it stays valid until release()
+    const GraphBlock* collect();
+    // Returns the block collect() gave to the free slots
+    void release();
+
+    StageGraphStats stats() const;
+    void resetStats();
+    bool failed() const { return failed_.load(std::memory_order_acquire); }
+    std::string error() const;
+
+    size_t stageCount() const { return stages_.size(); }
+    size_t inFlight() const;
+    const StageGraphConfig& config() const { return config_; }
+
+private:
+    // Bounded SPSC ring of slot indices; capacity covers every slot, so a
+    // push never finds it full
+    class IndexRing {
+    public:
+        explicit IndexRing(size_t capacity) : items_(capacity + 1) {}
+        void push(uint32_t index);
+        bool pop(uint32_t& index);
+        size_t size() const;
+
+    private:
+        std::vector<uint32_t> items_;
+        alignas(64) std::atomic<size_t> head_{0};  // Next pop
+        alignas(64) std::atomic<size_t> tail_{0};  // Next push
+    };
+
+    struct alignas(64) StageCounters {
+        std::atomic<uint64_t> blocks{0};
+        std::atomic<uint64_t> busy_ns{0};
+        std::atomic<uint64_t> idle_ns{0};
+        std::atomic<uint64_t> queued{0};  // Sum of input ring sizes at each pop
+    };
+
+    void runStage(size_t stage);
+
+    std::vector<GraphStage> stages_;
+    StageGraphConfig config_;
+    size_t max_in_flight_;
+    uint64_t budget_ns_;
+    std::vector<GraphBlock> slots_;
+    // rings_[k] feeds stage k, rings_[stages] holds finished blocks and
+    // rings_[stages + 1] the free slots
+    std::vector<std::unique_ptr<IndexRing>> rings_;
+    std::unique_ptr<StageCounters[]> counters_;
+    std::vector<std::thread> threads_;
+
+    uint64_t next_sequence_ = 0;      // Submitting thread only
+    int64_t collected_ = -1;          // Slot held by collect(), collecting thread only
+    std::atomic<uint64_t> submitted_{0};
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> released_{0};
+    std::atomic<uint64_t> rejected_{0};
+    std::atomic<uint64_t> late_{0};
+    LatencyHistogram latency_;
+    std::atomic<bool> stop_{false};
+    std::atomic<bool> failed_{false};
+    std::atomic<bool> error_claimed_{false};
+    std::string error_;               // Written once, by the stage that claims it, before failed_ is set
+};
+
+// Stages of the chromatic audio path, for StageGraph. Each owns its state
+// and must be used by one graph only.
+
+// High-pass input filter (DC and rumble removal) at hz, in place on input
+GraphStage makeInputFilterStage(double hz, double sample_rate, double q = 0.7071067811865476);
+// processChromaticBlock of the engine into channels; the engine must
+// outlive the graph and not be driven from elsewhere meanwhile
+GraphStage makeChromaticEngineStage(AnalogCellularEngineAVX2& engine, const ChromaticBlockConfig& config);
+// Magnitude spectrum of every channel over block_size (short blocks zero padded)
+GraphStage makeSpectrumStage(size_t num_channels, size_t block_size);
+// ICI of the channels (ICIKernel, short blocks zero padded); needs 2+ channels
+GraphStage makeIciStage(size_t num_channels, size_t block_size);
+// Input and output RMS, then sink(block) for publishing, if given
+GraphStage makeMetricsStage(size_t num_channels, std::function<void(const GraphBlock&)> sink = nullptr);
@@ -0,0 +1,355 @@
+#include "state_snapshot.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef DASE_WITH_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[8] = {'D', 'A', 'S', 'E', 'S', 'N', 'A', 'P'};
+constexpr uint32_t kByteOrderTag = 0x01020304u;
+constexpr unsigned char kGzipMagic[2] = {0x1f, 0x8b};
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;    // kByteOrderTag as the writing host stores it
+    uint32_t scalar_bytes;  // sizeof(Scalar) of the bank
+    uint32_t reserved;
+    uint64_t header_bytes;  // Offset of the storage block
+    uint64_t node_count;
+    uint64_t capacity;
+    uint64_t storage_bytes;
+    uint64_t cold_bytes;
+    uint64_t file_bytes;
+    SnapshotMeta meta;
+};
+static_assert(sizeof(Header) <= kSnapshotHeaderBytes, "snapshot header must fit its page");
+
+uint64_t coldBytes(uint64_t nodes) {
+    return nodes * (3 * sizeof(int16_t) + sizeof(uint16_t));
+}
+
+[[noreturn]] void fail(const std::string& path, const std::string& what) {
+    throw std::runtime_error("snapshot " + path + ": " + what);
+}
+
+struct FileCloser {
+    void operator()(std::FILE* f) const { std::fclose(f); }
+};
+using File = std::unique_ptr<std::FILE, FileCloser>;
+
+// Whole file mapped copy-on-write: reads come from the page cache, writes go
+// to private pages and never reach the file.
+class Mapping {
+public:
+    explicit Mapping(const std::string& path) {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                  FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) fail(path, "cannot open");
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size)) {
+            CloseHandle(file);
+            fail(path, "cannot stat");
+        }
+        size_ = static_cast<size_t>(size.QuadPart);
+        HANDLE mapping = size_ ? CreateFileMappingA(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr) : nullptr;
+        CloseHandle(file);
+        if (!mapping) fail(path, "cannot map");
+        data_ = static_cast<unsigned char*>(MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0));
+        CloseHandle(mapping);
+        if (!data_) fail(path, "cannot map");
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) fail(path, "cannot open");
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            fail(path, "cannot stat");
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        void* data = size_ ? ::mmap(nullptr, size_, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+        ::close(fd);
+        if (data == MAP_FAILED) fail(path, "cannot map");
+        data_ = static_cast<unsigned char*>(data);
+#endif
+    }
+
+    ~Mapping() {
+#ifdef _WIN32
+        UnmapViewOfFile(data_);
+#else
+        ::munmap(data_, size_);
+#endif
+    }
+
+    Mapping(const Mapping&) = delete;
+    Mapping& operator=(const Mapping&) = delete;
+
+    unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+private:
+    unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+template <typename Scalar>
+void checkHeader(const std::string& path, const Header& h, uint64_t file_bytes, size_t expected_nodes) {
+    if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0) fail(path, "not a state snapshot or incomplete");
+    if (h.version != kSnapshotVersion) fail(path, "unsupported version " + std::to_string(h.version));
+    if (h.byte_order != kByteOrderTag) fail(path, "written with another byte order");
+    if (h.scalar_bytes != sizeof(Scalar)) fail(path, "node state precision differs from the engine's");
+    if (h.node_count != expected_nodes) {
+        fail(path, "holds " + std::to_string(h.node_count) + " nodes, engine has " + std::to_string(expected_nodes));
+    }
+    if (h.header_bytes != kSnapshotHeaderBytes || h.capacity != BasicNodeBank<Scalar>::paddedCount(h.node_count) ||
+        h.storage_bytes != BasicNodeBank<Scalar>::storageBytesFor(h.capacity) ||
+        h.cold_bytes != coldBytes(h.node_count) ||
+        h.file_bytes != h.header_bytes + h.storage_bytes + h.cold_bytes) {
+        fail(path, "inconsistent header");
+    }
+    if (file_bytes != h.file_bytes) fail(path, "truncated");
+}
+
+template <typename Scalar>
+void readCold(BasicNodeBank<Scalar>& bank, const unsigned char* p) {
+    const size_t n = bank.size();
+    if (n == 0) return;
+    std::memcpy(bank.x.data(), p, n * sizeof(int16_t));
+    std::memcpy(bank.y.data(), p + n * sizeof(int16_t), n * sizeof(int16_t));
+    std::memcpy(bank.z.data(), p + 2 * n * sizeof(int16_t), n * sizeof(int16_t));
+    std::memcpy(bank.node_id.data(), p + 3 * n * sizeof(int16_t), n * sizeof(uint16_t));
+}
+
+// 64-bit file offsets; long is 32 bits on Windows
+bool seekTo(std::FILE* f, uint64_t offset, int origin) {
+#ifdef _WIN32
+    return _fseeki64(f, static_cast<__int64>(offset), origin) == 0;
+#else
+    return fseeko(f, static_cast<off_t>(offset), origin) == 0;
+#endif
+}
+
+int64_t tell(std::FILE* f) {
+#ifdef _WIN32
+    return _ftelli64(f);
+#else
+    return static_cast<int64_t>(ftello(f));
+#endif
+}
+
+bool writeAll(std::FILE* f, const void* data, size_t bytes) {
+    return bytes == 0 || std::fwrite(data, 1, bytes, f) == bytes;
+}
+
+template <typename Scalar>
+Header makeHeader(const BasicNodeBank<Scalar>& bank, const SnapshotMeta& meta) {
+    Header h{};
+    std::memcpy(h.magic, kMagic, sizeof(kMagic));
+    h.version = kSnapshotVersion;
+    h.byte_order = kByteOrderTag;
+    h.scalar_bytes = sizeof(Scalar);
+    h.header_bytes = kSnapshotHeaderBytes;
+    h.node_count = bank.size();
+    h.capacity = bank.capacity();
+    h.storage_bytes = bank.storageBytes();
+    h.cold_bytes = coldBytes(bank.size());
+    h.file_bytes = h.header_bytes + h.storage_bytes + h.cold_bytes;
+    h.meta = meta;
+    return h;
+}
+
+bool isCompressed(const std::string& path) {
+    File f(std::fopen(path.c_str(), "rb"));
+    if (!f) fail(path, "cannot open");
+    unsigned char magic[2] = {};
+    return std::fread(magic, 1, sizeof(magic), f.get()) == sizeof(magic) &&
+           std::memcmp(magic, kGzipMagic, sizeof(magic)) == 0;
+}
+
+#ifdef DASE_WITH_ZLIB
+
+struct GzCloser {
+    void operator()(gzFile_s* f) const { gzclose(f); }
+};
+using GzFile = std::unique_ptr<gzFile_s, GzCloser>;
+
+// gzwrite and gzread take unsigned lengths, so large columns go in pieces
+constexpr size_t kGzPiece = size_t(1) << 30;
+
+bool gzWriteAll(gzFile f, const void* data, size_t bytes) {
+    const unsigned char* p = static_cast<const unsigned char*>(data);
+    while (bytes > 0) {
+        const unsigned piece = static_cast<unsigned>(std::min(bytes, kGzPiece));
+        if (gzwrite(f, p, piece) != static_cast<int>(piece)) return false;
+        p += piece;
+        bytes -= piece;
+    }
+    return true;
+}
+
+bool gzReadAll(gzFile f, void* data, size_t bytes) {
+    unsigned char* p = static_cast<unsigned char*>(data);
+    while (bytes > 0) {
+        const unsigned piece = static_cast<unsigned>(std::min(bytes, kGzPiece));
+        if (gzread(f, p, piece) != static_cast<int>(piece)) return false;
+        p += piece;
+        bytes -= piece;
+    }
+    return true;
+}
+
+// Level 1: checkpoints favour write speed over ratio
+template <typename Scalar>
+void saveCompressed(const std::string& path, const BasicNodeBank<Scalar>& bank, const Header& h) {
+    GzFile f(gzopen(path.c_str(), "wb1"));
+    if (!f) fail(path, "cannot create");
+    std::vector<unsigned char> page(kSnapshotHeaderBytes, 0);
+    std::memcpy(page.data(), &h, sizeof(h));
+    const size_t n = bank.size();
+    const bool ok = gzWriteAll(f.get(), page.data(), page.size()) &&
+                    gzWriteAll(f.get(), bank.storage(), bank.storageBytes()) &&
+                    gzWriteAll(f.get(), bank.x.data(), n * sizeof(int16_t)) &&
+                    gzWriteAll(f.get(), bank.y.data(), n * sizeof(int16_t)) &&
+                    gzWriteAll(f.get(), bank.z.data(), n * sizeof(int16_t)) &&
+                    gzWriteAll(f.get(), bank.node_id.data(), n * sizeof(uint16_t));
+    const int close_status = gzclose(f.release());
+    if (!ok || close_status != Z_OK) fail(path, "write failed");
+}
+
+template <typename Scalar>
+SnapshotMeta loadCompressed(const std::string& path, BasicNodeBank<Scalar>& bank, size_t expected_nodes) {
+    GzFile f(gzopen(path.c_str(), "rb"));
+    if (!f) fail(path, "cannot open");
+    std::vector<unsigned char> page(kSnapshotHeaderBytes);
+    if (!gzReadAll(f.get(), page.data(), page.size())) fail(path, "truncated");
+    Header h;
+    std::memcpy(&h, page.data(), sizeof(h));
+    // The uncompressed size is only known once read; truncation shows as a
+    // short read or a failed trailer check below
+    checkHeader<Scalar>(path, h, h.file_bytes, expected_nodes);
+
+    BasicNodeBank<Scalar> loaded(h.node_count);
+    std::vector<unsigned char> cold(h.cold_bytes);
+    unsigned char extra;
+    if (!gzReadAll(f.get(), loaded.storage(), h.storage_bytes) || !gzReadAll(f.get(), cold.data(), h.cold_bytes) ||
+        gzread(f.get(), &extra, 1) != 0) {
+        fail(path, "read failed or corrupt");
+    }
+    readCold(loaded, cold.data());
+    bank = std::move(loaded);
+    return h.meta;
+}
+
+#endif
+
+} // namespace
+
+bool snapshotCompressionAvailable() {
+#ifdef DASE_WITH_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+template <typename Scalar>
+void saveSnapshot(const std::string& path, const BasicNodeBank<Scalar>& bank, const SnapshotMeta& meta,
+                  bool compress) {
+    const Header h = makeHeader(bank, meta);
+    if (compress) {
+#ifdef DASE_WITH_ZLIB
+        bank.materializeCold();
+        saveCompressed(path, bank, h);
+        return;
+#else
+        fail(path, "compression needs a build with DASE_WITH_ZLIB");
+#endif
+    }
+
+    File f(std::fopen(path.c_str(), "wb"));
+    if (!f) fail(path, "cannot create");
+
+    // Zero page first; the real header goes in once the payload is down
+    bank.materializeCold();
+    std::vector<unsigned char> page(kSnapshotHeaderBytes, 0);
+    const size_t n = bank.size();
+    bool ok = writeAll(f.get(), page.data(), page.size()) &&
+              writeAll(f.get(), bank.storage(), bank.storageBytes()) &&
+              writeAll(f.get(), bank.x.data(), n * sizeof(int16_t)) &&
+              writeAll(f.get(), bank.y.data(), n * sizeof(int16_t)) &&
+              writeAll(f.get(), bank.z.data(), n * sizeof(int16_t)) &&
+              writeAll(f.get(), bank.node_id.data(), n * sizeof(uint16_t)) &&
+              std::fflush(f.get()) == 0;
+    ok = ok && seekTo(f.get(), 0, SEEK_SET) && writeAll(f.get(), &h, sizeof(h));
+    const int close_status = std::fclose(f.release());
+    if (!ok || close_status != 0) fail(path, "write failed");
+}
+
+template <typename Scalar>
+SnapshotMeta loadSnapshot(const std::string& path, BasicNodeBank<Scalar>& bank, size_t expected_nodes,
+                          SnapshotLoad mode) {
+    if (isCompressed(path)) {
+#ifdef DASE_WITH_ZLIB
+        return loadCompressed(path, bank, expected_nodes);
+#else
+        fail(path, "compressed; loading it needs a build with DASE_WITH_ZLIB");
+#endif
+    }
+
+    Header h;
+    if (mode == SnapshotLoad::Map) {
+        auto mapping = std::make_shared<Mapping>(path);
+        if (mapping->size() < sizeof(Header)) fail(path, "truncated");
+        std::memcpy(&h, mapping->data(), sizeof(h));
+        checkHeader<Scalar>(path, h, mapping->size(), expected_nodes);
+
+        unsigned char* storage = mapping->data() + h.header_bytes;
+        bank.adoptStorage(h.node_count, h.capacity ? storage : nullptr, mapping);
+        readCold(bank, storage + h.storage_bytes);
+        return h.meta;
+    }
+
+    File f(std::fopen(path.c_str(), "rb"));
+    if (!f) fail(path, "cannot open");
+    if (std::fread(&h, 1, sizeof(h), f.get()) != sizeof(h)) fail(path, "truncated");
+    if (!seekTo(f.get(), 0, SEEK_END)) fail(path, "cannot seek");
+    const int64_t file_bytes = tell(f.get());
+    checkHeader<Scalar>(path, h, file_bytes < 0 ? 0 : static_cast<uint64_t>(file_bytes), expected_nodes);
+
+    BasicNodeBank<Scalar> loaded(h.node_count);
+    std::vector<unsigned char> cold(h.cold_bytes);
+    if (!seekTo(f.get(), h.header_bytes, SEEK_SET) ||
+        (h.storage_bytes && std::fread(loaded.storage(), 1, h.storage_bytes, f.get()) != h.storage_bytes) ||
+        (h.cold_bytes && std::fread(cold.data(), 1, h.cold_bytes, f.get()) != h.cold_bytes)) {
+        fail(path, "read failed");
+    }
+    readCold(loaded, cold.data());
+    bank = std::move(loaded);
+    return h.meta;
+}
+
+template void saveSnapshot<double>(const std::string&, const BasicNodeBank<double>&, const SnapshotMeta&, bool);
+template void saveSnapshot<float>(const std::string&, const BasicNodeBank<float>&, const SnapshotMeta&, bool);
+template SnapshotMeta loadSnapshot<double>(const std::string&, BasicNodeBank<double>&, size_t, SnapshotLoad);
+template SnapshotMeta loadSnapshot<float>(const std::string&, BasicNodeBank<float>&, size_t, SnapshotLoad);
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "node_bank.h"
+
+// How loadSnapshot() brings the node columns into memory
+enum class SnapshotLoad {
+    Copy = 0,  // Read the file into freshly allocated columns
+    Map = 1    // Map the file copy-on-write and run on the mapping directly
+};
+
+// Engine values stored next to the node bank
+struct SnapshotMeta {
+    uint64_t grid_nx = 0;
+    uint64_t grid_ny = 0;
+    uint64_t grid_nz = 0;
+    uint64_t noise_seed = 0;
+    uint64_t noise_step = 0;
+    uint64_t mission_step = 0;  // Mission steps done, for a checkpoint (0 otherwise)
+    uint64_t grid_order = 0;    // GridOrder; older files read 0, linear
+};
+
+// Node state snapshot file, version 2, in host byte order:
+//
+//   [0, kSnapshotHeaderBytes)   header, zero padded to a page
+//   storage block               BasicNodeBank::storage() byte for byte,
+//                               parameter columns included
+//   cold block                  x, y, z (int16), node_id (uint16), size() each
+//
+// The storage block starts page aligned, so a mapping of the file hands the
+// bank 64-byte aligned columns with no copy: pages fault in on first touch
+// and are copied only once the engine writes to them, and the file is never
+// modified. The header is written last, so a save cut short leaves a file
+// that fails to load rather than one with torn state.
+//
+// A compressed snapshot is the same file as one gzip stream (builds with
+// DASE_WITH_ZLIB only). It is written front to back, header first, and the
+// gzip trailer's CRC catches a cut-short save instead. Loading recognizes it
+// by the gzip magic and always decompresses into fresh columns, so Map
+// behaves as Copy for it.
+constexpr uint64_t kSnapshotHeaderBytes = 4096;
+constexpr uint32_t kSnapshotVersion = 2;  // 1 had no parameter columns
+
+// Both throw std::runtime_error with the reason on I/O errors, and loading
+// also on a file of another version, precision or byte order, or one whose
+// node count differs from expected_nodes. Compression, and loading a
+// compressed file, throw std::runtime_error without DASE_WITH_ZLIB.
+template <typename Scalar>
+void saveSnapshot(const std::string& path, const BasicNodeBank<Scalar>& bank, const SnapshotMeta& meta,
+                  bool compress = false);
+
+// True when the build can write and read compressed snapshots
+bool snapshotCompressionAvailable();
+
+template <typename Scalar>
+SnapshotMeta loadSnapshot(const std::string& path, BasicNodeBank<Scalar>& bank, size_t expected_nodes,
+                          SnapshotLoad mode);
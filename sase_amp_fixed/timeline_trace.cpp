@@ -0,0 +1,416 @@
+#include "timeline_trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+namespace timeline_trace {
+
+namespace detail {
+std::atomic<int> g_level{static_cast<int>(TraceLevel::Off)};
+
+uint64_t nowNs() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+} // namespace detail
+
+namespace {
+
+// Fields are relaxed atomics so a dump may read a slot the owner is
+// rewriting; the ring's head tells the reader which copies to keep.
+struct Slot {
+    std::atomic<const EventKind*> kind;
+    std::atomic<uint64_t> start_ns;
+    std::atomic<uint64_t> end_ns;
+    std::atomic<uint64_t> arg0;
+    std::atomic<uint64_t> arg1;
+};
+
+struct Event {
+    const EventKind* kind;
+    uint64_t start_ns;
+    uint64_t end_ns;
+    uint64_t arg0;
+    uint64_t arg1;
+};
+
+// One thread's ring. head counts events ever written; the owner is the
+// only writer. floor is the head at the last clear().
+struct Ring {
+    explicit Ring(size_t capacity) : slots(new Slot[capacity]), capacity(capacity) {}
+
+    std::unique_ptr<Slot[]> slots;
+    const size_t capacity;
+    alignas(64) std::atomic<uint64_t> head{0};
+    std::atomic<uint64_t> floor{0};
+    uint32_t tid = 0;
+    std::string name;      // Guarded by Registry::mutex
+    bool retired = false;  // Owner thread exited; guarded by Registry::mutex
+
+    void push(const EventKind* kind, uint64_t start_ns, uint64_t end_ns, uint64_t arg0, uint64_t arg1) {
+        const uint64_t index = head.load(std::memory_order_relaxed);
+        // A reader that sees any of the stores below also sees index as
+        // the head, so it drops the old event of this slot
+        std::atomic_thread_fence(std::memory_order_release);
+        Slot& slot = slots[index % capacity];
+        slot.kind.store(kind, std::memory_order_relaxed);
+        slot.start_ns.store(start_ns, std::memory_order_relaxed);
+        slot.end_ns.store(end_ns, std::memory_order_relaxed);
+        slot.arg0.store(arg0, std::memory_order_relaxed);
+        slot.arg1.store(arg1, std::memory_order_relaxed);
+        head.store(index + 1, std::memory_order_release);
+    }
+
+    // Events currently held, oldest first
+    std::vector<Event> copy() const {
+        const uint64_t end = head.load(std::memory_order_acquire);
+        uint64_t begin = std::max(floor.load(std::memory_order_relaxed), end > capacity ? end - capacity : 0);
+        std::vector<Event> events;
+        events.reserve(static_cast<size_t>(end - begin));
+        for (uint64_t i = begin; i < end; i++) {
+            const Slot& slot = slots[i % capacity];
+            events.push_back({slot.kind.load(std::memory_order_relaxed), slot.start_ns.load(std::memory_order_relaxed),
+                              slot.end_ns.load(std::memory_order_relaxed), slot.arg0.load(std::memory_order_relaxed),
+                              slot.arg1.load(std::memory_order_relaxed)});
+        }
+        // Slots the owner reached again during the copy may be torn
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t after = head.load(std::memory_order_relaxed);
+        const uint64_t first_intact = after >= capacity ? after - capacity + 1 : 0;
+        if (first_intact > begin) {
+            const size_t drop = static_cast<size_t>(std::min<uint64_t>(first_intact - begin, events.size()));
+            events.erase(events.begin(), events.begin() + static_cast<std::ptrdiff_t>(drop));
+        }
+        return events;
+    }
+
+    bool empty() const {
+        return head.load(std::memory_order_acquire) == floor.load(std::memory_order_relaxed);
+    }
+};
+
+struct Registry {
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Ring>> rings;
+    size_t capacity = 16384;
+    uint32_t next_tid = 1;
+};
+
+Registry& registry() {
+    static Registry r;
+    return r;
+}
+
+// The calling thread's ring, handed back to the registry when the thread exits
+struct ThreadRing {
+    Ring* ring = nullptr;
+    std::string name;  // Applies to the ring once it exists
+
+    ~ThreadRing() {
+        if (!ring) return;
+        Registry& r = registry();
+        std::lock_guard<std::mutex> lock(r.mutex);
+        ring->retired = true;
+    }
+};
+
+thread_local ThreadRing t_ring;
+
+Ring& threadRing() {
+    if (t_ring.ring) return *t_ring.ring;
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    Ring* ring = nullptr;
+    // Reuse a ring of an exited thread once its events have been cleared
+    for (auto& candidate : r.rings) {
+        if (candidate->retired && candidate->capacity == r.capacity && candidate->empty()) {
+            ring = candidate.get();
+            break;
+        }
+    }
+    if (!ring) {
+        r.rings.push_back(std::make_unique<Ring>(r.capacity));
+        ring = r.rings.back().get();
+    }
+    ring->retired = false;
+    ring->tid = r.next_tid++;
+    ring->name = t_ring.name.empty() ? "thread " + std::to_string(ring->tid) : t_ring.name;
+    t_ring.ring = ring;
+    return *ring;
+}
+
+struct ThreadEvents {
+    uint32_t tid;
+    std::string name;
+    std::vector<Event> events;
+};
+
+std::vector<ThreadEvents> collect() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    std::vector<ThreadEvents> threads;
+    for (const auto& ring : r.rings) {
+        std::vector<Event> events = ring->copy();
+        if (events.empty()) continue;
+        threads.push_back({ring->tid, ring->name, std::move(events)});
+    }
+    return threads;
+}
+
+bool writeFile(const std::string& path, const std::string& data) {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) return false;
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+    return static_cast<bool>(file);
+}
+
+std::string jsonString(const std::string& text) {
+    std::string out = "\"";
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+            out += escaped;
+        } else {
+            out += c;
+        }
+    }
+    return out + "\"";
+}
+
+// Microseconds with nanosecond digits, as the trace viewer expects
+std::string micros(uint64_t ns) {
+    char text[32];
+    std::snprintf(text, sizeof(text), "%llu.%03u", static_cast<unsigned long long>(ns / 1000),
+                  static_cast<unsigned>(ns % 1000));
+    return text;
+}
+
+// --- protobuf wire format (https://protobuf.dev/programming-guides/encoding/)
+
+void varint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+void fieldVarint(std::string& out, uint32_t field, uint64_t value) {
+    varint(out, static_cast<uint64_t>(field) << 3);
+    varint(out, value);
+}
+
+void fieldBytes(std::string& out, uint32_t field, const std::string& bytes) {
+    varint(out, (static_cast<uint64_t>(field) << 3) | 2);
+    varint(out, bytes.size());
+    out += bytes;
+}
+
+// Field numbers of perfetto/protos/perfetto/trace
+constexpr uint32_t kTracePacket = 1;              // Trace.packet
+constexpr uint32_t kPacketTimestamp = 8;          // TracePacket.timestamp
+constexpr uint32_t kPacketSequenceId = 10;        // TracePacket.trusted_packet_sequence_id
+constexpr uint32_t kPacketTrackEvent = 11;        // TracePacket.track_event
+constexpr uint32_t kPacketTrackDescriptor = 60;   // TracePacket.track_descriptor
+constexpr uint32_t kDescriptorUuid = 1;           // TrackDescriptor.uuid
+constexpr uint32_t kDescriptorProcess = 3;        // TrackDescriptor.process
+constexpr uint32_t kDescriptorThread = 4;         // TrackDescriptor.thread
+constexpr uint32_t kProcessPid = 1;               // ProcessDescriptor.pid
+constexpr uint32_t kProcessName = 6;              // ProcessDescriptor.process_name
+constexpr uint32_t kThreadPid = 1;                // ThreadDescriptor.pid
+constexpr uint32_t kThreadTid = 2;                // ThreadDescriptor.tid
+constexpr uint32_t kThreadName = 5;               // ThreadDescriptor.thread_name
+constexpr uint32_t kEventAnnotations = 4;         // TrackEvent.debug_annotations
+constexpr uint32_t kEventType = 9;                // TrackEvent.type
+constexpr uint32_t kEventTrackUuid = 11;          // TrackEvent.track_uuid
+constexpr uint32_t kEventName = 23;               // TrackEvent.name
+constexpr uint32_t kAnnotationUint = 3;           // DebugAnnotation.uint_value
+constexpr uint32_t kAnnotationName = 10;          // DebugAnnotation.name
+constexpr uint64_t kSliceBegin = 1;               // TrackEvent.Type
+constexpr uint64_t kSliceEnd = 2;
+
+constexpr uint32_t kPid = 1;
+constexpr uint32_t kSequenceId = 1;
+constexpr uint64_t kProcessUuid = 1;
+
+void packet(std::string& trace, const std::string& body) {
+    fieldBytes(trace, kTracePacket, body);
+}
+
+void annotation(std::string& event, const char* name, uint64_t value) {
+    if (!name) return;
+    std::string a;
+    fieldBytes(a, kAnnotationName, name);
+    fieldVarint(a, kAnnotationUint, value);
+    fieldBytes(event, kEventAnnotations, a);
+}
+
+} // namespace
+
+void setLevel(TraceLevel level) {
+    detail::g_level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+TraceLevel level() {
+    return static_cast<TraceLevel>(detail::g_level.load(std::memory_order_relaxed));
+}
+
+void setBufferCapacity(size_t events) {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    r.capacity = std::max<size_t>(events, 16);
+}
+
+size_t bufferCapacity() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.capacity;
+}
+
+void setThreadName(const std::string& name) {
+    t_ring.name = name;
+    if (!t_ring.ring) return;
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    t_ring.ring->name = name;
+}
+
+void clear() {
+    Registry& r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (auto& ring : r.rings) {
+        ring->floor.store(ring->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+size_t eventCount() {
+    size_t count = 0;
+    for (const ThreadEvents& thread : collect()) count += thread.events.size();
+    return count;
+}
+
+void detail::record(const EventKind* kind, uint64_t start_ns, uint64_t end_ns, uint64_t arg0, uint64_t arg1) {
+    threadRing().push(kind, start_ns, end_ns, arg0, arg1);
+}
+
+std::string chromeJson() {
+    const std::vector<ThreadEvents> threads = collect();
+    std::ostringstream s;
+    s << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    s << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << kPid << ",\"args\":{\"name\":\"dase_engine\"}}";
+    for (const ThreadEvents& thread : threads) {
+        s << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << kPid << ",\"tid\":" << thread.tid
+          << ",\"args\":{\"name\":" << jsonString(thread.name) << "}}";
+        for (const Event& e : thread.events) {
+            s << ",\n{\"name\":" << jsonString(e.kind->name) << ",\"ph\":\"X\",\"pid\":" << kPid
+              << ",\"tid\":" << thread.tid << ",\"ts\":" << micros(e.start_ns)
+              << ",\"dur\":" << micros(e.end_ns - e.start_ns);
+            if (e.kind->arg0_name || e.kind->arg1_name) {
+                s << ",\"args\":{";
+                if (e.kind->arg0_name) s << jsonString(e.kind->arg0_name) << ":" << e.arg0;
+                if (e.kind->arg0_name && e.kind->arg1_name) s << ",";
+                if (e.kind->arg1_name) s << jsonString(e.kind->arg1_name) << ":" << e.arg1;
+                s << "}";
+            }
+            s << "}";
+        }
+    }
+    s << "\n]}\n";
+    return s.str();
+}
+
+bool writeChromeJson(const std::string& path) {
+    return writeFile(path, chromeJson());
+}
+
+std::string perfettoProto() {
+    const std::vector<ThreadEvents> threads = collect();
+    std::string trace;
+
+    {
+        std::string process;
+        fieldVarint(process, kProcessPid, kPid);
+        fieldBytes(process, kProcessName, "dase_engine");
+        std::string descriptor;
+        fieldVarint(descriptor, kDescriptorUuid, kProcessUuid);
+        fieldBytes(descriptor, kDescriptorProcess, process);
+        std::string body;
+        fieldBytes(body, kPacketTrackDescriptor, descriptor);
+        packet(trace, body);
+    }
+
+    for (const ThreadEvents& thread : threads) {
+        const uint64_t uuid = kProcessUuid + thread.tid;
+        std::string desc_thread;
+        fieldVarint(desc_thread, kThreadPid, kPid);
+        fieldVarint(desc_thread, kThreadTid, thread.tid);
+        fieldBytes(desc_thread, kThreadName, thread.name);
+        std::string descriptor;
+        fieldVarint(descriptor, kDescriptorUuid, uuid);
+        fieldBytes(descriptor, kDescriptorThread, desc_thread);
+        std::string body;
+        fieldBytes(body, kPacketTrackDescriptor, descriptor);
+        packet(trace, body);
+
+        // Slices become begin/end pairs, which must nest on a track: order
+        // by time, ends before begins at the same instant, outer slices
+        // first among equal begins and inner slices first among equal ends.
+        // Zero-length slices are stretched to 1 ns so their end follows
+        // their begin.
+        struct Mark {
+            uint64_t ts;
+            bool begin;
+            uint64_t other;  // End of a begin mark, start of an end mark
+            size_t index;
+        };
+        std::vector<Mark> marks;
+        marks.reserve(2 * thread.events.size());
+        for (size_t i = 0; i < thread.events.size(); i++) {
+            const Event& e = thread.events[i];
+            const uint64_t end = std::max(e.end_ns, e.start_ns + 1);
+            marks.push_back({e.start_ns, true, end, i});
+            marks.push_back({end, false, e.start_ns, i});
+        }
+        std::sort(marks.begin(), marks.end(), [](const Mark& a, const Mark& b) {
+            if (a.ts != b.ts) return a.ts < b.ts;
+            if (a.begin != b.begin) return !a.begin;
+            // Later end means outer for begins, later start inner for ends
+            if (a.other != b.other) return a.other > b.other;
+            // Slices are recorded when they end, so the outer one comes later
+            return a.begin ? a.index > b.index : a.index < b.index;
+        });
+
+        for (const Mark& m : marks) {
+            const Event& e = thread.events[m.index];
+            std::string event;
+            fieldVarint(event, kEventType, m.begin ? kSliceBegin : kSliceEnd);
+            fieldVarint(event, kEventTrackUuid, uuid);
+            if (m.begin) {
+                fieldBytes(event, kEventName, e.kind->name);
+                annotation(event, e.kind->arg0_name, e.arg0);
+                annotation(event, e.kind->arg1_name, e.arg1);
+            }
+            std::string packet_body;
+            fieldVarint(packet_body, kPacketTimestamp, m.ts);
+            fieldVarint(packet_body, kPacketSequenceId, kSequenceId);
+            fieldBytes(packet_body, kPacketTrackEvent, event);
+            packet(trace, packet_body);
+        }
+    }
+    return trace;
+}
+
+bool writePerfetto(const std::string& path) {
+    return writeFile(path, perfettoProto());
+}
+
+} // namespace timeline_trace
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Opt-in timeline of the parallel regions, for Chrome's trace viewer
+// (chrome://tracing, ui.perfetto.dev) and Perfetto.
+//
+// Every thread that records gets its own ring buffer on first use, so
+// recording takes no lock and never waits for a reader; when a ring is
+// full the oldest events are overwritten. Events are complete slices
+// (kind, start, end, two integer arguments) on steady_clock. With
+// tracing off a scope costs one relaxed load and a branch.
+//
+// What is recorded per level:
+//   Regions  engine kernels (named after their WorkKernel) on the issuing
+//            thread, in DASE_PROFILING builds, and one "job" slice per
+//            worker and parallel region from its wake-up to the end of its
+//            last chunk
+//   Chunks   Regions plus one "chunk" slice per claimed index range
+namespace timeline_trace {
+
+enum class TraceLevel {
+    Off = 0,
+    Regions = 1,
+    Chunks = 2
+};
+
+// Name and argument labels of one kind of slice. Kinds are referenced, not
+// copied, so they must outlive the trace (static storage); a null label
+// hides that argument.
+struct EventKind {
+    const char* name;
+    const char* arg0_name;
+    const char* arg1_name;
+};
+
+namespace detail {
+extern std::atomic<int> g_level;
+uint64_t nowNs();
+void record(const EventKind* kind, uint64_t start_ns, uint64_t end_ns, uint64_t arg0, uint64_t arg1);
+} // namespace detail
+
+inline bool enabled(TraceLevel level) {
+    return detail::g_level.load(std::memory_order_relaxed) >= static_cast<int>(level);
+}
+
+// Level for all threads; enabling allocates each recording thread's ring
+// lazily, so an untraced run never pays for the buffers.
+void setLevel(TraceLevel level);
+TraceLevel level();
+// Ring size in events for threads that start recording after the call
+// (16384 by default, 40 bytes per event)
+void setBufferCapacity(size_t events);
+size_t bufferCapacity();
+
+// Name shown for the calling thread's track
+void setThreadName(const std::string& name);
+
+// Drops every recorded event; safe while other threads keep recording
+void clear();
+// Events currently held, over all threads
+size_t eventCount();
+
+// Serializations of the held events. Events recorded while a dump runs are
+// either included whole or left out. The file writers return false on I/O
+// failure.
+std::string chromeJson();
+bool writeChromeJson(const std::string& path);
+std::string perfettoProto();
+bool writePerfetto(const std::string& path);
+
+// Records [construction, destruction) as a slice of kind when level is
+// enabled
+class Scope {
+public:
+    Scope(TraceLevel level, const EventKind& kind, uint64_t arg0 = 0, uint64_t arg1 = 0)
+        : kind_(enabled(level) ? &kind : nullptr), arg0_(arg0), arg1_(arg1) {
+        if (kind_) start_ns_ = detail::nowNs();
+    }
+
+    ~Scope() {
+        if (kind_) detail::record(kind_, start_ns_, detail::nowNs(), arg0_, arg1_);
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+    // For arguments only known when the slice ends
+    void setArgs(uint64_t arg0, uint64_t arg1) {
+        arg0_ = arg0;
+        arg1_ = arg1;
+    }
+
+private:
+    const EventKind* kind_;
+    uint64_t arg0_;
+    uint64_t arg1_;
+    uint64_t start_ns_ = 0;
+};
+
+} // namespace timeline_trace
@@ -0,0 +1,684 @@
+#include "worker_pool.h"
+#include "float_environment.h"
+#include "timeline_trace.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#include <immintrin.h>
+#define DASE_CPU_RELAX() _mm_pause()
+#else
+#define DASE_CPU_RELAX() std::this_thread::yield()
+#endif
+
+#if defined(__linux__)
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/prctl.h>
+#include <time.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#include <avrt.h>
+#include <timeapi.h>
+#endif
+
+// Id of the pool worker running on this thread (0 for any other thread)
+static thread_local unsigned t_worker_id = 0;
+
+static const timeline_trace::EventKind kTraceJob{"job", "chunks", "worker"};
+static const timeline_trace::EventKind kTraceChunk{"chunk", "begin", "end"};
+
+WorkerPool::WorkerPool(const WorkerPoolConfig& config) : config_(config) {
+    allowed_cpus_ = availableCpus(config_.reserved_cpus);
+
+    unsigned threads = config_.num_threads;
+    if (threads == 0) {
+        threads = static_cast<unsigned>(std::max<size_t>(1, allowed_cpus_.size()));
+    }
+    config_.num_threads = threads;
+    shares_.reset(new Share[threads]);
+    thread_status_.resize(threads - 1);
+
+#if defined(_WIN32)
+    if (config_.realtime) {
+        timer_period_set_ = timeBeginPeriod(1) == TIMERR_NOERROR;
+#ifdef PROCESS_POWER_THROTTLING_IGNORE_TIMER_RESOLUTION
+        // Windows 11 lets the resolution lapse while no window of the
+        // process is visible, unless told not to
+        PROCESS_POWER_THROTTLING_STATE state = {};
+        state.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+        state.ControlMask = PROCESS_POWER_THROTTLING_IGNORE_TIMER_RESOLUTION;
+        state.StateMask = 0;
+        SetProcessInformation(GetCurrentProcess(), ProcessPowerThrottling, &state, sizeof(state));
+#endif
+    }
+#endif
+
+    workers_.reserve(threads - 1);
+    for (unsigned k = 1; k < threads; k++) {
+        workers_.emplace_back(&WorkerPool::workerLoop, this, k);
+        pinWorker(workers_.back(), k);
+    }
+
+    // Every worker has its profile before the first job
+    std::unique_lock<std::mutex> lock(status_mutex_);
+    status_cv_.wait(lock, [&] { return profiled_ == workers_.size(); });
+    const auto failed = std::find_if(thread_status_.begin(), thread_status_.end(),
+                                     [](const WorkerThreadStatus& status) { return status.error != 0; });
+    if (failed != thread_status_.end()) {
+        std::cerr << "⚠️  WorkerPool: real-time profile incomplete (error " << failed->error
+                  << "), see threadStatus()" << std::endl;
+    }
+}
+
+WorkerPool::~WorkerPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_.store(true, std::memory_order_release);
+    }
+    wake_cv_.notify_all();
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+#if defined(_WIN32)
+    if (timer_period_set_) {
+        timeEndPeriod(1);
+    }
+#endif
+}
+
+std::vector<int> WorkerPool::availableCpus(const std::vector<int>& reserved_cpus) {
+    std::vector<int> cpus;
+    const int online = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int cpu = 0; cpu < online; cpu++) {
+        if (std::find(reserved_cpus.begin(), reserved_cpus.end(), cpu) == reserved_cpus.end()) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+#if defined(__linux__)
+// One integer from a sysfs file, or fallback when it is missing
+static int readSysfsInt(const std::string& path, int fallback) {
+    std::ifstream in(path);
+    int value;
+    return (in >> value) ? value : fallback;
+}
+
+// Whether cpu is in a sysfs CPU list such as "0-3,8-11"
+static bool cpuListContains(const std::string& list, int cpu) {
+    size_t pos = 0;
+    while (pos < list.size()) {
+        size_t comma = list.find(',', pos);
+        if (comma == std::string::npos) comma = list.size();
+        const std::string range = list.substr(pos, comma - pos);
+        const size_t dash = range.find('-');
+        try {
+            const int first = std::stoi(range.substr(0, dash));
+            const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+            if (cpu >= first && cpu <= last) return true;
+        } catch (const std::exception&) {
+        }
+        pos = comma + 1;
+    }
+    return false;
+}
+#endif
+
+std::vector<CpuLocation> WorkerPool::cpuTopology(const std::vector<int>& cpus) {
+    std::vector<CpuLocation> locations(cpus.size());
+#if defined(__linux__)
+    std::vector<std::string> node_lists;
+    for (int node = 0; node < 256; node++) {
+        std::ifstream in("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+        std::string list;
+        node_lists.push_back(in && std::getline(in, list) ? list : std::string());
+    }
+#endif
+    for (size_t i = 0; i < cpus.size(); i++) {
+        CpuLocation& loc = locations[i];
+        loc.cpu = cpus[i];
+        loc.core = cpus[i];
+#if defined(__linux__)
+        const std::string topology = "/sys/devices/system/cpu/cpu" + std::to_string(loc.cpu) + "/topology/";
+        loc.core = readSysfsInt(topology + "core_id", loc.cpu);
+        loc.package = std::max(0, readSysfsInt(topology + "physical_package_id", 0));
+        for (size_t node = 0; node < node_lists.size(); node++) {
+            if (!node_lists[node].empty() && cpuListContains(node_lists[node], loc.cpu)) {
+                loc.numa_node = static_cast<int>(node);
+                break;
+            }
+        }
+#endif
+    }
+    // Siblings are ranked in CPU order, whatever order cpus came in
+    for (CpuLocation& loc : locations) {
+        for (const CpuLocation& other : locations) {
+            if (other.package == loc.package && other.core == loc.core && other.cpu < loc.cpu) loc.smt_index++;
+        }
+    }
+    return locations;
+}
+
+CpuCaches WorkerPool::cpuCaches(int cpu) {
+    CpuCaches caches;
+#if defined(__linux__)
+    const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cache/index";
+    for (int index = 0; index < 16; index++) {
+        std::ifstream type_in(base + std::to_string(index) + "/type");
+        std::ifstream size_in(base + std::to_string(index) + "/size");
+        std::string type, size_text;
+        if (!(type_in >> type) || !(size_in >> size_text)) break;
+        if (type == "Instruction") continue;
+        const int level = readSysfsInt(base + std::to_string(index) + "/level", 0);
+        // Sizes read like "48K" or "30M"
+        size_t bytes = 0;
+        try {
+            bytes = std::stoul(size_text);
+        } catch (const std::exception&) {
+            continue;
+        }
+        const char unit = size_text.back();
+        if (unit == 'K') bytes <<= 10;
+        else if (unit == 'M') bytes <<= 20;
+        else if (unit == 'G') bytes <<= 30;
+        if (level == 1) caches.l1d = bytes;
+        else if (level == 2) caches.l2 = bytes;
+        if (level >= 2 && type == "Unified") caches.llc = std::max(caches.llc, bytes);
+    }
+#else
+    (void)cpu;
+#endif
+    return caches;
+}
+
+ScopedThreadAffinity::ScopedThreadAffinity(int cpu) {
+    if (cpu < 0) return;
+#if defined(__linux__)
+    if (cpu >= CPU_SETSIZE) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0) return;
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (CPU_ISSET(c, &set)) previous_.push_back(c);
+    }
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pinned_ = pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#elif defined(_WIN32)
+    if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) return;
+    const DWORD_PTR old_mask = SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << cpu);
+    if (old_mask == 0) return;
+    for (int c = 0; c < static_cast<int>(sizeof(DWORD_PTR) * 8); c++) {
+        if (old_mask & (DWORD_PTR(1) << c)) previous_.push_back(c);
+    }
+    pinned_ = true;
+#endif
+}
+
+ScopedThreadAffinity::~ScopedThreadAffinity() {
+    if (!pinned_) return;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : previous_) CPU_SET(c, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#elif defined(_WIN32)
+    DWORD_PTR bits = 0;
+    for (int c : previous_) bits |= DWORD_PTR(1) << c;
+    SetThreadAffinityMask(GetCurrentThread(), bits);
+#endif
+}
+
+// Applies the real-time profile to the calling worker thread and records
+// what it got; returns what leaveProfile undoes (the MMCSS handle)
+void* WorkerPool::enterProfile(unsigned worker) {
+    WorkerThreadStatus status;
+    status.worker = worker;
+    void* handle = nullptr;
+#if defined(_WIN32)
+    if (config_.realtime) {
+        DWORD task = 0;
+        HANDLE mmcss = AvSetMmThreadCharacteristicsW(L"Pro Audio", &task);
+        if (mmcss != nullptr) {
+            handle = mmcss;
+            status.realtime = true;
+            status.mmcss_task = static_cast<uint32_t>(task);
+            status.priority = AvSetMmThreadPriority(mmcss, AVRT_PRIORITY_HIGH) ? AVRT_PRIORITY_HIGH
+                                                                               : AVRT_PRIORITY_NORMAL;
+        } else {
+            status.error = static_cast<int>(GetLastError());
+        }
+#ifdef THREAD_POWER_THROTTLING_CURRENT_VERSION
+        // Controlled and clear: never run at reduced execution speed
+        THREAD_POWER_THROTTLING_STATE throttling = {};
+        throttling.Version = THREAD_POWER_THROTTLING_CURRENT_VERSION;
+        throttling.ControlMask = THREAD_POWER_THROTTLING_EXECUTION_SPEED;
+        throttling.StateMask = 0;
+        if (SetThreadInformation(GetCurrentThread(), ThreadPowerThrottling, &throttling, sizeof(throttling))) {
+            status.power_throttling_disabled = true;
+        } else if (status.error == 0) {
+            status.error = static_cast<int>(GetLastError());
+        }
+#endif
+    }
+    if (timer_period_set_) {
+        status.timer_resolution_ns = 1000000;
+    }
+#elif defined(__linux__)
+    if (config_.realtime) {
+        sched_param param{};
+        param.sched_priority = config_.realtime_priority > 0 ? std::min(config_.realtime_priority, 99) : 70;
+        const int err = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (err == 0) {
+            status.realtime = true;
+            status.priority = param.sched_priority;
+        } else {
+            status.error = err;
+        }
+        if (prctl(PR_SET_TIMERSLACK, 1UL, 0UL, 0UL, 0UL) != 0 && status.error == 0) {
+            status.error = errno;
+        }
+    }
+    const int slack = prctl(PR_GET_TIMERSLACK, 0UL, 0UL, 0UL, 0UL);
+    status.timer_resolution_ns = slack > 0 ? static_cast<uint64_t>(slack) : 0;  // None under SCHED_FIFO
+#endif
+    {
+        std::lock_guard<std::mutex> lock(status_mutex_);
+        thread_status_[worker - 1] = status;
+        profiled_++;
+    }
+    status_cv_.notify_all();
+    return handle;
+}
+
+void WorkerPool::leaveProfile(void* handle) {
+#if defined(_WIN32)
+    if (handle != nullptr) {
+        AvRevertMmThreadCharacteristics(static_cast<HANDLE>(handle));
+    }
+#else
+    (void)handle;
+#endif
+}
+
+std::vector<WorkerThreadStatus> WorkerPool::threadStatus() const {
+    std::lock_guard<std::mutex> lock(status_mutex_);
+    return thread_status_;
+}
+
+#if defined(_WIN32)
+static uint64_t threadTimesNs(HANDLE thread) {
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(thread, &created, &exited, &kernel, &user)) return 0;
+    const uint64_t ticks = ((static_cast<uint64_t>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime) +
+                           ((static_cast<uint64_t>(user.dwHighDateTime) << 32) | user.dwLowDateTime);
+    return ticks * 100;  // 100 ns units
+}
+#endif
+
+uint64_t WorkerPool::threadCpuNs() {
+#if defined(__linux__)
+    timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) != 0) return 0;
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+#elif defined(_WIN32)
+    return threadTimesNs(GetCurrentThread());
+#else
+    return 0;
+#endif
+}
+
+void WorkerPool::pinWorker(std::thread& thread, unsigned worker) {
+    std::vector<int> mask;
+    if (!config_.cpu_affinity.empty()) {
+        mask.push_back(config_.cpu_affinity[(worker - 1) % config_.cpu_affinity.size()]);
+    } else if (!config_.reserved_cpus.empty()) {
+        mask = allowed_cpus_;
+    }
+    if (mask.empty()) return;
+
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : mask) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    if (pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) != 0) {
+        std::cerr << "⚠️  WorkerPool: could not set affinity for worker " << worker << std::endl;
+    }
+#elif defined(_WIN32)
+    DWORD_PTR bits = 0;
+    for (int cpu : mask) {
+        if (cpu >= 0 && cpu < static_cast<int>(sizeof(DWORD_PTR) * 8)) bits |= DWORD_PTR(1) << cpu;
+    }
+    if (bits == 0 || SetThreadAffinityMask(reinterpret_cast<HANDLE>(thread.native_handle()), bits) == 0) {
+        std::cerr << "⚠️  WorkerPool: could not set affinity for worker " << worker << std::endl;
+    }
+#else
+    (void)thread;
+#endif
+}
+
+size_t WorkerPool::resolveGrain(size_t count, size_t grain) const {
+    if (grain > 0) return grain;
+    // About eight chunks per thread balances load without much cursor traffic
+    return std::max<size_t>(1, count / (static_cast<size_t>(size()) * 8));
+}
+
+bool WorkerPool::tryAcquire(size_t count, size_t grain) {
+    if (workers_.empty() || count <= grain) return false;
+    bool expected = false;
+    return busy_.compare_exchange_strong(expected, true, std::memory_order_acquire);
+}
+
+void WorkerPool::parallelFor(size_t count, size_t grain, const Task& task) {
+    if (count == 0) return;
+    grain = resolveGrain(count, grain);
+    if (!tryAcquire(count, grain)) {
+        DenormalScope fp(config_.flush_denormals);
+        task(0, count, t_worker_id);
+        if (fp.takeDenormalFlags()) addDenormalJobs(1);
+        return;
+    }
+    run(count, grain, task);
+}
+
+double WorkerPool::parallelSum(size_t count, size_t grain,
+                               const std::function<double(size_t, size_t)>& task) {
+    if (count == 0) return 0.0;
+    const size_t block = grain > 0 ? grain : std::max<size_t>(1, count / kSumBlocks);
+    const size_t blocks = (count + block - 1) / block;
+    auto run_blocks = [&](double* sums, size_t first, size_t last) {
+        for (size_t b = first; b < last; b++) sums[b] = task(b * block, std::min(count, (b + 1) * block));
+    };
+    const bool compensated = config_.reduction == ReductionMode::Compensated;
+
+    // Inline runs (nested, a second caller, or a single block) keep their
+    // sums on the stack or in a buffer of their own
+    if (!tryAcquire(blocks, 1)) {
+        constexpr size_t kStackBlocks = 64;
+        double stack_sums[kStackBlocks], stack_errors[kStackBlocks];
+        std::vector<double> heap_sums, heap_errors;
+        double* sums = stack_sums;
+        double* errors = stack_errors;
+        if (blocks > kStackBlocks) {
+            heap_sums.resize(blocks);
+            heap_errors.resize(compensated ? blocks : 0);
+            sums = heap_sums.data();
+            errors = heap_errors.data();
+        }
+        DenormalScope fp(config_.flush_denormals);
+        run_blocks(sums, 0, blocks);
+        if (fp.takeDenormalFlags()) addDenormalJobs(1);
+        return treeSum(sums, errors, blocks, config_.reduction);
+    }
+    block_sums_.resize(blocks);
+    block_errors_.resize(compensated ? blocks : 0);
+    double* sums = block_sums_.data();
+    // Each worker claims a few blocks at a time, like parallelFor's grain
+    run(blocks, resolveGrain(blocks, 0), [&](size_t begin, size_t end, unsigned) { run_blocks(sums, begin, end); });
+    return treeSum(sums, block_errors_.data(), blocks, config_.reduction);
+}
+
+// Kept out of registers so -ffast-math cannot fold the error terms to zero
+static double rounded(double value) {
+    volatile double stored = value;
+    return stored;
+}
+
+double WorkerPool::treeSum(double* values, double* errors, size_t n, ReductionMode mode) {
+    if (n == 0) return 0.0;
+    if (mode == ReductionMode::Pairwise) {
+        // Level by level: element i of the next level is 2i + 2i+1 of this
+        // one, and an odd last element moves up unchanged
+        for (; n > 1; n = (n + 1) / 2) {
+            const size_t pairs = n / 2;
+            for (size_t i = 0; i < pairs; i++) values[i] = values[2 * i] + values[2 * i + 1];
+            if (n % 2) values[pairs] = values[n - 1];
+        }
+        return values[0];
+    }
+    // Same tree with Knuth's two-sum at every node; the errors move up
+    // alongside their sums and are added once at the root
+    std::fill(errors, errors + n, 0.0);
+    for (; n > 1; n = (n + 1) / 2) {
+        const size_t pairs = n / 2;
+        for (size_t i = 0; i < pairs; i++) {
+            const double a = values[2 * i];
+            const double b = values[2 * i + 1];
+            const double sum = rounded(a + b);
+            const double b_part = rounded(sum - a);
+            const double error = (a - rounded(sum - b_part)) + (b - b_part);
+            values[i] = sum;
+            errors[i] = errors[2 * i] + errors[2 * i + 1] + error;
+        }
+        if (n % 2) {
+            values[pairs] = values[n - 1];
+            errors[pairs] = errors[n - 1];
+        }
+    }
+    return values[0] + errors[0];
+}
+
+static uint64_t packRange(size_t begin, size_t end) {
+    return static_cast<uint64_t>(begin) << 32 | static_cast<uint64_t>(end);
+}
+
+void WorkerPool::run(size_t count, size_t grain, const Task& task) {
+    task_ = &task;
+    count_ = count;
+    grain_ = grain;
+    error_ = nullptr;
+    cursor_.store(0, std::memory_order_relaxed);
+    // Shares are packed into 32-bit halves; larger jobs use the cursor
+    stealing_ = config_.schedule == JobSchedule::WorkStealing && count <= UINT32_MAX;
+    if (stealing_) {
+        // Contiguous shares in whole chunks, so chunk boundaries match the
+        // shared cursor's and each worker starts on its own cache lines
+        const size_t threads = size();
+        const size_t chunks = (count + grain - 1) / grain;
+        for (size_t w = 0; w < threads; w++) {
+            const size_t begin = std::min(count, chunks * w / threads * grain);
+            const size_t end = std::min(count, chunks * (w + 1) / threads * grain);
+            shares_[w].range.store(packRange(begin, end), std::memory_order_relaxed);
+        }
+    }
+    pending_.store(static_cast<unsigned>(workers_.size()), std::memory_order_relaxed);
+
+    if (config_.wait_policy == WaitPolicy::Sleep) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            generation_.fetch_add(1, std::memory_order_release);
+        }
+        wake_cv_.notify_all();
+    } else {
+        generation_.fetch_add(1, std::memory_order_release);
+    }
+
+    job_denormals_.store(false, std::memory_order_relaxed);
+    {
+        DenormalScope fp(config_.flush_denormals);
+        execute(0);
+        if (fp.takeDenormalFlags()) job_denormals_.store(true, std::memory_order_relaxed);
+    }
+    if (cpu_accounting_.load(std::memory_order_relaxed)) {
+        const uint64_t start = threadCpuNs();
+        waitForCompletion();
+        wait_cpu_ns_.fetch_add(threadCpuNs() - start, std::memory_order_relaxed);
+    } else {
+        waitForCompletion();
+    }
+    if (job_denormals_.load(std::memory_order_relaxed)) addDenormalJobs(1);
+
+    task_ = nullptr;
+    std::exception_ptr error = error_;
+    error_ = nullptr;
+    busy_.store(false, std::memory_order_release);
+    if (error) std::rethrow_exception(error);
+}
+
+void WorkerPool::runChunk(unsigned worker, size_t begin, size_t end) {
+    try {
+        timeline_trace::Scope chunk(timeline_trace::TraceLevel::Chunks, kTraceChunk, begin, end);
+        (*task_)(begin, end, worker);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(error_mutex_);
+        if (!error_) error_ = std::current_exception();
+    }
+}
+
+void WorkerPool::execute(unsigned worker) {
+    if (stealing_) {
+        executeStealing(worker);
+        return;
+    }
+    timeline_trace::Scope job(timeline_trace::TraceLevel::Regions, kTraceJob);
+    uint64_t chunks = 0;
+    for (;;) {
+        const size_t begin = cursor_.fetch_add(grain_, std::memory_order_relaxed);
+        if (begin >= count_) break;
+        const size_t end = std::min(begin + grain_, count_);
+        chunks++;
+        runChunk(worker, begin, end);
+    }
+    job.setArgs(chunks, worker);
+}
+
+// Takes the next chunk off the front of the worker's own share. Only
+// thieves shrinking the back can make the swap fail.
+bool WorkerPool::claim(unsigned worker, size_t& begin, size_t& end) {
+    std::atomic<uint64_t>& range = shares_[worker].range;
+    uint64_t current = range.load(std::memory_order_acquire);
+    for (;;) {
+        const size_t first = static_cast<size_t>(current >> 32);
+        const size_t last = static_cast<size_t>(current & UINT32_MAX);
+        if (first >= last) return false;
+        const size_t next = std::min(first + grain_, last);
+        if (range.compare_exchange_weak(current, packRange(next, last), std::memory_order_acq_rel,
+                                        std::memory_order_acquire)) {
+            begin = first;
+            end = next;
+            return true;
+        }
+    }
+}
+
+// Moves the back half (in whole chunks) of the largest other share into the
+// worker's own, which is empty. A share only ever shrinks until its owner
+// has emptied it, and a refill comes from indices nobody has claimed, so a
+// swap never succeeds against a stale range.
+bool WorkerPool::steal(unsigned worker) {
+    const unsigned threads = size();
+    for (;;) {
+        unsigned victim = threads;
+        size_t largest = 0;
+        for (unsigned k = 1; k < threads; k++) {
+            const unsigned w = (worker + k) % threads;
+            const uint64_t range = shares_[w].range.load(std::memory_order_relaxed);
+            const size_t first = static_cast<size_t>(range >> 32);
+            const size_t last = static_cast<size_t>(range & UINT32_MAX);
+            if (last > first && last - first > largest) {
+                largest = last - first;
+                victim = w;
+            }
+        }
+        // A last chunk in flight is not worth taking from its owner
+        if (victim == threads || largest <= grain_) return false;
+
+        std::atomic<uint64_t>& range = shares_[victim].range;
+        uint64_t current = range.load(std::memory_order_acquire);
+        const size_t first = static_cast<size_t>(current >> 32);
+        const size_t last = static_cast<size_t>(current & UINT32_MAX);
+        if (last <= first || last - first <= grain_) continue;
+        const size_t chunks = (last - first + grain_ - 1) / grain_;
+        const size_t split = first + (chunks + 1) / 2 * grain_;
+        if (split >= last) continue;
+        if (range.compare_exchange_strong(current, packRange(first, split), std::memory_order_acq_rel,
+                                          std::memory_order_acquire)) {
+            shares_[worker].range.store(packRange(split, last), std::memory_order_release);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+}
+
+void WorkerPool::executeStealing(unsigned worker) {
+    timeline_trace::Scope job(timeline_trace::TraceLevel::Regions, kTraceJob);
+    uint64_t chunks = 0;
+    size_t begin = 0, end = 0;
+    do {
+        while (claim(worker, begin, end)) {
+            chunks++;
+            runChunk(worker, begin, end);
+        }
+    } while (steal(worker));
+    job.setArgs(chunks, worker);
+}
+
+void WorkerPool::workerLoop(unsigned worker) {
+    t_worker_id = worker;
+    timeline_trace::setThreadName("dase worker " + std::to_string(worker));
+    void* profile = enterProfile(worker);
+    // The worker's mode is set once for its lifetime; the flags are read
+    // after each job
+    DenormalScope fp(config_.flush_denormals);
+    uint64_t seen = 0;
+    for (;;) {
+        waitForJob(seen);
+        if (stop_.load(std::memory_order_acquire)) break;
+        seen = generation_.load(std::memory_order_acquire);
+
+        if (cpu_accounting_.load(std::memory_order_relaxed)) {
+            // Published to the caller by the pending_ release below
+            const uint64_t start = threadCpuNs();
+            execute(worker);
+            job_cpu_ns_.fetch_add(threadCpuNs() - start, std::memory_order_relaxed);
+        } else {
+            execute(worker);
+        }
+        if (fp.takeDenormalFlags()) job_denormals_.store(true, std::memory_order_relaxed);
+
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1 &&
+            config_.wait_policy == WaitPolicy::Sleep) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            done_cv_.notify_one();
+        }
+    }
+    leaveProfile(profile);
+}
+
+void WorkerPool::waitForJob(uint64_t seen) {
+    auto ready = [&] {
+        return generation_.load(std::memory_order_acquire) != seen ||
+               stop_.load(std::memory_order_acquire);
+    };
+    if (config_.wait_policy == WaitPolicy::Spin) {
+        while (!ready()) DASE_CPU_RELAX();
+        return;
+    }
+    for (uint32_t spin = 0; spin < config_.spin_iterations; spin++) {
+        if (ready()) return;
+        DASE_CPU_RELAX();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    wake_cv_.wait(lock, ready);
+}
+
+void WorkerPool::waitForCompletion() {
+    auto done = [&] { return pending_.load(std::memory_order_acquire) == 0; };
+    if (config_.wait_policy == WaitPolicy::Spin) {
+        while (!done()) DASE_CPU_RELAX();
+        return;
+    }
+    for (uint32_t spin = 0; spin < config_.spin_iterations; spin++) {
+        if (done()) return;
+        DASE_CPU_RELAX();
+    }
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, done);
+}
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// How idle workers wait for the next job
+enum class WaitPolicy {
+    Spin = 0,   // Busy-wait with pause; lowest wake latency, burns the core
+    Sleep = 1   // Spin briefly, then block on a condition variable
+};
+
+// How the chunks of a job reach the workers
+enum class JobSchedule {
+    SharedCursor = 0,  // Every chunk claimed from one shared atomic cursor
+    WorkStealing = 1   // Per-worker ranges; idle workers steal half of a busy one's
+};
+
+// How parallelSum combines its block partials
+enum class ReductionMode {
+    Pairwise = 0,     // Fixed binary tree
+    Compensated = 1   // Same tree, carrying each addition's rounding error
+};
+
+// Worker pool configuration. A zero num_threads means one thread per online
+// CPU that is not reserved. The calling thread always takes part in a job, so
+// the pool starts num_threads - 1 background workers; the caller is never
+// re-pinned. Without an explicit cpu_affinity, workers are confined to the
+// CPUs left after removing reserved_cpus.
+struct WorkerPoolConfig {
+    unsigned num_threads = 0;
+    std::vector<int> cpu_affinity;   // Background worker k pinned to cpu_affinity[(k - 1) % size]
+    std::vector<int> reserved_cpus;  // CPUs kept free for other threads (e.g. audio I/O)
+    WaitPolicy wait_policy = WaitPolicy::Sleep;
+    uint32_t spin_iterations = 20000; // Pause iterations before a Sleep worker blocks
+    JobSchedule schedule = JobSchedule::WorkStealing;
+    ReductionMode reduction = ReductionMode::Pairwise;
+    bool flush_denormals = true;      // Jobs run with FTZ/DAZ set (see DenormalScope)
+    // Real-time profile of the background workers, opt-in. Windows: each
+    // joins the MMCSS "Pro Audio" task at AVRT_PRIORITY_HIGH with power
+    // throttling off, and the system timer runs at 1 ms while the pool
+    // lives. Linux: each runs SCHED_FIFO at realtime_priority with 1 ns
+    // timer slack; with the Spin policy, give them CPUs of their own. Steps
+    // the process is not allowed are skipped; threadStatus() tells.
+    bool realtime = false;
+    int realtime_priority = 0;        // Linux SCHED_FIFO priority 1-99 (0: 70)
+};
+
+// Scheduling one background worker ended up with
+struct WorkerThreadStatus {
+    unsigned worker = 0;              // Pool worker id, from 1
+    bool realtime = false;            // In the MMCSS task (Windows) or SCHED_FIFO (Linux)
+    int priority = 0;                 // AVRT_PRIORITY (Windows) or SCHED_FIFO priority (Linux)
+    uint32_t mmcss_task = 0;          // MMCSS task index (Windows)
+    uint64_t timer_resolution_ns = 0; // System timer period (Windows, 0 when not raised) or the
+                                      // thread's timer slack (Linux, 0 under SCHED_FIFO)
+    bool power_throttling_disabled = false;  // Execution-speed throttling off (Windows)
+    int error = 0;                    // GetLastError or errno of the first step that failed
+};
+
+// Where one CPU sits in the machine. Read from sysfs on Linux; elsewhere
+// every CPU counts as its own core on package and node 0.
+struct CpuLocation {
+    int cpu = 0;
+    int core = 0;       // Core id within the package; SMT siblings share it
+    int package = 0;
+    int numa_node = 0;
+    int smt_index = 0;  // Rank among the core's siblings, 0 for the first
+};
+
+// Data cache sizes seen by one CPU, in bytes; 0 where unknown (sysfs on
+// Linux only). llc is the largest unified cache, shared by the CPUs of its
+// package or cluster.
+struct CpuCaches {
+    size_t l1d = 0;
+    size_t l2 = 0;
+    size_t llc = 0;
+};
+
+// Pins the calling thread to one CPU while in scope and restores its
+// previous affinity afterwards (Linux and Windows; no effect elsewhere or
+// for a negative cpu).
+class ScopedThreadAffinity {
+public:
+    explicit ScopedThreadAffinity(int cpu);
+    ~ScopedThreadAffinity();
+
+    ScopedThreadAffinity(const ScopedThreadAffinity&) = delete;
+    ScopedThreadAffinity& operator=(const ScopedThreadAffinity&) = delete;
+
+private:
+    bool pinned_ = false;
+    std::vector<int> previous_;
+};
+
+// Persistent worker pool owned by the engine.
+//
+// Workers are started once and parked between jobs, so sweeps pay neither a
+// fork/join nor thread-count changes per call. A job is an index range split
+// into grain-sized chunks. Under WorkStealing each worker starts on its own
+// contiguous share of the range and claims chunks from its front with a
+// compare-and-swap on a cache line no other worker touches while it has
+// work; a worker that runs dry steals the back half of the largest
+// remaining share and carries on there, so the split adapts to skewed chunk
+// costs and uniform jobs run with no shared-line traffic at all. Under
+// SharedCursor every chunk is claimed from one atomic cursor. Jobs issued
+// while another job is running (from a task or a second thread) run inline
+// on the caller.
+class WorkerPool {
+public:
+    // task(begin, end, worker) processes indices [begin, end); worker is a
+    // stable id in [0, size()) with 0 being the calling thread.
+    using Task = std::function<void(size_t, size_t, unsigned)>;
+
+    explicit WorkerPool(const WorkerPoolConfig& config = WorkerPoolConfig());
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    // Runs task over [0, count). grain 0 picks a chunk size from the pool size.
+    // The first exception thrown by a task is rethrown here after the job ends.
+    void parallelFor(size_t count, size_t grain, const Task& task);
+
+    // parallelFor whose chunks each return a partial sum. The range is cut
+    // into blocks of grain indices (grain 0: count / kSumBlocks, at least 1)
+    // whatever the pool size, task runs once per block, and the block sums
+    // are combined in a fixed pairwise tree, so the total is bit-identical
+    // for any thread count, schedule or inline run.
+    double parallelSum(size_t count, size_t grain, const std::function<double(size_t, size_t)>& task);
+
+    // Blocks a parallelSum with grain 0 is cut into
+    static constexpr size_t kSumBlocks = 1024;
+    // Sum of values[0, n) in parallelSum's tree order; overwrites values
+    // (and errors, for the compensated mode, which needs n entries there)
+    static double treeSum(double* values, double* errors, size_t n, ReductionMode mode);
+
+    unsigned size() const { return static_cast<unsigned>(workers_.size()) + 1; }
+    const WorkerPoolConfig& config() const { return config_; }
+
+    // CPUs the workers may run on after removing reserved_cpus
+    static std::vector<int> availableCpus(const std::vector<int>& reserved_cpus);
+    // Ranges taken from other workers since the pool started
+    uint64_t steals() const { return steals_.load(std::memory_order_relaxed); }
+    // Jobs (parallel or inline) in which some thread underflowed into the
+    // subnormal range, a sign of state decaying toward zero
+    uint64_t denormalJobs() const { return denormal_jobs_.load(std::memory_order_relaxed); }
+    // Scheduling of each background worker, worker 1 first
+    std::vector<WorkerThreadStatus> threadStatus() const;
+    // CPU time of the calling thread, ns, from its CPU clock (Linux and
+    // Windows; 0 elsewhere). Spinning waits count as CPU time.
+    static uint64_t threadCpuNs();
+    // With CPU accounting on, the pool reads the thread CPU clock around
+    // each thread's share of a job. jobCpuNs() sums the background workers'
+    // shares and waitCpuNs() the CPU the calling thread spent waiting for
+    // them, so neither idle spinning nor the wait is charged to the work.
+    // Off by default: it costs two clock reads per thread and job.
+    void setCpuAccounting(bool enabled) { cpu_accounting_.store(enabled, std::memory_order_relaxed); }
+    bool cpuAccounting() const { return cpu_accounting_.load(std::memory_order_relaxed); }
+    uint64_t jobCpuNs() const { return job_cpu_ns_.load(std::memory_order_relaxed); }
+    uint64_t waitCpuNs() const { return wait_cpu_ns_.load(std::memory_order_relaxed); }
+    // For work run outside the pool under its own DenormalScope
+    void addDenormalJobs(uint64_t jobs) { denormal_jobs_.fetch_add(jobs, std::memory_order_relaxed); }
+
+    // Core, package and NUMA node of each of cpus, in the same order
+    static std::vector<CpuLocation> cpuTopology(const std::vector<int>& cpus);
+    static CpuCaches cpuCaches(int cpu = 0);
+
+private:
+    // A worker's remaining share [begin, end) packed as begin << 32 | end
+    struct alignas(64) Share {
+        std::atomic<uint64_t> range{0};
+    };
+
+    size_t resolveGrain(size_t count, size_t grain) const;
+    bool tryAcquire(size_t count, size_t grain);
+    void run(size_t count, size_t grain, const Task& task);
+    void workerLoop(unsigned worker);
+    void execute(unsigned worker);
+    void executeStealing(unsigned worker);
+    bool claim(unsigned worker, size_t& begin, size_t& end);
+    bool steal(unsigned worker);
+    void runChunk(unsigned worker, size_t begin, size_t end);
+    void waitForJob(uint64_t seen);
+    void waitForCompletion();
+    void pinWorker(std::thread& thread, unsigned worker);
+    void* enterProfile(unsigned worker);
+    void leaveProfile(void* handle);
+
+    WorkerPoolConfig config_;
+    std::vector<std::thread> workers_;
+    std::vector<int> allowed_cpus_;
+    std::unique_ptr<Share[]> shares_;  // One per worker
+    std::vector<double> block_sums_;   // parallelSum blocks of the running job
+    std::vector<double> block_errors_;
+
+    // Current job
+    const Task* task_ = nullptr;
+    size_t count_ = 0;
+    size_t grain_ = 1;
+    bool stealing_ = false;  // Job runs on shares_ instead of cursor_
+    alignas(64) std::atomic<size_t> cursor_{0};
+    alignas(64) std::atomic<unsigned> pending_{0};
+    alignas(64) std::atomic<uint64_t> generation_{0};
+    std::atomic<bool> busy_{false};
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> steals_{0};
+    std::atomic<uint64_t> denormal_jobs_{0};
+    std::atomic<bool> job_denormals_{false};  // Set by any thread of the running job
+    std::atomic<bool> cpu_accounting_{false};
+    std::atomic<uint64_t> job_cpu_ns_{0};
+    std::atomic<uint64_t> wait_cpu_ns_{0};
+    std::exception_ptr error_;
+    std::mutex error_mutex_;
+
+    // Filled by each worker as it starts; the constructor waits for all
+    std::vector<WorkerThreadStatus> thread_status_;
+    size_t profiled_ = 0;
+    mutable std::mutex status_mutex_;
+    std::condition_variable status_cv_;
+    bool timer_period_set_ = false;   // timeBeginPeriod(1) (Windows realtime)
+
+    // Sleep-policy parking
+    std::mutex mutex_;
+    std::condition_variable wake_cv_;
+    std::condition_variable done_cv_;
+};
@@ -21,7 +21,7 @@ from queue import Queue, Empty
 from typing import Optional, Callable, Dict
 import traceback
 
-from .chromatic_field_processor import ChromaticFieldProcessor
+from .chromatic_field_processor import ChromaticFieldProcessor, DASE_AVAILABLE
 from .phi_modulator_controller import PhiModulatorController
 from .downmix import StereoDownmixer
 from .latency_manager import LatencyManager
@@ -56,7 +56,8 @@ class AudioServer:
     def __init__(self,
                  input_device: Optional[int] = None,
                  output_device: Optional[int] = None,
-                 enable_logging: bool = True):
+                 enable_logging: bool = True,
+                 use_native_host: bool = True):
         """
         Initialize audio server
 
@@ -64,6 +65,9 @@ class AudioServer:
             input_device: Input device index (None = default)
             output_device: Output device index (None = default)
             enable_logging: Enable metrics/latency logging
+            use_native_host: Run the audio path in dase_engine.NativeAudioHost
+                when the extension is built with PortAudio, instead of the
+                sounddevice callback
         """
         print("=" * 60)
         print("AudioServer Initialization")
@@ -77,6 +81,14 @@ class AudioServer:
         self.stream: Optional[sd.Stream] = None
         self.is_running = False
 
+        # Native audio host: the device callback runs engine, downmix and
+        # compensation without the interpreter; a control thread feeds it Φ
+        # and turns its frames into metrics
+        self.use_native_host = use_native_host and self._native_host_available()
+        self.native_host = None
+        self._control_thread: Optional[threading.Thread] = None
+        self._control_stop = threading.Event()
+
         # Processing components
         print("\n[AudioServer] Initializing processing components...")
 
@@ -203,59 +215,63 @@ class AudioServer:
             cpu_load = processing_time_ms / buffer_duration_ms
             latency_frame.cpu_load = cpu_load
 
-            # --- Publish Metrics (at target rate) ---
-            time_since_metrics = callback_time - self.last_metrics_time
-            metrics_interval = 1.0 / self.TARGET_METRICS_FPS
+            self._publish_frames(metrics_frame, latency_frame, callback_time)
 
-            if time_since_metrics >= metrics_interval:
-                # Try to enqueue metrics (non-blocking)
-                try:
-                    self.metrics_queue.put_nowait(metrics_frame)
+            self.callback_count += 1
 
-                    # Call external callback if set
-                    if self.metrics_callback:
-                        self.metrics_callback(metrics_frame)
+            # Warn if processing time exceeds threshold (80% of buffer duration)
+            if processing_time_ms > buffer_duration_ms * 0.8:
+                print(f"[AudioServer] WARNING: High CPU load: {processing_time_ms:.2f} ms / {buffer_duration_ms:.2f} ms ({cpu_load*100:.1f}%)")
 
-                    # Log to file
-                    if self.metrics_logger:
-                        self.metrics_logger.log_frame(metrics_frame)
+        except Exception as e:
+            print(f"[AudioServer] ERROR in audio callback: {e}")
+            traceback.print_exc()
+            # Fill output with silence on error
+            outdata.fill(0)
 
-                    self.last_metrics_time = callback_time
+    def _publish_frames(self, metrics_frame: MetricsFrame, latency_frame: LatencyFrame, callback_time: float):
+        """Hand metrics (at the target rate) and latency frames (at 10 Hz) to their consumers"""
+        # --- Publish Metrics (at target rate) ---
+        time_since_metrics = callback_time - self.last_metrics_time
+        metrics_interval = 1.0 / self.TARGET_METRICS_FPS
 
-                except:
-                    pass  # Queue full, skip this frame
+        if time_since_metrics >= metrics_interval:
+            # Try to enqueue metrics (non-blocking)
+            try:
+                self.metrics_queue.put_nowait(metrics_frame)
 
-            # --- Publish Latency Updates (every 100ms) ---
-            time_since_latency = callback_time - self.last_latency_update
+                # Call external callback if set
+                if self.metrics_callback:
+                    self.metrics_callback(metrics_frame)
 
-            if time_since_latency >= 0.1:  # 10 Hz
-                try:
-                    self.latency_queue.put_nowait(latency_frame)
+                # Log to file
+                if self.metrics_logger:
+                    self.metrics_logger.log_frame(metrics_frame)
 
-                    # Call external callback if set
-                    if self.latency_callback:
-                        self.latency_callback(latency_frame)
+                self.last_metrics_time = callback_time
 
-                    # Log to file
-                    if self.latency_logger:
-                        self.latency_logger.log_frame(latency_frame)
+            except:
+                pass  # Queue full, skip this frame
 
-                    self.last_latency_update = callback_time
+        # --- Publish Latency Updates (every 100ms) ---
+        time_since_latency = callback_time - self.last_latency_update
 
-                except:
-                    pass  # Queue full, skip this frame
+        if time_since_latency >= 0.1:  # 10 Hz
+            try:
+                self.latency_queue.put_nowait(latency_frame)
 
-            self.callback_count += 1
+                # Call external callback if set
+                if self.latency_callback:
+                    self.latency_callback(latency_frame)
 
-            # Warn if processing time exceeds threshold (80% of buffer duration)
-            if processing_time_ms > buffer_duration_ms * 0.8:
-                print(f"[AudioServer] WARNING: High CPU load: {processing_time_ms:.2f} ms / {buffer_duration_ms:.2f} ms ({cpu_load*100:.1f}%)")
+                # Log to file
+                if self.latency_logger:
+                    self.latency_logger.log_frame(latency_frame)
 
-        except Exception as e:
-            print(f"[AudioServer] ERROR in audio callback: {e}")
-            traceback.print_exc()
-            # Fill output with silence on error
-            outdata.fill(0)
+                self.last_latency_update = callback_time
+
+            except:
+                pass  # Queue full, skip this frame
 
     def _create_metrics_frame(self, metrics_dict: Dict, phi_state, timestamp: float) -> MetricsFrame:
         """
@@ -286,6 +302,15 @@ class AudioServer:
         frame.phi_depth = getattr(phi_state, 'depth', frame.phi_depth)
         frame.phi_source = getattr(phi_state, 'source', frame.phi_source)
 
+        # Per-channel pitch for the chromatic visualizer (main.py reads
+        # spectral_analysis); kept off the serialized schema
+        pitch = self.processor.getPitchAnalysis()
+        if pitch is not None:
+            frame.spectral_analysis = {
+                'channel_centroids': pitch['channel_pitch'],
+                'chroma': pitch['chroma']
+            }
+
         # Classify state based on metrics
         frame.state = frame.classify_state()
 
@@ -327,6 +352,9 @@ class AudioServer:
                         'quality': latency_frame.calibration_quality
                     })
 
+        if self.use_native_host:
+            return self._start_native_host()
+
         try:
             # Create audio stream
             print(f"\n[AudioServer] Opening audio stream...")
@@ -365,6 +393,144 @@ class AudioServer:
             traceback.print_exc()
             return False
 
+    @staticmethod
+    def _native_host_available() -> bool:
+        """Whether the extension has a NativeAudioHost with a device backend"""
+        if not DASE_AVAILABLE:
+            return False
+        import dase_engine
+        if not hasattr(dase_engine, 'NativeAudioHost'):
+            return False
+        return dase_engine.NativeAudioHost.backend_available(dase_engine.AudioHostBackend.PORTAUDIO)
+
+    def _start_native_host(self) -> bool:
+        """Open the device through NativeAudioHost and start its control thread"""
+        import dase_engine
+
+        try:
+            print(f"\n[AudioServer] Opening native audio host...")
+            print(f"[AudioServer]   Sample rate: {self.SAMPLE_RATE} Hz")
+            print(f"[AudioServer]   Buffer size: {self.BUFFER_SIZE} samples")
+
+            config = dase_engine.AudioHostConfig()
+            config.backend = dase_engine.AudioHostBackend.PORTAUDIO
+            config.sample_rate = float(self.SAMPLE_RATE)
+            config.block_size = self.BUFFER_SIZE
+            config.input_device = -1 if self.input_device is None else self.input_device
+            config.output_device = -1 if self.output_device is None else self.output_device
+            config.input_channels = self.INPUT_CHANNELS
+            config.output_channels = self.OUTPUT_CHANNELS
+            config.num_channels = self.processor.num_channels
+
+            self.native_host = dase_engine.NativeAudioHost(self.processor.engine, config)
+            if getattr(self.processor, 'phase_lock', None) is not None:
+                self.native_host.automation.set_phase_lock(self.processor.phase_lock)
+            self._push_native_controls()
+            self.native_host.start()
+
+            self.callback_count = 0
+            self.last_metrics_time = time.time()
+            self.last_latency_update = time.time()
+            self.processing_time_history = []
+            self._native_phi = (None, None)
+
+            self._control_stop.clear()
+            self._control_thread = threading.Thread(target=self._native_control_loop,
+                                                    name="AudioServerControl", daemon=True)
+            self._control_thread.start()
+            self.is_running = True
+
+            print(f"[AudioServer]   Device latency: {self.native_host.input_latency * 1000.0:.2f} ms in, "
+                  f"{self.native_host.output_latency * 1000.0:.2f} ms out")
+            print("[AudioServer] ✓ Native audio host started")
+            return True
+
+        except Exception as e:
+            print(f"[AudioServer] ✗ Failed to start native audio host: {e}")
+            traceback.print_exc()
+            self.native_host = None
+            return False
+
+    def _stop_native_host(self):
+        """Stop the control thread, then the device"""
+        self._control_stop.set()
+        if self._control_thread is not None:
+            self._control_thread.join(timeout=1.0)
+            self._control_thread = None
+        self.native_host.stop()
+        self.native_host = None
+
+    def _push_native_controls(self):
+        """Hand the downmix weights and latency compensation to the native callback"""
+        host = self.native_host
+        if host is None:
+            return
+        gain = self.downmixer.gain / self.downmixer.normalization
+        host.set_downmix(self.downmixer.left_weights.tolist(), self.downmixer.right_weights.tolist(), gain)
+        if self.latency_manager.is_calibrated:
+            host.set_compensation_delay(self.latency_manager.delay_line.current_delay_samples)
+
+    def _native_control_loop(self):
+        """
+        Control side of the native host, at the metrics rate: schedules Φ on
+        the host's automation and turns the callbacks it ran since the last
+        pass into metrics and latency frames
+        """
+        import dase_engine
+
+        interval = 1.0 / self.TARGET_METRICS_FPS
+        buffer_duration_ms = (self.BUFFER_SIZE / self.SAMPLE_RATE) * 1000.0
+        automation = self.native_host.automation
+
+        while not self._control_stop.wait(interval):
+            try:
+                now = time.time()
+
+                # Φ at control rate; the callback applies it sample-accurately
+                phi_state = self.phi_controller.update()
+                last_phase, last_depth = self._native_phi
+                if phi_state.phase != last_phase and automation.schedule(dase_engine.ParameterId.PHI_PHASE,
+                                                                         float(phi_state.phase)):
+                    last_phase = phi_state.phase
+                if phi_state.depth != last_depth and automation.schedule(dase_engine.ParameterId.PHI_DEPTH,
+                                                                         float(phi_state.depth)):
+                    last_depth = phi_state.depth
+                self._native_phi = (last_phase, last_depth)
+
+                frames = self.native_host.drain_frames()
+                if not frames:
+                    continue
+                for frame in frames:
+                    if frame.underflow or frame.overflow:
+                        print(f"[AudioServer] Stream status: underflow={frame.underflow} overflow={frame.overflow}")
+                    self.processing_time_history.append(frame.processing_ns / 1e6)
+                self.processing_time_history = self.processing_time_history[-100:]
+                self.callback_count += len(frames)
+                self.latency_manager.update_timing(now)
+
+                # Analysis runs here, on the latest block the engine published
+                block = self.processor.getLatestBlock()
+                if block is not None:
+                    self.processor._updateMetrics(block[1])
+                metrics_dict = self.processor.getMetrics()
+                metrics_dict['cpu_load'] = frames[-1].load
+                metrics_dict['frame_id'] = frames[-1].callback
+
+                metrics_frame = self._create_metrics_frame(metrics_dict, phi_state, now)
+                latency_frame = self.latency_manager.get_current_frame()
+                latency_frame.timestamp = now
+                latency_frame.cpu_load = max(frame.load for frame in frames)
+
+                self._publish_frames(metrics_frame, latency_frame, now)
+
+                worst_ms = max(frame.processing_ns for frame in frames) / 1e6
+                if worst_ms > buffer_duration_ms * 0.8:
+                    print(f"[AudioServer] WARNING: High CPU load: {worst_ms:.2f} ms / {buffer_duration_ms:.2f} ms")
+
+            except Exception as e:
+                print(f"[AudioServer] ERROR in native control loop: {e}")
+                traceback.print_exc()
+
     def stop(self):
         """Stop audio server"""
         if not self.is_running:
@@ -374,6 +540,10 @@ class AudioServer:
         print("\n[AudioServer] Stopping audio server...")
 
         try:
+            # Stop native host and its control thread
+            if self.native_host is not None:
+                self._stop_native_host()
+
             # Stop stream
             if self.stream:
                 self.stream.stop()
@@ -473,6 +643,14 @@ class AudioServer:
                 if 'coupling_strength' in engine:
                     self.processor.coupling_strength = engine['coupling_strength']
 
+                if 'feedback' in engine:
+                    # Swapped in at a block boundary with a one-block glide,
+                    # or through the processor's parameter queue, so the
+                    # audio callback never sees a half-applied change
+                    feedback = float(engine['feedback'])
+                    if not self.processor.switch_node_parameters({'feedback': feedback}):
+                        self.processor.schedule_parameter('feedback', feedback)
+
             # Update Φ parameters
             if 'phi' in preset_data:
                 phi = preset_data['phi']
@@ -502,6 +680,8 @@ class AudioServer:
                 if 'weights_r' in downmix:
                     self.downmixer.set_weights('R', np.array(downmix['weights_r']))
 
+            self._push_native_controls()
+
             self.current_preset = preset_data
             print("[AudioServer] ✓ Preset applied")
 
@@ -580,6 +760,11 @@ class AudioServer:
                     self.processor.coupling_strength = float(value)
                     return True
 
+                elif param_name == 'feedback':
+                    # Node feedback of the engine, applied by the audio
+                    # callback at its next block
+                    return self.processor.schedule_parameter('feedback', float(value))
+
                 elif param_name == 'gain':
                     # Overall output gain (applied to downmixer)
                     if not hasattr(self.downmixer, 'gain'):
@@ -0,0 +1,114 @@
+"""
+Batch preset rendering through the native dase_batch_render scheduler
+
+Writes a job manifest (preset x input) from saved Presets and runs it in one
+native call, instead of one Python-driven replay per pair. Each preset maps
+to num_channels, Φ depth and phase and the downmix weights; engine coupling
+has no per-preset counterpart in the offline render and is not carried over.
+"""
+
+import os
+import re
+import sys
+from typing import Dict, List, Optional, Sequence, Tuple
+
+from .preset_model import Preset
+
+# Add sase amp fixed to path to import dase_engine
+DASE_PATH = os.path.join(os.path.dirname(__file__), '..', 'sase amp fixed')
+if DASE_PATH not in sys.path:
+    sys.path.insert(0, DASE_PATH)
+
+try:
+    import dase_engine
+    DASE_AVAILABLE = hasattr(dase_engine, "batch_render")
+except ImportError:
+    DASE_AVAILABLE = False
+
+
+def _manifest_name(name: str, taken: Dict[str, int]) -> str:
+    """Single-word name for the manifest, unique among those already taken"""
+    base = re.sub(r'\W+', '_', name).strip('_') or 'unnamed'
+    count = taken.get(base, 0)
+    taken[base] = count + 1
+    return base if count == 0 else f"{base}_{count + 1}"
+
+
+def _weights(values: Sequence[float]) -> str:
+    return ",".join(repr(float(v)) for v in values)
+
+
+def preset_line(name: str, preset: Preset) -> str:
+    """Manifest line of one preset"""
+    line = (f"preset {name} channels={preset.engine.num_channels} "
+            f"phi_depth={preset.phi.depth!r} phi_phase={preset.phi.phase!r}")
+    weights_l, weights_r = preset.downmix.weights_l, preset.downmix.weights_r
+    if len(weights_l) == preset.engine.num_channels and len(weights_r) == preset.engine.num_channels:
+        line += f" mix_l={_weights(weights_l)} mix_r={_weights(weights_r)}"
+    return line
+
+
+def build_manifest(presets: Sequence[Preset], inputs: Sequence[str],
+                   jobs: Optional[Sequence[Tuple[int, int]]] = None) -> Tuple[str, List[str], List[str]]:
+    """
+    Manifest text for rendering presets over input WAV files
+
+    Args:
+        presets: Presets to render
+        inputs: Paths of the input WAV files
+        jobs: (preset index, input index) pairs; None renders every preset
+            over every input
+
+    Returns:
+        (manifest text, preset names, input names) in manifest order
+    """
+    taken: Dict[str, int] = {}
+    preset_names = [_manifest_name(p.name, taken) for p in presets]
+    taken = {}
+    input_names = [_manifest_name(os.path.splitext(os.path.basename(path))[0], taken) for path in inputs]
+
+    lines = ["# Generated by server/batch_render.py"]
+    lines += [preset_line(name, preset) for name, preset in zip(preset_names, presets)]
+    for name, path in zip(input_names, inputs):
+        if re.search(r'\s', path):
+            raise ValueError(f"input path must not contain whitespace: {path!r}")
+        lines.append(f"input {name} {path}")
+    for p, i in jobs or []:
+        lines.append(f"job {preset_names[p]} {input_names[i]}")
+    return "\n".join(lines) + "\n", preset_names, input_names
+
+
+def render_presets(presets: Sequence[Preset], inputs: Sequence[str], results_path: str,
+                   jobs: Optional[Sequence[Tuple[int, int]]] = None, render_dir: str = "",
+                   nodes: int = 1024, block_size: int = 512, num_threads: int = 0) -> Optional[Dict]:
+    """
+    Render presets over inputs natively, one row of metrics per job
+
+    The results go to a session file at results_path (open it with
+    dase_engine.SessionStore or SessionComparator); with render_dir set, each
+    job's audio is kept there as PRESET__INPUT.wav.
+
+    Returns:
+        Dict with the batch stats and the manifest's preset and input names,
+        or None without the native engine
+    """
+    if not DASE_AVAILABLE:
+        return None
+    text, preset_names, input_names = build_manifest(presets, inputs, jobs)
+    manifest = dase_engine.BatchRenderManifest.parse(text)
+    config = dase_engine.BatchRenderConfig()
+    config.nodes = nodes
+    config.block_size = block_size
+    config.render_dir = render_dir
+    config.workers.num_threads = num_threads
+    stats = dase_engine.batch_render(manifest, results_path, config)
+    return {
+        "jobs": stats.jobs,
+        "threads": stats.threads,
+        "audio_seconds": stats.audio_seconds,
+        "seconds": stats.seconds,
+        "jobs_per_second": stats.jobs_per_second,
+        "realtime_factor": stats.realtime_factor,
+        "presets": preset_names,
+        "inputs": input_names,
+    }
@@ -74,6 +74,31 @@ class ChromaticFieldProcessor:
             'consciousness_level': 0.0
         }
 
+        # Output level statistics accumulated inside the engine's node
+        # kernels, so _updateMetrics needs no extra pass over the block
+        self.native_block_stats = hasattr(self.engine, 'set_block_stats')
+        if self.native_block_stats:
+            self.engine.set_block_stats(True)
+            self.last_metrics.update({
+                'output_mean': 0.0,
+                'output_rms': 0.0,
+                'output_peak': 0.0,
+                'output_variance': 0.0
+            })
+
+        # Constant-Q pitch analysis of every output channel, one chroma
+        # vector per block (getPitchAnalysis); its lowest octave resolves
+        # semitones where block-sized FFT centroids cannot
+        self.chroma_analyzer = None
+        self.last_chroma = np.zeros(12)
+        self.last_channel_pitch = np.zeros(self.num_channels)
+        if hasattr(dase_engine, 'ChromaAnalyzer'):
+            chroma_config = dase_engine.ChromaConfig()
+            chroma_config.sample_rate = float(self.sample_rate)
+            chroma_config.channels = self.num_channels
+            chroma_config.hop_size = self.block_size
+            self.chroma_analyzer = dase_engine.ChromaAnalyzer(chroma_config)
+
         # Performance tracking
         self.process_time_history = []
         self.max_history_length = 100
@@ -81,6 +106,64 @@ class ChromaticFieldProcessor:
         # Multi-channel output buffer [channels, samples]
         self.output_buffer = np.zeros((self.num_channels, self.block_size), dtype=np.float32)
 
+        # Node state and block scratch in one region reserved up front, so
+        # blocks allocate nothing (outputs already go into output_buffer)
+        if hasattr(self.engine, 'reserve_arena'):
+            arena = dase_engine.EngineArenaConfig()
+            arena.max_block = max(self.block_size, 4096)
+            arena.max_channels = self.num_channels
+            arena.output_block = False
+            self.engine.reserve_arena(arena)
+
+        # Native re-blocking for processChunk (one block of latency)
+        self.stream = dase_engine.ChromaticStream(
+            self.engine, self.block_size, self.num_channels, sample_rate=self.sample_rate
+        )
+        self._stream_blocks = 0
+
+        # Every engine block is timed natively against its real-time budget
+        if hasattr(self.engine, 'configure_deadline_watchdog'):
+            self.engine.configure_deadline_watchdog(sample_rate=self.sample_rate)
+
+        # Every chromatic block is also published through a lock-free triple
+        # buffer, so a visualizer thread takes the latest one (getLatestBlock)
+        # without a lock on the audio path or a copy
+        self.publisher = None
+        if hasattr(self.engine, 'set_output_publishing'):
+            self.engine.set_output_publishing(True, max(self.block_size, 4096), self.num_channels)
+            self.publisher = self.engine.output_publisher
+
+        # Parameter changes from control threads reach the engine through a
+        # lock-free queue that the audio call drains: Φ phase and depth glide
+        # in sample-accurately, feedback lands at the next block
+        self.automation = None
+        if hasattr(dase_engine, 'ParameterAutomation'):
+            self.automation = dase_engine.ParameterAutomation(max_block=max(self.block_size, 4096))
+            self.stream.set_automation(self.automation)
+        self._scheduled_phi = (0.0, 0.5)  # The automation's starting values
+
+        # Preset changes of the node parameters are staged off the audio
+        # thread and swapped in at a block boundary, gliding over a crossfade
+        self.parameter_switch = None
+        if self.automation is not None and hasattr(dase_engine, 'ParameterSwitch'):
+            self.parameter_switch = dase_engine.ParameterSwitch(self.num_nodes)
+            self.automation.set_parameter_switch(self.parameter_switch)
+
+        # Cluster Φ phase alignment: NodeSynchronizer and PhaseNet push the
+        # reference node's phase into this loop, which corrects every block's
+        # phase curve in the audio call; with no estimates it leaves it alone
+        self.phase_lock = None
+        if self.automation is not None and hasattr(dase_engine, 'PhaseLockLoop'):
+            lock_config = dase_engine.PhaseLockConfig()
+            lock_config.sample_rate = float(self.sample_rate)
+            self.phase_lock = dase_engine.PhaseLockLoop(lock_config)
+            self.automation.set_phase_lock(self.phase_lock)
+
+        # Native Prometheus endpoint (start_metrics_endpoint), off by default
+        self.metrics_endpoint = None
+        # Native flight recorder of block timings (start_flight_recorder)
+        self.flight_recorder = None
+
         # Initialize ICI Engine (Feature 014)
         ici_config = ICIConfig(
             num_channels=self.num_channels,
@@ -120,40 +203,28 @@ class ChromaticFieldProcessor:
         if input_block.dtype != np.float32:
             input_block = input_block.astype(np.float32)
 
-        # Generate Φ-modulation envelope
-        modulation = self._generatePhiModulation(phi_phase, phi_depth)
-
-        # Process through each channel group (8 channels)
-        for ch_idx in range(self.num_channels):
-            # Calculate node range for this channel
-            node_start = ch_idx * self.num_channels
-            node_end = node_start + self.num_channels
-
-            # Process block through cellular engine for this channel group
-            # Apply Φ-rotated modulation for each channel
-            channel_phase_offset = ch_idx * self.PHI_INV * 2 * np.pi
-            channel_mod = np.roll(modulation, int(channel_phase_offset * self.block_size / (2*np.pi)))
-
-            # Process each sample in the block
-            for sample_idx in range(self.block_size):
-                # Input signal modulated by Φ-envelope
-                modulated_input = input_block[sample_idx] * channel_mod[sample_idx]
-
-                # Control signal varies with golden ratio
-                control_signal = np.cos(sample_idx * self.PHI_INV / self.block_size * 2 * np.pi)
-
-                # Process through D-ASE engine (simplified: using first node of group)
-                node_idx = node_start
-                if node_idx < len(self.engine.nodes):
-                    # Process through single representative node for this channel
-                    output_sample = self.engine.nodes[node_idx].process_signal_avx2(
-                        float(modulated_input),
-                        float(control_signal * phi_depth),
-                        0.0  # aux_signal
-                    )
-                    self.output_buffer[ch_idx, sample_idx] = output_sample
-                else:
-                    self.output_buffer[ch_idx, sample_idx] = 0.0
+        # Φ-modulation envelope (see _generatePhiModulation), golden-ratio
+        # channel rotation, control wave and node processing in one native
+        # call, each channel through the first node of its group, written
+        # straight into the output buffer
+        if self.automation is not None:
+            self._schedule_phi(phi_phase, phi_depth)
+            self.engine.process_chromatic_block(
+                input_block,
+                num_channels=self.num_channels,
+                sample_rate=self.sample_rate,
+                out=self.output_buffer,
+                automation=self.automation
+            )
+        else:
+            self.engine.process_chromatic_block(
+                input_block,
+                phi_phase,
+                phi_depth,
+                num_channels=self.num_channels,
+                sample_rate=self.sample_rate,
+                out=self.output_buffer
+            )
 
         # Record processing time
         elapsed = time.perf_counter() - start_time
@@ -166,9 +237,135 @@ class ChromaticFieldProcessor:
 
         return self.output_buffer.copy()
 
+    def processChunk(self,
+                     input_chunk: np.ndarray,
+                     phi_phase: float = 0.0,
+                     phi_depth: float = 0.5) -> np.ndarray:
+        """
+        Process a chunk of any length through the native re-blocking stream
+
+        The engine still runs whole blocks of block_size samples, so the
+        output lags the input by exactly block_size samples (self.stream.latency).
+        Φ parameters apply from the next internal block on; metrics update
+        whenever a block completes.
+
+        Args:
+            input_chunk: float32[n] mono input signal, any n
+            phi_phase: Φ-phase offset in radians [0, 2π]
+            phi_depth: Φ-modulation depth [0.0, 1.0]
+
+        Returns:
+            float32[num_channels, n] multi-channel output
+        """
+        start_time = time.perf_counter()
+
+        if self.automation is not None:
+            self._schedule_phi(phi_phase, phi_depth)
+        else:
+            self.stream.set_phi(phi_phase, phi_depth)
+        output = self.stream.process(input_chunk)
+
+        elapsed = time.perf_counter() - start_time
+        self.process_time_history.append(elapsed)
+        if len(self.process_time_history) > self.max_history_length:
+            self.process_time_history.pop(0)
+
+        if self.stream.blocks_processed != self._stream_blocks:
+            self._stream_blocks = self.stream.blocks_processed
+            self._updateMetrics(self.stream.last_block)
+
+        return output
+
+    def schedule_parameter(self, name: str, value: float, node: Optional[int] = None,
+                           sample: int = 0) -> bool:
+        """
+        Queue a parameter change for the audio thread; safe from any thread
+
+        Args:
+            name: 'phi_phase', 'phi_depth' or 'feedback'
+            value: New value (feedback is clamped to [-2, 2])
+            node: Node of a feedback change, None for every node
+            sample: Sample on self.automation.position's clock the change lands
+                    on; 0 for the next block
+
+        Returns:
+            False when the queue is full or the name is unknown
+        """
+        ids = {
+            'phi_phase': 'PHI_PHASE',
+            'phi_depth': 'PHI_DEPTH',
+            'feedback': 'FEEDBACK',
+        }
+        if name not in ids:
+            return False
+        if self.automation is not None:
+            return self.automation.schedule(getattr(dase_engine.ParameterId, ids[name]), float(value),
+                                            sample=sample, node=node)
+        if name != 'feedback':
+            return False  # Φ arrives with each processBlock call instead
+        nodes = self.engine.nodes
+        for i in range(len(nodes)) if node is None else [node]:
+            nodes[i].set_feedback(float(value))
+        return True
+
+    def switch_node_parameters(self, parameters: Dict[str, object],
+                               crossfade_samples: Optional[int] = None) -> bool:
+        """
+        Swap in a set of node parameters at the next block boundary; safe from
+        any thread
+
+        Args:
+            parameters: Name ('feedback', 'input_gain', 'time_constant',
+                        'clamp_low', 'clamp_high', 'spectral_mix') to one value
+                        for every node or one per node; parameters left out
+                        keep their live values
+            crossfade_samples: Samples the nodes glide over to the new values;
+                               None for one block, 0 for an immediate swap
+
+        Returns:
+            False when a previous switch is still gliding, a name is unknown or
+            the engine has no parameter switch
+        """
+        names = {
+            'feedback': 'FEEDBACK',
+            'input_gain': 'INPUT_GAIN',
+            'time_constant': 'TIME_CONSTANT',
+            'clamp_low': 'CLAMP_LOW',
+            'clamp_high': 'CLAMP_HIGH',
+            'spectral_mix': 'SPECTRAL_MIX',
+        }
+        if self.parameter_switch is None or not parameters or any(n not in names for n in parameters):
+            return False
+        switch = self.parameter_switch
+        for name, value in parameters.items():
+            parameter = getattr(dase_engine.NodeParameter, names[name])
+            if np.isscalar(value):
+                staged = switch.stage_uniform(parameter, float(value))
+            else:
+                staged = switch.stage(parameter, np.asarray(value, dtype=np.float64))
+            if not staged:
+                switch.cancel()
+                return False
+        if crossfade_samples is None:
+            crossfade_samples = self.block_size
+        return switch.commit(int(crossfade_samples))
+
+    def _schedule_phi(self, phi_phase: float, phi_depth: float):
+        """Queue the Φ values of a block when they changed since the last one"""
+        # A change the full queue refused is offered again with the next block
+        last_phase, last_depth = self._scheduled_phi
+        if phi_phase != last_phase and self.automation.schedule(dase_engine.ParameterId.PHI_PHASE,
+                                                                float(phi_phase)):
+            last_phase = phi_phase
+        if phi_depth != last_depth and self.automation.schedule(dase_engine.ParameterId.PHI_DEPTH,
+                                                                float(phi_depth)):
+            last_depth = phi_depth
+        self._scheduled_phi = (last_phase, last_depth)
+
     def _generatePhiModulation(self, phi_phase: float, phi_depth: float) -> np.ndarray:
         """
-        Generate Φ-modulated envelope for one block
+        Generate Φ-modulated envelope for one block (NumPy reference of the
+        envelope process_chromatic_block applies)
 
         Args:
             phi_phase: Phase offset [0, 2π]
@@ -198,11 +395,27 @@ class ChromaticFieldProcessor:
         - Phase Coherence: Phase alignment across channels
         - Spectral Centroid: Center of mass of spectrum
         - Consciousness Level: Composite metric
+        - Output mean, RMS, peak and variance (native engine stats)
 
         Args:
             output: float32[num_channels, block_size] multi-channel signal
         """
         try:
+            # Output levels of the block the engine just ran
+            if self.native_block_stats:
+                stats = self.engine.block_stats
+                self.last_metrics['output_mean'] = stats.mean
+                self.last_metrics['output_rms'] = stats.rms
+                self.last_metrics['output_peak'] = stats.peak
+                self.last_metrics['output_variance'] = stats.variance
+
+            # Pitch classes and dominant pitch of each channel
+            if self.chroma_analyzer is not None and self.chroma_analyzer.process(output).shape[0] > 0:
+                chroma = self.chroma_analyzer.chroma.sum(axis=0)
+                peak = chroma.max()
+                self.last_chroma = chroma / peak if peak > 0 else chroma
+                self.last_channel_pitch = np.asarray(self.chroma_analyzer.dominant_frequencies)
+
             # ICI: Use full spectral-phase integration engine (Feature 014)
             ici_value, _ = self.ici_engine.process_block(output)
             self.last_metrics['ici'] = ici_value
@@ -259,9 +472,27 @@ class ChromaticFieldProcessor:
                 - phase_coherence: Phase alignment [0, 1]
                 - spectral_centroid: Frequency in Hz
                 - consciousness_level: Composite metric [0, 1]
+                - output_mean, output_rms, output_peak, output_variance:
+                  levels of the last block (engines with block stats only)
         """
         return self.last_metrics.copy()
 
+    def getLatestBlock(self):
+        """
+        Latest completed chromatic block, for one reader thread at a time
+
+        Returns:
+            (sequence, outputs) with outputs a read-only [channels, samples]
+            view that stays unchanged until the next call, or None before the
+            first block or without the native publisher
+        """
+        if self.publisher is None:
+            return None
+        block = self.publisher.acquire()
+        if block is None:
+            return None
+        return block.sequence, block.output
+
     def getPerformanceStats(self) -> Dict[str, float]:
         """
         Get processing performance statistics
@@ -272,23 +503,103 @@ class ChromaticFieldProcessor:
                 - max_process_time_ms: Maximum processing time
                 - min_process_time_ms: Minimum processing time
                 - avg_cpu_load: Estimated CPU load [0, 1]
+                - deadline_misses, deadline_near_misses, deadline_worst_load:
+                  the engine watchdog's chromatic blocks over their budget,
+                  over 80% of it, and the largest time over budget (native
+                  builds only)
         """
         if not self.process_time_history:
-            return {
+            stats = {
                 'avg_process_time_ms': 0.0,
                 'max_process_time_ms': 0.0,
                 'min_process_time_ms': 0.0,
                 'avg_cpu_load': 0.0
             }
+        else:
+            times_ms = [t * 1000 for t in self.process_time_history]
+            block_time_ms = (self.block_size / self.sample_rate) * 1000
+            stats = {
+                'avg_process_time_ms': np.mean(times_ms),
+                'max_process_time_ms': np.max(times_ms),
+                'min_process_time_ms': np.min(times_ms),
+                'avg_cpu_load': np.mean(times_ms) / block_time_ms if block_time_ms > 0 else 0.0
+            }
+
+        if hasattr(self.engine, 'get_deadline_health'):
+            health = self.engine.get_deadline_health(dase_engine.DeadlineStage.CHROMATIC_BLOCK)
+            stats['deadline_misses'] = health.misses
+            stats['deadline_near_misses'] = health.near_misses
+            stats['deadline_worst_load'] = health.worst_load
+        return stats
+
+    def render_openmetrics(self) -> str:
+        """Engine counters and latency histograms as OpenMetrics text, rendered natively"""
+        if not hasattr(self.engine, 'render_openmetrics'):
+            return "# EOF\n"
+        return self.engine.render_openmetrics()
+
+    def start_metrics_endpoint(self, port: int = 9464, bind_address: str = '127.0.0.1') -> Optional[int]:
+        """
+        Serve GET /metrics from a native thread, so Prometheus scrapes never
+        reach the interpreter or the audio callback
+
+        Returns:
+            The port listened on, or None when the engine build has no endpoint
+        """
+        if self.metrics_endpoint is None:
+            if not hasattr(dase_engine, 'MetricsHttpServer'):
+                return None
+            self.metrics_endpoint = dase_engine.MetricsHttpServer(self.engine, port, bind_address)
+        return self.metrics_endpoint.port
+
+    def stop_metrics_endpoint(self):
+        if self.metrics_endpoint is not None:
+            self.metrics_endpoint.stop()
+            self.metrics_endpoint = None
+
+    def start_flight_recorder(self, directory: str, seconds: float = 10.0) -> bool:
+        """
+        Keep the last seconds of per-block engine timings and parameter
+        changes natively; a block over its real-time budget freezes them and
+        a native thread dumps them to directory/flight-<n>.dfr (read back with
+        dase_engine.read_flight_recording)
 
-        times_ms = [t * 1000 for t in self.process_time_history]
-        block_time_ms = (self.block_size / self.sample_rate) * 1000
+        Returns:
+            False when the engine build has no flight recorder
+        """
+        if not hasattr(dase_engine, 'FlightRecorder'):
+            return False
+        os.makedirs(directory, exist_ok=True)
+        config = dase_engine.FlightRecorderConfig()
+        # A block event and the odd parameter change per block
+        config.capacity = dase_engine.flight_capacity_for(seconds, self.sample_rate, self.block_size)
+        config.directory = directory
+        recorder = dase_engine.FlightRecorder(config)
+        self.engine.set_flight_recorder(recorder)
+        self.flight_recorder = recorder
+        return True
 
+    def stop_flight_recorder(self):
+        if self.flight_recorder is not None:
+            self.engine.set_flight_recorder(None)
+            self.flight_recorder = None
+
+    def getPitchAnalysis(self) -> Optional[Dict[str, list]]:
+        """
+        Latest constant-Q pitch analysis of the output
+
+        Returns:
+            Dictionary with keys, or None without the native analyzer:
+                - chroma: 12 pitch-class energies (C first) of all channels,
+                  peak-normalized
+                - channel_pitch: strongest constant-Q frequency of each
+                  channel in Hz (0 while silent)
+        """
+        if self.chroma_analyzer is None:
+            return None
         return {
-            'avg_process_time_ms': np.mean(times_ms),
-            'max_process_time_ms': np.max(times_ms),
-            'min_process_time_ms': np.min(times_ms),
-            'avg_cpu_load': np.mean(times_ms) / block_time_ms if block_time_ms > 0 else 0.0
+            'chroma': self.last_chroma.tolist(),
+            'channel_pitch': self.last_channel_pitch.tolist()
         }
 
     def reset(self):
@@ -300,18 +611,18 @@ class ChromaticFieldProcessor:
             node.reset_integrator()
 
         # Reset metrics
-        self.last_metrics = {
-            'ici': 0.0,
-            'phase_coherence': 0.0,
-            'spectral_centroid': 0.0,
-            'consciousness_level': 0.0
-        }
+        self.last_metrics = dict.fromkeys(self.last_metrics, 0.0)
 
         # Clear performance history
         self.process_time_history.clear()
 
-        # Clear output buffer
+        # Clear output buffer and stream history
         self.output_buffer.fill(0.0)
+        self.stream.reset()
+        if self.chroma_analyzer is not None:
+            self.chroma_analyzer.reset()
+            self.last_chroma = np.zeros(12)
+            self.last_channel_pitch = np.zeros(self.num_channels)
 
     def __del__(self):
         """Cleanup on destruction"""
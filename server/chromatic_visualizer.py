@@ -19,6 +19,8 @@ Requirements:
 - SC-005: CPU usage < 15% / GPU < 40%
 """
 
+import os
+import sys
 import time
 import math
 import numpy as np
@@ -27,6 +29,17 @@ from dataclasses import dataclass, asdict
 from collections import deque
 import threading
 
+# Add sase amp fixed to path to import dase_engine
+DASE_PATH = os.path.join(os.path.dirname(__file__), '..', 'sase amp fixed')
+if DASE_PATH not in sys.path:
+    sys.path.insert(0, DASE_PATH)
+
+try:
+    import dase_engine
+    DASE_AVAILABLE = hasattr(dase_engine, "ChromaticColorMapper")
+except ImportError:
+    DASE_AVAILABLE = False
+
 
 # Golden angle in degrees
 GOLDEN_ANGLE = 137.5077640500378
@@ -94,6 +107,7 @@ class VisualizerConfig:
     # Performance
     target_fps: int = 60
     enable_logging: bool = False
+    use_native_mapper: bool = True  # Batch colour mapping in dase_engine when built
 
 
 class ColorMapper:
@@ -110,6 +124,55 @@ class ColorMapper:
         """Initialize ColorMapper"""
         self.config = config
 
+        # Native batch mapper (map_channels), built from the config as it is now
+        self.native = None
+        if DASE_AVAILABLE and config.use_native_mapper:
+            native_config = dase_engine.ChromaticColorConfig()
+            native_config.min_frequency = config.min_frequency
+            native_config.max_frequency = config.max_frequency
+            native_config.log_scale = config.frequency_scale == "log"
+            native_config.amplitude_gamma = config.amplitude_gamma
+            native_config.phi_rotation = config.phi_rotation_enabled
+            self.native = dase_engine.ChromaticColorMapper(native_config)
+
+    def map_channels(self,
+                     frequencies,
+                     amplitudes,
+                     phi_phase: float,
+                     lightness_gain: float = 1.0) -> Tuple[np.ndarray, np.ndarray]:
+        """
+        Colors of every channel at once: frequency_to_hue, apply_phi_rotation
+        and amplitude_to_lightness over arrays, natively when available
+
+        Args:
+            frequencies: Channel frequencies in Hz
+            amplitudes: Channel amplitudes (0-1)
+            phi_phase: Φ phase (0-2π)
+            lightness_gain: Factor on every lightness (Φ-breathing)
+
+        Returns:
+            (hsl, rgba): float32 (n, 3) hue in degrees, saturation, lightness,
+            and uint8 (n, 4) RGBA
+        """
+        if self.native is not None:
+            return self.native.map(frequencies, amplitudes, phi_phase, lightness_gain)
+
+        hue = self.apply_phi_rotation(self.frequency_to_hue(np.asarray(frequencies, dtype=np.float64)), phi_phase)
+        lightness = self.amplitude_to_lightness(np.asarray(amplitudes, dtype=np.float64)) * lightness_gain
+        hsl = np.empty((len(hue), 3), dtype=np.float32)
+        hsl[:, 0] = hue
+        hsl[:, 1] = 1.0
+        hsl[:, 2] = lightness
+
+        # HSL to RGB: l - s * min(l, 1 - l) * clip(min(k - 3, 9 - k), -1, 1),
+        # k = (n + h / 30) mod 12 for n = 0, 8, 4
+        k = (np.array([0.0, 8.0, 4.0]) + hue[:, None] / 30.0) % 12.0
+        chroma = np.minimum(lightness, 1.0 - lightness)[:, None]
+        rgb = lightness[:, None] - chroma * np.clip(np.minimum(k - 3.0, 9.0 - k), -1.0, 1.0)
+        rgba = np.full((len(hue), 4), 255, dtype=np.uint8)
+        rgba[:, :3] = np.clip(rgb * 255.0 + 0.5, 0.0, 255.0).astype(np.uint8)
+        return hsl, rgba
+
     def frequency_to_hue(self, frequency: float) -> float:
         """
         Convert frequency to hue (FR-001, SC-001)
@@ -311,8 +374,10 @@ class ChromaticVisualizer:
         self.phi_animator = PhiAnimator(self.config)
         self.topology_overlay = TopologyOverlay(self.config)
 
-        # State
+        # State, and the packed colour buffers of its channels
         self.current_state: Optional[ChromaticState] = None
+        self.current_hsl: Optional[np.ndarray] = None
+        self.current_rgba: Optional[np.ndarray] = None
         self.state_lock = threading.Lock()
 
         # Performance tracking
@@ -351,33 +416,27 @@ class ChromaticVisualizer:
         # Compute Φ-breathing cycle
         phi_breathing = self.phi_animator.compute_breathing_cycle(frame_start, phi_depth)
 
-        # Compute channel chromatic states
-        channels = []
-        for i in range(min(len(channel_frequencies), self.config.num_channels)):
-            freq = channel_frequencies[i]
-            amp = channel_amplitudes[i]
-
-            # Base hue from frequency (FR-001)
-            base_hue = self.color_mapper.frequency_to_hue(freq)
-
-            # Apply Φ rotation (FR-002)
-            hue = self.color_mapper.apply_phi_rotation(base_hue, phi_phase)
-
-            # Brightness from amplitude (FR-001)
-            lightness = self.color_mapper.amplitude_to_lightness(amp)
-
-            # Modulate brightness by Φ-breathing (User Story 2)
-            if self.config.phi_breathing_enabled:
-                lightness = lightness * (0.5 + 0.5 * phi_breathing)
+        # Compute channel chromatic states in one batch: hue from frequency
+        # and brightness from amplitude (FR-001), Φ rotation (FR-002), and
+        # brightness modulated by Φ-breathing (User Story 2)
+        count = min(len(channel_frequencies), self.config.num_channels)
+        frequencies = channel_frequencies[:count]
+        amplitudes = channel_amplitudes[:count]
+        lightness_gain = 0.5 + 0.5 * phi_breathing if self.config.phi_breathing_enabled else 1.0
+        hsl, rgba = self.color_mapper.map_channels(frequencies, amplitudes, phi_phase, lightness_gain)
+        base_hues = self.color_mapper.frequency_to_hue(np.asarray(frequencies, dtype=np.float64))
 
+        channels = []
+        for i in range(count):
+            hue = float(hsl[i, 0])
             channels.append(ChannelChroma(
                 channel_id=i,
-                frequency=freq,
-                amplitude=amp,
+                frequency=frequencies[i],
+                amplitude=amplitudes[i],
                 hue=hue,
                 saturation=1.0,  # Full saturation for vivid colors
-                lightness=lightness,
-                phi_rotation=hue - base_hue
+                lightness=float(hsl[i, 2]),
+                phi_rotation=hue - float(base_hues[i])
             ))
 
         # Generate coupling matrix if not provided
@@ -390,6 +449,8 @@ class ChromaticVisualizer:
 
         # Create chromatic state
         with self.state_lock:
+            self.current_hsl = hsl
+            self.current_rgba = rgba
             self.current_state = ChromaticState(
                 timestamp=frame_start,
                 channels=channels,
@@ -430,6 +491,19 @@ class ChromaticVisualizer:
                 return asdict(self.current_state)
             return None
 
+    def get_color_buffers(self) -> Optional[Tuple[np.ndarray, np.ndarray]]:
+        """
+        Packed colours of the current state's channels, for renderers that
+        upload them directly instead of reading the state dictionary
+
+        Returns:
+            (hsl, rgba) as map_channels returns them, or None
+        """
+        with self.state_lock:
+            if self.current_rgba is None:
+                return None
+            return self.current_hsl, self.current_rgba
+
     def get_performance_stats(self) -> Dict:
         """
         Get performance statistics (SC-003, SC-005)
@@ -13,11 +13,25 @@ Requirements:
 - SC-003: Correlation accuracy >= 0.95
 """
 
+import sys
+import os
 import numpy as np
 from typing import List, Dict, Optional, Tuple
 from dataclasses import dataclass
 import json
 
+# Add sase amp fixed to path to import dase_engine
+DASE_PATH = os.path.join(os.path.dirname(__file__), '..', 'sase amp fixed')
+if DASE_PATH not in sys.path:
+    sys.path.insert(0, DASE_PATH)
+
+try:
+    import dase_engine
+    DASE_AVAILABLE = hasattr(dase_engine, "CorrelationKernel")
+except ImportError:
+    DASE_AVAILABLE = False
+SESSION_FILES_AVAILABLE = DASE_AVAILABLE and hasattr(dase_engine, "SessionStore")
+
 
 @dataclass
 class CorrelationMatrix:
@@ -53,6 +67,35 @@ class CorrelationAnalyzer:
         """
         self.sessions_data[session_id] = session_data
 
+    def load_session_file(self, session_id: str, path: str) -> bool:
+        """
+        Load a native session file (see session_comparator.write_session_file)
+
+        The file is mapped; its columns are read in place rather than parsed.
+
+        Args:
+            session_id: Session identifier
+            path: Session file path
+
+        Returns:
+            True if loaded successfully
+        """
+        if not SESSION_FILES_AVAILABLE:
+            return False
+        try:
+            self.sessions_data[session_id] = dase_engine.SessionStore(path)
+            return True
+        except Exception as e:
+            print(f"[CorrelationAnalyzer] Error loading session file: {e}")
+            return False
+
+    def _series(self, session_id: str, key: str) -> np.ndarray:
+        """One metric of a loaded session, from its dict or its mapped file"""
+        session = self.sessions_data[session_id]
+        if isinstance(session, dict):
+            return np.array([s.get(key, 0.5) for s in session.get("samples", [])])
+        return np.asarray(session.column(key))
+
     def compute_correlation_matrix(self, metric: str = "ici") -> Optional[CorrelationMatrix]:
         """
         Compute correlation matrix for a metric across all sessions (FR-004)
@@ -82,9 +125,7 @@ class CorrelationAnalyzer:
 
             time_series = {}
             for session_id in session_ids:
-                samples = self.sessions_data[session_id].get("samples", [])
-                values = np.array([s.get(metric_key, 0.5) for s in samples])
-                time_series[session_id] = values
+                time_series[session_id] = self._series(session_id, metric_key)
 
             # Find minimum length for alignment
             min_length = min(len(ts) for ts in time_series.values())
@@ -96,19 +137,9 @@ class CorrelationAnalyzer:
             }
 
             # Build correlation matrix (SC-003)
-            corr_matrix = np.zeros((n_sessions, n_sessions))
-
-            for i, sid_i in enumerate(session_ids):
-                for j, sid_j in enumerate(session_ids):
-                    if i == j:
-                        corr_matrix[i, j] = 1.0  # Diagonal is always 1.0
-                    else:
-                        # Compute Pearson correlation
-                        corr = np.corrcoef(
-                            aligned_series[sid_i],
-                            aligned_series[sid_j]
-                        )[0, 1]
-                        corr_matrix[i, j] = float(corr)
+            stacked = np.array([aligned_series[sid] for sid in session_ids], dtype=np.float64)
+            corr_matrix = self._pearson_matrix(stacked)
+            np.fill_diagonal(corr_matrix, 1.0)  # Diagonal is always 1.0
 
             # Verify matrix properties
             is_symmetric = np.allclose(corr_matrix, corr_matrix.T, atol=1e-6)
@@ -132,6 +163,19 @@ class CorrelationAnalyzer:
             print(f"[CorrelationAnalyzer] Error computing correlation: {e}")
             return None
 
+    def _pearson_matrix(self, series: np.ndarray) -> np.ndarray:
+        """
+        Pearson correlation of every pair of rows of a [sessions x samples] array
+
+        Uses the native blocked kernel when dase_engine provides it, NumPy otherwise.
+        """
+        if DASE_AVAILABLE and series.shape[1] >= 2:
+            if not hasattr(self, "_kernel"):
+                self._kernel = dase_engine.CorrelationKernel()
+            return np.array(self._kernel.compute(series.astype(np.float32)), dtype=np.float64)
+        with np.errstate(invalid="ignore", divide="ignore"):
+            return np.atleast_2d(np.corrcoef(series))
+
     def compute_all_correlations(self) -> Dict[str, CorrelationMatrix]:
         """
         Compute correlation matrices for all metrics
@@ -216,14 +260,14 @@ class CorrelationAnalyzer:
             for j, sid_b in enumerate(session_ids):
                 if i < j:  # Only compute once per pair
                     # Get metrics for both sessions
-                    samples_a = self.sessions_data[sid_a].get("samples", [])
-                    samples_b = self.sessions_data[sid_b].get("samples", [])
+                    icis_a = self._series(sid_a, "ici")
+                    icis_b = self._series(sid_b, "ici")
 
                     # Compute pairwise statistics
-                    min_len = min(len(samples_a), len(samples_b))
+                    min_len = min(len(icis_a), len(icis_b))
 
-                    icis_a = np.array([s.get("ici", 0.5) for s in samples_a[:min_len]])
-                    icis_b = np.array([s.get("ici", 0.5) for s in samples_b[:min_len]])
+                    icis_a = icis_a[:min_len]
+                    icis_b = icis_b[:min_len]
 
                     ici_corr = np.corrcoef(icis_a, icis_b)[0, 1] if min_len > 1 else 0.0
 
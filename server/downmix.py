@@ -5,9 +5,21 @@ Converts 8-channel D-ASE output to stereo for browser playback with spatial pres
 Implements multiple downmix strategies optimized for different use cases.
 """
 
+import os
+import sys
 import numpy as np
 from typing import Optional, Literal
 
+DASE_PATH = os.path.join(os.path.dirname(__file__), '..', 'sase_amp_fixed')
+if DASE_PATH not in sys.path:
+    sys.path.insert(0, DASE_PATH)
+
+try:
+    import dase_engine
+    NATIVE_DOWNMIX = hasattr(dase_engine, "StereoDownmix")
+except ImportError:
+    NATIVE_DOWNMIX = False
+
 
 class StereoDownmixer:
     """
@@ -17,7 +29,8 @@ class StereoDownmixer:
     of the multi-channel D-ASE output while preventing clipping.
     """
 
-    def __init__(self, num_channels: int = 8, strategy: Literal['spatial', 'energy', 'linear', 'phi'] = 'spatial'):
+    def __init__(self, num_channels: int = 8, strategy: Literal['spatial', 'energy', 'linear', 'phi'] = 'spatial',
+                 use_native: bool = True):
         """
         Initialize downmixer
 
@@ -28,10 +41,20 @@ class StereoDownmixer:
                 - 'energy': Energy-preserving (RMS-based)
                 - 'linear': Simple averaging
                 - 'phi': Golden-ratio weighted distribution
+            use_native: Mix through dase_engine.StereoDownmix when it is built
         """
         self.num_channels = num_channels
         self.strategy = strategy
         self.gain = 1.0  # Master output gain
+
+        # Native matrix mix: weights are pushed when the coefficients or the
+        # gain change, and the stereo buffer is kept between blocks
+        self.native = None
+        if use_native and NATIVE_DOWNMIX and num_channels == 8:
+            self.native = dase_engine.StereoDownmix(num_channels)
+        self._native_gain = None
+        self._stereo = np.zeros((2, 0), dtype=np.float32)
+
         self._setup_coefficients()
 
         print(f"[StereoDownmixer] Initialized with '{strategy}' strategy")
@@ -77,6 +100,8 @@ class StereoDownmixer:
         else:
             raise ValueError(f"Unknown downmix strategy: {self.strategy}")
 
+        self._native_gain = None
+
     def downmix(self, multi_channel: np.ndarray) -> np.ndarray:
         """
         Downmix 8 channels to stereo
@@ -86,7 +111,8 @@ class StereoDownmixer:
                 Multi-channel input signal
 
         Returns:
-            float32[2, num_samples] stereo output
+            float32[2, num_samples] stereo output; on the native path this
+            buffer is reused by the next call
 
         Raises:
             ValueError: If input doesn't have 8 channels
@@ -106,6 +132,9 @@ class StereoDownmixer:
 
         num_samples = channels.shape[1]
 
+        if self.native is not None:
+            return self._downmix_native(channels, num_samples)
+
         # Apply weighted mixing
         left = np.zeros(num_samples, dtype=np.float32)
         right = np.zeros(num_samples, dtype=np.float32)
@@ -127,6 +156,16 @@ class StereoDownmixer:
 
         return stereo
 
+    def _downmix_native(self, channels: np.ndarray, num_samples: int) -> np.ndarray:
+        """One native pass of every channel into the kept stereo buffer"""
+        gain = self.gain / self.normalization
+        if self._native_gain != gain:
+            self.native.set_weights(self.left_weights.tolist(), self.right_weights.tolist(), gain)
+            self._native_gain = gain
+        if self._stereo.shape[1] != num_samples:
+            self._stereo = np.zeros((2, num_samples), dtype=np.float32)
+        return self.native.process(channels, self._stereo)
+
     def downmix_with_monitoring(self, multi_channel: np.ndarray) -> tuple[np.ndarray, dict]:
         """
         Downmix with additional monitoring information
@@ -186,6 +225,7 @@ class StereoDownmixer:
             self.right_weights = np.array(weights, dtype=np.float32)
         else:
             raise ValueError(f"Invalid channel: {channel}. Use 'L' or 'R'")
+        self._native_gain = None
 
     def get_strategy_info(self) -> dict:
         """
@@ -200,6 +240,7 @@ class StereoDownmixer:
             'right_weights': self.right_weights.tolist(),
             'normalization': float(self.normalization),
             'gain': float(self.gain),
+            'native': self.native is not None,
             'total_left_gain': float(np.sum(self.left_weights)),
             'total_right_gain': float(np.sum(self.right_weights))
         }
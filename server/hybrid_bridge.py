@@ -152,6 +152,7 @@ class HybridBridge:
     CMD_SET_MODE = 0x1C
     CMD_EMERGENCY_SHUTDOWN = 0x1D
     CMD_GET_VERSION = 0x1E
+    CMD_GET_PHI_LINK = 0x1F
 
     RESP_OK = 0x00
     RESP_ERROR = 0xFF
@@ -382,6 +383,47 @@ class HybridBridge:
                 print(f"[HybridBridge] Get DSP metrics error: {e}")
             return {}
 
+    def get_phi_link(self) -> Dict:
+        """
+        Observe the on-device Φ link (FR-004)
+
+        With enable_phi_link the node takes phi_depth/phi_phase from its
+        Φ-sensor directly; the host reads them here instead of relaying
+        them through set_control_voltage.
+
+        Returns:
+            Link status dictionary
+        """
+        if not self.is_connected:
+            return {}
+
+        try:
+            self._send_command(self.CMD_GET_PHI_LINK)
+            response = self._receive_response()
+
+            if response == self.RESP_OK:
+                # Format: active (uint8, 3 pad), sequence, frames, stale_count (uint32), 4 floats
+                data = self.serial.read(32)
+                if len(data) == 32:
+                    unpacked = struct.unpack('<B3xIIIffff', data)
+                    return {
+                        'active': bool(unpacked[0]),
+                        'sequence': unpacked[1],
+                        'frames': unpacked[2],
+                        'stale_count': unpacked[3],
+                        'phi_depth': unpacked[4],
+                        'phi_phase': unpacked[5],
+                        'coherence': unpacked[6],
+                        'criticality': unpacked[7]
+                    }
+
+            return {}
+
+        except Exception as e:
+            if self.enable_logging:
+                print(f"[HybridBridge] Get phi link error: {e}")
+            return {}
+
     def get_safety(self) -> Dict:
         """
         Get safety telemetry (FR-007)
@@ -86,6 +86,7 @@ class HybridMetrics:
     cpu_load: float                # Processing CPU load [0, 1]
     latency_ms: float              # Processing latency (ms)
     dropouts: int                  # Audio dropout count
+    chroma: Optional[List[float]] = None  # 12 pitch-class energies, C first (native analyzer only)
 
 
 class PhiModulator:
@@ -348,6 +349,7 @@ class HybridNode:
 
             # Get metrics from processor (lightweight, already calculated)
             metrics_dict = self.processor.getMetrics()
+            pitch = self.processor.getPitchAnalysis()
 
             # Create metrics snapshot
             latency_ms = elapsed * 1000
@@ -363,7 +365,8 @@ class HybridNode:
                 phi_depth=phi_depth,
                 cpu_load=cpu_load,
                 latency_ms=latency_ms,
-                dropouts=self.dropout_count
+                dropouts=self.dropout_count,
+                chroma=pitch['chroma'] if pitch is not None else None
             )
 
             # Store current metrics (non-blocking)
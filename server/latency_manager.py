@@ -16,10 +16,21 @@ from typing import Optional, Tuple, Dict, List
 from collections import deque
 from datetime import datetime
 import os
+import sys
 from pathlib import Path
 
 from .latency_frame import LatencyFrame, create_default_latency_frame
 
+DASE_PATH = os.path.join(os.path.dirname(__file__), '..', 'sase_amp_fixed')
+if DASE_PATH not in sys.path:
+    sys.path.insert(0, DASE_PATH)
+
+try:
+    import dase_engine
+    NATIVE_DELAY_LINE = hasattr(dase_engine, "FractionalDelayLine")
+except ImportError:
+    NATIVE_DELAY_LINE = False
+
 
 class DriftMonitor:
     """
@@ -143,17 +154,25 @@ class DelayLineBuffer:
     Provides sample-accurate delay with fractional sample interpolation
     """
 
-    def __init__(self, max_delay_samples: int, num_channels: int = 1):
+    def __init__(self, max_delay_samples: int, num_channels: int = 1, use_native: bool = True):
         """
         Initialize delay buffer
 
         Args:
             max_delay_samples: Maximum delay in samples
             num_channels: Number of audio channels
+            use_native: Delay through dase_engine.FractionalDelayLine when it is built
         """
         self.max_delay_samples = max_delay_samples
         self.num_channels = num_channels
 
+        # Native delay: whole blocks as interpolating FIRs over its own ring,
+        # with a kept float32 block for callers passing other dtypes
+        self.native = None
+        if use_native and NATIVE_DELAY_LINE:
+            self.native = dase_engine.FractionalDelayLine(num_channels, max_delay_samples)
+        self._block = np.zeros((0, num_channels), dtype=np.float32)
+
         # Allocate buffer with extra space for interpolation
         self.buffer = np.zeros((max_delay_samples + 4, num_channels), dtype=np.float32)
         self.write_pos = 0
@@ -169,6 +188,19 @@ class DelayLineBuffer:
         """
         delay_samples = (delay_ms / 1000.0) * sample_rate
         self.current_delay_samples = max(0.0, min(delay_samples, self.max_delay_samples))
+        if self.native is not None:
+            self.native.delay = self.current_delay_samples
+
+    def process_inplace(self, block: np.ndarray) -> np.ndarray:
+        """
+        Delay a C-contiguous float32 (num_samples, num_channels) block in place
+
+        Falls back to process() and a copy back without the native delay line.
+        """
+        if self.native is not None:
+            return self.native.process_interleaved(block)
+        block[:] = self.process(block)
+        return block
 
     def process(self, input_block: np.ndarray) -> np.ndarray:
         """
@@ -178,9 +210,16 @@ class DelayLineBuffer:
             input_block: Input audio (num_samples, num_channels)
 
         Returns:
-            Delayed audio (same shape as input)
+            Delayed audio (same shape as input); float32 on the native path,
+            in a buffer reused by the next call
         """
         num_samples = input_block.shape[0]
+        if self.native is not None:
+            if self._block.shape[0] != num_samples:
+                self._block = np.zeros((num_samples, self.num_channels), dtype=np.float32)
+            np.copyto(self._block, input_block, casting='unsafe')
+            return self.native.process_interleaved(self._block)
+
         output = np.zeros_like(input_block)
 
         for i in range(num_samples):
@@ -265,7 +265,9 @@ class SoundlabServer:
                  hybrid_baudrate: int = 115200,
                  enable_hybrid_node: bool = False,
                  hybrid_node_input_device: Optional[int] = None,
-                 hybrid_node_output_device: Optional[int] = None):
+                 hybrid_node_output_device: Optional[int] = None,
+                 native_metrics_port: Optional[int] = None,
+                 flight_recorder_dir: Optional[str] = None):
         """
         Initialize Soundlab server
 
@@ -276,6 +278,8 @@ class SoundlabServer:
             audio_output_device: Audio output device index (None = default)
             enable_logging: Enable metrics/latency logging
             enable_cors: Enable CORS for web clients
+            native_metrics_port: Serve the engine's OpenMetrics natively on this port
+            flight_recorder_dir: Dump the engine's flight recorder here on deadline misses
         """
         print("=" * 60)
         print("SOUNDLAB SERVER")
@@ -294,6 +298,19 @@ class SoundlabServer:
             enable_logging=enable_logging
         )
 
+        if native_metrics_port is not None:
+            bound = self.audio_server.processor.start_metrics_endpoint(native_metrics_port)
+            if bound is None:
+                print("[Main] Native metrics endpoint unavailable in this engine build")
+            else:
+                print(f"[Main] Native OpenMetrics on http://127.0.0.1:{bound}/metrics")
+
+        if flight_recorder_dir is not None:
+            if self.audio_server.processor.start_flight_recorder(flight_recorder_dir):
+                print(f"[Main] Flight recorder dumps deadline misses to {flight_recorder_dir}")
+            else:
+                print("[Main] Flight recorder unavailable in this engine build")
+
         # Initialize preset management
         print("\n[Main] Initializing preset store...")
         self.preset_store = PresetStore()
@@ -666,6 +683,15 @@ class SoundlabServer:
         else:
             self.phasenet = None
 
+        # One reference for the native phase lock: the sync master when this
+        # node is a sync client, the PhaseNet leader otherwise
+        phase_lock = getattr(self.audio_server.processor, 'phase_lock', None)
+        if phase_lock is not None:
+            if self.node_sync and self.node_sync.role == NodeRole.CLIENT:
+                self.node_sync.phase_lock = phase_lock
+            elif self.phasenet:
+                self.phasenet.phase_lock = phase_lock
+
         # Initialize Cluster Monitor (Feature 022)
         if enable_cluster_monitor:
             print("\n[Main] Initializing Cluster Monitor...")
@@ -733,7 +759,8 @@ class SoundlabServer:
                     'phi_phase': metrics.phi_phase,
                     'phi_depth': metrics.phi_depth,
                     'cpu_load': metrics.cpu_load,
-                    'latency_ms': metrics.latency_ms
+                    'latency_ms': metrics.latency_ms,
+                    'chroma': metrics.chroma
                 }))
 
             self.hybrid_node.register_metrics_callback(hybrid_metrics_callback)
@@ -3608,6 +3635,8 @@ def main():
     parser.add_argument("--enable-hybrid-node", action="store_true", help="Enable Hybrid Node Integration (Feature 025: analog I/O with D-ASE engine)")
     parser.add_argument("--hybrid-node-input-device", type=int, help="Audio input device index for hybrid node (auto-detect if not specified)")
     parser.add_argument("--hybrid-node-output-device", type=int, help="Audio output device index for hybrid node (auto-detect if not specified)")
+    parser.add_argument("--native-metrics-port", type=int, help="Serve engine OpenMetrics from a native thread on this port (Prometheus scrape target)")
+    parser.add_argument("--flight-recorder", metavar="DIR", help="Keep the last seconds of engine block timings natively and dump them to DIR on a deadline miss")
     parser.add_argument("--list-devices", action="store_true", help="List available audio devices and exit")
 
     args = parser.parse_args()
@@ -3652,7 +3681,9 @@ def main():
         hybrid_baudrate=args.hybrid_baudrate,
         enable_hybrid_node=args.enable_hybrid_node,
         hybrid_node_input_device=args.hybrid_node_input_device,
-        hybrid_node_output_device=args.hybrid_node_output_device
+        hybrid_node_output_device=args.hybrid_node_output_device,
+        native_metrics_port=args.native_metrics_port,
+        flight_recorder_dir=args.flight_recorder
     )
 
     server.run(
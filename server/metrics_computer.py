@@ -11,6 +11,8 @@ Created: 2025-10-17 (Priority 1 Remediation)
 Purpose: Fix validate_soundlab_v1_final.py import errors
 """
 
+import os
+import sys
 import numpy as np
 from typing import Dict, Optional
 
@@ -18,6 +20,16 @@ from .ici_engine import IntegratedChromaticInformation, ICIConfig
 from .chromatic_field_processor import ChromaticFieldProcessor
 from .state_classifier import StateClassifierGraph, StateClassifierConfig
 
+DASE_PATH = os.path.join(os.path.dirname(__file__), '..', 'sase_amp_fixed')
+if DASE_PATH not in sys.path:
+    sys.path.insert(0, DASE_PATH)
+
+try:
+    import dase_engine
+    NATIVE_DSP_CORE = hasattr(dase_engine, "dsp")
+except ImportError:
+    NATIVE_DSP_CORE = False
+
 
 class MetricsComputer:
     """
@@ -45,6 +57,7 @@ class MetricsComputer:
         """
         self.enable_logging = enable_logging
         self.validation_mode = validation_mode
+        self._centroid_fft = None  # DSP core transform, made for the first buffer length
 
         # Initialize computation engines
         if not validation_mode:
@@ -76,13 +89,16 @@ class MetricsComputer:
             print("[MetricsComputer] Initialized")
             print(f"[MetricsComputer]   validation_mode={validation_mode}")
 
-    def compute_all(self, audio_buffer: Optional[np.ndarray] = None) -> Dict:
+    def compute_all(self, audio_buffer: Optional[np.ndarray] = None, block_stats=None) -> Dict:
         """
         Compute all metrics
 
         Args:
             audio_buffer: Optional audio buffer (num_channels, buffer_size)
                          If None, returns cached or synthetic metrics
+            block_stats: Optional dase_engine.BlockStats of the chromatic
+                         block that produced audio_buffer; its per-channel
+                         RMS replaces the NumPy pass over the buffer
 
         Returns:
             Dictionary with all computed metrics:
@@ -101,7 +117,7 @@ class MetricsComputer:
             return self._generate_synthetic_metrics()
 
         # Live mode: compute real metrics
-        return self._compute_live_metrics(audio_buffer)
+        return self._compute_live_metrics(audio_buffer, block_stats)
 
     def _generate_synthetic_metrics(self) -> Dict:
         """
@@ -124,12 +140,13 @@ class MetricsComputer:
         self._cached_metrics = metrics
         return metrics
 
-    def _compute_live_metrics(self, audio_buffer: np.ndarray) -> Dict:
+    def _compute_live_metrics(self, audio_buffer: np.ndarray, block_stats=None) -> Dict:
         """
         Compute real metrics from audio buffer
 
         Args:
             audio_buffer: Audio buffer (num_channels, buffer_size)
+            block_stats: Optional native statistics of the same block
 
         Returns:
             Dictionary with computed metrics
@@ -156,7 +173,7 @@ class MetricsComputer:
             criticality = self._compute_criticality(ici_value, phase_coherence)
 
             # 6. Compute chromatic field energy (from D-ASE processor)
-            chromatic_energy = self._compute_chromatic_energy(audio_buffer)
+            chromatic_energy = self._compute_chromatic_energy(audio_buffer, block_stats)
 
             # Aggregate metrics
             metrics = {
@@ -203,6 +220,16 @@ class MetricsComputer:
         # Average across all channels
         avg_signal = np.mean(audio_buffer, axis=0)
 
+        n = len(avg_signal)
+        if NATIVE_DSP_CORE and n >= 4 and (n & (n - 1)) == 0:
+            # The DSP core's centroid, as the firmware and the pipeline host
+            # report it: bins below Nyquist, DC left out
+            if self._centroid_fft is None or self._centroid_fft.size != n:
+                self._centroid_fft = dase_engine.dsp.RealFFT(n)
+            spectrum = self._centroid_fft.forward(avg_signal.astype(np.float32))
+            magnitude = dase_engine.dsp.magnitudes(spectrum[:n // 2])
+            return dase_engine.dsp.spectral_features(magnitude, 48000.0 / n)['centroid']
+
         # Compute FFT
         spectrum = np.abs(np.fft.rfft(avg_signal))
         freqs = np.fft.rfftfreq(len(avg_signal), d=1.0/48000.0)
@@ -275,19 +302,27 @@ class MetricsComputer:
 
         return float(np.clip(criticality, 0.0, 1.0))
 
-    def _compute_chromatic_energy(self, audio_buffer: np.ndarray) -> float:
+    def _compute_chromatic_energy(self, audio_buffer: np.ndarray, block_stats=None) -> float:
         """
         Compute chromatic field energy
 
         Args:
             audio_buffer: Audio buffer (num_channels, buffer_size)
+            block_stats: Optional native statistics of the same block
 
         Returns:
             Chromatic energy [0, 1]
         """
         # Simplified chromatic energy: RMS energy across channels
-        rms_per_channel = np.sqrt(np.mean(audio_buffer**2, axis=1))
-        avg_energy = np.mean(rms_per_channel)
+        num_channels = audio_buffer.shape[0]
+        channel_rms = getattr(block_stats, 'channel_rms', None)
+        if channel_rms and len(channel_rms) <= num_channels:
+            # Accumulated by the engine kernel; channels past the last node
+            # are silent and not listed
+            avg_energy = sum(channel_rms) / num_channels
+        else:
+            rms_per_channel = np.sqrt(np.mean(audio_buffer**2, axis=1))
+            avg_energy = np.mean(rms_per_channel)
 
         # Normalize to [0, 1] range (assuming typical audio levels)
         normalized_energy = np.clip(avg_energy * 10.0, 0.0, 1.0)
@@ -47,6 +47,11 @@ class MetricsFrame:
     valid: bool = True  # False if any metric is invalid (NaN/Inf)
     frame_id: Optional[int] = None  # Sequential frame number
 
+    # Tracing (native pipeline): the block's trace ID and where it started,
+    # CLOCK_REALTIME ns of its Φ sample or release (pipeline_trace.h)
+    trace_id: Optional[int] = None
+    origin_ns: Optional[int] = None
+
     def to_dict(self) -> Dict:
         """Convert to dictionary for JSON serialization"""
         return asdict(self)
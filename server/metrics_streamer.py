@@ -8,12 +8,31 @@ Implements FR-001 through FR-006:
 - Frame buffering with <100ms latency
 - REST endpoint /api/metrics/latest
 - Graceful reconnection handling
+
+Frames come from submit_frame(), or in batches from a native metrics ring
+(attach_native_ring): the pipeline host appends fixed-layout records to a
+shared-memory ring, read here as a NumPy structured array and sent to the
+clients as one column-oriented "metrics_batch" message per broadcast.
+
+Clients that send {"type": "subscribe", "format": "binary"} get binary
+frames instead (dase_engine.MetricsFrameEncoder): each frame, with its
+optional ICI matrix and per-channel arrays, is delta-encoded against the
+last one sent to that client, and clients at the same frame share one
+encoding. Everyone else, and every client without the native extension,
+keeps receiving JSON.
+
+Native records carry their block's trace ID and origin; the streamer adds
+the last hop, ring record to WebSocket send, and the end-to-end latency to
+a dase_engine.TraceBreakdown (get_statistics()['trace']). When the pipeline
+host runs on another machine, set_clock_offset() takes its clock's offset.
 """
 
 import asyncio
 import json
+import os
+import sys
 import time
-from typing import Set, Optional, Dict
+from typing import Set, Optional, Dict, Sequence
 from collections import deque
 from fastapi import FastAPI, WebSocket, WebSocketDisconnect
 from fastapi.responses import JSONResponse
@@ -22,6 +41,26 @@ import logging
 from .metrics_frame import MetricsFrame, create_idle_frame
 from .metrics_logger import MetricsLogger
 
+# Optional native metrics ring (D-ASE extension)
+DASE_PATH = os.path.join(os.path.dirname(__file__), '..', 'sase_amp_fixed')
+if DASE_PATH not in sys.path:
+    sys.path.insert(0, DASE_PATH)
+
+try:
+    import dase_engine
+    NATIVE_METRICS_RING = hasattr(dase_engine, "MetricsRing")
+    NATIVE_METRICS_CODEC = hasattr(dase_engine, "MetricsFrameEncoder")
+    NATIVE_TRACE = hasattr(dase_engine, "TraceBreakdown")
+except ImportError:
+    NATIVE_METRICS_RING = False
+    NATIVE_METRICS_CODEC = False
+    NATIVE_TRACE = False
+
+# MetricsRecord.state values (shared_state.h MetricsState), in order
+METRICS_STATES = ("AWAKE", "DREAMING", "DEEP_SLEEP", "REM", "TRANSITION", "CRITICAL", "IDLE")
+METRICS_RECORD_VALID = 1
+METRICS_RECORD_PHI_SENSOR = 2
+
 
 class MetricsStreamer:
     """
@@ -34,11 +73,14 @@ class MetricsStreamer:
     FRAME_INTERVAL = 1.0 / TARGET_FPS  # 0.033 seconds
     MAX_BUFFER_SIZE = 2  # FR-004: Buffer ≤2 frames
     MAX_CLIENTS = 10  # Support more than minimum 5
+    MAX_RING_BATCH = 64  # Native records per broadcast
+    CODEC_HISTORY = 128  # Frames the binary encoder keeps as delta bases
 
     def __init__(self,
                  enable_logging: bool = True,
                  log_dir: Optional[str] = None,
-                 session_name: Optional[str] = None):
+                 session_name: Optional[str] = None,
+                 native_ring: Optional[str] = None):
         """
         Initialize metrics streamer
 
@@ -46,16 +88,38 @@ class MetricsStreamer:
             enable_logging: Enable session logging to disk
             log_dir: Log directory (None = logs/metrics/)
             session_name: Session identifier (None = timestamp)
+            native_ring: Name of a native metrics ring to stream (None = submit_frame only)
         """
         # WebSocket clients
         self.active_connections: Set[WebSocket] = set()
         self.connection_count = 0
 
-        # Frame buffering
+        # Binary subscribers: WebSocket -> encoder client id. Sending counts
+        # as acknowledging, as a WebSocket delivers in order or drops the
+        # connection (a reconnect starts over with a keyframe).
+        self.binary_clients: Dict[WebSocket, int] = {}
+        self.encoder = None
+        if NATIVE_METRICS_CODEC:
+            self.encoder = dase_engine.MetricsFrameEncoder(self.CODEC_HISTORY, acknowledge_on_send=True)
+
+        # Frame buffering: (frame, ici_matrix, channel_arrays)
         self.frame_buffer = deque(maxlen=self.MAX_BUFFER_SIZE)
         self.latest_frame: Optional[MetricsFrame] = None
         self.frame_counter = 0
 
+        # Native metrics ring: reader, next record to send, reused batch array
+        self.ring = None
+        self.ring_next = 0
+        self.ring_rows = None
+
+        # Latency of traced records through the WebSocket hop, on the host's
+        # clock mapped to ours
+        self.trace = None
+        self.trace_clock = None
+        if NATIVE_TRACE:
+            self.trace = dase_engine.TraceBreakdown()
+            self.trace_clock = dase_engine.TraceClock()
+
         # Broadcasting control
         self.broadcasting = False
         self.broadcast_task = None
@@ -77,12 +141,18 @@ class MetricsStreamer:
             'avg_latency_ms': 0.0,
             'clients_connected': 0,
             'clients_disconnected': 0,
+            'ring_frames_read': 0,
+            'ring_frames_missed': 0,
+            'binary_bytes_sent': 0,
         }
 
         # Logging
         self.log = logging.getLogger(__name__)
         self.log.setLevel(logging.INFO)
 
+        if native_ring:
+            self.attach_native_ring(native_ring)
+
         print("[MetricsStreamer] Initialized")
 
     async def connect(self, websocket: WebSocket):
@@ -123,12 +193,34 @@ class MetricsStreamer:
         """
         if websocket in self.active_connections:
             self.active_connections.remove(websocket)
+            client = self.binary_clients.pop(websocket, None)
+            if client is not None:
+                self.encoder.remove_client(client)
             self.stats['clients_disconnected'] += 1
 
             client_id = id(websocket)
             self.log.info(f"Client {client_id} disconnected. Remaining: {len(self.active_connections)}")
 
-    def submit_frame(self, frame: MetricsFrame):
+    def subscribe_binary(self, websocket: WebSocket) -> bool:
+        """
+        Switch a connected client to binary delta-encoded frames
+
+        Args:
+            websocket: Connected client
+
+        Returns:
+            True if the client now gets binary frames; False without the
+            native codec, in which case it stays on JSON
+        """
+        if self.encoder is None or websocket not in self.active_connections:
+            return False
+        if websocket not in self.binary_clients:
+            self.binary_clients[websocket] = self.encoder.add_client()
+        return True
+
+    def submit_frame(self, frame: MetricsFrame,
+                     ici_matrix=None,
+                     channel_arrays: Optional[Sequence] = None):
         """
         Submit a new metrics frame for broadcasting
 
@@ -136,6 +228,11 @@ class MetricsStreamer:
 
         Args:
             frame: MetricsFrame to broadcast
+            ici_matrix: Optional square channel-by-channel ICI matrix
+            channel_arrays: Optional per-channel arrays (e.g. levels, phases)
+
+        The matrix and arrays go to binary subscribers only; JSON clients
+        get the frame's scalar fields as before.
         """
         # Validate and sanitize
         frame.sanitize()
@@ -146,23 +243,178 @@ class MetricsStreamer:
         self.latest_frame = frame
 
         # Add to buffer (deque is thread-safe for single producer/consumer)
-        self.frame_buffer.append(frame)
+        self.frame_buffer.append((frame, ici_matrix, channel_arrays))
 
         # Log to disk if enabled
         if self.logger:
             self.logger.log_frame(frame)
 
-    async def broadcast_frame(self, frame: MetricsFrame):
+    def attach_native_ring(self, name: str) -> bool:
+        """
+        Stream the records of a native metrics ring from now on
+
+        Args:
+            name: Ring name (dase_pipeline_host --metrics-ring)
+
+        Returns:
+            True if the ring was opened
+        """
+        if not NATIVE_METRICS_RING:
+            self.log.warning("dase_engine.MetricsRing not available; native ring not attached")
+            return False
+        try:
+            ring = dase_engine.MetricsRing(name)
+        except RuntimeError as e:
+            self.log.warning(f"Cannot open metrics ring {name}: {e}")
+            return False
+
+        import numpy as np
+        self.ring = ring
+        self.ring_next = ring.head
+        self.ring_rows = np.empty(self.MAX_RING_BATCH, dtype=dase_engine.METRICS_RECORD_DTYPE)
+        self.log.info(f"Streaming native metrics ring {name} ({ring.capacity} records)")
+        return True
+
+    def read_native_frames(self):
+        """
+        Records of the native ring written since the last read
+
+        Returns:
+            Structured array of METRICS_RECORD_DTYPE rows, oldest first (a
+            view of a reused buffer, valid until the next read), or None
+            without a ring
+        """
+        if self.ring is None:
+            return None
+        rows = self.ring.read_latest(self.MAX_RING_BATCH, self.ring_next, self.ring_rows)
+        if len(rows):
+            first = int(rows['frame_id'][0])
+            self.stats['ring_frames_missed'] += first - self.ring_next
+            self.stats['ring_frames_read'] += len(rows)
+            self.ring_next = int(rows['frame_id'][-1]) + 1
+        return rows
+
+    @staticmethod
+    def record_to_frame(row) -> MetricsFrame:
+        """MetricsFrame of one native record"""
+        flags = int(row['flags'])
+        return MetricsFrame(
+            timestamp=float(row['timestamp']),
+            ici=float(row['ici']),
+            phase_coherence=float(row['phase_coherence']),
+            spectral_centroid=float(row['spectral_centroid']),
+            criticality=float(row['criticality']),
+            consciousness_level=float(row['consciousness_level']),
+            state=METRICS_STATES[int(row['state'])] if int(row['state']) < len(METRICS_STATES) else "IDLE",
+            phi_phase=float(row['phi_phase']),
+            phi_depth=float(row['phi_depth']),
+            phi_source="sensor" if flags & METRICS_RECORD_PHI_SENSOR else "internal",
+            latency_ms=float(row['latency_ms']),
+            cpu_load=float(row['cpu_load']),
+            valid=bool(flags & METRICS_RECORD_VALID),
+            frame_id=int(row['frame_id']),
+            trace_id=int(row['trace_id']) or None,
+            origin_ns=int(row['origin_ns']) or None
+        )
+
+    @staticmethod
+    def frame_to_record(frame: MetricsFrame):
+        """One METRICS_RECORD_DTYPE row of a MetricsFrame (needs dase_engine)"""
+        import numpy as np
+        record = np.zeros(1, dtype=dase_engine.METRICS_RECORD_DTYPE)[0]
+        for name in ('timestamp', 'ici', 'phase_coherence', 'spectral_centroid', 'criticality',
+                     'consciousness_level', 'phi_phase', 'phi_depth'):
+            record[name] = getattr(frame, name)
+        record['latency_ms'] = frame.latency_ms if frame.latency_ms is not None else np.nan
+        record['cpu_load'] = frame.cpu_load if frame.cpu_load is not None else np.nan
+        record['frame_id'] = frame.frame_id or 0
+        record['trace_id'] = frame.trace_id or 0
+        record['origin_ns'] = frame.origin_ns or 0
+        record['state'] = METRICS_STATES.index(frame.state) if frame.state in METRICS_STATES else METRICS_STATES.index("IDLE")
+        record['flags'] = ((METRICS_RECORD_VALID if frame.valid else 0) |
+                           (METRICS_RECORD_PHI_SENSOR if frame.phi_source == "sensor" else 0))
+        return record
+
+    @staticmethod
+    def records_to_json(rows) -> str:
+        """
+        One "metrics_batch" message of native records: a list per field,
+        oldest first, so serialization costs one call per field, not per frame
+        """
+        batch = {name: rows[name].tolist() for name in rows.dtype.names}
+        batch['state'] = [METRICS_STATES[s] if s < len(METRICS_STATES) else "IDLE" for s in batch['state']]
+        return json.dumps({'type': 'metrics_batch', 'count': len(rows), 'frames': batch})
+
+    async def broadcast_native_frames(self, rows):
+        """
+        Broadcast a batch of native records and make the newest the latest frame
+
+        Args:
+            rows: Structured array from read_native_frames()
+        """
+        self.latest_frame = self.record_to_frame(rows[-1])
+        if self.logger:
+            self.logger.log_batch([self.record_to_frame(row) for row in rows])
+
+        latency_ms = (time.time() - float(rows['timestamp'][-1])) * 1000
+        self.stats['avg_latency_ms'] = 0.9 * self.stats['avg_latency_ms'] + 0.1 * latency_ms
+        if self.binary_clients:
+            for row in rows:
+                self.encoder.add_frame(row)
+        await self.broadcast_text(self.records_to_json(rows))
+        self.record_trace(rows)
+
+    def set_clock_offset(self, estimate) -> bool:
+        """
+        Offset of the pipeline host's clock from ours (a ClockSyncClient
+        estimate, remote minus local) for the trace latencies
+
+        Returns:
+            False without the native extension or for an invalid estimate
+        """
+        if self.trace_clock is None or not estimate.valid:
+            return False
+        self.trace_clock.set_offset(estimate)
+        return True
+
+    def record_trace(self, rows):
+        """WebSocket hop and end-to-end latency of the traced records just sent"""
+        if self.trace is None:
+            return
+        sent_ns = dase_engine.trace_now_ns()
+        to_reference = self.trace_clock.to_reference
+        for timestamp, origin_ns, trace_id in zip(rows['timestamp'].tolist(), rows['origin_ns'].tolist(),
+                                                  rows['trace_id'].tolist()):
+            if trace_id == 0:
+                continue
+            self.trace.record_hop(dase_engine.TraceHop.WEBSOCKET, sent_ns - to_reference(int(timestamp * 1e9)))
+            self.trace.record_end_to_end(sent_ns - to_reference(origin_ns))
+
+    async def broadcast_frame(self, frame: MetricsFrame, ici_matrix=None, channel_arrays=None):
         """
         Broadcast frame to all connected clients
 
         Args:
             frame: Frame to broadcast
+            ici_matrix: Optional ICI matrix for binary subscribers
+            channel_arrays: Optional per-channel arrays for binary subscribers
+        """
+        if self.binary_clients:
+            self.encoder.add_frame(self.frame_to_record(frame), ici_matrix, channel_arrays)
+        await self.broadcast_text(frame.to_json())
+
+    async def broadcast_text(self, json_data: str):
+        """
+        Send one message to all connected clients: the JSON message to JSON
+        clients, and to binary subscribers every encoder frame they have not
+        been sent yet
+
+        Args:
+            json_data: Serialized message
         """
         if not self.active_connections:
             return
 
-        json_data = frame.to_json()
         data_size = len(json_data)
 
         # Broadcast to all clients
@@ -170,8 +422,16 @@ class MetricsStreamer:
 
         for websocket in self.active_connections:
             try:
-                await websocket.send_text(json_data)
-                self.stats['total_bytes_sent'] += data_size
+                client = self.binary_clients.get(websocket)
+                if client is None:
+                    await websocket.send_text(json_data)
+                    self.stats['total_bytes_sent'] += data_size
+                else:
+                    message = self.encoder.encode_for(client)
+                    if message:
+                        await websocket.send_bytes(message)
+                        self.stats['total_bytes_sent'] += len(message)
+                        self.stats['binary_bytes_sent'] += len(message)
             except WebSocketDisconnect:
                 disconnected_clients.add(websocket)
             except Exception as e:
@@ -201,9 +461,15 @@ class MetricsStreamer:
             dt = current_time - last_time
             last_time = current_time
 
+            rows = self.read_native_frames()
+
             # Check if we have frames to broadcast
-            if self.frame_buffer:
-                frame = self.frame_buffer.popleft()
+            if rows is not None and len(rows):
+                await self.broadcast_native_frames(rows)
+                idle_frame_timer = 0.0
+
+            elif self.frame_buffer:
+                frame, ici_matrix, channel_arrays = self.frame_buffer.popleft()
 
                 # Calculate latency
                 if frame.timestamp > 0:
@@ -216,7 +482,7 @@ class MetricsStreamer:
                     if latency_ms > 100.0:
                         self.log.warning(f"High latency: {latency_ms:.1f}ms")
 
-                await self.broadcast_frame(frame)
+                await self.broadcast_frame(frame, ici_matrix, channel_arrays)
                 idle_frame_timer = 0.0
 
             else:
@@ -276,6 +542,25 @@ class MetricsStreamer:
             'broadcasting': self.broadcasting,
             'frames_buffered': len(self.frame_buffer),
             'uptime_seconds': uptime,
+            'trace': self.trace_statistics(),
+        }
+
+    def trace_statistics(self) -> Optional[Dict]:
+        """WebSocket hop and end-to-end latency of traced records, ms"""
+        if self.trace is None:
+            return None
+        snapshot = self.trace.snapshot()
+
+        def summary(latency):
+            return {'count': latency.count, 'mean_ms': latency.mean_ns * 1e-6,
+                    'p50_ms': latency.p50_ns * 1e-6, 'p99_ms': latency.p99_ns * 1e-6,
+                    'max_ms': latency.max_ns * 1e-6}
+
+        return {
+            'websocket': summary(snapshot.hop(dase_engine.TraceHop.WEBSOCKET)),
+            'end_to_end': summary(snapshot.end_to_end),
+            'websocket_share': snapshot.share(dase_engine.TraceHop.WEBSOCKET),
+            'skewed': snapshot.skewed,
         }
 
     async def close(self):
@@ -338,6 +623,12 @@ def create_metrics_app(streamer: MetricsStreamer) -> FastAPI:
                     msg = json.loads(data)
                     if msg.get('type') == 'ping':
                         await websocket.send_text(json.dumps({'type': 'pong'}))
+                    elif msg.get('type') == 'subscribe':
+                        binary = msg.get('format') == 'binary' and streamer.subscribe_binary(websocket)
+                        await websocket.send_text(json.dumps({
+                            'type': 'subscribed',
+                            'format': 'binary' if binary else 'json',
+                        }))
                 except:
                     pass  # Ignore malformed messages
 
@@ -0,0 +1,152 @@
+"""
+NativePipeline - control and telemetry client of the native pipeline host
+
+Runs sase_amp_fixed/dase_pipeline_host, which carries every audio block
+through the Φ-sensor, the D-ASE engine, the hybrid node and the I²S bridge
+in one native process. Python stays out of the audio path: commands go to
+the host's stdin and reach its audio thread through a lock-free queue, and
+the host prints a telemetry line per --telemetry-hz period that this client
+parses for visualization.
+"""
+
+import json
+import os
+import subprocess
+import threading
+from typing import Callable, Dict, List, Optional
+
+DEFAULT_BINARY = os.path.join(os.path.dirname(__file__), '..', 'sase_amp_fixed', 'dase_pipeline_host')
+
+
+class NativePipeline:
+    """
+    Native pipeline process with its control input and telemetry output
+
+    Usage:
+        pipeline = NativePipeline(telemetry_callback=print)
+        pipeline.start()
+        pipeline.set_phi(0.8, 1.57)
+        ...
+        pipeline.stop()
+    """
+
+    def __init__(self, binary: str = DEFAULT_BINARY, nodes: int = 1024, sample_rate: int = 48000,
+                 telemetry_hz: float = 10.0, realtime: bool = False, output: Optional[str] = None,
+                 metrics_ring: Optional[str] = None,
+                 telemetry_callback: Optional[Callable[[Dict], None]] = None):
+        """
+        Args:
+            binary: Path of dase_pipeline_host (`make pipeline-host-build`)
+            nodes: D-ASE engine nodes
+            sample_rate: Audio sample rate (Hz)
+            telemetry_hz: Telemetry lines per second
+            realtime: Run the audio thread at SCHED_FIFO (needs the privileges)
+            output: Latency JSON written when the host exits
+            metrics_ring: Shared-memory metrics ring the host appends to
+                (MetricsStreamer.attach_native_ring)
+            telemetry_callback: Called with every telemetry record, from the reader thread
+        """
+        self.binary = binary
+        self.args = ["--nodes", str(nodes), "--sample-rate", str(sample_rate),
+                     "--telemetry-hz", str(telemetry_hz)]
+        if realtime:
+            self.args.append("--realtime")
+        if output:
+            self.args += ["--output", output]
+        if metrics_ring:
+            self.args += ["--metrics-ring", metrics_ring]
+        self.telemetry_callback = telemetry_callback
+
+        self.process: Optional[subprocess.Popen] = None
+        self.reader_thread: Optional[threading.Thread] = None
+        self.latest: Optional[Dict] = None
+        self.lock = threading.Lock()
+
+    def start(self) -> bool:
+        """Launch the host; False if it is running already or cannot be started"""
+        if self.is_running():
+            return False
+        try:
+            self.process = subprocess.Popen([self.binary] + self.args, stdin=subprocess.PIPE,
+                                            stdout=subprocess.PIPE, text=True, bufsize=1)
+        except OSError as e:
+            print(f"[NativePipeline] Could not start {self.binary}: {e}")
+            self.process = None
+            return False
+
+        self.reader_thread = threading.Thread(target=self._read_loop, daemon=True)
+        self.reader_thread.start()
+        return True
+
+    def stop(self, timeout: float = 5.0):
+        """Ask the host to finish its block and exit, killing it after timeout"""
+        if self.process is None:
+            return
+        self._send("quit")
+        try:
+            self.process.wait(timeout=timeout)
+        except subprocess.TimeoutExpired:
+            self.process.kill()
+            self.process.wait()
+        if self.reader_thread:
+            self.reader_thread.join(timeout=1.0)
+        self.process = None
+
+    def is_running(self) -> bool:
+        return self.process is not None and self.process.poll() is None
+
+    def set_phi(self, depth: float, phase: float) -> bool:
+        """Host Φ values (depth [0, 1], phase in radians), in force while no sensor delivers"""
+        return self._send(f"phi {depth:.6f} {phase:.6f}")
+
+    def set_mode(self, mode: int) -> bool:
+        """Hybrid node mode (HybridNodeMode)"""
+        return self._send(f"mode {int(mode)}")
+
+    def set_gain(self, gain: float) -> bool:
+        """Hybrid node preamp gain"""
+        return self._send(f"gain {gain:.6f}")
+
+    def get_telemetry(self) -> Optional[Dict]:
+        """Newest telemetry record: Φ, DSP metrics and per-stage latencies (ms)"""
+        with self.lock:
+            return dict(self.latest) if self.latest else None
+
+    def _send(self, line: str) -> bool:
+        if not self.is_running():
+            return False
+        try:
+            self.process.stdin.write(line + "\n")
+            self.process.stdin.flush()
+            return True
+        except (BrokenPipeError, ValueError):
+            return False
+
+    def _read_loop(self):
+        for line in self.process.stdout:
+            try:
+                record = json.loads(line)
+            except json.JSONDecodeError:
+                continue
+            with self.lock:
+                self.latest = record
+            if self.telemetry_callback:
+                self.telemetry_callback(record)
+
+
+def _self_test(argv: List[str]) -> int:
+    """Run the host for a few seconds and print what comes back"""
+    import time
+    pipeline = NativePipeline(binary=argv[1] if len(argv) > 1 else DEFAULT_BINARY, telemetry_hz=2.0)
+    if not pipeline.start():
+        return 1
+    pipeline.set_phi(0.8, 1.57)
+    time.sleep(2.0)
+    print(pipeline.get_telemetry())
+    pipeline.stop()
+    return 0
+
+
+if __name__ == "__main__":
+    import sys
+    sys.exit(_self_test(sys.argv))
@@ -5,10 +5,14 @@ Distributed synchronization for multiple Soundlab nodes in phase-locked operatio
 Features:
 - Master/client architecture (master = authority, client = subscriber)
 - WebSocket communication protocol
-- NTP-like clock synchronization with smoothing filter
+- NTP-like clock synchronization with smoothing filter; with the native
+  extension, PTP-style exchanges on kernel/NIC socket timestamps
+  (dase_engine.ClockSyncServer/ClockSyncClient) instead of time.time()
 - Frame interpolation for missing data
 - Auto-reconnect mechanism
 - Latency compensation and drift correction
+- Clients feed the master's Φ phase to the engine's native phase lock
+  (dase_engine.PhaseLockLoop), which slews each audio block toward it
 - Multi-node support (scales to 8+ nodes)
 
 Requirements:
@@ -29,14 +33,27 @@ Success Criteria:
 
 import asyncio
 import json
+import os
+import sys
 import time
 import threading
 from typing import Optional, Dict, List, Callable, Any
 from dataclasses import dataclass
 from enum import Enum
 from collections import deque
+from urllib.parse import urlparse
 import statistics
 
+DASE_PATH = os.path.join(os.path.dirname(__file__), '..', 'sase_amp_fixed')
+if DASE_PATH not in sys.path:
+    sys.path.insert(0, DASE_PATH)
+
+try:
+    import dase_engine
+    NATIVE_CLOCK_SYNC = hasattr(dase_engine, "ClockSyncClient")
+except ImportError:
+    NATIVE_CLOCK_SYNC = False
+
 
 class NodeRole(Enum):
     """Node role in synchronization network (FR-002)"""
@@ -54,6 +71,9 @@ class NodeSyncConfig:
     drift_window: int = 100  # Samples for drift calculation
     reconnect_timeout: float = 3.0  # Auto-reconnect timeout (SC-003)
     max_interpolation_gap: int = 5  # Max frames to interpolate (FR-006)
+    clock_sync_port: int = 9320  # UDP port of the native clock sync server on the master
+    clock_sync_burst: int = 8  # Exchanges per clock sync
+    clock_sync_hardware: bool = True  # Use NIC timestamps where the interface provides them
     enable_logging: bool = True
 
 
@@ -77,6 +97,8 @@ class ClockOffset:
     latency: float  # Round-trip latency
     drift: float  # Clock drift rate
     updated_at: float  # Last update time
+    error_bound: float = 0.0  # Worst case offset error from path asymmetry (s)
+    source: str = "none"  # Timestamp source: user, kernel or hardware
 
 
 class NodeSynchronizer:
@@ -109,7 +131,16 @@ class NodeSynchronizer:
         self.master_connection = None
         self.last_sync_time = 0.0
         self.clock_offset: Optional[ClockOffset] = None
+
+        # Native clock sync: server on the master, client on the others
+        self.clock_sync_server = None
+        self.clock_sync_client = None
         self.last_received_frame: Optional[SyncFrame] = None
+
+        # Native phase lock (dase_engine.PhaseLockLoop) of the local audio
+        # path; clients feed it the master's phase, the loop itself runs per
+        # block in the engine
+        self.phase_lock = None
         self.received_frames = deque(maxlen=self.config.drift_window)
 
         # Frame interpolation (FR-006)
@@ -157,13 +188,32 @@ class NodeSynchronizer:
         """Start master node (FR-002)"""
         # Master doesn't need background tasks for sync
         # It broadcasts when process_local_state is called
-        pass
+        if NATIVE_CLOCK_SYNC and self.config.clock_sync_port:
+            sync_config = dase_engine.ClockSyncConfig()
+            sync_config.hardware = self.config.clock_sync_hardware
+            try:
+                self.clock_sync_server = dase_engine.ClockSyncServer(
+                    self.config.clock_sync_port, "0.0.0.0", sync_config)
+            except RuntimeError as e:
+                if self.config.enable_logging:
+                    print(f"[NodeSync] Native clock sync unavailable: {e}")
 
     async def _start_client(self):
         """Start client node (FR-002, FR-003)"""
         if not self.config.master_url:
             raise ValueError("Client mode requires master_url")
 
+        host = urlparse(self.config.master_url).hostname
+        if NATIVE_CLOCK_SYNC and self.config.clock_sync_port and host:
+            sync_config = dase_engine.ClockSyncConfig()
+            sync_config.hardware = self.config.clock_sync_hardware
+            try:
+                self.clock_sync_client = dase_engine.ClockSyncClient(
+                    host, self.config.clock_sync_port, sync_config)
+            except (RuntimeError, ValueError) as e:
+                if self.config.enable_logging:
+                    print(f"[NodeSync] Native clock sync unavailable: {e}")
+
         # Start clock sync task (FR-005)
         self.clock_sync_task = asyncio.create_task(self._clock_sync_loop())
 
@@ -182,6 +232,10 @@ class NodeSynchronizer:
             self.clock_sync_task.cancel()
         if self.reconnect_task:
             self.reconnect_task.cancel()
+        if self.clock_sync_server:
+            self.clock_sync_server.stop()
+            self.clock_sync_server = None
+        self.clock_sync_client = None
 
         # Disconnect from master
         if self.master_connection:
@@ -354,6 +408,12 @@ class NodeSynchronizer:
             latency = self.clock_offset.latency
             self.latency_history.append(latency)
 
+        # Hand the master's phase to the native loop, stamped on the local
+        # clock rather than by when the event loop got to it
+        if self.phase_lock is not None and not interpolated:
+            offset = self.clock_offset.offset if self.clock_offset else 0.0
+            self.phase_lock.push_at(frame.phi_phase, frame.master_timestamp - offset)
+
         # Update last sync time
         self.last_sync_time = time.time()
 
@@ -389,8 +449,32 @@ class NodeSynchronizer:
         1. Send timestamp t1 to master
         2. Master responds with t1, t2 (master time), t3 (response time)
         3. Calculate offset and latency
+
+        With the native client the exchanges run on kernel (or NIC)
+        timestamps in a worker thread, and the offset is the minimum-delay
+        sample of the last few bursts carried forward along the fitted drift.
         """
-        if self.role != NodeRole.CLIENT or not self.master_connection:
+        if self.role != NodeRole.CLIENT:
+            return
+
+        if self.clock_sync_client:
+            client = self.clock_sync_client
+            loop = asyncio.get_running_loop()
+            await loop.run_in_executor(None, client.burst, self.config.clock_sync_burst)
+            estimate = client.estimate()
+            if estimate.valid:
+                self.clock_offset = ClockOffset(
+                    offset=estimate.offset_ns / 1e9,
+                    latency=estimate.delay_ns / 1e9,
+                    drift=estimate.drift_ppm * 1e-6,
+                    updated_at=time.time(),
+                    error_bound=estimate.error_bound_ns / 1e9,
+                    source=estimate.source.name.lower()
+                )
+                self.latency_history.append(self.clock_offset.latency)
+            return
+
+        if not self.master_connection:
             return
 
         # Send clock sync request
@@ -588,6 +672,8 @@ class NodeSynchronizer:
                 stats["clock"] = {
                     "offset_ms": self.clock_offset.offset * 1000,
                     "drift": self.clock_offset.drift,
+                    "error_bound_us": self.clock_offset.error_bound * 1e6,
+                    "source": self.clock_offset.source,
                     "updated_at": self.clock_offset.updated_at
                 }
 
@@ -35,6 +35,7 @@ import time
 import threading
 import struct
 import hashlib
+import binascii
 from typing import Optional, Dict, List, Callable, Any, Tuple
 from dataclasses import dataclass, asdict
 from enum import Enum
@@ -102,6 +103,56 @@ class PeerInfo:
     phase_diff: float = 0.0  # Phase coherence difference
 
 
+# Batched phase datagrams from the native I²S bridge forwarder
+# (hardware/i2s_bridge.h, i2s_forward_start): a 16-byte header, the node
+# id, then the bridge's 32-byte telemetry lane packets
+BRIDGE_BATCH_MAGIC = b"PNB\x01"
+BRIDGE_BATCH_HEADER = struct.Struct("<4sBBxxd")
+BRIDGE_PACKET = struct.Struct("<BBII5fH")  # CRC-16 stored big-endian, swapped below
+BRIDGE_PACKET_BYTES = 32
+BRIDGE_PACKET_SYNC = 0xA5
+
+
+def decode_bridge_batch(data: bytes) -> Optional[List[Dict]]:
+    """
+    Decode a bridge forwarder datagram into phase packets (FR-004)
+
+    Args:
+        data: Datagram starting with BRIDGE_BATCH_MAGIC
+
+    Returns:
+        Phase packet dictionaries, timed by the datagram's send time, or
+        None if the datagram is malformed. Packets failing the CRC are left out.
+    """
+    if len(data) < BRIDGE_BATCH_HEADER.size:
+        return None
+    magic, count, node_id_len, sent = BRIDGE_BATCH_HEADER.unpack_from(data)
+    offset = BRIDGE_BATCH_HEADER.size + node_id_len
+    if magic != BRIDGE_BATCH_MAGIC or len(data) != offset + count * BRIDGE_PACKET_BYTES:
+        return None
+    node_id = data[BRIDGE_BATCH_HEADER.size:offset].decode("utf-8", errors="replace")
+
+    packets = []
+    for start in range(offset, len(data), BRIDGE_PACKET_BYTES):
+        raw = data[start:start + BRIDGE_PACKET_BYTES]
+        # CRC-16/CCITT-FALSE of bytes 0-29
+        if raw[0] != BRIDGE_PACKET_SYNC or int.from_bytes(raw[30:32], "big") != binascii.crc_hqx(raw[:30], 0xFFFF):
+            continue
+        _, _, sequence, _, phi_phase, phi_depth, coherence, criticality, ici, _ = BRIDGE_PACKET.unpack(raw)
+        packets.append({
+            "type": "phase",
+            "t": sent,
+            "phi_phase": phi_phase,
+            "phi_depth": phi_depth,
+            "criticality": criticality,
+            "coherence": coherence,
+            "ici": ici,
+            "node_id": node_id,
+            "sequence": sequence
+        })
+    return packets
+
+
 class PhaseNetNode:
     """
     PhaseNet Protocol Node (Feature 021)
@@ -173,6 +224,9 @@ class PhaseNetNode:
         self.jitter_history = deque(maxlen=100)
         self.coherence_history = deque(maxlen=100)
 
+        # Native phase lock (dase_engine.PhaseLockLoop) fed the leader's phase
+        self.phase_lock = None
+
         # Callbacks
         self.phase_callback: Optional[Callable] = None  # Called on phase update
         self.leader_callback: Optional[Callable] = None  # Called on leader change
@@ -391,6 +445,18 @@ class PhaseNetNode:
                 data, addr = self.socket.recvfrom(4096)
                 receive_time = time.time()
 
+                # Bridge batches are plain binary, so only taken unencrypted
+                if data[:4] == BRIDGE_BATCH_MAGIC:
+                    encrypted = self.cipher and self.config.enable_encryption and ENCRYPTION_AVAILABLE
+                    batch = None if encrypted else decode_bridge_batch(data)
+                    if batch is None:
+                        self.packets_dropped += 1
+                        continue
+                    self.packets_received += len(batch)
+                    for packet in batch:
+                        self._handle_phase_packet(packet, addr, receive_time)
+                    continue
+
                 # Decrypt packet
                 packet = self._decrypt_packet(data)
                 if not packet:
@@ -467,6 +533,10 @@ class PhaseNetNode:
                 jitter = abs(latencies[-1] - latencies[-2])
                 self.jitter_history.append(jitter)
 
+        # Followers lock their audio path's Φ phase to the leader's
+        if self.phase_lock is not None and node_id == self.leader_id and self.state != NodeState.LEADER:
+            self.phase_lock.push_at(packet.get("phi_phase", 0.0), packet_time - peer.drift_offset)
+
         # Call phase callback if registered
         if self.phase_callback:
             self.phase_callback(packet)
@@ -22,7 +22,11 @@ Success Criteria:
 - SC-005: CPU overhead ≤ 5% from sensor loop
 """
 
+import os
+import sys
 import time
+import struct
+import binascii
 import threading
 import queue
 from typing import Optional, Callable, Dict, List, Tuple
@@ -47,6 +51,124 @@ except ImportError:
     SERIAL_AVAILABLE = False
     print("[PhiSensorBridge] Warning: pyserial not available. Serial sensor support disabled.")
 
+# Optional native decoder of the firmware's binary frames (D-ASE extension)
+DASE_PATH = os.path.join(os.path.dirname(__file__), '..', 'sase_amp_fixed')
+if DASE_PATH not in sys.path:
+    sys.path.insert(0, DASE_PATH)
+
+try:
+    import dase_engine
+    NATIVE_PHI_DECODER = hasattr(dase_engine, "decode_phi_stream")
+except ImportError:
+    NATIVE_PHI_DECODER = False
+
+
+# Binary Φ-sensor frames (hardware/phi_packet.h, phi_sensor_read_packet):
+# COBS-encoded packets ended by a zero byte, each a 12-byte header, 16 bytes
+# per sample (18 with a sample number step when sparse) and a
+# CRC-16/CCITT-FALSE
+PHI_PACKET_VERSION = 1
+PHI_PACKET_CHANNELS = 4
+PHI_PACKET_MAX_FRAME = 305
+PHI_PACKET_FLAG_SPARSE = 0x04
+PHI_PACKET_HEADER = struct.Struct("<BBBBII")
+PHI_PACKET_SAMPLE = struct.Struct("<H6s4H")
+PHI_PACKET_SPARSE_SAMPLE = struct.Struct("<HH6s4H")
+
+
+def _cobs_decode(frame: bytes) -> Optional[bytes]:
+    """Undo COBS on one frame without its zero; None if invalid"""
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        i += 1
+        block = frame[i:i + code - 1]
+        if code == 0 or len(block) != code - 1 or 0 in block:
+            return None
+        out += block
+        i += code - 1
+        if code != 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def _decode_phi_packet(packet: Optional[bytes]) -> Optional[List[Tuple]]:
+    """Samples of one decoded packet as (number, timestamp, raw, normalized, flags)"""
+    if packet is None or len(packet) < PHI_PACKET_HEADER.size + 2:
+        return None
+    version, count, channels, flags, number, timestamp = PHI_PACKET_HEADER.unpack_from(packet)
+    sparse = bool(flags & PHI_PACKET_FLAG_SPARSE)
+    layout = PHI_PACKET_SPARSE_SAMPLE if sparse else PHI_PACKET_SAMPLE
+    if (version != PHI_PACKET_VERSION or channels != PHI_PACKET_CHANNELS or count == 0 or
+            len(packet) != PHI_PACKET_HEADER.size + count * layout.size + 2):
+        return None
+    if int.from_bytes(packet[-2:], "little") != binascii.crc_hqx(packet[:-2], 0xFFFF):
+        return None
+
+    samples = []
+    for i in range(count):
+        fields = layout.unpack_from(packet, PHI_PACKET_HEADER.size + i * layout.size)
+        if sparse:
+            step, delta, codes, *normalized = fields
+        else:
+            delta, codes, *normalized = fields
+            step = 1 if i > 0 else 0
+        number = (number + step) & 0xFFFFFFFF
+        timestamp = (timestamp + delta) & 0xFFFFFFFF
+        raw = []
+        for pair in range(0, 6, 3):
+            raw.append(codes[pair] | ((codes[pair + 1] & 0x0F) << 8))
+            raw.append((codes[pair + 1] >> 4) | (codes[pair + 2] << 4))
+        samples.append((number, timestamp, raw, [n / 65535.0 for n in normalized], flags))
+    return samples
+
+
+def decode_phi_stream(data: bytes) -> Dict:
+    """
+    Decode the complete binary Φ-sensor frames in a serial byte stream
+
+    Uses dase_engine.decode_phi_stream when the extension is built, the
+    same decoding in Python otherwise.
+
+    Args:
+        data: Received bytes; a partial frame after the last zero is left alone
+
+    Returns:
+        Dict of sample_number, timestamp_us (uint32), raw_adc (uint16, n x 4),
+        normalized (float32, n x 4) and flags (uint8) arrays, consumed (bytes
+        through the last zero, to drop from the buffer) and errors (frames
+        rejected)
+    """
+    if NATIVE_PHI_DECODER:
+        return dase_engine.decode_phi_stream(data)
+
+    data = bytes(data)
+    samples = []
+    errors = 0
+    start = 0
+    while True:
+        end = data.find(b"\x00", start)
+        if end < 0:
+            break
+        if end > start:
+            decoded = _decode_phi_packet(_cobs_decode(data[start:end]))
+            if decoded is None:
+                errors += 1
+            else:
+                samples.extend(decoded)
+        start = end + 1
+
+    return {
+        "sample_number": np.array([s[0] for s in samples], dtype=np.uint32),
+        "timestamp_us": np.array([s[1] for s in samples], dtype=np.uint32),
+        "raw_adc": np.array([s[2] for s in samples], dtype=np.uint16).reshape(-1, PHI_PACKET_CHANNELS),
+        "normalized": np.array([s[3] for s in samples], dtype=np.float32).reshape(-1, PHI_PACKET_CHANNELS),
+        "flags": np.array([s[4] for s in samples], dtype=np.uint8),
+        "consumed": start,
+        "errors": errors
+    }
+
 
 class SensorType(Enum):
     """Sensor input types"""
@@ -76,6 +198,8 @@ class SensorConfig:
     midi_channel: int = 0                 # MIDI channel (0-15)
     midi_cc_number: int = 1               # MIDI CC number (0-127)
     serial_baudrate: int = 9600           # Serial baudrate
+    serial_format: str = "text"           # "text": one value per line; "binary": phi_sensor frames
+    serial_channel: int = 0               # Channel of the binary frames used as the Φ input
     websocket_url: Optional[str] = None   # WebSocket URL
     input_range: Tuple[float, float] = (0.0, 1.0)  # Expected input range
     smoothing_alpha: float = 0.1          # Smoothing factor
@@ -241,7 +365,8 @@ class SerialSensorInput:
     Serial sensor input handler
 
     Reads analog sensor values from serial port (Arduino, etc.)
-    Expected format: ASCII decimal values, one per line
+    Expected format: ASCII decimal values, one per line, or with
+    serial_format "binary" the frames of phi_sensor_read_packet
     """
 
     def __init__(self, config: SensorConfig, callback: Callable[[SensorData], None]):
@@ -264,6 +389,10 @@ class SerialSensorInput:
         # Smoothing
         self.smoothed_value = 0.5
 
+        # Binary frames received up to a partial one
+        self.rx_buffer = bytearray()
+        self.frame_errors = 0
+
     def connect(self) -> bool:
         """
         Connect to serial device
@@ -326,8 +455,70 @@ class SerialSensorInput:
             self.serial_port.close()
             self.serial_port = None
 
+    def _publish(self, raw_value: float, normalized_01: float):
+        """Smooth a [0, 1] input, map it to the Φ range and hand it on"""
+        # Apply smoothing
+        self.smoothed_value = (
+            self.config.smoothing_alpha * normalized_01 +
+            (1 - self.config.smoothing_alpha) * self.smoothed_value
+        )
+
+        # Map to Φ range [0.618, 1.618] (FR-002)
+        PHI_MIN = 0.618033988749895
+        PHI_MAX = 1.618033988749895
+        normalized_phi = PHI_MIN + self.smoothed_value * (PHI_MAX - PHI_MIN)
+
+        # Create sensor data packet
+        sensor_data = SensorData(
+            sensor_type=SensorType.SERIAL_ANALOG,
+            timestamp=time.time(),
+            raw_value=raw_value,
+            normalized_value=normalized_phi,
+            source_id=f"Serial_{self.config.device_id}"
+        )
+
+        # Call callback (SC-001: < 100 ms latency)
+        self.callback(sensor_data)
+
+    def _binary_loop(self):
+        """Binary frame loop: every sample is smoothed, the newest handed on"""
+        channel = self.config.serial_channel
+        while self.is_running:
+            try:
+                waiting = self.serial_port.in_waiting
+                if waiting == 0:
+                    time.sleep(0.01)
+                    continue
+
+                self.rx_buffer += self.serial_port.read(waiting)
+                decoded = decode_phi_stream(self.rx_buffer)
+                del self.rx_buffer[:decoded["consumed"]]
+                self.frame_errors += decoded["errors"]
+                if len(self.rx_buffer) > 4 * PHI_PACKET_MAX_FRAME:
+                    # No frame end in sight: not our format, or line noise
+                    self.rx_buffer.clear()
+                    self.frame_errors += 1
+
+                normalized = decoded["normalized"]
+                if len(normalized) == 0:
+                    continue
+                for value in normalized[:-1, channel]:
+                    self.smoothed_value = (
+                        self.config.smoothing_alpha * float(value) +
+                        (1 - self.config.smoothing_alpha) * self.smoothed_value
+                    )
+                self._publish(float(decoded["raw_adc"][-1, channel]), float(normalized[-1, channel]))
+
+            except Exception as e:
+                if self.config.enable_logging:
+                    print(f"[SerialSensor] Error in serial loop: {e}")
+
     def _serial_loop(self):
         """Serial data processing loop"""
+        if self.config.serial_format == "binary":
+            self._binary_loop()
+            return
+
         while self.is_running:
             try:
                 # Read line from serial
@@ -344,28 +535,7 @@ class SerialSensorInput:
                             normalized_01 = (raw_value - input_min) / (input_max - input_min)
                             normalized_01 = np.clip(normalized_01, 0.0, 1.0)
 
-                            # Apply smoothing
-                            self.smoothed_value = (
-                                self.config.smoothing_alpha * normalized_01 +
-                                (1 - self.config.smoothing_alpha) * self.smoothed_value
-                            )
-
-                            # Map to Φ range [0.618, 1.618] (FR-002)
-                            PHI_MIN = 0.618033988749895
-                            PHI_MAX = 1.618033988749895
-                            normalized_phi = PHI_MIN + self.smoothed_value * (PHI_MAX - PHI_MIN)
-
-                            # Create sensor data packet
-                            sensor_data = SensorData(
-                                sensor_type=SensorType.SERIAL_ANALOG,
-                                timestamp=time.time(),
-                                raw_value=raw_value,
-                                normalized_value=normalized_phi,
-                                source_id=f"Serial_{self.config.device_id}"
-                            )
-
-                            # Call callback (SC-001: < 100 ms latency)
-                            self.callback(sensor_data)
+                            self._publish(raw_value, normalized_01)
 
                         except ValueError:
                             # Skip invalid values
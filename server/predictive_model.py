@@ -24,6 +24,19 @@ from typing import Optional, Dict, List, Tuple, Callable
 from dataclasses import dataclass
 from collections import deque
 from enum import Enum
+import sys
+import os
+
+# Add sase amp fixed to path to import dase_engine
+DASE_PATH = os.path.join(os.path.dirname(__file__), '..', 'sase amp fixed')
+if DASE_PATH not in sys.path:
+    sys.path.insert(0, DASE_PATH)
+
+try:
+    import dase_engine
+    DASE_AVAILABLE = hasattr(dase_engine, "ForecastKernel")
+except ImportError:
+    DASE_AVAILABLE = False
 
 
 # Import ConsciousnessState from state_classifier
@@ -65,6 +78,9 @@ class PredictiveModelConfig:
     # Log interval in seconds
     log_interval: float = 10.0
 
+    # Keep trends in dase_engine.ForecastKernel (O(1) per frame) when available
+    use_native_kernel: bool = True
+
 
 @dataclass
 class ForecastFrame:
@@ -134,6 +150,17 @@ class PredictiveModel:
         # Logging
         self.last_log_time: float = 0.0
 
+        # Native running-sum trends of ici, coherence, criticality; the
+        # windows match the numpy path below
+        self.kernel = None
+        self.kernel_rows = None
+        if self.config.use_native_kernel and DASE_AVAILABLE:
+            kernel_config = dase_engine.ForecastKernelConfig()
+            kernel_config.trend_window = self.config.buffer_size
+            kernel_config.fit_window = 30
+            kernel_config.stability_window = 10
+            self.kernel = dase_engine.ForecastKernel(3, kernel_config)
+
         print("[PredictiveModel] Initialized")
         print(f"[PredictiveModel]   buffer_size={self.config.buffer_size}")
         print(f"[PredictiveModel]   prediction_horizon={self.config.prediction_horizon}s")
@@ -166,6 +193,8 @@ class PredictiveModel:
             'state': current_state,
             'timestamp': timestamp
         })
+        if self.kernel is not None:
+            self.kernel_rows = self.kernel.push([ici, coherence, criticality])
 
         # Check if we have enough data (edge case handling)
         if len(self.input_buffer) < self.config.min_buffer_size:
@@ -207,27 +236,42 @@ class PredictiveModel:
         if len(self.input_buffer) < self.config.min_buffer_size:
             return None
 
-        # Extract time series
-        buffer_list = list(self.input_buffer)
+        if self.kernel is not None:
+            # Slopes, R^2 and stds come from the kernel's running sums
+            rows = self.kernel_rows
+            first, last = self.input_buffer[0], self.input_buffer[-1]
+            n = len(self.input_buffer)
+            avg_dt = (last['timestamp'] - first['timestamp']) / (n - 1) if n > 1 else 0.033
+
+            delta_ici, delta_coherence, delta_criticality = (float(rows[i, 0]) for i in range(3))
+            current_ici = last['ici']
+            current_coherence = last['coherence']
+            current_criticality = last['criticality']
+            r_squared = [float(rows[i, 1]) for i in range(3)]
+            stds = [float(rows[i, 2]) for i in range(3)]
+        else:
+            # Extract time series
+            buffer_list = list(self.input_buffer)
 
-        ici_series = np.array([f['ici'] for f in buffer_list])
-        coherence_series = np.array([f['coherence'] for f in buffer_list])
-        criticality_series = np.array([f['criticality'] for f in buffer_list])
-        timestamps = np.array([f['timestamp'] for f in buffer_list])
+            ici_series = np.array([f['ici'] for f in buffer_list])
+            coherence_series = np.array([f['coherence'] for f in buffer_list])
+            criticality_series = np.array([f['criticality'] for f in buffer_list])
+            timestamps = np.array([f['timestamp'] for f in buffer_list])
 
-        # Compute time deltas (for regression)
-        dt_series = np.diff(timestamps)
-        avg_dt = np.mean(dt_series) if len(dt_series) > 0 else 0.033  # ~30Hz fallback
+            # Compute time deltas (for regression)
+            dt_series = np.diff(timestamps)
+            avg_dt = np.mean(dt_series) if len(dt_series) > 0 else 0.033  # ~30Hz fallback
 
-        # Linear regression for each metric (FR-003)
-        delta_ici = self._predict_delta(ici_series, avg_dt)
-        delta_coherence = self._predict_delta(coherence_series, avg_dt)
-        delta_criticality = self._predict_delta(criticality_series, avg_dt)
+            # Linear regression for each metric (FR-003)
+            delta_ici = self._predict_delta(ici_series, avg_dt)
+            delta_coherence = self._predict_delta(coherence_series, avg_dt)
+            delta_criticality = self._predict_delta(criticality_series, avg_dt)
 
-        # Current values (from most recent frame)
-        current_ici = ici_series[-1]
-        current_coherence = coherence_series[-1]
-        current_criticality = criticality_series[-1]
+            # Current values (from most recent frame)
+            current_ici = ici_series[-1]
+            current_coherence = coherence_series[-1]
+            current_criticality = criticality_series[-1]
+            r_squared = None
 
         # Predicted values at prediction horizon
         steps_ahead = int(self.config.prediction_horizon / avg_dt)
@@ -248,11 +292,14 @@ class PredictiveModel:
         )
 
         # Calculate confidence (FR-007)
-        confidence = self._calculate_confidence(
-            ici_series,
-            coherence_series,
-            criticality_series
-        )
+        if r_squared is not None:
+            confidence = self._combine_confidence(r_squared, stds)
+        else:
+            confidence = self._calculate_confidence(
+                ici_series,
+                coherence_series,
+                criticality_series
+            )
 
         # Create forecast frame
         forecast = ForecastFrame(
@@ -368,7 +415,7 @@ class PredictiveModel:
         Returns:
             Confidence score [0, 1]
         """
-        # Component 1: Trend consistency (R² of linear fit)
+        # Trend consistency: R² of a linear fit
         def compute_r_squared(series):
             if len(series) < 3:
                 return 0.0
@@ -393,7 +440,24 @@ class PredictiveModel:
         r2_coherence = compute_r_squared(coherence_series[-30:])
         r2_criticality = compute_r_squared(criticality_series[-30:])
 
-        trend_confidence = (r2_ici + r2_coherence + r2_criticality) / 3.0
+        return self._combine_confidence(
+            [r2_ici, r2_coherence, r2_criticality],
+            [np.std(ici_series[-10:]), np.std(coherence_series[-10:]), np.std(criticality_series[-10:])]
+        )
+
+    def _combine_confidence(self, r_squared: List[float], stds: List[float]) -> float:
+        """
+        Weigh trend fit, historical accuracy and stability into a confidence (FR-007)
+
+        Args:
+            r_squared: R² of the last 30 frames' linear fit, per metric
+            stds: Standard deviation of the last 10 frames, per metric
+
+        Returns:
+            Confidence score [0, 1]
+        """
+        # Component 1: Trend consistency (R² of linear fit)
+        trend_confidence = sum(r_squared) / len(r_squared)
 
         # Component 2: Historical accuracy
         if len(self.prediction_history) > 10:
@@ -402,11 +466,7 @@ class PredictiveModel:
             recent_accuracy = 0.5  # Neutral when no history
 
         # Component 3: Data stability (low recent variance = high confidence)
-        recent_std = (
-            np.std(ici_series[-10:]) +
-            np.std(coherence_series[-10:]) +
-            np.std(criticality_series[-10:])
-        ) / 3.0
+        recent_std = sum(stds) / len(stds)
         stability_confidence = max(0.0, 1.0 - recent_std * 2.0)
 
         # Weighted combination
@@ -558,6 +618,9 @@ class PredictiveModel:
         self.actual_outcomes.clear()
         self.forecast_times.clear()
         self.total_forecasts = 0
+        if self.kernel is not None:
+            self.kernel.reset()
+            self.kernel_rows = None
 
         print("[PredictiveModel] State reset")
 
@@ -13,13 +13,63 @@ Requirements:
 - FR-002: System MUST compute statistical metrics
 """
 
+import sys
+import os
 import numpy as np
-from typing import List, Dict, Optional, Tuple
+from typing import List, Dict, Optional, Tuple, Union
 from dataclasses import dataclass, asdict
 from collections import defaultdict
 
 from .session_memory import MetricSnapshot
 
+# Add sase amp fixed to path to import dase_engine
+DASE_PATH = os.path.join(os.path.dirname(__file__), '..', 'sase amp fixed')
+if DASE_PATH not in sys.path:
+    sys.path.insert(0, DASE_PATH)
+
+try:
+    import dase_engine
+    DASE_AVAILABLE = hasattr(dase_engine, "SessionStore")
+except ImportError:
+    DASE_AVAILABLE = False
+
+# Metric columns of a session and the value a sample missing one reads as
+SESSION_COLUMNS = {
+    "ici": 0.5,
+    "coherence": 0.5,
+    "criticality": 0.5,
+    "phi_value": 1.0,
+}
+
+
+def write_session_file(path: str, session_data: Dict) -> bool:
+    """
+    Convert a StateRecorder session dict into a native session file
+
+    The file holds the SESSION_COLUMNS as float64 columns with per-chunk
+    summaries; SessionComparator.load_session_file and
+    CorrelationAnalyzer.load_session_file map it without parsing.
+
+    Returns:
+        True if written, False without the native engine
+    """
+    if not DASE_AVAILABLE:
+        return False
+    samples = session_data.get("samples", [])
+    columns = np.array([[s.get(key, default) for s in samples] for key, default in SESSION_COLUMNS.items()],
+                       dtype=np.float64).reshape(len(SESSION_COLUMNS), len(samples))
+    duration = session_data.get("metadata", {}).get("duration", 0.0)
+    dase_engine.write_session_store(path, list(SESSION_COLUMNS), columns, float(duration))
+    return True
+
+
+def session_series(session: Union[Dict, "dase_engine.SessionStore"], key: str) -> np.ndarray:
+    """One metric of a session dict or a mapped session file as an array"""
+    if isinstance(session, dict):
+        default = SESSION_COLUMNS.get(key, 0.5)
+        return np.array([s.get(key, default) for s in session.get("samples", [])])
+    return np.asarray(session.column(key))
+
 
 @dataclass
 class SessionStats:
@@ -84,7 +134,7 @@ class SessionComparator:
 
     def __init__(self):
         """Initialize SessionComparator"""
-        self.sessions: Dict[str, Dict] = {}
+        self.sessions: Dict[str, Union[Dict, "dase_engine.SessionStore"]] = {}
         self.session_stats: Dict[str, SessionStats] = {}
 
     def load_session(self, session_id: str, session_data: Dict) -> bool:
@@ -113,6 +163,35 @@ class SessionComparator:
             print(f"[SessionComparator] Error loading session: {e}")
             return False
 
+    def load_session_file(self, session_id: str, path: str) -> bool:
+        """
+        Load a native session file written by write_session_file (FR-001)
+
+        The file is mapped rather than parsed, and its statistics come from
+        the stored chunk summaries.
+
+        Args:
+            session_id: Unique identifier for session
+            path: Session file path
+
+        Returns:
+            True if loaded successfully
+        """
+        if not DASE_AVAILABLE:
+            print("[SessionComparator] Session files need the D-ASE engine")
+            return False
+        try:
+            store = dase_engine.SessionStore(path)
+            self.sessions[session_id] = store
+            self.session_stats[session_id] = self._store_session_stats(session_id, store)
+
+            print(f"[SessionComparator] Mapped session: {session_id}")
+            return True
+
+        except Exception as e:
+            print(f"[SessionComparator] Error loading session file: {e}")
+            return False
+
     def unload_session(self, session_id: str):
         """
         Unload a session to free memory (SC-001)
@@ -163,6 +242,33 @@ class SessionComparator:
             max_phi=float(np.max(phis))
         )
 
+    def _store_session_stats(self, session_id: str, store) -> SessionStats:
+        """
+        Statistics of a mapped session from its chunk summaries (FR-002)
+        """
+        ici = store.stats("ici")
+        coherence = store.stats("coherence")
+        criticality = store.stats("criticality")
+        phi = store.stats("phi_value")
+
+        return SessionStats(
+            session_id=session_id,
+            duration=store.duration,
+            sample_count=store.sample_count,
+            mean_ici=ici.mean,
+            std_ici=ici.std,
+            min_ici=ici.min,
+            max_ici=ici.max,
+            mean_coherence=coherence.mean,
+            std_coherence=coherence.std,
+            mean_criticality=criticality.mean,
+            std_criticality=criticality.std,
+            mean_phi=phi.mean,
+            std_phi=phi.std,
+            min_phi=phi.min,
+            max_phi=phi.max
+        )
+
     def compare_sessions(self, session_a_id: str, session_b_id: str) -> Optional[ComparisonResult]:
         """
         Compare two sessions (FR-002)
@@ -189,20 +295,20 @@ class SessionComparator:
             delta_phi = stats_b.mean_phi - stats_a.mean_phi
 
             # Extract time series for correlation
-            samples_a = self.sessions[session_a_id].get("samples", [])
-            samples_b = self.sessions[session_b_id].get("samples", [])
+            session_a = self.sessions[session_a_id]
+            session_b = self.sessions[session_b_id]
 
-            icis_a = np.array([s.get("ici", 0.5) for s in samples_a])
-            icis_b = np.array([s.get("ici", 0.5) for s in samples_b])
+            icis_a = session_series(session_a, "ici")
+            icis_b = session_series(session_b, "ici")
 
-            coherences_a = np.array([s.get("coherence", 0.5) for s in samples_a])
-            coherences_b = np.array([s.get("coherence", 0.5) for s in samples_b])
+            coherences_a = session_series(session_a, "coherence")
+            coherences_b = session_series(session_b, "coherence")
 
-            criticalities_a = np.array([s.get("criticality", 0.5) for s in samples_a])
-            criticalities_b = np.array([s.get("criticality", 0.5) for s in samples_b])
+            criticalities_a = session_series(session_a, "criticality")
+            criticalities_b = session_series(session_b, "criticality")
 
-            phis_a = np.array([s.get("phi_value", 1.0) for s in samples_a])
-            phis_b = np.array([s.get("phi_value", 1.0) for s in samples_b])
+            phis_a = session_series(session_a, "phi_value")
+            phis_b = session_series(session_b, "phi_value")
 
             # Align lengths for correlation (use shorter length)
             min_len = min(len(icis_a), len(icis_b))
@@ -268,7 +374,7 @@ class SessionComparator:
         import sys
 
         total_samples = sum(
-            len(session.get("samples", []))
+            len(session.get("samples", [])) if isinstance(session, dict) else session.sample_count
             for session in self.sessions.values()
         )
 
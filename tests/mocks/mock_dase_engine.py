@@ -275,13 +275,14 @@ class CPUFeatures:
         print("=" * 70)
         print("AVX2 Support: TRUE (simulated)")
         print("FMA Support: TRUE (simulated)")
-        print("OpenMP: FALSE (Python fallback)")
+        print("Worker threads: 1 (Python fallback)")
         print("=" * 70)
 
 
 # Module attributes
 __version__ = "1.0.0-mock"
 avx2_enabled = False  # Mock doesn't use AVX2
+threading_backend = "python"
 openmp_enabled = False
 
 
@@ -0,0 +1,207 @@
+"""
+Smoke tests for the NumPy block paths of the dase_engine extension
+
+Covers the zero-copy block bindings on a small engine:
+- process_block on AnalogCellularEngine, AnalogCellularEngineF32 and
+  AnalogUniversalNode (float32 in place, float64 per sample)
+- Node state columns as buffer-protocol views (outputs, node_column)
+- AsyncBlockProcessor against synchronous process_block
+- process_chromatic_block
+- process_block_frequency_domain in place
+
+Skipped when the extension is not built.
+"""
+
+import asyncio
+
+import pytest
+
+np = pytest.importorskip("numpy")
+dase_engine = pytest.importorskip("dase_engine")
+
+pytestmark = pytest.mark.unit
+
+NODES = 64
+N = 256
+
+
+def make_input(n=N, seed=0):
+    rng = np.random.default_rng(seed)
+    return rng.uniform(-0.5, 0.5, n).astype(np.float32)
+
+
+class TestProcessBlock:
+    """Whole-block processing in one call"""
+
+    @pytest.mark.parametrize("engine_class", ["AnalogCellularEngine", "AnalogCellularEngineF32"])
+    def test_engine_block_shape(self, engine_class):
+        engine = getattr(dase_engine, engine_class)(NODES)
+        out = engine.process_block(make_input())
+        assert out.shape == (NODES, N)
+        assert out.dtype == np.float32
+        assert np.all(np.isfinite(out))
+
+    def test_engine_block_into_out(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        out = np.zeros((NODES, N), dtype=np.float32)
+        control = np.ones(N, dtype=np.float32)
+        aux = np.zeros(N, dtype=np.float32)
+        result = engine.process_block(make_input(), control, aux, out=out)
+        assert result is out
+        assert np.any(out != 0.0)
+
+    def test_engine_block_without_outputs(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        assert engine.process_block(make_input(), return_outputs=False) is None
+
+    def test_engine_block_rejects_converted_out(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        with pytest.raises(ValueError):
+            engine.process_block(make_input(), out=np.zeros((NODES, N), dtype=np.float64))
+
+    def test_engine_block_rejects_short_control(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        with pytest.raises(ValueError):
+            engine.process_block(make_input(), np.ones(N // 2, dtype=np.float32))
+
+    def test_node_block_float32(self):
+        node = dase_engine.AnalogUniversalNode()
+        out = node.process_block(make_input())
+        assert out.shape == (N,)
+        assert out.dtype == np.float32
+
+    def test_node_block_float64_matches_per_sample(self):
+        signal = make_input().astype(np.float64)
+        node = dase_engine.AnalogUniversalNode()
+        out = node.process_block(signal)
+        assert out.dtype == np.float64
+
+        reference = dase_engine.AnalogUniversalNode()
+        expected = [reference.process_signal_avx2(float(x), 1.0, 0.0) for x in signal]
+        np.testing.assert_allclose(out, expected)
+
+    def test_node_view_block(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        node = engine.nodes[3]
+        assert node.is_view
+        out = node.process_block(make_input())
+        assert out[-1] == pytest.approx(node.get_output())
+
+
+class TestNodeColumns:
+    """Node state columns as buffer-protocol views"""
+
+    def test_read_only_views(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        engine.process_block(make_input(), return_outputs=False)
+        outputs = np.asarray(engine.outputs)
+        assert outputs.shape == (NODES,)
+        assert outputs.dtype == np.float64
+        assert not outputs.flags.writeable
+        for name in ("integrator_states", "feedback_gains", "previous_inputs"):
+            assert np.asarray(getattr(engine, name)).shape == (NODES,)
+
+    def test_views_alias_node_state(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        outputs = np.asarray(engine.outputs)
+        block = engine.process_block(make_input())
+        np.testing.assert_allclose(outputs, block[:, -1], rtol=1e-6)
+
+    def test_writeable_column(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        gains = np.asarray(engine.node_column(dase_engine.NodeStateColumn.FEEDBACK_GAIN, True))
+        gains[:] = 0.25
+        np.testing.assert_array_equal(np.asarray(engine.feedback_gains), 0.25)
+
+    def test_float32_engine_columns(self):
+        engine = dase_engine.AnalogCellularEngineF32(NODES)
+        outputs = np.asarray(engine.outputs)
+        assert outputs.dtype == np.float32
+        assert len(engine.outputs) == NODES
+
+
+class TestAsyncBlockProcessor:
+    """Double-buffered submission matches synchronous process_block"""
+
+    def test_matches_synchronous(self):
+        blocks = [make_input(seed=s) for s in range(4)]
+        reference = dase_engine.AnalogCellularEngine(NODES)
+        expected = [reference.process_block(block) for block in blocks]
+
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        processor = dase_engine.AsyncBlockProcessor(engine)
+        results = []
+        for block in blocks:
+            previous = processor.process(block)
+            if previous is not None:
+                results.append(previous)
+        results.append(processor.collect())
+        assert processor.pending == 0
+        assert processor.submitted == len(blocks)
+        for got, want in zip(results, expected):
+            np.testing.assert_array_equal(got, want)
+
+    def test_collect_async(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        processor = dase_engine.AsyncBlockProcessor(engine)
+
+        async def run():
+            processor.submit(make_input())
+            return await processor.collect_async()
+
+        out = asyncio.run(run())
+        assert out.shape == (NODES, N)
+
+    def test_collect_without_block(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        processor = dase_engine.AsyncBlockProcessor(engine, return_outputs=False)
+        with pytest.raises(RuntimeError):
+            processor.collect()
+
+
+class TestChromaticBlock:
+    """Chromatic field block step in one native call"""
+
+    def test_chromatic_block(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        out = engine.process_chromatic_block(make_input(), phi_phase=0.3, phi_depth=0.5, num_channels=8)
+        assert out.shape == (8, N)
+        assert out.dtype == np.float32
+        assert np.all(np.isfinite(out))
+
+    def test_chromatic_block_into_out(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        out = np.zeros((4, N), dtype=np.float32)
+        result = engine.process_chromatic_block(make_input(), num_channels=4, node_stride=2, out=out)
+        assert result is out
+
+
+class TestFrequencyDomainBlock:
+    """Frequency-domain filtering in place"""
+
+    @pytest.mark.parametrize("dtype", [np.float32, np.float64])
+    def test_in_place(self, dtype):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        block = make_input().astype(dtype)
+        result = engine.process_block_frequency_domain(block)
+        assert result is block
+        assert np.all(np.isfinite(block))
+
+    def test_rows(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        rows = np.stack([make_input(seed=s) for s in range(3)])
+        single = rows[1].copy()
+        engine.process_block_frequency_domain(rows)
+        engine.process_block_frequency_domain(single)
+        np.testing.assert_allclose(rows[1], single, rtol=1e-5, atol=1e-6)
+
+    def test_sequence_gives_new_array(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        result = engine.process_block_frequency_domain([float(x) for x in make_input()])
+        assert isinstance(result, np.ndarray)
+        assert result.dtype == np.float64
+
+    def test_rejects_strided_array(self):
+        engine = dase_engine.AnalogCellularEngine(NODES)
+        with pytest.raises(ValueError):
+            engine.process_block_frequency_domain(make_input(2 * N)[::2])